@@ -32,6 +32,14 @@ function (do_pthread_checks)
         ${INCLUDE_MISC_PTHREAD_HEADERS}
         int main() { pthread_attr_t a; pthread_getattr_np(pthread_self(), &a); }
         " HAVE_PTHREAD_GETATTR_NP)
+    # pthread_setaffinity_np(<thread_id>, <size>, <cpu_set_t>) - Linux
+    check_c_source_compiles("
+        #include <pthread.h>
+        #include <sched.h>
+        ${INCLUDE_MISC_PTHREAD_HEADERS}
+        int main() { cpu_set_t s; CPU_ZERO(&s);
+        pthread_setaffinity_np(pthread_self(), sizeof(s), &s); }
+        " HAVE_PTHREAD_SETAFFINITY_NP)
     # pthread_stackseg_np - OpenBSD
     check_c_source_compiles("
         #include <pthread.h>
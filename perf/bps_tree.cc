@@ -0,0 +1,222 @@
+#include <stdint.h>
+#include <stdlib.h>
+
+#include <iostream>
+#include <vector>
+#include <benchmark/benchmark.h>
+
+/*
+ * Element that mimics a hinted memtx tree entry: a pointer to
+ * the payload and a comparison hint that decides the order.
+ */
+struct elem {
+	const void *payload;
+	uint64_t hint;
+};
+
+static inline int
+elem_cmp(const struct elem &a, const struct elem &b)
+{
+	return a.hint < b.hint ? -1 : a.hint > b.hint;
+}
+
+static inline int
+elem_key_cmp(const struct elem &a, uint64_t key)
+{
+	return a.hint < key ? -1 : a.hint > key;
+}
+
+/* Size of the extents allocated by the trees. */
+static const size_t EXTENT_SIZE = 16 * 1024;
+
+#define BPS_TREE_NAME perf_tree
+#define BPS_TREE_BLOCK_SIZE (512)
+#define BPS_TREE_EXTENT_SIZE EXTENT_SIZE
+#define BPS_TREE_COMPARE(a, b, arg) elem_cmp(a, b)
+#define BPS_TREE_COMPARE_KEY(a, b, arg) elem_key_cmp(a, b)
+#define BPS_TREE_IS_IDENTICAL(a, b) ((a).payload == (b).payload)
+#define BPS_TREE_NO_DEBUG 1
+#define bps_tree_elem_t struct elem
+#define bps_tree_key_t uint64_t
+#define bps_tree_arg_t int
+
+#define BPS_TREE_NAMESPACE NS_NO_PREFETCH
+#include "salad/bps_tree.h"
+#undef BPS_TREE_NAMESPACE
+
+#define BPS_TREE_NAMESPACE NS_PREFETCH
+#define BPS_TREE_PREFETCH
+#include "salad/bps_tree.h"
+#undef BPS_TREE_PREFETCH
+#undef BPS_TREE_NAMESPACE
+
+#undef BPS_TREE_NAME
+#undef BPS_TREE_BLOCK_SIZE
+#undef BPS_TREE_EXTENT_SIZE
+#undef BPS_TREE_COMPARE
+#undef BPS_TREE_COMPARE_KEY
+#undef BPS_TREE_IS_IDENTICAL
+#undef BPS_TREE_NO_DEBUG
+#undef bps_tree_elem_t
+#undef bps_tree_key_t
+#undef bps_tree_arg_t
+
+const size_t NUM_LOOKUPS = 1 << 16;
+
+static void *
+extent_alloc(void *ctx)
+{
+	(void)ctx;
+	return malloc(EXTENT_SIZE);
+}
+
+static void
+extent_free(void *ctx, void *extent)
+{
+	(void)ctx;
+	free(extent);
+}
+
+// Wrapper of a tree variant API to use it as a template argument.
+#define PERF_TREE_OPS(name, ns)						\
+struct name {								\
+	typedef ns::perf_tree tree_t;					\
+	typedef ns::perf_tree_iterator iterator_t;			\
+	static void							\
+	create(tree_t *tree)						\
+	{								\
+		ns::perf_tree_create(tree, 0, extent_alloc,		\
+				     extent_free, NULL);		\
+	}								\
+	static int							\
+	build(tree_t *tree, struct elem *elems, size_t size)		\
+	{								\
+		return ns::perf_tree_build(tree, elems, size);		\
+	}								\
+	static void							\
+	destroy(tree_t *tree) { ns::perf_tree_destroy(tree); }		\
+	static struct elem *						\
+	find(tree_t *tree, uint64_t key)				\
+	{								\
+		return ns::perf_tree_find(tree, key);			\
+	}								\
+	static iterator_t						\
+	lower_bound(tree_t *tree, uint64_t key)			\
+	{								\
+		return ns::perf_tree_lower_bound(tree, key, NULL);	\
+	}								\
+	static int							\
+	insert(tree_t *tree, struct elem elem)				\
+	{								\
+		return ns::perf_tree_insert(tree, elem, NULL, NULL);	\
+	}								\
+	static int							\
+	remove(tree_t *tree, struct elem elem)				\
+	{								\
+		return ns::perf_tree_delete(tree, elem);		\
+	}								\
+}
+
+PERF_TREE_OPS(NoPrefetch, NS_NO_PREFETCH);
+PERF_TREE_OPS(Prefetch, NS_PREFETCH);
+
+// Tree of the given size filled with even hints and lookup keys.
+template <class Tree>
+class TestTree {
+public:
+	TestTree(size_t size) : elems(size), keys(NUM_LOOKUPS)
+	{
+		Tree::create(&tree);
+		for (size_t i = 0; i < size; i++) {
+			elems[i].payload = &elems[i];
+			elems[i].hint = i * 2;
+		}
+		if (Tree::build(&tree, elems.data(), size) != 0)
+			abort();
+		for (size_t i = 0; i < NUM_LOOKUPS; i++)
+			keys[i] = ((uint64_t)rand() * RAND_MAX + rand()) %
+				  (size * 2);
+	}
+	~TestTree() { Tree::destroy(&tree); }
+
+	typename Tree::tree_t tree;
+	std::vector<struct elem> elems;
+	std::vector<uint64_t> keys;
+};
+
+// Point lookup benchmark.
+template <class Tree>
+static void
+bench_find(benchmark::State& state)
+{
+	TestTree<Tree> test(state.range(0));
+	size_t i = 0;
+	size_t total_count = 0;
+	for (auto _ : state) {
+		if (i == NUM_LOOKUPS) {
+			total_count += i;
+			i = 0;
+		}
+		benchmark::DoNotOptimize(Tree::find(&test.tree, test.keys[i]));
+		++i;
+	}
+	total_count += i;
+	state.SetItemsProcessed(total_count);
+}
+
+// Range start (lower bound) benchmark.
+template <class Tree>
+static void
+bench_lower_bound(benchmark::State& state)
+{
+	TestTree<Tree> test(state.range(0));
+	size_t i = 0;
+	size_t total_count = 0;
+	for (auto _ : state) {
+		if (i == NUM_LOOKUPS) {
+			total_count += i;
+			i = 0;
+		}
+		typename Tree::iterator_t itr =
+			Tree::lower_bound(&test.tree, test.keys[i]);
+		benchmark::DoNotOptimize(itr);
+		++i;
+	}
+	total_count += i;
+	state.SetItemsProcessed(total_count);
+}
+
+// Insertion of a new element followed by its deletion, so that
+// the tree size stays the same. Odd hints are never in the tree.
+template <class Tree>
+static void
+bench_insert_delete(benchmark::State& state)
+{
+	TestTree<Tree> test(state.range(0));
+	size_t i = 0;
+	size_t total_count = 0;
+	for (auto _ : state) {
+		if (i == NUM_LOOKUPS) {
+			total_count += i;
+			i = 0;
+		}
+		struct elem elem;
+		elem.payload = &test;
+		elem.hint = test.keys[i] | 1;
+		if (Tree::insert(&test.tree, elem) != 0 ||
+		    Tree::remove(&test.tree, elem) != 0)
+			abort();
+		++i;
+	}
+	total_count += i;
+	state.SetItemsProcessed(total_count);
+}
+
+BENCHMARK_TEMPLATE(bench_find, NoPrefetch)->Range(1 << 10, 1 << 24);
+BENCHMARK_TEMPLATE(bench_find, Prefetch)->Range(1 << 10, 1 << 24);
+BENCHMARK_TEMPLATE(bench_lower_bound, NoPrefetch)->Range(1 << 10, 1 << 24);
+BENCHMARK_TEMPLATE(bench_lower_bound, Prefetch)->Range(1 << 10, 1 << 24);
+BENCHMARK_TEMPLATE(bench_insert_delete, NoPrefetch)->Range(1 << 10, 1 << 24);
+BENCHMARK_TEMPLATE(bench_insert_delete, Prefetch)->Range(1 << 10, 1 << 24);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,775 @@
+/*
+ * Copyright 2010-2026, Tarantool AUTHORS, please see AUTHORS file.
+ *
+ * Redistribution and use in source and binary forms, with or
+ * without modification, are permitted provided that the following
+ * conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above
+ *    copyright notice, this list of conditions and the
+ *    following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above
+ *    copyright notice, this list of conditions and the following
+ *    disclaimer in the documentation and/or other materials
+ *    provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY <COPYRIGHT HOLDER> ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ * TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL
+ * <COPYRIGHT HOLDER> OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+ * BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF
+ * THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+/*
+ * A load generator for the binary protocol.
+ *
+ * It opens a number of connections to an instance and sends a mix of
+ * requests over each of them, keeping up to a given number of requests
+ * in flight per connection. Without a rate, a connection sends a new
+ * request as soon as it gets a response (closed loop). With a rate,
+ * requests are sent on schedule (open loop), and the latency is
+ * measured from the time a request was due, not from the time it was
+ * sent, so a stall of the server or of the client isn't hidden.
+ *
+ * The server must have a space with an unsigned primary key, which the
+ * requests use. For example:
+ *
+ *   box.schema.space.create('test', {id = 512})
+ *   box.space.test:create_index('pk')
+ *   box.schema.user.grant('guest', 'read,write', 'space', 'test')
+ */
+#include <getopt.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "msgpuck/msgpuck.h"
+#include "small/ibuf.h"
+
+#include "clock.h"
+#include "coio.h"
+#include "diag.h"
+#include "fiber.h"
+#include "fiber_cond.h"
+#include "histogram.h"
+#include "iostream.h"
+#include "memory.h"
+#include "trivia/util.h"
+#include "uri/uri.h"
+
+#include "box/error.h"
+#include "box/iproto_constants.h"
+#include "box/xrow.h"
+
+/** Request types the generator can send. */
+enum load_op {
+	LOAD_OP_PING,
+	LOAD_OP_SELECT,
+	LOAD_OP_REPLACE,
+	LOAD_OP_UPDATE,
+	LOAD_OP_DELETE,
+	load_op_MAX,
+};
+
+static const char *load_op_strs[] = {
+	"ping", "select", "replace", "update", "delete",
+};
+
+/** Max number of requests in flight per connection. */
+enum { LOAD_DEPTH_MAX = 1 << 16 };
+
+/** Command line options. */
+static struct {
+	const char *uri;
+	int connections;
+	int depth;
+	double rate;
+	double duration;
+	double warmup;
+	uint32_t space_id;
+	uint64_t keys;
+	uint32_t payload_size;
+	/** Request mix, the weight of each request type. */
+	int weights[load_op_MAX];
+	int total_weight;
+	/** Print the latency distribution of all requests. */
+	bool print_distribution;
+} opts = {
+	.connections = 1,
+	.depth = 1,
+	.duration = 10,
+	.warmup = 1,
+	.space_id = 512,
+	.keys = 1000000,
+	.payload_size = 32,
+};
+
+/** A request in flight. */
+struct load_slot {
+	/** Time the request was due, see the comment at the top. */
+	double due;
+	enum load_op op;
+	/** Next free slot, or -1. */
+	int next_free;
+};
+
+struct load_conn {
+	struct iostream io;
+	struct ibuf in;
+	struct fiber *writer;
+	struct fiber *reader;
+	/** Signaled when a request completes. */
+	struct fiber_cond cond;
+	struct load_slot slots[LOAD_DEPTH_MAX];
+	int first_free;
+	int in_flight;
+	uint64_t seq;
+	/** State of the random number generator. */
+	uint64_t rand;
+	/** Time the next request is due in the open loop mode. */
+	double next_due;
+};
+
+/** Latency statistics of one request type, in microseconds. */
+struct load_stat {
+	struct histogram *hist;
+	int64_t max;
+	size_t errors;
+};
+
+static struct load_conn *conns;
+static struct load_stat stats[load_op_MAX];
+static struct load_stat total_stat;
+static char *payload;
+static struct greeting greeting;
+static struct uri uri;
+static double start_time;
+static double end_time;
+static bool is_stopped;
+static bool error_is_printed;
+static int exit_code;
+
+/** See test/unit/core_test_utils.c. */
+void
+cord_on_yield(void)
+{
+}
+
+static uint64_t
+load_rand(struct load_conn *conn)
+{
+	/* xorshift64* */
+	conn->rand ^= conn->rand >> 12;
+	conn->rand ^= conn->rand << 25;
+	conn->rand ^= conn->rand >> 27;
+	return conn->rand * 2685821657736338717ULL;
+}
+
+/**
+ * Create a histogram whose buckets are 1/32 of a power of two wide,
+ * so a percentile is within ~3% of its true value, up to 2^26 us.
+ */
+static struct histogram *
+load_histogram_new(void)
+{
+	int64_t buckets[27 * 32];
+	size_t n = 0;
+	for (int e = 0; e < 27; e++) {
+		int64_t base = 1LL << e;
+		for (int s = 0; s < 32; s++) {
+			int64_t max = base + base * s / 32;
+			if (n == 0 || max > buckets[n - 1])
+				buckets[n++] = max;
+		}
+	}
+	return histogram_new(buckets, n);
+}
+
+/** Return the value below which @a q of the observations fall. */
+static int64_t
+load_stat_quantile(struct load_stat *stat, double q)
+{
+	struct histogram *hist = stat->hist;
+	size_t count = 0;
+	for (size_t i = 0; i < hist->n_buckets; i++) {
+		count += hist->buckets[i].count;
+		if (count > q * hist->total)
+			return MIN(hist->buckets[i].max, stat->max);
+	}
+	return stat->max;
+}
+
+static void
+load_stat_collect(struct load_stat *stat, int64_t us, bool is_error)
+{
+	histogram_collect(stat->hist, us);
+	stat->max = MAX(stat->max, us);
+	if (is_error)
+		stat->errors++;
+}
+
+static void
+load_stat_print_row(const char *name, struct load_stat *stat)
+{
+	double duration = opts.duration;
+	printf("%-8s %10zu %10.0f %8zu", name, stat->hist->total,
+	       stat->hist->total / duration, stat->errors);
+	static const double quantiles[] = {0.5, 0.9, 0.99, 0.999, 0.9999};
+	for (size_t i = 0; i < lengthof(quantiles); i++) {
+		printf(" %8lld",
+		       (long long)load_stat_quantile(stat, quantiles[i]));
+	}
+	printf(" %8lld\n", (long long)stat->max);
+}
+
+/**
+ * Print the distribution of the latency in the format of
+ * HdrHistogram's outputPercentileDistribution(), which existing
+ * tools can plot.
+ */
+static void
+load_stat_print_distribution(struct load_stat *stat)
+{
+	struct histogram *hist = stat->hist;
+	printf("\n%12s %14s %10s %14s\n\n", "Value", "Percentile",
+	       "TotalCount", "1/(1-Percentile)");
+	size_t count = 0;
+	for (size_t i = 0; i < hist->n_buckets; i++) {
+		if (hist->buckets[i].count == 0)
+			continue;
+		count += hist->buckets[i].count;
+		double pct = (double)count / hist->total;
+		int64_t value = MIN(hist->buckets[i].max, stat->max);
+		if (count < hist->total) {
+			printf("%12.3f %2.12f %10zu %14.2f\n",
+			       value / 1000.0, pct, count, 1 / (1 - pct));
+		} else {
+			printf("%12.3f %2.12f %10zu\n",
+			       value / 1000.0, pct, count);
+		}
+	}
+	printf("#[Max = %12.3f, Total count = %12zu]\n",
+	       stat->max / 1000.0, hist->total);
+}
+
+static void
+load_report(void)
+{
+	printf("%d connections, %d requests in flight per connection, ",
+	       opts.connections, opts.depth);
+	if (opts.rate > 0)
+		printf("open loop at %.0f requests per second\n", opts.rate);
+	else
+		printf("closed loop\n");
+	printf("%-8s %10s %10s %8s %8s %8s %8s %8s %8s %8s\n", "request",
+	       "count", "rps", "errors", "p50", "p90", "p99", "p99.9",
+	       "p99.99", "max");
+	for (int op = 0; op < load_op_MAX; op++) {
+		if (opts.weights[op] > 0)
+			load_stat_print_row(load_op_strs[op], &stats[op]);
+	}
+	load_stat_print_row("total", &total_stat);
+	printf("Latency is in microseconds.\n");
+	if (opts.print_distribution)
+		load_stat_print_distribution(&total_stat);
+}
+
+static void
+load_print_error(const char *what)
+{
+	if (error_is_printed)
+		return;
+	error_is_printed = true;
+	struct error *e = diag_last_error(diag_get());
+	fprintf(stderr, "%s: %s\n", what, e != NULL ? e->errmsg : "unknown");
+}
+
+/** Read at least @a size bytes into the input buffer. */
+static int
+load_conn_readn(struct load_conn *conn, size_t size)
+{
+	struct ibuf *in = &conn->in;
+	if (ibuf_used(in) >= size)
+		return 0;
+	size -= ibuf_used(in);
+	if (ibuf_reserve(in, size) == NULL) {
+		diag_set(OutOfMemory, size, "ibuf_reserve", "in");
+		return -1;
+	}
+	ssize_t n = coio_readn_ahead(&conn->io, in->wpos, size,
+				     ibuf_unused(in));
+	if (n < 0)
+		return -1;
+	in->wpos += n;
+	return 0;
+}
+
+/**
+ * Read a row. Its body points to the input buffer and is valid until
+ * the next read.
+ */
+static int
+load_conn_read_row(struct load_conn *conn, struct xrow_header *row)
+{
+	struct ibuf *in = &conn->in;
+	if (ibuf_used(in) == 0)
+		ibuf_reset(in);
+	if (load_conn_readn(conn, 1) != 0)
+		return -1;
+	if (mp_typeof(*in->rpos) != MP_UINT) {
+		diag_set(ClientError, ER_INVALID_MSGPACK, "packet length");
+		return -1;
+	}
+	ptrdiff_t missing = mp_check_uint(in->rpos, in->wpos);
+	if (missing > 0 && load_conn_readn(conn, ibuf_used(in) + missing) != 0)
+		return -1;
+	uint32_t len = mp_decode_uint((const char **)&in->rpos);
+	if (load_conn_readn(conn, len) != 0)
+		return -1;
+	const char *pos = in->rpos;
+	in->rpos += len;
+	return xrow_header_decode(row, &pos, in->rpos, true);
+}
+
+static int
+load_conn_write_row(struct load_conn *conn, struct xrow_header *row)
+{
+	struct iovec iov[XROW_IOVMAX];
+	int iovcnt = xrow_to_iovec(row, iov);
+	if (iovcnt < 0)
+		return -1;
+	return coio_writev(&conn->io, iov, iovcnt, 0) < 0 ? -1 : 0;
+}
+
+static enum load_op
+load_conn_pick_op(struct load_conn *conn)
+{
+	int w = load_rand(conn) % opts.total_weight;
+	for (int op = 0; op < load_op_MAX; op++) {
+		if (w < opts.weights[op])
+			return op;
+		w -= opts.weights[op];
+	}
+	unreachable();
+	return LOAD_OP_PING;
+}
+
+/** Encode a request body on the fiber region. */
+static void
+load_encode_body(struct load_conn *conn, enum load_op op,
+		 struct xrow_header *row)
+{
+	uint64_t key = load_rand(conn) % opts.keys;
+	size_t size = 64 + opts.payload_size;
+	char *begin = region_alloc(&fiber()->gc, size);
+	if (begin == NULL)
+		panic("failed to allocate a request");
+	char *d = begin;
+	switch (op) {
+	case LOAD_OP_PING:
+		row->type = IPROTO_PING;
+		row->bodycnt = 0;
+		return;
+	case LOAD_OP_SELECT:
+		row->type = IPROTO_SELECT;
+		d = mp_encode_map(d, 5);
+		d = mp_encode_uint(d, IPROTO_SPACE_ID);
+		d = mp_encode_uint(d, opts.space_id);
+		d = mp_encode_uint(d, IPROTO_INDEX_ID);
+		d = mp_encode_uint(d, 0);
+		d = mp_encode_uint(d, IPROTO_LIMIT);
+		d = mp_encode_uint(d, 1);
+		d = mp_encode_uint(d, IPROTO_ITERATOR);
+		d = mp_encode_uint(d, ITER_EQ);
+		d = mp_encode_uint(d, IPROTO_KEY);
+		d = mp_encode_array(d, 1);
+		d = mp_encode_uint(d, key);
+		break;
+	case LOAD_OP_REPLACE:
+		row->type = IPROTO_REPLACE;
+		d = mp_encode_map(d, 2);
+		d = mp_encode_uint(d, IPROTO_SPACE_ID);
+		d = mp_encode_uint(d, opts.space_id);
+		d = mp_encode_uint(d, IPROTO_TUPLE);
+		d = mp_encode_array(d, 2);
+		d = mp_encode_uint(d, key);
+		d = mp_encode_str(d, payload, opts.payload_size);
+		break;
+	case LOAD_OP_UPDATE:
+		row->type = IPROTO_UPDATE;
+		d = mp_encode_map(d, 4);
+		d = mp_encode_uint(d, IPROTO_SPACE_ID);
+		d = mp_encode_uint(d, opts.space_id);
+		d = mp_encode_uint(d, IPROTO_INDEX_BASE);
+		d = mp_encode_uint(d, 1);
+		d = mp_encode_uint(d, IPROTO_KEY);
+		d = mp_encode_array(d, 1);
+		d = mp_encode_uint(d, key);
+		d = mp_encode_uint(d, IPROTO_TUPLE);
+		d = mp_encode_array(d, 1);
+		d = mp_encode_array(d, 3);
+		d = mp_encode_str(d, "=", 1);
+		d = mp_encode_uint(d, 2);
+		d = mp_encode_str(d, payload, opts.payload_size);
+		break;
+	case LOAD_OP_DELETE:
+		row->type = IPROTO_DELETE;
+		d = mp_encode_map(d, 2);
+		d = mp_encode_uint(d, IPROTO_SPACE_ID);
+		d = mp_encode_uint(d, opts.space_id);
+		d = mp_encode_uint(d, IPROTO_KEY);
+		d = mp_encode_array(d, 1);
+		d = mp_encode_uint(d, key);
+		break;
+	default:
+		unreachable();
+	}
+	assert((size_t)(d - begin) <= size);
+	row->body[0].iov_base = begin;
+	row->body[0].iov_len = d - begin;
+	row->bodycnt = 1;
+}
+
+static int
+load_writer_f(va_list ap)
+{
+	struct load_conn *conn = va_arg(ap, struct load_conn *);
+	struct region *gc = &fiber()->gc;
+	double interval = opts.rate > 0 ? opts.connections / opts.rate : 0;
+	conn->next_due = start_time;
+	while (!is_stopped) {
+		if (conn->in_flight >= opts.depth) {
+			fiber_cond_wait(&conn->cond);
+			continue;
+		}
+		double now = clock_monotonic();
+		double due = now;
+		if (interval > 0) {
+			if (conn->next_due > now) {
+				fiber_sleep(conn->next_due - now);
+				continue;
+			}
+			due = conn->next_due;
+			conn->next_due += interval;
+		}
+		if (due >= end_time)
+			break;
+		int slot = conn->first_free;
+		assert(slot >= 0);
+		conn->first_free = conn->slots[slot].next_free;
+		conn->slots[slot].due = due;
+		conn->slots[slot].op = load_conn_pick_op(conn);
+
+		struct xrow_header row;
+		memset(&row, 0, sizeof(row));
+		row.sync = (conn->seq++ << 16) | slot;
+		load_encode_body(conn, conn->slots[slot].op, &row);
+		conn->in_flight++;
+		int rc = load_conn_write_row(conn, &row);
+		region_truncate(gc, 0);
+		if (rc != 0) {
+			load_print_error("Failed to send a request");
+			exit_code = 1;
+			break;
+		}
+	}
+	return 0;
+}
+
+static int
+load_reader_f(va_list ap)
+{
+	struct load_conn *conn = va_arg(ap, struct load_conn *);
+	while (!(is_stopped && conn->in_flight == 0)) {
+		struct xrow_header row;
+		if (load_conn_read_row(conn, &row) != 0) {
+			if (!fiber_is_cancelled()) {
+				load_print_error("Failed to read a response");
+				exit_code = 1;
+			}
+			break;
+		}
+		int slot = row.sync & 0xffff;
+		if (slot >= opts.depth || conn->in_flight == 0) {
+			fprintf(stderr, "Unexpected response sync\n");
+			exit_code = 1;
+			break;
+		}
+		struct load_slot *s = &conn->slots[slot];
+		bool is_error = (row.type & IPROTO_TYPE_ERROR) != 0;
+		if (is_error && !error_is_printed) {
+			xrow_decode_error(&row);
+			load_print_error("Request failed");
+		}
+		if (s->due >= start_time + opts.warmup) {
+			int64_t us = (clock_monotonic() - s->due) * 1e6;
+			load_stat_collect(&stats[s->op], us, is_error);
+			load_stat_collect(&total_stat, us, is_error);
+		}
+		s->next_free = conn->first_free;
+		conn->first_free = slot;
+		conn->in_flight--;
+		fiber_cond_signal(&conn->cond);
+	}
+	return 0;
+}
+
+/** Connect and authenticate if the URI has a login. */
+static int
+load_conn_connect(struct load_conn *conn)
+{
+	const char *host = uri.host != NULL ? uri.host : "localhost";
+	int fd = coio_connect(host, uri.service, uri.host_hint, NULL, NULL);
+	if (fd < 0)
+		return -1;
+	plain_iostream_create(&conn->io, fd);
+	char greetingbuf[IPROTO_GREETING_SIZE];
+	if (coio_readn(&conn->io, greetingbuf, sizeof(greetingbuf)) < 0)
+		return -1;
+	if (greeting_decode(greetingbuf, &greeting) != 0) {
+		diag_set(ClientError, ER_PROTOCOL, "Invalid greeting");
+		return -1;
+	}
+	if (uri.login == NULL)
+		return 0;
+	const char *password = uri.password != NULL ? uri.password : "";
+	struct xrow_header row;
+	if (xrow_encode_auth(&row, greeting.salt, greeting.salt_len,
+			     uri.login, strlen(uri.login), password,
+			     strlen(password)) != 0)
+		return -1;
+	int rc = load_conn_write_row(conn, &row);
+	region_truncate(&fiber()->gc, 0);
+	if (rc != 0 || load_conn_read_row(conn, &row) != 0)
+		return -1;
+	if (row.type != IPROTO_OK) {
+		xrow_decode_error(&row);
+		return -1;
+	}
+	return 0;
+}
+
+static int
+load_main_f(va_list ap)
+{
+	(void)ap;
+	for (int i = 0; i < opts.connections; i++) {
+		struct load_conn *conn = &conns[i];
+		if (load_conn_connect(conn) != 0) {
+			load_print_error("Failed to connect");
+			exit_code = 1;
+			goto out;
+		}
+	}
+	start_time = clock_monotonic();
+	end_time = start_time + opts.warmup + opts.duration;
+	for (int i = 0; i < opts.connections; i++) {
+		struct load_conn *conn = &conns[i];
+		conn->writer = fiber_new("writer", load_writer_f);
+		conn->reader = fiber_new("reader", load_reader_f);
+		if (conn->writer == NULL || conn->reader == NULL)
+			panic("failed to create a fiber");
+		fiber_set_joinable(conn->writer, true);
+		fiber_set_joinable(conn->reader, true);
+		fiber_start(conn->writer, conn);
+		fiber_start(conn->reader, conn);
+	}
+	fiber_sleep(end_time - clock_monotonic());
+	is_stopped = true;
+	for (int i = 0; i < opts.connections; i++) {
+		fiber_cond_signal(&conns[i].cond);
+		fiber_wakeup(conns[i].writer);
+		fiber_join(conns[i].writer);
+	}
+	/* Give the responses in flight some time to arrive. */
+	double deadline = clock_monotonic() + 5;
+	for (int i = 0; i < opts.connections; i++) {
+		while (conns[i].in_flight > 0 &&
+		       clock_monotonic() < deadline)
+			fiber_sleep(0.01);
+	}
+	for (int i = 0; i < opts.connections; i++) {
+		fiber_cancel(conns[i].reader);
+		fiber_join(conns[i].reader);
+	}
+	load_report();
+out:
+	ev_break(loop(), EVBREAK_ALL);
+	return 0;
+}
+
+static int
+load_parse_mix(const char *str)
+{
+	char *copy = strdup(str);
+	if (copy == NULL)
+		return -1;
+	int rc = 0;
+	char *saveptr = NULL;
+	for (char *tok = strtok_r(copy, ",", &saveptr); tok != NULL;
+	     tok = strtok_r(NULL, ",", &saveptr)) {
+		char *eq = strchr(tok, '=');
+		int weight = 1;
+		if (eq != NULL) {
+			*eq = '\0';
+			weight = atoi(eq + 1);
+		}
+		int op = 0;
+		while (op < load_op_MAX && strcmp(tok, load_op_strs[op]) != 0)
+			op++;
+		if (op == load_op_MAX || weight < 0) {
+			rc = -1;
+			break;
+		}
+		opts.weights[op] = weight;
+	}
+	free(copy);
+	return rc;
+}
+
+static void
+load_usage(FILE *f)
+{
+	fprintf(f,
+"Usage: iproto_load [options] [login:password@]host:port\n"
+"\n"
+"Options:\n"
+"  -c N     number of connections (1)\n"
+"  -d N     max requests in flight per connection (1)\n"
+"  -r N     send N requests per second in total, open loop;\n"
+"           by default, send as fast as responses arrive\n"
+"  -t N     duration of the measurement in seconds (10)\n"
+"  -w N     warm-up time in seconds, not measured (1)\n"
+"  -m MIX   request mix, e.g. select=90,replace=10 (select=1);\n"
+"           requests: ping, select, replace, update, delete\n"
+"  -s ID    space id (512)\n"
+"  -k N     keys are random integers in [0, N) (1000000)\n"
+"  -l N     size of the string field of written tuples (32)\n"
+"  -H       print the latency distribution in the HdrHistogram format\n"
+"  -h       print this help\n");
+}
+
+int
+main(int argc, char **argv)
+{
+	bool has_mix = false;
+	int c;
+	while ((c = getopt(argc, argv, "c:d:r:t:w:m:s:k:l:Hh")) != -1) {
+		switch (c) {
+		case 'c':
+			opts.connections = atoi(optarg);
+			break;
+		case 'd':
+			opts.depth = atoi(optarg);
+			break;
+		case 'r':
+			opts.rate = atof(optarg);
+			break;
+		case 't':
+			opts.duration = atof(optarg);
+			break;
+		case 'w':
+			opts.warmup = atof(optarg);
+			break;
+		case 'm':
+			if (load_parse_mix(optarg) != 0) {
+				fprintf(stderr, "Invalid request mix: %s\n",
+					optarg);
+				return 1;
+			}
+			has_mix = true;
+			break;
+		case 's':
+			opts.space_id = strtoul(optarg, NULL, 10);
+			break;
+		case 'k':
+			opts.keys = strtoull(optarg, NULL, 10);
+			break;
+		case 'l':
+			opts.payload_size = strtoul(optarg, NULL, 10);
+			break;
+		case 'H':
+			opts.print_distribution = true;
+			break;
+		case 'h':
+			load_usage(stdout);
+			return 0;
+		default:
+			load_usage(stderr);
+			return 1;
+		}
+	}
+	if (optind != argc - 1) {
+		load_usage(stderr);
+		return 1;
+	}
+	opts.uri = argv[optind];
+	if (!has_mix)
+		opts.weights[LOAD_OP_SELECT] = 1;
+	for (int op = 0; op < load_op_MAX; op++)
+		opts.total_weight += opts.weights[op];
+	if (opts.connections <= 0 || opts.depth <= 0 ||
+	    opts.depth > LOAD_DEPTH_MAX || opts.duration <= 0 ||
+	    opts.warmup < 0 || opts.rate < 0 || opts.keys == 0 ||
+	    opts.total_weight == 0) {
+		fprintf(stderr, "Invalid options\n");
+		return 1;
+	}
+
+	memory_init();
+	fiber_init(fiber_c_invoke);
+	coio_init();
+	coio_enable();
+	if (uri_create(&uri, opts.uri) != 0 || uri.service == NULL) {
+		fprintf(stderr, "Invalid URI: %s\n", opts.uri);
+		return 1;
+	}
+	payload = xmalloc(opts.payload_size + 1);
+	memset(payload, 'x', opts.payload_size);
+	for (int op = 0; op < load_op_MAX; op++)
+		stats[op].hist = load_histogram_new();
+	total_stat.hist = load_histogram_new();
+	conns = xcalloc(opts.connections, sizeof(*conns));
+	for (int i = 0; i < opts.connections; i++) {
+		struct load_conn *conn = &conns[i];
+		iostream_clear(&conn->io);
+		ibuf_create(&conn->in, cord_slab_cache(), 16 * 1024);
+		fiber_cond_create(&conn->cond);
+		conn->rand = 0x9e3779b97f4a7c15ULL * (i + 1);
+		for (int k = 0; k < opts.depth; k++)
+			conn->slots[k].next_free = k + 1 < opts.depth ? k + 1 : -1;
+		conn->first_free = 0;
+	}
+
+	struct fiber *main_fiber = fiber_new("main", load_main_f);
+	if (main_fiber == NULL)
+		panic("failed to create a fiber");
+	fiber_wakeup(main_fiber);
+	ev_run(loop(), 0);
+
+	for (int i = 0; i < opts.connections; i++) {
+		struct load_conn *conn = &conns[i];
+		if (iostream_is_initialized(&conn->io))
+			iostream_destroy(&conn->io);
+		ibuf_destroy(&conn->in);
+		fiber_cond_destroy(&conn->cond);
+	}
+	free(conns);
+	for (int op = 0; op < load_op_MAX; op++)
+		histogram_delete(stats[op].hist);
+	histogram_delete(total_stat.hist);
+	free(payload);
+	uri_destroy(&uri);
+	fiber_free();
+	memory_free();
+	return exit_code;
+}
@@ -431,6 +431,81 @@ tuple_tuple_compare_hint(benchmark::State& state)
 
 BENCHMARK(tuple_tuple_compare_hint);
 
+// Generator of a set of tuples with unsigned fields only.
+class UnsignedTestTuples {
+public:
+	static const uint32_t FIELD_COUNT = 5;
+
+	UnsignedTestTuples(uint64_t max_value)
+	{
+		format = MemtxEngine::instance().format();
+		tuple_format_ref(format);
+		for (size_t i = 0; i < NUM_TEST_TUPLES; i++) {
+			char buf[FIELD_COUNT * 9 + 1];
+			char *end = mp_encode_array(buf, FIELD_COUNT);
+			for (uint32_t k = 0; k < FIELD_COUNT; k++) {
+				uint64_t r = (uint64_t)rand() * 1024 + rand();
+				end = mp_encode_uint(end, r % max_value);
+			}
+			data[i] = box_tuple_new(format, buf, end);
+			tuple_ref(data[i]);
+		}
+	}
+	~UnsignedTestTuples()
+	{
+		for (size_t i = 0; i < NUM_TEST_TUPLES; i++)
+			tuple_unref(data[i]);
+
+		tuple_format_unref(format);
+	}
+	struct tuple *operator[](size_t i) { return data[i]; }
+
+private:
+	struct tuple_format *format;
+	struct tuple *data[NUM_TEST_TUPLES];
+};
+
+// benchmark of multipart sequential unsigned key compare.
+static void
+tuple_tuple_compare_unsigned_multipart(benchmark::State& state)
+{
+	UnsignedTestTuples tuples(state.range(1));
+	struct key_part_def kdp[UnsignedTestTuples::FIELD_COUNT];
+	uint32_t part_count = state.range(0);
+	for (uint32_t k = 0; k < part_count; k++) {
+		kdp[k] = key_part_def_default;
+		kdp[k].fieldno = k;
+		kdp[k].type = FIELD_TYPE_UNSIGNED;
+	}
+	struct key_def *kd = key_def_new(kdp, part_count, false);
+	size_t i = 0;
+	size_t j = 0;
+	size_t total_count = 0;
+	for (auto _ : state) {
+		if (i == NUM_TEST_TUPLES) {
+			total_count += i;
+			i = 0;
+		}
+		if (j >= NUM_TEST_TUPLES)
+			j -= NUM_TEST_TUPLES;
+		struct tuple *t1 = tuples[i];
+		struct tuple *t2 = tuples[j];
+		benchmark::DoNotOptimize(tuple_compare(t1, HINT_NONE,
+						       t2, HINT_NONE, kd));
+		++i;
+		j += 3;
+	}
+	total_count += i;
+	state.SetItemsProcessed(total_count);
+	key_def_delete(kd);
+}
+
+// Arguments: part count, upper bound of field values (exclusive).
+BENCHMARK(tuple_tuple_compare_unsigned_multipart)
+	->Args({2, 4})->Args({3, 4})->Args({5, 4})
+	->Args({2, 100})->Args({3, 100})->Args({5, 100})
+	->Args({3, 1 << 20});
+
 BENCHMARK_MAIN();
 
 static void
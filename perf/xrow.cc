@@ -0,0 +1,294 @@
+#include "memory.h"
+#include "fiber.h"
+#include "xrow.h"
+#include "iproto_constants.h"
+
+#include <iostream>
+#include <benchmark/benchmark.h>
+
+const size_t NUM_TEST_ROWS = 1024;
+const size_t MAX_ROW_SIZE = 512;
+
+// Class that initializes the runtime needed to encode and decode rows.
+class Runtime {
+public:
+	static Runtime &instance()
+	{
+		static Runtime instance;
+		return instance;
+	}
+private:
+	Runtime()
+	{
+		memory_init();
+		fiber_init(fiber_c_invoke);
+	}
+	~Runtime()
+	{
+		fiber_free();
+		memory_free();
+	}
+};
+
+// Generator of a random DML request body.
+class DmlBody {
+public:
+	const char *begin() const { return data; }
+	const char *end() const { return data_end; }
+	DmlBody(uint16_t type)
+	{
+		uint32_t field_count = 1 + rand() % 16;
+		char *d = data;
+		switch (type) {
+		case IPROTO_INSERT:
+			// The layout handled by the fast decoder.
+			d = mp_encode_map(d, 2);
+			d = mp_encode_uint(d, IPROTO_SPACE_ID);
+			d = mp_encode_uint(d, 512 + rand() % 512);
+			d = mp_encode_uint(d, IPROTO_TUPLE);
+			d = encode_tuple(d, field_count);
+			break;
+		case IPROTO_SELECT:
+			d = mp_encode_map(d, 6);
+			d = mp_encode_uint(d, IPROTO_SPACE_ID);
+			d = mp_encode_uint(d, 512 + rand() % 512);
+			d = mp_encode_uint(d, IPROTO_INDEX_ID);
+			d = mp_encode_uint(d, rand() % 4);
+			d = mp_encode_uint(d, IPROTO_LIMIT);
+			d = mp_encode_uint(d, UINT32_MAX);
+			d = mp_encode_uint(d, IPROTO_OFFSET);
+			d = mp_encode_uint(d, 0);
+			d = mp_encode_uint(d, IPROTO_ITERATOR);
+			d = mp_encode_uint(d, 0);
+			d = mp_encode_uint(d, IPROTO_KEY);
+			d = encode_tuple(d, 1 + rand() % 2);
+			break;
+		case IPROTO_UPDATE:
+			d = mp_encode_map(d, 4);
+			d = mp_encode_uint(d, IPROTO_SPACE_ID);
+			d = mp_encode_uint(d, 512 + rand() % 512);
+			d = mp_encode_uint(d, IPROTO_INDEX_ID);
+			d = mp_encode_uint(d, 0);
+			d = mp_encode_uint(d, IPROTO_KEY);
+			d = encode_tuple(d, 1);
+			d = mp_encode_uint(d, IPROTO_TUPLE);
+			d = mp_encode_array(d, 1);
+			d = mp_encode_array(d, 3);
+			d = mp_encode_str(d, "+", 1);
+			d = mp_encode_uint(d, 2);
+			d = mp_encode_uint(d, rand());
+			break;
+		default:
+			abort();
+		}
+		data_end = d;
+		if (data_end - data > (ptrdiff_t)MAX_ROW_SIZE)
+			abort();
+	}
+private:
+	static char *
+	encode_tuple(char *d, uint32_t field_count)
+	{
+		d = mp_encode_array(d, field_count);
+		for (uint32_t i = 0; i < field_count; i++) {
+			if (i % 4 == 1)
+				d = mp_encode_str(d, "hello", 5);
+			else
+				d = mp_encode_uint(d, rand());
+		}
+		return d;
+	}
+
+	char data[MAX_ROW_SIZE];
+	char *data_end;
+};
+
+// Generator of a set of rows of the given type.
+class TestRows {
+public:
+	TestRows(uint16_t type)
+	{
+		for (size_t i = 0; i < NUM_TEST_ROWS; i++) {
+			bodies[i] = new DmlBody(type);
+			struct xrow_header *row = &rows[i];
+			memset(row, 0, sizeof(*row));
+			row->type = type;
+			row->replica_id = 1;
+			row->lsn = 1000000 + i;
+			row->tm = 1700000000.0 + i;
+			row->bodycnt = 1;
+			row->body[0].iov_base = (void *)bodies[i]->begin();
+			row->body[0].iov_len = bodies[i]->end() -
+					       bodies[i]->begin();
+		}
+	}
+	~TestRows()
+	{
+		for (size_t i = 0; i < NUM_TEST_ROWS; i++)
+			delete bodies[i];
+	}
+	struct xrow_header *operator[](size_t i) { return &rows[i]; }
+
+private:
+	DmlBody *bodies[NUM_TEST_ROWS];
+	struct xrow_header rows[NUM_TEST_ROWS];
+};
+
+// xrow_header_encode benchmark.
+static void
+bench_xrow_header_encode(benchmark::State& state)
+{
+	Runtime::instance();
+	TestRows rows(IPROTO_INSERT);
+	size_t i = 0;
+	size_t total_count = 0;
+	struct region *gc = &fiber()->gc;
+	for (auto _ : state) {
+		if (i == NUM_TEST_ROWS) {
+			total_count += i;
+			i = 0;
+			region_truncate(gc, 0);
+		}
+		struct iovec iov[XROW_IOVMAX];
+		benchmark::DoNotOptimize(
+			xrow_header_encode(rows[i++], 0, iov, 0));
+	}
+	total_count += i;
+	state.SetItemsProcessed(total_count);
+	region_truncate(gc, 0);
+}
+
+BENCHMARK(bench_xrow_header_encode);
+
+// xrow_header_decode benchmark.
+static void
+bench_xrow_header_decode(benchmark::State& state)
+{
+	Runtime::instance();
+	TestRows rows(IPROTO_INSERT);
+	struct region *gc = &fiber()->gc;
+	const char *packets[NUM_TEST_ROWS];
+	const char *packet_ends[NUM_TEST_ROWS];
+	for (size_t k = 0; k < NUM_TEST_ROWS; k++) {
+		struct iovec iov[XROW_IOVMAX];
+		int iovcnt = xrow_header_encode(rows[k], 0, iov, 0);
+		if (iovcnt < 0)
+			abort();
+		size_t size = 0;
+		for (int j = 0; j < iovcnt; j++)
+			size += iov[j].iov_len;
+		char *buf = (char *)region_alloc(gc, size);
+		if (buf == NULL)
+			abort();
+		packets[k] = buf;
+		for (int j = 0; j < iovcnt; j++) {
+			memcpy(buf, iov[j].iov_base, iov[j].iov_len);
+			buf += iov[j].iov_len;
+		}
+		packet_ends[k] = buf;
+	}
+	size_t i = 0;
+	size_t total_count = 0;
+	for (auto _ : state) {
+		if (i == NUM_TEST_ROWS) {
+			total_count += i;
+			i = 0;
+		}
+		struct xrow_header row;
+		const char *pos = packets[i];
+		benchmark::DoNotOptimize(
+			xrow_header_decode(&row, &pos, packet_ends[i], true));
+		++i;
+	}
+	total_count += i;
+	state.SetItemsProcessed(total_count);
+	region_truncate(gc, 0);
+}
+
+BENCHMARK(bench_xrow_header_decode);
+
+// xrow_decode_dml benchmark.
+static void
+bench_xrow_decode_dml(benchmark::State& state)
+{
+	Runtime::instance();
+	uint16_t type = state.range(0);
+	TestRows rows(type);
+	uint64_t key_map = dml_request_key_map(type);
+	size_t i = 0;
+	size_t total_count = 0;
+	for (auto _ : state) {
+		if (i == NUM_TEST_ROWS) {
+			total_count += i;
+			i = 0;
+		}
+		struct request request;
+		benchmark::DoNotOptimize(
+			xrow_decode_dml(rows[i++], &request, key_map));
+	}
+	total_count += i;
+	state.SetItemsProcessed(total_count);
+}
+
+// Argument: request type.
+BENCHMARK(bench_xrow_decode_dml)
+	->Arg(IPROTO_INSERT)->Arg(IPROTO_SELECT)->Arg(IPROTO_UPDATE);
+
+// xrow_encode_dml benchmark.
+static void
+bench_xrow_encode_dml(benchmark::State& state)
+{
+	Runtime::instance();
+	uint16_t type = state.range(0);
+	TestRows rows(type);
+	struct request requests[NUM_TEST_ROWS];
+	for (size_t k = 0; k < NUM_TEST_ROWS; k++) {
+		if (xrow_decode_dml(rows[k], &requests[k],
+				    dml_request_key_map(type)) != 0)
+			abort();
+	}
+	struct region *gc = &fiber()->gc;
+	size_t i = 0;
+	size_t total_count = 0;
+	for (auto _ : state) {
+		if (i == NUM_TEST_ROWS) {
+			total_count += i;
+			i = 0;
+			region_truncate(gc, 0);
+		}
+		struct iovec iov[XROW_BODY_IOVMAX];
+		benchmark::DoNotOptimize(
+			xrow_encode_dml(&requests[i++], gc, iov));
+	}
+	total_count += i;
+	state.SetItemsProcessed(total_count);
+	region_truncate(gc, 0);
+}
+
+// Argument: request type.
+BENCHMARK(bench_xrow_encode_dml)
+	->Arg(IPROTO_INSERT)->Arg(IPROTO_SELECT)->Arg(IPROTO_UPDATE);
+
+BENCHMARK_MAIN();
+
+static void
+show_warning_if_debug()
+{
+#ifndef NDEBUG
+	std::cerr << "#######################################################\n"
+		  << "#######################################################\n"
+		  << "#######################################################\n"
+		  << "###                                                 ###\n"
+		  << "###                    WARNING!                     ###\n"
+		  << "###   The performance test is run in debug build!   ###\n"
+		  << "###   Test results are definitely inappropriate!    ###\n"
+		  << "###                                                 ###\n"
+		  << "#######################################################\n"
+		  << "#######################################################\n"
+		  << "#######################################################\n";
+#endif // #ifndef NDEBUG
+}
+
+struct DebugWarning {
+	DebugWarning() { show_warning_if_debug(); }
+} debug_warning;
@@ -240,6 +240,23 @@ index_opts_decode(struct index_opts *opts, const char *map,
 			 "less than or equal to 1");
 		return -1;
 	}
+	if (opts->compaction_policy == index_compaction_policy_MAX) {
+		diag_set(ClientError, ER_WRONG_INDEX_OPTIONS,
+			 BOX_INDEX_FIELD_OPTS, "compaction_policy must be "
+			 "either 'leveled' or 'tiered'");
+		return -1;
+	}
+	if (opts->compression_dict_size != 0 &&
+	    (opts->compression_dict_size < INDEX_COMPRESSION_DICT_SIZE_MIN ||
+	     opts->compression_dict_size > INDEX_COMPRESSION_DICT_SIZE_MAX)) {
+		diag_set(ClientError, ER_WRONG_INDEX_OPTIONS,
+			 BOX_INDEX_FIELD_OPTS,
+			 tt_sprintf("compression_dict_size must be either 0 "
+				    "or between %d and %d",
+				    INDEX_COMPRESSION_DICT_SIZE_MIN,
+				    INDEX_COMPRESSION_DICT_SIZE_MAX));
+		return -1;
+	}
 	return 0;
 }
 
@@ -667,6 +684,11 @@ space_def_new_from_tuple(struct tuple *tuple, uint32_t errcode,
 			 "local space can't be synchronous");
 		return NULL;
 	}
+	if (opts.memory_quota < 0) {
+		diag_set(ClientError, errcode, tt_cstr(name, name_len),
+			 "memory_quota must be non-negative");
+		return NULL;
+	}
 	struct space_def *def =
 		space_def_new(id, uid, exact_field_count, name, name_len,
 			      engine_name, engine_name_len, &opts, fields,
@@ -716,6 +738,13 @@ space_swap_constraint_ids(struct space *new_space, struct space *old_space)
 	SWAP(new_space->constraint_ids, old_space->constraint_ids);
 }
 
+/** Keep the latency statistics of a space across alter. */
+static void
+space_swap_latency(struct space *new_space, struct space *old_space)
+{
+	SWAP(new_space->latency, old_space->latency);
+}
+
 /**
  * True if the space has records identified by key 'uid'.
  * Uses 'iid' index.
@@ -1044,6 +1073,7 @@ alter_space_rollback(struct trigger *trigger, void * /* event */)
 	space_swap_triggers(alter->new_space, alter->old_space);
 	space_swap_fk_constraints(alter->new_space, alter->old_space);
 	space_swap_constraint_ids(alter->new_space, alter->old_space);
+	space_swap_latency(alter->new_space, alter->old_space);
 	space_cache_replace(alter->new_space, alter->old_space);
 	alter_space_delete(alter);
 	return 0;
@@ -1156,6 +1186,7 @@ alter_space_do(struct txn_stmt *stmt, struct alter_space *alter)
 	space_swap_triggers(alter->new_space, alter->old_space);
 	space_swap_fk_constraints(alter->new_space, alter->old_space);
 	space_swap_constraint_ids(alter->new_space, alter->old_space);
+	space_swap_latency(alter->new_space, alter->old_space);
 	/*
 	 * The new space is ready. Time to update the space
 	 * cache with it.
@@ -4610,6 +4641,7 @@ on_replace_dd_sequence(struct trigger * /* trigger */, void *event)
 		if (on_commit == NULL || on_rollback == NULL)
 			return -1;
 		seq->def = new_def;
+		sequence_release_reserved(seq);
 		txn_stmt_on_commit(stmt, on_commit);
 		txn_stmt_on_rollback(stmt, on_rollback);
 	}
@@ -180,6 +180,26 @@ applier_writer_f(va_list ap)
 				fiber_cond_wait_timeout(&applier->writer_cond,
 							replication_timeout);
 		}
+		/*
+		 * Let acks for WAL writes that follow shortly be sent
+		 * together with this one. Don't delay them while there
+		 * are synchronous transactions waiting for a quorum,
+		 * because the master can't confirm them until it gets
+		 * the acks. The delay is limited by the replication
+		 * timeout so that the master doesn't miss acks to its
+		 * heartbeats.
+		 */
+		if (applier->has_acks_to_send && replication_ack_interval > 0) {
+			double deadline = ev_monotonic_now(loop()) +
+					  MIN(replication_ack_interval,
+					      replication_timeout);
+			while (txn_limbo_is_empty(&txn_limbo)) {
+				if (fiber_cond_wait_deadline(
+						&applier->writer_cond,
+						deadline) != 0)
+					break;
+			}
+		}
 		/*
 		 * A writer fiber is going to be awaken after a commit or
 		 * a heartbeat message. So this is an appropriate place to
@@ -525,8 +545,8 @@ applier_fetch_snapshot(struct applier *applier)
 	struct iostream *io = &applier->io;
 	struct xrow_header row;
 
-	memset(&row, 0, sizeof(row));
-	row.type = IPROTO_FETCH_SNAPSHOT;
+	xrow_encode_fetch_snapshot_xc(&row, replication_space_filter,
+				      replication_space_filter_size);
 	coio_write_xrow(io, &row);
 
 	applier_set_state(applier, APPLIER_FETCH_SNAPSHOT);
@@ -604,8 +624,9 @@ applier_register(struct applier *applier, bool was_anon)
 	 * Send this instance's current vclock together
 	 * with REGISTER request.
 	 */
-	xrow_encode_register(&row, &INSTANCE_UUID, box_vclock);
-	row.type = IPROTO_REGISTER;
+	xrow_encode_register_xc(&row, &INSTANCE_UUID, box_vclock,
+				replication_space_filter,
+				replication_space_filter_size);
 	coio_write_xrow(io, &row);
 
 	/*
@@ -632,7 +653,8 @@ applier_join(struct applier *applier)
 	struct xrow_header row;
 	uint64_t row_count;
 
-	xrow_encode_join_xc(&row, &INSTANCE_UUID);
+	xrow_encode_join_xc(&row, &INSTANCE_UUID, replication_space_filter,
+			    replication_space_filter_size);
 	coio_write_xrow(io, &row);
 
 	applier_set_state(applier, APPLIER_INITIAL_JOIN);
@@ -674,10 +696,19 @@ applier_read_tx_row(struct applier *applier, double timeout)
 
 	ERROR_INJECT_YIELD(ERRINJ_APPLIER_READ_TX_ROW_DELAY);
 
-	coio_read_xrow_timeout_xc(io, ibuf, row, timeout);
+	if (applier->is_compressed) {
+		coio_read_xrow_decompress_timeout_xc(io,
+						     &applier->compressed_ibuf,
+						     &applier->decompressor,
+						     ibuf, row, timeout);
+	} else {
+		coio_read_xrow_timeout_xc(io, ibuf, row, timeout);
+	}
 
-	if (row->tm > 0)
+	if (row->tm > 0) {
 		applier->lag = ev_now(loop()) - row->tm;
+		latency_collect(&applier->recv_lag, applier->lag);
+	}
 	applier->last_row_time = ev_monotonic_now(loop());
 	return tx_row;
 }
@@ -763,6 +794,89 @@ applier_read_tx(struct applier *applier, struct stailq *rows, double timeout)
 	return row_count;
 }
 
+/**
+ * A transaction queued for applying by the parallel apply
+ * fiber pool.
+ */
+struct applier_ptx {
+	/** Link in applier_pool::queue. */
+	struct rlist in_queue;
+	/**
+	 * Number of the transaction in the order the transactions
+	 * were received. They are submitted to WAL in this order.
+	 */
+	int64_t ticket;
+	/** Applier that received the transaction. */
+	struct applier *applier;
+	/** Id of the instance the applier is connected to. */
+	uint32_t instance_id;
+	/** Set once a worker fiber has taken the transaction. */
+	bool is_started;
+	/**
+	 * Set if the transaction can't be applied concurrently
+	 * with any other one, e.g. a synchronous replication
+	 * request or a change of a system space.
+	 */
+	bool is_barrier;
+	/** Ids of the spaces changed by the transaction. */
+	uint32_t *space_ids;
+	/** Number of entries in space_ids. */
+	int space_count;
+	/** Transaction rows, stored right after the struct. */
+	struct stailq rows;
+};
+
+/**
+ * Fiber pool applying transactions received by appliers if
+ * replication_apply_fibers is greater than 1. Transactions
+ * changing disjoint sets of spaces are applied concurrently so
+ * that a transaction waiting for disk, e.g. in vinyl, doesn't
+ * stall the following ones. Still, transactions are submitted
+ * to WAL strictly in the order they were received, so the
+ * replica vclock follows the same path as in the sequential mode.
+ */
+static struct applier_pool {
+	/** Queued and running transactions, in ticket order. */
+	struct rlist queue;
+	/** Number of transactions in the queue. */
+	int size;
+	/** Ticket to assign to the next queued transaction. */
+	int64_t next_ticket;
+	/**
+	 * Transactions with tickets less than this one are aborted,
+	 * because a transaction queued before them failed.
+	 */
+	int64_t abort_ticket;
+	/** Vclock of the transactions submitted to WAL. */
+	struct vclock vclock;
+	/** Number of worker fibers, including idle ones. */
+	int fiber_count;
+	/** Number of worker fibers waiting for transactions. */
+	int idle_count;
+	/** Signaled whenever the queue changes. */
+	struct fiber_cond cond;
+} applier_pool;
+
+static void
+applier_pool_create(void)
+{
+	rlist_create(&applier_pool.queue);
+	applier_pool.size = 0;
+	applier_pool.next_ticket = 1;
+	applier_pool.abort_ticket = 0;
+	vclock_create(&applier_pool.vclock);
+	applier_pool.fiber_count = 0;
+	applier_pool.idle_count = 0;
+	fiber_cond_create(&applier_pool.cond);
+}
+
+/** Abort all transactions in the apply queue. */
+static void
+applier_pool_abort(void)
+{
+	applier_pool.abort_ticket = applier_pool.next_ticket;
+}
+
 static void
 applier_rollback_by_wal_io(int64_t signature)
 {
@@ -787,6 +901,10 @@ applier_rollback_by_wal_io(int64_t signature)
 
 	/* Rollback applier vclock to the committed one. */
 	vclock_copy(&replicaset.applier.vclock, &replicaset.vclock);
+
+	/* Abort the transactions queued for parallel apply. */
+	applier_pool_abort();
+	vclock_copy(&applier_pool.vclock, &replicaset.vclock);
 }
 
 static int
@@ -820,8 +938,13 @@ static void
 replica_txn_wal_write_cb(struct replica_cb_data *rcb)
 {
 	struct replica *r = replica_by_id(rcb->replica_id);
-	if (likely(r != NULL))
-		r->applier_txn_last_tm = rcb->txn_last_tm;
+	if (unlikely(r == NULL))
+		return;
+	r->applier_txn_last_tm = rcb->txn_last_tm;
+	if (r->applier != NULL && rcb->txn_last_tm > 0) {
+		latency_collect(&r->applier->wal_lag,
+				ev_now(loop()) - rcb->txn_last_tm);
+	}
 }
 
 static int
@@ -950,9 +1073,12 @@ applier_handle_raft(struct applier *applier, struct xrow_header *row)
 	return box_raft_process(&req, applier->instance_id);
 }
 
-static int
-apply_plain_tx(uint32_t replica_id, struct stailq *rows,
-	       bool skip_conflict, bool use_triggers)
+/**
+ * Begin a transaction and apply the rows to it. Returns the
+ * transaction ready to be committed or NULL on error.
+ */
+static struct txn *
+apply_plain_tx_rows(struct stailq *rows, bool skip_conflict)
 {
 	/*
 	 * Explicitly begin the transaction so that we can
@@ -963,7 +1089,7 @@ apply_plain_tx(uint32_t replica_id, struct stailq *rows,
 	struct txn *txn = txn_begin();
 	struct applier_tx_row *item;
 	if (txn == NULL)
-		 return -1;
+		 return NULL;
 
 	stailq_foreach_entry(item, rows, next) {
 		struct xrow_header *row = &item->row;
@@ -1005,7 +1131,18 @@ apply_plain_tx(uint32_t replica_id, struct stailq *rows,
 			 "distributed transactions");
 		goto fail;
 	}
+	return txn;
+fail:
+	txn_abort(txn);
+	return NULL;
+}
 
+/** Submit a transaction built by apply_plain_tx_rows() to WAL. */
+static int
+apply_plain_tx_commit(struct txn *txn, uint32_t replica_id,
+		      struct stailq *rows, bool use_triggers)
+{
+	struct applier_tx_row *item;
 	if (use_triggers) {
 		/* We are ready to submit txn to wal. */
 		struct trigger *on_rollback, *on_wal_write;
@@ -1045,12 +1182,28 @@ apply_plain_tx(uint32_t replica_id, struct stailq *rows,
 		txn_on_wal_write(txn, on_wal_write);
 	}
 
+	/*
+	 * Don't wait for the write: the transactions read from the
+	 * input buffer in one event loop iteration are submitted to
+	 * the same WAL batch, while each of them keeps its own journal
+	 * entry and so its own vclock boundary.
+	 */
 	return txn_commit_try_async(txn);
 fail:
 	txn_abort(txn);
 	return -1;
 }
 
+static int
+apply_plain_tx(uint32_t replica_id, struct stailq *rows,
+	       bool skip_conflict, bool use_triggers)
+{
+	struct txn *txn = apply_plain_tx_rows(rows, skip_conflict);
+	if (txn == NULL)
+		return -1;
+	return apply_plain_tx_commit(txn, replica_id, rows, use_triggers);
+}
+
 /** A simpler version of applier_apply_tx() for final join stage. */
 static int
 apply_final_join_tx(uint32_t replica_id, struct stailq *rows)
@@ -1062,6 +1215,7 @@ apply_final_join_tx(uint32_t replica_id, struct stailq *rows)
 	int rc = 0;
 	/* WAL isn't enabled yet, so follow vclock manually. */
 	vclock_follow_xrow(&replicaset.vclock, last_row);
+	fiber_cond_broadcast(&replicaset.vclock_cond);
 	if (unlikely(iproto_type_is_synchro_request(first_row->type))) {
 		assert(first_row == last_row);
 		rc = apply_synchro_row(replica_id, first_row);
@@ -1129,47 +1283,40 @@ nopify:;
 }
 
 /**
- * Apply all rows in the rows queue as a single transaction.
- *
- * Return 0 for success or -1 in case of an error.
+ * Return the latch ordering the rows of the instance that
+ * started the transaction.
  */
-static int
-applier_apply_tx(struct applier *applier, struct stailq *rows)
+static struct latch *
+applier_tx_latch(struct stailq *rows)
 {
-	/*
-	 * Initially we've been filtering out data if it came from
-	 * an applier which instance_id doesn't match raft->leader,
-	 * but this prevents from obtaining valid leader's data when
-	 * it comes from intermediate node. For example a series of
-	 * replica hops
-	 *
-	 *  master -> replica 1 -> replica 2
-	 *
-	 * where each replica carries master's initiated transaction
-	 * in xrow->replica_id field and master's data get propagated
-	 * indirectly.
-	 *
-	 * Finally we dropped such "sender" filtration and use transaction
-	 * "initiator" filtration via xrow->replica_id only.
-	 */
 	struct xrow_header *first_row = &stailq_first_entry(rows,
 					struct applier_tx_row, next)->row;
-	struct xrow_header *last_row;
-	last_row = &stailq_last_entry(rows, struct applier_tx_row, next)->row;
 	struct replica *replica = replica_by_id(first_row->replica_id);
-	int rc = 0;
 	/*
 	 * In a full mesh topology, the same set of changes
 	 * may arrive via two concurrently running appliers.
 	 * Hence we need a latch to strictly order all changes
 	 * that belong to the same server id.
 	 */
-	struct latch *latch = (replica ? &replica->order_latch :
-			       &replicaset.applier.order_latch);
-	latch_lock(latch);
+	return replica != NULL ? &replica->order_latch :
+	       &replicaset.applier.order_latch;
+}
+
+/**
+ * Drop the rows of a transaction that have already been applied.
+ * Returns true if the whole transaction has been applied. Must be
+ * called under the latch returned by applier_tx_latch().
+ */
+static bool
+applier_skip_applied_rows(struct stailq *rows)
+{
+	struct xrow_header *first_row = &stailq_first_entry(rows,
+					struct applier_tx_row, next)->row;
+	struct xrow_header *last_row;
+	last_row = &stailq_last_entry(rows, struct applier_tx_row, next)->row;
 	if (vclock_get(&replicaset.applier.vclock,
 		       last_row->replica_id) >= last_row->lsn) {
-		goto finish;
+		return true;
 	} else if (vclock_get(&replicaset.applier.vclock,
 			      first_row->replica_id) >= first_row->lsn) {
 		/*
@@ -1190,6 +1337,416 @@ applier_apply_tx(struct applier *applier, struct stailq *rows)
 			}
 		}
 	}
+	return false;
+}
+
+/**
+ * Wait until the transactions received by @applier, or by all
+ * appliers if @applier is NULL, are applied. Returns -1 if the
+ * fiber was cancelled.
+ */
+static int
+applier_pool_wait(struct applier *applier)
+{
+	while (applier != NULL ? applier->apply_queue_len > 0 :
+				 applier_pool.size > 0) {
+		if (fiber_cond_wait(&applier_pool.cond) != 0)
+			return -1;
+	}
+	return 0;
+}
+
+/** Check if it's the turn of the transaction to be submitted to WAL. */
+static inline bool
+applier_ptx_is_first(struct applier_ptx *ptx)
+{
+	return rlist_first_entry(&applier_pool.queue, struct applier_ptx,
+				 in_queue) == ptx;
+}
+
+static void
+applier_ptx_wait_turn(struct applier_ptx *ptx)
+{
+	/* The transaction can't be abandoned, ignore cancellation. */
+	while (!applier_ptx_is_first(ptx))
+		fiber_cond_wait(&applier_pool.cond);
+}
+
+/** Check if two transactions may not be applied concurrently. */
+static bool
+applier_ptx_conflicts(const struct applier_ptx *a, const struct applier_ptx *b)
+{
+	if (a->is_barrier || b->is_barrier)
+		return true;
+	for (int i = 0; i < a->space_count; i++) {
+		for (int j = 0; j < b->space_count; j++) {
+			if (a->space_ids[i] == b->space_ids[j])
+				return true;
+		}
+	}
+	return false;
+}
+
+/**
+ * Check if the transaction has to wait for a transaction queued
+ * before it to complete.
+ */
+static bool
+applier_ptx_is_blocked(struct applier_ptx *ptx)
+{
+	struct applier_ptx *prev;
+	rlist_foreach_entry(prev, &applier_pool.queue, in_queue) {
+		if (prev == ptx)
+			break;
+		if (applier_ptx_conflicts(prev, ptx))
+			return true;
+	}
+	return false;
+}
+
+/** Account the space changed by a row for conflict detection. */
+static void
+applier_ptx_add_space(struct applier_ptx *ptx, struct xrow_header *row)
+{
+	if (iproto_type_is_synchro_request(row->type)) {
+		ptx->is_barrier = true;
+		return;
+	}
+	if (row->type == IPROTO_NOP)
+		return;
+	struct request request;
+	if (xrow_decode_dml(row, &request, dml_request_key_map(row->type)) != 0) {
+		/* The error will be raised when the row is applied. */
+		diag_clear(diag_get());
+		ptx->is_barrier = true;
+		return;
+	}
+	struct space *space = space_by_id(request.space_id);
+	/*
+	 * Changes of system spaces may alter the schema while
+	 * triggers and foreign keys may make a change touch other
+	 * spaces.
+	 */
+	if (space == NULL || space_is_system(space) ||
+	    !rlist_empty(&space->before_replace) ||
+	    !rlist_empty(&space->on_replace) ||
+	    !rlist_empty(&space->parent_fk_constraint) ||
+	    !rlist_empty(&space->child_fk_constraint)) {
+		ptx->is_barrier = true;
+		return;
+	}
+	for (int i = 0; i < ptx->space_count; i++) {
+		if (ptx->space_ids[i] == request.space_id)
+			return;
+	}
+	ptx->space_ids[ptx->space_count++] = request.space_id;
+}
+
+/**
+ * Copy transaction rows from the applier input buffer and fiber
+ * region to a new queue entry.
+ */
+static struct applier_ptx *
+applier_ptx_new(struct applier *applier, struct stailq *rows)
+{
+	int row_count = 0;
+	size_t data_size = 0;
+	struct applier_tx_row *item;
+	stailq_foreach_entry(item, rows, next) {
+		++row_count;
+		if (item->row.bodycnt == 1)
+			data_size += item->row.body[0].iov_len;
+	}
+	size_t size = sizeof(struct applier_ptx) + data_size +
+		      row_count * (sizeof(struct applier_tx_row) +
+				   sizeof(uint32_t));
+	struct applier_ptx *ptx = (struct applier_ptx *)malloc(size);
+	if (ptx == NULL) {
+		diag_set(OutOfMemory, size, "malloc", "struct applier_ptx");
+		return NULL;
+	}
+	ptx->applier = applier;
+	ptx->instance_id = applier->instance_id;
+	ptx->is_started = false;
+	ptx->is_barrier = false;
+	ptx->space_count = 0;
+	stailq_create(&ptx->rows);
+	struct applier_tx_row *tx_row = (struct applier_tx_row *)(ptx + 1);
+	ptx->space_ids = (uint32_t *)(tx_row + row_count);
+	char *data = (char *)(ptx->space_ids + row_count);
+	stailq_foreach_entry(item, rows, next) {
+		*tx_row = *item;
+		struct xrow_header *row = &tx_row->row;
+		assert(row->bodycnt <= 1);
+		if (row->bodycnt == 1) {
+			memcpy(data, row->body[0].iov_base,
+			       row->body[0].iov_len);
+			row->body[0].iov_base = data;
+			data += row->body[0].iov_len;
+		}
+		stailq_add_tail_entry(&ptx->rows, tx_row, next);
+		applier_ptx_add_space(ptx, row);
+		++tx_row;
+	}
+	return ptx;
+}
+
+/**
+ * Handle a failure to apply a transaction. Called when all the
+ * transactions queued before it are complete.
+ */
+static void
+applier_ptx_fail(struct applier_ptx *ptx)
+{
+	if (ptx->ticket >= applier_pool.abort_ticket) {
+		/*
+		 * The transactions queued after the failed one may
+		 * depend on it. Abort them and roll back the applier
+		 * vclock so that the rows may be received again.
+		 */
+		applier_pool_abort();
+		vclock_copy(&replicaset.applier.vclock, &applier_pool.vclock);
+	}
+	struct applier *applier = ptx->applier;
+	if (diag_is_empty(&applier->diag))
+		diag_move(diag_get(), &applier->diag);
+	else
+		diag_clear(diag_get());
+	/* Stop the applier as in the sequential mode. */
+	if (applier->reader != NULL)
+		fiber_cancel(applier->reader);
+}
+
+/** Apply a queued transaction and submit it to WAL. */
+static int
+applier_ptx_execute(struct applier_ptx *ptx)
+{
+	struct stailq *rows = &ptx->rows;
+	struct xrow_header *first_row = &stailq_first_entry(rows,
+					struct applier_tx_row, next)->row;
+	applier_synchro_filter_tx(rows);
+	if (unlikely(iproto_type_is_synchro_request(first_row->type))) {
+		/* Synchro requests are barriers. */
+		assert(applier_ptx_is_first(ptx));
+		return apply_synchro_row(ptx->instance_id, first_row);
+	}
+	struct txn *txn = apply_plain_tx_rows(rows, replication_skip_conflict);
+	if (txn == NULL)
+		return -1;
+	if (!applier_ptx_is_first(ptx) && !txn_has_flag(txn, TXN_CAN_YIELD)) {
+		/*
+		 * The engine doesn't support yields so the transaction
+		 * would be aborted while waiting for its turn. Apply it
+		 * again once the preceding transactions are submitted.
+		 */
+		txn_abort(txn);
+		applier_ptx_wait_turn(ptx);
+		if (ptx->ticket < applier_pool.abort_ticket) {
+			diag_set(ClientError, ER_CASCADE_ROLLBACK);
+			return -1;
+		}
+		txn = apply_plain_tx_rows(rows, replication_skip_conflict);
+		if (txn == NULL)
+			return -1;
+	}
+	applier_ptx_wait_turn(ptx);
+	if (ptx->ticket < applier_pool.abort_ticket) {
+		txn_abort(txn);
+		diag_set(ClientError, ER_CASCADE_ROLLBACK);
+		return -1;
+	}
+	return apply_plain_tx_commit(txn, ptx->instance_id, rows, true);
+}
+
+static void
+applier_ptx_apply(struct applier_ptx *ptx)
+{
+	struct applier_pool *pool = &applier_pool;
+	while (applier_ptx_is_blocked(ptx))
+		fiber_cond_wait(&pool->cond);
+	int rc = -1;
+	if (ptx->ticket < pool->abort_ticket)
+		diag_set(ClientError, ER_CASCADE_ROLLBACK);
+	else
+		rc = applier_ptx_execute(ptx);
+	/* Complete transactions in the order they were received. */
+	applier_ptx_wait_turn(ptx);
+	if (rc == 0) {
+		struct xrow_header *last_row = &stailq_last_entry(&ptx->rows,
+					struct applier_tx_row, next)->row;
+		if (vclock_get(&pool->vclock,
+			       last_row->replica_id) < last_row->lsn) {
+			vclock_follow(&pool->vclock, last_row->replica_id,
+				      last_row->lsn);
+		}
+	} else {
+		applier_ptx_fail(ptx);
+	}
+	rlist_del_entry(ptx, in_queue);
+	pool->size--;
+	ptx->applier->apply_queue_len--;
+	fiber_cond_broadcast(&pool->cond);
+	free(ptx);
+	fiber_gc();
+}
+
+/** Take the first queued transaction no worker has taken yet. */
+static struct applier_ptx *
+applier_pool_take(void)
+{
+	struct applier_ptx *ptx;
+	rlist_foreach_entry(ptx, &applier_pool.queue, in_queue) {
+		if (!ptx->is_started) {
+			ptx->is_started = true;
+			return ptx;
+		}
+	}
+	return NULL;
+}
+
+static int
+applier_pool_worker_f(va_list ap)
+{
+	(void)ap;
+	struct applier_pool *pool = &applier_pool;
+	/*
+	 * Set correct session type for use in on_replace()
+	 * triggers.
+	 */
+	struct session *session = session_create_on_demand();
+	if (session == NULL) {
+		pool->fiber_count--;
+		return -1;
+	}
+	session_set_type(session, SESSION_TYPE_APPLIER);
+	while (!fiber_is_cancelled()) {
+		struct applier_ptx *ptx = applier_pool_take();
+		if (ptx != NULL) {
+			applier_ptx_apply(ptx);
+			continue;
+		}
+		/* The pool was shrunk. */
+		if (pool->fiber_count > replication_apply_fibers)
+			break;
+		pool->idle_count++;
+		fiber_cond_wait(&pool->cond);
+		pool->idle_count--;
+	}
+	pool->fiber_count--;
+	return 0;
+}
+
+/** Start a new worker fiber unless there is an idle one. */
+static int
+applier_pool_start_worker(void)
+{
+	struct applier_pool *pool = &applier_pool;
+	if (pool->idle_count > 0 ||
+	    pool->fiber_count >= replication_apply_fibers)
+		return 0;
+	struct fiber *f = fiber_new("applier_pool", applier_pool_worker_f);
+	if (f == NULL) {
+		if (pool->fiber_count == 0)
+			return -1;
+		/* Make do with the running workers. */
+		diag_log();
+		diag_clear(diag_get());
+		return 0;
+	}
+	pool->fiber_count++;
+	fiber_start(f);
+	return 0;
+}
+
+/**
+ * Queue a transaction for applying by the parallel apply fiber
+ * pool. The function doesn't wait for the transaction to be
+ * applied.
+ */
+static int
+applier_queue_tx(struct applier *applier, struct stailq *rows)
+{
+	struct applier_pool *pool = &applier_pool;
+	/* Limit the memory used by queued transactions. */
+	while (pool->size >= 2 * replication_apply_fibers) {
+		if (fiber_cond_wait(&pool->cond) != 0) {
+			fiber_gc();
+			return -1;
+		}
+	}
+	int rc = 0;
+	struct latch *latch = applier_tx_latch(rows);
+	latch_lock(latch);
+	if (!applier_skip_applied_rows(rows)) {
+		struct applier_ptx *ptx = applier_ptx_new(applier, rows);
+		if (ptx == NULL || applier_pool_start_worker() != 0) {
+			free(ptx);
+			rc = -1;
+		} else {
+			if (pool->size == 0) {
+				vclock_copy(&pool->vclock,
+					    &replicaset.applier.vclock);
+			}
+			ptx->ticket = pool->next_ticket++;
+			rlist_add_tail_entry(&pool->queue, ptx, in_queue);
+			pool->size++;
+			applier->apply_queue_len++;
+			fiber_cond_broadcast(&pool->cond);
+			/*
+			 * Follow the vclock right away so that the rows
+			 * received by other appliers are skipped.
+			 */
+			struct xrow_header *last_row = &stailq_last_entry(
+				&ptx->rows, struct applier_tx_row, next)->row;
+			vclock_follow(&replicaset.applier.vclock,
+				      last_row->replica_id, last_row->lsn);
+		}
+	}
+	latch_unlock(latch);
+	fiber_gc();
+	return rc;
+}
+
+/**
+ * Apply all rows in the rows queue as a single transaction.
+ *
+ * Return 0 for success or -1 in case of an error.
+ */
+static int
+applier_apply_tx(struct applier *applier, struct stailq *rows)
+{
+	/*
+	 * Initially we've been filtering out data if it came from
+	 * an applier which instance_id doesn't match raft->leader,
+	 * but this prevents from obtaining valid leader's data when
+	 * it comes from intermediate node. For example a series of
+	 * replica hops
+	 *
+	 *  master -> replica 1 -> replica 2
+	 *
+	 * where each replica carries master's initiated transaction
+	 * in xrow->replica_id field and master's data get propagated
+	 * indirectly.
+	 *
+	 * Finally we dropped such "sender" filtration and use transaction
+	 * "initiator" filtration via xrow->replica_id only.
+	 */
+	struct xrow_header *first_row = &stailq_first_entry(rows,
+					struct applier_tx_row, next)->row;
+	struct xrow_header *last_row;
+	last_row = &stailq_last_entry(rows, struct applier_tx_row, next)->row;
+	if (replication_apply_fibers > 1)
+		return applier_queue_tx(applier, rows);
+	/* Let the transactions queued in the parallel mode complete. */
+	if (applier_pool_wait(NULL) != 0) {
+		fiber_gc();
+		return -1;
+	}
+	int rc = 0;
+	struct latch *latch = applier_tx_latch(rows);
+	latch_lock(latch);
+	if (applier_skip_applied_rows(rows))
+		goto finish;
 	applier_synchro_filter_tx(rows);
 	if (unlikely(iproto_type_is_synchro_request(first_row->type))) {
 		/*
@@ -1281,7 +1838,10 @@ applier_subscribe(struct applier *applier)
 	 */
 	uint32_t id_filter = box_is_orphan() ? 0 : 1 << instance_id;
 	xrow_encode_subscribe_xc(&row, &REPLICASET_UUID, &INSTANCE_UUID,
-				 &vclock, replication_anon, id_filter);
+				 &vclock, replication_anon, id_filter,
+				 replication_compression,
+				 replication_space_filter,
+				 replication_space_filter_size);
 	coio_write_xrow(io, &row);
 
 	/* Read SUBSCRIBE response */
@@ -1301,8 +1861,10 @@ applier_subscribe(struct applier *applier)
 		 * the replica, and replica has to check whether
 		 * its and master's cluster ids match.
 		 */
+		bool compression;
 		xrow_decode_subscribe_response_xc(&row, &cluster_id,
-					&applier->remote_vclock_at_subscribe);
+					&applier->remote_vclock_at_subscribe,
+					&compression);
 		applier->instance_id = row.replica_id;
 		/*
 		 * If master didn't send us its cluster id
@@ -1316,7 +1878,25 @@ applier_subscribe(struct applier *applier)
 				  tt_uuid_str(&REPLICASET_UUID));
 		}
 
-		say_info("subscribed");
+		if (compression) {
+			/*
+			 * Everything that follows the response is
+			 * compressed, including the input we may
+			 * have read ahead.
+			 */
+			size_t size = ibuf_used(ibuf);
+			void *data = ibuf_alloc(&applier->compressed_ibuf,
+						size);
+			if (data == NULL) {
+				tnt_raise(OutOfMemory, size, "ibuf_alloc",
+					  "compressed input");
+			}
+			memcpy(data, ibuf->rpos, size);
+			ibuf_reset(ibuf);
+			applier->is_compressed = true;
+		}
+
+		say_info("subscribed%s", compression ? " with compression" : "");
 		say_info("remote vclock %s local vclock %s",
 			 vclock_to_string(&applier->remote_vclock_at_subscribe),
 			 vclock_to_string(&vclock));
@@ -1366,6 +1946,8 @@ applier_subscribe(struct applier *applier)
 	}
 
 	applier->lag = TIMEOUT_INFINITY;
+	latency_reset(&applier->recv_lag);
+	latency_reset(&applier->wal_lag);
 
 	/*
 	 * Register triggers to handle WAL writes and rollbacks.
@@ -1423,7 +2005,13 @@ applier_subscribe(struct applier *applier)
 		if (first_row->lsn == 0) {
 			if (unlikely(iproto_type_is_raft_request(
 							first_row->type))) {
-				if (applier_handle_raft(applier,
+				/*
+				 * Raft state affects filtering of
+				 * synchronous transactions, so apply
+				 * the preceding ones first.
+				 */
+				if (applier_pool_wait(applier) != 0 ||
+				    applier_handle_raft(applier,
 							first_row) != 0)
 					diag_raise();
 			}
@@ -1450,6 +2038,8 @@ applier_disconnect(struct applier *applier, enum applier_state state)
 		iostream_close(&applier->io);
 	/* Clear all unparsed input. */
 	ibuf_reinit(&applier->ibuf);
+	ibuf_reinit(&applier->compressed_ibuf);
+	applier->is_compressed = false;
 	fiber_gc();
 }
 
@@ -1653,6 +2243,9 @@ applier_stop(struct applier *applier)
 	fiber_join(f);
 	applier_set_state(applier, APPLIER_OFF);
 	applier->reader = NULL;
+	/* Queued transactions refer to the applier. */
+	while (applier_pool_wait(applier) != 0)
+		diag_clear(diag_get());
 }
 
 struct applier *
@@ -1666,6 +2259,8 @@ applier_new(struct uri *uri)
 	}
 	iostream_clear(&applier->io);
 	ibuf_create(&applier->ibuf, &cord()->slabc, 1024);
+	ibuf_create(&applier->compressed_ibuf, &cord()->slabc, 1024);
+	iproto_decompressor_create(&applier->decompressor);
 
 	uri_move(&applier->uri, uri);
 	applier->last_row_time = ev_monotonic_now(loop());
@@ -1673,7 +2268,14 @@ applier_new(struct uri *uri)
 	fiber_cond_create(&applier->resume_cond);
 	fiber_cond_create(&applier->writer_cond);
 	diag_create(&applier->diag);
-
+	applier->apply_queue_len = 0;
+	if (latency_create(&applier->recv_lag) != 0 ||
+	    latency_create(&applier->wal_lag) != 0)
+		panic("failed to allocate applier lag statistics");
+
+	/* The pool is created along with the first applier. */
+	if (applier_pool.next_ticket == 0)
+		applier_pool_create();
 	return applier;
 }
 
@@ -1684,9 +2286,13 @@ applier_delete(struct applier *applier)
 	assert(!iostream_is_initialized(&applier->io));
 	iostream_ctx_destroy(&applier->io_ctx);
 	ibuf_destroy(&applier->ibuf);
+	ibuf_destroy(&applier->compressed_ibuf);
+	iproto_decompressor_destroy(&applier->decompressor);
 	uri_destroy(&applier->uri);
 	trigger_destroy(&applier->on_state);
 	diag_destroy(&applier->diag);
+	latency_destroy(&applier->recv_lag);
+	latency_destroy(&applier->wal_lag);
 	free(applier);
 }
 
@@ -39,6 +39,8 @@
 
 #include "fiber_cond.h"
 #include "iostream.h"
+#include "iproto_compress.h"
+#include "latency.h"
 #include "trigger.h"
 #include "trivia/util.h"
 #include "tt_uuid.h"
@@ -98,6 +100,16 @@ struct applier {
 	ev_tstamp last_row_time;
 	/** Number of seconds this replica is behind the remote master */
 	ev_tstamp lag;
+	/**
+	 * Time between the master WAL write of a row and receiving
+	 * the row, observed since the applier subscribed.
+	 */
+	struct latency recv_lag;
+	/**
+	 * Time between the master WAL write of a transaction and
+	 * writing it to the local WAL.
+	 */
+	struct latency wal_lag;
 	/** The last box_error_code() logged to avoid log flooding */
 	uint32_t last_logged_errcode;
 	/** Remote instance ID. */
@@ -123,6 +135,16 @@ struct applier {
 	struct iostream io;
 	/** Input buffer */
 	struct ibuf ibuf;
+	/**
+	 * Set if the master compresses the replication stream. The
+	 * input is then read into compressed_ibuf and decompressed
+	 * into ibuf.
+	 */
+	bool is_compressed;
+	/** Compressed input that hasn't been decompressed yet. */
+	struct ibuf compressed_ibuf;
+	/** Decompression context. */
+	struct iproto_decompressor decompressor;
 	/** Triggers invoked on state change */
 	struct rlist on_state;
 	/**
@@ -136,6 +158,11 @@ struct applier {
 	struct diag diag;
 	/* Master's vclock at the time of SUBSCRIBE. */
 	struct vclock remote_vclock_at_subscribe;
+	/**
+	 * Number of transactions received by the applier and
+	 * queued for parallel apply, see replication_apply_fibers.
+	 */
+	int apply_queue_len;
 };
 
 /**
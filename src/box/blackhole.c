@@ -40,6 +40,24 @@
 #include "txn.h"
 #include "tuple.h"
 #include "xrow.h"
+#include "iproto_constants.h"
+#include "info/info.h"
+
+/** Statistics of one statement type, see blackhole_space_stat(). */
+struct blackhole_stat {
+	/** Number of executed statements. */
+	uint64_t rows;
+	/** Size of their tuples, in bytes. */
+	uint64_t bytes;
+};
+
+struct blackhole_space {
+	struct space base;
+	/** INSERT statements. */
+	struct blackhole_stat insert;
+	/** REPLACE statements. */
+	struct blackhole_stat replace;
+};
 
 static void
 blackhole_space_destroy(struct space *space)
@@ -47,17 +65,62 @@ blackhole_space_destroy(struct space *space)
 	free(space);
 }
 
+static void
+blackhole_space_stat(struct space *space, struct info_handler *h)
+{
+	struct blackhole_space *bh_space = (struct blackhole_space *)space;
+	info_begin(h);
+	info_table_begin(h, "insert");
+	info_append_int(h, "rows", bh_space->insert.rows);
+	info_append_int(h, "bytes", bh_space->insert.bytes);
+	info_table_end(h);
+	info_table_begin(h, "replace");
+	info_append_int(h, "rows", bh_space->replace.rows);
+	info_append_int(h, "bytes", bh_space->replace.bytes);
+	info_table_end(h);
+	info_end(h);
+}
+
+/**
+ * Check if nobody is going to see the tuple of a statement: the
+ * statement is applied from a journal, by recovery or by the
+ * applier, which ignore the result, and there are no on_replace
+ * triggers. before_replace triggers make their own tuples, see
+ * space_before_replace().
+ */
+static bool
+blackhole_tuple_is_unused(struct space *space, struct request *request)
+{
+	return request->header != NULL && request->header->replica_id != 0 &&
+	       (rlist_empty(&space->on_replace) || !space->run_triggers);
+}
+
 static int
 blackhole_space_execute_replace(struct space *space, struct txn *txn,
 				struct request *request, struct tuple **result)
 {
-	struct txn_stmt *stmt = txn_current_stmt(txn);
-	stmt->new_tuple = tuple_new(space->format, request->tuple,
-				    request->tuple_end);
-	if (stmt->new_tuple == NULL)
-		return -1;
-	tuple_ref(stmt->new_tuple);
-	*result = stmt->new_tuple;
+	struct blackhole_space *bh_space = (struct blackhole_space *)space;
+	struct blackhole_stat *stat = request->type == IPROTO_INSERT ?
+				      &bh_space->insert : &bh_space->replace;
+	/*
+	 * The row is written to WAL from the request, so the
+	 * tuple is only needed for the result and triggers.
+	 */
+	if (blackhole_tuple_is_unused(space, request)) {
+		if (tuple_validate_raw(space->format, request->tuple) != 0)
+			return -1;
+		*result = NULL;
+	} else {
+		struct txn_stmt *stmt = txn_current_stmt(txn);
+		stmt->new_tuple = tuple_new(space->format, request->tuple,
+					    request->tuple_end);
+		if (stmt->new_tuple == NULL)
+			return -1;
+		tuple_ref(stmt->new_tuple);
+		*result = stmt->new_tuple;
+	}
+	stat->rows++;
+	stat->bytes += request->tuple_end - request->tuple;
 	return 0;
 }
 
@@ -106,9 +169,22 @@ blackhole_space_create_index(struct space *space, struct index_def *def)
 	return NULL;
 }
 
+static int
+blackhole_space_prepare_alter(struct space *old_space, struct space *new_space)
+{
+	struct blackhole_space *old_bh_space =
+		(struct blackhole_space *)old_space;
+	struct blackhole_space *new_bh_space =
+		(struct blackhole_space *)new_space;
+	new_bh_space->insert = old_bh_space->insert;
+	new_bh_space->replace = old_bh_space->replace;
+	return 0;
+}
+
 static const struct space_vtab blackhole_space_vtab = {
 	/* .destroy = */ blackhole_space_destroy,
 	/* .bsize = */ generic_space_bsize,
+	/* .stat = */ blackhole_space_stat,
 	/* .execute_replace = */ blackhole_space_execute_replace,
 	/* .execute_delete = */ blackhole_space_execute_delete,
 	/* .execute_update = */ blackhole_space_execute_update,
@@ -125,7 +201,7 @@ static const struct space_vtab blackhole_space_vtab = {
 	/* .check_format = */ generic_space_check_format,
 	/* .build_index = */ generic_space_build_index,
 	/* .swap_index = */ generic_space_swap_index,
-	/* .prepare_alter = */ generic_space_prepare_alter,
+	/* .prepare_alter = */ blackhole_space_prepare_alter,
 	/* .invalidate = */ generic_space_invalidate,
 };
 
@@ -144,12 +220,14 @@ blackhole_engine_create_space(struct engine *engine, struct space_def *def,
 		return NULL;
 	}
 
-	struct space *space = (struct space *)calloc(1, sizeof(*space));
-	if (space == NULL) {
-		diag_set(OutOfMemory, sizeof(*space),
-			 "malloc", "struct space");
+	struct blackhole_space *bh_space =
+		(struct blackhole_space *)calloc(1, sizeof(*bh_space));
+	if (bh_space == NULL) {
+		diag_set(OutOfMemory, sizeof(*bh_space),
+			 "malloc", "struct blackhole_space");
 		return NULL;
 	}
+	struct space *space = &bh_space->base;
 
 	/* Allocate tuples on runtime arena, but check space format. */
 	struct tuple_format *format;
@@ -58,12 +58,14 @@
 #include "vinyl.h"
 #include "space.h"
 #include "index.h"
+#include "op_latency.h"
 #include "port.h"
 #include "txn.h"
 #include "txn_limbo.h"
 #include "user.h"
 #include "cfg.h"
 #include "coio.h"
+#include "fio.h"
 #include "replication.h" /* replica */
 #include "title.h"
 #include "xrow.h"
@@ -108,6 +110,8 @@ static void title(const char *new_status)
 
 const struct vclock *box_vclock = &replicaset.vclock;
 
+const struct recovery *box_hot_standby = NULL;
+
 /**
  * Set if backup is in progress, i.e. box_backup_start() was
  * called but box_backup_stop() hasn't been yet.
@@ -121,6 +125,13 @@ static bool backup_is_in_progress;
  */
 static struct gc_checkpoint_ref backup_gc;
 
+/**
+ * If an incremental backup is in progress, this is the consumer
+ * that prevents the garbage collector from deleting the WAL
+ * files that are currently being backed up.
+ */
+static struct gc_consumer *backup_wal_gc;
+
 /**
  * The instance is in read-write mode: the local checkpoint
  * and all write ahead logs are processed. For a replica,
@@ -129,6 +140,8 @@ static struct gc_checkpoint_ref backup_gc;
  */
 static bool is_box_configured = false;
 static bool is_ro = true;
+/** CPU the TX thread is pinned to or -1, see box.cfg.tx_cpu_affinity. */
+static int tx_cpu = -1;
 static fiber_cond ro_cond;
 
 /**
@@ -278,6 +291,7 @@ box_process_rw(struct request *request, struct space *space,
 {
 	struct tuple *tuple = NULL;
 	bool return_tuple = false;
+	double start;
 	struct txn *txn = in_txn();
 	bool is_autocommit = txn == NULL;
 	if (is_autocommit && (txn = txn_begin()) == NULL)
@@ -288,10 +302,17 @@ box_process_rw(struct request *request, struct space *space,
 		goto rollback;
 	if (txn_begin_stmt(txn, space, request->type) != 0)
 		goto rollback;
+	start = op_latency_start();
 	if (space_execute_dml(space, txn, request, &tuple) != 0) {
 		txn_rollback_stmt(txn);
 		goto rollback;
 	}
+	if (start != 0) {
+		int type = op_latency_type_by_request(request->type);
+		if (type >= 0)
+			op_latency_collect(&space->latency,
+					   (enum op_latency_type)type, start);
+	}
 	if (result != NULL)
 		*result = tuple;
 
@@ -346,6 +367,12 @@ box_is_ro(void)
 	return is_ro_summary;
 }
 
+int
+box_tx_cpu(void)
+{
+	return tx_cpu;
+}
+
 bool
 box_is_orphan(void)
 {
@@ -363,6 +390,18 @@ box_wait_ro(bool ro, double timeout)
 	return 0;
 }
 
+int
+box_wait_vclock(const struct vclock *vclock, double timeout)
+{
+	double deadline = ev_monotonic_now(loop()) + timeout;
+	while (vclock_compare_ignore0(vclock, &replicaset.vclock) > 0) {
+		if (fiber_cond_wait_deadline(&replicaset.vclock_cond,
+					     deadline) != 0)
+			return -1;
+	}
+	return 0;
+}
+
 void
 box_do_set_orphan(bool orphan)
 {
@@ -731,6 +770,19 @@ box_check_say(void)
 	}
 }
 
+static enum say_async_overflow
+box_check_log_async_overflow(void)
+{
+	const char *name = cfg_gets("log_async_overflow");
+	enum say_async_overflow overflow = name == NULL ?
+		say_async_overflow_MAX : say_async_overflow_by_name(name);
+	if (overflow == say_async_overflow_MAX) {
+		diag_set(ClientError, ER_CFG, "log_async_overflow",
+			 "expected 'drop' or 'block'");
+	}
+	return overflow;
+}
+
 static enum election_mode
 box_check_election_mode(void)
 {
@@ -838,6 +890,45 @@ box_check_replication_connect_quorum(void)
 	return quorum;
 }
 
+static int
+box_check_replication_apply_fibers(void)
+{
+	int count = cfg_geti("replication_apply_fibers");
+	if (count < 1 || count > REPLICATION_APPLY_FIBERS_MAX) {
+		tnt_raise(ClientError, ER_CFG, "replication_apply_fibers",
+			  tt_sprintf("the value must be in range [1, %d]",
+				     REPLICATION_APPLY_FIBERS_MAX));
+	}
+	return count;
+}
+
+/**
+ * Checks box.cfg.replication_space_filter and stores the space
+ * ids in @a ids unless it's NULL. Returns the number of ids (0 if
+ * the option isn't set) or -1 on error.
+ */
+static int
+box_check_replication_space_filter(uint32_t *ids)
+{
+	int count = cfg_getarr_size("replication_space_filter");
+	for (int i = 0; i < count; i++) {
+		const char *str = cfg_getarr_elem("replication_space_filter",
+						  i);
+		char *end = NULL;
+		long long id = str != NULL ? strtoll(str, &end, 10) : -1;
+		if (id <= 0 || id > BOX_SPACE_MAX || *str == '\0' ||
+		    *end != '\0') {
+			diag_set(ClientError, ER_CFG,
+				 "replication_space_filter",
+				 "must contain space ids");
+			return -1;
+		}
+		if (ids != NULL)
+			ids[i] = id;
+	}
+	return count;
+}
+
 static double
 box_check_replication_sync_lag(void)
 {
@@ -985,6 +1076,17 @@ box_check_replication_sync_timeout(void)
 	return timeout;
 }
 
+static double
+box_check_replication_ack_interval(void)
+{
+	double interval = cfg_getd("replication_ack_interval");
+	if (interval < 0) {
+		tnt_raise(ClientError, ER_CFG, "replication_ack_interval",
+			  "the value must be greater than or equal to 0");
+	}
+	return interval;
+}
+
 static inline void
 box_check_uuid(struct tt_uuid *uuid, const char *name)
 {
@@ -1048,6 +1150,17 @@ box_check_wal_mode(const char *mode_name)
 	return (enum wal_mode) mode;
 }
 
+static enum fio_backend
+box_check_io_backend(const char *backend_name)
+{
+	assert(backend_name != NULL); /* checked in Lua */
+	int backend = strindex(fio_backend_strs, backend_name,
+			       fio_backend_MAX);
+	if (backend == fio_backend_MAX)
+		tnt_raise(ClientError, ER_CFG, "io_backend", backend_name);
+	return (enum fio_backend) backend;
+}
+
 static int64_t
 box_check_wal_queue_max_size(void)
 {
@@ -1075,6 +1188,50 @@ box_check_wal_cleanup_delay(void)
 	return value;
 }
 
+static double
+box_check_checkpoint_write_duration(void)
+{
+	double value = cfg_getd("checkpoint_write_duration");
+	if (value < 0) {
+		diag_set(ClientError, ER_CFG, "checkpoint_write_duration",
+			 "value must be >= 0");
+		return -1;
+	}
+	return value;
+}
+
+static int
+box_check_wal_group_commit(void)
+{
+	if (cfg_getd("wal_group_commit_timeout") < 0) {
+		diag_set(ClientError, ER_CFG, "wal_group_commit_timeout",
+			 "value must be >= 0");
+		return -1;
+	}
+	if (cfg_geti64("wal_group_commit_max_size") <= 0) {
+		diag_set(ClientError, ER_CFG, "wal_group_commit_max_size",
+			 "value must be > 0");
+		return -1;
+	}
+	if (cfg_geti64("wal_group_commit_max_entries") <= 0) {
+		diag_set(ClientError, ER_CFG, "wal_group_commit_max_entries",
+			 "value must be > 0");
+		return -1;
+	}
+	return 0;
+}
+
+static int
+box_check_wal_ring_size(void)
+{
+	if (cfg_geti64("wal_ring_size") < 0) {
+		diag_set(ClientError, ER_CFG, "wal_ring_size",
+			 "value must be >= 0");
+		return -1;
+	}
+	return 0;
+}
+
 static void
 box_check_readahead(int readahead)
 {
@@ -1170,6 +1327,17 @@ box_check_sql_cache_size(int size)
 	return 0;
 }
 
+static int
+box_check_sql_plan_cache_size(int size)
+{
+	if (size < 0) {
+		diag_set(ClientError, ER_CFG, "sql_plan_cache_size",
+			 "must be non-negative");
+		return -1;
+	}
+	return 0;
+}
+
 static int
 box_check_allocator(void)
 {
@@ -1183,6 +1351,21 @@ box_check_allocator(void)
 	return 0;
 }
 
+static int
+box_check_memtx_sort_threads(void)
+{
+	enum { MEMTX_SORT_THREADS_MAX = 256 };
+	int threads = cfg_geti("memtx_sort_threads");
+	if (threads < 1 || threads > MEMTX_SORT_THREADS_MAX) {
+		diag_set(ClientError, ER_CFG, "memtx_sort_threads",
+			 tt_sprintf("must be greater than or equal to 1,"
+				    " less than or equal to %d",
+				    MEMTX_SORT_THREADS_MAX));
+		return -1;
+	}
+	return threads;
+}
+
 static void
 box_check_small_alloc_options(void)
 {
@@ -1221,6 +1404,55 @@ box_check_iproto_options(void)
 	return 0;
 }
 
+/**
+ * Checks box.cfg.iproto_cpu_affinity and stores the CPU of each
+ * iproto thread in @a cpus unless it's NULL. Returns the number
+ * of CPUs (0 if the option isn't set) or -1 on error.
+ */
+static int
+box_check_iproto_cpu_affinity(int *cpus)
+{
+	int count = cfg_getarr_size("iproto_cpu_affinity");
+	if (count != 0 && count != cfg_geti("iproto_threads")) {
+		diag_set(ClientError, ER_CFG, "iproto_cpu_affinity",
+			 "must contain a CPU for each iproto thread");
+		return -1;
+	}
+	for (int i = 0; i < count; i++) {
+		const char *str = cfg_getarr_elem("iproto_cpu_affinity", i);
+		char *end = NULL;
+		long cpu = str != NULL ? strtol(str, &end, 10) : -1;
+		if (cpu < 0 || cpu > INT_MAX || *str == '\0' || *end != '\0') {
+			diag_set(ClientError, ER_CFG, "iproto_cpu_affinity",
+				 "must contain non-negative integers");
+			return -1;
+		}
+		if (cpus != NULL)
+			cpus[i] = cpu;
+	}
+	return count;
+}
+
+/**
+ * Checks a box.cfg option that pins a thread to a CPU and stores
+ * the CPU in @a cpu or -1 if the option isn't set.
+ */
+static int
+box_check_cpu_affinity(const char *option, int *cpu)
+{
+	*cpu = -1;
+	if (!cfg_isnumber(option))
+		return 0;
+	double value = cfg_getd(option);
+	if (value < 0 || value > INT_MAX || value != (int)value) {
+		diag_set(ClientError, ER_CFG, option,
+			 "must be a non-negative integer");
+		return -1;
+	}
+	*cpu = value;
+	return 0;
+}
+
 static double
 box_check_txn_timeout(void)
 {
@@ -1238,6 +1470,8 @@ box_check_config(void)
 {
 	struct tt_uuid uuid;
 	box_check_say();
+	if (box_check_log_async_overflow() == say_async_overflow_MAX)
+		diag_raise();
 	if (box_check_listen() != 0)
 		diag_raise();
 	box_check_instance_uuid(&uuid);
@@ -1252,30 +1486,52 @@ box_check_config(void)
 	box_check_replication_connect_timeout();
 	box_check_replication_connect_quorum();
 	box_check_replication_sync_lag();
+	box_check_replication_apply_fibers();
+	if (box_check_replication_space_filter(NULL) < 0)
+		diag_raise();
 	if (box_check_replication_synchro_quorum() != 0)
 		diag_raise();
 	if (box_check_replication_synchro_timeout() < 0)
 		diag_raise();
 	box_check_replication_sync_timeout();
+	box_check_replication_ack_interval();
 	box_check_readahead(cfg_geti("readahead"));
 	box_check_checkpoint_count(cfg_geti("checkpoint_count"));
+	if (box_check_checkpoint_write_duration() < 0)
+		diag_raise();
 	box_check_wal_max_size(cfg_geti64("wal_max_size"));
 	box_check_wal_mode(cfg_gets("wal_mode"));
+	box_check_io_backend(cfg_gets("io_backend"));
 	if (box_check_wal_queue_max_size() < 0)
 		diag_raise();
 	if (box_check_wal_cleanup_delay() < 0)
 		diag_raise();
+	if (box_check_wal_group_commit() != 0)
+		diag_raise();
+	if (box_check_wal_ring_size() != 0)
+		diag_raise();
 	if (box_check_memory_quota("memtx_memory") < 0)
 		diag_raise();
 	box_check_memtx_min_tuple_size(cfg_geti64("memtx_min_tuple_size"));
 	if (box_check_allocator() != 0)
 		diag_raise();
 	box_check_small_alloc_options();
+	if (box_check_memtx_sort_threads() < 0)
+		diag_raise();
 	box_check_vinyl_options();
 	if (box_check_iproto_options() != 0)
 		diag_raise();
+	if (box_check_iproto_cpu_affinity(NULL) < 0)
+		diag_raise();
+	int cpu;
+	if (box_check_cpu_affinity("tx_cpu_affinity", &cpu) != 0)
+		diag_raise();
+	if (box_check_cpu_affinity("wal_cpu_affinity", &cpu) != 0)
+		diag_raise();
 	if (box_check_sql_cache_size(cfg_geti("sql_cache_size")) != 0)
 		diag_raise();
+	if (box_check_sql_plan_cache_size(cfg_geti("sql_plan_cache_size")) != 0)
+		diag_raise();
 	if (box_check_txn_timeout() < 0)
 		diag_raise();
 }
@@ -1463,12 +1719,48 @@ box_set_replication_sync_timeout(void)
 	replication_sync_timeout = box_check_replication_sync_timeout();
 }
 
+void
+box_set_replication_ack_interval(void)
+{
+	replication_ack_interval = box_check_replication_ack_interval();
+}
+
 void
 box_set_replication_skip_conflict(void)
 {
 	replication_skip_conflict = cfg_geti("replication_skip_conflict");
 }
 
+void
+box_set_replication_apply_fibers(void)
+{
+	replication_apply_fibers = box_check_replication_apply_fibers();
+}
+
+void
+box_set_replication_compression(void)
+{
+	replication_compression = cfg_geti("replication_compression");
+}
+
+/** Sets the static box.cfg.replication_space_filter option. */
+static void
+box_set_replication_space_filter(void)
+{
+	int count = box_check_replication_space_filter(NULL);
+	if (count < 0)
+		diag_raise();
+	if (count == 0)
+		return;
+	size_t size = count * sizeof(*replication_space_filter);
+	uint32_t *ids = (uint32_t *)malloc(size);
+	if (ids == NULL)
+		tnt_raise(OutOfMemory, size, "malloc", "space filter");
+	box_check_replication_space_filter(ids);
+	replication_space_filter = ids;
+	replication_space_filter_size = count;
+}
+
 void
 box_set_replication_anon(void)
 {
@@ -1945,6 +2237,22 @@ box_set_log_format(void)
 	say_set_log_format(format);
 }
 
+int
+box_set_log_async(void)
+{
+	return say_set_log_async(cfg_getb("log_async"));
+}
+
+int
+box_set_log_async_overflow(void)
+{
+	enum say_async_overflow overflow = box_check_log_async_overflow();
+	if (overflow == say_async_overflow_MAX)
+		return -1;
+	say_set_log_async_overflow(overflow);
+	return 0;
+}
+
 void
 box_set_io_collect_interval(void)
 {
@@ -2027,6 +2335,25 @@ box_set_checkpoint_wal_threshold(void)
 	wal_set_checkpoint_threshold(threshold);
 }
 
+int
+box_set_checkpoint_write_duration(void)
+{
+	double duration = box_check_checkpoint_write_duration();
+	if (duration < 0)
+		return -1;
+	struct memtx_engine *memtx;
+	memtx = (struct memtx_engine *)engine_by_name("memtx");
+	assert(memtx != NULL);
+	memtx_engine_set_snap_write_duration(memtx, duration);
+	return 0;
+}
+
+int
+box_set_checkpoint_lock(void)
+{
+	return gc_set_checkpoint_lock(cfg_gets("checkpoint_lock"));
+}
+
 int
 box_set_wal_queue_max_size(void)
 {
@@ -2054,6 +2381,26 @@ box_set_wal_cleanup_delay(void)
 	return 0;
 }
 
+int
+box_set_wal_group_commit(void)
+{
+	if (box_check_wal_group_commit() != 0)
+		return -1;
+	wal_set_group_commit(cfg_getd("wal_group_commit_timeout"),
+			     cfg_geti64("wal_group_commit_max_size"),
+			     cfg_geti64("wal_group_commit_max_entries"));
+	return 0;
+}
+
+int
+box_set_wal_ring_size(void)
+{
+	if (box_check_wal_ring_size() != 0)
+		return -1;
+	wal_set_ring_size(cfg_geti64("wal_ring_size"));
+	return 0;
+}
+
 void
 box_set_vinyl_memory(void)
 {
@@ -2082,6 +2429,49 @@ box_set_vinyl_cache(void)
 	vinyl_engine_set_cache(vinyl, cfg_geti64("vinyl_cache"));
 }
 
+void
+box_set_vinyl_page_cache(void)
+{
+	struct engine *vinyl = engine_by_name("vinyl");
+	assert(vinyl != NULL);
+	vinyl_engine_set_page_cache(vinyl, cfg_geti64("vinyl_page_cache"));
+}
+
+void
+box_set_vinyl_read_ahead(void)
+{
+	int read_ahead = cfg_geti("vinyl_read_ahead");
+	if (read_ahead < 0) {
+		tnt_raise(ClientError, ER_CFG, "vinyl_read_ahead",
+			  "must be greater than or equal to 0");
+	}
+	struct engine *vinyl = engine_by_name("vinyl");
+	assert(vinyl != NULL);
+	vinyl_engine_set_read_ahead(vinyl, read_ahead);
+}
+
+void
+box_set_vinyl_direct_io(void)
+{
+	struct engine *vinyl = engine_by_name("vinyl");
+	assert(vinyl != NULL);
+	vinyl_engine_set_direct_io(vinyl, cfg_getb("vinyl_direct_io"));
+}
+
+void
+box_set_vinyl_max_gap_locks(void)
+{
+	int64_t count = cfg_geti64("vinyl_max_gap_locks");
+	if (count < 0 || count > UINT32_MAX) {
+		tnt_raise(ClientError, ER_CFG, "vinyl_max_gap_locks",
+			  "must be greater than or equal to 0 and "
+			  "less than or equal to 4294967295");
+	}
+	struct engine *vinyl = engine_by_name("vinyl");
+	assert(vinyl != NULL);
+	vinyl_engine_set_max_gap_locks(vinyl, count);
+}
+
 void
 box_set_vinyl_timeout(void)
 {
@@ -2111,6 +2501,16 @@ box_set_prepared_stmt_cache_size(void)
 	return 0;
 }
 
+int
+box_set_sql_plan_cache_size(void)
+{
+	int cache_sz = cfg_geti("sql_plan_cache_size");
+	if (box_check_sql_plan_cache_size(cache_sz) != 0)
+		return -1;
+	sql_plan_cache_set_size(cache_sz);
+	return 0;
+}
+
 int
 box_set_crash(void)
 {
@@ -2138,6 +2538,12 @@ box_set_txn_timeout(void)
 	return 0;
 }
 
+void
+box_set_space_latency_stat(void)
+{
+	op_latency_is_enabled = cfg_getb("space_latency_stat");
+}
+
 /* }}} configuration bindings */
 
 /**
@@ -2205,15 +2611,38 @@ boxk(int type, uint32_t space_id, const char *format, ...)
 API_EXPORT int
 box_return_tuple(box_function_ctx_t *ctx, box_tuple_t *tuple)
 {
+	if (ctx->thread_result != NULL) {
+		diag_set(IllegalParams, "box_return_tuple() can't be used "
+			 "in a threadsafe function");
+		return -1;
+	}
 	return port_c_add_tuple(ctx->port, tuple);
 }
 
 API_EXPORT int
 box_return_mp(box_function_ctx_t *ctx, const char *mp, const char *mp_end)
 {
+	if (ctx->thread_result != NULL)
+		return module_func_thread_result_add(ctx->thread_result,
+						     mp, mp_end);
 	return port_c_add_mp(ctx->port, mp, mp_end);
 }
 
+API_EXPORT int
+box_return_mp_ref(box_function_ctx_t *ctx, const char *mp, const char *mp_end,
+		  box_return_mp_free_f free_cb, void *arg)
+{
+	if (ctx->thread_result != NULL) {
+		/* TX can't call free_cb later, so copy the data. */
+		if (module_func_thread_result_add(ctx->thread_result,
+						  mp, mp_end) != 0)
+			return -1;
+		free_cb(arg);
+		return 0;
+	}
+	return port_c_add_mp_ref(ctx->port, mp, mp_end, free_cb, arg);
+}
+
 /* schema_find_id()-like method using only public API */
 API_EXPORT uint32_t
 box_space_id_by_name(const char *name, uint32_t len)
@@ -2268,17 +2697,21 @@ box_index_id_by_name(uint32_t space_id, const char *name, uint32_t len)
 }
 /** \endcond public */
 
-int
-box_process1(struct request *request, box_tuple_t **result)
+/**
+ * Find a space for a DML request and check that it can be written
+ * to right now.
+ */
+static struct space *
+box_find_writable_space(uint32_t space_id)
 {
 	/* Allow to write to temporary spaces in read-only mode. */
-	struct space *space = space_cache_find(request->space_id);
+	struct space *space = space_cache_find(space_id);
 	if (space == NULL)
-		return -1;
+		return NULL;
 	if (!space_is_temporary(space) &&
 	    space_group_id(space) != GROUP_LOCAL &&
 	    box_check_writable() != 0)
-		return -1;
+		return NULL;
 	if (space_is_memtx(space)) {
 		/*
 		 * Due to on_init_schema triggers set on system spaces,
@@ -2293,13 +2726,87 @@ box_process1(struct request *request, box_tuple_t **result)
 				"box.ctl.is_recovery_finished() "
 				"to check that snapshot recovery was completed");
 			diag_log();
-			return -1;
+			return NULL;
 		}
 	}
+	return space;
+}
 
+int
+box_process1(struct request *request, box_tuple_t **result)
+{
+	struct space *space = box_find_writable_space(request->space_id);
+	if (space == NULL)
+		return -1;
 	return box_process_rw(request, space, result);
 }
 
+/**
+ * Check if a SELECT can be served with index_get(), i.e. if it's
+ * an EQ lookup by a full key in a unique index. Nullable indexes
+ * are excluded, because they may store many tuples with NULL in
+ * a unique key. Functional and multikey indexes are excluded too,
+ * because there's no one-to-one mapping between keys and tuples.
+ */
+static inline bool
+box_select_is_point_lookup(struct index_def *def, enum iterator_type type,
+			   uint32_t part_count)
+{
+	struct key_def *key_def = def->key_def;
+	return (type == ITER_EQ || type == ITER_REQ) &&
+	       def->opts.is_unique && part_count == key_def->part_count &&
+	       !key_def->is_nullable && !key_def->is_multikey &&
+	       !key_def->for_func_index;
+}
+
+/**
+ * Serve a point lookup SELECT. Unlike an iterator, index_get()
+ * doesn't need a memory allocation and does only one descent in
+ * the index.
+ */
+static int
+box_select_get(struct index *index, const char *key, uint32_t part_count,
+	       struct port *port)
+{
+	struct tuple *tuple;
+	if (index_get(index, key, part_count, &tuple) != 0)
+		return -1;
+	if (tuple != NULL && port_c_add_tuple(port, tuple) != 0)
+		return -1;
+	return 0;
+}
+
+/** Serve a SELECT by iterating over the index. */
+static int
+box_select_iterate(struct index *index, enum iterator_type type,
+		   const char *key, uint32_t part_count,
+		   uint32_t offset, uint32_t limit, struct port *port)
+{
+	struct iterator *it = index_create_iterator(index, type,
+						    key, part_count);
+	if (it == NULL)
+		return -1;
+
+	int rc = 0;
+	uint32_t found = 0;
+	struct tuple *tuple;
+	while (found < limit) {
+		rc = iterator_next(it, &tuple);
+		if (rc != 0 || tuple == NULL)
+			break;
+		if (offset > 0) {
+			offset--;
+			continue;
+		}
+		rc = port_c_add_tuple(port, tuple);
+		if (rc != 0)
+			break;
+		found++;
+	}
+	iterator_delete(it);
+	return rc;
+}
+
 API_EXPORT int
 box_select(uint32_t space_id, uint32_t index_id,
 	   int iterator, uint32_t offset, uint32_t limit,
@@ -2341,37 +2848,27 @@ box_select(uint32_t space_id, uint32_t index_id,
 	if (txn_begin_ro_stmt(space, &txn, &svp) != 0)
 		return -1;
 
-	struct iterator *it = index_create_iterator(index, type,
-						    key, part_count);
-	if (it == NULL) {
-		txn_rollback_stmt(txn);
-		return -1;
-	}
-
-	int rc = 0;
-	uint32_t found = 0;
-	struct tuple *tuple;
+	int rc;
+	enum op_latency_type op;
+	double start = op_latency_start();
 	port_c_create(port);
-	while (found < limit) {
-		rc = iterator_next(it, &tuple);
-		if (rc != 0 || tuple == NULL)
-			break;
-		if (offset > 0) {
-			offset--;
-			continue;
-		}
-		rc = port_c_add_tuple(port, tuple);
-		if (rc != 0)
-			break;
-		found++;
+	if (offset == 0 && limit > 0 &&
+	    box_select_is_point_lookup(index->def, type, part_count)) {
+		op = OP_LATENCY_GET;
+		rc = box_select_get(index, key, part_count, port);
+	} else {
+		op = OP_LATENCY_SELECT;
+		rc = box_select_iterate(index, type, key, part_count,
+					offset, limit, port);
 	}
-	iterator_delete(it);
-
 	if (rc != 0) {
 		port_destroy(port);
 		txn_rollback_stmt(txn);
 		return -1;
 	}
+	/* The index can't be dropped while the statement is open. */
+	if (start != 0)
+		op_latency_collect(&index->latency, op, start);
 	txn_commit_ro_stmt(txn, &svp);
 	return 0;
 }
@@ -2404,6 +2901,69 @@ box_replace(uint32_t space_id, const char *tuple, const char *tuple_end,
 	return box_process1(&request, result);
 }
 
+API_EXPORT int
+box_insert_batch(uint32_t space_id, const char *tuples, const char *tuples_end)
+{
+	(void)tuples_end;
+	if (mp_typeof(*tuples) != MP_ARRAY) {
+		diag_set(ClientError, ER_ILLEGAL_PARAMS,
+			 "tuples must be a MsgPack array");
+		return -1;
+	}
+	struct space *space = box_find_writable_space(space_id);
+	if (space == NULL)
+		return -1;
+	struct txn *txn = in_txn();
+	bool is_autocommit = txn == NULL;
+	struct txn_savepoint *svp = NULL;
+	if (is_autocommit) {
+		if ((txn = txn_begin()) == NULL)
+			return -1;
+	} else if ((svp = box_txn_savepoint()) == NULL) {
+		return -1;
+	}
+	struct request request;
+	memset(&request, 0, sizeof(request));
+	request.type = IPROTO_INSERT;
+	request.space_id = space_id;
+	uint32_t count = mp_decode_array(&tuples);
+	for (uint32_t i = 0; i < count; i++) {
+		request.tuple = tuples;
+		mp_next(&tuples);
+		request.tuple_end = tuples;
+		if (mp_typeof(*request.tuple) != MP_ARRAY) {
+			diag_set(ClientError, ER_TUPLE_NOT_ARRAY);
+			goto rollback;
+		}
+		/*
+		 * The statement joins the transaction started above,
+		 * so box_process_rw() doesn't write it separately.
+		 */
+		if (box_process_rw(&request, space, NULL) != 0)
+			goto rollback;
+	}
+	assert(tuples == tuples_end);
+	if (is_autocommit) {
+		if (txn_commit(txn) != 0)
+			return -1;
+		fiber_gc();
+	}
+	return 0;
+rollback:
+	if (is_autocommit) {
+		txn_abort(txn);
+		fiber_gc();
+	} else {
+		struct diag diag;
+		diag_create(&diag);
+		diag_move(diag_get(), &diag);
+		box_txn_rollback_to_savepoint(svp);
+		diag_move(&diag, diag_get());
+		diag_destroy(&diag);
+	}
+	return -1;
+}
+
 API_EXPORT int
 box_delete(uint32_t space_id, uint32_t index_id, const char *key,
 	   const char *key_end, box_tuple_t **result)
@@ -2558,6 +3118,68 @@ sequence_data_delete(uint32_t seq_id)
 	return rc;
 }
 
+/** A block of sequence values reserved by a transaction. */
+struct sequence_reserve {
+	/** Publishes the block when the transaction is committed. */
+	struct trigger on_commit;
+	uint32_t seq_id;
+	/** The value returned by the sequence. */
+	int64_t value;
+	/** The last reserved value, stored in _sequence_data. */
+	int64_t last;
+};
+
+static int
+sequence_reserve_on_commit(struct trigger *trigger, void * /* event */)
+{
+	struct sequence_reserve *reserve =
+		(struct sequence_reserve *)trigger->data;
+	struct sequence *seq = sequence_by_id(reserve->seq_id);
+	if (seq != NULL)
+		sequence_set_reserved(seq, reserve->value, reserve->last);
+	return 0;
+}
+
+/**
+ * Make the values reserved by the last statement of the current
+ * transaction, which updated _sequence_data, available to others
+ * only when the statement is committed. If it is rolled back, the
+ * values have no WAL record and would be returned again after a
+ * restart. Without a transaction the statement is committed
+ * already.
+ */
+static int
+sequence_reserve_on_commit_of_last_stmt(uint32_t seq_id, int64_t value,
+					int64_t last)
+{
+	if (value == last)
+		return 0;
+	struct txn *txn = in_txn();
+	if (txn == NULL) {
+		/* The sequence may have been dropped during the commit. */
+		struct sequence *seq = sequence_by_id(seq_id);
+		if (seq != NULL)
+			sequence_set_reserved(seq, value, last);
+		return 0;
+	}
+	size_t size;
+	struct sequence_reserve *reserve = region_alloc_object(
+		&txn->region, struct sequence_reserve, &size);
+	if (reserve == NULL) {
+		diag_set(OutOfMemory, size, "region_alloc_object", "reserve");
+		return -1;
+	}
+	reserve->seq_id = seq_id;
+	reserve->value = value;
+	reserve->last = last;
+	trigger_create(&reserve->on_commit, sequence_reserve_on_commit,
+		       reserve, NULL);
+	struct txn_stmt *stmt =
+		stailq_last_entry(&txn->stmts, struct txn_stmt, next);
+	txn_stmt_on_commit(stmt, &reserve->on_commit);
+	return 0;
+}
+
 API_EXPORT int
 box_sequence_next(uint32_t seq_id, int64_t *result)
 {
@@ -2566,10 +3188,21 @@ box_sequence_next(uint32_t seq_id, int64_t *result)
 		return -1;
 	if (access_check_sequence(seq) != 0)
 		return -1;
+	if (sequence_next_reserved(seq, result))
+		return 0;
 	int64_t value;
 	if (sequence_next(seq, &value) != 0)
 		return -1;
-	if (sequence_data_update(seq_id, value) != 0)
+	/*
+	 * If the sequence has a cache, reserve a block of values
+	 * by logging the last one. The rest of the block is then
+	 * returned without writing to _sequence_data. The values
+	 * that are left unused on restart are skipped.
+	 */
+	int64_t last = sequence_reserve_bound(seq, value);
+	if (sequence_data_update(seq_id, last) != 0)
+		return -1;
+	if (sequence_reserve_on_commit_of_last_stmt(seq_id, value, last) != 0)
 		return -1;
 	*result = value;
 	return 0;
@@ -2671,11 +3304,47 @@ box_process_auth(struct auth_request *request, const char *salt)
 	authenticate(user, len, salt, request->scramble);
 }
 
+static int
+space_id_cmp(const void *a, const void *b)
+{
+	uint32_t id_a = *(const uint32_t *)a;
+	uint32_t id_b = *(const uint32_t *)b;
+	return id_a < id_b ? -1 : id_a > id_b;
+}
+
+/**
+ * Decode the space filter of a replication request. The ids are
+ * copied to malloc()-ed memory, because the fiber region is freed
+ * while rows are sent, and sorted for relay lookups. Returns NULL
+ * if the replica wants all spaces.
+ */
+static uint32_t *
+box_decode_space_filter_xc(const struct xrow_header *header, uint32_t *size)
+{
+	uint32_t *ids;
+	xrow_decode_space_filter_xc(header, &ids, size);
+	if (ids == NULL)
+		return NULL;
+	size_t bsize = (*size > 0 ? *size : 1) * sizeof(*ids);
+	uint32_t *copy = (uint32_t *)malloc(bsize);
+	if (copy == NULL)
+		tnt_raise(OutOfMemory, bsize, "malloc", "space filter");
+	memcpy(copy, ids, *size * sizeof(*ids));
+	qsort(copy, *size, sizeof(*copy), space_id_cmp);
+	return copy;
+}
+
 void
 box_process_fetch_snapshot(struct iostream *io,
 			   const struct xrow_header *header)
 {
 	assert(header->type == IPROTO_FETCH_SNAPSHOT);
+	uint32_t space_filter_size;
+	uint32_t *space_filter = box_decode_space_filter_xc(header,
+							    &space_filter_size);
+	auto space_filter_guard = make_scoped_guard([=] {
+		free(space_filter);
+	});
 
 	/* Check that bootstrap has been finished */
 	if (!is_box_configured)
@@ -2694,7 +3363,8 @@ box_process_fetch_snapshot(struct iostream *io,
 
 	/* Send the snapshot data to the instance. */
 	struct vclock start_vclock;
-	relay_initial_join(io, header->sync, &start_vclock, 0);
+	relay_initial_join(io, header->sync, &start_vclock, 0,
+			   space_filter, space_filter_size);
 	say_info("read-view sent.");
 
 	/* Remember master's vclock after the last request */
@@ -2718,6 +3388,12 @@ box_process_register(struct iostream *io, const struct xrow_header *header)
 	uint32_t replica_version_id;
 	xrow_decode_register_xc(header, &instance_uuid, &replica_vclock,
 				&replica_version_id);
+	uint32_t space_filter_size;
+	uint32_t *space_filter = box_decode_space_filter_xc(header,
+							    &space_filter_size);
+	auto space_filter_guard = make_scoped_guard([=] {
+		free(space_filter);
+	});
 
 	if (!is_box_configured)
 		tnt_raise(ClientError, ER_LOADING);
@@ -2771,7 +3447,8 @@ box_process_register(struct iostream *io, const struct xrow_header *header)
 	 * (replica_vclock, stop_vclock) so that it gets its
 	 * registration.
 	 */
-	relay_final_join(io, header->sync, &replica_vclock, &stop_vclock);
+	relay_final_join(io, header->sync, &replica_vclock, &stop_vclock,
+			 space_filter, space_filter_size);
 	say_info("final data sent.");
 
 	struct xrow_header row;
@@ -2844,6 +3521,12 @@ box_process_join(struct iostream *io, const struct xrow_header *header)
 	struct tt_uuid instance_uuid;
 	uint32_t replica_version_id;
 	xrow_decode_join_xc(header, &instance_uuid, &replica_version_id);
+	uint32_t space_filter_size;
+	uint32_t *space_filter = box_decode_space_filter_xc(header,
+							    &space_filter_size);
+	auto space_filter_guard = make_scoped_guard([=] {
+		free(space_filter);
+	});
 
 	/* Check that bootstrap has been finished */
 	if (!is_box_configured)
@@ -2893,7 +3576,8 @@ box_process_join(struct iostream *io, const struct xrow_header *header)
 	 */
 	struct vclock start_vclock;
 	relay_initial_join(io, header->sync, &start_vclock,
-			   replica_version_id);
+			   replica_version_id, space_filter,
+			   space_filter_size);
 	say_info("initial data sent.");
 
 	/**
@@ -2919,7 +3603,8 @@ box_process_join(struct iostream *io, const struct xrow_header *header)
 	 * Final stage: feed replica with WALs in range
 	 * (start_vclock, stop_vclock).
 	 */
-	relay_final_join(io, header->sync, &start_vclock, &stop_vclock);
+	relay_final_join(io, header->sync, &start_vclock, &stop_vclock,
+			 space_filter, space_filter_size);
 	say_info("final data sent.");
 
 	/* Send end of WAL stream marker */
@@ -2954,9 +3639,16 @@ box_process_subscribe(struct iostream *io, const struct xrow_header *header)
 	uint32_t replica_version_id;
 	bool anon;
 	uint32_t id_filter;
+	bool compression;
 	xrow_decode_subscribe_xc(header, &peer_replicaset_uuid, &replica_uuid,
 				 &replica_clock, &replica_version_id, &anon,
-				 &id_filter);
+				 &id_filter, &compression);
+	uint32_t space_filter_size;
+	uint32_t *space_filter = box_decode_space_filter_xc(header,
+							    &space_filter_size);
+	auto space_filter_guard = make_scoped_guard([=] {
+		free(space_filter);
+	});
 
 	/* Forbid connection to itself */
 	if (tt_uuid_is_equal(&replica_uuid, &INSTANCE_UUID))
@@ -3037,9 +3729,15 @@ box_process_subscribe(struct iostream *io, const struct xrow_header *header)
 	 *
 	 * Older versions not supporting replicaset UUID in the response will
 	 * just ignore the additional field (these are < 2.1.1).
+	 *
+	 * If the replica asked for compression, the master confirms it in
+	 * the response, and everything it sends after the response is
+	 * compressed. A master that doesn't support compression ignores
+	 * the request, so the replica knows what to expect.
 	 */
 	struct xrow_header row;
-	xrow_encode_subscribe_response_xc(&row, &REPLICASET_UUID, &vclock);
+	xrow_encode_subscribe_response_xc(&row, &REPLICASET_UUID, &vclock,
+					  compression);
 	/*
 	 * Identify the message with the replica id of this
 	 * instance, this is the only way for a replica to find
@@ -3066,7 +3764,10 @@ box_process_subscribe(struct iostream *io, const struct xrow_header *header)
 		struct raft_request req;
 		box_raft_checkpoint_remote(&req);
 		xrow_encode_raft(&row, &fiber()->gc, &req);
-		coio_write_xrow(io, &row);
+		if (compression)
+			coio_write_xrow_compressed(io, &row);
+		else
+			coio_write_xrow(io, &row);
 	}
 	/*
 	 * Replica clock is used in gc state and recovery
@@ -3098,7 +3799,8 @@ box_process_subscribe(struct iostream *io, const struct xrow_header *header)
 	 * indefinitely).
 	 */
 	relay_subscribe(replica, io, header->sync, &replica_clock,
-			replica_version_id, id_filter);
+			replica_version_id, id_filter, compression,
+			space_filter, space_filter_size);
 }
 
 void
@@ -3175,11 +3877,13 @@ engine_init()
 				    cfg_getd("memtx_memory"),
 				    cfg_geti("memtx_min_tuple_size"),
 				    cfg_geti("strip_core"),
+				    cfg_geti("memtx_use_hugepages"),
 				    cfg_geti("slab_alloc_granularity"),
 				    cfg_gets("memtx_allocator"),
 				    cfg_getd("slab_alloc_factor"));
 	engine_register((struct engine *)memtx);
 	box_set_memtx_max_tuple_size();
+	memtx_engine_set_sort_threads(memtx, cfg_geti("memtx_sort_threads"));
 
 	struct sysview_engine *sysview = sysview_engine_new_xc();
 	engine_register((struct engine *)sysview);
@@ -3199,6 +3903,10 @@ engine_init()
 	engine_register((struct engine *)vinyl);
 	box_set_vinyl_max_tuple_size();
 	box_set_vinyl_cache();
+	box_set_vinyl_page_cache();
+	box_set_vinyl_read_ahead();
+	box_set_vinyl_direct_io();
+	box_set_vinyl_max_gap_locks();
 	box_set_vinyl_timeout();
 }
 
@@ -3490,6 +4198,10 @@ local_recovery(const struct tt_uuid *instance_uuid,
 		engine_begin_hot_standby_xc();
 		recovery_follow_local(recovery, &wal_stream.base, "hot_standby",
 				      cfg_getd("wal_dir_rescan_delay"));
+		box_hot_standby = recovery;
+		auto hot_standby_guard = make_scoped_guard([&]{
+			box_hot_standby = NULL;
+		});
 		while (true) {
 			if (path_lock(wal_dir(), &wal_dir_lock))
 				diag_raise();
@@ -3601,6 +4313,23 @@ box_is_configured(void)
 static void
 box_cfg_xc(void)
 {
+	/*
+	 * Set the I/O backend before starting any threads doing
+	 * file I/O.
+	 */
+	enum fio_backend io_backend = box_check_io_backend(
+		cfg_gets("io_backend"));
+	if (fio_set_backend(io_backend) != 0) {
+		say_warn("%s I/O backend is not supported, falling back on %s",
+			 fio_backend_strs[io_backend],
+			 fio_backend_strs[FIO_BACKEND_SYSCALL]);
+	}
+
+	if (box_set_log_async_overflow() != 0)
+		diag_raise();
+	if (box_set_log_async() != 0)
+		diag_raise();
+
 	/* Join the cord interconnect as "tx" endpoint. */
 	fiber_pool_create(&tx_fiber_pool, "tx",
 			  IPROTO_MSG_MAX_MIN * IPROTO_FIBER_POOL_SIZE_FACTOR,
@@ -3616,15 +4345,39 @@ box_cfg_xc(void)
 	schema_init();
 	replication_init();
 	port_init();
-	iproto_init(cfg_geti("iproto_threads"));
+	int iproto_cpus[IPROTO_THREADS_MAX];
+	int iproto_cpu_count = box_check_iproto_cpu_affinity(iproto_cpus);
+	assert(iproto_cpu_count >= 0);
+	iproto_init(cfg_geti("iproto_threads"), cfg_getb("iproto_reuseport"),
+		    iproto_cpu_count > 0 ? iproto_cpus : NULL);
 	sql_init();
 
 	int64_t wal_max_size = box_check_wal_max_size(cfg_geti64("wal_max_size"));
 	enum wal_mode wal_mode = box_check_wal_mode(cfg_gets("wal_mode"));
+	int wal_cpu;
+	if (box_check_cpu_affinity("wal_cpu_affinity", &wal_cpu) != 0)
+		diag_raise();
 	if (wal_init(wal_mode, cfg_gets("wal_dir"), wal_max_size,
 		     &INSTANCE_UUID, on_wal_garbage_collection,
-		     on_wal_checkpoint_threshold) != 0) {
+		     on_wal_checkpoint_threshold, wal_cpu) != 0) {
+		diag_raise();
+	}
+
+	/*
+	 * Pin TX before recovery so that the memtx arena is touched
+	 * first, and so allocated, on the TX NUMA node. Threads
+	 * started by TX later don't inherit its affinity, because
+	 * every cord resets it on creation, see cord_create().
+	 */
+	if (box_check_cpu_affinity("tx_cpu_affinity", &tx_cpu) != 0)
 		diag_raise();
+	if (tx_cpu >= 0) {
+		int rc = tt_pthread_setaffinity(tx_cpu);
+		if (rc != 0) {
+			say_warn("failed to pin TX thread to CPU %d: %s",
+				 tx_cpu, strerror(rc));
+			tx_cpu = -1;
+		}
 	}
 
 	title("loading");
@@ -3635,6 +4388,8 @@ box_cfg_xc(void)
 
 	if (box_set_prepared_stmt_cache_size() != 0)
 		diag_raise();
+	if (box_set_sql_plan_cache_size() != 0)
+		diag_raise();
 	box_set_net_msg_max();
 	box_set_readahead();
 	box_set_too_long_threshold();
@@ -3647,7 +4402,11 @@ box_cfg_xc(void)
 	if (box_set_replication_synchro_timeout() != 0)
 		diag_raise();
 	box_set_replication_sync_timeout();
+	box_set_replication_ack_interval();
 	box_set_replication_skip_conflict();
+	box_set_replication_apply_fibers();
+	box_set_replication_compression();
+	box_set_replication_space_filter();
 	box_set_replication_anon();
 
 	struct gc_checkpoint *checkpoint = gc_last_checkpoint();
@@ -3831,8 +4590,71 @@ box_checkpoint(void)
 	return gc_checkpoint();
 }
 
+/**
+ * Call @a cb for each WAL file that contains rows written after
+ * the checkpoint with signature @a base and before the checkpoint
+ * @a vclock. Register a garbage collector consumer that pins the
+ * files until box_backup_stop().
+ */
+static int
+box_backup_wal(int64_t base, const struct vclock *vclock,
+	       box_backup_cb cb, void *cb_arg)
+{
+	int64_t signature = vclock_sum(vclock);
+	if (base >= signature) {
+		diag_set(IllegalParams, "base checkpoint must be older "
+			 "than the checkpoint to back up");
+		return -1;
+	}
+	/*
+	 * Pin all WAL files while the directory is scanned, then
+	 * advance the consumer to the first file to back up.
+	 */
+	struct vclock zero;
+	vclock_create(&zero);
+	assert(backup_wal_gc == NULL);
+	backup_wal_gc = gc_consumer_register(&zero, "backup");
+	if (backup_wal_gc == NULL)
+		return -1;
+	struct xdir dir;
+	xdir_create(&dir, wal_dir(), XLOG, &INSTANCE_UUID,
+		    &xlog_opts_default);
+	int rc = -1;
+	if (xdir_scan(&dir, true) != 0)
+		goto out;
+	/* The file containing the first row after the base. */
+	struct vclock *first = NULL;
+	for (struct vclock *it = vclockset_first(&dir.index);
+	     it != NULL && vclock_sum(it) <= base;
+	     it = vclockset_next(&dir.index, it))
+		first = it;
+	if (first == NULL) {
+		diag_set(IllegalParams, "WAL files written after "
+			 "checkpoint %lld have been removed",
+			 (long long)base);
+		goto out;
+	}
+	gc_consumer_advance(backup_wal_gc, first);
+	for (struct vclock *it = first;
+	     it != NULL && vclock_sum(it) < signature;
+	     it = vclockset_next(&dir.index, it)) {
+		if (cb(xdir_format_filename(&dir, vclock_sum(it), NONE),
+		       cb_arg) != 0)
+			goto out;
+	}
+	rc = 0;
+out:
+	xdir_destroy(&dir);
+	if (rc != 0) {
+		gc_consumer_unregister(backup_wal_gc);
+		backup_wal_gc = NULL;
+	}
+	return rc;
+}
+
 int
-box_backup_start(int checkpoint_idx, box_backup_cb cb, void *cb_arg)
+box_backup_start(int checkpoint_idx, int64_t base, box_backup_cb cb,
+		 void *cb_arg)
 {
 	assert(checkpoint_idx >= 0);
 	if (backup_is_in_progress) {
@@ -3850,7 +4672,11 @@ box_backup_start(int checkpoint_idx, box_backup_cb cb, void *cb_arg)
 	}
 	backup_is_in_progress = true;
 	gc_ref_checkpoint(checkpoint, &backup_gc, "backup");
-	int rc = engine_backup(&checkpoint->vclock, cb, cb_arg);
+	int rc;
+	if (base >= 0)
+		rc = box_backup_wal(base, &checkpoint->vclock, cb, cb_arg);
+	else
+		rc = engine_backup(&checkpoint->vclock, cb, cb_arg);
 	if (rc != 0) {
 		gc_unref_checkpoint(&backup_gc);
 		backup_is_in_progress = false;
@@ -3863,6 +4689,10 @@ box_backup_stop(void)
 {
 	if (backup_is_in_progress) {
 		gc_unref_checkpoint(&backup_gc);
+		if (backup_wal_gc != NULL) {
+			gc_consumer_unregister(backup_wal_gc);
+			backup_wal_gc = NULL;
+		}
 		backup_is_in_progress = false;
 	}
 }
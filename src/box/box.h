@@ -52,6 +52,7 @@ struct iostream;
 struct auth_request;
 struct space;
 struct vclock;
+struct recovery;
 
 /**
  * Pointer to TX thread local vclock.
@@ -64,6 +65,12 @@ struct vclock;
  */
 extern const struct vclock *box_vclock;
 
+/**
+ * The recovery following the WAL directory if the instance is
+ * in the hot standby mode, NULL otherwise.
+ */
+extern const struct recovery *box_hot_standby;
+
 /** Time to wait for shutdown triggers finished */
 extern double on_shutdown_trigger_timeout;
 
@@ -117,6 +124,13 @@ box_is_ro(void);
 bool
 box_is_orphan(void);
 
+/**
+ * Return the CPU the TX thread is pinned to or -1 if it isn't
+ * pinned.
+ */
+int
+box_tx_cpu(void);
+
 /**
  * Wait until the instance switches to a desired mode.
  * \param ro wait read-only if set or read-write if unset
@@ -127,6 +141,18 @@ box_is_orphan(void);
 int
 box_wait_ro(bool ro, double timeout);
 
+/**
+ * Wait until the instance vclock reaches or exceeds the given one
+ * in every component except the local one (0). Used to serve
+ * reads on a replica not older than a given state of the master.
+ * \param vclock vclock to wait for
+ * \param timeout max time to wait
+ * \retval -1 timeout or fiber is cancelled
+ * \retval 0 success
+ */
+int
+box_wait_vclock(const struct vclock *vclock, double timeout);
+
 /**
  * Switch this instance from 'orphan' to 'running' state or
  * vice versa depending on the value of the function argument.
@@ -175,11 +201,19 @@ typedef int (*box_backup_cb)(const char *path, void *arg);
  * is 0, the last checkpoint will be backed up; if it is 1, next
  * to last, and so on.
  *
+ * If @base is not negative, the backup is incremental: only the
+ * WAL files written after the checkpoint with signature @base and
+ * before the specified checkpoint are listed. Recovery from the
+ * base backup with these files added to the WAL directory restores
+ * the state of the specified checkpoint. The WAL files must not
+ * have been removed by the garbage collector yet.
+ *
  * The caller is supposed to call box_backup_stop() after he's
  * done copying the files.
  */
 int
-box_backup_start(int checkpoint_idx, box_backup_cb cb, void *cb_arg);
+box_backup_start(int checkpoint_idx, int64_t base, box_backup_cb cb,
+		 void *cb_arg);
 
 /**
  * Finish backup started with box_backup_start().
@@ -249,6 +283,8 @@ int box_listen(void);
 void box_set_replication(void);
 void box_set_log_level(void);
 void box_set_log_format(void);
+int box_set_log_async(void);
+int box_set_log_async_overflow(void);
 void box_set_io_collect_interval(void);
 void box_set_snap_io_rate_limit(void);
 void box_set_too_long_threshold(void);
@@ -256,13 +292,21 @@ void box_set_readahead(void);
 void box_set_checkpoint_count(void);
 void box_set_checkpoint_interval(void);
 void box_set_checkpoint_wal_threshold(void);
+int box_set_checkpoint_write_duration(void);
+int box_set_checkpoint_lock(void);
 int box_set_wal_queue_max_size(void);
 int box_set_wal_cleanup_delay(void);
+int box_set_wal_group_commit(void);
+int box_set_wal_ring_size(void);
 void box_set_memtx_memory(void);
 void box_set_memtx_max_tuple_size(void);
 void box_set_vinyl_memory(void);
 void box_set_vinyl_max_tuple_size(void);
 void box_set_vinyl_cache(void);
+void box_set_vinyl_page_cache(void);
+void box_set_vinyl_read_ahead(void);
+void box_set_vinyl_direct_io(void);
+void box_set_vinyl_max_gap_locks(void);
 void box_set_vinyl_timeout(void);
 int box_set_election_mode(void);
 int box_set_election_timeout(void);
@@ -274,15 +318,22 @@ void box_update_replication_synchro_quorum(void);
 int box_set_replication_synchro_quorum(void);
 int box_set_replication_synchro_timeout(void);
 void box_set_replication_sync_timeout(void);
+void box_set_replication_ack_interval(void);
 void box_set_replication_skip_conflict(void);
+void box_set_replication_apply_fibers(void);
+void box_set_replication_compression(void);
 void box_set_replication_anon(void);
 void box_set_net_msg_max(void);
 int box_set_crash(void);
 int box_set_txn_timeout(void);
+void box_set_space_latency_stat(void);
 
 int
 box_set_prepared_stmt_cache_size(void);
 
+int
+box_set_sql_plan_cache_size(void);
+
 extern "C" {
 #endif /* defined(__cplusplus) */
 
@@ -347,6 +398,33 @@ box_return_tuple(box_function_ctx_t *ctx, box_tuple_t *tuple);
 API_EXPORT int
 box_return_mp(box_function_ctx_t *ctx, const char *mp, const char *mp_end);
 
+/**
+ * A function to release MessagePack returned by
+ * box_return_mp_ref().
+ */
+typedef void
+(*box_return_mp_free_f)(void *arg);
+
+/**
+ * Return MessagePack from a stored C procedure without copying
+ * it. The MessagePack must stay valid until \a free_cb is called
+ * with \a arg, which happens once the result is encoded for the
+ * caller. It saves a copy of big results. The same rules as
+ * for box_return_mp() apply to the MessagePack contents.
+ *
+ * \param ctx An opaque structure passed to the stored C procedure
+ *        by Tarantool.
+ * \param mp Begin of MessagePack.
+ * \param mp_end End of MessagePack.
+ * \param free_cb A function to release the MessagePack.
+ * \param arg An argument of \a free_cb.
+ * \retval -1 Error, \a free_cb is not called then.
+ * \retval 0 Success.
+ */
+API_EXPORT int
+box_return_mp_ref(box_function_ctx_t *ctx, const char *mp, const char *mp_end,
+		  box_return_mp_free_f free_cb, void *arg);
+
 /**
  * Find space id by name.
  *
@@ -404,6 +482,24 @@ API_EXPORT int
 box_replace(uint32_t space_id, const char *tuple, const char *tuple_end,
 	    box_tuple_t **result);
 
+/**
+ * Insert many tuples into a space at once.
+ *
+ * All tuples are inserted in one transaction, so they are written
+ * to the WAL as one journal entry. If there is an active
+ * transaction, the tuples are inserted as a part of it. If any
+ * tuple fails to insert, none of them is inserted.
+ *
+ * \param space_id space identifier
+ * \param tuples MsgPack array of tuples, each tuple is a MsgPack array
+ * \param tuples_end end of @a tuples
+ * \retval -1 on error (check box_error_last())
+ * \retval 0 on success
+ * \sa \code box.space[space_id]:insert_batch(tuples) \endcode
+ */
+API_EXPORT int
+box_insert_batch(uint32_t space_id, const char *tuples, const char *tuples_end);
+
 /**
  * Execute an DELETE request.
  *
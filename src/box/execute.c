@@ -100,13 +100,30 @@ static_assert(sizeof(struct port_sql) <= sizeof(struct port),
 static int
 port_sql_dump_msgpack(struct port *port, struct obuf *out);
 
+/**
+ * Return a statement executed by its text to the plan cache so
+ * that the next execution of the same query doesn't compile it.
+ * Statements compiled before a schema change are finalized.
+ */
+static void
+sql_stmt_release(struct sql_stmt *stmt)
+{
+	if (sql_stmt_schema_version(stmt) != box_schema_version()) {
+		sql_stmt_finalize(stmt);
+		return;
+	}
+	sql_stmt_reset(stmt);
+	sql_unbind(stmt);
+	sql_plan_cache_put(stmt, current_session()->sql_flags);
+}
+
 static void
 port_sql_destroy(struct port *base)
 {
 	port_c_vtab.destroy(base);
 	struct port_sql *port_sql = (struct port_sql *) base;
 	if (port_sql->do_finalize)
-		sql_stmt_finalize(((struct port_sql *)base)->stmt);
+		sql_stmt_release(port_sql->stmt);
 }
 
 const struct port_vtab port_sql_vtab = {
@@ -616,8 +633,13 @@ sql_prepare_and_execute(const char *sql, int len, const struct sql_bind *bind,
 			uint32_t bind_count, struct port *port,
 			struct region *region)
 {
-	struct sql_stmt *stmt;
-	if (sql_stmt_compile(sql, len, NULL, &stmt, NULL) != 0)
+	struct sql_stmt *stmt = sql_plan_cache_take(sql, len,
+						    current_session()->sql_flags);
+	if (stmt != NULL && !sql_stmt_schema_version_is_valid(stmt)) {
+		sql_stmt_finalize(stmt);
+		stmt = NULL;
+	}
+	if (stmt == NULL && sql_stmt_compile(sql, len, NULL, &stmt, NULL) != 0)
 		return -1;
 	assert(stmt != NULL);
 	enum sql_serialization_format format = sql_column_count(stmt) > 0 ?
@@ -111,6 +111,8 @@ struct port_sql {
 	/**
 	 * There's no need in clean-up in case of PREPARE request:
 	 * statement remains in cache and will be deleted later.
+	 * Otherwise the statement is returned to the plan cache
+	 * or finalized when the port is destroyed.
 	 */
 	bool do_finalize;
 };
@@ -38,6 +38,7 @@ field_map_builder_create(struct field_map_builder *builder,
 			 struct region *region)
 {
 	builder->extents_size = 0;
+	builder->max_offset = 0;
 	builder->slot_count = minimal_field_map_size / sizeof(uint32_t);
 	if (minimal_field_map_size == 0) {
 		builder->slots = NULL;
@@ -82,39 +83,57 @@ field_map_builder_slot_extent_new(struct field_map_builder *builder,
 void
 field_map_build(struct field_map_builder *builder, char *buffer)
 {
+	if (builder->slot_count == 0) {
+		assert(builder->extents_size == 0);
+		return;
+	}
 	/*
 	 * To initialize the field map and its extents, prepare
 	 * the following memory layout with pointers:
 	 *
 	 *                      offset
-	 * buffer       +---------------------+
-	 * |            |                     |
-	 * [extentK] .. [extent1][[slotN]..[slot2][slot1]]
-	 * |            |                               |
-	 * |extent_wptr |        |                      |field_map
-	 * ->           ->                              <-
+	 * buffer       +--------------------------+
+	 * |            |                          |
+	 * [extentK] .. [extent1][[slotN]..[slot2][slot1]][tag]
+	 * |            |                     |           |
+	 * |extent_wptr |        |            |slots      |field_map
+	 * ->           ->                    <-          <-
 	 *
 	 * The buffer size is assumed to be sufficient to write
 	 * field_map_build_size(builder) bytes there.
 	 */
-	uint32_t *field_map =
-		(uint32_t *)(buffer + field_map_build_size(builder));
+	char *field_map = buffer + field_map_build_size(builder);
+	char *slots = field_map - FIELD_MAP_TAG_SIZE;
+	uint32_t slot_size = field_map_build_slot_size(builder);
+	*(uint8_t *)slots = slot_size;
 	char *extent_wptr = buffer;
 	for (int32_t i = -1; i >= -(int32_t)builder->slot_count; i--) {
 		/*
-		 * Can not access field_map as a normal uint32
-		 * array because its alignment may be < 4 bytes.
+		 * Can not access field_map as a normal uint16/uint32
+		 * array because its alignment may be < 2/4 bytes.
 		 * Need to use unaligned store-load operations
 		 * explicitly.
 		 */
+		if (slot_size == sizeof(uint8_t)) {
+			assert(!builder->slots[i].has_extent);
+			((uint8_t *)slots)[i] = builder->slots[i].offset;
+			continue;
+		}
+		if (slot_size == sizeof(uint16_t)) {
+			assert(!builder->slots[i].has_extent);
+			store_u16(&((uint16_t *)slots)[i],
+				  builder->slots[i].offset);
+			continue;
+		}
+		uint32_t *slot = &((uint32_t *)slots)[i];
 		if (!builder->slots[i].has_extent) {
-			store_u32(&field_map[i], builder->slots[i].offset);
+			store_u32(slot, builder->slots[i].offset);
 			continue;
 		}
 		struct field_map_builder_slot_extent *extent =
 						builder->slots[i].extent;
 		/** Retrive memory for the extent. */
-		store_u32(&field_map[i], extent_wptr - (char *)field_map);
+		store_u32(slot, extent_wptr - field_map);
 		store_u32(extent_wptr, extent->size);
 		uint32_t extent_offset_sz = extent->size * sizeof(uint32_t);
 		memcpy(&((uint32_t *) extent_wptr)[1], extent->offset,
@@ -42,6 +42,11 @@ extern "C" {
 struct region;
 struct field_map_builder_slot;
 
+enum {
+	/** Size of the field map tag storing the size of a slot. */
+	FIELD_MAP_TAG_SIZE = 1,
+};
+
 /**
  * A special value of multikey index that means that the key
  * definition is not multikey and no indirection is expected.
@@ -50,8 +55,9 @@ enum { MULTIKEY_NONE = -1 };
 
 /**
  * A field map is a special area is reserved before tuple's
- * MessagePack data. It is a sequence of the 32-bit unsigned
- * offsets of tuple's indexed fields.
+ * MessagePack data. It is a sequence of the unsigned offsets of
+ * tuple's indexed fields followed by a one-byte tag that stores
+ * the size of a single offset slot.
  *
  * These slots are numbered with negative indices called
  * offset_slot(s) starting with -1 (this is necessary to organize
@@ -59,16 +65,21 @@ enum { MULTIKEY_NONE = -1 };
  * offset_slot(s) is performed on tuple_format creation on index
  * create or alter (see tuple_format_create()).
  *
- *        4b   4b      4b          4b       MessagePack data.
- *       +-----------+------+----+------+------------------------+
- *tuple: |cnt|off1|..| offN | .. | off1 | header ..|key1|..|keyN||
- *       +-----+-----+--+---+----+--+---+------------------------+
+ *        4b   4b      4b          4b   1b  MessagePack data.
+ *       +-----------+------+----+------+---+--------------------+
+ *tuple: |cnt|off1|..| offN | .. | off1 |tag|header ..|key1|..|keyN||
+ *       +-----+-----+--+---+----+--+---+---+--------------------+
  * ext1  ^     |        |   ...     |                 ^       ^
  *       +-----|--------+           |                 |       |
  * indirection |                    +-----------------+       |
  *             +----------------------------------------------+
  *             (offset_slot = N, extent_slot = 1) --> offset
  *
+ * Most tuples are small, so their field offsets fit in one or
+ * two bytes. In this case the slots are 1 or 2 bytes wide, which
+ * is what the tag says. The slots are always 4 bytes wide when
+ * the map has extents.
+ *
  * This field_map_builder class is used for tuple field_map
  * construction. It encapsulates field_map build logic and size
  * estimation implementation-specific details.
@@ -101,6 +112,11 @@ struct field_map_builder {
 	 * extents.
 	 */
 	uint32_t extents_size;
+	/**
+	 * The maximal offset stored in a slot without an extent.
+	 * Defines the size of a slot.
+	 */
+	uint32_t max_offset;
 };
 
 /**
@@ -156,12 +172,19 @@ static inline uint32_t
 field_map_get_offset(const uint32_t *field_map, int32_t offset_slot,
 		     int multikey_idx)
 {
+	const char *slots = (const char *)field_map - FIELD_MAP_TAG_SIZE;
+	uint8_t slot_size = *(const uint8_t *)slots;
+	if (slot_size == sizeof(uint8_t))
+		return ((const uint8_t *)slots)[offset_slot];
 	/*
-	 * Can not access field_map as a normal uint32 array
-	 * because its alignment may be < 4 bytes. Need to use
-	 * unaligned store-load operations explicitly.
+	 * Can not access field_map as a normal uint16/uint32
+	 * array because its alignment may be < 2/4 bytes. Need
+	 * to use unaligned store-load operations explicitly.
 	 */
-	uint32_t offset = load_u32(&field_map[offset_slot]);
+	if (slot_size == sizeof(uint16_t))
+		return load_u16(&((const uint16_t *)slots)[offset_slot]);
+	assert(slot_size == sizeof(uint32_t));
+	uint32_t offset = load_u32(&((const uint32_t *)slots)[offset_slot]);
 	if (multikey_idx != MULTIKEY_NONE && (int32_t)offset < 0) {
 		/**
 		 * The field_map extent has the following
@@ -224,6 +247,8 @@ field_map_builder_set_slot(struct field_map_builder *builder,
 	assert(offset > 0);
 	if (multikey_idx == MULTIKEY_NONE) {
 		builder->slots[offset_slot].offset = offset;
+		if (offset > builder->max_offset)
+			builder->max_offset = offset;
 	} else {
 		assert(multikey_idx >= 0);
 		assert(multikey_idx < (int32_t)multikey_count);
@@ -243,14 +268,31 @@ field_map_builder_set_slot(struct field_map_builder *builder,
 	return 0;
 }
 
+/**
+ * Size of a single slot of the field_map to be built.
+ */
+static inline uint32_t
+field_map_build_slot_size(struct field_map_builder *builder)
+{
+	if (builder->extents_size == 0) {
+		if (builder->max_offset <= UINT8_MAX)
+			return sizeof(uint8_t);
+		if (builder->max_offset <= UINT16_MAX)
+			return sizeof(uint16_t);
+	}
+	return sizeof(uint32_t);
+}
+
 /**
  * Calculate the size of tuple field_map to be built.
  */
 static inline uint32_t
 field_map_build_size(struct field_map_builder *builder)
 {
-	return builder->slot_count * sizeof(uint32_t) +
-	       builder->extents_size;
+	if (builder->slot_count == 0)
+		return 0;
+	return builder->slot_count * field_map_build_slot_size(builder) +
+	       FIELD_MAP_TAG_SIZE + builder->extents_size;
 }
 
 /**
@@ -29,6 +29,7 @@
  * SUCH DAMAGE.
  */
 #include "func.h"
+#include "func_cache.h"
 #include "fiber.h"
 #include "assoc.h"
 #include "lua/call.h"
@@ -413,6 +414,7 @@ func_new(struct func_def *def)
 	 * checks (see user_has_data()).
 	 */
 	credentials_create_empty(&func->owner_credentials);
+	func->cache = NULL;
 	return func;
 }
 
@@ -489,6 +491,8 @@ func_c_call(struct func *base, struct port *args, struct port *ret)
 	 * thus while been inside the call the associated
 	 * schema_module can be unreferenced and freed.
 	 */
+	if (base->def->opts.is_threadsafe)
+		return module_func_call_in_thread(&func->mf, args, ret);
 	return module_func_call(&func->mf, args, ret);
 }
 
@@ -502,12 +506,12 @@ func_delete(struct func *func)
 {
 	struct func_def *def = func->def;
 	credentials_destroy(&func->owner_credentials);
+	func_cache_destroy(func);
 	func->vtab->destroy(func);
 	free(def);
 }
 
-/** Check "EXECUTE" permissions for a given function. */
-static int
+int
 func_access_check(struct func *func)
 {
 	struct credentials *credentials = effective_user();
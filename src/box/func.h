@@ -44,6 +44,7 @@ extern "C" {
 #endif /* defined(__cplusplus) */
 
 struct func;
+struct mh_strnptr_t;
 
 /** Virtual method table for func object. */
 struct func_vtab {
@@ -69,6 +70,11 @@ struct func {
 	 * Cached runtime access information.
 	 */
 	struct access access[BOX_USER_MAX];
+	/**
+	 * Cached CALL results, NULL if there are none.
+	 * See func_cache.h.
+	 */
+	struct mh_strnptr_t *cache;
 };
 
 /**
@@ -89,6 +95,10 @@ func_new(struct func_def *def);
 void
 func_delete(struct func *func);
 
+/** Check "EXECUTE" permissions for a given function. */
+int
+func_access_check(struct func *func);
+
 /**
  * Call function with arguments represented with given args.
  */
@@ -0,0 +1,108 @@
+/*
+ * SPDX-License-Identifier: BSD-2-Clause
+ *
+ * Copyright 2010-2021, Tarantool AUTHORS, please see AUTHORS file.
+ */
+
+#include "func_cache.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "assoc.h"
+#include "func.h"
+#include "txn.h"
+
+struct func_cache_entry {
+	/** Value of txn_data_generation the result is valid for. */
+	uint64_t generation;
+	/** Number of values, see port_dump_msgpack(). */
+	int count;
+	/** Size of the result. */
+	uint32_t size;
+	/** Size of the arguments. */
+	uint32_t args_size;
+	/** The result followed by the arguments. */
+	char data[0];
+};
+
+static void
+func_cache_clear(struct mh_strnptr_t *cache)
+{
+	mh_int_t i;
+	mh_foreach(cache, i)
+		free(mh_strnptr_node(cache, i)->val);
+	mh_strnptr_clear(cache);
+}
+
+const char *
+func_cache_get(struct func *func, const char *args, const char *args_end,
+	       uint32_t *size, int *count)
+{
+	struct mh_strnptr_t *cache = func->cache;
+	if (cache == NULL)
+		return NULL;
+	mh_int_t i = mh_strnptr_find_inp(cache, args, args_end - args);
+	if (i == mh_end(cache))
+		return NULL;
+	struct func_cache_entry *entry = mh_strnptr_node(cache, i)->val;
+	if (entry->generation != txn_data_generation) {
+		/*
+		 * Any data change invalidates all results, so drop
+		 * them at once instead of one by one.
+		 */
+		func_cache_clear(cache);
+		return NULL;
+	}
+	*size = entry->size;
+	*count = entry->count;
+	return entry->data;
+}
+
+void
+func_cache_put(struct func *func, const char *args, const char *args_end,
+	       const char *data, uint32_t size, int count)
+{
+	if (func->cache == NULL) {
+		func->cache = mh_strnptr_new();
+		if (func->cache == NULL)
+			return;
+	}
+	struct mh_strnptr_t *cache = func->cache;
+	uint32_t args_size = args_end - args;
+	mh_int_t i = mh_strnptr_find_inp(cache, args, args_size);
+	if (i != mh_end(cache)) {
+		free(mh_strnptr_node(cache, i)->val);
+		mh_strnptr_del(cache, i, NULL);
+	} else if (mh_size(cache) >= FUNC_CACHE_SIZE_MAX) {
+		func_cache_clear(cache);
+	}
+	struct func_cache_entry *entry = malloc(sizeof(*entry) + size +
+						args_size);
+	if (entry == NULL)
+		return;
+	entry->generation = txn_data_generation;
+	entry->count = count;
+	entry->size = size;
+	entry->args_size = args_size;
+	memcpy(entry->data, data, size);
+	memcpy(entry->data + size, args, args_size);
+	const struct mh_strnptr_node_t node = {
+		.str = entry->data + size,
+		.len = args_size,
+		.hash = mh_strn_hash(args, args_size),
+		.val = entry,
+	};
+	if (mh_strnptr_put(cache, &node, NULL, NULL) == mh_end(cache))
+		free(entry);
+}
+
+void
+func_cache_destroy(struct func *func)
+{
+	if (func->cache == NULL)
+		return;
+	func_cache_clear(func->cache);
+	mh_strnptr_delete(func->cache);
+	func->cache = NULL;
+}
@@ -0,0 +1,65 @@
+/*
+ * SPDX-License-Identifier: BSD-2-Clause
+ *
+ * Copyright 2010-2021, Tarantool AUTHORS, please see AUTHORS file.
+ */
+
+#pragma once
+
+#include <stdint.h>
+
+#if defined(__cplusplus)
+extern "C" {
+#endif /* defined(__cplusplus) */
+
+struct func;
+
+/**
+ * Cache of CALL results of functions with the cache option.
+ *
+ * A result is stored as the IPROTO_DATA MessagePack of a reply,
+ * keyed by the function arguments. It is valid while
+ * txn_data_generation doesn't change, i.e. until any data change
+ * or DDL, including redefinition of the function itself.
+ */
+enum {
+	/**
+	 * Max number of results cached for one function. The
+	 * cache of a function is cleared when it overflows.
+	 */
+	FUNC_CACHE_SIZE_MAX = 1024,
+};
+
+/**
+ * Look up a cached result of a function call.
+ *
+ * @param func function.
+ * @param args arguments, MessagePack array.
+ * @param args_end end of the arguments.
+ * @param[out] size size of the result.
+ * @param[out] count number of values in the result, as returned
+ *             by port_dump_msgpack().
+ *
+ * @return the result or NULL if there's no valid one.
+ */
+const char *
+func_cache_get(struct func *func, const char *args, const char *args_end,
+	       uint32_t *size, int *count);
+
+/**
+ * Cache a result of a function call. The arguments and the result
+ * are copied. The result is valid for the current
+ * txn_data_generation. Errors are ignored: the cache is best
+ * effort.
+ */
+void
+func_cache_put(struct func *func, const char *args, const char *args_end,
+	       const char *data, uint32_t size, int count);
+
+/** Drop all cached results of a function. */
+void
+func_cache_destroy(struct func *func);
+
+#if defined(__cplusplus)
+} /* extern "C" */
+#endif /* defined(__cplusplus) */
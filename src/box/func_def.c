@@ -41,11 +41,15 @@ const char *func_aggregate_strs[] = {"none", "group"};
 const struct func_opts func_opts_default = {
 	/* .is_multikey = */ false,
 	/* .takes_raw_args = */ false,
+	/* .is_threadsafe = */ false,
+	/* .cache = */ false,
 };
 
 const struct opt_def func_opts_reg[] = {
 	OPT_DEF("is_multikey", OPT_BOOL, struct func_opts, is_multikey),
 	OPT_DEF("takes_raw_args", OPT_BOOL, struct func_opts, takes_raw_args),
+	OPT_DEF("is_threadsafe", OPT_BOOL, struct func_opts, is_threadsafe),
+	OPT_DEF("cache", OPT_BOOL, struct func_opts, cache),
 };
 
 int
@@ -55,6 +59,10 @@ func_opts_cmp(struct func_opts *o1, struct func_opts *o2)
 		return o1->is_multikey - o2->is_multikey;
 	if (o1->takes_raw_args != o2->takes_raw_args)
 		return o1->takes_raw_args - o2->takes_raw_args;
+	if (o1->is_threadsafe != o2->is_threadsafe)
+		return o1->is_threadsafe - o2->is_threadsafe;
+	if (o1->cache != o2->cache)
+		return o1->cache - o2->cache;
 	return 0;
 }
 
@@ -103,6 +111,17 @@ func_def_cmp(struct func_def *def1, struct func_def *def2)
 int
 func_def_check(struct func_def *def)
 {
+	if (def->opts.is_threadsafe && def->language != FUNC_LANGUAGE_C) {
+		diag_set(ClientError, ER_CREATE_FUNCTION, def->name,
+			 "is_threadsafe option may be set only for a C function");
+		return -1;
+	}
+	if (def->opts.cache && !def->is_deterministic) {
+		diag_set(ClientError, ER_CREATE_FUNCTION, def->name,
+			 "cache option may be set only for a deterministic "
+			 "function");
+		return -1;
+	}
 	switch (def->language) {
 	case FUNC_LANGUAGE_C:
 		if (def->body != NULL || def->is_sandboxed) {
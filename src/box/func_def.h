@@ -72,6 +72,17 @@ struct func_opts {
 	 * True if the function expects a msgpack object for args.
 	 */
 	bool takes_raw_args;
+	/**
+	 * True if a C function may be executed in a worker thread,
+	 * outside the TX thread. Such a function must not use the
+	 * box API.
+	 */
+	bool is_threadsafe;
+	/**
+	 * True if results of IPROTO_CALL of the function are
+	 * cached until any data change. Requires is_deterministic.
+	 */
+	bool cache;
 };
 
 extern const struct func_opts func_opts_default;
@@ -33,13 +33,16 @@
 #include <trivia/util.h>
 
 #include <assert.h>
+#include <fcntl.h>
 #include <limits.h>
 #include <stdarg.h>
 #include <stdbool.h>
 #include <stdint.h>
 #include <stdlib.h>
 #include <stdio.h>
+#include <string.h>
 #include <time.h>
+#include <unistd.h>
 
 #define RB_COMPACT 1
 #include <small/rb.h>
@@ -50,20 +53,46 @@
 #include "errcode.h"
 #include "fiber.h"
 #include "fiber_cond.h"
+#include "file_reclaim.h"
 #include "latch.h"
+#include "path_lock.h"
 #include "say.h"
+#include "trigger.h"
 #include "cbus.h"
 #include "engine.h"		/* engine_collect_garbage() */
 #include "wal.h"		/* wal_collect_garbage() */
 #include "checkpoint_schedule.h"
 #include "txn_limbo.h"
+#include "box.h"		/* box_on_shutdown_trigger_list */
 
 struct gc_state gc;
 
+/** Stops the checkpoint daemon on shutdown, see gc_on_shutdown_f(). */
+static struct trigger gc_on_shutdown;
+
+enum {
+	/**
+	 * Removed files larger than this are truncated in chunks
+	 * of this size before they are closed, so that freeing
+	 * a multi-gigabyte xlog or run file doesn't stall disk
+	 * I/O, see file_reclaim_unlink().
+	 */
+	GC_RECLAIM_CHUNK_SIZE = 64 * 1024 * 1024,
+	/** Rate at which removed files are truncated, bytes/s. */
+	GC_RECLAIM_RATE = 256 * 1024 * 1024,
+	/**
+	 * How often to retry locking box.cfg.checkpoint_lock
+	 * while another instance is making a checkpoint, seconds.
+	 */
+	GC_CHECKPOINT_LOCK_RETRY_TIMEOUT = 1,
+};
+
 static int
 gc_cleanup_fiber_f(va_list);
 static int
 gc_checkpoint_fiber_f(va_list);
+static int
+gc_on_shutdown_f(struct trigger *trigger, void *event);
 
 /**
  * Comparator used for ordering gc_consumer objects
@@ -117,6 +146,7 @@ gc_init(void)
 	gc_tree_new(&gc.consumers);
 	fiber_cond_create(&gc.cleanup_cond);
 	checkpoint_schedule_cfg(&gc.checkpoint_schedule, 0, 0);
+	gc.checkpoint_lock = NULL;
 
 	gc.cleanup_fiber = fiber_new("gc", gc_cleanup_fiber_f);
 	if (gc.cleanup_fiber == NULL)
@@ -129,6 +159,12 @@ gc_init(void)
 
 	fiber_start(gc.cleanup_fiber);
 	fiber_start(gc.checkpoint_fiber);
+
+	trigger_create(&gc_on_shutdown, gc_on_shutdown_f, NULL, NULL);
+	trigger_add(&box_on_shutdown_trigger_list, &gc_on_shutdown);
+
+	if (file_reclaim_init(GC_RECLAIM_CHUNK_SIZE, GC_RECLAIM_RATE) != 0)
+		panic("failed to start file reclaim thread");
 }
 
 void
@@ -138,6 +174,10 @@ gc_free(void)
 	 * Can't clear the WAL watcher as the event loop isn't
 	 * running when this function is called.
 	 */
+	file_reclaim_free();
+
+	trigger_clear(&gc_on_shutdown);
+	free(gc.checkpoint_lock);
 
 	/* Free checkpoints. */
 	struct gc_checkpoint *checkpoint, *next_checkpoint;
@@ -410,6 +450,26 @@ gc_set_min_checkpoint_count(int min_checkpoint_count)
 	gc.min_checkpoint_count = min_checkpoint_count;
 }
 
+int
+gc_set_checkpoint_lock(const char *path)
+{
+	char *copy = NULL;
+	if (path != NULL) {
+		/* path_lock() needs the file to exist. */
+		int fd = open(path, O_RDONLY | O_CREAT, 0666);
+		if (fd < 0) {
+			diag_set(SystemError, "failed to create checkpoint "
+				 "lock file '%s'", path);
+			return -1;
+		}
+		close(fd);
+		copy = xstrdup(path);
+	}
+	free(gc.checkpoint_lock);
+	gc.checkpoint_lock = copy;
+	return 0;
+}
+
 void
 gc_set_checkpoint_interval(double interval)
 {
@@ -470,6 +530,7 @@ gc_do_checkpoint(bool is_scheduled)
 
 	assert(!gc.checkpoint_is_in_progress);
 	gc.checkpoint_is_in_progress = true;
+	double start = ev_monotonic_now(loop());
 
 	/*
 	 * Rotate WAL and call engine callbacks to create a checkpoint
@@ -509,6 +570,7 @@ gc_do_checkpoint(bool is_scheduled)
 	 * collector state.
 	 */
 	gc_add_checkpoint(&checkpoint.vclock);
+	gc.checkpoint_duration = ev_monotonic_now(loop()) - start;
 out:
 	if (rc != 0)
 		engine_abort_checkpoint();
@@ -568,6 +630,66 @@ gc_trigger_checkpoint(void)
 	fiber_wakeup(gc.checkpoint_fiber);
 }
 
+/**
+ * Wait until no other instance sharing box.cfg.checkpoint_lock
+ * is making a checkpoint and lock the file with path_lock().
+ * The lock to pass to gc_checkpoint_unlock() is returned in
+ * @a lock, -1 if there's no lock. The lock is released by the
+ * kernel if the instance holding it dies.
+ *
+ * Returns -1 if the fiber was cancelled while waiting, in which
+ * case the checkpoint must be skipped.
+ */
+static int
+gc_checkpoint_lock(int *lock)
+{
+	bool is_first_try = true;
+	while (true) {
+		*lock = -1;
+		if (fiber_is_cancelled()) {
+			diag_set(FiberIsCancelled);
+			return -1;
+		}
+		/* The lock may be reconfigured while we're waiting. */
+		if (gc.checkpoint_lock == NULL)
+			return 0;
+		if (path_lock(gc.checkpoint_lock, lock) != 0) {
+			diag_log();
+			return 0;
+		}
+		if (*lock >= 0)
+			return 0;
+		if (is_first_try) {
+			say_info("waiting for another instance "
+				 "to complete checkpoint");
+			is_first_try = false;
+		}
+		fiber_sleep(GC_CHECKPOINT_LOCK_RETRY_TIMEOUT);
+	}
+}
+
+/** Release the lock taken by gc_checkpoint_lock(). */
+static void
+gc_checkpoint_unlock(int lock)
+{
+	if (lock >= 0)
+		path_unlock(lock);
+}
+
+/**
+ * The checkpoint daemon isn't cancellable, so cancelling it only
+ * sets the flag, which it checks when it wakes up, see
+ * gc_checkpoint_lock().
+ */
+static int
+gc_on_shutdown_f(struct trigger *trigger, void *event)
+{
+	(void)trigger;
+	(void)event;
+	fiber_cancel(gc.checkpoint_fiber);
+	return 0;
+}
+
 static int
 gc_checkpoint_fiber_f(va_list ap)
 {
@@ -604,15 +726,20 @@ gc_checkpoint_fiber_f(va_list ap)
 		}
 		/* Time to make the next scheduled checkpoint. */
 		gc.checkpoint_is_pending = false;
+		int lock_fd;
+		if (gc_checkpoint_lock(&lock_fd) != 0)
+			continue;
 		if (gc.checkpoint_is_in_progress) {
 			/*
 			 * Another fiber is making a checkpoint.
 			 * Skip this one.
 			 */
+			gc_checkpoint_unlock(lock_fd);
 			continue;
 		}
 		if (gc_do_checkpoint(true) != 0)
 			diag_log();
+		gc_checkpoint_unlock(lock_fd);
 	}
 	return 0;
 }
@@ -174,6 +174,15 @@ struct gc_state {
 	 * a checkpoint as soon as possible despite the schedule.
 	 */
 	bool checkpoint_is_pending;
+	/** Time it took to make the last checkpoint, in seconds. */
+	double checkpoint_duration;
+	/**
+	 * Path to the file shared by instances running on the
+	 * same host, which is locked for the duration of a
+	 * scheduled checkpoint, or NULL. Configured by
+	 * box.cfg.checkpoint_lock.
+	 */
+	char *checkpoint_lock;
 };
 extern struct gc_state gc;
 
@@ -267,6 +276,15 @@ gc_set_min_checkpoint_count(int min_checkpoint_count);
 void
 gc_set_checkpoint_interval(double interval);
 
+/**
+ * Set the path of the file locked for the duration of a scheduled
+ * checkpoint, so that instances sharing it never make scheduled
+ * checkpoints at the same time. NULL disables locking.
+ * Returns 0 on success, -1 if the file can't be opened.
+ */
+int
+gc_set_checkpoint_lock(const char *path);
+
 /**
  * Track an existing checkpoint in the garbage collector state.
  * Note, this function may trigger garbage collection to remove
@@ -39,6 +39,8 @@
 #include "rmean.h"
 #include "info/info.h"
 #include "memtx_tx.h"
+#include "op_latency.h"
+#include "coll/coll.h"
 
 /* {{{ Utilities. **********************************************/
 
@@ -64,11 +66,55 @@ BuildUnsupportedIndexFeature(const char *file, unsigned line,
 	}
 }
 
+/**
+ * Check the key of an ITER_PREFIX iterator. The key must have at
+ * least one part, and its last part must be a string. The index
+ * part it is matched against must order strings byte by byte, so
+ * that all strings starting with the key follow each other.
+ */
+static int
+key_validate_prefix(const struct index_def *index_def, const char *key,
+		    uint32_t part_count)
+{
+	struct key_def *key_def = index_def->key_def;
+	if (part_count == 0) {
+		diag_set(ClientError, ER_ILLEGAL_PARAMS,
+			 "PREFIX iterator requires a key");
+		return -1;
+	}
+	if (part_count > key_def->part_count) {
+		diag_set(ClientError, ER_KEY_PART_COUNT,
+			 key_def->part_count, part_count);
+		return -1;
+	}
+	const struct key_part *part = &key_def->parts[part_count - 1];
+	if ((part->type != FIELD_TYPE_STRING &&
+	     part->type != FIELD_TYPE_SCALAR) ||
+	    (part->coll != NULL && part->coll->type != COLL_TYPE_BINARY) ||
+	    key_def->is_multikey || key_def->for_func_index) {
+		diag_set(UnsupportedIndexFeature,
+			 (struct index_def *)index_def,
+			 "PREFIX iterator over this key part");
+		return -1;
+	}
+	for (uint32_t i = 0; i < part_count - 1; i++)
+		mp_next(&key);
+	if (mp_typeof(*key) != MP_STR) {
+		diag_set(ClientError, ER_KEY_PART_TYPE, part_count - 1,
+			 field_type_strs[FIELD_TYPE_STRING]);
+		return -1;
+	}
+	return 0;
+}
+
 int
 key_validate(const struct index_def *index_def, enum iterator_type type,
 	     const char *key, uint32_t part_count)
 {
 	assert(key != NULL || part_count == 0);
+	if (type == ITER_PREFIX &&
+	    key_validate_prefix(index_def, key, part_count) != 0)
+		return -1;
 	if (part_count == 0) {
 		/*
 		 * Zero key parts are allowed:
@@ -135,6 +181,28 @@ key_validate(const struct index_def *index_def, enum iterator_type type,
 	return 0;
 }
 
+bool
+tuple_matches_prefix(struct tuple *tuple, struct key_def *key_def,
+		     const char *key, uint32_t part_count)
+{
+	assert(part_count > 0);
+	uint32_t last = part_count - 1;
+	if (last > 0 && tuple_compare_with_key(tuple, HINT_NONE, key, last,
+					       HINT_NONE, key_def) != 0)
+		return false;
+	for (uint32_t i = 0; i < last; i++)
+		mp_next(&key);
+	uint32_t prefix_len;
+	const char *prefix = mp_decode_str(&key, &prefix_len);
+	const char *field = tuple_field_by_part(tuple, &key_def->parts[last],
+						MULTIKEY_NONE);
+	if (field == NULL || mp_typeof(*field) != MP_STR)
+		return false;
+	uint32_t len;
+	field = mp_decode_str(&field, &len);
+	return len >= prefix_len && memcmp(field, prefix, prefix_len) == 0;
+}
+
 int
 exact_key_validate(struct key_def *key_def, const char *key,
 		   uint32_t part_count)
@@ -243,10 +311,13 @@ box_index_get(uint32_t space_id, uint32_t index_id, const char *key,
 	struct txn_ro_savepoint svp;
 	if (txn_begin_ro_stmt(space, &txn, &svp) != 0)
 		return -1;
+	double start = op_latency_start();
 	if (index_get(index, key, part_count, result) != 0) {
 		txn_rollback_stmt(txn);
 		return -1;
 	}
+	if (start != 0)
+		op_latency_collect(&index->latency, OP_LATENCY_GET, start);
 	txn_commit_ro_stmt(txn, &svp);
 	/* Count statistics. */
 	rmean_collect(rmean_box, IPROTO_SELECT, 1);
@@ -397,13 +468,51 @@ int
 box_iterator_next(box_iterator_t *itr, box_tuple_t **result)
 {
 	assert(result != NULL);
+	double start = op_latency_start();
 	if (iterator_next(itr, result) != 0)
 		return -1;
+	/*
+	 * The index may have been dropped while the iterator
+	 * yielded, in which case the schema version is stale.
+	 */
+	if (start != 0 && itr->space_id != 0 &&
+	    itr->space_cache_version == space_cache_version) {
+		op_latency_collect(&itr->index->latency, OP_LATENCY_NEXT,
+				   start);
+	}
 	if (*result != NULL)
 		tuple_bless(*result);
 	return 0;
 }
 
+int
+box_iterator_next_batch(box_iterator_t *itr, box_tuple_t **result,
+			uint32_t count)
+{
+	assert(result != NULL || count == 0);
+	double start = op_latency_start();
+	uint32_t i;
+	for (i = 0; i < count; i++) {
+		struct tuple *tuple;
+		if (iterator_next(itr, &tuple) != 0) {
+			while (i > 0)
+				tuple_unref(result[--i]);
+			return -1;
+		}
+		if (tuple == NULL)
+			break;
+		tuple_ref(tuple);
+		result[i] = tuple;
+	}
+	/* One observation per batch, see box_iterator_next(). */
+	if (start != 0 && itr->space_id != 0 &&
+	    itr->space_cache_version == space_cache_version) {
+		op_latency_collect(&itr->index->latency, OP_LATENCY_NEXT,
+				   start);
+	}
+	return i;
+}
+
 void
 box_iterator_free(box_iterator_t *it)
 {
@@ -502,6 +611,7 @@ index_create(struct index *index, struct engine *engine,
 	index->dense_id = UINT32_MAX;
 	rlist_create(&index->nearby_gaps);
 	rlist_create(&index->full_scans);
+	index->latency = NULL;
 	return 0;
 }
 
@@ -515,6 +625,7 @@ index_delete(struct index *index)
 	 * the index is primary or secondary.
 	 */
 	struct index_def *def = index->def;
+	op_latency_delete(index->latency);
 	memtx_tx_on_index_delete(index);
 	index->vtab->destroy(index);
 	index_def_delete(def);
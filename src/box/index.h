@@ -45,6 +45,7 @@ struct index;
 struct index_def;
 struct key_def;
 struct info_handler;
+struct op_latency;
 
 typedef struct tuple box_tuple_t;
 typedef struct key_def box_key_def_t;
@@ -82,6 +83,25 @@ box_index_iterator(uint32_t space_id, uint32_t index_id, int type,
 int
 box_iterator_next(box_iterator_t *iterator, box_tuple_t **result);
 
+/**
+ * Retrieve up to \a count next items from the \a iterator.
+ *
+ * Unlike box_iterator_next(), every returned tuple is referenced
+ * and stays valid until the caller unreferences it with
+ * box_tuple_unref(), so a batch can be consumed across yields.
+ *
+ * \param iterator an iterator returned by box_index_iterator().
+ * \param[out] result an array of at least \a count tuples.
+ * \param count the maximal number of tuples to retrieve.
+ * \retval -1 on error (check box_error_last() for details).
+ *         Nothing is returned then.
+ * \retval >= 0 the number of retrieved tuples. Less than \a count
+ *         means that there is no more data.
+ */
+int
+box_iterator_next_batch(box_iterator_t *iterator, box_tuple_t **result,
+			uint32_t count);
+
 /**
  * Destroy and deallocate iterator.
  *
@@ -318,6 +338,16 @@ int
 key_validate(const struct index_def *index_def, enum iterator_type type,
 	     const char *key, uint32_t part_count);
 
+/**
+ * Check if a tuple matches the key of an ITER_PREFIX iterator:
+ * the first @a part_count - 1 parts are equal to the key, and the
+ * string in the last part starts with the last part of the key.
+ * The key must have passed key_validate() for ITER_PREFIX.
+ */
+bool
+tuple_matches_prefix(struct tuple *tuple, struct key_def *key_def,
+		     const char *key, uint32_t part_count);
+
 /**
  * Check that the supplied key is valid for a search in a unique
  * index (i.e. the key must be fully specified).
@@ -483,6 +513,11 @@ struct index {
 	struct rlist nearby_gaps;
 	/** List of full scans of the index. @sa struct full_scan_item. */
 	struct rlist full_scans;
+	/**
+	 * Latency of get, select and iterator steps, or NULL.
+	 * See box.cfg.space_latency_stat.
+	 */
+	struct op_latency *latency;
 };
 
 /**
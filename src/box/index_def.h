@@ -58,6 +58,35 @@ enum rtree_index_distance_type {
 };
 extern const char *rtree_index_distance_type_strs[];
 
+/** Vinyl compaction policy. */
+enum index_compaction_policy {
+	/**
+	 * Leveled compaction: the number of runs at each level
+	 * is limited by run_count_per_level, and the last level
+	 * always consists of a single run.
+	 */
+	INDEX_COMPACTION_LEVELED,
+	/**
+	 * Tiered compaction: same as leveled, but the last level
+	 * may store up to run_count_per_level runs, too. Trades
+	 * space and read amplification for lower write
+	 * amplification, because the biggest run is rewritten
+	 * less often.
+	 */
+	INDEX_COMPACTION_TIERED,
+	index_compaction_policy_MAX
+};
+extern const char *index_compaction_policy_strs[];
+
+/**
+ * Limits of the compression_dict_size vinyl index option.
+ * The min value is the min dictionary size supported by zstd.
+ */
+enum {
+	INDEX_COMPRESSION_DICT_SIZE_MIN = 256,
+	INDEX_COMPRESSION_DICT_SIZE_MAX = 1024 * 1024,
+};
+
 /** Simple alias to represent logarithm metrics. */
 typedef int16_t log_est_t;
 
@@ -153,6 +182,18 @@ struct index_opts {
 	double run_size_ratio;
 	/* Bloom filter false positive rate. */
 	double bloom_fpr;
+	/**
+	 * If set, a separate bloom filter is built for each
+	 * page of a run instead of one filter for the whole run.
+	 */
+	bool bloom_partitioned;
+	/** Compaction policy. */
+	enum index_compaction_policy compaction_policy;
+	/**
+	 * Size of the zstd dictionary trained for compressing
+	 * run pages, 0 if dictionary compression is disabled.
+	 */
+	int64_t compression_dict_size;
 	/**
 	 * LSN from the time of index creation.
 	 */
@@ -213,6 +254,13 @@ index_opts_cmp(const struct index_opts *o1, const struct index_opts *o2)
 		return o1->run_size_ratio < o2->run_size_ratio ? -1 : 1;
 	if (o1->bloom_fpr != o2->bloom_fpr)
 		return o1->bloom_fpr < o2->bloom_fpr ? -1 : 1;
+	if (o1->bloom_partitioned != o2->bloom_partitioned)
+		return o1->bloom_partitioned - o2->bloom_partitioned;
+	if (o1->compaction_policy != o2->compaction_policy)
+		return o1->compaction_policy < o2->compaction_policy ? -1 : 1;
+	if (o1->compression_dict_size != o2->compression_dict_size)
+		return o1->compression_dict_size <
+		       o2->compression_dict_size ? -1 : 1;
 	if (o1->func_id != o2->func_id)
 		return o1->func_id - o2->func_id;
 	if (o1->hint != o2->hint)
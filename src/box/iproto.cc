@@ -54,20 +54,26 @@
 #include "port.h"
 #include "box.h"
 #include "call.h"
+#include "func.h"
+#include "func_cache.h"
 #include "tuple_convert.h"
 #include "session.h"
+#include "index.h"
 #include "xrow.h"
 #include "schema.h" /* schema_version */
 #include "replication.h" /* instance_uuid */
 #include "iproto_constants.h"
 #include "iproto_features.h"
+#include "iproto_compress.h"
 #include "rmean.h"
+#include "clock.h"
 #include "execute.h"
 #include "errinj.h"
 #include "tt_static.h"
 #include "salad/stailq.h"
 #include "assoc.h"
 #include "txn.h"
+#include "probe.h"
 
 enum {
 	IPROTO_SALT_SIZE = 32,
@@ -130,6 +136,11 @@ struct iproto_thread {
 	 * in the tx thread.
 	 */
 	struct slab_cache net_slabc;
+	/**
+	 * Slab cache used for allocating memory for input network buffers
+	 * in the iproto thread.
+	 */
+	struct slab_cache ibuf_slabc;
 	/**
 	 * Network thread execution unit.
 	 */
@@ -160,11 +171,14 @@ struct iproto_thread {
 	struct cmsg_hop call_route[2];
 	struct cmsg_hop select_route[2];
 	struct cmsg_hop process1_route[2];
+	struct cmsg_hop batch_route[2];
+	struct cmsg_hop cursor_route[2];
 	struct cmsg_hop sql_route[2];
 	struct cmsg_hop join_route[2];
 	struct cmsg_hop subscribe_route[2];
 	struct cmsg_hop error_route[2];
 	struct cmsg_hop push_route[2];
+	struct cmsg_hop trim_route[2];
 	struct cmsg_hop *dml_route[IPROTO_TYPE_STAT_MAX];
 	struct cmsg_hop connect_route[2];
 	/*
@@ -177,14 +191,33 @@ struct iproto_thread {
 	 * List of stopped connections
 	 */
 	struct rlist stopped_connections;
+	/**
+	 * List of connections that have completed the handshake and
+	 * haven't been closed yet, linked by in_connections.
+	 */
+	struct rlist connections;
+	/**
+	 * Timer that periodically releases the buffers of the
+	 * connections that have been idle since the previous check,
+	 * see iproto_connection_trim().
+	 */
+	struct ev_timer idle_timer;
 	/*
 	 * Iproto thread stat
 	 */
 	struct rmean *rmean;
+	/** Request latency stat, updated in the iproto thread. */
+	struct iproto_latency latency;
+	/** Ring buffer of requests that took too long. */
+	struct iproto_slow_request slow_log[IPROTO_SLOW_LOG_SIZE];
+	/** Number of requests ever added to the slow log. */
+	uint64_t slow_log_count;
 	/*
 	 * Iproto thread id
 	 */
 	uint32_t id;
+	/** CPU the thread is pinned to or -1. */
+	int cpu;
 	/** Array of iproto binary listeners */
 	struct evio_service binary;
 	/** Requests count currently pending in stream queue. */
@@ -212,6 +245,11 @@ int iproto_threads_count;
  * in tx thread.
  */
 static struct evio_service tx_binary;
+/**
+ * If set, each iproto thread listens on sockets of its own bound
+ * with SO_REUSEPORT to the tx_binary addresses.
+ */
+static bool iproto_reuse_port;
 
 /**
  * In Greek mythology, Kharon is the ferryman who carries souls
@@ -235,6 +273,24 @@ struct iproto_kharon {
 	struct iproto_wpos wpos;
 };
 
+/**
+ * A message sent to tx to release the memory of the output buffers
+ * of an idle connection. Unlike obuf_reset(), which keeps all
+ * the memory an output buffer has ever used, this returns it to
+ * the slab cache.
+ */
+struct iproto_trim_msg {
+	struct cmsg base;
+	/**
+	 * Iproto sets wpos to the last flushed position. If it turns
+	 * out that all the output has been flushed, tx releases the
+	 * output buffers, sets is_done and wpos to the beginning of
+	 * the current output buffer.
+	 */
+	struct iproto_wpos wpos;
+	bool is_done;
+};
+
 /**
  * Network readahead. A signed integer to avoid
  * automatic type coercion to an unsigned type.
@@ -252,6 +308,38 @@ struct iproto_kharon {
  */
 unsigned iproto_readahead = 16320;
 
+enum {
+	/**
+	 * Input buffers of a connection that keeps filling them up
+	 * grow geometrically up to this many readaheads.
+	 */
+	IPROTO_READAHEAD_MAX_FACTOR = 16,
+	/** Max number of cursors open in a connection. */
+	IPROTO_CURSOR_MAX = 256,
+	/**
+	 * If the client supports chunked responses, a SELECT result
+	 * is sent in IPROTO_CHUNK packets of about this size.
+	 */
+	IPROTO_RESPONSE_CHUNK_SIZE = 256 * 1024,
+	/**
+	 * A chunked response waits for the connection output to be
+	 * flushed as long as there is more than this unsent.
+	 */
+	IPROTO_RESPONSE_OUTPUT_MAX = 4 * IPROTO_RESPONSE_CHUNK_SIZE,
+};
+
+/**
+ * If a connection hasn't received any input for this many
+ * seconds, its buffers are returned to the slab caches.
+ */
+static const double IPROTO_IDLE_CHECK_PERIOD = 1;
+
+/**
+ * How long a chunked response waits before asking iproto thread
+ * about the connection output again if it doesn't get flushed.
+ */
+static const double IPROTO_OUTPUT_CHECK_PERIOD = 0.001;
+
 /* The maximal number of iproto messages in fly. */
 static int iproto_msg_max = IPROTO_MSG_MAX_MIN;
 
@@ -319,6 +407,10 @@ struct iproto_msg
 		struct call_request call;
 		/** Watch request. */
 		struct watch_request watch;
+		/** Batch of DML and SELECT requests. */
+		struct batch_request batch;
+		/** CURSOR_FETCH/CURSOR_CLOSE request. */
+		struct cursor_request cursor;
 		/** Authentication request. */
 		struct auth_request auth;
 		/** Features request. */
@@ -357,11 +449,28 @@ struct iproto_msg
 	 * Used by long (yielding) CALL/EVAL requests.
 	 */
 	struct cmsg discard_input;
+	/**
+	 * Message sent by the tx thread to let iproto pass the next
+	 * request of the stream to tx before this request is complete.
+	 * Used by requests with IPROTO_FLAG_ASYNC_COMMIT.
+	 */
+	struct cmsg release_stream;
+	/**
+	 * Set by the tx thread before it sends release_stream. The
+	 * request doesn't own its stream after that.
+	 */
+	bool is_stream_released;
 	/**
 	 * Used in "connect" msgs, true if connect trigger failed
 	 * and the connection must be closed.
 	 */
 	bool close_connection;
+	/**
+	 * Set by the tx thread if this is an IPROTO_ID request
+	 * that enabled output compression. The output following
+	 * the reply to the request is compressed.
+	 */
+	bool enable_compression;
 	/**
 	 * A stailq_entry to hold message in stream.
 	 * All messages processed in stream sequently. Before processing
@@ -372,6 +481,26 @@ struct iproto_msg
 	struct stailq_entry in_stream;
 	/** Stream that owns this message, or NULL. */
 	struct iproto_stream *stream;
+	/** Time when the request was decoded by the iproto thread. */
+	double start_time;
+	/** Time when the tx thread started executing the request. */
+	double tx_start_time;
+	/**
+	 * Time when the tx thread finished executing the request,
+	 * 0 if the request wasn't executed by the tx thread.
+	 */
+	double tx_end_time;
+	/**
+	 * Context switch count of the tx fiber when execution
+	 * started, replaced with the number of yields when it ended.
+	 */
+	int tx_yields;
+	/** Time the execution waited for WAL, see fiber storage. */
+	double tx_wal_wait;
+	/** Time the execution waited for the limbo. */
+	double tx_limbo_wait;
+	/** Session that sent the request, set by the tx thread. */
+	uint64_t session_id;
 };
 
 static struct iproto_msg *
@@ -390,6 +519,7 @@ iproto_msg_decode(struct iproto_msg *msg, const char **pos, const char *reqend,
 enum rmean_net_name {
 	IPROTO_SENT,
 	IPROTO_RECEIVED,
+	IPROTO_WRITES,
 	IPROTO_CONNECTIONS,
 	IPROTO_REQUESTS,
 	IPROTO_STREAMS,
@@ -400,6 +530,7 @@ enum rmean_net_name {
 const char *rmean_net_strings[RMEAN_NET_LAST] = {
 	"SENT",
 	"RECEIVED",
+	"WRITES",
 	"CONNECTIONS",
 	"REQUESTS",
 	"STREAMS",
@@ -415,6 +546,58 @@ const char *rmean_tx_strings[RMEAN_TX_LAST] = {
 	"REQUESTS_IN_PROGRESS",
 };
 
+const char *iproto_stage_strs[iproto_stage_MAX] = {
+	"queue",
+	"execution",
+	"reply",
+	"total",
+};
+
+/** Number of latency counters in struct iproto_latency. */
+enum { IPROTO_LATENCY_COUNT = IPROTO_TYPE_STAT_MAX * iproto_stage_MAX };
+
+int
+iproto_latency_create(struct iproto_latency *latency)
+{
+	struct latency *l = &latency->stage[0][0];
+	for (int i = 0; i < IPROTO_LATENCY_COUNT; i++) {
+		if (latency_create(&l[i]) != 0) {
+			while (--i >= 0)
+				latency_destroy(&l[i]);
+			diag_set(OutOfMemory, sizeof(struct latency),
+				 "latency_create", "struct latency");
+			return -1;
+		}
+	}
+	return 0;
+}
+
+void
+iproto_latency_destroy(struct iproto_latency *latency)
+{
+	struct latency *l = &latency->stage[0][0];
+	for (int i = 0; i < IPROTO_LATENCY_COUNT; i++)
+		latency_destroy(&l[i]);
+}
+
+static void
+iproto_latency_merge(struct iproto_latency *dst,
+		     const struct iproto_latency *src)
+{
+	struct latency *d = &dst->stage[0][0];
+	const struct latency *s = &src->stage[0][0];
+	for (int i = 0; i < IPROTO_LATENCY_COUNT; i++)
+		latency_merge(&d[i], &s[i]);
+}
+
+static void
+iproto_latency_reset(struct iproto_latency *latency)
+{
+	struct latency *l = &latency->stage[0][0];
+	for (int i = 0; i < IPROTO_LATENCY_COUNT; i++)
+		latency_reset(&l[i]);
+}
+
 static void
 tx_process_destroy(struct cmsg *m);
 
@@ -554,6 +737,21 @@ struct iproto_connection
 	 * meaningless.
 	 */
 	size_t parse_size;
+	/**
+	 * Capacity of new input buffers of the connection. Starts at
+	 * iproto_readahead, doubles every time a read fills up the input
+	 * buffer and halves every idle period, so that bulk loaders get
+	 * big buffers while idle connections don't waste memory.
+	 */
+	size_t readahead;
+	/** Set when input is read, cleared by the idle timer. */
+	bool has_input;
+	/** Link in iproto_thread::connections. */
+	struct rlist in_connections;
+	/** Pre-allocated message to release idle output buffers. */
+	struct iproto_trim_msg trim_msg;
+	/** Set while trim_msg is travelling to tx and back. */
+	bool is_trim_sent;
 	/**
 	 * Nubmer of active long polling requests that have already
 	 * discarded their arguments in order not to stall other
@@ -594,11 +792,42 @@ struct iproto_connection
 	 * should not write to the socket.
 	 */
 	bool can_write;
+	/** Output compression, see iproto_compress.h. */
+	struct {
+		/**
+		 * Set when an IPROTO_ID request enabling compression
+		 * has been processed, but the output preceding its
+		 * end hasn't been flushed yet.
+		 */
+		bool is_pending;
+		/** Set if the output is sent in chunks. */
+		bool is_enabled;
+		/**
+		 * If is_pending is set, the position of the end
+		 * of the reply to the IPROTO_ID request: the output
+		 * following it must be compressed.
+		 */
+		struct iproto_wpos start;
+		/**
+		 * Chunk that is being written to the socket. The output
+		 * is compressed only after the previous chunk has been
+		 * written out.
+		 */
+		struct ibuf buf;
+		struct iproto_compressor compressor;
+	} compression;
 	/**
 	 * Hash table that holds all streams for this connection.
 	 * This field is accesable only from iproto thread.
 	 */
 	struct mh_i64ptr_t *streams;
+	/**
+	 * Hash table that maps ids of the cursors opened in this
+	 * connection to their iterators. Although the table is
+	 * created and deleted in iproto thread, it's accessed only
+	 * from tx thread.
+	 */
+	struct mh_i64ptr_t *cursors;
 	/**
 	 * Kharon is used to implement box.session.push().
 	 * When a new push is ready, tx uses kharon to notify
@@ -645,6 +874,17 @@ struct iproto_connection
 		 * return.
 		 */
 		bool is_push_pending;
+		/**
+		 * The last flushed output position received from
+		 * iproto thread.
+		 */
+		struct iproto_wpos sent;
+		/** Signalled when Kharon returns to tx. */
+		struct fiber_cond push_cond;
+		/** True if on_disconnect has been processed. */
+		bool is_disconnected;
+		/** Id of the next cursor opened in this connection. */
+		uint64_t next_cursor_id;
 	} tx;
 	/** Authentication salt. */
 	char salt[IPROTO_SALT_SIZE];
@@ -750,8 +990,12 @@ iproto_msg_new(struct iproto_connection *con)
 		return NULL;
 	}
 	msg->close_connection = false;
+	msg->enable_compression = false;
 	msg->connection = con;
 	msg->stream = NULL;
+	msg->is_stream_released = false;
+	msg->start_time = clock_monotonic();
+	msg->tx_end_time = 0;
 	rmean_collect(con->iproto_thread->rmean, IPROTO_REQUESTS, 1);
 	return msg;
 }
@@ -804,6 +1048,7 @@ iproto_connection_is_idle(struct iproto_connection *con)
 	 * errors in the future.
 	 */
 	return con->long_poll_count == 0 &&
+	       !con->is_trim_sent &&
 	       mh_size(con->streams) == 0 &&
 	       ibuf_used(&con->ibuf[0]) == 0 &&
 	       ibuf_used(&con->ibuf[1]) == 0;
@@ -887,6 +1132,7 @@ iproto_connection_close(struct iproto_connection *con)
 		 * we mistakenly try to use it after this point.
 		 */
 		con->input.fd = con->output.fd = -1;
+		rlist_del(&con->in_connections);
 		iostream_close(&con->io);
 		/*
 		 * Discard unparsed data, to recycle the
@@ -972,8 +1218,12 @@ iproto_connection_input_buffer(struct iproto_connection *con)
 		 * buffer as read position is shifted to the
 		 * end of the buffer.
 		 */
-		if (ibuf_used(old_ibuf) == 0)
+		if (ibuf_used(old_ibuf) == 0) {
 			ibuf_reset(old_ibuf);
+			/* Let a hot connection read more at once. */
+			if (ibuf_capacity(old_ibuf) < con->readahead)
+				ibuf_reserve_xc(old_ibuf, con->readahead);
+		}
 		return old_ibuf;
 	}
 
@@ -995,9 +1245,10 @@ iproto_connection_input_buffer(struct iproto_connection *con)
 		return NULL;
 	}
 	/* Update buffer size if readahead has changed. */
-	if (new_ibuf->start_capacity != iproto_readahead) {
+	if (new_ibuf->start_capacity != con->readahead) {
 		ibuf_destroy(new_ibuf);
-		ibuf_create(new_ibuf, cord_slab_cache(), iproto_readahead);
+		ibuf_create(new_ibuf, &con->iproto_thread->ibuf_slabc,
+			    con->readahead);
 	}
 
 	ibuf_reserve_xc(new_ibuf, to_read + con->parse_size);
@@ -1266,7 +1517,8 @@ iproto_connection_on_input(ev_loop *loop, struct ev_io *watcher,
 			return;
 		}
 		/* Read input. */
-		ssize_t nrd = iostream_read(io, in->wpos, ibuf_unused(in));
+		size_t unused = ibuf_unused(in);
+		ssize_t nrd = iostream_read(io, in->wpos, unused);
 		if (nrd < 0) {                  /* Socket is not ready. */
 			if (nrd == IOSTREAM_ERROR)
 				diag_raise();
@@ -1285,6 +1537,16 @@ iproto_connection_on_input(ev_loop *loop, struct ev_io *watcher,
 		/* Count statistics */
 		rmean_collect(con->iproto_thread->rmean,
 			      IPROTO_RECEIVED, nrd);
+		con->has_input = true;
+		/*
+		 * The client sends more than fits in the buffer,
+		 * make the next one bigger.
+		 */
+		if ((size_t)nrd == unused) {
+			con->readahead = MIN(2 * con->readahead,
+					     (size_t)IPROTO_READAHEAD_MAX_FACTOR *
+					     iproto_readahead);
+		}
 
 		/* Update the read position and connection state. */
 		in->wpos += nrd;
@@ -1300,6 +1562,70 @@ iproto_connection_on_input(ev_loop *loop, struct ev_io *watcher,
 	}
 }
 
+/**
+ * Copy the iovecs of the output between @a begin and @a end to @a iov.
+ * Returns the number of iovecs.
+ */
+static int
+iproto_flush_iov(struct obuf *obuf, const struct obuf_svp *begin,
+		 const struct obuf_svp *end, struct iovec *iov)
+{
+	struct iovec *src = obuf->iov;
+	int iovcnt = end->pos - begin->pos + 1;
+	/*
+	 * iov[i].iov_len may be concurrently modified in tx thread,
+	 * but only for the last position.
+	 */
+	memcpy(iov, src + begin->pos, iovcnt * sizeof(struct iovec));
+	sio_add_to_iov(iov, -begin->iov_len);
+	/* *Overwrite* iov_len of the last pos as it may be garbage. */
+	iov[iovcnt-1].iov_len = end->iov_len - begin->iov_len * (iovcnt == 1);
+	return iovcnt;
+}
+
+/**
+ * Compress the output between @a begin and @a end into a chunk,
+ * unless the previous chunk hasn't been written out yet, and write
+ * the chunk to the socket.
+ */
+static int
+iproto_flush_compressed(struct iproto_connection *con, struct obuf *obuf,
+			struct obuf_svp *begin, struct obuf_svp *end)
+{
+	struct ibuf *buf = &con->compression.buf;
+	if (ibuf_used(buf) == 0) {
+		assert(begin->used < end->used);
+		struct iovec iov[SMALL_OBUF_IOV_MAX+1];
+		int iovcnt = iproto_flush_iov(obuf, begin, end, iov);
+		if (iproto_compress(&con->compression.compressor, iov, iovcnt,
+				    end->used - begin->used, buf) != 0) {
+			diag_log();
+			con->can_write = false;
+			ibuf_reset(buf);
+			*begin = *end;
+			return 0;
+		}
+		*begin = *end;
+	}
+	ssize_t nwr = iostream_write(&con->io, buf->rpos, ibuf_used(buf));
+	if (nwr >= 0) {
+		rmean_collect(con->iproto_thread->rmean, IPROTO_SENT, nwr);
+		rmean_collect(con->iproto_thread->rmean, IPROTO_WRITES, 1);
+		buf->rpos += nwr;
+		if (ibuf_used(buf) > 0)
+			return IOSTREAM_WANT_WRITE;
+		ibuf_reset(buf);
+		return 0;
+	} else if (nwr == IOSTREAM_ERROR) {
+		/* See the comment in iproto_flush(). */
+		diag_log();
+		con->can_write = false;
+		ibuf_reset(buf);
+		return 0;
+	}
+	return nwr;
+}
+
 /** writev() to the socket and handle the result. */
 static int
 iproto_flush(struct iproto_connection *con)
@@ -1320,32 +1646,42 @@ iproto_flush(struct iproto_connection *con)
 			end = &obuf_end;
 		}
 	}
-	if (begin->used == end->used) {
+	if (con->compression.is_pending &&
+	    con->compression.start.obuf == obuf) {
+		/*
+		 * The output preceding the end of the IPROTO_ID
+		 * reply is sent as is.
+		 */
+		struct obuf_svp *start = &con->compression.start.svp;
+		if (begin->used == start->used) {
+			con->compression.is_pending = false;
+			con->compression.is_enabled = true;
+		} else if (end->used > start->used) {
+			end = start;
+		}
+	}
+	if (begin->used == end->used &&
+	    ibuf_used(&con->compression.buf) == 0) {
 		/* Nothing to do. */
 		return 1;
 	}
 	if (!con->can_write) {
 		/* Receiving end was closed. Discard the output. */
+		ibuf_reset(&con->compression.buf);
 		*begin = *end;
 		return 0;
 	}
+	if (con->compression.is_enabled)
+		return iproto_flush_compressed(con, obuf, begin, end);
 	assert(begin->used < end->used);
 	struct iovec iov[SMALL_OBUF_IOV_MAX+1];
-	struct iovec *src = obuf->iov;
-	int iovcnt = end->pos - begin->pos + 1;
-	/*
-	 * iov[i].iov_len may be concurrently modified in tx thread,
-	 * but only for the last position.
-	 */
-	memcpy(iov, src + begin->pos, iovcnt * sizeof(struct iovec));
-	sio_add_to_iov(iov, -begin->iov_len);
-	/* *Overwrite* iov_len of the last pos as it may be garbage. */
-	iov[iovcnt-1].iov_len = end->iov_len - begin->iov_len * (iovcnt == 1);
+	int iovcnt = iproto_flush_iov(obuf, begin, end, iov);
 
 	ssize_t nwr = iostream_writev(&con->io, iov, iovcnt);
 	if (nwr >= 0) {
 		/* Count statistics */
 		rmean_collect(con->iproto_thread->rmean, IPROTO_SENT, nwr);
+		rmean_collect(con->iproto_thread->rmean, IPROTO_WRITES, 1);
 		if (begin->used + nwr == end->used) {
 			*begin = *end;
 			return 0;
@@ -1406,14 +1742,17 @@ iproto_connection_new(struct iproto_thread *iproto_thread)
 		return NULL;
 	}
 	con->streams = mh_i64ptr_new();
+	con->cursors = mh_i64ptr_new();
 	con->iproto_thread = iproto_thread;
 	con->input.data = con->output.data = con;
 	con->loop = loop();
 	iostream_clear(&con->io);
 	ev_io_init(&con->input, iproto_connection_on_input, -1, EV_NONE);
 	ev_io_init(&con->output, iproto_connection_on_output, -1, EV_NONE);
-	ibuf_create(&con->ibuf[0], cord_slab_cache(), iproto_readahead);
-	ibuf_create(&con->ibuf[1], cord_slab_cache(), iproto_readahead);
+	ibuf_create(&con->ibuf[0], &iproto_thread->ibuf_slabc,
+		    iproto_readahead);
+	ibuf_create(&con->ibuf[1], &iproto_thread->ibuf_slabc,
+		    iproto_readahead);
 	obuf_create(&con->obuf[0], &con->iproto_thread->net_slabc,
 		    iproto_readahead);
 	obuf_create(&con->obuf[1], &con->iproto_thread->net_slabc,
@@ -1423,7 +1762,17 @@ iproto_connection_new(struct iproto_thread *iproto_thread)
 	iproto_wpos_create(&con->wpos, con->tx.p_obuf);
 	iproto_wpos_create(&con->wend, con->tx.p_obuf);
 	con->parse_size = 0;
+	con->readahead = iproto_readahead;
+	con->has_input = false;
+	rlist_create(&con->in_connections);
+	cmsg_init(&con->trim_msg.base, iproto_thread->trim_route);
+	con->is_trim_sent = false;
 	con->can_write = true;
+	con->compression.is_pending = false;
+	con->compression.is_enabled = false;
+	ibuf_create(&con->compression.buf, cord_slab_cache(),
+		    iproto_readahead);
+	iproto_compressor_create(&con->compression.compressor);
 	con->long_poll_count = 0;
 	con->session = NULL;
 	rlist_create(&con->in_stop_list);
@@ -1433,6 +1782,10 @@ iproto_connection_new(struct iproto_thread *iproto_thread)
 	con->state = IPROTO_CONNECTION_ALIVE;
 	con->tx.is_push_pending = false;
 	con->tx.is_push_sent = false;
+	iproto_wpos_create(&con->tx.sent, con->tx.p_obuf);
+	fiber_cond_create(&con->tx.push_cond);
+	con->tx.is_disconnected = false;
+	con->tx.next_cursor_id = 1;
 	rmean_collect(iproto_thread->rmean, IPROTO_CONNECTIONS, 1);
 	return con;
 }
@@ -1449,8 +1802,11 @@ iproto_connection_delete(struct iproto_connection *con)
 	 * The output buffers must have been deleted
 	 * in tx thread.
 	 */
+	rlist_del(&con->in_connections);
 	ibuf_destroy(&con->ibuf[0]);
 	ibuf_destroy(&con->ibuf[1]);
+	ibuf_destroy(&con->compression.buf);
+	iproto_compressor_destroy(&con->compression.compressor);
 	assert(con->obuf[0].pos == 0 &&
 	       con->obuf[0].iov[0].iov_base == NULL);
 	assert(con->obuf[1].pos == 0 &&
@@ -1458,6 +1814,8 @@ iproto_connection_delete(struct iproto_connection *con)
 
 	assert(mh_size(con->streams) == 0);
 	mh_i64ptr_delete(con->streams);
+	assert(mh_size(con->cursors) == 0);
+	mh_i64ptr_delete(con->cursors);
 	mempool_free(&con->iproto_thread->iproto_connection_pool, con);
 }
 
@@ -1477,6 +1835,12 @@ tx_process1(struct cmsg *msg);
 static void
 tx_process_select(struct cmsg *msg);
 
+static void
+tx_process_batch(struct cmsg *msg);
+
+static void
+tx_process_cursor(struct cmsg *msg);
+
 static void
 tx_process_sql(struct cmsg *msg);
 
@@ -1492,6 +1856,9 @@ net_send_msg(struct cmsg *msg);
 static void
 net_send_error(struct cmsg *msg);
 
+static void
+net_release_stream(struct cmsg *msg);
+
 static void
 tx_process_replication(struct cmsg *msg);
 
@@ -1519,7 +1886,8 @@ iproto_msg_decode(struct iproto_msg *msg, const char **pos, const char *reqend,
 	stream_id = msg->header.stream_id;
 	request_is_not_for_stream =
 		((type > IPROTO_TYPE_STAT_MAX &&
-		 type != IPROTO_PING) || type == IPROTO_AUTH);
+		 type != IPROTO_PING && type != IPROTO_BATCH) ||
+		 type == IPROTO_AUTH);
 	request_is_only_for_stream =
 		(type == IPROTO_BEGIN ||
 		 type == IPROTO_COMMIT ||
@@ -1534,6 +1902,13 @@ iproto_msg_decode(struct iproto_msg *msg, const char **pos, const char *reqend,
 			 iproto_type_name(type));
 		goto error;
 	}
+	if ((msg->header.flags & IPROTO_FLAG_ASYNC_COMMIT) != 0 &&
+	    (stream_id == 0 || type == IPROTO_SELECT ||
+	     !iproto_type_is_dml(type))) {
+		diag_set(ClientError, ER_ILLEGAL_PARAMS, "async commit is "
+			 "supported only for DML requests in a stream");
+		goto error;
+	}
 
 	/*
 	 * Parse request before putting it into the queue
@@ -1560,6 +1935,23 @@ iproto_msg_decode(struct iproto_msg *msg, const char **pos, const char *reqend,
 		              sizeof(*(iproto_thread->dml_route)));
 		cmsg_init(&msg->base, iproto_thread->dml_route[type]);
 		break;
+	case IPROTO_BATCH:
+		if (xrow_decode_batch(&msg->header, &msg->batch) != 0)
+			goto error;
+		cmsg_init(&msg->base, iproto_thread->batch_route);
+		break;
+	case IPROTO_CURSOR_OPEN:
+		if (xrow_decode_dml(&msg->header, &msg->dml,
+				    dml_request_key_map(IPROTO_SELECT)) != 0)
+			goto error;
+		cmsg_init(&msg->base, iproto_thread->cursor_route);
+		break;
+	case IPROTO_CURSOR_FETCH:
+	case IPROTO_CURSOR_CLOSE:
+		if (xrow_decode_cursor(&msg->header, &msg->cursor) != 0)
+			goto error;
+		cmsg_init(&msg->base, iproto_thread->cursor_route);
+		break;
 	case IPROTO_BEGIN:
 		if (xrow_decode_begin(&msg->header, &msg->begin) != 0)
 			goto error;
@@ -1646,6 +2038,8 @@ tx_fiber_init(struct session *session, uint64_t sync)
 	 */
 	assert(rlist_empty(&f->on_stop));
 	f->storage.net.sync = sync;
+	f->storage.net.wal_wait = 0;
+	f->storage.net.limbo_wait = 0;
 	/*
 	 * We do not cleanup fiber keys at the end of each request.
 	 * This does not lead to privilege escalation as long as
@@ -1697,6 +2091,8 @@ tx_process_disconnect(struct cmsg *m)
 {
 	struct iproto_connection *con =
 		container_of(m, struct iproto_connection, disconnect_msg);
+	con->tx.is_disconnected = true;
+	fiber_cond_broadcast(&con->tx.push_cond);
 	if (con->session != NULL) {
 		session_close(con->session);
 		/*
@@ -1741,6 +2137,12 @@ tx_process_destroy(struct cmsg *m)
 	 */
 	obuf_destroy(&con->obuf[0]);
 	obuf_destroy(&con->obuf[1]);
+	/* Iterators must be freed in tx thread, too. */
+	mh_int_t node;
+	mh_foreach(con->cursors, node)
+		iterator_delete((struct iterator *)
+				mh_i64ptr_node(con->cursors, node)->val);
+	mh_i64ptr_clear(con->cursors);
 }
 
 /**
@@ -1811,6 +2213,7 @@ static void
 tx_accept_wpos(struct iproto_connection *con, const struct iproto_wpos *wpos)
 {
 	struct obuf *prev = &con->obuf[con->tx.p_obuf == con->obuf];
+	con->tx.sent = *wpos;
 	if (wpos->obuf == con->tx.p_obuf) {
 		/*
 		 * We got a message advancing the buffer which
@@ -1853,8 +2256,11 @@ static inline struct iproto_msg *
 tx_accept_msg(struct cmsg *m)
 {
 	struct iproto_msg *msg = (struct iproto_msg *) m;
+	msg->tx_start_time = clock_monotonic();
 	tx_accept_wpos(msg->connection, &msg->wpos);
 	tx_fiber_init(msg->connection->session, msg->header.sync);
+	msg->tx_yields = fiber()->csw;
+	PROBE2(iproto_request_start, msg->header.type, msg->header.sync);
 	tx_prepare_transaction_for_request(msg);
 	msg->connection->iproto_thread->tx.requests_in_progress++;
 	rmean_collect(msg->connection->iproto_thread->tx.rmean,
@@ -1865,11 +2271,18 @@ tx_accept_msg(struct cmsg *m)
 static inline void
 tx_end_msg(struct iproto_msg *msg)
 {
-	if (msg->stream != NULL) {
+	if (msg->stream != NULL && !msg->is_stream_released) {
 		assert(msg->stream->txn == NULL);
 		msg->stream->txn = txn_detach();
 	}
+	struct fiber *f = fiber();
+	msg->tx_end_time = clock_monotonic();
+	msg->tx_yields = f->csw - msg->tx_yields;
+	msg->tx_wal_wait = f->storage.net.wal_wait;
+	msg->tx_limbo_wait = f->storage.net.limbo_wait;
+	msg->session_id = msg->connection->session->id;
 	msg->connection->iproto_thread->tx.requests_in_progress--;
+	PROBE2(iproto_request_done, msg->header.type, msg->header.sync);
 }
 
 /**
@@ -1922,8 +2335,10 @@ tx_process_begin(struct cmsg *m)
 	if (box_txn_begin() != 0)
 		goto error;
 
-	if (msg->begin.timeout != 0 &&
-	    box_txn_set_timeout(msg->begin.timeout) != 0) {
+	if ((msg->begin.timeout != 0 &&
+	     box_txn_set_timeout(msg->begin.timeout) != 0) ||
+	    (msg->begin.isolation != 0 &&
+	     box_txn_set_isolation(msg->begin.isolation) != 0)) {
 		int rc = box_txn_rollback();
 		assert(rc == 0);
 		(void)rc;
@@ -1983,6 +2398,125 @@ error:
 	tx_end_msg(msg);
 }
 
+/**
+ * Transaction of a request with IPROTO_FLAG_ASYNC_COMMIT waited
+ * for after the request released its stream.
+ */
+struct tx_async_commit {
+	/** Set on the transaction, both run tx_async_commit_complete(). */
+	struct trigger on_commit;
+	struct trigger on_rollback;
+	/** Fiber executing the request. */
+	struct fiber *fiber;
+	/** Signature of the transaction, valid if is_complete is set. */
+	int64_t signature;
+	/** Set when the transaction is committed or rolled back. */
+	bool is_complete;
+};
+
+static int
+tx_async_commit_complete(struct trigger *trigger, void *event)
+{
+	struct tx_async_commit *commit =
+		(struct tx_async_commit *)trigger->data;
+	struct txn *txn = (struct txn *)event;
+	commit->signature = txn->signature;
+	commit->is_complete = true;
+	fiber_wakeup(commit->fiber);
+	return 0;
+}
+
+/**
+ * Commit the transaction of a request with IPROTO_FLAG_ASYNC_COMMIT.
+ * As soon as the transaction is submitted to WAL, iproto is told to
+ * pass the next request of the stream to tx, and then the fiber waits
+ * for the WAL write. The order of the requests is kept by the WAL
+ * queue, and a failed write rolls back all the transactions submitted
+ * after it.
+ */
+static int
+tx_commit_and_release_stream(struct iproto_msg *msg, struct txn *txn)
+{
+	struct txn_stmt *stmt;
+	stailq_foreach_entry(stmt, &txn->stmts, next) {
+		/*
+		 * A synchronous transaction gets its LSN assigned in
+		 * the limbo by txn_commit() only.
+		 */
+		if (stmt->space != NULL && stmt->space->def->opts.is_sync)
+			return txn_commit(txn);
+	}
+	struct tx_async_commit commit;
+	commit.fiber = fiber();
+	commit.is_complete = false;
+	trigger_create(&commit.on_commit, tx_async_commit_complete,
+		       &commit, NULL);
+	trigger_create(&commit.on_rollback, tx_async_commit_complete,
+		       &commit, NULL);
+	txn_on_commit(txn, &commit.on_commit);
+	txn_on_rollback(txn, &commit.on_rollback);
+	if (txn_commit_try_async(txn) != 0)
+		return -1;
+	if (!commit.is_complete) {
+		static const struct cmsg_hop release_stream_route[] = {
+			{ net_release_stream, NULL },
+		};
+		struct iproto_thread *iproto_thread =
+			msg->connection->iproto_thread;
+		msg->is_stream_released = true;
+		cmsg_init(&msg->release_stream, release_stream_route);
+		cpipe_push(&iproto_thread->net_pipe, &msg->release_stream);
+		double start = clock_monotonic();
+		while (!commit.is_complete)
+			fiber_yield();
+		fiber()->storage.net.wal_wait += clock_monotonic() - start;
+	}
+	if (commit.signature < 0) {
+		diag_set_txn_sign(commit.signature);
+		return -1;
+	}
+	return 0;
+}
+
+/**
+ * Execute a request with IPROTO_FLAG_ASYNC_COMMIT. It's the same as
+ * box_process1(), but the stream of the request is released before
+ * the WAL write, see tx_commit_and_release_stream().
+ */
+static int
+tx_process1_async_commit(struct iproto_msg *msg, struct tuple **result)
+{
+	if (in_txn() != NULL) {
+		diag_set(ClientError, ER_ACTIVE_TRANSACTION);
+		return -1;
+	}
+	struct txn *txn = txn_begin();
+	if (txn == NULL)
+		return -1;
+	struct tuple *tuple;
+	if (box_process1(&msg->dml, &tuple) != 0) {
+		txn_abort(txn);
+		fiber_gc();
+		return -1;
+	}
+	/* The tuple may go away while the fiber waits for WAL. */
+	if (tuple != NULL)
+		tuple_ref(tuple);
+	if (tx_commit_and_release_stream(msg, txn) != 0) {
+		fiber_gc();
+		if (tuple != NULL)
+			tuple_unref(tuple);
+		return -1;
+	}
+	fiber_gc();
+	if (tuple != NULL) {
+		tuple_bless(tuple);
+		tuple_unref(tuple);
+	}
+	*result = tuple;
+	return 0;
+}
+
 static void
 tx_process1(struct cmsg *m)
 {
@@ -1994,8 +2528,12 @@ tx_process1(struct cmsg *m)
 	struct obuf_svp svp;
 	struct obuf *out;
 	tx_inject_delay();
-	if (box_process1(&msg->dml, &tuple) != 0)
+	if ((msg->header.flags & IPROTO_FLAG_ASYNC_COMMIT) != 0) {
+		if (tx_process1_async_commit(msg, &tuple) != 0)
+			goto error;
+	} else if (box_process1(&msg->dml, &tuple) != 0) {
 		goto error;
+	}
 	out = msg->connection->tx.p_obuf;
 	if (iproto_prepare_select(out, &svp) != 0)
 		goto error;
@@ -2011,6 +2549,117 @@ error:
 	tx_end_msg(msg);
 }
 
+static void
+tx_push(struct iproto_connection *con);
+
+/**
+ * Size of the connection output that hasn't been sent yet, as far
+ * as tx knows.
+ */
+static inline size_t
+tx_output_unsent(struct iproto_connection *con)
+{
+	struct obuf *out = con->tx.p_obuf;
+	const struct iproto_wpos *sent = &con->tx.sent;
+	if (sent->obuf == out)
+		return obuf_size(out) - sent->svp.used;
+	return obuf_size(sent->obuf) - sent->svp.used + obuf_size(out);
+}
+
+/**
+ * Wait until the connection output that iproto hasn't sent yet
+ * gets smaller than IPROTO_RESPONSE_OUTPUT_MAX. The flushed output
+ * position is only known in tx when Kharon brings it back, so send
+ * Kharon for it until the output shrinks.
+ */
+static int
+tx_wait_output(struct iproto_connection *con)
+{
+	while (tx_output_unsent(con) > IPROTO_RESPONSE_OUTPUT_MAX) {
+		if (con->tx.is_disconnected) {
+			diag_set(ClientError, ER_SESSION_CLOSED);
+			return -1;
+		}
+		size_t size = tx_output_unsent(con);
+		tx_push(con);
+		if (fiber_cond_wait(&con->tx.push_cond) != 0)
+			return -1;
+		/* Don't spin while the socket isn't writable. */
+		if (tx_output_unsent(con) >= size) {
+			fiber_sleep(IPROTO_OUTPUT_CHECK_PERIOD);
+			if (fiber_is_cancelled()) {
+				diag_set(FiberIsCancelled);
+				return -1;
+			}
+		}
+	}
+	return 0;
+}
+
+/**
+ * Write the tuples of a SELECT result starting from @a *pe to the
+ * output buffer until about IPROTO_RESPONSE_CHUNK_SIZE bytes are
+ * written. On success, returns the number of tuples written and
+ * sets @a *pe to the first tuple left. On error, returns -1.
+ */
+static int
+tx_dump_select_chunk(struct port_c_entry **pe, struct obuf *out)
+{
+	size_t start = obuf_size(out);
+	int count = 0;
+	for (; *pe != NULL && obuf_size(out) - start <
+			       IPROTO_RESPONSE_CHUNK_SIZE; *pe = (*pe)->next) {
+		uint32_t size = (*pe)->mp_size;
+		if (size == 0) {
+			if (tuple_to_obuf((*pe)->tuple, out) != 0)
+				return -1;
+		} else if (obuf_dup(out, (*pe)->mp, size) != size) {
+			diag_set(OutOfMemory, size, "obuf_dup", "data");
+			return -1;
+		}
+		count++;
+	}
+	return count;
+}
+
+/**
+ * Reply to a SELECT of a client that supports chunked responses.
+ * The tuples are sent in IPROTO_CHUNK packets of about
+ * IPROTO_RESPONSE_CHUNK_SIZE, followed by the usual reply with the
+ * rest of them. If the client doesn't keep up, wait for the output
+ * to be flushed so that a huge result doesn't have to fit in the
+ * output buffers at once.
+ */
+static int
+tx_reply_select_chunked(struct iproto_msg *msg, struct port *port)
+{
+	struct iproto_connection *con = msg->connection;
+	struct port_c_entry *pe = ((struct port_c *)port)->first;
+	while (true) {
+		/* The buffer may be rotated while we wait. */
+		struct obuf *out = con->tx.p_obuf;
+		struct obuf_svp svp;
+		if (iproto_prepare_select(out, &svp) != 0)
+			return -1;
+		int count = tx_dump_select_chunk(&pe, out);
+		if (count < 0) {
+			obuf_rollback_to_svp(out, &svp);
+			return -1;
+		}
+		if (pe == NULL) {
+			iproto_reply_select(out, &svp, msg->header.sync,
+					    ::schema_version, count);
+			iproto_wpos_create(&msg->wpos, out);
+			return 0;
+		}
+		iproto_reply_chunk(out, &svp, msg->header.sync,
+				   ::schema_version, count);
+		tx_push(con);
+		if (tx_wait_output(con) != 0)
+			return -1;
+	}
+}
+
 static void
 tx_process_select(struct cmsg *m)
 {
@@ -2031,6 +2680,15 @@ tx_process_select(struct cmsg *m)
 	if (rc < 0)
 		goto error;
 
+	if (iproto_features_test(&msg->connection->session->meta.features,
+				 IPROTO_FEATURE_CHUNKED_RESPONSES)) {
+		rc = tx_reply_select_chunked(msg, &port);
+		port_destroy(&port);
+		if (rc != 0)
+			goto error;
+		tx_end_msg(msg);
+		return;
+	}
 	out = msg->connection->tx.p_obuf;
 	if (iproto_prepare_select(out, &svp) != 0) {
 		port_destroy(&port);
@@ -2056,24 +2714,443 @@ error:
 	tx_end_msg(msg);
 }
 
+/**
+ * Execute sub-requests of a BATCH request. The result of each
+ * sub-request is stored in the port with the same index. On return
+ * @a port_count is set to the number of ports that were created and
+ * must be destroyed by the caller.
+ */
 static int
-tx_process_call_on_yield(struct trigger *trigger, void *event)
+tx_process_batch_requests(const struct batch_request *batch,
+			  struct port *ports, uint32_t *port_count)
 {
-	(void)event;
-	struct iproto_msg *msg = (struct iproto_msg *)trigger->data;
-	TRASH(&msg->call);
-	tx_discard_input(msg);
-	trigger_clear(trigger);
+	const char *data = batch->requests;
+	*port_count = 0;
+	for (uint32_t i = 0; i < batch->count; i++) {
+		struct request req;
+		if (xrow_decode_batch_item(&data, &req) != 0)
+			return -1;
+		struct port *port = &ports[i];
+		if (req.type == IPROTO_SELECT) {
+			if (box_select(req.space_id, req.index_id,
+				       req.iterator, req.offset, req.limit,
+				       req.key, req.key_end, port) != 0)
+				return -1;
+		} else {
+			struct tuple *tuple;
+			if (box_process1(&req, &tuple) != 0)
+				return -1;
+			port_c_create(port);
+			if (tuple != NULL &&
+			    port_c_add_tuple(port, tuple) != 0) {
+				port_destroy(port);
+				return -1;
+			}
+		}
+		*port_count = i + 1;
+	}
+	assert(data == batch->requests_end);
 	return 0;
 }
 
-static void
+/**
+ * Write the results of BATCH sub-requests to the output buffer,
+ * each as an array of tuples.
+ */
+static int
+tx_dump_batch_results(struct port *ports, uint32_t port_count,
+		      struct obuf *out)
+{
+	for (uint32_t i = 0; i < port_count; i++) {
+		struct port_c *port = (struct port_c *)&ports[i];
+		size_t size = mp_sizeof_array(port->size);
+		char *pos = (char *)obuf_alloc(out, size);
+		if (pos == NULL) {
+			diag_set(OutOfMemory, size, "obuf_alloc", "pos");
+			return -1;
+		}
+		mp_encode_array(pos, port->size);
+		if (port_dump_msgpack_16(&ports[i], out) < 0)
+			return -1;
+	}
+	return 0;
+}
+
+static void
+tx_process_batch(struct cmsg *m)
+{
+	struct iproto_msg *msg = tx_accept_msg(m);
+	struct batch_request *batch = &msg->batch;
+	struct region *region = &fiber()->gc;
+	size_t region_svp = region_used(region);
+	struct port *ports = NULL;
+	uint32_t port_count = 0;
+	bool is_autocommit = false;
+	box_txn_savepoint_t *txn_svp = NULL;
+	struct obuf *out;
+	struct obuf_svp svp;
+	size_t size;
+
+	if (tx_check_schema(msg->header.schema_version))
+		goto error;
+
+	tx_inject_delay();
+	if (batch->count > 0) {
+		ports = region_alloc_array(region, typeof(ports[0]),
+					   batch->count, &size);
+		if (ports == NULL) {
+			diag_set(OutOfMemory, size, "region_alloc_array",
+				 "ports");
+			goto error;
+		}
+	}
+	/*
+	 * Execute all the sub-requests in one transaction so that
+	 * they are written to WAL at once. If the batch was sent in
+	 * a stream with an active transaction, use it instead, but
+	 * still apply the batch atomically: on failure roll back only
+	 * the sub-requests of the batch, leaving the transaction open.
+	 */
+	if (in_txn() == NULL) {
+		if (box_txn_begin() != 0)
+			goto error;
+		is_autocommit = true;
+	} else {
+		txn_svp = box_txn_savepoint();
+		if (txn_svp == NULL)
+			goto error;
+	}
+	if (tx_process_batch_requests(batch, ports, &port_count) != 0) {
+		if (is_autocommit)
+			box_txn_rollback();
+		else
+			box_txn_rollback_to_savepoint(txn_svp);
+		goto error;
+	}
+	if (is_autocommit && box_txn_commit() != 0)
+		goto error;
+	/*
+	 * Like in case of CALL, a save point for output buffer must
+	 * be taken only after the requests are executed, because
+	 * they may yield.
+	 */
+	out = msg->connection->tx.p_obuf;
+	if (iproto_prepare_select(out, &svp) != 0)
+		goto error;
+	if (tx_dump_batch_results(ports, port_count, out) != 0) {
+		obuf_rollback_to_svp(out, &svp);
+		goto error;
+	}
+	iproto_reply_select(out, &svp, msg->header.sync, ::schema_version,
+			    port_count);
+	iproto_wpos_create(&msg->wpos, out);
+	goto end;
+error:
+	tx_reply_error(msg);
+end:
+	for (uint32_t i = 0; i < port_count; i++)
+		port_destroy(&ports[i]);
+	region_truncate(region, region_svp);
+	tx_end_msg(msg);
+}
+
+/**
+ * Fetch at most @a limit tuples from the cursor iterator and reply
+ * with them. The reply has the cursor id set to @a cursor_id or to
+ * 0 if the iterator is exhausted, in which case *is_done is set.
+ * The first @a offset tuples are skipped.
+ */
+static int
+tx_reply_cursor(struct iproto_msg *msg, uint64_t cursor_id,
+		struct iterator *it, uint32_t offset, uint32_t limit,
+		bool *is_done)
+{
+	struct obuf *out;
+	struct obuf_svp svp;
+	struct port port;
+	port_c_create(&port);
+	uint32_t count = 0;
+	*is_done = false;
+	while (count < limit) {
+		struct tuple *tuple;
+		if (iterator_next(it, &tuple) != 0)
+			goto error;
+		if (tuple == NULL) {
+			*is_done = true;
+			cursor_id = 0;
+			break;
+		}
+		if (offset > 0) {
+			offset--;
+			continue;
+		}
+		if (port_c_add_tuple(&port, tuple) != 0)
+			goto error;
+		count++;
+	}
+	/*
+	 * A vinyl iterator may yield, so a save point for output
+	 * buffer must be taken only after the tuples are fetched.
+	 */
+	out = msg->connection->tx.p_obuf;
+	if (iproto_prepare_cursor(out, &svp) != 0)
+		goto error;
+	if (port_dump_msgpack_16(&port, out) < 0) {
+		obuf_rollback_to_svp(out, &svp);
+		goto error;
+	}
+	iproto_reply_cursor(out, &svp, msg->header.sync, ::schema_version,
+			    cursor_id, count);
+	iproto_wpos_create(&msg->wpos, out);
+	port_destroy(&port);
+	return 0;
+error:
+	port_destroy(&port);
+	return -1;
+}
+
+/** Open a cursor and reply with its first tuples. */
+static int
+tx_process_cursor_open(struct iproto_msg *msg)
+{
+	struct iproto_connection *con = msg->connection;
+	struct request *req = &msg->dml;
+	if (mh_size(con->cursors) >= IPROTO_CURSOR_MAX) {
+		diag_set(ClientError, ER_ILLEGAL_PARAMS,
+			 "too many open cursors");
+		return -1;
+	}
+	struct iterator *it = box_index_iterator(req->space_id, req->index_id,
+						 req->iterator, req->key,
+						 req->key_end);
+	if (it == NULL)
+		return -1;
+	uint64_t cursor_id = con->tx.next_cursor_id++;
+	bool is_done;
+	if (tx_reply_cursor(msg, cursor_id, it, req->offset, req->limit,
+			    &is_done) != 0) {
+		iterator_delete(it);
+		return -1;
+	}
+	if (is_done) {
+		iterator_delete(it);
+		return 0;
+	}
+	struct mh_i64ptr_node_t node = { cursor_id, it };
+	if (mh_i64ptr_put(con->cursors, &node, NULL, NULL) ==
+	    mh_end(con->cursors)) {
+		/* The reply is sent, the client will get NO_SUCH_CURSOR. */
+		iterator_delete(it);
+	}
+	return 0;
+}
+
+/**
+ * Fetch the next tuples from a cursor. The cursor is removed from
+ * the connection while its iterator is in use, because a vinyl
+ * iterator may yield and a pipelined request may try to use or
+ * close the cursor meanwhile.
+ */
+static int
+tx_process_cursor_fetch(struct iproto_msg *msg)
+{
+	struct iproto_connection *con = msg->connection;
+	uint64_t cursor_id = msg->cursor.cursor_id;
+	mh_int_t pos = mh_i64ptr_find(con->cursors, cursor_id, NULL);
+	if (pos == mh_end(con->cursors)) {
+		diag_set(ClientError, ER_NO_SUCH_CURSOR,
+			 (unsigned long long)cursor_id);
+		return -1;
+	}
+	struct iterator *it =
+		(struct iterator *)mh_i64ptr_node(con->cursors, pos)->val;
+	mh_i64ptr_del(con->cursors, pos, NULL);
+	bool is_done;
+	if (tx_reply_cursor(msg, cursor_id, it, 0, msg->cursor.limit,
+			    &is_done) != 0) {
+		iterator_delete(it);
+		return -1;
+	}
+	if (is_done) {
+		iterator_delete(it);
+		return 0;
+	}
+	struct mh_i64ptr_node_t node = { cursor_id, it };
+	if (mh_i64ptr_put(con->cursors, &node, NULL, NULL) ==
+	    mh_end(con->cursors))
+		iterator_delete(it);
+	return 0;
+}
+
+/** Close a cursor before it's exhausted. */
+static int
+tx_process_cursor_close(struct iproto_msg *msg)
+{
+	struct iproto_connection *con = msg->connection;
+	uint64_t cursor_id = msg->cursor.cursor_id;
+	mh_int_t pos = mh_i64ptr_find(con->cursors, cursor_id, NULL);
+	if (pos == mh_end(con->cursors)) {
+		diag_set(ClientError, ER_NO_SUCH_CURSOR,
+			 (unsigned long long)cursor_id);
+		return -1;
+	}
+	iterator_delete((struct iterator *)
+			mh_i64ptr_node(con->cursors, pos)->val);
+	mh_i64ptr_del(con->cursors, pos, NULL);
+	struct obuf *out = con->tx.p_obuf;
+	if (iproto_reply_ok(out, msg->header.sync, ::schema_version) != 0)
+		return -1;
+	iproto_wpos_create(&msg->wpos, out);
+	return 0;
+}
+
+static void
+tx_process_cursor(struct cmsg *m)
+{
+	struct iproto_msg *msg = tx_accept_msg(m);
+	int rc;
+	if (tx_check_schema(msg->header.schema_version))
+		goto error;
+
+	tx_inject_delay();
+	switch (msg->header.type) {
+	case IPROTO_CURSOR_OPEN:
+		rc = tx_process_cursor_open(msg);
+		break;
+	case IPROTO_CURSOR_FETCH:
+		rc = tx_process_cursor_fetch(msg);
+		break;
+	case IPROTO_CURSOR_CLOSE:
+		rc = tx_process_cursor_close(msg);
+		break;
+	default:
+		unreachable();
+	}
+	if (rc != 0)
+		goto error;
+	tx_end_msg(msg);
+	return;
+error:
+	tx_reply_error(msg);
+	tx_end_msg(msg);
+}
+
+static int
+tx_process_call_on_yield(struct trigger *trigger, void *event)
+{
+	(void)event;
+	struct iproto_msg *msg = (struct iproto_msg *)trigger->data;
+	TRASH(&msg->call);
+	tx_discard_input(msg);
+	trigger_clear(trigger);
+	return 0;
+}
+
+/**
+ * Return the function called by a CALL request if its results
+ * may be cached, NULL otherwise.
+ */
+static struct func *
+tx_call_cached_func(struct iproto_msg *msg)
+{
+	if (msg->header.type != IPROTO_CALL || in_txn() != NULL)
+		return NULL;
+	const char *name = msg->call.name;
+	uint32_t name_len = mp_decode_strl(&name);
+	struct func *func = func_by_name(name, name_len);
+	if (func == NULL || !func->def->opts.cache)
+		return NULL;
+	return func;
+}
+
+/**
+ * Reply to a CALL request with a cached result of the function.
+ * @retval 1 the reply is written.
+ * @retval 0 there's no cached result.
+ * @retval -1 error, diag is set.
+ */
+static int
+tx_reply_call_cached(struct iproto_msg *msg, struct func *func)
+{
+	uint32_t size;
+	int count;
+	const char *data = func_cache_get(func, msg->call.args,
+					  msg->call.args_end, &size, &count);
+	if (data == NULL)
+		return 0;
+	if (func_access_check(func) != 0)
+		return -1;
+	rmean_collect(rmean_box, IPROTO_CALL, 1);
+	struct obuf *out = msg->connection->tx.p_obuf;
+	struct obuf_svp svp;
+	if (iproto_prepare_select(out, &svp) != 0)
+		return -1;
+	if (obuf_dup(out, data, size) != size) {
+		obuf_rollback_to_svp(out, &svp);
+		diag_set(OutOfMemory, size, "obuf_dup", "data");
+		return -1;
+	}
+	iproto_reply_select(out, &svp, msg->header.sync,
+			    ::schema_version, count);
+	iproto_wpos_create(&msg->wpos, out);
+	return 1;
+}
+
+/**
+ * Store the result of a CALL request dumped to the output buffer
+ * starting from @a svp in the function result cache.
+ */
+static void
+tx_cache_call_result(struct iproto_msg *msg, struct func *func,
+		     struct obuf *out, const struct obuf_svp *svp, int count)
+{
+	struct region *region = &fiber()->gc;
+	size_t region_svp = region_used(region);
+	size_t size = obuf_size(out) - svp->used;
+	char *data = (char *)region_alloc(region, size);
+	if (data == NULL)
+		return;
+	char *pos = data;
+	size_t offset = svp->iov_len;
+	for (int i = svp->pos; i <= out->pos; i++) {
+		size_t len = out->iov[i].iov_len - offset;
+		memcpy(pos, (char *)out->iov[i].iov_base + offset, len);
+		pos += len;
+		offset = 0;
+	}
+	assert(pos == data + size);
+	func_cache_put(func, msg->call.args, msg->call.args_end,
+		       data, size, count);
+	region_truncate(region, region_svp);
+}
+
+static void
 tx_process_call(struct cmsg *m)
 {
 	struct iproto_msg *msg = tx_accept_msg(m);
+	struct func *cached_func;
+	uint64_t data_generation;
+	int csw;
 	if (tx_check_schema(msg->header.schema_version))
 		goto error;
 
+	/*
+	 * Results of functions with the cache option are valid
+	 * until any data changes, see func_cache.h.
+	 */
+	cached_func = tx_call_cached_func(msg);
+	data_generation = txn_data_generation;
+	csw = fiber()->csw;
+	if (cached_func != NULL) {
+		int rc = tx_reply_call_cached(msg, cached_func);
+		if (rc < 0)
+			goto error;
+		if (rc > 0) {
+			tx_end_msg(msg);
+			return;
+		}
+	}
+
 	/*
 	 * CALL/EVAL should copy its arguments so we can discard
 	 * input on yield to avoid stalling other connections by
@@ -2127,6 +3204,7 @@ tx_process_call(struct cmsg *m)
 	int count;
 	struct obuf *out;
 	struct obuf_svp svp;
+	struct obuf_svp data_svp;
 
 	out = msg->connection->tx.p_obuf;
 	if (iproto_prepare_select(out, &svp) != 0) {
@@ -2134,6 +3212,7 @@ tx_process_call(struct cmsg *m)
 		goto error;
 	}
 
+	data_svp = obuf_create_svp(out);
 	if (msg->header.type == IPROTO_CALL_16)
 		count = port_dump_msgpack_16(&port, out);
 	else
@@ -2143,6 +3222,15 @@ tx_process_call(struct cmsg *m)
 		obuf_rollback_to_svp(out, &svp);
 		goto error;
 	}
+	/*
+	 * The function pointer is valid only if nothing changed
+	 * during the call: dropping the function is a change too.
+	 * If the call yielded, the arguments are discarded with
+	 * the input buffer, see tx_process_call_on_yield().
+	 */
+	if (cached_func != NULL && data_generation == txn_data_generation &&
+	    csw == fiber()->csw)
+		tx_cache_call_result(msg, cached_func, out, &data_svp, count);
 
 	iproto_reply_select(out, &svp, msg->header.sync,
 			    ::schema_version, count);
@@ -2185,6 +3273,8 @@ tx_process_misc(struct cmsg *m)
 			con->session->meta.features = msg->id.features;
 			iproto_reply_id_xc(out, msg->header.sync,
 					   ::schema_version);
+			msg->enable_compression = iproto_features_test(
+				&msg->id.features, IPROTO_FEATURE_COMPRESSION);
 			break;
 		case IPROTO_VOTE_DEPRECATED:
 			iproto_reply_vclock_xc(out, &replicaset.vclock,
@@ -2416,13 +3506,128 @@ iproto_msg_finish_processing_in_stream(struct iproto_msg *msg)
 	}
 }
 
+/**
+ * Describe the key, tuple or function of a request for the slow
+ * request log. The request body is decoded again from the input
+ * buffer, because the tx thread may have changed the decoded one.
+ */
+static void
+iproto_msg_describe(struct iproto_msg *msg, struct iproto_slow_request *r)
+{
+	r->space_id = 0;
+	r->key[0] = '\0';
+	if (msg->len == 0) {
+		/* Already discarded by net_discard_input(). */
+		return;
+	}
+	const char *data = NULL;
+	uint32_t type = msg->header.type;
+	switch (type) {
+	case IPROTO_SELECT:
+	case IPROTO_INSERT:
+	case IPROTO_REPLACE:
+	case IPROTO_UPDATE:
+	case IPROTO_DELETE:
+	case IPROTO_UPSERT: {
+		struct request request;
+		if (xrow_decode_dml(&msg->header, &request,
+				    dml_request_key_map(type)) != 0) {
+			diag_clear(diag_get());
+			break;
+		}
+		r->space_id = request.space_id;
+		data = request.key != NULL ? request.key : request.tuple;
+		break;
+	}
+	case IPROTO_CALL_16:
+	case IPROTO_CALL:
+	case IPROTO_EVAL: {
+		struct call_request call;
+		if (xrow_decode_call(&msg->header, &call) != 0) {
+			diag_clear(diag_get());
+			break;
+		}
+		data = type == IPROTO_EVAL ? call.expr : call.name;
+		break;
+	}
+	default:
+		break;
+	}
+	if (data != NULL)
+		mp_snprint(r->key, sizeof(r->key), data);
+}
+
+/** Add a request that took too long to the slow request log. */
+static void
+iproto_msg_log_slow(struct iproto_msg *msg, double now)
+{
+	struct iproto_thread *iproto_thread = msg->connection->iproto_thread;
+	struct iproto_slow_request *r = &iproto_thread->slow_log[
+		iproto_thread->slow_log_count++ % IPROTO_SLOW_LOG_SIZE];
+	r->time = clock_realtime();
+	r->session_id = msg->session_id;
+	r->type = msg->header.type;
+	r->stage[IPROTO_STAGE_QUEUE] = msg->tx_start_time - msg->start_time;
+	r->stage[IPROTO_STAGE_EXECUTION] =
+		msg->tx_end_time - msg->tx_start_time;
+	r->stage[IPROTO_STAGE_REPLY] = now - msg->tx_end_time;
+	r->stage[IPROTO_STAGE_TOTAL] = now - msg->start_time;
+	r->wal = msg->tx_wal_wait;
+	r->limbo = msg->tx_limbo_wait;
+	r->yields = msg->tx_yields;
+	iproto_msg_describe(msg, r);
+}
+
+/**
+ * Account the latency of a request the reply to which has just
+ * been received by the iproto thread.
+ */
+static void
+iproto_msg_collect_latency(struct iproto_msg *msg)
+{
+	uint32_t type = msg->header.type;
+	if (msg->tx_end_time == 0)
+		return;
+	double now = clock_monotonic();
+	/*
+	 * The threshold is set by the tx thread. Like
+	 * iproto_readahead, it's read without synchronization.
+	 */
+	if (now - msg->start_time > too_long_threshold)
+		iproto_msg_log_slow(msg, now);
+	if (type >= IPROTO_TYPE_STAT_MAX)
+		return;
+	struct latency *l =
+		msg->connection->iproto_thread->latency.stage[type];
+	latency_collect(&l[IPROTO_STAGE_QUEUE],
+			msg->tx_start_time - msg->start_time);
+	latency_collect(&l[IPROTO_STAGE_EXECUTION],
+			msg->tx_end_time - msg->tx_start_time);
+	latency_collect(&l[IPROTO_STAGE_REPLY], now - msg->tx_end_time);
+	latency_collect(&l[IPROTO_STAGE_TOTAL], now - msg->start_time);
+}
+
+/**
+ * Pass the next request of the stream to tx before the reply to
+ * the request is sent, see IPROTO_FLAG_ASYNC_COMMIT.
+ */
+static void
+net_release_stream(struct cmsg *m)
+{
+	struct iproto_msg *msg = container_of(m, struct iproto_msg,
+					      release_stream);
+	iproto_msg_finish_processing_in_stream(msg);
+}
+
 static void
 net_send_msg(struct cmsg *m)
 {
 	struct iproto_msg *msg = (struct iproto_msg *) m;
 	struct iproto_connection *con = msg->connection;
 
-	iproto_msg_finish_processing_in_stream(msg);
+	iproto_msg_collect_latency(msg);
+	if (!msg->is_stream_released)
+		iproto_msg_finish_processing_in_stream(msg);
 	if (msg->len != 0) {
 		/* Discard request (see iproto_enqueue_batch()). */
 		msg->p_ibuf->rpos += msg->len;
@@ -2432,6 +3637,12 @@ net_send_msg(struct cmsg *m)
 		con->long_poll_count--;
 	}
 	con->wend = msg->wpos;
+	if (msg->enable_compression && !con->compression.is_pending &&
+	    !con->compression.is_enabled) {
+		/* Compress everything following the IPROTO_ID reply. */
+		con->compression.is_pending = true;
+		con->compression.start = msg->wpos;
+	}
 
 	if (con->state == IPROTO_CONNECTION_ALIVE) {
 		iproto_connection_feed_output(con);
@@ -2554,6 +3765,7 @@ net_send_greeting(struct cmsg *m)
 	 * progress.
 	 */
 	assert(con->state == IPROTO_CONNECTION_ALIVE);
+	rlist_add_tail(&con->iproto_thread->connections, &con->in_connections);
 	/* Handshake OK, start reading input. */
 	iproto_connection_feed_output(con);
 	iproto_msg_delete(msg);
@@ -2561,6 +3773,118 @@ net_send_greeting(struct cmsg *m)
 
 /** }}} */
 
+/** {{{ Idle connection trimming. */
+
+/** Return the memory of a flushed output buffer to the slab cache. */
+static inline void
+tx_release_output(struct iproto_connection *con, struct obuf *obuf)
+{
+	obuf_destroy(obuf);
+	obuf_create(obuf, &con->iproto_thread->net_slabc, iproto_readahead);
+}
+
+static void
+tx_process_trim(struct cmsg *m)
+{
+	struct iproto_trim_msg *msg = (struct iproto_trim_msg *)m;
+	struct iproto_connection *con =
+		container_of(msg, struct iproto_connection, trim_msg);
+	struct obuf *out = con->tx.p_obuf;
+	struct obuf *prev = &con->obuf[out == con->obuf];
+	const struct iproto_wpos *wpos = &msg->wpos;
+	/*
+	 * Buffers are flushed in order so if iproto has flushed
+	 * everything in the current buffer, the previous one has
+	 * been flushed, too. If tx has written anything since iproto
+	 * sent the message, the buffers are still in use.
+	 */
+	msg->is_done = (wpos->obuf == out &&
+			wpos->svp.used == obuf_size(out)) ||
+		       (wpos->obuf == prev &&
+			wpos->svp.used == obuf_size(prev) &&
+			obuf_size(out) == 0);
+	if (!msg->is_done)
+		return;
+	tx_release_output(con, out);
+	tx_release_output(con, prev);
+	iproto_wpos_create(&msg->wpos, out);
+	con->tx.sent = msg->wpos;
+}
+
+static void
+net_finish_trim(struct cmsg *m)
+{
+	struct iproto_trim_msg *msg = (struct iproto_trim_msg *)m;
+	struct iproto_connection *con =
+		container_of(msg, struct iproto_connection, trim_msg);
+	con->is_trim_sent = false;
+	if (msg->is_done) {
+		/*
+		 * Tx sends nothing after releasing the output buffers
+		 * before this message so there's nothing to flush.
+		 */
+		con->wpos = msg->wpos;
+		con->wend = msg->wpos;
+	}
+	if (con->state == IPROTO_CONNECTION_PENDING_DESTROY)
+		iproto_connection_try_to_start_destroy(con);
+}
+
+/**
+ * Return the buffers of a connection that hasn't received any
+ * input for the idle period to the slab caches and halve its
+ * readahead. Input buffers are released in place, while output
+ * buffers are released by tx, see tx_process_trim().
+ */
+static void
+iproto_connection_trim(struct iproto_connection *con)
+{
+	assert(con->state == IPROTO_CONNECTION_ALIVE);
+	con->readahead = MAX(con->readahead / 2, (size_t)iproto_readahead);
+	for (int i = 0; i < 2; i++) {
+		struct ibuf *ibuf = &con->ibuf[i];
+		if (ibuf_used(ibuf) != 0 || ibuf_capacity(ibuf) == 0)
+			continue;
+		ibuf_destroy(ibuf);
+		ibuf_create(ibuf, &con->iproto_thread->ibuf_slabc,
+			    con->readahead);
+	}
+	/*
+	 * Requests in progress may write to the output buffers, so
+	 * they may be released only when there are none and all the
+	 * output has been flushed.
+	 */
+	if (con->is_trim_sent || con->long_poll_count != 0 ||
+	    ibuf_used(&con->ibuf[0]) != 0 || ibuf_used(&con->ibuf[1]) != 0 ||
+	    con->wpos.obuf != con->wend.obuf ||
+	    con->wpos.svp.used != con->wend.svp.used ||
+	    con->compression.is_pending ||
+	    ibuf_used(&con->compression.buf) != 0)
+		return;
+	con->trim_msg.wpos = con->wpos;
+	con->is_trim_sent = true;
+	cpipe_push(&con->iproto_thread->tx_pipe, &con->trim_msg.base);
+}
+
+static void
+iproto_thread_on_idle_timer(ev_loop *loop, struct ev_timer *watcher,
+			    int revents)
+{
+	(void)loop;
+	(void)revents;
+	struct iproto_thread *iproto_thread =
+		(struct iproto_thread *)watcher->data;
+	struct iproto_connection *con;
+	rlist_foreach_entry(con, &iproto_thread->connections, in_connections) {
+		if (con->has_input)
+			con->has_input = false;
+		else
+			iproto_connection_trim(con);
+	}
+}
+
+/** }}} */
+
 /**
  * Create a connection and start input.
  */
@@ -2605,12 +3929,27 @@ net_cord_f(va_list  ap)
 	struct iproto_thread *iproto_thread =
 		va_arg(ap, struct iproto_thread *);
 
+	if (iproto_thread->cpu >= 0) {
+		int rc = tt_pthread_setaffinity(iproto_thread->cpu);
+		if (rc != 0) {
+			say_warn("failed to pin iproto thread %u to CPU %d: %s",
+				 iproto_thread->id, iproto_thread->cpu,
+				 strerror(rc));
+			iproto_thread->cpu = -1;
+		}
+	}
+
 	mempool_create(&iproto_thread->iproto_msg_pool, &cord()->slabc,
 		       sizeof(struct iproto_msg));
 	mempool_create(&iproto_thread->iproto_connection_pool, &cord()->slabc,
 		       sizeof(struct iproto_connection));
 	mempool_create(&iproto_thread->iproto_stream_pool, &cord()->slabc,
 		       sizeof(struct iproto_stream));
+	slab_cache_create(&iproto_thread->ibuf_slabc, &runtime);
+	ev_timer_init(&iproto_thread->idle_timer, iproto_thread_on_idle_timer,
+		      IPROTO_IDLE_CHECK_PERIOD, IPROTO_IDLE_CHECK_PERIOD);
+	iproto_thread->idle_timer.data = iproto_thread;
+	ev_timer_start(loop(), &iproto_thread->idle_timer);
 
 	evio_service_create(loop(), &iproto_thread->binary, "binary",
 			    iproto_on_accept, iproto_thread);
@@ -2624,19 +3963,21 @@ net_cord_f(va_list  ap)
 	cbus_endpoint_create(&endpoint, endpoint_name,
 			     fiber_schedule_cb, fiber());
 	/* Create a pipe to "tx" thread. */
-	cpipe_create(&iproto_thread->tx_pipe, "tx");
+	cpipe_create_ring(&iproto_thread->tx_pipe, "tx");
 	cpipe_set_max_input(&iproto_thread->tx_pipe, iproto_msg_max / 2);
 
 	/* Process incomming messages. */
 	cbus_loop(&endpoint);
 
 	cpipe_destroy(&iproto_thread->tx_pipe);
+	ev_timer_stop(loop(), &iproto_thread->idle_timer);
 	/*
 	 * Nothing to do in the fiber so far, the service
 	 * will take care of creating events for incoming
 	 * connections.
 	 */
 	evio_service_detach(&iproto_thread->binary);
+	slab_cache_destroy(&iproto_thread->ibuf_slabc);
 	return 0;
 }
 
@@ -2694,6 +4035,7 @@ tx_end_push(struct cmsg *m)
 		container_of(kharon, struct iproto_connection, kharon);
 	tx_accept_wpos(con, &kharon->wpos);
 	con->tx.is_push_sent = false;
+	fiber_cond_broadcast(&con->tx.push_cond);
 	if (con->tx.is_push_pending)
 		tx_begin_push(con);
 }
@@ -2730,7 +4072,7 @@ iproto_session_push(struct session *session, struct port *port)
 		return -1;
 	}
 	iproto_reply_chunk(con->tx.p_obuf, &svp, iproto_session_sync(session),
-			   ::schema_version);
+			   ::schema_version, 1);
 	tx_push(con);
 	return 0;
 }
@@ -2798,6 +4140,12 @@ iproto_thread_init_routes(struct iproto_thread *iproto_thread)
 	iproto_thread->process1_route[0] =
 		{ tx_process1, &iproto_thread->net_pipe };
 	iproto_thread->process1_route[1] = { net_send_msg, NULL };
+	iproto_thread->batch_route[0] =
+		{ tx_process_batch, &iproto_thread->net_pipe };
+	iproto_thread->batch_route[1] = { net_send_msg, NULL };
+	iproto_thread->cursor_route[0] =
+		{ tx_process_cursor, &iproto_thread->net_pipe };
+	iproto_thread->cursor_route[1] = { net_send_msg, NULL };
 	iproto_thread->sql_route[0] =
 		{ tx_process_sql, &iproto_thread->net_pipe };
 	iproto_thread->sql_route[1] = { net_send_msg, NULL };
@@ -2813,6 +4161,9 @@ iproto_thread_init_routes(struct iproto_thread *iproto_thread)
 	iproto_thread->push_route[0] =
 		{ iproto_process_push, &iproto_thread->tx_pipe };
 	iproto_thread->push_route[1] = { tx_end_push, NULL };
+	iproto_thread->trim_route[0] =
+		{ tx_process_trim, &iproto_thread->net_pipe };
+	iproto_thread->trim_route[1] = { net_finish_trim, NULL };
 	/* IPROTO_OK */
 	iproto_thread->dml_route[0] = NULL;
 	/* IPROTO_SELECT */
@@ -2858,7 +4209,14 @@ iproto_thread_init(struct iproto_thread *iproto_thread)
 	iproto_thread->tx.rmean = rmean_new(rmean_tx_strings, RMEAN_TX_LAST);
 	if (iproto_thread->tx.rmean == NULL)
 		goto fail;
+	if (iproto_latency_create(&iproto_thread->latency) != 0) {
+		rmean_delete(iproto_thread->rmean);
+		rmean_delete(iproto_thread->tx.rmean);
+		slab_cache_destroy(&iproto_thread->net_slabc);
+		return -1;
+	}
 	rlist_create(&iproto_thread->stopped_connections);
+	rlist_create(&iproto_thread->connections);
 	iproto_thread->tx.requests_in_progress = 0;
 	iproto_thread->requests_in_stream_queue = 0;
 	return 0;
@@ -2873,7 +4231,7 @@ fail:
 
 /** Initialize the iproto subsystem and start network io thread */
 void
-iproto_init(int threads_count)
+iproto_init(int threads_count, bool reuse_port, const int *cpus)
 {
 	iproto_features_init();
 
@@ -2887,6 +4245,7 @@ iproto_init(int threads_count)
 	 * We use this tx_binary only for bind, not for listen, so
 	 * we don't need any accept functions.
 	 */
+	iproto_reuse_port = reuse_port;
 	evio_service_create(loop(), &tx_binary, "tx_binary", NULL, NULL);
 	iproto_threads = (struct iproto_thread *)
 		xcalloc(threads_count, sizeof(struct iproto_thread));
@@ -2894,6 +4253,7 @@ iproto_init(int threads_count)
 	for (int i = 0; i < threads_count; i++, iproto_threads_count++) {
 		struct iproto_thread *iproto_thread = &iproto_threads[i];
 		iproto_thread->id = i;
+		iproto_thread->cpu = cpus != NULL ? cpus[i] : -1;
 		if (iproto_thread_init(iproto_thread) != 0)
 			goto fail;
 
@@ -2901,6 +4261,7 @@ iproto_init(int threads_count)
 				 net_cord_f, iproto_thread)) {
 			rmean_delete(iproto_thread->rmean);
 			rmean_delete(iproto_thread->tx.rmean);
+			iproto_latency_destroy(&iproto_thread->latency);
 			slab_cache_destroy(&iproto_thread->net_slabc);
 			goto fail;
 		}
@@ -2908,7 +4269,7 @@ iproto_init(int threads_count)
 		char endpoint_name[ENDPOINT_NAME_MAX];
 		snprintf(endpoint_name, ENDPOINT_NAME_MAX, "net%u",
 			 iproto_thread->id);
-		cpipe_create(&iproto_thread->net_pipe, endpoint_name);
+		cpipe_create_ring(&iproto_thread->net_pipe, endpoint_name);
 		cpipe_set_max_input(&iproto_thread->net_pipe,
 				    iproto_msg_max / 2);
 	}
@@ -2941,6 +4302,21 @@ enum iproto_cfg_op {
 	 * Command code do get statistic from iproto thread
 	 */
 	IPROTO_CFG_STAT,
+	/**
+	 * Command code to add request latency statistic of
+	 * iproto thread to the given counters.
+	 */
+	IPROTO_CFG_LATENCY,
+	/**
+	 * Command code to reset request latency statistic of
+	 * iproto thread.
+	 */
+	IPROTO_CFG_RESET_LATENCY,
+	/**
+	 * Command code to copy the slow request log of iproto
+	 * thread.
+	 */
+	IPROTO_CFG_SLOW_LOG,
 };
 
 /**
@@ -2956,6 +4332,13 @@ struct iproto_cfg_msg: public cbus_call_msg
 	union {
 		/** Pointer to the statistic stucture. */
 		struct iproto_stats *stats;
+		/** Pointer to the request latency counters. */
+		struct iproto_latency *latency;
+		/** Where to copy the slow request log. */
+		struct {
+			struct iproto_slow_request *entries;
+			int count;
+		} slow_log;
 		/** Pointer to evio_service, used for bind */
 		struct evio_service *binary;
 		/** New iproto max message count. */
@@ -2978,6 +4361,11 @@ iproto_fill_stat(struct iproto_thread *iproto_thread,
 	assert(cfg_msg->stats != NULL);
 	cfg_msg->stats->mem_used =
 		slab_cache_used(&iproto_thread->net_cord.slabc) +
+		slab_cache_used(&iproto_thread->ibuf_slabc) +
+		slab_cache_used(&iproto_thread->net_slabc);
+	cfg_msg->stats->input_buffers =
+		slab_cache_used(&iproto_thread->ibuf_slabc);
+	cfg_msg->stats->output_buffers =
 		slab_cache_used(&iproto_thread->net_slabc);
 	cfg_msg->stats->connections =
 		mempool_count(&iproto_thread->iproto_connection_pool);
@@ -3023,8 +4411,8 @@ iproto_do_cfg_f(struct cbus_call_msg *m)
 			}
 			evio_service_create(loop(), binary, "binary",
 					    iproto_on_accept, iproto_thread);
-			evio_service_attach(binary, cfg_msg->binary);
-			if (evio_service_listen(binary) != 0)
+			if (evio_service_attach(binary, cfg_msg->binary) != 0 ||
+			    evio_service_listen(binary) != 0)
 				diag_raise();
 			break;
 		case IPROTO_CFG_STOP:
@@ -3033,6 +4421,23 @@ iproto_do_cfg_f(struct cbus_call_msg *m)
 		case IPROTO_CFG_STAT:
 			iproto_fill_stat(iproto_thread, cfg_msg);
 			break;
+		case IPROTO_CFG_LATENCY:
+			iproto_latency_merge(cfg_msg->latency,
+					     &iproto_thread->latency);
+			break;
+		case IPROTO_CFG_RESET_LATENCY:
+			iproto_latency_reset(&iproto_thread->latency);
+			iproto_thread->slow_log_count = 0;
+			break;
+		case IPROTO_CFG_SLOW_LOG:
+			cfg_msg->slow_log.count = MIN(
+				iproto_thread->slow_log_count,
+				(uint64_t)IPROTO_SLOW_LOG_SIZE);
+			memcpy(cfg_msg->slow_log.entries,
+			       iproto_thread->slow_log,
+			       cfg_msg->slow_log.count *
+			       sizeof(*iproto_thread->slow_log));
+			break;
 		default:
 			unreachable();
 		}
@@ -3090,11 +4495,18 @@ iproto_listen(const struct uri_set *uri_set)
 	iproto_send_stop_msg();
 	evio_service_stop(&tx_binary);
 	evio_service_create(loop(), &tx_binary, "tx_binary", NULL, NULL);
+	tx_binary.reuse_port = iproto_reuse_port;
 	/*
 	 * Please note, we bind sockets in main thread, and then
 	 * listen these sockets in all iproto threads! With this
 	 * implementation, we rely on the Linux kernel to distribute
-	 * incoming connections across iproto threads.
+	 * incoming connections across iproto threads. If reuse_port
+	 * is set, each thread opens a socket of its own bound to the
+	 * same address, so that the kernel balances connections
+	 * between the threads evenly and every thread accepts only
+	 * from its own queue. The socket bound by tx is never listened
+	 * on and so doesn't get any connections: it only reserves the
+	 * address.
 	 */
 	if (evio_service_bind(&tx_binary, uri_set) != 0)
 		return -1;
@@ -3108,6 +4520,8 @@ iproto_stats_add(struct iproto_stats *total_stats,
 		 struct iproto_stats *thread_stats)
 {
 	total_stats->mem_used += thread_stats->mem_used;
+	total_stats->input_buffers += thread_stats->input_buffers;
+	total_stats->output_buffers += thread_stats->output_buffers;
 	total_stats->connections += thread_stats->connections;
 	total_stats->streams += thread_stats->streams;
 	total_stats->requests += thread_stats->requests;
@@ -3141,12 +4555,53 @@ iproto_thread_stats_get(struct iproto_stats *stats, int thread_id)
 		iproto_threads[thread_id].tx.requests_in_progress;
 }
 
+void
+iproto_latency_get(struct iproto_latency *latency)
+{
+	for (int i = 0; i < iproto_threads_count; i++)
+		iproto_thread_latency_get(latency, i);
+}
+
+void
+iproto_thread_latency_get(struct iproto_latency *latency, int thread_id)
+{
+	struct iproto_cfg_msg cfg_msg;
+	iproto_cfg_msg_create(&cfg_msg, IPROTO_CFG_LATENCY);
+	assert(thread_id >= 0 && thread_id < iproto_threads_count);
+	cfg_msg.latency = latency;
+	iproto_do_cfg_crit(&iproto_threads[thread_id], &cfg_msg);
+}
+
+int
+iproto_slow_log_get(struct iproto_slow_request *entries)
+{
+	int count = 0;
+	for (int i = 0; i < iproto_threads_count; i++) {
+		struct iproto_cfg_msg cfg_msg;
+		iproto_cfg_msg_create(&cfg_msg, IPROTO_CFG_SLOW_LOG);
+		cfg_msg.slow_log.entries = entries + count;
+		iproto_do_cfg_crit(&iproto_threads[i], &cfg_msg);
+		count += cfg_msg.slow_log.count;
+	}
+	return count;
+}
+
+int
+iproto_thread_cpu(int thread_id)
+{
+	assert(thread_id >= 0 && thread_id < iproto_threads_count);
+	return iproto_threads[thread_id].cpu;
+}
+
 void
 iproto_reset_stat(void)
 {
+	struct iproto_cfg_msg cfg_msg;
+	iproto_cfg_msg_create(&cfg_msg, IPROTO_CFG_RESET_LATENCY);
 	for (int i = 0; i < iproto_threads_count; i++) {
 		rmean_cleanup(iproto_threads[i].rmean);
 		rmean_cleanup(iproto_threads[i].tx.rmean);
+		iproto_do_cfg_crit(&iproto_threads[i], &cfg_msg);
 	}
 }
 
@@ -3182,6 +4637,7 @@ iproto_free(void)
 		evio_service_detach(&iproto_threads[i].binary);
 		rmean_delete(iproto_threads[i].rmean);
 		rmean_delete(iproto_threads[i].tx.rmean);
+		iproto_latency_destroy(&iproto_threads[i].latency);
 		slab_cache_destroy(&iproto_threads[i].net_slabc);
 	}
 	free(iproto_threads);
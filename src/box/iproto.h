@@ -33,6 +33,9 @@
 
 #include <stddef.h>
 
+#include "iproto_constants.h"
+#include "latency.h"
+
 struct uri_set;
 
 #if defined(__cplusplus)
@@ -61,6 +64,10 @@ enum {
 struct iproto_stats {
 	/** Size of memory used for storing network buffers. */
 	size_t mem_used;
+	/** Size of memory used for storing input network buffers. */
+	size_t input_buffers;
+	/** Size of memory used for storing output network buffers. */
+	size_t output_buffers;
 	/** Number of active iproto connections. */
 	size_t connections;
 	/** Number of active iproto streams. */
@@ -73,6 +80,82 @@ struct iproto_stats {
 	size_t requests_in_stream_queue;
 };
 
+/** Stages of request processing tracked by latency stats. */
+enum iproto_stage {
+	/**
+	 * From decoding of a request in an iproto thread till
+	 * the tx thread starts executing it, including the time
+	 * spent in the stream queue.
+	 */
+	IPROTO_STAGE_QUEUE,
+	/** Execution of a request in the tx thread. */
+	IPROTO_STAGE_EXECUTION,
+	/**
+	 * From the end of execution till the iproto thread gets
+	 * the reply for sending.
+	 */
+	IPROTO_STAGE_REPLY,
+	/** The whole request processing. */
+	IPROTO_STAGE_TOTAL,
+	iproto_stage_MAX,
+};
+
+extern const char *iproto_stage_strs[];
+
+/** Request latency counters, per request type and stage. */
+struct iproto_latency {
+	struct latency stage[IPROTO_TYPE_STAT_MAX][iproto_stage_MAX];
+};
+
+enum {
+	/** Number of slow requests kept by each iproto thread. */
+	IPROTO_SLOW_LOG_SIZE = 32,
+	/** Max length of the request description in the slow log. */
+	IPROTO_SLOW_LOG_KEY_MAX = 64,
+};
+
+/**
+ * A request that took longer than too_long_threshold to process,
+ * from decoding in the iproto thread till the reply was ready.
+ */
+struct iproto_slow_request {
+	/** Wall clock time when the reply was ready. */
+	double time;
+	/** Session that sent the request. */
+	uint64_t session_id;
+	/** Request type. */
+	uint32_t type;
+	/** Space id of a DML request or SELECT, 0 otherwise. */
+	uint32_t space_id;
+	/**
+	 * Key or tuple of a DML request, function name or
+	 * expression of a CALL or EVAL, truncated. Empty if the
+	 * request was discarded from the input buffer before the
+	 * reply was ready, see net_discard_input().
+	 */
+	char key[IPROTO_SLOW_LOG_KEY_MAX];
+	/** Time spent in each stage, in seconds. */
+	double stage[iproto_stage_MAX];
+	/** Time spent waiting for WAL writes during execution. */
+	double wal;
+	/** Time spent waiting for the synchronous quorum. */
+	double limbo;
+	/** Number of yields during execution. */
+	int yields;
+};
+
+/**
+ * Initialize request latency counters.
+ * @retval  0 on success
+ * @retval -1 on error, diag is set
+ */
+int
+iproto_latency_create(struct iproto_latency *latency);
+
+/** Destroy request latency counters. */
+void
+iproto_latency_destroy(struct iproto_latency *latency);
+
 extern unsigned iproto_readahead;
 extern int iproto_threads_count;
 
@@ -89,6 +172,35 @@ iproto_stats_get(struct iproto_stats *stats);
 void
 iproto_thread_stats_get(struct iproto_stats *stats, int thread_id);
 
+/**
+ * Add request latency statistic of all iproto threads
+ * to @a latency.
+ */
+void
+iproto_latency_get(struct iproto_latency *latency);
+
+/**
+ * Add request latency statistic of the thread with
+ * the given id to @a latency.
+ */
+void
+iproto_thread_latency_get(struct iproto_latency *latency, int thread_id);
+
+/**
+ * Copy the slow request logs of all iproto threads to @a entries,
+ * which must have room for IPROTO_SLOW_LOG_SIZE entries per thread.
+ * Returns the number of copied entries, in no particular order.
+ */
+int
+iproto_slow_log_get(struct iproto_slow_request *entries);
+
+/**
+ * Return the CPU the thread with the given id is pinned to
+ * or -1 if it isn't pinned.
+ */
+int
+iproto_thread_cpu(int thread_id);
+
 /**
  * Reset network statistics.
  */
@@ -122,8 +234,14 @@ iproto_thread_rmean_foreach(int thread_id, void *cb, void *cb_ctx);
 #if defined(__cplusplus)
 } /* extern "C" */
 
+/**
+ * Initialize the iproto subsystem with @a threads_count threads.
+ * If @a reuse_port is set, each thread listens on a SO_REUSEPORT
+ * socket of its own. If @a cpus isn't NULL, thread i is pinned to
+ * CPU cpus[i].
+ */
 void
-iproto_init(int threads_count);
+iproto_init(int threads_count, bool reuse_port, const int *cpus);
 
 int
 iproto_listen(const struct uri_set *uri_set);
@@ -0,0 +1,197 @@
+/*
+ * SPDX-License-Identifier: BSD-2-Clause
+ *
+ * Copyright 2010-2022, Tarantool AUTHORS, please see AUTHORS file.
+ */
+#include "iproto_compress.h"
+
+#include <assert.h>
+#include <string.h>
+
+#include "diag.h"
+#include "error.h"
+#include "msgpuck.h"
+#include "small/ibuf.h"
+#include "zstd.h"
+
+void
+iproto_compressor_destroy(struct iproto_compressor *compressor)
+{
+	ZSTD_freeCCtx(compressor->ctx);
+	compressor->ctx = NULL;
+}
+
+/**
+ * Compress @a size bytes given in @a iov into a single zstd frame
+ * and store it in @a dst, which is at least ZSTD_compressBound()
+ * bytes long. Returns the frame size in @a dst_size.
+ */
+static int
+iproto_compress_zstd(struct iproto_compressor *compressor,
+		     const struct iovec *iov, int iovcnt, size_t size,
+		     char *dst, size_t *dst_size)
+{
+	ZSTD_CCtx *ctx = compressor->ctx;
+	if (ctx == NULL) {
+		ctx = ZSTD_createCCtx();
+		if (ctx == NULL) {
+			diag_set(ClientError, ER_COMPRESSION,
+				 "failed to create context");
+			return -1;
+		}
+		ZSTD_CCtx_setParameter(ctx, ZSTD_c_compressionLevel,
+				       IPROTO_COMPRESSION_LEVEL);
+		compressor->ctx = ctx;
+	}
+	ZSTD_CCtx_reset(ctx, ZSTD_reset_session_only);
+	/* Store the content size in the frame for the decoder. */
+	ZSTD_CCtx_setPledgedSrcSize(ctx, size);
+	ZSTD_outBuffer output = {dst, ZSTD_compressBound(size), 0};
+	for (int i = 0; i < iovcnt; i++) {
+		ZSTD_inBuffer input = {iov[i].iov_base, iov[i].iov_len, 0};
+		ZSTD_EndDirective op = i == iovcnt - 1 ?
+				       ZSTD_e_end : ZSTD_e_continue;
+		size_t rc;
+		do {
+			rc = ZSTD_compressStream2(ctx, &output, &input, op);
+			if (ZSTD_isError(rc)) {
+				diag_set(ClientError, ER_COMPRESSION,
+					 ZSTD_getErrorName(rc));
+				return -1;
+			}
+		} while (op == ZSTD_e_end ? rc != 0 : input.pos < input.size);
+	}
+	*dst_size = output.pos;
+	return 0;
+}
+
+int
+iproto_compress(struct iproto_compressor *compressor,
+		const struct iovec *iov, int iovcnt, size_t size,
+		struct ibuf *out)
+{
+	assert(size > 0 && size <= UINT32_MAX);
+	size_t max_size = IPROTO_CHUNK_HEADER_SIZE + ZSTD_compressBound(size);
+	char *chunk = ibuf_reserve(out, max_size);
+	if (chunk == NULL) {
+		diag_set(OutOfMemory, max_size, "ibuf_reserve", "chunk");
+		return -1;
+	}
+	char *payload = chunk + IPROTO_CHUNK_HEADER_SIZE;
+	size_t payload_size = size;
+	uint8_t type = IPROTO_CHUNK_RAW;
+	if (size >= IPROTO_COMPRESSION_THRESHOLD) {
+		if (iproto_compress_zstd(compressor, iov, iovcnt, size,
+					 payload, &payload_size) != 0)
+			return -1;
+		if (payload_size < size)
+			type = IPROTO_CHUNK_ZSTD;
+	}
+	if (type == IPROTO_CHUNK_RAW) {
+		/* Didn't compress or compression didn't pay off. */
+		char *pos = payload;
+		for (int i = 0; i < iovcnt; i++) {
+			memcpy(pos, iov[i].iov_base, iov[i].iov_len);
+			pos += iov[i].iov_len;
+		}
+		assert((size_t)(pos - payload) == size);
+		payload_size = size;
+	}
+	char *pos = mp_store_u8(chunk, type);
+	mp_store_u32(pos, payload_size);
+	ibuf_alloc(out, IPROTO_CHUNK_HEADER_SIZE + payload_size);
+	return 0;
+}
+
+void
+iproto_decompressor_destroy(struct iproto_decompressor *decompressor)
+{
+	ZSTD_freeDCtx(decompressor->ctx);
+	decompressor->ctx = NULL;
+}
+
+/**
+ * Decompress a zstd frame of @a size bytes stored at @a data and
+ * append the result to @a out.
+ */
+static int
+iproto_decompress_zstd(struct iproto_decompressor *decompressor,
+		       const char *data, size_t size, struct ibuf *out)
+{
+	unsigned long long content_size = ZSTD_getFrameContentSize(data, size);
+	if (content_size == ZSTD_CONTENTSIZE_UNKNOWN ||
+	    content_size == ZSTD_CONTENTSIZE_ERROR) {
+		diag_set(ClientError, ER_DECOMPRESSION, "invalid frame");
+		return -1;
+	}
+	if (decompressor->ctx == NULL) {
+		decompressor->ctx = ZSTD_createDCtx();
+		if (decompressor->ctx == NULL) {
+			diag_set(ClientError, ER_DECOMPRESSION,
+				 "failed to create context");
+			return -1;
+		}
+	}
+	char *dst = ibuf_reserve(out, content_size);
+	if (dst == NULL) {
+		diag_set(OutOfMemory, content_size, "ibuf_reserve", "dst");
+		return -1;
+	}
+	size_t rc = ZSTD_decompressDCtx(decompressor->ctx, dst, content_size,
+					data, size);
+	if (ZSTD_isError(rc)) {
+		diag_set(ClientError, ER_DECOMPRESSION, ZSTD_getErrorName(rc));
+		return -1;
+	}
+	ibuf_alloc(out, rc);
+	return 0;
+}
+
+int
+iproto_decompress(struct iproto_decompressor *decompressor,
+		  struct ibuf *in, struct ibuf *out)
+{
+	while (ibuf_used(in) >= IPROTO_CHUNK_HEADER_SIZE) {
+		const char *pos = in->rpos;
+		uint8_t type = mp_load_u8(&pos);
+		uint32_t size = mp_load_u32(&pos);
+		if (ibuf_used(in) < IPROTO_CHUNK_HEADER_SIZE + size)
+			break;
+		switch (type) {
+		case IPROTO_CHUNK_RAW: {
+			char *dst = ibuf_alloc(out, size);
+			if (dst == NULL) {
+				diag_set(OutOfMemory, size, "ibuf_alloc",
+					 "dst");
+				return -1;
+			}
+			memcpy(dst, pos, size);
+			break;
+		}
+		case IPROTO_CHUNK_ZSTD:
+			if (iproto_decompress_zstd(decompressor, pos, size,
+						   out) != 0)
+				return -1;
+			break;
+		default:
+			diag_set(ClientError, ER_DECOMPRESSION,
+				 "unknown chunk type");
+			return -1;
+		}
+		in->rpos = (char *)pos + size;
+	}
+	if (ibuf_used(in) == 0)
+		ibuf_reset(in);
+	return 0;
+}
+
+size_t
+iproto_chunk_bytes_missing(struct ibuf *in)
+{
+	size_t used = ibuf_used(in);
+	if (used < IPROTO_CHUNK_HEADER_SIZE)
+		return IPROTO_CHUNK_HEADER_SIZE - used;
+	const char *pos = in->rpos + 1;
+	size_t size = IPROTO_CHUNK_HEADER_SIZE + mp_load_u32(&pos);
+	return size > used ? size - used : 0;
+}
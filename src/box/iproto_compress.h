@@ -0,0 +1,119 @@
+/*
+ * SPDX-License-Identifier: BSD-2-Clause
+ *
+ * Copyright 2010-2022, Tarantool AUTHORS, please see AUTHORS file.
+ */
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <sys/uio.h>
+
+#if defined(__cplusplus)
+extern "C" {
+#endif
+
+/**
+ * IPROTO output compression.
+ *
+ * If a client sets IPROTO_FEATURE_COMPRESSION in its IPROTO_ID
+ * request, the server puts everything it sends after the reply
+ * to the request into chunks. A chunk starts with a header:
+ * the chunk type (1 byte) followed by the payload size (4 bytes,
+ * big endian). A raw chunk payload is a piece of the output as
+ * is, a zstd chunk payload is a zstd frame with the content size
+ * set. The payloads of all chunks in order form the usual stream
+ * of IPROTO packets.
+ *
+ * The server puts all the output it has at hand into one chunk,
+ * so a chunk may contain many packets as well as a part of one.
+ */
+
+struct ibuf;
+struct ZSTD_CCtx_s;
+struct ZSTD_DCtx_s;
+
+enum iproto_chunk_type {
+	IPROTO_CHUNK_RAW = 0,
+	IPROTO_CHUNK_ZSTD = 1,
+};
+
+enum {
+	/** Size of a chunk header. */
+	IPROTO_CHUNK_HEADER_SIZE = 5,
+	/**
+	 * Output smaller than this is sent in a raw chunk: it isn't
+	 * worth compression.
+	 */
+	IPROTO_COMPRESSION_THRESHOLD = 1024,
+	/**
+	 * Compression level. Network compression must keep up with
+	 * the link, so use the fastest level.
+	 */
+	IPROTO_COMPRESSION_LEVEL = 1,
+};
+
+/** Server side compression state of a connection. */
+struct iproto_compressor {
+	/** Created on the first compressed chunk. */
+	struct ZSTD_CCtx_s *ctx;
+};
+
+static inline void
+iproto_compressor_create(struct iproto_compressor *compressor)
+{
+	compressor->ctx = NULL;
+}
+
+void
+iproto_compressor_destroy(struct iproto_compressor *compressor);
+
+/**
+ * Put @a size bytes of output given in @a iov in a chunk and
+ * append the chunk to @a out. The output is compressed unless
+ * it's smaller than IPROTO_COMPRESSION_THRESHOLD or doesn't get
+ * any smaller when compressed.
+ * @retval  0 on success
+ * @retval -1 on error, diag is set
+ */
+int
+iproto_compress(struct iproto_compressor *compressor,
+		const struct iovec *iov, int iovcnt, size_t size,
+		struct ibuf *out);
+
+/** Client side decompression state of a connection. */
+struct iproto_decompressor {
+	/** Created on the first compressed chunk. */
+	struct ZSTD_DCtx_s *ctx;
+};
+
+static inline void
+iproto_decompressor_create(struct iproto_decompressor *decompressor)
+{
+	decompressor->ctx = NULL;
+}
+
+void
+iproto_decompressor_destroy(struct iproto_decompressor *decompressor);
+
+/**
+ * Decode all complete chunks stored in @a in, consume them and
+ * append their payloads to @a out. An incomplete chunk is left
+ * in @a in.
+ * @retval  0 on success
+ * @retval -1 on error, diag is set
+ */
+int
+iproto_decompress(struct iproto_decompressor *decompressor,
+		  struct ibuf *in, struct ibuf *out);
+
+/**
+ * Return the number of bytes that must be appended to @a in to
+ * complete the first chunk stored in it.
+ */
+size_t
+iproto_chunk_bytes_missing(struct ibuf *in);
+
+#if defined(__cplusplus)
+} /* extern "C" */
+#endif /* defined(__cplusplus) */
@@ -152,6 +152,11 @@ const unsigned char iproto_key_type[IPROTO_KEY_MAX] =
 	/* 0x56 */	MP_DOUBLE, /* IPROTO_TIMEOUT */
 	/* 0x57 */	MP_STR, /* IPROTO_EVENT_KEY */
 	/* 0x58 */	MP_NIL, /* IPROTO_EVENT_DATA (can be any) */
+	/* 0x59 */	MP_ARRAY, /* IPROTO_REQUESTS */
+	/* 0x5a */	MP_UINT, /* IPROTO_CURSOR_ID */
+	/* 0x5b */	MP_BOOL, /* IPROTO_COMPRESSION */
+	/* 0x5c */	MP_ARRAY, /* IPROTO_SPACE_FILTER */
+	/* 0x5d */	MP_UINT, /* IPROTO_TXN_ISOLATION */
 	/* }}} */
 };
 
@@ -288,6 +293,11 @@ const char *iproto_key_strs[IPROTO_KEY_MAX] = {
 	"timeout",          /* 0x56 */
 	"event key",        /* 0x57 */
 	"event data",       /* 0x58 */
+	"requests",         /* 0x59 */
+	"cursor id",        /* 0x5a */
+	"compression",      /* 0x5b */
+	"space filter",     /* 0x5c */
+	"txn isolation",    /* 0x5d */
 };
 
 const char *vy_page_info_key_strs[VY_PAGE_INFO_KEY_MAX] = {
@@ -297,7 +307,8 @@ const char *vy_page_info_key_strs[VY_PAGE_INFO_KEY_MAX] = {
 	"unpacked size",
 	"row count",
 	"min key",
-	"row index offset"
+	"row index offset",
+	"bloom",
 };
 
 const char *vy_run_info_key_strs[VY_RUN_INFO_KEY_MAX] = {
@@ -310,6 +321,7 @@ const char *vy_run_info_key_strs[VY_RUN_INFO_KEY_MAX] = {
 	"bloom filter legacy",
 	"bloom filter",
 	"stmt stat",
+	"dict",
 };
 
 const char *vy_row_index_key_strs[VY_ROW_INDEX_KEY_MAX] = {
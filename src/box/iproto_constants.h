@@ -57,6 +57,12 @@ enum {
 	IPROTO_FLAG_WAIT_SYNC = 0x02,
 	/** Set for the last row of a synchronous tx. */
 	IPROTO_FLAG_WAIT_ACK = 0x04,
+	/**
+	 * Set by a client for a DML request in a stream to let the
+	 * stream go on before the request is written to WAL. It's
+	 * never written to WAL.
+	 */
+	IPROTO_FLAG_ASYNC_COMMIT = 0x08,
 };
 
 enum iproto_key {
@@ -148,6 +154,29 @@ enum iproto_key {
 	/** Key name and data sent to a remote watcher. */
 	IPROTO_EVENT_KEY = 0x57,
 	IPROTO_EVENT_DATA = 0x58,
+	/**
+	 * Sub-requests of IPROTO_BATCH: [
+	 *      { IPROTO_REQUEST_TYPE: type, <request body> },
+	 *      { ... },
+	 *      ...
+	 * ]
+	 */
+	IPROTO_REQUESTS = 0x59,
+	/** Id of a cursor opened with IPROTO_CURSOR_OPEN. */
+	IPROTO_CURSOR_ID = 0x5a,
+	/**
+	 * Set in SUBSCRIBE by a replica that wants the replication
+	 * stream to be compressed, and in the response by a master
+	 * that agrees to compress it.
+	 */
+	IPROTO_COMPRESSION = 0x5b,
+	/**
+	 * Ids of the user spaces a replica wants to receive, set in
+	 * JOIN, FETCH_SNAPSHOT, REGISTER and SUBSCRIBE.
+	 */
+	IPROTO_SPACE_FILTER = 0x5c,
+	/** Transaction isolation level, see enum txn_isolation_level. */
+	IPROTO_TXN_ISOLATION = 0x5d,
 	/*
 	 * Be careful to not extend iproto_key values over 0x7f.
 	 * iproto_keys are encoded in msgpack as positive fixnum, which ends at
@@ -282,6 +311,30 @@ enum iproto_type {
 	IPROTO_WATCH = 74,
 	IPROTO_UNWATCH = 75,
 	IPROTO_EVENT = 76,
+	/**
+	 * Execute a number of DML and SELECT requests in one packet.
+	 * The requests are executed in one transaction, unless they are
+	 * sent in a stream with an active transaction, in which case
+	 * they are added to it. The reply is a SELECT-like response,
+	 * where the data array contains the result of each request.
+	 */
+	IPROTO_BATCH = 77,
+	/**
+	 * Server-side cursors for paginated SELECT.
+	 *
+	 * IPROTO_CURSOR_OPEN takes the same body as IPROTO_SELECT. It
+	 * creates an index iterator, stores it in the connection and
+	 * replies with the first IPROTO_LIMIT tuples and the cursor id
+	 * in IPROTO_CURSOR_ID. IPROTO_CURSOR_FETCH takes IPROTO_CURSOR_ID
+	 * and IPROTO_LIMIT and replies with the next tuples the same
+	 * way. When the iterator is exhausted, the cursor is closed and
+	 * the reply has IPROTO_CURSOR_ID set to 0. IPROTO_CURSOR_CLOSE
+	 * closes a cursor before it's exhausted. Cursors are closed when
+	 * the connection is closed.
+	 */
+	IPROTO_CURSOR_OPEN = 78,
+	IPROTO_CURSOR_FETCH = 79,
+	IPROTO_CURSOR_CLOSE = 80,
 
 	/** Vinyl run info stored in .index file */
 	VY_INDEX_RUN_INFO = 100,
@@ -307,6 +360,7 @@ enum iproto_raft_keys {
 	IPROTO_RAFT_VOTE = 1,
 	IPROTO_RAFT_STATE = 2,
 	IPROTO_RAFT_VCLOCK = 3,
+	IPROTO_RAFT_IS_LEADER_SEEN = 4,
 };
 
 /**
@@ -337,6 +391,14 @@ iproto_type_name(uint16_t type)
 		return "CONFIRM";
 	case IPROTO_RAFT_ROLLBACK:
 		return "ROLLBACK";
+	case IPROTO_BATCH:
+		return "BATCH";
+	case IPROTO_CURSOR_OPEN:
+		return "CURSOR_OPEN";
+	case IPROTO_CURSOR_FETCH:
+		return "CURSOR_FETCH";
+	case IPROTO_CURSOR_CLOSE:
+		return "CURSOR_CLOSE";
 	case VY_INDEX_RUN_INFO:
 		return "RUNINFO";
 	case VY_INDEX_PAGE_INFO:
@@ -451,6 +513,8 @@ enum vy_run_info_key {
 	VY_RUN_INFO_BLOOM = 7,
 	/** Number of statements of each type (map). */
 	VY_RUN_INFO_STMT_STAT = 8,
+	/** Zstd dictionary the run pages are compressed with. */
+	VY_RUN_INFO_DICT = 9,
 	/** The last key in this enum + 1 */
 	VY_RUN_INFO_KEY_MAX
 };
@@ -485,6 +549,8 @@ enum vy_page_info_key {
 	VY_PAGE_INFO_MIN_KEY = 5,
 	/** Offset of the row index in the page. */
 	VY_PAGE_INFO_ROW_INDEX_OFFSET = 6,
+	/** Bloom filter of keys stored in the page. */
+	VY_PAGE_INFO_BLOOM = 7,
 	/** The last key in this enum + 1 */
 	VY_PAGE_INFO_KEY_MAX
 };
@@ -45,6 +45,33 @@ enum iproto_feature_id {
 	 * IPROTO_WATCH, IPROTO_UNWATCH, IPROTO_EVENT commands.
 	 */
 	IPROTO_FEATURE_WATCHERS = 3,
+	/**
+	 * Batches of requests: IPROTO_BATCH command.
+	 */
+	IPROTO_FEATURE_BATCH = 4,
+	/**
+	 * Compression of the server output. Unlike other features,
+	 * it changes the connection behavior if the client sets it
+	 * in IPROTO_ID (see iproto_compress.h).
+	 */
+	IPROTO_FEATURE_COMPRESSION = 5,
+	/**
+	 * Server-side cursors: IPROTO_CURSOR_OPEN, IPROTO_CURSOR_FETCH,
+	 * IPROTO_CURSOR_CLOSE commands.
+	 */
+	IPROTO_FEATURE_CURSORS = 6,
+	/**
+	 * Chunked responses. If the client sets it in IPROTO_ID, the
+	 * server may send a big SELECT result in a number of
+	 * IPROTO_CHUNK packets with the request sync followed by the
+	 * usual reply. The client must concatenate their data.
+	 */
+	IPROTO_FEATURE_CHUNKED_RESPONSES = 7,
+	/**
+	 * Asynchronous commit in streams: IPROTO_FLAG_ASYNC_COMMIT
+	 * request flag.
+	 */
+	IPROTO_FEATURE_ASYNC_COMMIT = 8,
 	iproto_feature_id_MAX,
 };
 
@@ -60,7 +87,7 @@ struct iproto_features {
  * It should be incremented every time a new feature is added or removed.
  */
 enum {
-	IPROTO_CURRENT_VERSION = 3,
+	IPROTO_CURRENT_VERSION = 8,
 };
 
 /**
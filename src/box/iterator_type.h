@@ -73,6 +73,7 @@ enum iterator_type {
 	ITER_BITS_ALL_NOT_SET =  9, /* all bits are not set                */
 	ITER_OVERLAPS         = 10, /* key overlaps x                      */
 	ITER_NEIGHBOR         = 11, /* tuples in distance ascending order from specified point */
+	ITER_PREFIX           = 12, /* string key part starts with x       */
 	iterator_type_MAX
 };
 
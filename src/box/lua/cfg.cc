@@ -150,6 +150,22 @@ lbox_cfg_set_checkpoint_interval(struct lua_State *L)
 	return 0;
 }
 
+static int
+lbox_cfg_set_checkpoint_write_duration(struct lua_State *L)
+{
+	if (box_set_checkpoint_write_duration() != 0)
+		luaT_error(L);
+	return 0;
+}
+
+static int
+lbox_cfg_set_checkpoint_lock(struct lua_State *L)
+{
+	if (box_set_checkpoint_lock() != 0)
+		luaT_error(L);
+	return 0;
+}
+
 static int
 lbox_cfg_set_checkpoint_wal_threshold(struct lua_State *L)
 {
@@ -177,6 +193,22 @@ lbox_cfg_set_wal_cleanup_delay(struct lua_State *L)
 	return 0;
 }
 
+static int
+lbox_cfg_set_wal_group_commit(struct lua_State *L)
+{
+	if (box_set_wal_group_commit() != 0)
+		luaT_error(L);
+	return 0;
+}
+
+static int
+lbox_cfg_set_wal_ring_size(struct lua_State *L)
+{
+	if (box_set_wal_ring_size() != 0)
+		luaT_error(L);
+	return 0;
+}
+
 static int
 lbox_cfg_set_read_only(struct lua_State *L)
 {
@@ -243,6 +275,47 @@ lbox_cfg_set_vinyl_cache(struct lua_State *L)
 	return 0;
 }
 
+static int
+lbox_cfg_set_vinyl_page_cache(struct lua_State *L)
+{
+	try {
+		box_set_vinyl_page_cache();
+	} catch (Exception *) {
+		luaT_error(L);
+	}
+	return 0;
+}
+
+static int
+lbox_cfg_set_vinyl_read_ahead(struct lua_State *L)
+{
+	try {
+		box_set_vinyl_read_ahead();
+	} catch (Exception *) {
+		luaT_error(L);
+	}
+	return 0;
+}
+
+static int
+lbox_cfg_set_vinyl_direct_io(struct lua_State *L)
+{
+	(void)L;
+	box_set_vinyl_direct_io();
+	return 0;
+}
+
+static int
+lbox_cfg_set_vinyl_max_gap_locks(struct lua_State *L)
+{
+	try {
+		box_set_vinyl_max_gap_locks();
+	} catch (Exception *) {
+		luaT_error(L);
+	}
+	return 0;
+}
+
 static int
 lbox_cfg_set_vinyl_timeout(struct lua_State *L)
 {
@@ -273,6 +346,14 @@ lbox_set_prepared_stmt_cache_size(struct lua_State *L)
 	return 0;
 }
 
+static int
+lbox_cfg_set_sql_plan_cache_size(struct lua_State *L)
+{
+	if (box_set_sql_plan_cache_size() != 0)
+		luaT_error(L);
+	return 0;
+}
+
 static int
 lbox_cfg_set_worker_pool_threads(struct lua_State *L)
 {
@@ -369,6 +450,17 @@ lbox_cfg_set_replication_sync_timeout(struct lua_State *L)
 	return 0;
 }
 
+static int
+lbox_cfg_set_replication_ack_interval(struct lua_State *L)
+{
+	try {
+		box_set_replication_ack_interval();
+	} catch (Exception *) {
+		luaT_error(L);
+	}
+	return 0;
+}
+
 static int
 lbox_cfg_set_replication_anon(struct lua_State *L)
 {
@@ -388,6 +480,25 @@ lbox_cfg_set_replication_skip_conflict(struct lua_State *L)
 	return 0;
 }
 
+static int
+lbox_cfg_set_replication_compression(struct lua_State *L)
+{
+	(void) L;
+	box_set_replication_compression();
+	return 0;
+}
+
+static int
+lbox_cfg_set_replication_apply_fibers(struct lua_State *L)
+{
+	try {
+		box_set_replication_apply_fibers();
+	} catch (Exception *) {
+		luaT_error(L);
+	}
+	return 0;
+}
+
 static int
 lbox_cfg_set_crash(struct lua_State *L)
 {
@@ -396,6 +507,22 @@ lbox_cfg_set_crash(struct lua_State *L)
 	return 0;
 }
 
+static int
+lbox_cfg_set_log_async(struct lua_State *L)
+{
+	if (box_set_log_async() != 0)
+		luaT_error(L);
+	return 0;
+}
+
+static int
+lbox_cfg_set_log_async_overflow(struct lua_State *L)
+{
+	if (box_set_log_async_overflow() != 0)
+		luaT_error(L);
+	return 0;
+}
+
 static int
 lbox_cfg_set_txn_timeout(struct lua_State *L)
 {
@@ -404,6 +531,14 @@ lbox_cfg_set_txn_timeout(struct lua_State *L)
 	return 0;
 }
 
+static int
+lbox_cfg_set_space_latency_stat(struct lua_State *L)
+{
+	(void)L;
+	box_set_space_latency_stat();
+	return 0;
+}
+
 void
 box_lua_cfg_init(struct lua_State *L)
 {
@@ -419,15 +554,24 @@ box_lua_cfg_init(struct lua_State *L)
 		{"cfg_set_snap_io_rate_limit", lbox_cfg_set_snap_io_rate_limit},
 		{"cfg_set_checkpoint_count", lbox_cfg_set_checkpoint_count},
 		{"cfg_set_checkpoint_interval", lbox_cfg_set_checkpoint_interval},
+		{"cfg_set_checkpoint_write_duration",
+			lbox_cfg_set_checkpoint_write_duration},
+		{"cfg_set_checkpoint_lock", lbox_cfg_set_checkpoint_lock},
 		{"cfg_set_checkpoint_wal_threshold", lbox_cfg_set_checkpoint_wal_threshold},
 		{"cfg_set_wal_queue_max_size", lbox_cfg_set_wal_queue_max_size},
 		{"cfg_set_wal_cleanup_delay", lbox_cfg_set_wal_cleanup_delay},
+		{"cfg_set_wal_group_commit", lbox_cfg_set_wal_group_commit},
+		{"cfg_set_wal_ring_size", lbox_cfg_set_wal_ring_size},
 		{"cfg_set_read_only", lbox_cfg_set_read_only},
 		{"cfg_set_memtx_memory", lbox_cfg_set_memtx_memory},
 		{"cfg_set_memtx_max_tuple_size", lbox_cfg_set_memtx_max_tuple_size},
 		{"cfg_set_vinyl_memory", lbox_cfg_set_vinyl_memory},
 		{"cfg_set_vinyl_max_tuple_size", lbox_cfg_set_vinyl_max_tuple_size},
 		{"cfg_set_vinyl_cache", lbox_cfg_set_vinyl_cache},
+		{"cfg_set_vinyl_page_cache", lbox_cfg_set_vinyl_page_cache},
+		{"cfg_set_vinyl_read_ahead", lbox_cfg_set_vinyl_read_ahead},
+		{"cfg_set_vinyl_direct_io", lbox_cfg_set_vinyl_direct_io},
+		{"cfg_set_vinyl_max_gap_locks", lbox_cfg_set_vinyl_max_gap_locks},
 		{"cfg_set_vinyl_timeout", lbox_cfg_set_vinyl_timeout},
 		{"cfg_set_election_mode", lbox_cfg_set_election_mode},
 		{"cfg_set_election_timeout", lbox_cfg_set_election_timeout},
@@ -438,12 +582,19 @@ box_lua_cfg_init(struct lua_State *L)
 		{"cfg_set_replication_synchro_quorum", lbox_cfg_set_replication_synchro_quorum},
 		{"cfg_set_replication_synchro_timeout", lbox_cfg_set_replication_synchro_timeout},
 		{"cfg_set_replication_sync_timeout", lbox_cfg_set_replication_sync_timeout},
+		{"cfg_set_replication_ack_interval", lbox_cfg_set_replication_ack_interval},
 		{"cfg_set_replication_skip_conflict", lbox_cfg_set_replication_skip_conflict},
+		{"cfg_set_replication_apply_fibers", lbox_cfg_set_replication_apply_fibers},
+		{"cfg_set_replication_compression", lbox_cfg_set_replication_compression},
 		{"cfg_set_replication_anon", lbox_cfg_set_replication_anon},
 		{"cfg_set_net_msg_max", lbox_cfg_set_net_msg_max},
 		{"cfg_set_sql_cache_size", lbox_set_prepared_stmt_cache_size},
+		{"cfg_set_sql_plan_cache_size", lbox_cfg_set_sql_plan_cache_size},
 		{"cfg_set_crash", lbox_cfg_set_crash},
 		{"cfg_set_txn_timeout", lbox_cfg_set_txn_timeout},
+		{"cfg_set_space_latency_stat", lbox_cfg_set_space_latency_stat},
+		{"cfg_set_log_async", lbox_cfg_set_log_async},
+		{"cfg_set_log_async_overflow", lbox_cfg_set_log_async_overflow},
 		{NULL, NULL}
 	};
 
@@ -0,0 +1,592 @@
+/*
+ * SPDX-License-Identifier: BSD-2-Clause
+ *
+ * Copyright 2010-2026, Tarantool AUTHORS, please see AUTHORS file.
+ */
+#include "box/lua/csv.h"
+
+#include <assert.h>
+#include <errno.h>
+#include <lua.h>
+#include <lauxlib.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "box/box.h"
+#include "box/field_def.h"
+#include "box/schema.h"
+#include "box/space.h"
+#include "box/txn.h"
+#include "coio_task.h"
+#include "csv/csv.h"
+#include "decimal.h"
+#include "diag.h"
+#include "lua/utils.h"
+#include "mp_decimal.h"
+#include "mp_uuid.h"
+#include "msgpuck.h"
+#include "trivia/util.h"
+#include "tt_uuid.h"
+
+/**
+ * CSV loader parses CSV text straight into MsgPack tuples, converting
+ * the fields to the types defined by the space format, and inserts
+ * them with box_insert_batch(), so that no Lua object is created per
+ * field or per row.
+ *
+ * Parsing doesn't touch the tx thread state, so it may be done in a
+ * coio worker thread. That's why all buffers are allocated with
+ * malloc() rather than from the cord slab cache.
+ */
+
+/** Default number of rows inserted in one transaction. */
+enum { CSV_LOADER_BATCH_SIZE_DEFAULT = 1000 };
+
+/** Max length of a field that can be converted to a number. */
+enum { CSV_LOADER_NUMBER_LEN_MAX = 64 };
+
+/** A growable buffer that may be used in any thread. */
+struct csv_loader_buf {
+	char *data;
+	size_t size;
+	size_t capacity;
+};
+
+static void
+csv_loader_buf_destroy(struct csv_loader_buf *buf)
+{
+	free(buf->data);
+	memset(buf, 0, sizeof(*buf));
+}
+
+/**
+ * Reserve @a size bytes at the end of the buffer.
+ * Returns NULL and sets diag on memory error.
+ */
+static char *
+csv_loader_buf_reserve(struct csv_loader_buf *buf, size_t size)
+{
+	if (buf->size + size <= buf->capacity)
+		return buf->data + buf->size;
+	size_t capacity = MAX(buf->capacity * 2, 4096);
+	while (capacity < buf->size + size)
+		capacity *= 2;
+	char *data = realloc(buf->data, capacity);
+	if (data == NULL) {
+		diag_set(OutOfMemory, capacity, "realloc", "data");
+		return NULL;
+	}
+	buf->data = data;
+	buf->capacity = capacity;
+	return buf->data + buf->size;
+}
+
+struct csv_loader {
+	/** Target space. */
+	uint32_t space_id;
+	/** Max number of rows inserted in one transaction. */
+	uint32_t batch_size;
+	/** Types of the fields defined by the space format. */
+	enum field_type *types;
+	/** Nullability of the fields defined by the space format. */
+	bool *is_nullable;
+	/** Number of fields in the space format. */
+	uint32_t field_count;
+	/** Number of header lines that are still to be skipped. */
+	uint32_t skip_lines;
+	/** Parse chunks in a coio worker thread. */
+	bool parse_in_thread;
+	/** Set while a chunk is processed, the loader may yield. */
+	bool is_busy;
+	/** Set after the end of input is parsed. */
+	bool is_finished;
+	struct csv csv;
+	struct csv_iterator it;
+	/** Number of rows parsed so far, including skipped ones. */
+	uint64_t line;
+	/** Encoded fields of the row being parsed. */
+	struct csv_loader_buf row;
+	/** Number of fields in @a row. */
+	uint32_t row_field_count;
+	/** Set if the only field of the row so far is empty. */
+	bool row_is_blank;
+	/**
+	 * Batches of encoded rows. Each batch is a MsgPack array of
+	 * tuples. The array header is always 32-bit, so it can be
+	 * reserved when the batch is started and written when the
+	 * number of rows is known. All batches but the last one are
+	 * complete, the last one is complete only if @a open_count
+	 * is 0.
+	 */
+	struct csv_loader_buf batches;
+	/** Size of the complete batches in @a batches. */
+	size_t complete_size;
+	/** Number of rows in the last, incomplete batch. */
+	uint32_t open_count;
+	/** Number of rows inserted so far. */
+	uint64_t row_count;
+};
+
+static const char csv_loader_typename[] = "box.csv_loader";
+
+/** Set diag about a field that doesn't match the space format. */
+static void
+csv_loader_field_error(struct csv_loader *loader, const char *field,
+		       size_t len, enum field_type type)
+{
+	diag_set(IllegalParams, "CSV row %llu, field %u: can't convert "
+		 "'%.*s' to %s", (unsigned long long)loader->line + 1,
+		 loader->row_field_count + 1, (int)MIN(len, 64), field,
+		 field_type_strs[type]);
+}
+
+/**
+ * Encode a field of the current row, converting it to the type
+ * defined by the space format. Fields that aren't in the format are
+ * encoded as strings. An empty field is encoded as nil if the field
+ * is nullable.
+ */
+static int
+csv_loader_encode_field(struct csv_loader *loader, const char *field,
+			size_t len)
+{
+	uint32_t fieldno = loader->row_field_count;
+	enum field_type type = FIELD_TYPE_STRING;
+	bool is_nullable = false;
+	if (fieldno < loader->field_count) {
+		type = loader->types[fieldno];
+		is_nullable = loader->is_nullable[fieldno];
+	}
+	loader->row_is_blank = fieldno == 0 && len == 0;
+	char *data;
+	if (len == 0 && is_nullable) {
+		data = csv_loader_buf_reserve(&loader->row, mp_sizeof_nil());
+		if (data == NULL)
+			return -1;
+		loader->row.size = mp_encode_nil(data) - loader->row.data;
+		loader->row_field_count++;
+		return 0;
+	}
+	if (type == FIELD_TYPE_STRING || type == FIELD_TYPE_ANY ||
+	    type == FIELD_TYPE_SCALAR) {
+		data = csv_loader_buf_reserve(&loader->row,
+					      mp_sizeof_str(len));
+		if (data == NULL)
+			return -1;
+		loader->row.size = mp_encode_str(data, field, len) -
+				   loader->row.data;
+		loader->row_field_count++;
+		return 0;
+	}
+	/* strto*() need a zero-terminated string. */
+	char str[CSV_LOADER_NUMBER_LEN_MAX + 1];
+	if (len == 0 || len > CSV_LOADER_NUMBER_LEN_MAX)
+		goto error;
+	memcpy(str, field, len);
+	str[len] = '\0';
+	char *end;
+	/* Enough for any scalar, a UUID or a decimal. */
+	data = csv_loader_buf_reserve(&loader->row, 64);
+	if (data == NULL)
+		return -1;
+	errno = 0;
+	switch (type) {
+	case FIELD_TYPE_UNSIGNED: {
+		if (str[0] == '-')
+			goto error;
+		unsigned long long u = strtoull(str, &end, 10);
+		if (*end != '\0' || errno != 0)
+			goto error;
+		data = mp_encode_uint(data, u);
+		break;
+	}
+	case FIELD_TYPE_INTEGER:
+	case FIELD_TYPE_NUMBER: {
+		long long i = strtoll(str, &end, 10);
+		if (*end == '\0' && errno == 0) {
+			data = i >= 0 ? mp_encode_uint(data, i) :
+					mp_encode_int(data, i);
+			break;
+		}
+		if (str[0] != '-' && *end == '\0') {
+			/* Integers above INT64_MAX are still unsigned. */
+			errno = 0;
+			unsigned long long u = strtoull(str, &end, 10);
+			if (errno == 0) {
+				data = mp_encode_uint(data, u);
+				break;
+			}
+		}
+		if (type == FIELD_TYPE_INTEGER)
+			goto error;
+		errno = 0;
+		double d = strtod(str, &end);
+		if (*end != '\0' || errno != 0)
+			goto error;
+		data = mp_encode_double(data, d);
+		break;
+	}
+	case FIELD_TYPE_DOUBLE: {
+		double d = strtod(str, &end);
+		if (*end != '\0' || errno != 0)
+			goto error;
+		data = mp_encode_double(data, d);
+		break;
+	}
+	case FIELD_TYPE_BOOLEAN:
+		if (strcmp(str, "true") == 0)
+			data = mp_encode_bool(data, true);
+		else if (strcmp(str, "false") == 0)
+			data = mp_encode_bool(data, false);
+		else
+			goto error;
+		break;
+	case FIELD_TYPE_UUID: {
+		struct tt_uuid uuid;
+		if (tt_uuid_from_strl(str, len, &uuid) != 0)
+			goto error;
+		data = mp_encode_uuid(data, &uuid);
+		break;
+	}
+	case FIELD_TYPE_DECIMAL: {
+		decimal_t dec;
+		if (decimal_from_string(&dec, str) == NULL)
+			goto error;
+		data = mp_encode_decimal(data, &dec);
+		break;
+	}
+	default:
+		/*
+		 * Varbinary, datetime, array and map have no text
+		 * representation in CSV.
+		 */
+		goto error;
+	}
+	loader->row.size = data - loader->row.data;
+	loader->row_field_count++;
+	return 0;
+error:
+	csv_loader_field_error(loader, field, len, type);
+	return -1;
+}
+
+/** Append the current row to the last batch. */
+static int
+csv_loader_end_row(struct csv_loader *loader)
+{
+	uint32_t field_count = loader->row_field_count;
+	size_t row_size = loader->row.size;
+	loader->row_field_count = 0;
+	loader->row.size = 0;
+	loader->line++;
+	/* A blank line is parsed as a single empty field. */
+	if (field_count == 0 || (field_count == 1 && loader->row_is_blank))
+		return 0;
+	struct csv_loader_buf *batches = &loader->batches;
+	char *data = csv_loader_buf_reserve(batches, 5 +
+					    mp_sizeof_array(field_count) +
+					    row_size);
+	if (data == NULL)
+		return -1;
+	/* Reserve the header of a new batch. */
+	if (loader->open_count == 0)
+		data += 5;
+	data = mp_encode_array(data, field_count);
+	memcpy(data, loader->row.data, row_size);
+	batches->size = data + row_size - batches->data;
+	if (++loader->open_count == loader->batch_size) {
+		char *header = batches->data + loader->complete_size;
+		mp_store_u8(header, 0xdd);
+		mp_store_u32(header + 1, loader->open_count);
+		loader->complete_size = batches->size;
+		loader->open_count = 0;
+	}
+	return 0;
+}
+
+/**
+ * Parse a chunk of CSV text into batches of tuples. An empty chunk
+ * means the end of input.
+ */
+static int
+csv_loader_parse(struct csv_loader *loader, const char *chunk, size_t size)
+{
+	struct csv_iterator *it = &loader->it;
+	csv_feed(it, chunk, size);
+	while (true) {
+		switch (csv_next(it)) {
+		case CSV_IT_OK:
+			if (loader->skip_lines > 0)
+				break;
+			if (csv_loader_encode_field(
+					loader, csv_iterator_get_field(it),
+					csv_iterator_get_field_len(it)) != 0)
+				return -1;
+			break;
+		case CSV_IT_EOL:
+			if (loader->skip_lines > 0) {
+				loader->skip_lines--;
+				loader->line++;
+				break;
+			}
+			if (csv_loader_end_row(loader) != 0)
+				return -1;
+			break;
+		case CSV_IT_NEEDMORE:
+		case CSV_IT_EOF:
+			return 0;
+		case CSV_IT_ERROR:
+			if (csv_get_error_status(&loader->csv) ==
+			    CSV_ER_MEMORY_ERROR) {
+				diag_set(OutOfMemory, 0, "realloc", "csv");
+			} else {
+				diag_set(IllegalParams, "CSV row %llu: "
+					 "unterminated quoted field",
+					 (unsigned long long)loader->line + 1);
+			}
+			return -1;
+		default:
+			unreachable();
+		}
+	}
+}
+
+static ssize_t
+csv_loader_parse_f(va_list ap)
+{
+	struct csv_loader *loader = va_arg(ap, struct csv_loader *);
+	const char *chunk = va_arg(ap, const char *);
+	size_t size = va_arg(ap, size_t);
+	return csv_loader_parse(loader, chunk, size);
+}
+
+/** Insert the complete batches, in the tx thread. */
+static int
+csv_loader_flush(struct csv_loader *loader)
+{
+	struct csv_loader_buf *batches = &loader->batches;
+	const char *pos = batches->data;
+	const char *end = batches->data + loader->complete_size;
+	while (pos < end) {
+		const char *batch = pos;
+		uint32_t count = mp_decode_array(&pos);
+		for (uint32_t i = 0; i < count; i++)
+			mp_next(&pos);
+		if (box_insert_batch(loader->space_id, batch, pos) != 0)
+			return -1;
+		loader->row_count += count;
+	}
+	/* Move the incomplete batch to the beginning. */
+	memmove(batches->data, end, batches->size - loader->complete_size);
+	batches->size -= loader->complete_size;
+	loader->complete_size = 0;
+	return 0;
+}
+
+/** Parse a chunk, maybe in a worker thread, and insert it. */
+static int
+csv_loader_process(struct csv_loader *loader, const char *chunk,
+		   size_t size)
+{
+	if (loader->is_busy) {
+		diag_set(IllegalParams, "CSV loader is used by another fiber");
+		return -1;
+	}
+	if (loader->is_finished) {
+		diag_set(IllegalParams, "CSV loader is finished");
+		return -1;
+	}
+	int rc;
+	loader->is_busy = true;
+	if (loader->parse_in_thread) {
+		rc = coio_call(csv_loader_parse_f, loader, chunk, size);
+		if (rc != 0 && diag_is_empty(diag_get()))
+			diag_set(OutOfMemory, sizeof(struct coio_task),
+				 "calloc", "coio_task");
+	} else {
+		rc = csv_loader_parse(loader, chunk, size);
+	}
+	if (rc == 0 && size == 0) {
+		loader->is_finished = true;
+		/* Complete the last batch. */
+		if (loader->open_count > 0) {
+			char *header = loader->batches.data +
+				       loader->complete_size;
+			mp_store_u8(header, 0xdd);
+			mp_store_u32(header + 1, loader->open_count);
+			loader->complete_size = loader->batches.size;
+			loader->open_count = 0;
+		}
+	}
+	if (rc == 0)
+		rc = csv_loader_flush(loader);
+	loader->is_busy = false;
+	return rc;
+}
+
+static struct csv_loader *
+luaT_check_csv_loader(struct lua_State *L, int idx)
+{
+	struct csv_loader **ptr = luaL_checkudata(L, idx, csv_loader_typename);
+	if (*ptr == NULL)
+		luaL_error(L, "CSV loader is closed");
+	return *ptr;
+}
+
+static void
+csv_loader_delete(struct csv_loader *loader)
+{
+	csv_destroy(&loader->csv);
+	csv_loader_buf_destroy(&loader->row);
+	csv_loader_buf_destroy(&loader->batches);
+	free(loader->types);
+	free(loader->is_nullable);
+	free(loader);
+}
+
+/** Read a single character option from the table at index 2. */
+static char
+lbox_csv_loader_char_opt(struct lua_State *L, const char *name, char dflt)
+{
+	lua_getfield(L, 2, name);
+	char c = dflt;
+	if (!lua_isnil(L, -1)) {
+		size_t len;
+		const char *str = lua_tolstring(L, -1, &len);
+		if (str == NULL || len != 1)
+			luaL_error(L, "%s must be a single character", name);
+		c = str[0];
+	}
+	lua_pop(L, 1);
+	return c;
+}
+
+/**
+ * csv_loader_new(space_id, opts) creates a loader for the space.
+ * The options are batch_size, delimiter, quote_char, skip_head_lines
+ * and parse_in_thread.
+ */
+static int
+lbox_csv_loader_new(struct lua_State *L)
+{
+	if (lua_gettop(L) != 2 || !lua_isnumber(L, 1) || !lua_istable(L, 2))
+		return luaL_error(L, "Usage: csv_loader_new(space_id, opts)");
+	uint32_t space_id = lua_tonumber(L, 1);
+	lua_getfield(L, 2, "batch_size");
+	int batch_size = lua_isnil(L, -1) ? CSV_LOADER_BATCH_SIZE_DEFAULT :
+					    lua_tointeger(L, -1);
+	lua_getfield(L, 2, "skip_head_lines");
+	int skip_lines = lua_tointeger(L, -1);
+	lua_getfield(L, 2, "parse_in_thread");
+	bool parse_in_thread = lua_toboolean(L, -1);
+	lua_pop(L, 3);
+	if (batch_size <= 0)
+		return luaL_error(L, "batch_size must be positive");
+	if (skip_lines < 0)
+		return luaL_error(L, "skip_head_lines must not be negative");
+	char delimiter = lbox_csv_loader_char_opt(L, "delimiter", ',');
+	char quote_char = lbox_csv_loader_char_opt(L, "quote_char", '"');
+
+	struct space *space = space_cache_find(space_id);
+	if (space == NULL)
+		return luaT_error(L);
+	struct csv_loader **ptr = lua_newuserdata(L, sizeof(*ptr));
+	*ptr = NULL;
+	luaL_getmetatable(L, csv_loader_typename);
+	lua_setmetatable(L, -2);
+
+	struct csv_loader *loader = xcalloc(1, sizeof(*loader));
+	loader->space_id = space_id;
+	loader->batch_size = batch_size;
+	loader->skip_lines = skip_lines;
+	loader->parse_in_thread = parse_in_thread;
+	/*
+	 * The format is copied, because the space may be altered
+	 * while a chunk is parsed in a worker thread.
+	 */
+	uint32_t field_count = space->def->field_count;
+	loader->field_count = field_count;
+	loader->types = xcalloc(MAX(field_count, 1), sizeof(*loader->types));
+	loader->is_nullable = xcalloc(MAX(field_count, 1),
+				      sizeof(*loader->is_nullable));
+	for (uint32_t i = 0; i < field_count; i++) {
+		loader->types[i] = space->def->fields[i].type;
+		loader->is_nullable[i] = space->def->fields[i].is_nullable;
+	}
+	csv_create(&loader->csv);
+	csv_setopt(&loader->csv, CSV_OPT_DELIMITER, delimiter);
+	csv_setopt(&loader->csv, CSV_OPT_QUOTE, quote_char);
+	csv_iterator_create(&loader->it, &loader->csv);
+	*ptr = loader;
+	return 1;
+}
+
+/**
+ * loader:feed(chunk) parses a chunk of CSV text and inserts all
+ * complete batches of rows. A row may span several chunks.
+ */
+static int
+lbox_csv_loader_feed(struct lua_State *L)
+{
+	struct csv_loader *loader = luaT_check_csv_loader(L, 1);
+	size_t size;
+	const char *chunk = luaL_checklstring(L, 2, &size);
+	/* An empty chunk would mean the end of input to the parser. */
+	if (size == 0)
+		return 0;
+	if (loader->parse_in_thread && in_txn() != NULL) {
+		diag_set(IllegalParams, "parse_in_thread can't be used "
+			 "in a transaction");
+		return luaT_error(L);
+	}
+	/* The chunk is referenced by the stack while the fiber yields. */
+	if (csv_loader_process(loader, chunk, size) != 0)
+		return luaT_error(L);
+	return 0;
+}
+
+/**
+ * loader:finish() parses the rest of input, inserts the last batch
+ * and returns the total number of inserted rows.
+ */
+static int
+lbox_csv_loader_finish(struct lua_State *L)
+{
+	struct csv_loader *loader = luaT_check_csv_loader(L, 1);
+	if (csv_loader_process(loader, "", 0) != 0)
+		return luaT_error(L);
+	lua_pushnumber(L, loader->row_count);
+	return 1;
+}
+
+static int
+lbox_csv_loader_gc(struct lua_State *L)
+{
+	struct csv_loader **ptr = luaL_checkudata(L, 1, csv_loader_typename);
+	if (*ptr != NULL) {
+		/* A yielded fiber may use it, see csv_loader_process(). */
+		assert(!(*ptr)->is_busy);
+		csv_loader_delete(*ptr);
+		*ptr = NULL;
+	}
+	return 0;
+}
+
+void
+box_lua_csv_init(struct lua_State *L)
+{
+	static const struct luaL_Reg csv_loader_meta[] = {
+		{"feed", lbox_csv_loader_feed},
+		{"finish", lbox_csv_loader_finish},
+		{"__gc", lbox_csv_loader_gc},
+		{NULL, NULL}
+	};
+	luaL_register_type(L, csv_loader_typename, csv_loader_meta);
+
+	static const struct luaL_Reg boxlib_internal[] = {
+		{"csv_loader_new", lbox_csv_loader_new},
+		{NULL, NULL}
+	};
+	luaL_register(L, "box.internal", boxlib_internal);
+	lua_pop(L, 1);
+}
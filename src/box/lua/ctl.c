@@ -44,6 +44,7 @@
 #include "box/engine.h"
 #include "box/memtx_engine.h"
 #include "box/raft.h"
+#include "vclock/vclock.h"
 
 static int
 lbox_ctl_wait_ro(struct lua_State *L)
@@ -69,6 +70,34 @@ lbox_ctl_wait_rw(struct lua_State *L)
 	return 0;
 }
 
+static int
+lbox_ctl_wait_vclock(struct lua_State *L)
+{
+	int index = lua_gettop(L);
+	if (index < 1 || index > 2 || !lua_istable(L, 1))
+		return luaL_error(L, "Usage: box.ctl.wait_vclock(vclock"
+				  "[, timeout])");
+	double timeout = TIMEOUT_INFINITY;
+	if (index > 1)
+		timeout = luaL_checknumber(L, 2);
+	struct vclock vclock;
+	vclock_create(&vclock);
+	lua_pushnil(L);
+	while (lua_next(L, 1) != 0) {
+		uint64_t id = luaL_checkuint64(L, -2);
+		int64_t lsn = luaL_checkint64(L, -1);
+		if (id >= VCLOCK_MAX || lsn < 0)
+			return luaL_error(L, "Invalid vclock component "
+					  "%llu: %lld", (unsigned long long)id,
+					  (long long)lsn);
+		vclock_reset(&vclock, id, lsn);
+		lua_pop(L, 1);
+	}
+	if (box_wait_vclock(&vclock, timeout) != 0)
+		return luaT_error(L);
+	return 0;
+}
+
 static int
 lbox_ctl_on_shutdown(struct lua_State *L)
 {
@@ -137,6 +166,7 @@ lbox_ctl_set_on_shutdown_timeout(struct lua_State *L)
 static const struct luaL_Reg lbox_ctl_lib[] = {
 	{"wait_ro", lbox_ctl_wait_ro},
 	{"wait_rw", lbox_ctl_wait_rw},
+	{"wait_vclock", lbox_ctl_wait_vclock},
 	{"on_shutdown", lbox_ctl_on_shutdown},
 	{"on_schema_init", lbox_ctl_on_schema_init},
 	{"on_election", lbox_ctl_on_election},
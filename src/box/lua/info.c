@@ -31,6 +31,7 @@
 #include "lua/info.h"
 
 #include <ctype.h> /* tolower() */
+#include <dirent.h>
 
 #include <lua.h>
 #include <lauxlib.h>
@@ -44,17 +45,23 @@
 #include "info/info.h"
 #include "box/gc.h"
 #include "box/engine.h"
+#include "box/memtx_engine.h"
 #include "box/vinyl.h"
 #include "box/sql_stmt_cache.h"
 #include "main.h"
 #include "version.h"
 #include "box/box.h"
 #include "box/raft.h"
+#include "box/recovery.h"
 #include "box/txn_limbo.h"
 #include "lua/utils.h"
 #include "lua/serializer.h" /* luaL_setmaphint */
 #include "fiber.h"
+#include "file_reclaim.h"
+#include "say.h"
 #include "sio.h"
+#include "tt_static.h"
+#include "histogram.h"
 
 static void
 lbox_pushvclock(struct lua_State *L, const struct vclock *vclock)
@@ -84,6 +91,22 @@ lbox_push_replication_error_message(struct lua_State *L, struct error *e,
 	lua_settable(L, idx - 2);
 }
 
+/** Push a table with the median and the 99th percentile of a lag. */
+static void
+lbox_push_lag_percentiles(lua_State *L, const char *name,
+			  double p50, double p99)
+{
+	lua_pushstring(L, name);
+	lua_createtable(L, 0, 2);
+	lua_pushstring(L, "p50");
+	lua_pushnumber(L, p50);
+	lua_settable(L, -3);
+	lua_pushstring(L, "p99");
+	lua_pushnumber(L, p99);
+	lua_settable(L, -3);
+	lua_settable(L, -3);
+}
+
 static void
 lbox_pushapplier(lua_State *L, struct applier *applier)
 {
@@ -121,6 +144,20 @@ lbox_pushapplier(lua_State *L, struct applier *applier)
 		lua_pushlstring(L, name, total);
 		lua_settable(L, -3);
 
+		lua_pushstring(L, "apply_queue");
+		lua_pushinteger(L, applier->apply_queue_len);
+		lua_settable(L, -3);
+
+		lua_pushstring(L, "lag_stat");
+		lua_newtable(L);
+		lbox_push_lag_percentiles(L, "recv",
+			latency_get(&applier->recv_lag, 50),
+			latency_get(&applier->recv_lag, 99));
+		lbox_push_lag_percentiles(L, "wal",
+			latency_get(&applier->wal_lag, 50),
+			latency_get(&applier->wal_lag, 99));
+		lua_settable(L, -3);
+
 		struct error *e = diag_last_error(&applier->reader->diag);
 		if (e != NULL)
 			lbox_push_replication_error_message(L, e, -1);
@@ -147,6 +184,15 @@ lbox_pushrelay(lua_State *L, struct relay *relay)
 		lua_pushstring(L, "lag");
 		lua_pushnumber(L, relay_txn_lag(relay));
 		lua_settable(L, -3);
+		struct relay_lag_stat lag_stat;
+		relay_lag_stat(relay, &lag_stat);
+		lua_pushstring(L, "lag_stat");
+		lua_newtable(L);
+		lbox_push_lag_percentiles(L, "send", lag_stat.send_p50,
+					  lag_stat.send_p99);
+		lbox_push_lag_percentiles(L, "ack", lag_stat.ack_p50,
+					  lag_stat.ack_p99);
+		lua_settable(L, -3);
 		break;
 	case RELAY_STOPPED:
 	{
@@ -464,6 +510,53 @@ lbox_info_gc_call(struct lua_State *L)
 	lua_pushboolean(L, gc.is_paused);
 	lua_settable(L, -3);
 
+	/*
+	 * Memory held by tuples deleted during a checkpoint,
+	 * which can't be freed until the checkpoint completes.
+	 */
+	struct memtx_engine *memtx =
+		(struct memtx_engine *)engine_by_name("memtx");
+	lua_pushstring(L, "delayed_free");
+	luaL_pushuint64(L, memtx_engine_delayed_free_size(memtx));
+	lua_settable(L, -3);
+
+	/*
+	 * Files that have been removed by garbage collection,
+	 * but are still being freed in background.
+	 */
+	struct file_reclaim_stat reclaim;
+	file_reclaim_stat(&reclaim);
+	lua_pushstring(L, "unlink_backlog");
+	lua_createtable(L, 0, 2);
+	lua_pushstring(L, "files");
+	luaL_pushint64(L, reclaim.files);
+	lua_settable(L, -3);
+	lua_pushstring(L, "bytes");
+	luaL_pushint64(L, reclaim.bytes);
+	lua_settable(L, -3);
+	lua_settable(L, -3);
+
+	/*
+	 * Statistics of the last checkpoint: how long it took
+	 * and how fast the memtx snapshot was written.
+	 */
+	lua_pushstring(L, "checkpoint");
+	lua_createtable(L, 0, 4);
+	lua_pushstring(L, "duration");
+	lua_pushnumber(L, gc.checkpoint_duration);
+	lua_settable(L, -3);
+	lua_pushstring(L, "snap_size");
+	luaL_pushint64(L, memtx->snap_size);
+	lua_settable(L, -3);
+	lua_pushstring(L, "snap_write_time");
+	lua_pushnumber(L, memtx->snap_write_time);
+	lua_settable(L, -3);
+	lua_pushstring(L, "snap_write_rate");
+	lua_pushnumber(L, memtx->snap_write_time > 0 ?
+		       memtx->snap_size / memtx->snap_write_time : 0);
+	lua_settable(L, -3);
+	lua_settable(L, -3);
+
 	lua_pushstring(L, "checkpoints");
 	lua_newtable(L);
 
@@ -566,6 +659,34 @@ lbox_info_vinyl(struct lua_State *L)
 	return 1;
 }
 
+static int
+lbox_info_memtx_call(struct lua_State *L)
+{
+	struct info_handler h;
+	luaT_info_handler_create(&h, L);
+	struct memtx_engine *memtx =
+		(struct memtx_engine *)engine_by_name("memtx");
+	assert(memtx != NULL);
+	memtx_engine_stat(memtx, &h);
+	return 1;
+}
+
+static int
+lbox_info_memtx(struct lua_State *L)
+{
+	lua_newtable(L);
+
+	lua_newtable(L); /* metatable */
+
+	lua_pushstring(L, "__call");
+	lua_pushcfunction(L, lbox_info_memtx_call);
+	lua_settable(L, -3);
+
+	lua_setmetatable(L, -2);
+
+	return 1;
+}
+
 static int
 lbox_info_sql_call(struct lua_State *L)
 {
@@ -614,7 +735,7 @@ static int
 lbox_info_election(struct lua_State *L)
 {
 	struct raft *raft = box_raft();
-	lua_createtable(L, 0, 4);
+	lua_createtable(L, 0, 5);
 	lua_pushstring(L, raft_state_str(raft->state));
 	lua_setfield(L, -2, "state");
 	luaL_pushuint64(L, raft->volatile_term);
@@ -623,6 +744,24 @@ lbox_info_election(struct lua_State *L)
 	lua_setfield(L, -2, "vote");
 	lua_pushinteger(L, raft->leader);
 	lua_setfield(L, -2, "leader");
+
+	/* Time without a leader, in milliseconds. */
+	const struct histogram *hist = box_raft_latency_hist;
+	lua_createtable(L, 0, 2);
+	lua_pushinteger(L, hist->total);
+	lua_setfield(L, -2, "total");
+	lua_createtable(L, 0, hist->n_buckets);
+	for (size_t i = 0; i < hist->n_buckets; i++) {
+		const struct histogram_bucket *b = &hist->buckets[i];
+		if (b->max == INT64_MAX)
+			lua_pushstring(L, "inf");
+		else
+			lua_pushfstring(L, "le_%d", (int)b->max);
+		lua_pushinteger(L, b->count);
+		lua_settable(L, -3);
+	}
+	lua_setfield(L, -2, "histogram");
+	lua_setfield(L, -2, "latency");
 	return 1;
 }
 
@@ -647,6 +786,113 @@ lbox_info_synchro(struct lua_State *L)
 	return 1;
 }
 
+static int
+lbox_info_hot_standby(struct lua_State *L)
+{
+	const struct recovery *r = box_hot_standby;
+	if (r == NULL) {
+		lua_pushnil(L);
+		return 1;
+	}
+	lua_createtable(L, 0, 2);
+	/* Replay lag of the last recovered row, like upstream.lag. */
+	double lag = r->last_row_time > 0 ?
+		     r->last_row_time - r->last_row_tm : 0;
+	lua_pushnumber(L, lag);
+	lua_setfield(L, -2, "lag");
+	/* Time since the last row was recovered. */
+	double idle = r->last_row_time > 0 ?
+		      ev_now(loop()) - r->last_row_time : 0;
+	lua_pushnumber(L, idle);
+	lua_setfield(L, -2, "idle");
+	return 1;
+}
+
+static int
+lbox_info_log(struct lua_State *L)
+{
+	struct say_async_stat stat;
+	say_log_async_stat(&stat);
+
+	lua_createtable(L, 0, 2);
+	lua_pushboolean(L, say_log_async_is_enabled());
+	lua_setfield(L, -2, "async");
+
+	/* Asynchronous logger queue information. */
+	lua_createtable(L, 0, 3);
+	lua_pushnumber(L, stat.queue_size);
+	lua_setfield(L, -2, "size");
+	lua_pushnumber(L, stat.queue_used);
+	lua_setfield(L, -2, "used");
+	luaL_pushuint64(L, stat.dropped);
+	lua_setfield(L, -2, "dropped");
+	lua_setfield(L, -2, "queue");
+
+	return 1;
+}
+
+/**
+ * Return the NUMA node of @a cpu or -1 if it's unknown. Sysfs has
+ * a "nodeN" link in the directory of every CPU on NUMA systems.
+ */
+static int
+cpu_numa_node(int cpu)
+{
+	int node = -1;
+	DIR *dir = opendir(tt_sprintf("/sys/devices/system/cpu/cpu%d", cpu));
+	if (dir == NULL)
+		return -1;
+	struct dirent *entry;
+	while ((entry = readdir(dir)) != NULL) {
+		if (strncmp(entry->d_name, "node", 4) == 0 &&
+		    isdigit(entry->d_name[4])) {
+			node = atoi(entry->d_name + 4);
+			break;
+		}
+	}
+	closedir(dir);
+	return node;
+}
+
+/** Push the placement of a thread pinned to @a cpu. */
+static void
+lbox_info_push_cpu(struct lua_State *L, int cpu)
+{
+	lua_createtable(L, 0, 2);
+	lua_pushinteger(L, cpu);
+	lua_setfield(L, -2, "cpu");
+	int node = cpu_numa_node(cpu);
+	if (node >= 0) {
+		lua_pushinteger(L, node);
+		lua_setfield(L, -2, "numa_node");
+	}
+}
+
+static int
+lbox_info_affinity(struct lua_State *L)
+{
+	lua_createtable(L, 0, 3);
+	int cpu = box_tx_cpu();
+	if (cpu >= 0) {
+		lbox_info_push_cpu(L, cpu);
+		lua_setfield(L, -2, "tx");
+	}
+	cpu = wal_cpu();
+	if (cpu >= 0) {
+		lbox_info_push_cpu(L, cpu);
+		lua_setfield(L, -2, "wal");
+	}
+	lua_createtable(L, iproto_threads_count, 0);
+	for (int i = 0; i < iproto_threads_count; i++) {
+		cpu = iproto_thread_cpu(i);
+		if (cpu < 0)
+			continue;
+		lbox_info_push_cpu(L, cpu);
+		lua_rawseti(L, -2, i + 1);
+	}
+	lua_setfield(L, -2, "iproto");
+	return 1;
+}
 
 static const struct luaL_Reg lbox_info_dynamic_meta[] = {
 	{"id", lbox_info_id},
@@ -664,11 +910,15 @@ static const struct luaL_Reg lbox_info_dynamic_meta[] = {
 	{"cluster", lbox_info_cluster},
 	{"memory", lbox_info_memory},
 	{"gc", lbox_info_gc},
+	{"memtx", lbox_info_memtx},
 	{"vinyl", lbox_info_vinyl},
 	{"sql", lbox_info_sql},
 	{"listen", lbox_info_listen},
 	{"election", lbox_info_election},
 	{"synchro", lbox_info_synchro},
+	{"hot_standby", lbox_info_hot_standby},
+	{"log", lbox_info_log},
+	{"affinity", lbox_info_affinity},
 	{NULL, NULL}
 };
 
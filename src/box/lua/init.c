@@ -67,6 +67,8 @@
 #include "box/lua/key_def.h"
 #include "box/lua/merger.h"
 #include "box/lua/watcher.h"
+#include "box/lua/csv.h"
+#include "box/lua/read_view.h"
 
 #include "mpstream/mpstream.h"
 
@@ -364,16 +366,29 @@ static int
 lbox_backup_start(struct lua_State *L)
 {
 	int checkpoint_idx = 0;
-	if (lua_gettop(L) > 0) {
+	if (lua_gettop(L) > 0 && !lua_isnil(L, 1)) {
 		checkpoint_idx = luaL_checkint(L, 1);
 		if (checkpoint_idx < 0)
 			return luaL_error(L, "invalid checkpoint index");
 	}
+	int64_t base = -1;
+	if (lua_gettop(L) > 1 && !lua_isnil(L, 2)) {
+		if (!lua_istable(L, 2))
+			return luaL_error(L, "options should be a table");
+		lua_getfield(L, 2, "base");
+		if (!lua_isnil(L, -1)) {
+			base = luaL_checkint64(L, -1);
+			if (base < 0)
+				return luaL_error(L, "invalid base checkpoint");
+		}
+		lua_pop(L, 1);
+	}
 	lua_newtable(L);
 	struct lbox_backup_arg arg = {
 		.L = L,
 	};
-	if (box_backup_start(checkpoint_idx, lbox_backup_cb, &arg) != 0)
+	if (box_backup_start(checkpoint_idx, base, lbox_backup_cb,
+			     &arg) != 0)
 		return luaT_error(L);
 	return 1;
 }
@@ -480,6 +495,8 @@ box_lua_init(struct lua_State *L)
 	box_lua_xlog_init(L);
 	box_lua_sql_init(L);
 	box_lua_watcher_init(L);
+	box_lua_csv_init(L);
+	box_lua_read_view_init(L);
 	luaopen_net_box(L);
 	lua_pop(L, 1);
 	tarantool_lua_console_init(L);
@@ -45,7 +45,13 @@ local default_cfg = {
     slab_alloc_granularity = 8,
     slab_alloc_factor   = 1.05,
     iproto_threads      = 1,
+    iproto_reuseport    = false,
+    iproto_cpu_affinity = nil,
+    tx_cpu_affinity     = nil,
+    wal_cpu_affinity    = nil,
     memtx_allocator     = "small",
+    memtx_use_hugepages = false,
+    memtx_sort_threads  = 4,
     work_dir            = nil,
     memtx_dir           = ".",
     wal_dir             = ".",
@@ -53,6 +59,10 @@ local default_cfg = {
     vinyl_dir           = '.',
     vinyl_memory        = 128 * 1024 * 1024,
     vinyl_cache         = 128 * 1024 * 1024,
+    vinyl_page_cache    = 0,
+    vinyl_read_ahead    = 0,
+    vinyl_direct_io     = false,
+    vinyl_max_gap_locks = 10000,
     vinyl_max_tuple_size = 1024 * 1024,
     vinyl_read_threads  = 1,
     vinyl_write_threads = 4,
@@ -75,10 +85,15 @@ local default_cfg = {
     snap_io_rate_limit  = nil, -- no limit
     too_long_threshold  = 0.5,
     wal_mode            = "write",
+    io_backend          = "syscall",
     wal_max_size        = 256 * 1024 * 1024,
     wal_dir_rescan_delay= 2,
     wal_queue_max_size  = 16 * 1024 * 1024,
     wal_cleanup_delay   = 4 * 3600,
+    wal_group_commit_timeout = 0,
+    wal_group_commit_max_size = 1024 * 1024,
+    wal_group_commit_max_entries = 1024,
+    wal_ring_size       = 16 * 1024 * 1024,
     force_recovery      = false,
     replication         = nil,
     instance_uuid       = nil,
@@ -93,6 +108,8 @@ local default_cfg = {
     memtx_use_mvcc_engine = false,
     checkpoint_interval = 3600,
     checkpoint_wal_threshold = 1e18,
+    checkpoint_write_duration = 0,
+    checkpoint_lock     = nil,
     checkpoint_count    = 2,
     worker_pool_threads = 4,
     election_mode       = 'off',
@@ -100,11 +117,15 @@ local default_cfg = {
     replication_timeout = 1,
     replication_sync_lag = 10,
     replication_sync_timeout = 300,
+    replication_ack_interval = 0,
     replication_synchro_quorum = "N / 2 + 1",
     replication_synchro_timeout = 5,
     replication_connect_timeout = 30,
     replication_connect_quorum = nil, -- connect all
     replication_skip_conflict = false,
+    replication_apply_fibers = 1,
+    replication_compression = false,
+    replication_space_filter = nil, -- all spaces
     replication_anon      = false,
     feedback_enabled      = true,
     feedback_crashinfo    = true,
@@ -112,7 +133,11 @@ local default_cfg = {
     feedback_interval     = 3600,
     net_msg_max           = 768,
     sql_cache_size        = 5 * 1024 * 1024,
+    sql_plan_cache_size   = 5 * 1024 * 1024,
     txn_timeout           = 365 * 100 * 86400,
+    space_latency_stat    = false,
+    log_async             = false,
+    log_async_overflow    = 'drop',
 }
 
 -- cfg variables which are covered by modules
@@ -155,13 +180,23 @@ local template_cfg = {
     slab_alloc_granularity = 'number',
     slab_alloc_factor   = 'number',
     iproto_threads      = 'number',
+    iproto_reuseport    = 'boolean',
+    iproto_cpu_affinity = 'number, table',
+    tx_cpu_affinity     = 'number',
+    wal_cpu_affinity    = 'number',
     memtx_allocator     = 'string',
+    memtx_use_hugepages = 'boolean',
+    memtx_sort_threads  = 'number',
     work_dir            = 'string',
     memtx_dir            = 'string',
     wal_dir             = 'string',
     vinyl_dir           = 'string',
     vinyl_memory        = 'number',
     vinyl_cache               = 'number',
+    vinyl_page_cache          = 'number',
+    vinyl_read_ahead          = 'number',
+    vinyl_direct_io           = 'boolean',
+    vinyl_max_gap_locks       = 'number',
     vinyl_max_tuple_size      = 'number',
     vinyl_read_threads        = 'number',
     vinyl_write_threads       = 'number',
@@ -185,9 +220,14 @@ local template_cfg = {
     snap_io_rate_limit  = 'number',
     too_long_threshold  = 'number',
     wal_mode            = 'string',
+    io_backend          = 'string',
     wal_max_size        = 'number',
     wal_dir_rescan_delay= 'number',
     wal_cleanup_delay   = 'number',
+    wal_group_commit_timeout = 'number',
+    wal_group_commit_max_size = 'number',
+    wal_group_commit_max_entries = 'number',
+    wal_ring_size       = 'number',
     force_recovery      = 'boolean',
     replication         = 'string, number, table',
     instance_uuid       = 'string',
@@ -199,6 +239,8 @@ local template_cfg = {
     coredump            = 'boolean',
     checkpoint_interval = 'number',
     checkpoint_wal_threshold = 'number',
+    checkpoint_write_duration = 'number',
+    checkpoint_lock     = 'string',
     wal_queue_max_size  = 'number',
     checkpoint_count    = 'number',
     read_only           = 'boolean',
@@ -210,11 +252,15 @@ local template_cfg = {
     replication_timeout = 'number',
     replication_sync_lag = 'number',
     replication_sync_timeout = 'number',
+    replication_ack_interval = 'number',
     replication_synchro_quorum = 'string, number',
     replication_synchro_timeout = 'number',
     replication_connect_timeout = 'number',
     replication_connect_quorum = 'number',
     replication_skip_conflict = 'boolean',
+    replication_apply_fibers = 'number',
+    replication_compression = 'boolean',
+    replication_space_filter = 'number, table',
     replication_anon      = 'boolean',
     feedback_enabled      = ifdef_feedback('boolean'),
     feedback_crashinfo    = ifdef_feedback('boolean'),
@@ -222,7 +268,11 @@ local template_cfg = {
     feedback_interval     = ifdef_feedback('number'),
     net_msg_max           = 'number',
     sql_cache_size        = 'number',
+    sql_plan_cache_size   = 'number',
     txn_timeout           = 'number',
+    space_latency_stat    = 'boolean',
+    log_async             = 'boolean',
+    log_async_overflow    = 'string',
 }
 
 local function normalize_uri_list_for_replication(port_list)
@@ -298,10 +348,16 @@ local dynamic_cfg = {
     vinyl_memory            = private.cfg_set_vinyl_memory,
     vinyl_max_tuple_size    = private.cfg_set_vinyl_max_tuple_size,
     vinyl_cache             = private.cfg_set_vinyl_cache,
+    vinyl_page_cache        = private.cfg_set_vinyl_page_cache,
+    vinyl_read_ahead        = private.cfg_set_vinyl_read_ahead,
+    vinyl_direct_io         = private.cfg_set_vinyl_direct_io,
+    vinyl_max_gap_locks     = private.cfg_set_vinyl_max_gap_locks,
     vinyl_timeout           = private.cfg_set_vinyl_timeout,
     checkpoint_count        = private.cfg_set_checkpoint_count,
     checkpoint_interval     = private.cfg_set_checkpoint_interval,
     checkpoint_wal_threshold = private.cfg_set_checkpoint_wal_threshold,
+    checkpoint_write_duration = private.cfg_set_checkpoint_write_duration,
+    checkpoint_lock         = private.cfg_set_checkpoint_lock,
     wal_queue_max_size      = private.cfg_set_wal_queue_max_size,
     worker_pool_threads     = private.cfg_set_worker_pool_threads,
     feedback_enabled        = ifdef_feedback_set_params,
@@ -311,6 +367,10 @@ local dynamic_cfg = {
     -- do nothing, affects new replicas, which query this value on start
     wal_dir_rescan_delay    = function() end,
     wal_cleanup_delay       = private.cfg_set_wal_cleanup_delay,
+    wal_group_commit_timeout = private.cfg_set_wal_group_commit,
+    wal_group_commit_max_size = private.cfg_set_wal_group_commit,
+    wal_group_commit_max_entries = private.cfg_set_wal_group_commit,
+    wal_ring_size           = private.cfg_set_wal_ring_size,
     custom_proc_title       = function()
         require('title').update(box.cfg.custom_proc_title)
     end,
@@ -322,15 +382,22 @@ local dynamic_cfg = {
     replication_connect_quorum = private.cfg_set_replication_connect_quorum,
     replication_sync_lag    = private.cfg_set_replication_sync_lag,
     replication_sync_timeout = private.cfg_set_replication_sync_timeout,
+    replication_ack_interval = private.cfg_set_replication_ack_interval,
     replication_synchro_quorum = private.cfg_set_replication_synchro_quorum,
     replication_synchro_timeout = private.cfg_set_replication_synchro_timeout,
     replication_skip_conflict = private.cfg_set_replication_skip_conflict,
+    replication_apply_fibers = private.cfg_set_replication_apply_fibers,
+    replication_compression = private.cfg_set_replication_compression,
     replication_anon        = private.cfg_set_replication_anon,
     instance_uuid           = check_instance_uuid,
     replicaset_uuid         = check_replicaset_uuid,
     net_msg_max             = private.cfg_set_net_msg_max,
     sql_cache_size          = private.cfg_set_sql_cache_size,
+    sql_plan_cache_size     = private.cfg_set_sql_plan_cache_size,
     txn_timeout             = private.cfg_set_txn_timeout,
+    space_latency_stat      = private.cfg_set_space_latency_stat,
+    log_async               = private.cfg_set_log_async,
+    log_async_overflow      = private.cfg_set_log_async_overflow,
 }
 
 -- dynamically settable options, which should be reverted in case
@@ -407,6 +474,10 @@ local dynamic_cfg_skip_at_load = {
     vinyl_memory            = true,
     vinyl_max_tuple_size    = true,
     vinyl_cache             = true,
+    vinyl_page_cache        = true,
+    vinyl_read_ahead        = true,
+    vinyl_direct_io         = true,
+    vinyl_max_gap_locks     = true,
     vinyl_timeout           = true,
     too_long_threshold      = true,
     election_mode           = true,
@@ -417,9 +488,12 @@ local dynamic_cfg_skip_at_load = {
     replication_connect_quorum = true,
     replication_sync_lag    = true,
     replication_sync_timeout = true,
+    replication_ack_interval = true,
     replication_synchro_quorum = true,
     replication_synchro_timeout = true,
     replication_skip_conflict = true,
+    replication_apply_fibers = true,
+    replication_compression = true,
     replication_anon        = true,
     wal_dir_rescan_delay    = true,
     custom_proc_title       = true,
@@ -433,6 +433,11 @@ static int
 luaL_merge_source_buffer_next(struct merge_source *base,
 			      struct tuple_format *format,
 			      struct tuple **out);
+static int
+luaL_merge_source_buffer_next_batch(struct merge_source *base,
+				    struct tuple_format *format,
+				    struct tuple **out, uint32_t size,
+				    uint32_t *count);
 
 /* Non-virtual methods */
 
@@ -449,6 +454,7 @@ luaL_merge_source_buffer_new(struct lua_State *L)
 	static struct merge_source_vtab merge_source_buffer_vtab = {
 		.destroy = luaL_merge_source_buffer_destroy,
 		.next = luaL_merge_source_buffer_next,
+		.next_batch = luaL_merge_source_buffer_next_batch,
 	};
 
 	struct merge_source_buffer *source = malloc(
@@ -607,6 +613,43 @@ luaL_merge_source_buffer_next(struct merge_source *base,
 	return 0;
 }
 
+/**
+ * next_batch() virtual method implementation for a buffer
+ * source.
+ *
+ * A next chunk is fetched only for the first tuple of a batch,
+ * the rest are decoded from the current chunk, so a batch never
+ * calls a user provided function more than once.
+ *
+ * @see struct merge_source_vtab
+ */
+static int
+luaL_merge_source_buffer_next_batch(struct merge_source *base,
+				    struct tuple_format *format,
+				    struct tuple **out, uint32_t size,
+				    uint32_t *count)
+{
+	struct merge_source_buffer *source = container_of(base,
+		struct merge_source_buffer, base);
+
+	*count = 0;
+	if (luaL_merge_source_buffer_next(base, format, &out[0]) != 0)
+		return -1;
+	if (out[0] == NULL)
+		return 0;
+	uint32_t i = 1;
+	for (; i < size && source->remaining_tuple_count > 0; ++i) {
+		if (luaL_merge_source_buffer_next(base, format, &out[i]) != 0)
+			goto error;
+	}
+	*count = i;
+	return 0;
+error:
+	for (uint32_t j = 0; j < i; ++j)
+		tuple_unref(out[j]);
+	return -1;
+}
+
 /* Lua functions */
 
 /**
@@ -31,6 +31,7 @@
 #include "box/lua/misc.h"
 
 #include "fiber.h" /* fiber->gc() */
+#include <small/ibuf.h>
 #include <small/region.h>
 #include "lua/utils.h"
 #include "lua/msgpack.h"
@@ -98,13 +99,54 @@ port_msgpack_dump_lua(struct port *base, struct lua_State *L, bool is_flat)
 
 /** {{{ Lua/C implementation of index:select(): used only by Vinyl **/
 
+/**
+ * Encode the content of a C port as a MsgPack array and append it
+ * to @a buf. Returns the number of bytes written or -1 on memory
+ * allocation error.
+ */
+static ssize_t
+port_c_dump_ibuf(struct port *base, struct ibuf *buf)
+{
+	struct port_c *port = (struct port_c *)base;
+	size_t size = mp_sizeof_array(port->size);
+	struct port_c_entry *pe;
+	for (pe = port->first; pe != NULL; pe = pe->next)
+		size += pe->mp_size == 0 ? tuple_bsize(pe->tuple) :
+			pe->mp_size;
+	char *data = (char *)ibuf_alloc(buf, size);
+	if (data == NULL) {
+		diag_set(OutOfMemory, size, "ibuf_alloc", "data");
+		return -1;
+	}
+	char *pos = mp_encode_array(data, port->size);
+	for (pe = port->first; pe != NULL; pe = pe->next) {
+		if (pe->mp_size == 0) {
+			uint32_t bsize = tuple_bsize(pe->tuple);
+			memcpy(pos, tuple_data(pe->tuple), bsize);
+			pos += bsize;
+		} else {
+			memcpy(pos, pe->mp, pe->mp_size);
+			pos += pe->mp_size;
+		}
+	}
+	assert(pos == data + size);
+	return size;
+}
+
 static int
 lbox_select(lua_State *L)
 {
-	if (lua_gettop(L) != 6 || !lua_isnumber(L, 1) || !lua_isnumber(L, 2) ||
-		!lua_isnumber(L, 3) || !lua_isnumber(L, 4) || !lua_isnumber(L, 5)) {
+	int top = lua_gettop(L);
+	if ((top != 6 && top != 7) || !lua_isnumber(L, 1) ||
+	    !lua_isnumber(L, 2) || !lua_isnumber(L, 3) ||
+	    !lua_isnumber(L, 4) || !lua_isnumber(L, 5)) {
 		return luaL_error(L, "Usage index:select(iterator, offset, "
-				  "limit, key)");
+				  "limit, key[, buffer])");
+	}
+	struct ibuf *buf = NULL;
+	if (top == 7 && (buf = luaT_toibuf(L, 7)) == NULL) {
+		return luaL_error(L, "Usage index:select(iterator, offset, "
+				  "limit, key[, buffer])");
 	}
 
 	uint32_t space_id = lua_tonumber(L, 1);
@@ -121,6 +163,14 @@ lbox_select(lua_State *L)
 		       key, key + key_len, &port) != 0) {
 		return luaT_error(L);
 	}
+	if (buf != NULL) {
+		ssize_t size = port_c_dump_ibuf(&port, buf);
+		port_destroy(&port);
+		if (size < 0)
+			return luaT_error(L);
+		lua_pushinteger(L, size);
+		return 1; /* number of bytes written to the buffer */
+	}
 
 	/*
 	 * Lua may raise an exception during allocating table or pushing
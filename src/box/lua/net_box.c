@@ -44,6 +44,7 @@
 
 #include "box/iproto_constants.h"
 #include "box/iproto_features.h"
+#include "box/iproto_compress.h"
 #include "box/lua/tuple.h" /* luamp_convert_tuple() / luamp_convert_key() */
 #include "box/xrow.h"
 #include "box/tuple.h"
@@ -112,6 +113,7 @@ enum netbox_method {
 	NETBOX_COMMIT      = 18,
 	NETBOX_ROLLBACK    = 19,
 	NETBOX_INJECT      = 20,
+	NETBOX_CALL_PREPARED = 21,
 	netbox_method_MAX
 };
 
@@ -154,8 +156,29 @@ struct netbox_options {
 	 * reconnect, in seconds. Reconnect is disabled if it's 0.
 	 */
 	double reconnect_after;
+	/**
+	 * If set, ask the server to compress its output
+	 * (see IPROTO_FEATURE_COMPRESSION).
+	 */
+	bool compression;
+	/**
+	 * If set, share the fetched schema with other connections of
+	 * this process to the same instance and user, see
+	 * netbox_schema_cache_ref.
+	 */
+	bool schema_cache;
 };
 
+/**
+ * Lua reference to the table with schemas fetched by connections
+ * that have the schema_cache option set. Maps "<instance uuid>:<user>"
+ * to an array {schema_version, spaces, indices, collations}. If a
+ * connection learns from a response that the schema version of the
+ * remote instance matches the cached one, it installs the cached
+ * schema instead of fetching it again.
+ */
+static int netbox_schema_cache_ref = LUA_NOREF;
+
 /**
  * Basically, *transport* is a TCP connection speaking the Tarantool
  * network protocol (IPROTO). This is a low-level interface.
@@ -234,12 +257,27 @@ struct netbox_transport {
 	struct ibuf send_buf;
 	/** Connection receive buffer. */
 	struct ibuf recv_buf;
+	/**
+	 * Set if the server compresses its output. If it does, the
+	 * input is read into compressed_buf and then decompressed
+	 * into recv_buf.
+	 */
+	bool is_compressed;
+	/** Compressed input that hasn't been decompressed yet. */
+	struct ibuf compressed_buf;
+	/** Decompression context. */
+	struct iproto_decompressor decompressor;
 	/** Signalled when send_buf becomes empty. */
 	struct fiber_cond on_send_buf_empty;
 	/** Next request id. */
 	uint64_t next_sync;
 	/** sync -> netbox_request */
 	struct mh_i64ptr_t *requests;
+	/**
+	 * The last schema version of the remote instance seen in a
+	 * response before fetching the schema or 0 if unknown.
+	 */
+	uint32_t peer_schema_version;
 };
 
 struct netbox_request {
@@ -282,6 +320,15 @@ struct netbox_request {
 	/** Lua references to on_push trigger and its context. */
 	int on_push_ref;
 	int on_push_ctx_ref;
+	/**
+	 * Data of the IPROTO_CHUNK packets of a SELECT response
+	 * received so far (see IPROTO_FEATURE_CHUNKED_RESPONSES).
+	 * It starts with a body header reserved for the whole result,
+	 * followed by the tuples.
+	 */
+	struct ibuf chunks;
+	/** Number of tuples stored in chunks. */
+	uint32_t chunk_count;
 	/**
 	 * Lua reference to a table with user-defined fields.
 	 * We allow the user to attach extra information to a future object,
@@ -329,6 +376,7 @@ netbox_request_destroy(struct netbox_request *request)
 	luaL_unref(tarantool_L, LUA_REGISTRYINDEX, request->index_ref);
 	if (request->error != NULL)
 		error_unref(request->error);
+	ibuf_destroy(&request->chunks);
 }
 
 /**
@@ -469,9 +517,14 @@ netbox_transport_create(struct netbox_transport *transport)
 	iostream_clear(&transport->io);
 	ibuf_create(&transport->send_buf, &cord()->slabc, NETBOX_READAHEAD);
 	ibuf_create(&transport->recv_buf, &cord()->slabc, NETBOX_READAHEAD);
+	transport->is_compressed = false;
+	ibuf_create(&transport->compressed_buf, &cord()->slabc,
+		    NETBOX_READAHEAD);
+	iproto_decompressor_create(&transport->decompressor);
 	fiber_cond_create(&transport->on_send_buf_empty);
 	transport->next_sync = 1;
 	transport->requests = mh_i64ptr_new();
+	transport->peer_schema_version = 0;
 }
 
 static void
@@ -487,6 +540,8 @@ netbox_transport_destroy(struct netbox_transport *transport)
 	assert(!iostream_is_initialized(&transport->io));
 	assert(ibuf_used(&transport->send_buf) == 0);
 	assert(ibuf_used(&transport->recv_buf) == 0);
+	assert(ibuf_used(&transport->compressed_buf) == 0);
+	iproto_decompressor_destroy(&transport->decompressor);
 	fiber_cond_destroy(&transport->on_send_buf_empty);
 	struct mh_i64ptr_t *h = transport->requests;
 	assert(mh_size(h) == 0);
@@ -524,6 +579,8 @@ netbox_transport_set_error(struct netbox_transport *transport)
 	/* Reset buffers. */
 	ibuf_reinit(&transport->send_buf);
 	ibuf_reinit(&transport->recv_buf);
+	ibuf_reinit(&transport->compressed_buf);
+	transport->is_compressed = false;
 	fiber_cond_broadcast(&transport->on_send_buf_empty);
 	/* Complete requests and clean up the hash. */
 	struct mh_i64ptr_t *h = transport->requests;
@@ -607,19 +664,21 @@ netbox_encode_ping(lua_State *L, int idx, struct mpstream *stream,
 
 /**
  * Encodes an id request and writes it to the provided buffer.
+ * If compression is set, requests compression of the server output.
  * Raises a Lua error on memory allocation failure.
  */
 static void
-netbox_encode_id(struct lua_State *L, struct ibuf *ibuf, uint64_t sync)
+netbox_encode_id(struct lua_State *L, struct ibuf *ibuf, uint64_t sync,
+		 bool compression)
 {
-	struct iproto_features *features = &NETBOX_IPROTO_FEATURES;
+	struct iproto_features features_value = NETBOX_IPROTO_FEATURES;
+	struct iproto_features *features = &features_value;
+	if (compression)
+		iproto_features_set(features, IPROTO_FEATURE_COMPRESSION);
 #ifndef NDEBUG
-	struct iproto_features features_value;
 	struct errinj *errinj = errinj(ERRINJ_NETBOX_FLIP_FEATURE, ERRINJ_INT);
 	if (errinj->iparam >= 0 && errinj->iparam < iproto_feature_id_MAX) {
 		int feature_id = errinj->iparam;
-		features_value = *features;
-		features = &features_value;
 		if (iproto_features_test(features, feature_id))
 			iproto_features_clear(features, feature_id);
 		else
@@ -727,6 +786,28 @@ netbox_encode_call(lua_State *L, int idx, struct mpstream *stream,
 	netbox_encode_call_impl(L, idx, stream, sync, IPROTO_CALL, stream_id);
 }
 
+/**
+ * Encodes a CALL request using the body prefix built by
+ * luaT_netbox_encode_call_prefix() so that only the arguments
+ * have to be encoded on each call.
+ */
+static void
+netbox_encode_call_prepared(lua_State *L, int idx, struct mpstream *stream,
+			    uint64_t sync, uint64_t stream_id)
+{
+	/* Lua stack at idx: body_prefix, args */
+	size_t svp = netbox_begin_encode(stream, sync, IPROTO_CALL, stream_id);
+
+	size_t prefix_len;
+	const char *prefix = lua_tolstring(L, idx, &prefix_len);
+	mpstream_memcpy(stream, prefix, prefix_len);
+
+	/* encode args */
+	luamp_encode_tuple(L, cfg, stream, idx + 1);
+
+	netbox_end_encode(stream, svp);
+}
+
 static void
 netbox_encode_eval(lua_State *L, int idx, struct mpstream *stream,
 		   uint64_t sync, uint64_t stream_id)
@@ -996,24 +1077,32 @@ netbox_transport_communicate(struct netbox_transport *transport, size_t limit)
 	struct ibuf *send_buf = &transport->send_buf;
 	struct ibuf *recv_buf = &transport->recv_buf;
 	struct fiber_cond *on_send_buf_empty = &transport->on_send_buf_empty;
+	bool is_write_deferred = false;
 	while (true) {
 		/* reader serviced first */
 		int events = 0;
 		while (ibuf_used(recv_buf) < limit) {
-			void *p = ibuf_reserve(recv_buf, NETBOX_READAHEAD);
+			struct ibuf *buf = transport->is_compressed ?
+					   &transport->compressed_buf :
+					   recv_buf;
+			void *p = ibuf_reserve(buf, NETBOX_READAHEAD);
 			if (p == NULL) {
 				diag_set(OutOfMemory, NETBOX_READAHEAD,
 					 "ibuf_reserve", "p");
 				return -1;
 			}
-			ssize_t rc = iostream_read(io, recv_buf->wpos,
-						   ibuf_unused(recv_buf));
+			ssize_t rc = iostream_read(io, buf->wpos,
+						   ibuf_unused(buf));
 			if (rc == 0) {
 				box_error_raise(ER_NO_CONNECTION,
 						"Peer closed");
 				return -1;
 			} if (rc > 0) {
-				recv_buf->wpos += rc;
+				buf->wpos += rc;
+				if (buf != recv_buf &&
+				    iproto_decompress(&transport->decompressor,
+						      buf, recv_buf) != 0)
+					return -1;
 			} else if (rc == IOSTREAM_ERROR) {
 				goto io_error;
 			} else {
@@ -1023,6 +1112,17 @@ netbox_transport_communicate(struct netbox_transport *transport, size_t limit)
 		}
 		if (ibuf_used(recv_buf) >= limit)
 			return 0;
+		if (ibuf_used(send_buf) > 0 && !is_write_deferred) {
+			/*
+			 * Let fibers that are ready to run append their
+			 * requests to the send buffer so that they are sent
+			 * with one write.
+			 */
+			is_write_deferred = true;
+			fiber_reschedule();
+			continue;
+		}
+		is_write_deferred = false;
 		while (ibuf_used(send_buf) > 0) {
 			ssize_t rc = iostream_write(io, send_buf->rpos,
 						    ibuf_used(send_buf));
@@ -1167,13 +1267,23 @@ netbox_encode_begin(struct lua_State *L, int idx, struct mpstream *stream,
 		    uint64_t sync, uint64_t stream_id)
 {
 	size_t svp = netbox_begin_encode(stream, sync, IPROTO_BEGIN, stream_id);
-	if (!lua_isnoneornil(L, idx)) {
+	/* Lua stack at idx: timeout, isolation */
+	bool has_timeout = !lua_isnoneornil(L, idx);
+	bool has_isolation = !lua_isnoneornil(L, idx + 1);
+	if (has_timeout || has_isolation)
+		mpstream_encode_map(stream, has_timeout + has_isolation);
+	if (has_timeout) {
 		assert(lua_type(L, idx) == LUA_TNUMBER);
 		double timeout = lua_tonumber(L, idx);
-		mpstream_encode_map(stream, 1);
 		mpstream_encode_uint(stream, IPROTO_TIMEOUT);
 		mpstream_encode_double(stream, timeout);
 	}
+	if (has_isolation) {
+		assert(lua_type(L, idx + 1) == LUA_TNUMBER);
+		uint32_t isolation = lua_tointeger(L, idx + 1);
+		mpstream_encode_uint(stream, IPROTO_TXN_ISOLATION);
+		mpstream_encode_uint(stream, isolation);
+	}
 	netbox_end_encode(stream, svp);
 }
 
@@ -1240,6 +1350,7 @@ netbox_encode_method(struct lua_State *L, int idx, enum netbox_method method,
 		[NETBOX_COMMIT]         = netbox_encode_commit,
 		[NETBOX_ROLLBACK]       = netbox_encode_rollback,
 		[NETBOX_INJECT]		= netbox_encode_inject,
+		[NETBOX_CALL_PREPARED]	= netbox_encode_call_prepared,
 	};
 	struct mpstream stream;
 	mpstream_init(&stream, ibuf, ibuf_reserve_cb, ibuf_alloc_cb,
@@ -1664,6 +1775,7 @@ netbox_decode_method(struct lua_State *L, enum netbox_method method,
 		[NETBOX_COMMIT]         = netbox_decode_nil,
 		[NETBOX_ROLLBACK]       = netbox_decode_nil,
 		[NETBOX_INJECT]		= netbox_decode_table,
+		[NETBOX_CALL_PREPARED]	= netbox_decode_table,
 	};
 	method_decoder[method](L, data, data_end, return_raw, format);
 }
@@ -1941,16 +2053,42 @@ luaT_netbox_request_pairs(struct lua_State *L)
 	return 3;
 }
 
+/**
+ * Takes a function name and pushes a string containing the beginning
+ * of a CALL request body for it: the body map header, the function
+ * name, and the arguments key. Used by prepared calls, which send the
+ * string as is followed by the encoded arguments.
+ */
+static int
+luaT_netbox_encode_call_prefix(struct lua_State *L)
+{
+	size_t name_len;
+	const char *name = luaL_checklstring(L, 1, &name_len);
+	char header[16];
+	luaL_Buffer b;
+	luaL_buffinit(L, &b);
+	char *pos = mp_encode_map(header, 2);
+	pos = mp_encode_uint(pos, IPROTO_FUNCTION_NAME);
+	pos = mp_encode_strl(pos, name_len);
+	luaL_addlstring(&b, header, pos - header);
+	luaL_addlstring(&b, name, name_len);
+	pos = mp_encode_uint(header, IPROTO_TUPLE);
+	luaL_addlstring(&b, header, pos - header);
+	luaL_pushresult(&b);
+	return 1;
+}
+
 /**
  * Creates a netbox transport object (userdata) and pushes it to Lua stack.
  * Takes the following arguments: uri (string, number, or table),
  * user (string or nil), password (string or nil), callback (function),
- * connect_timeout (number or nil), reconnect_after (number or nil).
+ * connect_timeout (number or nil), reconnect_after (number or nil),
+ * compression (boolean or nil), schema_cache (boolean or nil).
  */
 static int
 luaT_netbox_new_transport(struct lua_State *L)
 {
-	assert(lua_gettop(L) == 6);
+	assert(lua_gettop(L) == 8);
 	/* Create a transport object. */
 	struct netbox_transport *transport;
 	transport = lua_newuserdata(L, sizeof(*transport));
@@ -1972,6 +2110,8 @@ luaT_netbox_new_transport(struct lua_State *L)
 		opts->connect_timeout = luaL_checknumber(L, 5);
 	if (!lua_isnil(L, 6))
 		opts->reconnect_after = luaL_checknumber(L, 6);
+	opts->compression = lua_toboolean(L, 7);
+	opts->schema_cache = lua_toboolean(L, 8);
 	if (opts->user == NULL && opts->password != NULL) {
 		diag_set(ClientError, ER_PROC_LUA,
 			 "net.box: user is not defined");
@@ -2057,6 +2197,8 @@ luaT_netbox_transport_make_request(struct lua_State *L, int idx,
 		request->format = tuple_format_runtime;
 	tuple_format_ref(request->format);
 	fiber_cond_create(&request->cond);
+	ibuf_create(&request->chunks, &cord()->slabc, NETBOX_READAHEAD);
+	request->chunk_count = 0;
 	request->index_ref = LUA_NOREF;
 	request->result_ref = LUA_NOREF;
 	request->error = NULL;
@@ -2214,6 +2356,62 @@ netbox_transport_on_event(struct netbox_transport *transport,
 	lua_call(L, watch.data != NULL ? 3 : 2, 0);
 }
 
+/** Returns true if the method is sent in an IPROTO_SELECT request. */
+static inline bool
+netbox_method_is_select(enum netbox_method method)
+{
+	return method == NETBOX_SELECT || method == NETBOX_GET ||
+	       method == NETBOX_MIN || method == NETBOX_MAX;
+}
+
+enum {
+	/** Size of a SELECT response body header: map, key, array32. */
+	NETBOX_SELECT_BODY_HEADER_SIZE = 7,
+};
+
+/**
+ * Appends the tuples of an IPROTO_CHUNK packet of a SELECT response
+ * to the request. Raises a Lua error on memory allocation failure.
+ */
+static void
+netbox_request_add_chunk(struct netbox_request *request, struct lua_State *L,
+			 const char *data, const char *data_end)
+{
+	size_t size = NETBOX_SELECT_BODY_HEADER_SIZE;
+	if (ibuf_used(&request->chunks) == 0 &&
+	    ibuf_alloc(&request->chunks, size) == NULL)
+		luaL_error(L, "out of memory");
+	netbox_skip_to_data(&data);
+	request->chunk_count += mp_decode_array(&data);
+	size = data_end - data;
+	void *p = ibuf_alloc(&request->chunks, size);
+	if (p == NULL)
+		luaL_error(L, "out of memory");
+	memcpy(p, data, size);
+}
+
+/**
+ * Appends the tuples of the final packet of a chunked SELECT
+ * response to the request and makes @a data and @a data_end point
+ * to the body of the whole response assembled in the request.
+ * Raises a Lua error on memory allocation failure.
+ */
+static void
+netbox_request_finish_chunks(struct netbox_request *request,
+			     struct lua_State *L, const char **data,
+			     const char **data_end)
+{
+	netbox_request_add_chunk(request, L, *data, *data_end);
+	char *pos = request->chunks.rpos;
+	pos = mp_encode_map(pos, 1);
+	pos = mp_encode_uint(pos, IPROTO_DATA);
+	pos = mp_store_u8(pos, 0xdd);
+	pos = mp_store_u32(pos, request->chunk_count);
+	assert(pos == request->chunks.rpos + NETBOX_SELECT_BODY_HEADER_SIZE);
+	*data = request->chunks.rpos;
+	*data_end = request->chunks.wpos;
+}
+
 /**
  * Given a netbox transport and a response header, decodes the response and
  * either completes the request or invokes the on-push trigger, depending on
@@ -2247,6 +2445,16 @@ netbox_transport_dispatch_response(struct netbox_transport *transport,
 	}
 	const char *data = hdr->body[0].iov_base;
 	const char *data_end = data + hdr->body[0].iov_len;
+	if (netbox_method_is_select(request->method)) {
+		/* See IPROTO_FEATURE_CHUNKED_RESPONSES. */
+		if (status == IPROTO_CHUNK) {
+			netbox_request_add_chunk(request, L, data, data_end);
+			return;
+		}
+		if (ibuf_used(&request->chunks) > 0)
+			netbox_request_finish_chunks(request, L, &data,
+						     &data_end);
+	}
 	if (request->buffer != NULL) {
 		/* Copy xrow.body to user-provided buffer. */
 		if (request->skip_header)
@@ -2290,6 +2498,37 @@ netbox_transport_dispatch_response(struct netbox_transport *transport,
 	}
 }
 
+/**
+ * Switches the transport to reading compressed input. Called after
+ * the reply to an IPROTO_ID request enabling compression has been
+ * received: all the input following it comes in chunks.
+ * Raises a Lua error on memory allocation failure.
+ */
+static void
+netbox_transport_enable_compression(struct netbox_transport *transport,
+				    struct lua_State *L)
+{
+	assert(!transport->is_compressed);
+	struct ibuf *recv_buf = &transport->recv_buf;
+	struct ibuf *compressed_buf = &transport->compressed_buf;
+	assert(ibuf_used(compressed_buf) == 0);
+	/* The input read past the reply is compressed. */
+	size_t size = ibuf_used(recv_buf);
+	if (size > 0) {
+		void *p = ibuf_alloc(compressed_buf, size);
+		if (p == NULL) {
+			diag_set(OutOfMemory, size, "ibuf_alloc", "p");
+			luaT_error(L);
+		}
+		memcpy(p, recv_buf->rpos, size);
+		recv_buf->rpos += size;
+	}
+	transport->is_compressed = true;
+	if (iproto_decompress(&transport->decompressor, compressed_buf,
+			      recv_buf) != 0)
+		luaT_error(L);
+}
+
 /**
  * Performs a features request for an iproto connection.
  * If the server doesn't support the IPROTO_ID command, assumes the protocol
@@ -2307,7 +2546,8 @@ netbox_transport_do_id(struct netbox_transport *transport, struct lua_State *L)
 	ERROR_INJECT(ERRINJ_NETBOX_DISABLE_ID, goto out);
 	if (peer_version_id < version_id(2, 10, 0))
 		goto unsupported;
-	netbox_encode_id(L, &transport->send_buf, transport->next_sync++);
+	netbox_encode_id(L, &transport->send_buf, transport->next_sync++,
+			 transport->opts.compression);
 	struct xrow_header hdr;
 	if (netbox_transport_send_and_recv(transport, &hdr) != 0)
 		luaT_error(L);
@@ -2320,6 +2560,10 @@ netbox_transport_do_id(struct netbox_transport *transport, struct lua_State *L)
 	}
 	if (xrow_decode_id(&hdr, &id) != 0)
 		luaT_error(L);
+	transport->peer_schema_version = hdr.schema_version;
+	if (transport->opts.compression &&
+	    iproto_features_test(&id.features, IPROTO_FEATURE_COMPRESSION))
+		netbox_transport_enable_compression(transport, L);
 out:
 	/* Invoke the 'handshake' callback. */
 	lua_rawgeti(L, LUA_REGISTRYINDEX, transport->opts.callback_ref);
@@ -2370,6 +2614,80 @@ netbox_transport_do_auth(struct netbox_transport *transport,
 		xrow_decode_error(&hdr);
 		luaT_error(L);
 	}
+	transport->peer_schema_version = hdr.schema_version;
+}
+
+/**
+ * Pushes the key of the transport in the schema cache to Lua stack.
+ */
+static void
+netbox_transport_push_schema_cache_key(struct netbox_transport *transport,
+				       struct lua_State *L)
+{
+	const char *user = transport->opts.user;
+	lua_pushfstring(L, "%s:%s", tt_uuid_str(&transport->greeting.uuid),
+			user != NULL ? user : "guest");
+}
+
+/**
+ * If the schema cache has the schema of the version last seen by the
+ * transport, invokes the 'did_fetch_schema' callback with it and returns
+ * true. Otherwise returns false.
+ */
+static bool
+netbox_transport_install_cached_schema(struct netbox_transport *transport,
+				       struct lua_State *L)
+{
+	if (!transport->opts.schema_cache ||
+	    transport->peer_schema_version == 0)
+		return false;
+	lua_rawgeti(L, LUA_REGISTRYINDEX, netbox_schema_cache_ref);
+	netbox_transport_push_schema_cache_key(transport, L);
+	lua_rawget(L, -2);
+	if (lua_isnil(L, -1)) {
+		lua_pop(L, 2);
+		return false;
+	}
+	int entry_idx = lua_gettop(L);
+	lua_rawgeti(L, entry_idx, 1);
+	uint32_t schema_version = lua_tointeger(L, -1);
+	lua_pop(L, 1);
+	if (schema_version != transport->peer_schema_version) {
+		lua_pop(L, 2);
+		return false;
+	}
+	lua_rawgeti(L, LUA_REGISTRYINDEX, transport->opts.callback_ref);
+	lua_pushliteral(L, "did_fetch_schema");
+	lua_pushinteger(L, schema_version);
+	lua_rawgeti(L, entry_idx, 2);
+	lua_rawgeti(L, entry_idx, 3);
+	lua_rawgeti(L, entry_idx, 4);
+	lua_call(L, 5, 0);
+	lua_pop(L, 2);
+	return true;
+}
+
+/**
+ * Stores the schema table at the given stack index in the schema cache.
+ */
+static void
+netbox_transport_cache_schema(struct netbox_transport *transport,
+			      struct lua_State *L, uint32_t schema_version,
+			      int schema_table_idx)
+{
+	lua_rawgeti(L, LUA_REGISTRYINDEX, netbox_schema_cache_ref);
+	netbox_transport_push_schema_cache_key(transport, L);
+	lua_createtable(L, 4, 0);
+	lua_pushinteger(L, schema_version);
+	lua_rawseti(L, -2, 1);
+	lua_rawgeti(L, schema_table_idx, BOX_VSPACE_ID);
+	lua_rawseti(L, -2, 2);
+	lua_rawgeti(L, schema_table_idx, BOX_VINDEX_ID);
+	lua_rawseti(L, -2, 3);
+	lua_rawgeti(L, schema_table_idx, BOX_VCOLLATION_ID);
+	lua_rawseti(L, -2, 4);
+	lua_rawset(L, -3);
+	lua_pop(L, 1);
 }
 
 /**
@@ -2377,6 +2695,9 @@ netbox_transport_do_auth(struct netbox_transport *transport,
  * processes other requests in a loop, like netbox_transport_process_requests().
  * On success invokes the 'did_fetch_schema' callback and returns the actual
  * schema version. On failure raises a Lua error.
+ *
+ * If the schema cache is enabled and has the schema of the last seen
+ * version, the schema is taken from the cache without a request.
  */
 static uint32_t
 netbox_transport_fetch_schema(struct netbox_transport *transport,
@@ -2384,6 +2705,8 @@ netbox_transport_fetch_schema(struct netbox_transport *transport,
 {
 	transport->state = NETBOX_FETCH_SCHEMA;
 	netbox_transport_on_state_change(transport, L);
+	if (netbox_transport_install_cached_schema(transport, L))
+		return transport->peer_schema_version;
 	uint32_t peer_version_id = transport->greeting.version_id;
 	/* _vcollation view was added in 2.2.0-389-g3e3ef182f */
 	bool peer_has_vcollation = peer_version_id >= version_id(2, 2, 1);
@@ -2458,6 +2781,10 @@ restart:
 		lua_rawseti(L, schema_table_idx, key);
 	} while (!(got_vspace && got_vindex &&
 		   (got_vcollation || !peer_has_vcollation)));
+	if (transport->opts.schema_cache) {
+		netbox_transport_cache_schema(transport, L, schema_version,
+					      schema_table_idx);
+	}
 	/* Invoke the 'did_fetch_schema' callback. */
 	lua_rawgeti(L, LUA_REGISTRYINDEX, transport->opts.callback_ref);
 	lua_pushliteral(L, "did_fetch_schema");
@@ -2488,6 +2815,7 @@ netbox_transport_process_requests(struct netbox_transport *transport,
 		netbox_transport_dispatch_response(transport, L, &hdr);
 		if (hdr.schema_version > 0 &&
 		    hdr.schema_version != schema_version) {
+			transport->peer_schema_version = hdr.schema_version;
 			break;
 		}
 	}
@@ -2500,6 +2828,7 @@ static int
 netbox_connection_handler_f(struct lua_State *L)
 {
 	struct netbox_transport *transport = (void *)lua_topointer(L, 1);
+	transport->peer_schema_version = 0;
 	netbox_transport_do_id(transport, L);
 	netbox_transport_do_auth(transport, L);
 	while (true) {
@@ -2644,10 +2973,15 @@ luaopen_net_box(struct lua_State *L)
 			    IPROTO_FEATURE_ERROR_EXTENSION);
 	iproto_features_set(&NETBOX_IPROTO_FEATURES,
 			    IPROTO_FEATURE_WATCHERS);
+	iproto_features_set(&NETBOX_IPROTO_FEATURES,
+			    IPROTO_FEATURE_CHUNKED_RESPONSES);
 
 	lua_pushcfunction(L, luaT_netbox_request_iterator_next);
 	luaT_netbox_request_iterator_next_ref = luaL_ref(L, LUA_REGISTRYINDEX);
 
+	lua_newtable(L);
+	netbox_schema_cache_ref = luaL_ref(L, LUA_REGISTRYINDEX);
+
 	static const struct luaL_Reg netbox_transport_meta[] = {
 		{ "__gc",           luaT_netbox_transport_gc },
 		{ "start",          luaT_netbox_transport_start },
@@ -2679,6 +3013,7 @@ luaopen_net_box(struct lua_State *L)
 
 	static const luaL_Reg net_box_lib[] = {
 		{ "new_transport",  luaT_netbox_new_transport },
+		{ "encode_call_prefix", luaT_netbox_encode_call_prefix },
 		{ NULL, NULL}
 	};
 	/* luaL_register_module polutes _G */
@@ -46,6 +46,13 @@ local M_COMMIT      = 18
 local M_ROLLBACK    = 19
 -- Injects raw data into connection. Used by tests.
 local M_INJECT      = 20
+local M_CALL_PREPARED = 21
+
+-- Transaction isolation levels, see enum txn_isolation_level.
+local TXN_ISOLATION_LEVEL = {
+    ['default'] = 0,
+    ['read-only-snapshot'] = 1,
+}
 
 -- IPROTO feature id -> name
 local IPROTO_FEATURE_NAMES = {
@@ -53,6 +60,11 @@ local IPROTO_FEATURE_NAMES = {
     [1]     = 'transactions',
     [2]     = 'error_extension',
     [3]     = 'watchers',
+    [4]     = 'batch',
+    [5]     = 'compression',
+    [6]     = 'cursors',
+    [7]     = 'chunked_responses',
+    [8]     = 'async_commit',
 }
 
 -- Given an array of IPROTO feature ids, returns a map {feature_name: bool}.
@@ -362,7 +374,8 @@ local function new_sm(uri, opts)
     remote._callback = callback
     local transport = internal.new_transport(
             uri, user, password, weak_callback,
-            opts.connect_timeout, opts.reconnect_after)
+            opts.connect_timeout, opts.reconnect_after, opts.compression,
+            opts.schema_cache)
     remote._transport = transport
     remote._gc_hook = ffi.gc(ffi.new('char[1]'), function()
         pcall(transport.stop, transport);
@@ -420,6 +433,7 @@ end
 local function stream_begin(stream, txn_opts, netbox_opts)
     check_remote_arg(stream, 'begin')
     local timeout
+    local isolation
     if txn_opts then
         if type(txn_opts) ~= 'table' then
             error("txn_opts should be a table")
@@ -428,9 +442,16 @@ local function stream_begin(stream, txn_opts, netbox_opts)
         if timeout and (type(timeout) ~= "number" or timeout <= 0) then
             error("timeout must be a number greater than 0")
         end
+        if txn_opts.isolation ~= nil then
+            isolation = TXN_ISOLATION_LEVEL[txn_opts.isolation]
+            if isolation == nil then
+                error("isolation must be one of 'default', " ..
+                      "'read-only-snapshot'")
+            end
+        end
     end
     local res = stream:_request(M_BEGIN, netbox_opts, nil,
-                                stream._stream_id, timeout)
+                                stream._stream_id, timeout, isolation)
     if netbox_opts and netbox_opts.is_async then
         return res
     end
@@ -727,6 +748,28 @@ function remote_methods:call(func_name, args, opts)
     return unpack(res)
 end
 
+-- Returns a function that calls the remote function func_name with
+-- the given arguments and options. The request body up to the
+-- arguments is encoded once, here, so each call only encodes the
+-- arguments.
+function remote_methods:prepare_call(func_name, opts)
+    check_remote_arg(self, 'prepare_call')
+    if opts ~= nil and type(opts) ~= 'table' then
+        error("Use remote:prepare_call(func_name, opts)")
+    end
+    local prefix = internal.encode_call_prefix(tostring(func_name))
+    local is_async = opts and opts.is_async
+    return function(args)
+        check_call_args(args)
+        local res = self:_request(M_CALL_PREPARED, opts, nil,
+                                  self._stream_id, prefix, args or {})
+        if type(res) ~= 'table' or is_async then
+            return res
+        end
+        return unpack(res)
+    end
+end
+
 -- @deprecated since 1.7.4
 function remote_methods:eval_16(code, ...)
     check_remote_arg(self, 'eval')
@@ -1063,6 +1106,7 @@ this_module = {
         commit      = M_COMMIT,
         rollback    = M_ROLLBACK,
         inject      = M_INJECT,
+        call_prepared = M_CALL_PREPARED,
     }
 }
 
@@ -1124,6 +1168,12 @@ this_module.self = {
             return handle_eval_result(pcall(proc, unpack(args)))
         end
     end,
+    prepare_call = function(_box, proc_name)
+        check_remote_arg(_box, 'prepare_call')
+        return function(args)
+            return _box:call(proc_name, args)
+        end
+    end,
     eval = function(_box, expr, args)
         check_remote_arg(_box, 'eval')
         check_eval_args(args)
@@ -0,0 +1,205 @@
+/*
+ * SPDX-License-Identifier: BSD-2-Clause
+ *
+ * Copyright 2010-2026, Tarantool AUTHORS, please see AUTHORS file.
+ */
+#include "box/lua/read_view.h"
+
+#include <assert.h>
+#include <lua.h>
+#include <lauxlib.h>
+
+#include "box/lua/tuple.h"
+#include "box/read_view.h"
+#include "box/schema.h"
+#include "box/space.h"
+#include "box/tuple.h"
+#include "diag.h"
+#include "lua/utils.h"
+#include "trivia/util.h"
+
+static const char read_view_typename[] = "box.read_view";
+static const char read_view_iterator_typename[] = "box.read_view.iterator";
+
+/** Iterator pushed to Lua by read_view:pairs(). */
+struct lbox_read_view_iterator {
+	box_read_view_iterator_t *it;
+	/** Runtime format with the field names of the space. */
+	struct tuple_format *format;
+};
+
+/**
+ * Get a space id from a space object, a space name or a space id
+ * at the given index of the stack.
+ */
+static uint32_t
+lbox_read_view_space_id(struct lua_State *L, int idx)
+{
+	if (lua_istable(L, idx)) {
+		lua_getfield(L, idx, "id");
+		uint32_t space_id = lua_tointeger(L, -1);
+		lua_pop(L, 1);
+		return space_id;
+	}
+	if (lua_type(L, idx) == LUA_TSTRING) {
+		const char *name = lua_tostring(L, idx);
+		struct space *space = space_by_name(name);
+		if (space == NULL) {
+			diag_set(ClientError, ER_NO_SUCH_SPACE, name);
+			luaT_error(L);
+		}
+		return space_id(space);
+	}
+	if (lua_type(L, idx) != LUA_TNUMBER)
+		luaL_error(L, "space must be a space object, a name or an id");
+	return lua_tointeger(L, idx);
+}
+
+static box_read_view_t *
+luaT_check_read_view(struct lua_State *L, int idx)
+{
+	box_read_view_t **ptr = luaL_checkudata(L, idx, read_view_typename);
+	if (*ptr == NULL)
+		luaL_error(L, "Read view is closed");
+	return *ptr;
+}
+
+/**
+ * box.read_view.open({space, ...}) opens a read view of the given
+ * spaces.
+ */
+static int
+lbox_read_view_open(struct lua_State *L)
+{
+	if (lua_gettop(L) != 1 || !lua_istable(L, 1))
+		return luaL_error(L, "Usage: box.read_view.open({space, ...})");
+	uint32_t space_count = lua_objlen(L, 1);
+	/* Allocated on the Lua stack, because resolving a name may throw. */
+	uint32_t *space_ids = lua_newuserdata(L, MAX(space_count, 1) *
+					      sizeof(*space_ids));
+	for (uint32_t i = 0; i < space_count; i++) {
+		lua_rawgeti(L, 1, i + 1);
+		space_ids[i] = lbox_read_view_space_id(L, -1);
+		lua_pop(L, 1);
+	}
+	box_read_view_t **ptr = lua_newuserdata(L, sizeof(*ptr));
+	*ptr = NULL;
+	luaL_getmetatable(L, read_view_typename);
+	lua_setmetatable(L, -2);
+	*ptr = box_read_view_open(space_ids, space_count);
+	if (*ptr == NULL)
+		return luaT_error(L);
+	return 1;
+}
+
+/**
+ * read_view:close() closes the read view. Iterators created before
+ * can still be used.
+ */
+static int
+lbox_read_view_close(struct lua_State *L)
+{
+	box_read_view_t **ptr = luaL_checkudata(L, 1, read_view_typename);
+	if (*ptr != NULL) {
+		box_read_view_close(*ptr);
+		*ptr = NULL;
+	}
+	return 0;
+}
+
+/** Iterator function returned by read_view:pairs(). */
+static int
+lbox_read_view_iterator_next(struct lua_State *L)
+{
+	struct lbox_read_view_iterator *it =
+		luaL_checkudata(L, 1, read_view_iterator_typename);
+	if (it->it == NULL)
+		return 0;
+	const char *data, *data_end;
+	if (box_read_view_iterator_next(it->it, &data, &data_end) != 0)
+		return luaT_error(L);
+	if (data == NULL) {
+		/* Release the memory held by the read view early. */
+		box_read_view_iterator_free(it->it);
+		it->it = NULL;
+		return 0;
+	}
+	struct tuple *tuple = tuple_new(it->format, data, data_end);
+	if (tuple == NULL)
+		return luaT_error(L);
+	lua_pushvalue(L, 1);
+	luaT_pushtuple(L, tuple);
+	return 2;
+}
+
+static int
+lbox_read_view_iterator_gc(struct lua_State *L)
+{
+	struct lbox_read_view_iterator *it =
+		luaL_checkudata(L, 1, read_view_iterator_typename);
+	if (it->it != NULL)
+		box_read_view_iterator_free(it->it);
+	if (it->format != NULL)
+		tuple_format_unref(it->format);
+	it->it = NULL;
+	it->format = NULL;
+	return 0;
+}
+
+/**
+ * read_view:pairs(space) returns an iterator over the tuples of the
+ * space in the read view, in the primary key order. Each space can
+ * be iterated once per read view.
+ */
+static int
+lbox_read_view_pairs(struct lua_State *L)
+{
+	if (lua_gettop(L) != 2)
+		return luaL_error(L, "Usage: read_view:pairs(space)");
+	box_read_view_t *rv = luaT_check_read_view(L, 1);
+	uint32_t space_id = lbox_read_view_space_id(L, 2);
+	struct space *space = space_cache_find(space_id);
+	if (space == NULL)
+		return luaT_error(L);
+	struct lbox_read_view_iterator *it = lua_newuserdata(L, sizeof(*it));
+	it->it = NULL;
+	it->format = NULL;
+	luaL_getmetatable(L, read_view_iterator_typename);
+	lua_setmetatable(L, -2);
+	it->format = runtime_tuple_format_new(space->def->dict);
+	if (it->format == NULL)
+		return luaT_error(L);
+	it->it = box_read_view_iterator(rv, space_id);
+	if (it->it == NULL)
+		return luaT_error(L);
+	lua_pushcfunction(L, lbox_read_view_iterator_next);
+	lua_insert(L, -2);
+	lua_pushnil(L);
+	return 3;
+}
+
+void
+box_lua_read_view_init(struct lua_State *L)
+{
+	static const struct luaL_Reg read_view_meta[] = {
+		{"pairs", lbox_read_view_pairs},
+		{"close", lbox_read_view_close},
+		{"__gc", lbox_read_view_close},
+		{NULL, NULL}
+	};
+	luaL_register_type(L, read_view_typename, read_view_meta);
+
+	static const struct luaL_Reg read_view_iterator_meta[] = {
+		{"__gc", lbox_read_view_iterator_gc},
+		{NULL, NULL}
+	};
+	luaL_register_type(L, read_view_iterator_typename,
+			   read_view_iterator_meta);
+
+	static const struct luaL_Reg read_view_lib[] = {
+		{"open", lbox_read_view_open},
+		{NULL, NULL}
+	};
+	luaL_register_module(L, "box.read_view", read_view_lib);
+	lua_pop(L, 1);
+}
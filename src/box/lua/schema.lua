@@ -2,6 +2,7 @@
 --
 local ffi = require('ffi')
 local msgpack = require('msgpack')
+local msgpackffi = require('msgpackffi')
 local fun = require('fun')
 local log = require('log')
 local buffer = require('buffer')
@@ -17,10 +18,13 @@ local builtin = ffi.C
 -- performance fixup for hot functions
 local tuple_encode = box.internal.tuple.encode
 local tuple_bless = box.internal.tuple.bless
+local tuple_adopt = box.internal.tuple.adopt
 local is_tuple = box.tuple.is
-assert(tuple_encode ~= nil and tuple_bless ~= nil and is_tuple ~= nil)
+assert(tuple_encode ~= nil and tuple_bless ~= nil and tuple_adopt ~= nil and
+       is_tuple ~= nil)
 local cord_ibuf_take = buffer.internal.cord_ibuf_take
 local cord_ibuf_put = buffer.internal.cord_ibuf_put
+local encode_array = msgpackffi.internal.encode_array
 
 local INT64_MIN = tonumber64('-9223372036854775808')
 local INT64_MAX = tonumber64('9223372036854775807')
@@ -30,6 +34,7 @@ ffi.cdef[[
     extern uint32_t box_schema_version();
     void space_run_triggers(struct space *space, bool yesno);
     size_t space_bsize(struct space *space);
+    bool space_is_ffi_dml_safe(struct space *space);
 
     typedef struct tuple box_tuple_t;
     typedef struct iterator box_iterator_t;
@@ -40,6 +45,9 @@ ffi.cdef[[
                        const char *key, const char *key_end);
     int
     box_iterator_next(box_iterator_t *itr, box_tuple_t **result);
+    int
+    box_iterator_next_batch(box_iterator_t *itr, box_tuple_t **result,
+                            uint32_t count);
     void
     box_iterator_free(box_iterator_t *itr);
     /** \endcond public */
@@ -73,11 +81,32 @@ ffi.cdef[[
     box_txn_begin();
     int
     box_txn_set_timeout(double timeout);
+    int
+    box_txn_set_isolation(uint32_t level);
     /** \endcond public */
     /** \cond public */
     int
     box_sequence_current(uint32_t seq_id, int64_t *result);
     /** \endcond public */
+    /** \cond public */
+    int
+    box_insert(uint32_t space_id, const char *tuple, const char *tuple_end,
+               box_tuple_t **result);
+    int
+    box_replace(uint32_t space_id, const char *tuple, const char *tuple_end,
+                box_tuple_t **result);
+    int
+    box_delete(uint32_t space_id, uint32_t index_id, const char *key,
+               const char *key_end, box_tuple_t **result);
+    int
+    box_update(uint32_t space_id, uint32_t index_id, const char *key,
+               const char *key_end, const char *ops, const char *ops_end,
+               int index_base, box_tuple_t **result);
+    int
+    box_upsert(uint32_t space_id, uint32_t index_id, const char *tuple,
+               const char *tuple_end, const char *ops, const char *ops_end,
+               int index_base, box_tuple_t **result);
+    /** \endcond public */
     typedef struct txn_savepoint box_txn_savepoint_t;
 
     box_txn_savepoint_t *
@@ -330,8 +359,14 @@ local function feedback_save_event(event)
     end
 end
 
+local txn_isolation_level = {
+    ['default'] = 0,
+    ['read-only-snapshot'] = 1,
+}
+
 box.begin = function(options)
     local timeout
+    local isolation
     if options then
         check_param(options, 'options', 'table')
         timeout = options.timeout
@@ -339,6 +374,14 @@ box.begin = function(options)
             box.error(box.error.ILLEGAL_PARAMS,
                       "timeout must be a number greater than 0")
         end
+        if options.isolation ~= nil then
+            isolation = txn_isolation_level[options.isolation]
+            if isolation == nil then
+                box.error(box.error.ILLEGAL_PARAMS,
+                          "isolation must be one of 'default', " ..
+                          "'read-only-snapshot'")
+            end
+        end
     end
     if builtin.box_txn_begin() == -1 then
         box.error()
@@ -346,6 +389,9 @@ box.begin = function(options)
     if timeout then
         assert(builtin.box_txn_set_timeout(timeout) == 0)
     end
+    if isolation then
+        assert(builtin.box_txn_set_isolation(isolation) == 0)
+    end
 end
 
 box.is_in_txn = builtin.box_txn
@@ -443,6 +489,9 @@ box.schema.space.create = function(name, options)
         is_local = 'boolean',
         temporary = 'boolean',
         is_sync = 'boolean',
+        memory_quota = 'number',
+        expire_field = 'number',
+        cached_paths = 'table',
     }
     local options_defaults = {
         engine = 'memtx',
@@ -487,7 +536,10 @@ box.schema.space.create = function(name, options)
     local space_options = setmap({
         group_id = options.is_local and 1 or nil,
         temporary = options.temporary and true or nil,
-        is_sync = options.is_sync
+        is_sync = options.is_sync,
+        memory_quota = options.memory_quota,
+        expire_field = options.expire_field,
+        cached_paths = options.cached_paths,
     })
     _space:insert{id, uid, name, options.engine, options.field_count,
         space_options, format}
@@ -580,6 +632,9 @@ local alter_space_template = {
     format = 'table',
     temporary = 'boolean',
     is_sync = 'boolean',
+    memory_quota = 'number',
+    expire_field = 'number',
+    cached_paths = 'table',
     name = 'string',
 }
 
@@ -616,6 +671,18 @@ box.schema.space.alter = function(space_id, options)
         flags.is_sync = options.is_sync
     end
 
+    if options.memory_quota ~= nil then
+        flags.memory_quota = options.memory_quota
+    end
+
+    if options.expire_field ~= nil then
+        flags.expire_field = options.expire_field
+    end
+
+    if options.cached_paths ~= nil then
+        flags.cached_paths = options.cached_paths
+    end
+
     local format
     if options.format ~= nil then
         format = update_format(options.format)
@@ -1085,6 +1152,9 @@ local index_options = {
     range_size = 'number',
     page_size = 'number',
     bloom_fpr = 'number',
+    bloom_partitioned = 'boolean',
+    compaction_policy = 'string',
+    compression_dict_size = 'number',
     func = 'number, string',
     hint = 'boolean',
 }
@@ -1232,6 +1302,9 @@ box.schema.index.create = function(space_id, name, options)
             run_count_per_level = options.run_count_per_level,
             run_size_ratio = options.run_size_ratio,
             bloom_fpr = options.bloom_fpr,
+            bloom_partitioned = options.bloom_partitioned,
+            compaction_policy = options.compaction_policy,
+            compression_dict_size = options.compression_dict_size,
             func = options.func,
             hint = options.hint,
     }
@@ -1473,6 +1546,39 @@ local iterator_gen = function(param, state) -- luacheck: no unused args
     end
 end
 
+-- Same as iterator_gen, but takes tuples from the iterator in batches
+-- of param.size. The prefetched tuples are kept in param, so unlike
+-- iterator_gen this function isn't stateless.
+local iterator_gen_prefetch = function(param, state)
+    if not ffi.istype(iterator_t, state) then
+        error('usage: next(param, state)')
+    end
+    local tuples = param.tuples
+    local pos = param.pos
+    if pos > param.count then
+        if param.count < param.size then
+            return nil
+        end
+        local count = builtin.box_iterator_next_batch(state, param.buf,
+                                                      param.size)
+        if count < 0 then
+            return box.error() -- error
+        end
+        for i = 1, count do
+            tuples[i] = tuple_adopt(param.buf[i - 1])
+        end
+        param.count = count
+        pos = 1
+        if count == 0 then
+            return nil
+        end
+    end
+    local tuple = tuples[pos]
+    tuples[pos] = nil
+    param.pos = pos + 1
+    return state, tuple -- new state, value
+end
+
 local iterator_gen_luac = function(param, state) -- luacheck: no unused args
     local tuple = internal.iterator_next(state)
     if tuple ~= nil then
@@ -1890,11 +1996,33 @@ base_index_mt.pairs_ffi = function(index, key, opts)
     local keybuf = ffi.string(pkey, pkey_end - pkey)
     cord_ibuf_put(ibuf)
     local pkeybuf = ffi.cast('const char *', keybuf)
+    local prefetch = type(opts) == 'table' and opts.prefetch or nil
+    if prefetch ~= nil and (type(prefetch) ~= 'number' or prefetch < 1 or
+                            prefetch > 1024 or prefetch % 1 ~= 0) then
+        box.error(box.error.ILLEGAL_PARAMS,
+                  "options parameter 'prefetch' should be an integer " ..
+                  "from 1 to 1024")
+    end
     local cdata = builtin.box_index_iterator(index.space_id, index.id,
         itype, pkeybuf, pkeybuf + #keybuf);
     if cdata == nil then
         box.error()
     end
+    if prefetch ~= nil and prefetch > 1 then
+        -- keybuf is kept to prevent GC from collecting it, see
+        -- iterator_gen.
+        local param = {
+            keybuf = keybuf,
+            buf = ffi.new('box_tuple_t *[?]', prefetch),
+            tuples = {},
+            size = prefetch,
+            -- Make the first call fetch a batch.
+            count = prefetch,
+            pos = prefetch + 1,
+        }
+        return fun.wrap(iterator_gen_prefetch, param,
+            ffi.gc(cdata, builtin.box_iterator_free))
+    end
     return fun.wrap(iterator_gen, keybuf,
         ffi.gc(cdata, builtin.box_iterator_free))
 end
@@ -1951,9 +2079,13 @@ base_index_mt.get_luac = function(index, key)
     return internal.get(index.space_id, index.id, key)
 end
 
+local ibuf_t = ffi.typeof('struct ibuf')
+local ibuf_ptr_t = ffi.typeof('struct ibuf *')
+
 local function check_select_opts(opts, key_is_nil)
     local offset = 0
     local limit = 4294967295
+    local buffer
     local iterator = check_iterator_type(opts, key_is_nil)
     if opts ~= nil then
         if opts.offset ~= nil then
@@ -1962,15 +2094,39 @@ local function check_select_opts(opts, key_is_nil)
         if opts.limit ~= nil then
             limit = opts.limit
         end
+        if opts.buffer ~= nil then
+            buffer = opts.buffer
+            if not ffi.istype(ibuf_t, buffer) and
+               not ffi.istype(ibuf_ptr_t, buffer) then
+                box.error(box.error.ILLEGAL_PARAMS,
+                          "options parameter 'buffer' should be of type ibuf")
+            end
+        end
+    end
+    return iterator, offset, limit, buffer
+end
+
+-- Encodes tuples stored in port_c as a MsgPack array, appends it
+-- to the buffer and returns the number of bytes written.
+local function port_c_dump_buffer(buffer)
+    local used = buffer:size()
+    encode_array(buffer, port_c.size)
+    local entry = port_c.first
+    for _ = 1, tonumber(port_c.size) do
+        local bsize = builtin.box_tuple_bsize(entry.tuple)
+        local data = buffer:alloc(bsize)
+        builtin.box_tuple_to_buf(entry.tuple, data, bsize)
+        entry = entry.next
     end
-    return iterator, offset, limit
+    return buffer:size() - used
 end
 
 base_index_mt.select_ffi = function(index, key, opts)
     check_index_arg(index, 'select')
     local ibuf = cord_ibuf_take()
     local key, key_end = tuple_encode(ibuf, key)
-    local iterator, offset, limit = check_select_opts(opts, key + 1 >= key_end)
+    local iterator, offset, limit, buffer =
+        check_select_opts(opts, key + 1 >= key_end)
 
     local port = ffi.cast('struct port *', port_c)
     local nok = builtin.box_select(index.space_id, index.id, iterator, offset,
@@ -1979,6 +2135,14 @@ base_index_mt.select_ffi = function(index, key, opts)
     if nok then
         return box.error()
     end
+    if buffer ~= nil then
+        local ok, res = pcall(port_c_dump_buffer, buffer)
+        builtin.port_destroy(port);
+        if not ok then
+            error(res)
+        end
+        return res
+    end
 
     local ret = {}
     local entry = port_c.first
@@ -1993,17 +2157,72 @@ end
 base_index_mt.select_luac = function(index, key, opts)
     check_index_arg(index, 'select')
     local key = keify(key)
-    local iterator, offset, limit = check_select_opts(opts, #key == 0)
+    local iterator, offset, limit, buffer = check_select_opts(opts, #key == 0)
+    if buffer ~= nil then
+        return internal.select(index.space_id, index.id, iterator,
+            offset, limit, key, buffer)
+    end
     return internal.select(index.space_id, index.id, iterator,
         offset, limit, key)
 end
 
+-- DML via FFI doesn't abort JIT traces, but an FFI call must not
+-- yield or call Lua code. So it is used only in a transaction,
+-- where a statement doesn't wait for the WAL, and only for memtx
+-- spaces without triggers and functional indexes. Otherwise the
+-- Lua C API functions are called.
+local function dml_ffi_is_safe(space_id)
+    if not builtin.box_txn() then
+        return false
+    end
+    local s = builtin.space_by_id(space_id)
+    return s ~= nil and builtin.space_is_ffi_dml_safe(s)
+end
+
+local function dml_ffi_result(nok)
+    if nok then
+        return box.error() -- error
+    elseif ptuple[0] ~= nil then
+        return tuple_bless(ptuple[0])
+    else
+        return
+    end
+end
+
+-- Encode a key or a tuple and update operations one after another.
+-- The buffer may be reallocated by the second encoding, so the
+-- first object is addressed by its size.
+local function dml_ffi_encode2(ibuf, a, b)
+    local data, data_end = tuple_encode(ibuf, a)
+    local a_size = data_end - data
+    data, data_end = tuple_encode(ibuf, b)
+    return data, data + a_size, data + a_size, data_end
+end
+
 base_index_mt.update = function(index, key, ops)
     check_index_arg(index, 'update')
+    if type(ops) == 'table' and dml_ffi_is_safe(index.space_id) then
+        local ibuf = cord_ibuf_take()
+        local pkey, pkey_end, pops, pops_end =
+            dml_ffi_encode2(ibuf, keify(key), ops)
+        local nok = builtin.box_update(index.space_id, index.id, pkey,
+                                       pkey_end, pops, pops_end, 1,
+                                       ptuple) ~= 0
+        cord_ibuf_put(ibuf)
+        return dml_ffi_result(nok)
+    end
     return internal.update(index.space_id, index.id, keify(key), ops);
 end
 base_index_mt.delete = function(index, key)
     check_index_arg(index, 'delete')
+    if dml_ffi_is_safe(index.space_id) then
+        local ibuf = cord_ibuf_take()
+        local pkey, pkey_end = tuple_encode(ibuf, key)
+        local nok = builtin.box_delete(index.space_id, index.id, pkey,
+                                       pkey_end, ptuple) ~= 0
+        cord_ibuf_put(ibuf)
+        return dml_ffi_result(nok)
+    end
     return internal.delete(index.space_id, index.id, keify(key));
 end
 
@@ -2090,12 +2309,67 @@ space_mt.jselect = function(space, key, opts, fselect_opts)
 end
 space_mt.insert = function(space, tuple)
     check_space_arg(space, 'insert')
+    if (type(tuple) == 'table' or is_tuple(tuple)) and
+       dml_ffi_is_safe(space.id) then
+        local ibuf = cord_ibuf_take()
+        local data, data_end = tuple_encode(ibuf, tuple)
+        local nok = builtin.box_insert(space.id, data, data_end,
+                                       ptuple) ~= 0
+        cord_ibuf_put(ibuf)
+        return dml_ffi_result(nok)
+    end
     return internal.insert(space.id, tuple);
 end
 space_mt.replace = function(space, tuple)
     check_space_arg(space, 'replace')
+    if (type(tuple) == 'table' or is_tuple(tuple)) and
+       dml_ffi_is_safe(space.id) then
+        local ibuf = cord_ibuf_take()
+        local data, data_end = tuple_encode(ibuf, tuple)
+        local nok = builtin.box_replace(space.id, data, data_end,
+                                        ptuple) ~= 0
+        cord_ibuf_put(ibuf)
+        return dml_ffi_result(nok)
+    end
     return internal.replace(space.id, tuple);
 end
+space_mt.insert_batch = function(space, tuples)
+    check_space_arg(space, 'insert_batch')
+    return internal.insert_batch(space.id, tuples);
+end
+-- Load CSV text from a string or an object with method read(size),
+-- like a fio handle or a socket, converting the fields to the types
+-- of the space format. Returns the number of inserted rows.
+space_mt.load_csv = function(space, readable, opts)
+    check_space_arg(space, 'load_csv')
+    check_param_table(opts, {chunk_size = 'number', batch_size = 'number',
+                             delimiter = 'string', quote_char = 'string',
+                             skip_head_lines = 'number',
+                             parse_in_thread = 'boolean'})
+    opts = update_param_table(opts, {chunk_size = 65536})
+    if type(readable) ~= 'string' and (readable == nil or
+       type(readable.read) ~= 'function') then
+        box.error(box.error.ILLEGAL_PARAMS, "Usage: space:load_csv(string " ..
+                  "or object with method read(size)[, opts])")
+    end
+    local loader = internal.csv_loader_new(space.id, opts)
+    if type(readable) == 'string' then
+        loader:feed(readable)
+    else
+        while true do
+            local chunk, err = readable:read(opts.chunk_size)
+            if chunk == nil then
+                box.error(box.error.ILLEGAL_PARAMS, "failed to read CSV: " ..
+                          tostring(err))
+            end
+            if chunk == '' then
+                break
+            end
+            loader:feed(chunk)
+        end
+    end
+    return loader:finish()
+end
 space_mt.put = space_mt.replace; -- put is an alias for replace
 space_mt.update = function(space, key, ops)
     check_space_arg(space, 'update')
@@ -2109,6 +2383,17 @@ space_mt.upsert = function(space, tuple_key, ops, deprecated)
         msg = msg .. ". Usage :upsert(tuple, operations)"
         box.error(box.error.PROC_LUA, msg)
     end
+    if (type(tuple_key) == 'table' or is_tuple(tuple_key)) and
+       (type(ops) == 'table' or is_tuple(ops)) and
+       dml_ffi_is_safe(space.id) then
+        local ibuf = cord_ibuf_take()
+        local data, data_end, pops, pops_end =
+            dml_ffi_encode2(ibuf, tuple_key, ops)
+        local nok = builtin.box_upsert(space.id, 0, data, data_end, pops,
+                                       pops_end, 1, ptuple) ~= 0
+        cord_ibuf_put(ibuf)
+        return dml_ffi_result(nok)
+    end
     return internal.upsert(space.id, tuple_key, ops);
 end
 space_mt.delete = function(space, key)
@@ -2186,6 +2471,7 @@ space_mt.run_triggers = function(space, yesno)
     builtin.space_run_triggers(s, yesno)
 end
 space_mt.frommap = box.internal.space.frommap
+space_mt.stat = box.internal.space.stat
 space_mt.__index = space_mt
 
 local ck_constraint_mt = {}
@@ -2602,6 +2888,8 @@ box.schema.func.create = function(name, opts)
                               is_sandboxed = 'boolean',
                               is_multikey = 'boolean',
                               takes_raw_args = 'boolean',
+                              is_threadsafe = 'boolean',
+                              cache = 'boolean',
                               comment = 'string',
                               param_list = 'table', returns = 'string',
                               exports = 'table', opts = 'table' })
@@ -2629,6 +2917,12 @@ box.schema.func.create = function(name, opts)
     if opts.takes_raw_args then
         opts.opts.takes_raw_args = opts.takes_raw_args
     end
+    if opts.is_threadsafe then
+        opts.opts.is_threadsafe = opts.is_threadsafe
+    end
+    if opts.cache then
+        opts.opts.cache = opts.cache
+    end
     _func:auto_increment{session.euid(), name, opts.setuid, opts.language,
                          opts.body, opts.routine_type, opts.param_list,
                          opts.returns, opts.aggregate, opts.sql_data_access,
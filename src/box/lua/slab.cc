@@ -198,6 +198,14 @@ lbox_slab_info(struct lua_State *L)
 	lua_pushstring(L, ratio_buf);
 	lua_settable(L, -3);
 
+	/**
+	 * How much of the arena is backed by transparent huge
+	 * pages, see box.cfg.memtx_use_hugepages.
+	 */
+	lua_pushstring(L, "arena_hugepages");
+	luaL_pushuint64(L, memtx_engine_hugepages_used(memtx));
+	lua_settable(L, -3);
+
 	/*
 	 * This is pretty much the same as
 	 * box.cfg.slab_alloc_arena, but in bytes
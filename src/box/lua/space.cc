@@ -35,6 +35,8 @@
 #include "box/sql/sqlLimit.h"
 #include "lua/utils.h"
 #include "lua/trigger.h"
+#include "lua/info.h"
+#include "info/info.h"
 
 extern "C" {
 	#include <lua.h>
@@ -437,6 +439,24 @@ lbox_fillspace(struct lua_State *L, struct space *space, int i)
 			lua_pushnumber(L, index_opts->bloom_fpr);
 			lua_setfield(L, -2, "bloom_fpr");
 
+			if (index_opts->bloom_partitioned) {
+				lua_pushboolean(L, true);
+				lua_setfield(L, -2, "bloom_partitioned");
+			}
+
+			if (index_opts->compaction_policy !=
+			    INDEX_COMPACTION_LEVELED) {
+				lua_pushstring(L, index_compaction_policy_strs[
+					index_opts->compaction_policy]);
+				lua_setfield(L, -2, "compaction_policy");
+			}
+
+			if (index_opts->compression_dict_size > 0) {
+				lua_pushnumber(L,
+					index_opts->compression_dict_size);
+				lua_setfield(L, -2, "compression_dict_size");
+			}
+
 			lua_settable(L, -3);
 		}
 		lua_setfield(L, -2, index_def->name);
@@ -606,6 +626,27 @@ usage_error:
 	return luaL_error(L, "Usage: space:frommap(map, opts)");
 }
 
+/**
+ * Dump space statistics.
+ * @param Lua space object.
+ * @retval Lua table with the statistics.
+ */
+static int
+lbox_space_stat(struct lua_State *L)
+{
+	if (lua_gettop(L) != 1 || !lua_istable(L, 1))
+		return luaL_error(L, "Usage: space:stat()");
+	lua_getfield(L, 1, "id");
+	uint32_t id = (uint32_t)lua_tointeger(L, -1);
+	struct space *space = space_cache_find(id);
+	if (space == NULL)
+		return luaT_error(L);
+	struct info_handler info;
+	luaT_info_handler_create(&info, L);
+	space_stat(space, &info);
+	return 1;
+}
+
 void
 box_lua_space_init(struct lua_State *L)
 {
@@ -705,6 +746,7 @@ box_lua_space_init(struct lua_State *L)
 
 	static const struct luaL_Reg space_internal_lib[] = {
 		{"frommap", lbox_space_frommap},
+		{"stat", lbox_space_stat},
 		{NULL, NULL}
 	};
 	luaL_register(L, "box.internal.space", space_internal_lib);
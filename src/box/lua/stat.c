@@ -31,6 +31,7 @@
  */
 #include "stat.h"
 
+#include <stdlib.h>
 #include <string.h>
 #include <rmean.h>
 
@@ -43,9 +44,15 @@
 #include "box/engine.h"
 #include "box/vinyl.h"
 #include "box/sql.h"
+#include "box/wal.h"
+#include "box/tuple_format.h"
+#include "box/schema.h"
+#include "box/space.h"
+#include "box/op_latency.h"
 #include "info/info.h"
 #include "lua/info.h"
 #include "lua/utils.h"
+#include "tt_static.h"
 
 extern struct rmean *rmean_box;
 extern struct rmean *rmean_error;
@@ -67,9 +74,27 @@ inject_current_stat(struct lua_State *L, const char *name, size_t val)
 	lua_pop(L, 1);
 }
 
+/**
+ * Function adds a table with 'current' field set to @a val by
+ * name @a name to the table which located at the top of the lua
+ * stack.
+ */
+static void
+inject_current_only_stat(struct lua_State *L, const char *name, size_t val)
+{
+	lua_pushstring(L, name);
+	lua_newtable(L);
+	lua_pushstring(L, "current");
+	lua_pushnumber(L, val);
+	lua_rawset(L, -3);
+	lua_rawset(L, -3);
+}
+
 static void
 inject_iproto_stats(struct lua_State *L, struct iproto_stats *stats)
 {
+	inject_current_only_stat(L, "INPUT_BUFFERS", stats->input_buffers);
+	inject_current_only_stat(L, "OUTPUT_BUFFERS", stats->output_buffers);
 	inject_current_stat(L, "CONNECTIONS", stats->connections);
 	inject_current_stat(L, "STREAMS", stats->streams);
 	inject_current_stat(L, "REQUESTS", stats->requests);
@@ -79,6 +104,60 @@ inject_iproto_stats(struct lua_State *L, struct iproto_stats *stats)
 			    stats->requests_in_stream_queue);
 }
 
+/**
+ * Push a table with request latency percentiles to a Lua stack.
+ * The table is indexed by request type name and stage name, only
+ * request types that have been served are present.
+ */
+static void
+push_iproto_latency(struct lua_State *L, struct iproto_latency *latency)
+{
+	static const int pcts[] = {50, 75, 90, 95, 99};
+	lua_newtable(L);
+	for (int type = 0; type < IPROTO_TYPE_STAT_MAX; type++) {
+		struct latency *l = latency->stage[type];
+		if (iproto_type_strs[type] == NULL ||
+		    latency_count(&l[IPROTO_STAGE_TOTAL]) == 0)
+			continue;
+		lua_pushstring(L, iproto_type_strs[type]);
+		lua_newtable(L);
+		for (int stage = 0; stage < iproto_stage_MAX; stage++) {
+			lua_pushstring(L, iproto_stage_strs[stage]);
+			lua_newtable(L);
+			for (size_t i = 0; i < lengthof(pcts); i++) {
+				lua_pushstring(L, tt_sprintf("p%d", pcts[i]));
+				lua_pushnumber(L, latency_get(&l[stage],
+							      pcts[i]));
+				lua_rawset(L, -3);
+			}
+			lua_rawset(L, -3);
+		}
+		lua_rawset(L, -3);
+	}
+}
+
+/**
+ * Add request latency percentiles of the iproto thread with the
+ * given id, or of all iproto threads if @a thread_id is -1, by
+ * name 'LATENCY' to the table which located at the top of the lua
+ * stack.
+ */
+static void
+inject_iproto_latency(struct lua_State *L, int thread_id)
+{
+	struct iproto_latency latency;
+	if (iproto_latency_create(&latency) != 0)
+		luaT_error(L);
+	if (thread_id < 0)
+		iproto_latency_get(&latency);
+	else
+		iproto_thread_latency_get(&latency, thread_id);
+	lua_pushstring(L, "LATENCY");
+	push_iproto_latency(L, &latency);
+	lua_rawset(L, -3);
+	iproto_latency_destroy(&latency);
+}
+
 static void
 fill_stat_item(struct lua_State *L, int rps, int64_t total)
 {
@@ -153,12 +232,144 @@ lbox_stat_vinyl(struct lua_State *L)
 	return 1;
 }
 
+static int
+lbox_stat_wal(struct lua_State *L)
+{
+	struct info_handler h;
+	luaT_info_handler_create(&h, L);
+	wal_stat(&h);
+	return 1;
+}
+
+static int
+iproto_slow_request_cmp(const void *a, const void *b)
+{
+	double t1 = ((const struct iproto_slow_request *)a)->time;
+	double t2 = ((const struct iproto_slow_request *)b)->time;
+	return t1 < t2 ? -1 : t1 > t2;
+}
+
+/**
+ * Push an array of requests that took longer than
+ * too_long_threshold to a Lua stack, oldest first. Each entry has
+ * the wall clock time when the reply was ready, the session id,
+ * the request type, space id and key, the time spent in each stage
+ * of processing, the time the execution waited for WAL and for
+ * the synchronous quorum, and the number of yields.
+ */
+static int
+lbox_stat_slow_requests(struct lua_State *L)
+{
+	size_t size = iproto_threads_count * IPROTO_SLOW_LOG_SIZE *
+		      sizeof(struct iproto_slow_request);
+	struct iproto_slow_request *entries = malloc(size);
+	if (entries == NULL) {
+		diag_set(OutOfMemory, size, "malloc", "entries");
+		return luaT_error(L);
+	}
+	int count = iproto_slow_log_get(entries);
+	qsort(entries, count, sizeof(*entries), iproto_slow_request_cmp);
+	lua_createtable(L, count, 0);
+	for (int i = 0; i < count; i++) {
+		struct iproto_slow_request *r = &entries[i];
+		lua_createtable(L, 0, 12);
+		lua_pushnumber(L, r->time);
+		lua_setfield(L, -2, "time");
+		luaL_pushuint64(L, r->session_id);
+		lua_setfield(L, -2, "session_id");
+		lua_pushstring(L, iproto_type_name(r->type));
+		lua_setfield(L, -2, "type");
+		if (r->space_id != 0) {
+			lua_pushinteger(L, r->space_id);
+			lua_setfield(L, -2, "space_id");
+		}
+		if (r->key[0] != '\0') {
+			lua_pushstring(L, r->key);
+			lua_setfield(L, -2, "key");
+		}
+		for (int stage = 0; stage < iproto_stage_MAX; stage++) {
+			lua_pushnumber(L, r->stage[stage]);
+			lua_setfield(L, -2, iproto_stage_strs[stage]);
+		}
+		lua_pushnumber(L, r->wal);
+		lua_setfield(L, -2, "wal");
+		lua_pushnumber(L, r->limbo);
+		lua_setfield(L, -2, "limbo");
+		lua_pushinteger(L, r->yields);
+		lua_setfield(L, -2, "yields");
+		lua_rawseti(L, -2, i + 1);
+	}
+	free(entries);
+	return 1;
+}
+
+static bool
+space_has_latency(struct space *space)
+{
+	if (space->latency != NULL)
+		return true;
+	for (uint32_t i = 0; i < space->index_count; i++) {
+		if (space->index[i]->latency != NULL)
+			return true;
+	}
+	return false;
+}
+
+static int
+space_latency_info(struct space *space, void *arg)
+{
+	struct info_handler *h = (struct info_handler *)arg;
+	if (!space_has_latency(space))
+		return 0;
+	info_table_begin(h, space_name(space));
+	op_latency_info(space->latency, h);
+	info_table_begin(h, "index");
+	for (uint32_t i = 0; i < space->index_count; i++) {
+		struct index *index = space->index[i];
+		if (index->latency == NULL)
+			continue;
+		info_table_begin(h, index->def->name);
+		op_latency_info(index->latency, h);
+		info_table_end(h);
+	}
+	info_table_end(h); /* index */
+	info_table_end(h); /* space */
+	return 0;
+}
+
+static int
+space_latency_reset(struct space *space, void *arg)
+{
+	(void)arg;
+	op_latency_reset(space->latency);
+	for (uint32_t i = 0; i < space->index_count; i++)
+		op_latency_reset(space->index[i]->latency);
+	return 0;
+}
+
+/**
+ * Push latency of operations per space and index collected with
+ * box.cfg.space_latency_stat to a Lua stack.
+ */
+static int
+lbox_stat_latency(struct lua_State *L)
+{
+	struct info_handler info;
+	luaT_info_handler_create(&info, L);
+	info_begin(&info);
+	space_foreach(space_latency_info, &info);
+	info_end(&info);
+	return 1;
+}
+
 static int
 lbox_stat_reset(struct lua_State *L)
 {
 	(void)L;
+	space_foreach(space_latency_reset, NULL);
 	box_reset_stat();
 	iproto_reset_stat();
+	wal_reset_stat();
 	return 0;
 }
 
@@ -174,10 +385,34 @@ static int
 lbox_stat_net_index(struct lua_State *L)
 {
 	const char *key = luaL_checkstring(L, -1);
+	struct iproto_stats stats;
+	/* Buffer metrics don't have rmean counters. */
+	if (strcmp(key, "INPUT_BUFFERS") == 0) {
+		iproto_stats_get(&stats);
+		lua_newtable(L);
+		lua_pushstring(L, "current");
+		lua_pushnumber(L, stats.input_buffers);
+		lua_rawset(L, -3);
+		return 1;
+	} else if (strcmp(key, "OUTPUT_BUFFERS") == 0) {
+		iproto_stats_get(&stats);
+		lua_newtable(L);
+		lua_pushstring(L, "current");
+		lua_pushnumber(L, stats.output_buffers);
+		lua_rawset(L, -3);
+		return 1;
+	} else if (strcmp(key, "LATENCY") == 0) {
+		struct iproto_latency latency;
+		if (iproto_latency_create(&latency) != 0)
+			return luaT_error(L);
+		iproto_latency_get(&latency);
+		push_iproto_latency(L, &latency);
+		iproto_latency_destroy(&latency);
+		return 1;
+	}
 	if (iproto_rmean_foreach(seek_stat_item, L) == 0)
 		return 0;
 
-	struct iproto_stats stats;
 	iproto_stats_get(&stats);
 	if (strcmp(key, "CONNECTIONS") == 0) {
 		lua_pushstring(L, "current");
@@ -210,11 +445,17 @@ lbox_stat_net_index(struct lua_State *L)
  *
  * - SENT (packets): total, rps;
  * - RECEIVED (packets): total, rps;
+ * - WRITES (socket writes): total, rps;
  * - CONNECTIONS: total, rps, current;
  * - STREAMS: total, rps, current;
  * - REQUESTS: total, rps, current;
  * - REQUESTS_IN_PROGRESS: total, rps, current;
- * - REQUESTS_IN_STREAM_QUEUE: total, rps, current.
+ * - REQUESTS_IN_STREAM_QUEUE: total, rps, current;
+ * - INPUT_BUFFERS (bytes): current;
+ * - OUTPUT_BUFFERS (bytes): current;
+ * - LATENCY (seconds): p50, p75, p90, p95 and p99 percentiles of
+ *   request processing time per request type and stage (queue,
+ *   execution, reply, total).
  *
  * These fields have the following meaning:
  *
@@ -231,6 +472,7 @@ lbox_stat_net_call(struct lua_State *L)
 	struct iproto_stats stats;
 	iproto_stats_get(&stats);
 	inject_iproto_stats(L, &stats);
+	inject_iproto_latency(L, -1);
 	return 1;
 }
 
@@ -249,6 +491,7 @@ lbox_stat_net_thread_index(struct lua_State *L)
 	struct iproto_stats stats;
 	iproto_thread_stats_get(&stats, thread_id);
 	inject_iproto_stats(L, &stats);
+	inject_iproto_latency(L, thread_id);
 	return 1;
 }
 
@@ -265,6 +508,7 @@ lbox_stat_net_thread_call(struct lua_State *L)
 		iproto_thread_rmean_foreach(thread_id, set_stat_item, L);
 		iproto_thread_stats_get(&stats, thread_id);
 		inject_iproto_stats(L, &stats);
+		inject_iproto_latency(L, thread_id);
 		lua_rawseti(L, -2, thread_id + 1);
 	}
 	return 1;
@@ -279,6 +523,15 @@ lbox_stat_sql(struct lua_State *L)
 	return 1;
 }
 
+static int
+lbox_stat_tuple_format(struct lua_State *L)
+{
+	struct info_handler info;
+	luaT_info_handler_create(&info, L);
+	tuple_format_stat(&info);
+	return 1;
+}
+
 static const struct luaL_Reg lbox_stat_meta [] = {
 	{"__index", lbox_stat_index},
 	{"__call",  lbox_stat_call},
@@ -303,8 +556,12 @@ box_lua_stat_init(struct lua_State *L)
 {
 	static const struct luaL_Reg statlib [] = {
 		{"vinyl", lbox_stat_vinyl},
+		{"wal", lbox_stat_wal},
 		{"reset", lbox_stat_reset},
 		{"sql", lbox_stat_sql},
+		{"tuple_format", lbox_stat_tuple_format},
+		{"latency", lbox_stat_latency},
+		{"slow_requests", lbox_stat_slow_requests},
 		{NULL, NULL}
 	};
 
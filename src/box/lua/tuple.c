@@ -335,6 +335,30 @@ lbox_tuple_new(lua_State *L)
 	return 1;
 }
 
+/**
+ * box.tuple.from_msgpack(obj) creates a tuple from a msgpack object
+ * holding an array, e.g. box.tuple.from_msgpack(json.to_msgpack(body)),
+ * using the object data as is, same as space:insert() does.
+ * box.tuple.new() wraps a msgpack object into a one-field tuple.
+ */
+static int
+lbox_tuple_from_msgpack(struct lua_State *L)
+{
+	size_t data_len;
+	const char *data = lua_gettop(L) == 1 ?
+			   luamp_get(L, 1, &data_len) : NULL;
+	if (data == NULL || mp_typeof(*data) != MP_ARRAY) {
+		return luaL_error(L, "Usage: box.tuple.from_msgpack("
+				  "msgpack object holding an array)");
+	}
+	box_tuple_format_t *fmt = box_tuple_format_default();
+	struct tuple *tuple = box_tuple_new(fmt, data, data + data_len);
+	if (tuple == NULL)
+		return luaT_error(L);
+	luaT_pushtuple(L, tuple);
+	return 1;
+}
+
 static int
 lbox_tuple_gc(struct lua_State *L)
 {
@@ -504,17 +528,16 @@ lbox_tuple_to_map(struct lua_State *L)
 		const char *name = format->dict->names[i];
 		lua_pushstring(L, name);
 		luamp_decode(L, luaL_msgpack_default, &pos);
+		if (!names_only) {
+			/*
+			 * Access the same field by an index. There
+			 * is no copy for tables - lua optimizes it
+			 * and uses references.
+			 */
+			lua_pushvalue(L, -1);
+			lua_rawseti(L, -4, i + TUPLE_INDEX_BASE);
+		}
 		lua_rawset(L, -3);
-		if (names_only)
-			continue;
-		/*
-		 * Access the same field by an index. There is no
-		 * copy for tables - lua optimizes it and uses
-		 * references.
-		 */
-		lua_pushstring(L, name);
-		lua_rawget(L, -2);
-		lua_rawseti(L, -2, i + TUPLE_INDEX_BASE);
 	}
 	if (names_only)
 		return 1;
@@ -634,6 +657,70 @@ lbox_tuple_transform(struct lua_State *L)
 	return 1;
 }
 
+/**
+ * Cache of field numbers resolved by name in tuple['name']. An
+ * entry is found by the dictionary and the address of the name
+ * string. Lua strings are interned, so the same name used at a call
+ * site has the same address every time, and a hit costs no hash
+ * table lookup.
+ *
+ * An entry is only a hint: a string can be collected and its memory
+ * reused for another one, and a dictionary can be swapped on alter.
+ * So a hit is accepted only if the dictionary still has the name at
+ * the cached field number. Names are unique in a dictionary, so that
+ * is the field number a lookup would return.
+ */
+struct field_name_cache_entry {
+	/** Dictionary of the tuple format. */
+	const struct tuple_dictionary *dict;
+	/** The name, as returned by lua_tolstring(). */
+	const char *name;
+	/** Field number of the name in the dictionary. */
+	uint32_t fieldno;
+};
+
+enum { FIELD_NAME_CACHE_SIZE = 256 };
+
+static struct field_name_cache_entry field_name_cache[FIELD_NAME_CACHE_SIZE];
+
+static inline struct field_name_cache_entry *
+field_name_cache_entry(const struct tuple_dictionary *dict, uint32_t name_hash)
+{
+	uint32_t i = name_hash ^ (uint32_t)((uintptr_t)dict >> 4);
+	return &field_name_cache[i % FIELD_NAME_CACHE_SIZE];
+}
+
+/**
+ * Get the number of the field named @a name from the cache or from
+ * the dictionary, and cache it.
+ * @retval  0 Field is found.
+ * @retval -1 No such field.
+ */
+static inline int
+field_name_cache_fieldno(struct tuple_dictionary *dict, const char *name,
+			 uint32_t name_len, uint32_t name_hash,
+			 uint32_t *fieldno)
+{
+	struct field_name_cache_entry *e = field_name_cache_entry(dict,
+								  name_hash);
+	if (e->dict == dict && e->name == name &&
+	    e->fieldno < dict->name_count) {
+		const char *cached = dict->names[e->fieldno];
+		if (strlen(cached) == name_len &&
+		    memcmp(cached, name, name_len) == 0) {
+			*fieldno = e->fieldno;
+			return 0;
+		}
+	}
+	if (tuple_fieldno_by_name(dict, name, name_len, name_hash,
+				  fieldno) != 0)
+		return -1;
+	e->dict = dict;
+	e->name = name;
+	e->fieldno = *fieldno;
+	return 0;
+}
+
 /**
  * Find a tuple field by JSON path. If a field was not found and a
  * path contains JSON syntax errors, then an exception is raised.
@@ -657,11 +744,18 @@ lbox_tuple_field_by_path(struct lua_State *L)
 	const char *field = NULL, *path = lua_tolstring(L, 2, &len);
 	if (len == 0)
 		return 0;
-	field = tuple_field_raw_by_full_path(tuple_format(tuple),
-					     tuple_data(tuple),
-					     tuple_field_map(tuple),
-					     path, (uint32_t)len,
-					     lua_hashstring(L, 2));
+	struct tuple_format *format = tuple_format(tuple);
+	uint32_t hash = lua_hashstring(L, 2);
+	uint32_t fieldno;
+	if (field_name_cache_fieldno(format->dict, path, (uint32_t)len, hash,
+				     &fieldno) == 0) {
+		field = tuple_field_raw(format, tuple_data(tuple),
+					tuple_field_map(tuple), fieldno);
+	} else {
+		field = tuple_field_raw_by_full_path(format, tuple_data(tuple),
+						     tuple_field_map(tuple),
+						     path, (uint32_t)len, hash);
+	}
 	if (field == NULL)
 		return 0;
 	luamp_decode(L, luaL_msgpack_default, &field);
@@ -708,6 +802,7 @@ static const struct luaL_Reg lbox_tuple_meta[] = {
 
 static const struct luaL_Reg lbox_tuplelib[] = {
 	{"new", lbox_tuple_new},
+	{"from_msgpack", lbox_tuple_from_msgpack},
 	{NULL, NULL}
 };
 
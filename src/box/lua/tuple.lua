@@ -72,6 +72,7 @@ end
 local encode_fix = msgpackffi.internal.encode_fix
 local encode_array = msgpackffi.internal.encode_array
 local encode_r = msgpackffi.internal.encode_r
+local decode_view = msgpackffi.internal.decode_view
 
 local tuple_encode = function(tmpbuf, obj)
     if obj == nil then
@@ -113,6 +114,13 @@ local tuple_bless = function(tuple)
     return tuple_ref
 end
 
+-- Same as tuple_bless(), but for a tuple that is already referenced
+-- by the caller: the reference is passed to the Lua GC.
+local tuple_adopt = function(tuple)
+    local tuple_ref = ffi.gc(ffi.cast(const_tuple_ref_t, tuple), tuple_gc)
+    return tuple_ref
+end
+
 local tuple_check = function(tuple, usage)
     if not is_tuple(tuple) then
         error('Usage: ' .. usage)
@@ -282,6 +290,25 @@ end
 
 msgpackffi.on_encode(const_tuple_ref_t, tuple_to_msgpack)
 
+local view_bufp = ffi.new('const unsigned char *[1]')
+
+-- Returns a field like tuple[fieldno] does, but a string or
+-- a binary field is returned as a pointer to the tuple data and
+-- the field size, without creating a Lua string. The pointer is
+-- valid as long as the tuple is referenced.
+local function tuple_field_view(tuple, fieldno)
+    tuple_check(tuple, "tuple:field_view(fieldno)")
+    if type(fieldno) ~= 'number' then
+        error('Usage: tuple:field_view(fieldno)')
+    end
+    local field = builtin.box_tuple_field(tuple, fieldno - 1)
+    if field == nil then
+        return nil
+    end
+    view_bufp[0] = field
+    return decode_view(view_bufp)
+end
+
 local function tuple_field_by_path(tuple, path)
     tuple_check(tuple, "tuple['field_name']");
     return internal.tuple.tuple_field_by_path(tuple, path)
@@ -301,6 +328,7 @@ local methods = {
     ["upsert"]      = tuple_upsert;
     ["bsize"]       = tuple_bsize;
     ["tomap"]       = internal.tuple.tuple_to_map;
+    ["field_view"]  = tuple_field_view;
 }
 
 -- Aliases for tuple:methods().
@@ -364,6 +392,7 @@ internal.tuple.tostring = nil
 
 -- internal api for box.select and iterators
 internal.tuple.bless = tuple_bless
+internal.tuple.adopt = tuple_adopt
 internal.tuple.encode = tuple_encode
 
 -- Public API, additional to implemented in C.
@@ -39,6 +39,15 @@ struct memtx_allocator_set_mode {
 	}
 };
 
+struct memtx_allocator_delayed_stat {
+	template<typename Allocator, typename...Arg>
+	void
+	invoke(Arg&&...size)
+	{
+		Allocator::delayed_stat(size...);
+	}
+};
+
 void
 memtx_allocators_init(struct memtx_engine *memtx,
 		      struct allocator_settings *settings)
@@ -57,6 +66,14 @@ memtx_allocators_set_mode(enum memtx_engine_free_mode mode)
 		enum memtx_engine_free_mode &>(mode);
 }
 
+size_t
+memtx_allocators_delayed_size(void)
+{
+	size_t size = 0;
+	foreach_memtx_allocator<memtx_allocator_delayed_stat, size_t &>(size);
+	return size;
+}
+
 void
 memtx_allocators_destroy()
 {
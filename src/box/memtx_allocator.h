@@ -33,6 +33,8 @@
 #include "memtx_engine.h"
 #include "tuple.h"
 
+#include <pmatomic.h>
+
 struct PACKED memtx_tuple {
 	/*
 	 * sic: the header of the tuple is used
@@ -50,11 +52,7 @@ class MemtxAllocator {
 public:
 	static void free(void *item)
 	{
-		struct memtx_tuple *memtx_tuple = (struct memtx_tuple *) item;
-		struct tuple *tuple = &memtx_tuple->base;
-		size_t total = tuple_size(tuple) +
-			       offsetof(struct memtx_tuple, base);
-		Allocator::free((void *) memtx_tuple, total);
+		Allocator::free(item, item_size(item));
 	}
 
 	static void free(void *ptr, size_t size)
@@ -64,9 +62,21 @@ public:
 
 	static void delayed_free(void *ptr)
 	{
+		pm_atomic_fetch_add_explicit(&delayed_size, item_size(ptr),
+					     pm_memory_order_relaxed);
 		lifo_push(&MemtxAllocator<Allocator>::lifo, ptr);
 	}
 
+	/**
+	 * Add the size of memory waiting to be freed in the delayed
+	 * free lifo to @a size. Safe to call from any thread.
+	 */
+	static void delayed_stat(size_t &size)
+	{
+		size += pm_atomic_load_explicit(&delayed_size,
+						pm_memory_order_relaxed);
+	}
+
 	static void * alloc(size_t size)
 	{
 		collect_garbage();
@@ -89,10 +99,19 @@ public:
 		void *item;
 		while ((item = lifo_pop(&MemtxAllocator<Allocator>::lifo)))
 			free(item);
+		delayed_size = 0;
 	}
 private:
 	static constexpr int GC_BATCH_SIZE = 100;
 
+	/** Size of a tuple allocation, including the memtx header. */
+	static size_t item_size(void *item)
+	{
+		struct memtx_tuple *memtx_tuple = (struct memtx_tuple *) item;
+		return tuple_size(&memtx_tuple->base) +
+		       offsetof(struct memtx_tuple, base);
+	}
+
 	static void collect_garbage()
 	{
 		if (MemtxAllocator<Allocator>::mode !=
@@ -103,6 +122,9 @@ private:
 				void *item = lifo_pop(&MemtxAllocator<Allocator>::lifo);
 				if (item == NULL)
 					break;
+				pm_atomic_fetch_sub_explicit(
+					&delayed_size, item_size(item),
+					pm_memory_order_relaxed);
 				free(item);
 			}
 		} else {
@@ -111,6 +133,8 @@ private:
 	}
 	static struct lifo lifo;
 	static enum memtx_engine_free_mode mode;
+	/** Total size of tuples in the lifo, see delayed_stat(). */
+	static size_t delayed_size;
 };
 
 template<class Allocator>
@@ -119,6 +143,9 @@ struct lifo MemtxAllocator<Allocator>::lifo;
 template<class Allocator>
 enum memtx_engine_free_mode MemtxAllocator<Allocator>::mode;
 
+template<class Allocator>
+size_t MemtxAllocator<Allocator>::delayed_size;
+
 void
 memtx_allocators_init(struct memtx_engine *memtx,
 		      struct allocator_settings *settings);
@@ -126,6 +153,13 @@ memtx_allocators_init(struct memtx_engine *memtx,
 void
 memtx_allocators_set_mode(enum memtx_engine_free_mode mode);
 
+/**
+ * Return the total size of tuples waiting to be freed because of
+ * delayed free mode. Safe to call from any thread.
+ */
+size_t
+memtx_allocators_delayed_size(void);
+
 void
 memtx_allocators_destroy();
 
@@ -34,8 +34,12 @@
 #include <small/quota.h>
 #include <small/small.h>
 #include <small/mempool.h>
+#include <pmatomic.h>
+#include <sys/stat.h>
 
 #include "fiber.h"
+#include "fiber_cond.h"
+#include "cbus.h"
 #include "errinj.h"
 #include "coio_file.h"
 #include "tuple.h"
@@ -48,11 +52,15 @@
 #include "bootstrap.h"
 #include "replication.h"
 #include "schema.h"
+#include "box.h"
 #include "gc.h"
 #include "raft.h"
 #include "txn_limbo.h"
 #include "memtx_allocator.h"
+#include "info/info.h"
 
+#include <stdio.h>
+#include <sys/mman.h>
 #include <type_traits>
 
 /* sync snapshot every 16MB */
@@ -87,6 +95,217 @@ memtx_end_build_primary_key(struct space *space, void *param)
 	return 0;
 }
 
+/** Timings of building a secondary index. */
+struct memtx_index_build_stat {
+	/** Id of the index. */
+	uint32_t index_id;
+	/** Time spent sorting keys of the index. */
+	double sort_time;
+	/** Time spent building the index structure. */
+	double build_time;
+};
+
+/** Timings of building secondary keys of a space. */
+struct memtx_space_build_stat {
+	/** Link in memtx_build_stat::spaces. */
+	struct rlist in_build_stat;
+	/** Id of the space. */
+	uint32_t space_id;
+	/** Number of tuples in the primary index. */
+	int64_t tuple_count;
+	/** Time spent collecting keys from the primary index. */
+	double fill_time;
+	/** Time spent sorting keys, summed over all indexes. */
+	double sort_time;
+	/** Time spent building index structures in tx. */
+	double build_time;
+	/** Wall clock time spent on the space. */
+	double total_time;
+	/** Number of entries in the index array. */
+	uint32_t index_count;
+	/** Timings of each secondary index. */
+	struct memtx_index_build_stat indexes[0];
+};
+
+/**
+ * Don't bother starting sort threads for spaces with fewer
+ * tuples than this - thread creation would take longer than
+ * sorting itself.
+ */
+enum { MEMTX_SORT_THREADS_MIN_TUPLES = 10000 };
+
+/** State shared by threads sorting secondary keys of a space. */
+struct memtx_sort_ctx {
+	/** Indexes to sort. */
+	struct index **indexes;
+	/** Where to store sort time of each index. */
+	struct memtx_space_build_stat *stat;
+	/** Number of indexes. */
+	int index_count;
+	/** Position of the next index to sort, updated atomically. */
+	int next;
+};
+
+/**
+ * Sort build arrays of indexes from @ctx until there's no more
+ * left to sort. Called concurrently from sort threads and tx.
+ */
+static void
+memtx_sort_ctx_run(struct memtx_sort_ctx *ctx)
+{
+	int i;
+	while ((i = pm_atomic_fetch_add(&ctx->next, 1)) < ctx->index_count) {
+		double start = ev_monotonic_time();
+		memtx_tree_index_sort_build_array(ctx->indexes[i]);
+		ctx->stat->indexes[i].sort_time = ev_monotonic_time() - start;
+	}
+}
+
+static int
+memtx_sort_f(va_list ap)
+{
+	struct memtx_sort_ctx *ctx = va_arg(ap, struct memtx_sort_ctx *);
+	memtx_sort_ctx_run(ctx);
+	return 0;
+}
+
+/**
+ * Sort collected keys of secondary indexes of a space. Every
+ * index is sorted independently so the work is spread among up
+ * to box.cfg.memtx_sort_threads threads. While they are running,
+ * the tx thread keeps serving its event loop.
+ */
+static void
+memtx_sort_secondary_keys(struct memtx_engine *memtx,
+			  struct memtx_sort_ctx *ctx, int64_t n_tuples)
+{
+	int thread_count = MIN(memtx->sort_threads, ctx->index_count);
+	if (n_tuples < MEMTX_SORT_THREADS_MIN_TUPLES || thread_count <= 1) {
+		memtx_sort_ctx_run(ctx);
+		return;
+	}
+	struct cord *cords = (struct cord *)
+		calloc(thread_count, sizeof(*cords));
+	int started = 0;
+	if (cords != NULL) {
+		for (; started < thread_count; started++) {
+			char name[FIBER_NAME_MAX];
+			snprintf(name, sizeof(name), "memtx.sort.%d", started);
+			if (cord_costart(&cords[started], name,
+					 memtx_sort_f, ctx) != 0) {
+				diag_log();
+				break;
+			}
+		}
+	}
+	for (int i = 0; i < started; i++) {
+		/* The thread function never fails. */
+		if (cord_cojoin(&cords[i]) != 0)
+			unreachable();
+	}
+	free(cords);
+	/* Sort whatever is left if we failed to start threads. */
+	memtx_sort_ctx_run(ctx);
+}
+
+/**
+ * Collect keys of all secondary indexes of a space in one pass
+ * over the primary index.
+ */
+static int
+memtx_fill_secondary_keys(struct space *space)
+{
+	struct index *pk = space->index[0];
+	ssize_t n_tuples = index_size(pk);
+	assert(n_tuples >= 0);
+	uint32_t estimated_tuples = n_tuples * 1.2;
+	for (uint32_t j = 1; j < space->index_count; j++) {
+		struct index *index = space->index[j];
+		index_begin_build(index);
+		if (index_reserve(index, estimated_tuples) < 0)
+			return -1;
+		if (n_tuples > 0) {
+			say_info("Adding %zd keys to %s index '%s' ...",
+				 n_tuples, index_type_strs[index->def->type],
+				 index->def->name);
+		}
+	}
+	struct iterator *it = index_create_iterator(pk, ITER_ALL, NULL, 0);
+	if (it == NULL)
+		return -1;
+	int rc;
+	while (true) {
+		struct tuple *tuple;
+		rc = iterator_next(it, &tuple);
+		if (rc != 0 || tuple == NULL)
+			break;
+		for (uint32_t j = 1; j < space->index_count && rc == 0; j++)
+			rc = index_build_next(space->index[j], tuple);
+		if (rc != 0)
+			break;
+	}
+	iterator_delete(it);
+	return rc;
+}
+
+/**
+ * Build all secondary indexes of a space in bulk: collect keys
+ * from the primary index, sort them in parallel and then build
+ * index structures.
+ */
+static int
+memtx_build_secondary_keys_bulk(struct memtx_engine *memtx,
+				struct space *space)
+{
+	uint32_t index_count = space->index_count - 1;
+	struct index **indexes = space->index + 1;
+
+	size_t size = sizeof(struct memtx_space_build_stat) +
+		      index_count * sizeof(struct memtx_index_build_stat);
+	struct memtx_space_build_stat *stat =
+		(struct memtx_space_build_stat *)calloc(1, size);
+	if (stat == NULL) {
+		diag_set(OutOfMemory, size, "malloc",
+			 "struct memtx_space_build_stat");
+		return -1;
+	}
+	stat->space_id = space_id(space);
+	stat->tuple_count = index_size(space->index[0]);
+	stat->index_count = index_count;
+	for (uint32_t j = 0; j < index_count; j++)
+		stat->indexes[j].index_id = indexes[j]->def->iid;
+
+	double start = ev_monotonic_time();
+	if (memtx_fill_secondary_keys(space) != 0) {
+		free(stat);
+		return -1;
+	}
+	double sort_start = ev_monotonic_time();
+	stat->fill_time = sort_start - start;
+
+	struct memtx_sort_ctx ctx;
+	ctx.indexes = indexes;
+	ctx.stat = stat;
+	ctx.index_count = index_count;
+	ctx.next = 0;
+	memtx_sort_secondary_keys(memtx, &ctx, stat->tuple_count);
+	for (uint32_t j = 0; j < index_count; j++)
+		stat->sort_time += stat->indexes[j].sort_time;
+
+	double build_start = ev_monotonic_time();
+	for (uint32_t j = 0; j < index_count; j++) {
+		double index_start = ev_monotonic_time();
+		index_end_build(indexes[j]);
+		stat->indexes[j].build_time = ev_monotonic_time() - index_start;
+		memtx->build_stat.indexes_done++;
+	}
+	double end = ev_monotonic_time();
+	stat->build_time = end - build_start;
+	stat->total_time = end - start;
+	rlist_add_tail_entry(&memtx->build_stat.spaces, stat, in_build_stat);
+	return 0;
+}
+
 /**
  * Secondary indexes are built in bulk after all data is
  * recovered. This function enables secondary keys on a space.
@@ -96,6 +315,7 @@ memtx_end_build_primary_key(struct space *space, void *param)
 static int
 memtx_build_secondary_keys(struct space *space, void *param)
 {
+	struct memtx_engine *memtx = (struct memtx_engine *)param;
 	struct memtx_space *memtx_space = (struct memtx_space *)space;
 	if (space->engine != param || space_index(space, 0) == NULL ||
 	    memtx_space->replace == memtx_space_replace_all_keys)
@@ -111,19 +331,51 @@ memtx_build_secondary_keys(struct space *space, void *param)
 				 space_name(space));
 		}
 
-		for (uint32_t j = 1; j < space->index_count; j++) {
-			if (index_build(space->index[j], pk) < 0)
-				return -1;
-		}
+		if (memtx_build_secondary_keys_bulk(memtx, space) != 0)
+			return -1;
 
 		if (n_tuples > 0) {
 			say_info("Space '%s': done", space_name(space));
 		}
 	}
+	memtx->build_stat.spaces_done++;
 	memtx_space->replace = memtx_space_replace_all_keys;
 	return 0;
 }
 
+/** Count spaces whose secondary keys haven't been built yet. */
+static int
+memtx_count_unbuilt_spaces(struct space *space, void *param)
+{
+	struct memtx_engine *memtx = (struct memtx_engine *)param;
+	struct memtx_space *memtx_space = (struct memtx_space *)space;
+	if (space->engine != param || space_index(space, 0) == NULL ||
+	    memtx_space->replace == memtx_space_replace_all_keys)
+		return 0;
+	memtx->build_stat.space_count++;
+	return 0;
+}
+
+/** Build secondary keys of all memtx spaces. */
+static int
+memtx_engine_build_secondary_keys(struct memtx_engine *memtx)
+{
+	struct memtx_build_stat *stat = &memtx->build_stat;
+	stat->space_count = 0;
+	stat->spaces_done = 0;
+	space_foreach(memtx_count_unbuilt_spaces, memtx);
+	stat->in_progress = true;
+	double start = ev_monotonic_time();
+	int rc = space_foreach(memtx_build_secondary_keys, memtx);
+	stat->time += ev_monotonic_time() - start;
+	stat->in_progress = false;
+	if (rc == 0 && stat->indexes_done > 0) {
+		say_info("Built %d secondary indexes in %.3f sec",
+			 stat->indexes_done, stat->time);
+	}
+	return rc;
+}
+
 static void
 memtx_engine_shutdown(struct engine *engine)
 {
@@ -145,13 +397,397 @@ memtx_engine_shutdown(struct engine *engine)
 	slab_cache_destroy(&memtx->slab_cache);
 	tuple_arena_destroy(&memtx->arena);
 
+	struct memtx_space_build_stat *stat, *next;
+	rlist_foreach_entry_safe(stat, &memtx->build_stat.spaces,
+				 in_build_stat, next)
+		free(stat);
+
 	xdir_destroy(&memtx->snap_dir);
 	free(memtx);
 }
 
 static int
 memtx_engine_recover_snapshot_row(struct memtx_engine *memtx,
-				  struct xrow_header *row, int *is_space_system);
+				  struct xrow_header *row,
+				  struct request *request,
+				  int *is_space_system);
+
+enum {
+	/** Max number of rows in a snapshot batch. */
+	MEMTX_SNAP_BATCH_ROWS = 1024,
+	/**
+	 * Max total size of row bodies in a snapshot batch.
+	 * A batch may exceed it by one row.
+	 */
+	MEMTX_SNAP_BATCH_SIZE = 1024 * 1024,
+	/** Max number of batches read ahead of tx. */
+	MEMTX_SNAP_READ_AHEAD = 4,
+};
+
+struct memtx_snap_reader;
+
+/**
+ * A batch of snapshot rows read and decoded by the snapshot
+ * reader thread. Row bodies are copied to the memory owned by
+ * the batch so they stay valid until the batch is freed.
+ */
+struct memtx_snap_batch {
+	/** Message used for reading the batch in the reader thread. */
+	struct cbus_call_msg base;
+	/** The reader the batch is read by. */
+	struct memtx_snap_reader *reader;
+	/** Link in memtx_snap_reader::ready. */
+	struct stailq_entry in_ready;
+	/** Number of rows in the batch. Zero means EOF. */
+	int row_count;
+	/** Row bodies. */
+	char *data;
+	/** Size of data used by row bodies. */
+	size_t data_size;
+	/** Size of allocated data. */
+	size_t data_capacity;
+	/** Offset of each row body in data. */
+	size_t body_offset[MEMTX_SNAP_BATCH_ROWS];
+	/** Set if the request of the corresponding row was decoded. */
+	bool is_decoded[MEMTX_SNAP_BATCH_ROWS];
+	/** Row headers. */
+	struct xrow_header rows[MEMTX_SNAP_BATCH_ROWS];
+	/** DML requests decoded from rows. */
+	struct request requests[MEMTX_SNAP_BATCH_ROWS];
+};
+
+/** Message used for opening and closing the snapshot. */
+struct memtx_snap_reader_msg {
+	struct cbus_call_msg base;
+	/** The reader to open or close the snapshot for. */
+	struct memtx_snap_reader *reader;
+};
+
+/**
+ * Snapshot reader. To offload tx, reading, decompression and
+ * decoding of snapshot rows are done in a separate thread, which
+ * reads rows in batches ahead of tx so that tx only has to apply
+ * them. Batches are requested from the reader thread by a tx
+ * fiber, while the main recovery fiber applies previously read
+ * batches.
+ */
+struct memtx_snap_reader {
+	/** Snapshot file name. */
+	const char *filename;
+	/** Reader thread. */
+	struct cord cord;
+	/** Pipe from tx to the reader thread. */
+	struct cpipe reader_pipe;
+	/** Pipe from the reader thread to tx. */
+	struct cpipe tx_pipe;
+	/** Snapshot cursor, used only by the reader thread. */
+	struct xlog_cursor cursor;
+	/** box.cfg.force_recovery. */
+	bool force_recovery;
+	/**
+	 * Set if corrupted rows may be skipped, i.e. the last
+	 * read row belongs to a non-system space and
+	 * box.cfg.force_recovery is set.
+	 */
+	bool skip_corrupted;
+	/** Set if the reader has reached the snapshot EOF. */
+	bool is_eof;
+	/** Fiber fetching batches from the reader thread. */
+	struct fiber *fetcher;
+	/** Batches read but not applied yet. */
+	struct stailq ready;
+	/** Length of the ready list. */
+	int ready_count;
+	/** Set when the fetcher fiber is done. */
+	bool is_done;
+	/** Set when tx wants the reader to stop. */
+	bool is_stopped;
+	/** Signaled when the reader state changes. */
+	struct fiber_cond cond;
+};
+
+static struct memtx_snap_batch *
+memtx_snap_batch_new(struct memtx_snap_reader *reader)
+{
+	struct memtx_snap_batch *batch =
+		(struct memtx_snap_batch *)malloc(sizeof(*batch));
+	if (batch == NULL) {
+		diag_set(OutOfMemory, sizeof(*batch), "malloc",
+			 "struct memtx_snap_batch");
+		return NULL;
+	}
+	batch->reader = reader;
+	batch->row_count = 0;
+	batch->data = NULL;
+	batch->data_size = 0;
+	batch->data_capacity = 0;
+	return batch;
+}
+
+static void
+memtx_snap_batch_delete(struct memtx_snap_batch *batch)
+{
+	free(batch->data);
+	free(batch);
+}
+
+/** Copy a row body to the batch memory. */
+static int
+memtx_snap_batch_add_body(struct memtx_snap_batch *batch,
+			  const struct xrow_header *row)
+{
+	size_t size = 0;
+	for (int i = 0; i < row->bodycnt; i++)
+		size += row->body[i].iov_len;
+	if (batch->data_size + size > batch->data_capacity) {
+		size_t capacity = MAX(batch->data_capacity * 2,
+				      batch->data_size + size);
+		capacity = MAX(capacity, (size_t)MEMTX_SNAP_BATCH_SIZE / 4);
+		char *data = (char *)realloc(batch->data, capacity);
+		if (data == NULL) {
+			diag_set(OutOfMemory, capacity, "realloc",
+				 "snapshot batch");
+			return -1;
+		}
+		batch->data = data;
+		batch->data_capacity = capacity;
+	}
+	batch->body_offset[batch->row_count] = batch->data_size;
+	for (int i = 0; i < row->bodycnt; i++) {
+		memcpy(batch->data + batch->data_size, row->body[i].iov_base,
+		       row->body[i].iov_len);
+		batch->data_size += row->body[i].iov_len;
+	}
+	return 0;
+}
+
+/**
+ * Read the next batch of rows from the snapshot and decode them.
+ * Runs in the reader thread.
+ */
+static int
+memtx_snap_batch_read_cb(struct cbus_call_msg *base)
+{
+	struct memtx_snap_batch *batch = (struct memtx_snap_batch *)base;
+	struct memtx_snap_reader *reader = batch->reader;
+	while (batch->row_count < MEMTX_SNAP_BATCH_ROWS &&
+	       batch->data_size < MEMTX_SNAP_BATCH_SIZE) {
+		struct xrow_header *row = &batch->rows[batch->row_count];
+		int rc = xlog_cursor_next(&reader->cursor, row,
+					  reader->skip_corrupted);
+		if (rc < 0)
+			return -1;
+		if (rc > 0) {
+			reader->is_eof = xlog_cursor_is_eof(&reader->cursor);
+			break;
+		}
+		if (memtx_snap_batch_add_body(batch, row) != 0)
+			return -1;
+		batch->row_count++;
+	}
+	/*
+	 * Now that the batch memory won't be reallocated, point
+	 * rows to it and decode DML requests.
+	 */
+	for (int i = 0; i < batch->row_count; i++) {
+		struct xrow_header *row = &batch->rows[i];
+		size_t size = 0;
+		for (int j = 0; j < row->bodycnt; j++)
+			size += row->body[j].iov_len;
+		if (row->bodycnt > 0) {
+			row->body[0].iov_base = batch->data +
+						batch->body_offset[i];
+			row->body[0].iov_len = size;
+			row->bodycnt = 1;
+		}
+		batch->is_decoded[i] = false;
+		if (row->type != IPROTO_INSERT)
+			continue;
+		struct request *request = &batch->requests[i];
+		if (xrow_decode_dml(row, request,
+				    dml_request_key_map(row->type)) != 0) {
+			/* tx will decode the row again to report it. */
+			diag_clear(diag_get());
+			continue;
+		}
+		batch->is_decoded[i] = true;
+		reader->skip_corrupted =
+			request->space_id >= BOX_SYSTEM_ID_MAX &&
+			reader->force_recovery;
+	}
+	return 0;
+}
+
+static int
+memtx_snap_reader_open_cb(struct cbus_call_msg *base)
+{
+	struct memtx_snap_reader_msg *msg =
+		(struct memtx_snap_reader_msg *)base;
+	struct memtx_snap_reader *reader = msg->reader;
+	return xlog_cursor_open(&reader->cursor, reader->filename);
+}
+
+static int
+memtx_snap_reader_close_cb(struct cbus_call_msg *base)
+{
+	struct memtx_snap_reader_msg *msg =
+		(struct memtx_snap_reader_msg *)base;
+	struct memtx_snap_reader *reader = msg->reader;
+	if (xlog_cursor_is_open(&reader->cursor))
+		reader->is_eof = xlog_cursor_is_eof(&reader->cursor);
+	xlog_cursor_close(&reader->cursor, false);
+	return 0;
+}
+
+/** Execute a function on behalf of the reader thread. */
+static int
+memtx_snap_reader_call(struct memtx_snap_reader *reader,
+		       struct cbus_call_msg *msg, cbus_call_f func)
+{
+	bool cancellable = fiber_set_cancellable(false);
+	int rc = cbus_call(&reader->reader_pipe, &reader->tx_pipe,
+			   msg, func, NULL, TIMEOUT_INFINITY);
+	fiber_set_cancellable(cancellable);
+	return rc;
+}
+
+/** Reader thread function. */
+static int
+memtx_snap_reader_f(va_list ap)
+{
+	struct memtx_snap_reader *reader =
+		va_arg(ap, struct memtx_snap_reader *);
+	struct cbus_endpoint endpoint;
+	cpipe_create(&reader->tx_pipe, "tx_prio");
+	cbus_endpoint_create(&endpoint, cord_name(cord()),
+			     fiber_schedule_cb, fiber());
+	cbus_loop(&endpoint);
+	cbus_endpoint_destroy(&endpoint, cbus_process);
+	cpipe_destroy(&reader->tx_pipe);
+	return 0;
+}
+
+/**
+ * Tx fiber requesting batches from the reader thread so that
+ * up to MEMTX_SNAP_READ_AHEAD batches are always ready.
+ */
+static int
+memtx_snap_reader_fetch_f(va_list ap)
+{
+	struct memtx_snap_reader *reader =
+		va_arg(ap, struct memtx_snap_reader *);
+	int rc = 0;
+	while (!reader->is_stopped) {
+		if (reader->ready_count >= MEMTX_SNAP_READ_AHEAD) {
+			fiber_cond_wait(&reader->cond);
+			continue;
+		}
+		struct memtx_snap_batch *batch = memtx_snap_batch_new(reader);
+		if (batch == NULL) {
+			rc = -1;
+			break;
+		}
+		rc = memtx_snap_reader_call(reader, &batch->base,
+					    memtx_snap_batch_read_cb);
+		if (rc != 0 || batch->row_count == 0) {
+			memtx_snap_batch_delete(batch);
+			break;
+		}
+		stailq_add_tail_entry(&reader->ready, batch, in_ready);
+		reader->ready_count++;
+		fiber_cond_broadcast(&reader->cond);
+	}
+	reader->is_done = true;
+	fiber_cond_broadcast(&reader->cond);
+	return rc;
+}
+
+/** Start the reader thread and open the snapshot in it. */
+static int
+memtx_snap_reader_start(struct memtx_snap_reader *reader,
+			const char *filename, bool force_recovery)
+{
+	memset(reader, 0, sizeof(*reader));
+	reader->filename = filename;
+	reader->force_recovery = force_recovery;
+	reader->skip_corrupted = false;
+	stailq_create(&reader->ready);
+	fiber_cond_create(&reader->cond);
+	const char *name = "snapshot.reader";
+	if (cord_costart(&reader->cord, name,
+			 memtx_snap_reader_f, reader) != 0)
+		goto fail;
+	cpipe_create(&reader->reader_pipe, name);
+
+	struct memtx_snap_reader_msg msg;
+	msg.reader = reader;
+	if (memtx_snap_reader_call(reader, &msg.base,
+				   memtx_snap_reader_open_cb) != 0)
+		goto fail_stop;
+
+	reader->fetcher = fiber_new("snapshot.fetch",
+				    memtx_snap_reader_fetch_f);
+	if (reader->fetcher == NULL)
+		goto fail_close;
+	fiber_set_joinable(reader->fetcher, true);
+	fiber_start(reader->fetcher, reader);
+	return 0;
+fail_close:
+	memtx_snap_reader_call(reader, &msg.base, memtx_snap_reader_close_cb);
+fail_stop:
+	cbus_stop_loop(&reader->reader_pipe);
+	cpipe_destroy(&reader->reader_pipe);
+	if (cord_join(&reader->cord) != 0)
+		panic("failed to join snapshot reader thread");
+fail:
+	fiber_cond_destroy(&reader->cond);
+	return -1;
+}
+
+/**
+ * Get the next batch read from the snapshot. Returns NULL on EOF
+ * or error, in which case memtx_snap_reader_stop() returns -1.
+ */
+static struct memtx_snap_batch *
+memtx_snap_reader_next(struct memtx_snap_reader *reader)
+{
+	while (stailq_empty(&reader->ready) && !reader->is_done)
+		fiber_cond_wait(&reader->cond);
+	if (stailq_empty(&reader->ready))
+		return NULL;
+	struct memtx_snap_batch *batch =
+		stailq_shift_entry(&reader->ready, struct memtx_snap_batch,
+				   in_ready);
+	reader->ready_count--;
+	fiber_cond_broadcast(&reader->cond);
+	return batch;
+}
+
+/**
+ * Stop the reader, close the snapshot and join the reader thread.
+ * Returns the status of reading, @is_eof is set if the snapshot
+ * EOF marker was read.
+ */
+static int
+memtx_snap_reader_stop(struct memtx_snap_reader *reader, bool *is_eof)
+{
+	reader->is_stopped = true;
+	fiber_cond_broadcast(&reader->cond);
+	int rc = fiber_join(reader->fetcher);
+	struct memtx_snap_batch *batch, *next;
+	stailq_foreach_entry_safe(batch, next, &reader->ready, in_ready)
+		memtx_snap_batch_delete(batch);
+	struct memtx_snap_reader_msg msg;
+	msg.reader = reader;
+	memtx_snap_reader_call(reader, &msg.base, memtx_snap_reader_close_cb);
+	*is_eof = reader->is_eof;
+	cbus_stop_loop(&reader->reader_pipe);
+	cpipe_destroy(&reader->reader_pipe);
+	if (cord_join(&reader->cord) != 0)
+		panic("failed to join snapshot reader thread");
+	fiber_cond_destroy(&reader->cond);
+	return rc;
+}
 
 int
 memtx_engine_recover_snapshot(struct memtx_engine *memtx,
@@ -164,51 +800,89 @@ memtx_engine_recover_snapshot(struct memtx_engine *memtx,
 						    signature, NONE);
 
 	say_info("recovering from `%s'", filename);
-	struct xlog_cursor cursor;
-	if (xlog_cursor_open(&cursor, filename) < 0)
+	/*
+	 * Remember the snapshot size: it is used to pace writing
+	 * of the next snapshot, see memtx_engine_snap_rate_limit().
+	 */
+	struct stat st;
+	if (stat(filename, &st) == 0)
+		memtx->snap_size = st.st_size;
+	struct memtx_snap_reader reader;
+	if (memtx_snap_reader_start(&reader, filename,
+				    memtx->force_recovery) != 0)
 		return -1;
 
-	int rc;
-	struct xrow_header row;
-	uint64_t row_count = 0;
+	struct memtx_recovery_stat *stat = &memtx->recovery_stat;
+	stat->in_progress = true;
+	stat->row_count = 0;
+	double start = ev_monotonic_time();
+	int rc = 0;
 	int is_space_system = -1;
 	bool force_recovery = false;
-	/*
-	 * In case when we read system space, we can't ignore errors.
-	 */
-	while ((rc = xlog_cursor_next(&cursor, &row, force_recovery)) == 0) {
-		row.lsn = signature;
-		rc = memtx_engine_recover_snapshot_row(memtx, &row,
-						       &is_space_system);
-		force_recovery = is_space_system == 0 ?
-				 memtx->force_recovery : false;
-		if (rc < 0) {
-			if (!force_recovery)
-				break;
-			say_error("can't apply row: ");
-			diag_log();
-		}
-		++row_count;
-		if (row_count % 100000 == 0) {
-			say_info_ratelimited("%.1fM rows processed",
-					     row_count / 1e6);
-			fiber_yield_timeout(0);
+	struct memtx_snap_batch *batch;
+	while (rc == 0 && (batch = memtx_snap_reader_next(&reader)) != NULL) {
+		for (int i = 0; i < batch->row_count; i++) {
+			struct xrow_header *row = &batch->rows[i];
+			row->lsn = signature;
+			rc = memtx_engine_recover_snapshot_row(memtx, row,
+				batch->is_decoded[i] ?
+				&batch->requests[i] : NULL,
+				&is_space_system);
+			/*
+			 * In case when we read system space, we can't
+			 * ignore errors.
+			 */
+			force_recovery = is_space_system == 0 ?
+					 memtx->force_recovery : false;
+			if (rc < 0) {
+				if (!force_recovery)
+					break;
+				say_error("can't apply row: ");
+				diag_log();
+				rc = 0;
+			}
+			++stat->row_count;
+			if (stat->row_count % 100000 == 0) {
+				stat->time = ev_monotonic_time() - start;
+				say_info_ratelimited("%.1fM rows processed, "
+						     "%.0f rows/s",
+						     stat->row_count / 1e6,
+						     stat->row_count /
+						     stat->time);
+				fiber_yield_timeout(0);
+			}
 		}
+		memtx_snap_batch_delete(batch);
 	}
-	xlog_cursor_close(&cursor, false);
+	/* Keep the error that stopped applying rows, if any. */
+	struct diag diag;
+	diag_create(&diag);
+	if (rc != 0)
+		diag_move(diag_get(), &diag);
+	bool is_eof;
+	if (memtx_snap_reader_stop(&reader, &is_eof) != 0)
+		rc = -1;
+	else if (rc != 0)
+		diag_move(&diag, diag_get());
+	diag_destroy(&diag);
+	stat->time = ev_monotonic_time() - start;
+	stat->in_progress = false;
 	if (rc < 0 || is_space_system < 0)
 		return -1;
+	say_info("%.1fM rows recovered in %.3f sec, %.0f rows/s",
+		 stat->row_count / 1e6, stat->time,
+		 stat->time > 0 ? stat->row_count / stat->time : 0);
 
 	/**
 	 * We should never try to read snapshots with no EOF
 	 * marker - such snapshots are very likely corrupted and
 	 * should not be trusted.
 	 */
-	if (!xlog_cursor_is_eof(&cursor)) {
+	if (!is_eof) {
 		if (!memtx->force_recovery)
-			panic("snapshot `%s' has no EOF marker", cursor.name);
+			panic("snapshot `%s' has no EOF marker", filename);
 		else
-			say_error("snapshot `%s' has no EOF marker", cursor.name);
+			say_error("snapshot `%s' has no EOF marker", filename);
 	}
 
 	return 0;
@@ -244,7 +918,9 @@ memtx_engine_recover_synchro(const struct xrow_header *row)
 
 static int
 memtx_engine_recover_snapshot_row(struct memtx_engine *memtx,
-				  struct xrow_header *row, int *is_space_system)
+				  struct xrow_header *row,
+				  struct request *request,
+				  int *is_space_system)
 {
 	assert(row->bodycnt == 1); /* always 1 for read */
 	if (row->type != IPROTO_INSERT) {
@@ -257,11 +933,15 @@ memtx_engine_recover_snapshot_row(struct memtx_engine *memtx,
 		return -1;
 	}
 	int rc;
-	struct request request;
-	if (xrow_decode_dml(row, &request, dml_request_key_map(row->type)) != 0)
-		return -1;
-	*is_space_system = (request.space_id < BOX_SYSTEM_ID_MAX);
-	struct space *space = space_cache_find(request.space_id);
+	struct request decoded;
+	if (request == NULL) {
+		request = &decoded;
+		if (xrow_decode_dml(row, request,
+				    dml_request_key_map(row->type)) != 0)
+			return -1;
+	}
+	*is_space_system = (request->space_id < BOX_SYSTEM_ID_MAX);
+	struct space *space = space_cache_find(request->space_id);
 	if (space == NULL)
 		return -1;
 	/* memtx snapshot must contain only memtx spaces */
@@ -272,13 +952,13 @@ memtx_engine_recover_snapshot_row(struct memtx_engine *memtx,
 	struct txn *txn = txn_begin();
 	if (txn == NULL)
 		return -1;
-	if (txn_begin_stmt(txn, space, request.type) != 0)
+	if (txn_begin_stmt(txn, space, request->type) != 0)
 		goto rollback;
 	/* no access checks here - applier always works with admin privs */
 	struct tuple *unused;
-	if (space_execute_dml(space, txn, &request, &unused) != 0)
+	if (space_execute_dml(space, txn, request, &unused) != 0)
 		goto rollback_stmt;
-	if (txn_commit_stmt(txn, &request) != 0)
+	if (txn_commit_stmt(txn, request) != 0)
 		goto rollback;
 	/*
 	 * Snapshot rows are confirmed by definition. They don't need to go to
@@ -350,7 +1030,7 @@ memtx_engine_begin_final_recovery(struct engine *engine)
 		 * unique keys.
 		 */
 		memtx->state = MEMTX_OK;
-		if (space_foreach(memtx_build_secondary_keys, memtx) != 0)
+		if (memtx_engine_build_secondary_keys(memtx) != 0)
 			return -1;
 	}
 	return 0;
@@ -368,7 +1048,7 @@ memtx_engine_begin_hot_standby(struct engine *engine)
 	if (memtx->state != MEMTX_OK) {
 		assert(memtx->state == MEMTX_FINAL_RECOVERY);
 		memtx->state = MEMTX_OK;
-		if (space_foreach(memtx_build_secondary_keys, memtx) != 0)
+		if (memtx_engine_build_secondary_keys(memtx) != 0)
 			return -1;
 	}
 	return 0;
@@ -387,7 +1067,7 @@ memtx_engine_end_recovery(struct engine *engine)
 	if (memtx->state != MEMTX_OK) {
 		assert(memtx->state == MEMTX_FINAL_RECOVERY);
 		memtx->state = MEMTX_OK;
-		if (space_foreach(memtx_build_secondary_keys, memtx) != 0)
+		if (memtx_engine_build_secondary_keys(memtx) != 0)
 			return -1;
 	}
 	xdir_collect_inprogress(&memtx->snap_dir);
@@ -431,11 +1111,14 @@ memtx_engine_commit(struct engine *engine, struct txn *txn)
 	struct txn_stmt *stmt;
 	stailq_foreach_entry(stmt, &txn->stmts, next) {
 		if (stmt->add_story != NULL || stmt->del_story != NULL) {
-			ssize_t bsize = memtx_tx_history_commit_stmt(stmt);
 			assert(stmt->space->engine == engine);
-			struct memtx_space *mspace =
-				(struct memtx_space *)stmt->space;
-			mspace->bsize += bsize;
+			struct tuple *old_tuple = stmt->del_story != NULL ?
+						  stmt->del_story->tuple : NULL;
+			struct tuple *new_tuple = stmt->add_story != NULL ?
+						  stmt->add_story->tuple : NULL;
+			memtx_space_update_bsize(stmt->space, old_tuple,
+						 new_tuple);
+			memtx_tx_history_commit_stmt(stmt);
 		}
 	}
 }
@@ -507,7 +1190,8 @@ memtx_engine_bootstrap(struct engine *engine)
 	int rc, is_space_system;
 	struct xrow_header row;
 	while ((rc = xlog_cursor_next(&cursor, &row, true)) == 0) {
-		rc = memtx_engine_recover_snapshot_row(memtx, &row, &is_space_system);
+		rc = memtx_engine_recover_snapshot_row(memtx, &row, NULL,
+						       &is_space_system);
 		if (rc < 0)
 			break;
 	}
@@ -594,10 +1278,20 @@ struct checkpoint {
 	 * checkpoint already exists.
 	 */
 	bool touch;
+	/**
+	 * Size of memory held by delayed free above which the
+	 * snapshot is written ignoring snap_io_rate_limit.
+	 */
+	size_t delayed_free_limit;
+	/** Size of the written snapshot file, in bytes. */
+	int64_t size;
+	/** Time it took to write the snapshot, in seconds. */
+	double write_time;
 };
 
 static struct checkpoint *
-checkpoint_new(const char *snap_dirname, uint64_t snap_io_rate_limit)
+checkpoint_new(const char *snap_dirname, uint64_t snap_io_rate_limit,
+	       size_t delayed_free_limit)
 {
 	struct checkpoint *ckpt = (struct checkpoint *)malloc(sizeof(*ckpt));
 	if (ckpt == NULL) {
@@ -616,6 +1310,9 @@ checkpoint_new(const char *snap_dirname, uint64_t snap_io_rate_limit)
 	box_raft_checkpoint_local(&ckpt->raft);
 	txn_limbo_checkpoint(&txn_limbo, &ckpt->synchro_state);
 	ckpt->touch = false;
+	ckpt->delayed_free_limit = delayed_free_limit;
+	ckpt->size = 0;
+	ckpt->write_time = 0;
 	return ckpt;
 }
 
@@ -713,6 +1410,27 @@ checkpoint_write_synchro(struct xlog *l, const struct synchro_request *req)
 	return checkpoint_write_row(l, &row);
 }
 
+/**
+ * Tuples deleted while a snapshot is written can't be freed until
+ * it completes, so memory usage grows with the write rate. Once
+ * the memory held this way exceeds the limit, stop throttling the
+ * snapshot: the sooner it completes, the sooner the memory is
+ * freed. snap_io_rate_limit is thus a soft limit.
+ */
+static void
+checkpoint_check_rate_limit(struct checkpoint *ckpt, struct xlog *snap)
+{
+	if (snap->opts.rate_limit == 0)
+		return;
+	size_t delayed_free_size = memtx_allocators_delayed_size();
+	if (delayed_free_size <= ckpt->delayed_free_limit)
+		return;
+	say_warn("memory waiting for snapshot completion (%zu bytes) "
+		 "exceeds %zu bytes, ignoring snap_io_rate_limit",
+		 delayed_free_size, ckpt->delayed_free_limit);
+	snap->opts.rate_limit = 0;
+}
+
 static int
 checkpoint_f(va_list ap)
 {
@@ -733,6 +1451,7 @@ checkpoint_f(va_list ap)
 		return -1;
 
 	say_info("saving snapshot `%s'", snap.filename);
+	double start = ev_monotonic_time();
 	ERROR_INJECT_SLEEP(ERRINJ_SNAP_WRITE_DELAY);
 	struct checkpoint_entry *entry;
 	rlist_foreach_entry(entry, &ckpt->entries, link) {
@@ -744,6 +1463,7 @@ checkpoint_f(va_list ap)
 			if (checkpoint_write_tuple(&snap, entry->space_id,
 					entry->group_id, data, size) != 0)
 				goto fail;
+			checkpoint_check_rate_limit(ckpt, &snap);
 		}
 		if (rc != 0)
 			goto fail;
@@ -755,7 +1475,9 @@ checkpoint_f(va_list ap)
 	if (xlog_flush(&snap) < 0)
 		goto fail;
 
+	ckpt->size = snap.offset;
 	xlog_close(&snap, false);
+	ckpt->write_time = ev_monotonic_time() - start;
 	say_info("done");
 	return 0;
 fail:
@@ -763,6 +1485,23 @@ fail:
 	return -1;
 }
 
+/**
+ * Return the rate at which the next snapshot should be written,
+ * in bytes per second, or 0 if the rate is unlimited.
+ */
+static uint64_t
+memtx_engine_snap_rate_limit(struct memtx_engine *memtx)
+{
+	uint64_t limit = memtx->snap_io_rate_limit;
+	if (memtx->snap_write_duration > 0 && memtx->snap_size > 0) {
+		uint64_t rate = MAX(memtx->snap_size /
+				    memtx->snap_write_duration, 1);
+		if (limit == 0 || rate < limit)
+			limit = rate;
+	}
+	return limit;
+}
+
 static int
 memtx_engine_begin_checkpoint(struct engine *engine, bool is_scheduled)
 {
@@ -770,8 +1509,15 @@ memtx_engine_begin_checkpoint(struct engine *engine, bool is_scheduled)
 	struct memtx_engine *memtx = (struct memtx_engine *)engine;
 
 	assert(memtx->checkpoint == NULL);
+	/*
+	 * Let delayed free take at most a half of the memory
+	 * that is left in the quota.
+	 */
+	size_t delayed_free_limit = (quota_total(&memtx->quota) -
+				     quota_used(&memtx->quota)) / 2;
 	memtx->checkpoint = checkpoint_new(memtx->snap_dir.dirname,
-					   memtx->snap_io_rate_limit);
+					   memtx_engine_snap_rate_limit(memtx),
+					   delayed_free_limit);
 	if (memtx->checkpoint == NULL)
 		return -1;
 
@@ -840,6 +1586,8 @@ memtx_engine_commit_checkpoint(struct engine *engine,
 		int rc = coio_rename(from, to);
 		if (rc != 0)
 			panic("can't rename .snap.inprogress");
+		memtx->snap_size = memtx->checkpoint->size;
+		memtx->snap_write_time = memtx->checkpoint->write_time;
 	}
 
 	struct vclock last;
@@ -1119,6 +1867,68 @@ memtx_engine_gc_f(va_list va)
 	return 0;
 }
 
+/** How often spaces are checked for expired tuples, in seconds. */
+static const double MEMTX_EXPIRE_PERIOD = 1;
+
+/**
+ * Max number of memtx_space_expire() batches done for one space
+ * per period, so that a huge space doesn't starve the others.
+ */
+enum { MEMTX_EXPIRE_BATCH_COUNT_MAX = 100 };
+
+/** Identifiers of spaces with the expire_field option. */
+struct memtx_expire_spaces {
+	uint32_t *ids;
+	uint32_t count;
+	uint32_t capacity;
+};
+
+static int
+memtx_expire_spaces_add(struct space *space, void *data)
+{
+	struct memtx_expire_spaces *spaces =
+		(struct memtx_expire_spaces *)data;
+	if (space->def->opts.expire_field == 0 || !space_is_memtx(space))
+		return 0;
+	if (spaces->count == spaces->capacity) {
+		spaces->capacity = MAX(spaces->capacity * 2, 16u);
+		spaces->ids = (uint32_t *)xrealloc(spaces->ids,
+			spaces->capacity * sizeof(*spaces->ids));
+	}
+	spaces->ids[spaces->count++] = space_id(space);
+	return 0;
+}
+
+static int
+memtx_engine_expire_f(va_list va)
+{
+	struct memtx_engine *memtx = va_arg(va, struct memtx_engine *);
+	struct memtx_expire_spaces spaces = {NULL, 0, 0};
+	while (!fiber_is_cancelled()) {
+		fiber_sleep(MEMTX_EXPIRE_PERIOD);
+		/* Replicas receive the deletions from the master. */
+		if (memtx->state != MEMTX_OK || box_is_ro())
+			continue;
+		spaces.count = 0;
+		space_foreach(memtx_expire_spaces_add, &spaces);
+		for (uint32_t i = 0; i < spaces.count; i++) {
+			bool is_done = false;
+			for (int j = 0; j < MEMTX_EXPIRE_BATCH_COUNT_MAX &&
+			     !is_done && !box_is_ro(); j++) {
+				if (memtx_space_expire(spaces.ids[i],
+						       fiber_time(),
+						       &is_done) != 0) {
+					diag_log();
+					break;
+				}
+				fiber_sleep(0);
+			}
+		}
+	}
+	free(spaces.ids);
+	return 0;
+}
+
 void
 memtx_set_tuple_format_vtab(const char *allocator_name)
 {
@@ -1133,10 +1943,34 @@ memtx_set_tuple_format_vtab(const char *allocator_name)
 	}
 }
 
+/**
+ * Ask the kernel to back the memtx arena with transparent huge
+ * pages. The arena is mapped aligned by the slab size, which is
+ * a multiple of the huge page size, so every huge page of the
+ * arena can be backed. This cuts TLB misses on index lookups in
+ * big data sets.
+ */
+static void
+memtx_engine_advise_hugepages(struct memtx_engine *memtx)
+{
+#ifdef MADV_HUGEPAGE
+	if (madvise(memtx->arena.arena, memtx->arena.prealloc,
+		    MADV_HUGEPAGE) != 0) {
+		say_syserror("failed to enable huge pages for memtx arena");
+		return;
+	}
+	memtx->use_hugepages = true;
+	say_info("using transparent huge pages for memtx arena");
+#else
+	(void)memtx;
+	say_warn("huge pages are not supported on this platform");
+#endif
+}
+
 struct memtx_engine *
 memtx_engine_new(const char *snap_dirname, bool force_recovery,
 		 uint64_t tuple_arena_max_size, uint32_t objsize_min,
-		 bool dontdump, unsigned granularity,
+		 bool dontdump, bool use_hugepages, unsigned granularity,
 		 const char *allocator, float alloc_factor)
 {
 	int64_t snap_signature;
@@ -1186,6 +2020,12 @@ memtx_engine_new(const char *snap_dirname, bool force_recovery,
 	memtx->gc_fiber = fiber_new("memtx.gc", memtx_engine_gc_f);
 	if (memtx->gc_fiber == NULL)
 		goto fail;
+	memtx->tx_gc_fiber = fiber_new("memtx.tx_gc", memtx_tx_gc_f);
+	if (memtx->tx_gc_fiber == NULL)
+		goto fail;
+	memtx->expire_fiber = fiber_new("memtx.expire", memtx_engine_expire_f);
+	if (memtx->expire_fiber == NULL)
+		goto fail;
 
 	/* Apply lowest allowed objsize bound. */
 	if (objsize_min < OBJSIZE_MIN)
@@ -1205,6 +2045,8 @@ memtx_engine_new(const char *snap_dirname, bool force_recovery,
 	quota_init(&memtx->quota, tuple_arena_max_size);
 	tuple_arena_create(&memtx->arena, &memtx->quota, tuple_arena_max_size,
 			   SLAB_SIZE, dontdump, "memtx");
+	if (use_hugepages)
+		memtx_engine_advise_hugepages(memtx);
 	slab_cache_create(&memtx->slab_cache, &memtx->arena);
 	memtx->free_mode = MEMTX_ENGINE_FREE;
 	float actual_alloc_factor;
@@ -1232,11 +2074,15 @@ memtx_engine_new(const char *snap_dirname, bool force_recovery,
 	memtx->force_recovery = force_recovery;
 
 	memtx->replica_join_cord = NULL;
+	memtx->sort_threads = 1;
+	rlist_create(&memtx->build_stat.spaces);
 
 	memtx->base.vtab = &memtx_engine_vtab;
 	memtx->base.name = "memtx";
 
 	fiber_start(memtx->gc_fiber, memtx);
+	fiber_start(memtx->tx_gc_fiber);
+	fiber_start(memtx->expire_fiber, memtx);
 	return memtx;
 fail:
 	xdir_destroy(&memtx->snap_dir);
@@ -1258,6 +2104,13 @@ memtx_engine_set_snap_io_rate_limit(struct memtx_engine *memtx, double limit)
 	memtx->snap_io_rate_limit = limit * 1024 * 1024;
 }
 
+void
+memtx_engine_set_snap_write_duration(struct memtx_engine *memtx,
+				     double duration)
+{
+	memtx->snap_write_duration = duration;
+}
+
 int
 memtx_engine_set_memory(struct memtx_engine *memtx, size_t size)
 {
@@ -1276,6 +2129,139 @@ memtx_engine_set_max_tuple_size(struct memtx_engine *memtx, size_t max_size)
 	memtx->max_tuple_size = max_size;
 }
 
+void
+memtx_engine_set_sort_threads(struct memtx_engine *memtx, int threads)
+{
+	memtx->sort_threads = threads;
+}
+
+size_t
+memtx_engine_delayed_free_size(struct memtx_engine *memtx)
+{
+	(void)memtx;
+	return memtx_allocators_delayed_size();
+}
+
+/** How often memtx_engine_hugepages_used() rereads smaps, in seconds. */
+enum { MEMTX_HUGEPAGES_USED_UPDATE_PERIOD = 1 };
+
+/**
+ * Count the arena pages backed by transparent huge pages. The
+ * arena may be split into a number of mappings, so the per-mapping
+ * smaps is parsed, not smaps_rollup, which has the process total.
+ */
+static size_t
+memtx_engine_count_hugepages(struct memtx_engine *memtx)
+{
+#ifdef __linux__
+	FILE *f = fopen("/proc/self/smaps", "r");
+	if (f == NULL)
+		return 0;
+	uintptr_t arena_start = (uintptr_t)memtx->arena.arena;
+	uintptr_t arena_end = arena_start + memtx->arena.prealloc;
+	size_t total = 0;
+	bool in_arena = false;
+	char line[256];
+	while (fgets(line, sizeof(line), f) != NULL) {
+		unsigned long start, end;
+		size_t kb;
+		if (sscanf(line, "%lx-%lx ", &start, &end) == 2) {
+			/* A mapping header line. */
+			in_arena = start < arena_end && end > arena_start;
+		} else if (in_arena &&
+			   sscanf(line, "AnonHugePages: %zu kB", &kb) == 1) {
+			total += kb * 1024;
+		}
+	}
+	fclose(f);
+	return total;
+#else
+	(void)memtx;
+	return 0;
+#endif
+}
+
+size_t
+memtx_engine_hugepages_used(struct memtx_engine *memtx)
+{
+	if (!memtx->use_hugepages)
+		return 0;
+	double now = ev_monotonic_now(loop());
+	if (memtx->hugepages_used_time == 0 ||
+	    now - memtx->hugepages_used_time >=
+	    MEMTX_HUGEPAGES_USED_UPDATE_PERIOD) {
+		memtx->hugepages_used = memtx_engine_count_hugepages(memtx);
+		memtx->hugepages_used_time = now;
+	}
+	return memtx->hugepages_used;
+}
+
+static void
+memtx_engine_stat_build(struct memtx_engine *memtx, struct info_handler *h)
+{
+	struct memtx_build_stat *stat = &memtx->build_stat;
+	info_table_begin(h, "build");
+	info_append_str(h, "status", stat->in_progress ? "running" : "idle");
+	info_append_int(h, "spaces_total", stat->space_count);
+	info_append_int(h, "spaces_done", stat->spaces_done);
+	info_append_int(h, "indexes_done", stat->indexes_done);
+	info_append_double(h, "time", stat->time);
+	info_table_begin(h, "spaces");
+	struct memtx_space_build_stat *space_stat;
+	rlist_foreach_entry(space_stat, &stat->spaces, in_build_stat) {
+		struct space *space = space_by_id(space_stat->space_id);
+		if (space == NULL)
+			continue;
+		info_table_begin(h, space_name(space));
+		info_append_int(h, "tuples", space_stat->tuple_count);
+		info_append_double(h, "fill", space_stat->fill_time);
+		info_append_double(h, "sort", space_stat->sort_time);
+		info_append_double(h, "build", space_stat->build_time);
+		info_append_double(h, "total", space_stat->total_time);
+		info_table_begin(h, "indexes");
+		for (uint32_t i = 0; i < space_stat->index_count; i++) {
+			struct memtx_index_build_stat *index_stat =
+				&space_stat->indexes[i];
+			struct index *index = space_index(space,
+							  index_stat->index_id);
+			if (index == NULL)
+				continue;
+			info_table_begin(h, index->def->name);
+			info_append_double(h, "sort", index_stat->sort_time);
+			info_append_double(h, "build", index_stat->build_time);
+			info_table_end(h);
+		}
+		info_table_end(h); /* indexes */
+		info_table_end(h); /* space */
+	}
+	info_table_end(h); /* spaces */
+	info_table_end(h); /* build */
+}
+
+static void
+memtx_engine_stat_recovery(struct memtx_engine *memtx,
+			   struct info_handler *h)
+{
+	struct memtx_recovery_stat *stat = &memtx->recovery_stat;
+	info_table_begin(h, "recovery");
+	info_append_str(h, "status", stat->in_progress ? "running" : "idle");
+	info_append_int(h, "rows", stat->row_count);
+	info_append_double(h, "time", stat->time);
+	info_append_double(h, "rps", stat->time > 0 ?
+			   stat->row_count / stat->time : 0);
+	info_table_end(h); /* recovery */
+}
+
+void
+memtx_engine_stat(struct memtx_engine *memtx, struct info_handler *h)
+{
+	info_begin(h);
+	memtx_engine_stat_recovery(memtx, h);
+	memtx_engine_stat_build(memtx, h);
+	memtx_tx_stat(h);
+	info_end(h);
+}
+
 void
 memtx_enter_delayed_free_mode(struct memtx_engine *memtx)
 {
@@ -1296,6 +2282,37 @@ memtx_leave_delayed_free_mode(struct memtx_engine *memtx)
 	}
 }
 
+/**
+ * Allocate memory for a memtx tuple of the given total size,
+ * running garbage collection if the allocator is out of memory.
+ * Return NULL and set diag on failure.
+ */
+template<class ALLOC>
+static struct memtx_tuple *
+memtx_tuple_alloc(struct memtx_engine *memtx, size_t total)
+{
+	ERROR_INJECT(ERRINJ_TUPLE_ALLOC, {
+		diag_set(OutOfMemory, total, "slab allocator", "memtx_tuple");
+		return NULL;
+	});
+	if (unlikely(total > memtx->max_tuple_size)) {
+		diag_set(ClientError, ER_MEMTX_MAX_TUPLE_SIZE, total);
+		error_log(diag_last_error(diag_get()));
+		return NULL;
+	}
+	struct memtx_tuple *memtx_tuple;
+	while ((memtx_tuple = (struct memtx_tuple *)
+			MemtxAllocator<ALLOC>::alloc(total)) == NULL) {
+		bool stop;
+		memtx_engine_run_gc(memtx, &stop);
+		if (stop)
+			break;
+	}
+	if (memtx_tuple == NULL)
+		diag_set(OutOfMemory, total, "slab allocator", "memtx_tuple");
+	return memtx_tuple;
+}
+
 template<class ALLOC>
 struct tuple *
 memtx_tuple_new(struct tuple_format *format, const char *data, const char *end)
@@ -1332,28 +2349,10 @@ memtx_tuple_new(struct tuple_format *format, const char *data, const char *end)
 		total -= TUPLE_COMPACT_SAVINGS;
 	}
 
-	ERROR_INJECT(ERRINJ_TUPLE_ALLOC, {
-		diag_set(OutOfMemory, total, "slab allocator", "memtx_tuple");
-		goto end;
-	});
-	if (unlikely(total > memtx->max_tuple_size)) {
-		diag_set(ClientError, ER_MEMTX_MAX_TUPLE_SIZE, total);
-		error_log(diag_last_error(diag_get()));
-		goto end;
-	}
-
 	struct memtx_tuple *memtx_tuple;
-	while ((memtx_tuple = (struct memtx_tuple *)
-			MemtxAllocator<ALLOC>::alloc(total)) == NULL) {
-		bool stop;
-		memtx_engine_run_gc(memtx, &stop);
-		if (stop)
-			break;
-	}
-	if (memtx_tuple == NULL) {
-		diag_set(OutOfMemory, total, "slab allocator", "memtx_tuple");
+	memtx_tuple = memtx_tuple_alloc<ALLOC>(memtx, total);
+	if (memtx_tuple == NULL)
 		goto end;
-	}
 	tuple = &memtx_tuple->base;
 	tuple_create(tuple, 0, tuple_format_id(format),
 		     data_offset, tuple_len, make_compact);
@@ -1368,6 +2367,41 @@ end:
 	return tuple;
 }
 
+template<class ALLOC>
+static struct tuple *
+memtx_tuple_new_patched_impl(struct tuple *old_tuple, uint32_t offset,
+			     const char *patch, uint32_t size)
+{
+	struct tuple_format *format = tuple_format(old_tuple);
+	struct memtx_engine *memtx = (struct memtx_engine *)format->engine;
+	struct memtx_tuple *old_memtx_tuple =
+		container_of(old_tuple, struct memtx_tuple, base);
+	uint32_t bsize = tuple_bsize(old_tuple);
+	uint16_t data_offset = tuple_data_offset(old_tuple);
+	assert(offset + size <= bsize);
+	size_t total = (const char *)tuple_data(old_tuple) + bsize -
+		       (const char *)old_memtx_tuple;
+	struct memtx_tuple *memtx_tuple =
+		memtx_tuple_alloc<ALLOC>(memtx, total);
+	if (memtx_tuple == NULL)
+		return NULL;
+	/*
+	 * The header is initialized anew, so the copy doesn't get
+	 * the references and the MVCC flag of the old tuple. In the
+	 * compact mode, the part of the header that isn't used is
+	 * the field map, and it is copied as is.
+	 */
+	memcpy(memtx_tuple, old_memtx_tuple, total);
+	struct tuple *tuple = &memtx_tuple->base;
+	tuple_create(tuple, 0, tuple_format_id(format), data_offset, bsize,
+		     tuple_is_compact(old_tuple));
+	memtx_tuple->version = memtx->snapshot_version;
+	tuple_format_ref(format);
+	memcpy((char *)tuple + data_offset + offset, patch, size);
+	say_debug("%s(%u) = %p", __func__, bsize, memtx_tuple);
+	return tuple;
+}
+
 template<class ALLOC>
 static void
 memtx_tuple_delete(struct tuple_format *format, struct tuple *tuple)
@@ -1408,7 +2442,7 @@ memtx_tuple_chunk_new(struct tuple_format *format, struct tuple *tuple,
 	uint32_t sz = tuple_chunk_sz(data_sz);
 	struct tuple_chunk *tuple_chunk =
 		(struct tuple_chunk *) MemtxAllocator<ALLOC>::alloc(sz);
-	if (tuple == NULL) {
+	if (tuple_chunk == NULL) {
 		diag_set(OutOfMemory, sz, "MemtxAllocator::alloc", "tuple");
 		return NULL;
 	}
@@ -1419,6 +2453,10 @@ memtx_tuple_chunk_new(struct tuple_format *format, struct tuple *tuple,
 
 struct tuple_format_vtab memtx_tuple_format_vtab;
 
+struct tuple *
+(*memtx_tuple_new_patched)(struct tuple *old_tuple, uint32_t offset,
+			   const char *patch, uint32_t size);
+
 template <class ALLOC>
 static inline void
 create_memtx_tuple_format_vtab(struct tuple_format_vtab *vtab)
@@ -1427,6 +2465,7 @@ create_memtx_tuple_format_vtab(struct tuple_format_vtab *vtab)
 	vtab->tuple_new = memtx_tuple_new<ALLOC>;
 	vtab->tuple_chunk_delete = metmx_tuple_chunk_delete<ALLOC>;
 	vtab->tuple_chunk_new = memtx_tuple_chunk_new<ALLOC>;
+	memtx_tuple_new_patched = memtx_tuple_new_patched_impl<ALLOC>;
 }
 
 /**
@@ -1523,6 +2562,9 @@ memtx_index_def_change_requires_rebuild(struct index *index,
 		return true;
 	if (old_def->opts.hint != new_def->opts.hint)
 		return true;
+	if (new_def->type == TREE && new_def->opts.hint &&
+	    !key_def_hints_are_compatible(old_def->cmp_def, new_def->cmp_def))
+		return true;
 
 	const struct key_def *old_cmp_def, *new_cmp_def;
 	if (index_depends_on_pk(index)) {
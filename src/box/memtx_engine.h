@@ -36,6 +36,7 @@
 #include <small/quota.h>
 #include <small/small.h>
 #include <small/mempool.h>
+#include <small/rlist.h>
 
 #include "engine.h"
 #include "xlog.h"
@@ -50,6 +51,7 @@ struct index;
 struct fiber;
 struct tuple;
 struct tuple_format;
+struct info_handler;
 
 /**
  * Free mode, determines a strategy for freeing up memory
@@ -112,6 +114,38 @@ enum memtx_reserve_extents_num {
 	RESERVE_EXTENTS_BEFORE_REPLACE = 16
 };
 
+/**
+ * Progress of building secondary keys at the end of recovery,
+ * reported by box.info.memtx().
+ */
+struct memtx_build_stat {
+	/** Set while secondary keys are being built. */
+	bool in_progress;
+	/** Number of spaces whose secondary keys are to be built. */
+	int space_count;
+	/** Number of spaces whose secondary keys have been built. */
+	int spaces_done;
+	/** Number of secondary indexes built so far. */
+	int indexes_done;
+	/** Total time spent building secondary keys, in seconds. */
+	double time;
+	/**
+	 * Per space timings of spaces that have been built,
+	 * linked by memtx_space_build_stat::in_build_stat.
+	 */
+	struct rlist spaces;
+};
+
+/** Progress of recovering the snapshot, see box.info.memtx(). */
+struct memtx_recovery_stat {
+	/** Set while the snapshot is being recovered. */
+	bool in_progress;
+	/** Number of snapshot rows applied so far. */
+	int64_t row_count;
+	/** Time spent recovering the snapshot, in seconds. */
+	double time;
+};
+
 /**
  * The size of the biggest memtx iterator. Used with
  * mempool_create. This is the size of the block that will be
@@ -130,6 +164,18 @@ struct memtx_engine {
 	struct xdir snap_dir;
 	/** Limit disk usage of checkpointing (bytes per second). */
 	uint64_t snap_io_rate_limit;
+	/**
+	 * Target time of writing a snapshot, in seconds, or 0.
+	 * If set, the snapshot is written at the rate that spreads
+	 * the size of the previous snapshot over this time, unless
+	 * snap_io_rate_limit is lower. Configured by
+	 * box.cfg.checkpoint_write_duration.
+	 */
+	double snap_write_duration;
+	/** Size of the last written snapshot file, in bytes. */
+	int64_t snap_size;
+	/** Time it took to write the last snapshot, in seconds. */
+	double snap_write_time;
 	/** Skip invalid snapshot records if this flag is set. */
 	bool force_recovery;
 	/**
@@ -184,6 +230,16 @@ struct memtx_engine {
 	 * destruction of dropped indexes.
 	 */
 	struct fiber *gc_fiber;
+	/**
+	 * Fiber that deletes unused MVCC stories in the
+	 * background, see memtx_tx_gc_f().
+	 */
+	struct fiber *tx_gc_fiber;
+	/**
+	 * Fiber that deletes expired tuples of spaces with the
+	 * expire_field option, see memtx_engine_expire_f().
+	 */
+	struct fiber *expire_fiber;
 	/**
 	 * Scheduled garbage collection tasks, linked by
 	 * memtx_gc_task::link.
@@ -193,6 +249,27 @@ struct memtx_engine {
 	 * Free mode, determines a strategy for freeing up memory
 	 */
 	enum memtx_engine_free_mode free_mode;
+	/**
+	 * Max number of threads used for sorting secondary keys
+	 * at the end of recovery, box.cfg.memtx_sort_threads.
+	 */
+	int sort_threads;
+	/**
+	 * Set if the arena is advised to be backed by transparent
+	 * huge pages, box.cfg.memtx_use_hugepages.
+	 */
+	bool use_hugepages;
+	/**
+	 * Size of the arena backed by huge pages as of the time
+	 * hugepages_used_time, see memtx_engine_hugepages_used().
+	 */
+	size_t hugepages_used;
+	/** Monotonic time when hugepages_used was computed. */
+	double hugepages_used_time;
+	/** Snapshot recovery progress. */
+	struct memtx_recovery_stat recovery_stat;
+	/** Secondary key build progress. */
+	struct memtx_build_stat build_stat;
 };
 
 struct memtx_gc_task;
@@ -227,7 +304,7 @@ memtx_engine_schedule_gc(struct memtx_engine *memtx,
 struct memtx_engine *
 memtx_engine_new(const char *snap_dirname, bool force_recovery,
 		 uint64_t tuple_arena_max_size, uint32_t objsize_min,
-		 bool dontdump, unsigned granularity,
+		 bool dontdump, bool use_hugepages, unsigned granularity,
 		 const char *allocator, float alloc_factor);
 
 int
@@ -237,12 +314,39 @@ memtx_engine_recover_snapshot(struct memtx_engine *memtx,
 void
 memtx_engine_set_snap_io_rate_limit(struct memtx_engine *memtx, double limit);
 
+void
+memtx_engine_set_snap_write_duration(struct memtx_engine *memtx,
+				     double duration);
+
 int
 memtx_engine_set_memory(struct memtx_engine *memtx, size_t size);
 
 void
 memtx_engine_set_max_tuple_size(struct memtx_engine *memtx, size_t max_size);
 
+void
+memtx_engine_set_sort_threads(struct memtx_engine *memtx, int threads);
+
+/**
+ * Return the size of tuples that were deleted while a snapshot
+ * was in progress and are yet to be freed.
+ */
+size_t
+memtx_engine_delayed_free_size(struct memtx_engine *memtx);
+
+/**
+ * Return the size of the memtx arena backed by transparent huge
+ * pages, in bytes. Returns 0 if huge pages aren't used or if it
+ * can't be determined. Computing it is costly, so the value is
+ * updated at most once a second.
+ */
+size_t
+memtx_engine_hugepages_used(struct memtx_engine *memtx);
+
+/** Report memtx engine statistics, see box.info.memtx(). */
+void
+memtx_engine_stat(struct memtx_engine *memtx, struct info_handler *h);
+
 /**
  * Enter tuple delayed free mode: tuple allocated before the call
  * won't be freed until memtx_leave_delayed_free_mode() is called.
@@ -263,6 +367,17 @@ memtx_leave_delayed_free_mode(struct memtx_engine *memtx);
 /** Tuple format vtab for memtx engine. */
 extern struct tuple_format_vtab memtx_tuple_format_vtab;
 
+/**
+ * Create a copy of a memtx tuple with @a size bytes of its data
+ * at @a offset replaced with @a patch. The field map is copied
+ * as is, so the patch must not move any field and the new data
+ * must be valid for the format of the tuple. Set along with
+ * memtx_tuple_format_vtab.
+ */
+extern struct tuple *
+(*memtx_tuple_new_patched)(struct tuple *old_tuple, uint32_t offset,
+			   const char *patch, uint32_t size);
+
 enum {
 	MEMTX_EXTENT_SIZE = 16 * 1024,
 	MEMTX_SLAB_SIZE = 4 * 1024 * 1024
@@ -308,13 +423,13 @@ memtx_set_tuple_format_vtab(const char *allocator_name);
 static inline struct memtx_engine *
 memtx_engine_new_xc(const char *snap_dirname, bool force_recovery,
 		    uint64_t tuple_arena_max_size, uint32_t objsize_min,
-		    bool dontdump, unsigned granularity,
+		    bool dontdump, bool use_hugepages, unsigned granularity,
 		    const char *allocator, float alloc_factor)
 {
 	struct memtx_engine *memtx;
 	memtx = memtx_engine_new(snap_dirname, force_recovery,
 				 tuple_arena_max_size,
-				 objsize_min, dontdump,
+				 objsize_min, dontdump, use_hugepages,
 				 granularity, allocator, alloc_factor);
 	if (memtx == NULL)
 		diag_raise();
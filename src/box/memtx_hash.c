@@ -39,6 +39,9 @@
 #include "space.h"
 #include "schema.h" /* space_by_id(), space_cache_find() */
 #include "errinj.h"
+#include "info/info.h"
+#include "histogram.h"
+#include "clock.h"
 
 #include <small/mempool.h>
 
@@ -79,8 +82,23 @@ struct memtx_hash_index {
 	struct light_index_core hash_table;
 	struct memtx_gc_task gc_task;
 	struct light_index_iterator gc_iterator;
+	/**
+	 * Histogram of time spent on inserting a tuple into the
+	 * hash table, including its growth, in nanoseconds. Only
+	 * sampled inserts are timed, see insert_count.
+	 */
+	struct histogram *insert_latency;
+	/** Number of inserts since the last sampled one. */
+	uint32_t insert_count;
 };
 
+/**
+ * An insert into a hash table takes about a hundred nanoseconds,
+ * so timing each one would slow it down noticeably. Instead, only
+ * every MEMTX_HASH_INSERT_LATENCY_SAMPLE-th insert is timed.
+ */
+enum { MEMTX_HASH_INSERT_LATENCY_SAMPLE = 64 };
+
 /* {{{ MemtxHash Iterators ****************************************/
 
 struct hash_iterator {
@@ -185,6 +203,7 @@ static void
 memtx_hash_index_free(struct memtx_hash_index *index)
 {
 	light_index_destroy(&index->hash_table);
+	histogram_delete(index->insert_latency);
 	free(index);
 }
 
@@ -272,6 +291,42 @@ memtx_hash_index_size(struct index *base)
 	       memtx_tx_index_invisible_count(in_txn(), space, base);
 }
 
+/**
+ * Return the @a pml-th per mille of the insert latency histogram,
+ * in seconds, or 0 if there are no observations.
+ */
+static double
+insert_latency_get(struct histogram *hist, int pml)
+{
+	if (hist->total == 0)
+		return 0;
+	return (double)histogram_permille(hist, pml) / 1e9;
+}
+
+static void
+memtx_hash_index_stat(struct index *base, struct info_handler *h)
+{
+	struct memtx_hash_index *index = (struct memtx_hash_index *)base;
+	struct histogram *hist = index->insert_latency;
+	info_begin(h);
+	info_table_begin(h, "insert_latency");
+	info_append_int(h, "count", hist->total);
+	info_append_double(h, "p50", insert_latency_get(hist, 500));
+	info_append_double(h, "p90", insert_latency_get(hist, 900));
+	info_append_double(h, "p99", insert_latency_get(hist, 990));
+	info_append_double(h, "p999", insert_latency_get(hist, 999));
+	info_table_end(h); /* insert_latency */
+	info_end(h);
+}
+
+static void
+memtx_hash_index_reset_stat(struct index *base)
+{
+	struct memtx_hash_index *index = (struct memtx_hash_index *)base;
+	histogram_reset(index->insert_latency);
+	index->insert_count = 0;
+}
+
 static ssize_t
 memtx_hash_index_bsize(struct index *base)
 {
@@ -347,10 +402,21 @@ memtx_hash_index_replace(struct index *base, struct tuple *old_tuple,
 	if (new_tuple) {
 		uint32_t h = tuple_hash(new_tuple, base->def->key_def);
 		struct tuple *dup_tuple = NULL;
+		bool is_sampled = ++index->insert_count ==
+				  MEMTX_HASH_INSERT_LATENCY_SAMPLE;
+		uint64_t start = 0;
+		if (is_sampled) {
+			index->insert_count = 0;
+			start = clock_monotonic64();
+		}
 		uint32_t pos = light_index_replace(hash_table, h, new_tuple,
 						   &dup_tuple);
 		if (pos == light_index_end)
 			pos = light_index_insert(hash_table, h, new_tuple);
+		if (is_sampled) {
+			histogram_collect(index->insert_latency,
+					  clock_monotonic64() - start);
+		}
 
 		ERROR_INJECT(ERRINJ_INDEX_ALLOC,
 		{
@@ -551,6 +617,75 @@ memtx_hash_index_create_snapshot_iterator(struct index *base)
 	return (struct snapshot_iterator *) it;
 }
 
+/** Iterator over a frozen hash index, see the header. */
+struct hash_read_view_iterator {
+	struct iterator base;
+	struct memtx_hash_index *index;
+	struct light_index_iterator iterator;
+	struct memtx_tx_snapshot_cleaner cleaner;
+};
+
+static void
+hash_read_view_iterator_free(struct iterator *iterator)
+{
+	assert(iterator->free == hash_read_view_iterator_free);
+	struct hash_read_view_iterator *it =
+		(struct hash_read_view_iterator *)iterator;
+	memtx_leave_delayed_free_mode((struct memtx_engine *)
+				      it->index->base.engine);
+	light_index_iterator_destroy(&it->index->hash_table, &it->iterator);
+	index_unref(&it->index->base);
+	memtx_tx_snapshot_cleaner_destroy(&it->cleaner);
+	free(it);
+}
+
+static int
+hash_read_view_iterator_next(struct iterator *iterator, struct tuple **ret)
+{
+	assert(iterator->free == hash_read_view_iterator_free);
+	struct hash_read_view_iterator *it =
+		(struct hash_read_view_iterator *)iterator;
+	while (true) {
+		struct tuple **res =
+			light_index_iterator_get_and_next(&it->index->hash_table,
+							  &it->iterator);
+		if (res == NULL) {
+			*ret = NULL;
+			return 0;
+		}
+		*ret = memtx_tx_snapshot_clarify(&it->cleaner, *res);
+		if (*ret != NULL)
+			return 0;
+	}
+}
+
+struct iterator *
+memtx_hash_index_create_read_view_iterator(struct index *base)
+{
+	assert(base->vtab->create_snapshot_iterator ==
+	       memtx_hash_index_create_snapshot_iterator);
+	struct memtx_hash_index *index = (struct memtx_hash_index *)base;
+	struct hash_read_view_iterator *it = (struct hash_read_view_iterator *)
+		calloc(1, sizeof(*it));
+	if (it == NULL) {
+		diag_set(OutOfMemory, sizeof(struct hash_read_view_iterator),
+			 "memtx_hash_index", "iterator");
+		return NULL;
+	}
+	struct space *space = space_cache_find(base->def->space_id);
+	memtx_tx_snapshot_cleaner_create(&it->cleaner, space);
+
+	iterator_create(&it->base, base);
+	it->base.next = hash_read_view_iterator_next;
+	it->base.free = hash_read_view_iterator_free;
+	it->index = index;
+	index_ref(base);
+	light_index_iterator_begin(&index->hash_table, &it->iterator);
+	light_index_iterator_freeze(&index->hash_table, &it->iterator);
+	memtx_enter_delayed_free_mode((struct memtx_engine *)base->engine);
+	return (struct iterator *)it;
+}
+
 static const struct index_vtab memtx_hash_index_vtab = {
 	/* .destroy = */ memtx_hash_index_destroy,
 	/* .commit_create = */ generic_index_commit_create,
@@ -572,9 +707,9 @@ static const struct index_vtab memtx_hash_index_vtab = {
 	/* .create_iterator = */ memtx_hash_index_create_iterator,
 	/* .create_snapshot_iterator = */
 		memtx_hash_index_create_snapshot_iterator,
-	/* .stat = */ generic_index_stat,
+	/* .stat = */ memtx_hash_index_stat,
 	/* .compact = */ generic_index_compact,
-	/* .reset_stat = */ generic_index_reset_stat,
+	/* .reset_stat = */ memtx_hash_index_reset_stat,
 	/* .begin_build = */ generic_index_begin_build,
 	/* .reserve = */ generic_index_reserve,
 	/* .build_next = */ generic_index_build_next,
@@ -591,8 +726,23 @@ memtx_hash_index_new(struct memtx_engine *memtx, struct index_def *def)
 			 "malloc", "struct memtx_hash_index");
 		return NULL;
 	}
+	/* Nanoseconds, from a fast insert to a slow extent allocation. */
+	static const int64_t buckets[] = {
+		50, 100, 150, 200, 300, 400, 500, 700,
+		1000, 1500, 2000, 3000, 5000, 7000,
+		10000, 20000, 50000, 100000, 200000, 500000,
+		1000000, 10000000, 100000000,
+	};
+	index->insert_latency = histogram_new(buckets, lengthof(buckets));
+	if (index->insert_latency == NULL) {
+		diag_set(OutOfMemory, sizeof(struct histogram),
+			 "histogram_new", "struct histogram");
+		free(index);
+		return NULL;
+	}
 	if (index_create(&index->base, (struct engine *)memtx,
 			 &memtx_hash_index_vtab, def) != 0) {
+		histogram_delete(index->insert_latency);
 		free(index);
 		return NULL;
 	}
@@ -42,6 +42,18 @@ struct memtx_engine;
 struct index *
 memtx_hash_index_new(struct memtx_engine *memtx, struct index_def *def);
 
+/**
+ * Create an iterator over all tuples stored in a hash index at
+ * the time of the call. Changes made to the index after that
+ * don't affect the iteration, and the tuples returned by the
+ * iterator aren't freed until the iterator is deleted, even if
+ * they are deleted from the index. Like a snapshot iterator,
+ * this one clarifies tuples with MVCC, so only the committed
+ * state of the index is returned.
+ */
+struct iterator *
+memtx_hash_index_create_read_view_iterator(struct index *base);
+
 #if defined(__cplusplus)
 } /* extern "C" */
 #endif /* defined(__cplusplus) */
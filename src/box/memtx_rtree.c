@@ -37,6 +37,7 @@
 #include "index.h"
 #include "errinj.h"
 #include "fiber.h"
+#include "say.h"
 #include "trivia/util.h"
 
 #include "tuple.h"
@@ -50,6 +51,17 @@ struct memtx_rtree_index {
 	struct index base;
 	unsigned dimension;
 	struct rtree tree;
+	/**
+	 * Records collected by build_next() to be loaded into the
+	 * tree at once by end_build(), see rtree_bulk_load().
+	 */
+	char *build_array;
+	size_t build_array_size, build_array_alloc_size;
+};
+
+enum {
+	/** Initial capacity of the build array, in records. */
+	RTREE_BUILD_ARRAY_MIN_SIZE = 1024,
 };
 
 /* {{{ Utilities. *************************************************/
@@ -174,6 +186,7 @@ memtx_rtree_index_destroy(struct index *base)
 {
 	struct memtx_rtree_index *index = (struct memtx_rtree_index *)base;
 	rtree_destroy(&index->tree);
+	free(index->build_array);
 	free(index);
 }
 
@@ -285,13 +298,91 @@ memtx_rtree_index_reserve(struct index *base, uint32_t size_hint)
          * on rtree, because there is no error handling in the
          * rtree lib.
          */
-	(void)size_hint;
 	ERROR_INJECT(ERRINJ_INDEX_RESERVE, {
 		diag_set(OutOfMemory, MEMTX_EXTENT_SIZE, "mempool", "new slab");
 		return -1;
 	});
 	struct memtx_engine *memtx = (struct memtx_engine *)base->engine;
-	return memtx_index_extent_reserve(memtx, RESERVE_EXTENTS_BEFORE_REPLACE);
+	if (memtx_index_extent_reserve(memtx,
+				       RESERVE_EXTENTS_BEFORE_REPLACE) != 0)
+		return -1;
+	/* A non-zero hint is only passed before building the index. */
+	struct memtx_rtree_index *index = (struct memtx_rtree_index *)base;
+	if (size_hint <= index->build_array_alloc_size)
+		return 0;
+	size_t size = size_hint * rtree_bulk_entry_size(&index->tree);
+	char *tmp = (char *)realloc(index->build_array, size);
+	if (tmp == NULL) {
+		diag_set(OutOfMemory, size, "memtx_rtree_index", "reserve");
+		return -1;
+	}
+	index->build_array = tmp;
+	index->build_array_alloc_size = size_hint;
+	return 0;
+}
+
+static void
+memtx_rtree_index_begin_build(struct index *base)
+{
+	struct memtx_rtree_index *index = (struct memtx_rtree_index *)base;
+	assert(rtree_number_of_records(&index->tree) == 0);
+	(void)index;
+}
+
+static int
+memtx_rtree_index_build_next(struct index *base, struct tuple *tuple)
+{
+	struct memtx_rtree_index *index = (struct memtx_rtree_index *)base;
+	struct rtree_rect rect;
+	if (extract_rectangle(&rect, tuple, base->def) != 0)
+		return -1;
+	if (index->build_array_size == index->build_array_alloc_size) {
+		size_t alloc_size = MAX(index->build_array_alloc_size +
+				DIV_ROUND_UP(index->build_array_alloc_size, 2),
+				(size_t)RTREE_BUILD_ARRAY_MIN_SIZE);
+		size_t size = alloc_size * rtree_bulk_entry_size(&index->tree);
+		char *tmp = (char *)realloc(index->build_array, size);
+		if (tmp == NULL) {
+			diag_set(OutOfMemory, size, "memtx_rtree_index",
+				 "build_next");
+			return -1;
+		}
+		index->build_array = tmp;
+		index->build_array_alloc_size = alloc_size;
+	}
+	rtree_bulk_entry_set(&index->tree, index->build_array,
+			     index->build_array_size++, &rect, tuple);
+	return 0;
+}
+
+static void
+memtx_rtree_index_end_build(struct index *base)
+{
+	struct memtx_rtree_index *index = (struct memtx_rtree_index *)base;
+	struct memtx_engine *memtx = (struct memtx_engine *)base->engine;
+	size_t count = index->build_array_size;
+	if (count > 0) {
+		/*
+		 * The rtree lib doesn't handle allocation errors,
+		 * so reserve the extents for all pages beforehand,
+		 * along with the matras extents that point to them.
+		 */
+		size_t extents = DIV_ROUND_UP(
+			rtree_bulk_load_size(&index->tree, count),
+			MEMTX_EXTENT_SIZE);
+		extents += DIV_ROUND_UP(extents,
+					MEMTX_EXTENT_SIZE / sizeof(void *)) + 1;
+		if (memtx_index_extent_reserve(memtx, extents) != 0) {
+			diag_log();
+			panic("failed to build RTREE index '%s'",
+			      base->def->name);
+		}
+		rtree_bulk_load(&index->tree, index->build_array, count);
+	}
+	free(index->build_array);
+	index->build_array = NULL;
+	index->build_array_size = 0;
+	index->build_array_alloc_size = 0;
 }
 
 static struct iterator *
@@ -391,10 +482,10 @@ static const struct index_vtab memtx_rtree_index_vtab = {
 	/* .stat = */ generic_index_stat,
 	/* .compact = */ generic_index_compact,
 	/* .reset_stat = */ generic_index_reset_stat,
-	/* .begin_build = */ generic_index_begin_build,
+	/* .begin_build = */ memtx_rtree_index_begin_build,
 	/* .reserve = */ memtx_rtree_index_reserve,
-	/* .build_next = */ generic_index_build_next,
-	/* .end_build = */ generic_index_end_build,
+	/* .build_next = */ memtx_rtree_index_build_next,
+	/* .end_build = */ memtx_rtree_index_end_build,
 };
 
 struct index *
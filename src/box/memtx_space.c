@@ -32,6 +32,7 @@
 #include "space.h"
 #include "iproto_constants.h"
 #include "txn.h"
+#include "box.h"
 #include "memtx_tx.h"
 #include "tuple.h"
 #include "xrow_update.h"
@@ -43,6 +44,10 @@
 #include "memtx_engine.h"
 #include "column_mask.h"
 #include "sequence.h"
+#include "info/info.h"
+#include "json/json.h"
+#include "tt_static.h"
+#include "mp_decimal.h"
 
 /*
  * Yield every 1K tuples while building a new index or checking
@@ -62,6 +67,7 @@ enum { MEMTX_DDL_YIELD_LOOPS = 10 };
 static void
 memtx_space_destroy(struct space *space)
 {
+	free(((struct memtx_space *)space)->expire_key);
 	TRASH(space);
 	free(space);
 }
@@ -85,6 +91,266 @@ memtx_space_update_bsize(struct space *space, struct tuple *old_tuple,
 	ssize_t new_bsize = new_tuple ? box_tuple_bsize(new_tuple) : 0;
 	assert((ssize_t)memtx_space->bsize + new_bsize - old_bsize >= 0);
 	memtx_space->bsize += new_bsize - old_bsize;
+	ssize_t old_size = old_tuple ? tuple_size(old_tuple) : 0;
+	ssize_t new_size = new_tuple ? tuple_size(new_tuple) : 0;
+	assert((ssize_t)memtx_space->tuple_size + new_size - old_size >= 0);
+	memtx_space->tuple_size += new_size - old_size;
+}
+
+size_t
+memtx_space_memory_used(struct space *space)
+{
+	assert(space->vtab->destroy == &memtx_space_destroy);
+	struct memtx_space *memtx_space = (struct memtx_space *)space;
+	size_t size = memtx_space->tuple_size;
+	for (uint32_t i = 0; i < space->index_count; i++)
+		size += index_bsize(space->index[i]);
+	return size;
+}
+
+static void
+memtx_space_stat(struct space *space, struct info_handler *h)
+{
+	struct memtx_space *memtx_space = (struct memtx_space *)space;
+	size_t index_size = 0;
+	for (uint32_t i = 0; i < space->index_count; i++)
+		index_size += index_bsize(space->index[i]);
+	info_begin(h);
+	info_table_begin(h, "memory");
+	info_append_int(h, "tuples", memtx_space->tuple_size);
+	info_append_int(h, "indexes", index_size);
+	info_append_int(h, "total", memtx_space->tuple_size + index_size);
+	info_table_end(h);
+	info_append_int(h, "memory_quota", space->def->opts.memory_quota);
+	info_append_int(h, "expired", memtx_space->expired);
+	info_end(h);
+}
+
+/**
+ * Max number of tuples checked for expiration by one call of
+ * memtx_space_expire().
+ */
+enum { MEMTX_EXPIRE_BATCH_SIZE = 1000 };
+
+/**
+ * Check if a tuple expired. Tuples without a numeric expiration
+ * time never expire. A decimal time is compared as a decimal, so
+ * that the result agrees with the order of a 'number' index.
+ */
+static bool
+memtx_space_tuple_is_expired(struct space *space, struct tuple *tuple,
+			     double now)
+{
+	const char *field = tuple_field(tuple, space->def->opts.expire_field -
+					TUPLE_INDEX_BASE);
+	if (field == NULL)
+		return false;
+	double time;
+	if (mp_read_double(&field, &time) == 0)
+		return time <= now;
+	decimal_t dec_time, dec_now;
+	return mp_decode_decimal(&field, &dec_time) != NULL &&
+	       decimal_from_double(&dec_now, now) != NULL &&
+	       decimal_compare(&dec_time, &dec_now) <= 0;
+}
+
+/** Delete tuples by primary keys in one transaction. */
+static int
+memtx_space_expire_delete(uint32_t space_id, const char **keys,
+			  uint32_t count)
+{
+	if (box_txn_begin() != 0)
+		return -1;
+	for (uint32_t i = 0; i < count; i++) {
+		const char *key_end = keys[i];
+		mp_next(&key_end);
+		if (box_delete(space_id, 0, keys[i], key_end, NULL) != 0) {
+			box_txn_rollback();
+			return -1;
+		}
+	}
+	if (box_txn_commit() != 0)
+		return -1;
+	/* The space may have been dropped while the commit yielded. */
+	struct space *space = space_by_id(space_id);
+	if (space != NULL && space_is_memtx(space))
+		((struct memtx_space *)space)->expired += count;
+	return 0;
+}
+
+/**
+ * Find a TREE index ordered by the expiration time: its first part
+ * is the non-nullable numeric expire_field. Returns NULL if there
+ * is no such index.
+ */
+static struct index *
+memtx_space_expire_index(struct space *space)
+{
+	uint32_t fieldno = space->def->opts.expire_field - TUPLE_INDEX_BASE;
+	for (uint32_t i = 0; i < space->index_count; i++) {
+		struct index *index = space->index[i];
+		struct key_def *key_def = index->def->key_def;
+		struct key_part *part = &key_def->parts[0];
+		if (index->def->type == TREE && !key_def->is_multikey &&
+		    !key_def->for_func_index && part->fieldno == fieldno &&
+		    part->path == NULL && !key_part_is_nullable(part) &&
+		    field_type1_contains_type2(FIELD_TYPE_NUMBER, part->type))
+			return index;
+	}
+	return NULL;
+}
+
+/**
+ * Collect primary keys of expired tuples to @a keys using an
+ * index ordered by the expiration time. Only the expired tuples
+ * and the first live one are visited.
+ */
+static int
+memtx_space_expire_collect_ordered(struct space *space, struct index *index,
+				   double now, const char **keys,
+				   uint32_t *count, bool *is_done)
+{
+	struct key_def *pk_def = space->index[0]->def->key_def;
+	struct iterator *it = index_create_iterator(index, ITER_ALL, NULL, 0);
+	if (it == NULL)
+		return -1;
+	*is_done = false;
+	while (*count < MEMTX_EXPIRE_BATCH_SIZE) {
+		struct tuple *tuple;
+		if (iterator_next(it, &tuple) != 0)
+			goto fail;
+		if (tuple == NULL ||
+		    !memtx_space_tuple_is_expired(space, tuple, now)) {
+			*is_done = true;
+			break;
+		}
+		keys[*count] = tuple_extract_key(tuple, pk_def,
+						 MULTIKEY_NONE, NULL);
+		if (keys[*count] == NULL)
+			goto fail;
+		(*count)++;
+	}
+	iterator_delete(it);
+	return 0;
+fail:
+	iterator_delete(it);
+	return -1;
+}
+
+/**
+ * Collect primary keys of expired tuples to @a keys checking a
+ * batch of tuples of the primary index, starting after the one
+ * where the previous call stopped.
+ */
+static int
+memtx_space_expire_collect_scan(struct space *space, double now,
+				const char **keys, uint32_t *count,
+				bool *is_done)
+{
+	struct memtx_space *memtx_space = (struct memtx_space *)space;
+	struct index *pk = space->index[0];
+	const char *key = memtx_space->expire_key;
+	uint32_t part_count = key != NULL ? mp_decode_array(&key) : 0;
+	struct iterator *it = index_create_iterator(
+		pk, key != NULL ? ITER_GT : ITER_ALL, key, part_count);
+	if (it == NULL)
+		return -1;
+	struct tuple *tuple = NULL;
+	for (uint32_t i = 0; i < MEMTX_EXPIRE_BATCH_SIZE; i++) {
+		if (iterator_next(it, &tuple) != 0)
+			goto fail;
+		if (tuple == NULL)
+			break;
+		if (!memtx_space_tuple_is_expired(space, tuple, now))
+			continue;
+		keys[*count] = tuple_extract_key(tuple, pk->def->key_def,
+						 MULTIKEY_NONE, NULL);
+		if (keys[*count] == NULL)
+			goto fail;
+		(*count)++;
+	}
+	/*
+	 * Continue after the last checked tuple next time or
+	 * start over if the whole index was checked.
+	 */
+	char *next_key = NULL;
+	if (tuple != NULL) {
+		uint32_t key_size;
+		const char *last_key = tuple_extract_key(
+			tuple, pk->def->key_def, MULTIKEY_NONE, &key_size);
+		if (last_key == NULL)
+			goto fail;
+		next_key = xmalloc(key_size);
+		memcpy(next_key, last_key, key_size);
+	}
+	iterator_delete(it);
+	free(memtx_space->expire_key);
+	memtx_space->expire_key = next_key;
+	*is_done = next_key == NULL;
+	return 0;
+fail:
+	iterator_delete(it);
+	return -1;
+}
+
+int
+memtx_space_expire(uint32_t space_id, double now, bool *is_done)
+{
+	*is_done = true;
+	struct space *space = space_by_id(space_id);
+	if (space == NULL || space->def->opts.expire_field == 0 ||
+	    !space_is_memtx(space) ||
+	    space->index_count == 0)
+		return 0;
+	struct region *region = &fiber()->gc;
+	size_t region_svp = region_used(region);
+	size_t size;
+	const char **keys = region_alloc_array(region, const char *,
+					       MEMTX_EXPIRE_BATCH_SIZE, &size);
+	if (keys == NULL) {
+		diag_set(OutOfMemory, size, "region_alloc_array", "keys");
+		return -1;
+	}
+	uint32_t count = 0;
+	struct index *index = memtx_space_expire_index(space);
+	int rc;
+	if (index != NULL)
+		rc = memtx_space_expire_collect_ordered(space, index, now,
+							keys, &count, is_done);
+	else
+		rc = memtx_space_expire_collect_scan(space, now, keys, &count,
+						     is_done);
+	if (rc == 0 && count > 0)
+		rc = memtx_space_expire_delete(space_id, keys, count);
+	region_truncate(region, region_svp);
+	return rc;
+}
+
+/**
+ * Check that replacing @a old_tuple with @a new_tuple doesn't make
+ * the space exceed its memory quota. The tuples must not be
+ * accounted in memtx_space::tuple_size yet. Statements that don't
+ * increase memory usage are always allowed, so that a space that
+ * is over its quota can be cleaned up.
+ */
+static int
+memtx_space_check_memory_quota(struct space *space, struct tuple *old_tuple,
+			       struct tuple *new_tuple)
+{
+	int64_t quota = space->def->opts.memory_quota;
+	if (quota == 0 || new_tuple == NULL ||
+	    memtx_space_is_recovering(space))
+		return 0;
+	ssize_t delta = tuple_size(new_tuple);
+	if (old_tuple != NULL)
+		delta -= tuple_size(old_tuple);
+	if (delta <= 0)
+		return 0;
+	if (memtx_space_memory_used(space) + delta <= (size_t)quota)
+		return 0;
+	diag_set(ClientError, ER_SPACE_MEMORY_QUOTA, space_name(space),
+		 (long long)quota);
+	return -1;
 }
 
 /**
@@ -278,6 +544,13 @@ memtx_space_replace_all_keys(struct space *space, struct tuple *old_tuple,
 	 * we must not use MVCC for those spaces even if txn is present now.
 	 */
 	if (memtx_tx_manager_use_mvcc_engine && !space->def->opts.is_ephemeral) {
+		/*
+		 * With MVCC, the replaced tuple is unknown yet for
+		 * REPLACE, so the check is pessimistic.
+		 */
+		if (memtx_space_check_memory_quota(space, old_tuple,
+						   new_tuple) != 0)
+			return -1;
 		struct txn_stmt *stmt = txn_current_stmt(in_txn());
 		return memtx_tx_history_add_stmt(stmt, old_tuple, new_tuple,
 						 mode, result);
@@ -302,6 +575,9 @@ memtx_space_replace_all_keys(struct space *space, struct tuple *old_tuple,
 			goto rollback;
 	}
 
+	if (memtx_space_check_memory_quota(space, old_tuple, new_tuple) != 0)
+		goto rollback;
+
 	memtx_space_update_bsize(space, old_tuple, new_tuple);
 	if (new_tuple != NULL)
 		tuple_ref(new_tuple);
@@ -388,6 +664,73 @@ memtx_space_execute_delete(struct space *space, struct txn *txn,
 	return 0;
 }
 
+/**
+ * Check if the result of an update differs from the old tuple in
+ * one top-level scalar field only, and the field has the same
+ * size. Then the field map of the old tuple is valid for the new
+ * one, and the new tuple can be made by memtx_tuple_new_patched()
+ * instead of decoding it again. The changed bytes are returned in
+ * @a offset and @a size. If the new value doesn't match the field
+ * type, false is returned, and tuple_new() reports the error.
+ */
+static bool
+memtx_update_is_patch(struct tuple_format *format, struct tuple *old_tuple,
+		      const char *new_data, uint32_t new_size,
+		      uint32_t *offset, uint32_t *size)
+{
+	uint32_t bsize;
+	const char *old_data = tuple_data_range(old_tuple, &bsize);
+	if (tuple_format(old_tuple) != format || new_size != bsize)
+		return false;
+	uint32_t begin = 0;
+	while (begin < bsize && old_data[begin] == new_data[begin])
+		begin++;
+	if (begin == bsize) {
+		*offset = 0;
+		*size = 0;
+		return true;
+	}
+	uint32_t end = bsize;
+	while (old_data[end - 1] == new_data[end - 1])
+		end--;
+	const char *pos = old_data;
+	uint32_t field_count = mp_decode_array(&pos);
+	if (begin < (uint32_t)(pos - old_data))
+		return false;
+	for (uint32_t i = 0; i < field_count; i++) {
+		const char *field = pos;
+		mp_next(&pos);
+		uint32_t field_end = pos - old_data;
+		if (begin >= field_end)
+			continue;
+		/* The changed bytes must be within this field. */
+		if (end > field_end)
+			return false;
+		const char *new_field = new_data + (field - old_data);
+		const char *new_field_end = new_field;
+		mp_next(&new_field_end);
+		if ((uint32_t)(new_field_end - new_data) != field_end)
+			return false;
+		/* Nested fields may have offsets in the field map. */
+		enum mp_type type = mp_typeof(*field);
+		enum mp_type new_type = mp_typeof(*new_field);
+		if (type == MP_ARRAY || type == MP_MAP ||
+		    new_type == MP_ARRAY || new_type == MP_MAP)
+			return false;
+		if (i < tuple_format_field_count(format)) {
+			struct tuple_field *f = tuple_format_field(format, i);
+			if (!field_mp_type_is_compatible(
+					f->type, new_field,
+					tuple_field_is_nullable(f)))
+				return false;
+		}
+		*offset = field - old_data;
+		*size = pos - field;
+		return true;
+	}
+	return false;
+}
+
 static int
 memtx_space_execute_update(struct space *space, struct txn *txn,
 			   struct request *request, struct tuple **result)
@@ -422,9 +765,18 @@ memtx_space_execute_update(struct space *space, struct txn *txn,
 	if (new_data == NULL)
 		return -1;
 
-	stmt->new_tuple =
-		space->format->vtab.tuple_new(format, new_data,
-					      new_data + new_size);
+	uint32_t patch_offset, patch_size;
+	if (memtx_update_is_patch(format, old_tuple, new_data, new_size,
+				  &patch_offset, &patch_size)) {
+		stmt->new_tuple =
+			memtx_tuple_new_patched(old_tuple, patch_offset,
+						new_data + patch_offset,
+						patch_size);
+	} else {
+		stmt->new_tuple =
+			space->format->vtab.tuple_new(format, new_data,
+						      new_data + new_size);
+	}
 	if (stmt->new_tuple == NULL)
 		return -1;
 	tuple_ref(stmt->new_tuple);
@@ -867,10 +1219,91 @@ struct memtx_ddl_state {
 	struct tuple *cursor;
 	/* Primary key key_def to compare new tuples with cursor. */
 	struct key_def *cmp_def;
+	/*
+	 * If set, the index is built from a read view of the
+	 * primary key, and the on_replace trigger appends all
+	 * changes of the space to the log instead of applying
+	 * them to the index. The log is replayed when the read
+	 * view is processed. This is used when the primary key
+	 * is unordered, so the cursor can't tell whether a tuple
+	 * has been processed already.
+	 */
+	bool use_log;
+	/* Changes made during the build, see use_log. */
+	struct stailq log;
 	struct diag diag;
 	int rc;
 };
 
+/* A change of the space logged during an index build. */
+struct memtx_ddl_change {
+	struct stailq_entry in_log;
+	struct tuple *old_tuple;
+	struct tuple *new_tuple;
+};
+
+/*
+ * Append a change to the index build log. The tuples are
+ * referenced until the log is destroyed.
+ */
+static int
+memtx_ddl_log_change(struct memtx_ddl_state *state, struct tuple *old_tuple,
+		     struct tuple *new_tuple)
+{
+	struct memtx_ddl_change *change = malloc(sizeof(*change));
+	if (change == NULL) {
+		diag_set(OutOfMemory, sizeof(*change), "malloc",
+			 "struct memtx_ddl_change");
+		return -1;
+	}
+	change->old_tuple = old_tuple;
+	change->new_tuple = new_tuple;
+	if (old_tuple != NULL)
+		tuple_ref(old_tuple);
+	if (new_tuple != NULL)
+		tuple_ref(new_tuple);
+	stailq_add_tail_entry(&state->log, change, in_log);
+	return 0;
+}
+
+/*
+ * Apply the changes logged during an index build to the index.
+ * Must not yield, otherwise new changes may be missed.
+ */
+static int
+memtx_ddl_replay_log(struct memtx_ddl_state *state)
+{
+	enum dup_replace_mode mode =
+		state->index->def->opts.is_unique ? DUP_INSERT :
+						    DUP_REPLACE_OR_INSERT;
+	struct memtx_ddl_change *change;
+	stailq_foreach_entry(change, &state->log, in_log) {
+		if (change->new_tuple != NULL &&
+		    tuple_validate(state->format, change->new_tuple) != 0)
+			return -1;
+		struct tuple *delete, *successor;
+		if (index_replace(state->index, change->old_tuple,
+				  change->new_tuple, mode,
+				  &delete, &successor) != 0)
+			return -1;
+	}
+	return 0;
+}
+
+static void
+memtx_ddl_destroy_log(struct memtx_ddl_state *state)
+{
+	struct memtx_ddl_change *change, *next;
+	stailq_foreach_entry_safe(change, next, &state->log, in_log) {
+		if (change->old_tuple != NULL)
+			tuple_unref(change->old_tuple);
+		if (change->new_tuple != NULL)
+			tuple_unref(change->new_tuple);
+		free(change);
+	}
+	stailq_create(&state->log);
+}
+
 static int
 memtx_check_on_replace(struct trigger *trigger, void *event)
 {
@@ -977,6 +1410,7 @@ memtx_space_drop_primary_key(struct space *space)
 	 */
 	memtx_space->replace = memtx_space_replace_no_keys;
 	memtx_space->bsize = 0;
+	memtx_space->tuple_size = 0;
 }
 
 static void
@@ -1008,10 +1442,17 @@ memtx_build_on_replace_rollback(struct trigger *trigger, void *event)
 	struct index_build_on_rollback_data *data = trigger->data;
 	struct txn_stmt *stmt = data->stmt;
 	struct memtx_ddl_state *state = data->state;
+	assert(stmt != NULL);
+	if (state->use_log) {
+		state->rc = memtx_ddl_log_change(state, stmt->new_tuple,
+						 stmt->old_tuple);
+		if (state->rc != 0)
+			diag_move(diag_get(), &state->diag);
+		return 0;
+	}
 	/*
 	 * Old tuple's format is valid if it exists.
 	 */
-	assert(stmt != NULL);
 	assert(stmt->old_tuple == NULL ||
 	       tuple_validate(state->format, stmt->old_tuple) == 0);
 
@@ -1052,6 +1493,41 @@ struct on_rollback_trigger_with_data {
 	struct index_build_on_rollback_data data;
 };
 
+/*
+ * Set on_rollback trigger on stmt to avoid
+ * problem when rollbacked changes appears in
+ * built-in-background index.
+ */
+static void
+memtx_build_set_on_rollback(struct memtx_ddl_state *state,
+			    struct txn_stmt *stmt)
+{
+	struct on_rollback_trigger_with_data *on_rollback_associates = NULL;
+	struct errinj *inj = errinj(ERRINJ_BUILD_INDEX_ON_ROLLBACK_ALLOC,
+				    ERRINJ_BOOL);
+	if (inj == NULL || inj->bparam == false) {
+		on_rollback_associates = region_aligned_alloc(
+			&in_txn()->region,
+			sizeof(struct on_rollback_trigger_with_data),
+			alignof(struct on_rollback_trigger_with_data));
+	}
+	if (on_rollback_associates == NULL) {
+		diag_set(OutOfMemory,
+			 sizeof(struct on_rollback_trigger_with_data),
+			 "region_aligned_alloc",
+			 "struct on_rollback_trigger_with_data");
+		diag_move(diag_get(), &state->diag);
+		state->rc = -1;
+		return;
+	}
+	on_rollback_associates->data.stmt = stmt;
+	on_rollback_associates->data.state = state;
+	trigger_create(&on_rollback_associates->on_rollback,
+		       memtx_build_on_replace_rollback,
+		       &on_rollback_associates->data, NULL);
+	txn_stmt_on_rollback(stmt, &on_rollback_associates->on_rollback);
+}
+
 static int
 memtx_build_on_replace(struct trigger *trigger, void *event)
 {
@@ -1059,6 +1535,21 @@ memtx_build_on_replace(struct trigger *trigger, void *event)
 	struct memtx_ddl_state *state = trigger->data;
 	struct txn_stmt *stmt = txn_current_stmt(txn);
 
+	if (state->use_log) {
+		/*
+		 * The new format is checked when the log is replayed,
+		 * because the change may be rolled back before that.
+		 */
+		state->rc = memtx_ddl_log_change(state, stmt->old_tuple,
+						 stmt->new_tuple);
+		if (state->rc != 0) {
+			diag_move(diag_get(), &state->diag);
+			return 0;
+		}
+		memtx_build_set_on_rollback(state, stmt);
+		return 0;
+	}
+
 	struct tuple *cmp_tuple = stmt->new_tuple != NULL ? stmt->new_tuple :
 							    stmt->old_tuple;
 	/*
@@ -1098,35 +1589,7 @@ memtx_build_on_replace(struct trigger *trigger, void *event)
 		if (stmt->old_tuple != NULL)
 			tuple_unref(stmt->old_tuple);
 	}
-	/*
-	 * Set on_rollback trigger on stmt to avoid
-	 * problem when rollbacked changes appears in
-	 * built-in-background index.
-	 */
-	struct on_rollback_trigger_with_data *on_rollback_associates = NULL;
-	struct errinj *inj = errinj(ERRINJ_BUILD_INDEX_ON_ROLLBACK_ALLOC,
-				    ERRINJ_BOOL);
-	if (inj == NULL || inj->bparam == false) {
-		on_rollback_associates = region_aligned_alloc(
-			&in_txn()->region,
-			sizeof(struct on_rollback_trigger_with_data),
-			alignof(struct on_rollback_trigger_with_data));
-	}
-	if (on_rollback_associates == NULL) {
-		diag_set(OutOfMemory,
-			 sizeof(struct on_rollback_trigger_with_data),
-			 "region_aligned_alloc",
-			 "struct on_rollback_trigger_with_data");
-		diag_move(diag_get(), &state->diag);
-		state->rc = -1;
-		return 0;
-	}
-	on_rollback_associates->data.stmt = stmt;
-	on_rollback_associates->data.state = state;
-	trigger_create(&on_rollback_associates->on_rollback,
-		       memtx_build_on_replace_rollback,
-		       &on_rollback_associates->data, NULL);
-	txn_stmt_on_rollback(stmt, &on_rollback_associates->on_rollback);
+	memtx_build_set_on_rollback(state, stmt);
 	return 0;
 }
 
@@ -1161,22 +1624,35 @@ memtx_space_build_index(struct space *src_space, struct index *new_index,
 		return -1;
 	}
 
-	/* Now deal with any kind of add index during normal operation. */
-	struct iterator *it = index_create_iterator(pk, ITER_ALL, NULL, 0);
-	if (it == NULL)
-		return -1;
 	/*
 	 * If we insert a tuple during index being built, new tuple will or
 	 * will not be inserted in index depending on result of lexicographical
 	 * comparison with tuple which was inserted into new index last.
-	 * The problem is HASH index is unordered, so background
-	 * build will not work properly if primary key is HASH index.
+	 * The problem is HASH index is unordered, so if the primary key is
+	 * HASH, a secondary index is built from a read view of the primary
+	 * key instead, and the changes made meanwhile are replayed at the
+	 * end. The read view is clarified with MVCC the same way as a
+	 * checkpoint, so tuples of transactions that aren't committed
+	 * yet don't get into the new index. A new primary key can't be
+	 * built this way, because it must reference its tuples, and a
+	 * tuple from the read view may be already deleted from the space.
+	 * So it is built without yields.
 	 */
-	bool can_yield = pk->def->type != HASH;
+	bool use_log = pk->def->type == HASH;
+	bool can_yield = !use_log || new_index->def->iid != 0;
 
 	if (txn_check_singlestatement(txn, "index build") != 0)
 		return -1;
 
+	/* Now deal with any kind of add index during normal operation. */
+	struct iterator *it;
+	if (use_log && can_yield)
+		it = memtx_hash_index_create_read_view_iterator(pk);
+	else
+		it = index_create_iterator(pk, ITER_ALL, NULL, 0);
+	if (it == NULL)
+		return -1;
+
 	struct memtx_engine *memtx = (struct memtx_engine *)src_space->engine;
 	struct memtx_ddl_state state;
 	struct trigger on_replace;
@@ -1188,6 +1664,8 @@ memtx_space_build_index(struct space *src_space, struct index *new_index,
 		state.index = new_index;
 		state.format = new_format;
 		state.cmp_def = pk->def->key_def;
+		state.use_log = use_log;
+		stailq_create(&state.log);
 		state.rc = 0;
 		diag_create(&state.diag);
 
@@ -1243,8 +1721,10 @@ memtx_space_build_index(struct space *src_space, struct index *new_index,
 		 * avoid processing yet to be added tuples
 		 * in on_replace triggers.
 		 */
-		state.cursor = tuple;
-		tuple_ref(state.cursor);
+		if (!use_log) {
+			state.cursor = tuple;
+			tuple_ref(state.cursor);
+		}
 		if (++count % MEMTX_DDL_YIELD_LOOPS == 0 &&
 		    memtx->state == MEMTX_OK)
 			fiber_sleep(0);
@@ -1253,7 +1733,8 @@ memtx_space_build_index(struct space *src_space, struct index *new_index,
 		 * on_replace triggers for index build.
 		 */
 		ERROR_INJECT_YIELD(ERRINJ_BUILD_INDEX_DELAY);
-		tuple_unref(state.cursor);
+		if (!use_log)
+			tuple_unref(state.cursor);
 		/*
 		 * The on_replace trigger may have failed
 		 * during the yield.
@@ -1264,8 +1745,15 @@ memtx_space_build_index(struct space *src_space, struct index *new_index,
 			break;
 		}
 	}
+	/*
+	 * Replay the log before the read view is deleted: tuples
+	 * from the read view may be still referenced by the index.
+	 */
+	if (rc == 0 && can_yield && use_log)
+		rc = memtx_ddl_replay_log(&state);
 	iterator_delete(it);
 	if (can_yield) {
+		memtx_ddl_destroy_log(&state);
 		diag_destroy(&state.diag);
 		trigger_clear(&on_replace);
 	}
@@ -1287,6 +1775,8 @@ memtx_space_prepare_alter(struct space *old_space, struct space *new_space)
 
 	new_memtx_space->replace = old_memtx_space->replace;
 	new_memtx_space->bsize = old_memtx_space->bsize;
+	new_memtx_space->tuple_size = old_memtx_space->tuple_size;
+	new_memtx_space->expired = old_memtx_space->expired;
 	return 0;
 }
 
@@ -1295,6 +1785,7 @@ memtx_space_prepare_alter(struct space *old_space, struct space *new_space)
 static const struct space_vtab memtx_space_vtab = {
 	/* .destroy = */ memtx_space_destroy,
 	/* .bsize = */ memtx_space_bsize,
+	/* .stat = */ memtx_space_stat,
 	/* .execute_replace = */ memtx_space_execute_replace,
 	/* .execute_delete = */ memtx_space_execute_delete,
 	/* .execute_update = */ memtx_space_execute_update,
@@ -1315,6 +1806,83 @@ static const struct space_vtab memtx_space_vtab = {
 	/* .invalidate = */ generic_space_invalidate,
 };
 
+/**
+ * Create a key definition for each path of the cached_paths option
+ * of the space and append it to @a keys. The format stores the
+ * offsets of key parts in the field map, so lookups by these paths
+ * don't decode the tuple. The parts are nullable and of any type,
+ * so they don't add any constraints except that the parent fields
+ * must be maps or arrays, as it is for an index by a JSON path.
+ * The new keys must be deleted with key_def_delete() after the
+ * format is created.
+ */
+static struct key_def **
+memtx_space_add_cached_paths(struct space_def *def, struct key_def **keys,
+			     int *key_count, int *cached_count)
+{
+	*cached_count = 0;
+	if (def->opts.cached_paths == NULL)
+		return keys;
+	const char *data = def->opts.cached_paths;
+	uint32_t path_count = mp_decode_array(&data);
+	size_t size;
+	struct key_def **all_keys =
+		region_alloc_array(&fiber()->gc, typeof(all_keys[0]),
+				   *key_count + path_count, &size);
+	if (all_keys == NULL) {
+		diag_set(OutOfMemory, size, "region_alloc_array", "keys");
+		return NULL;
+	}
+	memcpy(all_keys, keys, *key_count * sizeof(keys[0]));
+	for (uint32_t i = 0; i < path_count; i++) {
+		uint32_t path_len;
+		const char *path = mp_decode_str(&data, &path_len);
+		struct json_lexer lexer;
+		struct json_token token;
+		json_lexer_create(&lexer, path, path_len, TUPLE_INDEX_BASE);
+		if (json_lexer_next_token(&lexer, &token) != 0)
+			unreachable();
+		struct key_part_def part = key_part_def_default;
+		part.type = FIELD_TYPE_ANY;
+		part.is_nullable = true;
+		part.nullable_action = ON_CONFLICT_ACTION_NONE;
+		if (token.type == JSON_TOKEN_NUM) {
+			part.fieldno = token.num;
+		} else if (token.type != JSON_TOKEN_STR ||
+			   tuple_fieldno_by_name(def->dict, token.str,
+						 token.len,
+						 field_name_hash(token.str,
+								 token.len),
+						 &part.fieldno) != 0) {
+			diag_set(ClientError, ER_WRONG_SPACE_OPTIONS,
+				 BOX_SPACE_FIELD_OPTS,
+				 tt_sprintf("unknown field in cached path "
+					    "'%.*s'", path_len, path));
+			goto fail;
+		}
+		if ((uint32_t)lexer.offset == path_len) {
+			diag_set(ClientError, ER_WRONG_SPACE_OPTIONS,
+				 BOX_SPACE_FIELD_OPTS,
+				 tt_sprintf("cached path '%.*s' must point "
+					    "to a nested field",
+					    path_len, path));
+			goto fail;
+		}
+		part.path = tt_cstr(path + lexer.offset,
+				    path_len - lexer.offset);
+		struct key_def *key_def = key_def_new(&part, 1, false);
+		if (key_def == NULL)
+			goto fail;
+		all_keys[*key_count + (*cached_count)++] = key_def;
+	}
+	*key_count += *cached_count;
+	return all_keys;
+fail:
+	for (int i = 0; i < *cached_count; i++)
+		key_def_delete(all_keys[*key_count + i]);
+	return NULL;
+}
+
 struct space *
 memtx_space_new(struct memtx_engine *memtx,
 		struct space_def *def, struct rlist *key_list)
@@ -1333,11 +1901,20 @@ memtx_space_new(struct memtx_engine *memtx,
 		free(memtx_space);
 		return NULL;
 	}
+	int cached_count;
+	keys = memtx_space_add_cached_paths(def, keys, &key_count,
+					    &cached_count);
+	if (keys == NULL) {
+		free(memtx_space);
+		return NULL;
+	}
 	struct tuple_format *format =
 		tuple_format_new(&memtx_tuple_format_vtab, memtx, keys, key_count,
 				 def->fields, def->field_count,
 				 def->exact_field_count, def->dict,
 				 def->opts.is_temporary, def->opts.is_ephemeral);
+	for (int i = key_count - cached_count; i < key_count; i++)
+		key_def_delete(keys[i]);
 	if (format == NULL) {
 		free(memtx_space);
 		return NULL;
@@ -1355,7 +1932,10 @@ memtx_space_new(struct memtx_engine *memtx,
 	tuple_format_unref(format);
 
 	memtx_space->bsize = 0;
+	memtx_space->tuple_size = 0;
 	memtx_space->rowid = 0;
+	memtx_space->expire_key = NULL;
+	memtx_space->expired = 0;
 	memtx_space->replace = memtx_space_replace_no_keys;
 	return (struct space *)memtx_space;
 }
@@ -43,6 +43,11 @@ struct memtx_space {
 	struct space base;
 	/* Number of bytes used in memory by tuples in the space. */
 	size_t bsize;
+	/**
+	 * Number of bytes allocated for tuples in the space,
+	 * including tuple headers and field maps, see tuple_size().
+	 */
+	size_t tuple_size;
 	/**
 	 * This counter is used to generate unique ids for
 	 * ephemeral spaces. Mostly used by SQL: values of this
@@ -50,6 +55,14 @@ struct memtx_space {
 	 * tuples within one unique primary key.
 	 */
 	uint64_t rowid;
+	/**
+	 * Primary key of the last tuple checked for expiration,
+	 * MsgPack array allocated with malloc(). NULL if the next
+	 * check starts from the beginning. See memtx_space_expire().
+	 */
+	char *expire_key;
+	/** Number of tuples deleted because they expired. */
+	uint64_t expired;
 	/**
 	 * A pointer to replace function, set to different values
 	 * at different stages of recovery.
@@ -59,9 +72,9 @@ struct memtx_space {
 };
 
 /**
- * Change binary size of a space subtracting old tuple's size and
- * adding new tuple's size. Used also for rollback by swaping old
- * and new tuple.
+ * Change binary size and tuple memory of a space subtracting old
+ * tuple's size and adding new tuple's size. Used also for rollback
+ * by swaping old and new tuple.
  *
  * @param space Instance of memtx space.
  * @param old_tuple Old tuple (replaced or deleted).
@@ -71,6 +84,32 @@ void
 memtx_space_update_bsize(struct space *space, struct tuple *old_tuple,
 			 struct tuple *new_tuple);
 
+/**
+ * Number of bytes used by tuples and indexes of a memtx space.
+ */
+size_t
+memtx_space_memory_used(struct space *space);
+
+/**
+ * Delete expired tuples of a space with the expire_field option.
+ * If the space has a TREE index with the expire_field as the first
+ * non-nullable numeric part, the expired tuples are taken from its
+ * beginning. Otherwise a batch of tuples of the primary index is
+ * checked, starting after the one where the previous call stopped.
+ * The expired tuples are deleted in a transaction, so the call
+ * yields if there are any.
+ *
+ * @param space_id space identifier, the space may be dropped
+ *                 during the call.
+ * @param now current time, in seconds since the epoch.
+ * @param[out] is_done set if there are no more expired tuples
+ *                     to check until the next call starts over.
+ * @retval 0 success.
+ * @retval -1 error, diag is set.
+ */
+int
+memtx_space_expire(uint32_t space_id, double now, bool *is_done);
+
 int
 memtx_space_replace_no_keys(struct space *, struct tuple *, struct tuple *,
 			    enum dup_replace_mode, struct tuple **);
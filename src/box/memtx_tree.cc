@@ -39,6 +39,7 @@
 #include "tuple.h"
 #include "txn.h"
 #include "memtx_tx.h"
+#include "assoc.h"
 #include <qsort_arg.h>
 #include <small/mempool.h>
 
@@ -117,6 +118,7 @@ memtx_tree_data_is_equal(const struct memtx_tree_data_common *a,
 			       (b)->part_count, (b)->hint, arg)
 #define BPS_TREE_IS_IDENTICAL(a, b) memtx_tree_data_is_equal(&a, &b)
 #define BPS_TREE_NO_DEBUG 1
+#define BPS_TREE_PREFETCH
 #define bps_tree_arg_t struct key_def *
 
 #define BPS_TREE_NAMESPACE NS_NO_HINT
@@ -146,6 +148,7 @@ memtx_tree_data_is_equal(const struct memtx_tree_data_common *a,
 #undef BPS_TREE_COMPARE_KEY
 #undef BPS_TREE_IS_IDENTICAL
 #undef BPS_TREE_NO_DEBUG
+#undef BPS_TREE_PREFETCH
 #undef bps_tree_arg_t
 
 using namespace NS_NO_HINT;
@@ -197,8 +200,19 @@ struct memtx_tree_index {
 	memtx_tree_t<USE_HINT> tree;
 	struct memtx_tree_data<USE_HINT> *build_array;
 	size_t build_array_size, build_array_alloc_size;
+	/**
+	 * Set if build_array has already been sorted by
+	 * memtx_tree_index_sort_build_array() so that
+	 * end_build() doesn't need to sort it again.
+	 */
+	bool build_array_is_sorted;
 	struct memtx_gc_task gc_task;
 	memtx_tree_iterator_t<USE_HINT> gc_iterator;
+	/**
+	 * Functional index only: tuple -> the chunk with all
+	 * keys of the tuple, see memtx_tree_func_index_replace().
+	 */
+	struct mh_i64ptr_t *func_keys;
 };
 
 /* {{{ Utilities. *************************************************/
@@ -458,6 +472,54 @@ tree_iterator_prev_equal_base(struct iterator *iterator, struct tuple **ret)
 	return 0;
 }
 
+template <bool USE_HINT>
+static int
+tree_iterator_next_prefix_base(struct iterator *iterator, struct tuple **ret)
+{
+	struct memtx_tree_index<USE_HINT> *index =
+		(struct memtx_tree_index<USE_HINT> *)iterator->index;
+	struct tree_iterator<USE_HINT> *it = get_tree_iterator<USE_HINT>(iterator);
+	assert(it->current.tuple != NULL);
+	struct memtx_tree_data<USE_HINT> *check =
+		memtx_tree_iterator_get_elem(&index->tree, &it->tree_iterator);
+	if (check == NULL || !memtx_tree_data_is_equal(check, &it->current)) {
+		it->tree_iterator = memtx_tree_upper_bound_elem(&index->tree,
+								it->current, NULL);
+	} else {
+		memtx_tree_iterator_next(&index->tree, &it->tree_iterator);
+	}
+	tuple_unref(it->current.tuple);
+	struct memtx_tree_data<USE_HINT> *res =
+		memtx_tree_iterator_get_elem(&index->tree, &it->tree_iterator);
+	/*
+	 * Strings starting with the key follow each other in
+	 * the tree, so stop at the first one that doesn't.
+	 */
+	if (res == NULL ||
+	    !tuple_matches_prefix(res->tuple, index->base.def->key_def,
+				  it->key_data.key,
+				  it->key_data.part_count)) {
+		iterator->next = tree_iterator_dummie;
+		it->current.tuple = NULL;
+		*ret = NULL;
+	} else {
+		*ret = res->tuple;
+		tuple_ref(*ret);
+		it->current = *res;
+	}
+	struct index *idx = iterator->index;
+	struct space *space = space_by_id(iterator->space_id);
+	/*
+	 * Pass no key because any write to the gap between that
+	 * two tuples must lead to conflict. On the end of the key
+	 * it is the gap before the first tuple that doesn't match.
+	 */
+	struct tuple *nearby_tuple = res == NULL ? NULL : res->tuple;
+	memtx_tx_track_gap(in_txn(), space, idx, nearby_tuple, ITER_GE,
+			   NULL, 0);
+	return 0;
+}
+
 #define WRAP_ITERATOR_METHOD(name)						\
 template <bool USE_HINT>							\
 static int									\
@@ -498,6 +560,7 @@ WRAP_ITERATOR_METHOD(tree_iterator_next);
 WRAP_ITERATOR_METHOD(tree_iterator_prev);
 WRAP_ITERATOR_METHOD(tree_iterator_next_equal);
 WRAP_ITERATOR_METHOD(tree_iterator_prev_equal);
+WRAP_ITERATOR_METHOD(tree_iterator_next_prefix);
 
 #undef WRAP_ITERATOR_METHOD
 
@@ -524,6 +587,9 @@ tree_iterator_set_next_method(struct tree_iterator<USE_HINT> *it)
 	case ITER_GT:
 		it->base.next = tree_iterator_next<USE_HINT>;
 		break;
+	case ITER_PREFIX:
+		it->base.next = tree_iterator_next_prefix<USE_HINT>;
+		break;
 	default:
 		/* The type was checked in initIterator */
 		assert(false);
@@ -572,7 +638,8 @@ tree_iterator_start(struct iterator *iterator, struct tuple **ret)
 		equals = memtx_tree_size(tree) != 0;
 	} else {
 		if (type == ITER_ALL || type == ITER_EQ ||
-		    type == ITER_GE || type == ITER_LT) {
+		    type == ITER_GE || type == ITER_LT ||
+		    type == ITER_PREFIX) {
 			it->tree_iterator =
 				memtx_tree_lower_bound(tree, &it->key_data,
 						       &equals);
@@ -595,7 +662,14 @@ tree_iterator_start(struct iterator *iterator, struct tuple **ret)
 			memtx_tree_iterator_get_elem(tree, &it->tree_iterator);
 		struct tuple *successor =
 			succ_data == NULL ? NULL : succ_data->tuple;
-		memtx_tx_track_gap(in_txn(), space, idx, successor, type,
+		/*
+		 * The gap of a PREFIX iterator is tracked as the one of
+		 * GE: it is wider, but the first tuple that doesn't match
+		 * is found by the iterator steps and ends the gap.
+		 */
+		enum iterator_type gap_type =
+			type == ITER_PREFIX ? ITER_GE : type;
+		memtx_tx_track_gap(in_txn(), space, idx, successor, gap_type,
 				   it->key_data.key, it->key_data.part_count);
 	}
 	if (iterator_type_is_reverse(type)) {
@@ -617,6 +691,10 @@ tree_iterator_start(struct iterator *iterator, struct tuple **ret)
 		memtx_tree_iterator_get_elem(tree, &it->tree_iterator);
 	if (!res)
 		return 0;
+	if (type == ITER_PREFIX &&
+	    !tuple_matches_prefix(res->tuple, index->base.def->key_def,
+				  it->key_data.key, it->key_data.part_count))
+		return 0;
 	*ret = res->tuple;
 	tuple_ref(*ret);
 	it->current = *res;
@@ -1046,11 +1124,23 @@ memtx_tree_index_replace_multikey(struct index *base, struct tuple *old_tuple,
 	*successor = NULL;
 
 	struct key_def *cmp_def = memtx_tree_cmp_def(&index->tree);
+	struct region *region = &fiber()->gc;
+	size_t region_svp = region_used(region);
+	/*
+	 * Bitmap of the old tuple entries that were replaced by the
+	 * new tuple entries. They are already gone from the tree, so
+	 * they are skipped when the rest of the old entries is
+	 * deleted. Allocated on the first replaced entry. If there is
+	 * no memory for it, every old entry is looked up, which is
+	 * slower but still correct.
+	 */
+	void *replaced_map = NULL;
 	*result = NULL;
 	if (new_tuple != NULL) {
 		int multikey_idx = 0, err = 0;
 		uint32_t multikey_count =
 			tuple_multikey_count(new_tuple, cmp_def);
+		bool map_failed = false;
 		for (; (uint32_t) multikey_idx < multikey_count;
 		     multikey_idx++) {
 			bool is_multikey_conflict;
@@ -1061,14 +1151,28 @@ memtx_tree_index_replace_multikey(struct index *base, struct tuple *old_tuple,
 						&is_multikey_conflict);
 			if (err != 0)
 				break;
-			if (replaced_data.tuple != NULL &&
-			    !is_multikey_conflict) {
-				assert(*result == NULL ||
-				       *result == replaced_data.tuple);
-				*result = replaced_data.tuple;
+			if (replaced_data.tuple == NULL ||
+			    is_multikey_conflict)
+				continue;
+			assert(*result == NULL ||
+			       *result == replaced_data.tuple);
+			*result = replaced_data.tuple;
+			if (replaced_map == NULL && !map_failed) {
+				uint32_t old_count = tuple_multikey_count(
+						replaced_data.tuple, cmp_def);
+				size_t size = DIV_ROUND_UP(old_count,
+							   CHAR_BIT);
+				replaced_map = region_alloc(region, size);
+				if (replaced_map != NULL)
+					memset(replaced_map, 0, size);
+				else
+					map_failed = true;
 			}
+			if (replaced_map != NULL)
+				bit_set(replaced_map, replaced_data.hint);
 		}
 		if (err != 0) {
+			region_truncate(region, region_svp);
 			memtx_tree_index_replace_multikey_rollback(index,
 					new_tuple, *result, multikey_idx);
 			return -1;
@@ -1084,13 +1188,42 @@ memtx_tree_index_replace_multikey(struct index *base, struct tuple *old_tuple,
 		uint32_t multikey_count =
 			tuple_multikey_count(old_tuple, cmp_def);
 		for (int i = 0; (uint32_t) i < multikey_count; i++) {
+			if (replaced_map != NULL && bit_test(replaced_map, i))
+				continue;
 			data.hint = i;
 			memtx_tree_delete_value(&index->tree, data, NULL);
 		}
 	}
+	region_truncate(region, region_svp);
 	return 0;
 }
 
+static void
+memtx_tree_func_index_destroy(struct index *base)
+{
+	struct memtx_tree_index<true> *index =
+		(struct memtx_tree_index<true> *)base;
+	struct mh_i64ptr_t *h = index->func_keys;
+	mh_int_t pos;
+	mh_foreach(h, pos) {
+		struct mh_i64ptr_node_t *node = mh_i64ptr_node(h, pos);
+		tuple_chunk_delete((struct tuple *)(uintptr_t)node->key,
+				   (const char *)node->val);
+	}
+	mh_i64ptr_delete(h);
+	index->func_keys = NULL;
+	memtx_tree_index_destroy<true>(base);
+}
+
+static ssize_t
+memtx_tree_func_index_bsize(struct index *base)
+{
+	struct memtx_tree_index<true> *index =
+		(struct memtx_tree_index<true> *)base;
+	return memtx_tree_index_bsize<true>(base) +
+	       mh_i64ptr_memsize(index->func_keys);
+}
+
 /** A dummy key allocator used when removing tuples from an index. */
 static const char *
 func_index_key_dummy_alloc(struct tuple *tuple, const char *key,
@@ -1139,26 +1272,87 @@ memtx_tree_func_index_replace_rollback(struct memtx_tree_index<true> *index,
 				       struct rlist *new_keys)
 {
 	struct func_key_undo *entry;
-	rlist_foreach_entry(entry, new_keys, link) {
+	rlist_foreach_entry(entry, new_keys, link)
 		memtx_tree_delete_value(&index->tree, entry->key, NULL);
-		tuple_chunk_delete(entry->key.tuple,
-				   (const char *)entry->key.hint);
-	}
 	rlist_foreach_entry(entry, old_keys, link)
 		memtx_tree_insert(&index->tree, entry->key, NULL, NULL);
 }
 
+/**
+ * Copy the keys returned by the functional index function to one
+ * tuple chunk, and make the iterator return keys from the chunk.
+ * Returns the chunk data or NULL on memory error.
+ */
+static const char *
+memtx_tree_func_index_copy_keys(struct key_list_iterator *it,
+				struct tuple *tuple)
+{
+	uint32_t size = it->data_end - it->data;
+	const char *keys = tuple_chunk_new(tuple, it->data, size);
+	if (keys == NULL)
+		return NULL;
+	it->data = keys;
+	it->data_end = keys + size;
+	return keys;
+}
+
+/** Remember the chunk with the keys of a tuple inserted into the index. */
+static int
+memtx_tree_func_index_put_keys(struct memtx_tree_index<true> *index,
+			       struct tuple *tuple, const char *keys)
+{
+	struct mh_i64ptr_node_t node = {(uint64_t)(uintptr_t)tuple,
+					(void *)keys};
+	struct mh_i64ptr_node_t old_node, *old = &old_node;
+	if (mh_i64ptr_put(index->func_keys, &node, &old, NULL) ==
+	    mh_end(index->func_keys)) {
+		diag_set(OutOfMemory, sizeof(node), "mh_i64ptr_put",
+			 "func_keys");
+		return -1;
+	}
+	if (old != NULL)
+		tuple_chunk_delete(tuple, (const char *)old->val);
+	return 0;
+}
+
+/**
+ * Forget the chunk with the keys of a tuple deleted from the index
+ * and return it. Returns NULL if the tuple isn't in the index.
+ */
+static const char *
+memtx_tree_func_index_take_keys(struct memtx_tree_index<true> *index,
+				struct tuple *tuple)
+{
+	struct mh_i64ptr_t *h = index->func_keys;
+	mh_int_t pos = mh_i64ptr_find(h, (uint64_t)(uintptr_t)tuple, NULL);
+	if (pos == mh_end(h))
+		return NULL;
+	const char *keys = (const char *)mh_i64ptr_node(h, pos)->val;
+	mh_i64ptr_del(h, pos, NULL);
+	return keys;
+}
+
+/** Return the end of the keys stored in a tuple chunk. */
+static inline const char *
+memtx_tree_func_index_keys_end(const char *keys)
+{
+	const struct tuple_chunk *chunk = (const struct tuple_chunk *)
+		(keys - offsetof(struct tuple_chunk, data));
+	return keys + chunk->data_sz;
+}
+
 /**
  * @sa memtx_tree_index_replace_multikey().
  * Use the functional index function from the key definition
- * to build a key list. Then each returned key is reallocated in
- * engine's memory as key_hint object and is used as comparison
- * hint.
- * To release key_hint memory in case of replace failure
- * we use a list of undo records which are allocated on region.
- * It is used to restore the original b+* entries with their
- * original key_hint(s) pointers in case of failure and release
- * the now useless hints of old items in case of success.
+ * to build a key list. The keys are copied to one tuple chunk
+ * in engine's memory, and each of them is used as comparison
+ * hint of a tree entry. The chunk is found by the tuple in
+ * func_keys, so a tuple is deleted from the index without
+ * calling the function again.
+ * To restore the index in case of replace failure we use a list
+ * of undo records which are allocated on region. It is used to
+ * restore the original b+* entries with their original key_hint(s)
+ * pointers.
  */
 static int
 memtx_tree_func_index_replace(struct index *base, struct tuple *old_tuple,
@@ -1184,7 +1378,11 @@ memtx_tree_func_index_replace(struct index *base, struct tuple *old_tuple,
 		rlist_create(&old_keys);
 		rlist_create(&new_keys);
 		if (key_list_iterator_create(&it, new_tuple, index_def, true,
-					     tuple_chunk_new) != 0)
+					     func_index_key_dummy_alloc) != 0)
+			goto end;
+		const char *new_keys_chunk =
+			memtx_tree_func_index_copy_keys(&it, new_tuple);
+		if (new_keys_chunk == NULL)
 			goto end;
 		int err = 0;
 		const char *key;
@@ -1194,7 +1392,6 @@ memtx_tree_func_index_replace(struct index *base, struct tuple *old_tuple,
 			/* Perform insertion, log it in list. */
 			undo = func_key_undo_new(region);
 			if (undo == NULL) {
-				tuple_chunk_delete(new_tuple, key);
 				err = -1;
 				break;
 			}
@@ -1233,8 +1430,6 @@ memtx_tree_func_index_replace(struct index *base, struct tuple *old_tuple,
 				 * Remove the replaced tuple undo
 				 * from undo list.
 				 */
-				tuple_chunk_delete(new_tuple,
-						(const char *)old_data.hint);
 				rlist_foreach_entry(undo, &new_keys, link) {
 					if (undo->key.hint == old_data.hint) {
 						rlist_del(&undo->link);
@@ -1243,46 +1438,39 @@ memtx_tree_func_index_replace(struct index *base, struct tuple *old_tuple,
 				}
 			}
 		}
-		if (key != NULL || err != 0) {
+		if (key != NULL || err != 0 ||
+		    memtx_tree_func_index_put_keys(index, new_tuple,
+						   new_keys_chunk) != 0) {
 			memtx_tree_func_index_replace_rollback(index,
 						&old_keys, &new_keys);
+			tuple_chunk_delete(new_tuple, new_keys_chunk);
 			goto end;
 		}
 		if (*result != NULL) {
 			assert(old_tuple == NULL || old_tuple == *result);
 			old_tuple = *result;
 		}
-		/*
-		 * Commit changes: release hints for
-		 * replaced entries.
-		 */
-		rlist_foreach_entry(undo, &old_keys, link) {
-			tuple_chunk_delete(undo->key.tuple,
-					   (const char *)undo->key.hint);
-		}
 	}
 	if (old_tuple != NULL) {
-		if (key_list_iterator_create(&it, old_tuple, index_def, false,
-					     func_index_key_dummy_alloc) != 0)
-			goto end;
-		struct memtx_tree_data<true> data, deleted_data;
-		data.tuple = old_tuple;
-		const char *key;
-		while (key_list_iterator_next(&it, &key) == 0 && key != NULL) {
-			data.hint = (hint_t) key;
-			deleted_data.tuple = NULL;
-			memtx_tree_delete_value(&index->tree, data,
-						&deleted_data);
-			if (deleted_data.tuple != NULL) {
-				/*
-				 * Release related hint on
-				 * successful node deletion.
-				 */
-				tuple_chunk_delete(deleted_data.tuple,
-					(const char *)deleted_data.hint);
+		/*
+		 * The entries replaced by the new tuple are already
+		 * gone, deleting them again is a no-op.
+		 */
+		const char *keys =
+			memtx_tree_func_index_take_keys(index, old_tuple);
+		if (keys != NULL) {
+			const char *keys_end =
+				memtx_tree_func_index_keys_end(keys);
+			struct memtx_tree_data<true> data;
+			data.tuple = old_tuple;
+			for (const char *key = keys; key < keys_end;
+			     mp_next(&key)) {
+				data.hint = (hint_t)key;
+				memtx_tree_delete_value(&index->tree, data,
+							NULL);
 			}
+			tuple_chunk_delete(old_tuple, keys);
 		}
-		assert(key == NULL);
 	}
 	rc = 0;
 end:
@@ -1301,13 +1489,14 @@ memtx_tree_index_create_iterator(struct index *base, enum iterator_type type,
 	struct key_def *cmp_def = memtx_tree_cmp_def(&index->tree);
 
 	assert(part_count == 0 || key != NULL);
-	if (type > ITER_GT) {
+	if (type > ITER_GT && type != ITER_PREFIX) {
 		diag_set(UnsupportedIndexFeature, base->def,
 			 "requested iterator type");
 		return NULL;
 	}
 
 	if (part_count == 0) {
+		assert(type != ITER_PREFIX);
 		/*
 		 * If no key is specified, downgrade equality
 		 * iterators to a full range.
@@ -1447,8 +1636,13 @@ memtx_tree_func_index_build_next(struct index *base, struct tuple *tuple)
 
 	struct key_list_iterator it;
 	if (key_list_iterator_create(&it, tuple, index_def, false,
-				     tuple_chunk_new) != 0)
+				     func_index_key_dummy_alloc) != 0)
 		return -1;
+	const char *keys = memtx_tree_func_index_copy_keys(&it, tuple);
+	if (keys == NULL) {
+		region_truncate(region, region_svp);
+		return -1;
+	}
 
 	const char *key;
 	uint32_t insert_idx = index->build_array_size;
@@ -1458,13 +1652,13 @@ memtx_tree_func_index_build_next(struct index *base, struct tuple *tuple)
 			goto error;
 	}
 	assert(key == NULL);
+	if (memtx_tree_func_index_put_keys(index, tuple, keys) != 0)
+		goto error;
 	region_truncate(region, region_svp);
 	return 0;
 error:
-	for (uint32_t i = insert_idx; i < index->build_array_size; i++) {
-		tuple_chunk_delete(index->build_array[i].tuple,
-				   (const char *)index->build_array[i].hint);
-	}
+	index->build_array_size = insert_idx;
+	tuple_chunk_delete(tuple, keys);
 	region_truncate(region, region_svp);
 	return -1;
 }
@@ -1476,8 +1670,7 @@ error:
  */
 template <bool USE_HINT>
 static void
-memtx_tree_index_build_array_deduplicate(struct memtx_tree_index<USE_HINT> *index,
-			void (*destroy)(struct tuple *tuple, const char *hint))
+memtx_tree_index_build_array_deduplicate(struct memtx_tree_index<USE_HINT> *index)
 {
 	if (index->build_array_size == 0)
 		return;
@@ -1499,39 +1692,44 @@ memtx_tree_index_build_array_deduplicate(struct memtx_tree_index<USE_HINT> *inde
 		}
 		r_idx++;
 	}
-	if (destroy != NULL) {
-		/* Destroy deduplicated entries. */
-		for (r_idx = w_idx + 1;
-		     r_idx < index->build_array_size; r_idx++) {
-			destroy(index->build_array[r_idx].tuple,
-				(const char *)index->build_array[r_idx].hint);
-		}
-	}
 	index->build_array_size = w_idx + 1;
 }
 
 template <bool USE_HINT>
 static void
-memtx_tree_index_end_build(struct index *base)
+memtx_tree_index_sort_build_array_tpl(struct index *base)
 {
 	struct memtx_tree_index<USE_HINT> *index =
 		(struct memtx_tree_index<USE_HINT> *)base;
+	if (index->build_array_is_sorted)
+		return;
 	struct key_def *cmp_def = memtx_tree_cmp_def(&index->tree);
 	qsort_arg(index->build_array, index->build_array_size,
 		  sizeof(index->build_array[0]),
 		  memtx_tree_qcompare<USE_HINT>, cmp_def);
-	if (cmp_def->is_multikey) {
+	index->build_array_is_sorted = true;
+}
+
+template <bool USE_HINT>
+static void
+memtx_tree_index_end_build(struct index *base)
+{
+	struct memtx_tree_index<USE_HINT> *index =
+		(struct memtx_tree_index<USE_HINT> *)base;
+	struct key_def *cmp_def = memtx_tree_cmp_def(&index->tree);
+	memtx_tree_index_sort_build_array_tpl<USE_HINT>(base);
+	if (cmp_def->is_multikey || cmp_def->for_func_index) {
 		/*
 		 * Multikey index may have equal(in terms of
 		 * cmp_def) keys inserted by different multikey
-		 * offsets. We must deduplicate them because
-		 * the following memtx_tree_build assumes that
-		 * all keys are unique.
+		 * offsets, and a functional index function may
+		 * return equal keys. We must deduplicate them
+		 * because the following memtx_tree_build assumes
+		 * that all keys are unique. The keys of a tuple
+		 * in a functional index share one chunk, so there
+		 * is nothing to free.
 		 */
-		memtx_tree_index_build_array_deduplicate<USE_HINT>(index, NULL);
-	} else if (cmp_def->for_func_index) {
-		memtx_tree_index_build_array_deduplicate<USE_HINT>(index,
-							 tuple_chunk_delete);
+		memtx_tree_index_build_array_deduplicate<USE_HINT>(index);
 	}
 	memtx_tree_build(&index->tree, index->build_array,
 			 index->build_array_size);
@@ -1540,6 +1738,7 @@ memtx_tree_index_end_build(struct index *base)
 	index->build_array = NULL;
 	index->build_array_size = 0;
 	index->build_array_alloc_size = 0;
+	index->build_array_is_sorted = false;
 }
 
 template <bool USE_HINT>
@@ -1723,7 +1922,7 @@ static const struct index_vtab memtx_tree_index_multikey_vtab = {
 };
 
 static const struct index_vtab memtx_tree_func_index_vtab = {
-	/* .destroy = */ memtx_tree_index_destroy<true>,
+	/* .destroy = */ memtx_tree_func_index_destroy,
 	/* .commit_create = */ generic_index_commit_create,
 	/* .abort_create = */ generic_index_abort_create,
 	/* .commit_modify = */ generic_index_commit_modify,
@@ -1733,7 +1932,7 @@ static const struct index_vtab memtx_tree_func_index_vtab = {
 	/* .def_change_requires_rebuild = */
 		memtx_index_def_change_requires_rebuild,
 	/* .size = */ memtx_tree_index_size<true>,
-	/* .bsize = */ memtx_tree_index_bsize<true>,
+	/* .bsize = */ memtx_tree_func_index_bsize,
 	/* .min = */ generic_index_min,
 	/* .max = */ generic_index_max,
 	/* .random = */ memtx_tree_index_random<true>,
@@ -1788,6 +1987,17 @@ static const struct index_vtab memtx_tree_disabled_index_vtab = {
 	/* .end_build = */ generic_index_end_build,
 };
 
+void
+memtx_tree_index_sort_build_array(struct index *base)
+{
+	if (base->vtab == &memtx_tree_no_hint_index_vtab)
+		memtx_tree_index_sort_build_array_tpl<false>(base);
+	else if (base->vtab == &memtx_tree_use_hint_index_vtab ||
+		 base->vtab == &memtx_tree_index_multikey_vtab ||
+		 base->vtab == &memtx_tree_func_index_vtab)
+		memtx_tree_index_sort_build_array_tpl<true>(base);
+}
+
 template <bool USE_HINT>
 static struct index *
 memtx_tree_index_new_tpl(struct memtx_engine *memtx, struct index_def *def,
@@ -1823,9 +2033,16 @@ memtx_tree_index_new(struct memtx_engine *memtx, struct index_def *def)
 	const struct index_vtab *vtab;
 	if (def->key_def->for_func_index) {
 		if (def->key_def->func_index_func == NULL)
-			vtab = &memtx_tree_disabled_index_vtab;
-		else
-			vtab = &memtx_tree_func_index_vtab;
+			return memtx_tree_index_new_tpl<true>(memtx, def,
+					&memtx_tree_disabled_index_vtab);
+		struct index *base = memtx_tree_index_new_tpl<true>(memtx, def,
+					&memtx_tree_func_index_vtab);
+		if (base != NULL) {
+			struct memtx_tree_index<true> *index =
+				(struct memtx_tree_index<true> *)base;
+			index->func_keys = mh_i64ptr_new();
+		}
+		return base;
 	} else if (def->key_def->is_multikey) {
 		vtab = &memtx_tree_index_multikey_vtab;
 	} else if (def->opts.hint) {
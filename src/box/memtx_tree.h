@@ -42,6 +42,18 @@ struct memtx_engine;
 struct index *
 memtx_tree_index_new(struct memtx_engine *memtx, struct index_def *def);
 
+/**
+ * Sort the keys collected with index_build_next() so that the
+ * following index_end_build() only has to build the tree.
+ *
+ * The function doesn't touch anything but the index build array
+ * so it may be called from a thread other than tx, provided tx
+ * doesn't use the index meanwhile. It is a no-op if the index
+ * isn't a memtx tree index.
+ */
+void
+memtx_tree_index_sort_build_array(struct index *index);
+
 #if defined(__cplusplus)
 } /* extern "C" */
 #endif /* defined(__cplusplus) */
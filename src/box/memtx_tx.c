@@ -36,7 +36,12 @@
 #include <stdint.h>
 
 #include "txn.h"
+#include "schema.h"
 #include "schema_def.h"
+#include "session.h"
+#include "space.h"
+#include "fiber.h"
+#include "info/info.h"
 #include "small/mempool.h"
 
 static uint32_t
@@ -213,6 +218,18 @@ struct tx_manager
 	struct rlist all_txs;
 	/** Accumulated number of GC steps that should be done. */
 	size_t must_do_gc_steps;
+	/** Number of memtx_story objects. */
+	size_t story_count;
+	/** Memory used by memtx_story objects, in bytes. */
+	size_t story_bytes;
+	/** Number of gap_item objects. */
+	size_t gap_count;
+	/** Number of full_scan_item objects. */
+	size_t full_scan_count;
+	/** Number of GC steps done so far. */
+	uint64_t gc_steps;
+	/** Number of stories deleted by GC so far. */
+	uint64_t gc_freed;
 };
 
 enum {
@@ -222,8 +239,21 @@ enum {
 	 * a new story.
 	 */
 		TX_MANAGER_GC_STEPS_SIZE = 2,
+	/**
+	 * Number of GC steps the background GC fiber does
+	 * before yielding.
+	 */
+	TX_MANAGER_GC_BATCH_SIZE = 1000,
 };
 
+/**
+ * Min and max time the background GC fiber sleeps between passes
+ * over all stories, in seconds. It sleeps longer while the passes
+ * don't free anything, see memtx_tx_gc_f().
+ */
+static const double TX_MANAGER_GC_MIN_DELAY = 0.01;
+static const double TX_MANAGER_GC_MAX_DELAY = 1;
+
 /** That's a definition, see declaration for description. */
 bool memtx_tx_manager_use_mvcc_engine = false;
 
@@ -253,6 +283,12 @@ memtx_tx_manager_init()
 	rlist_create(&txm.all_txs);
 	txm.traverse_all_stories = &txm.all_stories;
 	txm.must_do_gc_steps = 0;
+	txm.story_count = 0;
+	txm.story_bytes = 0;
+	txm.gap_count = 0;
+	txm.full_scan_count = 0;
+	txm.gc_steps = 0;
+	txm.gc_freed = 0;
 }
 
 void
@@ -365,6 +401,23 @@ memtx_tx_handle_conflict(struct txn *breaker, struct txn *victim)
 	}
 }
 
+void
+memtx_tx_open_read_view(struct txn *txn)
+{
+	if (!memtx_tx_manager_use_mvcc_engine)
+		return;
+	assert(txn->status == TXN_INPROGRESS);
+	assert(stailq_empty(&txn->stmts));
+	txn->status = TXN_IN_READ_VIEW;
+	/*
+	 * Everything prepared so far has psn <= txn_last_psn. The list
+	 * stays sorted, since rv_psn of the other read views is a psn
+	 * of a prepared transaction.
+	 */
+	txn->rv_psn = txn_last_psn + 1;
+	rlist_add_tail(&txm.read_view_txs, &txn->in_read_view_txs);
+}
+
 /**
  * Create a new story and link it with the @a tuple.
  * @return story on success, NULL on error (diag is set).
@@ -386,6 +439,8 @@ memtx_tx_story_new(struct space *space, struct tuple *tuple)
 		return NULL;
 	}
 	story->tuple = tuple;
+	txm.story_count++;
+	txm.story_bytes += pool->objsize;
 
 	const struct memtx_story **put_story =
 		(const struct memtx_story **) &story;
@@ -448,6 +503,9 @@ memtx_tx_story_delete(struct memtx_story *story)
 #endif
 
 	struct mempool *pool = &txm.memtx_tx_story_pool[story->index_count];
+	assert(txm.story_count > 0);
+	txm.story_count--;
+	txm.story_bytes -= pool->objsize;
 	mempool_free(pool, story);
 }
 
@@ -867,6 +925,7 @@ memtx_tx_story_full_unlink(struct memtx_story *story)
 static void
 memtx_tx_story_gc_step()
 {
+	txm.gc_steps++;
 	if (txm.traverse_all_stories == &txm.all_stories) {
 		/* We came to the head of the list. */
 		txm.traverse_all_stories = txm.traverse_all_stories->next;
@@ -908,6 +967,7 @@ memtx_tx_story_gc_step()
 	/* Unlink and delete the story */
 	memtx_tx_story_full_unlink(story);
 	memtx_tx_story_delete(story);
+	txm.gc_freed++;
 }
 
 /**
@@ -921,17 +981,51 @@ memtx_tx_story_gc()
 	txm.must_do_gc_steps = 0;
 }
 
+int
+memtx_tx_gc_f(va_list ap)
+{
+	(void)ap;
+	double delay = TX_MANAGER_GC_MIN_DELAY;
+	while (!fiber_is_cancelled()) {
+		fiber_sleep(delay);
+		/*
+		 * Make a pass over all stories. Writers do only a
+		 * few GC steps per story they create, which isn't
+		 * enough to keep up when many stories are pinned
+		 * by read views: most of the steps are wasted.
+		 */
+		uint64_t freed = txm.gc_freed;
+		size_t steps = txm.story_count + 1;
+		for (size_t i = 1; i <= steps; i++) {
+			memtx_tx_story_gc_step();
+			if (i % TX_MANAGER_GC_BATCH_SIZE == 0)
+				fiber_sleep(0);
+		}
+		/*
+		 * If nothing was freed, the stories are still in
+		 * use, so back off until they are released.
+		 */
+		if (txm.gc_freed == freed)
+			delay = MIN(delay * 2, TX_MANAGER_GC_MAX_DELAY);
+		else
+			delay = TX_MANAGER_GC_MIN_DELAY;
+	}
+	return 0;
+}
+
 /**
  * Check if a @a story is visible for transaction @a txn. Return visible tuple
  * to @a visible_tuple (can be set to NULL).
  * @param is_prepared_ok - whether prepared (not committed) change is acceptable.
+ * @param own_session_id - if not 0, prepared changes of transactions started
+ *  by this session are acceptable even if @a is_prepared_ok is false.
  * @param own_change - return true if the change was made by @txn itself.
  * @return true if the story is visible, false otherwise.
  */
 static bool
 memtx_tx_story_is_visible(struct memtx_story *story, struct txn *txn,
 			  struct tuple **visible_tuple, bool is_prepared_ok,
-			  bool *own_change)
+			  uint64_t own_session_id, bool *own_change)
 {
 	*own_change = false;
 	*visible_tuple = NULL;
@@ -948,8 +1042,15 @@ memtx_tx_story_is_visible(struct memtx_story *story, struct txn *txn,
 			*own_change = true;
 			return true;
 		}
-		if (story->del_psn != 0 && dels->txn->psn == story->del_psn)
+		if (story->del_psn != 0 && dels->txn->psn == story->del_psn) {
 			was_deleted_by_prepared = true;
+			if (own_session_id != 0 &&
+			    dels->txn->session_id == own_session_id &&
+			    story->del_psn < rv_psn) {
+				/* Tuple is deleted by our session's TX. */
+				return true;
+			}
+		}
 		dels = dels->next_in_del_list;
 	}
 	if (is_prepared_ok && story->del_psn != 0 && story->del_psn < rv_psn) {
@@ -973,6 +1074,14 @@ memtx_tx_story_is_visible(struct memtx_story *story, struct txn *txn,
 		*visible_tuple = story->tuple;
 		return true;
 	}
+	if (own_session_id != 0 && story->add_psn != 0 &&
+	    story->add_stmt != NULL &&
+	    story->add_stmt->txn->session_id == own_session_id &&
+	    story->add_psn < rv_psn) {
+		/* Tuple is added by our session's prepared TX. */
+		*visible_tuple = story->tuple;
+		return true;
+	}
 	if (story->add_psn != 0 && story->add_stmt == NULL &&
 	    story->add_psn < rv_psn) {
 		/* Tuple is added by committed TX. */
@@ -1043,7 +1152,8 @@ memtx_tx_story_find_visible_tuple(struct memtx_story *story,
 		assert(index < story->index_count);
 		bool unused;
 		if (memtx_tx_story_is_visible(story, stmt->txn,
-					      visible_replaced, true, &unused))
+					      visible_replaced, true, 0,
+					      &unused))
 			return 0;
 	}
 	*visible_replaced = NULL;
@@ -1889,20 +1999,15 @@ memtx_tx_history_prepare_stmt(struct txn_stmt *stmt)
 		stmt->del_story->del_psn = stmt->txn->psn;
 }
 
-ssize_t
+void
 memtx_tx_history_commit_stmt(struct txn_stmt *stmt)
 {
-	ssize_t res = 0;
 	if (stmt->add_story != NULL) {
 		assert(stmt->add_story->add_stmt == stmt);
-		res += tuple_bsize(stmt->add_story->tuple);
 		memtx_tx_story_unlink_added_by(stmt->add_story, stmt);
 	}
-	if (stmt->del_story != NULL) {
-		res -= tuple_bsize(stmt->del_story->tuple);
+	if (stmt->del_story != NULL)
 		memtx_tx_story_unlink_deleted_by(stmt->del_story, stmt);
-	}
-	return res;
 }
 
 struct tuple *
@@ -1915,10 +2020,21 @@ memtx_tx_tuple_clarify_slow(struct txn *txn, struct space *space,
 	struct memtx_story *last_checked_story = story;
 	bool own_change = false;
 	struct tuple *result = NULL;
+	/*
+	 * The session may opt in to see its own prepared changes, so as a
+	 * client can pipeline requests depending on a synchronous transaction
+	 * without waiting for its quorum.
+	 */
+	uint64_t own_session_id = 0;
+	struct session *session = fiber_get_session(fiber());
+	if (!is_prepared_ok && session != NULL &&
+	    session->txn_read_own_prepared)
+		own_session_id = session->id;
 
 	while (true) {
 		if (memtx_tx_story_is_visible(story, txn, &result,
-					      is_prepared_ok, &own_change)) {
+					      is_prepared_ok, own_session_id,
+					      &own_change)) {
 			break;
 		}
 		story = story->link[index->dense_id].older_story;
@@ -1970,7 +2086,8 @@ memtx_tx_index_invisible_count_slow(struct txn *txn,
 			assert(index->dense_id < lookup->index_count);
 			bool unused;
 			if (memtx_tx_story_is_visible(lookup, txn,
-						      &visible, true, &unused))
+						      &visible, true, 0,
+						      &unused))
 				break;
 		}
 		if (visible == NULL)
@@ -1984,6 +2101,8 @@ memtx_tx_delete_gap(struct gap_item *item)
 {
 	rlist_del(&item->in_gap_list);
 	rlist_del(&item->in_nearby_gaps);
+	assert(txm.gap_count > 0);
+	txm.gap_count--;
 	mempool_free(&txm.gap_item_mempoool, item);
 }
 
@@ -1992,6 +2111,8 @@ memtx_tx_full_scan_item_delete(struct full_scan_item *item)
 {
 	rlist_del(&item->in_full_scan_list);
 	rlist_del(&item->in_full_scans);
+	assert(txm.full_scan_count > 0);
+	txm.full_scan_count--;
 	mempool_free(&txm.full_scan_item_mempool, item);
 }
 
@@ -2107,6 +2228,9 @@ memtx_tx_track_read_story(struct txn *txn, struct space *space,
 {
 	if (txn == NULL)
 		return 0;
+	/* Reads from a read view can't conflict with anything. */
+	if (txn->status != TXN_INPROGRESS)
+		return 0;
 	if (space == NULL)
 		return 0;
 	if (space->def->opts.is_ephemeral)
@@ -2121,6 +2245,8 @@ memtx_tx_track_read(struct txn *txn, struct space *space, struct tuple *tuple)
 		return 0;
 	if (txn == NULL)
 		return 0;
+	if (txn->status != TXN_INPROGRESS)
+		return 0;
 	if (space == NULL)
 		return 0;
 	if (space->def->opts.is_ephemeral)
@@ -2304,6 +2430,7 @@ memtx_tx_gap_item_new(struct txn *txn, enum iterator_type type,
 	}
 	memcpy((char *)item->key, key, item->key_len);
 	rlist_add(&txn->gap_list, &item->in_gap_list);
+	txm.gap_count++;
 	return item;
 }
 
@@ -2336,6 +2463,8 @@ memtx_tx_track_gap_slow(struct txn *txn, struct space *space, struct index *inde
 		} else {
 			story = memtx_tx_story_new(space, successor);
 			if (story == NULL) {
+				rlist_del(&item->in_gap_list);
+				txm.gap_count--;
 				mempool_free(&txm.gap_item_mempoool, item);
 				return -1;
 			}
@@ -2363,6 +2492,7 @@ memtx_tx_full_scan_item_new(struct txn *txn)
 
 	item->txn = txn;
 	rlist_add(&txn->full_scan_list, &item->in_full_scan_list);
+	txm.full_scan_count++;
 	return item;
 }
 
@@ -2416,6 +2546,61 @@ memtx_tx_clean_txn(struct txn *txn)
 	}
 }
 
+static int
+memtx_tx_stat_space(struct space *space, void *arg)
+{
+	struct info_handler *h = (struct info_handler *)arg;
+	if (rlist_empty(&space->memtx_stories))
+		return 0;
+	int64_t count = 0;
+	struct memtx_story *story;
+	rlist_foreach_entry(story, &space->memtx_stories, in_space_stories)
+		count++;
+	info_table_begin(h, space_name(space));
+	info_append_int(h, "stories", count);
+	info_table_end(h);
+	return 0;
+}
+
+void
+memtx_tx_stat(struct info_handler *h)
+{
+	int64_t txn_count = 0;
+	int64_t read_view_count = 0;
+	int64_t read_tracker_count = 0;
+	struct txn *txn;
+	rlist_foreach_entry(txn, &txm.all_txs, in_all_txs) {
+		txn_count++;
+		struct tx_read_tracker *tracker;
+		rlist_foreach_entry(tracker, &txn->read_set, in_read_set)
+			read_tracker_count++;
+	}
+	rlist_foreach_entry(txn, &txm.read_view_txs, in_read_view_txs)
+		read_view_count++;
+
+	info_table_begin(h, "tx");
+	info_append_int(h, "txns", txn_count);
+	info_append_int(h, "read_views", read_view_count);
+	info_table_begin(h, "stories");
+	info_append_int(h, "count", txm.story_count);
+	info_append_int(h, "total", txm.story_bytes);
+	info_table_end(h); /* stories */
+	info_table_begin(h, "trackers");
+	info_append_int(h, "read", read_tracker_count);
+	info_append_int(h, "point_holes", txm.point_holes_size);
+	info_append_int(h, "gaps", txm.gap_count);
+	info_append_int(h, "full_scans", txm.full_scan_count);
+	info_table_end(h); /* trackers */
+	info_table_begin(h, "gc");
+	info_append_int(h, "steps", txm.gc_steps);
+	info_append_int(h, "freed", txm.gc_freed);
+	info_table_end(h); /* gc */
+	info_table_begin(h, "spaces");
+	space_foreach(memtx_tx_stat_space, h);
+	info_table_end(h); /* spaces */
+	info_table_end(h); /* tx */
+}
+
 static uint32_t
 memtx_tx_snapshot_cleaner_hash(const struct tuple *a)
 {
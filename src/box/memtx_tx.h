@@ -37,10 +37,14 @@
 
 #include "small/rlist.h"
 
+#include <stdarg.h>
+
 #if defined(__cplusplus)
 extern "C" {
 #endif /* defined(__cplusplus) */
 
+struct info_handler;
+
 /**
  * Global flag that enables mvcc engine.
  * If set, memtx starts to apply statements through txm history mechanism
@@ -170,6 +174,18 @@ struct memtx_tx_snapshot_cleaner {
 void
 memtx_tx_register_tx(struct txn *tx);
 
+/**
+ * Body of the fiber that deletes unused stories in the background.
+ * It makes a pass over all stories in small batches, and sleeps
+ * between the passes, longer if the last pass freed nothing.
+ */
+int
+memtx_tx_gc_f(va_list ap);
+
+/** Append the transaction manager statistics to @a h. */
+void
+memtx_tx_stat(struct info_handler *h);
+
 /**
  * Initialize memtx transaction manager.
  */
@@ -222,6 +238,15 @@ memtx_tx_cause_conflict(struct txn *breaker, struct txn *victim);
 void
 memtx_tx_handle_conflict(struct txn *breaker, struct txn *victim);
 
+/**
+ * Send a transaction that hasn't done anything yet to a read view of
+ * the current state of the database. The transaction sees only the
+ * changes that have already been prepared, and its reads aren't tracked
+ * any more. Does nothing if MVCC is disabled.
+ */
+void
+memtx_tx_open_read_view(struct txn *txn);
+
 /**
  * @brief Add a statement to transaction manager's history.
  * Until unlinking or releasing the space could internally contain
@@ -277,9 +302,8 @@ memtx_tx_history_prepare_stmt(struct txn_stmt *stmt);
  * Make the statement's changes permanent. It becomes visible to all.
  *
  * @param stmt current statement.
- * @return the change in space bsize.
  */
-ssize_t
+void
 memtx_tx_history_commit_stmt(struct txn_stmt *stmt);
 
 /** Helper of memtx_tx_tuple_clarify */
@@ -36,58 +36,56 @@
 #include <stdint.h>
 #include <stdlib.h>
 
-#define HEAP_FORWARD_DECLARATION
-#include "salad/heap.h"
-
+#include "trivia/util.h"      /* SWAP() */
 #include "diag.h"             /* diag_set() */
 #include "box/tuple.h"        /* tuple_ref(), tuple_unref(),
 				 tuple_validate() */
 #include "box/tuple_format.h" /* box_tuple_format_new(),
 				 tuple_format_*() */
 #include "box/key_def.h"      /* key_def_*(),
-				 tuple_compare() */
+				 tuple_compare(), tuple_hint() */
 
 /* {{{ Merger */
 
+enum {
+	/**
+	 * Max number of tuples fetched from a source at once.
+	 */
+	MERGER_BATCH_SIZE = 32,
+};
+
 /**
- * Holds a source to fetch next tuples and a last fetched tuple to
+ * Holds a source to fetch next tuples and a current tuple to
  * compare the node against other nodes.
  *
  * The main reason why this structure is separated from a merge
- * source is that a heap node can not be a member of several
- * heaps.
+ * source is that a source can be used by several mergers.
  *
- * The second reason is that it allows to encapsulate all heap
- * related logic inside this compilation unit, without any traces
- * in externally visible structures.
+ * The second reason is that it allows to encapsulate all
+ * tournament tree related logic inside this compilation unit,
+ * without any traces in externally visible structures.
  */
-struct merger_heap_node {
+struct merger_node {
 	/* A source of tuples. */
 	struct merge_source *source;
 	/*
-	 * A last fetched (refcounted) tuple to compare against
-	 * other nodes.
+	 * A current (refcounted) tuple to compare against other
+	 * nodes. NULL when the source is exhausted.
 	 */
 	struct tuple *tuple;
-	/* An anchor to make the structure a merger heap node. */
-	struct heap_node in_merger;
+	/* A comparison hint of the current tuple. */
+	hint_t hint;
+	/* A position of the next tuple in the batch. */
+	uint32_t batch_pos;
+	/* A number of tuples in the batch. */
+	uint32_t batch_count;
+	/* Tuples (refcounted) fetched from the source ahead. */
+	struct tuple *batch[MERGER_BATCH_SIZE];
 };
 
-static bool
-merge_source_less(const heap_t *heap, const struct merger_heap_node *left,
-		  const struct merger_heap_node *right);
-#define HEAP_NAME merger_heap
-#define HEAP_LESS merge_source_less
-#define heap_value_t struct merger_heap_node
-#define heap_value_attr in_merger
-#include "salad/heap.h"
-#undef HEAP_NAME
-#undef HEAP_LESS
-#undef heap_value_t
-#undef heap_value_attr
-
 /**
- * Holds a heap, parameters of a merge process and utility fields.
+ * Holds a tournament tree, parameters of a merge process and
+ * utility fields.
  */
 struct merger {
 	/* A merger is a source. */
@@ -95,22 +93,30 @@ struct merger {
 	/*
 	 * Whether a merge process started.
 	 *
-	 * The merger postpones charging of heap nodes until a
-	 * first output tuple is acquired.
+	 * The merger postpones charging of nodes until a first
+	 * output tuple is acquired.
 	 */
 	bool started;
 	/* A key_def to compare tuples. */
 	struct key_def *key_def;
 	/* A format to acquire compatible tuples from sources. */
 	struct tuple_format *format;
+	/* An array of nodes. */
+	uint32_t node_count;
+	struct merger_node *nodes;
 	/*
-	 * A heap of sources (of nodes that contains a source to
-	 * be exact).
+	 * A tree of losers: tree[0] is the number of the node
+	 * holding the next output tuple, tree[i] for i > 0 is the
+	 * number of the node, which lost the match in the i-th
+	 * internal node of the tree. Node j is the leaf
+	 * node_count + j, the parent of the i-th tree node is
+	 * i / 2.
+	 *
+	 * Unlike a binary heap, the tree needs one comparison per
+	 * level to replace the top node and compares the new
+	 * tuple only against the losers on its path.
 	 */
-	heap_t heap;
-	/* An array of heap nodes. */
-	uint32_t node_count;
-	struct merger_heap_node *nodes;
+	uint32_t *tree;
 	/* Ascending (false) / descending (true) order. */
 	bool reverse;
 };
@@ -118,75 +124,133 @@ struct merger {
 /* Helpers */
 
 /**
- * Data comparing function to construct a heap of sources.
+ * Whether the tuple of the left node goes before the tuple of
+ * the right node in the merger output. An exhausted node goes
+ * after all others. Equal tuples go in the order of sources to
+ * make the output stable.
  */
 static bool
-merge_source_less(const heap_t *heap, const struct merger_heap_node *left,
-		  const struct merger_heap_node *right)
+merger_node_less(struct merger *merger, const struct merger_node *left,
+		 const struct merger_node *right)
 {
-	assert(left->tuple != NULL);
-	assert(right->tuple != NULL);
-	struct merger *merger = container_of(heap, struct merger, heap);
-	int cmp = tuple_compare(left->tuple, HINT_NONE, right->tuple, HINT_NONE,
-				merger->key_def);
-	return merger->reverse ? cmp >= 0 : cmp < 0;
+	if (right->tuple == NULL)
+		return left->tuple != NULL;
+	if (left->tuple == NULL)
+		return false;
+	int cmp = tuple_compare(left->tuple, left->hint, right->tuple,
+				right->hint, merger->key_def);
+	if (cmp == 0)
+		return left < right;
+	return merger->reverse ? cmp > 0 : cmp < 0;
 }
 
 /**
- * Initialize a new merger heap node.
+ * Initialize a new merger node.
  */
 static void
-merger_heap_node_create(struct merger_heap_node *node,
-			struct merge_source *source)
+merger_node_create(struct merger_node *node, struct merge_source *source)
 {
 	node->source = source;
 	merge_source_ref(node->source);
 	node->tuple = NULL;
-	heap_node_create(&node->in_merger);
+	node->hint = HINT_NONE;
+	node->batch_pos = 0;
+	node->batch_count = 0;
 }
 
 /**
- * Free a merger heap node.
+ * Free a merger node.
  */
 static void
-merger_heap_node_delete(struct merger_heap_node *node)
+merger_node_delete(struct merger_node *node)
 {
 	merge_source_unref(node->source);
 	if (node->tuple != NULL)
 		tuple_unref(node->tuple);
+	for (uint32_t i = node->batch_pos; i < node->batch_count; ++i)
+		tuple_unref(node->batch[i]);
 }
 
 /**
- * The helper to add a new heap node to a merger heap.
+ * Move a node to a next tuple of its source. A new batch of
+ * tuples is fetched from the source when the current one is
+ * exhausted.
  *
- * Return -1 at an error and set a diag.
+ * Return -1 at an error and set a diag, node->tuple is not
+ * changed then.
  *
- * Otherwise store a next tuple in node->tuple, add the node to
- * merger->heap and return 0.
+ * Otherwise store the next tuple (or NULL when the source ends)
+ * in node->tuple and return 0. The old node->tuple is not
+ * unreferenced: it is the caller's responsibility.
  */
 static int
-merger_add_heap_node(struct merger *merger, struct merger_heap_node *node)
+merger_node_next(struct merger *merger, struct merger_node *node)
 {
-	struct tuple *tuple = NULL;
-
-	/* Acquire a next tuple. */
-	struct merge_source *source = node->source;
-	if (merge_source_next(source, merger->format, &tuple) != 0)
-		return -1;
-
-	/* Don't add an empty source to a heap. */
-	if (tuple == NULL)
-		return 0;
-
-	node->tuple = tuple;
+	if (node->batch_pos == node->batch_count) {
+		uint32_t count;
+		if (merge_source_next_batch(node->source, merger->format,
+					    node->batch, MERGER_BATCH_SIZE,
+					    &count) != 0)
+			return -1;
+		node->batch_pos = 0;
+		node->batch_count = count;
+		if (count == 0) {
+			node->tuple = NULL;
+			return 0;
+		}
+	}
+	node->tuple = node->batch[node->batch_pos++];
+	node->hint = tuple_hint(node->tuple, merger->key_def);
+	return 0;
+}
 
-	/* Add a node to a heap. */
-	if (merger_heap_insert(&merger->heap, node) != 0) {
-		diag_set(OutOfMemory, 0, "malloc", "merger->heap");
-		return -1;
+/**
+ * Play matches from the leaf of the given node up to the root
+ * and store the winner in tree[0]. The tree must be complete
+ * except for the path from the node to the root.
+ */
+static void
+merger_replay(struct merger *merger, uint32_t winner)
+{
+	uint32_t *tree = merger->tree;
+	for (uint32_t i = (merger->node_count + winner) / 2; i > 0; i /= 2) {
+		if (merger_node_less(merger, &merger->nodes[tree[i]],
+				     &merger->nodes[winner]))
+			SWAP(tree[i], winner);
 	}
+	tree[0] = winner;
+}
 
-	return 0;
+/**
+ * Build a tree of losers from scratch.
+ *
+ * The nodes are added one by one: a winner that reaches an
+ * empty internal node waits there for the winner of the other
+ * subtree, the second one plays the match and the winner goes
+ * up.
+ */
+static void
+merger_build_tree(struct merger *merger)
+{
+	const uint32_t none = UINT32_MAX;
+	uint32_t *tree = merger->tree;
+	for (uint32_t i = 0; i < merger->node_count; ++i)
+		tree[i] = none;
+	for (uint32_t j = 0; j < merger->node_count; ++j) {
+		uint32_t winner = j;
+		uint32_t i = (merger->node_count + j) / 2;
+		for (; i > 0; i /= 2) {
+			if (tree[i] == none) {
+				tree[i] = winner;
+				break;
+			}
+			if (merger_node_less(merger, &merger->nodes[tree[i]],
+					     &merger->nodes[winner]))
+				SWAP(tree[i], winner);
+		}
+		if (i == 0)
+			tree[0] = winner;
+	}
 }
 
 /* Virtual methods declarations */
@@ -210,20 +274,27 @@ static int
 merger_set_sources(struct merger *merger, struct merge_source **sources,
 		   uint32_t source_count)
 {
-	const size_t nodes_size = sizeof(struct merger_heap_node) *
-		source_count;
-	struct merger_heap_node *nodes = malloc(nodes_size);
+	const size_t nodes_size = sizeof(struct merger_node) * source_count;
+	struct merger_node *nodes = malloc(nodes_size);
 	if (nodes == NULL) {
 		diag_set(OutOfMemory, nodes_size, "malloc",
-			 "merger heap nodes");
+			 "merger nodes");
+		return -1;
+	}
+	const size_t tree_size = sizeof(uint32_t) * source_count;
+	uint32_t *tree = malloc(tree_size);
+	if (tree == NULL) {
+		diag_set(OutOfMemory, tree_size, "malloc", "merger tree");
+		free(nodes);
 		return -1;
 	}
 
 	for (uint32_t i = 0; i < source_count; ++i)
-		merger_heap_node_create(&nodes[i], sources[i]);
+		merger_node_create(&nodes[i], sources[i]);
 
 	merger->node_count = source_count;
 	merger->nodes = nodes;
+	merger->tree = tree;
 	return 0;
 }
 
@@ -266,15 +337,14 @@ merger_new(struct key_def *key_def, struct merge_source **sources,
 	merger->started = false;
 	merger->key_def = key_def;
 	merger->format = format;
-	merger_heap_create(&merger->heap);
 	merger->node_count = 0;
 	merger->nodes = NULL;
+	merger->tree = NULL;
 	merger->reverse = reverse;
 
 	if (merger_set_sources(merger, sources, source_count) != 0) {
 		key_def_delete(merger->key_def);
 		tuple_format_unref(merger->format);
-		merger_heap_destroy(&merger->heap);
 		free(merger);
 		return NULL;
 	}
@@ -291,13 +361,14 @@ merger_delete(struct merge_source *base)
 
 	key_def_delete(merger->key_def);
 	tuple_format_unref(merger->format);
-	merger_heap_destroy(&merger->heap);
 
 	for (uint32_t i = 0; i < merger->node_count; ++i)
-		merger_heap_node_delete(&merger->nodes[i]);
+		merger_node_delete(&merger->nodes[i]);
 
 	if (merger->nodes != NULL)
 		free(merger->nodes);
+	if (merger->tree != NULL)
+		free(merger->tree);
 
 	free(merger);
 }
@@ -309,26 +380,31 @@ merger_next(struct merge_source *base, struct tuple_format *format,
 	struct merger *merger = container_of(base, struct merger, base);
 
 	/*
-	 * Fetch a first tuple for each source and add all heap
-	 * nodes to a merger heap.
+	 * Fetch a first tuple for each source and play all
+	 * matches of the tournament.
 	 */
 	if (!merger->started) {
 		for (uint32_t i = 0; i < merger->node_count; ++i) {
-			struct merger_heap_node *node = &merger->nodes[i];
-			if (merger_add_heap_node(merger, node) != 0)
+			struct merger_node *node = &merger->nodes[i];
+			if (merger_node_next(merger, node) != 0)
 				return -1;
 		}
+		merger_build_tree(merger);
 		merger->started = true;
 	}
 
 	/* Get a next tuple. */
-	struct merger_heap_node *node = merger_heap_top(&merger->heap);
-	if (node == NULL) {
+	if (merger->node_count == 0) {
 		*out = NULL;
 		return 0;
 	}
+	uint32_t winner = merger->tree[0];
+	struct merger_node *node = &merger->nodes[winner];
 	struct tuple *tuple = node->tuple;
-	assert(tuple != NULL);
+	if (tuple == NULL) {
+		*out = NULL;
+		return 0;
+	}
 
 	/* Validate the tuple. */
 	if (format != NULL && tuple_validate(format, tuple) != 0)
@@ -339,15 +415,11 @@ merger_next(struct merge_source *base, struct tuple_format *format,
 	 * *out as refcounted tuple, so we don't unreference it
 	 * here.
 	 */
-	struct merge_source *source = node->source;
-	if (merge_source_next(source, merger->format, &node->tuple) != 0)
+	if (merger_node_next(merger, node) != 0)
 		return -1;
 
-	/* Update a heap. */
-	if (node->tuple == NULL)
-		merger_heap_delete(&merger->heap, node);
-	else
-		merger_heap_update(&merger->heap, node);
+	/* Update the tree. */
+	merger_replay(merger, winner);
 
 	*out = tuple;
 	return 0;
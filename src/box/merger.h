@@ -33,6 +33,7 @@
 
 #include <assert.h>
 #include <stdbool.h>
+#include <stddef.h>
 #include <stdint.h>
 
 #if defined(__cplusplus)
@@ -69,6 +70,23 @@ struct merge_source_vtab {
 	 */
 	int (*next)(struct merge_source *base, struct tuple_format *format,
 		    struct tuple **out);
+	/**
+	 * Get up to @a size next tuples (refcounted) from a
+	 * source at once and store their number in @a count.
+	 * Zero count means that the source is exhausted.
+	 *
+	 * The format has the same meaning as for next().
+	 *
+	 * The method is optional: a source that can't deliver
+	 * tuples cheaper in a batch leaves it NULL and next() is
+	 * called instead.
+	 *
+	 * Return 0 at success. In case of an error set a diag and
+	 * return -1, no tuples are returned then.
+	 */
+	int (*next_batch)(struct merge_source *base,
+			  struct tuple_format *format, struct tuple **out,
+			  uint32_t size, uint32_t *count);
 };
 
 /**
@@ -118,6 +136,24 @@ merge_source_next(struct merge_source *source, struct tuple_format *format,
 	return source->vtab->next(source, format, out);
 }
 
+/**
+ * @see merge_source_vtab
+ */
+static inline int
+merge_source_next_batch(struct merge_source *source,
+			struct tuple_format *format, struct tuple **out,
+			uint32_t size, uint32_t *count)
+{
+	assert(size > 0);
+	if (source->vtab->next_batch != NULL)
+		return source->vtab->next_batch(source, format, out, size,
+						count);
+	if (source->vtab->next(source, format, out) != 0)
+		return -1;
+	*count = out[0] != NULL ? 1 : 0;
+	return 0;
+}
+
 /**
  * Initialize a base merge source structure.
  */
@@ -24,6 +24,8 @@
 
 #include "lua/utils.h"
 #include "libeio/eio.h"
+#include "coio_task.h"
+#include "trivia/util.h"
 
 static struct mh_strnptr_t *module_cache = NULL;
 
@@ -252,6 +254,128 @@ module_func_call(struct module_func *mf, struct port *args,
 	return 0;
 }
 
+/**
+ * MessagePack returned by a function executed in a worker thread.
+ * The region and the port mempool of a worker cord can't be used
+ * in TX, so the results are accumulated in a malloc'ed buffer as
+ * a sequence of [uint32_t size][MessagePack] entries.
+ */
+struct module_func_thread_result {
+	/** Buffer with entries. */
+	char *data;
+	/** Number of used bytes. */
+	size_t size;
+	/** Number of allocated bytes. */
+	size_t capacity;
+};
+
+int
+module_func_thread_result_add(struct module_func_thread_result *res,
+			      const char *mp, const char *mp_end)
+{
+	uint32_t mp_size = mp_end - mp;
+	size_t need = res->size + sizeof(mp_size) + mp_size;
+	if (need > res->capacity) {
+		size_t capacity = MAX(res->capacity * 2, need);
+		capacity = MAX(capacity, (size_t)256);
+		char *data = realloc(res->data, capacity);
+		if (data == NULL) {
+			diag_set(OutOfMemory, capacity, "realloc", "data");
+			return -1;
+		}
+		res->data = data;
+		res->capacity = capacity;
+	}
+	memcpy(res->data + res->size, &mp_size, sizeof(mp_size));
+	memcpy(res->data + res->size + sizeof(mp_size), mp, mp_size);
+	res->size = need;
+	return 0;
+}
+
+/** Move the results of a threaded call to a port in TX. */
+static int
+module_func_thread_result_move(struct module_func_thread_result *res,
+			       struct port *port)
+{
+	const char *pos = res->data;
+	const char *end = res->data + res->size;
+	while (pos < end) {
+		uint32_t mp_size;
+		memcpy(&mp_size, pos, sizeof(mp_size));
+		pos += sizeof(mp_size);
+		if (port_c_add_mp(port, pos, pos + mp_size) != 0)
+			return -1;
+		pos += mp_size;
+	}
+	return 0;
+}
+
+static ssize_t
+module_func_call_thread_f(va_list ap)
+{
+	box_function_t func = va_arg(ap, box_function_t);
+	box_function_ctx_t *ctx = va_arg(ap, box_function_ctx_t *);
+	const char *data = va_arg(ap, const char *);
+	const char *data_end = va_arg(ap, const char *);
+	return func(ctx, data, data_end) == 0 ? 0 : -1;
+}
+
+int
+module_func_call_in_thread(struct module_func *mf, struct port *args,
+			   struct port *ret)
+{
+	struct region *region = &fiber()->gc;
+	size_t region_svp = region_used(region);
+
+	uint32_t data_sz;
+	const char *data = port_get_msgpack(args, &data_sz);
+	if (data == NULL)
+		return -1;
+
+	struct module_func_thread_result res = {
+		.data = NULL,
+		.size = 0,
+		.capacity = 0,
+	};
+	box_function_ctx_t ctx = {
+		.port = NULL,
+		.thread_result = &res,
+	};
+
+	/*
+	 * The module must outlive the call, see module_func_call().
+	 * The arguments are on the fiber region, which is not
+	 * touched while the fiber waits for the worker.
+	 */
+	struct module *m = mf->module;
+	module_ref(m);
+	ssize_t rc = coio_call(module_func_call_thread_f, mf->func, &ctx,
+			       data, data + data_sz);
+	module_unref(m);
+
+	region_truncate(region, region_svp);
+
+	if (rc != 0) {
+		/*
+		 * Errors with statistics can't be created in the
+		 * worker, so the default one is set here.
+		 */
+		if (diag_last_error(&fiber()->diag) == NULL)
+			diag_set(ClientError, ER_PROC_C, "unknown error");
+		free(res.data);
+		return -1;
+	}
+
+	port_c_create(ret);
+	if (module_func_thread_result_move(&res, ret) != 0) {
+		port_destroy(ret);
+		free(res.data);
+		return -1;
+	}
+	free(res.data);
+	return 0;
+}
+
 /** Fill attributes from stat. */
 static void
 module_attr_fill(struct module_attr *attr, struct stat *st)
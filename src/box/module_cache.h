@@ -19,9 +19,15 @@ extern "C" {
  */
 
 struct port;
+struct module_func_thread_result;
 
 struct box_function_ctx {
 	struct port *port;
+	/**
+	 * Results of a function executed in a worker thread,
+	 * NULL in the TX thread. See module_func_call_in_thread().
+	 */
+	struct module_func_thread_result *thread_result;
 };
 
 typedef struct box_function_ctx box_function_ctx_t;
@@ -184,6 +190,32 @@ int
 module_func_call(struct module_func *mf, struct port *args,
 		 struct port *ret);
 
+/**
+ * Execute a function in a coio worker thread. The calling fiber
+ * yields until the function returns. The function may only return
+ * MessagePack (box_return_mp(), box_return_mp_ref()) and must not
+ * use the rest of the box API, which is bound to the TX thread.
+ *
+ * @param mf a function to execute.
+ * @param args function arguments.
+ * @param ret[out] execution results.
+ *
+ * @return 0 on success, -1 otherwise (diag is set).
+ */
+int
+module_func_call_in_thread(struct module_func *mf, struct port *args,
+			   struct port *ret);
+
+/**
+ * Append MessagePack returned by a function executed in a worker
+ * thread to its results.
+ *
+ * @return 0 on success, -1 on memory error (diag is set).
+ */
+int
+module_func_thread_result_add(struct module_func_thread_result *res,
+			      const char *mp, const char *mp_end);
+
 /** Increment reference to a module. */
 void
 module_ref(struct module *m);
@@ -0,0 +1,105 @@
+/*
+ * SPDX-License-Identifier: BSD-2-Clause
+ *
+ * Copyright 2010-2026, Tarantool AUTHORS, please see AUTHORS file.
+ */
+#include "op_latency.h"
+
+#include <stdlib.h>
+
+#include "info/info.h"
+#include "iproto_constants.h"
+
+const char *op_latency_type_strs[] = {
+	"get",
+	"select",
+	"next",
+	"insert",
+	"replace",
+	"update",
+	"upsert",
+	"delete",
+};
+
+static_assert(lengthof(op_latency_type_strs) == op_latency_type_MAX,
+	      "op_latency_type_strs must match enum op_latency_type");
+
+bool op_latency_is_enabled = false;
+
+int
+op_latency_type_by_request(uint16_t request_type)
+{
+	switch (request_type) {
+	case IPROTO_INSERT:
+		return OP_LATENCY_INSERT;
+	case IPROTO_REPLACE:
+		return OP_LATENCY_REPLACE;
+	case IPROTO_UPDATE:
+		return OP_LATENCY_UPDATE;
+	case IPROTO_UPSERT:
+		return OP_LATENCY_UPSERT;
+	case IPROTO_DELETE:
+		return OP_LATENCY_DELETE;
+	default:
+		return -1;
+	}
+}
+
+void
+op_latency_collect(struct op_latency **stat, enum op_latency_type type,
+		   double start)
+{
+	double value = clock_monotonic() - start;
+	if (*stat == NULL) {
+		*stat = calloc(1, sizeof(**stat));
+		if (*stat == NULL)
+			return;
+	}
+	struct latency *latency = &(*stat)->latency[type];
+	if (latency->histogram == NULL && latency_create(latency) != 0)
+		return;
+	latency_collect(latency, value);
+}
+
+void
+op_latency_delete(struct op_latency *stat)
+{
+	if (stat == NULL)
+		return;
+	for (int i = 0; i < op_latency_type_MAX; i++) {
+		if (stat->latency[i].histogram != NULL)
+			latency_destroy(&stat->latency[i]);
+	}
+	free(stat);
+}
+
+void
+op_latency_reset(struct op_latency *stat)
+{
+	if (stat == NULL)
+		return;
+	for (int i = 0; i < op_latency_type_MAX; i++) {
+		if (stat->latency[i].histogram != NULL)
+			latency_reset(&stat->latency[i]);
+	}
+}
+
+void
+op_latency_info(struct op_latency *stat, struct info_handler *h)
+{
+	if (stat == NULL)
+		return;
+	for (int i = 0; i < op_latency_type_MAX; i++) {
+		struct latency *latency = &stat->latency[i];
+		if (latency->histogram == NULL || latency_count(latency) == 0)
+			continue;
+		info_table_begin(h, op_latency_type_strs[i]);
+		info_append_int(h, "count", latency_count(latency));
+		info_append_double(h, "p50", latency_get(latency, 50));
+		info_append_double(h, "p90", latency_get(latency, 90));
+		info_append_double(h, "p99", latency_get(latency, 99));
+		info_append_double(h, "p999",
+				   latency_get_permille(latency, 999));
+		info_table_end(h);
+	}
+}
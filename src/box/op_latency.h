@@ -0,0 +1,94 @@
+/*
+ * SPDX-License-Identifier: BSD-2-Clause
+ *
+ * Copyright 2010-2026, Tarantool AUTHORS, please see AUTHORS file.
+ */
+#pragma once
+
+#include <stdbool.h>
+
+#include "clock.h"
+#include "latency.h"
+#include "trivia/util.h"
+
+#if defined(__cplusplus)
+extern "C" {
+#endif /* defined(__cplusplus) */
+
+struct info_handler;
+
+/**
+ * Operations whose latency is tracked per space or per index
+ * if box.cfg.space_latency_stat is set.
+ */
+enum op_latency_type {
+	/** index:get() and SELECT by a full unique key. */
+	OP_LATENCY_GET,
+	/** Other SELECTs, from start to the last returned tuple. */
+	OP_LATENCY_SELECT,
+	/**
+	 * One step of an iterator returned by index:pairs(), or one
+	 * batch if the iterator prefetches tuples.
+	 */
+	OP_LATENCY_NEXT,
+	OP_LATENCY_INSERT,
+	OP_LATENCY_REPLACE,
+	OP_LATENCY_UPDATE,
+	OP_LATENCY_UPSERT,
+	OP_LATENCY_DELETE,
+	op_latency_type_MAX,
+};
+
+extern const char *op_latency_type_strs[];
+
+/** Set if latency of space and index operations is collected. */
+extern bool op_latency_is_enabled;
+
+/**
+ * Latency of operations of a space or an index. Allocated on the
+ * first observation; a histogram is created on the first
+ * observation of its type, so a space only pays for what it does.
+ */
+struct op_latency {
+	struct latency latency[op_latency_type_MAX];
+};
+
+/** Return the DML operation type for an IPROTO request type or -1. */
+int
+op_latency_type_by_request(uint16_t request_type);
+
+/**
+ * Add an observation of an operation that started at @a start,
+ * as returned by clock_monotonic(). *stat is allocated if it's
+ * NULL. Out of memory errors are ignored: statistics are not
+ * worth failing a request.
+ */
+void
+op_latency_collect(struct op_latency **stat, enum op_latency_type type,
+		   double start);
+
+/** Free statistics allocated by op_latency_collect(). */
+void
+op_latency_delete(struct op_latency *stat);
+
+/** Forget all observations. */
+void
+op_latency_reset(struct op_latency *stat);
+
+/**
+ * Append a table per operation type with observations to an info
+ * handler: count and the 50, 90, 99 and 99.9 percentiles.
+ */
+void
+op_latency_info(struct op_latency *stat, struct info_handler *h);
+
+/** Return the time to pass to op_latency_collect() or 0 if disabled. */
+static inline double
+op_latency_start(void)
+{
+	return unlikely(op_latency_is_enabled) ? clock_monotonic() : 0;
+}
+
+#if defined(__cplusplus)
+} /* extern "C" */
+#endif /* defined(__cplusplus) */
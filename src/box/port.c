@@ -47,6 +47,9 @@ enum {
 	PORT_ENTRY_SIZE = sizeof(struct port_c_entry),
 };
 
+static_assert(sizeof(struct port_c_mp_owner) <= PORT_ENTRY_SIZE,
+	      "port_c_mp_owner must fit into a port entry pool object");
+
 static inline void
 port_c_destroy_entry(struct port_c_entry *pe)
 {
@@ -54,9 +57,12 @@ port_c_destroy_entry(struct port_c_entry *pe)
 	 * See port_c_add_*() for algorithm of how and where to
 	 * store data, to understand why it is freed differently.
 	 */
-	if (pe->mp_size == 0)
+	if (pe->mp_size == 0) {
 		tuple_unref(pe->tuple);
-	else if (pe->mp_size <= PORT_ENTRY_SIZE)
+	} else if (pe->mp_owner != NULL) {
+		pe->mp_owner->free(pe->mp_owner->arg);
+		mempool_free(&port_entry_pool, pe->mp_owner);
+	} else if (pe->mp_size <= PORT_ENTRY_SIZE)
 		mempool_free(&port_entry_pool, pe->mp);
 	else
 		free(pe->mp);
@@ -151,6 +157,7 @@ port_c_add_mp(struct port *base, const char *mp, const char *mp_end)
 		memcpy(dst, mp, size);
 		pe->mp = dst;
 		pe->mp_size = size;
+		pe->mp_owner = NULL;
 		return 0;
 	}
 	if (size <= PORT_ENTRY_SIZE)
@@ -160,6 +167,32 @@ port_c_add_mp(struct port *base, const char *mp, const char *mp_end)
 	return -1;
 }
 
+int
+port_c_add_mp_ref(struct port *base, const char *mp, const char *mp_end,
+		  port_c_mp_free_f free_cb, void *arg)
+{
+	struct port_c *port = (struct port_c *)base;
+	assert(mp_end > mp);
+	assert(free_cb != NULL);
+	struct port_c_mp_owner *owner = mempool_alloc(&port_entry_pool);
+	if (owner == NULL) {
+		diag_set(OutOfMemory, sizeof(*owner), "mempool_alloc",
+			 "owner");
+		return -1;
+	}
+	struct port_c_entry *pe = port_c_new_entry(port);
+	if (pe == NULL) {
+		mempool_free(&port_entry_pool, owner);
+		return -1;
+	}
+	owner->free = free_cb;
+	owner->arg = arg;
+	pe->mp = (char *)mp;
+	pe->mp_size = mp_end - mp;
+	pe->mp_owner = owner;
+	return 0;
+}
+
 static int
 port_c_dump_msgpack_16(struct port *base, struct obuf *out)
 {
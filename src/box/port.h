@@ -106,19 +106,37 @@ void
 port_vdbemem_create(struct port *base, struct sql_value *mem,
 		    uint32_t mem_count);
 
+/** Release MessagePack referenced by a C port entry. */
+typedef void
+(*port_c_mp_free_f)(void *arg);
+
+/** Owner of MessagePack referenced by a C port entry. */
+struct port_c_mp_owner {
+	/** Called when the port is destroyed. */
+	port_c_mp_free_f free;
+	/** Argument of the free function. */
+	void *arg;
+};
+
 struct port_c_entry {
 	struct port_c_entry *next;
 	union {
 		/** Valid if mp_size is 0. */
 		struct tuple *tuple;
 		/**
-		 * Valid if mp_size is > 0. MessagePack is
-		 * allocated either on heap or on the port entry
-		 * mempool, if it fits into a pool object.
+		 * Valid if mp_size is > 0. Unless the entry has an
+		 * owner, MessagePack is allocated either on heap or
+		 * on the port entry mempool, if it fits into a
+		 * pool object.
 		 */
 		char *mp;
 	};
 	uint32_t mp_size;
+	/**
+	 * Valid if mp_size is > 0. Not NULL if MessagePack is
+	 * not copied and belongs to the owner.
+	 */
+	struct port_c_mp_owner *mp_owner;
 };
 
 /**
@@ -148,6 +166,15 @@ port_c_add_tuple(struct port *port, struct tuple *tuple);
 int
 port_c_add_mp(struct port *port, const char *mp, const char *mp_end);
 
+/**
+ * Append raw MessagePack to the port without copying. It must
+ * stay valid until the port is destroyed, then @a free_cb is called
+ * with @a arg. On error @a free_cb is not called.
+ */
+int
+port_c_add_mp_ref(struct port *port, const char *mp, const char *mp_end,
+		  port_c_mp_free_f free_cb, void *arg);
+
 void
 port_init(void);
 
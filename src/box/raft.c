@@ -30,6 +30,7 @@
  */
 #include "box.h"
 #include "error.h"
+#include "histogram.h"
 #include "journal.h"
 #include "raft.h"
 #include "relay.h"
@@ -46,6 +47,22 @@ struct raft box_raft_global = {
 
 enum election_mode box_election_mode = ELECTION_MODE_INVALID;
 
+/**
+ * Upper bounds of buckets of the election latency histogram, in
+ * milliseconds.
+ */
+static const int64_t box_raft_latency_buckets[] = {
+	100, 200, 500, 1000, 2000, 5000, 10000, 30000, INT64_MAX,
+};
+
+struct histogram *box_raft_latency_hist = NULL;
+
+/**
+ * Time when the leader was lost, or 0 if the leader is known or Raft is
+ * disabled. Used to measure how long the cluster stays without a leader.
+ */
+static double box_raft_leader_lost_time = 0;
+
 /**
  * A trigger executed each time the Raft state machine updates any
  * of its visible attributes.
@@ -72,6 +89,7 @@ box_raft_msg_to_request(const struct raft_msg *msg, struct raft_request *req)
 		.vote = msg->vote,
 		.state = msg->state,
 		.vclock = msg->vclock,
+		.is_leader_seen = msg->is_leader_seen,
 	};
 }
 
@@ -83,6 +101,7 @@ box_raft_request_to_msg(const struct raft_request *req, struct raft_msg *msg)
 		.vote = req->vote,
 		.state = req->state,
 		.vclock = req->vclock,
+		.is_leader_seen = req->is_leader_seen,
 	};
 }
 
@@ -157,12 +176,34 @@ box_raft_schedule_async(struct raft *raft)
 	box_raft_has_work = true;
 }
 
+/** Collect the time spent without a leader when a new leader is found. */
+static void
+box_raft_update_latency(const struct raft *raft)
+{
+	if (!raft->is_enabled) {
+		box_raft_leader_lost_time = 0;
+		return;
+	}
+	double now = ev_monotonic_now(loop());
+	if (raft->leader == 0) {
+		if (box_raft_leader_lost_time == 0)
+			box_raft_leader_lost_time = now;
+		return;
+	}
+	if (box_raft_leader_lost_time == 0)
+		return;
+	histogram_collect(box_raft_latency_hist,
+			  (now - box_raft_leader_lost_time) * 1000);
+	box_raft_leader_lost_time = 0;
+}
+
 static int
 box_raft_on_update_f(struct trigger *trigger, void *event)
 {
 	(void)trigger;
 	struct raft *raft = (struct raft *)event;
 	assert(raft == box_raft());
+	box_raft_update_latency(raft);
 	/*
 	 * When the instance becomes a follower, it's good to make it read-only
 	 * ASAP. This way we make sure followers don't write anything.
@@ -442,6 +483,10 @@ box_raft_init(void)
 		.schedule_async = box_raft_schedule_async,
 	};
 	raft_create(&box_raft_global, &box_raft_vtab);
+	box_raft_latency_hist = histogram_new(box_raft_latency_buckets,
+					      lengthof(box_raft_latency_buckets));
+	if (box_raft_latency_hist == NULL)
+		panic("failed to allocate election statistics");
 	trigger_create(&box_raft_on_update, box_raft_on_update_f, NULL, NULL);
 	raft_on_update(box_raft(), &box_raft_on_update);
 }
@@ -456,6 +501,8 @@ box_raft_free(void)
 	 */
 	box_raft_worker = NULL;
 	raft_destroy(raft);
+	histogram_delete(box_raft_latency_hist);
+	box_raft_latency_hist = NULL;
 	/*
 	 * Invalidate so as box_raft() would fail if any usage attempt happens.
 	 */
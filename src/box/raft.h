@@ -50,8 +50,15 @@ enum election_mode {
 	ELECTION_MODE_CANDIDATE = 3,
 };
 
+struct histogram;
 struct raft_request;
 
+/**
+ * Histogram of the time the instance spent without a known leader, from the
+ * leader loss until a new leader is found, in milliseconds.
+ */
+extern struct histogram *box_raft_latency_hist;
+
 /**
  * box_election_mode - current mode of operation for raft. Some modes correspond
  * to RAFT operation modes directly, like CANDIDATE, VOTER and OFF.
@@ -0,0 +1,136 @@
+/*
+ * SPDX-License-Identifier: BSD-2-Clause
+ *
+ * Copyright 2010-2026, Tarantool AUTHORS, please see AUTHORS file.
+ */
+#include "read_view.h"
+
+#include <assert.h>
+#include <stdlib.h>
+
+#include "diag.h"
+#include "index.h"
+#include "schema.h"
+#include "space.h"
+
+struct read_view_entry {
+	/** Space identifier. */
+	uint32_t space_id;
+	/**
+	 * Iterator over the primary index of the space or NULL if
+	 * it was taken by box_read_view_iterator().
+	 */
+	struct snapshot_iterator *iterator;
+};
+
+struct box_read_view {
+	/** Number of entries. */
+	uint32_t entry_count;
+	/** One entry per space. */
+	struct read_view_entry entries[0];
+};
+
+box_read_view_t *
+box_read_view_open(const uint32_t *space_ids, uint32_t space_count)
+{
+	if (space_count == 0) {
+		diag_set(IllegalParams, "a read view needs at least one space");
+		return NULL;
+	}
+	struct box_read_view *rv = calloc(1, sizeof(*rv) +
+					  space_count * sizeof(rv->entries[0]));
+	if (rv == NULL) {
+		diag_set(OutOfMemory, sizeof(*rv) +
+			 space_count * sizeof(rv->entries[0]),
+			 "calloc", "struct box_read_view");
+		return NULL;
+	}
+	rv->entry_count = space_count;
+	/*
+	 * Check all the spaces before creating iterators, so that
+	 * no index is frozen in vain.
+	 */
+	for (uint32_t i = 0; i < space_count; i++) {
+		struct space *space = space_cache_find(space_ids[i]);
+		if (space == NULL)
+			goto fail;
+		if (access_check_space(space, PRIV_R) != 0)
+			goto fail;
+		if (space_index(space, 0) == NULL) {
+			diag_set(ClientError, ER_NO_SUCH_INDEX_ID, 0,
+				 space_name(space));
+			goto fail;
+		}
+		for (uint32_t j = 0; j < i; j++) {
+			if (rv->entries[j].space_id == space_ids[i]) {
+				diag_set(IllegalParams, "space '%s' is given "
+					 "twice", space_name(space));
+				goto fail;
+			}
+		}
+		rv->entries[i].space_id = space_ids[i];
+	}
+	/*
+	 * Nothing yields below, so all the indexes are frozen at
+	 * the same point.
+	 */
+	for (uint32_t i = 0; i < space_count; i++) {
+		struct space *space = space_by_id(space_ids[i]);
+		struct index *pk = space_index(space, 0);
+		rv->entries[i].iterator = index_create_snapshot_iterator(pk);
+		if (rv->entries[i].iterator == NULL)
+			goto fail;
+	}
+	return rv;
+fail:
+	box_read_view_close(rv);
+	return NULL;
+}
+
+void
+box_read_view_close(box_read_view_t *rv)
+{
+	for (uint32_t i = 0; i < rv->entry_count; i++) {
+		struct snapshot_iterator *it = rv->entries[i].iterator;
+		if (it != NULL)
+			it->free(it);
+	}
+	free(rv);
+}
+
+box_read_view_iterator_t *
+box_read_view_iterator(box_read_view_t *rv, uint32_t space_id)
+{
+	for (uint32_t i = 0; i < rv->entry_count; i++) {
+		struct read_view_entry *entry = &rv->entries[i];
+		if (entry->space_id != space_id)
+			continue;
+		if (entry->iterator == NULL) {
+			diag_set(IllegalParams, "space %u is already "
+				 "iterated in the read view", space_id);
+			return NULL;
+		}
+		struct snapshot_iterator *it = entry->iterator;
+		entry->iterator = NULL;
+		return it;
+	}
+	diag_set(IllegalParams, "space %u is not in the read view", space_id);
+	return NULL;
+}
+
+int
+box_read_view_iterator_next(box_read_view_iterator_t *it, const char **data,
+			    const char **data_end)
+{
+	uint32_t size;
+	if (it->next(it, data, &size) != 0)
+		return -1;
+	*data_end = *data != NULL ? *data + size : NULL;
+	return 0;
+}
+
+void
+box_read_view_iterator_free(box_read_view_iterator_t *it)
+{
+	it->free(it);
+}
@@ -0,0 +1,104 @@
+/*
+ * SPDX-License-Identifier: BSD-2-Clause
+ *
+ * Copyright 2010-2026, Tarantool AUTHORS, please see AUTHORS file.
+ */
+#pragma once
+
+#include <stdint.h>
+
+#include "trivia/util.h"
+
+#if defined(__cplusplus)
+extern "C" {
+#endif /* defined(__cplusplus) */
+
+struct snapshot_iterator;
+
+/** \cond public */
+
+/**
+ * A consistent frozen view of the data of several spaces, as
+ * checkpoints and replica join use. Spaces of engines that can't
+ * create such a view aren't supported.
+ */
+typedef struct box_read_view box_read_view_t;
+
+/** An iterator over the primary index of a space in a read view. */
+typedef struct snapshot_iterator box_read_view_iterator_t;
+
+/**
+ * Open a read view of the given spaces. All the spaces are frozen
+ * at the same point, so the view is consistent across them. Later
+ * changes of the spaces aren't seen in it.
+ *
+ * Memtx tuples deleted while a read view or its iterators exist
+ * aren't freed until they are closed, so a long-lived read view
+ * makes memtx use more memory.
+ *
+ * \param space_ids identifiers of the spaces.
+ * \param space_count number of elements in \a space_ids.
+ * \retval NULL on error (check box_error_last())
+ * \retval read view otherwise
+ * \sa box_read_view_close()
+ */
+API_EXPORT box_read_view_t *
+box_read_view_open(const uint32_t *space_ids, uint32_t space_count);
+
+/**
+ * Close a read view. Iterators created with box_read_view_iterator()
+ * stay valid and must be freed with box_read_view_iterator_free().
+ *
+ * \param rv a read view returned by box_read_view_open().
+ */
+API_EXPORT void
+box_read_view_close(box_read_view_t *rv);
+
+/**
+ * Take the iterator over the primary index of a space from a read
+ * view. The space is iterated in the primary key order. An iterator
+ * can be taken only once per space and read view.
+ *
+ * \param rv a read view returned by box_read_view_open().
+ * \param space_id space identifier.
+ * \retval NULL on error (check box_error_last())
+ * \retval iterator otherwise
+ * \sa box_read_view_iterator_free()
+ */
+API_EXPORT box_read_view_iterator_t *
+box_read_view_iterator(box_read_view_t *rv, uint32_t space_id);
+
+/**
+ * Retrieve the next tuple from a read view iterator.
+ *
+ * For a memtx space, unlike other functions of the read view API,
+ * this one may be called from any thread, but only from one thread
+ * at a time for an iterator. For a vinyl space, it must be called
+ * in the tx thread and may yield to read disk.
+ *
+ * The returned data is valid until the next call.
+ *
+ * \param it an iterator returned by box_read_view_iterator().
+ * \param[out] data MsgPack data of the tuple or NULL if there is
+ *             no more data.
+ * \param[out] data_end the end of \a data.
+ * \retval -1 on error (check box_error_last())
+ * \retval 0 on success. The end of data is not an error.
+ */
+API_EXPORT int
+box_read_view_iterator_next(box_read_view_iterator_t *it, const char **data,
+			    const char **data_end);
+
+/**
+ * Free a read view iterator.
+ *
+ * \param it an iterator returned by box_read_view_iterator().
+ */
+API_EXPORT void
+box_read_view_iterator_free(box_read_view_iterator_t *it);
+
+/** \endcond public */
+
+#if defined(__cplusplus)
+} /* extern "C" */
+#endif /* defined(__cplusplus) */
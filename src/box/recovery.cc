@@ -292,6 +292,8 @@ recover_xlog(struct recovery *r, struct xstream *stream,
 				  (unsigned)row.replica_id, (long long)row.lsn);
 			diag_log();
 		}
+		r->last_row_tm = row.tm;
+		r->last_row_time = ev_now(loop());
 	}
 }
 
@@ -56,6 +56,10 @@ struct recovery {
 	struct fiber *watcher;
 	/** List of triggers invoked when the current WAL is closed. */
 	struct rlist on_close_log;
+	/** Time when the last recovered row was written to WAL. */
+	double last_row_tm;
+	/** Local time when the last row was recovered. */
+	double last_row_time;
 };
 
 struct recovery *
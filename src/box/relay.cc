@@ -45,8 +45,10 @@
 #include "gc.h"
 #include "iostream.h"
 #include "iproto_constants.h"
+#include "iproto_compress.h"
 #include "recovery.h"
 #include "replication.h"
+#include "schema_def.h"
 #include "trigger.h"
 #include "vclock/vclock.h"
 #include "version.h"
@@ -56,8 +58,21 @@
 #include "wal.h"
 #include "txn_limbo.h"
 #include "raft.h"
+#include "latency.h"
 
 #include <stdlib.h>
+#include <msgpuck.h>
+#include <small/ibuf.h>
+
+enum {
+	/**
+	 * A compressed stream is flushed when this many rows or
+	 * bytes are collected, or when the relay runs out of rows
+	 * to send.
+	 */
+	RELAY_BATCH_MAX_ROWS = 1024,
+	RELAY_BATCH_MAX_SIZE = 256 * 1024,
+};
 
 /**
  * Cbus message to send status updates from relay to tx thread.
@@ -71,6 +86,8 @@ struct relay_status_msg {
 	struct vclock vclock;
 	/** Last replicated transaction timestamp. */
 	double txn_lag;
+	/** Percentiles of the lag stages. */
+	struct relay_lag_stat lag_stat;
 };
 
 /**
@@ -135,6 +152,15 @@ struct relay {
 	 * is passed by the replica on subscribe.
 	 */
 	uint32_t id_filter;
+	/**
+	 * Sorted ids of the user spaces to send to the replica or
+	 * NULL if all spaces are sent. Rows of the other user spaces
+	 * are skipped by initial join and sent as NOPs otherwise.
+	 * The array is owned by the caller of the relay function.
+	 */
+	const uint32_t *space_filter;
+	/** Number of ids in space_filter. */
+	uint32_t space_filter_size;
 	/**
 	 * How many rows has this relay sent to the replica. Used to yield once
 	 * in a while when reading a WAL to unblock the event loop.
@@ -169,8 +195,43 @@ struct relay {
 	 * received.
 	 */
 	double txn_lag;
+	/**
+	 * Time between the local WAL write of a row and sending
+	 * it to the replica. Includes the time of reading the row
+	 * from an xlog file if the relay isn't caught up.
+	 */
+	struct latency send_lag;
+	/** Same as txn_lag, but for all acknowledged transactions. */
+	struct latency ack_lag;
 	/** Relay sync state. */
 	enum relay_state state;
+	/**
+	 * Set if the relay is caught up and sends rows from the
+	 * in-memory WAL ring rather than reads them from xlog files.
+	 */
+	bool is_ring_mode;
+	/** Position in the WAL ring. */
+	struct wal_ring_cursor ring_cursor;
+	/**
+	 * Signature of the xlog file the rows sent from the WAL
+	 * ring were written to. Used to advance garbage collection
+	 * when the relay moves to the next file.
+	 */
+	int64_t ring_file_signature;
+	/**
+	 * Set if the replica asked to compress the stream. Rows are
+	 * then collected in batch_buf and sent in compressed chunks,
+	 * see relay_flush().
+	 */
+	bool is_compressed;
+	/** Encoded rows that haven't been sent yet. */
+	struct ibuf batch_buf;
+	/** Number of rows in batch_buf. */
+	int batch_row_count;
+	/** Compressed chunk being sent. */
+	struct ibuf send_buf;
+	/** Compression context. */
+	struct iproto_compressor compressor;
 
 	struct {
 		/* Align to prevent false-sharing with tx thread */
@@ -182,6 +243,8 @@ struct relay {
 		 * from TX thread only.
 		 */
 		double txn_lag;
+		/** Lag stage percentiles to be accessed from TX. */
+		struct relay_lag_stat lag_stat;
 		/**
 		 * True if the relay needs Raft updates. It can live fine
 		 * without sending Raft updates, if it is a relay to an
@@ -239,9 +302,17 @@ relay_txn_lag(const struct relay *relay)
 	return relay->tx.txn_lag;
 }
 
+void
+relay_lag_stat(const struct relay *relay, struct relay_lag_stat *stat)
+{
+	*stat = relay->tx.lag_stat;
+}
+
 static void
 relay_send(struct relay *relay, struct xrow_header *packet);
 static void
+relay_flush(struct relay *relay);
+static void
 relay_send_initial_join_row(struct xstream *stream, struct xrow_header *row);
 static void
 relay_send_row(struct xstream *stream, struct xrow_header *row);
@@ -273,6 +344,14 @@ relay_new(struct replica *replica)
 	assert(relay != NULL);
 
 	memset(relay, 0, sizeof(struct relay));
+	if (latency_create(&relay->send_lag) != 0 ||
+	    latency_create(&relay->ack_lag) != 0) {
+		latency_destroy(&relay->send_lag);
+		free(relay);
+		diag_set(OutOfMemory, sizeof(struct latency),
+			 "latency_create", "struct latency");
+		return NULL;
+	}
 	relay->replica = replica;
 	relay->last_row_time = ev_monotonic_now(loop());
 	fiber_cond_create(&relay->reader_cond);
@@ -306,6 +385,10 @@ relay_start(struct relay *relay, struct iostream *io, uint64_t sync,
 	relay->state = RELAY_FOLLOW;
 	relay->row_count = 0;
 	relay->last_row_time = ev_monotonic_now(loop());
+	relay->is_ring_mode = false;
+	relay->is_compressed = false;
+	relay->space_filter = NULL;
+	relay->space_filter_size = 0;
 }
 
 void
@@ -365,6 +448,7 @@ relay_stop(struct relay *relay)
 	 */
 	relay->txn_lag = 0;
 	relay->tx.txn_lag = 0;
+	memset(&relay->tx.lag_stat, 0, sizeof(relay->tx.lag_stat));
 }
 
 void
@@ -374,6 +458,8 @@ relay_delete(struct relay *relay)
 		relay_stop(relay);
 	fiber_cond_destroy(&relay->reader_cond);
 	diag_destroy(&relay->diag);
+	latency_destroy(&relay->send_lag);
+	latency_destroy(&relay->ack_lag);
 	TRASH(relay);
 	free(relay);
 }
@@ -395,13 +481,16 @@ relay_set_cord_name(int fd)
 
 void
 relay_initial_join(struct iostream *io, uint64_t sync, struct vclock *vclock,
-		   uint32_t replica_version_id)
+		   uint32_t replica_version_id, const uint32_t *space_filter,
+		   uint32_t space_filter_size)
 {
 	struct relay *relay = relay_new(NULL);
 	if (relay == NULL)
 		diag_raise();
 
 	relay_start(relay, io, sync, relay_send_initial_join_row);
+	relay->space_filter = space_filter;
+	relay->space_filter_size = space_filter_size;
 	auto relay_guard = make_scoped_guard([=] {
 		relay_stop(relay);
 		relay_delete(relay);
@@ -485,13 +574,16 @@ relay_final_join_f(va_list ap)
 
 void
 relay_final_join(struct iostream *io, uint64_t sync,
-		 struct vclock *start_vclock, struct vclock *stop_vclock)
+		 struct vclock *start_vclock, struct vclock *stop_vclock,
+		 const uint32_t *space_filter, uint32_t space_filter_size)
 {
 	struct relay *relay = relay_new(NULL);
 	if (relay == NULL)
 		diag_raise();
 
 	relay_start(relay, io, sync, relay_send_row);
+	relay->space_filter = space_filter;
+	relay->space_filter_size = space_filter_size;
 	auto relay_guard = make_scoped_guard([=] {
 		relay_stop(relay);
 		relay_delete(relay);
@@ -541,6 +633,7 @@ tx_status_update(struct cmsg *msg)
 	struct relay_status_msg *status = (struct relay_status_msg *)msg;
 	vclock_copy(&status->relay->tx.vclock, &status->vclock);
 	status->relay->tx.txn_lag = status->txn_lag;
+	status->relay->tx.lag_stat = status->lag_stat;
 
 	struct replication_ack ack;
 	ack.source = status->relay->replica->id;
@@ -642,6 +735,77 @@ relay_set_error(struct relay *relay, struct error *e)
 		diag_set_error(&relay->diag, e);
 }
 
+/**
+ * Recreate the recovery context at the current relay position.
+ * The xlog file read by the old context is closed without
+ * running on_close_log triggers.
+ */
+static void
+relay_reset_recovery(struct relay *relay)
+{
+	struct recovery *r = recovery_new(wal_dir(), false, &relay->r->vclock);
+	rlist_swap(&relay->r->on_close_log, &r->on_close_log);
+	recovery_delete(relay->r);
+	relay->r = r;
+}
+
+/** Send the rows of a WAL ring block the replica doesn't have yet. */
+static void
+relay_send_ring_block(struct relay *relay, struct wal_ring_block *block)
+{
+	struct recovery *r = relay->r;
+	struct xstream *stream = &relay->stream;
+	if (block->file_signature != relay->ring_file_signature) {
+		/* Done with the previous file, see recovery_close_log(). */
+		trigger_run_xc(&r->on_close_log, NULL);
+		relay->ring_file_signature = block->file_signature;
+	}
+	for (int i = 0; i < block->row_count; i++) {
+		/* The row is copied, because sending may modify it. */
+		struct xrow_header row = block->rows[i];
+		if (row.lsn <= vclock_get(&r->vclock, row.replica_id))
+			continue;
+		vclock_follow_xrow(&r->vclock, &row);
+		xstream_write_xc(stream, &row);
+		if (++stream->row_count % WAL_ROWS_PER_YIELD == 0)
+			xstream_yield(stream);
+	}
+}
+
+/**
+ * Send new rows from the in-memory WAL ring. Returns false if
+ * the relay is behind the ring and has to read the rows from
+ * xlog files.
+ */
+static bool
+relay_send_from_ring(struct relay *relay)
+{
+	if (!relay->is_ring_mode) {
+		if (wal_ring_cursor_create(&relay->ring_cursor,
+					   &relay->r->vclock) != 0)
+			return false;
+		struct xlog_cursor *cursor = &relay->r->cursor;
+		relay->ring_file_signature = xlog_cursor_is_open(cursor) ?
+			vclock_sum(&cursor->meta.vclock) : -1;
+		/* Don't keep the xlog file open while it isn't read. */
+		relay_reset_recovery(relay);
+		relay->is_ring_mode = true;
+	}
+	struct wal_ring_block *block;
+	while (wal_ring_cursor_next(&relay->ring_cursor, &block) == 0) {
+		if (block == NULL)
+			return true;
+		auto guard = make_scoped_guard([=] {
+			wal_ring_block_unref(block);
+		});
+		relay_send_ring_block(relay, block);
+	}
+	/* The rows were evicted from the ring before we sent them. */
+	relay->is_ring_mode = false;
+	relay_reset_recovery(relay);
+	return false;
+}
+
 static void
 relay_process_wal_event(struct wal_watcher *watcher, unsigned events)
 {
@@ -659,8 +823,19 @@ relay_process_wal_event(struct wal_watcher *watcher, unsigned events)
 		return;
 	}
 	try {
-		recover_remaining_wals(relay->r, &relay->stream, NULL,
-				       (events & WAL_EVENT_ROTATE) != 0);
+		bool was_ring_mode = relay->is_ring_mode;
+		if (!relay_send_from_ring(relay)) {
+			/*
+			 * The recovery context is recreated when leaving
+			 * the ring mode so the WAL directory must be
+			 * rescanned.
+			 */
+			bool scan_dir = was_ring_mode ||
+					(events & WAL_EVENT_ROTATE) != 0;
+			recover_remaining_wals(relay->r, &relay->stream, NULL,
+					       scan_dir);
+		}
+		relay_flush(relay);
 	} catch (Exception *e) {
 		relay_set_error(relay, e);
 		fiber_cancel(fiber());
@@ -694,8 +869,11 @@ relay_reader_f(va_list ap)
 			 * can compute time spent regardless of the clock
 			 * value on remote replica.
 			 */
-			if (xrow.tm != 0)
+			if (xrow.tm != 0) {
 				relay->txn_lag = ev_now(loop()) - xrow.tm;
+				latency_collect(&relay->ack_lag,
+						relay->txn_lag);
+			}
 			fiber_cond_signal(&relay->reader_cond);
 		}
 	} catch (Exception *e) {
@@ -716,6 +894,7 @@ relay_send_heartbeat(struct relay *relay)
 	xrow_encode_timestamp(&row, instance_id, ev_now(loop()));
 	try {
 		relay_send(relay, &row);
+		relay_flush(relay);
 	} catch (Exception *e) {
 		relay_set_error(relay, e);
 		fiber_cancel(fiber());
@@ -820,6 +999,13 @@ relay_subscribe_f(va_list ap)
 	coio_enable();
 	relay_set_cord_name(relay->io->fd);
 
+	ibuf_create(&relay->batch_buf, &cord()->slabc, RELAY_BATCH_MAX_SIZE);
+	ibuf_create(&relay->send_buf, &cord()->slabc, RELAY_BATCH_MAX_SIZE);
+	relay->batch_row_count = 0;
+	iproto_compressor_create(&relay->compressor);
+	latency_reset(&relay->send_lag);
+	latency_reset(&relay->ack_lag);
+
 	/* Create cpipe to tx for propagating vclock. */
 	cbus_endpoint_create(&relay->endpoint, tt_sprintf("relay_%p", relay),
 			     fiber_schedule_cb, fiber());
@@ -906,6 +1092,11 @@ relay_subscribe_f(va_list ap)
 		cmsg_init(&relay->status_msg.msg, route);
 		vclock_copy(&relay->status_msg.vclock, send_vclock);
 		relay->status_msg.txn_lag = relay->txn_lag;
+		struct relay_lag_stat *lag_stat = &relay->status_msg.lag_stat;
+		lag_stat->send_p50 = latency_get(&relay->send_lag, 50);
+		lag_stat->send_p99 = latency_get(&relay->send_lag, 99);
+		lag_stat->ack_p50 = latency_get(&relay->ack_lag, 50);
+		lag_stat->ack_p99 = latency_get(&relay->ack_lag, 99);
 		relay->status_msg.relay = relay;
 		cpipe_push(&relay->tx_pipe, &relay->status_msg.msg);
 	}
@@ -930,6 +1121,10 @@ relay_subscribe_f(va_list ap)
 		    NULL, NULL, cbus_process);
 	cbus_endpoint_destroy(&relay->endpoint, cbus_process);
 
+	ibuf_destroy(&relay->batch_buf);
+	ibuf_destroy(&relay->send_buf);
+	iproto_compressor_destroy(&relay->compressor);
+
 	relay_exit(relay);
 
 	/*
@@ -948,7 +1143,8 @@ relay_subscribe_f(va_list ap)
 void
 relay_subscribe(struct replica *replica, struct iostream *io, uint64_t sync,
 		struct vclock *replica_clock, uint32_t replica_version_id,
-		uint32_t replica_id_filter)
+		uint32_t replica_id_filter, bool compression,
+		const uint32_t *space_filter, uint32_t space_filter_size)
 {
 	assert(replica->anon || replica->id != REPLICA_ID_NIL);
 	struct relay *relay = replica->relay;
@@ -984,6 +1180,9 @@ relay_subscribe(struct replica *replica, struct iostream *io, uint64_t sync,
 	relay->version_id = replica_version_id;
 
 	relay->id_filter = replica_id_filter;
+	relay->is_compressed = compression;
+	relay->space_filter = space_filter;
+	relay->space_filter_size = space_filter_size;
 
 	int rc = cord_costart(&relay->cord, "subscribe",
 			      relay_subscribe_f, relay);
@@ -993,6 +1192,48 @@ relay_subscribe(struct replica *replica, struct iostream *io, uint64_t sync,
 		diag_raise();
 }
 
+/** Send the rows collected for a compressed stream. */
+static void
+relay_flush(struct relay *relay)
+{
+	if (!relay->is_compressed || ibuf_used(&relay->batch_buf) == 0)
+		return;
+	struct iovec iov;
+	iov.iov_base = relay->batch_buf.rpos;
+	iov.iov_len = ibuf_used(&relay->batch_buf);
+	if (iproto_compress(&relay->compressor, &iov, 1, iov.iov_len,
+			    &relay->send_buf) != 0)
+		diag_raise();
+	ibuf_reset(&relay->batch_buf);
+	relay->batch_row_count = 0;
+	ssize_t rc = coio_write_timeout(relay->io, relay->send_buf.rpos,
+					ibuf_used(&relay->send_buf),
+					TIMEOUT_INFINITY);
+	ibuf_reset(&relay->send_buf);
+	if (rc < 0)
+		diag_raise();
+}
+
+/** Add a row to the batch to be sent in a compressed stream. */
+static void
+relay_batch_row(struct relay *relay, struct xrow_header *packet)
+{
+	struct iovec iov[XROW_IOVMAX];
+	int iovcnt = xrow_to_iovec_xc(packet, iov);
+	for (int i = 0; i < iovcnt; i++) {
+		char *data = (char *)ibuf_alloc(&relay->batch_buf,
+						iov[i].iov_len);
+		if (data == NULL) {
+			tnt_raise(OutOfMemory, iov[i].iov_len, "ibuf_alloc",
+				  "relay batch");
+		}
+		memcpy(data, iov[i].iov_base, iov[i].iov_len);
+	}
+	if (++relay->batch_row_count >= RELAY_BATCH_MAX_ROWS ||
+	    ibuf_used(&relay->batch_buf) >= RELAY_BATCH_MAX_SIZE)
+		relay_flush(relay);
+}
+
 static void
 relay_send(struct relay *relay, struct xrow_header *packet)
 {
@@ -1000,7 +1241,10 @@ relay_send(struct relay *relay, struct xrow_header *packet)
 
 	packet->sync = relay->sync;
 	relay->last_row_time = ev_monotonic_now(loop());
-	coio_write_xrow(relay->io, packet);
+	if (relay->is_compressed)
+		relay_batch_row(relay, packet);
+	else
+		coio_write_xrow(relay->io, packet);
 	fiber_gc();
 
 	struct errinj *inj = errinj(ERRINJ_RELAY_TIMEOUT, ERRINJ_DOUBLE);
@@ -1008,15 +1252,61 @@ relay_send(struct relay *relay, struct xrow_header *packet)
 		fiber_sleep(inj->dparam);
 }
 
+/**
+ * Check if a row changes a user space the replica didn't ask
+ * for. System spaces are always sent.
+ */
+static bool
+relay_row_is_filtered(struct relay *relay, const struct xrow_header *row)
+{
+	if (relay->space_filter == NULL || !iproto_type_is_dml(row->type) ||
+	    row->bodycnt == 0)
+		return false;
+	const char *d = (const char *)row->body[0].iov_base;
+	if (mp_typeof(*d) != MP_MAP)
+		return false;
+	uint32_t space_id = 0;
+	uint32_t map_size = mp_decode_map(&d);
+	for (uint32_t i = 0; i < map_size; i++) {
+		if (mp_typeof(*d) != MP_UINT) {
+			mp_next(&d); /* key */
+			mp_next(&d); /* value */
+			continue;
+		}
+		if (mp_decode_uint(&d) != IPROTO_SPACE_ID) {
+			mp_next(&d); /* value */
+			continue;
+		}
+		if (mp_typeof(*d) != MP_UINT)
+			return false;
+		space_id = mp_decode_uint(&d);
+		break;
+	}
+	if (space_id <= BOX_SYSTEM_ID_MAX)
+		return false;
+	uint32_t begin = 0, end = relay->space_filter_size;
+	while (begin < end) {
+		uint32_t mid = begin + (end - begin) / 2;
+		if (relay->space_filter[mid] == space_id)
+			return false;
+		if (relay->space_filter[mid] < space_id)
+			begin = mid + 1;
+		else
+			end = mid;
+	}
+	return true;
+}
+
 static void
 relay_send_initial_join_row(struct xstream *stream, struct xrow_header *row)
 {
 	struct relay *relay = container_of(stream, struct relay, stream);
 	/*
 	 * Ignore replica local requests as we don't need to promote
-	 * vclock while sending a snapshot.
+	 * vclock while sending a snapshot. Neither do we need to
+	 * send the spaces the replica didn't ask for.
 	 */
-	if (row->group_id != GROUP_LOCAL)
+	if (row->group_id != GROUP_LOCAL && !relay_row_is_filtered(relay, row))
 		relay_send(relay, row);
 }
 
@@ -1054,6 +1344,7 @@ relay_restart_recovery(struct relay *relay)
 	rlist_swap(&relay->r->on_close_log, &r->on_close_log);
 	recovery_delete(relay->r);
 	relay->r = r;
+	relay->is_ring_mode = false;
 	recover_remaining_wals(relay->r, &relay->stream, NULL, true);
 }
 
@@ -1076,6 +1367,7 @@ relay_raft_msg_push(struct cmsg *base)
 		relay_send(msg->relay, &row);
 		if (msg->req.state == RAFT_STATE_LEADER)
 			relay_restart_recovery(msg->relay);
+		relay_flush(msg->relay);
 	} catch (Exception *e) {
 		relay_set_error(msg->relay, e);
 		fiber_cancel(fiber());
@@ -1135,6 +1427,13 @@ relay_send_row(struct xstream *stream, struct xrow_header *packet)
 		packet->type = IPROTO_NOP;
 		packet->group_id = GROUP_DEFAULT;
 		packet->bodycnt = 0;
+	} else if (relay_row_is_filtered(relay, packet)) {
+		/*
+		 * The replica didn't ask for the space, but it
+		 * still needs the row to promote its vclock.
+		 */
+		packet->type = IPROTO_NOP;
+		packet->bodycnt = 0;
 	}
 	assert(iproto_type_is_dml(packet->type) ||
 	       iproto_type_is_synchro_request(packet->type));
@@ -1165,6 +1464,10 @@ relay_send_row(struct xstream *stream, struct xrow_header *packet)
 			say_warn("injected broken lsn: %lld",
 				 (long long) packet->lsn);
 		}
+		if (packet->tm != 0) {
+			latency_collect(&relay->send_lag,
+					ev_now(loop()) - packet->tm);
+		}
 		relay_send(relay, packet);
 	}
 }
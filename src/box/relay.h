@@ -100,6 +100,28 @@ relay_last_row_time(const struct relay *relay);
 double
 relay_txn_lag(const struct relay *relay);
 
+/**
+ * Percentiles of the downstream lag stages, in seconds. Both are
+ * measured from the moment a row was written to the local WAL,
+ * so the difference between them is the time the row spent on
+ * the way to the replica and in the replica's WAL.
+ */
+struct relay_lag_stat {
+	/** Time until the row is sent to the replica. */
+	double send_p50;
+	double send_p99;
+	/** Time until the replica acknowledges the row. */
+	double ack_p50;
+	double ack_p99;
+};
+
+/**
+ * Get percentiles of the downstream lag stages observed since
+ * the replica subscribed.
+ */
+void
+relay_lag_stat(const struct relay *relay, struct relay_lag_stat *stat);
+
 /**
  * Send a Raft update request to the relay channel. It is not
  * guaranteed that it will be delivered. The connection may break.
@@ -118,20 +140,28 @@ relay_push_raft(struct relay *relay, const struct raft_request *req);
  * @param sync      sync from incoming JOIN request
  * @param vclock[out] vclock of the read view sent to the replica
  * @param replica_version_id peer's version
+ * @param space_filter sorted ids of the user spaces to send or
+ *                     NULL to send all of them
+ * @param space_filter_size number of ids in @a space_filter
  */
 void
 relay_initial_join(struct iostream *io, uint64_t sync, struct vclock *vclock,
-		   uint32_t replica_version_id);
+		   uint32_t replica_version_id, const uint32_t *space_filter,
+		   uint32_t space_filter_size);
 
 /**
  * Send final JOIN rows to the replica.
  *
  * @param io        client connection
  * @param sync      sync from incoming JOIN request
+ * @param space_filter sorted ids of the user spaces to send or
+ *                     NULL to send all of them
+ * @param space_filter_size number of ids in @a space_filter
  */
 void
 relay_final_join(struct iostream *io, uint64_t sync,
-		 struct vclock *start_vclock, struct vclock *stop_vclock);
+		 struct vclock *start_vclock, struct vclock *stop_vclock,
+		 const uint32_t *space_filter, uint32_t space_filter_size);
 
 /**
  * Subscribe a replica to updates.
@@ -141,6 +171,7 @@ relay_final_join(struct iostream *io, uint64_t sync,
 void
 relay_subscribe(struct replica *replica, struct iostream *io, uint64_t sync,
 		struct vclock *replica_vclock, uint32_t replica_version_id,
-		uint32_t replica_id_filter);
+		uint32_t replica_id_filter, bool compression,
+		const uint32_t *space_filter, uint32_t space_filter_size);
 
 #endif /* TARANTOOL_REPLICATION_RELAY_H_INCLUDED */
@@ -54,7 +54,12 @@ double replication_sync_lag = 10.0; /* seconds */
 int replication_synchro_quorum = 1;
 double replication_synchro_timeout = 5.0; /* seconds */
 double replication_sync_timeout = 300.0; /* seconds */
+double replication_ack_interval = 0.0; /* seconds */
 bool replication_skip_conflict = false;
+int replication_apply_fibers = 1;
+bool replication_compression = false;
+uint32_t *replication_space_filter = NULL;
+uint32_t replication_space_filter_size = 0;
 bool replication_anon = false;
 
 struct replicaset replicaset;
@@ -90,6 +95,7 @@ replication_init(void)
 	replica_hash_new(&replicaset.hash);
 	rlist_create(&replicaset.anon);
 	vclock_create(&replicaset.vclock);
+	fiber_cond_create(&replicaset.vclock_cond);
 	fiber_cond_create(&replicaset.applier.cond);
 	latch_create(&replicaset.applier.order_latch);
 
@@ -116,6 +122,7 @@ replication_free(void)
 
 	diag_destroy(&replicaset.applier.diag);
 	trigger_destroy(&replicaset.on_ack);
+	free(replication_space_filter);
 }
 
 int
@@ -452,6 +459,8 @@ replica_on_applier_disconnect(struct replica *replica)
 	replica->applier_sync_state = replica->applier->state;
 	if (replica->applier_sync_state == APPLIER_LOADING)
 		replicaset.applier.loading++;
+	/* The replica can't tell anymore whether it sees the leader. */
+	raft_process_disconnect(box_raft(), replica->id);
 }
 
 static int
@@ -98,6 +98,9 @@ struct gc_consumer;
 
 static const int REPLICATION_CONNECT_QUORUM_ALL = INT_MAX;
 
+/** Max value of replication_apply_fibers. */
+static const int REPLICATION_APPLY_FIBERS_MAX = 64;
+
 /**
  * Network timeout. Determines how often master and slave exchange
  * heartbeat messages. Set by box.cfg.replication_timeout.
@@ -143,12 +146,42 @@ extern double replication_synchro_timeout;
  */
 extern double replication_sync_timeout;
 
+/**
+ * Max time in seconds an applier may delay an ACK so as to send
+ * it together with ACKs for the following WAL writes. Zero means
+ * sending an ACK after every WAL write.
+ */
+extern double replication_ack_interval;
+
 /*
  * Allows automatic skip of conflicting rows in replication (e.g. applying
  * the row throws ER_TUPLE_FOUND) based on box.cfg configuration option.
  */
 extern bool replication_skip_conflict;
 
+/**
+ * Number of fibers applying transactions received by appliers.
+ * If greater than 1, transactions changing different spaces are
+ * applied concurrently.
+ */
+extern int replication_apply_fibers;
+
+/**
+ * If set, appliers ask masters to compress the replication
+ * stream on subscribe.
+ */
+extern bool replication_compression;
+
+/**
+ * Ids of the user spaces that appliers ask masters to
+ * send, or NULL if all spaces are replicated. System spaces are
+ * replicated anyway.
+ */
+extern uint32_t *replication_space_filter;
+
+/** Number of ids in replication_space_filter. */
+extern uint32_t replication_space_filter_size;
+
 /**
  * Whether this replica will be anonymous or not, e.g. be preset
  * in _cluster table and have a non-zero id.
@@ -218,6 +251,11 @@ struct replicaset {
 	 * of the cluster as maintained by appliers.
 	 */
 	struct vclock vclock;
+	/**
+	 * Signaled whenever the vclock is promoted, i.e. after
+	 * each WAL write and each row applied on final join.
+	 */
+	struct fiber_cond vclock_cond;
 	/**
 	 * This flag is set while the instance is bootstrapping
 	 * from a remote master.
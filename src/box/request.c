@@ -65,6 +65,7 @@ request_update_header(struct request *request, struct xrow_header *row)
 	if (row->bodycnt < 0)
 		return -1;
 	request->header = row;
+	request->has_extra_keys = false;
 	return 0;
 }
 
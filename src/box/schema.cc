@@ -57,6 +57,16 @@
 
 /** All existing spaces. */
 static struct mh_i32ptr_t *spaces;
+/**
+ * Spaces with ids less than SPACE_ARRAY_ID_MAX, indexed by id, so
+ * that the lookup of a space by id on the request path is a single
+ * load instead of a hash probe. The array grows on demand up to the
+ * biggest id of an existing space. Spaces with greater ids are only
+ * in the @spaces hash, which contains all spaces anyway.
+ */
+static struct space **space_array;
+/** Number of slots allocated in @space_array. */
+static uint32_t space_array_size;
 static struct mh_strnptr_t *spaces_by_name;
 static struct mh_i32ptr_t *funcs;
 static struct mh_strnptr_t *funcs_by_name;
@@ -92,6 +102,8 @@ space_is_system(struct space *space)
 struct space *
 space_by_id(uint32_t id)
 {
+	if (id < SPACE_ARRAY_ID_MAX)
+		return id < space_array_size ? space_array[id] : NULL;
 	mh_int_t space = mh_i32ptr_find(spaces, id, NULL);
 	if (space == mh_end(spaces))
 		return NULL;
@@ -172,6 +184,27 @@ space_foreach(int (*func)(struct space *sp, void *udata), void *udata)
 	return 0;
 }
 
+/** Set the slot of a space in @space_array, growing it if needed. */
+static void
+space_array_set(uint32_t id, struct space *space)
+{
+	if (id >= SPACE_ARRAY_ID_MAX)
+		return;
+	if (id >= space_array_size) {
+		assert(space != NULL);
+		uint32_t size = MAX(space_array_size, 512U);
+		while (size <= id)
+			size *= 2;
+		size = MIN(size, (uint32_t)SPACE_ARRAY_ID_MAX);
+		space_array = (struct space **)
+			xrealloc(space_array, size * sizeof(*space_array));
+		memset(space_array + space_array_size, 0,
+		       (size - space_array_size) * sizeof(*space_array));
+		space_array_size = size;
+	}
+	space_array[id] = space;
+}
+
 void
 space_cache_replace(struct space *old_space, struct space *new_space)
 {
@@ -206,6 +239,7 @@ space_cache_replace(struct space *old_space, struct space *new_space)
 				(struct space *)p_old->val : NULL;
 		assert(old_space_by_id == old_space);
 		(void)old_space_by_id;
+		space_array_set(space_id(new_space), new_space);
 		/*
 		 * Insert @new_space into @spaces_by_name cache.
 		 */
@@ -231,6 +265,7 @@ space_cache_replace(struct space *old_space, struct space *new_space)
 		assert(old_space_by_id == old_space);
 		(void)old_space_by_id;
 		mh_i32ptr_del(spaces, k, NULL);
+		space_array_set(space_id(old_space), NULL);
 		/*
 		 * Delete @old_space from @spaces_by_name cache.
 		 */
@@ -531,6 +566,9 @@ schema_free(void)
 	}
 	mh_i32ptr_delete(spaces);
 	mh_strnptr_delete(spaces_by_name);
+	free(space_array);
+	space_array = NULL;
+	space_array_size = 0;
 	while (mh_size(funcs) > 0) {
 		mh_int_t i = mh_first(funcs);
 
@@ -49,6 +49,14 @@ extern uint32_t dd_version_id;
 /** Triggers invoked after schema initialization. */
 extern struct rlist on_schema_init;
 
+enum {
+	/**
+	 * Spaces with ids less than this are looked up by id in
+	 * an array rather than in a hash.
+	 */
+	SPACE_ARRAY_ID_MAX = 1 << 16,
+};
+
 /**
  * Try to look up a space by space number in the space cache.
  * FFI-friendly no-exception-thrown space lookup function.
@@ -151,6 +151,7 @@ sequence_delete(struct sequence *seq)
 void
 sequence_reset(struct sequence *seq)
 {
+	sequence_release_reserved(seq);
 	uint32_t key = seq->def->id;
 	uint32_t hash = sequence_hash(key);
 	uint32_t pos = light_sequence_find_key(&sequence_data_index, hash, key);
@@ -161,6 +162,7 @@ sequence_reset(struct sequence *seq)
 int
 sequence_set(struct sequence *seq, int64_t value)
 {
+	sequence_release_reserved(seq);
 	uint32_t key = seq->def->id;
 	uint32_t hash = sequence_hash(key);
 	struct sequence_data new_data, old_data;
@@ -178,6 +180,11 @@ sequence_set(struct sequence *seq, int64_t value)
 int
 sequence_update(struct sequence *seq, int64_t value)
 {
+	/* Don't return reserved values that are already used. */
+	if (seq->reserved_count > 0 &&
+	    ((seq->def->step > 0 && value >= seq->reserved_next) ||
+	     (seq->def->step < 0 && value <= seq->reserved_next)))
+		sequence_release_reserved(seq);
 	uint32_t key = seq->def->id;
 	uint32_t hash = sequence_hash(key);
 	uint32_t pos = light_sequence_find_key(&sequence_data_index, hash, key);
@@ -260,6 +267,57 @@ overflow:
 	goto done;
 }
 
+int64_t
+sequence_reserve_bound(struct sequence *seq, int64_t value)
+{
+	struct sequence_def *def = seq->def;
+	if (def->cache <= 1)
+		return value;
+	/* Count values left up to the limit, avoiding an overflow. */
+	uint64_t left;
+	if (def->step > 0)
+		left = ((uint64_t)def->max - (uint64_t)value) /
+		       (uint64_t)def->step;
+	else
+		left = ((uint64_t)value - (uint64_t)def->min) /
+		       (0 - (uint64_t)def->step);
+	uint64_t count = MIN(left, (uint64_t)def->cache - 1);
+	return (int64_t)((uint64_t)value + count * (uint64_t)def->step);
+}
+
+void
+sequence_set_reserved(struct sequence *seq, int64_t value, int64_t last)
+{
+	sequence_release_reserved(seq);
+	if (value == last)
+		return;
+	int64_t current;
+	if (sequence_get_value(seq, &current) != 0) {
+		/* The sequence was reset. */
+		diag_clear(diag_get());
+		return;
+	}
+	if (current != last)
+		return;
+	int64_t step = seq->def->step;
+	uint64_t distance = step > 0 ? (uint64_t)last - (uint64_t)value :
+				       (uint64_t)value - (uint64_t)last;
+	uint64_t abs_step = step > 0 ? (uint64_t)step : 0 - (uint64_t)step;
+	seq->reserved_next = value + step;
+	seq->reserved_count = distance / abs_step;
+}
+
+bool
+sequence_next_reserved(struct sequence *seq, int64_t *result)
+{
+	if (seq->reserved_count == 0)
+		return false;
+	*result = seq->reserved_next;
+	if (--seq->reserved_count > 0)
+		seq->reserved_next += seq->def->step;
+	return true;
+}
+
 int
 access_check_sequence(struct sequence *seq)
 {
@@ -377,6 +435,11 @@ sequence_get_value(struct sequence *seq, int64_t *result)
 		diag_set(ClientError, ER_SEQUENCE_NOT_STARTED, seq->def->name);
 		return -1;
 	}
+	if (seq->reserved_count > 0) {
+		/* The last value returned by the sequence. */
+		*result = seq->reserved_next - seq->def->step;
+		return 0;
+	}
 	struct sequence_data data = light_sequence_get(&sequence_data_index,
 						       pos);
 	*result = data.value;
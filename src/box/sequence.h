@@ -64,7 +64,10 @@ struct sequence_def {
 	int64_t max;
 	/** Initial sequence value. */
 	int64_t start;
-	/** Number of values to preallocate. Not implemented yet. */
+	/**
+	 * Number of values to reserve with one update of
+	 * _sequence_data, see box_sequence_next().
+	 */
 	int64_t cache;
 	/**
 	 * If this flag is set, the sequence will wrap
@@ -82,6 +85,15 @@ struct sequence {
 	struct sequence_def *def;
 	/** Set if the sequence is automatically generated. */
 	bool is_generated;
+	/**
+	 * Values reserved by the sequence cache, which may be
+	 * returned without updating _sequence_data: @reserved_count
+	 * values, starting from @reserved_next and going by the
+	 * sequence step. The sequence value stored in the sequence
+	 * data is the last reserved one.
+	 */
+	int64_t reserved_next;
+	int64_t reserved_count;
 	/** Cached runtime access information. */
 	struct access access[BOX_USER_MAX];
 };
@@ -150,6 +162,38 @@ sequence_update(struct sequence *seq, int64_t value);
 int
 sequence_next(struct sequence *seq, int64_t *result);
 
+/**
+ * Return the last value of a block of at most def->cache values
+ * that starts at @a value, which must have been just returned by
+ * sequence_next(). The block never crosses the min or max of
+ * the sequence. The sequence value must be set to the returned
+ * value for the block to be reserved.
+ */
+int64_t
+sequence_reserve_bound(struct sequence *seq, int64_t value);
+
+/**
+ * Keep the values after @a value up to @a last in memory, so
+ * that sequence_next_reserved() returns them. Nothing is kept if
+ * the sequence value was changed after it was set to @a last.
+ */
+void
+sequence_set_reserved(struct sequence *seq, int64_t value, int64_t last);
+
+/**
+ * Take the next reserved value. Return false if there are no
+ * reserved values left.
+ */
+bool
+sequence_next_reserved(struct sequence *seq, int64_t *result);
+
+/** Forget the values reserved by the sequence cache. */
+static inline void
+sequence_release_reserved(struct sequence *seq)
+{
+	seq->reserved_count = 0;
+}
+
 /**
  * Check whether or not the current user can be granted
  * access to the sequence.
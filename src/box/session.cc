@@ -232,6 +232,7 @@ session_create(enum session_type type)
 	session_set_type(session, type);
 	session->sql_flags = default_flags;
 	session->sql_default_engine = SQL_STORAGE_ENGINE_MEMTX;
+	session->txn_read_own_prepared = false;
 	session->sql_stmts = NULL;
 	session->watchers = NULL;
 
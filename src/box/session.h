@@ -109,6 +109,12 @@ struct session {
 	uint8_t sql_default_engine;
 	/** SQL Connection flag for current user session */
 	uint32_t sql_flags;
+	/**
+	 * Whether the session sees its own prepared transactions,
+	 * e.g. synchronous ones waiting for the quorum, before
+	 * they are committed.
+	 */
+	bool txn_read_own_prepared;
 	enum session_type type;
 	/** Session virtual methods. */
 	const struct session_vtab *vtab;
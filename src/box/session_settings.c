@@ -37,6 +37,7 @@
 #include "tuple.h"
 #include "xrow.h"
 #include "sql.h"
+#include "tt_static.h"
 
 struct session_setting session_settings[SESSION_SETTING_COUNT] = {};
 
@@ -51,6 +52,7 @@ const char *session_setting_strs[SESSION_SETTING_COUNT] = {
 	"sql_reverse_unordered_selects",
 	"sql_select_debug",
 	"sql_vdbe_debug",
+	"txn_read_own_prepared",
 };
 
 struct session_settings_index {
@@ -421,6 +423,7 @@ session_settings_space_create_index(struct space *space, struct index_def *def)
 const struct space_vtab session_settings_space_vtab = {
 	/* .destroy = */ session_settings_space_destroy,
 	/* .bsize = */ generic_space_bsize,
+	/* .stat = */ generic_space_stat,
 	/* .execute_replace = */ session_settings_space_execute_replace,
 	/* .execute_delete = */ session_settings_space_execute_delete,
 	/* .execute_update = */ session_settings_space_execute_update,
@@ -450,6 +453,39 @@ session_setting_find(const char *name) {
 		return -1;
 }
 
+static void
+txn_session_setting_get(int id, const char **mp_pair,
+			const char **mp_pair_end)
+{
+	assert(id == SESSION_SETTING_TXN_READ_OWN_PREPARED);
+	const char *name = session_setting_strs[id];
+	size_t name_len = strlen(name);
+	bool value = current_session()->txn_read_own_prepared;
+	size_t size = mp_sizeof_array(2) + mp_sizeof_str(name_len) +
+		      mp_sizeof_bool(value);
+	char *pos = static_alloc(size);
+	assert(pos != NULL);
+	char *pos_end = mp_encode_array(pos, 2);
+	pos_end = mp_encode_str(pos_end, name, name_len);
+	pos_end = mp_encode_bool(pos_end, value);
+	*mp_pair = pos;
+	*mp_pair_end = pos_end;
+}
+
+static int
+txn_session_setting_set(int id, const char *mp_value)
+{
+	assert(id == SESSION_SETTING_TXN_READ_OWN_PREPARED);
+	if (mp_typeof(*mp_value) != MP_BOOL) {
+		diag_set(ClientError, ER_SESSION_SETTING_INVALID_VALUE,
+			 session_setting_strs[id],
+			 field_type_strs[FIELD_TYPE_BOOLEAN]);
+		return -1;
+	}
+	current_session()->txn_read_own_prepared = mp_decode_bool(&mp_value);
+	return 0;
+}
+
 extern void
 sql_session_settings_init();
 
@@ -457,4 +493,9 @@ void
 session_settings_init(void)
 {
 	sql_session_settings_init();
+	struct session_setting *setting =
+		&session_settings[SESSION_SETTING_TXN_READ_OWN_PREPARED];
+	setting->field_type = FIELD_TYPE_BOOLEAN;
+	setting->get = txn_session_setting_get;
+	setting->set = txn_session_setting_set;
 }
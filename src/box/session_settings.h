@@ -53,13 +53,16 @@ enum {
 	SESSION_SETTING_SQL_SELECT_DEBUG,
 	SESSION_SETTING_SQL_VDBE_DEBUG,
 	SESSION_SETTING_SQL_END,
+	SESSION_SETTING_TXN_BEGIN = SESSION_SETTING_SQL_END,
+	SESSION_SETTING_TXN_READ_OWN_PREPARED = SESSION_SETTING_TXN_BEGIN,
+	SESSION_SETTING_TXN_END,
 	/**
 	 * Follow the pattern for groups of settings:
 	 * SESSION_SETTING_<N>_BEGIN = SESSION_SETTING_<N-1>_END,
 	 * ...
 	 * SESSION_SETTING_<N>_END,
 	 */
-	SESSION_SETTING_COUNT = SESSION_SETTING_SQL_END,
+	SESSION_SETTING_COUNT = SESSION_SETTING_TXN_END,
 };
 
 struct session_setting {
@@ -48,6 +48,8 @@
 #include "ck_constraint.h"
 #include "assoc.h"
 #include "constraint_id.h"
+#include "op_latency.h"
+#include "info/info.h"
 
 int
 access_check_space(struct space *space, user_access_t access)
@@ -259,6 +261,7 @@ space_delete(struct space *space)
 	}
 	free(space->index_map);
 	free(space->check_unique_constraint_map);
+	op_latency_delete(space->latency);
 	if (space->format != NULL)
 		tuple_format_unref(space->format);
 	trigger_destroy(&space->before_replace);
@@ -316,6 +319,27 @@ space_bsize(struct space *space)
 	return space->vtab->bsize(space);
 }
 
+bool
+space_is_ffi_dml_safe(struct space *space)
+{
+	if (!space_is_memtx(space) || space->sql_triggers != NULL)
+		return false;
+	if (space->run_triggers && (!rlist_empty(&space->before_replace) ||
+				    !rlist_empty(&space->on_replace)))
+		return false;
+	for (uint32_t i = 0; i < space->index_count; i++) {
+		if (space->index[i]->def->key_def->for_func_index)
+			return false;
+	}
+	return true;
+}
+
+void
+space_stat(struct space *space, struct info_handler *handler)
+{
+	space->vtab->stat(space, handler);
+}
+
 struct index_def *
 space_index_def(struct space *space, int n)
 {
@@ -662,6 +686,14 @@ generic_space_bsize(struct space *space)
 	return 0;
 }
 
+void
+generic_space_stat(struct space *space, struct info_handler *handler)
+{
+	(void)space;
+	info_begin(handler);
+	info_end(handler);
+}
+
 int
 generic_space_ephemeral_replace(struct space *space, const char *tuple,
 				const char *tuple_end)
@@ -53,12 +53,15 @@ struct tuple;
 struct tuple_format;
 struct ck_constraint;
 struct constraint_id;
+struct info_handler;
 
 struct space_vtab {
 	/** Free a space instance. */
 	void (*destroy)(struct space *);
 	/** Return binary size of a space. */
 	size_t (*bsize)(struct space *);
+	/** Dump space statistics, see space:stat(). */
+	void (*stat)(struct space *, struct info_handler *);
 
 	int (*execute_replace)(struct space *, struct txn *,
 			       struct request *, struct tuple **result);
@@ -243,6 +246,11 @@ struct space {
 	 * List of all tx stories in the space.
 	 */
 	struct rlist memtx_stories;
+	/**
+	 * Latency of DML requests, or NULL.
+	 * See box.cfg.space_latency_stat.
+	 */
+	struct op_latency *latency;
 };
 
 /** Initialize a base space instance. */
@@ -364,6 +372,21 @@ index_find_unique(struct space *space, uint32_t index_id)
 size_t
 space_bsize(struct space *space);
 
+/**
+ * Check if DML requests on the space can be executed from Lua via
+ * FFI. An FFI call must neither yield nor call Lua code, so the
+ * space must be a memtx one, and it must not have triggers or
+ * functional indexes. Besides, the request must be done in a
+ * transaction, so as not to wait for the WAL, which is checked
+ * by the caller.
+ */
+bool
+space_is_ffi_dml_safe(struct space *space);
+
+/** Dump space statistics in the given format. */
+void
+space_stat(struct space *space, struct info_handler *handler);
+
 /** Get definition of the n-th index of the space. */
 struct index_def *
 space_index_def(struct space *space, int n);
@@ -567,6 +590,7 @@ space_pop_constraint_id(struct space *space, const char *name);
  * Virtual method stubs.
  */
 size_t generic_space_bsize(struct space *);
+void generic_space_stat(struct space *, struct info_handler *);
 int generic_space_ephemeral_replace(struct space *, const char *, const char *);
 int generic_space_ephemeral_delete(struct space *, const char *);
 int generic_space_ephemeral_rowid_next(struct space *, uint64_t *);
@@ -35,6 +35,9 @@
 #include "sql.h"
 #include "msgpuck.h"
 #include "tt_static.h"
+#include "fiber.h"
+#include "json/json.h"
+#include "tuple_format.h"
 
 const struct space_opts space_opts_default = {
 	/* .group_id = */ 0,
@@ -42,15 +45,68 @@ const struct space_opts space_opts_default = {
 	/* .is_ephemeral = */ false,
 	/* .view = */ false,
 	/* .is_sync = */ false,
+	/* .memory_quota = */ 0,
+	/* .expire_field = */ 0,
 	/* .sql        = */ NULL,
+	/* .cached_paths = */ NULL,
 };
 
+/**
+ * Decode the cached_paths space option. The paths are checked
+ * here, field names in them are resolved when a tuple format is
+ * created. The array is copied to the region as is, an empty one
+ * is stored as NULL.
+ */
+static int
+space_opts_parse_cached_paths(const char **data, uint32_t len, char *opt,
+			      uint32_t errcode, uint32_t field_no)
+{
+	const char *begin = *data;
+	for (uint32_t i = 0; i < len; i++) {
+		if (mp_typeof(**data) != MP_STR) {
+			diag_set(ClientError, errcode, field_no,
+				 "'cached_paths' must be an array of strings");
+			return -1;
+		}
+		uint32_t path_len;
+		const char *path = mp_decode_str(data, &path_len);
+		if (path_len == 0 ||
+		    json_path_validate(path, path_len, TUPLE_INDEX_BASE) != 0 ||
+		    json_path_multikey_offset(path, path_len,
+					      TUPLE_INDEX_BASE) !=
+		    (int)path_len) {
+			diag_set(ClientError, errcode, field_no,
+				 tt_sprintf("invalid cached path '%.*s'",
+					    path_len, path));
+			return -1;
+		}
+	}
+	char *paths = NULL;
+	if (len > 0) {
+		size_t size = mp_sizeof_array(len) + (*data - begin);
+		paths = region_alloc(&fiber()->gc, size);
+		if (paths == NULL) {
+			diag_set(OutOfMemory, size, "region_alloc",
+				 "cached_paths");
+			return -1;
+		}
+		char *pos = mp_encode_array(paths, len);
+		memcpy(pos, begin, *data - begin);
+	}
+	memcpy(opt, &paths, sizeof(paths));
+	return 0;
+}
+
 const struct opt_def space_opts_reg[] = {
 	OPT_DEF("group_id", OPT_UINT32, struct space_opts, group_id),
 	OPT_DEF("temporary", OPT_BOOL, struct space_opts, is_temporary),
 	OPT_DEF("view", OPT_BOOL, struct space_opts, is_view),
 	OPT_DEF("is_sync", OPT_BOOL, struct space_opts, is_sync),
+	OPT_DEF("memory_quota", OPT_INT64, struct space_opts, memory_quota),
+	OPT_DEF("expire_field", OPT_UINT32, struct space_opts, expire_field),
 	OPT_DEF("sql", OPT_STRPTR, struct space_opts, sql),
+	OPT_DEF_ARRAY("cached_paths", struct space_opts, cached_paths,
+		      space_opts_parse_cached_paths),
 	OPT_DEF_LEGACY("checks"),
 	OPT_END,
 };
@@ -92,6 +148,7 @@ static int
 space_def_dup_opts(struct space_def *def, const struct space_opts *opts)
 {
 	def->opts = *opts;
+	def->opts.cached_paths = NULL;
 	if (opts->sql != NULL) {
 		def->opts.sql = strdup(opts->sql);
 		if (def->opts.sql == NULL) {
@@ -100,6 +157,18 @@ space_def_dup_opts(struct space_def *def, const struct space_opts *opts)
 			return -1;
 		}
 	}
+	if (opts->cached_paths != NULL) {
+		const char *end = opts->cached_paths;
+		mp_next(&end);
+		size_t size = end - opts->cached_paths;
+		def->opts.cached_paths = malloc(size);
+		if (def->opts.cached_paths == NULL) {
+			diag_set(OutOfMemory, size, "malloc",
+				 "def->opts.cached_paths");
+			return -1;
+		}
+		memcpy(def->opts.cached_paths, opts->cached_paths, size);
+	}
 	return 0;
 }
 
@@ -281,5 +350,6 @@ void
 space_opts_destroy(struct space_opts *opts)
 {
 	free(opts->sql);
+	free(opts->cached_paths);
 	TRASH(opts);
 }
@@ -73,8 +73,28 @@ struct space_opts {
 	 * until replicated to a quorum of replicas.
 	 */
 	bool is_sync;
+	/**
+	 * Maximal number of bytes that tuples of the space may
+	 * occupy in memory, 0 means unlimited. Writes that would
+	 * exceed the quota fail with ER_SPACE_MEMORY_QUOTA.
+	 * Supported only by memtx.
+	 */
+	int64_t memory_quota;
+	/**
+	 * Number of a field (1-based) with the time when a tuple
+	 * expires, in seconds since the epoch. Expired tuples are
+	 * deleted in the background. 0 means tuples never expire.
+	 * Supported only by memtx.
+	 */
+	uint32_t expire_field;
 	/** SQL statement that produced this space. */
 	char *sql;
+	/**
+	 * MsgPack array of JSON paths to nested fields, which
+	 * offsets are stored in the tuple field map like the
+	 * offsets of indexed fields. NULL if there are none.
+	 */
+	char *cached_paths;
 };
 
 extern const struct space_opts space_opts_default;
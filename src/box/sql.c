@@ -1276,8 +1276,10 @@ vdbe_field_ref_create(struct vdbe_field_ref *field_ref, struct tuple *tuple,
 	const char *field0 = data;
 	field_ref->field_count = mp_decode_array((const char **) &field0);
 	field_ref->slots[0] = (uint32_t)(field0 - data);
-	memset(&field_ref->slots[1], 0,
-	       field_ref->field_count * sizeof(field_ref->slots[0]));
+	if (field_ref->field_count >= 64) {
+		memset(&field_ref->slots[64], 0, (field_ref->field_count - 63) *
+		       sizeof(field_ref->slots[0]));
+	}
 	field_ref->slot_bitmask = 0;
 	bitmask64_set_bit(&field_ref->slot_bitmask, 0);
 }
@@ -1369,7 +1371,17 @@ index_field_tuple_est(const struct index_def *idx_def, uint32_t field)
 		if (field == idx_def->key_def->part_count &&
 		    idx_def->opts.is_unique)
 			return 0;
-		return default_tuple_est[field + 1 >= 6 ? 6 : field];
+		if (field > 0)
+			return default_tuple_est[field + 1 >= 6 ? 6 : field];
+		/*
+		 * The number of tuples is maintained by the engine,
+		 * so spaces bigger than the default are estimated by
+		 * their real size. Smaller ones keep the default in
+		 * order not to make plans depend on the amount of
+		 * data, which changes quickly in small spaces.
+		 */
+		log_est_t size = sqlLogEst(index_size(tnt_idx));
+		return MAX(size, default_tuple_est[0]);
 	}
 	return tnt_idx->def->opts.stat->tuple_log_est[field];
 }
@@ -394,8 +394,12 @@ struct vdbe_field_ref {
 	 */
 	uint64_t slot_bitmask;
 	/**
-	 * Array of offsets of tuple fields.
-	 * Only values <= rightmost_slot are valid.
+	 * Array of offsets of tuple fields. A slot below 64 is
+	 * valid if it's marked in slot_bitmask, the rest are valid
+	 * if they aren't 0. So only slots starting from 64 need to
+	 * be zeroed when a new tuple is prepared, and for tuples
+	 * shorter than that, as is usually the case, moving
+	 * a cursor to the next tuple costs nothing.
 	 */
 	uint32_t slots[1];
 };
@@ -2754,7 +2754,7 @@ sqlCodeSubselect(Parse * pParse,	/* Parsing context */
 		jmpIfDynamic = sqlVdbeAddOp0(v, OP_Once);
 		VdbeCoverage(v);
 	}
-	if (pParse->explain == 2) {
+	if (pParse->explain >= 2) {
 		char *zMsg =
 		    sqlMPrintf(pParse->db, "EXECUTE %s%s SUBQUERY %d",
 				   jmpIfDynamic >= 0 ? "" : "CORRELATED ",
@@ -4716,6 +4716,26 @@ exprCodeBetween(Parse * pParse,	/* Parsing and code generating context */
 	testcase(xJump == 0);
 }
 
+/**
+ * Generate code for an operand of a comparison or a NULL check
+ * in a condition. The operand value is consumed by the check right
+ * away, so a column is fetched without copying it out of the tuple
+ * and without storing it in the column cache. This way rows
+ * rejected by a filter don't pay for materialization of the
+ * columns it refers to.
+ */
+static int
+expr_code_condition_operand(struct Parse *parse, struct Expr *expr, int *reg)
+{
+	if (expr->op != TK_COLUMN_REF)
+		return sqlExprCodeTemp(parse, expr, reg);
+	u8 op2 = expr->op2;
+	expr->op2 = OPFLAG_EPHEM;
+	int r = sqlExprCodeTemp(parse, expr, reg);
+	expr->op2 = op2;
+	return r;
+}
+
 /*
  * Generate code for a boolean expression such that a jump is made
  * to the label "dest" if the expression is true but execution
@@ -4783,10 +4803,12 @@ sqlExprIfTrue(Parse * pParse, Expr * pExpr, int dest, int jumpIfNull)
 			if (sqlExprIsVector(pExpr->pLeft))
 				goto default_expr;
 			testcase(jumpIfNull == 0);
-			r1 = sqlExprCodeTemp(pParse, pExpr->pLeft,
-						 &regFree1);
-			r2 = sqlExprCodeTemp(pParse, pExpr->pRight,
-						 &regFree2);
+			r1 = expr_code_condition_operand(pParse,
+							 pExpr->pLeft,
+							 &regFree1);
+			r2 = expr_code_condition_operand(pParse,
+							 pExpr->pRight,
+							 &regFree2);
 			codeCompare(pParse, pExpr->pLeft, pExpr->pRight, op, r1,
 				    r2, dest, jumpIfNull);
 			assert(TK_LT == OP_Lt);
@@ -4823,8 +4845,9 @@ sqlExprIfTrue(Parse * pParse, Expr * pExpr, int dest, int jumpIfNull)
 			testcase(op == TK_ISNULL);
 			assert(TK_NOTNULL == OP_NotNull);
 			testcase(op == TK_NOTNULL);
-			r1 = sqlExprCodeTemp(pParse, pExpr->pLeft,
-						 &regFree1);
+			r1 = expr_code_condition_operand(pParse,
+							 pExpr->pLeft,
+							 &regFree1);
 			sqlVdbeAddOp2(v, op, r1, dest);
 			VdbeCoverageIf(v, op == TK_ISNULL);
 			VdbeCoverageIf(v, op == TK_NOTNULL);
@@ -4976,10 +4999,12 @@ sqlExprIfFalse(Parse * pParse, Expr * pExpr, int dest, int jumpIfNull)
 			if (sqlExprIsVector(pExpr->pLeft))
 				goto default_expr;
 			testcase(jumpIfNull == 0);
-			r1 = sqlExprCodeTemp(pParse, pExpr->pLeft,
-						 &regFree1);
-			r2 = sqlExprCodeTemp(pParse, pExpr->pRight,
-						 &regFree2);
+			r1 = expr_code_condition_operand(pParse,
+							 pExpr->pLeft,
+							 &regFree1);
+			r2 = expr_code_condition_operand(pParse,
+							 pExpr->pRight,
+							 &regFree2);
 			codeCompare(pParse, pExpr->pLeft, pExpr->pRight, op, r1,
 				    r2, dest, jumpIfNull);
 			assert(TK_LT == OP_Lt);
@@ -5012,8 +5037,9 @@ sqlExprIfFalse(Parse * pParse, Expr * pExpr, int dest, int jumpIfNull)
 		}
 	case TK_ISNULL:
 	case TK_NOTNULL:{
-			r1 = sqlExprCodeTemp(pParse, pExpr->pLeft,
-						 &regFree1);
+			r1 = expr_code_condition_operand(pParse,
+							 pExpr->pLeft,
+							 &regFree1);
 			sqlVdbeAddOp2(v, op, r1, dest);
 			testcase(op == TK_ISNULL);
 			VdbeCoverageIf(v, op == TK_ISNULL);
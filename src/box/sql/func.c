@@ -305,13 +305,12 @@ func_lower_upper(struct sql_context *ctx, int argc, const struct Mem *argv)
 		return mem_set_str0_static(ctx->pOut, "");
 	const char *str = arg->z;
 	int32_t len = arg->n;
-	struct sql *db = sql_get();
-	char *res = sqlDbMallocRawNN(db, len);
+	char *res = mem_reserve(ctx->pOut, len);
 	if (res == NULL) {
 		ctx->is_aborted = true;
 		return;
 	}
-	int32_t size = sqlDbMallocSize(db, res);
+	int32_t size = ctx->pOut->szMalloc;
 	assert(size >= len);
 	UErrorCode status = U_ZERO_ERROR;
 	const char *locale = NULL;
@@ -329,11 +328,13 @@ func_lower_upper(struct sql_context *ctx, int argc, const struct Mem *argv)
 		ucasemap_utf8ToUpper(cm, res, size, str, len, &status) :
 		ucasemap_utf8ToLower(cm, res, size, str, len, &status);
 	if (new_len > size) {
-		res = sqlDbRealloc(db, res, new_len);
-		if (db->mallocFailed != 0) {
+		res = mem_reserve(ctx->pOut, new_len);
+		if (res == NULL) {
+			ucasemap_close(cm);
 			ctx->is_aborted = true;
 			return;
 		}
+		size = ctx->pOut->szMalloc;
 		status = U_ZERO_ERROR;
 		if (is_upper)
 			ucasemap_utf8ToUpper(cm, res, size, str, len, &status);
@@ -341,7 +342,7 @@ func_lower_upper(struct sql_context *ctx, int argc, const struct Mem *argv)
 			ucasemap_utf8ToLower(cm, res, size, str, len, &status);
 	}
 	ucasemap_close(cm);
-	mem_set_str_allocated(ctx->pOut, res, new_len);
+	mem_set_str_reserved(ctx->pOut, new_len);
 }
 
 /** Implementation of the NULLIF() function. */
@@ -778,7 +779,7 @@ func_char(struct sql_context *ctx, int argc, const struct Mem *argv)
 		len += U8_LENGTH(buf[i]);
 	}
 
-	char *str = sqlDbMallocRawNN(sql_get(), len);
+	char *str = mem_reserve(ctx->pOut, len);
 	if (str == NULL) {
 		region_truncate(region, svp);
 		ctx->is_aborted = true;
@@ -794,7 +795,7 @@ func_char(struct sql_context *ctx, int argc, const struct Mem *argv)
 	region_truncate(region, svp);
 	assert(pos == len);
 	(void)pos;
-	mem_set_str_allocated(ctx->pOut, str, len);
+	mem_set_str_reserved(ctx->pOut, len);
 }
 
 /**
@@ -849,7 +850,7 @@ func_hex(struct sql_context *ctx, int argc, const struct Mem *argv)
 		return mem_set_str0_static(ctx->pOut, "");
 
 	uint32_t size = 2 * arg->n;
-	char *str = sqlDbMallocRawNN(sql_get(), size);
+	char *str = mem_reserve(ctx->pOut, size);
 	if (str == NULL) {
 		ctx->is_aborted = true;
 		return;
@@ -859,7 +860,7 @@ func_hex(struct sql_context *ctx, int argc, const struct Mem *argv)
 		str[2 * i] = hexdigits[(c >> 4) & 0xf];
 		str[2 * i + 1] = hexdigits[c & 0xf];
 	}
-	mem_set_str_allocated(ctx->pOut, str, size);
+	mem_set_str_reserved(ctx->pOut, size);
 }
 
 /** Implementation of the OCTET_LENGTH() function. */
@@ -2124,6 +2125,7 @@ sql_built_in_functions_cache_init(void)
 		func->base.vtab = &func_sql_builtin_vtab;
 		credentials_create_empty(&func->base.owner_credentials);
 		memset(func->base.access, 0, sizeof(func->base.access));
+		func->base.cache = NULL;
 
 		func->param_list = desc->argt;
 		func->flags = dict->flags;
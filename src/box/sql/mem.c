@@ -434,6 +434,31 @@ mem_copy_str0(struct Mem *mem, const char *value)
 	return 0;
 }
 
+char *
+mem_reserve(struct Mem *mem, uint32_t size)
+{
+	mem_clear(mem);
+	if (sqlVdbeMemClearAndResize(mem, MAX(size, 1)) != 0)
+		return NULL;
+	return mem->z;
+}
+
+static inline void
+set_reserved(struct Mem *mem, uint32_t size, enum mem_type type)
+{
+	assert(mem_is_null(mem));
+	assert(mem->z == mem->zMalloc && (int)size <= mem->szMalloc);
+	mem->n = size;
+	mem->type = type;
+	mem->flags = 0;
+}
+
+void
+mem_set_str_reserved(struct Mem *mem, uint32_t len)
+{
+	set_reserved(mem, len, MEM_TYPE_STR);
+}
+
 static inline void
 set_bin_const(struct Mem *mem, char *value, uint32_t size, int alloc_type)
 {
@@ -458,6 +483,12 @@ set_bin_dynamic(struct Mem *mem, char *value, uint32_t size, int alloc_type)
 	mem->szMalloc = sqlDbMallocSize(mem->db, mem->zMalloc);
 }
 
+void
+mem_set_bin_reserved(struct Mem *mem, uint32_t size)
+{
+	set_reserved(mem, size, MEM_TYPE_BIN);
+}
+
 void
 mem_set_bin_ephemeral(struct Mem *mem, char *value, uint32_t size)
 {
@@ -360,6 +360,24 @@ mem_copy_str(struct Mem *mem, const char *value, uint32_t len);
 int
 mem_copy_str0(struct Mem *mem, const char *value);
 
+/**
+ * Clear MEM and return a buffer of at least @a size bytes owned by it. The
+ * buffer the MEM already owns is reused if it is big enough, so a register
+ * that receives a value of similar size on every row doesn't allocate
+ * memory. The buffer is supposed to be filled and then turned into the
+ * value of MEM with mem_set_str_reserved() or mem_set_bin_reserved().
+ * Returns NULL on memory error.
+ */
+char *
+mem_reserve(struct Mem *mem, uint32_t size);
+
+/**
+ * Set MEM to STRING stored in the first @a len bytes of the buffer
+ * returned by mem_reserve().
+ */
+void
+mem_set_str_reserved(struct Mem *mem, uint32_t len);
+
 /**
  * Clear MEM and set it to VARBINARY. The binary value belongs to another
  * object.
@@ -380,6 +398,13 @@ mem_set_bin_static(struct Mem *mem, char *value, uint32_t size);
 void
 mem_set_bin_allocated(struct Mem *mem, char *value, uint32_t size);
 
+/**
+ * Set MEM to VARBINARY stored in the first @a size bytes of the buffer
+ * returned by mem_reserve().
+ */
+void
+mem_set_bin_reserved(struct Mem *mem, uint32_t size);
+
 /**
  * Copy binary value to a newly allocated memory. The MEM type becomes
  * VARBINARY.
@@ -593,6 +618,28 @@ int
 mem_cmp(const struct Mem *a, const struct Mem *b, int *result,
 	const struct coll *coll);
 
+/**
+ * Same as mem_cmp(), but comparison of two integers, which is the
+ * most common one in WHERE clauses, is done inline bypassing type
+ * class dispatching.
+ */
+static inline int
+mem_cmp_fast(const struct Mem *a, const struct Mem *b, int *result,
+	     const struct coll *coll)
+{
+	if (((a->type | b->type) & ~(MEM_TYPE_UINT | MEM_TYPE_INT)) != 0 ||
+	    ((a->flags | b->flags) & MEM_Any) != 0)
+		return mem_cmp(a, b, result, coll);
+	/* Only negative values are stored as MEM_TYPE_INT. */
+	if (a->type != b->type)
+		*result = a->type == MEM_TYPE_INT ? -1 : 1;
+	else if (a->type == MEM_TYPE_INT)
+		*result = a->u.i < b->u.i ? -1 : a->u.i > b->u.i;
+	else
+		*result = a->u.u < b->u.u ? -1 : a->u.u > b->u.u;
+	return 0;
+}
+
 /**
  * Convert the given MEM to INTEGER. This function and the function below define
  * the rules that are used to convert values of all other types to INTEGER. In
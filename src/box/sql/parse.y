@@ -131,6 +131,7 @@ ecmd ::= SEMI. {
 explain ::= .
 explain ::= EXPLAIN.              { pParse->explain = 1; }
 explain ::= EXPLAIN QUERY PLAN.   { pParse->explain = 2; }
+explain ::= EXPLAIN ANALYZE.      { pParse->explain = 3; }
 cmdx ::= cmd.
 
 // Define operator precedence early so that this is the first occurrence
@@ -125,12 +125,23 @@ sql_stmt_compile(const char *zSql, int nBytes, struct Vdbe *pReprepare,
 			/* 21 */ "integer",
 			/* 22 */ "detail",
 			/* 23 */ "text",
+			/* 24 */ "count",
+			/* 25 */ "integer",
+			/* 26 */ "time",
+			/* 27 */ "double",
+			/* 28 */ "scanned",
+			/* 29 */ "integer",
+			/* 30 */ "returned",
+			/* 31 */ "integer",
 		};
 
 		int name_first, name_count;
 		if (sParse.explain == 2) {
 			name_first = 16;
 			name_count = 4;
+		} else if (sParse.explain == 3) {
+			name_first = 0;
+			name_count = 12;
 		} else {
 			name_first = 0;
 			name_count = 8;
@@ -138,6 +149,12 @@ sql_stmt_compile(const char *zSql, int nBytes, struct Vdbe *pReprepare,
 		sqlVdbeSetNumCols(sParse.pVdbe, name_count);
 		for (int i = 0; i < name_count; i++) {
 			int name_index = 2 * i + name_first;
+			/*
+			 * EXPLAIN ANALYZE columns follow the ones of
+			 * EXPLAIN QUERY PLAN.
+			 */
+			if (i >= 8)
+				name_index += 8;
 			vdbe_metadata_set_col_name(sParse.pVdbe, i,
 						   azColName[name_index]);
 			vdbe_metadata_set_col_type(sParse.pVdbe, i,
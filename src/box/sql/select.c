@@ -1725,7 +1725,7 @@ sql_select_op_name(int id)
 static void
 explainTempTable(Parse * pParse, const char *zUsage)
 {
-	if (pParse->explain == 2) {
+	if (pParse->explain >= 2) {
 		Vdbe *v = pParse->pVdbe;
 		char *zMsg =
 		    sqlMPrintf(pParse->db, "USE TEMP B-TREE FOR %s",
@@ -1759,7 +1759,7 @@ explainComposite(Parse * pParse,	/* Parse context */
 {
 	assert(op == TK_UNION || op == TK_EXCEPT || op == TK_INTERSECT
 	       || op == TK_ALL);
-	if (pParse->explain == 2) {
+	if (pParse->explain >= 2) {
 		Vdbe *v = pParse->pVdbe;
 		char *zMsg =
 		    sqlMPrintf(pParse->db,
@@ -5691,7 +5691,7 @@ updateAccumulator(Parse * pParse, AggInfo * pAggInfo)
 static void
 explain_simple_count(struct Parse *parse_context, const char *table_name)
 {
-	if (parse_context->explain == 2) {
+	if (parse_context->explain >= 2) {
 		char *zEqp = sqlMPrintf(parse_context->db, "B+tree count %s",
 					    table_name);
 		sqlVdbeAddOp4(parse_context->pVdbe, OP_Explain,
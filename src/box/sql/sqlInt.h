@@ -2059,7 +2059,7 @@ struct Parse {
 	 */
 	int line_pos;
 	ynVar nVar;		/* Number of '?' variables seen in the SQL so far */
-	u8 explain;		/* True if the EXPLAIN flag is found on the query */
+	u8 explain;		/* 1: EXPLAIN, 2: QUERY PLAN, 3: ANALYZE */
 	int nHeight;		/* Expression tree height of current sub-select */
 	int iSelectId;		/* ID of current select for EXPLAIN output */
 	int iNextSelectId;	/* Next available select ID for EXPLAIN output */
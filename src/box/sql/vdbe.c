@@ -57,6 +57,7 @@
 #include "box/space.h"
 #include "box/sequence.h"
 #include "box/session_settings.h"
+#include "clock.h"
 
 #ifdef SQL_DEBUG
 
@@ -346,7 +347,9 @@ vdbe_field_ref_closest_slotno(struct vdbe_field_ref *field_ref,
 static const char *
 vdbe_field_ref_fetch_data(struct vdbe_field_ref *field_ref, uint32_t fieldno)
 {
-	if (field_ref->slots[fieldno] != 0)
+	if (fieldno < 64 ?
+	    bitmask64_is_bit_set(field_ref->slot_bitmask, fieldno) :
+	    field_ref->slots[fieldno] != 0)
 		return field_ref->data + field_ref->slots[fieldno];
 
 	const char *field_begin;
@@ -364,7 +367,7 @@ vdbe_field_ref_fetch_data(struct vdbe_field_ref *field_ref, uint32_t fieldno)
 			 * Try to find the biggest initialized
 			 * slot.
 			 */
-			for (uint32_t it = fieldno - 1; it > prev; it--) {
+			for (uint32_t it = fieldno - 1; it >= 64; it--) {
 				if (field_ref->slots[it] == 0)
 					continue;
 				prev = it;
@@ -390,13 +393,15 @@ vdbe_field_ref_fetch_data(struct vdbe_field_ref *field_ref, uint32_t fieldno)
  * in dest_mem.
  * @param field_ref The initialized vdbe_field_ref instance to use.
  * @param fieldno The id of the field to fetch.
+ * @param is_ephemeral Don't copy strings and binaries, refer to
+ *        the tuple data instead.
  * @param[out] dest_mem The memory variable to store result.
  * @retval 0 Status code in case of success.
  * @retval sql_ret_code Error code otherwise.
  */
 static int
 vdbe_field_ref_fetch(struct vdbe_field_ref *field_ref, uint32_t fieldno,
-		     struct Mem *dest_mem)
+		     bool is_ephemeral, struct Mem *dest_mem)
 {
 	if (fieldno >= field_ref->field_count) {
 		UPDATE_MAX_BLOBSIZE(dest_mem);
@@ -405,7 +410,9 @@ vdbe_field_ref_fetch(struct vdbe_field_ref *field_ref, uint32_t fieldno,
 	assert(sqlVdbeCheckMemInvariants(dest_mem) != 0);
 	const char *data = vdbe_field_ref_fetch_data(field_ref, fieldno);
 	uint32_t dummy;
-	if (mem_from_mp(dest_mem, data, &dummy) != 0)
+	int rc = is_ephemeral ? mem_from_mp_ephemeral(dest_mem, data, &dummy) :
+		 mem_from_mp(dest_mem, data, &dummy);
+	if (rc != 0)
 		return -1;
 	UPDATE_MAX_BLOBSIZE(dest_mem);
 	return 0;
@@ -432,6 +439,9 @@ int sqlVdbeExec(Vdbe *p)
 	Mem *pIn3 = 0;             /* 3rd input operand */
 	Mem *pOut = 0;             /* Output operand */
 	int *aPermute = 0;         /* Permutation of columns for OP_Compare */
+	/* EXPLAIN ANALYZE statistics of the current instruction. */
+	struct vdbe_op_stat *op_stat = NULL;
+	uint64_t op_start = 0;     /* Time when the instruction started */
 #ifdef VDBE_PROFILE
 	u64 start;                 /* CPU clock count at start of opcode */
 #endif
@@ -440,7 +450,7 @@ int sqlVdbeExec(Vdbe *p)
 	assert(p->magic==VDBE_MAGIC_RUN);  /* sql_step() verifies this */
 	assert(!p->is_aborted);
 	p->iCurrentTime = 0;
-	assert(p->explain==0);
+	assert(p->explain == 0 || p->explain == 3);
 	p->pResultSet = 0;
 #ifdef SQL_DEBUG
 	if (p->pc == 0 &&
@@ -477,6 +487,14 @@ int sqlVdbeExec(Vdbe *p)
 #ifdef VDBE_PROFILE
 		start = sqlHwtime();
 #endif
+		/*
+		 * Subprograms of triggers aren't accounted, because
+		 * they have their own instruction arrays.
+		 */
+		if (unlikely(p->op_stat != NULL) && p->pFrame == NULL) {
+			op_stat = &p->op_stat[pOp - aOp];
+			op_start = clock_monotonic64();
+		}
 		nVmStep++;
 
 		/* Only allow tracing if SQL_DEBUG is defined.
@@ -1035,7 +1053,7 @@ case OP_SCopy: {            /* out2 */
  * the result row.
  */
 case OP_ResultRow: {
-	assert(p->nResColumn==pOp->p2);
+	assert(p->nResColumn==pOp->p2 || p->explain == 3);
 	assert(pOp->p1>0);
 	assert(pOp->p1+pOp->p2<=(p->nMem+1 - p->nCursor)+1);
 	assert(p->iStatement == 0 && p->anonymous_savepoint == NULL);
@@ -1477,7 +1495,7 @@ case OP_Ne: {             /* same as TK_NE, jump, in1, in3 */
 		break;
 	}
 	int cmp_res;
-	if (mem_cmp(pIn3, pIn1, &cmp_res, pOp->p4.pColl) != 0)
+	if (mem_cmp_fast(pIn3, pIn1, &cmp_res, pOp->p4.pColl) != 0)
 		goto abort_due_to_error;
 	bool result = pOp->opcode == OP_Eq ? cmp_res == 0 : cmp_res != 0;
 	if ((pOp->p5 & SQL_STOREP2) != 0) {
@@ -1539,7 +1557,7 @@ case OP_Ge: {             /* same as TK_GE, jump, in1, in3 */
 		break;
 	}
 	int cmp_res;
-	if (mem_cmp(pIn3, pIn1, &cmp_res, pOp->p4.pColl) != 0)
+	if (mem_cmp_fast(pIn3, pIn1, &cmp_res, pOp->p4.pColl) != 0)
 		goto abort_due_to_error;
 
 	bool result;
@@ -1894,6 +1912,9 @@ case OP_NotNull: {            /* same as TK_NOTNULL, jump, in1 */
  * the result is guaranteed to only be used as the argument of a length()
  * or typeof() function, respectively.  The loading of large blobs can be
  * skipped for length() and all content loading can be skipped for typeof().
+ *
+ * If the OPFLAG_EPHEM bit is set on P5, the result is consumed before the
+ * cursor moves, so strings and blobs are not copied out of the tuple.
  */
 case OP_Column: {
 	int p2;            /* column number to retrieve */
@@ -1941,7 +1962,8 @@ case OP_Column: {
 	       pC->eCurType == CURTYPE_PSEUDO);
 	struct Mem *default_val_mem =
 		pOp->p4type == P4_MEM ? pOp->p4.pMem : NULL;
-	if (vdbe_field_ref_fetch(&pC->field_ref, p2, pDest) != 0)
+	if (vdbe_field_ref_fetch(&pC->field_ref, p2,
+				 (pOp->p5 & OPFLAG_EPHEM) != 0, pDest) != 0)
 		goto abort_due_to_error;
 
 	if (mem_is_null(pDest) &&
@@ -1981,7 +2003,7 @@ case OP_Fetch: {
 		(struct vdbe_field_ref *) p->aMem[pOp->p1].u.p;
 	uint32_t field_idx = pOp->p2;
 	struct Mem *dest_mem = vdbe_prepare_null_out(p, pOp->p3);
-	if (vdbe_field_ref_fetch(field_ref, field_idx, dest_mem) != 0)
+	if (vdbe_field_ref_fetch(field_ref, field_idx, false, dest_mem) != 0)
 		goto abort_due_to_error;
 	REGISTER_TRACE(p, pOp->p3, dest_mem);
 	break;
@@ -4375,8 +4397,9 @@ case OP_SetSession: {
  * destination.
  */
 /*
- * The magic Explain opcode are only inserted when explain==2 (which
- * is to say when the EXPLAIN QUERY PLAN syntax is used.)
+ * The magic Explain opcode are only inserted when explain==2 or
+ * explain==3 (which is to say when the EXPLAIN QUERY PLAN or EXPLAIN
+ * ANALYZE syntax is used.)
  * This opcode records information from the optimizer.  It is the
  * the same as a no-op.  This opcodesnever appears in a real VM program.
  */
@@ -4400,6 +4423,11 @@ default: {          /* This is really OP_Noop and OP_Explain */
 			pOrigOp->cnt++;
 		}
 #endif
+		if (unlikely(op_stat != NULL)) {
+			op_stat->count++;
+			op_stat->time += clock_monotonic64() - op_start;
+			op_stat = NULL;
+		}
 
 		/* The following code adds nothing to the actual functionality
 		 * of the program.  It is only here for testing and debugging.
@@ -4435,6 +4463,11 @@ abort_due_to_error:
 
 	/* This is the only way out of this procedure. */
 vdbe_return:
+	/* Account the instruction that has returned or failed. */
+	if (unlikely(op_stat != NULL)) {
+		op_stat->count++;
+		op_stat->time += clock_monotonic64() - op_start;
+	}
 	testcase( nVmStep>0);
 	p->aCounter[SQL_STMTSTATUS_VM_STEP] += (int)nVmStep;
 	assert(rc == 0 || rc == -1 || rc == SQL_ROW || rc == SQL_DONE);
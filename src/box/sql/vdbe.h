@@ -222,6 +222,19 @@ VdbeOp *sqlVdbeGetOp(Vdbe *, int);
 int sqlVdbeMakeLabel(Vdbe *);
 void sqlVdbeRunOnlyOnce(Vdbe *);
 
+/**
+ * Remember the addresses of a WHERE loop, so that EXPLAIN ANALYZE
+ * can report how many rows it scanned and returned.
+ *
+ * @param v VDBE being built.
+ * @param addr_explain OP_Explain describing the loop.
+ * @param addr_visit Instruction executed once per scanned row.
+ * @param addr_output Instruction executed once per returned row.
+ */
+void
+sql_vdbe_scan_status(struct Vdbe *v, int addr_explain, int addr_visit,
+		     int addr_output);
+
 void
 vdbe_metadata_delete(struct Vdbe *v);
 
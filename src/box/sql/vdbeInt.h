@@ -186,14 +186,27 @@ struct sql_context {
  */
 typedef unsigned bft;		/* Bit Field Type */
 
+/**
+ * Addresses of a WHERE loop used by EXPLAIN ANALYZE to report the
+ * number of rows the loop scanned and returned. The numbers are
+ * taken from the execution counters of the instructions.
+ */
 typedef struct ScanStatus ScanStatus;
 struct ScanStatus {
-	int addrExplain;	/* OP_Explain for loop */
-	int addrLoop;		/* Address of "loops" counter */
-	int addrVisit;		/* Address of "rows visited" counter */
-	int iSelectID;		/* The "Select-ID" for this loop */
-	LogEst nEst;		/* Estimated output rows per loop */
-	char *zName;		/* Name of table or index */
+	/** OP_Explain describing the loop. */
+	int addrExplain;
+	/** Instruction executed once for every row scanned. */
+	int addrVisit;
+	/** Instruction executed once for every row returned. */
+	int addrOutput;
+};
+
+/** Execution statistics of an instruction, see EXPLAIN ANALYZE. */
+struct vdbe_op_stat {
+	/** Number of times the instruction was executed. */
+	uint64_t count;
+	/** Total time spent in the instruction, in nanoseconds. */
+	uint64_t time;
 };
 
 struct sql_column_metadata {
@@ -288,6 +301,11 @@ struct Vdbe {
 	bft expired:1;		/* True if the VM needs to be recompiled */
 	bft doingRerun:1;	/* True if rerunning after an auto-reprepare */
 	bft explain:2;		/* True if EXPLAIN present on SQL command */
+	/**
+	 * Set by EXPLAIN ANALYZE once the statement has been
+	 * executed and its instructions are being listed.
+	 */
+	bft is_analyzed:1;
 	bft changeCntOn:1;	/* True to update the change-counter */
 	bft runOnlyOnce:1;	/* Automatically expire on reset */
 	u32 aCounter[5];	/* Counters used by sql_stmt_status() */
@@ -297,6 +315,15 @@ struct Vdbe {
 	VdbeFrame *pDelFrame;	/* List of frame objects to free on VM reset */
 	int nFrame;		/* Number of frames in pFrame list */
 	SubProgram *pProgram;	/* Linked list of all sub-programs used by VM */
+	/**
+	 * EXPLAIN ANALYZE statistics of the main program
+	 * instructions, one per instruction. NULL otherwise.
+	 */
+	struct vdbe_op_stat *op_stat;
+	/** EXPLAIN ANALYZE addresses of WHERE loops. */
+	ScanStatus *aScan;
+	/** Number of entries in aScan. */
+	int nScan;
 	/** Parser flags with which this object was built. */
 	uint32_t sql_flags;
 	/* Anonymous savepoint for aborts only */
@@ -325,6 +352,13 @@ void sqlVdbePrintOp(FILE *, int, Op *);
 int sqlVdbeExec(Vdbe *);
 int sqlVdbeList(Vdbe *);
 
+/**
+ * Execute an EXPLAIN ANALYZE statement discarding its rows, then
+ * list its instructions along with their execution statistics.
+ */
+int
+sql_vdbe_analyze(struct Vdbe *p);
+
 int sqlVdbeHalt(Vdbe *);
 
 const char *sqlOpcodeName(int);
@@ -123,7 +123,8 @@ sqlStep(Vdbe * p)
 	int rc;
 
 	assert(p);
-	if (p->magic != VDBE_MAGIC_RUN)
+	/* EXPLAIN ANALYZE lists the program after it has halted. */
+	if (p->magic != VDBE_MAGIC_RUN && !p->is_analyzed)
 		sql_stmt_reset((sql_stmt *) p);
 
 	/* Check that malloc() has not failed. If it has, return early. */
@@ -149,7 +150,11 @@ sqlStep(Vdbe * p)
 		db->nVdbeActive++;
 		p->pc = 0;
 	}
-	if (p->explain) {
+	if (p->explain == 3) {
+		db->nVdbeExec++;
+		rc = sql_vdbe_analyze(p);
+		db->nVdbeExec--;
+	} else if (p->explain) {
 		rc = sqlVdbeList(p);
 	} else {
 		db->nVdbeExec++;
@@ -440,6 +440,22 @@ sqlVdbeRunOnlyOnce(Vdbe * p)
 	p->runOnlyOnce = 1;
 }
 
+void
+sql_vdbe_scan_status(struct Vdbe *v, int addr_explain, int addr_visit,
+		     int addr_output)
+{
+	assert(v->magic == VDBE_MAGIC_INIT);
+	size_t size = (v->nScan + 1) * sizeof(ScanStatus);
+	ScanStatus *scan = sqlDbRealloc(v->db, v->aScan, size);
+	if (scan == NULL)
+		return;
+	v->aScan = scan;
+	scan = &v->aScan[v->nScan++];
+	scan->addrExplain = addr_explain;
+	scan->addrVisit = addr_visit;
+	scan->addrOutput = addr_output;
+}
+
 /*
  * This routine is called after all opcodes have been inserted.  It loops
  * through all the opcodes and fixes up some details.
@@ -1191,6 +1207,10 @@ sqlVdbeFrameDelete(VdbeFrame * p)
  *
  * When p->explain==1, first the main program is listed, then each of
  * the trigger subprograms are listed one by one.
+ *
+ * p->explain==3 is used to implement EXPLAIN ANALYZE. It lists the
+ * instructions as p->explain==1 does, with their execution
+ * statistics in four additional columns.
  */
 int
 sqlVdbeList(Vdbe * p)
@@ -1202,15 +1222,17 @@ sqlVdbeList(Vdbe * p)
 	int i;			/* Loop counter */
 	int rc = 0;	/* Return code */
 	Mem *pMem = &p->aMem[1];	/* First Mem of result set */
+	int nColumn = p->explain == 1 ? 8 : p->explain == 2 ? 4 : 12;
 
 	assert(p->explain);
-	assert(p->magic == VDBE_MAGIC_RUN);
+	assert(p->magic == VDBE_MAGIC_RUN ||
+	       (p->is_analyzed && p->magic == VDBE_MAGIC_HALT));
 
 	/* Even though this opcode does not use dynamic strings for
 	 * the result, result columns may become dynamic if the user calls
 	 * sql_column_text16(), causing a translation to UTF-16 encoding.
 	 */
-	releaseMemArray(pMem, 8);
+	releaseMemArray(pMem, nColumn);
 	p->pResultSet = 0;
 
 	/* When the number of output rows reaches nRow, that means the
@@ -1221,14 +1243,14 @@ sqlVdbeList(Vdbe * p)
 	 * encountered, but p->pc will eventually catch up to nRow.
 	 */
 	nRow = p->nOp;
-	if (p->explain == 1) {
-		/* The first 8 memory cells are used for the result set.  So we will
-		 * commandeer the 9th cell to use as storage for an array of pointers
-		 * to trigger subprograms.  The VDBE is guaranteed to have at least 9
-		 * cells.
+	if (p->explain != 2) {
+		/* The first nColumn memory cells are used for the result set.
+		 * So we will commandeer the next cell to use as storage for an
+		 * array of pointers to trigger subprograms.  The VDBE is
+		 * guaranteed to have enough cells.
 		 */
-		assert(p->nMem > 9);
-		pSub = &p->aMem[9];
+		assert(p->nMem > nColumn + 1);
+		pSub = &p->aMem[nColumn + 1];
 		if (mem_is_bin(pSub)) {
 			/* On the first call to sql_step(), pSub will hold a NULL.  It is
 			 * initialized to a BLOB by the P4_SUBPROGRAM processing logic below
@@ -1249,11 +1271,14 @@ sqlVdbeList(Vdbe * p)
 	} else {
 		char *zP4;
 		Op *pOp;
+		struct vdbe_op_stat *stat = NULL;
 		if (i < p->nOp) {
 			/* The output line number is small enough that we are still in the
 			 * main program.
 			 */
 			pOp = &p->aOp[i];
+			if (p->op_stat != NULL)
+				stat = &p->op_stat[i];
 		} else {
 			/* We are currently listing subprograms.  Figure out which one and
 			 * pick up the appropriate opcode.
@@ -1265,7 +1290,7 @@ sqlVdbeList(Vdbe * p)
 			}
 			pOp = &apSub[j]->aOp[i];
 		}
-		if (p->explain == 1) {
+		if (p->explain != 2) {
 			assert(i >= 0);
 			mem_set_uint(pMem, i);
 
@@ -1321,7 +1346,7 @@ sqlVdbeList(Vdbe * p)
 		}
 		pMem++;
 
-		if (p->explain == 1) {
+		if (p->explain != 2) {
 			buf = sqlDbMallocRaw(sql_get(), 4);
 			if (buf == NULL)
 				return -1;
@@ -1338,15 +1363,67 @@ sqlVdbeList(Vdbe * p)
 #else
 			mem_set_null(pMem);
 #endif
+			pMem++;
+		}
+
+		if (p->explain == 3) {
+			if (stat != NULL) {
+				mem_set_uint(pMem, stat->count);
+				mem_set_double(pMem + 1, stat->time / 1e9);
+			} else {
+				mem_set_null(pMem);
+				mem_set_null(pMem + 1);
+			}
+			pMem += 2;
+			ScanStatus *scan = NULL;
+			for (int j = 0; stat != NULL && j < p->nScan; j++) {
+				if (p->aScan[j].addrExplain == i) {
+					scan = &p->aScan[j];
+					break;
+				}
+			}
+			if (scan != NULL) {
+				struct vdbe_op_stat *visit =
+					&p->op_stat[scan->addrVisit];
+				struct vdbe_op_stat *output =
+					&p->op_stat[scan->addrOutput];
+				mem_set_uint(pMem, visit->count);
+				mem_set_uint(pMem + 1, output->count);
+			} else {
+				mem_set_null(pMem);
+				mem_set_null(pMem + 1);
+			}
 		}
 
-		p->nResColumn = 8 - 4 * (p->explain - 1);
+		p->nResColumn = nColumn;
 		p->pResultSet = &p->aMem[1];
 		rc = SQL_ROW;
 	}
 	return rc;
 }
 
+int
+sql_vdbe_analyze(struct Vdbe *p)
+{
+	assert(p->explain == 3);
+	if (!p->is_analyzed) {
+		int rc;
+		do {
+			rc = sqlVdbeExec(p);
+		} while (rc == SQL_ROW);
+		if (rc != SQL_DONE)
+			return rc;
+		/*
+		 * The program has halted, so its registers can
+		 * be reused for the listing.
+		 */
+		releaseMemArray(&p->aMem[1], 13);
+		p->is_analyzed = 1;
+		p->pc = 0;
+	}
+	return sqlVdbeList(p);
+}
+
 #ifdef SQL_DEBUG
 /*
  * Print the SQL that was used to generate a VDBE program.
@@ -1448,6 +1525,9 @@ sqlVdbeRewind(Vdbe * p)
 	p->cacheCtr = 1;
 	p->iStatement = 0;
 	p->nFkConstraint = 0;
+	p->is_analyzed = 0;
+	if (p->op_stat != NULL)
+		memset(p->op_stat, 0, p->nOp * sizeof(p->op_stat[0]));
 #ifdef VDBE_PROFILE
 	for (i = 0; i < p->nOp; i++) {
 		p->aOp[i].cnt = 0;
@@ -1518,9 +1598,15 @@ sqlVdbeMakeReady(Vdbe * p,	/* The VDBE */
 	assert(EIGHT_BYTE_ALIGNMENT(&x.pSpace[x.nFree]));
 
 	resolveP2Values(p);
-	if (pParse->explain && nMem < 10) {
-		nMem = 10;
+	/*
+	 * EXPLAIN ANALYZE lists 12 columns and keeps the array
+	 * of subprograms in the next register.
+	 */
+	int explain_mem = pParse->explain == 3 ? 14 : 10;
+	if (pParse->explain && nMem < explain_mem) {
+		nMem = explain_mem;
 	}
+	int op_stat_count = pParse->explain == 3 ? p->nOp : 0;
 	p->expired = 0;
 
 	/* Memory for registers, parameters, cursor, etc, is allocated in one or two
@@ -1539,6 +1625,10 @@ sqlVdbeMakeReady(Vdbe * p,	/* The VDBE */
 		p->aVar = allocSpace(&x, p->aVar, nVar * sizeof(Mem));
 		p->apCsr =
 		    allocSpace(&x, p->apCsr, nCursor * sizeof(VdbeCursor *));
+		if (op_stat_count > 0) {
+			p->op_stat = allocSpace(&x, p->op_stat, op_stat_count *
+						sizeof(struct vdbe_op_stat));
+		}
 		if (x.nNeeded == 0)
 			break;
 		x.pSpace = p->pFree = sqlDbMallocRawNN(db, x.nNeeded);
@@ -2168,6 +2258,7 @@ sqlVdbeClearObject(sql * db, Vdbe * p)
 		sqlDbFree(db, p->pFree);
 	}
 	vdbeFreeOpArray(db, p->aOp, p->nOp);
+	sqlDbFree(db, p->aScan);
 	sqlDbFree(db, p->zSql);
 }
 
@@ -154,6 +154,7 @@
 #include "sqlInt.h"
 #include "mem.h"
 #include "vdbeInt.h"
+#include "coio_task.h"
 
 /*
  * Hard-coded maximum amount of data to accumulate in memory before flushing
@@ -444,6 +445,13 @@ struct SorterRecord {
 /* Maximum number of PMAs that a single MergeEngine can merge */
 #define SORTER_MAX_MERGE_COUNT 16
 
+/*
+ * Lists of records that take less than this many bytes are sorted
+ * in the tx thread. Bigger lists are sorted in a coio worker thread
+ * while the tx fiber yields.
+ */
+#define SORTER_MIN_OFFLOAD_SIZE (1024 * 1024)
+
 static int vdbeIncrSwap(IncrMerger *);
 static void vdbeIncrFree(IncrMerger *);
 
@@ -1174,6 +1182,34 @@ vdbeSorterSort(SortSubtask * pTask, SorterList * pList)
 	return 0;
 }
 
+static ssize_t
+vdbeSorterSortf(va_list ap)
+{
+	SortSubtask *pTask = va_arg(ap, SortSubtask *);
+	SorterList *pList = va_arg(ap, SorterList *);
+	return vdbeSorterSort(pTask, pList);
+}
+
+/*
+ * Same as vdbeSorterSort(), but sort a big list in a coio worker
+ * thread so as not to block the tx thread. Sorting only compares
+ * the records owned by the sorter and uses malloc, so it's safe to
+ * do in another thread. The current fiber yields while waiting,
+ * which is only allowed if the current transaction can yield.
+ */
+static int
+vdbeSorterSortOffload(SortSubtask * pTask, SorterList * pList)
+{
+	struct txn *txn = in_txn();
+	if (pList->szPMA < SORTER_MIN_OFFLOAD_SIZE ||
+	    (txn != NULL && !txn_has_flag(txn, TXN_CAN_YIELD)))
+		return vdbeSorterSort(pTask, pList);
+	/* The record is allocated with the connection lookaside. */
+	if (vdbeSortAllocUnpacked(pTask) != 0)
+		return -1;
+	return coio_call(vdbeSorterSortf, pTask, pList) == 0 ? 0 : -1;
+}
+
 /*
  * Initialize a PMA-writer object.
  */
@@ -1313,7 +1349,7 @@ vdbeSorterListToPMA(SortSubtask * pTask, SorterList * pList)
 
 	/* Sort the list */
 	if (rc == 0)
-		rc = vdbeSorterSort(pTask, pList);
+		rc = vdbeSorterSortOffload(pTask, pList);
 
 	if (rc == 0) {
 		SorterRecord *p;
@@ -2059,7 +2095,8 @@ sqlVdbeSorterRewind(const VdbeCursor * pCsr, int *pbEof)
 	if (pSorter->bUsePMA == 0) {
 		if (pSorter->list.pList) {
 			*pbEof = 0;
-			rc = vdbeSorterSort(&pSorter->aTask, &pSorter->list);
+			rc = vdbeSorterSortOffload(&pSorter->aTask,
+						   &pSorter->list);
 		} else {
 			*pbEof = 1;
 		}
@@ -2869,12 +2869,21 @@ tnt_error:
 
 	/* Automatic indexes */
 	rSize = DEFAULT_TUPLE_LOG_COUNT;
-	/*
-	 * Increase cost of ephemeral index if number of tuples in space is less
-	 * then 10240.
-	 */
-	if (!space->def->opts.is_view && sql_space_tuple_log_count(space) < 133)
-		rSize += DEFAULT_TUPLE_LOG_COUNT;
+	if (!space->def->opts.is_view) {
+		LogEst space_size = sql_space_tuple_log_count(space);
+		/*
+		 * Increase cost of ephemeral index if number of
+		 * tuples in space is less then 10240. Otherwise the
+		 * index costs as much as sorting the whole space,
+		 * which is then compared with the cost of nested
+		 * full scans. This only tunes the cost, the automatic
+		 * index itself is built and used as before.
+		 */
+		if (space_size < 133)
+			rSize += DEFAULT_TUPLE_LOG_COUNT;
+		else
+			rSize = space_size;
+	}
 	LogEst rLogSize = estLog(rSize);
 	if (!pBuilder->pOrSet && /* Not pqart of an OR optimization */
 	    (pWInfo->wctrlFlags & WHERE_OR_SUBCLAUSE) == 0 &&
@@ -4695,11 +4704,27 @@ sqlWhereBegin(Parse * pParse,	/* The parser context */
 			if (db->mallocFailed)
 				goto whereBeginError;
 		}
-		sqlWhereExplainOneScan(pParse, pTabList, pLevel, ii,
+		int addr_explain =
+			sqlWhereExplainOneScan(pParse, pTabList, pLevel, ii,
 					       pLevel->iFrom, wctrlFlags);
 		pLevel->addrBody = sqlVdbeCurrentAddr(v);
 		notReady = sqlWhereCodeOneLoopStart(pWInfo, ii, notReady);
 		pWInfo->iContinue = pLevel->addrCont;
+		if (pParse->explain == 3 && addr_explain != 0) {
+			/*
+			 * Code after the loop start is executed for
+			 * every row that passed the loop constraints.
+			 * Every row read by OP_Next or OP_Prev enters
+			 * the loop at p2. Other loops don't read rows
+			 * by themselves, so count only returned rows.
+			 */
+			int addr_output = sqlVdbeCurrentAddr(v);
+			int addr_visit = addr_output;
+			if (pLevel->op == OP_Next || pLevel->op == OP_Prev)
+				addr_visit = pLevel->p2;
+			sql_vdbe_scan_status(v, addr_explain, addr_visit,
+					     addr_output);
+		}
 	}
 
 	/* Done. */
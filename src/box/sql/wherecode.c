@@ -158,7 +158,7 @@ explainIndexRange(StrAccum * pStr, WhereLoop * pLoop)
 
 /*
  * This function is a no-op unless currently processing an EXPLAIN QUERY PLAN
- * command, or if SQL_DEBUG was
+ * or EXPLAIN ANALYZE command, or if SQL_DEBUG was
  * defined at compile-time. If it is not a no-op, a single OP_Explain opcode
  * is added to the output to describe the table scan strategy in pLevel.
  *
@@ -175,7 +175,7 @@ sqlWhereExplainOneScan(Parse * pParse,	/* Parse context */
 {
 	int ret = 0;
 #if !defined(SQL_DEBUG)
-	if (pParse->explain == 2)
+	if (pParse->explain >= 2)
 #endif
 	{
 		struct SrcList_item *pItem = &pTabList->a[pLevel->iFrom];
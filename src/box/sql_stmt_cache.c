@@ -37,6 +37,7 @@
 #include "info/info.h"
 
 static struct sql_stmt_cache sql_stmt_cache;
+static struct sql_plan_cache sql_plan_cache;
 
 void
 sql_stmt_cache_init(void)
@@ -45,6 +46,14 @@ sql_stmt_cache_init(void)
 	sql_stmt_cache.mem_quota = 0;
 	sql_stmt_cache.mem_used = 0;
 	rlist_create(&sql_stmt_cache.gc_queue);
+
+	sql_plan_cache.hash = mh_strnptr_new();
+	rlist_create(&sql_plan_cache.lru);
+	sql_plan_cache.mem_used = 0;
+	sql_plan_cache.mem_quota = 0;
+	sql_plan_cache.hits = 0;
+	sql_plan_cache.misses = 0;
+	sql_plan_cache.evictions = 0;
 }
 
 void
@@ -59,6 +68,13 @@ sql_stmt_cache_stat(struct info_handler *h)
 		entry_count++;
 	info_append_int(h, "stmt_count", entry_count);
 	info_table_end(h);
+	info_table_begin(h, "plan_cache");
+	info_append_int(h, "size", sql_plan_cache.mem_used);
+	info_append_int(h, "stmt_count", mh_size(sql_plan_cache.hash));
+	info_append_int(h, "hits", sql_plan_cache.hits);
+	info_append_int(h, "misses", sql_plan_cache.misses);
+	info_append_int(h, "evictions", sql_plan_cache.evictions);
+	info_table_end(h);
 	info_end(h);
 }
 
@@ -286,3 +302,108 @@ sql_stmt_cache_set_size(size_t size)
 	sql_stmt_cache.mem_quota = size;
 	return 0;
 }
+
+static size_t
+plan_cache_entry_sizeof(struct sql_stmt *stmt)
+{
+	return sql_stmt_est_size(stmt) + sizeof(struct plan_cache_entry);
+}
+
+/**
+ * Remove an entry from the plan cache and free it. Returns the
+ * statement stored in the entry.
+ */
+static struct sql_stmt *
+plan_cache_delete(struct plan_cache_entry *entry)
+{
+	struct sql_plan_cache *cache = &sql_plan_cache;
+	struct sql_stmt *stmt = entry->stmt;
+	const char *sql_str = sql_stmt_query_str(stmt);
+	mh_int_t i = mh_strnptr_find_inp(cache->hash, sql_str,
+					 strlen(sql_str));
+	assert(i != mh_end(cache->hash));
+	mh_strnptr_del(cache->hash, i, NULL);
+	rlist_del(&entry->in_lru);
+	cache->mem_used -= plan_cache_entry_sizeof(stmt);
+	free(entry);
+	return stmt;
+}
+
+/** Evict least recently used statements until @a size is free. */
+static void
+plan_cache_evict(size_t size)
+{
+	struct sql_plan_cache *cache = &sql_plan_cache;
+	while (cache->mem_used + size > cache->mem_quota &&
+	       !rlist_empty(&cache->lru)) {
+		struct plan_cache_entry *entry =
+			rlist_first_entry(&cache->lru, struct plan_cache_entry,
+					  in_lru);
+		sql_stmt_finalize(plan_cache_delete(entry));
+		cache->evictions++;
+	}
+}
+
+struct sql_stmt *
+sql_plan_cache_take(const char *sql, size_t len, uint32_t sql_flags)
+{
+	struct sql_plan_cache *cache = &sql_plan_cache;
+	if (cache->mem_quota == 0)
+		return NULL;
+	mh_int_t i = mh_strnptr_find_inp(cache->hash, sql, len);
+	if (i == mh_end(cache->hash)) {
+		cache->misses++;
+		return NULL;
+	}
+	struct plan_cache_entry *entry = mh_strnptr_node(cache->hash, i)->val;
+	if (entry->sql_flags != sql_flags) {
+		cache->misses++;
+		return NULL;
+	}
+	cache->hits++;
+	return plan_cache_delete(entry);
+}
+
+void
+sql_plan_cache_put(struct sql_stmt *stmt, uint32_t sql_flags)
+{
+	struct sql_plan_cache *cache = &sql_plan_cache;
+	assert(!sql_stmt_busy(stmt));
+	const char *sql_str = sql_stmt_query_str(stmt);
+	size_t len = strlen(sql_str);
+	mh_int_t i = mh_strnptr_find_inp(cache->hash, sql_str, len);
+	if (i != mh_end(cache->hash)) {
+		/*
+		 * The same query was compiled by a concurrent
+		 * request or with other flags, keep the newest one.
+		 */
+		struct plan_cache_entry *old =
+			mh_strnptr_node(cache->hash, i)->val;
+		sql_stmt_finalize(plan_cache_delete(old));
+	}
+	size_t size = plan_cache_entry_sizeof(stmt);
+	if (size > cache->mem_quota)
+		goto finalize;
+	plan_cache_evict(size);
+	struct plan_cache_entry *entry = malloc(sizeof(*entry));
+	if (entry == NULL)
+		goto finalize;
+	entry->stmt = stmt;
+	entry->sql_flags = sql_flags;
+	struct mh_strnptr_node_t node = {
+		sql_str, len, mh_strn_hash(sql_str, len), entry
+	};
+	mh_strnptr_put(cache->hash, &node, NULL, NULL);
+	rlist_add_tail_entry(&cache->lru, entry, in_lru);
+	cache->mem_used += size;
+	return;
+finalize:
+	sql_stmt_finalize(stmt);
+}
+
+void
+sql_plan_cache_set_size(size_t size)
+{
+	sql_plan_cache.mem_quota = size;
+	plan_cache_evict(0);
+}
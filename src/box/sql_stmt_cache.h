@@ -41,6 +41,7 @@ extern "C" {
 
 struct sql_stmt;
 struct mh_i64ptr_t;
+struct mh_strnptr_t;
 struct info_handler;
 
 struct stmt_cache_entry {
@@ -146,6 +147,61 @@ sql_stmt_cache_find(uint32_t stmt_id);
 int
 sql_stmt_cache_set_size(size_t size);
 
+struct plan_cache_entry {
+	/** Statement compiled from the query text. */
+	struct sql_stmt *stmt;
+	/** Session SQL flags the statement was compiled with. */
+	uint32_t sql_flags;
+	/** Link in sql_plan_cache::lru. */
+	struct rlist in_lru;
+};
+
+/**
+ * Cache of statements executed by their text, without PREPARE.
+ * Unlike prepared statements, they aren't referenced by sessions,
+ * so the least recently used ones are evicted when the cache is
+ * full. A statement is taken out of the cache while it's being
+ * executed, so it's never shared by concurrent requests.
+ */
+struct sql_plan_cache {
+	/** Query text -> struct plan_cache_entry. */
+	struct mh_strnptr_t *hash;
+	/** All entries, the least recently used first. */
+	struct rlist lru;
+	/** Size of memory occupied by cached statements. */
+	size_t mem_used;
+	/** Max memory size that can be used for cache. */
+	size_t mem_quota;
+	/** Number of lookups that found a statement. */
+	uint64_t hits;
+	/** Number of lookups that didn't find a statement. */
+	uint64_t misses;
+	/** Number of statements evicted to free memory. */
+	uint64_t evictions;
+};
+
+/**
+ * Take a statement compiled from @a sql with session SQL flags
+ * @a sql_flags out of the plan cache. The caller owns the
+ * statement and may return it to the cache with
+ * sql_plan_cache_put(). Returns NULL if there's no such statement.
+ */
+struct sql_stmt *
+sql_plan_cache_take(const char *sql, size_t len, uint32_t sql_flags);
+
+/**
+ * Return a reset statement compiled with session SQL flags
+ * @a sql_flags to the plan cache, evicting the least recently
+ * used statements if needed. The statement is finalized if it
+ * doesn't fit in the cache.
+ */
+void
+sql_plan_cache_put(struct sql_stmt *stmt, uint32_t sql_flags);
+
+/** Set plan cache size limit, evicting statements if needed. */
+void
+sql_plan_cache_set_size(size_t size);
+
 #if defined(__cplusplus)
 } /* extern "C" { */
 #endif
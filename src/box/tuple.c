@@ -554,6 +554,17 @@ tuple_raw_multikey_count(struct tuple_format *format, const char *data,
 
 /* }}} tuple_field_* getters */
 
+struct tuple_format *
+runtime_tuple_format_new(struct tuple_dictionary *dict)
+{
+	struct tuple_format *format =
+		tuple_format_new(&tuple_format_runtime_vtab, NULL, NULL, 0,
+				 NULL, 0, 0, dict, false, true);
+	if (format != NULL)
+		tuple_format_ref(format);
+	return format;
+}
+
 /* {{{ box_tuple_* */
 
 box_tuple_format_t *
@@ -568,7 +579,7 @@ box_tuple_format_new(struct key_def **keys, uint16_t key_count)
 	box_tuple_format_t *format =
 		tuple_format_new(&tuple_format_runtime_vtab, NULL,
 				 keys, key_count, NULL, 0, 0, NULL, false,
-				 false);
+				 true);
 	if (format != NULL)
 		tuple_format_ref(format);
 	return format;
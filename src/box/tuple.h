@@ -52,6 +52,17 @@ struct key_part;
  */
 extern struct tuple_format *tuple_format_runtime;
 
+struct tuple_dictionary;
+
+/**
+ * Create a format for standalone tuples allocated on runtime arena
+ * with field names from @a dict, so that fields of a tuple read
+ * from a space can be accessed by name. The format is referenced.
+ * @retval NULL Memory error.
+ */
+struct tuple_format *
+runtime_tuple_format_new(struct tuple_dictionary *dict);
+
 /** Initialize tuple library */
 int
 tuple_init(field_name_hash_f hash);
@@ -299,14 +310,15 @@ box_tuple_validate(box_tuple_t *tuple, box_tuple_format_t *format);
 /**
  * An atom of Tarantool storage. Represents MsgPack Array.
  * Tuple has the following structure:
- *                           uint32       uint32     bsize
- *                          +-------------------+-------------+
- * tuple_begin, ..., raw =  | offN | ... | off1 | MessagePack |
- * |                        +-------------------+-------------+
- * |                                            ^
- * +---------------------------------------data_offset
+ *                                                  bsize
+ *                          +-------------------------+-------------+
+ * tuple_begin, ..., raw =  | offN | ... | off1 | tag | MessagePack |
+ * |                        +-------------------------+-------------+
+ * |                                                  ^
+ * +---------------------------------------------data_offset
  *
- * Each 'off_i' is the offset to the i-th indexed field.
+ * Each 'off_i' is the offset to the i-th indexed field. Offsets are
+ * 1, 2 or 4 bytes wide, as stored in the tag, see field_map.h.
  */
 struct PACKED tuple
 {
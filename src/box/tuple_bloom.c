@@ -70,6 +70,13 @@ tuple_bloom_builder_delete(struct tuple_bloom_builder *builder)
 	free(builder);
 }
 
+void
+tuple_bloom_builder_reset(struct tuple_bloom_builder *builder)
+{
+	for (uint32_t i = 0; i < builder->part_count; i++)
+		builder->parts[i].count = 0;
+}
+
 /**
  * Add a tuple hash to a hash array unless it's already there.
  * Reallocate the array if necessary.
@@ -124,6 +124,15 @@ tuple_bloom_builder_new(uint32_t part_count);
 void
 tuple_bloom_builder_delete(struct tuple_bloom_builder *builder);
 
+/**
+ * Reset a tuple bloom filter builder so that it can be reused
+ * for building another bloom filter. The memory allocated for
+ * hash arrays is retained.
+ * @param builder - bloom filter builder to reset
+ */
+void
+tuple_bloom_builder_reset(struct tuple_bloom_builder *builder);
+
 /**
  * Add a tuple hash to a tuple bloom filter builder.
  * @param builder - bloom filter builder
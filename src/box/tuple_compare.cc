@@ -33,6 +33,7 @@
 #include "tuple.h"
 #include "coll/coll.h"
 #include "trivia/util.h" /* NOINLINE */
+#include "bit/bit.h"
 #include <math.h>
 #include "mp_decimal.h"
 #include "mp_extension_types.h"
@@ -41,6 +42,16 @@
 
 /* {{{ tuple_compare */
 
+/**
+ * The highest bit is set in a hint of a key that has only the first
+ * part of a composite hint, see key_hint_composite(). It's never set
+ * in other hints except HINT_NONE.
+ */
+#define HINT_PREFIX		(1ULL << 63)
+
+static int
+hint_cmp_prefix(hint_t hint_a, hint_t hint_b);
+
 /**
  * Compare two tuple hints.
  *
@@ -55,9 +66,11 @@
 static inline int
 hint_cmp(hint_t hint_a, hint_t hint_b)
 {
-	if (hint_a != HINT_NONE && hint_b != HINT_NONE && hint_a != hint_b)
-		return hint_a < hint_b ? -1 : 1;
-	return 0;
+	if (hint_a == hint_b || hint_a == HINT_NONE || hint_b == HINT_NONE)
+		return 0;
+	if (unlikely(((hint_a | hint_b) & HINT_PREFIX) != 0))
+		return hint_cmp_prefix(hint_a, hint_b);
+	return hint_a < hint_b ? -1 : 1;
 }
 
 /*
@@ -1000,6 +1013,129 @@ tuple_compare_sequential(struct tuple *tuple_a, hint_t tuple_a_hint,
 	return 0;
 }
 
+/**
+ * Load @a len <= 8 bytes starting at @a data into the most
+ * significant bytes of a 64-bit word, so that the first byte
+ * in memory becomes the most significant one. The remaining
+ * bytes are zeroed.
+ */
+static inline uint64_t
+load_u64_prefix(const char *data, uint32_t len)
+{
+	assert(len > 0 && len <= sizeof(uint64_t));
+	uint64_t word = 0;
+	/* Constant-size copies are compiled into plain loads. */
+	switch (len) {
+	case 8: memcpy(&word, data, 8); break;
+	case 7: memcpy(&word, data, 7); break;
+	case 6: memcpy(&word, data, 6); break;
+	case 5: memcpy(&word, data, 5); break;
+	case 4: memcpy(&word, data, 4); break;
+	case 3: memcpy(&word, data, 3); break;
+	case 2: memcpy(&word, data, 2); break;
+	default: memcpy(&word, data, 1); break;
+	}
+#if __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+	word = __builtin_bswap64(word);
+#endif
+	return word;
+}
+
+/**
+ * Compare @a part_count consecutive unsigned fields of two
+ * MsgPack sequences.
+ *
+ * Small unsigned values are encoded as one-byte positive
+ * fixints, and a run of fixint fields compares exactly like
+ * the same run of bytes compared as a big-endian number. So
+ * instead of decoding fields one by one, up to eight fields
+ * are loaded into a single machine word, the fixint prefix
+ * common to both sequences is detected with one mask and is
+ * compared with one integer comparison. A field that doesn't
+ * fit in a fixint falls back to mp_compare_uint().
+ *
+ * Reading never crosses the end of the compared fields: every
+ * field takes at least one byte, so the data is never shorter
+ * than the number of fields left to compare.
+ */
+static inline int
+mp_compare_uint_sequence(const char *data_a, const char *data_b,
+			 uint32_t part_count)
+{
+	while (part_count > 0) {
+		uint32_t len = MIN(part_count, sizeof(uint64_t));
+		uint64_t a = load_u64_prefix(data_a, len);
+		uint64_t b = load_u64_prefix(data_b, len);
+		uint64_t not_fixint = (a | b) & 0x8080808080808080ULL;
+		uint32_t fixint_count = not_fixint == 0 ? len :
+					__builtin_clzll(not_fixint) / 8;
+		if (fixint_count > 0) {
+			uint64_t mask = fixint_count == sizeof(uint64_t) ?
+					UINT64_MAX :
+					~(UINT64_MAX >> (fixint_count * 8));
+			a &= mask;
+			b &= mask;
+			if (a != b)
+				return a < b ? -1 : 1;
+			data_a += fixint_count;
+			data_b += fixint_count;
+			part_count -= fixint_count;
+			if (fixint_count == len)
+				continue;
+		}
+		int rc = mp_compare_uint(data_a, data_b);
+		if (rc != 0)
+			return rc;
+		mp_next(&data_a);
+		mp_next(&data_b);
+		part_count--;
+	}
+	return 0;
+}
+
+/**
+ * Comparator for keys that consist of non-nullable unsigned
+ * parts going in the same order as tuple fields starting with
+ * the first one. See mp_compare_uint_sequence().
+ */
+static int
+tuple_compare_sequential_unsigned(struct tuple *tuple_a, hint_t tuple_a_hint,
+				  struct tuple *tuple_b, hint_t tuple_b_hint,
+				  struct key_def *key_def)
+{
+	assert(key_def_is_sequential(key_def));
+	assert(!key_def->is_nullable && !key_def->has_optional_parts);
+	int rc = hint_cmp(tuple_a_hint, tuple_b_hint);
+	if (rc != 0)
+		return rc;
+	const char *key_a = tuple_data(tuple_a);
+	MAYBE_UNUSED uint32_t fc_a = mp_decode_array(&key_a);
+	const char *key_b = tuple_data(tuple_b);
+	MAYBE_UNUSED uint32_t fc_b = mp_decode_array(&key_b);
+	assert(fc_a >= key_def->part_count);
+	assert(fc_b >= key_def->part_count);
+	return mp_compare_uint_sequence(key_a, key_b, key_def->part_count);
+}
+
+static int
+tuple_compare_with_key_sequential_unsigned(struct tuple *tuple,
+					   hint_t tuple_hint, const char *key,
+					   uint32_t part_count, hint_t key_hint,
+					   struct key_def *key_def)
+{
+	assert(key_def_is_sequential(key_def));
+	assert(!key_def->is_nullable && !key_def->has_optional_parts);
+	assert(part_count <= key_def->part_count);
+	(void)key_def;
+	int rc = hint_cmp(tuple_hint, key_hint);
+	if (rc != 0)
+		return rc;
+	const char *tuple_key = tuple_data(tuple);
+	MAYBE_UNUSED uint32_t field_count = mp_decode_array(&tuple_key);
+	assert(field_count >= part_count);
+	return mp_compare_uint_sequence(tuple_key, key, part_count);
+}
+
 template <int TYPE>
 static inline int
 field_compare(const char **field_a, const char **field_b);
@@ -1472,7 +1608,8 @@ func_index_compare_with_key(struct tuple *tuple, hint_t tuple_hint,
  * For simplicity we construct it using the first key part only;
  * other key parts don't participate in hint construction. As a
  * consequence, tuple hints are useless if the first key part
- * doesn't differ among indexed tuples.
+ * doesn't differ among indexed tuples. An exception is made for
+ * keys whose first part is an integer, see hint_composite().
  *
  * Hint class stores one of mp_class enum values corresponding
  * to the field type. We store it in upper bits of a hint so
@@ -1922,6 +2059,224 @@ field_hint(const char *field, struct coll *coll)
 	return HINT_NONE;
 }
 
+/**
+ * A composite hint is used for keys of two or more parts whose
+ * first part is a non-nullable integer, such as (tenant_id, time).
+ * The first part often has only a few distinct values in such keys,
+ * so a hint built from it alone doesn't help. A composite hint has
+ * the following layout:
+ *
+ *     [ 0 | region |                 value                 ]
+ *      <1> <--2--> <------- HINT_COMPOSITE_VALUE_BITS ------>
+ *
+ * If the first part fits in HINT_COMPOSITE_HEAD_BITS, the region is
+ * HINT_COMPOSITE_EXACT and the value is the first part followed by
+ * the hint of the second part squeezed into HINT_COMPOSITE_TAIL_BITS,
+ * see hint_composite_tail(). Otherwise, the region is
+ * HINT_COMPOSITE_BELOW or HINT_COMPOSITE_ABOVE, and the value is the
+ * distance from the first part to the exact range, saturated, while
+ * the second part doesn't participate in the hint. The regions go in
+ * the order of the first part, so the layout satisfies the hint
+ * property for all integers.
+ *
+ * A key with only one part may be equal to tuples with any second
+ * part, so its hint is built with a zero tail and marked with
+ * HINT_PREFIX. Such a hint is compared with the others by the bits
+ * above the tail only, see hint_cmp_prefix(). They depend only on
+ * the first part, in the exact range and out of it, and go in its
+ * order, so the hint property holds for one-part keys as well.
+ *
+ * The tail is computed from the usual hint of the second part, so
+ * the layout doesn't depend on the type of the second part, and its
+ * type can be altered without rebuilding the index, as with hints of
+ * the first part only.
+ */
+#define HINT_COMPOSITE_VALUE_BITS	(HINT_BITS - 3)
+#define HINT_COMPOSITE_TAIL_BITS	39
+#define HINT_COMPOSITE_HEAD_BITS	(HINT_COMPOSITE_VALUE_BITS - \
+					 HINT_COMPOSITE_TAIL_BITS)
+#define HINT_COMPOSITE_VALUE_MAX \
+	((1ULL << HINT_COMPOSITE_VALUE_BITS) - 1)
+#define HINT_COMPOSITE_HEAD_MAX \
+	((1LL << (HINT_COMPOSITE_HEAD_BITS - 1)) - 1)
+#define HINT_COMPOSITE_HEAD_MIN \
+	(-(1LL << (HINT_COMPOSITE_HEAD_BITS - 1)))
+
+/** Number of bits of a tail value, following the class. */
+#define HINT_COMPOSITE_TAIL_VALUE_BITS \
+	(HINT_COMPOSITE_TAIL_BITS - HINT_CLASS_BITS)
+/**
+ * Number of bits of a number in a tail value that follow its sign
+ * and exponent, see hint_composite_tail_number().
+ */
+#define HINT_COMPOSITE_MANTISSA_BITS	(HINT_COMPOSITE_TAIL_VALUE_BITS - 7)
+
+/** Composite hint regions, in the order of the first key part. */
+enum {
+	HINT_COMPOSITE_BELOW = 0,
+	HINT_COMPOSITE_EXACT = 1,
+	HINT_COMPOSITE_ABOVE = 2,
+};
+
+static inline hint_t
+hint_composite_create(uint64_t region, uint64_t val)
+{
+	assert((val >> HINT_COMPOSITE_VALUE_BITS) == 0);
+	return (hint_t)((region << HINT_COMPOSITE_VALUE_BITS) | val);
+}
+
+/**
+ * Compute a composite hint from the first key part, which must be
+ * an integer, and the tail computed from the second key part.
+ */
+static inline hint_t
+hint_composite(const char *head, uint64_t tail)
+{
+	assert((tail >> HINT_COMPOSITE_TAIL_BITS) == 0);
+	int64_t val;
+	if (mp_typeof(*head) == MP_UINT) {
+		uint64_t u = mp_decode_uint(&head);
+		if (u > (uint64_t)HINT_COMPOSITE_HEAD_MAX) {
+			u -= HINT_COMPOSITE_HEAD_MAX + 1;
+			return hint_composite_create(
+				HINT_COMPOSITE_ABOVE,
+				MIN(u, HINT_COMPOSITE_VALUE_MAX));
+		}
+		val = u;
+	} else {
+		val = mp_decode_int(&head);
+		if (val > HINT_COMPOSITE_HEAD_MAX) {
+			uint64_t u = val - HINT_COMPOSITE_HEAD_MAX - 1;
+			return hint_composite_create(
+				HINT_COMPOSITE_ABOVE,
+				MIN(u, HINT_COMPOSITE_VALUE_MAX));
+		}
+	}
+	if (val < HINT_COMPOSITE_HEAD_MIN) {
+		uint64_t u = (HINT_COMPOSITE_HEAD_MIN - 1) - val;
+		return hint_composite_create(
+			HINT_COMPOSITE_BELOW,
+			HINT_COMPOSITE_VALUE_MAX -
+			MIN(u, HINT_COMPOSITE_VALUE_MAX));
+	}
+	uint64_t head_val = val - HINT_COMPOSITE_HEAD_MIN;
+	head_val <<= HINT_COMPOSITE_TAIL_BITS;
+	return hint_composite_create(HINT_COMPOSITE_EXACT, head_val | tail);
+}
+
+/**
+ * Compare two composite hints, one of which is marked with
+ * HINT_PREFIX, by the bits above the tail.
+ */
+static int
+hint_cmp_prefix(hint_t hint_a, hint_t hint_b)
+{
+	uint64_t head_a = (hint_a & ~HINT_PREFIX) >> HINT_COMPOSITE_TAIL_BITS;
+	uint64_t head_b = (hint_b & ~HINT_PREFIX) >> HINT_COMPOSITE_TAIL_BITS;
+	if (head_a != head_b)
+		return head_a < head_b ? -1 : 1;
+	return 0;
+}
+
+/**
+ * Squeeze the value of a number hint into a tail value. The value
+ * is the integral part of the number, see hint_uint(). It's encoded
+ * as a floating point number: a sign bit, 6 bits of exponent and
+ * HINT_COMPOSITE_MANTISSA_BITS of mantissa, so small numbers are
+ * stored exactly, and large ones, such as timestamps, are stored
+ * with a relative precision of 2^-28.
+ */
+static inline uint64_t
+hint_composite_tail_number(uint64_t val)
+{
+	int64_t num = (int64_t)val + HINT_VALUE_INT_MIN;
+	uint64_t u = num < 0 ? -(uint64_t)num : (uint64_t)num;
+	uint64_t mag = 0;
+	if (u != 0) {
+		/* Position of the highest bit, at most 60. */
+		int exp = 64 - bit_clz_u64(u);
+		u &= ~(1ULL << (exp - 1));
+		int shift = exp - 1 - HINT_COMPOSITE_MANTISSA_BITS;
+		uint64_t mant = shift >= 0 ? u >> shift : u << -shift;
+		mag = ((uint64_t)exp << HINT_COMPOSITE_MANTISSA_BITS) | mant;
+	}
+	uint64_t sign = 1ULL << (HINT_COMPOSITE_MANTISSA_BITS + 6);
+	return num < 0 ? sign - 1 - mag : sign | mag;
+}
+
+/**
+ * Squeeze a hint of the second key part into HINT_COMPOSITE_TAIL_BITS
+ * preserving the order. The class is kept as is. Number values are
+ * mapped with hint_composite_tail_number(), which keeps more precision
+ * for numbers that are much less than the hint value range. For other
+ * classes, the higher bits of the value are taken.
+ */
+static inline uint64_t
+hint_composite_tail(hint_t hint)
+{
+	assert(hint != HINT_NONE);
+	uint64_t c = hint >> HINT_VALUE_BITS;
+	uint64_t val = hint & HINT_VALUE_MAX;
+	if (c == MP_CLASS_NUMBER)
+		val = hint_composite_tail_number(val);
+	else
+		val >>= HINT_VALUE_BITS - HINT_COMPOSITE_TAIL_VALUE_BITS;
+	return (c << HINT_COMPOSITE_TAIL_VALUE_BITS) | val;
+}
+
+/**
+ * Compute the tail of a composite hint from the second key part.
+ * Returns HINT_NONE if the field has no hint.
+ */
+template <enum field_type type, bool is_nullable>
+static inline uint64_t
+field_hint_composite_tail(const char *field, struct coll *coll)
+{
+	if (is_nullable && field == NULL)
+		return hint_composite_tail(hint_nil());
+	hint_t hint = field_hint<type, is_nullable>(field, coll);
+	if (hint == HINT_NONE)
+		return HINT_NONE;
+	return hint_composite_tail(hint);
+}
+
+template <enum field_type type, bool is_nullable>
+static hint_t
+key_hint_composite(const char *key, uint32_t part_count,
+		   struct key_def *key_def)
+{
+	assert(!key_def->is_multikey);
+	assert(key_def->part_count >= 2);
+	if (part_count == 0)
+		return HINT_NONE;
+	if (part_count == 1)
+		return hint_composite(key, 0) | HINT_PREFIX;
+	const char *head = key;
+	mp_next(&key);
+	uint64_t tail = field_hint_composite_tail<type, is_nullable>(
+		key, key_def->parts[1].coll);
+	if (tail == HINT_NONE)
+		return HINT_NONE;
+	return hint_composite(head, tail);
+}
+
+template <enum field_type type, bool is_nullable>
+static hint_t
+tuple_hint_composite(struct tuple *tuple, struct key_def *key_def)
+{
+	assert(!key_def->is_multikey);
+	assert(key_def->part_count >= 2);
+	const char *head = tuple_field_by_part(tuple, &key_def->parts[0],
+					       MULTIKEY_NONE);
+	const char *field = tuple_field_by_part(tuple, &key_def->parts[1],
+						MULTIKEY_NONE);
+	uint64_t tail = field_hint_composite_tail<type, is_nullable>(
+		field, key_def->parts[1].coll);
+	if (tail == HINT_NONE)
+		return HINT_NONE;
+	return hint_composite(head, tail);
+}
+
 template <enum field_type type, bool is_nullable>
 static hint_t
 key_hint(const char *key, uint32_t part_count, struct key_def *key_def)
@@ -1991,13 +2346,124 @@ key_def_set_hint_func(struct key_def *def)
 		key_def_set_hint_func<type, false>(def);
 }
 
+template<enum field_type type, bool is_nullable>
+static void
+key_def_set_composite_hint_func(struct key_def *def)
+{
+	def->key_hint = key_hint_composite<type, is_nullable>;
+	def->tuple_hint = tuple_hint_composite<type, is_nullable>;
+}
+
+template<enum field_type type>
+static void
+key_def_set_composite_hint_func(struct key_def *def)
+{
+	if (key_part_is_nullable(&def->parts[1]))
+		key_def_set_composite_hint_func<type, true>(def);
+	else
+		key_def_set_composite_hint_func<type, false>(def);
+}
+
+/** Hint layouts, see key_def_hints_are_compatible(). */
+enum hint_layout {
+	/** Multikey and functional indexes. */
+	HINT_LAYOUT_STUB,
+	/** A hint of the first key part. */
+	HINT_LAYOUT_FIRST_PART,
+	/** A composite hint, see hint_composite(). */
+	HINT_LAYOUT_COMPOSITE,
+};
+
+static enum hint_layout
+key_def_hint_layout(const struct key_def *def)
+{
+	if (def->is_multikey || def->for_func_index)
+		return HINT_LAYOUT_STUB;
+	if (def->part_count < 2 || key_part_is_nullable(&def->parts[0]))
+		return HINT_LAYOUT_FIRST_PART;
+	if (def->parts[0].type != FIELD_TYPE_UNSIGNED &&
+	    def->parts[0].type != FIELD_TYPE_INTEGER)
+		return HINT_LAYOUT_FIRST_PART;
+	switch (def->parts[1].type) {
+	case FIELD_TYPE_BOOLEAN:
+	case FIELD_TYPE_UNSIGNED:
+	case FIELD_TYPE_INTEGER:
+	case FIELD_TYPE_NUMBER:
+	case FIELD_TYPE_DOUBLE:
+	case FIELD_TYPE_STRING:
+	case FIELD_TYPE_VARBINARY:
+	case FIELD_TYPE_SCALAR:
+	case FIELD_TYPE_DECIMAL:
+	case FIELD_TYPE_UUID:
+	case FIELD_TYPE_DATETIME:
+		return HINT_LAYOUT_COMPOSITE;
+	default:
+		return HINT_LAYOUT_FIRST_PART;
+	}
+}
+
+bool
+key_def_hints_are_compatible(const struct key_def *def1,
+			     const struct key_def *def2)
+{
+	return key_def_hint_layout(def1) == key_def_hint_layout(def2);
+}
+
+static void
+key_def_set_composite_hint_func(struct key_def *def)
+{
+	switch (def->parts[1].type) {
+	case FIELD_TYPE_BOOLEAN:
+		key_def_set_composite_hint_func<FIELD_TYPE_BOOLEAN>(def);
+		break;
+	case FIELD_TYPE_UNSIGNED:
+		key_def_set_composite_hint_func<FIELD_TYPE_UNSIGNED>(def);
+		break;
+	case FIELD_TYPE_INTEGER:
+		key_def_set_composite_hint_func<FIELD_TYPE_INTEGER>(def);
+		break;
+	case FIELD_TYPE_NUMBER:
+		key_def_set_composite_hint_func<FIELD_TYPE_NUMBER>(def);
+		break;
+	case FIELD_TYPE_DOUBLE:
+		key_def_set_composite_hint_func<FIELD_TYPE_DOUBLE>(def);
+		break;
+	case FIELD_TYPE_STRING:
+		key_def_set_composite_hint_func<FIELD_TYPE_STRING>(def);
+		break;
+	case FIELD_TYPE_VARBINARY:
+		key_def_set_composite_hint_func<FIELD_TYPE_VARBINARY>(def);
+		break;
+	case FIELD_TYPE_SCALAR:
+		key_def_set_composite_hint_func<FIELD_TYPE_SCALAR>(def);
+		break;
+	case FIELD_TYPE_DECIMAL:
+		key_def_set_composite_hint_func<FIELD_TYPE_DECIMAL>(def);
+		break;
+	case FIELD_TYPE_UUID:
+		key_def_set_composite_hint_func<FIELD_TYPE_UUID>(def);
+		break;
+	case FIELD_TYPE_DATETIME:
+		key_def_set_composite_hint_func<FIELD_TYPE_DATETIME>(def);
+		break;
+	default:
+		unreachable();
+	}
+}
+
 static void
 key_def_set_hint_func(struct key_def *def)
 {
-	if (def->is_multikey || def->for_func_index) {
+	switch (key_def_hint_layout(def)) {
+	case HINT_LAYOUT_STUB:
 		def->key_hint = key_hint_stub;
 		def->tuple_hint = key_hint_stub;
 		return;
+	case HINT_LAYOUT_COMPOSITE:
+		key_def_set_composite_hint_func(def);
+		return;
+	case HINT_LAYOUT_FIRST_PART:
+		break;
 	}
 	switch (def->parts->type) {
 	case FIELD_TYPE_BOOLEAN:
@@ -2082,6 +2548,23 @@ key_def_set_compare_func_fast(struct key_def *def)
 			break;
 		}
 	}
+	/*
+	 * Multipart sequential keys of unsigned fields are better
+	 * served by the word-at-a-time comparator than by the
+	 * pre-compiled ones: single-part keys are already covered
+	 * by hints.
+	 */
+	if (is_sequential && def->part_count > 1) {
+		uint32_t i = 0;
+		for (; i < def->part_count; i++) {
+			if (def->parts[i].type != FIELD_TYPE_UNSIGNED)
+				break;
+		}
+		if (i == def->part_count) {
+			cmp = tuple_compare_sequential_unsigned;
+			cmp_wk = tuple_compare_with_key_sequential_unsigned;
+		}
+	}
 	if (cmp == NULL) {
 		cmp = is_sequential ?
 			tuple_compare_sequential<false, false> :
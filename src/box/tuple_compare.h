@@ -30,6 +30,7 @@
  * THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
  * SUCH DAMAGE.
  */
+#include <stdbool.h>
 #include <stdint.h>
 
 #if defined(__cplusplus)
@@ -76,6 +77,16 @@ typedef uint64_t hint_t;
 void
 key_def_set_compare_func(struct key_def *def);
 
+/**
+ * Return true if comparison hints computed with @a def1 are the
+ * same as computed with @a def2 for any tuple and key that fit
+ * both definitions, so an index can switch between them without
+ * rebuild.
+ */
+bool
+key_def_hints_are_compatible(const struct key_def *def1,
+			     const struct key_def *def2);
+
 #if defined(__cplusplus)
 } /* extern "C" */
 #endif /* defined(__cplusplus) */
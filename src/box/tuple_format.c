@@ -34,6 +34,7 @@
 #include "tuple_format.h"
 #include "coll_id_cache.h"
 #include "tt_static.h"
+#include "info/info.h"
 
 #include <PMurHash.h>
 
@@ -44,6 +45,27 @@ static intptr_t recycled_format_ids = FORMAT_ID_NIL;
 static uint32_t formats_size = 0, formats_capacity = 0;
 static uint64_t formats_epoch = 0;
 
+enum {
+	/**
+	 * Max number of unreferenced runtime formats kept for
+	 * reuse.
+	 */
+	TUPLE_FORMAT_CACHE_SIZE = 64,
+};
+
+/**
+ * Unreferenced reusable runtime formats, the least recently
+ * used first. Lua code and mergers often create equal formats
+ * for a short time: caching them saves format registration and
+ * keeps format ids stable.
+ */
+static RLIST_HEAD(tuple_format_cache);
+static uint32_t tuple_format_cache_count = 0;
+/** The number of registered formats. */
+static uint32_t tuple_format_count = 0;
+/** The number of times an existing format was reused. */
+static uint64_t tuple_format_reuse_count = 0;
+
 /**
  * Find in format1::fields the field by format2_field's JSON path.
  * Routine uses fiber region for temporal path allocation and
@@ -77,6 +99,13 @@ tuple_format_cmp(const struct tuple_format *format1,
 {
 	struct tuple_format *a = (struct tuple_format *)format1;
 	struct tuple_format *b = (struct tuple_format *)format2;
+	if (a->engine != b->engine)
+		return a->engine < b->engine ? -1 : 1;
+	int rc = memcmp(&a->vtab, &b->vtab, sizeof(a->vtab));
+	if (rc != 0)
+		return rc;
+	if (a->is_temporary != b->is_temporary)
+		return (int)a->is_temporary - (int)b->is_temporary;
 	if (a->exact_field_count != b->exact_field_count)
 		return a->exact_field_count - b->exact_field_count;
 	if (a->total_field_count != b->total_field_count)
@@ -553,9 +582,27 @@ out:
 	return 0;
 }
 
+/** The max number of registered formats. */
+static uint32_t
+tuple_format_count_max(void)
+{
+	struct errinj *inj = errinj(ERRINJ_TUPLE_FORMAT_COUNT, ERRINJ_INT);
+	if (inj != NULL && inj->iparam > 0)
+		return inj->iparam;
+	return FORMAT_ID_MAX + 1;
+}
+
+static void
+tuple_format_cache_evict(void);
+
 static int
 tuple_format_register(struct tuple_format *format)
 {
+	/* Cached formats must not make the format limit lower. */
+	if (recycled_format_ids == FORMAT_ID_NIL &&
+	    formats_size >= tuple_format_count_max() &&
+	    tuple_format_cache_count > 0)
+		tuple_format_cache_evict();
 	if (recycled_format_ids != FORMAT_ID_NIL) {
 
 		format->id = (uint16_t) recycled_format_ids;
@@ -578,12 +625,7 @@ tuple_format_register(struct tuple_format *format)
 			formats_capacity = new_capacity;
 			tuple_formats = formats;
 		}
-		uint32_t formats_size_max = FORMAT_ID_MAX + 1;
-		struct errinj *inj = errinj(ERRINJ_TUPLE_FORMAT_COUNT,
-					    ERRINJ_INT);
-		if (inj != NULL && inj->iparam > 0)
-			formats_size_max = inj->iparam;
-		if (formats_size >= formats_size_max) {
+		if (formats_size >= tuple_format_count_max()) {
 			diag_set(ClientError, ER_TUPLE_FORMAT_LIMIT,
 				 (unsigned) formats_capacity);
 			return -1;
@@ -591,6 +633,7 @@ tuple_format_register(struct tuple_format *format)
 		format->id = formats_size++;
 	}
 	tuple_formats[format->id] = format;
+	tuple_format_count++;
 	return 0;
 }
 
@@ -602,6 +645,7 @@ tuple_format_deregister(struct tuple_format *format)
 	tuple_formats[format->id] = (struct tuple_format *) recycled_format_ids;
 	recycled_format_ids = format->id;
 	format->id = FORMAT_ID_NIL;
+	tuple_format_count--;
 }
 
 /*
@@ -680,6 +724,7 @@ tuple_format_alloc(struct key_def * const *keys, uint16_t key_count,
 	format->refs = 0;
 	format->id = FORMAT_ID_NIL;
 	format->index_field_count = index_field_count;
+	rlist_create(&format->in_cache);
 	format->exact_field_count = 0;
 	format->min_field_count = 0;
 	format->epoch = 0;
@@ -720,7 +765,14 @@ tuple_format_reuse(struct tuple_format **p_format)
 			tuple_formats_hash, key);
 		tuple_format_destroy(format);
 		free(format);
-		*p_format = *entry;
+		format = *entry;
+		if (!rlist_empty(&format->in_cache)) {
+			assert(format->refs == 0);
+			rlist_del(&format->in_cache);
+			tuple_format_cache_count--;
+		}
+		tuple_format_reuse_count++;
+		*p_format = format;
 		return true;
 	}
 	return false;
@@ -745,8 +797,9 @@ tuple_format_remove_from_hash(struct tuple_format *format)
 		mh_tuple_format_del(tuple_formats_hash, key, NULL);
 }
 
-void
-tuple_format_delete(struct tuple_format *format)
+/** Unregister and free a format. */
+static void
+tuple_format_do_delete(struct tuple_format *format)
 {
 	tuple_format_remove_from_hash(format);
 	tuple_format_deregister(format);
@@ -754,6 +807,38 @@ tuple_format_delete(struct tuple_format *format)
 	free(format);
 }
 
+/** Delete the least recently used cached format. */
+static void
+tuple_format_cache_evict(void)
+{
+	assert(tuple_format_cache_count > 0);
+	struct tuple_format *format = rlist_shift_entry(&tuple_format_cache,
+							struct tuple_format,
+							in_cache);
+	tuple_format_cache_count--;
+	tuple_format_do_delete(format);
+}
+
+void
+tuple_format_delete(struct tuple_format *format)
+{
+	assert(format->refs == 0);
+	/*
+	 * Only runtime formats, which don't belong to any engine,
+	 * are cached: they are the ones created on the fly by Lua
+	 * code and mergers.
+	 */
+	if (!format->is_reusable || format->engine != NULL ||
+	    format->id == FORMAT_ID_NIL) {
+		tuple_format_do_delete(format);
+		return;
+	}
+	assert(rlist_empty(&format->in_cache));
+	rlist_add_tail_entry(&tuple_format_cache, format, in_cache);
+	if (++tuple_format_cache_count > TUPLE_FORMAT_CACHE_SIZE)
+		tuple_format_cache_evict();
+}
+
 struct tuple_format *
 tuple_format_new(struct tuple_format_vtab *vtab, void *engine,
 		 struct key_def * const *keys, uint16_t key_count,
@@ -992,6 +1077,18 @@ tuple_format_free()
 	}
 	free(tuple_formats);
 	mh_tuple_format_delete(tuple_formats_hash);
+	rlist_create(&tuple_format_cache);
+	tuple_format_cache_count = 0;
+}
+
+void
+tuple_format_stat(struct info_handler *h)
+{
+	info_begin(h);
+	info_append_int(h, "count", tuple_format_count);
+	info_append_int(h, "cached", tuple_format_cache_count);
+	info_append_int(h, "reused", tuple_format_reuse_count);
+	info_end(h);
 }
 
 void
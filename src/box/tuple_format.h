@@ -37,6 +37,7 @@
 #include "json/json.h"
 #include "tuple_dictionary.h"
 #include "field_map.h"
+#include <small/rlist.h>
 
 #if defined(__cplusplus)
 extern "C" {
@@ -196,6 +197,12 @@ struct tuple_format {
 	 * those are never altered. We can also reuse formats exported to Lua.
 	 */
 	bool is_reusable;
+	/**
+	 * Link in the list of unreferenced runtime formats kept for
+	 * reuse, see tuple_format_delete(). Empty if the format is
+	 * referenced or isn't cached.
+	 */
+	struct rlist in_cache;
 	/**
 	 * Size of minimal field map of tuple where each indexed
 	 * field has own offset slot (in bytes). The real tuple
@@ -305,7 +312,12 @@ tuple_format_by_id(uint32_t tuple_format_id)
 	return tuple_formats[tuple_format_id];
 }
 
-/** Delete a format with zero ref count. */
+/**
+ * Delete a format with zero ref count. A reusable runtime format
+ * is not deleted at once: it is kept in a cache of limited size
+ * so that creating an equal format again just takes it from
+ * there.
+ */
 void
 tuple_format_delete(struct tuple_format *format);
 
@@ -438,6 +450,15 @@ tuple_field_map_create(struct tuple_format *format, const char *tuple,
 void
 tuple_format_init();
 
+struct info_handler;
+
+/**
+ * Report statistics of tuple formats: the number of registered
+ * formats, the number of cached unreferenced ones and how many
+ * times a new format was replaced with an existing one.
+ */
+void
+tuple_format_stat(struct info_handler *h);
 
 /** Tuple format iterator flags to configure parse mode. */
 enum {
@@ -183,6 +183,41 @@ struct TupleHash<FIELD_TYPE_UNSIGNED> {
 	}
 };
 
+/**
+ * Integer fields are hashed with their MsgPack headers, so sequential
+ * integer fields are hashed as one span of MsgPack. PMurHash32 is a
+ * stream hash, so it gives the same value as hashing the fields one
+ * by one, which matters for hashes stored on disk.
+ */
+static inline uint32_t
+integer_span_hash(const char *field, uint32_t part_count)
+{
+	const char *end = field;
+	for (uint32_t i = 0; i < part_count; i++)
+		mp_next(&end);
+	uint32_t size = end - field;
+	assert(size < INT32_MAX);
+	uint32_t h = HASH_SEED;
+	uint32_t carry = 0;
+	PMurHash32_Process(&h, &carry, field, size);
+	return PMurHash32_Result(h, carry, size);
+}
+
+static uint32_t
+key_hash_integer_span(const char *key, struct key_def *key_def)
+{
+	return integer_span_hash(key, key_def->part_count);
+}
+
+static uint32_t
+tuple_hash_integer_span(struct tuple *tuple, struct key_def *key_def)
+{
+	assert(!key_def->is_multikey);
+	const char *field = tuple_field_by_part(tuple, key_def->parts,
+						MULTIKEY_NONE);
+	return integer_span_hash(field, key_def->part_count);
+}
+
 }; /* namespace { */
 
 #define HASHER(...) \
@@ -197,15 +232,14 @@ struct hasher_signature {
 
 /**
  * field1 type,  field2 type, ...
+ * Keys of integers only are hashed by integer_span_hash().
  */
 static const hasher_signature hash_arr[] = {
 	HASHER(FIELD_TYPE_UNSIGNED)
 	HASHER(FIELD_TYPE_STRING)
-	HASHER(FIELD_TYPE_UNSIGNED, FIELD_TYPE_UNSIGNED)
 	HASHER(FIELD_TYPE_STRING  , FIELD_TYPE_UNSIGNED)
 	HASHER(FIELD_TYPE_UNSIGNED, FIELD_TYPE_STRING)
 	HASHER(FIELD_TYPE_STRING  , FIELD_TYPE_STRING)
-	HASHER(FIELD_TYPE_UNSIGNED, FIELD_TYPE_UNSIGNED, FIELD_TYPE_UNSIGNED)
 	HASHER(FIELD_TYPE_STRING  , FIELD_TYPE_UNSIGNED, FIELD_TYPE_UNSIGNED)
 	HASHER(FIELD_TYPE_UNSIGNED, FIELD_TYPE_STRING  , FIELD_TYPE_UNSIGNED)
 	HASHER(FIELD_TYPE_STRING  , FIELD_TYPE_STRING  , FIELD_TYPE_UNSIGNED)
@@ -224,6 +258,25 @@ tuple_hash_slowpath(struct tuple *tuple, struct key_def *key_def);
 uint32_t
 key_hash_slowpath(const char *key, struct key_def *key_def);
 
+/**
+ * Check if all parts of a sequential key are integers, so the key
+ * can be hashed with integer_span_hash(). A single unsigned part
+ * has a faster hasher, which doesn't use PMurHash32 at all.
+ */
+static bool
+key_def_is_integer_span(const struct key_def *key_def)
+{
+	if (key_def->part_count == 1 &&
+	    key_def->parts[0].type == FIELD_TYPE_UNSIGNED)
+		return false;
+	for (uint32_t i = 0; i < key_def->part_count; i++) {
+		if (key_def->parts[i].type != FIELD_TYPE_UNSIGNED &&
+		    key_def->parts[i].type != FIELD_TYPE_INTEGER)
+			return false;
+	}
+	return true;
+}
+
 void
 key_def_set_hash_func(struct key_def *key_def) {
 	if (key_def->is_nullable || key_def->has_json_paths)
@@ -241,6 +294,11 @@ key_def_set_hash_func(struct key_def *key_def) {
 		/* Precalculated comparators don't use collation */
 		goto slowpath;
 	}
+	if (key_def_is_integer_span(key_def)) {
+		key_def->tuple_hash = tuple_hash_integer_span;
+		key_def->key_hash = key_hash_integer_span;
+		return;
+	}
 	/*
 	 * Try to find pre-generated tuple_hash() and key_hash()
 	 * implementations
@@ -39,12 +39,22 @@
 #include "errinj.h"
 #include "iproto_constants.h"
 #include "box.h"
+#include "session.h"
+#include "clock.h"
+#include "probe.h"
 
 double too_long_threshold;
 
 /** Last prepare-sequence-number that was assigned to prepared TX. */
 int64_t txn_last_psn = 0;
 
+uint64_t txn_data_generation = 0;
+
+const char *txn_isolation_level_strs[] = {
+	/* [TXN_ISOLATION_DEFAULT] = */ "default",
+	/* [TXN_ISOLATION_READ_ONLY_SNAPSHOT] = */ "read-only-snapshot",
+};
+
 /* Txn cache. */
 static struct stailq txn_cache = {NULL, &txn_cache.first};
 
@@ -117,9 +127,36 @@ txn_add_redo(struct txn *txn, struct txn_stmt *stmt, struct request *request)
 	 */
 	struct space *space = stmt->space;
 	row->group_id = space != NULL ? space_group_id(space) : 0;
-	row->bodycnt = xrow_encode_dml(request, &txn->region, row->body);
-	if (row->bodycnt < 0)
-		return -1;
+	if (request->header != NULL && request->header->replica_id != 0 &&
+	    request->header->bodycnt == 1 && !request->has_extra_keys) {
+		/*
+		 * The request came from a remote master or a WAL:
+		 * client requests have no header, iproto drops it. Any
+		 * change to the request either rebuilds the header body
+		 * or clears the header (see request_update_header()),
+		 * so the body still matches the request. Write it as
+		 * is rather than encode it again: this saves the work
+		 * on cascading replicas and keeps the rows relayed
+		 * downstream byte-identical to the ones received. A
+		 * body with keys the request doesn't use is encoded
+		 * again to not persist them.
+		 */
+		size_t len = request->header->body[0].iov_len;
+		void *body = region_alloc(&txn->region, len);
+		if (body == NULL) {
+			diag_set(OutOfMemory, len, "region_alloc", "body");
+			return -1;
+		}
+		memcpy(body, request->header->body[0].iov_base, len);
+		row->body[0].iov_base = body;
+		row->body[0].iov_len = len;
+		row->bodycnt = 1;
+	} else {
+		row->bodycnt = xrow_encode_dml(request, &txn->region,
+					       row->body);
+		if (row->bodycnt < 0)
+			return -1;
+	}
 	stmt->row = row;
 	return 0;
 }
@@ -177,6 +214,7 @@ txn_stmt_destroy(struct txn_stmt *stmt)
 static void
 txn_rollback_one_stmt(struct txn *txn, struct txn_stmt *stmt)
 {
+	++txn_data_generation;
 	if (txn->engine != NULL && stmt->space != NULL)
 		engine_rollback_statement(txn->engine, txn, stmt);
 	if (stmt->has_triggers && trigger_run(&stmt->on_rollback, txn) != 0) {
@@ -341,6 +379,8 @@ txn_begin(void)
 	rlist_create(&txn->savepoints);
 	memtx_tx_register_tx(txn);
 	txn->fiber = NULL;
+	struct session *session = fiber_get_session(fiber());
+	txn->session_id = session != NULL ? session->id : 0;
 	txn->timeout = TIMEOUT_INFINITY;
 	txn->rollback_timer = NULL;
 	fiber_set_txn(fiber(), txn);
@@ -389,6 +429,12 @@ txn_begin_stmt(struct txn *txn, struct space *space, uint16_t type)
 	if (txn_check_can_continue(txn) != 0)
 		return -1;
 
+	if (txn_has_flag(txn, TXN_IS_READ_ONLY_SNAPSHOT)) {
+		diag_set(ClientError, ER_UNSUPPORTED,
+			 "Read-only snapshot transaction", "writes");
+		return -1;
+	}
+
 	struct txn_stmt *stmt = txn_stmt_new(&txn->region);
 	if (stmt == NULL)
 		return -1;
@@ -441,6 +487,7 @@ txn_commit_stmt(struct txn *txn, struct request *request)
 	 * of tuples in the trigger.
 	 */
 	struct txn_stmt *stmt = txn_current_stmt(txn);
+	++txn_data_generation;
 
 	/*
 	 * Create WAL record for the write requests in
@@ -564,6 +611,8 @@ txn_complete_success(struct txn *txn)
 	assert(!txn_has_flag(txn, TXN_WAIT_SYNC));
 	assert(txn->signature >= 0);
 	txn->status = TXN_COMMITTED;
+	if (!stailq_empty(&txn->stmts))
+		++txn_data_generation;
 	if (txn->engine != NULL)
 		engine_commit(txn->engine, txn);
 	if (txn_has_flag(txn, TXN_HAS_TRIGGERS)) {
@@ -917,6 +966,7 @@ txn_commit(struct txn *txn)
 	struct txn_limbo_entry *limbo_entry = NULL;
 
 	txn->fiber = fiber();
+	PROBE1(txn_commit_start, txn->id);
 
 	if (txn_prepare(txn) != 0)
 		goto rollback_abort;
@@ -954,8 +1004,11 @@ txn_commit(struct txn *txn)
 	}
 
 	fiber_set_txn(fiber(), NULL);
+	double start = clock_monotonic();
 	if (journal_write(req) != 0)
 		goto rollback_io;
+	double end = clock_monotonic();
+	fiber()->storage.net.wal_wait += end - start;
 	if (req->res < 0) {
 		diag_set_journal_res(req->res);
 		goto rollback_io;
@@ -973,12 +1026,15 @@ txn_commit(struct txn *txn)
 			/* Local WAL write is a first 'ACK'. */
 			txn_limbo_ack(&txn_limbo, txn_limbo.owner_id, lsn);
 		}
-		if (txn_limbo_wait_complete(&txn_limbo, limbo_entry) < 0)
+		int rc = txn_limbo_wait_complete(&txn_limbo, limbo_entry);
+		fiber()->storage.net.limbo_wait += clock_monotonic() - end;
+		if (rc < 0)
 			goto rollback;
 	}
 	assert(txn_has_flag(txn, TXN_IS_DONE));
 	assert(txn->signature >= 0);
 
+	PROBE2(txn_commit_done, txn->id, txn->signature);
 	/* Synchronous transactions are freed by the calling fiber. */
 	txn_free(txn);
 	return 0;
@@ -1161,6 +1217,37 @@ box_txn_set_timeout(double timeout)
 	return 0;
 }
 
+int
+box_txn_set_isolation(uint32_t level)
+{
+	if (level >= txn_isolation_level_MAX) {
+		diag_set(ClientError, ER_ILLEGAL_PARAMS,
+			 "unknown isolation level");
+		return -1;
+	}
+	struct txn *txn = in_txn();
+	if (txn == NULL) {
+		diag_set(ClientError, ER_NO_TRANSACTION);
+		return -1;
+	}
+	/* The level can be set only once, before the first statement. */
+	if (!stailq_empty(&txn->stmts) || txn->engine != NULL ||
+	    txn_has_flag(txn, TXN_IS_READ_ONLY_SNAPSHOT)) {
+		diag_set(ClientError, ER_ACTIVE_TRANSACTION);
+		return -1;
+	}
+	if (level == TXN_ISOLATION_READ_ONLY_SNAPSHOT) {
+		txn_set_flags(txn, TXN_IS_READ_ONLY_SNAPSHOT);
+		/*
+		 * Reads of the transaction are never checked for
+		 * conflicts, so it doesn't need to track them:
+		 * enter a read view right away.
+		 */
+		memtx_tx_open_read_view(txn);
+	}
+	return 0;
+}
+
 struct txn_savepoint *
 txn_savepoint_new(struct txn *txn, const char *name)
 {
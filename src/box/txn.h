@@ -48,6 +48,12 @@ extern struct rmean *rmean_box;
 /** Last prepare-sequence-number that was assigned to prepared TX. */
 extern int64_t txn_last_psn;
 
+/**
+ * Incremented whenever data visible to readers may change: on
+ * every statement, its rollback and transaction completion.
+ */
+extern uint64_t txn_data_generation;
+
 struct journal_entry;
 struct engine;
 struct space;
@@ -101,8 +107,29 @@ enum txn_flag {
 	 * rolled back at commit.
 	 */
 	TXN_IS_ABORTED_BY_TIMEOUT = 0x100,
+	/**
+	 * Transaction was started with the read-only-snapshot
+	 * isolation level: it can't write, see txn_set_isolation().
+	 */
+	TXN_IS_READ_ONLY_SNAPSHOT = 0x200,
+};
+
+/** Transaction isolation level, see box_txn_set_isolation(). */
+enum txn_isolation_level {
+	/** The engines decide how the transaction reads and writes. */
+	TXN_ISOLATION_DEFAULT,
+	/**
+	 * A read-only transaction that sees a snapshot of the database
+	 * taken when the isolation level is set. With the memtx MVCC
+	 * engine it never conflicts and doesn't track its reads.
+	 */
+	TXN_ISOLATION_READ_ONLY_SNAPSHOT,
+	txn_isolation_level_MAX,
 };
 
+/** Names of the isolation levels, as accepted by box.begin(). */
+extern const char *txn_isolation_level_strs[];
+
 enum {
 	/**
 	 * Maximum recursion depth for on_replace triggers.
@@ -382,6 +409,8 @@ struct txn {
 	void *engine_tx;
 	/* A fiber to wake up when transaction is finished. */
 	struct fiber *fiber;
+	/** ID of the session that started the transaction or 0. */
+	uint64_t session_id;
 	/** Timestampt of entry write start. */
 	double start_tm;
 	/**
@@ -855,6 +884,18 @@ box_txn_alloc(size_t size);
 API_EXPORT int
 box_txn_set_timeout(double timeout);
 
+/**
+ * Set the isolation @a level of the current transaction: 0 is the
+ * default, 1 is a read-only snapshot. Must be called before the first
+ * statement of the transaction.
+ *
+ * @retval 0 if success
+ * @retval -1 if the level is unknown, there is no current
+ *            transaction or it has already executed a statement.
+ */
+API_EXPORT int
+box_txn_set_isolation(uint32_t level);
+
 /** \endcond public */
 
 typedef struct txn_savepoint box_txn_savepoint_t;
@@ -50,6 +50,9 @@ txn_limbo_create(struct txn_limbo *limbo)
 	limbo->confirmed_lsn = 0;
 	limbo->rollback_count = 0;
 	limbo->is_in_rollback = false;
+	limbo->confirm_fiber = NULL;
+	limbo->is_confirm_in_progress = false;
+	limbo->confirm_lsn_queued = 0;
 }
 
 bool
@@ -362,20 +365,64 @@ fail:
 
 }
 
+/** Confirm all the entries <= @a lsn. */
+static void
+txn_limbo_read_confirm(struct txn_limbo *limbo, int64_t lsn);
+
 /**
- * Write a confirmation entry to WAL. After it's written all the
- * transactions waiting for confirmation may be finished.
+ * Schedule writing a confirmation entry to WAL. After it's written
+ * all the transactions waiting for confirmation may be finished.
+ * The entry is written by the confirm fiber. If it's busy writing
+ * a previous CONFIRM, the new one is written after it and covers
+ * all the LSNs that gathered a quorum in the meantime.
  */
 static void
 txn_limbo_write_confirm(struct txn_limbo *limbo, int64_t lsn)
 {
 	assert(lsn > limbo->confirmed_lsn);
 	assert(!limbo->is_in_rollback);
+	/*
+	 * The LSN is considered confirmed right away so that it
+	 * can't be rolled back while the CONFIRM is queued.
+	 */
 	limbo->confirmed_lsn = lsn;
-	txn_limbo_write_synchro(limbo, IPROTO_RAFT_CONFIRM, lsn, 0);
+	limbo->confirm_lsn_queued = lsn;
+	if (!limbo->is_confirm_in_progress)
+		fiber_wakeup(limbo->confirm_fiber);
+}
+
+static int
+txn_limbo_confirm_f(va_list ap)
+{
+	struct txn_limbo *limbo = va_arg(ap, struct txn_limbo *);
+	while (!fiber_is_cancelled()) {
+		int64_t lsn = limbo->confirm_lsn_queued;
+		if (lsn == 0) {
+			fiber_yield();
+			continue;
+		}
+		limbo->confirm_lsn_queued = 0;
+		limbo->is_confirm_in_progress = true;
+		uint32_t owner_id = limbo->owner_id;
+		uint64_t term = limbo->promote_greatest_term;
+		txn_limbo_write_synchro(limbo, IPROTO_RAFT_CONFIRM, lsn, 0);
+		limbo->is_confirm_in_progress = false;
+		/*
+		 * The write yields, and meanwhile a PROMOTE or DEMOTE
+		 * could be processed. It has already finished the
+		 * entries covered by the CONFIRM and could pass the
+		 * limbo to a new owner, whose LSNs have nothing to do
+		 * with this one.
+		 */
+		if (limbo->owner_id != owner_id ||
+		    limbo->promote_greatest_term != term ||
+		    limbo->confirmed_lsn < lsn)
+			continue;
+		txn_limbo_read_confirm(limbo, lsn);
+	}
+	return 0;
 }
 
-/** Confirm all the entries <= @a lsn. */
 static void
 txn_limbo_read_confirm(struct txn_limbo *limbo, int64_t lsn)
 {
@@ -490,6 +537,8 @@ void
 txn_limbo_write_promote(struct txn_limbo *limbo, int64_t lsn, uint64_t term)
 {
 	limbo->confirmed_lsn = lsn;
+	/* PROMOTE confirms everything a queued CONFIRM would. */
+	limbo->confirm_lsn_queued = 0;
 	limbo->is_in_rollback = true;
 	/*
 	 * We make sure that promote is only written once everything this
@@ -516,12 +565,15 @@ txn_limbo_read_promote(struct txn_limbo *limbo, uint32_t replica_id,
 	limbo->owner_id = replica_id;
 	box_update_ro_summary();
 	limbo->confirmed_lsn = 0;
+	limbo->confirm_lsn_queued = 0;
 }
 
 void
 txn_limbo_write_demote(struct txn_limbo *limbo, int64_t lsn, uint64_t term)
 {
 	limbo->confirmed_lsn = lsn;
+	/* DEMOTE confirms everything a queued CONFIRM would. */
+	limbo->confirm_lsn_queued = 0;
 	limbo->is_in_rollback = true;
 	struct txn_limbo_entry *e = txn_limbo_last_synchro_entry(limbo);
 	assert(e == NULL || e->lsn <= lsn);
@@ -595,7 +647,6 @@ txn_limbo_ack(struct txn_limbo *limbo, uint32_t replica_id, int64_t lsn)
 	if (confirm_lsn == -1 || confirm_lsn <= limbo->confirmed_lsn)
 		return;
 	txn_limbo_write_confirm(limbo, confirm_lsn);
-	txn_limbo_read_confirm(limbo, confirm_lsn);
 }
 
 /**
@@ -805,10 +856,8 @@ txn_limbo_on_parameters_change(struct txn_limbo *limbo)
 			assert(confirm_lsn > 0);
 		}
 	}
-	if (confirm_lsn > limbo->confirmed_lsn && !limbo->is_in_rollback) {
+	if (confirm_lsn > limbo->confirmed_lsn && !limbo->is_in_rollback)
 		txn_limbo_write_confirm(limbo, confirm_lsn);
-		txn_limbo_read_confirm(limbo, confirm_lsn);
-	}
 	/*
 	 * Wakeup all the others - timed out will rollback. Also
 	 * there can be non-transactional waiters, such as CONFIRM
@@ -823,4 +872,9 @@ void
 txn_limbo_init(void)
 {
 	txn_limbo_create(&txn_limbo);
+	txn_limbo.confirm_fiber = fiber_new("txn_limbo.confirm",
+					    txn_limbo_confirm_f);
+	if (txn_limbo.confirm_fiber == NULL)
+		panic("failed to start synchronous replication confirm fiber");
+	fiber_start(txn_limbo.confirm_fiber, &txn_limbo);
 }
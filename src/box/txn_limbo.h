@@ -179,6 +179,20 @@ struct txn_limbo {
 	 * by the 'reversed rollback order' rule - contradiction.
 	 */
 	bool is_in_rollback;
+	/**
+	 * Fiber writing CONFIRM requests to WAL. Quorum advances
+	 * that happen while a CONFIRM is being written are covered
+	 * by the next one, so the number of CONFIRM writes depends
+	 * on the WAL latency rather than on the transaction rate.
+	 */
+	struct fiber *confirm_fiber;
+	/** Whether the confirm fiber is writing a CONFIRM now. */
+	bool is_confirm_in_progress;
+	/**
+	 * LSN to be confirmed by the next CONFIRM written by the
+	 * confirm fiber or 0 if nothing is to be confirmed.
+	 */
+	int64_t confirm_lsn_queued;
 };
 
 /**
@@ -155,6 +155,21 @@ struct vinyl_iterator {
 	struct vy_tx *tx;
 	/** Search key. */
 	struct vy_entry key;
+	/**
+	 * Parts of the search key of an ITER_PREFIX iterator,
+	 * NULL for other iterator types. The read iterator is
+	 * opened as ITER_GE and stopped at the first statement
+	 * that doesn't match the key.
+	 */
+	const char *prefix;
+	/** Number of parts in the prefix key. */
+	uint32_t prefix_part_count;
+	/**
+	 * Key statement made of all the prefix key parts but the
+	 * last one, used to check key statements. NULL if there
+	 * are no such parts.
+	 */
+	struct tuple *prefix_head;
 	/** Vinyl read iterator. */
 	struct vy_read_iterator iterator;
 	/**
@@ -259,6 +274,10 @@ vy_info_append_regulator(struct vy_env *env, struct info_handler *h)
 	info_append_int(h, "write_rate", r->write_rate);
 	info_append_int(h, "dump_bandwidth", r->dump_bandwidth);
 	info_append_int(h, "dump_watermark", r->dump_watermark);
+	info_append_int(h, "write_rate_forecast", r->write_rate_forecast);
+	info_append_int(h, "bursts", r->burst_count);
+	info_append_int(h, "early_dumps", r->early_dump_count);
+	info_append_double(h, "throttle_avoided", r->throttle_avoided);
 	info_append_int(h, "rate_limit", vy_quota_get_rate_limit(r->quota,
 							VY_QUOTA_CONSUMER_TX));
 	info_append_int(h, "blocked_writers", r->quota->n_blocked);
@@ -301,6 +320,18 @@ vy_info_append_memory(struct vy_env *env, struct info_handler *h)
 	info_table_end(h); /* memory */
 }
 
+static void
+vy_info_append_page_cache(struct vy_env *env, struct info_handler *h)
+{
+	struct vy_page_cache *cache = &env->run_env.page_cache;
+	info_table_begin(h, "page_cache");
+	info_append_int(h, "used", cache->mem_used);
+	info_append_int(h, "hit", cache->stat.hit);
+	info_append_int(h, "miss", cache->stat.miss);
+	info_append_int(h, "evict", cache->stat.evict);
+	info_table_end(h); /* page_cache */
+}
+
 static void
 vy_info_append_disk(struct vy_env *env, struct info_handler *h)
 {
@@ -319,6 +350,7 @@ vinyl_engine_stat(struct engine *engine, struct info_handler *h)
 	info_begin(h);
 	vy_info_append_tx(env, h);
 	vy_info_append_memory(env, h);
+	vy_info_append_page_cache(env, h);
 	vy_info_append_disk(env, h);
 	vy_info_append_scheduler(env, h);
 	vy_info_append_regulator(env, h);
@@ -410,6 +442,10 @@ vinyl_index_stat(struct index *index, struct info_handler *h)
 	info_append_int(h, "hit", stat->disk.iterator.bloom_hit);
 	info_append_int(h, "miss", stat->disk.iterator.bloom_miss);
 	info_table_end(h); /* bloom */
+	info_table_begin(h, "prefetch");
+	info_append_int(h, "pages", stat->disk.iterator.prefetch.pages);
+	info_append_int(h, "hit", stat->disk.iterator.prefetch.hit);
+	info_table_end(h); /* prefetch */
 	info_table_end(h); /* iterator */
 	info_table_begin(h, "dump");
 	info_append_int(h, "count", stat->disk.dump.count);
@@ -423,6 +459,8 @@ vinyl_index_stat(struct index *index, struct info_handler *h)
 	vy_info_append_disk_stmt_counter(h, "input", &stat->disk.compaction.input);
 	vy_info_append_disk_stmt_counter(h, "output", &stat->disk.compaction.output);
 	vy_info_append_disk_stmt_counter(h, "queue", &stat->disk.compaction.queue);
+	info_append_str(h, "policy",
+			index_compaction_policy_strs[lsm->opts.compaction_policy]);
 	info_table_end(h); /* compaction */
 	info_append_int(h, "index_size", lsm->page_index_size);
 	info_append_int(h, "bloom_size", lsm->bloom_size);
@@ -510,6 +548,7 @@ vinyl_engine_memory_stat(struct engine *engine, struct engine_memory_stat *stat)
 	stat->index += env->lsm_env.bloom_size;
 	stat->index += env->lsm_env.page_index_size;
 	stat->cache += env->cache_env.mem_used;
+	stat->cache += env->run_env.page_cache.mem_used;
 	stat->tx += vy_tx_manager_mem_used(env->xm);
 }
 
@@ -583,6 +622,21 @@ vinyl_engine_check_space_def(struct space_def *def)
 			 def->name, "engine does not support temporary flag");
 		return -1;
 	}
+	if (def->opts.memory_quota != 0) {
+		diag_set(ClientError, ER_ALTER_SPACE,
+			 def->name, "engine does not support memory quota");
+		return -1;
+	}
+	if (def->opts.expire_field != 0) {
+		diag_set(ClientError, ER_ALTER_SPACE,
+			 def->name, "engine does not support expire_field");
+		return -1;
+	}
+	if (def->opts.cached_paths != NULL) {
+		diag_set(ClientError, ER_ALTER_SPACE,
+			 def->name, "engine does not support cached paths");
+		return -1;
+	}
 	return 0;
 }
 
@@ -949,6 +1003,9 @@ vinyl_index_def_change_requires_rebuild(struct index *index,
 	 */
 	if (old_cmp_def->part_count != new_cmp_def->part_count)
 		return true;
+	/* Statements in memory store hints computed with the old def. */
+	if (!key_def_hints_are_compatible(old_cmp_def, new_cmp_def))
+		return true;
 
 	for (uint32_t i = 0; i < new_cmp_def->part_count; i++) {
 		const struct key_part *old_part = &old_cmp_def->parts[i];
@@ -1809,7 +1866,8 @@ vy_check_update(struct space *space, const struct vy_lsm *pk,
 
 /**
  * An UPDATE operation turns into a REPLACE statement in the
- * primary index and into DELETE + INSERT in secondary indexes.
+ * primary index and into DELETE + INSERT in secondary indexes
+ * whose key parts may be changed by it.
  * This function performs an UPDATE operation in the given
  * transaction write set after stmt->old_tuple and new_tuple
  * have been initialized and checked.
@@ -1843,6 +1901,19 @@ vy_perform_update(struct vy_env *env, struct vy_tx *tx, struct txn_stmt *stmt,
 		struct vy_lsm *lsm = vy_lsm(space->index[i]);
 		if (vy_is_committed(env, lsm))
 			continue;
+		/*
+		 * If the update doesn't touch the key of the index,
+		 * DELETE + REPLACE would be annihilated in the write
+		 * set anyway, see vy_tx_set_entry(), so don't spend
+		 * time on computing hints and looking up the write
+		 * set. Stale non-key fields of the tuple stored in
+		 * the index are harmless, because reads from a
+		 * secondary index always fetch the full tuple from
+		 * the primary index.
+		 */
+		if (key_update_can_be_skipped(lsm->key_def->column_mask,
+					      column_mask))
+			continue;
 		if (vy_tx_set(tx, lsm, delete) != 0)
 			goto error;
 		if (new_tuple != NULL && vy_tx_set(tx, lsm, new_tuple) != 0)
@@ -2697,6 +2768,34 @@ vinyl_engine_set_cache(struct engine *engine, size_t quota)
 	vy_cache_env_set_quota(&env->cache_env, quota);
 }
 
+void
+vinyl_engine_set_page_cache(struct engine *engine, size_t quota)
+{
+	struct vy_env *env = vy_env(engine);
+	vy_run_env_set_page_cache_quota(&env->run_env, quota);
+}
+
+void
+vinyl_engine_set_read_ahead(struct engine *engine, int read_ahead)
+{
+	struct vy_env *env = vy_env(engine);
+	vy_run_env_set_read_ahead(&env->run_env, read_ahead);
+}
+
+void
+vinyl_engine_set_direct_io(struct engine *engine, bool direct_io)
+{
+	struct vy_env *env = vy_env(engine);
+	vy_run_env_set_direct_io(&env->run_env, direct_io);
+}
+
+void
+vinyl_engine_set_max_gap_locks(struct engine *engine, uint32_t count)
+{
+	struct vy_env *env = vy_env(engine);
+	env->xm->max_read_set_count = count;
+}
+
 int
 vinyl_engine_set_memory(struct engine *engine, size_t size)
 {
@@ -3482,6 +3581,10 @@ vinyl_iterator_close(struct vinyl_iterator *it)
 	vy_read_iterator_close(&it->iterator);
 	tuple_unref(it->key.stmt);
 	it->key = vy_entry_none();
+	if (it->prefix_head != NULL) {
+		tuple_unref(it->prefix_head);
+		it->prefix_head = NULL;
+	}
 	if (it->tx == &it->tx_autocommit) {
 		/*
 		 * Rollback the automatic transaction.
@@ -3545,6 +3648,50 @@ vinyl_iterator_account_read(struct vinyl_iterator *it, double start_time,
 		vy_stmt_counter_acct_tuple(&lsm->stat.get, result);
 }
 
+/**
+ * Return true if the iterator is an ITER_PREFIX one and the
+ * given statement doesn't match its key, i.e. the iteration
+ * is over.
+ */
+static inline bool
+vinyl_iterator_is_past_prefix(struct vinyl_iterator *it,
+			      struct vy_entry entry)
+{
+	if (it->prefix == NULL || entry.stmt == NULL)
+		return false;
+	struct vy_lsm *lsm = it->iterator.lsm;
+	if (!vy_stmt_is_key(entry.stmt)) {
+		return !tuple_matches_prefix(entry.stmt, lsm->key_def,
+					     it->prefix,
+					     it->prefix_part_count);
+	}
+	/*
+	 * Key statements, e.g. the ones read from the runs of a
+	 * secondary index, have the key parts in the cmp_def
+	 * order rather than at their field numbers, so the parts
+	 * are taken by position.
+	 */
+	const char *key = tuple_data(entry.stmt);
+	if (it->prefix_head != NULL &&
+	    key_compare(key, HINT_NONE, tuple_data(it->prefix_head),
+			HINT_NONE, lsm->cmp_def) != 0)
+		return true;
+	uint32_t last = it->prefix_part_count - 1;
+	if (mp_decode_array(&key) <= last)
+		return true;
+	const char *prefix = it->prefix;
+	for (uint32_t i = 0; i < last; i++) {
+		mp_next(&key);
+		mp_next(&prefix);
+	}
+	if (mp_typeof(*key) != MP_STR)
+		return true;
+	uint32_t len, prefix_len;
+	key = mp_decode_str(&key, &len);
+	prefix = mp_decode_str(&prefix, &prefix_len);
+	return len < prefix_len || memcmp(key, prefix, prefix_len) != 0;
+}
+
 static int
 vinyl_iterator_primary_next(struct iterator *base, struct tuple **ret)
 {
@@ -3566,7 +3713,10 @@ vinyl_iterator_primary_next(struct iterator *base, struct tuple **ret)
 	struct vy_entry entry;
 	if (vy_read_iterator_next(&it->iterator, &entry) != 0)
 		goto fail;
-	vy_read_iterator_cache_add(&it->iterator, entry);
+	if (vinyl_iterator_is_past_prefix(it, entry))
+		entry = vy_entry_none();
+	else
+		vy_read_iterator_cache_add(&it->iterator, entry);
 	vinyl_iterator_account_read(it, start_time, entry.stmt);
 	if (entry.stmt == NULL) {
 		/* EOF. Close the iterator immediately. */
@@ -3606,6 +3756,16 @@ next:
 	if (vy_read_iterator_next(&it->iterator, &partial) != 0)
 		goto fail;
 
+	if (vinyl_iterator_is_past_prefix(it, partial)) {
+		/*
+		 * Don't add it to the cache: the chain ends at
+		 * the statement, not at the end of the index.
+		 */
+		vinyl_iterator_account_read(it, start_time, NULL);
+		vinyl_iterator_close(it);
+		*ret = NULL;
+		goto out;
+	}
 	if (partial.stmt == NULL) {
 		/* EOF. Close the iterator immediately. */
 		vy_read_iterator_cache_add(&it->iterator, vy_entry_none());
@@ -3652,7 +3812,7 @@ vinyl_index_create_iterator(struct index *base, enum iterator_type type,
 	struct vy_lsm *lsm = vy_lsm(base);
 	struct vy_env *env = vy_env(base->engine);
 
-	if (type > ITER_GT) {
+	if (type > ITER_GT && type != ITER_PREFIX) {
 		diag_set(UnsupportedIndexFeature, base->def,
 			 "requested iterator type");
 		return NULL;
@@ -3676,6 +3836,16 @@ vinyl_index_create_iterator(struct index *base, enum iterator_type type,
 		mempool_free(&env->iterator_pool, it);
 		return NULL;
 	}
+	it->prefix_head = NULL;
+	if (type == ITER_PREFIX && part_count > 1) {
+		it->prefix_head = vy_key_new(lsm->env->key_format, key,
+					     part_count - 1);
+		if (it->prefix_head == NULL) {
+			tuple_unref(it->key.stmt);
+			mempool_free(&env->iterator_pool, it);
+			return NULL;
+		}
+	}
 
 	iterator_create(&it->base, base);
 	if (lsm->index_id == 0)
@@ -3699,6 +3869,15 @@ vinyl_index_create_iterator(struct index *base, enum iterator_type type,
 	}
 	it->tx = tx;
 
+	it->prefix = NULL;
+	it->prefix_part_count = 0;
+	if (type == ITER_PREFIX) {
+		assert(part_count > 0);
+		it->prefix = tuple_data(it->key.stmt);
+		it->prefix_part_count = mp_decode_array(&it->prefix);
+		type = ITER_GE;
+	}
+
 	lsm->stat.lookup++;
 	vy_read_iterator_open(&it->iterator, lsm, tx, type, it->key,
 			      (const struct vy_read_view **)&tx->read_view);
@@ -4539,6 +4718,7 @@ static const struct engine_vtab vinyl_engine_vtab = {
 static const struct space_vtab vinyl_space_vtab = {
 	/* .destroy = */ vinyl_space_destroy,
 	/* .bsize = */ vinyl_space_bsize,
+	/* .stat = */ generic_space_stat,
 	/* .execute_replace = */ vinyl_space_execute_replace,
 	/* .execute_delete = */ vinyl_space_execute_delete,
 	/* .execute_update = */ vinyl_space_execute_update,
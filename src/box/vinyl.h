@@ -33,6 +33,7 @@
 
 #include <stdbool.h>
 #include <stddef.h>
+#include <stdint.h>
 
 #ifdef __cplusplus
 extern "C" {
@@ -57,6 +58,32 @@ vinyl_engine_stat(struct engine *engine, struct info_handler *handler);
 void
 vinyl_engine_set_cache(struct engine *engine, size_t quota);
 
+/**
+ * Update the size of the cache of decompressed run pages.
+ */
+void
+vinyl_engine_set_page_cache(struct engine *engine, size_t quota);
+
+/**
+ * Update the max number of pages read ahead by a run iterator
+ * during a sequential scan.
+ */
+void
+vinyl_engine_set_read_ahead(struct engine *engine, int read_ahead);
+
+/**
+ * Enable or disable direct I/O for run files.
+ */
+void
+vinyl_engine_set_direct_io(struct engine *engine, bool direct_io);
+
+/**
+ * Update the max number of read intervals (gap locks) a transaction
+ * may have before its intervals are coarsened. Zero means no limit.
+ */
+void
+vinyl_engine_set_max_gap_locks(struct engine *engine, uint32_t count);
+
 /**
  * Update vinyl memory size.
  */
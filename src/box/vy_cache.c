@@ -47,6 +47,12 @@ enum {
 	/* Flag in cache node that means that there are no values in DB
 	 * that greater than the current and less than the previous */
 	VY_CACHE_RIGHT_LINKED = 2,
+	/* Flag in cache node that means that the node is in the
+	 * protected segment of the LRU */
+	VY_CACHE_PROTECTED = 4,
+	/* Max share of the quota, in percent, that may be occupied
+	 * by the protected segment of the LRU */
+	VY_CACHE_PROTECTED_PERCENT = 80,
 	/* Max number of deletes that are made by cleanup action per one
 	 * cache operation */
 	VY_CACHE_CLEANUP_MAX_STEPS = 10,
@@ -56,7 +62,9 @@ void
 vy_cache_env_create(struct vy_cache_env *e, struct slab_cache *slab_cache)
 {
 	rlist_create(&e->cache_lru);
+	rlist_create(&e->cache_lru_protected);
 	e->mem_used = 0;
+	e->mem_protected = 0;
 	e->mem_quota = 0;
 	mempool_create(&e->cache_node_mempool, slab_cache,
 		       sizeof(struct vy_cache_node));
@@ -108,12 +116,45 @@ vy_cache_node_delete(struct vy_cache_env *env, struct vy_cache_node *node)
 				     node->entry.stmt);
 	assert(env->mem_used >= vy_cache_node_size(node));
 	env->mem_used -= vy_cache_node_size(node);
+	if (node->flags & VY_CACHE_PROTECTED) {
+		assert(env->mem_protected >= vy_cache_node_size(node));
+		env->mem_protected -= vy_cache_node_size(node);
+	}
 	tuple_unref(node->entry.stmt);
 	rlist_del(&node->in_lru);
 	TRASH(node);
 	mempool_free(&env->cache_node_mempool, node);
 }
 
+/**
+ * Mark a cache node as recently used. If the node is in the
+ * probationary segment of the LRU, move it to the protected one,
+ * pushing the least recently used protected nodes back to the
+ * probationary segment if the protected segment gets too big.
+ */
+static void
+vy_cache_node_touch(struct vy_cache_env *env, struct vy_cache_node *node)
+{
+	if (node->flags & VY_CACHE_PROTECTED) {
+		rlist_move(&env->cache_lru_protected, &node->in_lru);
+		return;
+	}
+	node->flags |= VY_CACHE_PROTECTED;
+	rlist_move(&env->cache_lru_protected, &node->in_lru);
+	env->mem_protected += vy_cache_node_size(node);
+	size_t limit = env->mem_quota / 100 * VY_CACHE_PROTECTED_PERCENT;
+	while (env->mem_protected > limit) {
+		struct vy_cache_node *last =
+			rlist_last_entry(&env->cache_lru_protected,
+					 struct vy_cache_node, in_lru);
+		if (last == node)
+			break;
+		last->flags &= ~VY_CACHE_PROTECTED;
+		rlist_move(&env->cache_lru, &last->in_lru);
+		env->mem_protected -= vy_cache_node_size(last);
+	}
+}
+
 static void *
 vy_cache_tree_page_alloc(void *ctx)
 {
@@ -167,6 +208,8 @@ static void
 vy_cache_gc_step(struct vy_cache_env *env)
 {
 	struct rlist *lru = &env->cache_lru;
+	if (rlist_empty(lru))
+		lru = &env->cache_lru_protected;
 	struct vy_cache_node *node =
 		rlist_last_entry(lru, struct vy_cache_node, in_lru);
 	struct vy_cache *cache = node->cache;
@@ -423,6 +466,7 @@ vy_cache_get(struct vy_cache *cache, struct vy_entry key)
 		vy_cache_tree_find(&cache->cache_tree, key);
 	if (node == NULL)
 		return vy_entry_none();
+	vy_cache_node_touch(cache->env, *node);
 	return (*node)->entry;
 }
 
@@ -515,6 +559,19 @@ vy_cache_iterator_curr(struct vy_cache_iterator *itr)
 	return node ? (*node)->entry : vy_entry_none();
 }
 
+/**
+ * Mark the node the iterator is positioned at as recently used.
+ */
+static void
+vy_cache_iterator_touch(struct vy_cache_iterator *itr)
+{
+	struct vy_cache_tree *tree = &itr->cache->cache_tree;
+	struct vy_cache_node **node =
+		vy_cache_tree_iterator_get_elem(tree, &itr->curr_pos);
+	if (node != NULL && (*node)->entry.stmt == itr->curr.stmt)
+		vy_cache_node_touch(itr->cache->env, *node);
+}
+
 /**
  * Determine whether the merge iterator must be stopped or not.
  * That is made by examining flags of a cache record.
@@ -716,6 +773,7 @@ vy_cache_iterator_next(struct vy_cache_iterator *itr,
 	if (itr->curr.stmt != NULL) {
 		vy_stmt_counter_acct_tuple(&itr->cache->stat.get,
 					   itr->curr.stmt);
+		vy_cache_iterator_touch(itr);
 		return vy_history_append_stmt(history, itr->curr);
 	}
 	return 0;
@@ -747,6 +805,7 @@ vy_cache_iterator_skip(struct vy_cache_iterator *itr, struct vy_entry last,
 	if (itr->curr.stmt != NULL) {
 		vy_stmt_counter_acct_tuple(&itr->cache->stat.get,
 					   itr->curr.stmt);
+		vy_cache_iterator_touch(itr);
 		return vy_history_append_stmt(history, itr->curr);
 	}
 	return 0;
@@ -826,6 +885,7 @@ vy_cache_iterator_restore(struct vy_cache_iterator *itr, struct vy_entry last,
 	if (itr->curr.stmt != NULL) {
 		vy_stmt_counter_acct_tuple(&itr->cache->stat.get,
 					   itr->curr.stmt);
+		vy_cache_iterator_touch(itr);
 		if (vy_history_append_stmt(history, itr->curr) != 0)
 			return -1;
 	}
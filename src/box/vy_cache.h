@@ -58,8 +58,9 @@ struct vy_cache_node {
 	struct vy_entry entry;
 	/* Link in LRU list */
 	struct rlist in_lru;
-	/* VY_CACHE_LEFT_LINKED and/or VY_CACHE_RIGHT_LINKED, see
-	 * description of them for more information */
+	/* VY_CACHE_LEFT_LINKED, VY_CACHE_RIGHT_LINKED and/or
+	 * VY_CACHE_PROTECTED, see description of them for more
+	 * information */
 	uint32_t flags;
 	/* Number of parts in key when the value was the first in EQ search */
 	uint8_t left_boundary_level;
@@ -113,14 +114,30 @@ vy_cache_tree_key_cmp(struct vy_cache_node *a, struct vy_entry b,
 
 /**
  * Environment of the cache
+ *
+ * The cache is a segmented LRU. New nodes are added to the
+ * probationary segment. A node that is read from the cache
+ * is moved to the protected segment. Nodes are evicted from
+ * the probationary segment first, so a scan that reads every
+ * key once can't evict keys that are read often.
  */
 struct vy_cache_env {
-	/** Common LRU list of read cache. The first element is the newest */
+	/**
+	 * LRU list of the probationary segment.
+	 * The first element is the newest.
+	 */
 	struct rlist cache_lru;
+	/**
+	 * LRU list of the protected segment.
+	 * The first element is the most recently used.
+	 */
+	struct rlist cache_lru_protected;
 	/** Common mempool for vy_cache_node struct */
 	struct mempool cache_node_mempool;
 	/** Size of memory occupied by cached tuples */
 	size_t mem_used;
+	/** Size of memory occupied by the protected segment. */
+	size_t mem_protected;
 	/** Max memory size that can be used for cache */
 	size_t mem_quota;
 };
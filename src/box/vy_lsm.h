@@ -192,6 +192,14 @@ struct vy_lsm {
 	uint32_t group_id;
 	/** Index options. */
 	struct index_opts opts;
+	/**
+	 * Zstd dictionary for compressing new runs, trained by
+	 * the last dump or compaction, NULL if none. Not persisted:
+	 * each run stores the dictionary it was compressed with.
+	 */
+	char *dict;
+	/** Size of the dictionary. */
+	uint32_t dict_size;
 	/** Key definition used to compare tuples. */
 	struct key_def *cmp_def;
 	/** Key definition passed by the user. */
@@ -617,7 +617,9 @@ vy_mem_stream_next(struct vy_stmt_stream *virt_stream, struct vy_entry *ret)
 	struct vy_entry *res =
 		vy_mem_tree_iterator_get_elem(&stream->mem->tree,
 					      &stream->curr_pos);
-	if (res == NULL) {
+	if (res == NULL || (stream->end.stmt != NULL &&
+			    vy_entry_compare(*res, stream->end,
+					     stream->mem->cmp_def) >= 0)) {
 		*ret = vy_entry_none();
 	} else {
 		*ret = *res;
@@ -635,11 +637,21 @@ static const struct vy_stmt_stream_iface vy_mem_stream_iface = {
 };
 
 void
-vy_mem_stream_open(struct vy_mem_stream *stream, struct vy_mem *mem)
+vy_mem_stream_open(struct vy_mem_stream *stream, struct vy_mem *mem,
+		   struct vy_entry begin, struct vy_entry end)
 {
 	stream->base.iface = &vy_mem_stream_iface;
 	stream->mem = mem;
-	stream->curr_pos = vy_mem_tree_iterator_first(&mem->tree);
+	stream->end = end;
+	if (begin.stmt == NULL) {
+		stream->curr_pos = vy_mem_tree_iterator_first(&mem->tree);
+	} else {
+		struct vy_mem_tree_key tree_key;
+		tree_key.entry = begin;
+		tree_key.lsn = INT64_MAX - 1;
+		stream->curr_pos = vy_mem_tree_lower_bound(&mem->tree,
+							   &tree_key, NULL);
+	}
 }
 
 /* }}} vy_mem_iterator API implementation */
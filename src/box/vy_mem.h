@@ -122,6 +122,7 @@ vy_mem_tree_cmp_key(struct vy_entry entry, struct vy_mem_tree_key *key,
 #define BPS_TREE_COMPARE(a, b, cmp_def) vy_mem_tree_cmp(a, b, cmp_def)
 #define BPS_TREE_COMPARE_KEY(a, b, cmp_def) vy_mem_tree_cmp_key(a, b, cmp_def)
 #define BPS_TREE_IS_IDENTICAL(a, b) vy_entry_is_equal(a, b)
+#define BPS_TREE_PREFETCH
 #define bps_tree_elem_t struct vy_entry
 #define bps_tree_key_t struct vy_mem_tree_key *
 #define bps_tree_arg_t struct key_def *
@@ -137,6 +138,7 @@ vy_mem_tree_cmp_key(struct vy_entry entry, struct vy_mem_tree_key *key,
 #undef bps_tree_key_t
 #undef bps_tree_arg_t
 #undef BPS_TREE_IS_IDENTICAL
+#undef BPS_TREE_PREFETCH
 
 /** @endcond false */
 
@@ -418,13 +420,22 @@ struct vy_mem_stream {
 	struct vy_mem *mem;
 	/** Current position */
 	struct vy_mem_tree_iterator curr_pos;
+	/**
+	 * Statement at which the stream stops (exclusive)
+	 * or NULL if the stream spans till the end of the mem.
+	 */
+	struct vy_entry end;
 };
 
 /**
  * Open a mem stream. Use vy_stmt_stream api for further work.
+ *
+ * The stream returns only statements that are >= @begin and
+ * < @end. NULL @begin or @end stands for infinity.
  */
 void
-vy_mem_stream_open(struct vy_mem_stream *stream, struct vy_mem *mem);
+vy_mem_stream_open(struct vy_mem_stream *stream, struct vy_mem *mem,
+		   struct vy_entry begin, struct vy_entry end);
 
 #if defined(__cplusplus)
 } /* extern "C" */
@@ -30,6 +30,7 @@
  */
 #include "vy_point_lookup.h"
 
+#include <stdarg.h>
 #include <stdbool.h>
 #include <stddef.h>
 #include <stdint.h>
@@ -153,6 +154,141 @@ vy_point_lookup_scan_slice(struct vy_lsm *lsm, struct vy_slice *slice,
 	return rc;
 }
 
+/** Scan of a slice done in a separate fiber. */
+struct vy_point_lookup_slice_scan {
+	struct vy_lsm *lsm;
+	struct vy_slice *slice;
+	const struct vy_read_view **rv;
+	struct vy_entry key;
+	/** Statements found in the slice. */
+	struct vy_history history;
+	/** Fiber doing the scan or NULL if it's done. */
+	struct fiber *fiber;
+	/** Result of the scan. */
+	int rc;
+};
+
+static int
+vy_point_lookup_scan_slice_f(va_list ap)
+{
+	struct vy_point_lookup_slice_scan *scan =
+		va_arg(ap, struct vy_point_lookup_slice_scan *);
+	return vy_point_lookup_scan_slice(scan->lsm, scan->slice, scan->rv,
+					  scan->key, &scan->history);
+}
+
+/**
+ * Return the number of slices that may store the key according to
+ * bloom filters, but not more than two, which is enough to decide
+ * whether reading them concurrently makes sense.
+ */
+static int
+vy_point_lookup_count_candidates(struct vy_lsm *lsm, struct vy_entry key,
+				 struct vy_slice **slices, int slice_count)
+{
+	int count = 0;
+	for (int i = 0; i < slice_count && count < 2; i++) {
+		if (vy_slice_bloom_maybe_has(slices[i], key, lsm->cmp_def,
+					     lsm->key_def))
+			count++;
+	}
+	return count;
+}
+
+/**
+ * Scan slices one by one, from the newest to the oldest, until
+ * a terminal statement is found.
+ */
+static int
+vy_point_lookup_scan_slices_serial(struct vy_lsm *lsm,
+				   const struct vy_read_view **rv,
+				   struct vy_entry key,
+				   struct vy_slice **slices, int slice_count,
+				   struct vy_history *history)
+{
+	for (int i = 0; i < slice_count; i++) {
+		if (vy_history_is_terminal(history))
+			break;
+		if (vy_point_lookup_scan_slice(lsm, slices[i], rv,
+					       key, history) != 0)
+			return -1;
+	}
+	return 0;
+}
+
+/**
+ * Scan all slices that may store the key at the same time, each
+ * in its own fiber, so that their pages are read from disk in
+ * parallel by the reader threads. Then merge the found statements
+ * from the newest slice to the oldest one up to a terminal statement.
+ * This costs extra reads if a newer slice has a terminal statement,
+ * but the lookup waits for one disk read instead of one per slice.
+ */
+static int
+vy_point_lookup_scan_slices_concurrent(struct vy_lsm *lsm,
+				       const struct vy_read_view **rv,
+				       struct vy_entry key,
+				       struct vy_slice **slices,
+				       int slice_count,
+				       struct vy_history *history)
+{
+	size_t size;
+	struct vy_point_lookup_slice_scan *scans =
+		region_alloc_array(&fiber()->gc, typeof(scans[0]), slice_count,
+				   &size);
+	if (scans == NULL) {
+		diag_set(OutOfMemory, size, "region_alloc_array", "scans");
+		return -1;
+	}
+	int scan_count = 0;
+	for (int i = 0; i < slice_count; i++) {
+		if (!vy_slice_bloom_maybe_has(slices[i], key, lsm->cmp_def,
+					      lsm->key_def)) {
+			lsm->stat.disk.iterator.bloom_hit++;
+			continue;
+		}
+		struct vy_point_lookup_slice_scan *scan = &scans[scan_count++];
+		scan->lsm = lsm;
+		scan->slice = slices[i];
+		scan->rv = rv;
+		scan->key = key;
+		scan->rc = 0;
+		vy_history_create(&scan->history,
+				  &lsm->env->history_node_pool);
+		scan->fiber = fiber_new("vinyl.point_lookup",
+					vy_point_lookup_scan_slice_f);
+		if (scan->fiber == NULL) {
+			/* Fall back on scanning the slice in place. */
+			diag_clear(diag_get());
+			scan->rc = vy_point_lookup_scan_slice(lsm, scan->slice,
+							      rv, key,
+							      &scan->history);
+			continue;
+		}
+		fiber_set_joinable(scan->fiber, true);
+		/* The fiber runs until it yields to read a page. */
+		fiber_start(scan->fiber, scan);
+	}
+	int rc = 0;
+	for (int i = 0; i < scan_count; i++) {
+		struct vy_point_lookup_slice_scan *scan = &scans[i];
+		if (scan->fiber != NULL) {
+			scan->rc = fiber_join(scan->fiber);
+			scan->fiber = NULL;
+		}
+		if (scan->rc != 0)
+			rc = -1;
+	}
+	for (int i = 0; i < scan_count; i++) {
+		struct vy_point_lookup_slice_scan *scan = &scans[i];
+		if (rc == 0 && !vy_history_is_terminal(history))
+			vy_history_splice(history, &scan->history);
+		else
+			vy_history_cleanup(&scan->history);
+	}
+	return rc;
+}
+
 /**
  * Find a range and scan all slices that belongs to the range.
  * Add found statements to the history list up to terminal statement.
@@ -182,13 +318,22 @@ vy_point_lookup_scan_slices(struct vy_lsm *lsm, const struct vy_read_view **rv,
 		slices[i++] = slice;
 	}
 	assert(i == slice_count);
-	int rc = 0;
-	for (i = 0; i < slice_count; i++) {
-		if (rc == 0 && !vy_history_is_terminal(history))
-			rc = vy_point_lookup_scan_slice(lsm, slices[i],
-							rv, key, history);
-		vy_slice_unpin(slices[i]);
+	int rc;
+	/*
+	 * If bloom filters let us skip all slices but one, there's
+	 * nothing to read concurrently.
+	 */
+	if (vy_point_lookup_count_candidates(lsm, key, slices,
+					     slice_count) > 1) {
+		rc = vy_point_lookup_scan_slices_concurrent(lsm, rv, key,
+							    slices, slice_count,
+							    history);
+	} else {
+		rc = vy_point_lookup_scan_slices_serial(lsm, rv, key, slices,
+							slice_count, history);
 	}
+	for (i = 0; i < slice_count; i++)
+		vy_slice_unpin(slices[i]);
 	return rc;
 }
 
@@ -280,6 +280,12 @@ vy_range_remove_slice(struct vy_range *range, struct vy_slice *slice)
  * compaction is relatively cheap, because of the level size
  * ratio.
  *
+ * With the leveled compaction policy, the last level never stores
+ * more than one run. The tiered policy lifts this restriction and
+ * lets the last level accumulate up to run_count_per_level runs
+ * before compacting them, which reduces write amplification at
+ * the cost of space and read amplification.
+ *
  * Given a range, this function computes the maximal level that needs
  * to be compacted and sets @compaction_priority to the number of runs
  * in this level and all preceding levels.
@@ -415,7 +421,8 @@ vy_range_update_compaction_priority(struct vy_range *range,
 		}
 	}
 
-	if (level_run_count > 1) {
+	if (opts->compaction_policy == INDEX_COMPACTION_LEVELED &&
+	    level_run_count > 1) {
 		/*
 		 * Do not store more than one run at the last level
 		 * to keep space amplification low.
@@ -515,6 +522,38 @@ vy_range_needs_split(struct vy_range *range, int64_t range_size,
 	return true;
 }
 
+int
+vy_range_find_split_keys(struct vy_range *range, struct vy_slice *slice,
+			 int part_count, const char **keys)
+{
+	uint32_t page_count = slice->last_page_no - slice->first_page_no + 1;
+	struct vy_page_info *prev_page = vy_run_page_info(slice->run,
+						slice->first_page_no);
+	int key_count = 0;
+	for (int i = 1; i < part_count; i++) {
+		struct vy_page_info *page;
+		page = vy_run_page_info(slice->run, slice->first_page_no +
+					(uint64_t)page_count * i / part_count);
+		/*
+		 * The key must be greater than the previous one and
+		 * the beginning of the slice, see also the comment
+		 * in vy_range_needs_split().
+		 */
+		if (key_compare(prev_page->min_key, prev_page->min_key_hint,
+				page->min_key, page->min_key_hint,
+				range->cmp_def) >= 0)
+			continue;
+		if (slice->begin.stmt != NULL &&
+		    vy_entry_compare_with_raw_key(slice->begin, page->min_key,
+						  page->min_key_hint,
+						  range->cmp_def) >= 0)
+			continue;
+		keys[key_count++] = page->min_key;
+		prev_page = page;
+	}
+	return key_count;
+}
+
 /**
  * Check if a range should be coalesced with one or more its neighbors.
  * If it should, return true and set @p_first and @p_last to the first
@@ -266,6 +266,23 @@ bool
 vy_range_needs_split(struct vy_range *range, int64_t range_size,
 		     const char **p_split_key);
 
+/**
+ * Find keys splitting a slice of a range in approximately equal
+ * parts. The keys are taken from the page index of the slice run
+ * and are returned in the ascending order. Keys that would result
+ * in an empty part are skipped.
+ *
+ * @param range             The range.
+ * @param slice             Slice to split.
+ * @param part_count        Desired number of parts.
+ * @param[out] keys         Array of at least part_count - 1 keys.
+ *
+ * @return Number of keys stored in @keys.
+ */
+int
+vy_range_find_split_keys(struct vy_range *range, struct vy_slice *slice,
+			 int part_count, const char **keys);
+
 /**
  * Check if a range needs to be coalesced with adjacent
  * ranges in a range tree.
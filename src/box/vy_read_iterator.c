@@ -38,6 +38,15 @@
 #include "vy_lsm.h"
 #include "vy_stat.h"
 
+enum {
+	/**
+	 * A read iterator stops adding statements to the tuple
+	 * cache after it has added 1/VY_READ_ITERATOR_CACHE_SHARE
+	 * of the cache quota.
+	 */
+	VY_READ_ITERATOR_CACHE_SHARE = 4,
+};
+
 /**
  * Merge source, support structure for vy_read_iterator.
  * Contains source iterator and merge state.
@@ -847,14 +856,25 @@ next_key:
 void
 vy_read_iterator_cache_add(struct vy_read_iterator *itr, struct vy_entry entry)
 {
-	if ((**itr->read_view).vlsn != INT64_MAX) {
+	struct vy_cache *cache = &itr->lsm->cache;
+	/*
+	 * An iterator that has already put a big share of the cache
+	 * quota into the cache looks like a one-off scan. Stop caching
+	 * its results so that it doesn't evict the keys that are read
+	 * often.
+	 */
+	if ((**itr->read_view).vlsn != INT64_MAX ||
+	    itr->cached_bytes > cache->env->mem_quota /
+				VY_READ_ITERATOR_CACHE_SHARE) {
 		if (itr->last_cached.stmt != NULL)
 			tuple_unref(itr->last_cached.stmt);
 		itr->last_cached = vy_entry_none();
 		return;
 	}
-	vy_cache_add(&itr->lsm->cache, entry, itr->last_cached,
+	int64_t put_bytes = cache->stat.put.bytes;
+	vy_cache_add(cache, entry, itr->last_cached,
 		     itr->key, itr->iterator_type);
+	itr->cached_bytes += cache->stat.put.bytes - put_bytes;
 	if (entry.stmt != NULL)
 		tuple_ref(entry.stmt);
 	if (itr->last_cached.stmt != NULL)
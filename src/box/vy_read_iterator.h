@@ -70,6 +70,11 @@ struct vy_read_iterator {
 	 * vy_read_iterator_cache_add().
 	 */
 	struct vy_entry last_cached;
+	/**
+	 * Size of statements added to the tuple cache by
+	 * vy_read_iterator_cache_add().
+	 */
+	size_t cached_bytes;
 	/**
 	 * Copy of lsm->range_tree_version.
 	 * Used for detecting range tree changes.
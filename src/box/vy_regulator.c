@@ -56,6 +56,26 @@ static const double VY_REGULATOR_TIMER_PERIOD = 1;
  */
 static const double VY_WRITE_RATE_AVG_WIN = 5;
 
+/**
+ * A write rate measured by the timer is considered a burst if it
+ * exceeds the average by more than this many average deviations.
+ * The same bound is used as the write rate forecast when there's
+ * no burst.
+ */
+static const int VY_WRITE_BURST_DEV_COUNT = 3;
+
+/**
+ * Don't consider write rates below this value, in bytes per
+ * second, bursts: they can't affect the dump schedule anyway.
+ */
+static const size_t VY_WRITE_BURST_RATE_MIN = 1024 * 1024;
+
+/**
+ * Max time, in seconds, over which the write rate trend is
+ * extrapolated when a burst is detected.
+ */
+static const double VY_WRITE_FORECAST_HORIZON_MAX = 10;
+
 /**
  * Histogram percentile used for estimating dump bandwidth.
  * For details see the comment to vy_regulator::dump_bandwidth_hist.
@@ -83,6 +103,24 @@ static const size_t VY_DUMP_SIZE_ACCT_MIN = 1024 * 1024;
  */
 static const int VY_RECENT_DUMP_COUNT = 100;
 
+/**
+ * Estimate for how long writers will be throttled if a memory dump
+ * is started when @a mem_used bytes are used and the write rate
+ * stays at the forecast level: the dump takes mem_used / bandwidth
+ * seconds, and the memory limit is hit in mem_left / rate seconds.
+ */
+static double
+vy_regulator_throttle_time(struct vy_regulator *regulator, size_t mem_used)
+{
+	struct vy_quota *quota = regulator->quota;
+	size_t mem_left = (mem_used < quota->limit ?
+			   quota->limit - mem_used : 0);
+	double dump_time = (double)mem_used / (regulator->dump_bandwidth + 1);
+	double fill_time = (double)mem_left /
+			   (regulator->write_rate_forecast + 1);
+	return MAX(dump_time - fill_time, 0.0);
+}
+
 static void
 vy_regulator_trigger_dump(struct vy_regulator *regulator)
 {
@@ -94,6 +132,15 @@ vy_regulator_trigger_dump(struct vy_regulator *regulator)
 
 	regulator->dump_in_progress = true;
 
+	struct vy_quota *quota = regulator->quota;
+	if (quota->used < regulator->dump_watermark_base) {
+		regulator->early_dump_count++;
+		regulator->throttle_avoided +=
+			vy_regulator_throttle_time(regulator,
+					regulator->dump_watermark_base) -
+			vy_regulator_throttle_time(regulator, quota->used);
+	}
+
 	/*
 	 * To avoid unpredictably long stalls, we must limit
 	 * the write rate when a dump is in progress so that
@@ -104,7 +151,6 @@ vy_regulator_trigger_dump(struct vy_regulator *regulator)
 	 *   ---------- >= --------------
 	 *   write_rate    dump_bandwidth
 	 */
-	struct vy_quota *quota = regulator->quota;
 	size_t mem_left = (quota->used < quota->limit ?
 			   quota->limit - quota->used : 0);
 	size_t mem_used = quota->used;
@@ -142,23 +188,67 @@ vy_regulator_update_write_rate(struct vy_regulator *regulator)
 	}
 
 	size_t rate_avg = regulator->write_rate;
+	size_t rate_dev = regulator->write_rate_dev;
 	size_t rate_curr = (used_curr - used_last) / VY_REGULATOR_TIMER_PERIOD;
+	size_t rate_bound = rate_avg + VY_WRITE_BURST_DEV_COUNT * rate_dev;
+
+	/*
+	 * Forecast the write rate for the next dump. The average
+	 * rate lags behind a burst, so when the current rate goes
+	 * above the usual deviation from the average, assume it
+	 * will keep growing at the same pace until the memory is
+	 * dumped.
+	 */
+	size_t forecast = rate_bound;
+	if (rate_curr > rate_bound && rate_curr >= VY_WRITE_BURST_RATE_MIN) {
+		regulator->burst_count++;
+		size_t rate_last = regulator->write_rate_last;
+		size_t trend = rate_curr > rate_last ? rate_curr - rate_last : 0;
+		double horizon = (double)regulator->quota->limit /
+				 (regulator->dump_bandwidth + 1);
+		horizon = MIN(horizon, VY_WRITE_FORECAST_HORIZON_MAX);
+		forecast = rate_curr + trend * horizon /
+					VY_REGULATOR_TIMER_PERIOD;
+	}
 
 	double weight = 1 - exp(-VY_REGULATOR_TIMER_PERIOD /
 				VY_WRITE_RATE_AVG_WIN);
+	size_t rate_diff = rate_curr > rate_avg ? rate_curr - rate_avg :
+						  rate_avg - rate_curr;
 	rate_avg = (1 - weight) * rate_avg + weight * rate_curr;
+	rate_dev = (1 - weight) * rate_dev + weight * rate_diff;
 
 	regulator->write_rate = rate_avg;
+	regulator->write_rate_dev = rate_dev;
+	regulator->write_rate_last = rate_curr;
+	regulator->write_rate_forecast = forecast;
 	if (regulator->write_rate_max < rate_curr)
 		regulator->write_rate_max = rate_curr;
 	regulator->quota_used_last = used_curr;
 }
 
-static void
-vy_regulator_update_dump_watermark(struct vy_regulator *regulator)
+/**
+ * Return the memory watermark for the given expected write rate.
+ */
+static size_t
+vy_regulator_dump_watermark(struct vy_regulator *regulator,
+			    size_t write_rate)
 {
 	struct vy_quota *quota = regulator->quota;
+	write_rate = write_rate * 3 / 2;
+	size_t watermark = (double)quota->limit * regulator->dump_bandwidth /
+			   (regulator->dump_bandwidth + write_rate + 1);
+	/*
+	 * It doesn't make sense to set the watermark below 50%
+	 * of the memory limit because the write rate can exceed
+	 * the dump bandwidth under no circumstances.
+	 */
+	return MAX(watermark, quota->limit / 2);
+}
 
+static void
+vy_regulator_update_dump_watermark(struct vy_regulator *regulator)
+{
 	/*
 	 * Due to log structured nature of the lsregion allocator,
 	 * which is used for allocating statements, we cannot free
@@ -171,22 +261,18 @@ vy_regulator_update_dump_watermark(struct vy_regulator *regulator)
 	 *       write_rate      dump_bandwidth
 	 *
 	 * Be pessimistic when predicting the write rate - use the
-	 * max observed write rate multiplied by 1.5 - because it's
-	 * better to start memory dump early than delay it as long
-	 * as possible at the risk of experiencing unpredictably
-	 * long stalls.
+	 * max observed write rate, or the forecast if it's higher,
+	 * multiplied by 1.5 - because it's better to start memory
+	 * dump early than delay it as long as possible at the risk
+	 * of experiencing unpredictably long stalls.
 	 */
-	size_t write_rate = regulator->write_rate_max * 3 / 2;
+	regulator->dump_watermark_base =
+		vy_regulator_dump_watermark(regulator,
+					    regulator->write_rate_max);
 	regulator->dump_watermark =
-			(double)quota->limit * regulator->dump_bandwidth /
-			(regulator->dump_bandwidth + write_rate + 1);
-	/*
-	 * It doesn't make sense to set the watermark below 50%
-	 * of the memory limit because the write rate can exceed
-	 * the dump bandwidth under no circumstances.
-	 */
-	regulator->dump_watermark = MAX(regulator->dump_watermark,
-					quota->limit / 2);
+		vy_regulator_dump_watermark(regulator,
+				MAX(regulator->write_rate_max,
+				    regulator->write_rate_forecast));
 }
 
 static void
@@ -230,6 +316,7 @@ vy_regulator_create(struct vy_regulator *regulator, struct vy_quota *quota,
 	regulator->timer.data = regulator;
 	regulator->dump_bandwidth = VY_DUMP_BANDWIDTH_DEFAULT;
 	regulator->dump_watermark = SIZE_MAX;
+	regulator->dump_watermark_base = SIZE_MAX;
 }
 
 void
@@ -321,6 +408,9 @@ vy_regulator_reset_stat(struct vy_regulator *regulator)
 {
 	memset(&regulator->sched_stat_last, 0,
 	       sizeof(regulator->sched_stat_last));
+	regulator->burst_count = 0;
+	regulator->early_dump_count = 0;
+	regulator->throttle_avoided = 0;
 }
 
 /*
@@ -80,6 +80,27 @@ struct vy_regulator {
 	 * memory dump was triggered, in bytes per second.
 	 */
 	size_t write_rate_max;
+	/**
+	 * Average absolute deviation of the write rate measured
+	 * by the timer from @write_rate, in bytes per second.
+	 */
+	size_t write_rate_dev;
+	/**
+	 * Write rate measured by the timer last time, in bytes
+	 * per second. Needed to estimate the write rate trend.
+	 */
+	size_t write_rate_last;
+	/**
+	 * Write rate predicted for the time it takes to dump the
+	 * memory, in bytes per second. Normally, it's the upper
+	 * bound of the usual deviation from the average rate.
+	 * When a burst is detected, i.e. the write rate goes above
+	 * the bound, it's the current rate extrapolated with its
+	 * trend over the expected dump duration.
+	 */
+	size_t write_rate_forecast;
+	/** Number of write bursts detected. */
+	int64_t burst_count;
 	/**
 	 * Amount of memory that was used when the timer was
 	 * executed last time. Needed to update @write_rate.
@@ -108,6 +129,20 @@ struct vy_regulator {
 	 * background memory reclaim.
 	 */
 	size_t dump_watermark;
+	/**
+	 * Memory watermark computed from @write_rate_max only,
+	 * without the forecast. If a dump is triggered below it,
+	 * it is counted as started early.
+	 */
+	size_t dump_watermark_base;
+	/** Number of dumps started early thanks to the forecast. */
+	int64_t early_dump_count;
+	/**
+	 * Estimated time, in seconds, writers would have been
+	 * throttled if the dumps started early had been started
+	 * at @dump_watermark_base.
+	 */
+	double throttle_avoided;
 	/**
 	 * Set if the last triggered memory dump hasn't completed
 	 * yet, i.e. trigger_dump_cb() was successfully invoked,
@@ -30,7 +30,9 @@
  */
 #include "vy_run.h"
 
+#include <fcntl.h>
 #include <zstd.h>
+#include <zdict.h>
 
 #include "fiber.h"
 #include "fiber_cond.h"
@@ -74,6 +76,25 @@ const char *vy_file_suffix[] = {
 /* sync run and index files very 16 MB */
 #define VY_RUN_SYNC_INTERVAL (1 << 24)
 
+enum {
+	/**
+	 * Alignment of the file offset, size and buffer of
+	 * a read from a run file opened with O_DIRECT. It's
+	 * the logical block size of most storage devices.
+	 */
+	VY_RUN_DIRECT_IO_ALIGN = 4096,
+	/** zstd compression level used for dictionaries. */
+	VY_RUN_DICT_COMPRESSION_LEVEL = 3,
+	/**
+	 * Max and min total size of samples used for training
+	 * a dictionary, in dictionary sizes. The zstd manual
+	 * recommends that samples be ~100 times larger than
+	 * the dictionary.
+	 */
+	VY_RUN_DICT_SAMPLE_RATIO_MAX = 100,
+	VY_RUN_DICT_SAMPLE_RATIO_MIN = 10,
+};
+
 /**
  * We read runs in background threads so as not to stall tx.
  * This structure represents such a thread.
@@ -85,8 +106,38 @@ struct vy_run_reader {
 	struct cpipe reader_pipe;
 	/** Pipe from the reader thread to tx. */
 	struct cpipe tx_pipe;
+	/** Route of read-ahead requests, see vy_page_prefetch. */
+	struct cmsg_hop prefetch_route[2];
 };
 
+/** Key used for looking up a page in the page cache. */
+struct vy_page_cache_key {
+	/** ID of the run the page belongs to. */
+	int64_t run_id;
+	/** Page number in the run. */
+	uint32_t page_no;
+};
+
+static inline uint32_t
+vy_page_cache_hash(int64_t run_id, uint32_t page_no)
+{
+	uint64_t h = (uint64_t)run_id * 0x9E3779B97F4A7C15ULL + page_no;
+	return (uint32_t)(h ^ (h >> 32));
+}
+
+#define mh_name _vy_page_cache
+#define mh_key_t const struct vy_page_cache_key *
+#define mh_node_t struct vy_page *
+#define mh_arg_t int
+#define mh_hash(a, arg) (vy_page_cache_hash((*(a))->run_id, (*(a))->page_no))
+#define mh_hash_key(a, arg) (vy_page_cache_hash((a)->run_id, (a)->page_no))
+#define mh_cmp(a, b, arg) ((*(a))->run_id != (*(b))->run_id || \
+			   (*(a))->page_no != (*(b))->page_no)
+#define mh_cmp_key(a, b, arg) ((a)->run_id != (*(b))->run_id || \
+			       (a)->page_no != (*(b))->page_no)
+#define MH_SOURCE
+#include "salad/mhash.h"
+
 /** Cbus task for vinyl page read. */
 struct vy_page_read_task {
 	/** parent */
@@ -111,6 +162,46 @@ struct vy_page_read_task {
 	struct vy_page *page;
 };
 
+/**
+ * Request to read a page ahead. It is sent to a reader thread
+ * by a run iterator that detected a sequential scan. Unlike
+ * vy_page_read_task, the iterator doesn't wait for the request
+ * to complete: it picks up the page when it gets to it, see
+ * vy_run_iterator_load_page().
+ */
+struct vy_page_prefetch {
+	/** Message sent to the reader thread. */
+	struct cmsg base;
+	/** Run to read the page from. Referenced. */
+	struct vy_run *run;
+	/** Metadata of the page to read. */
+	struct vy_page_info *page_info;
+	/** Page number in the run. */
+	uint32_t page_no;
+	/** Page to read the data to. */
+	struct vy_page *page;
+	/** Set when the request returns to tx. */
+	bool is_done;
+	/** Set if the reader thread failed to read the page. */
+	bool is_failed;
+	/**
+	 * Set if the page isn't needed anymore while it's still
+	 * being read. The request is freed as soon as it returns
+	 * to tx then.
+	 */
+	bool is_orphan;
+	/** Signaled when the request returns to tx. */
+	struct fiber_cond done_cond;
+	/** Next request in vy_run_iterator::prefetch list. */
+	struct vy_page_prefetch *next;
+};
+
+static void
+vy_page_prefetch_read_f(struct cmsg *base);
+
+static void
+vy_page_prefetch_complete_f(struct cmsg *base);
+
 /** Destructor for env->zdctx_key thread-local variable */
 static void
 vy_free_zdctx(void *arg)
@@ -156,6 +247,10 @@ vy_run_env_start_readers(struct vy_run_env *env)
 				 vy_run_reader_f, reader) != 0)
 			panic("failed to start vinyl reader thread");
 		cpipe_create(&reader->reader_pipe, name);
+		reader->prefetch_route[0].f = vy_page_prefetch_read_f;
+		reader->prefetch_route[0].pipe = &reader->tx_pipe;
+		reader->prefetch_route[1].f = vy_page_prefetch_complete_f;
+		reader->prefetch_route[1].pipe = NULL;
 	}
 	env->next_reader = 0;
 }
@@ -184,6 +279,8 @@ vy_run_env_create(struct vy_run_env *env, int read_threads)
 	mempool_create(&env->read_task_pool, cord_slab_cache(),
 		       sizeof(struct vy_page_read_task));
 	env->initial_join = false;
+	env->page_cache.pages = mh_vy_page_cache_new();
+	rlist_create(&env->page_cache.lru);
 }
 
 /**
@@ -196,6 +293,9 @@ vy_run_env_destroy(struct vy_run_env *env)
 		vy_run_env_stop_readers(env);
 	mempool_destroy(&env->read_task_pool);
 	tt_pthread_key_delete(env->zdctx_key);
+	vy_run_env_set_page_cache_quota(env, 0);
+	assert(rlist_empty(&env->page_cache.lru));
+	mh_vy_page_cache_delete(env->page_cache.pages);
 }
 
 /**
@@ -269,6 +369,8 @@ vy_page_info_destroy(struct vy_page_info *page_info)
 {
 	if (page_info->min_key != NULL)
 		free(page_info->min_key);
+	if (page_info->bloom != NULL)
+		tuple_bloom_delete(page_info->bloom);
 }
 
 struct vy_run *
@@ -284,9 +386,11 @@ vy_run_new(struct vy_run_env *env, int64_t id)
 	run->id = id;
 	run->dump_lsn = -1;
 	run->fd = -1;
+	run->direct_fd = -1;
 	run->refs = 1;
 	rlist_create(&run->in_lsm);
 	rlist_create(&run->in_unused);
+	rlist_create(&run->cached_pages);
 	return run;
 }
 
@@ -310,14 +414,25 @@ vy_run_clear(struct vy_run *run)
 	run->info.min_key = NULL;
 	free(run->info.max_key);
 	run->info.max_key = NULL;
+	ZSTD_freeDDict(run->zddict);
+	run->zddict = NULL;
+	free(run->info.dict);
+	run->info.dict = NULL;
+	run->info.dict_size = 0;
 }
 
+static void
+vy_page_cache_invalidate_run(struct vy_page_cache *cache, struct vy_run *run);
+
 void
 vy_run_delete(struct vy_run *run)
 {
 	assert(run->refs == 0);
 	if (run->fd >= 0 && close(run->fd) < 0)
 		say_syserror("close failed");
+	if (run->direct_fd >= 0 && close(run->direct_fd) < 0)
+		say_syserror("close failed");
+	vy_page_cache_invalidate_run(&run->env->page_cache, run);
 	vy_run_clear(run);
 	TRASH(run);
 	free(run);
@@ -326,7 +441,15 @@ vy_run_delete(struct vy_run *run)
 size_t
 vy_run_bloom_size(struct vy_run *run)
 {
-	return run->info.bloom == NULL ? 0 : tuple_bloom_size(run->info.bloom);
+	size_t size = 0;
+	if (run->info.bloom != NULL)
+		size += tuple_bloom_size(run->info.bloom);
+	for (uint32_t i = 0; i < run->info.page_count; i++) {
+		struct vy_page_info *page_info = run->page_info + i;
+		if (page_info->bloom != NULL)
+			size += tuple_bloom_size(page_info->bloom);
+	}
+	return size;
 }
 
 /**
@@ -412,6 +535,51 @@ vy_page_index_find_page(struct vy_run *run, struct vy_entry key,
 	return page;
 }
 
+/** Return true if the run has a bloom filter. */
+static inline bool
+vy_run_has_bloom(struct vy_run *run)
+{
+	return run->info.bloom != NULL ||
+	       (run->info.page_count > 0 && run->page_info[0].bloom != NULL);
+}
+
+/**
+ * Check if a run may store a statement matching the given key.
+ * If bloom filters are partitioned by page, only the filters of
+ * the pages that may store the key are checked.
+ *
+ * @return true if there may be a matching statement in the run,
+ *  false if there is definitely no such statement.
+ */
+static bool
+vy_run_bloom_maybe_has(struct vy_run *run, struct vy_entry key,
+		       struct key_def *cmp_def, struct key_def *key_def)
+{
+	if (run->info.bloom != NULL)
+		return vy_bloom_maybe_has(run->info.bloom, key, key_def);
+	/*
+	 * Statements matching the key may be stored in pages
+	 * starting from the one preceding the first page with
+	 * min_key >= key and up to the last page with min_key
+	 * <= key.
+	 */
+	bool unused;
+	uint32_t last = vy_page_index_find_page(run, key, cmp_def,
+						ITER_LE, &unused);
+	if (last == run->info.page_count)
+		return false;
+	uint32_t first = vy_page_index_find_page(run, key, cmp_def,
+						 ITER_GE, &unused);
+	assert(first <= last);
+	for (uint32_t page_no = first; page_no <= last; page_no++) {
+		struct vy_page_info *page_info = vy_run_page_info(run, page_no);
+		if (page_info->bloom == NULL ||
+		    vy_bloom_maybe_has(page_info->bloom, key, key_def))
+			return true;
+	}
+	return false;
+}
+
 struct vy_slice *
 vy_slice_new(int64_t id, struct vy_run *run, struct vy_entry begin,
 	     struct vy_entry end, struct key_def *cmp_def)
@@ -527,6 +695,15 @@ vy_slice_cut(struct vy_slice *slice, int64_t id, struct vy_entry begin,
 	return 0;
 }
 
+bool
+vy_slice_bloom_maybe_has(struct vy_slice *slice, struct vy_entry key,
+			 struct key_def *cmp_def, struct key_def *key_def)
+{
+	if (!vy_run_has_bloom(slice->run))
+		return true;
+	return vy_run_bloom_maybe_has(slice->run, key, cmp_def, key_def);
+}
+
 /**
  * Decode page information from xrow.
  *
@@ -579,12 +756,20 @@ vy_page_info_decode(struct vy_page_info *page, const struct xrow_header *xrow,
 		case VY_PAGE_INFO_ROW_INDEX_OFFSET:
 			page->row_index_offset = mp_decode_uint(&pos);
 			break;
+		case VY_PAGE_INFO_BLOOM:
+			page->bloom = tuple_bloom_decode(&pos);
+			if (page->bloom == NULL) {
+				vy_page_info_destroy(page);
+				return -1;
+			}
+			break;
 		default:
 			mp_next(&pos); /* unknown key, ignore */
 			break;
 		}
 	}
 	if (key_map) {
+		vy_page_info_destroy(page);
 		enum vy_page_info_key key = bit_ctz_u64(key_map);
 		diag_set(ClientError, ER_INVALID_INDEX_FILE, filename,
 			 tt_sprintf("Can't decode page info: "
@@ -687,6 +872,16 @@ vy_run_info_decode(struct vy_run_info *run_info,
 		case VY_RUN_INFO_STMT_STAT:
 			vy_stmt_stat_decode(&run_info->stmt_stat, &pos);
 			break;
+		case VY_RUN_INFO_DICT:
+			tmp = mp_decode_bin(&pos, &run_info->dict_size);
+			run_info->dict = malloc(run_info->dict_size);
+			if (run_info->dict == NULL) {
+				diag_set(OutOfMemory, run_info->dict_size,
+					 "malloc", "run dict");
+				return -1;
+			}
+			memcpy(run_info->dict, tmp, run_info->dict_size);
+			break;
 		default:
 			mp_next(&pos); /* unknown key, ignore */
 			break;
@@ -712,6 +907,12 @@ vy_page_new(const struct vy_page_info *page_info)
 			 "load_page", "page cache");
 		return NULL;
 	}
+	page->run_id = -1;
+	page->page_no = 0;
+	page->refs = 1;
+	page->is_cached = false;
+	rlist_create(&page->in_lru);
+	rlist_create(&page->in_run);
 	page->unpacked_size = page_info->unpacked_size;
 	page->row_count = page_info->row_count;
 	page->row_index = calloc(page_info->row_count, sizeof(uint32_t));
@@ -736,6 +937,7 @@ vy_page_new(const struct vy_page_info *page_info)
 static void
 vy_page_delete(struct vy_page *page)
 {
+	assert(!page->is_cached);
 	uint32_t *row_index = page->row_index;
 	char *data = page->data;
 #if !defined(NDEBUG)
@@ -748,6 +950,167 @@ vy_page_delete(struct vy_page *page)
 	free(page);
 }
 
+static inline void
+vy_page_ref(struct vy_page *page)
+{
+	assert(page->refs > 0);
+	page->refs++;
+}
+
+static inline void
+vy_page_unref(struct vy_page *page)
+{
+	assert(page->refs > 0);
+	if (--page->refs == 0)
+		vy_page_delete(page);
+}
+
+/** Size of memory occupied by a page. */
+static inline size_t
+vy_page_mem_used(struct vy_page *page)
+{
+	return sizeof(*page) + page->unpacked_size +
+	       page->row_count * sizeof(uint32_t);
+}
+
+/**
+ * Remove a page from the page cache and drop the reference
+ * held by the cache.
+ */
+static void
+vy_page_cache_remove(struct vy_page_cache *cache, struct vy_page *page)
+{
+	assert(page->is_cached);
+	struct vy_page_cache_key key = {
+		.run_id = page->run_id,
+		.page_no = page->page_no,
+	};
+	mh_int_t pos = mh_vy_page_cache_find(cache->pages, &key, 0);
+	assert(pos != mh_end(cache->pages));
+	mh_vy_page_cache_del(cache->pages, pos, 0);
+	rlist_del_entry(page, in_lru);
+	rlist_del_entry(page, in_run);
+	assert(cache->mem_used >= vy_page_mem_used(page));
+	cache->mem_used -= vy_page_mem_used(page);
+	page->is_cached = false;
+	vy_page_unref(page);
+}
+
+/**
+ * Evict least recently used pages from the cache until
+ * the memory usage fits in the quota.
+ */
+static void
+vy_page_cache_evict(struct vy_page_cache *cache)
+{
+	while (cache->mem_used > cache->quota) {
+		assert(!rlist_empty(&cache->lru));
+		struct vy_page *page = rlist_last_entry(&cache->lru,
+							struct vy_page,
+							in_lru);
+		vy_page_cache_remove(cache, page);
+		cache->stat.evict++;
+	}
+}
+
+/**
+ * Look up a page in the cache. On success, the page is moved
+ * to the head of the LRU list and returned, otherwise NULL
+ * is returned. Note, the caller must take a reference to the
+ * page if it wants to use it.
+ */
+static struct vy_page *
+vy_page_cache_get(struct vy_page_cache *cache, int64_t run_id,
+		  uint32_t page_no)
+{
+	if (cache->quota == 0)
+		return NULL;
+	struct vy_page_cache_key key = {
+		.run_id = run_id,
+		.page_no = page_no,
+	};
+	mh_int_t pos = mh_vy_page_cache_find(cache->pages, &key, 0);
+	if (pos == mh_end(cache->pages)) {
+		cache->stat.miss++;
+		return NULL;
+	}
+	cache->stat.hit++;
+	struct vy_page *page = *mh_vy_page_cache_node(cache->pages, pos);
+	assert(page->is_cached);
+	rlist_move_entry(&cache->lru, page, in_lru);
+	return page;
+}
+
+/**
+ * Check if a page is stored in the cache. Unlike
+ * vy_page_cache_get(), doesn't update the LRU list
+ * and statistics.
+ */
+static bool
+vy_page_cache_has(struct vy_page_cache *cache, int64_t run_id,
+		  uint32_t page_no)
+{
+	if (cache->quota == 0)
+		return false;
+	struct vy_page_cache_key key = {
+		.run_id = run_id,
+		.page_no = page_no,
+	};
+	return mh_vy_page_cache_find(cache->pages, &key, 0) !=
+	       mh_end(cache->pages);
+}
+
+/**
+ * Add a page read from the given run to the cache. Does nothing
+ * if the page is too big to be cached.
+ */
+static void
+vy_page_cache_put(struct vy_page_cache *cache, struct vy_run *run,
+		  struct vy_page *page)
+{
+	assert(!page->is_cached);
+	assert(page->run_id == run->id);
+	size_t size = vy_page_mem_used(page);
+	if (size > cache->quota)
+		return;
+	struct vy_page *replaced = NULL;
+	mh_vy_page_cache_put(cache->pages, &page, &replaced, 0);
+	if (replaced != NULL) {
+		/*
+		 * The same page could have been read by another
+		 * fiber while we were waiting for the disk.
+		 */
+		assert(replaced->is_cached);
+		rlist_del_entry(replaced, in_lru);
+		rlist_del_entry(replaced, in_run);
+		cache->mem_used -= vy_page_mem_used(replaced);
+		replaced->is_cached = false;
+		vy_page_unref(replaced);
+	}
+	vy_page_ref(page);
+	page->is_cached = true;
+	rlist_add_entry(&cache->lru, page, in_lru);
+	rlist_add_entry(&run->cached_pages, page, in_run);
+	cache->mem_used += size;
+	vy_page_cache_evict(cache);
+}
+
+/** Remove all pages of a run from the cache. */
+static void
+vy_page_cache_invalidate_run(struct vy_page_cache *cache, struct vy_run *run)
+{
+	struct vy_page *page, *tmp;
+	rlist_foreach_entry_safe(page, &run->cached_pages, in_run, tmp)
+		vy_page_cache_remove(cache, page);
+}
+
+void
+vy_run_env_set_page_cache_quota(struct vy_run_env *env, size_t quota)
+{
+	env->page_cache.quota = quota;
+	vy_page_cache_evict(&env->page_cache);
+}
+
 static int
 vy_page_xrow(struct vy_page *page, uint32_t stmt_no,
 	     struct xrow_header *xrow)
@@ -787,6 +1150,60 @@ vy_page_stmt(struct vy_page *page, uint32_t stmt_no,
 	return entry;
 }
 
+/**
+ * Compare a statement of the page with the given key. Unlike
+ * vy_page_stmt(), doesn't allocate a statement: the key is compared
+ * with the MessagePack of the xrow body. Key fields of a tuple are
+ * extracted to the fiber region, which is truncated on return.
+ * @param page          Page.
+ * @param stmt_no       Statement position in the page.
+ * @param key           Key to compare with.
+ * @param cmp_def       Definition of keys stored in the page.
+ * @param format        Format for REPLACE/DELETE tuples.
+ * @param[out] cmp      Comparison result, as vy_entry_compare()
+ *                      of the statement and the key.
+ *
+ * @retval  0 Success.
+ * @retval -1 Memory error or invalid statement.
+ */
+static int
+vy_page_compare_stmt(struct vy_page *page, uint32_t stmt_no,
+		     struct vy_entry key, struct key_def *cmp_def,
+		     struct tuple_format *format, int *cmp)
+{
+	struct xrow_header xrow;
+	if (vy_page_xrow(page, stmt_no, &xrow) != 0)
+		return -1;
+	/* See vy_stmt_decode(). */
+	struct request request;
+	uint64_t key_map = dml_request_key_map(xrow.type);
+	key_map &= ~(1ULL << IPROTO_SPACE_ID);
+	if (xrow_decode_dml(&xrow, &request, key_map) != 0)
+		return -1;
+	const char *data;
+	uint32_t size;
+	struct region *region = &fiber()->gc;
+	size_t region_svp = region_used(region);
+	if (request.type == IPROTO_DELETE) {
+		/* DELETE statements are always stored as keys. */
+		data = request.key;
+	} else if (vy_stmt_is_key_format(format)) {
+		/* Secondary index statements are keys, too. */
+		data = request.tuple;
+	} else {
+		data = tuple_extract_key_raw(request.tuple, request.tuple_end,
+					     cmp_def, MULTIKEY_NONE, &size);
+		if (data == NULL)
+			return -1;
+	}
+	const char *key_data = data;
+	uint32_t part_count = mp_decode_array(&key_data);
+	hint_t hint = key_hint(key_data, part_count, cmp_def);
+	*cmp = -vy_entry_compare_with_raw_key(key, data, hint, cmp_def);
+	region_truncate(region, region_svp);
+	return 0;
+}
+
 /**
  * Binary search in page
  * In terms of STL, makes lower_bound for EQ,GE,LT and upper_bound for GT,LE
@@ -807,18 +1224,16 @@ vy_page_find_key(struct vy_page *page, struct vy_entry key,
 			iterator_type == ITER_LE ? -1 : 0);
 	while (beg != end) {
 		uint32_t mid = beg + (end - beg) / 2;
-		struct vy_entry fnd_key = vy_page_stmt(page, mid, cmp_def,
-						       format);
-		if (fnd_key.stmt == NULL)
+		int cmp;
+		if (vy_page_compare_stmt(page, mid, key, cmp_def,
+					 format, &cmp) != 0)
 			return end;
-		int cmp = vy_entry_compare(fnd_key, key, cmp_def);
 		cmp = cmp ? cmp : zero_cmp;
 		*equal_key = *equal_key || cmp == 0;
 		if (cmp < 0)
 			beg = mid + 1;
 		else
 			end = mid;
-		tuple_unref(fnd_key.stmt);
 	}
 	return end;
 }
@@ -834,9 +1249,9 @@ vy_run_iterator_stop(struct vy_run_iterator *itr)
 		itr->curr = vy_entry_none();
 	}
 	if (itr->curr_page != NULL) {
-		vy_page_delete(itr->curr_page);
+		vy_page_unref(itr->curr_page);
 		if (itr->prev_page != NULL)
-			vy_page_delete(itr->prev_page);
+			vy_page_unref(itr->prev_page);
 		itr->curr_page = itr->prev_page = NULL;
 	}
 }
@@ -873,6 +1288,26 @@ vy_row_index_decode(uint32_t *row_index, uint32_t row_count,
 	return 0;
 }
 
+/**
+ * If direct I/O is enabled, open a run data file with O_DIRECT for
+ * reading pages. A failure isn't an error: some file systems don't
+ * support O_DIRECT, in which case the run is read as usual.
+ */
+static void
+vy_run_open_direct(struct vy_run *run, const char *path)
+{
+	assert(run->direct_fd < 0);
+	if (!run->env->direct_io)
+		return;
+#ifdef O_DIRECT
+	run->direct_fd = open(path, O_RDONLY | O_DIRECT);
+	if (run->direct_fd < 0)
+		say_syserror("failed to open `%s' for direct I/O", path);
+#else
+	(void)path;
+#endif
+}
+
 /** Return the name of a run data file. */
 static inline const char *
 vy_run_filename(struct vy_run *run)
@@ -882,6 +1317,39 @@ vy_run_filename(struct vy_run *run)
 	return buf;
 }
 
+/**
+ * Read a page of a run file opened with O_DIRECT. The offset, the
+ * size and the buffer of a direct read must be aligned, so the
+ * function reads the smallest aligned block of the file containing
+ * the page. On return, @data points to the page data in the block
+ * and @readen is set to the number of bytes of the page read or -1
+ * on I/O error, like the return value of fio_pread(). Returns -1 on
+ * memory allocation error, 0 otherwise.
+ */
+static int
+vy_page_read_direct(const struct vy_page_info *page_info,
+		    struct vy_run *run, char **data, ssize_t *readen)
+{
+	off_t begin = page_info->offset &
+		      ~((off_t)VY_RUN_DIRECT_IO_ALIGN - 1);
+	size_t head = page_info->offset - begin;
+	size_t size = small_align(head + page_info->size,
+				  VY_RUN_DIRECT_IO_ALIGN);
+	char *buf = (char *)region_aligned_alloc(&fiber()->gc, size,
+						 VY_RUN_DIRECT_IO_ALIGN);
+	if (buf == NULL) {
+		diag_set(OutOfMemory, size, "region gc", "page");
+		return -1;
+	}
+	*data = buf + head;
+	*readen = fio_pread(run->direct_fd, buf, size, begin);
+	if (*readen >= 0) {
+		*readen = MIN((size_t)MAX(*readen - (ssize_t)head, 0),
+			      page_info->size);
+	}
+	return 0;
+}
+
 /**
  * Read a page requests from vinyl xlog data file.
  *
@@ -894,13 +1362,21 @@ vy_page_read(struct vy_page *page, const struct vy_page_info *page_info,
 {
 	/* read xlog tx from xlog file */
 	size_t region_svp = region_used(&fiber()->gc);
-	char *data = (char *)region_alloc(&fiber()->gc, page_info->size);
-	if (data == NULL) {
-		diag_set(OutOfMemory, page_info->size, "region gc", "page");
-		return -1;
-	}
-	ssize_t readen = fio_pread(run->fd, data, page_info->size,
+	char *data;
+	ssize_t readen;
+	if (run->direct_fd >= 0) {
+		if (vy_page_read_direct(page_info, run, &data, &readen) != 0)
+			goto error;
+	} else {
+		data = (char *)region_alloc(&fiber()->gc, page_info->size);
+		if (data == NULL) {
+			diag_set(OutOfMemory, page_info->size,
+				 "region gc", "page");
+			return -1;
+		}
+		readen = fio_pread(run->fd, data, page_info->size,
 				   page_info->offset);
+	}
 	ERROR_INJECT(ERRINJ_VYRUN_DATA_READ, {
 		readen = -1;
 		errno = EIO;});
@@ -925,7 +1401,8 @@ vy_page_read(struct vy_page *page, const struct vy_page_info *page_info,
 	const char *data_end = data + readen;
 	char *rows = page->data;
 	char *rows_end = rows + page_info->unpacked_size;
-	if (xlog_tx_decode(data, data_end, rows, rows_end, zdctx) != 0)
+	if (xlog_tx_decode(data, data_end, rows, rows_end, zdctx,
+			   run->zddict) != 0)
 		goto error;
 
 	struct xrow_header xrow;
@@ -996,46 +1473,244 @@ vy_page_read_cb(struct cbus_call_msg *base)
 	return 0;
 }
 
+/** Read-ahead request callback, executed by a reader thread. */
+static void
+vy_page_prefetch_read_f(struct cmsg *base)
+{
+	struct vy_page_prefetch *prefetch = (struct vy_page_prefetch *)base;
+	struct vy_run *run = prefetch->run;
+	ZSTD_DStream *zdctx = vy_env_get_zdctx(run->env);
+	if (zdctx == NULL ||
+	    vy_page_read(prefetch->page, prefetch->page_info,
+			 run, zdctx) != 0) {
+		/*
+		 * Read-ahead is optional. The iterator will retry
+		 * to read the page and report the error if needed.
+		 */
+		prefetch->is_failed = true;
+		diag_clear(diag_get());
+	}
+}
+
+/** Free a read-ahead request that returned to tx. */
+static void
+vy_page_prefetch_delete(struct vy_page_prefetch *prefetch)
+{
+	assert(prefetch->is_done);
+	if (prefetch->page != NULL)
+		vy_page_delete(prefetch->page);
+	vy_run_unref(prefetch->run);
+	fiber_cond_destroy(&prefetch->done_cond);
+	free(prefetch);
+}
+
+/** Read-ahead request callback, executed in tx. */
+static void
+vy_page_prefetch_complete_f(struct cmsg *base)
+{
+	struct vy_page_prefetch *prefetch = (struct vy_page_prefetch *)base;
+	prefetch->is_done = true;
+	if (prefetch->is_orphan)
+		vy_page_prefetch_delete(prefetch);
+	else
+		fiber_cond_broadcast(&prefetch->done_cond);
+}
+
 /**
- * Read a page from disk given its number.
- * The function caches two most recently read pages.
- *
- * @retval 0 success
- * @retval -1 critical error
+ * Drop a read-ahead request. If the request is still in progress,
+ * it will be freed when it returns to tx.
  */
-static NODISCARD int
-vy_run_iterator_load_page(struct vy_run_iterator *itr, uint32_t page_no,
-			  struct vy_entry key, enum iterator_type iterator_type,
-			  struct vy_page **result, uint32_t *pos_in_page,
-			  bool *equal_found)
+static void
+vy_page_prefetch_discard(struct vy_page_prefetch *prefetch)
 {
-	struct vy_slice *slice = itr->slice;
-	struct vy_run_env *env = slice->run->env;
+	if (prefetch->is_done)
+		vy_page_prefetch_delete(prefetch);
+	else
+		prefetch->is_orphan = true;
+}
 
-	/* Check cache */
+/**
+ * Wait for a read-ahead request to complete, free it and
+ * return the page. The reference to the page is passed to
+ * the caller. Returns NULL if the page failed to be read.
+ */
+static struct vy_page *
+vy_page_prefetch_take(struct vy_page_prefetch *prefetch)
+{
+	bool cancellable = fiber_set_cancellable(false);
+	while (!prefetch->is_done)
+		fiber_cond_wait(&prefetch->done_cond);
+	fiber_set_cancellable(cancellable);
 	struct vy_page *page = NULL;
-	if (itr->curr_page != NULL &&
-	    itr->curr_page->page_no == page_no) {
-		page = itr->curr_page;
-	} else if (itr->prev_page != NULL &&
-		   itr->prev_page->page_no == page_no) {
-		SWAP(itr->prev_page, itr->curr_page);
-		page = itr->curr_page;
+	if (!prefetch->is_failed) {
+		page = prefetch->page;
+		prefetch->page = NULL;
 	}
-	if (page != NULL) {
-		if (key.stmt != NULL)
-			*pos_in_page = vy_page_find_key(page, key, itr->cmp_def,
-							itr->format, iterator_type,
-							equal_found);
-		*result = page;
-		return 0;
+	vy_page_prefetch_delete(prefetch);
+	return page;
+}
+
+/**
+ * Remove the read-ahead request for the given page from
+ * an iterator and return it. Returns NULL if the page
+ * wasn't read ahead.
+ */
+static struct vy_page_prefetch *
+vy_run_iterator_remove_prefetch(struct vy_run_iterator *itr, uint32_t page_no)
+{
+	struct vy_page_prefetch **prev = &itr->prefetch;
+	for (struct vy_page_prefetch *prefetch = itr->prefetch;
+	     prefetch != NULL; prefetch = prefetch->next) {
+		if (prefetch->page_no == page_no) {
+			*prev = prefetch->next;
+			prefetch->next = NULL;
+			return prefetch;
+		}
+		prev = &prefetch->next;
+	}
+	return NULL;
+}
+
+/** Drop all pages read ahead by an iterator. */
+static void
+vy_run_iterator_discard_prefetch(struct vy_run_iterator *itr)
+{
+	struct vy_page_prefetch *prefetch = itr->prefetch;
+	while (prefetch != NULL) {
+		struct vy_page_prefetch *next = prefetch->next;
+		vy_page_prefetch_discard(prefetch);
+		prefetch = next;
+	}
+	itr->prefetch = NULL;
+}
+
+/** Check if an iterator has a page read ahead or loaded. */
+static bool
+vy_run_iterator_has_page(struct vy_run_iterator *itr, uint32_t page_no)
+{
+	if (itr->curr_page != NULL && itr->curr_page->page_no == page_no)
+		return true;
+	if (itr->prev_page != NULL && itr->prev_page->page_no == page_no)
+		return true;
+	for (struct vy_page_prefetch *prefetch = itr->prefetch;
+	     prefetch != NULL; prefetch = prefetch->next) {
+		if (prefetch->page_no == page_no)
+			return true;
+	}
+	return false;
+}
+
+/**
+ * Send a request to read a page to a reader thread without
+ * waiting for it to complete. Errors are ignored, because
+ * read-ahead is optional.
+ */
+static void
+vy_run_iterator_prefetch_page(struct vy_run_iterator *itr, uint32_t page_no)
+{
+	struct vy_run *run = itr->slice->run;
+	struct vy_run_env *env = run->env;
+	struct vy_page_prefetch *prefetch = malloc(sizeof(*prefetch));
+	if (prefetch == NULL)
+		return;
+	prefetch->page_info = vy_run_page_info(run, page_no);
+	prefetch->page = vy_page_new(prefetch->page_info);
+	if (prefetch->page == NULL) {
+		diag_clear(diag_get());
+		free(prefetch);
+		return;
+	}
+	prefetch->page->run_id = run->id;
+	prefetch->page->page_no = page_no;
+	prefetch->run = run;
+	vy_run_ref(run);
+	prefetch->page_no = page_no;
+	prefetch->is_done = false;
+	prefetch->is_failed = false;
+	prefetch->is_orphan = false;
+	fiber_cond_create(&prefetch->done_cond);
+	prefetch->next = itr->prefetch;
+	itr->prefetch = prefetch;
+
+	struct vy_run_reader *reader;
+	reader = &env->reader_pool[env->next_reader++];
+	env->next_reader %= env->reader_pool_size;
+	cmsg_init(&prefetch->base, reader->prefetch_route);
+	cpipe_push(&reader->reader_pipe, &prefetch->base);
+
+	itr->stat->prefetch.pages++;
+}
+
+/**
+ * Called when an iterator switches to another page. If the page
+ * follows the previously loaded one in the iteration direction,
+ * the iterator is considered to scan the run sequentially and
+ * the pages following the given one are read ahead. Otherwise,
+ * pages read ahead so far are dropped.
+ */
+static void
+vy_run_iterator_read_ahead(struct vy_run_iterator *itr, uint32_t page_no)
+{
+	struct vy_slice *slice = itr->slice;
+	struct vy_run_env *env = slice->run->env;
+	int dir = iterator_direction(itr->iterator_type);
+	if (itr->last_page_no != UINT32_MAX &&
+	    (int64_t)page_no == (int64_t)itr->last_page_no + dir) {
+		itr->seq_page_count++;
+	} else {
+		itr->seq_page_count = 0;
+		vy_run_iterator_discard_prefetch(itr);
+	}
+	itr->last_page_no = page_no;
+	/* Reads are blocking during WAL recovery. */
+	if (env->read_ahead == 0 || env->reader_pool == NULL ||
+	    itr->seq_page_count == 0)
+		return;
+	for (uint32_t i = 1; i <= env->read_ahead; i++) {
+		int64_t next_page_no = (int64_t)page_no + dir * (int64_t)i;
+		if (next_page_no < slice->first_page_no ||
+		    next_page_no > slice->last_page_no)
+			break;
+		uint32_t next = (uint32_t)next_page_no;
+		if (vy_run_iterator_has_page(itr, next) ||
+		    vy_page_cache_has(&env->page_cache, slice->run->id, next))
+			continue;
+		vy_run_iterator_prefetch_page(itr, next);
 	}
+}
+
+/**
+ * Remember a page in the iterator. The iterator keeps two most
+ * recently used pages. The reference to the page is passed to
+ * the iterator.
+ */
+static void
+vy_run_iterator_cache_page(struct vy_run_iterator *itr, struct vy_page *page)
+{
+	if (itr->prev_page != NULL)
+		vy_page_unref(itr->prev_page);
+	itr->prev_page = itr->curr_page;
+	itr->curr_page = page;
+}
+
+/**
+ * Read a page from disk on behalf of a reader thread and look up
+ * a key in it. Returns the page, with a reference passed to the
+ * caller, or NULL on error.
+ */
+static struct vy_page *
+vy_run_iterator_read_page(struct vy_run_iterator *itr, uint32_t page_no,
+			  struct vy_entry key, enum iterator_type iterator_type,
+			  uint32_t *pos_in_page, bool *equal_found)
+{
+	struct vy_slice *slice = itr->slice;
+	struct vy_run_env *env = slice->run->env;
 
 	/* Allocate buffers */
 	struct vy_page_info *page_info = vy_run_page_info(slice->run, page_no);
-	page = vy_page_new(page_info);
+	struct vy_page *page = vy_page_new(page_info);
 	if (page == NULL)
-		return -1;
+		return NULL;
 
 	/* Read page data from the disk */
 	struct vy_page_read_task *task = mempool_alloc(&env->read_task_pool);
@@ -1043,7 +1718,7 @@ vy_run_iterator_load_page(struct vy_run_iterator *itr, uint32_t page_no,
 		diag_set(OutOfMemory, sizeof(*task),
 			 "mempool", "vy_page_read_task");
 		vy_page_delete(page);
-		return -1;
+		return NULL;
 	}
 	task->run = slice->run;
 	task->page_info = page_info;
@@ -1063,15 +1738,84 @@ vy_run_iterator_load_page(struct vy_run_iterator *itr, uint32_t page_no,
 	mempool_free(&env->read_task_pool, task);
 	if (rc != 0) {
 		vy_page_delete(page);
-		return -1;
+		return NULL;
+	}
+	page->run_id = slice->run->id;
+	page->page_no = page_no;
+	return page;
+}
+
+/**
+ * Read a page from disk given its number.
+ * The function caches two most recently read pages in the
+ * iterator and looks up pages in the shared page cache and
+ * among pages read ahead before reading them from disk.
+ *
+ * @retval 0 success
+ * @retval -1 critical error
+ */
+static NODISCARD int
+vy_run_iterator_load_page(struct vy_run_iterator *itr, uint32_t page_no,
+			  struct vy_entry key, enum iterator_type iterator_type,
+			  struct vy_page **result, uint32_t *pos_in_page,
+			  bool *equal_found)
+{
+	struct vy_slice *slice = itr->slice;
+	struct vy_run_env *env = slice->run->env;
+
+	/* Check cache */
+	struct vy_page *page = NULL;
+	struct vy_page_prefetch *prefetch = NULL;
+	if (itr->curr_page != NULL &&
+	    itr->curr_page->page_no == page_no) {
+		page = itr->curr_page;
+	} else if (itr->prev_page != NULL &&
+		   itr->prev_page->page_no == page_no) {
+		SWAP(itr->prev_page, itr->curr_page);
+		page = itr->curr_page;
+	} else {
+		vy_run_iterator_read_ahead(itr, page_no);
+		prefetch = vy_run_iterator_remove_prefetch(itr, page_no);
+		page = vy_page_cache_get(&env->page_cache,
+					 slice->run->id, page_no);
+		if (page != NULL) {
+			vy_page_ref(page);
+			vy_run_iterator_cache_page(itr, page);
+			if (prefetch != NULL)
+				vy_page_prefetch_discard(prefetch);
+		}
+	}
+	if (page != NULL) {
+		if (key.stmt != NULL)
+			*pos_in_page = vy_page_find_key(page, key, itr->cmp_def,
+							itr->format, iterator_type,
+							equal_found);
+		*result = page;
+		return 0;
+	}
+
+	struct vy_page_info *page_info = vy_run_page_info(slice->run, page_no);
+
+	/* Use the page read ahead, if any */
+	if (prefetch != NULL)
+		page = vy_page_prefetch_take(prefetch);
+	if (page != NULL) {
+		itr->stat->prefetch.hit++;
+		if (key.stmt != NULL)
+			*pos_in_page = vy_page_find_key(page, key, itr->cmp_def,
+							itr->format, iterator_type,
+							equal_found);
+	} else {
+		page = vy_run_iterator_read_page(itr, page_no, key,
+						 iterator_type, pos_in_page,
+						 equal_found);
+		if (page == NULL)
+			return -1;
 	}
 
 	/* Update cache */
-	if (itr->prev_page != NULL)
-		vy_page_delete(itr->prev_page);
-	itr->prev_page = itr->curr_page;
-	itr->curr_page = page;
-	page->page_no = page_no;
+	vy_page_cache_put(&env->page_cache, slice->run, page);
+	vy_run_iterator_cache_page(itr, page);
 
 	/* Update read statistics. */
 	itr->stat->read.rows += page_info->row_count;
@@ -1342,7 +2086,6 @@ vy_run_iterator_seek(struct vy_run_iterator *itr, struct vy_entry last,
 {
 	struct key_def *cmp_def = itr->cmp_def;
 	struct vy_slice *slice = itr->slice;
-	struct tuple_bloom *bloom = slice->run->info.bloom;
 	struct vy_entry key = itr->key;
 	enum iterator_type iterator_type = itr->iterator_type;
 
@@ -1351,8 +2094,11 @@ vy_run_iterator_seek(struct vy_run_iterator *itr, struct vy_entry last,
 
 	/* Check the bloom filter on the first iteration. */
 	bool check_bloom = (itr->iterator_type == ITER_EQ &&
-			    itr->curr.stmt == NULL && bloom != NULL);
-	if (check_bloom && !vy_bloom_maybe_has(bloom, itr->key, itr->key_def)) {
+			    itr->curr.stmt == NULL &&
+			    vy_run_has_bloom(slice->run));
+	if (check_bloom &&
+	    !vy_run_bloom_maybe_has(slice->run, itr->key, cmp_def,
+				    itr->key_def)) {
 		vy_run_iterator_stop(itr);
 		itr->stat->bloom_hit++;
 		return 0;
@@ -1483,6 +2229,9 @@ vy_run_iterator_open(struct vy_run_iterator *itr,
 	itr->curr_pos.page_no = slice->run->info.page_count;
 	itr->curr_page = NULL;
 	itr->prev_page = NULL;
+	itr->prefetch = NULL;
+	itr->last_page_no = UINT32_MAX;
+	itr->seq_page_count = 0;
 	itr->search_started = false;
 
 	/*
@@ -1636,6 +2385,7 @@ void
 vy_run_iterator_close(struct vy_run_iterator *itr)
 {
 	vy_run_iterator_stop(itr);
+	vy_run_iterator_discard_prefetch(itr);
 	tuple_format_unref(itr->format);
 	TRASH(itr);
 }
@@ -1656,6 +2406,26 @@ vy_run_acct_page(struct vy_run *run, struct vy_page_info *page)
 	run->count.pages++;
 }
 
+/**
+ * Digest the dictionary of a run, if any, for decompressing
+ * run pages.
+ */
+static int
+vy_run_load_dict(struct vy_run *run)
+{
+	assert(run->zddict == NULL);
+	if (run->info.dict == NULL)
+		return 0;
+	run->zddict = ZSTD_createDDict_byReference(run->info.dict,
+						   run->info.dict_size);
+	if (run->zddict == NULL) {
+		diag_set(OutOfMemory, run->info.dict_size, "zstd",
+			 "run dict");
+		return -1;
+	}
+	return 0;
+}
+
 int
 vy_run_recover(struct vy_run *run, const char *dir,
 	       uint32_t space_id, uint32_t iid, struct key_def *cmp_def)
@@ -1707,6 +2477,8 @@ vy_run_recover(struct vy_run *run, const char *dir,
 
 	if (vy_run_info_decode(&run->info, &xrow, path) != 0)
 		goto fail_close;
+	if (vy_run_load_dict(run) != 0)
+		goto fail_close;
 
 	/* Allocate buffer for page info. */
 	run->page_info = calloc(run->info.page_count,
@@ -1769,6 +2541,7 @@ vy_run_recover(struct vy_run *run, const char *dir,
 	}
 	run->fd = cursor.fd;
 	xlog_cursor_close(&cursor, true);
+	vy_run_open_direct(run, path);
 	return 0;
 
 fail_close:
@@ -1885,9 +2658,10 @@ vy_page_info_encode(const struct vy_page_info *page_info,
 	min_key_size = tmp - page_info->min_key;
 
 	/* calc tuple size */
+	uint32_t map_size = page_info->bloom != NULL ? 7 : 6;
 	uint32_t size;
 	/* 3 items: page offset, size, and map */
-	size = mp_sizeof_map(6) +
+	size = mp_sizeof_map(map_size) +
 	       mp_sizeof_uint(VY_PAGE_INFO_OFFSET) +
 	       mp_sizeof_uint(page_info->offset) +
 	       mp_sizeof_uint(VY_PAGE_INFO_SIZE) +
@@ -1900,6 +2674,9 @@ vy_page_info_encode(const struct vy_page_info *page_info,
 	       mp_sizeof_uint(page_info->unpacked_size) +
 	       mp_sizeof_uint(VY_PAGE_INFO_ROW_INDEX_OFFSET) +
 	       mp_sizeof_uint(page_info->row_index_offset);
+	if (page_info->bloom != NULL)
+		size += mp_sizeof_uint(VY_PAGE_INFO_BLOOM) +
+			tuple_bloom_size(page_info->bloom);
 
 	char *pos = region_alloc(region, size);
 	if (pos == NULL) {
@@ -1910,7 +2687,7 @@ vy_page_info_encode(const struct vy_page_info *page_info,
 	memset(xrow, 0, sizeof(*xrow));
 	/* encode page */
 	xrow->body->iov_base = pos;
-	pos = mp_encode_map(pos, 6);
+	pos = mp_encode_map(pos, map_size);
 	pos = mp_encode_uint(pos, VY_PAGE_INFO_OFFSET);
 	pos = mp_encode_uint(pos, page_info->offset);
 	pos = mp_encode_uint(pos, VY_PAGE_INFO_SIZE);
@@ -1924,6 +2701,10 @@ vy_page_info_encode(const struct vy_page_info *page_info,
 	pos = mp_encode_uint(pos, page_info->unpacked_size);
 	pos = mp_encode_uint(pos, VY_PAGE_INFO_ROW_INDEX_OFFSET);
 	pos = mp_encode_uint(pos, page_info->row_index_offset);
+	if (page_info->bloom != NULL) {
+		pos = mp_encode_uint(pos, VY_PAGE_INFO_BLOOM);
+		pos = tuple_bloom_encode(page_info->bloom, pos);
+	}
 	xrow->body->iov_len = (void *)pos - xrow->body->iov_base;
 	xrow->bodycnt = 1;
 
@@ -1991,6 +2772,8 @@ vy_run_info_encode(const struct vy_run_info *run_info,
 	uint32_t key_count = 6;
 	if (run_info->bloom != NULL)
 		key_count++;
+	if (run_info->dict != NULL)
+		key_count++;
 
 	size_t size = mp_sizeof_map(key_count);
 	size += mp_sizeof_uint(VY_RUN_INFO_MIN_KEY) + min_key_size;
@@ -2006,6 +2789,9 @@ vy_run_info_encode(const struct vy_run_info *run_info,
 			tuple_bloom_size(run_info->bloom);
 	size += mp_sizeof_uint(VY_RUN_INFO_STMT_STAT) +
 		vy_stmt_stat_sizeof(&run_info->stmt_stat);
+	if (run_info->dict != NULL)
+		size += mp_sizeof_uint(VY_RUN_INFO_DICT) +
+			mp_sizeof_bin(run_info->dict_size);
 
 	char *pos = region_alloc(&fiber()->gc, size);
 	if (pos == NULL) {
@@ -2034,6 +2820,10 @@ vy_run_info_encode(const struct vy_run_info *run_info,
 	}
 	pos = mp_encode_uint(pos, VY_RUN_INFO_STMT_STAT);
 	pos = vy_stmt_stat_encode(&run_info->stmt_stat, pos);
+	if (run_info->dict != NULL) {
+		pos = mp_encode_uint(pos, VY_RUN_INFO_DICT);
+		pos = mp_encode_bin(pos, run_info->dict, run_info->dict_size);
+	}
 	xrow->body->iov_len = (void *)pos - xrow->body->iov_base;
 	xrow->bodycnt = 1;
 	xrow->type = VY_INDEX_RUN_INFO;
@@ -2062,6 +2852,7 @@ vy_run_write_index(struct vy_run *run, const char *dirpath,
 	struct xlog_opts opts = xlog_opts_default;
 	opts.rate_limit = run->env->snap_io_rate_limit;
 	opts.sync_interval = VY_RUN_SYNC_INTERVAL;
+	opts.free_cache = run->env->direct_io;
 	if (xlog_create(&index_xlog, path, 0, &meta, &opts) < 0)
 		return -1;
 
@@ -2113,7 +2904,8 @@ int
 vy_run_writer_create(struct vy_run_writer *writer, struct vy_run *run,
 		     const char *dirpath, uint32_t space_id, uint32_t iid,
 		     struct key_def *cmp_def, struct key_def *key_def,
-		     uint64_t page_size, double bloom_fpr, bool no_compression)
+		     uint64_t page_size, double bloom_fpr,
+		     bool bloom_partitioned, bool no_compression)
 {
 	memset(writer, 0, sizeof(*writer));
 	writer->run = run;
@@ -2124,6 +2916,7 @@ vy_run_writer_create(struct vy_run_writer *writer, struct vy_run *run,
 	writer->key_def = key_def;
 	writer->page_size = page_size;
 	writer->bloom_fpr = bloom_fpr;
+	writer->bloom_partitioned = bloom_partitioned;
 	writer->no_compression = no_compression;
 	if (bloom_fpr < 1) {
 		writer->bloom = tuple_bloom_builder_new(key_def->part_count);
@@ -2133,12 +2926,107 @@ vy_run_writer_create(struct vy_run_writer *writer, struct vy_run *run,
 	xlog_clear(&writer->data_xlog);
 	ibuf_create(&writer->row_index_buf, &cord()->slabc,
 		    4096 * sizeof(uint32_t));
+	ibuf_create(&writer->dict_samples, &cord()->slabc, 16 * 1024);
+	ibuf_create(&writer->dict_sample_sizes, &cord()->slabc,
+		    1024 * sizeof(size_t));
 	run->info.min_lsn = INT64_MAX;
 	run->info.max_lsn = -1;
 	assert(run->page_info == NULL);
 	return 0;
 }
 
+int
+vy_run_writer_set_dict(struct vy_run_writer *writer,
+		       const char *dict, uint32_t dict_size,
+		       uint32_t new_dict_capacity)
+{
+	assert(!xlog_is_open(&writer->data_xlog));
+	assert(writer->zcdict == NULL);
+	writer->new_dict_capacity = new_dict_capacity;
+	if (dict == NULL || writer->no_compression)
+		return 0;
+	struct vy_run *run = writer->run;
+	assert(run->info.dict == NULL);
+	run->info.dict = malloc(dict_size);
+	if (run->info.dict == NULL) {
+		diag_set(OutOfMemory, dict_size, "malloc", "run dict");
+		return -1;
+	}
+	memcpy(run->info.dict, dict, dict_size);
+	run->info.dict_size = dict_size;
+	writer->zcdict = ZSTD_createCDict(dict, dict_size,
+					  VY_RUN_DICT_COMPRESSION_LEVEL);
+	if (writer->zcdict == NULL) {
+		diag_set(OutOfMemory, dict_size, "zstd", "run dict");
+		return -1;
+	}
+	return 0;
+}
+
+/**
+ * Remember a statement as a sample for training a dictionary
+ * unless enough samples have already been collected.
+ */
+static int
+vy_run_writer_add_dict_sample(struct vy_run_writer *writer,
+			      struct vy_entry entry)
+{
+	size_t max_size = (size_t)writer->new_dict_capacity *
+			  VY_RUN_DICT_SAMPLE_RATIO_MAX;
+	if (ibuf_used(&writer->dict_samples) >= max_size)
+		return 0;
+	uint32_t size;
+	const char *data = tuple_data_range(entry.stmt, &size);
+	char *sample = ibuf_alloc(&writer->dict_samples, size);
+	if (sample == NULL) {
+		diag_set(OutOfMemory, size, "ibuf", "dict sample");
+		return -1;
+	}
+	size_t *sample_size = ibuf_alloc(&writer->dict_sample_sizes,
+					 sizeof(*sample_size));
+	if (sample_size == NULL) {
+		diag_set(OutOfMemory, sizeof(*sample_size),
+			 "ibuf", "dict sample size");
+		return -1;
+	}
+	memcpy(sample, data, size);
+	*sample_size = size;
+	return 0;
+}
+
+/**
+ * Train a new dictionary from the collected samples. Errors are
+ * ignored, because the run can still be used without a dictionary.
+ */
+static void
+vy_run_writer_train_dict(struct vy_run_writer *writer)
+{
+	assert(writer->new_dict == NULL);
+	size_t min_size = (size_t)writer->new_dict_capacity *
+			  VY_RUN_DICT_SAMPLE_RATIO_MIN;
+	if (writer->new_dict_capacity == 0 ||
+	    ibuf_used(&writer->dict_samples) < min_size)
+		return;
+	char *dict = malloc(writer->new_dict_capacity);
+	if (dict == NULL)
+		return;
+	const void *samples = writer->dict_samples.rpos;
+	const size_t *sample_sizes = (size_t *)writer->dict_sample_sizes.rpos;
+	unsigned sample_count = ibuf_used(&writer->dict_sample_sizes) /
+				sizeof(size_t);
+	size_t size = ZDICT_trainFromBuffer(dict, writer->new_dict_capacity,
+					    samples, sample_sizes,
+					    sample_count);
+	if (ZDICT_isError(size)) {
+		say_verbose("failed to train zstd dictionary: %s",
+			    ZDICT_getErrorName(size));
+		free(dict);
+		return;
+	}
+	writer->new_dict = dict;
+	writer->new_dict_size = size;
+}
+
 /**
  * Create an xlog to write run.
  * @param writer Run writer.
@@ -2160,7 +3048,9 @@ vy_run_writer_create_xlog(struct vy_run_writer *writer)
 	struct xlog_opts opts = xlog_opts_default;
 	opts.rate_limit = writer->run->env->snap_io_rate_limit;
 	opts.sync_interval = VY_RUN_SYNC_INTERVAL;
+	opts.free_cache = writer->run->env->direct_io;
 	opts.no_compression = writer->no_compression;
+	opts.zcdict = writer->zcdict;
 	if (xlog_create(&writer->data_xlog, path, 0, &meta, &opts) != 0)
 		return -1;
 	return 0;
@@ -2218,6 +3108,9 @@ vy_run_writer_write_to_page(struct vy_run_writer *writer, struct vy_entry entry)
 	if (writer->bloom != NULL &&
 	    vy_bloom_builder_add(writer->bloom, entry, writer->key_def) != 0)
 		return -1;
+	if (writer->new_dict_capacity > 0 &&
+	    vy_run_writer_add_dict_sample(writer, entry) != 0)
+		return -1;
 	if (writer->last.stmt != NULL)
 		vy_stmt_unref_if_possible(writer->last.stmt);
 	writer->last = entry;
@@ -2273,6 +3166,13 @@ vy_run_writer_end_page(struct vy_run_writer *writer)
 	if (written < 0)
 		return -1;
 	page->size = written;
+	if (writer->bloom != NULL && writer->bloom_partitioned) {
+		page->bloom = tuple_bloom_new(writer->bloom,
+					      writer->bloom_fpr);
+		if (page->bloom == NULL)
+			return -1;
+		tuple_bloom_builder_reset(writer->bloom);
+	}
 	run->info.page_count++;
 	vy_run_acct_page(run, page);
 	ibuf_reset(&writer->row_index_buf);
@@ -2317,6 +3217,9 @@ vy_run_writer_destroy(struct vy_run_writer *writer, bool reuse_fd)
 	if (writer->bloom != NULL)
 		tuple_bloom_builder_delete(writer->bloom);
 	ibuf_destroy(&writer->row_index_buf);
+	ibuf_destroy(&writer->dict_samples);
+	ibuf_destroy(&writer->dict_sample_sizes);
+	ZSTD_freeCDict(writer->zcdict);
 }
 
 int
@@ -2361,7 +3264,7 @@ vy_run_writer_commit(struct vy_run_writer *writer)
 	    xlog_rename(&writer->data_xlog) < 0)
 		goto out;
 
-	if (writer->bloom != NULL) {
+	if (writer->bloom != NULL && !writer->bloom_partitioned) {
 		run->info.bloom = tuple_bloom_new(writer->bloom,
 						  writer->bloom_fpr);
 		if (run->info.bloom == NULL)
@@ -2370,8 +3273,12 @@ vy_run_writer_commit(struct vy_run_writer *writer)
 	if (vy_run_write_index(run, writer->dirpath,
 			       writer->space_id, writer->iid) != 0)
 		goto out;
+	if (vy_run_load_dict(run) != 0)
+		goto out;
 
+	vy_run_writer_train_dict(writer);
 	run->fd = writer->data_xlog.fd;
+	vy_run_open_direct(run, writer->data_xlog.filename);
 	vy_run_writer_destroy(writer, true);
 	rc = 0;
 out:
@@ -2382,6 +3289,7 @@ out:
 void
 vy_run_writer_abort(struct vy_run_writer *writer)
 {
+	assert(writer->new_dict == NULL);
 	vy_run_writer_destroy(writer, false);
 }
 
@@ -2486,6 +3394,15 @@ vy_run_rebuild_index(struct vy_run *run, const char *dir,
 		info->size = next_page_offset - page_offset;
 		info->unpacked_size = xlog_cursor_tx_pos(&cursor);
 		info->row_index_offset = page_row_index_offset;
+		if (bloom_builder != NULL && opts->bloom_partitioned) {
+			info->bloom = tuple_bloom_new(bloom_builder,
+						      opts->bloom_fpr);
+			if (info->bloom == NULL) {
+				vy_page_info_destroy(info);
+				goto close_err;
+			}
+			tuple_bloom_builder_reset(bloom_builder);
+		}
 		++run->info.page_count;
 		vy_run_acct_page(run, info);
 
@@ -2508,12 +3425,15 @@ vy_run_rebuild_index(struct vy_run *run, const char *dir,
 	region_truncate(region, mem_used);
 	run->fd = cursor.fd;
 	xlog_cursor_close(&cursor, true);
+	vy_run_open_direct(run, path);
 
 	if (bloom_builder != NULL) {
-		run->info.bloom = tuple_bloom_new(bloom_builder,
-						  opts->bloom_fpr);
-		if (run->info.bloom == NULL)
-			goto close_err;
+		if (!opts->bloom_partitioned) {
+			run->info.bloom = tuple_bloom_new(bloom_builder,
+							  opts->bloom_fpr);
+			if (run->info.bloom == NULL)
+				goto close_err;
+		}
 		tuple_bloom_builder_delete(bloom_builder);
 		bloom_builder = NULL;
 	}
@@ -2555,7 +3475,7 @@ vy_run_remove_files(const char *dir, uint32_t space_id,
 	for (int type = 0; type < vy_file_MAX; type++) {
 		vy_run_snprint_path(path, sizeof(path), dir,
 				    space_id, iid, run_id, type);
-		if (coio_unlink(path) < 0) {
+		if (coio_unlink_throttled(path) < 0) {
 			if (errno != ENOENT) {
 				say_syserror("error while removing %s", path);
 				ret = -1;
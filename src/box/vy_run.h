@@ -44,6 +44,7 @@
 #include "xlog.h"
 
 #include "small/mempool.h"
+#include "small/rlist.h"
 
 #if defined(__cplusplus)
 extern "C" {
@@ -51,6 +52,43 @@ extern "C" {
 
 struct vy_history;
 struct vy_run_reader;
+struct vy_page_prefetch;
+struct mh_vy_page_cache_t;
+
+/** Page cache statistics. */
+struct vy_page_cache_stat {
+	/** Number of lookups that found the page in the cache. */
+	int64_t hit;
+	/** Number of lookups that had to read the page from disk. */
+	int64_t miss;
+	/** Number of pages evicted from the cache. */
+	int64_t evict;
+};
+
+/**
+ * Engine-wide cache of decompressed run pages.
+ *
+ * Pages are looked up by run id and page number so that all
+ * run iterators share them. A cached page is reference counted:
+ * an iterator that holds a page pins it in memory even if it is
+ * evicted from the cache, in which case the page is freed when
+ * the last reference to it is dropped.
+ */
+struct vy_page_cache {
+	/** Run id, page number -> struct vy_page. */
+	struct mh_vy_page_cache_t *pages;
+	/**
+	 * List of cached pages, ordered by access time,
+	 * most recently used first. Linked by vy_page::in_lru.
+	 */
+	struct rlist lru;
+	/** Memory used by cached pages. */
+	size_t mem_used;
+	/** Max memory that may be used by cached pages. */
+	size_t quota;
+	/** Usage statistics. */
+	struct vy_page_cache_stat stat;
+};
 
 /** Part of vinyl environment for run read/write */
 struct vy_run_env {
@@ -74,6 +112,20 @@ struct vy_run_env {
 	 * unconditionally remove unused runs' files in-place.
 	 */
 	bool initial_join;
+	/** Cache of pages read from run files. */
+	struct vy_page_cache page_cache;
+	/**
+	 * Max number of pages a run iterator may read ahead
+	 * once it detects a sequential scan. Zero disables
+	 * read-ahead.
+	 */
+	uint32_t read_ahead;
+	/**
+	 * If set, pages of run files opened from now on are
+	 * read with O_DIRECT, bypassing the OS page cache, and
+	 * the page cache is freed after writing run files.
+	 */
+	bool direct_io;
 };
 
 /**
@@ -94,6 +146,13 @@ struct vy_run_info {
 	struct tuple_bloom *bloom;
 	/** Statement statistics. */
 	struct vy_stmt_stat stmt_stat;
+	/**
+	 * Zstd dictionary the run pages are compressed with,
+	 * NULL if pages are compressed without a dictionary.
+	 */
+	char *dict;
+	/** Size of the dictionary. */
+	uint32_t dict_size;
 };
 
 /**
@@ -114,6 +173,12 @@ struct vy_page_info {
 	hint_t min_key_hint;
 	/** Offset of the row index in the page. */
 	uint32_t row_index_offset;
+	/**
+	 * Bloom filter of keys stored in the page or NULL if
+	 * the run has a single bloom filter for all pages
+	 * (see vy_run_info::bloom).
+	 */
+	struct tuple_bloom *bloom;
 };
 
 /**
@@ -128,6 +193,11 @@ struct vy_run {
 	struct vy_page_info *page_info;
 	/** Run data file. */
 	int fd;
+	/**
+	 * Run data file opened with O_DIRECT or -1 if direct I/O
+	 * is disabled. Used for reading pages if set.
+	 */
+	int direct_fd;
 	/** Unique ID of this run. */
 	int64_t id;
 	/** Number of statements in this run. */
@@ -173,6 +243,18 @@ struct vy_run {
 	struct rlist in_unused;
 	/** Link in vy_lsm::runs list. */
 	struct rlist in_lsm;
+	/**
+	 * List of pages of this run stored in the page cache.
+	 * Linked by vy_page::in_run.
+	 */
+	struct rlist cached_pages;
+	/**
+	 * Digested info.dict used for decompressing pages,
+	 * NULL if the run has no dictionary. It refers to
+	 * info.dict and is immutable so it can be shared by
+	 * reader threads.
+	 */
+	ZSTD_DDict *zddict;
 };
 
 /**
@@ -284,6 +366,23 @@ struct vy_run_iterator {
 	 */
 	struct vy_page *curr_page;
 	struct vy_page *prev_page;
+	/**
+	 * List of pages read ahead by the iterator, linked by
+	 * vy_page_prefetch::next. We don't use rlist here,
+	 * because run iterators may be moved in memory before
+	 * iteration starts, see vy_read_iterator_reserve().
+	 */
+	struct vy_page_prefetch *prefetch;
+	/**
+	 * Number of the page that was loaded last, UINT32_MAX
+	 * if none. Used for detecting sequential scans.
+	 */
+	uint32_t last_page_no;
+	/**
+	 * Number of pages loaded in a row in the iteration
+	 * direction. Read-ahead starts once it's non-zero.
+	 */
+	uint32_t seq_page_count;
 	/** Is false until first .._get or .._next_.. method is called */
 	bool search_started;
 };
@@ -292,8 +391,21 @@ struct vy_run_iterator {
  * Vinyl page stored in memory.
  */
 struct vy_page {
+	/** ID of the run the page was read from. */
+	int64_t run_id;
 	/** Page position in the run file. */
 	uint32_t page_no;
+	/**
+	 * Number of run iterators using the page plus one if
+	 * the page is stored in the page cache.
+	 */
+	int refs;
+	/** Set if the page is stored in the page cache. */
+	bool is_cached;
+	/** Link in vy_page_cache::lru. */
+	struct rlist in_lru;
+	/** Link in vy_run::cached_pages. */
+	struct rlist in_run;
 	/** Size of page data in memory, i.e. unpacked. */
 	uint32_t unpacked_size;
 	/** Number of statements in the page. */
@@ -320,6 +432,35 @@ vy_run_env_create(struct vy_run_env *env, int read_threads);
 void
 vy_run_env_destroy(struct vy_run_env *env);
 
+/**
+ * Set the max amount of memory that may be used for caching
+ * run pages. Pages are evicted from the cache if the new limit
+ * is less than the amount of memory currently used. Zero quota
+ * disables the cache.
+ */
+void
+vy_run_env_set_page_cache_quota(struct vy_run_env *env, size_t quota);
+
+/**
+ * Set the max number of pages a run iterator may read ahead
+ * during a sequential scan. Zero disables read-ahead.
+ */
+static inline void
+vy_run_env_set_read_ahead(struct vy_run_env *env, uint32_t read_ahead)
+{
+	env->read_ahead = read_ahead;
+}
+
+/**
+ * Enable or disable direct I/O for run files.
+ * See vy_run_env::direct_io.
+ */
+static inline void
+vy_run_env_set_direct_io(struct vy_run_env *env, bool direct_io)
+{
+	env->direct_io = direct_io;
+}
+
 /**
  * Enable coio reads for a vinyl run environment.
  *
@@ -515,6 +656,15 @@ vy_slice_cut(struct vy_slice *slice, int64_t id, struct vy_entry begin,
 	     struct vy_entry end, struct key_def *cmp_def,
 	     struct vy_slice **result);
 
+/**
+ * Check if a slice may store a statement matching the given full
+ * key according to the bloom filter of its run. Returns true if
+ * the run has no bloom filter.
+ */
+bool
+vy_slice_bloom_maybe_has(struct vy_slice *slice, struct vy_entry key,
+			 struct key_def *cmp_def, struct key_def *key_def);
+
 /**
  * Open an iterator over on-disk run.
  *
@@ -623,6 +773,12 @@ struct vy_run_writer {
 	struct xlog data_xlog;
 	/** Bloom filter false positive rate. */
 	double bloom_fpr;
+	/**
+	 * If set, a bloom filter is built for each page rather
+	 * than for the whole run and the builder is reset after
+	 * each page.
+	 */
+	bool bloom_partitioned;
 	/** Bloom filter. */
 	struct tuple_bloom_builder *bloom;
 	/** Buffer of a current page row offsets. */
@@ -632,6 +788,27 @@ struct vy_run_writer {
 	 * of max key of a finished run.
 	 */
 	struct vy_entry last;
+	/**
+	 * Dictionary used for compressing pages, NULL if pages
+	 * are compressed without a dictionary.
+	 */
+	ZSTD_CDict *zcdict;
+	/**
+	 * Max size of a dictionary trained from statements
+	 * written by the writer, 0 if training is disabled.
+	 */
+	uint32_t new_dict_capacity;
+	/** Samples collected for training a new dictionary. */
+	struct ibuf dict_samples;
+	/** Sizes of the samples, array of size_t. */
+	struct ibuf dict_sample_sizes;
+	/**
+	 * Dictionary trained on commit, NULL if none. The caller
+	 * of vy_run_writer_commit() takes the ownership of it.
+	 */
+	char *new_dict;
+	/** Size of the trained dictionary. */
+	uint32_t new_dict_size;
 };
 
 /** Create a run writer to fill a run with statements. */
@@ -639,7 +816,22 @@ int
 vy_run_writer_create(struct vy_run_writer *writer, struct vy_run *run,
 		     const char *dirpath, uint32_t space_id, uint32_t iid,
 		     struct key_def *cmp_def, struct key_def *key_def,
-		     uint64_t page_size, double bloom_fpr, bool no_compression);
+		     uint64_t page_size, double bloom_fpr,
+		     bool bloom_partitioned, bool no_compression);
+
+/**
+ * Make a run writer compress pages with the given zstd dictionary
+ * (NULL if none) and train a new dictionary of up to the given size
+ * from the statements written to the run. The new dictionary is
+ * returned in vy_run_writer::new_dict on commit.
+ *
+ * @retval -1 Memory error.
+ * @retval  0 Success.
+ */
+int
+vy_run_writer_set_dict(struct vy_run_writer *writer,
+		       const char *dict, uint32_t dict_size,
+		       uint32_t new_dict_capacity);
 
 /**
  * Write a specified statement into a run.
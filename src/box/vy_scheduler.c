@@ -46,6 +46,7 @@
 #include "fiber_cond.h"
 #include "cbus.h"
 #include "salad/stailq.h"
+#include "probe.h"
 #include "say.h"
 #include "txn.h"
 #include "space.h"
@@ -104,6 +105,19 @@ struct vy_worker {
 /** Max number of statements in a batch of deferred DELETEs. */
 enum { VY_DEFERRED_DELETE_BATCH_MAX = 100 };
 
+/**
+ * Min number of pages a run written by a part of a dump split
+ * among several workers is expected to have, see vy_dump_job.
+ * Splitting smaller dumps isn't worth creating extra files.
+ */
+enum { VY_DUMP_PART_PAGES_MIN = 64 };
+
+/**
+ * Max number of tasks compaction of a range can be split among,
+ * see vy_compaction_job.
+ */
+enum { VY_COMPACTION_PART_COUNT_MAX = 16 };
+
 /** Deferred DELETE statement. */
 struct vy_deferred_delete_stmt {
 	/** Overwritten tuple. */
@@ -198,13 +212,64 @@ struct vy_task {
 	 * need to remember the slices we are compacting.
 	 */
 	struct vy_slice *first_slice, *last_slice;
+	/**
+	 * Dump this task is a part of. Shared by all tasks that
+	 * process the same dump, see vy_dump_job.
+	 */
+	struct vy_dump_job *dump_job;
+	/**
+	 * Compaction this task is a part of in case compaction
+	 * of the range is split among several tasks, see
+	 * vy_compaction_job.
+	 */
+	struct vy_compaction_job *compaction_job;
+	/** Ordinal number of the task in its dump or compaction. */
+	int part_no;
+	/**
+	 * Boundaries of the key range written by a task that
+	 * is a part of a dump or compaction: begin is inclusive,
+	 * end is exclusive, NULL stands for infinity. Hold
+	 * references to the statements.
+	 */
+	struct vy_entry part_begin, part_end;
+	/**
+	 * Slices of the compacted runs cut by the key range of
+	 * a compaction part task, linked by vy_slice::in_range.
+	 * They aren't added to any range and are deleted when
+	 * the task is processed.
+	 */
+	struct rlist part_slices;
+	/**
+	 * Other tasks of the same dump or compaction that must
+	 * be submitted to workers along with this one, linked
+	 * by in_parts.
+	 */
+	struct stailq parts;
+	/** Link in vy_task::parts. */
+	struct stailq_entry in_parts;
 	/**
 	 * Index options may be modified while a task is in
 	 * progress so we save them here to safely access them
 	 * from another thread.
 	 */
 	double bloom_fpr;
+	bool bloom_partitioned;
 	int64_t page_size;
+	/**
+	 * Copy of the LSM tree dictionary used for compressing
+	 * the new run, NULL if none, and the max size of a new
+	 * dictionary to train, 0 if dictionary compression is
+	 * disabled.
+	 */
+	char *dict;
+	uint32_t dict_size;
+	uint32_t dict_capacity;
+	/**
+	 * Dictionary trained by the task. It replaces the LSM
+	 * tree dictionary once the task is completed.
+	 */
+	char *new_dict;
+	uint32_t new_dict_size;
 	/**
 	 * Deferred DELETE handler passed to the write iterator.
 	 * It sends deferred DELETE statements generated during
@@ -262,9 +327,24 @@ vy_task_new(struct vy_scheduler *scheduler, struct vy_worker *worker,
 	vy_lsm_ref(lsm);
 	diag_create(&task->diag);
 	task->deferred_delete_handler.iface = &vy_task_deferred_delete_iface;
+	task->part_begin = vy_entry_none();
+	task->part_end = vy_entry_none();
+	rlist_create(&task->part_slices);
+	stailq_create(&task->parts);
 	return task;
 }
 
+/** Delete slices cut for a compaction part task. */
+static void
+vy_task_delete_part_slices(struct vy_task *task)
+{
+	struct vy_slice *slice, *next_slice;
+	rlist_foreach_entry_safe(slice, &task->part_slices, in_range,
+				 next_slice)
+		vy_slice_delete(slice);
+	rlist_create(&task->part_slices);
+}
+
 /** Free a task allocated with vy_task_new(). */
 static void
 vy_task_delete(struct vy_task *task)
@@ -273,11 +353,39 @@ vy_task_delete(struct vy_task *task)
 	assert(task->deferred_delete_in_progress == 0);
 	key_def_delete(task->cmp_def);
 	key_def_delete(task->key_def);
+	if (task->part_begin.stmt != NULL)
+		tuple_unref(task->part_begin.stmt);
+	if (task->part_end.stmt != NULL)
+		tuple_unref(task->part_end.stmt);
+	vy_task_delete_part_slices(task);
+	free(task->dict);
+	free(task->new_dict);
 	vy_lsm_unref(task->lsm);
 	diag_destroy(&task->diag);
 	free(task);
 }
 
+/**
+ * Copy the compression dictionary of an LSM tree to a task so
+ * that it can be safely accessed from a worker thread.
+ */
+static int
+vy_task_copy_dict(struct vy_task *task, struct vy_lsm *lsm)
+{
+	assert(task->dict == NULL);
+	task->dict_capacity = lsm->opts.compression_dict_size;
+	if (task->dict_capacity == 0 || lsm->dict == NULL)
+		return 0;
+	task->dict = malloc(lsm->dict_size);
+	if (task->dict == NULL) {
+		diag_set(OutOfMemory, lsm->dict_size, "malloc", "dict");
+		return -1;
+	}
+	memcpy(task->dict, lsm->dict, lsm->dict_size);
+	task->dict_size = lsm->dict_size;
+	return 0;
+}
+
 static bool
 vy_dump_heap_less(struct vy_lsm *i1, struct vy_lsm *i2)
 {
@@ -411,6 +519,17 @@ vy_worker_pool_get(struct vy_worker_pool *pool)
 	return worker;
 }
 
+/** Return the number of idle workers in a pool. */
+static int
+vy_worker_pool_idle_count(struct vy_worker_pool *pool)
+{
+	int count = 0;
+	struct vy_worker *worker;
+	stailq_foreach_entry(worker, &pool->idle_workers, in_idle)
+		count++;
+	return count;
+}
+
 /**
  * Put a worker back to the pool it was allocated from once
  * it's done its job.
@@ -1075,8 +1194,13 @@ vy_task_write_run(struct vy_task *task, bool no_compression)
 				 lsm->space_id, lsm->index_id,
 				 task->cmp_def, task->key_def,
 				 task->page_size, task->bloom_fpr,
+				 task->bloom_partitioned,
 				 no_compression) != 0)
 		goto fail;
+	if (task->dict_capacity > 0 &&
+	    vy_run_writer_set_dict(&writer, task->dict, task->dict_size,
+				   task->dict_capacity) != 0)
+		goto fail_abort_writer;
 
 	if (wi->iface->start(wi) != 0)
 		goto fail_abort_writer;
@@ -1108,6 +1232,8 @@ vy_task_write_run(struct vy_task *task, bool no_compression)
 	if (rc != 0)
 		goto fail_abort_writer;
 
+	task->new_dict = writer.new_dict;
+	task->new_dict_size = writer.new_dict_size;
 	return 0;
 
 fail_abort_writer:
@@ -1125,92 +1251,167 @@ vy_task_dump_execute(struct vy_task *task)
 	 * and smallest runs at the same time and so we would gain
 	 * nothing by compressing them.
 	 */
-	return vy_task_write_run(task, true);
+	PROBE2(vy_dump_start, task->lsm->space_id, task->lsm->index_id);
+	int rc = vy_task_write_run(task, true);
+	PROBE3(vy_dump_done, task->lsm->space_id, task->lsm->index_id, rc);
+	return rc;
 }
 
+/**
+ * A dump of an LSM tree may be split among several tasks, each
+ * of which writes statements falling in a group of adjacent
+ * ranges to a separate run, so that a big dump is processed by
+ * all idle dump workers in parallel. Since the groups are aligned
+ * by range boundaries, each range still receives only one new
+ * slice per dump.
+ *
+ * All tasks of the same dump share this structure. The dump is
+ * committed when the last of its tasks has been processed or
+ * aborted if any of them failed.
+ */
+struct vy_dump_job {
+	/** LSM tree being dumped. */
+	struct vy_lsm *lsm;
+	/** Time of the dump start. */
+	double start_time;
+	/** Max LSN stored in the dumped in-memory trees. */
+	int64_t dump_lsn;
+	/** Number of tasks that haven't been processed yet. */
+	int pending;
+	/** Set if any task of the dump failed. */
+	bool is_failed;
+	/** Number of runs stored in the array below. */
+	int run_count;
+	/** Runs written by the processed tasks. */
+	struct vy_run *runs[0];
+};
+
+/**
+ * Add runs written by all tasks of a dump to the LSM tree and
+ * delete the dumped in-memory trees. Called when the last task
+ * of the dump has been processed.
+ */
 static int
-vy_task_dump_complete(struct vy_task *task)
+vy_dump_job_complete(struct vy_scheduler *scheduler, struct vy_dump_job *job)
 {
-	struct vy_scheduler *scheduler = task->scheduler;
-	struct vy_lsm *lsm = task->lsm;
-	struct vy_run *new_run = task->new_run;
-	int64_t dump_lsn = new_run->dump_lsn;
-	double dump_time = ev_monotonic_now(loop()) - task->start_time;
-	struct vy_disk_stmt_counter dump_output = new_run->count;
+	struct vy_lsm *lsm = job->lsm;
+	int64_t dump_lsn = job->dump_lsn;
+	double dump_time = ev_monotonic_now(loop()) - job->start_time;
+	struct vy_disk_stmt_counter dump_output;
 	struct vy_stmt_counter dump_input;
 	struct vy_mem *mem, *next_mem;
 	struct vy_slice **new_slices, *slice;
 	struct vy_range *range, *begin_range, *end_range;
-	int i;
+	struct vy_run *new_run;
+	int range_count = lsm->range_count;
+	int run_count = job->run_count;
+	int i, j;
 
 	assert(lsm->is_dumping);
-
-	if (vy_run_is_empty(new_run)) {
-		/*
-		 * In case the run is empty, we can discard the run
-		 * and delete dumped in-memory trees right away w/o
-		 * inserting slices into ranges. However, we need
-		 * to log LSM tree dump anyway.
-		 */
-		vy_log_tx_begin();
-		vy_log_dump_lsm(lsm->id, dump_lsn);
-		if (vy_log_tx_commit() < 0)
-			goto fail;
-		vy_run_discard(new_run);
-		goto delete_mems;
-	}
-
-	assert(new_run->info.max_lsn <= dump_lsn);
-
-	/*
-	 * Figure out which ranges intersect the new run.
-	 */
-	if (vy_lsm_find_range_intersection(lsm, new_run->info.min_key,
-					   new_run->info.max_key,
-					   &begin_range, &end_range) != 0)
-		goto fail;
+	assert(job->pending == 0);
+	assert(!job->is_failed);
 
 	/*
-	 * For each intersected range allocate a slice of the new run.
+	 * Slice of run j for range i is stored at new_slices[j *
+	 * range_count + i], where i is the range position in the
+	 * range tree.
 	 */
-	new_slices = calloc(lsm->range_count, sizeof(*new_slices));
+	new_slices = calloc(run_count * range_count, sizeof(*new_slices));
 	if (new_slices == NULL) {
-		diag_set(OutOfMemory, lsm->range_count * sizeof(*new_slices),
+		diag_set(OutOfMemory,
+			 run_count * range_count * sizeof(*new_slices),
 			 "malloc", "struct vy_slice *");
 		goto fail;
 	}
-	for (range = begin_range, i = 0; range != end_range;
-	     range = vy_range_tree_next(&lsm->range_tree, range), i++) {
-		slice = vy_slice_new(vy_log_next_id(), new_run,
-				     range->begin, range->end, lsm->cmp_def);
-		if (slice == NULL)
+	vy_disk_stmt_counter_reset(&dump_output);
+	for (j = 0; j < run_count; j++) {
+		new_run = job->runs[j];
+		vy_disk_stmt_counter_add(&dump_output, &new_run->count);
+		/*
+		 * In case the run is empty, we can discard the run
+		 * w/o inserting slices into ranges. However, we need
+		 * to log LSM tree dump anyway.
+		 */
+		if (vy_run_is_empty(new_run))
+			continue;
+
+		assert(new_run->info.max_lsn <= dump_lsn);
+
+		/*
+		 * Figure out which ranges intersect the new run.
+		 */
+		if (vy_lsm_find_range_intersection(lsm, new_run->info.min_key,
+						   new_run->info.max_key,
+						   &begin_range,
+						   &end_range) != 0)
 			goto fail_free_slices;
 
-		assert(i < lsm->range_count);
-		new_slices[i] = slice;
+		/*
+		 * For each intersected range allocate a slice
+		 * of the new run.
+		 */
+		bool in_intersection = false;
+		for (range = vy_range_tree_first(&lsm->range_tree), i = 0;
+		     range != end_range;
+		     range = vy_range_tree_next(&lsm->range_tree, range), i++) {
+			if (range == begin_range)
+				in_intersection = true;
+			if (!in_intersection)
+				continue;
+			slice = vy_slice_new(vy_log_next_id(), new_run,
+					     range->begin, range->end,
+					     lsm->cmp_def);
+			if (slice == NULL)
+				goto fail_free_slices;
+
+			assert(i < range_count);
+			new_slices[j * range_count + i] = slice;
+		}
 	}
 
 	/*
 	 * Log change in metadata.
 	 */
 	vy_log_tx_begin();
-	vy_log_create_run(lsm->id, new_run->id, dump_lsn, new_run->dump_count);
-	for (range = begin_range, i = 0; range != end_range;
+	for (j = 0; j < run_count; j++) {
+		new_run = job->runs[j];
+		if (!vy_run_is_empty(new_run))
+			vy_log_create_run(lsm->id, new_run->id, dump_lsn,
+					  new_run->dump_count);
+	}
+	for (range = vy_range_tree_first(&lsm->range_tree), i = 0;
+	     range != NULL;
 	     range = vy_range_tree_next(&lsm->range_tree, range), i++) {
-		assert(i < lsm->range_count);
-		slice = new_slices[i];
-		vy_log_insert_slice(range->id, new_run->id, slice->id,
-				    tuple_data_or_null(slice->begin.stmt),
-				    tuple_data_or_null(slice->end.stmt));
+		assert(i < range_count);
+		for (j = 0; j < run_count; j++) {
+			slice = new_slices[j * range_count + i];
+			if (slice == NULL)
+				continue;
+			struct tuple *begin = slice->begin.stmt;
+			struct tuple *end = slice->end.stmt;
+			vy_log_insert_slice(range->id, slice->run->id,
+					    slice->id,
+					    tuple_data_or_null(begin),
+					    tuple_data_or_null(end));
+		}
 	}
 	vy_log_dump_lsm(lsm->id, dump_lsn);
 	if (vy_log_tx_commit() < 0)
 		goto fail_free_slices;
 
-	/* Account the new run. */
-	vy_lsm_add_run(lsm, new_run);
-	/* Drop the reference held by the task. */
-	vy_run_unref(new_run);
+	for (j = 0; j < run_count; j++) {
+		new_run = job->runs[j];
+		if (vy_run_is_empty(new_run)) {
+			vy_run_discard(new_run);
+			continue;
+		}
+		/* Account the new run. */
+		vy_lsm_add_run(lsm, new_run);
+		/* Drop the reference held by the task. */
+		vy_run_unref(new_run);
+	}
+	/* The runs are owned by the LSM tree now. */
+	job->run_count = 0;
 
 	/*
 	 * Add new slices to ranges.
@@ -1220,12 +1421,21 @@ vy_task_dump_complete(struct vy_task *task)
 	 * LSM tree state, when the same statement is present twice,
 	 * in memory and on disk.
 	 */
-	for (range = begin_range, i = 0; range != end_range;
+	for (range = vy_range_tree_first(&lsm->range_tree), i = 0;
+	     range != NULL;
 	     range = vy_range_tree_next(&lsm->range_tree, range), i++) {
-		assert(i < lsm->range_count);
-		slice = new_slices[i];
-		vy_lsm_unacct_range(lsm, range);
-		vy_range_add_slice(range, slice);
+		bool is_updated = false;
+		for (j = 0; j < run_count; j++) {
+			slice = new_slices[j * range_count + i];
+			if (slice == NULL)
+				continue;
+			if (!is_updated)
+				vy_lsm_unacct_range(lsm, range);
+			vy_range_add_slice(range, slice);
+			is_updated = true;
+		}
+		if (!is_updated)
+			continue;
 		vy_range_update_compaction_priority(range, &lsm->opts);
 		vy_range_update_dumps_per_compaction(range);
 		vy_lsm_acct_range(lsm, range);
@@ -1233,7 +1443,6 @@ vy_task_dump_complete(struct vy_task *task)
 	vy_range_heap_update_all(&lsm->range_heap);
 	free(new_slices);
 
-delete_mems:
 	/*
 	 * Delete dumped in-memory trees and account dump in
 	 * LSM tree statistics.
@@ -1256,9 +1465,6 @@ delete_mems:
 	scheduler->stat.dump_output += dump_output.bytes;
 	scheduler->stat.dump_time += dump_time;
 
-	/* The iterator has been cleaned up in a worker thread. */
-	task->wi->iface->close(task->wi);
-
 	lsm->is_dumping = false;
 	vy_scheduler_update_lsm(scheduler, lsm);
 
@@ -1274,7 +1480,7 @@ delete_mems:
 	return 0;
 
 fail_free_slices:
-	for (i = 0; i < lsm->range_count; i++) {
+	for (i = 0; i < run_count * range_count; i++) {
 		slice = new_slices[i];
 		if (slice != NULL)
 			vy_slice_delete(slice);
@@ -1284,22 +1490,21 @@ fail:
 	return -1;
 }
 
+/**
+ * Discard runs written by tasks of a failed dump and free
+ * the dump job. Called when the last task of the dump has
+ * been processed.
+ */
 static void
-vy_task_dump_abort(struct vy_task *task)
+vy_dump_job_abort(struct vy_scheduler *scheduler, struct vy_dump_job *job)
 {
-	struct vy_scheduler *scheduler = task->scheduler;
-	struct vy_lsm *lsm = task->lsm;
+	struct vy_lsm *lsm = job->lsm;
 
 	assert(lsm->is_dumping);
+	assert(job->pending == 0);
 
-	/* The iterator has been cleaned up in a worker thread. */
-	task->wi->iface->close(task->wi);
-
-	struct error *e = diag_last_error(&task->diag);
-	error_log(e);
-	say_error("%s: dump failed", vy_lsm_name(lsm));
-
-	vy_run_discard(task->new_run);
+	for (int i = 0; i < job->run_count; i++)
+		vy_run_discard(job->runs[i]);
 
 	lsm->is_dumping = false;
 	vy_scheduler_update_lsm(scheduler, lsm);
@@ -1309,6 +1514,139 @@ vy_task_dump_abort(struct vy_task *task)
 
 	assert(scheduler->dump_task_count > 0);
 	scheduler->dump_task_count--;
+
+	free(job);
+}
+
+static int
+vy_task_dump_complete(struct vy_task *task)
+{
+	struct vy_scheduler *scheduler = task->scheduler;
+	struct vy_dump_job *job = task->dump_job;
+
+	assert(job->pending > 0);
+
+	/* The iterator has been cleaned up in a worker thread. */
+	task->wi->iface->close(task->wi);
+	task->wi = NULL;
+
+	/* Hand the new run over to the dump job. */
+	job->runs[job->run_count++] = task->new_run;
+	task->new_run = NULL;
+
+	if (--job->pending > 0) {
+		/* Wait for the other tasks of the same dump. */
+		return 0;
+	}
+	if (job->is_failed) {
+		/* The failure was reported by vy_task_dump_abort(). */
+		vy_dump_job_abort(scheduler, job);
+		task->dump_job = NULL;
+		return 0;
+	}
+	if (vy_dump_job_complete(scheduler, job) != 0)
+		return -1;
+	free(job);
+	task->dump_job = NULL;
+	return 0;
+}
+
+static void
+vy_task_dump_abort(struct vy_task *task)
+{
+	struct vy_scheduler *scheduler = task->scheduler;
+	struct vy_dump_job *job = task->dump_job;
+
+	/* The iterator has been cleaned up in a worker thread. */
+	if (task->wi != NULL)
+		task->wi->iface->close(task->wi);
+
+	struct error *e = diag_last_error(&task->diag);
+	error_log(e);
+	say_error("%s: dump failed", vy_lsm_name(task->lsm));
+
+	if (task->new_run != NULL) {
+		/*
+		 * The task failed before handing the new run over
+		 * to the dump job so the job can't be committed.
+		 * Wait for the other tasks of the same dump, if any,
+		 * before aborting it.
+		 */
+		vy_run_discard(task->new_run);
+		task->new_run = NULL;
+		job->is_failed = true;
+		assert(job->pending > 0);
+		if (--job->pending > 0)
+			return;
+	}
+	vy_dump_job_abort(scheduler, job);
+	task->dump_job = NULL;
+}
+
+/**
+ * Prepare a dump task for writing in-memory trees of the LSM
+ * tree that belong to the key range of the task to a new run.
+ */
+static int
+vy_task_dump_prepare(struct vy_task *task, int64_t dump_lsn,
+		     bool is_last_level)
+{
+	struct vy_scheduler *scheduler = task->scheduler;
+	struct vy_lsm *lsm = task->lsm;
+
+	struct vy_run *new_run = vy_run_prepare(scheduler->run_env, lsm);
+	if (new_run == NULL)
+		goto err;
+
+	new_run->dump_count = 1;
+	new_run->dump_lsn = dump_lsn;
+
+	/*
+	 * Note, since deferred DELETE are generated on tx commit
+	 * in case the overwritten tuple is found in-memory, no
+	 * deferred DELETE statement should be generated during
+	 * dump so we don't pass a deferred DELETE handler.
+	 */
+	struct vy_stmt_stream *wi;
+	wi = vy_write_iterator_new(task->cmp_def, lsm->index_id == 0,
+				   is_last_level, scheduler->read_views, NULL);
+	if (wi == NULL)
+		goto err_wi;
+	struct vy_mem *mem;
+	rlist_foreach_entry(mem, &lsm->sealed, in_sealed) {
+		if (mem->generation > scheduler->dump_generation)
+			continue;
+		if (vy_write_iterator_new_mem(wi, mem, task->part_begin,
+					      task->part_end) != 0)
+			goto err_wi_sub;
+	}
+
+	if (vy_task_copy_dict(task, lsm) != 0)
+		goto err_wi_sub;
+	task->new_run = new_run;
+	task->wi = wi;
+	task->bloom_fpr = lsm->opts.bloom_fpr;
+	task->bloom_partitioned = lsm->opts.bloom_partitioned;
+	task->page_size = lsm->opts.page_size;
+	return 0;
+
+err_wi_sub:
+	wi->iface->close(wi);
+err_wi:
+	vy_run_discard(new_run);
+err:
+	return -1;
+}
+
+/** Free a task that hasn't been submitted to a worker. */
+static void
+vy_task_cancel(struct vy_task *task)
+{
+	if (task->new_run != NULL) {
+		task->wi->iface->close(task->wi);
+		vy_run_discard(task->new_run);
+	}
+	vy_task_delete(task);
 }
 
 /**
@@ -1316,6 +1654,10 @@ vy_task_dump_abort(struct vy_task *task)
  *
  * On success the task is supposed to dump all in-memory
  * trees created at @scheduler->dump_generation.
+ *
+ * If the dump is big enough and there are idle dump workers,
+ * it is split among several tasks, see vy_dump_job. The extra
+ * tasks are linked to vy_task::parts of the returned task.
  */
 static int
 vy_task_dump_new(struct vy_scheduler *scheduler, struct vy_worker *worker,
@@ -1348,6 +1690,7 @@ vy_task_dump_new(struct vy_scheduler *scheduler, struct vy_worker *worker,
 	 * eligible for dump are over.
 	 */
 	int64_t dump_lsn = -1;
+	int64_t dump_size = 0;
 	struct vy_mem *mem, *next_mem;
 	rlist_foreach_entry_safe(mem, &lsm->sealed, in_sealed, next_mem) {
 		if (mem->generation > scheduler->dump_generation)
@@ -1362,6 +1705,7 @@ vy_task_dump_new(struct vy_scheduler *scheduler, struct vy_worker *worker,
 			continue;
 		}
 		dump_lsn = MAX(dump_lsn, mem->dump_lsn);
+		dump_size += mem->count.bytes;
 	}
 
 	if (dump_lsn < 0) {
@@ -1371,40 +1715,83 @@ vy_task_dump_new(struct vy_scheduler *scheduler, struct vy_worker *worker,
 		return 0;
 	}
 
+	/*
+	 * Split the dump by ranges so that each task writes
+	 * at least VY_DUMP_PART_PAGES_MIN pages.
+	 */
+	int part_count = 1;
+	if (lsm->range_count > 1) {
+		int64_t part_size_min = (int64_t)VY_DUMP_PART_PAGES_MIN *
+					lsm->opts.page_size;
+		part_count = MIN(lsm->range_count, dump_size / part_size_min);
+		part_count = MAX(part_count, 1);
+	}
+
 	struct vy_task *task = vy_task_new(scheduler, worker, lsm, &dump_ops);
 	if (task == NULL)
 		goto err;
 
-	struct vy_run *new_run = vy_run_prepare(scheduler->run_env, lsm);
-	if (new_run == NULL)
-		goto err_run;
-
-	new_run->dump_count = 1;
-	new_run->dump_lsn = dump_lsn;
+	struct vy_task *part, *next_part;
+	int part_no;
+	for (part_no = 1; part_no < part_count; part_no++) {
+		struct vy_worker *part_worker;
+		part_worker = vy_worker_pool_get(&scheduler->dump_pool);
+		if (part_worker == NULL)
+			break; /* all other workers are busy */
+		part = vy_task_new(scheduler, part_worker, lsm, &dump_ops);
+		if (part == NULL) {
+			vy_worker_pool_put(part_worker);
+			goto err_parts;
+		}
+		stailq_add_tail_entry(&task->parts, part, in_parts);
+	}
+	part_count = part_no;
+
+	struct vy_dump_job *job = calloc(1, sizeof(*job) +
+					 part_count * sizeof(job->runs[0]));
+	if (job == NULL) {
+		diag_set(OutOfMemory, sizeof(*job) +
+			 part_count * sizeof(job->runs[0]),
+			 "malloc", "struct vy_dump_job");
+		goto err_parts;
+	}
+	job->lsm = lsm;
+	job->start_time = task->start_time;
+	job->dump_lsn = dump_lsn;
+	job->pending = part_count;
+	task->dump_job = job;
 
 	/*
-	 * Note, since deferred DELETE are generated on tx commit
-	 * in case the overwritten tuple is found in-memory, no
-	 * deferred DELETE statement should be generated during
-	 * dump so we don't pass a deferred DELETE handler.
+	 * Assign each task a group of adjacent ranges. Note, we
+	 * must not yield until the boundaries are set, because
+	 * ranges may be split or coalesced by a concurrent fiber.
 	 */
-	struct vy_stmt_stream *wi;
-	bool is_last_level = (lsm->run_count == 0);
-	wi = vy_write_iterator_new(task->cmp_def, lsm->index_id == 0,
-				   is_last_level, scheduler->read_views, NULL);
-	if (wi == NULL)
-		goto err_wi;
-	rlist_foreach_entry(mem, &lsm->sealed, in_sealed) {
-		if (mem->generation > scheduler->dump_generation)
-			continue;
-		if (vy_write_iterator_new_mem(wi, mem) != 0)
-			goto err_wi_sub;
+	struct vy_task *prev = task;
+	struct vy_range *range = vy_range_tree_first(&lsm->range_tree);
+	int range_no = 0;
+	part_no = 1;
+	stailq_foreach_entry(part, &task->parts, in_parts) {
+		int first_range_no = part_no++ * lsm->range_count / part_count;
+		while (range_no < first_range_no) {
+			range = vy_range_tree_next(&lsm->range_tree, range);
+			range_no++;
+		}
+		assert(range->begin.stmt != NULL);
+		part->part_begin = range->begin;
+		tuple_ref(range->begin.stmt);
+		prev->part_end = range->begin;
+		tuple_ref(range->begin.stmt);
+		part->dump_job = job;
+		prev = part;
 	}
 
-	task->new_run = new_run;
-	task->wi = wi;
-	task->bloom_fpr = lsm->opts.bloom_fpr;
-	task->page_size = lsm->opts.page_size;
+	bool is_last_level = (lsm->run_count == 0);
+	if (vy_task_dump_prepare(task, dump_lsn, is_last_level) != 0)
+		goto err_job;
+	stailq_foreach_entry(part, &task->parts, in_parts) {
+		if (vy_task_dump_prepare(part, dump_lsn, is_last_level) != 0)
+			goto err_job;
+	}
 
 	lsm->is_dumping = true;
 	vy_scheduler_update_lsm(scheduler, lsm);
@@ -1423,16 +1810,23 @@ vy_task_dump_new(struct vy_scheduler *scheduler, struct vy_worker *worker,
 
 	scheduler->dump_task_count++;
 
-	say_info("%s: dump started", vy_lsm_name(lsm));
+	if (part_count > 1) {
+		say_info("%s: dump started in %d tasks",
+			 vy_lsm_name(lsm), part_count);
+	} else {
+		say_info("%s: dump started", vy_lsm_name(lsm));
+	}
 	*p_task = task;
 	return 0;
 
-err_wi_sub:
-	task->wi->iface->close(wi);
-err_wi:
-	vy_run_discard(new_run);
-err_run:
-	vy_task_delete(task);
+err_job:
+	free(job);
+err_parts:
+	stailq_foreach_entry_safe(part, next_part, &task->parts, in_parts) {
+		vy_worker_pool_put(part->worker);
+		vy_task_cancel(part);
+	}
+	vy_task_cancel(task);
 err:
 	diag_log();
 	say_error("%s: could not start dump", vy_lsm_name(lsm));
@@ -1443,7 +1837,11 @@ static int
 vy_task_compaction_execute(struct vy_task *task)
 {
 	ERROR_INJECT_SLEEP(ERRINJ_VY_COMPACTION_DELAY);
-	return vy_task_write_run(task, false);
+	PROBE2(vy_compaction_start, task->lsm->space_id, task->lsm->index_id);
+	int rc = vy_task_write_run(task, false);
+	PROBE3(vy_compaction_done, task->lsm->space_id, task->lsm->index_id,
+	       rc);
+	return rc;
 }
 
 static int
@@ -1635,34 +2033,386 @@ vy_task_compaction_abort(struct vy_task *task)
 	vy_scheduler_update_lsm(scheduler, lsm);
 }
 
+/**
+ * Compaction of a big range may be split among several tasks,
+ * each of which merges statements falling in a sub-range of the
+ * range to a separate run. When all the tasks are done, the range
+ * is replaced with a range per task, each of which receives the
+ * run written by the task. Since a range that is bigger than
+ * range_size would be split after compaction anyway, this doesn't
+ * result in extra ranges.
+ *
+ * All tasks of the same compaction share this structure. The
+ * compaction is committed when the last of its tasks has been
+ * processed or aborted if any of them failed.
+ */
+struct vy_compaction_job {
+	/** LSM tree the compacted range belongs to. */
+	struct vy_lsm *lsm;
+	/** Compacted range. */
+	struct vy_range *range;
+	/** First (newest) and last (oldest) compacted slices. */
+	struct vy_slice *first_slice, *last_slice;
+	/** Time of the compaction start. */
+	double start_time;
+	/** Number of tasks that haven't been processed yet. */
+	int pending;
+	/** Set if any task of the compaction failed. */
+	bool is_failed;
+	/** Number of tasks the compaction is split among. */
+	int part_count;
+	/**
+	 * Keys splitting the range between the tasks: keys[i]
+	 * is the end of part i and the beginning of part i + 1.
+	 */
+	struct vy_entry keys[VY_COMPACTION_PART_COUNT_MAX - 1];
+	/** Runs written by the processed tasks, by part number. */
+	struct vy_run *runs[VY_COMPACTION_PART_COUNT_MAX];
+};
+
+static void
+vy_compaction_job_delete(struct vy_compaction_job *job)
+{
+	for (int i = 0; i < job->part_count - 1; i++) {
+		if (job->keys[i].stmt != NULL)
+			tuple_unref(job->keys[i].stmt);
+	}
+	free(job);
+}
+
+/**
+ * Replace the compacted range with a range per task of the
+ * compaction. Called when the last task has been processed.
+ */
 static int
-vy_task_compaction_new(struct vy_scheduler *scheduler, struct vy_worker *worker,
-		       struct vy_lsm *lsm, struct vy_task **p_task)
+vy_compaction_job_complete(struct vy_scheduler *scheduler,
+			   struct vy_compaction_job *job)
 {
-	static struct vy_task_ops compaction_ops = {
-		.execute = vy_task_compaction_execute,
-		.complete = vy_task_compaction_complete,
-		.abort = vy_task_compaction_abort,
-	};
+	struct vy_lsm *lsm = job->lsm;
+	struct vy_range *range = job->range;
+	double compaction_time = ev_monotonic_now(loop()) - job->start_time;
+	struct vy_disk_stmt_counter compaction_input;
+	struct vy_disk_stmt_counter compaction_output;
+	struct vy_slice *first_slice = job->first_slice;
+	struct vy_slice *last_slice = job->last_slice;
+	struct vy_range *parts[VY_COMPACTION_PART_COUNT_MAX] = { NULL };
+	struct vy_slice *slice, *new_slice;
+	struct vy_range *part;
+	struct vy_run *run;
+	int i;
 
-	struct vy_range *range = vy_range_heap_top(&lsm->range_heap);
-	assert(range != NULL);
-	assert(range->compaction_priority > 1);
+	assert(job->pending == 0);
+	assert(!job->is_failed);
 
-	if (vy_lsm_split_range(lsm, range) ||
-	    vy_lsm_coalesce_range(lsm, range)) {
+	/*
+	 * The LSM tree could have been dropped while we were writing
+	 * the new runs, see the comment in vy_task_compaction_complete().
+	 */
+	if (lsm->is_dropped) {
+		for (i = 0; i < job->part_count; i++) {
+			vy_run_unref(job->runs[i]);
+			job->runs[i] = NULL;
+		}
+		assert(heap_node_is_stray(&range->heap_node));
+		vy_range_heap_insert(&lsm->range_heap, range);
 		vy_scheduler_update_lsm(scheduler, lsm);
 		return 0;
 	}
 
-	struct vy_task *task = vy_task_new(scheduler, worker, lsm,
-					   &compaction_ops);
-	if (task == NULL)
-		goto err_task;
+	/*
+	 * Allocate a range for each part. A new range receives
+	 * a slice of the run written for the part instead of
+	 * the compacted slices and slices of other runs cut by
+	 * the range boundaries.
+	 */
+	vy_disk_stmt_counter_reset(&compaction_output);
+	for (i = 0; i < job->part_count; i++) {
+		struct vy_entry begin = range->begin;
+		struct vy_entry end = range->end;
+		if (i > 0)
+			begin = job->keys[i - 1];
+		if (i < job->part_count - 1)
+			end = job->keys[i];
+		part = vy_range_new(vy_log_next_id(), begin, end,
+				    lsm->cmp_def);
+		if (part == NULL)
+			goto fail;
+		parts[i] = part;
+		run = job->runs[i];
+		vy_disk_stmt_counter_add(&compaction_output, &run->count);
+		/*
+		 * vy_range_add_slice() adds a slice to the list head,
+		 * so to preserve the order of the slices list, we have
+		 * to iterate backward.
+		 */
+		bool is_compacted = false;
+		rlist_foreach_entry_reverse(slice, &range->slices, in_range) {
+			if (slice == last_slice) {
+				is_compacted = true;
+				if (!vy_run_is_empty(run)) {
+					new_slice = vy_slice_new(
+						vy_log_next_id(), run,
+						part->begin, part->end,
+						lsm->cmp_def);
+					if (new_slice == NULL)
+						goto fail;
+					vy_range_add_slice(part, new_slice);
+				}
+			}
+			if (is_compacted) {
+				if (slice == first_slice)
+					is_compacted = false;
+				continue;
+			}
+			if (vy_slice_cut(slice, vy_log_next_id(), part->begin,
+					 part->end, lsm->cmp_def,
+					 &new_slice) != 0)
+				goto fail;
+			if (new_slice != NULL)
+				vy_range_add_slice(part, new_slice);
+		}
+		part->n_compactions = range->n_compactions + 1;
+		vy_range_update_compaction_priority(part, &lsm->opts);
+		vy_range_update_dumps_per_compaction(part);
+	}
+
+	/*
+	 * Build the list of runs that became unused
+	 * as a result of compaction.
+	 */
+	RLIST_HEAD(unused_runs);
+	for (slice = first_slice; ; slice = rlist_next_entry(slice, in_range)) {
+		slice->run->compacted_slice_count++;
+		if (slice == last_slice)
+			break;
+	}
+	for (slice = first_slice; ; slice = rlist_next_entry(slice, in_range)) {
+		run = slice->run;
+		if (run->compacted_slice_count == run->slice_count)
+			rlist_add_entry(&unused_runs, run, in_unused);
+		slice->run->compacted_slice_count = 0;
+		if (slice == last_slice)
+			break;
+	}
+
+	/*
+	 * Log change in metadata.
+	 */
+	vy_log_tx_begin();
+	rlist_foreach_entry(slice, &range->slices, in_range)
+		vy_log_delete_slice(slice->id);
+	vy_log_delete_range(range->id);
+	rlist_foreach_entry(run, &unused_runs, in_unused)
+		vy_log_drop_run(run->id, VY_LOG_GC_LSN_CURRENT);
+	for (i = 0; i < job->part_count; i++) {
+		run = job->runs[i];
+		if (!vy_run_is_empty(run))
+			vy_log_create_run(lsm->id, run->id, run->dump_lsn,
+					  run->dump_count);
+	}
+	for (i = 0; i < job->part_count; i++) {
+		part = parts[i];
+		vy_log_insert_range(lsm->id, part->id,
+				    tuple_data_or_null(part->begin.stmt),
+				    tuple_data_or_null(part->end.stmt));
+		rlist_foreach_entry(slice, &part->slices, in_range)
+			vy_log_insert_slice(part->id, slice->run->id, slice->id,
+					    tuple_data_or_null(slice->begin.stmt),
+					    tuple_data_or_null(slice->end.stmt));
+	}
+	if (vy_log_tx_commit() < 0)
+		goto fail;
+
+	/*
+	 * Remove compacted run files that were created after
+	 * the last checkpoint immediately to save disk space,
+	 * see the comment in vy_task_compaction_complete().
+	 */
+	rlist_foreach_entry(run, &unused_runs, in_unused) {
+		if (run->dump_lsn > vy_log_signature() ||
+		    scheduler->run_env->initial_join)
+			vy_run_remove_files(lsm->env->path, lsm->space_id,
+					    lsm->index_id, run->id);
+	}
+
+	/*
+	 * Account the new runs if they are not empty,
+	 * otherwise discard them.
+	 */
+	for (i = 0; i < job->part_count; i++) {
+		run = job->runs[i];
+		job->runs[i] = NULL;
+		if (vy_run_is_empty(run)) {
+			vy_run_discard(run);
+			continue;
+		}
+		vy_lsm_add_run(lsm, run);
+		/* Drop the reference held by the task. */
+		vy_run_unref(run);
+	}
+
+	/*
+	 * Replace the compacted range with the new ones and
+	 * account compaction in LSM tree statistics.
+	 */
+	vy_disk_stmt_counter_reset(&compaction_input);
+	for (slice = first_slice; ; slice = rlist_next_entry(slice, in_range)) {
+		vy_disk_stmt_counter_add(&compaction_input, &slice->count);
+		if (slice == last_slice)
+			break;
+	}
+	vy_lsm_unacct_range(lsm, range);
+	/* The range was removed from the heap when compaction started. */
+	vy_range_heap_insert(&lsm->range_heap, range);
+	vy_lsm_remove_range(lsm, range);
+	for (i = 0; i < job->part_count; i++) {
+		part = parts[i];
+		vy_lsm_add_range(lsm, part);
+		vy_lsm_acct_range(lsm, part);
+	}
+	lsm->range_tree_version++;
+	vy_lsm_acct_compaction(lsm, compaction_time,
+			       &compaction_input, &compaction_output);
+	scheduler->stat.compaction_input += compaction_input.bytes;
+	scheduler->stat.compaction_output += compaction_output.bytes;
+	scheduler->stat.compaction_time += compaction_time;
+
+	/*
+	 * Unaccount unused runs and delete the compacted range.
+	 */
+	rlist_foreach_entry(run, &unused_runs, in_unused)
+		vy_lsm_remove_run(lsm, run);
+
+	say_info("%s: completed compacting range %s in %d parts",
+		 vy_lsm_name(lsm), vy_range_str(range), job->part_count);
+
+	rlist_foreach_entry(slice, &range->slices, in_range)
+		vy_slice_wait_pinned(slice);
+	vy_range_delete(range);
+	vy_scheduler_update_lsm(scheduler, lsm);
+	return 0;
+fail:
+	for (i = 0; i < job->part_count; i++) {
+		if (parts[i] != NULL)
+			vy_range_delete(parts[i]);
+	}
+	return -1;
+}
+
+/**
+ * Discard runs written by tasks of a failed compaction and
+ * free the compaction job. Called when the last task of the
+ * compaction has been processed.
+ */
+static void
+vy_compaction_job_abort(struct vy_scheduler *scheduler,
+			struct vy_compaction_job *job)
+{
+	struct vy_lsm *lsm = job->lsm;
+	struct vy_range *range = job->range;
+
+	assert(job->pending == 0);
+
+	for (int i = 0; i < job->part_count; i++) {
+		if (job->runs[i] != NULL)
+			vy_run_discard(job->runs[i]);
+	}
+
+	assert(heap_node_is_stray(&range->heap_node));
+	vy_range_heap_insert(&lsm->range_heap, range);
+	vy_scheduler_update_lsm(scheduler, lsm);
+
+	vy_compaction_job_delete(job);
+}
+
+static int
+vy_task_compaction_part_complete(struct vy_task *task)
+{
+	struct vy_scheduler *scheduler = task->scheduler;
+	struct vy_compaction_job *job = task->compaction_job;
+
+	assert(job->pending > 0);
+
+	/* The iterator has been cleaned up in worker. */
+	task->wi->iface->close(task->wi);
+	task->wi = NULL;
+	/*
+	 * Slices cut for the task must be deleted before
+	 * looking for unused runs.
+	 */
+	vy_task_delete_part_slices(task);
+
+	/* Hand the new run over to the compaction job. */
+	assert(job->runs[task->part_no] == NULL);
+	job->runs[task->part_no] = task->new_run;
+	task->new_run = NULL;
+
+	if (--job->pending > 0) {
+		/* Wait for the other tasks of the same compaction. */
+		return 0;
+	}
+	if (job->is_failed) {
+		/* The failure was reported by the failed task. */
+		vy_compaction_job_abort(scheduler, job);
+		task->compaction_job = NULL;
+		return 0;
+	}
+	if (vy_compaction_job_complete(scheduler, job) != 0)
+		return -1;
+	vy_compaction_job_delete(job);
+	task->compaction_job = NULL;
+	return 0;
+}
+
+static void
+vy_task_compaction_part_abort(struct vy_task *task)
+{
+	struct vy_scheduler *scheduler = task->scheduler;
+	struct vy_compaction_job *job = task->compaction_job;
+
+	/* The iterator has been cleaned up in worker. */
+	if (task->wi != NULL)
+		task->wi->iface->close(task->wi);
+	vy_task_delete_part_slices(task);
+
+	struct error *e = diag_last_error(&task->diag);
+	error_log(e);
+	say_error("%s: failed to compact range %s",
+		  vy_lsm_name(task->lsm), vy_range_str(task->range));
+
+	if (task->new_run != NULL) {
+		/*
+		 * The task failed before handing the new run over
+		 * to the compaction job so the job can't be committed.
+		 * Wait for the other tasks of the same compaction,
+		 * if any, before aborting it.
+		 */
+		vy_run_discard(task->new_run);
+		task->new_run = NULL;
+		job->is_failed = true;
+		assert(job->pending > 0);
+		if (--job->pending > 0)
+			return;
+	}
+	vy_compaction_job_abort(scheduler, job);
+	task->compaction_job = NULL;
+}
+
+/**
+ * Create a run and a write iterator for a compaction task.
+ * If the task is a part of a compaction split among several
+ * tasks, merge slices cut by the task key range.
+ */
+static int
+vy_task_compaction_prepare(struct vy_task *task)
+{
+	struct vy_scheduler *scheduler = task->scheduler;
+	struct vy_lsm *lsm = task->lsm;
+	struct vy_range *range = task->range;
 
 	struct vy_run *new_run = vy_run_prepare(scheduler->run_env, lsm);
 	if (new_run == NULL)
-		goto err_run;
+		goto err;
 
 	struct vy_stmt_stream *wi;
 	bool is_last_level = (range->compaction_priority == range->slice_count);
@@ -1677,7 +2427,19 @@ vy_task_compaction_new(struct vy_scheduler *scheduler, struct vy_worker *worker,
 	int32_t dump_count = 0;
 	int n = range->compaction_priority;
 	rlist_foreach_entry(slice, &range->slices, in_range) {
-		if (vy_write_iterator_new_slice(wi, slice,
+		struct vy_slice *src = slice;
+		if (task->compaction_job != NULL) {
+			/* The cut slice isn't logged so it needs no id. */
+			if (vy_slice_cut(slice, 0, task->part_begin,
+					 task->part_end, lsm->cmp_def,
+					 &src) != 0)
+				goto err_wi_sub;
+			if (src != NULL)
+				rlist_add_tail_entry(&task->part_slices,
+						     src, in_range);
+		}
+		if (src != NULL &&
+		    vy_write_iterator_new_slice(wi, src,
 						lsm->disk_format) != 0)
 			goto err_wi_sub;
 		new_run->dump_lsn = MAX(new_run->dump_lsn,
@@ -1705,13 +2467,215 @@ vy_task_compaction_new(struct vy_scheduler *scheduler, struct vy_worker *worker,
 	else
 		new_run->dump_count = dump_count;
 
-	range->needs_compaction = false;
-
-	task->range = range;
+	if (vy_task_copy_dict(task, lsm) != 0)
+		goto err_wi_sub;
 	task->new_run = new_run;
 	task->wi = wi;
 	task->bloom_fpr = lsm->opts.bloom_fpr;
+	task->bloom_partitioned = lsm->opts.bloom_partitioned;
 	task->page_size = lsm->opts.page_size;
+	return 0;
+
+err_wi_sub:
+	wi->iface->close(wi);
+err_wi:
+	vy_run_discard(new_run);
+err:
+	return -1;
+}
+
+/**
+ * Check if compaction of a range should be split among several
+ * tasks (see vy_compaction_job) and find keys to split it by.
+ * Returns the number of tasks to split compaction among.
+ */
+static int
+vy_task_compaction_part_count(struct vy_scheduler *scheduler,
+			      struct vy_lsm *lsm, struct vy_range *range,
+			      const char **split_keys)
+{
+	/* Find the biggest of the slices that are going to be compacted. */
+	struct vy_slice *slice, *max_slice = NULL;
+	int64_t input_size = 0;
+	int n = range->compaction_priority;
+	rlist_foreach_entry(slice, &range->slices, in_range) {
+		input_size += slice->count.bytes;
+		if (max_slice == NULL ||
+		    slice->count.bytes > max_slice->count.bytes)
+			max_slice = slice;
+		if (--n == 0)
+			break;
+	}
+	/*
+	 * Each part becomes a separate range on completion
+	 * so there's no point in making it less than a range
+	 * is supposed to be.
+	 */
+	int64_t part_count = input_size / vy_lsm_range_size(lsm);
+	part_count = MIN(part_count, VY_COMPACTION_PART_COUNT_MAX);
+	part_count = MIN(part_count, 1 + vy_worker_pool_idle_count(
+					&scheduler->compaction_pool));
+	if (part_count <= 1)
+		return 1;
+	return 1 + vy_range_find_split_keys(range, max_slice, part_count,
+					    split_keys);
+}
+
+/**
+ * Create tasks to compact a range split by the given keys.
+ * The extra tasks are linked to vy_task::parts of the returned
+ * task.
+ */
+static int
+vy_task_compaction_new_parts(struct vy_scheduler *scheduler,
+			     struct vy_worker *worker, struct vy_lsm *lsm,
+			     struct vy_range *range, int part_count,
+			     const char **split_keys, struct vy_task **p_task)
+{
+	static struct vy_task_ops compaction_part_ops = {
+		.execute = vy_task_compaction_execute,
+		.complete = vy_task_compaction_part_complete,
+		.abort = vy_task_compaction_part_abort,
+	};
+
+	struct tuple_format *key_format = lsm->env->key_format;
+	struct vy_task *task = NULL, *part, *next_part;
+	int i;
+
+	assert(part_count > 1);
+	assert(part_count <= VY_COMPACTION_PART_COUNT_MAX);
+
+	struct vy_compaction_job *job = calloc(1, sizeof(*job));
+	if (job == NULL) {
+		diag_set(OutOfMemory, sizeof(*job),
+			 "malloc", "struct vy_compaction_job");
+		goto err;
+	}
+	job->lsm = lsm;
+	job->range = range;
+	job->start_time = ev_monotonic_now(loop());
+	job->part_count = part_count;
+	job->pending = part_count;
+	for (i = 0; i < part_count - 1; i++) {
+		job->keys[i] = vy_entry_key_from_msgpack(key_format,
+							 lsm->cmp_def,
+							 split_keys[i]);
+		if (job->keys[i].stmt == NULL)
+			goto err_job;
+	}
+
+	for (i = 0; i < part_count; i++) {
+		struct vy_worker *part_worker = worker;
+		if (i > 0) {
+			part_worker = vy_worker_pool_get(
+					&scheduler->compaction_pool);
+			assert(part_worker != NULL);
+		}
+		part = vy_task_new(scheduler, part_worker, lsm,
+				   &compaction_part_ops);
+		if (part == NULL) {
+			if (i > 0)
+				vy_worker_pool_put(part_worker);
+			goto err_parts;
+		}
+		part->range = range;
+		part->compaction_job = job;
+		part->part_no = i;
+		if (i > 0) {
+			part->part_begin = job->keys[i - 1];
+			tuple_ref(part->part_begin.stmt);
+		}
+		if (i < part_count - 1) {
+			part->part_end = job->keys[i];
+			tuple_ref(part->part_end.stmt);
+		}
+		if (task == NULL)
+			task = part;
+		else
+			stailq_add_tail_entry(&task->parts, part, in_parts);
+	}
+
+	if (vy_task_compaction_prepare(task) != 0)
+		goto err_parts;
+	stailq_foreach_entry(part, &task->parts, in_parts) {
+		if (vy_task_compaction_prepare(part) != 0)
+			goto err_parts;
+	}
+	job->first_slice = task->first_slice;
+	job->last_slice = task->last_slice;
+
+	range->needs_compaction = false;
+
+	/*
+	 * Remove the range we are going to compact from the heap
+	 * so that it doesn't get selected again.
+	 */
+	vy_range_heap_delete(&lsm->range_heap, range);
+	vy_scheduler_update_lsm(scheduler, lsm);
+
+	say_info("%s: started compacting range %s in %d parts, runs %d/%d",
+		 vy_lsm_name(lsm), vy_range_str(range), part_count,
+		 range->compaction_priority, range->slice_count);
+	*p_task = task;
+	return 0;
+
+err_parts:
+	if (task != NULL) {
+		stailq_foreach_entry_safe(part, next_part, &task->parts,
+					  in_parts) {
+			vy_worker_pool_put(part->worker);
+			vy_task_cancel(part);
+		}
+		vy_task_cancel(task);
+	}
+err_job:
+	vy_compaction_job_delete(job);
+err:
+	diag_log();
+	say_error("%s: could not start compacting range %s",
+		  vy_lsm_name(lsm), vy_range_str(range));
+	return -1;
+}
+
+static int
+vy_task_compaction_new(struct vy_scheduler *scheduler, struct vy_worker *worker,
+		       struct vy_lsm *lsm, struct vy_task **p_task)
+{
+	static struct vy_task_ops compaction_ops = {
+		.execute = vy_task_compaction_execute,
+		.complete = vy_task_compaction_complete,
+		.abort = vy_task_compaction_abort,
+	};
+
+	struct vy_range *range = vy_range_heap_top(&lsm->range_heap);
+	assert(range != NULL);
+	assert(range->compaction_priority > 1);
+
+	if (vy_lsm_split_range(lsm, range) ||
+	    vy_lsm_coalesce_range(lsm, range)) {
+		vy_scheduler_update_lsm(scheduler, lsm);
+		return 0;
+	}
+
+	const char *split_keys[VY_COMPACTION_PART_COUNT_MAX - 1];
+	int part_count = vy_task_compaction_part_count(scheduler, lsm, range,
+						       split_keys);
+	if (part_count > 1) {
+		return vy_task_compaction_new_parts(scheduler, worker, lsm,
+						    range, part_count,
+						    split_keys, p_task);
+	}
+
+	struct vy_task *task = vy_task_new(scheduler, worker, lsm,
+					   &compaction_ops);
+	if (task == NULL)
+		goto err_task;
+
+	task->range = range;
+	if (vy_task_compaction_prepare(task) != 0)
+		goto err_prepare;
+
+	range->needs_compaction = false;
 
 	/*
 	 * Remove the range we are going to compact from the heap
@@ -1726,11 +2690,7 @@ vy_task_compaction_new(struct vy_scheduler *scheduler, struct vy_worker *worker,
 	*p_task = task;
 	return 0;
 
-err_wi_sub:
-	task->wi->iface->close(wi);
-err_wi:
-	vy_run_discard(new_run);
-err_run:
+err_prepare:
 	vy_task_delete(task);
 err_task:
 	diag_log();
@@ -1938,6 +2898,7 @@ no_task:
 static int
 vy_schedule(struct vy_scheduler *scheduler, struct vy_task **ptask)
 {
+	struct vy_task *part;
 	*ptask = NULL;
 
 	if (vy_scheduler_peek_dump(scheduler, ptask) != 0)
@@ -1954,6 +2915,8 @@ vy_schedule(struct vy_scheduler *scheduler, struct vy_task **ptask)
 	return 0;
 found:
 	scheduler->stat.tasks_inprogress++;
+	stailq_foreach_entry(part, &(*ptask)->parts, in_parts)
+		scheduler->stat.tasks_inprogress++;
 	return 0;
 fail:
 	assert(!diag_is_empty(diag_get()));
@@ -1986,6 +2949,14 @@ vy_task_complete(struct vy_task *task)
 		diag_move(diag_get(), diag);
 		goto fail;
 	}
+	if (task->new_dict != NULL) {
+		/* Compress the next run with the new dictionary. */
+		struct vy_lsm *lsm = task->lsm;
+		free(lsm->dict);
+		lsm->dict = task->new_dict;
+		lsm->dict_size = task->new_dict_size;
+		task->new_dict = NULL;
+	}
 	scheduler->stat.tasks_completed++;
 	return 0;
 fail:
@@ -2049,7 +3020,17 @@ vy_scheduler_f(va_list va)
 			continue;
 		}
 
-		/* Queue the task for execution. */
+		/*
+		 * Queue the task for execution along with other
+		 * tasks of the same dump, if any.
+		 */
+		struct vy_task *part, *next_part;
+		stailq_foreach_entry_safe(part, next_part, &task->parts,
+					  in_parts) {
+			cmsg_init(&part->cmsg, vy_task_execute_route);
+			cpipe_push(&part->worker->worker_pipe, &part->cmsg);
+		}
+		stailq_create(&task->parts);
 		cmsg_init(&task->cmsg, vy_task_execute_route);
 		cpipe_push(&task->worker->worker_pipe, &task->cmsg);
 
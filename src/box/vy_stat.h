@@ -101,6 +101,13 @@ struct vy_run_iterator_stat {
 	 * of disk reads.
 	 */
 	struct vy_disk_stmt_counter read;
+	/** Read-ahead statistics. */
+	struct {
+		/** Number of pages requested to be read ahead. */
+		int64_t pages;
+		/** Number of read-ahead pages used by the iterator. */
+		int64_t hit;
+	} prefetch;
 };
 
 /** TX write set iterator statistics. */
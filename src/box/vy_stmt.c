@@ -158,7 +158,7 @@ vy_stmt_format_new(struct vy_stmt_env *env, struct key_def *const *keys,
 static struct tuple *
 vy_stmt_alloc(struct tuple_format *format, uint32_t data_offset, uint32_t bsize)
 {
-	assert(data_offset >= sizeof(struct vy_stmt) + format->field_map_size);
+	assert(data_offset >= sizeof(struct vy_stmt));
 
 	if (tuple_check_data_offset(data_offset) != 0)
 		return NULL;
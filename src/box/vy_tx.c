@@ -329,6 +329,7 @@ vy_tx_create(struct vy_tx_manager *xm, struct vy_tx *tx)
 	tx->is_applier_session = false;
 	tx->read_view = (struct vy_read_view *)xm->p_global_read_view;
 	vy_tx_read_set_new(&tx->read_set);
+	tx->read_set_count = 0;
 	tx->psn = 0;
 	rlist_create(&tx->on_destroy);
 	rlist_create(&tx->in_writers);
@@ -941,6 +942,57 @@ vy_tx_rollback_statement(struct vy_tx *tx, void *svp)
 	tx->last_stmt_space = NULL;
 }
 
+/**
+ * Replace all intervals read by a transaction from the LSM tree
+ * of the given interval with one interval spanning them. This
+ * bounds the size of the read set of a long scanning transaction
+ * at the cost of false conflicts with writes that fall between
+ * the intervals.
+ */
+static void
+vy_tx_coarsen_read_set(struct vy_tx *tx, struct vy_read_interval *interval)
+{
+	struct vy_lsm *lsm = interval->lsm;
+	struct vy_read_interval *first = interval;
+	struct vy_read_interval *last = interval;
+	struct vy_read_interval *curr;
+	while ((curr = vy_tx_read_set_prev(&tx->read_set, first)) != NULL &&
+	       curr->lsm == lsm)
+		first = curr;
+	while ((curr = vy_tx_read_set_next(&tx->read_set, last)) != NULL &&
+	       curr->lsm == lsm)
+		last = curr;
+	if (first == last)
+		return;
+	/*
+	 * Intervals of a transaction don't intersect, so the last
+	 * one has the max right boundary. The left boundary of the
+	 * first one, and so its position in the transaction read
+	 * set, doesn't change, but it has to be reinserted into the
+	 * LSM tree read set to update the subtree max.
+	 */
+	vy_lsm_read_set_remove(&lsm->read_set, first);
+	vy_read_interval_unacct(first);
+	tuple_ref(last->right.stmt);
+	tuple_unref(first->right.stmt);
+	first->right = last->right;
+	first->right_belongs = last->right_belongs;
+	vy_read_interval_acct(first);
+
+	struct vy_read_interval *end = vy_tx_read_set_next(&tx->read_set, last);
+	curr = vy_tx_read_set_next(&tx->read_set, first);
+	while (curr != end) {
+		struct vy_read_interval *next =
+			vy_tx_read_set_next(&tx->read_set, curr);
+		vy_tx_read_set_remove(&tx->read_set, curr);
+		vy_lsm_read_set_remove(&lsm->read_set, curr);
+		vy_read_interval_delete(curr);
+		tx->read_set_count--;
+		curr = next;
+	}
+	vy_lsm_read_set_insert(&lsm->read_set, first);
+}
+
 int
 vy_tx_track(struct vy_tx *tx, struct vy_lsm *lsm,
 	    struct vy_entry left, bool left_belongs,
@@ -1017,12 +1069,18 @@ vy_tx_track(struct vy_tx *tx, struct vy_lsm *lsm,
 			vy_tx_read_set_remove(&tx->read_set, interval);
 			vy_lsm_read_set_remove(&lsm->read_set, interval);
 			vy_read_interval_delete(interval);
+			tx->read_set_count--;
 		}
 		vy_read_interval_acct(new_interval);
 	}
 
 	vy_tx_read_set_insert(&tx->read_set, new_interval);
 	vy_lsm_read_set_insert(&lsm->read_set, new_interval);
+	tx->read_set_count++;
+
+	uint32_t max_count = tx->xm->max_read_set_count;
+	if (max_count > 0 && tx->read_set_count > max_count)
+		vy_tx_coarsen_read_set(tx, new_interval);
 	return 0;
 }
 
@@ -193,6 +193,8 @@ struct vy_tx {
 	 * intervals.
 	 */
 	vy_tx_read_set_t read_set;
+	/** Number of intervals in the read set. */
+	uint32_t read_set_count;
 	/**
 	 * Prepare sequence number or -1 if the transaction
 	 * is not prepared.
@@ -267,6 +269,13 @@ struct vy_tx_manager {
 	size_t write_set_size;
 	/** Sum size of statements pinned by the read set. */
 	size_t read_set_size;
+	/**
+	 * Max number of read intervals a transaction may have.
+	 * When it is exceeded, all intervals of the LSM tree the
+	 * transaction is reading from are replaced with a single
+	 * interval spanning them. Zero means no limit.
+	 */
+	uint32_t max_read_set_count;
 	/** Memory pool for struct vy_tx allocations. */
 	struct mempool tx_mempool;
 	/** Memory pool for struct txv allocations. */
@@ -32,6 +32,7 @@
  */
 #include "trivia/util.h"
 #include "vy_stmt_stream.h"
+#include "vy_entry.h"
 #include "vy_read_view.h"
 #include <stdbool.h>
 #include <pthread.h>
@@ -254,10 +255,13 @@ vy_write_iterator_new(struct key_def *cmp_def, bool is_primary,
 
 /**
  * Add a mem as a source to the iterator.
+ * Only statements that are >= @begin and < @end are taken
+ * from the mem. NULL @begin or @end stands for infinity.
  * @return 0 on success, -1 on error (diag is set).
  */
 NODISCARD int
-vy_write_iterator_new_mem(struct vy_stmt_stream *stream, struct vy_mem *mem);
+vy_write_iterator_new_mem(struct vy_stmt_stream *stream, struct vy_mem *mem,
+			  struct vy_entry begin, struct vy_entry end);
 
 /**
  * Add a run slice as a source to the iterator.
@@ -42,6 +42,9 @@
 #include "cbus.h"
 #include "coio_task.h"
 #include "replication.h"
+#include "histogram.h"
+#include "info/info.h"
+#include "probe.h"
 
 enum {
 	/**
@@ -53,6 +56,42 @@ enum {
 	 * latency. 1 MB seems to be a well balanced choice.
 	 */
 	WAL_FALLOCATE_LEN = 1024 * 1024,
+	/**
+	 * The adaptive group commit window is never narrowed
+	 * below wal_group_commit_timeout divided by this factor:
+	 * if it gets any narrower, it is reset to zero.
+	 */
+	WAL_GROUP_COMMIT_WINDOW_STEPS = 16,
+};
+
+/** Upper bounds of buckets of the group commit size histogram. */
+static const int64_t wal_batch_entries_buckets[] = {
+	1, 2, 4, 8, 16, 32, 64, 128, 256, 512, 1024, INT64_MAX,
+};
+
+/**
+ * Upper bounds of buckets of the group commit wait time
+ * histogram, in microseconds.
+ */
+static const int64_t wal_batch_wait_buckets[] = {
+	0, 10, 20, 50, 100, 200, 500, 1000, 2000, 5000, 10000, INT64_MAX,
+};
+
+/**
+ * Upper bounds of buckets of the WAL write size and the journal
+ * queue size histograms, in bytes.
+ */
+static const int64_t wal_size_buckets[] = {
+	512, 1024, 4096, 16384, 65536, 262144, 1048576, 4194304,
+	16777216, 67108864, 268435456, INT64_MAX,
+};
+
+/**
+ * Upper bounds of buckets of the WAL write and fallocate time
+ * histograms, in microseconds.
+ */
+static const int64_t wal_io_time_buckets[] = {
+	10, 20, 50, 100, 200, 500, 1000, 2000, 5000, 10000, 100000, INT64_MAX,
 };
 
 const char *wal_mode_STRS[WAL_MODE_MAX] = {
@@ -75,6 +114,30 @@ wal_write_none_async(struct journal *, struct journal_entry *);
 static int
 wal_write_none(struct journal *, struct journal_entry *);
 
+/**
+ * A bounded in-memory ring of recently written rows. It is
+ * filled by the WAL thread and read by relay threads, hence
+ * protected with a mutex. Blocks are reference counted so
+ * that a relay may send a block without holding the mutex
+ * even if the block gets evicted from the ring meanwhile.
+ */
+struct wal_ring {
+	pthread_mutex_t mutex;
+	/** Blocks, oldest first. */
+	struct rlist blocks;
+	/** Total size of blocks in the ring. */
+	size_t size;
+	/** Max total size of blocks. Zero if the ring is disabled. */
+	size_t max_size;
+	/**
+	 * Sequence number of the last appended block. Blocks in
+	 * the ring always have consecutive sequence numbers.
+	 */
+	int64_t seq;
+	/** WAL vclock after the last appended block. */
+	struct vclock vclock;
+};
+
 /*
  * WAL writer - maintain a Write Ahead Log for every change
  * in the data state.
@@ -116,6 +179,8 @@ struct wal_writer
 	struct xdir wal_dir;
 	/** 'wal' thread doing the writes. */
 	struct cord cord;
+	/** CPU the WAL thread is pinned to or -1. */
+	int cpu;
 	/**
 	 * Return pipe from 'wal' to tx'. This is a
 	 * priority pipe and DOES NOT support yield.
@@ -158,6 +223,18 @@ struct wal_writer
 	bool checkpoint_triggered;
 	/** The current WAL file. */
 	struct xlog current_wal;
+	/**
+	 * Set while the file for the next WAL is being
+	 * preallocated in a coio thread, see wal_prepare_spare().
+	 */
+	bool spare_in_progress;
+	/** Signaled when spare_in_progress is cleared. */
+	struct fiber_cond spare_cond;
+	/** Set if the file system doesn't support preallocation. */
+	bool spare_disabled;
+	/** Size and path of the file being preallocated. */
+	size_t spare_size;
+	char spare_path[PATH_MAX];
 	/**
 	 * Used if there was a WAL I/O error and we need to
 	 * keep adding all incoming requests to the rollback
@@ -170,12 +247,68 @@ struct wal_writer
 	 * Used for replication relays.
 	 */
 	struct rlist watchers;
+	/**
+	 * Max time the WAL thread may wait for more requests
+	 * to arrive before writing a batch, in seconds. Zero
+	 * disables waiting, but the requests that have already
+	 * been queued are still merged into one write.
+	 */
+	double group_commit_timeout;
+	/**
+	 * The WAL thread stops waiting for more requests once
+	 * the batch size reaches this number of bytes ...
+	 */
+	int64_t group_commit_max_size;
+	/** ... or this number of journal entries. */
+	int64_t group_commit_max_entries;
+	/**
+	 * Current group commit wait time. It adapts to the load:
+	 * it is widened up to group_commit_timeout while waiting
+	 * results in bigger batches and narrowed otherwise so
+	 * that a lone writer doesn't pay the wait latency.
+	 */
+	double group_commit_window;
+	/**
+	 * The 'wal' endpoint and messages fetched from it but
+	 * not delivered yet. Used for merging queued batches.
+	 */
+	struct cbus_endpoint *endpoint;
+	struct stailq pending;
+	/** Number of journal entries per disk write. */
+	struct histogram *batch_entries_hist;
+	/** Time spent waiting for a batch to fill, in microseconds. */
+	struct histogram *batch_wait_hist;
+	/** Number of bytes written to disk per batch. */
+	struct histogram *write_size_hist;
+	/**
+	 * Time of writing a batch to disk, in microseconds.
+	 * In the fsync mode the WAL is opened with O_SYNC, so
+	 * this includes the time of syncing the data.
+	 */
+	struct histogram *write_time_hist;
+	/** Time of xlog_fallocate() calls, in microseconds. */
+	struct histogram *fallocate_time_hist;
+	/**
+	 * Size of the journal queue in bytes when an entry is
+	 * submitted. Unlike the histograms above, this one is
+	 * owned by tx.
+	 */
+	struct histogram *queue_size_hist;
+	/** Recently written rows streamed by relays. */
+	struct wal_ring ring;
 };
 
 struct wal_msg {
 	struct cmsg base;
 	/** Approximate size of this request when encoded. */
 	size_t approx_len;
+	/** Number of journal entries in the commit queue. */
+	int64_t entry_count;
+	/**
+	 * Set if the entries of this batch were merged into
+	 * a preceding one and written along with it.
+	 */
+	bool is_merged;
 	/** Input queue, on output contains all committed requests. */
 	struct stailq commit;
 	/**
@@ -210,6 +343,12 @@ wal_dir(void)
 	return wal_writer_singleton.wal_dir.dirname;
 }
 
+int
+wal_cpu(void)
+{
+	return wal_writer_singleton.cpu;
+}
+
 static void
 wal_write_to_disk(struct cmsg *msg);
 
@@ -226,6 +365,8 @@ wal_msg_create(struct wal_msg *batch)
 {
 	cmsg_init(&batch->base, wal_request_route);
 	batch->approx_len = 0;
+	batch->entry_count = 0;
+	batch->is_merged = false;
 	stailq_create(&batch->commit);
 	stailq_create(&batch->rollback);
 	vclock_create(&batch->vclock);
@@ -373,6 +514,7 @@ tx_complete_batch(struct cmsg *msg)
 	}
 	/* Update the tx vclock to the latest written by wal. */
 	vclock_copy(&replicaset.vclock, &batch->vclock);
+	fiber_cond_broadcast(&replicaset.vclock_cond);
 	tx_schedule_queue(&batch->commit);
 	mempool_free(&writer->msg_pool, container_of(msg, struct wal_msg, base));
 }
@@ -406,6 +548,218 @@ tx_notify_checkpoint(struct cmsg *msg)
 	free(msg);
 }
 
+static void
+wal_ring_create(struct wal_ring *ring)
+{
+	tt_pthread_mutex_init(&ring->mutex, NULL);
+	rlist_create(&ring->blocks);
+	ring->size = 0;
+	ring->max_size = 0;
+	ring->seq = 0;
+	vclock_create(&ring->vclock);
+}
+
+static void
+wal_ring_block_unref_locked(struct wal_ring_block *block)
+{
+	assert(block->refs > 0);
+	if (--block->refs == 0)
+		free(block);
+}
+
+/** Evict the oldest blocks until the ring fits in @max_size. */
+static void
+wal_ring_evict_locked(struct wal_ring *ring, size_t max_size)
+{
+	while (ring->size > max_size) {
+		assert(!rlist_empty(&ring->blocks));
+		struct wal_ring_block *block = rlist_shift_entry(
+			&ring->blocks, struct wal_ring_block, in_ring);
+		ring->size -= block->size;
+		wal_ring_block_unref_locked(block);
+	}
+}
+
+static void
+wal_ring_destroy(struct wal_ring *ring)
+{
+	wal_ring_evict_locked(ring, 0);
+	tt_pthread_mutex_destroy(&ring->mutex);
+}
+
+/**
+ * Change the max size of the ring. Called in the WAL thread.
+ * When the ring is enabled, it starts at the current WAL
+ * vclock @vclock.
+ */
+static void
+wal_ring_set_max_size(struct wal_ring *ring, size_t max_size,
+		      const struct vclock *vclock)
+{
+	tt_pthread_mutex_lock(&ring->mutex);
+	if (ring->max_size == 0 && max_size != 0) {
+		/* Invalidate cursors created before disabling. */
+		ring->seq++;
+		vclock_copy(&ring->vclock, vclock);
+	}
+	ring->max_size = max_size;
+	wal_ring_evict_locked(ring, max_size);
+	tt_pthread_mutex_unlock(&ring->mutex);
+}
+
+/**
+ * Append the rows of written journal @entries to the ring.
+ * @vclock_begin and @vclock_end are the WAL vclock before
+ * and after the rows. Called in the WAL thread.
+ */
+static void
+wal_ring_append(struct wal_ring *ring, int64_t file_signature,
+		const struct vclock *vclock_begin,
+		const struct vclock *vclock_end, struct stailq *entries)
+{
+	if (ring->max_size == 0)
+		return;
+	struct journal_entry *entry;
+	int row_count = 0;
+	size_t data_size = 0;
+	stailq_foreach_entry(entry, entries, fifo) {
+		row_count += entry->n_rows;
+		for (int i = 0; i < entry->n_rows; i++) {
+			struct xrow_header *row = entry->rows[i];
+			for (int j = 0; j < row->bodycnt; j++)
+				data_size += row->body[j].iov_len;
+		}
+	}
+	size_t size = sizeof(struct wal_ring_block) +
+		      row_count * sizeof(struct xrow_header) + data_size;
+	struct wal_ring_block *block = NULL;
+	if (size <= ring->max_size)
+		block = malloc(size);
+	if (block != NULL) {
+		block->refs = 1;
+		block->file_signature = file_signature;
+		vclock_copy(&block->vclock, vclock_begin);
+		block->size = size;
+		block->row_count = row_count;
+		char *data = (char *)&block->rows[row_count];
+		struct xrow_header *dst = block->rows;
+		stailq_foreach_entry(entry, entries, fifo) {
+			for (int i = 0; i < entry->n_rows; i++, dst++) {
+				struct xrow_header *row = entry->rows[i];
+				*dst = *row;
+				dst->sync = 0;
+				dst->schema_version = 0;
+				if (row->bodycnt == 0)
+					continue;
+				dst->bodycnt = 1;
+				dst->body[0].iov_base = data;
+				for (int j = 0; j < row->bodycnt; j++) {
+					memcpy(data, row->body[j].iov_base,
+					       row->body[j].iov_len);
+					data += row->body[j].iov_len;
+				}
+				dst->body[0].iov_len =
+					data - (char *)dst->body[0].iov_base;
+			}
+		}
+	}
+	tt_pthread_mutex_lock(&ring->mutex);
+	ring->seq++;
+	vclock_copy(&ring->vclock, vclock_end);
+	if (block != NULL) {
+		block->seq = ring->seq;
+		rlist_add_tail_entry(&ring->blocks, block, in_ring);
+		ring->size += size;
+		wal_ring_evict_locked(ring, ring->max_size);
+	} else {
+		/*
+		 * The rows can't be stored in the ring. Drop all
+		 * blocks so that relays notice the gap by sequence
+		 * number and read the rows from the xlog file.
+		 */
+		wal_ring_evict_locked(ring, 0);
+	}
+	tt_pthread_mutex_unlock(&ring->mutex);
+}
+
+int
+wal_ring_cursor_create(struct wal_ring_cursor *cursor,
+		       const struct vclock *vclock)
+{
+	struct wal_ring *ring = &wal_writer_singleton.ring;
+	int rc = -1;
+	tt_pthread_mutex_lock(&ring->mutex);
+	if (ring->max_size == 0)
+		goto out;
+	if (rlist_empty(&ring->blocks)) {
+		if (vclock_compare_ignore0(&ring->vclock, vclock) <= 0) {
+			cursor->seq = ring->seq;
+			rc = 0;
+		}
+		goto out;
+	}
+	/*
+	 * Start from the newest block that doesn't begin past
+	 * @vclock. Rows of the block already sent by the relay
+	 * are skipped by it by LSN.
+	 */
+	struct wal_ring_block *block;
+	rlist_foreach_entry_reverse(block, &ring->blocks, in_ring) {
+		if (vclock_compare_ignore0(&block->vclock, vclock) <= 0) {
+			cursor->seq = block->seq - 1;
+			rc = 0;
+			break;
+		}
+	}
+out:
+	tt_pthread_mutex_unlock(&ring->mutex);
+	return rc;
+}
+
+int
+wal_ring_cursor_next(struct wal_ring_cursor *cursor,
+		     struct wal_ring_block **ret)
+{
+	struct wal_ring *ring = &wal_writer_singleton.ring;
+	int rc = 0;
+	*ret = NULL;
+	tt_pthread_mutex_lock(&ring->mutex);
+	if (ring->max_size == 0) {
+		rc = -1;
+		goto out;
+	}
+	if (cursor->seq == ring->seq)
+		goto out;
+	if (rlist_empty(&ring->blocks) ||
+	    rlist_first_entry(&ring->blocks, struct wal_ring_block,
+			      in_ring)->seq > cursor->seq + 1) {
+		rc = -1;
+		goto out;
+	}
+	/* Relays are supposed to be close to the ring end. */
+	struct wal_ring_block *block;
+	rlist_foreach_entry_reverse(block, &ring->blocks, in_ring) {
+		if (block->seq == cursor->seq + 1)
+			break;
+	}
+	assert(block->seq == cursor->seq + 1);
+	block->refs++;
+	cursor->seq = block->seq;
+	*ret = block;
+out:
+	tt_pthread_mutex_unlock(&ring->mutex);
+	return rc;
+}
+
+void
+wal_ring_block_unref(struct wal_ring_block *block)
+{
+	struct wal_ring *ring = &wal_writer_singleton.ring;
+	tt_pthread_mutex_lock(&ring->mutex);
+	wal_ring_block_unref_locked(block);
+	tt_pthread_mutex_unlock(&ring->mutex);
+}
+
 /**
  * Initialize WAL writer context. Even though it's a singleton,
  * encapsulate the details just in case we may use
@@ -431,6 +785,10 @@ wal_writer_create(struct wal_writer *writer, enum wal_mode wal_mode,
 	opts.sync_is_async = true;
 	xdir_create(&writer->wal_dir, wal_dirname, XLOG, instance_uuid, &opts);
 	xlog_clear(&writer->current_wal);
+	writer->spare_in_progress = false;
+	fiber_cond_create(&writer->spare_cond);
+	writer->spare_disabled = false;
+	writer->spare_size = 0;
 	if (wal_mode == WAL_FSYNC)
 		writer->wal_dir.open_wflags |= O_SYNC;
 
@@ -450,6 +808,34 @@ wal_writer_create(struct wal_writer *writer, enum wal_mode wal_mode,
 
 	mempool_create(&writer->msg_pool, &cord()->slabc,
 		       sizeof(struct wal_msg));
+
+	writer->group_commit_timeout = 0;
+	writer->group_commit_max_size = INT64_MAX;
+	writer->group_commit_max_entries = INT64_MAX;
+	writer->group_commit_window = 0;
+	writer->endpoint = NULL;
+	stailq_create(&writer->pending);
+	writer->batch_entries_hist = histogram_new(wal_batch_entries_buckets,
+					lengthof(wal_batch_entries_buckets));
+	writer->batch_wait_hist = histogram_new(wal_batch_wait_buckets,
+					lengthof(wal_batch_wait_buckets));
+	writer->write_size_hist = histogram_new(wal_size_buckets,
+					lengthof(wal_size_buckets));
+	writer->write_time_hist = histogram_new(wal_io_time_buckets,
+					lengthof(wal_io_time_buckets));
+	writer->fallocate_time_hist = histogram_new(wal_io_time_buckets,
+					lengthof(wal_io_time_buckets));
+	writer->queue_size_hist = histogram_new(wal_size_buckets,
+					lengthof(wal_size_buckets));
+	if (writer->batch_entries_hist == NULL ||
+	    writer->batch_wait_hist == NULL ||
+	    writer->write_size_hist == NULL ||
+	    writer->write_time_hist == NULL ||
+	    writer->fallocate_time_hist == NULL ||
+	    writer->queue_size_hist == NULL)
+		panic("failed to allocate WAL statistics");
+
+	wal_ring_create(&writer->ring);
 }
 
 /** Destroy a WAL writer structure. */
@@ -457,6 +843,14 @@ static void
 wal_writer_destroy(struct wal_writer *writer)
 {
 	xdir_destroy(&writer->wal_dir);
+	fiber_cond_destroy(&writer->spare_cond);
+	histogram_delete(writer->batch_entries_hist);
+	histogram_delete(writer->batch_wait_hist);
+	histogram_delete(writer->write_size_hist);
+	histogram_delete(writer->write_time_hist);
+	histogram_delete(writer->fallocate_time_hist);
+	histogram_delete(writer->queue_size_hist);
+	wal_ring_destroy(&writer->ring);
 }
 
 /** WAL writer thread routine. */
@@ -536,20 +930,21 @@ int
 wal_init(enum wal_mode wal_mode, const char *wal_dirname,
 	 int64_t wal_max_size, const struct tt_uuid *instance_uuid,
 	 wal_on_garbage_collection_f on_garbage_collection,
-	 wal_on_checkpoint_threshold_f on_checkpoint_threshold)
+	 wal_on_checkpoint_threshold_f on_checkpoint_threshold, int cpu)
 {
 	/* Initialize the state. */
 	struct wal_writer *writer = &wal_writer_singleton;
 	wal_writer_create(writer, wal_mode, wal_dirname, wal_max_size,
 			  instance_uuid, on_garbage_collection,
 			  on_checkpoint_threshold);
+	writer->cpu = cpu;
 
 	/* Start WAL thread. */
 	if (cord_costart(&writer->cord, "wal", wal_writer_f, NULL) != 0)
 		return -1;
 
 	/* Create a pipe to WAL thread. */
-	cpipe_create(&writer->wal_pipe, "wal");
+	cpipe_create_ring(&writer->wal_pipe, "wal");
 	cpipe_set_max_input(&writer->wal_pipe, IOV_MAX);
 	return 0;
 }
@@ -777,6 +1172,201 @@ wal_set_queue_max_size(int64_t size)
 	journal_queue_set_max_size(size);
 }
 
+struct wal_set_group_commit_msg {
+	struct cbus_call_msg base;
+	double timeout;
+	int64_t max_size;
+	int64_t max_entries;
+};
+
+static int
+wal_set_group_commit_f(struct cbus_call_msg *data)
+{
+	struct wal_writer *writer = &wal_writer_singleton;
+	struct wal_set_group_commit_msg *msg;
+	msg = (struct wal_set_group_commit_msg *)data;
+	writer->group_commit_timeout = msg->timeout;
+	writer->group_commit_max_size = msg->max_size;
+	writer->group_commit_max_entries = msg->max_entries;
+	writer->group_commit_window = msg->timeout;
+	return 0;
+}
+
+void
+wal_set_group_commit(double timeout, int64_t max_size, int64_t max_entries)
+{
+	struct wal_writer *writer = &wal_writer_singleton;
+	if (writer->wal_mode == WAL_NONE)
+		return;
+	struct wal_set_group_commit_msg msg;
+	msg.timeout = timeout;
+	msg.max_size = max_size;
+	msg.max_entries = max_entries;
+	bool cancellable = fiber_set_cancellable(false);
+	cbus_call(&writer->wal_pipe, &writer->tx_prio_pipe,
+		  &msg.base, wal_set_group_commit_f, NULL,
+		  TIMEOUT_INFINITY);
+	fiber_set_cancellable(cancellable);
+}
+
+struct wal_set_ring_size_msg {
+	struct cbus_call_msg base;
+	int64_t size;
+};
+
+static int
+wal_set_ring_size_f(struct cbus_call_msg *data)
+{
+	struct wal_writer *writer = &wal_writer_singleton;
+	struct wal_set_ring_size_msg *msg;
+	msg = (struct wal_set_ring_size_msg *)data;
+	wal_ring_set_max_size(&writer->ring, msg->size, &writer->vclock);
+	return 0;
+}
+
+void
+wal_set_ring_size(int64_t size)
+{
+	struct wal_writer *writer = &wal_writer_singleton;
+	if (writer->wal_mode == WAL_NONE)
+		return;
+	struct wal_set_ring_size_msg msg;
+	msg.size = size;
+	bool cancellable = fiber_set_cancellable(false);
+	cbus_call(&writer->wal_pipe, &writer->tx_prio_pipe,
+		  &msg.base, wal_set_ring_size_f, NULL,
+		  TIMEOUT_INFINITY);
+	fiber_set_cancellable(cancellable);
+}
+
+/** Snapshot of a WAL thread histogram passed to tx. */
+struct wal_hist_stat {
+	size_t total;
+	size_t count[lengthof(wal_batch_wait_buckets)];
+};
+
+static_assert(lengthof(wal_batch_entries_buckets) ==
+	      lengthof(wal_batch_wait_buckets) &&
+	      lengthof(wal_size_buckets) ==
+	      lengthof(wal_batch_wait_buckets) &&
+	      lengthof(wal_io_time_buckets) ==
+	      lengthof(wal_batch_wait_buckets),
+	      "WAL histograms must have the same number of buckets");
+
+struct wal_stat_msg {
+	struct cbus_call_msg base;
+	double window;
+	struct wal_hist_stat batch_entries;
+	struct wal_hist_stat batch_wait;
+	struct wal_hist_stat write_size;
+	struct wal_hist_stat write_time;
+	struct wal_hist_stat fallocate_time;
+};
+
+static void
+wal_hist_stat_create(struct wal_hist_stat *stat, struct histogram *hist)
+{
+	assert(hist->n_buckets == lengthof(stat->count));
+	stat->total = hist->total;
+	for (size_t i = 0; i < hist->n_buckets; i++)
+		stat->count[i] = hist->buckets[i].count;
+}
+
+static int
+wal_stat_f(struct cbus_call_msg *data)
+{
+	struct wal_writer *writer = &wal_writer_singleton;
+	struct wal_stat_msg *msg = (struct wal_stat_msg *)data;
+	msg->window = writer->group_commit_window;
+	wal_hist_stat_create(&msg->batch_entries, writer->batch_entries_hist);
+	wal_hist_stat_create(&msg->batch_wait, writer->batch_wait_hist);
+	wal_hist_stat_create(&msg->write_size, writer->write_size_hist);
+	wal_hist_stat_create(&msg->write_time, writer->write_time_hist);
+	wal_hist_stat_create(&msg->fallocate_time,
+			     writer->fallocate_time_hist);
+	return 0;
+}
+
+static void
+wal_hist_stat_info(struct info_handler *h, const char *name,
+		   const struct wal_hist_stat *stat, const int64_t *buckets)
+{
+	info_table_begin(h, name);
+	info_append_int(h, "total", stat->total);
+	info_table_begin(h, "histogram");
+	for (size_t i = 0; i < lengthof(stat->count); i++) {
+		char key[32];
+		if (buckets[i] == INT64_MAX)
+			snprintf(key, sizeof(key), "inf");
+		else
+			snprintf(key, sizeof(key), "le_%lld",
+				 (long long)buckets[i]);
+		info_append_int(h, key, stat->count[i]);
+	}
+	info_table_end(h); /* histogram */
+	info_table_end(h); /* name */
+}
+
+void
+wal_stat(struct info_handler *h)
+{
+	struct wal_writer *writer = &wal_writer_singleton;
+	struct wal_stat_msg msg;
+	if (writer->wal_mode == WAL_NONE) {
+		memset(&msg, 0, sizeof(msg));
+	} else {
+		bool cancellable = fiber_set_cancellable(false);
+		cbus_call(&writer->wal_pipe, &writer->tx_prio_pipe,
+			  &msg.base, wal_stat_f, NULL, TIMEOUT_INFINITY);
+		fiber_set_cancellable(cancellable);
+	}
+	info_begin(h);
+	info_table_begin(h, "group_commit");
+	info_append_double(h, "window", msg.window);
+	wal_hist_stat_info(h, "batch_entries", &msg.batch_entries,
+			   wal_batch_entries_buckets);
+	wal_hist_stat_info(h, "batch_wait", &msg.batch_wait,
+			   wal_batch_wait_buckets);
+	info_table_end(h); /* group_commit */
+	wal_hist_stat_info(h, "write_size", &msg.write_size,
+			   wal_size_buckets);
+	wal_hist_stat_info(h, "write_time", &msg.write_time,
+			   wal_io_time_buckets);
+	wal_hist_stat_info(h, "fallocate_time", &msg.fallocate_time,
+			   wal_io_time_buckets);
+	struct wal_hist_stat queue_size;
+	wal_hist_stat_create(&queue_size, writer->queue_size_hist);
+	wal_hist_stat_info(h, "queue_size", &queue_size, wal_size_buckets);
+	info_end(h);
+}
+
+static int
+wal_reset_stat_f(struct cbus_call_msg *data)
+{
+	(void)data;
+	struct wal_writer *writer = &wal_writer_singleton;
+	histogram_reset(writer->batch_entries_hist);
+	histogram_reset(writer->batch_wait_hist);
+	histogram_reset(writer->write_size_hist);
+	histogram_reset(writer->write_time_hist);
+	histogram_reset(writer->fallocate_time_hist);
+	return 0;
+}
+
+void
+wal_reset_stat(void)
+{
+	struct wal_writer *writer = &wal_writer_singleton;
+	if (writer->wal_mode == WAL_NONE)
+		return;
+	histogram_reset(writer->queue_size_hist);
+	struct cbus_call_msg msg;
+	bool cancellable = fiber_set_cancellable(false);
+	cbus_call(&writer->wal_pipe, &writer->tx_prio_pipe,
+		  &msg, wal_reset_stat_f, NULL, TIMEOUT_INFINITY);
+	fiber_set_cancellable(cancellable);
+}
+
 struct wal_gc_msg
 {
 	struct cbus_call_msg base;
@@ -828,6 +1418,54 @@ wal_collect_garbage(const struct vclock *vclock)
 static void
 wal_notify_watchers(struct wal_writer *writer, unsigned events);
 
+static void
+wal_prepare_spare_f(eio_req *req)
+{
+	struct wal_writer *writer = req->data;
+	req->result = xdir_prepare_spare(writer->spare_path,
+					 writer->spare_size);
+	req->errorno = errno;
+}
+
+static int
+wal_prepare_spare_done(eio_req *req)
+{
+	struct wal_writer *writer = req->data;
+	writer->spare_in_progress = false;
+	fiber_cond_broadcast(&writer->spare_cond);
+	if (req->result == 0) {
+		writer->wal_dir.spare_size = writer->spare_size;
+		return 0;
+	}
+	errno = req->errorno;
+	if (errno == EOPNOTSUPP || errno == ENOSYS) {
+		say_warn("fallocate is not supported, "
+			 "WAL files won't be preallocated");
+		writer->spare_disabled = true;
+	} else {
+		say_syserror("failed to preallocate %s", writer->spare_path);
+	}
+	return 0;
+}
+
+/**
+ * Preallocate disk space for the next WAL file in a coio
+ * thread, so that rotation and writes to the new file don't
+ * have to wait for the file system to allocate it.
+ */
+static void
+wal_prepare_spare(struct wal_writer *writer)
+{
+	if (writer->spare_disabled || writer->spare_in_progress ||
+	    writer->wal_dir.spare_size > 0)
+		return;
+	writer->spare_in_progress = true;
+	writer->spare_size = writer->wal_max_size;
+	strlcpy(writer->spare_path, xdir_spare_filename(&writer->wal_dir),
+		sizeof(writer->spare_path));
+	eio_custom(wal_prepare_spare_f, 0, wal_prepare_spare_done, writer);
+}
+
 /**
  * If there is no current WAL, try to open it, and close the
  * previous WAL. We close the previous WAL only after opening
@@ -872,6 +1510,7 @@ wal_opt_rotate(struct wal_writer *writer)
 	xdir_add_vclock(&writer->wal_dir, &writer->vclock);
 
 	wal_notify_watchers(writer, WAL_EVENT_ROTATE);
+	wal_prepare_spare(writer);
 	return 0;
 }
 
@@ -907,7 +1546,11 @@ retry:
 	if (errinj == NULL || errinj->iparam == 0) {
 		if (l->allocated >= len)
 			goto out;
-		if (xlog_fallocate(l, MAX(len, WAL_FALLOCATE_LEN)) == 0)
+		double start = ev_monotonic_time();
+		int alloc_rc = xlog_fallocate(l, MAX(len, WAL_FALLOCATE_LEN));
+		histogram_collect(writer->fallocate_time_hist,
+				  (ev_monotonic_time() - start) * 1e6);
+		if (alloc_rc == 0)
 			goto out;
 	} else {
 		errinj->iparam--;
@@ -916,6 +1559,11 @@ retry:
 	}
 	if (errno != ENOSPC)
 		goto error;
+	if (writer->wal_dir.spare_size > 0) {
+		/* The preallocated file is the cheapest to drop. */
+		xdir_drop_spare(&writer->wal_dir);
+		goto retry;
+	}
 	if (!xdir_has_garbage(&writer->wal_dir, gc_lsn))
 		goto error;
 
@@ -1031,6 +1679,92 @@ wal_assign_lsn(struct vclock *vclock_diff, struct vclock *base,
 		(*row)->tsn = tsn;
 }
 
+/** Check if a batch has reached the group commit size limits. */
+static inline bool
+wal_group_commit_is_full(struct wal_writer *writer, struct wal_msg *batch)
+{
+	return batch->entry_count >= writer->group_commit_max_entries ||
+	       (int64_t)batch->approx_len >= writer->group_commit_max_size;
+}
+
+/**
+ * Merge WAL batches that were queued right after @batch into it.
+ * The merged batches are left in the pending queue with the
+ * is_merged flag set so that they are still returned to tx, in
+ * order, after @batch. Merging stops at the first message that
+ * isn't a WAL batch, because requests like checkpointing must
+ * not be reordered with writes.
+ *
+ * Returns the number of merged journal entries or -1 if no more
+ * batches can be merged.
+ */
+static int64_t
+wal_group_commit_merge(struct wal_writer *writer, struct wal_msg *batch)
+{
+	cbus_endpoint_fetch(writer->endpoint, &writer->pending);
+	int64_t merged = 0;
+	struct cmsg *msg;
+	stailq_foreach_entry(msg, &writer->pending, fifo) {
+		struct wal_msg *next = wal_msg(msg);
+		if (next == NULL)
+			return -1;
+		if (next->is_merged)
+			continue;
+		if (wal_group_commit_is_full(writer, batch))
+			return -1;
+		stailq_concat(&batch->commit, &next->commit);
+		batch->approx_len += next->approx_len;
+		batch->entry_count += next->entry_count;
+		merged += next->entry_count;
+		next->approx_len = 0;
+		next->entry_count = 0;
+		next->is_merged = true;
+	}
+	return merged;
+}
+
+/**
+ * Group commit: merge more batches into @batch so that they are
+ * written and synced to disk at once. Waits for new batches to
+ * arrive for up to the current group commit window unless the
+ * batch size limits are reached. Adapts the window to the load.
+ */
+static void
+wal_group_commit(struct wal_writer *writer, struct wal_msg *batch)
+{
+	double start = ev_monotonic_time();
+	double deadline = start + writer->group_commit_window;
+	int64_t entry_count = batch->entry_count;
+	bool waited = false;
+	while (true) {
+		if (wal_group_commit_merge(writer, batch) < 0 ||
+		    wal_group_commit_is_full(writer, batch))
+			break;
+		double timeout = deadline - ev_monotonic_time();
+		if (timeout <= 0)
+			break;
+		fiber_yield_timeout(timeout);
+		waited = true;
+	}
+	double wait_time = ev_monotonic_time() - start;
+	histogram_collect(writer->batch_wait_hist, wait_time * 1e6);
+	/*
+	 * Widen the window if there was more than one writer,
+	 * narrow it if waiting didn't bring more entries.
+	 */
+	double max_window = writer->group_commit_timeout;
+	double min_window = max_window / WAL_GROUP_COMMIT_WINDOW_STEPS;
+	double window = writer->group_commit_window;
+	if (batch->entry_count > entry_count || entry_count > 1) {
+		window = MIN(MAX(window * 2, min_window), max_window);
+	} else if (waited) {
+		window /= 2;
+		if (window < min_window)
+			window = 0;
+	}
+	writer->group_commit_window = window;
+}
+
 static void
 wal_write_to_disk(struct cmsg *msg)
 {
@@ -1040,8 +1774,15 @@ wal_write_to_disk(struct cmsg *msg)
 	struct stailq_entry *last_committed = NULL;
 	struct journal_entry *entry;
 	struct error *error;
+	if (wal_msg->is_merged) {
+		/* The entries were written with a preceding batch. */
+		assert(stailq_empty(&wal_msg->commit));
+		vclock_copy(&wal_msg->vclock, &writer->vclock);
+		return;
+	}
 	if (stailq_empty(&wal_msg->commit))
 		panic("Attempted to write an empty batch to WAL");
+	PROBE2(wal_write_start, wal_msg->entry_count, wal_msg->approx_len);
 
 	/*
 	 * Track all vclock changes made by this batch into
@@ -1050,6 +1791,9 @@ wal_write_to_disk(struct cmsg *msg)
 	 */
 	struct vclock vclock_diff;
 	vclock_create(&vclock_diff);
+	/* WAL vclock before the batch, for the WAL ring. */
+	struct vclock vclock_begin;
+	vclock_copy(&vclock_begin, &writer->vclock);
 
 	ERROR_INJECT_SLEEP(ERRINJ_WAL_DELAY);
 
@@ -1065,6 +1809,9 @@ wal_write_to_disk(struct cmsg *msg)
 		goto done;
 	}
 
+	wal_group_commit(writer, wal_msg);
+	histogram_collect(writer->batch_entries_hist, wal_msg->entry_count);
+
 	/* Xlog is only rotated between queue processing  */
 	if (wal_opt_rotate(writer) != 0) {
 		err_code = JOURNAL_ENTRY_ERR_IO;
@@ -1099,6 +1846,8 @@ wal_write_to_disk(struct cmsg *msg)
 	 */
 
 	struct xlog *l = &writer->current_wal;
+	double write_start = ev_monotonic_time();
+	int64_t write_size = 0;
 
 	/*
 	 * Iterate over requests (transactions)
@@ -1115,6 +1864,7 @@ wal_write_to_disk(struct cmsg *msg)
 		}
 		if (rc > 0) {
 			writer->checkpoint_wal_size += rc;
+			write_size += rc;
 			last_committed = &entry->fifo;
 			vclock_merge(&writer->vclock, &vclock_diff);
 		}
@@ -1127,6 +1877,10 @@ wal_write_to_disk(struct cmsg *msg)
 	}
 
 	writer->checkpoint_wal_size += rc;
+	write_size += rc;
+	histogram_collect(writer->write_size_hist, write_size);
+	histogram_collect(writer->write_time_hist,
+			  (ev_monotonic_time() - write_start) * 1e6);
 	last_committed = stailq_last(&wal_msg->commit);
 	vclock_merge(&writer->vclock, &vclock_diff);
 
@@ -1186,11 +1940,38 @@ done:
 	} else {
 		assert(err_code == JOURNAL_ENTRY_ERR_UNKNOWN);
 	}
+	if (!stailq_empty(&wal_msg->commit)) {
+		wal_ring_append(&writer->ring,
+				vclock_sum(&writer->current_wal.meta.vclock),
+				&vclock_begin, &writer->vclock,
+				&wal_msg->commit);
+	}
 	fiber_gc();
+	PROBE2(wal_write_done, wal_msg->entry_count, err_code);
 	wal_notify_watchers(writer, WAL_EVENT_WRITE);
 	ERROR_INJECT_SLEEP(ERRINJ_RELAY_FASTER_THAN_TX);
 }
 
+/**
+ * Same as cbus_loop(), but keeps the fetched messages in the
+ * writer so that WAL batches can be merged by group commit.
+ */
+static void
+wal_writer_loop(struct wal_writer *writer)
+{
+	while (true) {
+		cbus_endpoint_fetch(writer->endpoint, &writer->pending);
+		while (!stailq_empty(&writer->pending)) {
+			struct cmsg *msg = stailq_shift_entry(
+				&writer->pending, struct cmsg, fifo);
+			cmsg_deliver(msg);
+		}
+		if (fiber_is_cancelled())
+			break;
+		fiber_yield();
+	}
+}
+
 /** WAL writer main loop.  */
 static int
 wal_writer_f(va_list ap)
@@ -1198,6 +1979,15 @@ wal_writer_f(va_list ap)
 	(void) ap;
 	struct wal_writer *writer = &wal_writer_singleton;
 
+	if (writer->cpu >= 0) {
+		int rc = tt_pthread_setaffinity(writer->cpu);
+		if (rc != 0) {
+			say_warn("failed to pin WAL thread to CPU %d: %s",
+				 writer->cpu, strerror(rc));
+			writer->cpu = -1;
+		}
+	}
+
 	/** Initialize eio in this thread */
 	coio_enable();
 
@@ -1208,9 +1998,18 @@ wal_writer_f(va_list ap)
 	 * endpoint, to ensure that WAL messages are delivered
 	 * even when tx fiber pool is used up by net messages.
 	 */
-	cpipe_create(&writer->tx_prio_pipe, "tx_prio");
+	cpipe_create_ring(&writer->tx_prio_pipe, "tx_prio");
 
-	cbus_loop(&endpoint);
+	writer->endpoint = &endpoint;
+	wal_writer_loop(writer);
+	writer->endpoint = NULL;
+
+	/*
+	 * Wait for the spare file to be preallocated, otherwise
+	 * it would be created after it's dropped below.
+	 */
+	while (writer->spare_in_progress)
+		fiber_cond_wait(&writer->spare_cond);
 
 	/*
 	 * Create a new empty WAL on shutdown so that we don't
@@ -1232,6 +2031,8 @@ wal_writer_f(va_list ap)
 	if (xlog_is_open(&writer->current_wal))
 		xlog_close(&writer->current_wal, false);
 
+	xdir_drop_spare(&writer->wal_dir);
+
 	if (xlog_is_open(&vy_log_writer.xlog))
 		xlog_close(&vy_log_writer.xlog, false);
 
@@ -1296,7 +2097,9 @@ wal_write_async(struct journal *journal, struct journal_entry *entry)
 	 * transactions until and including this one.
 	 */
 	writer->last_entry = entry;
+	histogram_collect(writer->queue_size_hist, journal_queue.size);
 	batch->approx_len += entry->approx_len;
+	batch->entry_count++;
 	writer->wal_pipe.n_input += entry->n_rows * XROW_IOVMAX;
 #ifndef NDEBUG
 	++errinj(ERRINJ_WAL_WRITE_COUNT, ERRINJ_INT)->iparam;
@@ -35,11 +35,13 @@
 #include "small/rlist.h"
 #include "cbus.h"
 #include "journal.h"
+#include "xrow.h"
 #include "vclock/vclock.h"
 
 struct fiber;
 struct wal_writer;
 struct tt_uuid;
+struct info_handler;
 
 enum wal_mode {
 	/**
@@ -97,13 +99,14 @@ typedef void (*wal_on_garbage_collection_f)(const struct vclock *vclock);
 typedef void (*wal_on_checkpoint_threshold_f)(void);
 
 /**
- * Start WAL thread and initialize WAL writer.
+ * Start WAL thread and initialize WAL writer. If @a cpu isn't
+ * negative, the thread is pinned to this CPU.
  */
 int
 wal_init(enum wal_mode wal_mode, const char *wal_dirname,
 	 int64_t wal_max_size, const struct tt_uuid *instance_uuid,
 	 wal_on_garbage_collection_f on_garbage_collection,
-	 wal_on_checkpoint_threshold_f on_checkpoint_threshold);
+	 wal_on_checkpoint_threshold_f on_checkpoint_threshold, int cpu);
 
 /**
  * Setup WAL writer as journaling subsystem.
@@ -124,6 +127,13 @@ wal_free(void);
 const char *
 wal_dir(void);
 
+/**
+ * Get the CPU the WAL thread is pinned to or -1 if it isn't
+ * pinned.
+ */
+int
+wal_cpu(void);
+
 struct wal_watcher_msg {
 	struct cmsg cmsg;
 	struct wal_watcher *watcher;
@@ -263,6 +273,95 @@ wal_set_checkpoint_threshold(int64_t threshold);
 void
 wal_set_queue_max_size(int64_t size);
 
+/**
+ * Configure WAL group commit. The WAL thread waits up to @timeout
+ * seconds for more transactions to write them to disk at once,
+ * unless the batch size exceeds @max_size bytes or @max_entries
+ * journal entries.
+ */
+void
+wal_set_group_commit(double timeout, int64_t max_size, int64_t max_entries);
+
+/**
+ * Fill WAL statistics: histograms of group commit sizes and
+ * wait times.
+ */
+void
+wal_stat(struct info_handler *h);
+
+/** Reset WAL statistics. */
+void
+wal_reset_stat(void);
+
+/**
+ * A batch of rows written to WAL by one disk write and kept
+ * in the WAL ring so that relays can send it without reading
+ * the rows back from the xlog file.
+ */
+struct wal_ring_block {
+	/** Link in the WAL ring, oldest block first. */
+	struct rlist in_ring;
+	/** Sequence number of the block in the ring. */
+	int64_t seq;
+	/**
+	 * Number of references: the ring holds one while the
+	 * block is in it, and each relay reading it holds one.
+	 */
+	int refs;
+	/** Signature of the xlog file the rows were written to. */
+	int64_t file_signature;
+	/** WAL vclock before the rows of this block. */
+	struct vclock vclock;
+	/** Size of the block, including the row bodies. */
+	size_t size;
+	/** Number of rows in the block. */
+	int row_count;
+	/**
+	 * Rows of the block. Bodies are stored right after the
+	 * array, one iovec per row.
+	 */
+	struct xrow_header rows[0];
+};
+
+/** Position of a relay in the WAL ring. */
+struct wal_ring_cursor {
+	/** Sequence number of the last block read. */
+	int64_t seq;
+};
+
+/**
+ * Set the max total size of rows kept in the WAL ring.
+ * Zero disables the ring.
+ */
+void
+wal_set_ring_size(int64_t size);
+
+/**
+ * Position a cursor to read rows following @vclock from the
+ * WAL ring. Returns -1 if the ring doesn't have all the rows
+ * following @vclock, in which case they have to be read from
+ * xlog files. May be called from any thread.
+ */
+int
+wal_ring_cursor_create(struct wal_ring_cursor *cursor,
+		       const struct vclock *vclock);
+
+/**
+ * Fetch the next block from the WAL ring. On success, @ret is
+ * set to the block, which must be released with
+ * wal_ring_block_unref(), or to NULL if there are no new blocks.
+ * Returns -1 if the next block has already been evicted from
+ * the ring or the ring was disabled. May be called from any
+ * thread.
+ */
+int
+wal_ring_cursor_next(struct wal_ring_cursor *cursor,
+		     struct wal_ring_block **ret);
+
+/** Release a block returned by wal_ring_cursor_next(). */
+void
+wal_ring_block_unref(struct wal_ring_block *block);
+
 /**
  * Remove WAL files that are not needed by consumers reading
  * rows at @vclock or newer.
@@ -41,6 +41,7 @@
 #include <msgpuck.h>
 
 #include "coio_file.h"
+#include "file_reclaim.h"
 #include "tt_static.h"
 #include "error.h"
 #include "xrow.h"
@@ -96,6 +97,7 @@ const struct xlog_opts xlog_opts_default = {
 	.free_cache = false,
 	.sync_is_async = false,
 	.no_compression = false,
+	.zcdict = NULL,
 };
 
 /* {{{ struct xlog_meta */
@@ -669,10 +671,18 @@ xdir_say_gc(int result, int errorno, const char *filename)
 	}
 }
 
+static void
+xdir_do_gc(eio_req *req)
+{
+	req->result = file_reclaim_unlink(req->data);
+	req->errorno = errno;
+}
+
 static int
 xdir_complete_gc(eio_req *req)
 {
-	xdir_say_gc(req->result, req->errorno, EIO_PATH(req));
+	xdir_say_gc(req->result, req->errorno, req->data);
+	free(req->data);
 	return 0;
 }
 
@@ -684,8 +694,10 @@ xdir_collect_garbage(struct xdir *dir, int64_t signature, unsigned flags)
 	       vclock_sum(vclock) < signature) {
 		const char *filename =
 			xdir_format_filename(dir, vclock_sum(vclock), NONE);
-		if (flags & XDIR_GC_ASYNC) {
-			eio_unlink(filename, 0, xdir_complete_gc, NULL);
+		char *path;
+		if ((flags & XDIR_GC_ASYNC) &&
+		    (path = strdup(filename)) != NULL) {
+			eio_custom(xdir_do_gc, 0, xdir_complete_gc, path);
 		} else {
 			int rc = unlink(filename);
 			xdir_say_gc(rc, errno, filename);
@@ -823,9 +835,16 @@ xlog_destroy(struct xlog *xlog)
 	xlog->fd = -1;
 }
 
-int
-xlog_create(struct xlog *xlog, const char *name, int flags,
-	    const struct xlog_meta *meta, const struct xlog_opts *opts)
+/**
+ * Create a new xlog file, see xlog_create(). If @a spare is
+ * not NULL, try to use the file preallocated at this path with
+ * xdir_prepare_spare() instead of creating a new one.
+ */
+static int
+xlog_create_from_spare(struct xlog *xlog, const char *name, int flags,
+		       const struct xlog_meta *meta,
+		       const struct xlog_opts *opts,
+		       const char *spare, size_t spare_size)
 {
 	char meta_buf[XLOG_META_LEN_MAX];
 	int meta_len;
@@ -856,6 +875,20 @@ xlog_create(struct xlog *xlog, const char *name, int flags,
 
 	flags |= O_RDWR | O_CREAT | O_EXCL;
 
+	/*
+	 * The spare file is created in the same directory with
+	 * zero size, so it's enough to rename it. If this fails,
+	 * fall back on creating a new file.
+	 */
+	if (spare != NULL) {
+		if (rename(spare, xlog->filename) == 0) {
+			flags &= ~O_EXCL;
+		} else {
+			say_syserror("failed to rename %s", spare);
+			spare = NULL;
+		}
+	}
+
 	/*
 	 * Open the <lsn>.<suffix>.inprogress file.
 	 * If it exists, open will fail. Always open/create
@@ -889,6 +922,8 @@ xlog_create(struct xlog *xlog, const char *name, int flags,
 	}
 
 	xlog->offset = meta_len; /* first log starts after meta */
+	if (spare != NULL && spare_size > (size_t)meta_len)
+		xlog->allocated = spare_size - meta_len;
 	return 0;
 err_write:
 	close(xlog->fd);
@@ -899,6 +934,13 @@ err:
 	return -1;
 }
 
+int
+xlog_create(struct xlog *xlog, const char *name, int flags,
+	    const struct xlog_meta *meta, const struct xlog_opts *opts)
+{
+	return xlog_create_from_spare(xlog, name, flags, meta, opts, NULL, 0);
+}
+
 int
 xlog_open(struct xlog *xlog, const char *name, const struct xlog_opts *opts)
 {
@@ -1015,9 +1057,17 @@ xdir_create_xlog(struct xdir *dir, struct xlog *xlog,
 	xlog_meta_create(&meta, dir->filetype, dir->instance_uuid,
 			 vclock, prev_vclock);
 
+	/* Use the preallocated file if there's one. */
+	char spare[PATH_MAX];
+	size_t spare_size = dir->spare_size;
+	if (spare_size > 0) {
+		strlcpy(spare, xdir_spare_filename(dir), sizeof(spare));
+		dir->spare_size = 0;
+	}
 	const char *filename = xdir_format_filename(dir, signature, NONE);
-	if (xlog_create(xlog, filename, dir->open_wflags, &meta,
-			&dir->opts) != 0)
+	if (xlog_create_from_spare(xlog, filename, dir->open_wflags, &meta,
+				   &dir->opts, spare_size > 0 ? spare : NULL,
+				   spare_size) != 0)
 		return -1;
 
 	/* Rename xlog file */
@@ -1031,6 +1081,53 @@ xdir_create_xlog(struct xdir *dir, struct xlog *xlog,
 	return 0;
 }
 
+const char *
+xdir_spare_filename(struct xdir *dir)
+{
+	return tt_snprintf(PATH_MAX, "%s/spare%s%s", dir->dirname,
+			   dir->filename_ext, inprogress_suffix);
+}
+
+int
+xdir_prepare_spare(const char *path, size_t size)
+{
+	int fd = open(path, O_RDWR | O_CREAT | O_TRUNC, 0644);
+	if (fd < 0)
+		return -1;
+	int rc = 0;
+#ifdef HAVE_FALLOCATE
+	/*
+	 * Keep the file size zero so that the file looks
+	 * exactly like a new one when it's opened as an xlog.
+	 */
+	rc = fallocate(fd, FALLOC_FL_KEEP_SIZE, 0, size);
+#else
+	(void)size;
+	errno = EOPNOTSUPP;
+	rc = -1;
+#endif /* HAVE_FALLOCATE */
+	if (rc == 0)
+		rc = fdatasync(fd);
+	int save_errno = errno;
+	close(fd);
+	if (rc != 0) {
+		unlink(path);
+		errno = save_errno;
+	}
+	return rc;
+}
+
+void
+xdir_drop_spare(struct xdir *dir)
+{
+	if (dir->spare_size == 0)
+		return;
+	dir->spare_size = 0;
+	const char *filename = xdir_spare_filename(dir);
+	int rc = unlink(filename);
+	xdir_say_gc(rc, errno, filename);
+}
+
 ssize_t
 xlog_fallocate(struct xlog *log, size_t len)
 {
@@ -1138,8 +1235,13 @@ xlog_tx_write_zstd(struct xlog *log)
 
 	uint32_t crc32c = 0;
 	struct iovec *iov;
-	/* 3 is compression level. */
-	ZSTD_compressBegin(log->zctx, 3);
+	if (log->opts.zcdict != NULL) {
+		/* Compression level is stored in the dictionary. */
+		ZSTD_compressBegin_usingCDict(log->zctx, log->opts.zcdict);
+	} else {
+		/* 3 is compression level. */
+		ZSTD_compressBegin(log->zctx, 3);
+	}
 	size_t offset = XLOG_FIXHEADER_SIZE;
 	for (iov = log->obuf.iov; iov->iov_len; ++iov) {
 		/* Estimate max output buffer size. */
@@ -1446,7 +1548,7 @@ xlog_sync(struct xlog *l)
 			return -1;
 		}
 		eio_fsync(fd, 0, sync_cb, (void *) (intptr_t) fd);
-	} else if (fsync(l->fd) < 0) {
+	} else if (fio_fsync(l->fd) < 0) {
 		say_syserror("%s: fsync failed", l->filename);
 		return -1;
 	}
@@ -1525,6 +1627,34 @@ xlog_atfork(struct xlog *xlog)
 /* {{{ struct xlog_cursor */
 
 #define XLOG_READ_AHEAD		(1 << 14)
+/*
+ * The kernel is asked to read this much of the file in advance
+ * of the cursor, so that disk reads overlap with decoding and
+ * applying of the rows which are already read.
+ */
+#define XLOG_PREFETCH_SIZE	(8 << 20)
+
+/**
+ * Ask the kernel to read the next part of the file in background
+ * once the cursor has consumed a half of the prefetched range.
+ */
+static inline void
+xlog_cursor_prefetch(struct xlog_cursor *cursor)
+{
+#ifdef HAVE_POSIX_FADVISE
+	if (cursor->prefetch_offset - cursor->read_offset >=
+	    XLOG_PREFETCH_SIZE / 2)
+		return;
+	off_t from = MAX(cursor->prefetch_offset, cursor->read_offset);
+	off_t to = cursor->read_offset + XLOG_PREFETCH_SIZE;
+	/* It's only a hint, so the result doesn't matter. */
+	(void)posix_fadvise(cursor->fd, from, to - from,
+			    POSIX_FADV_WILLNEED);
+	cursor->prefetch_offset = to;
+#else
+	(void)cursor;
+#endif /* HAVE_POSIX_FADVISE */
+}
 
 /**
  * Ensure that at least count bytes are in read buffer
@@ -1569,6 +1699,7 @@ xlog_cursor_ensure(struct xlog_cursor *cursor, size_t count)
 	assert((size_t)readen <= to_load);
 	ibuf_alloc(&cursor->rbuf, readen);
 	cursor->read_offset += readen;
+	xlog_cursor_prefetch(cursor);
 	return ibuf_used(&cursor->rbuf) >= count ? 0: 1;
 }
 
@@ -1693,7 +1824,8 @@ xlog_fixheader_decode(struct xlog_fixheader *fixheader,
 
 int
 xlog_tx_decode(const char *data, const char *data_end,
-	       char *rows, char *rows_end, ZSTD_DStream *zdctx)
+	       char *rows, char *rows_end, ZSTD_DStream *zdctx,
+	       const ZSTD_DDict *zddict)
 {
 	/* Decode fixheader */
 	struct xlog_fixheader fixheader;
@@ -1733,6 +1865,8 @@ xlog_tx_decode(const char *data, const char *data_end,
 	/* Decompress zstd rows */
 	assert(fixheader.magic == zrow_marker);
 	ZSTD_initDStream(zdctx);
+	if (zddict != NULL)
+		ZSTD_DCtx_refDDict(zdctx, zddict);
 	int rc = xlog_cursor_decompress(&rows, rows_end, &data, data_end,
 					zdctx);
 	if (rc < 0) {
@@ -1982,6 +2116,10 @@ xlog_cursor_openfd(struct xlog_cursor *i, int fd, const char *name)
 	i->fd = fd;
 	ibuf_create(&i->rbuf, &cord()->slabc,
 		    XLOG_TX_AUTOCOMMIT_THRESHOLD << 1);
+#ifdef HAVE_POSIX_FADVISE
+	/* Xlogs are read sequentially, let the kernel read ahead more. */
+	(void)posix_fadvise(fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+#endif /* HAVE_POSIX_FADVISE */
 
 	ssize_t rc;
 	/*
@@ -82,6 +82,12 @@ struct xlog_opts {
 	 * to be read frequently, e.g. L1 run files in Vinyl.
 	 */
 	bool no_compression;
+	/**
+	 * Dictionary used for zstd compression, NULL if none.
+	 * Data compressed with a dictionary can only be decoded
+	 * with the same dictionary, see xlog_tx_decode().
+	 */
+	const ZSTD_CDict *zcdict;
 };
 
 extern const struct xlog_opts xlog_opts_default;
@@ -165,6 +171,12 @@ struct xdir {
 	char dirname[PATH_MAX];
 	/** Snapshots or xlogs */
 	enum xdir_type type;
+	/**
+	 * Size of the file preallocated for the next log file
+	 * with xdir_prepare_spare() or 0 if there is no such
+	 * file.
+	 */
+	size_t spare_size;
 };
 
 /**
@@ -224,7 +236,8 @@ xdir_has_garbage(struct xdir *dir, int64_t signature)
 enum {
 	/**
 	 * Delete files in coio threads so as not to block
-	 * the caller thread.
+	 * the caller thread. Large files are freed gradually,
+	 * see file_reclaim_unlink().
 	 */
 	XDIR_GC_ASYNC = 1 << 0,
 	/**
@@ -233,6 +246,33 @@ enum {
 	XDIR_GC_REMOVE_ONE = 1 << 1,
 };
 
+/**
+ * Return the path of the file preallocated for the next log
+ * file of the directory. The result is stored in a static
+ * buffer.
+ */
+const char *
+xdir_spare_filename(struct xdir *dir);
+
+/**
+ * Create a file of @a size bytes of preallocated disk space
+ * at @a path, which should be xdir_spare_filename(). The file
+ * size stays 0. Blocks, so it's supposed to be called from a
+ * coio thread. On success the caller should assign @a size to
+ * xdir::spare_size so that the next xdir_create_xlog() reuses
+ * the file. Follows the errno conventions of system calls and
+ * doesn't set diag.
+ */
+int
+xdir_prepare_spare(const char *path, size_t size);
+
+/**
+ * Remove the file preallocated with xdir_prepare_spare(), if
+ * any, to free disk space.
+ */
+void
+xdir_drop_spare(struct xdir *dir);
+
 /**
  * Remove files whose signature is less than specified.
  * For possible values of @flags see XDIR_GC_*.
@@ -627,13 +667,16 @@ xlog_tx_cursor_pos(struct xlog_tx_cursor *tx_cursor)
  * @param data_end the end of @a data buffer
  * @param[out] rows a buffer to store decoded rows
  * @param[out] rows_end the end of @a rows buffer
+ * @param zdctx zstd decompression context
+ * @param zddict dictionary the data was compressed with,
+ *        NULL if none
  * @retval  0 success
  * @retval -1 error, check diag
  */
 int
 xlog_tx_decode(const char *data, const char *data_end,
 	       char *rows, char *rows_end,
-	       ZSTD_DStream *zdctx);
+	       ZSTD_DStream *zdctx, const ZSTD_DDict *zddict);
 
 /* }}} */
 
@@ -670,6 +713,8 @@ struct xlog_cursor {
 	struct ibuf rbuf;
 	/** file read position */
 	off_t read_offset;
+	/** end of the file range requested to be read in advance */
+	off_t prefetch_offset;
 	/** cursor for current tx */
 	struct xlog_tx_cursor tx_cursor;
 	/** ZSTD context for decompression */
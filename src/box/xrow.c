@@ -411,6 +411,23 @@ static const struct iproto_body_bin iproto_body_bin = {
 	0x81, IPROTO_DATA, 0xdd, 0
 };
 
+struct PACKED iproto_cursor_body_bin {
+	uint8_t m_body;                    /* MP_MAP */
+	uint8_t k_cursor_id;               /* IPROTO_CURSOR_ID */
+	uint8_t m_cursor_id;               /* MP_UINT64 */
+	uint64_t v_cursor_id;              /* cursor id */
+	uint8_t k_data;                    /* IPROTO_DATA */
+	uint8_t m_data;                    /* MP_ARRAY */
+	uint32_t v_data_len;               /* array size */
+};
+
+static_assert(sizeof(struct iproto_cursor_body_bin) + IPROTO_HEADER_LEN ==
+	      IPROTO_CURSOR_HEADER_LEN, "size of the prepared cursor reply");
+
+static const struct iproto_cursor_body_bin iproto_cursor_body_bin = {
+	0x82, IPROTO_CURSOR_ID, 0xcf, 0, IPROTO_DATA, 0xdd, 0
+};
+
 /** Return a 4-byte numeric error code, with status flags. */
 static inline uint32_t
 iproto_encode_error(uint32_t error)
@@ -679,6 +696,22 @@ iproto_reply_select(struct obuf *buf, struct obuf_svp *svp, uint64_t sync,
 	memcpy(pos + IPROTO_HEADER_LEN, &body, sizeof(body));
 }
 
+void
+iproto_reply_cursor(struct obuf *buf, struct obuf_svp *svp, uint64_t sync,
+		    uint32_t schema_version, uint64_t cursor_id,
+		    uint32_t count)
+{
+	char *pos = (char *)obuf_svp_to_ptr(buf, svp);
+	iproto_header_encode(pos, IPROTO_OK, sync, schema_version,
+			     obuf_size(buf) - svp->used - IPROTO_HEADER_LEN);
+
+	struct iproto_cursor_body_bin body = iproto_cursor_body_bin;
+	body.v_cursor_id = mp_bswap_u64(cursor_id);
+	body.v_data_len = mp_bswap_u32(count);
+
+	memcpy(pos + IPROTO_HEADER_LEN, &body, sizeof(body));
+}
+
 int
 xrow_decode_sql(const struct xrow_header *row, struct sql_request *request)
 {
@@ -741,13 +774,13 @@ iproto_reply_sql(struct obuf *buf, struct obuf_svp *svp, uint64_t sync,
 
 void
 iproto_reply_chunk(struct obuf *buf, struct obuf_svp *svp, uint64_t sync,
-		   uint32_t schema_version)
+		   uint32_t schema_version, uint32_t count)
 {
 	char *pos = (char *) obuf_svp_to_ptr(buf, svp);
 	iproto_header_encode(pos, IPROTO_CHUNK, sync, schema_version,
 			     obuf_size(buf) - svp->used - IPROTO_HEADER_LEN);
 	struct iproto_body_bin body = iproto_body_bin;
-	body.v_data_len = mp_bswap_u32(1);
+	body.v_data_len = mp_bswap_u32(count);
 	memcpy(pos + IPROTO_HEADER_LEN, &body, sizeof(body));
 }
 
@@ -798,6 +831,37 @@ iproto_send_event(struct obuf *out, const char *key, size_t key_len,
 	return 0;
 }
 
+/**
+ * Decode a DML request body of the shape {SPACE_ID: uint, TUPLE:
+ * array} with the keys in this order. It is how net.box,
+ * connectors and xrow_encode_dml() encode INSERT and REPLACE, so
+ * most of the requests coming from clients and replicas are
+ * decoded without the generic key-by-key loop.
+ *
+ * The body must be valid MessagePack. Returns false and doesn't
+ * touch @a request if the body has a different shape.
+ */
+static inline bool
+xrow_decode_dml_fast(const char *data, struct request *request)
+{
+	static_assert(IPROTO_SPACE_ID < 0x80 && IPROTO_TUPLE < 0x80,
+		      "the keys must be encoded as positive fixints");
+	/* A fixmap with 2 entries. */
+	if ((uint8_t)data[0] != 0x82 || data[1] != IPROTO_SPACE_ID)
+		return false;
+	const char *pos = data + 2;
+	if (mp_typeof(*pos) != MP_UINT)
+		return false;
+	uint64_t space_id = mp_decode_uint(&pos);
+	if (*pos != IPROTO_TUPLE || mp_typeof(pos[1]) != MP_ARRAY)
+		return false;
+	request->space_id = space_id;
+	request->tuple = ++pos;
+	mp_next(&pos);
+	request->tuple_end = pos;
+	return true;
+}
+
 int
 xrow_decode_dml(struct xrow_header *row, struct request *request,
 		uint64_t key_map)
@@ -811,6 +875,11 @@ xrow_decode_dml(struct xrow_header *row, struct request *request,
 
 	assert(row->bodycnt == 1);
 	const char *data = (const char *) row->body[0].iov_base;
+	if (xrow_decode_dml_fast(data, request)) {
+		key_map &= ~(iproto_key_bit(IPROTO_SPACE_ID) |
+			     iproto_key_bit(IPROTO_TUPLE));
+		goto done;
+	}
 	if (mp_typeof(*data) != MP_MAP) {
 error:
 		xrow_on_decode_err(row, ER_INVALID_MSGPACK, "packet body");
@@ -822,6 +891,7 @@ error:
 		if (mp_typeof(*data) != MP_UINT) {
 			mp_next(&data);
 			mp_next(&data);
+			request->has_extra_keys = true;
 			continue;
 		}
 		uint64_t key = mp_decode_uint(&data);
@@ -840,15 +910,18 @@ error:
 			break;
 		case IPROTO_OFFSET:
 			request->offset = mp_decode_uint(&value);
+			request->has_extra_keys = true;
 			break;
 		case IPROTO_INDEX_BASE:
 			request->index_base = mp_decode_uint(&value);
 			break;
 		case IPROTO_LIMIT:
 			request->limit = mp_decode_uint(&value);
+			request->has_extra_keys = true;
 			break;
 		case IPROTO_ITERATOR:
 			request->iterator = mp_decode_uint(&value);
+			request->has_extra_keys = true;
 			break;
 		case IPROTO_TUPLE:
 			request->tuple = value;
@@ -867,6 +940,7 @@ error:
 			request->tuple_meta_end = data;
 			break;
 		default:
+			request->has_extra_keys = true;
 			break;
 		}
 	}
@@ -1140,6 +1214,11 @@ xrow_encode_raft(struct xrow_header *row, struct region *region,
 		size += mp_sizeof_uint(IPROTO_RAFT_VCLOCK) +
 			mp_sizeof_vclock_ignore0(r->vclock);
 	}
+	if (r->is_leader_seen) {
+		++map_size;
+		size += mp_sizeof_uint(IPROTO_RAFT_IS_LEADER_SEEN) +
+			mp_sizeof_bool(true);
+	}
 	size += mp_sizeof_map(map_size);
 
 	char *buf = region_alloc(region, size);
@@ -1169,6 +1248,10 @@ xrow_encode_raft(struct xrow_header *row, struct region *region,
 		buf = mp_encode_uint(buf, IPROTO_RAFT_VCLOCK);
 		buf = mp_encode_vclock_ignore0(buf, r->vclock);
 	}
+	if (r->is_leader_seen) {
+		buf = mp_encode_uint(buf, IPROTO_RAFT_IS_LEADER_SEEN);
+		buf = mp_encode_bool(buf, true);
+	}
 	row->body[0].iov_len = buf - begin;
 	return 0;
 }
@@ -1215,6 +1298,11 @@ xrow_decode_raft(const struct xrow_header *row, struct raft_request *r,
 			else if (mp_decode_vclock_ignore0(&pos, vclock) != 0)
 				goto bad_msgpack;
 			break;
+		case IPROTO_RAFT_IS_LEADER_SEEN:
+			if (mp_typeof(*pos) != MP_BOOL)
+				goto bad_msgpack;
+			r->is_leader_seen = mp_decode_bool(&pos);
+			break;
 		default:
 			mp_next(&pos);
 			break;
@@ -1364,6 +1452,167 @@ error:
 	return 0;
 }
 
+/**
+ * Get the type of a BATCH sub-request. Only DML and SELECT
+ * requests are allowed in a batch.
+ */
+static int
+xrow_batch_item_type(const char *data, uint16_t *type)
+{
+	if (mp_typeof(*data) != MP_MAP) {
+		diag_set(ClientError, ER_INVALID_MSGPACK, "batch request");
+		return -1;
+	}
+	uint32_t map_size = mp_decode_map(&data);
+	for (uint32_t i = 0; i < map_size; i++) {
+		if (mp_typeof(*data) != MP_UINT) {
+			mp_next(&data);
+			mp_next(&data);
+			continue;
+		}
+		uint64_t key = mp_decode_uint(&data);
+		if (key != IPROTO_REQUEST_TYPE) {
+			mp_next(&data);
+			continue;
+		}
+		if (mp_typeof(*data) != MP_UINT) {
+			diag_set(ClientError, ER_INVALID_MSGPACK,
+				 "batch request");
+			return -1;
+		}
+		uint64_t value = mp_decode_uint(&data);
+		if (!iproto_type_is_dml(value) || value == IPROTO_NOP) {
+			diag_set(ClientError, ER_ILLEGAL_PARAMS, "BATCH may "
+				 "only contain SELECT and DML requests");
+			return -1;
+		}
+		*type = value;
+		return 0;
+	}
+	diag_set(ClientError, ER_MISSING_REQUEST_FIELD,
+		 iproto_key_name(IPROTO_REQUEST_TYPE));
+	return -1;
+}
+
+int
+xrow_decode_batch(const struct xrow_header *row, struct batch_request *request)
+{
+	if (row->bodycnt == 0) {
+		diag_set(ClientError, ER_INVALID_MSGPACK,
+			 "missing request body");
+		return -1;
+	}
+	assert(row->bodycnt == 1);
+	const char *data = (const char *)row->body[0].iov_base;
+	if (mp_typeof(*data) != MP_MAP) {
+error:
+		xrow_on_decode_err(row, ER_INVALID_MSGPACK, "packet body");
+		return -1;
+	}
+	memset(request, 0, sizeof(*request));
+	uint32_t map_size = mp_decode_map(&data);
+	for (uint32_t i = 0; i < map_size; i++) {
+		if (mp_typeof(*data) != MP_UINT)
+			goto error;
+		uint64_t key = mp_decode_uint(&data);
+		if (key < IPROTO_KEY_MAX &&
+		    iproto_key_type[key] != MP_NIL &&
+		    iproto_key_type[key] != mp_typeof(*data))
+			goto error;
+		if (key != IPROTO_REQUESTS) {
+			mp_next(&data);
+			continue;
+		}
+		request->count = mp_decode_array(&data);
+		request->requests = data;
+		for (uint32_t j = 0; j < request->count; j++) {
+			uint16_t type;
+			if (xrow_batch_item_type(data, &type) != 0)
+				return -1;
+			mp_next(&data);
+		}
+		request->requests_end = data;
+	}
+	if (request->requests == NULL) {
+		xrow_on_decode_err(row, ER_MISSING_REQUEST_FIELD,
+				   iproto_key_name(IPROTO_REQUESTS));
+		return -1;
+	}
+	return 0;
+}
+
+int
+xrow_decode_batch_item(const char **data, struct request *request)
+{
+	uint16_t type;
+	if (xrow_batch_item_type(*data, &type) != 0)
+		return -1;
+	struct xrow_header row;
+	memset(&row, 0, sizeof(row));
+	row.type = type;
+	row.bodycnt = 1;
+	row.body[0].iov_base = (void *)*data;
+	mp_next(data);
+	row.body[0].iov_len = *data - (const char *)row.body[0].iov_base;
+	if (xrow_decode_dml(&row, request, dml_request_key_map(type)) != 0)
+		return -1;
+	/*
+	 * Like for any other client request, the header is set
+	 * by WAL. The one constructed above is gone on return.
+	 */
+	request->header = NULL;
+	return 0;
+}
+
+int
+xrow_decode_cursor(const struct xrow_header *row,
+		   struct cursor_request *request)
+{
+	if (row->bodycnt == 0) {
+		diag_set(ClientError, ER_INVALID_MSGPACK,
+			 "missing request body");
+		return -1;
+	}
+	assert(row->bodycnt == 1);
+	const char *data = (const char *)row->body[0].iov_base;
+	if (mp_typeof(*data) != MP_MAP) {
+error:
+		xrow_on_decode_err(row, ER_INVALID_MSGPACK, "packet body");
+		return -1;
+	}
+	memset(request, 0, sizeof(*request));
+	request->limit = UINT32_MAX;
+	bool has_cursor_id = false;
+	uint32_t map_size = mp_decode_map(&data);
+	for (uint32_t i = 0; i < map_size; i++) {
+		if (mp_typeof(*data) != MP_UINT)
+			goto error;
+		uint64_t key = mp_decode_uint(&data);
+		if (key < IPROTO_KEY_MAX &&
+		    iproto_key_type[key] != MP_NIL &&
+		    iproto_key_type[key] != mp_typeof(*data))
+			goto error;
+		switch (key) {
+		case IPROTO_CURSOR_ID:
+			request->cursor_id = mp_decode_uint(&data);
+			has_cursor_id = true;
+			break;
+		case IPROTO_LIMIT:
+			request->limit = mp_decode_uint(&data);
+			break;
+		default:
+			mp_next(&data);
+			break;
+		}
+	}
+	if (!has_cursor_id) {
+		xrow_on_decode_err(row, ER_MISSING_REQUEST_FIELD,
+				   iproto_key_name(IPROTO_CURSOR_ID));
+		return -1;
+	}
+	return 0;
+}
+
 int
 xrow_decode_auth(const struct xrow_header *row, struct auth_request *request)
 {
@@ -1537,6 +1786,9 @@ xrow_decode_begin(const struct xrow_header *row, struct begin_request *request)
 		case IPROTO_TIMEOUT:
 			request->timeout = mp_decode_double(&d);
 			break;
+		case IPROTO_TXN_ISOLATION:
+			request->isolation = mp_decode_uint(&d);
+			break;
 		default:
 			mp_next(&d);
 			break;
@@ -1644,28 +1896,56 @@ err:
 	return -1;
 }
 
+/** Size of IPROTO_SPACE_FILTER key and value. */
+static size_t
+mp_sizeof_space_filter(uint32_t space_filter_size)
+{
+	return mp_sizeof_uint(IPROTO_SPACE_FILTER) +
+	       mp_sizeof_array(space_filter_size) +
+	       space_filter_size * mp_sizeof_uint(UINT32_MAX);
+}
+
+/** Encode IPROTO_SPACE_FILTER key and value. */
+static char *
+mp_encode_space_filter(char *data, const uint32_t *space_filter,
+		       uint32_t space_filter_size)
+{
+	data = mp_encode_uint(data, IPROTO_SPACE_FILTER);
+	data = mp_encode_array(data, space_filter_size);
+	for (uint32_t i = 0; i < space_filter_size; i++)
+		data = mp_encode_uint(data, space_filter[i]);
+	return data;
+}
+
 int
 xrow_encode_register(struct xrow_header *row,
 		     const struct tt_uuid *instance_uuid,
-		     const struct vclock *vclock)
+		     const struct vclock *vclock,
+		     const uint32_t *space_filter,
+		     uint32_t space_filter_size)
 {
 	memset(row, 0, sizeof(*row));
-	size_t size = mp_sizeof_map(2) +
+	size_t size = mp_sizeof_map(3) +
 		      mp_sizeof_uint(IPROTO_INSTANCE_UUID) +
 		      mp_sizeof_str(UUID_STR_LEN) +
 		      mp_sizeof_uint(IPROTO_VCLOCK) +
-		      mp_sizeof_vclock_ignore0(vclock);
+		      mp_sizeof_vclock_ignore0(vclock) +
+		      mp_sizeof_space_filter(space_filter_size);
 	char *buf = (char *) region_alloc(&fiber()->gc, size);
 	if (buf == NULL) {
 		diag_set(OutOfMemory, size, "region_alloc", "buf");
 		return -1;
 	}
 	char *data = buf;
-	data = mp_encode_map(data, 2);
+	data = mp_encode_map(data, 2 + (space_filter != NULL));
 	data = mp_encode_uint(data, IPROTO_INSTANCE_UUID);
 	data = xrow_encode_uuid(data, instance_uuid);
 	data = mp_encode_uint(data, IPROTO_VCLOCK);
 	data = mp_encode_vclock_ignore0(data, vclock);
+	if (space_filter != NULL) {
+		data = mp_encode_space_filter(data, space_filter,
+					      space_filter_size);
+	}
 	assert(data <= buf + size);
 	row->body[0].iov_base = buf;
 	row->body[0].iov_len = (data - buf);
@@ -1679,11 +1959,14 @@ xrow_encode_subscribe(struct xrow_header *row,
 		      const struct tt_uuid *replicaset_uuid,
 		      const struct tt_uuid *instance_uuid,
 		      const struct vclock *vclock, bool anon,
-		      uint32_t id_filter)
+		      uint32_t id_filter, bool compression,
+		      const uint32_t *space_filter,
+		      uint32_t space_filter_size)
 {
 	memset(row, 0, sizeof(*row));
 	size_t size = XROW_BODY_LEN_MAX +
-		      mp_sizeof_vclock_ignore0(vclock);
+		      mp_sizeof_vclock_ignore0(vclock) +
+		      mp_sizeof_space_filter(space_filter_size);
 	char *buf = (char *) region_alloc(&fiber()->gc, size);
 	if (buf == NULL) {
 		diag_set(OutOfMemory, size, "region_alloc", "buf");
@@ -1691,7 +1974,8 @@ xrow_encode_subscribe(struct xrow_header *row,
 	}
 	char *data = buf;
 	int filter_size = bit_count_u32(id_filter);
-	data = mp_encode_map(data, filter_size != 0 ? 6 : 5);
+	data = mp_encode_map(data, 5 + (filter_size != 0) + compression +
+				   (space_filter != NULL));
 	data = mp_encode_uint(data, IPROTO_CLUSTER_UUID);
 	data = xrow_encode_uuid(data, replicaset_uuid);
 	data = mp_encode_uint(data, IPROTO_INSTANCE_UUID);
@@ -1713,6 +1997,14 @@ xrow_encode_subscribe(struct xrow_header *row,
 			data = mp_encode_uint(data, id);
 		}
 	}
+	if (compression) {
+		data = mp_encode_uint(data, IPROTO_COMPRESSION);
+		data = mp_encode_bool(data, true);
+	}
+	if (space_filter != NULL) {
+		data = mp_encode_space_filter(data, space_filter,
+					      space_filter_size);
+	}
 	assert(data <= buf + size);
 	row->body[0].iov_base = buf;
 	row->body[0].iov_len = (data - buf);
@@ -1725,7 +2017,8 @@ int
 xrow_decode_subscribe(const struct xrow_header *row,
 		      struct tt_uuid *replicaset_uuid,
 		      struct tt_uuid *instance_uuid, struct vclock *vclock,
-		      uint32_t *version_id, bool *anon, uint32_t *id_filter)
+		      uint32_t *version_id, bool *anon, uint32_t *id_filter,
+		      bool *compression)
 {
 	if (row->bodycnt == 0) {
 		diag_set(ClientError, ER_INVALID_MSGPACK, "request body");
@@ -1750,6 +2043,8 @@ xrow_decode_subscribe(const struct xrow_header *row,
 		*anon = false;
 	if (id_filter != NULL)
 		*id_filter = 0;
+	if (compression != NULL)
+		*compression = false;
 
 	uint32_t map_size = mp_decode_map(&d);
 	for (uint32_t i = 0; i < map_size; i++) {
@@ -1825,6 +2120,16 @@ id_filter_decode_err:		xrow_on_decode_err(row, ER_INVALID_MSGPACK,
 				*id_filter |= 1 << val;
 			}
 			break;
+		case IPROTO_COMPRESSION:
+			if (compression == NULL)
+				goto skip;
+			if (mp_typeof(*d) != MP_BOOL) {
+				xrow_on_decode_err(row, ER_INVALID_MSGPACK,
+						   "invalid COMPRESSION flag");
+				return -1;
+			}
+			*compression = mp_decode_bool(&d);
+			break;
 		default: skip:
 			mp_next(&d); /* value */
 		}
@@ -1833,23 +2138,28 @@ id_filter_decode_err:		xrow_on_decode_err(row, ER_INVALID_MSGPACK,
 }
 
 int
-xrow_encode_join(struct xrow_header *row, const struct tt_uuid *instance_uuid)
+xrow_encode_join(struct xrow_header *row, const struct tt_uuid *instance_uuid,
+		 const uint32_t *space_filter, uint32_t space_filter_size)
 {
 	memset(row, 0, sizeof(*row));
 
-	size_t size = 64;
+	size_t size = 64 + mp_sizeof_space_filter(space_filter_size);
 	char *buf = (char *) region_alloc(&fiber()->gc, size);
 	if (buf == NULL) {
 		diag_set(OutOfMemory, size, "region_alloc", "buf");
 		return -1;
 	}
 	char *data = buf;
-	data = mp_encode_map(data, 2);
+	data = mp_encode_map(data, 2 + (space_filter != NULL));
 	data = mp_encode_uint(data, IPROTO_INSTANCE_UUID);
 	/* Greet the remote replica with our replica UUID */
 	data = xrow_encode_uuid(data, instance_uuid);
 	data = mp_encode_uint(data, IPROTO_SERVER_VERSION);
 	data = mp_encode_uint(data, tarantool_version_id());
+	if (space_filter != NULL) {
+		data = mp_encode_space_filter(data, space_filter,
+					      space_filter_size);
+	}
 	assert(data <= buf + size);
 
 	row->body[0].iov_base = buf;
@@ -1859,6 +2169,86 @@ xrow_encode_join(struct xrow_header *row, const struct tt_uuid *instance_uuid)
 	return 0;
 }
 
+int
+xrow_encode_fetch_snapshot(struct xrow_header *row,
+			   const uint32_t *space_filter,
+			   uint32_t space_filter_size)
+{
+	memset(row, 0, sizeof(*row));
+	row->type = IPROTO_FETCH_SNAPSHOT;
+	if (space_filter == NULL)
+		return 0;
+	size_t size = mp_sizeof_map(1) +
+		      mp_sizeof_space_filter(space_filter_size);
+	char *buf = (char *)region_alloc(&fiber()->gc, size);
+	if (buf == NULL) {
+		diag_set(OutOfMemory, size, "region_alloc", "buf");
+		return -1;
+	}
+	char *data = buf;
+	data = mp_encode_map(data, 1);
+	data = mp_encode_space_filter(data, space_filter, space_filter_size);
+	assert(data <= buf + size);
+	row->body[0].iov_base = buf;
+	row->body[0].iov_len = (data - buf);
+	row->bodycnt = 1;
+	return 0;
+}
+
+int
+xrow_decode_space_filter(const struct xrow_header *row,
+			 uint32_t **space_filter, uint32_t *space_filter_size)
+{
+	*space_filter = NULL;
+	*space_filter_size = 0;
+	if (row->bodycnt == 0)
+		return 0;
+	assert(row->bodycnt == 1);
+	const char *d = (const char *)row->body[0].iov_base;
+	if (mp_typeof(*d) != MP_MAP) {
+		xrow_on_decode_err(row, ER_INVALID_MSGPACK, "request body");
+		return -1;
+	}
+	uint32_t map_size = mp_decode_map(&d);
+	for (uint32_t i = 0; i < map_size; i++) {
+		if (mp_typeof(*d) != MP_UINT) {
+			mp_next(&d); /* key */
+			mp_next(&d); /* value */
+			continue;
+		}
+		if (mp_decode_uint(&d) != IPROTO_SPACE_FILTER) {
+			mp_next(&d); /* value */
+			continue;
+		}
+		if (mp_typeof(*d) != MP_ARRAY)
+			goto error;
+		uint32_t size = mp_decode_array(&d);
+		size_t bsize;
+		/* Allocate at least one id so that an empty filter is set. */
+		uint32_t *ids = region_alloc_array(&fiber()->gc, typeof(*ids),
+						   size > 0 ? size : 1, &bsize);
+		if (ids == NULL) {
+			diag_set(OutOfMemory, bsize, "region_alloc_array",
+				 "ids");
+			return -1;
+		}
+		for (uint32_t j = 0; j < size; j++) {
+			if (mp_typeof(*d) != MP_UINT)
+				goto error;
+			uint64_t id = mp_decode_uint(&d);
+			if (id > UINT32_MAX)
+				goto error;
+			ids[j] = id;
+		}
+		*space_filter = ids;
+		*space_filter_size = size;
+	}
+	return 0;
+error:
+	xrow_on_decode_err(row, ER_INVALID_MSGPACK, "invalid SPACE_FILTER");
+	return -1;
+}
+
 int
 xrow_encode_vclock(struct xrow_header *row, const struct vclock *vclock)
 {
@@ -1886,25 +2276,31 @@ xrow_encode_vclock(struct xrow_header *row, const struct vclock *vclock)
 int
 xrow_encode_subscribe_response(struct xrow_header *row,
 			       const struct tt_uuid *replicaset_uuid,
-			       const struct vclock *vclock)
+			       const struct vclock *vclock, bool compression)
 {
 	memset(row, 0, sizeof(*row));
-	size_t size = mp_sizeof_map(2) +
+	size_t size = mp_sizeof_map(3) +
 		      mp_sizeof_uint(IPROTO_VCLOCK) +
 		      mp_sizeof_vclock_ignore0(vclock) +
 		      mp_sizeof_uint(IPROTO_CLUSTER_UUID) +
-		      mp_sizeof_str(UUID_STR_LEN);
+		      mp_sizeof_str(UUID_STR_LEN) +
+		      mp_sizeof_uint(IPROTO_COMPRESSION) +
+		      mp_sizeof_bool(compression);
 	char *buf = (char *) region_alloc(&fiber()->gc, size);
 	if (buf == NULL) {
 		diag_set(OutOfMemory, size, "region_alloc", "buf");
 		return -1;
 	}
 	char *data = buf;
-	data = mp_encode_map(data, 2);
+	data = mp_encode_map(data, compression ? 3 : 2);
 	data = mp_encode_uint(data, IPROTO_VCLOCK);
 	data = mp_encode_vclock_ignore0(data, vclock);
 	data = mp_encode_uint(data, IPROTO_CLUSTER_UUID);
 	data = xrow_encode_uuid(data, replicaset_uuid);
+	if (compression) {
+		data = mp_encode_uint(data, IPROTO_COMPRESSION);
+		data = mp_encode_bool(data, true);
+	}
 	assert(data <= buf + size);
 	row->body[0].iov_base = buf;
 	row->body[0].iov_len = (data - buf);
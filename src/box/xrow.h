@@ -54,6 +54,8 @@ enum {
 	IPROTO_HEADER_LEN = 28,
 	/** 7 = sizeof(iproto_body_bin). */
 	IPROTO_SELECT_HEADER_LEN = IPROTO_HEADER_LEN + 7,
+	/** 17 = sizeof(iproto_cursor_body_bin). */
+	IPROTO_CURSOR_HEADER_LEN = IPROTO_HEADER_LEN + 17,
 };
 
 struct iostream;
@@ -196,6 +198,12 @@ struct request {
 	const char *tuple_meta_end;
 	/** Base field offset for UPDATE/UPSERT, e.g. 0 for C and 1 for Lua. */
 	int index_base;
+	/**
+	 * The decoded body has keys xrow_encode_dml() doesn't
+	 * encode, e.g. ones unknown to this version. Such a body
+	 * is encoded again rather than written to WAL as is.
+	 */
+	bool has_extra_keys;
 };
 
 /**
@@ -317,6 +325,7 @@ struct raft_request {
 	uint32_t vote;
 	uint64_t state;
 	const struct vclock *vclock;
+	bool is_leader_seen;
 };
 
 int
@@ -375,6 +384,62 @@ struct watch_request {
 int
 xrow_decode_watch(const struct xrow_header *row, struct watch_request *request);
 
+/**
+ * BATCH request.
+ */
+struct batch_request {
+	/** Number of sub-requests. */
+	uint32_t count;
+	/** Sub-requests, MessagePack maps following one another. */
+	const char *requests;
+	/** End of the sub-requests. */
+	const char *requests_end;
+};
+
+/**
+ * Decode BATCH request from MessagePack. Only checks that all
+ * sub-requests have a known type. Each sub-request should then
+ * be decoded with xrow_decode_batch_item().
+ * @param row Request header.
+ * @param[out] request Request to decode to.
+ * @retval  0 on success
+ * @retval -1 on error
+ */
+int
+xrow_decode_batch(const struct xrow_header *row, struct batch_request *request);
+
+/**
+ * Decode a sub-request of a BATCH request.
+ * @param[in, out] data Sub-request to decode. Set to the next
+ *                 sub-request on success.
+ * @param[out] request Request to decode to.
+ * @retval  0 on success
+ * @retval -1 on error
+ */
+int
+xrow_decode_batch_item(const char **data, struct request *request);
+
+/**
+ * CURSOR_FETCH/CURSOR_CLOSE request.
+ */
+struct cursor_request {
+	/** Cursor id. */
+	uint64_t cursor_id;
+	/** Max number of tuples to fetch. */
+	uint32_t limit;
+};
+
+/**
+ * Decode CURSOR_FETCH/CURSOR_CLOSE request from MessagePack.
+ * @param row Request header.
+ * @param[out] request Request to decode to.
+ * @retval  0 on success
+ * @retval -1 on error
+ */
+int
+xrow_decode_cursor(const struct xrow_header *row,
+		   struct cursor_request *request);
+
 /**
  * AUTH request
  */
@@ -458,6 +523,9 @@ xrow_encode_vote(struct xrow_header *row);
  * @param[out] Row.
  * @param instance_uuid Instance uuid.
  * @param vclock Replication clock.
+ * @param space_filter Ids of the user spaces to receive or NULL
+ *                     to receive all of them.
+ * @param space_filter_size Number of ids in @a space_filter.
  *
  * @retval 0 Success.
  * @retval -1 Memory error.
@@ -465,7 +533,9 @@ xrow_encode_vote(struct xrow_header *row);
 int
 xrow_encode_register(struct xrow_header *row,
 		     const struct tt_uuid *instance_uuid,
-		     const struct vclock *vclock);
+		     const struct vclock *vclock,
+		     const uint32_t *space_filter,
+		     uint32_t space_filter_size);
 
 /**
  * Encode SUBSCRIBE command.
@@ -476,6 +546,10 @@ xrow_encode_register(struct xrow_header *row,
  * @param anon Whether it is an anonymous subscribe request or not.
  * @param id_filter A List of replica ids to skip rows from
  *		    when feeding a replica.
+ * @param compression Whether to ask for a compressed stream.
+ * @param space_filter Ids of the user spaces to receive or NULL
+ *                     to receive all of them.
+ * @param space_filter_size Number of ids in @a space_filter.
  *
  * @retval  0 Success.
  * @retval -1 Memory error.
@@ -485,7 +559,9 @@ xrow_encode_subscribe(struct xrow_header *row,
 		      const struct tt_uuid *replicaset_uuid,
 		      const struct tt_uuid *instance_uuid,
 		      const struct vclock *vclock, bool anon,
-		      uint32_t id_filter);
+		      uint32_t id_filter, bool compression,
+		      const uint32_t *space_filter,
+		      uint32_t space_filter_size);
 
 /**
  * Decode SUBSCRIBE command.
@@ -497,6 +573,7 @@ xrow_encode_subscribe(struct xrow_header *row,
  * @param[out] anon Whether it is an anonymous subscribe.
  * @param[out] id_filter A list of ids to skip rows from when
  *			 feeding a replica.
+ * @param[out] compression Whether the stream is to be compressed.
  *
  * @retval  0 Success.
  * @retval -1 Memory or format error.
@@ -505,18 +582,54 @@ int
 xrow_decode_subscribe(const struct xrow_header *row,
 		      struct tt_uuid *replicaset_uuid,
 		      struct tt_uuid *instance_uuid, struct vclock *vclock,
-		      uint32_t *version_id, bool *anon, uint32_t *id_filter);
+		      uint32_t *version_id, bool *anon, uint32_t *id_filter,
+		      bool *compression);
 
 /**
  * Encode JOIN command.
  * @param[out] row Row to encode into.
  * @param instance_uuid.
+ * @param space_filter Ids of the user spaces to receive or NULL
+ *                     to receive all of them.
+ * @param space_filter_size Number of ids in @a space_filter.
+ *
+ * @retval  0 Success.
+ * @retval -1 Memory error.
+ */
+int
+xrow_encode_join(struct xrow_header *row, const struct tt_uuid *instance_uuid,
+		 const uint32_t *space_filter, uint32_t space_filter_size);
+
+/**
+ * Encode FETCH_SNAPSHOT command.
+ * @param[out] row Row to encode into.
+ * @param space_filter Ids of the user spaces to receive or NULL
+ *                     to receive all of them.
+ * @param space_filter_size Number of ids in @a space_filter.
  *
  * @retval  0 Success.
  * @retval -1 Memory error.
  */
 int
-xrow_encode_join(struct xrow_header *row, const struct tt_uuid *instance_uuid);
+xrow_encode_fetch_snapshot(struct xrow_header *row,
+			   const uint32_t *space_filter,
+			   uint32_t space_filter_size);
+
+/**
+ * Decode the space filter of JOIN, FETCH_SNAPSHOT, REGISTER or
+ * SUBSCRIBE command.
+ * @param row Row to decode.
+ * @param[out] space_filter Ids of the user spaces to send,
+ *                          allocated on the fiber region, or NULL
+ *                          if all spaces are to be sent.
+ * @param[out] space_filter_size Number of ids in @a space_filter.
+ *
+ * @retval  0 Success.
+ * @retval -1 Memory or format error.
+ */
+int
+xrow_decode_space_filter(const struct xrow_header *row,
+			 uint32_t **space_filter, uint32_t *space_filter_size);
 
 /**
  * Decode JOIN command.
@@ -532,7 +645,7 @@ xrow_decode_join(const struct xrow_header *row, struct tt_uuid *instance_uuid,
 		 uint32_t *version_id)
 {
 	return xrow_decode_subscribe(row, NULL, instance_uuid, NULL, version_id,
-				     NULL, NULL);
+				     NULL, NULL, NULL);
 }
 
 /**
@@ -551,7 +664,7 @@ xrow_decode_register(const struct xrow_header *row,
 		     uint32_t *version_id)
 {
 	return xrow_decode_subscribe(row, NULL, instance_uuid, vclock,
-				     version_id, NULL, NULL);
+				     version_id, NULL, NULL, NULL);
 }
 
 /**
@@ -576,7 +689,8 @@ xrow_encode_vclock(struct xrow_header *row, const struct vclock *vclock);
 static inline int
 xrow_decode_vclock(const struct xrow_header *row, struct vclock *vclock)
 {
-	return xrow_decode_subscribe(row, NULL, NULL, vclock, NULL, NULL, NULL);
+	return xrow_decode_subscribe(row, NULL, NULL, vclock, NULL, NULL, NULL,
+				     NULL);
 }
 
 /**
@@ -584,6 +698,7 @@ xrow_decode_vclock(const struct xrow_header *row, struct vclock *vclock)
  * @param row[out] Row to encode into.
  * @param replicaset_uuid.
  * @param vclock.
+ * @param compression Whether the stream that follows is compressed.
  *
  * @retval 0 Success.
  * @retval -1 Memory error.
@@ -591,13 +706,15 @@ xrow_decode_vclock(const struct xrow_header *row, struct vclock *vclock)
 int
 xrow_encode_subscribe_response(struct xrow_header *row,
 			      const struct tt_uuid *replicaset_uuid,
-			      const struct vclock *vclock);
+			      const struct vclock *vclock, bool compression);
 
 /**
  * Decode a response to subscribe request.
  * @param row Row to decode.
  * @param[out] replicaset_uuid.
  * @param[out] vclock.
+ * @param[out] compression Whether the stream that follows is
+ *			   compressed.
  *
  * @retval 0 Success.
  * @retval -1 Memory or format error.
@@ -605,10 +722,10 @@ xrow_encode_subscribe_response(struct xrow_header *row,
 static inline int
 xrow_decode_subscribe_response(const struct xrow_header *row,
 			       struct tt_uuid *replicaset_uuid,
-			       struct vclock *vclock)
+			       struct vclock *vclock, bool *compression)
 {
 	return xrow_decode_subscribe(row, replicaset_uuid, NULL, vclock, NULL,
-				     NULL, NULL);
+				     NULL, NULL, compression);
 }
 
 /**
@@ -682,6 +799,30 @@ void
 iproto_reply_select(struct obuf *buf, struct obuf_svp *svp, uint64_t sync,
 		    uint32_t schema_version, uint32_t count);
 
+/**
+ * Prepare the iproto header for a cursor result set.
+ * @param buf Out buffer.
+ * @param svp Savepoint of the header beginning.
+ *
+ * @retval  0 Success.
+ * @retval -1 Memory error.
+ */
+static inline int
+iproto_prepare_cursor(struct obuf *buf, struct obuf_svp *svp)
+{
+	return iproto_prepare_header(buf, svp, IPROTO_CURSOR_HEADER_LEN);
+}
+
+/**
+ * Write cursor result set header to a preallocated buffer.
+ * It's the same as the select header, but the body also has
+ * IPROTO_CURSOR_ID set to @a cursor_id.
+ */
+void
+iproto_reply_cursor(struct obuf *buf, struct obuf_svp *svp, uint64_t sync,
+		    uint32_t schema_version, uint64_t cursor_id,
+		    uint32_t count);
+
 /**
  * Encode iproto header with IPROTO_OK response code.
  * @param out Encode to.
@@ -783,10 +924,11 @@ iproto_reply_sql(struct obuf *buf, struct obuf_svp *svp, uint64_t sync,
  * @param svp Position to write from.
  * @param sync Request sync.
  * @param schema_version Actual schema version.
+ * @param count Number of elements in the chunk data.
  */
 void
 iproto_reply_chunk(struct obuf *buf, struct obuf_svp *svp, uint64_t sync,
-		   uint32_t schema_version);
+		   uint32_t schema_version, uint32_t count);
 
 /**
  * Encode IPROTO_EVENT packet.
@@ -895,6 +1037,8 @@ struct begin_request {
 	 * will be rolled back. Must be greater than zero.
 	 */
 	double timeout;
+	/** Isolation level, see enum txn_isolation_level. */
+	uint32_t isolation;
 };
 
 /**
@@ -1030,9 +1174,12 @@ xrow_decode_ballot_xc(const struct xrow_header *row, struct ballot *ballot)
 static inline void
 xrow_encode_register_xc(struct xrow_header *row,
 		       const struct tt_uuid *instance_uuid,
-		       const struct vclock *vclock)
+		       const struct vclock *vclock,
+		       const uint32_t *space_filter,
+		       uint32_t space_filter_size)
 {
-	if (xrow_encode_register(row, instance_uuid, vclock) != 0)
+	if (xrow_encode_register(row, instance_uuid, vclock, space_filter,
+				 space_filter_size) != 0)
 		diag_raise();
 }
 
@@ -1042,10 +1189,13 @@ xrow_encode_subscribe_xc(struct xrow_header *row,
 			 const struct tt_uuid *replicaset_uuid,
 			 const struct tt_uuid *instance_uuid,
 			 const struct vclock *vclock, bool anon,
-			 uint32_t id_filter)
+			 uint32_t id_filter, bool compression,
+			 const uint32_t *space_filter,
+			 uint32_t space_filter_size)
 {
 	if (xrow_encode_subscribe(row, replicaset_uuid, instance_uuid,
-				  vclock, anon, id_filter) != 0)
+				  vclock, anon, id_filter, compression,
+				  space_filter, space_filter_size) != 0)
 		diag_raise();
 }
 
@@ -1055,20 +1205,44 @@ xrow_decode_subscribe_xc(const struct xrow_header *row,
 			 struct tt_uuid *replicaset_uuid,
 			 struct tt_uuid *instance_uuid, struct vclock *vclock,
 			 uint32_t *replica_version_id, bool *anon,
-			 uint32_t *id_filter)
+			 uint32_t *id_filter, bool *compression)
 {
 	if (xrow_decode_subscribe(row, replicaset_uuid, instance_uuid,
 				  vclock, replica_version_id, anon,
-				  id_filter) != 0)
+				  id_filter, compression) != 0)
 		diag_raise();
 }
 
 /** @copydoc xrow_encode_join. */
 static inline void
 xrow_encode_join_xc(struct xrow_header *row,
-		    const struct tt_uuid *instance_uuid)
+		    const struct tt_uuid *instance_uuid,
+		    const uint32_t *space_filter, uint32_t space_filter_size)
+{
+	if (xrow_encode_join(row, instance_uuid, space_filter,
+			     space_filter_size) != 0)
+		diag_raise();
+}
+
+/** @copydoc xrow_encode_fetch_snapshot. */
+static inline void
+xrow_encode_fetch_snapshot_xc(struct xrow_header *row,
+			      const uint32_t *space_filter,
+			      uint32_t space_filter_size)
+{
+	if (xrow_encode_fetch_snapshot(row, space_filter,
+				       space_filter_size) != 0)
+		diag_raise();
+}
+
+/** @copydoc xrow_decode_space_filter. */
+static inline void
+xrow_decode_space_filter_xc(const struct xrow_header *row,
+			    uint32_t **space_filter,
+			    uint32_t *space_filter_size)
 {
-	if (xrow_encode_join(row, instance_uuid) != 0)
+	if (xrow_decode_space_filter(row, space_filter,
+				     space_filter_size) != 0)
 		diag_raise();
 }
 
@@ -1111,9 +1285,11 @@ xrow_decode_vclock_xc(const struct xrow_header *row, struct vclock *vclock)
 static inline void
 xrow_encode_subscribe_response_xc(struct xrow_header *row,
 				  const struct tt_uuid *replicaset_uuid,
-				  const struct vclock *vclock)
+				  const struct vclock *vclock,
+				  bool compression)
 {
-	if (xrow_encode_subscribe_response(row, replicaset_uuid, vclock) != 0)
+	if (xrow_encode_subscribe_response(row, replicaset_uuid, vclock,
+					   compression) != 0)
 		diag_raise();
 }
 
@@ -1121,9 +1297,10 @@ xrow_encode_subscribe_response_xc(struct xrow_header *row,
 static inline void
 xrow_decode_subscribe_response_xc(const struct xrow_header *row,
 				  struct tt_uuid *replicaset_uuid,
-				  struct vclock *vclock)
+				  struct vclock *vclock, bool *compression)
 {
-	if (xrow_decode_subscribe_response(row, replicaset_uuid, vclock) != 0)
+	if (xrow_decode_subscribe_response(row, replicaset_uuid, vclock,
+					   compression) != 0)
 		diag_raise();
 }
 
@@ -33,7 +33,10 @@
 #include "coio.h"
 #include "coio_buf.h"
 #include "error.h"
+#include "fiber.h"
+#include "iproto_compress.h"
 #include "msgpuck/msgpuck.h"
+#include "scoped_guard.h"
 
 void
 coio_read_xrow(struct iostream *io, struct ibuf *in, struct xrow_header *row)
@@ -104,3 +107,87 @@ coio_write_xrow(struct iostream *io, const struct xrow_header *row)
 		diag_raise();
 }
 
+
+/**
+ * Read and decompress chunks until @a in has at least @a size
+ * bytes. The compressed input is read into @a raw.
+ */
+static void
+coio_breadn_decompress_timeout(struct iostream *io, struct ibuf *raw,
+			       struct iproto_decompressor *decompressor,
+			       struct ibuf *in, size_t size, ev_tstamp timeout)
+{
+	ev_tstamp start, delay;
+	coio_timeout_init(&start, &delay, timeout);
+	while (true) {
+		/*
+		 * Whole chunks may have been read ahead into the raw
+		 * buffer, so decompress them before reading more.
+		 */
+		if (iproto_decompress(decompressor, raw, in) != 0)
+			diag_raise();
+		if (ibuf_used(in) >= size)
+			break;
+		/* All whole chunks are consumed, so the first is partial. */
+		size_t to_read = iproto_chunk_bytes_missing(raw);
+		assert(to_read > 0);
+		coio_breadn_timeout(io, raw, to_read, delay);
+		coio_timeout_update(&start, &delay);
+	}
+}
+
+void
+coio_read_xrow_decompress_timeout_xc(struct iostream *io, struct ibuf *raw,
+				     struct iproto_decompressor *decompressor,
+				     struct ibuf *in, struct xrow_header *row,
+				     ev_tstamp timeout)
+{
+	ev_tstamp start, delay;
+	coio_timeout_init(&start, &delay, timeout);
+	/* Read fixed header */
+	coio_breadn_decompress_timeout(io, raw, decompressor, in, 1, delay);
+	coio_timeout_update(&start, &delay);
+
+	/* Read length */
+	if (mp_typeof(*in->rpos) != MP_UINT) {
+		tnt_raise(ClientError, ER_INVALID_MSGPACK,
+			  "packet length");
+	}
+	ssize_t to_read = mp_check_uint(in->rpos, in->wpos);
+	if (to_read > 0) {
+		coio_breadn_decompress_timeout(io, raw, decompressor, in,
+					       ibuf_used(in) + to_read, delay);
+	}
+	coio_timeout_update(&start, &delay);
+
+	uint32_t len = mp_decode_uint((const char **) &in->rpos);
+
+	/* Read header and body */
+	coio_breadn_decompress_timeout(io, raw, decompressor, in, len, delay);
+
+	xrow_header_decode_xc(row, (const char **) &in->rpos, in->rpos + len,
+			      true);
+}
+
+void
+coio_write_xrow_compressed(struct iostream *io, const struct xrow_header *row)
+{
+	struct iovec iov[XROW_IOVMAX];
+	int iovcnt = xrow_to_iovec_xc(row, iov);
+	size_t size = 0;
+	for (int i = 0; i < iovcnt; i++)
+		size += iov[i].iov_len;
+	struct iproto_compressor compressor;
+	iproto_compressor_create(&compressor);
+	struct ibuf buf;
+	ibuf_create(&buf, &cord()->slabc, size + IPROTO_CHUNK_HEADER_SIZE);
+	auto guard = make_scoped_guard([&] {
+		ibuf_destroy(&buf);
+		iproto_compressor_destroy(&compressor);
+	});
+	if (iproto_compress(&compressor, iov, iovcnt, size, &buf) != 0)
+		diag_raise();
+	if (coio_write_timeout(io, buf.rpos, ibuf_used(&buf),
+			       TIMEOUT_INFINITY) < 0)
+		diag_raise();
+}
@@ -36,6 +36,7 @@ extern "C" {
 
 struct ibuf;
 struct iostream;
+struct iproto_decompressor;
 struct xrow_header;
 
 void
@@ -48,6 +49,21 @@ coio_read_xrow_timeout_xc(struct iostream *io, struct ibuf *in,
 void
 coio_write_xrow(struct iostream *io, const struct xrow_header *row);
 
+/**
+ * Read a row from a compressed stream (see iproto_compress.h).
+ * The stream is read into @a raw and decompressed into @a in,
+ * which the row is decoded from.
+ */
+void
+coio_read_xrow_decompress_timeout_xc(struct iostream *io, struct ibuf *raw,
+				     struct iproto_decompressor *decompressor,
+				     struct ibuf *in, struct xrow_header *row,
+				     double timeout);
+
+/** Write a row to a compressed stream as a separate chunk. */
+void
+coio_write_xrow_compressed(struct iostream *io, const struct xrow_header *row);
+
 
 #if defined(__cplusplus)
 } /* extern "C" */
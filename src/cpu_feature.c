@@ -123,3 +123,36 @@ sse42_enabled_cpu()
 }
 
 #endif
+
+#if defined(__aarch64__) && defined(__ARM_FEATURE_CRC32)
+
+#include <arm_acle.h>
+#include <string.h>
+
+uint32_t
+crc32c_hw_arm(uint32_t crc, const char *buf, unsigned int len)
+{
+	/*
+	 * Unlike x86, the load is done with memcpy(), which is a
+	 * single unaligned load on AArch64 and is not an undefined
+	 * behaviour.
+	 */
+	for (; len >= sizeof(uint64_t); len -= sizeof(uint64_t)) {
+		uint64_t word;
+		memcpy(&word, buf, sizeof(word));
+		crc = __crc32cd(crc, word);
+		buf += sizeof(word);
+	}
+	if (len >= sizeof(uint32_t)) {
+		uint32_t word;
+		memcpy(&word, buf, sizeof(word));
+		crc = __crc32cw(crc, word);
+		buf += sizeof(word);
+		len -= sizeof(word);
+	}
+	while (len-- > 0)
+		crc = __crc32cb(crc, *buf++);
+	return crc;
+}
+
+#endif /* defined(__aarch64__) && defined(__ARM_FEATURE_CRC32) */
@@ -55,5 +55,19 @@ bool sse42_enabled_cpu();
 uint32_t crc32c_hw(uint32_t crc, const char *buf, unsigned int len);
 #endif
 
+#if defined(__aarch64__) && defined(__ARM_FEATURE_CRC32)
+/* Calculate CRC32 for the given data buffer with the ARMv8 CRC32
+ * instructions. Available if the target architecture has them, e.g.
+ * -march=armv8.1-a or -march=armv8-a+crc.
+ *
+ * @param	crc 		initial CRC
+ * @param	buf			data buffer
+ * @param	len			buffer length
+ *
+ * @return	CRC32 value
+ */
+uint32_t crc32c_hw_arm(uint32_t crc, const char *buf, unsigned int len);
+#endif
+
 #endif /* TARANTOOL_CPU_FEATURES_H */
 
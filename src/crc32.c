@@ -44,6 +44,8 @@ crc32_init(void)
 {
 #if defined(HAVE_CPUID) && (defined (__x86_64__) || defined (__i386__))
 	crc32_calc = sse42_enabled_cpu() ? &crc32c_hw : &crc32c;
+#elif defined(__aarch64__) && defined(__ARM_FEATURE_CRC32)
+	crc32_calc = &crc32c_hw_arm;
 #else
 	crc32_calc = &crc32c;
 #endif
@@ -90,7 +90,10 @@ curl_multi_process(CURLM *multi, curl_socket_t sockfd, int events)
 		if (errinj != NULL)
 			errinj->bparam = false;
 #endif
-		fiber_cond_signal(&request->cond);
+		if (request->batch == NULL)
+			fiber_cond_signal(&request->cond);
+		else if (--request->batch->in_progress == 0)
+			fiber_cond_signal(&request->batch->cond);
 	}
 }
 
@@ -220,7 +223,8 @@ curl_multi_sock_cb(CURL *easy, curl_socket_t fd, int what, void *envp,
 
 
 int
-curl_env_create(struct curl_env *env, long max_conns, long max_total_conns)
+curl_env_create(struct curl_env *env, long max_conns, long max_total_conns,
+		long max_host_conns, bool multiplex)
 {
 	memset(env, 0, sizeof(*env));
 	mempool_create(&env->sock_pool, &cord()->slabc,
@@ -248,6 +252,24 @@ curl_env_create(struct curl_env *env, long max_conns, long max_total_conns)
 #else
 	(void) max_total_conns;
 #endif
+#if LIBCURL_VERSION_NUM >= 0x071e00
+	curl_multi_setopt(env->multi, CURLMOPT_MAX_HOST_CONNECTIONS,
+			  max_host_conns);
+#else
+	(void) max_host_conns;
+#endif
+#if LIBCURL_VERSION_NUM >= 0x072b00
+	/*
+	 * Multiplexing is on by default since libcurl 7.62.0, so
+	 * only enable it explicitly and leave the libcurl default
+	 * alone otherwise.
+	 */
+	if (multiplex)
+		curl_multi_setopt(env->multi, CURLMOPT_PIPELINING,
+				  CURLPIPE_MULTIPLEX);
+#else
+	(void) multiplex;
+#endif
 
 	return 0;
 
@@ -276,6 +298,7 @@ curl_request_create(struct curl_request *curl_request)
 	}
 	curl_request->in_progress = false;
 	curl_request->code = CURLE_OK;
+	curl_request->batch = NULL;
 	fiber_cond_create(&curl_request->cond);
 	return 0;
 }
@@ -288,6 +311,21 @@ curl_request_destroy(struct curl_request *curl_request)
 	fiber_cond_destroy(&curl_request->cond);
 }
 
+/** Set diag for a libcurl multi interface error. */
+static void
+curl_multi_diag_set(CURLMcode mcode)
+{
+	switch (mcode) {
+	case CURLM_OUT_OF_MEMORY:
+		diag_set(OutOfMemory, 0, "curl", "internal");
+		break;
+	default:
+		errno = EINVAL;
+		diag_set(SystemError, "curl_multi_error: %s",
+			 curl_multi_strerror(mcode));
+	}
+}
+
 CURLMcode
 curl_execute(struct curl_request *curl_request, struct curl_env *env,
 	     double timeout)
@@ -313,14 +351,61 @@ curl_execute(struct curl_request *curl_request, struct curl_env *env,
 	return CURLM_OK;
 
 curl_merror:
-	switch (mcode) {
-	case CURLM_OUT_OF_MEMORY:
-		diag_set(OutOfMemory, 0, "curl", "internal");
-		break;
-	default:
-		errno = EINVAL;
-		diag_set(SystemError, "curl_multi_error: %s",
-			 curl_multi_strerror(mcode));
+	curl_multi_diag_set(mcode);
+	return mcode;
+}
+
+CURLMcode
+curl_execute_many(struct curl_request **requests, int count,
+		  struct curl_env *env, double timeout)
+{
+	CURLMcode mcode = CURLM_OK;
+	struct curl_batch batch;
+	batch.in_progress = 0;
+	fiber_cond_create(&batch.cond);
+	int added = 0;
+	for (; added < count; added++) {
+		struct curl_request *request = requests[added];
+		request->in_progress = true;
+		request->batch = &batch;
+		batch.in_progress++;
+		mcode = curl_multi_add_handle(env->multi, request->easy);
+		if (mcode != CURLM_OK) {
+			request->in_progress = false;
+			request->batch = NULL;
+			batch.in_progress--;
+			break;
+		}
+	}
+	/*
+	 * Requests may fail or even finish while being added, so
+	 * the batch may be done already.
+	 */
+	if (mcode == CURLM_OK && batch.in_progress > 0) {
+		env->stat.active_requests += count;
+		double deadline = ev_monotonic_now(loop()) + timeout;
+		while (batch.in_progress > 0) {
+			if (fiber_cond_wait_deadline(&batch.cond,
+						     deadline) != 0 ||
+			    fiber_is_cancelled())
+				break;
+		}
+		env->stat.active_requests -= count;
 	}
+	for (int i = 0; i < added; i++) {
+		struct curl_request *request = requests[i];
+		if (request->in_progress) {
+			request->code = CURLE_OPERATION_TIMEDOUT;
+			request->in_progress = false;
+		}
+		request->batch = NULL;
+		CURLMcode rc = curl_multi_remove_handle(env->multi,
+							request->easy);
+		if (mcode == CURLM_OK)
+			mcode = rc;
+	}
+	fiber_cond_destroy(&batch.cond);
+	if (mcode != CURLM_OK)
+		curl_multi_diag_set(mcode);
 	return mcode;
 }
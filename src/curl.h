@@ -62,6 +62,16 @@ struct curl_env {
 	struct curl_stat stat;
 };
 
+/**
+ * A set of requests executed at once with curl_execute_many().
+ */
+struct curl_batch {
+	/** Number of requests still in progress. */
+	int in_progress;
+	/** Signaled when the last request of the batch is done. */
+	struct fiber_cond cond;
+};
+
 /**
  * CURL Request
  */
@@ -77,17 +87,29 @@ struct curl_request {
 	 * until the handler (callback function) gives a signal within variable.
 	 * */
 	struct fiber_cond cond;
+	/**
+	 * The batch the request is executed in, if any. The batch
+	 * is signaled instead of the request when all requests of
+	 * the batch are done, so the waiting fiber wakes up once.
+	 */
+	struct curl_batch *batch;
 };
 
 /**
  * @brief Create a new CURL environment
  * @param env pointer to a structure to initialize
  * @param max_conn The maximum number of entries in connection cache
+ * @param max_total_conns The maximum number of active connections
+ * @param max_host_conns The maximum number of active connections to
+ *        a single host, 0 for no limit
+ * @param multiplex Whether to multiplex requests to the same host
+ *        over one HTTP/2 connection, false keeps the libcurl default
  * @retval 0 on success
  * @retval -1 on error, check diag
  */
 int
-curl_env_create(struct curl_env *env, long max_conns, long max_total_conns);
+curl_env_create(struct curl_env *env, long max_conns, long max_total_conns,
+		long max_host_conns, bool multiplex);
 
 /**
  * Destroy HTTP client environment
@@ -122,4 +144,18 @@ CURLMcode
 curl_execute(struct curl_request *curl_request, struct curl_env *env,
 	     double timeout);
 
+/**
+ * Execute a set of CURL requests concurrently. The calling fiber
+ * is woken up once, when all of them are done or the timeout
+ * expires. Requests that don't finish in time fail with
+ * CURLE_OPERATION_TIMEDOUT.
+ * @param requests requests
+ * @param count number of requests
+ * @param env environment
+ * @param timeout - timeout of waiting for all requests
+ */
+CURLMcode
+curl_execute_many(struct curl_request **requests, int count,
+		  struct curl_env *env, double timeout);
+
 #endif /* TARANTOOL_CURL_H_INCLUDED */
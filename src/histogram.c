@@ -131,15 +131,34 @@ histogram_discard(struct histogram *hist, int64_t val)
 	hist->total--;
 }
 
+void
+histogram_merge(struct histogram *dst, const struct histogram *src)
+{
+	assert(dst->n_buckets == src->n_buckets);
+	for (size_t i = 0; i < dst->n_buckets; i++) {
+		assert(dst->buckets[i].max == src->buckets[i].max);
+		dst->buckets[i].count += src->buckets[i].count;
+	}
+	if (dst->max < src->max)
+		dst->max = src->max;
+	dst->total += src->total;
+}
+
 int64_t
 histogram_percentile(struct histogram *hist, int pct)
+{
+	return histogram_permille(hist, pct * 10);
+}
+
+int64_t
+histogram_permille(struct histogram *hist, int pml)
 {
 	size_t count = 0;
 
 	for (size_t i = 0; i < hist->n_buckets; i++) {
 		struct histogram_bucket *bucket = &hist->buckets[i];
 		count += bucket->count;
-		if (count * 100 > hist->total * pct)
+		if (count * 1000 > hist->total * pml)
 			return bucket->max;
 	}
 	return hist->max;
@@ -82,6 +82,13 @@ histogram_collect(struct histogram *hist, int64_t val);
 void
 histogram_discard(struct histogram *hist, int64_t val);
 
+/**
+ * Add all observations collected by histogram @a src to
+ * histogram @a dst. The histograms must have the same buckets.
+ */
+void
+histogram_merge(struct histogram *dst, const struct histogram *src);
+
 /**
  * Calculate a percentile, i.e. the value below which a given
  * percentage of observations fall.
@@ -89,6 +96,13 @@ histogram_discard(struct histogram *hist, int64_t val);
 int64_t
 histogram_percentile(struct histogram *hist, int pct);
 
+/**
+ * Same as histogram_percentile(), but @a pml is given in per
+ * mille, e.g. 999 for the 99.9th percentile.
+ */
+int64_t
+histogram_permille(struct histogram *hist, int pml);
+
 /**
  * Same as histogram_percentile(), but return a lower bound
  * estimate of the percentile.
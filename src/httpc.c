@@ -33,9 +33,11 @@
 
 #include <assert.h>
 #include <curl/curl.h>
+#include "assoc.h"
 #include "tt_static.h"
 #include "fiber.h"
 #include "errinj.h"
+#include "uri/uri.h"
 
 #define MAX_HEADER_LEN 8192
 
@@ -85,13 +87,17 @@ curl_easy_header_cb(char *buffer, size_t size, size_t nitems, void *ctx)
 }
 
 int
-httpc_env_create(struct httpc_env *env, int max_conns, int max_total_conns)
+httpc_env_create(struct httpc_env *env, int max_conns, int max_total_conns,
+		 int max_host_conns, bool http2)
 {
 	memset(env, 0, sizeof(*env));
 	mempool_create(&env->req_pool, &cord()->slabc,
 			sizeof(struct httpc_request));
+	env->hosts = mh_strnptr_new();
+	env->http2 = http2;
 
-	return curl_env_create(&env->curl_env, max_conns, max_total_conns);
+	return curl_env_create(&env->curl_env, max_conns, max_total_conns,
+			       max_host_conns, http2);
 }
 
 void
@@ -101,9 +107,75 @@ httpc_env_destroy(struct httpc_env *ctx)
 
 	curl_env_destroy(&ctx->curl_env);
 
+	mh_int_t i;
+	mh_foreach(ctx->hosts, i) {
+		struct httpc_host_stat *stat =
+			mh_strnptr_node(ctx->hosts, i)->val;
+		latency_destroy(&stat->latency);
+		free(stat);
+	}
+	mh_strnptr_delete(ctx->hosts);
+
 	mempool_destroy(&ctx->req_pool);
 }
 
+void
+httpc_env_foreach_host_stat(struct httpc_env *env,
+			    void (*cb)(struct httpc_host_stat *stat,
+				       void *arg),
+			    void *arg)
+{
+	mh_int_t i;
+	mh_foreach(env->hosts, i)
+		cb(mh_strnptr_node(env->hosts, i)->val, arg);
+}
+
+/**
+ * Find or create statistics of the host @a url points to. Returns
+ * NULL if the URL can't be parsed, there are too many hosts or
+ * out of memory: statistics are not worth failing a request.
+ */
+static struct httpc_host_stat *
+httpc_env_host_stat(struct httpc_env *env, const char *url)
+{
+	struct uri uri;
+	struct httpc_host_stat *stat = NULL;
+	if (uri_create(&uri, url) != 0 || uri.host == NULL)
+		goto out;
+	const char *name = uri.service == NULL ? uri.host :
+			   tt_sprintf("%s:%s", uri.host, uri.service);
+	uint32_t name_len = strlen(name);
+	mh_int_t i = mh_strnptr_find_inp(env->hosts, name, name_len);
+	if (i != mh_end(env->hosts)) {
+		stat = mh_strnptr_node(env->hosts, i)->val;
+		goto out;
+	}
+	if (mh_size(env->hosts) >= HTTPC_HOST_STAT_MAX)
+		goto out;
+	stat = calloc(1, sizeof(*stat) + name_len + 1);
+	if (stat == NULL)
+		goto out;
+	if (latency_create(&stat->latency) != 0) {
+		free(stat);
+		stat = NULL;
+		goto out;
+	}
+	memcpy(stat->name, name, name_len + 1);
+	stat->name_len = name_len;
+	struct mh_strnptr_node_t node = {
+		stat->name, name_len, mh_strn_hash(name, name_len), stat,
+	};
+	if (mh_strnptr_put(env->hosts, &node, NULL, NULL) ==
+	    mh_end(env->hosts)) {
+		latency_destroy(&stat->latency);
+		free(stat);
+		stat = NULL;
+	}
+out:
+	uri_destroy(&uri);
+	return stat;
+}
+
 struct httpc_request *
 httpc_request_new(struct httpc_env *env, const char *method,
 		  const char *url)
@@ -116,6 +188,7 @@ httpc_request_new(struct httpc_env *env, const char *method,
 	}
 	memset(req, 0, sizeof(*req));
 	req->env = env;
+	req->host_stat = httpc_env_host_stat(env, url);
 	req->set_connection_header = true;
 	req->set_keep_alive_header = true;
 	region_create(&req->resp_headers, &cord()->slabc);
@@ -155,6 +228,19 @@ httpc_request_new(struct httpc_env *env, const char *method,
 	curl_easy_setopt(req->curl_request.easy, CURLOPT_HEADERFUNCTION,
 			 curl_easy_header_cb);
 	curl_easy_setopt(req->curl_request.easy, CURLOPT_NOPROGRESS, 1L);
+#if LIBCURL_VERSION_NUM >= 0x072b00
+	if (env->http2) {
+		/*
+		 * HTTP/2 for https:// only, negotiated with ALPN, so
+		 * plain HTTP/1.1 servers keep working. Wait for a
+		 * connection that can be multiplexed rather than open
+		 * a new one.
+		 */
+		curl_easy_setopt(req->curl_request.easy, CURLOPT_HTTP_VERSION,
+				 (long)CURL_HTTP_VERSION_2TLS);
+		curl_easy_setopt(req->curl_request.easy, CURLOPT_PIPEWAIT, 1L);
+	}
+#endif
 
 	ibuf_create(&req->body, &cord()->slabc, 1);
 
@@ -375,8 +461,9 @@ httpc_set_accept_encoding(struct httpc_request *req, const char *encoding)
 #endif
 }
 
-int
-httpc_execute(struct httpc_request *req, double timeout)
+/** Set the automatic headers and callbacks before execution. */
+static int
+httpc_request_prepare(struct httpc_request *req)
 {
 	struct httpc_env *env = req->env;
 	if (req->set_accept_header &&
@@ -398,10 +485,81 @@ httpc_execute(struct httpc_request *req, double timeout)
 	curl_easy_setopt(req->curl_request.easy, CURLOPT_HTTPHEADER, req->headers);
 
 	++env->stat.total_requests;
+	return 0;
+}
+
+/** Account a finished request in the statistics of its host. */
+static void
+httpc_request_collect_host_stat(struct httpc_request *req, bool is_failed)
+{
+	struct httpc_host_stat *stat = req->host_stat;
+	if (stat == NULL)
+		return;
+	CURL *easy = req->curl_request.easy;
+	++stat->total_requests;
+	if (is_failed) {
+		++stat->failed_requests;
+		return;
+	}
+	long connects = 0;
+	if (curl_easy_getinfo(easy, CURLINFO_NUM_CONNECTS,
+			      &connects) == CURLE_OK) {
+		if (connects > 0)
+			++stat->new_connections;
+		else
+			++stat->reused_connections;
+	}
+	double total_time = 0;
+	if (curl_easy_getinfo(easy, CURLINFO_TOTAL_TIME,
+			      &total_time) == CURLE_OK)
+		latency_collect(&stat->latency, total_time);
+}
 
+int
+httpc_execute(struct httpc_request *req, double timeout)
+{
+	struct httpc_env *env = req->env;
+	if (httpc_request_prepare(req) != 0)
+		return -1;
 	if (curl_execute(&req->curl_request, &env->curl_env, timeout) != CURLM_OK)
 		return -1;
 	ERROR_INJECT_RETURN(ERRINJ_HTTPC_EXECUTE);
+	return httpc_request_finish(req);
+}
+
+int
+httpc_execute_many(struct httpc_request **reqs, int count, double timeout)
+{
+	if (count == 0)
+		return 0;
+	struct httpc_env *env = reqs[0]->env;
+	struct curl_request **curl_reqs = malloc(count * sizeof(*curl_reqs));
+	if (curl_reqs == NULL) {
+		diag_set(OutOfMemory, count * sizeof(*curl_reqs), "malloc",
+			 "curl_reqs");
+		return -1;
+	}
+	int rc = -1;
+	for (int i = 0; i < count; i++) {
+		assert(reqs[i]->env == env);
+		if (httpc_request_prepare(reqs[i]) != 0)
+			goto out;
+		curl_reqs[i] = &reqs[i]->curl_request;
+	}
+	if (curl_execute_many(curl_reqs, count, &env->curl_env,
+			      timeout) != CURLM_OK)
+		goto out;
+	rc = 0;
+out:
+	free(curl_reqs);
+	return rc;
+}
+
+int
+httpc_request_finish(struct httpc_request *req)
+{
+	struct httpc_env *env = req->env;
+	httpc_request_collect_host_stat(req, req->curl_request.code != CURLE_OK);
 	long longval = 0;
 	switch (req->curl_request.code) {
 	case CURLE_OK:
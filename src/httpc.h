@@ -36,6 +36,7 @@
 #include <tarantool_ev.h>
 
 #include "diag.h"
+#include "latency.h"
 
 #include "curl.h"
 
@@ -44,6 +45,7 @@
 typedef void CURLM;
 typedef void CURL;
 struct curl_slist;
+struct mh_strnptr_t;
 
 /**
  * HTTP Client Statistics
@@ -56,6 +58,33 @@ struct httpc_stat {
 	uint64_t active_requests;
 };
 
+enum {
+	/**
+	 * Statistics are collected for this many hosts at most,
+	 * so that a client talking to arbitrary hosts doesn't
+	 * consume unbounded memory.
+	 */
+	HTTPC_HOST_STAT_MAX = 1024,
+};
+
+/**
+ * HTTP Client Statistics of a single host
+ */
+struct httpc_host_stat {
+	uint64_t total_requests;
+	uint64_t failed_requests;
+	/** Requests that had to open a new connection. */
+	uint64_t new_connections;
+	/** Requests that reused a cached connection. */
+	uint64_t reused_connections;
+	/** Time from the start of a request to the end of the response. */
+	struct latency latency;
+	/** Length of the name. */
+	uint32_t name_len;
+	/** Host and port, the key in httpc_env::hosts. */
+	char name[0];
+};
+
 /**
  * HTTP Client Environment
  */
@@ -66,17 +95,38 @@ struct httpc_env {
 	struct mempool req_pool;
 	/** Statistics */
 	struct httpc_stat stat;
+	/** Host name -> struct httpc_host_stat. */
+	struct mh_strnptr_t *hosts;
+	/** Requests prefer HTTP/2 and multiplexing. */
+	bool http2;
 };
 
 /**
  * @brief Creates  new HTTP client environment
  * @param env pointer to a structure to initialize
  * @param max_conn The maximum number of entries in connection cache
+ * @param max_total_conns The maximum number of active connections
+ * @param max_host_conns The maximum number of active connections to
+ *        a single host, 0 for no limit
+ * @param http2 Whether requests should use HTTP/2 over TLS, if the
+ *        server supports it, and multiplex requests to a host over
+ *        one connection
  * @retval 0 on success
  * @retval -1 on error, check diag
  */
 int
-httpc_env_create(struct httpc_env *ctx, int max_conns, int max_total_conns);
+httpc_env_create(struct httpc_env *ctx, int max_conns, int max_total_conns,
+		 int max_host_conns, bool http2);
+
+/**
+ * Call @a cb for statistics of each host the client has sent
+ * requests to.
+ */
+void
+httpc_env_foreach_host_stat(struct httpc_env *env,
+			    void (*cb)(struct httpc_host_stat *stat,
+				       void *arg),
+			    void *arg);
 
 /**
  * Destroy HTTP client environment
@@ -101,6 +151,8 @@ struct httpc_request {
 	struct ibuf body;
 	/** curl resuest. */
 	struct curl_request curl_request;
+	/** Statistics of the request host or NULL. */
+	struct httpc_host_stat *host_stat;
 	/** HTTP status code */
 	int status;
 	/** Error message */
@@ -411,6 +463,29 @@ httpc_set_accept_encoding(struct httpc_request *req, const char *encoding);
 int
 httpc_execute(struct httpc_request *req, double timeout);
 
+/**
+ * Execute a set of HTTP requests concurrently. The calling fiber
+ * yields until all of them are done or @a timeout expires.
+ * Results of the requests must be checked with
+ * httpc_request_finish() for each request.
+ * @param reqs - requests with filled fields
+ * @param count - number of requests
+ * @param timeout - timeout of waiting for all requests
+ * @retval 0 the requests were executed
+ * @retval -1 the requests could not be started, check diag
+ */
+int
+httpc_execute_many(struct httpc_request **reqs, int count, double timeout);
+
+/**
+ * Check the result of a request executed by httpc_execute_many(),
+ * set its status and reason and account it in statistics.
+ * @retval 0 the request got a response or an HTTP-like status
+ * @retval -1 the request failed, check diag
+ */
+int
+httpc_request_finish(struct httpc_request *req);
+
 /** Request }}} */
 
 #endif /* TARANTOOL_HTTPC_H_INCLUDED */
@@ -89,9 +89,31 @@ latency_collect(struct latency *latency, double value)
 	histogram_collect(latency->histogram, value_usec);
 }
 
+void
+latency_merge(struct latency *dst, const struct latency *src)
+{
+	histogram_merge(dst->histogram, src->histogram);
+	/* Drop the zero observation added on creation of @src. */
+	histogram_discard(dst->histogram, 0);
+}
+
+size_t
+latency_count(const struct latency *latency)
+{
+	/* Don't count the zero observation added on creation. */
+	return latency->histogram->total - 1;
+}
+
 double
 latency_get(struct latency *latency, int pct)
 {
 	int64_t value_usec = histogram_percentile(latency->histogram, pct);
 	return (double)value_usec / USEC_PER_SEC;
 }
+
+double
+latency_get_permille(struct latency *latency, int pml)
+{
+	int64_t value_usec = histogram_permille(latency->histogram, pml);
+	return (double)value_usec / USEC_PER_SEC;
+}
@@ -31,6 +31,12 @@
  * SUCH DAMAGE.
  */
 
+#include <stddef.h>
+
+#if defined(__cplusplus)
+extern "C" {
+#endif
+
 struct histogram;
 
 /**
@@ -70,6 +76,20 @@ latency_reset(struct latency *latency);
 void
 latency_collect(struct latency *latency, double value);
 
+/**
+ * Add all observations collected by latency counter @a src
+ * to latency counter @a dst.
+ */
+void
+latency_merge(struct latency *dst, const struct latency *src);
+
+/**
+ * Return the number of observations collected by a latency
+ * counter.
+ */
+size_t
+latency_count(const struct latency *latency);
+
 /**
  * Get accumulated latency value, in seconds.
  * Returns @pct-th percentile of all observations.
@@ -77,4 +97,15 @@ latency_collect(struct latency *latency, double value);
 double
 latency_get(struct latency *latency, int pct);
 
+/**
+ * Same as latency_get(), but @pml is given in per mille,
+ * so that tail latencies like p99.9 can be tracked.
+ */
+double
+latency_get_permille(struct latency *latency, int pml);
+
+#if defined(__cplusplus)
+} /* extern "C" */
+#endif
+
 #endif /* TARANTOOL_LATENCY_H_INCLUDED */
@@ -66,6 +66,115 @@ tt_bitset_destroy(struct tt_bitset *bitset)
 	memset(&bitset->pages, 0, sizeof(bitset->pages));
 }
 
+/** Allocate a sparse page with room for @a capacity offsets. */
+static struct tt_bitset_page *
+tt_bitset_page_array_new(struct tt_bitset *bitset, size_t first_pos,
+			 size_t capacity)
+{
+	assert(capacity > 0 && capacity <= BITSET_PAGE_ARRAY_MAX);
+	size_t size = tt_bitset_page_array_alloc_size(capacity);
+	struct tt_bitset_page *page = bitset->realloc(NULL, size);
+	if (page == NULL)
+		return NULL;
+
+	memset(page, 0, sizeof(*page));
+	page->first_pos = first_pos;
+	page->capacity = capacity;
+	return page;
+}
+
+/** Allocate a bitmap page with all bits cleared. */
+static struct tt_bitset_page *
+tt_bitset_page_bitmap_new(struct tt_bitset *bitset, size_t first_pos)
+{
+	size_t size = tt_bitset_page_alloc_size(bitset->realloc);
+	struct tt_bitset_page *page = bitset->realloc(NULL, size);
+	if (page == NULL)
+		return NULL;
+
+	tt_bitset_page_create(page);
+	page->first_pos = first_pos;
+	return page;
+}
+
+/** Put @a new_page in place of @a old_page and free the latter. */
+static void
+tt_bitset_page_replace(struct tt_bitset *bitset,
+		       struct tt_bitset_page *old_page,
+		       struct tt_bitset_page *new_page)
+{
+	assert(old_page->first_pos == new_page->first_pos);
+	assert(old_page->cardinality == new_page->cardinality);
+	tt_bitset_pages_remove(&bitset->pages, old_page);
+	tt_bitset_pages_insert(&bitset->pages, new_page);
+	tt_bitset_page_destroy(old_page);
+	bitset->realloc(old_page, 0);
+}
+
+/**
+ * Make room for one more offset in a full sparse page. The page
+ * is replaced with a sparse page twice as large or, if it has
+ * reached the max size, with a bitmap page.
+ *
+ * @retval the new page on success
+ * @retval NULL on memory error, the old page is left intact
+ */
+static struct tt_bitset_page *
+tt_bitset_page_expand(struct tt_bitset *bitset, struct tt_bitset_page *page)
+{
+	assert(tt_bitset_page_is_array(page));
+	assert(page->cardinality == page->capacity);
+
+	uint16_t *array = tt_bitset_page_array(page);
+	struct tt_bitset_page *new_page;
+	if (page->capacity < BITSET_PAGE_ARRAY_MAX) {
+		size_t capacity = page->capacity * 2;
+		if (capacity > BITSET_PAGE_ARRAY_MAX)
+			capacity = BITSET_PAGE_ARRAY_MAX;
+		new_page = tt_bitset_page_array_new(bitset, page->first_pos,
+						    capacity);
+		if (new_page == NULL)
+			return NULL;
+		memcpy(tt_bitset_page_array(new_page), array,
+		       page->cardinality * sizeof(*array));
+	} else {
+		new_page = tt_bitset_page_bitmap_new(bitset, page->first_pos);
+		if (new_page == NULL)
+			return NULL;
+		void *data = tt_bitset_page_data(new_page);
+		for (size_t i = 0; i < page->cardinality; i++)
+			bit_set(data, array[i]);
+	}
+	new_page->cardinality = page->cardinality;
+	tt_bitset_page_replace(bitset, page, new_page);
+	return new_page;
+}
+
+/**
+ * Replace a bitmap page that has few bits left with a sparse page.
+ * On memory error the bitmap page is kept, it is still valid.
+ */
+static void
+tt_bitset_page_shrink(struct tt_bitset *bitset, struct tt_bitset_page *page)
+{
+	assert(!tt_bitset_page_is_array(page));
+	assert(page->cardinality <= BITSET_PAGE_ARRAY_MAX / 2);
+
+	struct tt_bitset_page *new_page = tt_bitset_page_array_new(bitset,
+			page->first_pos, BITSET_PAGE_ARRAY_MAX / 2);
+	if (new_page == NULL)
+		return;
+
+	uint16_t *array = tt_bitset_page_array(new_page);
+	struct bit_iterator it;
+	bit_iterator_init(&it, tt_bitset_page_data(page),
+			  BITSET_PAGE_DATA_SIZE, true);
+	size_t pos;
+	while ((pos = bit_iterator_next(&it)) != SIZE_MAX)
+		array[new_page->cardinality++] = pos;
+	tt_bitset_page_replace(bitset, page, new_page);
+}
+
 bool
 tt_bitset_test(struct tt_bitset *bitset, size_t pos)
 {
@@ -80,7 +189,7 @@ tt_bitset_test(struct tt_bitset *bitset, size_t pos)
 
 	assert(page->first_pos <= pos && pos < page->first_pos +
 	       BITSET_PAGE_DATA_SIZE * CHAR_BIT);
-	return bit_test(tt_bitset_page_data(page), pos - page->first_pos);
+	return tt_bitset_page_test(page, pos - page->first_pos);
 }
 
 int
@@ -93,23 +202,40 @@ tt_bitset_set(struct tt_bitset *bitset, size_t pos)
 	struct tt_bitset_page *page =
 		tt_bitset_pages_search(&bitset->pages, &key);
 	if (page == NULL) {
-		/* Allocate a new page */
-		size_t size = tt_bitset_page_alloc_size(bitset->realloc);
-		page = bitset->realloc(NULL, size);
+		/* Allocate a new page, it is sparse until it fills up */
+		page = tt_bitset_page_array_new(bitset, key.first_pos,
+						BITSET_PAGE_ARRAY_MIN);
 		if (page == NULL)
 			return -1;
 
-		tt_bitset_page_create(page);
-		page->first_pos = key.first_pos;
-
 		/* Insert the page into pages tree */
 		tt_bitset_pages_insert(&bitset->pages, page);
 	}
 
 	assert(page->first_pos <= pos && pos < page->first_pos +
 	       BITSET_PAGE_DATA_SIZE * CHAR_BIT);
-	bool prev = bit_set(tt_bitset_page_data(page), pos - page->first_pos);
-	if (prev) {
+	size_t offset = pos - page->first_pos;
+	if (tt_bitset_page_is_array(page)) {
+		size_t i = tt_bitset_page_array_lower_bound(page, offset);
+		if (i < page->cardinality &&
+		    tt_bitset_page_array(page)[i] == offset) {
+			/* Value has not changed */
+			return 1;
+		}
+		if (page->cardinality == page->capacity) {
+			page = tt_bitset_page_expand(bitset, page);
+			if (page == NULL)
+				return -1;
+		}
+		if (tt_bitset_page_is_array(page)) {
+			uint16_t *array = tt_bitset_page_array(page);
+			memmove(array + i + 1, array + i,
+				(page->cardinality - i) * sizeof(*array));
+			array[i] = offset;
+		} else {
+			bit_set(tt_bitset_page_data(page), offset);
+		}
+	} else if (bit_set(tt_bitset_page_data(page), offset)) {
 		/* Value has not changed */
 		return 1;
 	}
@@ -134,8 +260,15 @@ tt_bitset_clear(struct tt_bitset *bitset, size_t pos)
 
 	assert(page->first_pos <= pos && pos < page->first_pos +
 	       BITSET_PAGE_DATA_SIZE * CHAR_BIT);
-	bool prev = bit_clear(tt_bitset_page_data(page), pos - page->first_pos);
-	if (!prev) {
+	size_t offset = pos - page->first_pos;
+	if (tt_bitset_page_is_array(page)) {
+		uint16_t *array = tt_bitset_page_array(page);
+		size_t i = tt_bitset_page_array_lower_bound(page, offset);
+		if (i == page->cardinality || array[i] != offset)
+			return 0;
+		memmove(array + i, array + i + 1,
+			(page->cardinality - i - 1) * sizeof(*array));
+	} else if (!bit_clear(tt_bitset_page_data(page), offset)) {
 		return 0;
 	}
 
@@ -150,6 +283,9 @@ tt_bitset_clear(struct tt_bitset *bitset, size_t pos)
 		/* Free the page */
 		tt_bitset_page_destroy(page);
 		bitset->realloc(page, 0);
+	} else if (!tt_bitset_page_is_array(page) &&
+		   page->cardinality <= BITSET_PAGE_ARRAY_MAX / 2) {
+		tt_bitset_page_shrink(bitset, page);
 	}
 
 	return 1;
@@ -170,6 +306,13 @@ tt_bitset_info(struct tt_bitset *bitset, struct tt_bitset_info *info)
 	struct tt_bitset_page *page = tt_bitset_pages_first(&bitset->pages);
 	while (page != NULL) {
 		info->pages++;
+		if (tt_bitset_page_is_array(page)) {
+			info->array_pages++;
+			info->mem_total +=
+				tt_bitset_page_array_alloc_size(page->capacity);
+		} else {
+			info->mem_total += info->page_total_size;
+		}
 		cardinality_check += page->cardinality;
 		page = tt_bitset_pages_next(&bitset->pages, page);
 	}
@@ -68,7 +68,12 @@ extern "C" {
 struct tt_bitset_page {
 	size_t first_pos;
 	rb_node(struct tt_bitset_page) node;
-	size_t cardinality;
+	uint32_t cardinality;
+	/**
+	 * Number of offsets a sparse page has room for, or 0 if
+	 * the page is a bitmap.
+	 */
+	uint32_t capacity;
 	uint8_t data[];
 };
 
@@ -151,10 +156,17 @@ tt_bitset_cardinality(const struct tt_bitset *bitset) {
 struct tt_bitset_info {
 	/** Number of allocated pages */
 	size_t pages;
-	/** Data (payload) size of one page (in bytes) */
+	/** Number of sparse pages (storing offsets instead of bitmaps) */
+	size_t array_pages;
+	/** Data (payload) size of one bitmap page (in bytes) */
 	size_t page_data_size;
-	/** Full size of one page (in bytes, including padding and tree data) */
+	/**
+	 * Full size of one bitmap page (in bytes, including padding and
+	 * tree data)
+	 */
 	size_t page_total_size;
+	/** Memory used by all pages (in bytes) */
+	size_t mem_total;
 	/** A multiplier by which an address of page data is aligned **/
 	size_t page_data_alignment;
 };
@@ -386,7 +386,7 @@ tt_bitset_index_bsize(const struct tt_bitset_index *index)
 			continue;
 		struct tt_bitset_info info;
 		tt_bitset_info(index->bitsets[b], &info);
-		result += info.page_total_size * info.pages;
+		result += info.mem_total;
 	}
 	return result;
 }
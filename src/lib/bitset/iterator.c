@@ -302,6 +302,27 @@ tt_bitset_iterator_conj_cmp(const void *p1, const void *p2)
 	}
 }
 
+/**
+ * Test bit @a offset of the current page of a conjunction.
+ */
+static bool
+tt_bitset_iterator_conj_test(struct tt_bitset_iterator_conj *conj,
+			     size_t offset)
+{
+	for (size_t b = 0; b < conj->size; b++) {
+		struct tt_bitset_page *page = conj->pages[b];
+		if (!conj->pre_nots[b]) {
+			if (!tt_bitset_page_test(page, offset))
+				return false;
+		} else if (page != NULL &&
+			   page->first_pos == conj->page_first_pos &&
+			   tt_bitset_page_test(page, offset)) {
+			return false;
+		}
+	}
+	return true;
+}
+
 static void
 tt_bitset_iterator_conj_prepare_page(struct tt_bitset_iterator_conj *conj,
 				     struct tt_bitset_page *dst)
@@ -311,6 +332,30 @@ tt_bitset_iterator_conj_prepare_page(struct tt_bitset_iterator_conj *conj,
 	assert(conj->size > 0);
 	assert(conj->page_first_pos != SIZE_MAX);
 
+	/*
+	 * If one of the pages is sparse, the result has no bits
+	 * beyond its offsets. Test only them instead of ANDing
+	 * whole pages.
+	 */
+	struct tt_bitset_page *sparse = NULL;
+	for (size_t b = 0; b < conj->size; b++) {
+		struct tt_bitset_page *page = conj->pages[b];
+		if (conj->pre_nots[b] || !tt_bitset_page_is_array(page))
+			continue;
+		if (sparse == NULL || page->cardinality < sparse->cardinality)
+			sparse = page;
+	}
+	if (sparse != NULL) {
+		tt_bitset_page_set_zeros(dst);
+		void *data = tt_bitset_page_data(dst);
+		uint16_t *array = tt_bitset_page_array(sparse);
+		for (size_t i = 0; i < sparse->cardinality; i++) {
+			if (tt_bitset_iterator_conj_test(conj, array[i]))
+				bit_set(data, array[i]);
+		}
+		return;
+	}
+
 	tt_bitset_page_set_ones(dst);
 	for (size_t b = 0; b < conj->size; b++) {
 		if (!conj->pre_nots[b]) {
@@ -38,6 +38,21 @@ tt_bitset_page_alloc_size(void *(*realloc_arg)(void *ptr, size_t size));
 extern inline void *
 tt_bitset_page_data(struct tt_bitset_page *page);
 
+extern inline bool
+tt_bitset_page_is_array(const struct tt_bitset_page *page);
+
+extern inline uint16_t *
+tt_bitset_page_array(struct tt_bitset_page *page);
+
+extern inline size_t
+tt_bitset_page_array_alloc_size(size_t capacity);
+
+extern inline size_t
+tt_bitset_page_array_lower_bound(struct tt_bitset_page *page, size_t offset);
+
+extern inline bool
+tt_bitset_page_test(struct tt_bitset_page *page, size_t offset);
+
 extern inline void
 tt_bitset_page_create(struct tt_bitset_page *page);
 
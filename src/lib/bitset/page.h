@@ -55,7 +55,16 @@ extern "C" {
 
 enum {
 	/** How many bytes to store in one page */
-	BITSET_PAGE_DATA_SIZE = 160
+	BITSET_PAGE_DATA_SIZE = 160,
+	/**
+	 * Max number of set bits in a sparse page. A sparse page
+	 * stores the sorted offsets of its set bits instead of a
+	 * bitmap, so it is smaller than a bitmap page until it has
+	 * BITSET_PAGE_DATA_SIZE / 2 bits set.
+	 */
+	BITSET_PAGE_ARRAY_MAX = 64,
+	/** Capacity of a new sparse page */
+	BITSET_PAGE_ARRAY_MIN = 4,
 };
 
 #if defined(ENABLE_AVX)
@@ -114,6 +123,60 @@ tt_bitset_page_data(struct tt_bitset_page *page)
 	return (void *) (r & ~((uintptr_t) BITSET_PAGE_DATA_ALIGNMENT - 1));
 }
 
+inline bool
+tt_bitset_page_is_array(const struct tt_bitset_page *page)
+{
+	return page->capacity > 0;
+}
+
+inline uint16_t *
+tt_bitset_page_array(struct tt_bitset_page *page)
+{
+	assert(tt_bitset_page_is_array(page));
+	return (uint16_t *) page->data;
+}
+
+inline size_t
+tt_bitset_page_array_alloc_size(size_t capacity)
+{
+	return sizeof(struct tt_bitset_page) + capacity * sizeof(uint16_t);
+}
+
+/**
+ * Return the index of the first offset in a sparse page that is
+ * not less than @a offset.
+ */
+inline size_t
+tt_bitset_page_array_lower_bound(struct tt_bitset_page *page, size_t offset)
+{
+	uint16_t *array = tt_bitset_page_array(page);
+	size_t lo = 0;
+	size_t hi = page->cardinality;
+	while (lo < hi) {
+		size_t mid = lo + (hi - lo) / 2;
+		if (array[mid] < offset)
+			lo = mid + 1;
+		else
+			hi = mid;
+	}
+	return lo;
+}
+
+/**
+ * Test bit @a offset of a page of any kind.
+ */
+inline bool
+tt_bitset_page_test(struct tt_bitset_page *page, size_t offset)
+{
+	if (!tt_bitset_page_is_array(page))
+		return bit_test(tt_bitset_page_data(page), offset);
+	size_t i = tt_bitset_page_array_lower_bound(page, offset);
+	return i < page->cardinality && tt_bitset_page_array(page)[i] == offset;
+}
+
+/**
+ * Create a bitmap page with all bits cleared.
+ */
 inline void
 tt_bitset_page_create(struct tt_bitset_page *page)
 {
@@ -151,6 +214,22 @@ tt_bitset_page_set_ones(struct tt_bitset_page *page)
 inline void
 tt_bitset_page_and(struct tt_bitset_page *dst, struct tt_bitset_page *src)
 {
+	assert(!tt_bitset_page_is_array(dst));
+	if (tt_bitset_page_is_array(src)) {
+		void *data = tt_bitset_page_data(dst);
+		uint16_t *array = tt_bitset_page_array(src);
+		uint16_t offsets[BITSET_PAGE_ARRAY_MAX];
+		size_t count = 0;
+		for (size_t i = 0; i < src->cardinality; i++) {
+			if (bit_test(data, array[i]))
+				offsets[count++] = array[i];
+		}
+		memset(data, 0, BITSET_PAGE_DATA_SIZE);
+		for (size_t i = 0; i < count; i++)
+			bit_set(data, offsets[i]);
+		return;
+	}
+
 	tt_bitset_word_t *d = (tt_bitset_word_t *) tt_bitset_page_data(dst);
 	tt_bitset_word_t *s = (tt_bitset_word_t *) tt_bitset_page_data(src);
 
@@ -164,6 +243,15 @@ tt_bitset_page_and(struct tt_bitset_page *dst, struct tt_bitset_page *src)
 inline void
 tt_bitset_page_nand(struct tt_bitset_page *dst, struct tt_bitset_page *src)
 {
+	assert(!tt_bitset_page_is_array(dst));
+	if (tt_bitset_page_is_array(src)) {
+		void *data = tt_bitset_page_data(dst);
+		uint16_t *array = tt_bitset_page_array(src);
+		for (size_t i = 0; i < src->cardinality; i++)
+			bit_clear(data, array[i]);
+		return;
+	}
+
 	tt_bitset_word_t *d = (tt_bitset_word_t *) tt_bitset_page_data(dst);
 	tt_bitset_word_t *s = (tt_bitset_word_t *) tt_bitset_page_data(src);
 
@@ -177,6 +265,15 @@ tt_bitset_page_nand(struct tt_bitset_page *dst, struct tt_bitset_page *src)
 inline void
 tt_bitset_page_or(struct tt_bitset_page *dst, struct tt_bitset_page *src)
 {
+	assert(!tt_bitset_page_is_array(dst));
+	if (tt_bitset_page_is_array(src)) {
+		void *data = tt_bitset_page_data(dst);
+		uint16_t *array = tt_bitset_page_array(src);
+		for (size_t i = 0; i < src->cardinality; i++)
+			bit_set(data, array[i]);
+		return;
+	}
+
 	tt_bitset_word_t *d = (tt_bitset_word_t *) tt_bitset_page_data(dst);
 	tt_bitset_word_t *s = (tt_bitset_word_t *) tt_bitset_page_data(src);
 
@@ -74,29 +74,170 @@ static struct mh_coll_t *coll_cache = NULL;
 static_assert(COLL_LOCALE_LEN_MAX <= TT_STATIC_BUF_LEN,
 	      "static buf is used to 0-terminate locale name");
 
-/** Compare two string using ICU collation. */
+/** Compare two UTF-8 strings with an ICU collator. */
 static int
-coll_icu_cmp(const char *s, size_t slen, const char *t, size_t tlen,
-	     const struct coll *coll)
+coll_icu_collator_cmp(const struct UCollator *collator,
+		      const char *s, size_t slen, const char *t, size_t tlen)
 {
-	assert(coll->collator != NULL);
-
 	UErrorCode status = U_ZERO_ERROR;
 
 #ifdef HAVE_ICU_STRCOLLUTF8
-	UCollationResult result = ucol_strcollUTF8(coll->collator, s, slen, t,
+	UCollationResult result = ucol_strcollUTF8(collator, s, slen, t,
 						   tlen, &status);
 #else
 	UCharIterator s_iter, t_iter;
 	uiter_setUTF8(&s_iter, s, slen);
 	uiter_setUTF8(&t_iter, t, tlen);
-	UCollationResult result = ucol_strcollIter(coll->collator, &s_iter,
+	UCollationResult result = ucol_strcollIter(collator, &s_iter,
 						   &t_iter, &status);
 #endif
 	assert(!U_FAILURE(status));
 	return (int)result;
 }
 
+/** Compare two string using ICU collation. */
+static int
+coll_icu_cmp(const char *s, size_t slen, const char *t, size_t tlen,
+	     const struct coll *coll)
+{
+	assert(coll->collator != NULL);
+	return coll_icu_collator_cmp(coll->collator, s, slen, t, tlen);
+}
+
+/** First and last printable ASCII characters. */
+enum { COLL_ASCII_MIN = 0x20, COLL_ASCII_MAX = 0x7e };
+
+/** Return true if a string consists of printable ASCII characters. */
+static inline bool
+coll_is_printable_ascii(const char *s, size_t len)
+{
+	for (size_t i = 0; i < len; i++) {
+		unsigned char c = s[i];
+		if (c < COLL_ASCII_MIN || c > COLL_ASCII_MAX)
+			return false;
+	}
+	return true;
+}
+
+/**
+ * Compare two strings using ICU collation, with a fast path for
+ * strings of printable ASCII characters. In the root locale with
+ * the default attributes, these characters have no contractions or
+ * expansions, no secondary differences, and the only tertiary
+ * difference is the case. So such strings are compared as UCA does:
+ * the primary ranks of all characters first, then, if the strength
+ * is tertiary, the tertiary ranks.
+ *
+ * The strings are checked as a whole: a non-ASCII character can
+ * change the weight of the ASCII one before it, e.g. '=' followed
+ * by U+0338 is canonically equivalent to U+2260.
+ */
+static int
+coll_icu_ascii_cmp(const char *s, size_t slen, const char *t, size_t tlen,
+		   const struct coll *coll)
+{
+	assert(coll->has_ascii_weights);
+	if (!coll_is_printable_ascii(s, slen) ||
+	    !coll_is_printable_ascii(t, tlen))
+		return coll_icu_cmp(s, slen, t, tlen, coll);
+	int tertiary = 0;
+	size_t len = slen < tlen ? slen : tlen;
+	for (size_t i = 0; i < len; i++) {
+		unsigned char a = s[i];
+		unsigned char b = t[i];
+		if (a == b)
+			continue;
+		int primary = (int)coll->ascii_primary[a] -
+			      (int)coll->ascii_primary[b];
+		if (primary != 0)
+			return primary < 0 ? -1 : 1;
+		if (tertiary == 0)
+			tertiary = (int)coll->ascii_tertiary[a] -
+				   (int)coll->ascii_tertiary[b];
+	}
+	if (slen != tlen)
+		return slen < tlen ? -1 : 1;
+	if (!coll->is_ascii_case_sensitive || tertiary == 0)
+		return 0;
+	return tertiary < 0 ? -1 : 1;
+}
+
+/**
+ * Fill @a ranks with ranks of printable ASCII characters in the
+ * order defined by @a collator. Equal characters get equal ranks.
+ */
+static void
+coll_icu_rank_ascii(const struct UCollator *collator, uint8_t *ranks)
+{
+	char chars[COLL_ASCII_MAX - COLL_ASCII_MIN + 1];
+	int count = 0;
+	/* Insertion sort: there are fewer than a hundred chars. */
+	for (char c = COLL_ASCII_MIN; c <= COLL_ASCII_MAX; c++) {
+		int i = count++;
+		while (i > 0 && coll_icu_collator_cmp(collator, &chars[i - 1],
+						      1, &c, 1) > 0) {
+			chars[i] = chars[i - 1];
+			i--;
+		}
+		chars[i] = c;
+	}
+	uint8_t rank = 1;
+	ranks[(unsigned char)chars[0]] = rank;
+	for (int i = 1; i < count; i++) {
+		if (coll_icu_collator_cmp(collator, &chars[i - 1], 1,
+					  &chars[i], 1) != 0)
+			rank++;
+		ranks[(unsigned char)chars[i]] = rank;
+	}
+}
+
+/**
+ * Set up the ASCII fast path of a collation if its definition
+ * allows it, see coll_icu_ascii_cmp().
+ * @retval  0 Success, the fast path may be disabled.
+ * @retval -1 Collation error.
+ */
+static int
+coll_icu_init_ascii(struct coll *coll, const struct coll_def *def)
+{
+	coll->has_ascii_weights = false;
+	const struct coll_icu_def *icu = &def->icu;
+	if (def->locale[0] != '\0' ||
+	    icu->french_collation != COLL_ICU_DEFAULT ||
+	    icu->alternate_handling != COLL_ICU_AH_DEFAULT ||
+	    icu->case_first != COLL_ICU_CF_DEFAULT ||
+	    icu->case_level != COLL_ICU_DEFAULT ||
+	    icu->normalization_mode != COLL_ICU_DEFAULT ||
+	    icu->numeric_collation != COLL_ICU_DEFAULT ||
+	    icu->strength == COLL_ICU_STRENGTH_QUATERNARY ||
+	    icu->strength == COLL_ICU_STRENGTH_IDENTICAL)
+		return 0;
+
+	UErrorCode status = U_ZERO_ERROR;
+	struct UCollator *primary = ucol_open("", &status);
+	if (U_FAILURE(status)) {
+		diag_set(CollationError, u_errorName(status));
+		return -1;
+	}
+	ucol_setStrength(primary, UCOL_PRIMARY);
+	coll_icu_rank_ascii(primary, coll->ascii_primary);
+	ucol_close(primary);
+
+	struct UCollator *tertiary = ucol_open("", &status);
+	if (U_FAILURE(status)) {
+		diag_set(CollationError, u_errorName(status));
+		return -1;
+	}
+	ucol_setStrength(tertiary, UCOL_TERTIARY);
+	coll_icu_rank_ascii(tertiary, coll->ascii_tertiary);
+	ucol_close(tertiary);
+
+	coll->is_ascii_case_sensitive =
+		ucol_getStrength(coll->collator) >= UCOL_TERTIARY;
+	coll->has_ascii_weights = true;
+	return 0;
+}
+
 static int
 coll_bin_cmp(const char *s, size_t slen, const char *t, size_t tlen,
 	     const struct coll *coll)
@@ -269,7 +410,10 @@ coll_icu_init_cmp(struct coll *coll, const struct coll_def *def)
 			return -1;
 		}
 	}
-	coll->cmp = coll_icu_cmp;
+	if (coll_icu_init_ascii(coll, def) != 0)
+		return -1;
+	coll->cmp = coll->has_ascii_weights ? coll_icu_ascii_cmp :
+					      coll_icu_cmp;
 	coll->hash = coll_icu_hash;
 	coll->hint = coll_icu_hint;
 	return 0;
@@ -384,6 +528,7 @@ coll_new(const struct coll_def *def)
 		break;
 	case COLL_TYPE_BINARY:
 		coll->collator = NULL;
+		coll->has_ascii_weights = false;
 		coll->cmp = coll_bin_cmp;
 		coll->hash = coll_bin_hash;
 		coll->hint = coll_bin_hint;
@@ -79,6 +79,21 @@ struct coll {
 	 * copied. Sort keys may be compared using strcmp().
 	 */
 	coll_hint_f hint;
+	/**
+	 * Set if strings of printable ASCII characters are
+	 * compared with @ascii_primary and @ascii_tertiary
+	 * instead of ICU.
+	 */
+	bool has_ascii_weights;
+	/** Set if @ascii_tertiary is used, i.e. case matters. */
+	bool is_ascii_case_sensitive;
+	/**
+	 * Ranks of printable ASCII characters in the collation
+	 * at the primary strength, e.g. 'a' and 'A' are equal.
+	 */
+	uint8_t ascii_primary[128];
+	/** Same as @ascii_primary, but at the tertiary strength. */
+	uint8_t ascii_tertiary[128];
 	/** Reference counter. */
 	int refs;
 	/**
@@ -31,6 +31,8 @@
 #include "cbus.h"
 
 #include <limits.h>
+#include <stdlib.h>
+#include <pmatomic.h>
 #include "fiber.h"
 #include "trigger.h"
 
@@ -83,14 +85,61 @@ cbus_find_endpoint(struct cbus *bus, const char *name)
 	return endpoint;
 }
 
+enum {
+	/** Number of slots in a pipe ring, must be a power of two. */
+	CPIPE_RING_SIZE = 1024,
+	/**
+	 * Number of event loop iterations the consumer keeps polling
+	 * the rings for after they have been drained.
+	 */
+	CBUS_RING_POLL_COUNT = 64,
+};
+
+/**
+ * Single-producer single-consumer queue of messages of a pipe.
+ * The producer and the consumer indexes are kept in separate
+ * cache lines so that they don't bounce between the cords.
+ *
+ * One slot is always kept free for the poison message, see
+ * cpipe_destroy_ring().
+ */
+struct cpipe_ring {
+	/** Index of the next message to fetch. */
+	alignas(CACHELINE_SIZE) unsigned head;
+	/** Link in cbus_endpoint::rings. */
+	struct rlist in_endpoint;
+	/** Index of the next free slot. */
+	alignas(CACHELINE_SIZE) unsigned tail;
+	/** The last value of head seen by the producer. */
+	unsigned cached_head;
+	/**
+	 * Retries flushing the pipe input on each event loop
+	 * iteration of the producer while the ring is full.
+	 */
+	struct ev_check retry;
+	/** Keeps the producer event loop from blocking meanwhile. */
+	struct ev_idle spin;
+	alignas(CACHELINE_SIZE) struct cmsg *msgs[CPIPE_RING_SIZE];
+};
+
 static void
 cpipe_flush_cb(ev_loop * /* loop */, struct ev_async *watcher,
 	       int /* events */);
 
+/** Callback of idle watchers that only keep an event loop spinning. */
+static void
+cbus_spin_cb(ev_loop *loop, struct ev_idle *watcher, int events)
+{
+	(void)loop;
+	(void)watcher;
+	(void)events;
+}
+
 void
 cpipe_create(struct cpipe *pipe, const char *consumer)
 {
 	stailq_create(&pipe->input);
+	pipe->ring = NULL;
 
 	pipe->n_input = 0;
 	pipe->max_input = INT_MAX;
@@ -112,15 +161,58 @@ cpipe_create(struct cpipe *pipe, const char *consumer)
 	tt_pthread_mutex_unlock(&cbus.mutex);
 }
 
+static void
+cpipe_ring_retry_cb(ev_loop *loop, struct ev_check *watcher, int events)
+{
+	(void)events;
+	struct cpipe *pipe = (struct cpipe *)watcher->data;
+	ev_invoke(loop, &pipe->flush_input, EV_CUSTOM);
+}
+
+void
+cpipe_create_ring(struct cpipe *pipe, const char *consumer)
+{
+	cpipe_create(pipe, consumer);
+	struct cpipe_ring *ring = (struct cpipe_ring *)
+		xalloc_impl(sizeof(*ring), aligned_alloc,
+			    CACHELINE_SIZE, sizeof(*ring));
+	ring->head = 0;
+	ring->tail = 0;
+	ring->cached_head = 0;
+	ev_check_init(&ring->retry, cpipe_ring_retry_cb);
+	ring->retry.data = pipe;
+	ev_idle_init(&ring->spin, cbus_spin_cb);
+	pipe->ring = ring;
+
+	struct cbus_endpoint *endpoint = pipe->endpoint;
+	tt_pthread_mutex_lock(&endpoint->mutex);
+	rlist_add_tail_entry(&endpoint->rings, ring, in_endpoint);
+	tt_pthread_mutex_unlock(&endpoint->mutex);
+}
+
 struct cmsg_poison {
 	struct cmsg msg;
 	struct cbus_endpoint *endpoint;
+	/** Ring of the destroyed pipe or NULL. */
+	struct cpipe_ring *ring;
+	/**
+	 * Messages of the destroyed pipe that didn't fit in
+	 * the ring. They are fetched right before the poison.
+	 */
+	struct stailq leftover;
 };
 
 static void
 cbus_endpoint_poison_f(struct cmsg *msg)
 {
-	struct cbus_endpoint *endpoint = ((struct cmsg_poison *)msg)->endpoint;
+	struct cmsg_poison *poison = (struct cmsg_poison *)msg;
+	struct cbus_endpoint *endpoint = poison->endpoint;
+	if (poison->ring != NULL) {
+		tt_pthread_mutex_lock(&endpoint->mutex);
+		rlist_del_entry(poison->ring, in_endpoint);
+		tt_pthread_mutex_unlock(&endpoint->mutex);
+		free(poison->ring);
+	}
 	tt_pthread_mutex_lock(&cbus.mutex);
 	assert(endpoint->n_pipes > 0);
 	--endpoint->n_pipes;
@@ -129,6 +221,95 @@ cbus_endpoint_poison_f(struct cmsg *msg)
 	free(msg);
 }
 
+static const struct cmsg_hop cbus_poison_route[1] = {
+	{cbus_endpoint_poison_f, NULL}
+};
+
+/**
+ * Move as many messages from the pipe input to its ring as fit.
+ * Must be called by the producer.
+ */
+static void
+cpipe_ring_put(struct cpipe *pipe)
+{
+	struct cpipe_ring *ring = pipe->ring;
+	unsigned tail = ring->tail;
+	while (!stailq_empty(&pipe->input)) {
+		if (tail - ring->cached_head >= CPIPE_RING_SIZE - 1) {
+			ring->cached_head = pm_atomic_load_explicit(
+				&ring->head, pm_memory_order_acquire);
+			if (tail - ring->cached_head >= CPIPE_RING_SIZE - 1)
+				break;
+		}
+		ring->msgs[tail % CPIPE_RING_SIZE] =
+			stailq_shift_entry(&pipe->input, struct cmsg, fifo);
+		pipe->n_input--;
+		tail++;
+	}
+	/*
+	 * Sequentially consistent so as not to be reordered with
+	 * the is_sleeping check, see cbus_endpoint_ring_poll_cb().
+	 */
+	pm_atomic_store(&ring->tail, tail);
+}
+
+/** Flush the pipe input to the ring, see cpipe_flush_cb(). */
+static void
+cpipe_flush_ring(struct cpipe *pipe)
+{
+	struct cpipe_ring *ring = pipe->ring;
+	struct cbus_endpoint *endpoint = pipe->endpoint;
+	cpipe_ring_put(pipe);
+	/* Wake up the consumer only if it has stopped polling. */
+	if (pm_atomic_load(&endpoint->is_sleeping) &&
+	    pm_atomic_exchange(&endpoint->is_sleeping, false)) {
+		rmean_collect(cbus.stats, CBUS_STAT_EVENTS, 1);
+		/* See the comment in cpipe_flush_cb(). */
+		int old_cancel_state;
+		tt_pthread_setcancelstate(PTHREAD_CANCEL_DISABLE,
+					  &old_cancel_state);
+		ev_async_send(endpoint->consumer, &endpoint->async);
+		tt_pthread_setcancelstate(old_cancel_state, NULL);
+	}
+	if (pipe->n_input > 0) {
+		/* The ring is full, retry until there's room. */
+		ev_check_start(pipe->producer, &ring->retry);
+		ev_idle_start(pipe->producer, &ring->spin);
+	} else {
+		ev_check_stop(pipe->producer, &ring->retry);
+		ev_idle_stop(pipe->producer, &ring->spin);
+	}
+}
+
+/**
+ * Flush the pipe input to the ring and put the poison after it.
+ * The poison always fits in the ring, because one slot is kept
+ * free for it, and carries the messages that don't fit.
+ */
+static void
+cpipe_destroy_ring(struct cpipe *pipe, struct cmsg_poison *poison)
+{
+	struct cpipe_ring *ring = pipe->ring;
+	struct cbus_endpoint *endpoint = pipe->endpoint;
+	ev_check_stop(pipe->producer, &ring->retry);
+	ev_idle_stop(pipe->producer, &ring->spin);
+	cpipe_ring_put(pipe);
+	stailq_concat(&poison->leftover, &pipe->input);
+	pipe->n_input = 0;
+	/*
+	 * Hold the lock while sending the async, because the
+	 * endpoint may disappear as soon as the poison is
+	 * fetched, which is done under the lock.
+	 */
+	tt_pthread_mutex_lock(&endpoint->mutex);
+	ring->msgs[ring->tail % CPIPE_RING_SIZE] = &poison->msg;
+	pm_atomic_store(&ring->tail, ring->tail + 1);
+	pm_atomic_store(&endpoint->is_sleeping, false);
+	rmean_collect(cbus.stats, CBUS_STAT_EVENTS, 1);
+	ev_async_send(endpoint->consumer, &endpoint->async);
+	tt_pthread_mutex_unlock(&endpoint->mutex);
+}
+
 void
 cpipe_destroy(struct cpipe *pipe)
 {
@@ -141,37 +322,39 @@ cpipe_destroy(struct cpipe *pipe)
 
 	ev_async_stop(pipe->producer, &pipe->flush_input);
 
-	static const struct cmsg_hop route[1] = {
-		{cbus_endpoint_poison_f, NULL}
-	};
 	trigger_destroy(&pipe->on_flush);
 
 	struct cbus_endpoint *endpoint = pipe->endpoint;
 	struct cmsg_poison *poison = malloc(sizeof(struct cmsg_poison));
-	cmsg_init(&poison->msg, route);
+	cmsg_init(&poison->msg, cbus_poison_route);
 	poison->endpoint = pipe->endpoint;
-	/*
-	 * Avoid the general purpose cpipe_push_input() since
-	 * we want to control the way the poison message is
-	 * delivered.
-	 */
-	tt_pthread_mutex_lock(&endpoint->mutex);
-	/* Flush input */
-	stailq_concat(&endpoint->output, &pipe->input);
-	pipe->n_input = 0;
-	/* Add the pipe shutdown message as the last one. */
-	stailq_add_tail_entry(&endpoint->output, poison, msg.fifo);
-	/* Count statistics */
-	rmean_collect(cbus.stats, CBUS_STAT_EVENTS, 1);
-	/*
-	 * Keep the lock for the duration of ev_async_send():
-	 * this will avoid a race condition between
-	 * ev_async_send() and execution of the poison
-	 * message, after which the endpoint may disappear.
-	 */
-	ev_async_send(endpoint->consumer, &endpoint->async);
-	tt_pthread_mutex_unlock(&endpoint->mutex);
-
+	poison->ring = pipe->ring;
+	stailq_create(&poison->leftover);
+	if (pipe->ring != NULL) {
+		cpipe_destroy_ring(pipe, poison);
+	} else {
+		/*
+		 * Avoid the general purpose cpipe_push_input() since
+		 * we want to control the way the poison message is
+		 * delivered.
+		 */
+		tt_pthread_mutex_lock(&endpoint->mutex);
+		/* Flush input */
+		stailq_concat(&endpoint->output, &pipe->input);
+		pipe->n_input = 0;
+		/* Add the pipe shutdown message as the last one. */
+		stailq_add_tail_entry(&endpoint->output, poison, msg.fifo);
+		/* Count statistics */
+		rmean_collect(cbus.stats, CBUS_STAT_EVENTS, 1);
+		/*
+		 * Keep the lock for the duration of ev_async_send():
+		 * this will avoid a race condition between
+		 * ev_async_send() and execution of the poison
+		 * message, after which the endpoint may disappear.
+		 */
+		ev_async_send(endpoint->consumer, &endpoint->async);
+		tt_pthread_mutex_unlock(&endpoint->mutex);
+	}
 	tt_pthread_setcancelstate(old_cancel_state, NULL);
 
 	TRASH(pipe);
@@ -206,6 +389,104 @@ cbus_destroy(struct cbus *bus)
 	rmean_delete(bus->stats);
 }
 
+/**
+ * Move the messages fetched from the rings of the endpoint to
+ * output. Must be called under the endpoint mutex.
+ * Returns true if any messages were fetched.
+ */
+static bool
+cbus_endpoint_fetch_rings(struct cbus_endpoint *endpoint,
+			  struct stailq *output)
+{
+	bool found = false;
+	struct cpipe_ring *ring;
+	rlist_foreach_entry(ring, &endpoint->rings, in_endpoint) {
+		unsigned head = ring->head;
+		unsigned tail = pm_atomic_load_explicit(
+			&ring->tail, pm_memory_order_acquire);
+		if (head == tail)
+			continue;
+		found = true;
+		for (; head != tail; head++) {
+			struct cmsg *msg = ring->msgs[head % CPIPE_RING_SIZE];
+			if (msg->route == cbus_poison_route) {
+				/* The pipe is destroyed, see cmsg_poison. */
+				struct cmsg_poison *poison =
+					(struct cmsg_poison *)msg;
+				stailq_concat(output, &poison->leftover);
+			}
+			stailq_add_tail_entry(output, msg, fifo);
+		}
+		pm_atomic_store_explicit(&ring->head, head,
+					 pm_memory_order_release);
+	}
+	return found;
+}
+
+/** Check if there are messages in the rings of the endpoint. */
+static bool
+cbus_endpoint_has_ring_input(struct cbus_endpoint *endpoint)
+{
+	bool found = false;
+	tt_pthread_mutex_lock(&endpoint->mutex);
+	struct cpipe_ring *ring;
+	rlist_foreach_entry(ring, &endpoint->rings, in_endpoint) {
+		if (ring->head != pm_atomic_load(&ring->tail)) {
+			found = true;
+			break;
+		}
+	}
+	tt_pthread_mutex_unlock(&endpoint->mutex);
+	return found;
+}
+
+/**
+ * Poll the rings after each event loop iteration of the consumer.
+ * If there are new messages, notify the consumer as if it got
+ * the async. Once the rings have been empty for a while, go to
+ * sleep: from now on, the producers send the async.
+ */
+static void
+cbus_endpoint_ring_poll_cb(ev_loop *loop, struct ev_check *watcher,
+			   int events)
+{
+	(void)events;
+	struct cbus_endpoint *endpoint = (struct cbus_endpoint *)watcher->data;
+	if (cbus_endpoint_has_ring_input(endpoint)) {
+		endpoint->idle_poll_count = 0;
+		ev_feed_event(loop, &endpoint->async, EV_CUSTOM);
+		return;
+	}
+	if (++endpoint->idle_poll_count < CBUS_RING_POLL_COUNT)
+		return;
+	ev_check_stop(loop, &endpoint->ring_poll);
+	ev_idle_stop(loop, &endpoint->ring_spin);
+	pm_atomic_store(&endpoint->is_sleeping, true);
+	/*
+	 * A producer could put a message before it saw the flag.
+	 * If it did see the flag, it has sent the async already.
+	 */
+	if (cbus_endpoint_has_ring_input(endpoint) &&
+	    pm_atomic_exchange(&endpoint->is_sleeping, false))
+		ev_feed_event(loop, &endpoint->async, EV_CUSTOM);
+}
+
+void
+cbus_endpoint_fetch(struct cbus_endpoint *endpoint, struct stailq *output)
+{
+	tt_pthread_mutex_lock(&endpoint->mutex);
+	stailq_concat(output, &endpoint->output);
+	bool found = cbus_endpoint_fetch_rings(endpoint, output);
+	tt_pthread_mutex_unlock(&endpoint->mutex);
+	if (found && !ev_is_active(&endpoint->ring_poll)) {
+		/* Keep polling the rings while messages are coming. */
+		pm_atomic_store(&endpoint->is_sleeping, false);
+		endpoint->idle_poll_count = 0;
+		ev_check_start(endpoint->consumer, &endpoint->ring_poll);
+		ev_idle_start(endpoint->consumer, &endpoint->ring_spin);
+	}
+}
+
 /**
  * Join a new endpoint (message consumer) to the bus. The endpoint
  * must have a unique name. Wakes up all producers (@sa cpipe_create())
@@ -232,6 +513,12 @@ cbus_endpoint_create(struct cbus_endpoint *endpoint, const char *name,
 		      (void (*)(ev_loop *, struct ev_async *, int)) fetch_cb);
 	endpoint->async.data = fetch_data;
 	ev_async_start(endpoint->consumer, &endpoint->async);
+	rlist_create(&endpoint->rings);
+	endpoint->is_sleeping = true;
+	endpoint->idle_poll_count = 0;
+	ev_check_init(&endpoint->ring_poll, cbus_endpoint_ring_poll_cb);
+	endpoint->ring_poll.data = endpoint;
+	ev_idle_init(&endpoint->ring_spin, cbus_spin_cb);
 
 	rlist_add_tail(&cbus.endpoints, &endpoint->in_cbus);
 	/*
@@ -273,6 +560,9 @@ cbus_endpoint_destroy(struct cbus_endpoint *endpoint,
 	tt_pthread_mutex_lock(&endpoint->mutex);
 	tt_pthread_mutex_unlock(&endpoint->mutex);
 	tt_pthread_mutex_destroy(&endpoint->mutex);
+	assert(rlist_empty(&endpoint->rings));
+	ev_check_stop(endpoint->consumer, &endpoint->ring_poll);
+	ev_idle_stop(endpoint->consumer, &endpoint->ring_spin);
 	ev_async_stop(endpoint->consumer, &endpoint->async);
 	fiber_cond_destroy(&endpoint->cond);
 	TRASH(endpoint);
@@ -290,6 +580,10 @@ cpipe_flush_cb(ev_loop *loop, struct ev_async *watcher, int events)
 		return;
 
 	trigger_run(&pipe->on_flush, pipe);
+	if (pipe->ring != NULL) {
+		cpipe_flush_ring(pipe);
+		return;
+	}
 	/* Trigger task processing when the queue becomes non-empty. */
 	bool output_was_empty;
 
@@ -44,6 +44,7 @@ extern "C" {
 
 struct cmsg;
 struct cpipe;
+struct cpipe_ring;
 typedef void (*cmsg_f)(struct cmsg *);
 
 enum cbus_stat_name {
@@ -140,6 +141,12 @@ struct cpipe {
 	 * is not empty.
 	 */
 	struct rlist on_flush;
+	/**
+	 * Lock-free ring the messages are flushed to instead of
+	 * the endpoint queue, see cpipe_create_ring(). NULL for
+	 * an ordinary pipe.
+	 */
+	struct cpipe_ring *ring;
 };
 
 /**
@@ -151,6 +158,18 @@ struct cpipe {
 void
 cpipe_create(struct cpipe *pipe, const char *consumer);
 
+/**
+ * Same as cpipe_create(), but the messages are passed to the
+ * consumer through a single-producer single-consumer ring, which
+ * doesn't need the endpoint mutex. Besides, the consumer keeps
+ * polling the ring for a few event loop iterations after it gets
+ * drained so that the producer needn't wake it up with ev_async
+ * while the message flow is dense. Meant for hot pipes, such as
+ * the ones between iproto and tx threads.
+ */
+void
+cpipe_create_ring(struct cpipe *pipe, const char *consumer);
+
 /**
  * Deinitialize a pipe and disconnect it from the consumer.
  * Must be called by producer. Will flash queued messages.
@@ -239,7 +258,8 @@ static inline void
 cpipe_push(struct cpipe *pipe, struct cmsg *msg)
 {
 	cpipe_push_input(pipe, msg);
-	assert(pipe->n_input < pipe->max_input);
+	/* Messages are left in a pipe if its ring is full. */
+	assert(pipe->ring != NULL || pipe->n_input < pipe->max_input);
 	if (pipe->n_input == 1)
 		ev_feed_event(pipe->producer, &pipe->flush_input, EV_CUSTOM);
 }
@@ -267,18 +287,32 @@ struct cbus_endpoint {
 	uint32_t n_pipes;
 	/** Condition for endpoint destroy */
 	struct fiber_cond cond;
+	/**
+	 * Rings of the pipes connected with cpipe_create_ring().
+	 * Protected by the mutex.
+	 */
+	struct rlist rings;
+	/**
+	 * Set if the consumer doesn't poll the rings and must be
+	 * woken up with the async when a message is put to a ring.
+	 */
+	bool is_sleeping;
+	/** Number of polls that have found the rings empty. */
+	int idle_poll_count;
+	/**
+	 * Polls the rings on each event loop iteration while the
+	 * consumer isn't sleeping.
+	 */
+	struct ev_check ring_poll;
+	/** Keeps the event loop from blocking while polling. */
+	struct ev_idle ring_spin;
 };
 
 /**
  * Fetch incomming messages to output
  */
-static inline void
-cbus_endpoint_fetch(struct cbus_endpoint *endpoint, struct stailq *output)
-{
-	tt_pthread_mutex_lock(&endpoint->mutex);
-	stailq_concat(output, &endpoint->output);
-	tt_pthread_mutex_unlock(&endpoint->mutex);
-}
+void
+cbus_endpoint_fetch(struct cbus_endpoint *endpoint, struct stailq *output);
 
 /** Initialize the global singleton bus. */
 void
@@ -34,6 +34,7 @@
 #include "say.h"
 #include "fio.h"
 #include "errinj.h"
+#include "file_reclaim.h"
 #include <stdio.h>
 #include <stdlib.h>
 #include <dirent.h>
@@ -377,6 +378,24 @@ coio_unlink(const char *pathname)
 	return coio_wait_done(req, &eio);
 }
 
+static void
+coio_do_unlink_throttled(eio_req *req)
+{
+	struct coio_file_task *eio = (struct coio_file_task *)req->data;
+	req->result = file_reclaim_unlink(eio->lstat.pathname);
+	req->errorno = errno;
+}
+
+int
+coio_unlink_throttled(const char *pathname)
+{
+	INIT_COEIO_FILE(eio);
+	eio.lstat.pathname = pathname;
+	eio_req *req = eio_custom(coio_do_unlink_throttled, 0,
+				  coio_complete, &eio);
+	return coio_wait_done(req, &eio);
+}
+
 int
 coio_ftruncate(int fd, off_t length)
 {
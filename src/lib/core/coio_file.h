@@ -62,6 +62,11 @@ int     coio_lstat(const char *pathname, struct stat *buf);
 int     coio_fstat(int fd, struct stat *buf);
 int     coio_rename(const char *oldpath, const char *newpath);
 int     coio_unlink(const char *pathname);
+/**
+ * Like coio_unlink(), but a large file is freed gradually in
+ * background, see file_reclaim_unlink().
+ */
+int     coio_unlink_throttled(const char *pathname);
 int     coio_mkdir(const char *pathname, mode_t mode);
 int     coio_rmdir(const char *pathname);
 int     coio_ftruncate(int fd, off_t length);
@@ -80,9 +80,32 @@ datetime_now(struct datetime *now)
 	now->tzoffset = tm.tm_gmtoff / 60;
 }
 
+/**
+ * Write a non-negative value to the buffer in decimal, padded with
+ * zeroes to at least the given width, as "%0*d" does.
+ */
+static char *
+datetime_put_digits(char *p, uint32_t value, int width)
+{
+	char digits[10];
+	int n = 0;
+	do {
+		digits[n++] = '0' + value % 10;
+		value /= 10;
+	} while (value != 0);
+	while (n < width)
+		digits[n++] = '0';
+	while (n > 0)
+		*p++ = digits[--n];
+	return p;
+}
+
 /**
  * NB! buf may be NULL, and we should handle it gracefully, returning
  * calculated length of output string
+ *
+ * The string is built without snprintf(), which is too slow for
+ * serializing many datetime values.
  */
 size_t
 datetime_to_string(const struct datetime *date, char *buf, ssize_t len)
@@ -95,7 +118,7 @@ datetime_to_string(const struct datetime *date, char *buf, ssize_t len)
 	assert(rd_number >= INT_MIN);
 	dt_t dt = dt_from_rdn((int)rd_number);
 
-	int year, month, day, second, nanosec, sign;
+	int year, month, day, second, nanosec;
 	dt_to_ymd(dt, &year, &month, &day);
 
 	rd_seconds = MOD(rd_seconds, SECS_PER_DAY);
@@ -104,32 +127,53 @@ datetime_to_string(const struct datetime *date, char *buf, ssize_t len)
 	second = rd_seconds % 60;
 	nanosec = date->nsec;
 
-	size_t sz = 0;
-	SNPRINT(sz, snprintf, buf, len, "%04d-%02d-%02dT%02d:%02d:%02d",
-		year, month, day, hour, minute, second);
+	char str[DT_TO_STRING_BUFSIZE];
+	char *p = str;
+	/* The same as "%04d", including the sign. */
+	if (year < 0) {
+		*p++ = '-';
+		p = datetime_put_digits(p, -(int64_t)year, 3);
+	} else {
+		p = datetime_put_digits(p, year, 4);
+	}
+	*p++ = '-';
+	p = datetime_put_digits(p, month, 2);
+	*p++ = '-';
+	p = datetime_put_digits(p, day, 2);
+	*p++ = 'T';
+	p = datetime_put_digits(p, hour, 2);
+	*p++ = ':';
+	p = datetime_put_digits(p, minute, 2);
+	*p++ = ':';
+	p = datetime_put_digits(p, second, 2);
 	if (nanosec != 0) {
-		if (nanosec % 1000000 == 0) {
-			SNPRINT(sz, snprintf, buf, len, ".%03d",
-				nanosec / 1000000);
-
-		} else if (nanosec % 1000 == 0) {
-			SNPRINT(sz, snprintf, buf, len, ".%06d",
-				nanosec / 1000);
-		} else {
-			SNPRINT(sz, snprintf, buf, len, ".%09d", nanosec);
-		}
+		*p++ = '.';
+		if (nanosec % 1000000 == 0)
+			p = datetime_put_digits(p, nanosec / 1000000, 3);
+		else if (nanosec % 1000 == 0)
+			p = datetime_put_digits(p, nanosec / 1000, 6);
+		else
+			p = datetime_put_digits(p, nanosec, 9);
 	}
 	if (offset == 0) {
-		SNPRINT(sz, snprintf, buf, len, "Z");
+		*p++ = 'Z';
 	} else {
 		if (offset < 0) {
-			sign = '-';
+			*p++ = '-';
 			offset = -offset;
 		} else {
-			sign = '+';
+			*p++ = '+';
 		}
-		SNPRINT(sz, snprintf, buf, len, "%c%02d%02d", sign,
-			offset / 60, offset % 60);
+		p = datetime_put_digits(p, offset / 60, 2);
+		p = datetime_put_digits(p, offset % 60, 2);
+	}
+	size_t sz = p - str;
+	assert(sz < sizeof(str));
+	/* Truncate the output as snprintf() does. */
+	if (buf != NULL && len > 0) {
+		size_t copy = MIN(sz, (size_t)len - 1);
+		memcpy(buf, str, copy);
+		buf[copy] = '\0';
 	}
 	return sz;
 }
@@ -93,6 +93,176 @@ decimal_check_status(decimal_t *dec, decContext *context)
 	return status || !decNumberIsFinite(dec) ? NULL : dec;
 }
 
+#if defined(__SIZEOF_INT128__)
+
+/*
+ * Fast path for addition, subtraction and multiplication of
+ * decimals with short coefficients, like money amounts. Such a
+ * coefficient fits into uint64_t, and the exact result of the
+ * operation fits into a 128-bit integer, so it is calculated
+ * without the unit-by-unit decNumber arithmetic. When an operand
+ * is too long or the result needs rounding or is out of range,
+ * the generic decNumber path is used.
+ */
+
+enum {
+	/** Max coefficient digits of a fast path operand. */
+	DECIMAL_FAST_DIGITS = 19,
+	/** Min exponent of a decimal, see decimal_context. */
+	DECIMAL_MIN_EXPONENT = -DECIMAL_MAX_DIGITS,
+};
+
+typedef unsigned __int128 decimal_uint128_t;
+
+static const uint64_t decimal_pow10[] = {
+	1ULL, 10ULL, 100ULL, 1000ULL, 10000ULL, 100000ULL, 1000000ULL,
+	10000000ULL, 100000000ULL, 1000000000ULL, 10000000000ULL,
+	100000000000ULL, 1000000000000ULL, 10000000000000ULL,
+	100000000000000ULL, 1000000000000000ULL, 10000000000000000ULL,
+	100000000000000000ULL, 1000000000000000000ULL,
+	10000000000000000000ULL,
+};
+
+/**
+ * Get the coefficient of a decimal as an integer.
+ * @retval false The decimal is too long for the fast path.
+ */
+static inline bool
+decimal_fast_coef(const decimal_t *dec, uint64_t *coef)
+{
+	if (dec->digits > DECIMAL_FAST_DIGITS ||
+	    (dec->bits & DECSPECIAL) != 0)
+		return false;
+	uint64_t c = 0;
+	for (int i = (dec->digits + DECDPUN - 1) / DECDPUN - 1; i >= 0; i--)
+		c = c * decimal_pow10[DECDPUN] + dec->lsu[i];
+	*coef = c;
+	return true;
+}
+
+/** Multiply a coefficient by 10^n. The result must fit. */
+static inline decimal_uint128_t
+decimal_fast_shift(uint64_t coef, int n)
+{
+	assert(n < DECIMAL_MAX_DIGITS);
+	decimal_uint128_t res = coef;
+	if (n >= (int)lengthof(decimal_pow10)) {
+		res *= decimal_pow10[DECIMAL_FAST_DIGITS];
+		n -= DECIMAL_FAST_DIGITS;
+	}
+	return res * decimal_pow10[n];
+}
+
+/**
+ * Store an exact result of the fast path into a decimal.
+ * @retval NULL The result is out of the decimal range, it should
+ *         be handled by decNumber.
+ */
+static decimal_t *
+decimal_fast_set(decimal_t *dec, decimal_uint128_t coef, int exponent,
+		 bool is_neg)
+{
+	/* Both the sum and the product are below 10^38. */
+	int digits = 1;
+	decimal_uint128_t p = 10;
+	while (digits < DECIMAL_MAX_DIGITS && coef >= p) {
+		p *= 10;
+		digits++;
+	}
+	assert(digits < DECIMAL_MAX_DIGITS || coef < p);
+	if (exponent < DECIMAL_MIN_EXPONENT ||
+	    digits - 1 + exponent > decimal_context.emax)
+		return NULL;
+	int i = 0;
+	do {
+		dec->lsu[i++] = coef % decimal_pow10[DECDPUN];
+		coef /= decimal_pow10[DECDPUN];
+	} while (coef != 0);
+	dec->digits = digits;
+	dec->exponent = exponent;
+	dec->bits = is_neg ? DECNEG : 0;
+	return dec;
+}
+
+/**
+ * Calculate lhs + rhs, or lhs - rhs if @a is_sub is set.
+ * @retval NULL The fast path isn't applicable.
+ */
+static decimal_t *
+decimal_add_fast(decimal_t *res, const decimal_t *lhs, const decimal_t *rhs,
+		 bool is_sub)
+{
+	uint64_t a, b;
+	if (!decimal_fast_coef(lhs, &a) || !decimal_fast_coef(rhs, &b))
+		return NULL;
+	int exponent = MIN(lhs->exponent, rhs->exponent);
+	int a_shift = lhs->exponent - exponent;
+	int b_shift = rhs->exponent - exponent;
+	/* Keep the sum below 10^DECIMAL_MAX_DIGITS. */
+	if (lhs->digits + a_shift >= DECIMAL_MAX_DIGITS ||
+	    rhs->digits + b_shift >= DECIMAL_MAX_DIGITS)
+		return NULL;
+	decimal_uint128_t x = decimal_fast_shift(a, a_shift);
+	decimal_uint128_t y = decimal_fast_shift(b, b_shift);
+	bool x_neg = decNumberIsNegative(lhs);
+	bool y_neg = decNumberIsNegative(rhs) != is_sub;
+	decimal_uint128_t sum;
+	bool is_neg;
+	if (x_neg == y_neg) {
+		sum = x + y;
+		is_neg = x_neg;
+	} else if (x >= y) {
+		sum = x - y;
+		is_neg = x_neg;
+	} else {
+		sum = y - x;
+		is_neg = y_neg;
+	}
+	/* Exact zero is negative only as a sum of negatives. */
+	if (sum == 0)
+		is_neg = x_neg && y_neg;
+	return decimal_fast_set(res, sum, exponent, is_neg);
+}
+
+/**
+ * Calculate lhs * rhs.
+ * @retval NULL The fast path isn't applicable.
+ */
+static decimal_t *
+decimal_mul_fast(decimal_t *res, const decimal_t *lhs, const decimal_t *rhs)
+{
+	uint64_t a, b;
+	if (!decimal_fast_coef(lhs, &a) || !decimal_fast_coef(rhs, &b))
+		return NULL;
+	bool is_neg = decNumberIsNegative(lhs) != decNumberIsNegative(rhs);
+	return decimal_fast_set(res, (decimal_uint128_t)a * b,
+				lhs->exponent + rhs->exponent, is_neg);
+}
+
+#else /* !defined(__SIZEOF_INT128__) */
+
+static inline decimal_t *
+decimal_add_fast(decimal_t *res, const decimal_t *lhs, const decimal_t *rhs,
+		 bool is_sub)
+{
+	(void)res;
+	(void)lhs;
+	(void)rhs;
+	(void)is_sub;
+	return NULL;
+}
+
+static inline decimal_t *
+decimal_mul_fast(decimal_t *res, const decimal_t *lhs, const decimal_t *rhs)
+{
+	(void)res;
+	(void)lhs;
+	(void)rhs;
+	return NULL;
+}
+
+#endif /* !defined(__SIZEOF_INT128__) */
+
 int decimal_precision(const decimal_t *dec) {
 	return dec->exponent <= 0 ? MAX(dec->digits, -dec->exponent) :
 				    dec->digits + dec->exponent;
@@ -329,6 +499,8 @@ decimal_minus(decimal_t *res, const decimal_t *dec)
 decimal_t *
 decimal_add(decimal_t *res, const decimal_t *lhs, const decimal_t *rhs)
 {
+	if (decimal_add_fast(res, lhs, rhs, false) != NULL)
+		return res;
 	decNumberAdd(res, lhs, rhs, &decimal_context);
 	return decimal_check_status(res, &decimal_context);
 }
@@ -336,6 +508,8 @@ decimal_add(decimal_t *res, const decimal_t *lhs, const decimal_t *rhs)
 decimal_t *
 decimal_sub(decimal_t *res, const decimal_t *lhs, const decimal_t *rhs)
 {
+	if (decimal_add_fast(res, lhs, rhs, true) != NULL)
+		return res;
 	decNumberSubtract(res, lhs, rhs, &decimal_context);
 
 	return decimal_check_status(res, &decimal_context);
@@ -344,6 +518,8 @@ decimal_sub(decimal_t *res, const decimal_t *lhs, const decimal_t *rhs)
 decimal_t *
 decimal_mul(decimal_t *res, const decimal_t *lhs, const decimal_t *rhs)
 {
+	if (decimal_mul_fast(res, lhs, rhs) != NULL)
+		return res;
 	decNumberMultiply(res, lhs, rhs, &decimal_context);
 
 	return decimal_check_status(res, &decimal_context);
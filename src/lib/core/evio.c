@@ -56,6 +56,11 @@ struct evio_service_entry {
 	struct ev_io ev;
 	/** Pointer to the root evio_service, which contains this object */
 	struct evio_service *service;
+	/**
+	 * Set if the acceptor socket was opened by
+	 * evio_service_attach() and so must be closed on detach.
+	 */
+	bool is_own_socket;
 };
 
 static inline bool
@@ -153,6 +158,23 @@ evio_setsockopt_server(int fd, int family, int type)
 	return 0;
 }
 
+/**
+ * Allow other sockets to bind to the same address so that the kernel
+ * balances incoming connections between them.
+ */
+static int
+evio_setsockopt_reuseport(int fd)
+{
+#ifdef SO_REUSEPORT
+	int on = 1;
+	return sio_setsockopt(fd, SOL_SOCKET, SO_REUSEPORT, &on, sizeof(on));
+#else
+	(void)fd;
+	diag_set(IllegalParams, "SO_REUSEPORT is not supported");
+	return -1;
+#endif
+}
+
 static inline const char *
 evio_service_name(struct evio_service *service)
 {
@@ -263,6 +285,10 @@ evio_service_entry_bind_addr(struct evio_service_entry *entry)
 				   SOCK_STREAM) != 0)
 		goto error;
 
+	if (entry->service->reuse_port && entry->addr.sa_family != AF_UNIX &&
+	    evio_setsockopt_reuseport(fd) != 0)
+		goto error;
+
 	if (sio_bind(fd, &entry->addr, entry->addr_len) != 0)
 		goto error;
 
@@ -320,6 +346,7 @@ evio_service_entry_create(struct evio_service_entry *entry,
 	ev_io_set(&entry->ev, -1, 0);
 	entry->ev.data = entry;
 	entry->service = service;
+	entry->is_own_socket = false;
 }
 
 /**
@@ -380,6 +407,7 @@ evio_service_entry_bind(struct evio_service_entry *entry, const struct uri *u)
 static void
 evio_service_entry_detach(struct evio_service_entry *entry)
 {
+	int fd = entry->ev.fd;
 	iostream_ctx_clear(&entry->io_ctx);
 	if (ev_is_active(&entry->ev)) {
 		ev_io_stop(entry->service->loop, &entry->ev);
@@ -387,6 +415,12 @@ evio_service_entry_detach(struct evio_service_entry *entry)
 	}
 	ev_io_set(&entry->ev, -1, 0);
 	uri_destroy(&entry->uri);
+	if (entry->is_own_socket) {
+		entry->is_own_socket = false;
+		if (fd >= 0 && close(fd) < 0)
+			say_error("Failed to close socket: %s",
+				  strerror(errno));
+	}
 }
 
 /** It's safe to stop a service entry which is not started yet. */
@@ -396,8 +430,9 @@ evio_service_entry_stop(struct evio_service_entry *entry)
 	iostream_ctx_destroy(&entry->io_ctx);
 
 	int service_fd = entry->ev.fd;
+	bool is_own_socket = entry->is_own_socket;
 	evio_service_entry_detach(entry);
-	if (service_fd < 0)
+	if (service_fd < 0 || is_own_socket)
 		return;
 
 	if (close(service_fd) < 0)
@@ -412,7 +447,7 @@ evio_service_entry_stop(struct evio_service_entry *entry)
 	}
 }
 
-static void
+static int
 evio_service_entry_attach(struct evio_service_entry *dst,
 			 const struct evio_service_entry *src)
 {
@@ -422,7 +457,15 @@ evio_service_entry_attach(struct evio_service_entry *dst,
 	dst->addrstorage = src->addrstorage;
 	dst->addr_len = src->addr_len;
 	dst->io_ctx = src->io_ctx;
+	if (dst->service->reuse_port && dst->addr.sa_family != AF_UNIX) {
+		/* Open a socket of our own bound to the same address. */
+		if (evio_service_entry_bind_addr(dst) != 0)
+			return -1;
+		dst->is_own_socket = true;
+		return 0;
+	}
 	ev_io_set(&dst->ev, src->ev.fd, EV_READ);
+	return 0;
 }
 
 static inline int
@@ -473,13 +516,18 @@ evio_service_create(struct ev_loop *loop, struct evio_service *service,
 	service->on_accept_param = on_accept_param;
 }
 
-void
+int
 evio_service_attach(struct evio_service *dst, const struct evio_service *src)
 {
 	assert(dst->entry_count == 0);
+	dst->reuse_port = src->reuse_port;
 	evio_service_create_entries(dst, src->entry_count);
-	for (int i = 0; i < src->entry_count; i++)
-		evio_service_entry_attach(&dst->entries[i], &src->entries[i]);
+	for (int i = 0; i < src->entry_count; i++) {
+		if (evio_service_entry_attach(&dst->entries[i],
+					      &src->entries[i]) != 0)
+			return -1;
+	}
+	return 0;
 }
 
 void
@@ -88,6 +88,14 @@ struct evio_service {
         evio_accept_f on_accept;
         void *on_accept_param;
         ev_loop *loop;
+        /**
+         * If set, TCP sockets are bound with SO_REUSEPORT, and
+         * a service attached to this one opens sockets of its own
+         * bound to the same addresses instead of sharing ours.
+         * The kernel then balances incoming connections between
+         * the listening sockets.
+         */
+        bool reuse_port;
 };
 
 /**
@@ -131,8 +139,11 @@ evio_service_stop(struct evio_service *service);
 
 /**
  * Updates @a dst evio_service socket settings according @a src evio service.
+ * If @a src has reuse_port set, opens new TCP sockets for @a dst.
+ *
+ * @retval 0 for success
  */
-void
+int
 evio_service_attach(struct evio_service *dst, const struct evio_service *src);
 
 bool
@@ -42,6 +42,7 @@
 #include "memory.h"
 #include "trigger.h"
 #include "errinj.h"
+#include "probe.h"
 
 extern void cord_on_yield(void);
 
@@ -261,6 +262,15 @@ pthread_t main_thread_id;
 static size_t page_size;
 static int stack_direction;
 
+#if HAVE_PTHREAD_SETAFFINITY_NP
+/**
+ * CPUs the main thread was allowed to run on at startup. A new
+ * cord resets its affinity to them, because a thread inherits
+ * the affinity of its creator, which may be pinned to one CPU.
+ */
+static cpu_set_t cord_cpu_set;
+#endif
+
 enum {
 	/* The minimum allowable fiber stack size in bytes */
 	FIBER_STACK_SIZE_MINIMAL = 16384,
@@ -268,6 +278,11 @@ enum {
 	FIBER_STACK_SIZE_DEFAULT = 524288,
 	/* Stack size watermark in bytes. */
 	FIBER_STACK_SIZE_WATERMARK = 65536,
+	/*
+	 * Number of dead fibers a cord caches for reuse regardless
+	 * of the number of alive fibers, see fiber_cache_trim().
+	 */
+	FIBER_DEAD_CACHE_MIN = 128,
 };
 
 /** Default fiber attributes */
@@ -372,6 +387,9 @@ fiber_recycle(struct fiber *fiber);
 static void
 fiber_stack_recycle(struct fiber *fiber);
 
+static void
+fiber_cache_trim(struct cord *cord);
+
 static void
 fiber_destroy(struct cord *cord, struct fiber *f);
 
@@ -399,6 +417,7 @@ fiber_call_impl(struct fiber *callee)
 	assert((caller->flags & FIBER_IS_RUNNING) != 0);
 	assert((callee->flags & FIBER_IS_RUNNING) == 0);
 
+	PROBE2(fiber_call, caller->fid, callee->fid);
 	caller->flags &= ~FIBER_IS_RUNNING;
 	cord->fiber = callee;
 	callee->flags = (callee->flags & ~FIBER_IS_READY) | FIBER_IS_RUNNING;
@@ -694,6 +713,7 @@ fiber_yield(void)
 	assert((caller->flags & FIBER_IS_RUNNING) != 0);
 	assert((callee->flags & FIBER_IS_RUNNING) == 0);
 
+	PROBE2(fiber_yield, caller->fid, callee->fid);
 	caller->flags &= ~FIBER_IS_RUNNING;
 	cord->fiber = callee;
 	callee->flags = (callee->flags & ~FIBER_IS_READY) | FIBER_IS_RUNNING;
@@ -902,6 +922,8 @@ fiber_recycle(struct fiber *fiber)
 	region_free(&fiber->gc);
 	if (!has_custom_stack) {
 		rlist_move_entry(&cord()->dead, fiber, link);
+		cord()->dead_count++;
+		fiber_cache_trim(cord());
 	} else {
 		fiber_destroy(cord(), fiber);
 	}
@@ -1104,6 +1126,19 @@ fiber_stack_watermark_create(struct fiber *fiber)
 	}
 	stack_put_watermark(fiber->stack_watermark);
 }
+
+/**
+ * Return the whole stack memory of a fiber to the OS before the
+ * stack is released to the slab cache: cached slabs stay mapped.
+ */
+static void
+fiber_stack_release(struct fiber *fiber)
+{
+	void *start = page_align_up(fiber->stack);
+	void *end = page_align_down(fiber->stack + fiber->stack_size);
+	if (start < end)
+		fiber_madvise(start, end - start, MADV_DONTNEED);
+}
 #else
 static void
 fiber_stack_recycle(struct fiber *fiber)
@@ -1111,6 +1146,12 @@ fiber_stack_recycle(struct fiber *fiber)
 	(void)fiber;
 }
 
+static void
+fiber_stack_release(struct fiber *fiber)
+{
+	(void)fiber;
+}
+
 static void
 fiber_stack_watermark_create(struct fiber *fiber)
 {
@@ -1134,6 +1175,7 @@ fiber_stack_destroy(struct fiber *fiber, struct slab_cache *slabc)
 		else
 			guard = page_align_up(fiber->stack + fiber->stack_size);
 
+		fiber_stack_release(fiber);
 		if (fiber_mprotect(guard, page_size, mprotect_flags) != 0) {
 			/*
 			 * FIXME: We need some intelligent handling:
@@ -1229,6 +1271,7 @@ fiber_new_ex(const char *name, const struct fiber_attr *fiber_attr,
 		fiber = rlist_first_entry(&cord->dead,
 					  struct fiber, link);
 		rlist_move_entry(&cord->alive, fiber, link);
+		cord->dead_count--;
 	} else {
 		fiber = (struct fiber *)
 			mempool_alloc(&cord->fiber_mempool);
@@ -1258,6 +1301,8 @@ fiber_new_ex(const char *name, const struct fiber_attr *fiber_attr,
 		fiber->flags = fiber_attr->flags;
 
 		rlist_add_entry(&cord->alive, fiber, link);
+		cord->fiber_count++;
+		cord->stack_size += fiber->stack_size;
 	}
 
 	fiber->f = f;
@@ -1310,6 +1355,8 @@ fiber_destroy(struct cord *cord, struct fiber *f)
 	trigger_destroy(&f->on_stop);
 	rlist_del(&f->state);
 	rlist_del(&f->link);
+	cord->fiber_count--;
+	cord->stack_size -= f->stack_size;
 	region_destroy(&f->gc);
 	fiber_stack_destroy(f, &cord->slabc);
 	diag_destroy(&f->diag);
@@ -1324,9 +1371,38 @@ fiber_destroy_all(struct cord *cord)
 	while (!rlist_empty(&cord->alive))
 		fiber_destroy(cord, rlist_first_entry(&cord->alive,
 						      struct fiber, link));
-	while (!rlist_empty(&cord->dead))
+	while (!rlist_empty(&cord->dead)) {
 		fiber_destroy(cord, rlist_first_entry(&cord->dead,
 						      struct fiber, link));
+		cord->dead_count--;
+	}
+}
+
+/**
+ * Destroy dead fibers which the cord doesn't need anymore, so
+ * that a burst of fibers doesn't keep their stacks forever.
+ *
+ * The cache is sized by demand: it may hold as many fibers as
+ * there are alive ones plus FIBER_DEAD_CACHE_MIN. A call destroys
+ * at most two oldest cached fibers, so the cache shrinks as fast
+ * as fibers die, while the cost is spread over fiber_recycle().
+ */
+static void
+fiber_cache_trim(struct cord *cord)
+{
+	for (int i = 0; i < 2; i++) {
+		int alive_count = cord->fiber_count - cord->dead_count;
+		if (cord->dead_count <= alive_count + FIBER_DEAD_CACHE_MIN)
+			return;
+		struct fiber *f = rlist_last_entry(&cord->dead,
+						   struct fiber, link);
+		/* A recycled fiber may still be running on its stack. */
+		if (f == cord->fiber)
+			return;
+		fiber_destroy(cord, f);
+		mempool_free(&cord->fiber_mempool, f);
+		cord->dead_count--;
+	}
 }
 
 #if ENABLE_FIBER_TOP
@@ -1448,12 +1524,21 @@ cord_create(struct cord *cord, const char *name)
 
 	cord->id = pthread_self();
 	cord->on_exit = NULL;
+#if HAVE_PTHREAD_SETAFFINITY_NP
+	if (cord != &main_cord && CPU_COUNT(&cord_cpu_set) > 0) {
+		pthread_setaffinity_np(cord->id, sizeof(cord_cpu_set),
+				       &cord_cpu_set);
+	}
+#endif
 	slab_cache_create(&cord->slabc, &runtime);
 	mempool_create(&cord->fiber_mempool, &cord->slabc,
 		       sizeof(struct fiber));
 	rlist_create(&cord->alive);
 	rlist_create(&cord->ready);
 	rlist_create(&cord->dead);
+	cord->fiber_count = 0;
+	cord->dead_count = 0;
+	cord->stack_size = 0;
 	cord->fiber_registry = mh_i64ptr_new();
 
 	/* sched fiber is not present in alive/ready/dead list. */
@@ -1809,6 +1894,11 @@ fiber_init(int (*invoke)(fiber_func f, va_list ap))
 	stack_direction = check_stack_direction(__builtin_frame_address(0));
 	fiber_invoke = invoke;
 	main_thread_id = pthread_self();
+#if HAVE_PTHREAD_SETAFFINITY_NP
+	if (pthread_getaffinity_np(main_thread_id, sizeof(cord_cpu_set),
+				   &cord_cpu_set) != 0)
+		CPU_ZERO(&cord_cpu_set);
+#endif
 	main_cord.loop = ev_default_loop(EVFLAG_AUTO | EVFLAG_ALLOCFD);
 	cord_create(&main_cord, "main");
 }
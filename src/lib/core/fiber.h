@@ -644,10 +644,14 @@ struct fiber {
 			int storage_ref;
 		} lua;
 		/**
-		 * Iproto sync.
+		 * Iproto sync and the time the current request
+		 * has waited for WAL writes and for the quorum of
+		 * synchronous replication, for the slow request log.
 		 */
 		struct {
 			uint64_t sync;
+			double wal_wait;
+			double limbo_wait;
 		} net;
 	} storage;
 	/** An object to wait for incoming message or a reader. */
@@ -696,6 +700,12 @@ struct cord {
 	struct rlist ready;
 	/** A cache of dead fibers for reuse */
 	struct rlist dead;
+	/** Number of fibers in the alive and dead lists. */
+	int fiber_count;
+	/** Number of fibers in the dead list. */
+	int dead_count;
+	/** Total size of stacks of fibers in the alive and dead lists. */
+	size_t stack_size;
 	/** A watcher to have a single async event for all ready fibers.
 	 * This technique is necessary to be able to suspend
 	 * a single fiber on a few watchers (for example,
@@ -0,0 +1,192 @@
+/*
+ * SPDX-License-Identifier: BSD-2-Clause
+ *
+ * Copyright 2010-2022, Tarantool AUTHORS, please see AUTHORS file.
+ */
+#include "file_reclaim.h"
+
+#include <assert.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "clock.h"
+#include "fiber.h"
+#include "say.h"
+#include "small/rlist.h"
+#include "tt_pthread.h"
+
+/** A file that has been unlinked, but not freed yet. */
+struct file_reclaim_entry {
+	/** Open descriptor of the file. */
+	int fd;
+	/** Current size of the file. */
+	off_t size;
+	/** Link in file_reclaim::queue. */
+	struct rlist in_queue;
+};
+
+static struct file_reclaim {
+	/** Protects all members below. */
+	pthread_mutex_t mutex;
+	/** Signaled on a new entry or shutdown. */
+	pthread_cond_t cond;
+	/** Files to free, linked by file_reclaim_entry::in_queue. */
+	struct rlist queue;
+	/** Size of a truncation step, see file_reclaim_init(). */
+	size_t chunk_size;
+	/** Truncation rate, see file_reclaim_init(). */
+	size_t rate;
+	/** Backlog statistics. */
+	struct file_reclaim_stat stat;
+	/** Set if the thread accepts new files. */
+	bool is_running;
+	/** Set when the thread is told to stop. */
+	bool is_shutdown;
+	/** The background thread. */
+	struct cord cord;
+} reclaim = {
+	.mutex = PTHREAD_MUTEX_INITIALIZER,
+	.cond = PTHREAD_COND_INITIALIZER,
+	.queue = RLIST_HEAD_INITIALIZER(reclaim.queue),
+};
+
+/**
+ * Sleep for the time it takes to free one chunk at the configured
+ * rate or until shutdown. Called with the mutex locked.
+ */
+static void
+file_reclaim_throttle(void)
+{
+	double deadline = clock_realtime() +
+			  (double)reclaim.chunk_size / reclaim.rate;
+	struct timespec ts;
+	ts.tv_sec = (time_t)deadline;
+	ts.tv_nsec = (long)((deadline - ts.tv_sec) * 1e9);
+	while (!reclaim.is_shutdown &&
+	       tt_pthread_cond_timedwait(&reclaim.cond, &reclaim.mutex,
+					 &ts) != ETIMEDOUT) {
+	}
+}
+
+static void *
+file_reclaim_f(void *arg)
+{
+	(void)arg;
+	tt_pthread_mutex_lock(&reclaim.mutex);
+	while (true) {
+		while (rlist_empty(&reclaim.queue) && !reclaim.is_shutdown)
+			tt_pthread_cond_wait(&reclaim.cond, &reclaim.mutex);
+		if (reclaim.is_shutdown)
+			break;
+		struct file_reclaim_entry *entry =
+			rlist_first_entry(&reclaim.queue,
+					  struct file_reclaim_entry, in_queue);
+		off_t size = 0;
+		if (entry->size > (off_t)reclaim.chunk_size)
+			size = entry->size - reclaim.chunk_size;
+		tt_pthread_mutex_unlock(&reclaim.mutex);
+
+		if (size > 0 && ftruncate(entry->fd, size) != 0) {
+			say_syserror("failed to truncate removed file");
+			size = 0;
+		}
+		if (size == 0)
+			close(entry->fd);
+
+		tt_pthread_mutex_lock(&reclaim.mutex);
+		reclaim.stat.bytes -= entry->size - size;
+		entry->size = size;
+		if (size == 0) {
+			rlist_del_entry(entry, in_queue);
+			reclaim.stat.files--;
+			free(entry);
+		}
+		file_reclaim_throttle();
+	}
+	tt_pthread_mutex_unlock(&reclaim.mutex);
+	return NULL;
+}
+
+int
+file_reclaim_init(size_t chunk_size, size_t rate)
+{
+	assert(!reclaim.is_running);
+	assert(chunk_size > 0 && rate > 0);
+	reclaim.chunk_size = chunk_size;
+	reclaim.rate = rate;
+	reclaim.is_shutdown = false;
+	if (cord_start(&reclaim.cord, "reclaim", file_reclaim_f, NULL) != 0)
+		return -1;
+	tt_pthread_mutex_lock(&reclaim.mutex);
+	reclaim.is_running = true;
+	tt_pthread_mutex_unlock(&reclaim.mutex);
+	return 0;
+}
+
+void
+file_reclaim_free(void)
+{
+	if (!reclaim.is_running)
+		return;
+	tt_pthread_mutex_lock(&reclaim.mutex);
+	reclaim.is_running = false;
+	reclaim.is_shutdown = true;
+	tt_pthread_cond_broadcast(&reclaim.cond);
+	tt_pthread_mutex_unlock(&reclaim.mutex);
+	if (cord_join(&reclaim.cord) != 0)
+		panic_syserror("file reclaim: thread join failed");
+	struct file_reclaim_entry *entry, *tmp;
+	rlist_foreach_entry_safe(entry, &reclaim.queue, in_queue, tmp) {
+		close(entry->fd);
+		free(entry);
+	}
+	rlist_create(&reclaim.queue);
+	reclaim.stat.files = 0;
+	reclaim.stat.bytes = 0;
+}
+
+int
+file_reclaim_unlink(const char *path)
+{
+	int fd = open(path, O_WRONLY);
+	if (fd < 0)
+		return unlink(path);
+	struct stat st;
+	if (fstat(fd, &st) != 0)
+		st.st_size = 0;
+	if (unlink(path) != 0) {
+		int save_errno = errno;
+		close(fd);
+		errno = save_errno;
+		return -1;
+	}
+	struct file_reclaim_entry *entry = NULL;
+	tt_pthread_mutex_lock(&reclaim.mutex);
+	if (reclaim.is_running && st.st_size > (off_t)reclaim.chunk_size)
+		entry = malloc(sizeof(*entry));
+	if (entry != NULL) {
+		entry->fd = fd;
+		entry->size = st.st_size;
+		rlist_add_tail_entry(&reclaim.queue, entry, in_queue);
+		reclaim.stat.files++;
+		reclaim.stat.bytes += st.st_size;
+		tt_pthread_cond_signal(&reclaim.cond);
+	}
+	tt_pthread_mutex_unlock(&reclaim.mutex);
+	if (entry == NULL)
+		close(fd);
+	return 0;
+}
+
+void
+file_reclaim_stat(struct file_reclaim_stat *stat)
+{
+	tt_pthread_mutex_lock(&reclaim.mutex);
+	*stat = reclaim.stat;
+	tt_pthread_mutex_unlock(&reclaim.mutex);
+}
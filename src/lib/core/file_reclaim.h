@@ -0,0 +1,72 @@
+/*
+ * SPDX-License-Identifier: BSD-2-Clause
+ *
+ * Copyright 2010-2022, Tarantool AUTHORS, please see AUTHORS file.
+ */
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#if defined(__cplusplus)
+extern "C" {
+#endif
+
+/**
+ * Throttled removal of large files.
+ *
+ * Unlinking a multi-gigabyte file makes the file system free all of
+ * its extents at once, which may stall other I/O on the same disk for
+ * hundreds of milliseconds. To avoid that, file_reclaim_unlink()
+ * removes the directory entry right away, but keeps the file open and
+ * passes it to a background thread. The thread truncates the file
+ * by chunks of a configured size at a configured rate and closes it
+ * when it is small.
+ *
+ * Until file_reclaim_init() is called, and after file_reclaim_free(),
+ * files are unlinked without throttling.
+ */
+
+/** Backlog of files removed but not yet freed. */
+struct file_reclaim_stat {
+	/** Number of files. */
+	int64_t files;
+	/** Total size of the files, in bytes. */
+	int64_t bytes;
+};
+
+/**
+ * Start the background thread.
+ *
+ * @param chunk_size  Files of this size or smaller are unlinked
+ *                    without throttling. Larger files are truncated
+ *                    by chunks of this size.
+ * @param rate        Truncation rate, in bytes per second.
+ *
+ * Returns 0 on success, -1 on failure (diag is set).
+ */
+int
+file_reclaim_init(size_t chunk_size, size_t rate);
+
+/**
+ * Stop the background thread. Files left in the backlog are closed
+ * without throttling.
+ */
+void
+file_reclaim_free(void);
+
+/**
+ * Remove a file. Follows the conventions of unlink(): returns 0 on
+ * success, -1 on failure and sets errno. Blocks, so it should be
+ * called from a coio thread. Thread-safe.
+ */
+int
+file_reclaim_unlink(const char *path);
+
+/** Get the current backlog. Thread-safe. */
+void
+file_reclaim_stat(struct file_reclaim_stat *stat);
+
+#if defined(__cplusplus)
+} /* extern "C" */
+#endif /* defined(__cplusplus) */
@@ -42,6 +42,41 @@
 
 #include <say.h>
 #include "tt_static.h"
+#include "fio_uring.h"
+
+const char *fio_backend_strs[] = {
+	[FIO_BACKEND_SYSCALL] = "syscall",
+	[FIO_BACKEND_IO_URING] = "io_uring",
+};
+
+/**
+ * The I/O backend. Set once on startup, before any threads
+ * doing file I/O are started.
+ */
+static enum fio_backend fio_backend = FIO_BACKEND_SYSCALL;
+
+int
+fio_set_backend(enum fio_backend backend)
+{
+	/*
+	 * Check that io_uring works by creating a ring in
+	 * the calling thread.
+	 */
+	if (backend == FIO_BACKEND_IO_URING && !fio_uring_is_available()) {
+		errno = ENOTSUP;
+		return -1;
+	}
+	fio_backend = backend;
+	return 0;
+}
+
+/** Check if the calling thread should use io_uring. */
+static inline bool
+fio_use_uring(void)
+{
+	return fio_backend == FIO_BACKEND_IO_URING &&
+	       fio_uring_is_available();
+}
 
 const char *
 fio_filename(int fd)
@@ -94,7 +129,9 @@ fio_pread(int fd, void *buf, size_t count, off_t offset)
 {
 	size_t n = 0;
 	do {
-		ssize_t nrd = pread(fd, buf + n, count - n, offset + n);
+		ssize_t nrd = fio_use_uring() ?
+			fio_uring_pread(fd, buf + n, count - n, offset + n) :
+			pread(fd, buf + n, count - n, offset + n);
 		if (nrd < 0) {
 			if (errno == EINTR) {
 				errno = 0;
@@ -140,7 +177,8 @@ fio_writev(int fd, struct iovec *iov, int iovcnt)
 	assert(iov && iovcnt >= 0);
 	ssize_t nwr;
 restart:
-	nwr = writev(fd, iov, iovcnt);
+	nwr = fio_use_uring() ? fio_uring_writev(fd, iov, iovcnt) :
+				writev(fd, iov, iovcnt);
 	if (nwr < 0) {
 		if (errno == EINTR) {
 			errno = 0;
@@ -195,6 +233,16 @@ fio_lseek(int fd, off_t offset, int whence)
 	return effective_offset;
 }
 
+int
+fio_fsync(int fd)
+{
+	int rc;
+	do {
+		rc = fio_use_uring() ? fio_uring_fsync(fd) : fsync(fd);
+	} while (rc < 0 && errno == EINTR);
+	return rc;
+}
+
 int
 fio_truncate(int fd, off_t offset)
 {
@@ -45,6 +45,32 @@
 extern "C" {
 #endif /* defined(__cplusplus) */
 
+/** File I/O backends. */
+enum fio_backend {
+	/** Plain blocking system calls. */
+	FIO_BACKEND_SYSCALL,
+	/**
+	 * Linux io_uring. Threads that fail to set up a ring
+	 * fall back on system calls.
+	 */
+	FIO_BACKEND_IO_URING,
+	fio_backend_MAX,
+};
+
+/** String constants for the supported backends. */
+extern const char *fio_backend_strs[];
+
+/**
+ * Set the backend used by fio_pread(), fio_writev() and
+ * fio_fsync(). Must be called before starting any threads that
+ * use these functions.
+ *
+ * @retval  0 on success
+ * @retval -1 if the backend isn't supported, errno is set.
+ */
+int
+fio_set_backend(enum fio_backend backend);
+
 const char *
 fio_filename(int fd);
 
@@ -158,6 +184,15 @@ fio_writevn(int fd, struct iovec *iov, int iovcnt);
 off_t
 fio_lseek(int fd, off_t offset, int whence);
 
+/**
+ * A wrapper around fsync(), re-tries in case of EINTR.
+ *
+ * @retval  0 on success
+ * @retval -1 on error, errno is set.
+ */
+int
+fio_fsync(int fd);
+
 /** Truncate a file and log a message in case of error. */
 int
 fio_truncate(int fd, off_t offset);
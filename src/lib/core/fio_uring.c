@@ -0,0 +1,305 @@
+/*
+ * Copyright 2010-2021, Tarantool AUTHORS, please see AUTHORS file.
+ *
+ * Redistribution and use in source and binary forms, with or
+ * without modification, are permitted provided that the following
+ * conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above
+ *    copyright notice, this list of conditions and the
+ *    following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above
+ *    copyright notice, this list of conditions and the following
+ *    disclaimer in the documentation and/or other materials
+ *    provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY <COPYRIGHT HOLDER> ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ * TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL
+ * <COPYRIGHT HOLDER> OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+ * BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF
+ * THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+#include "fio_uring.h"
+
+#if defined(HAVE_IO_URING)
+
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <errno.h>
+#include <pthread.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "say.h"
+
+enum {
+	/**
+	 * Requests are submitted one at a time so we don't need
+	 * a big ring.
+	 */
+	FIO_URING_ENTRIES = 4,
+};
+
+/** Per-thread io_uring instance. */
+struct fio_uring {
+	/** Ring file descriptor. */
+	int fd;
+	/** Submission queue ring, shared with the kernel. */
+	void *sq_ring;
+	size_t sq_ring_size;
+	unsigned *sq_head;
+	unsigned *sq_tail;
+	unsigned *sq_mask;
+	unsigned *sq_array;
+	/** Submission queue entries. */
+	struct io_uring_sqe *sqes;
+	size_t sqes_size;
+	/** Completion queue ring, shared with the kernel. */
+	void *cq_ring;
+	size_t cq_ring_size;
+	unsigned *cq_head;
+	unsigned *cq_tail;
+	unsigned *cq_mask;
+	struct io_uring_cqe *cqes;
+};
+
+/** The ring of the current thread or NULL if not created yet. */
+static __thread struct fio_uring *fio_uring;
+/** Set if the ring of the current thread failed to initialize. */
+static __thread bool fio_uring_is_broken;
+/** Used for destroying rings on thread exit. */
+static pthread_key_t fio_uring_key;
+static pthread_once_t fio_uring_key_once = PTHREAD_ONCE_INIT;
+
+static void
+fio_uring_delete(struct fio_uring *ring)
+{
+	if (ring->sqes != NULL)
+		munmap(ring->sqes, ring->sqes_size);
+	if (ring->cq_ring != NULL)
+		munmap(ring->cq_ring, ring->cq_ring_size);
+	if (ring->sq_ring != NULL)
+		munmap(ring->sq_ring, ring->sq_ring_size);
+	if (ring->fd >= 0)
+		close(ring->fd);
+	free(ring);
+}
+
+static void
+fio_uring_destructor(void *arg)
+{
+	fio_uring_delete((struct fio_uring *)arg);
+}
+
+static void
+fio_uring_create_key(void)
+{
+	if (pthread_key_create(&fio_uring_key, fio_uring_destructor) != 0)
+		panic_syserror("pthread_key_create");
+}
+
+static void *
+fio_uring_mmap(int fd, size_t size, off_t offset)
+{
+	void *ptr = mmap(NULL, size, PROT_READ | PROT_WRITE,
+			 MAP_SHARED | MAP_POPULATE, fd, offset);
+	return ptr == MAP_FAILED ? NULL : ptr;
+}
+
+static struct fio_uring *
+fio_uring_new(void)
+{
+	struct fio_uring *ring = calloc(1, sizeof(*ring));
+	if (ring == NULL)
+		return NULL;
+	struct io_uring_params params;
+	memset(&params, 0, sizeof(params));
+	ring->fd = syscall(__NR_io_uring_setup, FIO_URING_ENTRIES, &params);
+	if (ring->fd < 0)
+		goto fail;
+	/*
+	 * We submit writes at the current file position (offset
+	 * -1), which is supported only since Linux 5.6.
+	 */
+	if ((params.features & IORING_FEAT_RW_CUR_POS) == 0) {
+		errno = ENOTSUP;
+		goto fail;
+	}
+	ring->sq_ring_size = params.sq_off.array +
+			     params.sq_entries * sizeof(unsigned);
+	ring->sq_ring = fio_uring_mmap(ring->fd, ring->sq_ring_size,
+				       IORING_OFF_SQ_RING);
+	if (ring->sq_ring == NULL)
+		goto fail;
+	ring->cq_ring_size = params.cq_off.cqes +
+			     params.cq_entries * sizeof(struct io_uring_cqe);
+	ring->cq_ring = fio_uring_mmap(ring->fd, ring->cq_ring_size,
+				       IORING_OFF_CQ_RING);
+	if (ring->cq_ring == NULL)
+		goto fail;
+	ring->sqes_size = params.sq_entries * sizeof(struct io_uring_sqe);
+	ring->sqes = fio_uring_mmap(ring->fd, ring->sqes_size,
+				    IORING_OFF_SQES);
+	if (ring->sqes == NULL)
+		goto fail;
+	char *sq = ring->sq_ring;
+	ring->sq_head = (unsigned *)(sq + params.sq_off.head);
+	ring->sq_tail = (unsigned *)(sq + params.sq_off.tail);
+	ring->sq_mask = (unsigned *)(sq + params.sq_off.ring_mask);
+	ring->sq_array = (unsigned *)(sq + params.sq_off.array);
+	char *cq = ring->cq_ring;
+	ring->cq_head = (unsigned *)(cq + params.cq_off.head);
+	ring->cq_tail = (unsigned *)(cq + params.cq_off.tail);
+	ring->cq_mask = (unsigned *)(cq + params.cq_off.ring_mask);
+	ring->cqes = (struct io_uring_cqe *)(cq + params.cq_off.cqes);
+	return ring;
+fail:;
+	int save_errno = errno;
+	fio_uring_delete(ring);
+	errno = save_errno;
+	return NULL;
+}
+
+bool
+fio_uring_is_available(void)
+{
+	if (likely(fio_uring != NULL))
+		return true;
+	if (fio_uring_is_broken)
+		return false;
+	pthread_once(&fio_uring_key_once, fio_uring_create_key);
+	struct fio_uring *ring = fio_uring_new();
+	if (ring == NULL) {
+		say_syserror("failed to initialize io_uring, "
+			     "falling back on system calls");
+		fio_uring_is_broken = true;
+		return false;
+	}
+	if (pthread_setspecific(fio_uring_key, ring) != 0) {
+		say_syserror("pthread_setspecific");
+		fio_uring_delete(ring);
+		fio_uring_is_broken = true;
+		return false;
+	}
+	fio_uring = ring;
+	return true;
+}
+
+/**
+ * Get a submission queue entry of the current thread's ring.
+ * Since requests are submitted one at a time, there's always
+ * a free entry.
+ */
+static struct io_uring_sqe *
+fio_uring_get_sqe(struct fio_uring *ring)
+{
+	unsigned tail = *ring->sq_tail;
+	unsigned index = tail & *ring->sq_mask;
+	assert(tail - __atomic_load_n(ring->sq_head, __ATOMIC_ACQUIRE) <
+	       FIO_URING_ENTRIES);
+	struct io_uring_sqe *sqe = &ring->sqes[index];
+	memset(sqe, 0, sizeof(*sqe));
+	ring->sq_array[index] = index;
+	return sqe;
+}
+
+/**
+ * Submit the request prepared with fio_uring_get_sqe() and wait
+ * for its completion. Returns the request result.
+ */
+static int
+fio_uring_submit_and_wait(struct fio_uring *ring)
+{
+	unsigned tail = *ring->sq_tail;
+	__atomic_store_n(ring->sq_tail, tail + 1, __ATOMIC_RELEASE);
+	unsigned to_submit = 1;
+	unsigned head = *ring->cq_head;
+	while (head == __atomic_load_n(ring->cq_tail, __ATOMIC_ACQUIRE)) {
+		int rc = syscall(__NR_io_uring_enter, ring->fd, to_submit,
+				 1, IORING_ENTER_GETEVENTS, NULL, 0);
+		if (rc >= 0) {
+			to_submit -= MIN((unsigned)rc, to_submit);
+			continue;
+		}
+		if (errno == EINTR)
+			continue;
+		if (to_submit > 0) {
+			/*
+			 * The kernel consumes submission entries only
+			 * in io_uring_enter() so we can safely take
+			 * the request back.
+			 */
+			__atomic_store_n(ring->sq_tail, tail,
+					 __ATOMIC_RELEASE);
+			return -1;
+		}
+		/*
+		 * The request is in flight and may still access
+		 * the caller's buffers so we can't return.
+		 */
+		if (errno != EAGAIN && errno != EBUSY)
+			panic_syserror("io_uring_enter");
+	}
+	struct io_uring_cqe *cqe = &ring->cqes[head & *ring->cq_mask];
+	int res = cqe->res;
+	__atomic_store_n(ring->cq_head, head + 1, __ATOMIC_RELEASE);
+	if (res < 0) {
+		errno = -res;
+		return -1;
+	}
+	return res;
+}
+
+ssize_t
+fio_uring_writev(int fd, const struct iovec *iov, int iovcnt)
+{
+	struct fio_uring *ring = fio_uring;
+	assert(ring != NULL);
+	struct io_uring_sqe *sqe = fio_uring_get_sqe(ring);
+	sqe->opcode = IORING_OP_WRITEV;
+	sqe->fd = fd;
+	sqe->off = (uint64_t)-1;
+	sqe->addr = (uint64_t)(uintptr_t)iov;
+	sqe->len = iovcnt;
+	return fio_uring_submit_and_wait(ring);
+}
+
+ssize_t
+fio_uring_pread(int fd, void *buf, size_t count, off_t offset)
+{
+	struct fio_uring *ring = fio_uring;
+	assert(ring != NULL);
+	struct iovec iov = {buf, count};
+	struct io_uring_sqe *sqe = fio_uring_get_sqe(ring);
+	sqe->opcode = IORING_OP_READV;
+	sqe->fd = fd;
+	sqe->off = offset;
+	sqe->addr = (uint64_t)(uintptr_t)&iov;
+	sqe->len = 1;
+	return fio_uring_submit_and_wait(ring);
+}
+
+int
+fio_uring_fsync(int fd)
+{
+	struct fio_uring *ring = fio_uring;
+	assert(ring != NULL);
+	struct io_uring_sqe *sqe = fio_uring_get_sqe(ring);
+	sqe->opcode = IORING_OP_FSYNC;
+	sqe->fd = fd;
+	return fio_uring_submit_and_wait(ring) < 0 ? -1 : 0;
+}
+
+#endif /* defined(HAVE_IO_URING) */
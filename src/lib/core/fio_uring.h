@@ -0,0 +1,119 @@
+#ifndef TARANTOOL_LIB_CORE_FIO_URING_H_INCLUDED
+#define TARANTOOL_LIB_CORE_FIO_URING_H_INCLUDED
+/*
+ * Copyright 2010-2021, Tarantool AUTHORS, please see AUTHORS file.
+ *
+ * Redistribution and use in source and binary forms, with or
+ * without modification, are permitted provided that the following
+ * conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above
+ *    copyright notice, this list of conditions and the
+ *    following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above
+ *    copyright notice, this list of conditions and the following
+ *    disclaimer in the documentation and/or other materials
+ *    provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY <COPYRIGHT HOLDER> ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ * TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL
+ * <COPYRIGHT HOLDER> OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+ * BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF
+ * THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+#include <stdbool.h>
+#include <sys/types.h>
+#include <sys/uio.h>
+
+#include "trivia/util.h"
+
+#if defined(__cplusplus)
+extern "C" {
+#endif /* defined(__cplusplus) */
+
+/*
+ * Minimal synchronous io_uring interface used by fio to submit
+ * file I/O requests. Each thread has its own ring, which is
+ * created on demand and destroyed on thread exit. Requests are
+ * submitted one at a time, the caller is blocked until the
+ * request completes, so the functions below are drop-in
+ * replacements for the corresponding system calls. They return
+ * -1 and set errno on failure.
+ */
+
+#if defined(HAVE_IO_URING)
+
+/**
+ * Check if io_uring can be used in the calling thread.
+ * Creates the thread's ring on the first call. If the ring
+ * can't be created, e.g. because the kernel is too old or the
+ * system call is forbidden, logs a warning and returns false.
+ */
+bool
+fio_uring_is_available(void);
+
+/** Same as writev(2), writes at the current file position. */
+ssize_t
+fio_uring_writev(int fd, const struct iovec *iov, int iovcnt);
+
+/** Same as pread(2). */
+ssize_t
+fio_uring_pread(int fd, void *buf, size_t count, off_t offset);
+
+/** Same as fsync(2). */
+int
+fio_uring_fsync(int fd);
+
+#else /* !defined(HAVE_IO_URING) */
+
+static inline bool
+fio_uring_is_available(void)
+{
+	return false;
+}
+
+static inline ssize_t
+fio_uring_writev(int fd, const struct iovec *iov, int iovcnt)
+{
+	(void)fd;
+	(void)iov;
+	(void)iovcnt;
+	unreachable();
+	return -1;
+}
+
+static inline ssize_t
+fio_uring_pread(int fd, void *buf, size_t count, off_t offset)
+{
+	(void)fd;
+	(void)buf;
+	(void)count;
+	(void)offset;
+	unreachable();
+	return -1;
+}
+
+static inline int
+fio_uring_fsync(int fd)
+{
+	(void)fd;
+	unreachable();
+	return -1;
+}
+
+#endif /* !defined(HAVE_IO_URING) */
+
+#if defined(__cplusplus)
+} /* extern "C" */
+#endif /* defined(__cplusplus) */
+
+#endif /* TARANTOOL_LIB_CORE_FIO_URING_H_INCLUDED */
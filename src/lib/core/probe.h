@@ -0,0 +1,39 @@
+/*
+ * SPDX-License-Identifier: BSD-2-Clause
+ *
+ * Copyright 2010-2026, Tarantool AUTHORS, please see AUTHORS file.
+ */
+#pragma once
+
+/**
+ * Static tracepoints (USDT) for SystemTap, bpftrace and perf.
+ *
+ * A probe compiles to a single nop and a note in the .note.stapsdt
+ * section, which a tracer replaces with a breakpoint when it attaches.
+ * The arguments are computed even if nothing is attached, so they
+ * must be cheap to get, e.g. fields of structures at hand.
+ *
+ * All probes belong to the "tarantool" provider, so they can be
+ * listed with `bpftrace -l 'usdt:/path/to/tarantool:tarantool:*'`.
+ * PROBE1(txn_commit_start, id) is usdt::tarantool:txn_commit_start.
+ */
+#include "trivia/config.h"
+
+#if defined(ENABLE_USDT)
+
+#include <sys/sdt.h>
+
+#define PROBE0(name) STAP_PROBE(tarantool, name)
+#define PROBE1(name, a1) STAP_PROBE1(tarantool, name, a1)
+#define PROBE2(name, a1, a2) STAP_PROBE2(tarantool, name, a1, a2)
+#define PROBE3(name, a1, a2, a3) STAP_PROBE3(tarantool, name, a1, a2, a3)
+
+#else /* !defined(ENABLE_USDT) */
+
+#define PROBE0(name) do {} while (0)
+#define PROBE1(name, a1) do { (void)(a1); } while (0)
+#define PROBE2(name, a1, a2) do { (void)(a1); (void)(a2); } while (0)
+#define PROBE3(name, a1, a2, a3) \
+	do { (void)(a1); (void)(a2); (void)(a3); } while (0)
+
+#endif /* !defined(ENABLE_USDT) */
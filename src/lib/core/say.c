@@ -46,7 +46,9 @@
 #include <sys/socket.h>
 #include <sys/un.h>
 #include <arpa/inet.h>
+#include <pthread.h>
 #include <coio_task.h>
+#include "tt_pthread.h"
 
 pid_t log_pid = 0;
 int log_level = S_INFO;
@@ -750,8 +752,10 @@ fail:
 void
 say_logger_free(void)
 {
-	if (say_logger_initialized())
+	if (say_logger_initialized()) {
+		say_set_log_async(false);
 		log_destroy(&log_std);
+	}
 }
 
 /** {{{ Formatters */
@@ -1074,6 +1078,238 @@ write_to_syslog(struct log *log, int total)
 
 /** Loggers }}} */
 
+/**
+ * Write a message of @a total bytes formatted in the thread-local
+ * buffer to the log.
+ */
+static void
+log_write(struct log *log, int level, int total)
+{
+	switch (log->type) {
+	case SAY_LOGGER_FILE:
+	case SAY_LOGGER_PIPE:
+	case SAY_LOGGER_STDERR:
+		write_to_file(log, total);
+		break;
+	case SAY_LOGGER_SYSLOG:
+		write_to_syslog(log, total);
+		if (level == S_FATAL && log->fd != STDERR_FILENO)
+			(void) safe_write(STDERR_FILENO, buf, total);
+		break;
+	case SAY_LOGGER_BOOT:
+	{
+		ssize_t r = safe_write(STDERR_FILENO, buf, total);
+		(void) r;                       /* silence gcc warning */
+		break;
+	}
+	default:
+		unreachable();
+	}
+}
+
+/** {{{ Asynchronous logging */
+
+/**
+ * Messages of the default logger are put in a ring buffer, each
+ * prefixed with its length, and written out by the logger thread.
+ * The queue is shared by all threads and protected by a mutex: the
+ * critical section is a memcpy of one message, so contention costs
+ * much less than the write() it replaces.
+ *
+ * Plain pthread calls are used on the logging path rather than
+ * tt_pthread wrappers, because the latter log errors.
+ */
+enum { SAY_ASYNC_QUEUE_SIZE = 1024 * 1024 };
+
+static struct {
+	pthread_mutex_t mutex;
+	/** Signaled when a message is queued or the thread must stop. */
+	pthread_cond_t cond_nonempty;
+	/** Signaled when the logger thread frees space in the queue. */
+	pthread_cond_t cond_nonfull;
+	/** Ring buffer of SAY_ASYNC_QUEUE_SIZE bytes. */
+	char *queue;
+	/** Read and write positions, wrapped on access. */
+	size_t rpos;
+	size_t wpos;
+	/** Set to make the logger thread exit once the queue is empty. */
+	bool is_stopping;
+	/** Set while the logger thread is running. */
+	bool is_enabled;
+	enum say_async_overflow overflow;
+	/** Number of messages dropped due to queue overflow. */
+	uint64_t dropped;
+	pthread_t thread;
+} say_async = {
+	.mutex = PTHREAD_MUTEX_INITIALIZER,
+	.cond_nonempty = PTHREAD_COND_INITIALIZER,
+	.cond_nonfull = PTHREAD_COND_INITIALIZER,
+	.overflow = SAY_ASYNC_OVERFLOW_DROP,
+};
+
+static const char *say_async_overflow_strs[] = {
+	[SAY_ASYNC_OVERFLOW_DROP] = "drop",
+	[SAY_ASYNC_OVERFLOW_BLOCK] = "block",
+	[say_async_overflow_MAX] = "unknown"
+};
+
+enum say_async_overflow
+say_async_overflow_by_name(const char *name)
+{
+	return STR2ENUM(say_async_overflow, name);
+}
+
+/** Copy @a size bytes to the queue at the write position. */
+static void
+say_async_queue_write(const void *data, size_t size)
+{
+	size_t pos = say_async.wpos % SAY_ASYNC_QUEUE_SIZE;
+	size_t n = MIN(size, SAY_ASYNC_QUEUE_SIZE - pos);
+	memcpy(say_async.queue + pos, data, n);
+	memcpy(say_async.queue, (const char *)data + n, size - n);
+	say_async.wpos += size;
+}
+
+/** Copy @a size bytes from the queue at the read position. */
+static void
+say_async_queue_read(void *data, size_t size)
+{
+	size_t pos = say_async.rpos % SAY_ASYNC_QUEUE_SIZE;
+	size_t n = MIN(size, SAY_ASYNC_QUEUE_SIZE - pos);
+	memcpy(data, say_async.queue + pos, n);
+	memcpy((char *)data + n, say_async.queue, size - n);
+	say_async.rpos += size;
+}
+
+/**
+ * Queue a message of @a total bytes formatted in the thread-local
+ * buffer for the logger thread.
+ */
+static void
+say_async_push(int level, int total)
+{
+	uint32_t len = MIN(total, SAY_BUF_LEN_MAX - 1);
+	size_t size = sizeof(len) + len;
+	bool is_self = pthread_equal(pthread_self(), say_async.thread);
+	pthread_mutex_lock(&say_async.mutex);
+	while (say_async.is_enabled && !say_async.is_stopping && !is_self &&
+	       say_async.wpos - say_async.rpos + size > SAY_ASYNC_QUEUE_SIZE) {
+		if (say_async.overflow == SAY_ASYNC_OVERFLOW_DROP) {
+			say_async.dropped++;
+			pthread_mutex_unlock(&say_async.mutex);
+			return;
+		}
+		pthread_cond_wait(&say_async.cond_nonfull, &say_async.mutex);
+	}
+	if (!say_async.is_enabled || say_async.is_stopping || is_self) {
+		/*
+		 * The mode is being disabled or the logger thread
+		 * logs something itself: don't wait for the thread.
+		 */
+		pthread_mutex_unlock(&say_async.mutex);
+		log_write(log_default, level, len);
+		return;
+	}
+	say_async_queue_write(&len, sizeof(len));
+	say_async_queue_write(buf, len);
+	pthread_cond_signal(&say_async.cond_nonempty);
+	pthread_mutex_unlock(&say_async.mutex);
+}
+
+/** Logger thread function: writes out queued messages. */
+static void *
+say_async_f(void *arg)
+{
+	(void)arg;
+	tt_pthread_setname("logger");
+	pthread_mutex_lock(&say_async.mutex);
+	while (true) {
+		while (say_async.wpos == say_async.rpos &&
+		       !say_async.is_stopping) {
+			pthread_cond_wait(&say_async.cond_nonempty,
+					  &say_async.mutex);
+		}
+		if (say_async.wpos == say_async.rpos)
+			break;
+		uint32_t len;
+		say_async_queue_read(&len, sizeof(len));
+		say_async_queue_read(buf, len);
+		pthread_cond_broadcast(&say_async.cond_nonfull);
+		pthread_mutex_unlock(&say_async.mutex);
+		log_write(log_default, S_INFO, len);
+		pthread_mutex_lock(&say_async.mutex);
+	}
+	pthread_mutex_unlock(&say_async.mutex);
+	return NULL;
+}
+
+int
+say_set_log_async(bool is_enabled)
+{
+	if (is_enabled == say_async.is_enabled)
+		return 0;
+	if (is_enabled) {
+		char *queue = malloc(SAY_ASYNC_QUEUE_SIZE);
+		if (queue == NULL) {
+			diag_set(OutOfMemory, SAY_ASYNC_QUEUE_SIZE, "malloc",
+				 "log queue");
+			return -1;
+		}
+		say_async.queue = queue;
+		say_async.rpos = say_async.wpos = 0;
+		say_async.is_stopping = false;
+		if (tt_pthread_create(&say_async.thread, NULL,
+				      say_async_f, NULL) != 0) {
+			diag_set(SystemError, "failed to start logger thread");
+			free(queue);
+			say_async.queue = NULL;
+			return -1;
+		}
+		pm_atomic_store(&say_async.is_enabled, true);
+		return 0;
+	}
+	pthread_mutex_lock(&say_async.mutex);
+	say_async.is_stopping = true;
+	pthread_cond_signal(&say_async.cond_nonempty);
+	pthread_mutex_unlock(&say_async.mutex);
+	pthread_join(say_async.thread, NULL);
+	pthread_mutex_lock(&say_async.mutex);
+	pm_atomic_store(&say_async.is_enabled, false);
+	/* Wake up writers blocked on overflow, if any. */
+	pthread_cond_broadcast(&say_async.cond_nonfull);
+	pthread_mutex_unlock(&say_async.mutex);
+	free(say_async.queue);
+	say_async.queue = NULL;
+	return 0;
+}
+
+void
+say_set_log_async_overflow(enum say_async_overflow overflow)
+{
+	assert(overflow < say_async_overflow_MAX);
+	pthread_mutex_lock(&say_async.mutex);
+	say_async.overflow = overflow;
+	pthread_mutex_unlock(&say_async.mutex);
+}
+
+bool
+say_log_async_is_enabled(void)
+{
+	return pm_atomic_load(&say_async.is_enabled);
+}
+
+void
+say_log_async_stat(struct say_async_stat *stat)
+{
+	pthread_mutex_lock(&say_async.mutex);
+	stat->queue_size = say_async.is_enabled ? SAY_ASYNC_QUEUE_SIZE : 0;
+	stat->queue_used = say_async.wpos - say_async.rpos;
+	stat->dropped = say_async.dropped;
+	pthread_mutex_unlock(&say_async.mutex);
+}
+
+/** Asynchronous logging }}} */
+
 /*
  * Init string parser(s)
  */
@@ -1242,26 +1478,11 @@ log_vsay(struct log *log, int level, const char *filename, int line,
 	}
 	int total = log->format_func(log, buf, sizeof(buf), level,
 				     filename, line, error, format, ap);
-	switch (log->type) {
-	case SAY_LOGGER_FILE:
-	case SAY_LOGGER_PIPE:
-	case SAY_LOGGER_STDERR:
-		write_to_file(log, total);
-		break;
-	case SAY_LOGGER_SYSLOG:
-		write_to_syslog(log, total);
-		if (level == S_FATAL && log->fd != STDERR_FILENO)
-			(void) safe_write(STDERR_FILENO, buf, total);
-		break;
-	case SAY_LOGGER_BOOT:
-	{
-		ssize_t r = safe_write(STDERR_FILENO, buf, total);
-		(void) r;                       /* silence gcc warning */
-		break;
-	}
-	default:
-		unreachable();
-	}
+	if (log == log_default && level != S_FATAL &&
+	    pm_atomic_load(&say_async.is_enabled))
+		say_async_push(level, total);
+	else
+		log_write(log, level, total);
 	errno = errsv; /* Preserve the errno. */
 	return total;
 }
@@ -34,6 +34,7 @@
 #include <stdlib.h>
 #include <stdbool.h>
 #include <stdarg.h>
+#include <stdint.h>
 #include <errno.h>
 #include <sys/types.h> /* pid_t */
 #include <tarantool_ev.h>
@@ -261,6 +262,70 @@ say_set_log_format(enum say_format format);
 enum say_format
 say_format_by_name(const char *format);
 
+/**
+ * What to do with a message written to the asynchronous logger
+ * when its queue is full.
+ */
+enum say_async_overflow {
+	/** Drop the message and account it in the stats. */
+	SAY_ASYNC_OVERFLOW_DROP,
+	/** Block the writer until the logger thread frees space. */
+	SAY_ASYNC_OVERFLOW_BLOCK,
+	say_async_overflow_MAX
+};
+
+/**
+ * Return asynchronous logger overflow policy by name.
+ *
+ * @param name policy name.
+ * @retval say_async_overflow_MAX on error
+ * @retval say_async_overflow otherwise
+ */
+enum say_async_overflow
+say_async_overflow_by_name(const char *name);
+
+/** Asynchronous logger statistics. */
+struct say_async_stat {
+	/** Size of the message queue, in bytes. */
+	size_t queue_size;
+	/** Size of messages waiting in the queue, in bytes. */
+	size_t queue_used;
+	/** Number of messages dropped due to queue overflow. */
+	uint64_t dropped;
+};
+
+/**
+ * Enable or disable asynchronous logging for the default logger.
+ *
+ * In the asynchronous mode, messages are formatted by the thread
+ * that writes them, like in the synchronous mode, but instead of
+ * being written out right away, they are put in a queue that is
+ * drained by a dedicated logger thread, so that a slow log device
+ * doesn't stall the writer. Fatal messages are always written
+ * synchronously. Disabling the mode waits for the queue to be
+ * drained.
+ *
+ * @retval 0 on success
+ * @retval -1 on failure to start the logger thread, diag is set
+ */
+int
+say_set_log_async(bool is_enabled);
+
+/**
+ * Set the asynchronous logger queue overflow policy.
+ * Can be used dynamically.
+ */
+void
+say_set_log_async_overflow(enum say_async_overflow overflow);
+
+/** Return true if asynchronous logging is enabled. */
+bool
+say_log_async_is_enabled(void);
+
+/** Get asynchronous logger statistics. */
+void
+say_log_async_stat(struct say_async_stat *stat);
+
 struct ev_loop;
 struct ev_signal;
 
@@ -0,0 +1,206 @@
+/*
+ * SPDX-License-Identifier: BSD-2-Clause
+ *
+ * Copyright 2010-2022, Tarantool AUTHORS, please see AUTHORS file.
+ */
+#include "thread_pool.h"
+
+#include <assert.h>
+#include <stdlib.h>
+
+#include "diag.h"
+#include "fiber.h"
+#include "say.h"
+#include "trivia/util.h"
+#include "tt_pthread.h"
+#include "tt_static.h"
+
+/**
+ * Take a task from the queue of @a worker: the oldest one if the
+ * worker is the queue owner, the newest one if it's stolen.
+ */
+static struct thread_pool_task *
+thread_pool_worker_pop(struct thread_pool_worker *worker, bool is_steal)
+{
+	struct thread_pool_task *task = NULL;
+	tt_pthread_mutex_lock(&worker->mutex);
+	if (!rlist_empty(&worker->queue)) {
+		if (is_steal) {
+			task = rlist_last_entry(&worker->queue,
+						struct thread_pool_task,
+						in_queue);
+		} else {
+			task = rlist_first_entry(&worker->queue,
+						 struct thread_pool_task,
+						 in_queue);
+		}
+		rlist_del_entry(task, in_queue);
+	}
+	tt_pthread_mutex_unlock(&worker->mutex);
+	return task;
+}
+
+/**
+ * Take a task from the worker's own queue or, if it's empty, steal
+ * one from another worker. Returns NULL if all queues are empty.
+ */
+static struct thread_pool_task *
+thread_pool_worker_take(struct thread_pool_worker *worker)
+{
+	struct thread_pool *pool = worker->pool;
+	struct thread_pool_task *task = thread_pool_worker_pop(worker, false);
+	for (int i = 1; task == NULL && i < pool->worker_count; i++) {
+		int victim = (worker->id + i) % pool->worker_count;
+		task = thread_pool_worker_pop(&pool->workers[victim], true);
+	}
+	return task;
+}
+
+static void *
+thread_pool_worker_f(void *arg)
+{
+	struct thread_pool_worker *worker = arg;
+	struct thread_pool *pool = worker->pool;
+	tt_pthread_mutex_lock(&pool->mutex);
+	while (true) {
+		while (pool->pending_count == 0 && !pool->is_shutdown)
+			tt_pthread_cond_wait(&pool->cond, &pool->mutex);
+		if (pool->pending_count == 0)
+			break;
+		tt_pthread_mutex_unlock(&pool->mutex);
+		struct thread_pool_task *task = thread_pool_worker_take(worker);
+		tt_pthread_mutex_lock(&pool->mutex);
+		if (task == NULL) {
+			/* Taken by another worker, which is yet to account it. */
+			continue;
+		}
+		pool->pending_count--;
+		tt_pthread_mutex_unlock(&pool->mutex);
+
+		int rc = task->f(task);
+		if (rc != 0)
+			diag_move(diag_get(), &task->diag);
+
+		tt_pthread_mutex_lock(&pool->mutex);
+		/*
+		 * The caller checks completion under the mutex, so it
+		 * can't free the task while we're sending the event.
+		 */
+		task->rc = rc;
+		task->is_complete = true;
+		ev_async_send(task->loop, &task->async);
+	}
+	tt_pthread_mutex_unlock(&pool->mutex);
+	return NULL;
+}
+
+int
+thread_pool_create(struct thread_pool *pool, const char *name,
+		   int worker_count)
+{
+	assert(worker_count > 0);
+	pool->workers = calloc(worker_count, sizeof(*pool->workers));
+	if (pool->workers == NULL) {
+		diag_set(OutOfMemory, worker_count * sizeof(*pool->workers),
+			 "calloc", "thread pool workers");
+		return -1;
+	}
+	pool->worker_count = 0;
+	pool->pending_count = 0;
+	pool->is_shutdown = false;
+	pool->next_worker = 0;
+	tt_pthread_mutex_init(&pool->mutex, NULL);
+	tt_pthread_cond_init(&pool->cond, NULL);
+	for (int i = 0; i < worker_count; i++) {
+		struct thread_pool_worker *worker = &pool->workers[i];
+		worker->pool = pool;
+		worker->id = i;
+		tt_pthread_mutex_init(&worker->mutex, NULL);
+		rlist_create(&worker->queue);
+		if (cord_start(&worker->cord, tt_sprintf("%s.%d", name, i),
+			       thread_pool_worker_f, worker) != 0) {
+			tt_pthread_mutex_destroy(&worker->mutex);
+			thread_pool_destroy(pool);
+			return -1;
+		}
+		pool->worker_count++;
+	}
+	return 0;
+}
+
+void
+thread_pool_destroy(struct thread_pool *pool)
+{
+	tt_pthread_mutex_lock(&pool->mutex);
+	pool->is_shutdown = true;
+	tt_pthread_cond_broadcast(&pool->cond);
+	tt_pthread_mutex_unlock(&pool->mutex);
+	for (int i = 0; i < pool->worker_count; i++) {
+		struct thread_pool_worker *worker = &pool->workers[i];
+		if (cord_join(&worker->cord) != 0) {
+			/* We can't recover from this in any reasonable way. */
+			panic_syserror("thread pool: thread join failed");
+		}
+		assert(rlist_empty(&worker->queue));
+		tt_pthread_mutex_destroy(&worker->mutex);
+	}
+	tt_pthread_cond_destroy(&pool->cond);
+	tt_pthread_mutex_destroy(&pool->mutex);
+	free(pool->workers);
+	pool->workers = NULL;
+	pool->worker_count = 0;
+}
+
+static void
+thread_pool_task_complete_cb(struct ev_loop *loop, struct ev_async *watcher,
+			     int events)
+{
+	(void)loop;
+	(void)events;
+	struct thread_pool_task *task =
+		container_of(watcher, struct thread_pool_task, async);
+	fiber_wakeup(task->caller);
+}
+
+int
+thread_pool_call(struct thread_pool *pool, struct thread_pool_task *task)
+{
+	assert(task->f != NULL);
+	assert(pool->worker_count > 0);
+	task->caller = fiber();
+	task->loop = loop();
+	task->is_complete = false;
+	task->rc = 0;
+	diag_create(&task->diag);
+	ev_async_init(&task->async, thread_pool_task_complete_cb);
+	ev_async_start(task->loop, &task->async);
+
+	tt_pthread_mutex_lock(&pool->mutex);
+	assert(!pool->is_shutdown);
+	struct thread_pool_worker *worker =
+		&pool->workers[pool->next_worker++ % pool->worker_count];
+	tt_pthread_mutex_lock(&worker->mutex);
+	rlist_add_tail_entry(&worker->queue, task, in_queue);
+	tt_pthread_mutex_unlock(&worker->mutex);
+	pool->pending_count++;
+	tt_pthread_cond_signal(&pool->cond);
+	tt_pthread_mutex_unlock(&pool->mutex);
+
+	bool cancellable = fiber_set_cancellable(false);
+	while (true) {
+		tt_pthread_mutex_lock(&pool->mutex);
+		bool is_complete = task->is_complete;
+		tt_pthread_mutex_unlock(&pool->mutex);
+		if (is_complete)
+			break;
+		fiber_yield();
+	}
+	fiber_set_cancellable(cancellable);
+	ev_async_stop(task->loop, &task->async);
+
+	int rc = task->rc;
+	if (rc != 0)
+		diag_move(&task->diag, diag_get());
+	diag_destroy(&task->diag);
+	return rc;
+}
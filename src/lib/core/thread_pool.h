@@ -0,0 +1,131 @@
+/*
+ * SPDX-License-Identifier: BSD-2-Clause
+ *
+ * Copyright 2010-2022, Tarantool AUTHORS, please see AUTHORS file.
+ */
+#pragma once
+
+#include <pthread.h>
+#include <stdbool.h>
+
+#include "diag.h"
+#include "fiber.h"
+#include "tarantool_ev.h"
+#include "small/rlist.h"
+
+#if defined(__cplusplus)
+extern "C" {
+#endif
+
+/**
+ * A pool of worker threads executing CPU-heavy tasks that don't
+ * need Lua, fibers or the event loop, such as hashing, sorting or
+ * compression.
+ *
+ * A task is submitted from a fiber of any cord, which then waits
+ * for its completion without blocking the cord: the worker that
+ * executes the task notifies the caller's event loop.
+ *
+ * Every worker has its own queue. Submitted tasks are spread over
+ * the queues round-robin. A worker executes tasks from its own
+ * queue in order; when the queue is empty, it steals the most
+ * recently queued task from another worker, so one long task
+ * doesn't delay the tasks queued after it while others are idle.
+ */
+
+struct thread_pool;
+struct thread_pool_task;
+
+/**
+ * Task function executed by a worker thread. On failure, it must
+ * return -1 and set diag, otherwise 0.
+ */
+typedef int (*thread_pool_f)(struct thread_pool_task *task);
+
+struct thread_pool_task {
+	/** Function to execute. */
+	thread_pool_f f;
+	/** Fiber waiting for the task to complete. */
+	struct fiber *caller;
+	/** Used to notify the caller's event loop of completion. */
+	struct ev_async async;
+	/** Event loop of the caller. */
+	struct ev_loop *loop;
+	/** Set by the worker when the task is complete. */
+	bool is_complete;
+	/** Return code of the task function. */
+	int rc;
+	/** Error set by the task function, moved to the caller. */
+	struct diag diag;
+	/** Link in a worker queue. */
+	struct rlist in_queue;
+};
+
+/** Worker thread of a pool. */
+struct thread_pool_worker {
+	/** The pool the worker belongs to. */
+	struct thread_pool *pool;
+	/** Index of the worker in the pool. */
+	int id;
+	/** Protects the queue. */
+	pthread_mutex_t mutex;
+	/** Tasks submitted to this worker. */
+	struct rlist queue;
+	/** The worker thread. */
+	struct cord cord;
+};
+
+struct thread_pool {
+	/** Worker array. */
+	struct thread_pool_worker *workers;
+	/** Number of workers. */
+	int worker_count;
+	/** Protects the fields below. */
+	pthread_mutex_t mutex;
+	/** Signaled when a task is submitted or on shutdown. */
+	pthread_cond_t cond;
+	/** Number of tasks queued but not taken by a worker yet. */
+	int pending_count;
+	/** Set when the pool is being destroyed. */
+	bool is_shutdown;
+	/** The worker to submit the next task to. */
+	unsigned next_worker;
+};
+
+/**
+ * Start a thread pool with @a worker_count workers, whose threads
+ * are named @a name.
+ *
+ * @retval  0 on success
+ * @retval -1 on error, diag is set
+ */
+int
+thread_pool_create(struct thread_pool *pool, const char *name,
+		   int worker_count);
+
+/**
+ * Stop the pool threads and free the pool. Tasks must not be
+ * submitted to the pool after this function is called. The
+ * tasks queued before are executed.
+ */
+void
+thread_pool_destroy(struct thread_pool *pool);
+
+/**
+ * Execute @a task in the pool and wait for it to complete. Only
+ * the calling fiber is suspended, the cord keeps running.
+ *
+ * The caller fills in the task function and any arguments it
+ * needs, typically by embedding the task struct in a bigger one.
+ * The wait can't be cancelled, because the task may still be using
+ * the memory owned by the caller.
+ *
+ * @retval  0 on success
+ * @retval -1 on error, diag is set to the task function error
+ */
+int
+thread_pool_call(struct thread_pool *pool, struct thread_pool_task *task);
+
+#if defined(__cplusplus)
+} /* extern "C" */
+#endif /* defined(__cplusplus) */
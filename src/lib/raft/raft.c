@@ -225,6 +225,13 @@ static void
 raft_sm_schedule_new_election_cb(struct ev_loop *loop, struct ev_timer *timer,
 				 int events);
 
+/**
+ * Start a new election if the leader is not seen by this node, and nobody else
+ * reports that it sees the leader.
+ */
+static void
+raft_sm_check_leader_witness(struct raft *raft);
+
 /** Start Raft state flush to disk. */
 static void
 raft_sm_pause_and_dump(struct raft *raft);
@@ -269,6 +276,12 @@ raft_msg_to_string(const struct raft_msg *req)
 		pos += rc;
 		size -= rc;
 	}
+	if (req->is_leader_seen) {
+		rc = snprintf(pos, size, ", leader is seen");
+		assert(rc >= 0 && rc < size);
+		pos += rc;
+		size -= rc;
+	}
 	rc = snprintf(pos, size, "}");
 	assert(rc >= 0 && rc < size);
 	pos += rc;
@@ -330,6 +343,17 @@ raft_process_msg(struct raft *raft, const struct raft_msg *req, uint32_t source)
 	/* Term bump. */
 	if (req->term > raft->volatile_term)
 		raft_sm_schedule_new_term(raft, req->term);
+	/*
+	 * The sender tells whether it sees the leader of the current term. That
+	 * is only valid if the persisted term of the sender is the same.
+	 */
+	if (req->term == raft->volatile_term) {
+		if (req->is_leader_seen) {
+			bit_set(&raft->leader_witness_map, source);
+		} else if (bit_clear(&raft->leader_witness_map, source)) {
+			raft_sm_check_leader_witness(raft);
+		}
+	}
 	/*
 	 * Either a vote request during an on-going election. Or an old vote
 	 * persisted long time ago and still broadcasted. Or a vote response.
@@ -466,6 +490,12 @@ raft_process_heartbeat(struct raft *raft, uint32_t source)
 	/* Not interested in heartbeats from not a leader. */
 	if (raft->leader != source)
 		return;
+	if (!raft->is_leader_seen) {
+		say_info("RAFT: leader %u is seen again", source);
+		raft->is_leader_seen = true;
+		/* Visible to the other nodes - broadcast. */
+		raft_schedule_broadcast(raft);
+	}
 	/*
 	 * The instance currently is busy with writing something on disk. Can't
 	 * react to heartbeats.
@@ -483,6 +513,19 @@ raft_process_heartbeat(struct raft *raft, uint32_t source)
 	raft_sm_wait_leader_dead(raft);
 }
 
+void
+raft_process_disconnect(struct raft *raft, uint32_t source)
+{
+	if (source == 0 || source == raft->self)
+		return;
+	/*
+	 * Nothing is known about the instance anymore. It may still see the
+	 * leader, but it can't tell about it.
+	 */
+	if (bit_clear(&raft->leader_witness_map, source))
+		raft_sm_check_leader_witness(raft);
+}
+
 /* Dump Raft state to WAL in a blocking way. */
 static void
 raft_worker_handle_io(struct raft *raft)
@@ -568,6 +611,7 @@ raft_worker_handle_broadcast(struct raft *raft)
 		assert(raft->vote == raft->self);
 		req.vclock = raft->vclock;
 	}
+	req.is_leader_seen = raft_is_leader_seen(raft);
 	raft_broadcast(raft, &req);
 	raft->is_broadcast_scheduled = false;
 }
@@ -625,6 +669,7 @@ raft_sm_follow_leader(struct raft *raft, uint32_t leader)
 	assert(raft->leader == 0);
 	raft->state = RAFT_STATE_FOLLOWER;
 	raft->leader = leader;
+	raft->is_leader_seen = true;
 	if (!raft->is_write_in_progress && raft->is_candidate) {
 		raft_ev_timer_stop(raft_loop(), &raft->timer);
 		raft_sm_wait_leader_dead(raft);
@@ -663,6 +708,8 @@ raft_sm_schedule_new_term(struct raft *raft, uint64_t new_term)
 	raft->volatile_vote = 0;
 	raft->leader = 0;
 	raft->state = RAFT_STATE_FOLLOWER;
+	/* The witnesses saw the leader of the old term. */
+	raft->leader_witness_map = 0;
 	/*
 	 * The instance could be promoted for the previous term. But promotion
 	 * has no effect on following terms.
@@ -712,6 +759,42 @@ raft_sm_schedule_new_election_cb(struct ev_loop *loop, struct ev_timer *timer,
 	 */
 	assert(raft_is_fully_on_disk(raft));
 	raft_ev_timer_stop(loop, timer);
+	if (raft->leader != 0 && raft->leader_witness_map != 0) {
+		/*
+		 * The leader is not heard by this node, but some other nodes
+		 * still hear it. Most likely only the link to this node is
+		 * broken. A new term would only interrupt the healthy leader.
+		 * Tell the others that the leader is lost here, and keep
+		 * waiting until the witnesses lose it too.
+		 */
+		if (raft->is_leader_seen) {
+			say_info("RAFT: leader %u is not seen, but other nodes "
+				 "still see it - election is not started",
+				 raft->leader);
+			raft->is_leader_seen = false;
+			raft_schedule_broadcast(raft);
+		}
+		raft_sm_wait_leader_dead(raft);
+		return;
+	}
+	raft_sm_schedule_new_election(raft);
+}
+
+static void
+raft_sm_check_leader_witness(struct raft *raft)
+{
+	if (raft->leader == 0 || raft->is_leader_seen ||
+	    raft->leader_witness_map != 0)
+		return;
+	/*
+	 * The death timeout has already expired, so the leader is not waited
+	 * for anymore.
+	 */
+	if (!raft->is_candidate || raft->is_write_in_progress ||
+	    raft->state != RAFT_STATE_FOLLOWER)
+		return;
+	say_info("RAFT: leader %u is not seen by anybody", raft->leader);
+	raft_ev_timer_stop(raft_loop(), &raft->timer);
 	raft_sm_schedule_new_election(raft);
 }
 
@@ -828,6 +911,7 @@ raft_checkpoint_remote(const struct raft *raft, struct raft_msg *req)
 	 */
 	if (req->state == RAFT_STATE_CANDIDATE)
 		req->vclock = raft->vclock;
+	req->is_leader_seen = raft_is_leader_seen(raft);
 }
 
 void
@@ -116,6 +116,12 @@ struct raft_msg {
 	 * Also is omitted when does not matter (when the message is for disk).
 	 */
 	const struct vclock *vclock;
+	/**
+	 * Flag whether the instance still hears the leader of the term. It is
+	 * a witness for the other nodes, which don't start a new election
+	 * while the leader is seen by anyone. Is not persisted.
+	 */
+	bool is_leader_seen;
 };
 
 typedef void (*raft_broadcast_f)(struct raft *raft, const struct raft_msg *req);
@@ -198,6 +204,20 @@ struct raft {
 	int vote_count;
 	/** Number of votes necessary for successful election. */
 	int election_quorum;
+	/**
+	 * Flag whether the heartbeats from the known leader are still
+	 * received. Valid only when the leader is known.
+	 */
+	bool is_leader_seen;
+	/**
+	 * Bit 1 on position N means that the instance with ID = N reported
+	 * that it sees the leader of the current term. While any bit is set,
+	 * this node doesn't start a new election even if it lost the leader
+	 * itself. It works as a pre-vote: a node with a broken link to a
+	 * healthy leader doesn't bump the term and doesn't disrupt the
+	 * cluster.
+	 */
+	vclock_map_t leader_witness_map;
 	/**
 	 * Vclock of the Raft node owner. Raft never changes it, only watches,
 	 * and makes decisions based on it. The value is not stored by copy so
@@ -243,6 +263,19 @@ raft_is_enabled(const struct raft *raft)
 	return raft->is_enabled;
 }
 
+/**
+ * Check if the instance can be a witness of the leader for the other nodes.
+ * Only candidate followers watch the leader's health, and only the persisted
+ * term is shared with the others.
+ */
+static inline bool
+raft_is_leader_seen(const struct raft *raft)
+{
+	return raft->state == RAFT_STATE_FOLLOWER && raft->is_candidate &&
+	       raft->leader != 0 &&
+	       raft->is_leader_seen && raft->term == raft->volatile_term;
+}
+
 /** Process a raft entry stored in WAL/snapshot. */
 void
 raft_process_recovery(struct raft *raft, const struct raft_msg *req);
@@ -263,6 +296,13 @@ raft_process_async(struct raft *raft);
 void
 raft_process_heartbeat(struct raft *raft, uint32_t source);
 
+/**
+ * Process a loss of connection to an instance with the given ID. The instance
+ * can't be a witness of the leader anymore.
+ */
+void
+raft_process_disconnect(struct raft *raft, uint32_t source);
+
 /** Configure whether Raft is enabled. */
 void
 raft_cfg_is_enabled(struct raft *raft, bool is_enabled);
@@ -302,6 +302,18 @@
  * #define BPS_BLOCK_LINEAR_SEARCH
  */
 
+/**
+ * A switch to prefetch blocks while descending the tree on lookup,
+ * insertion or deletion. A binary search in a block touches several
+ * cache lines one after another, and every probe depends on the
+ * previous one, so the lines are fetched from memory sequentially.
+ * With the switch on, as soon as the next block on the path is
+ * known, all its cache lines are requested at once, so that the
+ * misses overlap. It pays off on trees that don't fit in CPU
+ * caches. To turn it on,
+ * #define BPS_TREE_PREFETCH
+ */
+
 /**
  * A switch that enables collection of executions of different
  * branches of code. Used only for debug purposes, I hope you
@@ -410,6 +422,7 @@ typedef uint32_t bps_tree_block_id_t;
 
 #define bps_tree_restore_block _bps_tree(restore_block)
 #define bps_tree_restore_block_ver _bps_tree(restore_block_ver)
+#define bps_tree_prefetch_block _bps_tree(prefetch_block)
 #define bps_tree_root _bps_tree(root)
 #define bps_tree_touch_block _bps_tree(touch_block)
 #define bps_tree_find_ins_point_key _bps_tree(find_ins_point_key)
@@ -1303,6 +1316,23 @@ bps_tree_restore_block_ver(const struct bps_tree *tree, bps_tree_block_id_t id,
 	return (struct bps_block *)matras_view_get(&tree->matras, view, id);
 }
 
+/**
+ * @brief Start loading a block into CPU caches. See BPS_TREE_PREFETCH.
+ */
+static inline void
+bps_tree_prefetch_block(const struct bps_block *block)
+{
+#ifdef BPS_TREE_PREFETCH
+	enum { CACHE_LINE_SIZE = 64 };
+	const char *data = (const char *)block;
+	for (size_t offset = 0; offset < BPS_TREE_BLOCK_SIZE;
+	     offset += CACHE_LINE_SIZE)
+		__builtin_prefetch(data + offset, 0, 3);
+#else
+	(void)block;
+#endif
+}
+
 /**
  * @brief Get a pointer to block by it's ID.
  */
@@ -1710,6 +1740,7 @@ bps_tree_lower_bound(const struct bps_tree *tree, bps_tree_key_t key,
 						  key, exact);
 		block_id = inner->child_ids[pos];
 		block = bps_tree_restore_block(tree, block_id);
+		bps_tree_prefetch_block(block);
 	}
 
 	struct bps_leaf *leaf = (struct bps_leaf *)block;
@@ -1764,6 +1795,7 @@ bps_tree_upper_bound(const struct bps_tree *tree, bps_tree_key_t key,
 			*exact = true;
 		block_id = inner->child_ids[pos];
 		block = bps_tree_restore_block(tree, block_id);
+		bps_tree_prefetch_block(block);
 	}
 
 	struct bps_leaf *leaf = (struct bps_leaf *)block;
@@ -1818,6 +1850,7 @@ bps_tree_lower_bound_elem(const struct bps_tree *tree, bps_tree_elem_t key,
 						   key, exact);
 		block_id = inner->child_ids[pos];
 		block = bps_tree_restore_block(tree, block_id);
+		bps_tree_prefetch_block(block);
 	}
 
 	struct bps_leaf *leaf = (struct bps_leaf *)block;
@@ -1873,6 +1906,7 @@ bps_tree_upper_bound_elem(const struct bps_tree *tree, bps_tree_elem_t key,
 			*exact = true;
 		block_id = inner->child_ids[pos];
 		block = bps_tree_restore_block(tree, block_id);
+		bps_tree_prefetch_block(block);
 	}
 
 	struct bps_leaf *leaf = (struct bps_leaf *)block;
@@ -1944,9 +1978,11 @@ bps_tree_approximate_count(const struct bps_tree *tree, bps_tree_key_t key)
 		bps_tree_block_id_t lower_block_id =
 			lower_inner->child_ids[lower_pos];
 		lower_block = bps_tree_restore_block(tree, lower_block_id);
+		bps_tree_prefetch_block(lower_block);
 		bps_tree_block_id_t upper_block_id =
 			upper_inner->child_ids[upper_pos];
 		upper_block = bps_tree_restore_block(tree, upper_block_id);
+		bps_tree_prefetch_block(upper_block);
 	}
 
 	/* average occupancy in B+* block is 5/6 */
@@ -2100,6 +2136,7 @@ bps_tree_find(const struct bps_tree *tree, bps_tree_key_t key)
 						  inner->header.size - 1,
 						  key, &exact);
 		block = bps_tree_restore_block(tree, inner->child_ids[pos]);
+		bps_tree_prefetch_block(block);
 	}
 
 	struct bps_leaf *leaf = (struct bps_leaf *)block;
@@ -2293,6 +2330,7 @@ bps_tree_collect_path(struct bps_tree *tree, bps_tree_elem_t new_elem,
 		}
 		block_id = inner->child_ids[pos];
 		block = bps_tree_restore_block(tree, block_id);
+		bps_tree_prefetch_block(block);
 		prev_pos = pos;
 		prev_ext = path + i;
 	}
@@ -6144,6 +6182,7 @@ bps_tree_debug_check_internal_functions(bool assertme)
 
 #undef bps_tree_restore_block
 #undef bps_tree_restore_block_ver
+#undef bps_tree_prefetch_block
 #undef bps_tree_root
 #undef bps_tree_touch_block
 #undef bps_tree_find_ins_point_key
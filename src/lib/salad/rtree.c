@@ -34,6 +34,10 @@
 #include <limits.h>
 #include <stddef.h>
 #include <sys/types.h>
+#include <qsort_arg.h>
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
 
 /*------------------------------------------------------------------------- */
 /* R-tree internal structures definition */
@@ -325,6 +329,88 @@ rtree_rect_equal_to_rect(const struct rtree_rect *rt1,
 	return true;
 }
 
+/*
+ * Versions of the comparators above for two dimensions, the most
+ * common case. They check both axes at once, without branches.
+ */
+
+static bool
+rtree_rect_intersects_rect_2d(const struct rtree_rect *rt1,
+			      const struct rtree_rect *rt2,
+			      unsigned dimension)
+{
+	assert(dimension == 2);
+	(void) dimension;
+	const coord_t *c1 = rt1->coords;
+	const coord_t *c2 = rt2->coords;
+#if defined(__SSE2__)
+	__m128d x1 = _mm_loadu_pd(c1);
+	__m128d y1 = _mm_loadu_pd(c1 + 2);
+	__m128d x2 = _mm_loadu_pd(c2);
+	__m128d y2 = _mm_loadu_pd(c2 + 2);
+	/* { low X, low Y } and { upper X, upper Y } */
+	__m128d lo1 = _mm_unpacklo_pd(x1, y1);
+	__m128d hi1 = _mm_unpackhi_pd(x1, y1);
+	__m128d lo2 = _mm_unpacklo_pd(x2, y2);
+	__m128d hi2 = _mm_unpackhi_pd(x2, y2);
+	__m128d ok = _mm_and_pd(_mm_cmpngt_pd(lo1, hi2),
+				_mm_cmpnlt_pd(hi1, lo2));
+	return _mm_movemask_pd(ok) == 3;
+#else
+	return !(c1[0] > c2[1]) & !(c1[1] < c2[0]) &
+	       !(c1[2] > c2[3]) & !(c1[3] < c2[2]);
+#endif
+}
+
+static bool
+rtree_rect_in_rect_2d(const struct rtree_rect *rt1,
+		      const struct rtree_rect *rt2,
+		      unsigned dimension)
+{
+	assert(dimension == 2);
+	(void) dimension;
+	const coord_t *c1 = rt1->coords;
+	const coord_t *c2 = rt2->coords;
+#if defined(__SSE2__)
+	__m128d x1 = _mm_loadu_pd(c1);
+	__m128d y1 = _mm_loadu_pd(c1 + 2);
+	__m128d x2 = _mm_loadu_pd(c2);
+	__m128d y2 = _mm_loadu_pd(c2 + 2);
+	/* { low X, low Y } and { upper X, upper Y } */
+	__m128d lo1 = _mm_unpacklo_pd(x1, y1);
+	__m128d hi1 = _mm_unpackhi_pd(x1, y1);
+	__m128d lo2 = _mm_unpacklo_pd(x2, y2);
+	__m128d hi2 = _mm_unpackhi_pd(x2, y2);
+	__m128d ok = _mm_and_pd(_mm_cmpnlt_pd(lo1, lo2),
+				_mm_cmpngt_pd(hi1, hi2));
+	return _mm_movemask_pd(ok) == 3;
+#else
+	return !(c1[0] < c2[0]) & !(c1[1] > c2[1]) &
+	       !(c1[2] < c2[2]) & !(c1[3] > c2[3]);
+#endif
+}
+
+static bool
+rtree_rect_holds_rect_2d(const struct rtree_rect *rt1,
+			 const struct rtree_rect *rt2,
+			 unsigned dimension)
+{
+	return rtree_rect_in_rect_2d(rt2, rt1, dimension);
+}
+
+/* Return the two-dimensional version of a comparator if there is one */
+static rtree_comparator_t
+rtree_comparator_2d(rtree_comparator_t cmp)
+{
+	if (cmp == rtree_rect_intersects_rect)
+		return rtree_rect_intersects_rect_2d;
+	if (cmp == rtree_rect_in_rect)
+		return rtree_rect_in_rect_2d;
+	if (cmp == rtree_rect_holds_rect)
+		return rtree_rect_holds_rect_2d;
+	return cmp;
+}
+
 static bool
 rtree_always_true(const struct rtree_rect *rt1,
 		  const struct rtree_rect *rt2,
@@ -1006,6 +1092,128 @@ rtree_insert(struct rtree *tree, struct rtree_rect *rect, record_t obj)
 	tree->n_records++;
 }
 
+size_t
+rtree_bulk_entry_size(const struct rtree *tree)
+{
+	return tree->page_branch_size;
+}
+
+void
+rtree_bulk_entry_set(const struct rtree *tree, void *entries, size_t i,
+		     const struct rtree_rect *rect, record_t obj)
+{
+	struct rtree_page_branch *b = (struct rtree_page_branch *)
+		((char *)entries + i * tree->page_branch_size);
+	b->data.record = obj;
+	rtree_rect_copy(&b->rect, rect, tree->dimension);
+}
+
+size_t
+rtree_bulk_load_size(const struct rtree *tree, size_t count)
+{
+	size_t fill = tree->page_max_fill;
+	size_t n_pages = 0;
+	while (count > 1) {
+		count = (count + fill - 1) / fill;
+		n_pages += count;
+	}
+	/* A single record still needs a root page. */
+	return (n_pages > 0 ? n_pages : count) * tree->page_size;
+}
+
+static int
+rtree_branch_center_cmp(const void *a, const void *b, void *arg)
+{
+	unsigned axis = *(unsigned *)arg;
+	const coord_t *ca =
+		&((const struct rtree_page_branch *)a)->rect.coords[2 * axis];
+	const coord_t *cb =
+		&((const struct rtree_page_branch *)b)->rect.coords[2 * axis];
+	/* Doubled centers, the order is the same */
+	coord_t sa = ca[0] + ca[1];
+	coord_t sb = cb[0] + cb[1];
+	return sa < sb ? -1 : sa > sb ? 1 : 0;
+}
+
+/* The smallest s such that s^k >= n */
+static size_t
+rtree_root_ceil(size_t n, unsigned k)
+{
+	for (size_t s = 1; ; s++) {
+		size_t p = 1;
+		for (unsigned i = 0; i < k && p < n; i++)
+			p *= s;
+		if (p >= n)
+			return s;
+	}
+}
+
+/*
+ * Sort-Tile-Recursive ordering. Sort branches by the center along
+ * the axis, cut them into slabs and order each slab along the next
+ * axes. After that, every run of page_max_fill branches is a page
+ * that covers a compact area.
+ */
+static void
+rtree_str_sort(const struct rtree *tree, char *branches, size_t n,
+	       unsigned axis)
+{
+	qsort_arg(branches, n, tree->page_branch_size,
+		  rtree_branch_center_cmp, &axis);
+	if (axis + 1 == tree->dimension)
+		return;
+	size_t fill = tree->page_max_fill;
+	size_t n_pages = (n + fill - 1) / fill;
+	size_t n_slabs = rtree_root_ceil(n_pages, tree->dimension - axis);
+	size_t slab_size = fill * ((n_pages + n_slabs - 1) / n_slabs);
+	for (size_t i = 0; i < n; i += slab_size) {
+		size_t size = n - i < slab_size ? n - i : slab_size;
+		rtree_str_sort(tree, branches + i * tree->page_branch_size,
+			       size, axis + 1);
+	}
+}
+
+void
+rtree_bulk_load(struct rtree *tree, void *entries, size_t count)
+{
+	assert(tree->root == NULL);
+	if (count == 0)
+		return;
+	size_t fill = tree->page_max_fill;
+	char *branches = (char *)entries;
+	size_t n = count;
+	while (true) {
+		rtree_str_sort(tree, branches, n, 0);
+		size_t n_pages = (n + fill - 1) / fill;
+		/*
+		 * The branch pointing to page i is stored in place of
+		 * branch i of this level, which is already copied to
+		 * a page by then.
+		 */
+		for (size_t i = 0; i < n_pages; i++) {
+			struct rtree_page *page = rtree_page_alloc(tree);
+			tree->n_pages++;
+			size_t first = i * fill;
+			page->n = n - first < fill ? n - first : fill;
+			memcpy(page->data, branches + first *
+			       tree->page_branch_size,
+			       page->n * tree->page_branch_size);
+			struct rtree_page_branch *b = (struct rtree_page_branch *)
+				(branches + i * tree->page_branch_size);
+			rtree_page_cover(tree, page, &b->rect);
+			b->data.page = page;
+		}
+		tree->height++;
+		assert(tree->height <= RTREE_MAX_HEIGHT);
+		if (n_pages == 1)
+			break;
+		n = n_pages;
+	}
+	tree->root = ((struct rtree_page_branch *)branches)->data.page;
+	tree->n_records = count;
+	tree->version++;
+}
+
 bool
 rtree_remove(struct rtree *tree, const struct rtree_rect *rect, record_t obj)
 {
@@ -1115,6 +1323,10 @@ rtree_search(const struct rtree *tree, const struct rtree_rect *rect,
 			return false;
 		}
 	}
+	if (tree->dimension == 2) {
+		itr->intr_cmp = rtree_comparator_2d(itr->intr_cmp);
+		itr->leaf_cmp = rtree_comparator_2d(itr->leaf_cmp);
+	}
 	if (tree->root && rtree_iterator_goto_first(itr, 0, tree->root)) {
 		itr->stack[tree->height-1].pos -= 1;
 		/* will be incremented by goto_next */
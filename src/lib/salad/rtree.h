@@ -275,6 +275,48 @@ rtree_search(const struct rtree *tree, const struct rtree_rect *rect,
 void
 rtree_insert(struct rtree *tree, struct rtree_rect *rect, record_t obj);
 
+/**
+ * @brief Size of one entry of an array passed to rtree_bulk_load()
+ * @param tree - pointer to a tree
+ */
+size_t
+rtree_bulk_entry_size(const struct rtree *tree);
+
+/**
+ * @brief Set an entry of an array passed to rtree_bulk_load()
+ * @param tree - pointer to a tree
+ * @param entries - array of rtree_bulk_entry_size() sized entries
+ * @param i - number of the entry to set
+ * @param rect - rectangle of the record
+ * @param obj - record
+ */
+void
+rtree_bulk_entry_set(const struct rtree *tree, void *entries, size_t i,
+		     const struct rtree_rect *rect, record_t obj);
+
+/**
+ * @brief Size of memory a tree built by rtree_bulk_load() uses
+ * @param tree - pointer to a tree
+ * @param count - number of records
+ */
+size_t
+rtree_bulk_load_size(const struct rtree *tree, size_t count);
+
+/**
+ * @brief Build a tree from an array of records at once, with
+ * Sort-Tile-Recursive packing. It is much faster than inserting
+ * the records one by one, and the pages of the tree overlap less.
+ * The tree must be empty. The array is reordered and used as
+ * scratch memory. Like rtree_insert(), this function doesn't
+ * handle allocation errors: the extent allocator must be able to
+ * provide rtree_bulk_load_size() bytes of pages.
+ * @param tree - pointer to a tree
+ * @param entries - array of entries set up by rtree_bulk_entry_set()
+ * @param count - number of entries
+ */
+void
+rtree_bulk_load(struct rtree *tree, void *entries, size_t count);
+
 /**
  * @brief Remove the record from a tree
  * @return true if the record deleted (false otherwise)
@@ -150,6 +150,13 @@ enum {
 	 * value.
 	 */
 	HEARTBEAT_RATE_DEFAULT = 1,
+	/**
+	 * Max number of packets sent to a member in one round
+	 * step. The first one is the round message, the others
+	 * carry the events which didn't fit into it. It bounds
+	 * the cost of a step when lots of members change at once.
+	 */
+	SWIM_DISS_PACKET_COUNT_MAX = 4,
 	/**
 	 * If a ping was sent, it is considered lost after this
 	 * time without an ack. Nothing special in this value.
@@ -258,9 +265,10 @@ struct swim_member {
 	 */
 	uint32_t hash;
 	/**
-	 * Position in a queue of members in the current round.
+	 * Index in the array of members in the order of round
+	 * steps.
 	 */
-	struct rlist in_round_queue;
+	int round_idx;
 	/**
 	 * Reference counter. Used by public API to prevent the
 	 * member deletion after it is obtained by UUID or from an
@@ -349,10 +357,17 @@ struct swim_member {
 	 */
 	int payload_ttd;
 	/**
-	 * All created events are put into a queue sorted by event
-	 * time.
+	 * All created events are put into a queue sorted by
+	 * status TTD in descending order, so the events sent
+	 * fewer times go first.
 	 */
 	struct rlist in_dissemination_queue;
+	/**
+	 * Number of the last round step which sent the events of
+	 * the member. TTDs are decreased only for the events
+	 * actually sent.
+	 */
+	uint64_t diss_step;
 	/**
 	 * Each time a member is updated, or created, or dropped,
 	 * it is added to an event queue. Members from this queue
@@ -512,17 +527,22 @@ struct swim {
 	 */
 	struct rlist on_member_event;
 	/**
-	 * Members to which a message should be sent next during
-	 * this round.
+	 * All members, including self, in the order of round
+	 * steps. Members [0, round_pos) are already visited in
+	 * the current round. The order is shuffled incrementally:
+	 * each step swaps a random not visited member into
+	 * round_pos, which gives a random permutation each round
+	 * without an O(N) shuffle at the beginning of a round.
 	 */
-	struct rlist round_queue;
+	struct swim_member **round_order;
+	/** Number of members in @a round_order. */
+	int round_size;
+	/** Index of the next addressee in @a round_order. */
+	int round_pos;
+	/** Number of the current round step. */
+	uint64_t round_step;
 	/** Generator of round step events. */
 	struct ev_timer round_tick;
-	/**
-	 * Preallocated buffer to store shuffled members here at
-	 * the beginning of each round.
-	 */
-	struct swim_member **shuffled;
 	/**
 	 * Fiber to serve member event triggers. This task is
 	 * being done in a separate fiber, because user triggers
@@ -544,6 +564,11 @@ struct swim {
 	 * lines.
 	 */
 	struct swim_task round_step_task;
+	/**
+	 * Tasks to send the events which didn't fit into the
+	 * round step packet, to the same addressee.
+	 */
+	struct swim_task diss_tasks[SWIM_DISS_PACKET_COUNT_MAX - 1];
 };
 
 /** Put the member into a list of ACK waiters. */
@@ -580,10 +605,9 @@ swim_wait_ack(struct swim *swim, struct swim_member *member,
 static inline void
 swim_register_event(struct swim *swim, struct swim_member *member)
 {
-	if (rlist_empty(&member->in_dissemination_queue)) {
-		rlist_add_tail_entry(&swim->dissemination_queue, member,
-				     in_dissemination_queue);
-	}
+	/* A new event has not been sent yet, so it goes first. */
+	rlist_move_entry(&swim->dissemination_queue, member,
+			 in_dissemination_queue);
 	/*
 	 * Logarithm is a perfect number of disseminations of an
 	 * event.
@@ -798,7 +822,7 @@ swim_member_is_dropped(const struct swim_member *member)
 static inline void
 swim_member_delete(struct swim_member *member)
 {
-	assert(rlist_empty(&member->in_round_queue));
+	assert(member->round_idx < 0);
 	member->is_dropped = true;
 
 	/* Failure detection component. */
@@ -835,7 +859,7 @@ swim_member_new(const struct sockaddr_in *addr, const struct tt_uuid *uuid,
 	member->addr = *addr;
 	member->uuid = *uuid;
 	member->hash = swim_uuid_hash(uuid);
-	rlist_create(&member->in_round_queue);
+	member->round_idx = -1;
 
 	/* Failure detection component. */
 	member->incarnation = *incarnation;
@@ -847,6 +871,70 @@ swim_member_new(const struct sockaddr_in *addr, const struct tt_uuid *uuid,
 	return member;
 }
 
+/** Swap two members in the round order. */
+static inline void
+swim_round_swap(struct swim *swim, int i, int j)
+{
+	struct swim_member **order = swim->round_order;
+	SWAP(order[i], order[j]);
+	order[i]->round_idx = i;
+	order[j]->round_idx = j;
+}
+
+/**
+ * Add a member to the round order. It is not visited in the
+ * current round, so it can be chosen as an addressee right away.
+ * The array should have a free slot.
+ */
+static inline void
+swim_round_add(struct swim *swim, struct swim_member *member)
+{
+	assert(member->round_idx < 0);
+	member->round_idx = swim->round_size;
+	swim->round_order[swim->round_size++] = member;
+}
+
+/** Remove a member from the round order. */
+static void
+swim_round_remove(struct swim *swim, struct swim_member *member)
+{
+	int idx = member->round_idx;
+	assert(idx >= 0 && swim->round_order[idx] == member);
+	if (idx < swim->round_pos) {
+		/*
+		 * Keep the visited members together, the last of
+		 * them becomes not visited and is removed.
+		 */
+		swim_round_swap(swim, idx, --swim->round_pos);
+		idx = swim->round_pos;
+	}
+	swim_round_swap(swim, idx, --swim->round_size);
+	member->round_idx = -1;
+}
+
+/**
+ * Choose the next round step addressee. It is a random member
+ * not visited in the current round yet - an incremental
+ * Fisher-Yates shuffle, which costs O(1) per step. The member
+ * stays at round_pos until the step is complete.
+ * @retval NULL The round is over.
+ */
+static struct swim_member *
+swim_round_next(struct swim *swim)
+{
+	while (swim->round_pos < swim->round_size) {
+		int i = pseudo_random_in_range(swim->round_pos,
+					       swim->round_size - 1);
+		swim_round_swap(swim, swim->round_pos, i);
+		struct swim_member *m = swim->round_order[swim->round_pos];
+		if (m != swim->self)
+			return m;
+		/* Self is never an addressee. */
+		++swim->round_pos;
+	}
+	return NULL;
+}
+
 /**
  * Remove the member from all queues, hashes, destroy it and free
  * the memory.
@@ -869,7 +957,7 @@ swim_delete_member(struct swim *swim, struct swim_member *member)
 	mh_int_t rc = mh_swim_table_find(swim->members, key, NULL);
 	assert(rc != mh_end(swim->members));
 	mh_swim_table_del(swim->members, rc, NULL);
-	rlist_del_entry(member, in_round_queue);
+	swim_round_remove(swim, member);
 	swim_member_delete(member);
 }
 
@@ -885,11 +973,9 @@ swim_find_member(struct swim *swim, const struct tt_uuid *uuid)
 }
 
 /**
- * Register a new member with a specified status. It is not added
- * to the round queue here. It waits until the current round is
- * finished, and then is included into a new round. It is done
- * mainly to not add self into the round queue, because self is
- * also created via this function.
+ * Register a new member with a specified status. It is added to
+ * the round order as not visited, so it can be pinged in the
+ * current round already.
  */
 static struct swim_member *
 swim_new_member(struct swim *swim, const struct sockaddr_in *addr,
@@ -897,15 +983,15 @@ swim_new_member(struct swim *swim, const struct sockaddr_in *addr,
 		const struct swim_incarnation *incarnation, const char *payload,
 		int payload_size)
 {
-	int new_bsize = sizeof(swim->shuffled[0]) *
+	int new_bsize = sizeof(swim->round_order[0]) *
 			(mh_size(swim->members) + 1);
-	struct swim_member **new_shuffled =
-		(struct swim_member **) realloc(swim->shuffled, new_bsize);
-	if (new_shuffled == NULL) {
-		diag_set(OutOfMemory, new_bsize, "realloc", "new_shuffled");
+	struct swim_member **new_order =
+		(struct swim_member **) realloc(swim->round_order, new_bsize);
+	if (new_order == NULL) {
+		diag_set(OutOfMemory, new_bsize, "realloc", "new_order");
 		return NULL;
 	}
-	swim->shuffled = new_shuffled;
+	swim->round_order = new_order;
 	/*
 	 * Reserve one more slot to never fail push into the ack
 	 * waiters heap.
@@ -922,6 +1008,7 @@ swim_new_member(struct swim *swim, const struct sockaddr_in *addr,
 	assert(swim_find_member(swim, uuid) == NULL);
 	mh_swim_table_put(swim->members, (const struct swim_member **)&member,
 			  NULL, NULL);
+	swim_round_add(swim, member);
 	if (mh_size(swim->members) > 1)
 		swim_ev_timer_again(swim_loop(), &swim->round_tick);
 
@@ -940,30 +1027,8 @@ swim_new_member(struct swim *swim, const struct sockaddr_in *addr,
 }
 
 /**
- * Take all the members from the table and shuffle them randomly.
- * Is used for forthcoming round planning.
- */
-static void
-swim_shuffle_members(struct swim *swim)
-{
-	struct mh_swim_table_t *members = swim->members;
-	int i = 0;
-	/*
-	 * This shuffling preserves even distribution of a random
-	 * sequence. The distribution properties have been
-	 * verified by a longevity test.
-	 */
-	for (mh_int_t node = mh_first(members), end = mh_end(members);
-	     node != end; node = mh_next(members, node), ++i) {
-		swim->shuffled[i] = *mh_swim_table_node(members, node);
-		int j = pseudo_random_in_range(0, i);
-		SWAP(swim->shuffled[i], swim->shuffled[j]);
-	}
-}
-
-/**
- * Shuffle members, build randomly ordered queue of addressees. In
- * other words, do all round preparation work.
+ * Start a new round. All members become not visited, the order
+ * is shuffled step by step in swim_round_next().
  */
 static void
 swim_new_round(struct swim *swim)
@@ -978,14 +1043,8 @@ swim_new_round(struct swim *swim)
 	/* -1 for self. */
 	say_verbose("SWIM %d: start a new round with %d members", swim_fd(swim),
 		    size - 1);
-	swim_shuffle_members(swim);
-	rlist_create(&swim->round_queue);
-	for (int i = 0; i < size; ++i) {
-		if (swim->shuffled[i] != swim->self) {
-			rlist_add_entry(&swim->round_queue, swim->shuffled[i],
-					in_round_queue);
-		}
-	}
+	assert(size == swim->round_size);
+	swim->round_pos = 0;
 }
 
 /**
@@ -1103,11 +1162,22 @@ swim_encode_failure_detection(struct swim *swim, struct swim_packet *packet,
 }
 
 /**
- * Encode dissemination component.
+ * Encode dissemination component. Events are taken from the
+ * dissemination queue starting from @a next, or from the queue
+ * head if it is NULL, as many as fit. The events sent fewer
+ * times go first.
+ * @param[in][out] next The first event to encode. Set to the
+ *        first event which didn't fit, or to NULL if all did.
+ * @param step If not 0, the encoded events are marked as sent
+ *        in this round step.
+ * @param size_max Max size of the packet body after the events
+ *        are encoded.
  * @retval Number of key-values added to the packet's root map.
  */
 static int
-swim_encode_dissemination(struct swim *swim, struct swim_packet *packet)
+swim_encode_dissemination(struct swim *swim, struct swim_packet *packet,
+			  struct swim_member **next, uint64_t step,
+			  int size_max)
 {
 	struct swim_diss_header_bin diss_header_bin;
 	struct swim_member_payload_bin payload_header;
@@ -1118,59 +1188,107 @@ swim_encode_dissemination(struct swim *swim, struct swim_packet *packet)
 	swim_passport_bin_create(&passport_bin);
 	swim_member_payload_bin_create(&payload_header);
 	int i = 0;
-	struct swim_member *m;
-	rlist_foreach_entry(m, &swim->dissemination_queue,
-			    in_dissemination_queue) {
+	struct rlist *queue = &swim->dissemination_queue;
+	struct rlist *link = *next != NULL ?
+			     &(*next)->in_dissemination_queue :
+			     rlist_first(queue);
+	for (; link != queue; link = rlist_next(link), ++i) {
+		struct swim_member *m =
+			rlist_entry(link, struct swim_member,
+				    in_dissemination_queue);
+		char *pos = packet->pos;
 		if (swim_encode_member(packet, m, &passport_bin,
 				       &payload_header,
 				       m->payload_ttd > 0) != 0)
 			break;
-		++i;
+		if (swim_packet_body_size(packet) > size_max) {
+			packet->pos = pos;
+			break;
+		}
+		if (step != 0)
+			m->diss_step = step;
 	}
+	*next = link != queue ? rlist_entry(link, struct swim_member,
+					    in_dissemination_queue) : NULL;
 	swim_diss_header_bin_create(&diss_header_bin, i);
 	memcpy(header, &diss_header_bin, sizeof(diss_header_bin));
 	return 1;
 }
 
-/** Encode SWIM components into a UDP packet. */
-static void
+/**
+ * Encode SWIM components into a UDP packet.
+ * @param step Round step number, if it is a round step packet,
+ *        or 0.
+ * @retval The first event which didn't fit into the packet, or
+ *         NULL.
+ */
+static struct swim_member *
 swim_encode_msg(struct swim *swim, struct swim_packet *packet,
-		enum swim_fd_msg_type fd_type)
+		enum swim_fd_msg_type fd_type, uint64_t step)
 {
 	char *header = swim_packet_alloc(packet, 1);
 	int map_size = 0;
+	struct swim_member *next = NULL;
 	map_size += swim_encode_src_uuid(swim, packet);
 	map_size += swim_encode_failure_detection(swim, packet, fd_type);
 	ERROR_INJECT(ERRINJ_SWIM_FD_ONLY, {
 		mp_encode_map(header, map_size);
-		return;
+		return NULL;
 	});
-	map_size += swim_encode_dissemination(swim, packet);
+	/*
+	 * Events of a round step packet take at most half of it,
+	 * the rest is sent in separate packets. Otherwise an
+	 * event storm would leave no space for anti-entropy.
+	 */
+	int diss_size_max = step != 0 ? MAX_PACKET_SIZE / 2 : MAX_PACKET_SIZE;
+	map_size += swim_encode_dissemination(swim, packet, &next, step,
+					      diss_size_max);
 	map_size += swim_encode_anti_entropy(swim, packet);
 
 	assert(mp_sizeof_map(map_size) == 1 && map_size >= 2);
 	mp_encode_map(header, map_size);
+	return next;
+}
+
+/**
+ * Encode a packet with dissemination component only, starting
+ * from the event @a next. It is used to send the events which
+ * didn't fit into a round step packet.
+ * @retval true At least one event is encoded.
+ */
+static bool
+swim_encode_diss_msg(struct swim *swim, struct swim_packet *packet,
+		     struct swim_member **next, uint64_t step)
+{
+	struct swim_member *first = *next;
+	char *header = swim_packet_alloc(packet, 1);
+	int map_size = swim_encode_src_uuid(swim, packet);
+	map_size += swim_encode_dissemination(swim, packet, next, step,
+					      MAX_PACKET_SIZE);
+	assert(map_size == 2);
+	mp_encode_map(header, map_size);
+	return *next != first;
 }
 
 /**
- * Decrement TTDs of all events. It is done after each round step.
- * Note, since we decrement TTD of all events, even those which
- * have not been actually encoded and sent, if there are more
- * events than can fit into a packet, the tail of the queue begins
- * reeking and rotting. The most recently added members could even
- * be deleted without being sent once. This is, however, very
- * unlikely, since even 1000 bytes can fit 37 events containing
- * ~27 bytes each, which means only happens upon a failure of 37
- * instances. In such a case event loss is the mildest problem to
- * deal with.
+ * Decrement TTDs of the events sent in the round step @a step. It
+ * is done after each round step. The events which didn't fit into
+ * the step packets keep their TTDs, so a burst of events bigger
+ * than a packet is sent over several steps rather than lost.
+ *
+ * The queue is kept sorted by status TTD in descending order, so
+ * the events sent fewer times go first. The sent events are taken
+ * out of the queue and merged back after the decrement.
  */
 static void
-swim_decrease_event_ttd(struct swim *swim)
+swim_decrease_event_ttd(struct swim *swim, uint64_t step)
 {
+	RLIST_HEAD(sent);
+	struct rlist *queue = &swim->dissemination_queue;
 	struct swim_member *member, *tmp;
-	rlist_foreach_entry_safe(member, &swim->dissemination_queue,
-				 in_dissemination_queue,
-				 tmp) {
+	rlist_foreach_entry_safe(member, queue, in_dissemination_queue, tmp) {
+		if (member->diss_step != step)
+			continue;
 		if (member->payload_ttd > 0)
 			--member->payload_ttd;
 		assert(member->status_ttd > 0);
@@ -1178,8 +1296,36 @@ swim_decrease_event_ttd(struct swim *swim)
 			rlist_del_entry(member, in_dissemination_queue);
 			if (member->status == MEMBER_LEFT)
 				swim_delete_member(swim, member);
+		} else {
+			rlist_move_tail_entry(&sent, member,
+					      in_dissemination_queue);
 		}
 	}
+	struct rlist *pos = rlist_first(queue);
+	while (! rlist_empty(&sent)) {
+		member = rlist_first_entry(&sent, struct swim_member,
+					   in_dissemination_queue);
+		while (pos != queue &&
+		       rlist_entry(pos, struct swim_member,
+				   in_dissemination_queue)->status_ttd >=
+		       member->status_ttd)
+			pos = rlist_next(pos);
+		/* Insert before pos. */
+		rlist_move_tail(pos, &member->in_dissemination_queue);
+	}
+}
+
+/**
+ * Round step packets completion callback. Nothing to do, TTDs of
+ * the events are decreased when the round step is complete.
+ */
+static void
+swim_complete_diss_msg(struct swim_task *task,
+		       struct swim_scheduler *scheduler, int rc)
+{
+	(void)task;
+	(void)scheduler;
+	(void)rc;
 }
 
 /**
@@ -1206,24 +1352,42 @@ swim_begin_step(struct ev_loop *loop, struct ev_timer *t, int events)
 		swim_ev_timer_stop(loop, t);
 		return;
 	}
-	if (! rlist_empty(&swim->round_queue))
+	struct swim_member *m = swim_round_next(swim);
+	if (m != NULL) {
 		say_verbose("SWIM %d: continue the round", swim_fd(swim));
-	else
+	} else {
 		swim_new_round(swim);
+		m = swim_round_next(swim);
+	}
 	/*
 	 * Possibly empty, if no members but self are specified.
 	 */
-	if (rlist_empty(&swim->round_queue)) {
+	if (m == NULL) {
 		swim_ev_timer_stop(loop, t);
 		return;
 	}
+	uint64_t step = ++swim->round_step;
 	struct swim_packet *packet = &swim->round_step_task.packet;
 	swim_packet_create(packet);
-	swim_encode_msg(swim, packet, SWIM_FD_MSG_PING);
-	struct swim_member *m =
-		rlist_first_entry(&swim->round_queue, struct swim_member,
-				  in_round_queue);
+	struct swim_member *next =
+		swim_encode_msg(swim, packet, SWIM_FD_MSG_PING, step);
 	swim_task_send(&swim->round_step_task, &m->addr, &swim->scheduler);
+	/*
+	 * The events which didn't fit are sent in a few more
+	 * packets to the same member, so a burst of events in a
+	 * big cluster is disseminated at the same speed as a
+	 * single event, but the cost of a step is still bounded.
+	 */
+	for (int i = 0; i < (int)lengthof(swim->diss_tasks) && next != NULL;
+	     ++i) {
+		struct swim_task *task = &swim->diss_tasks[i];
+		if (swim_task_is_scheduled(task))
+			break;
+		swim_packet_create(&task->packet);
+		if (! swim_encode_diss_msg(swim, &task->packet, &next, step))
+			break;
+		swim_task_send(task, &m->addr, &swim->scheduler);
+	}
 }
 
 /**
@@ -1246,13 +1410,11 @@ swim_complete_step(struct swim_task *task,
 	 * It is possible that the original member was deleted
 	 * manually during the task execution.
 	 */
-	if (rlist_empty(&swim->round_queue))
+	if (swim->round_pos >= swim->round_size)
 		return;
-	struct swim_member *m =
-		rlist_first_entry(&swim->round_queue, struct swim_member,
-				  in_round_queue);
+	struct swim_member *m = swim->round_order[swim->round_pos];
 	if (swim_inaddr_eq(&m->addr, &task->dst)) {
-		rlist_shift(&swim->round_queue);
+		++swim->round_pos;
 		if (rc > 0) {
 			/*
 			 * Each round message contains
@@ -1260,7 +1422,7 @@ swim_complete_step(struct swim_task *task,
 			 * sections.
 			 */
 			swim_wait_ack(swim, m, false);
-			swim_decrease_event_ttd(swim);
+			swim_decrease_event_ttd(swim, swim->round_step);
 		}
 	}
 }
@@ -1278,7 +1440,7 @@ swim_send_fd_msg(struct swim *swim, struct swim_task *task,
 	swim_packet_create(&task->packet);
 	if (proxy != NULL)
 		swim_task_set_proxy(task, proxy);
-	swim_encode_msg(swim, &task->packet, type);
+	swim_encode_msg(swim, &task->packet, type, 0);
 	say_verbose("SWIM %d: schedule %s to %s", swim_fd(swim),
 		    swim_fd_msg_type_strs[type], swim_inaddr_str(dst));
 	swim_task_send(task, dst, &swim->scheduler);
@@ -1901,12 +2063,15 @@ swim_new(uint64_t generation)
 	}
 	swim->initial_generation = generation;
 	swim->members = mh_swim_table_new();
-	rlist_create(&swim->round_queue);
 	swim_ev_timer_init(&swim->round_tick, swim_begin_step,
 			   0, HEARTBEAT_RATE_DEFAULT);
 	swim->round_tick.data = (void *) swim;
 	swim_task_create(&swim->round_step_task, swim_complete_step, NULL,
 			 "round packet");
+	for (int i = 0; i < (int)lengthof(swim->diss_tasks); ++i) {
+		swim_task_create(&swim->diss_tasks[i], swim_complete_diss_msg,
+				 NULL, "dissemination packet");
+	}
 	swim_scheduler_create(&swim->scheduler, swim_on_input);
 
 	/* Failure detection component. */
@@ -2226,7 +2391,7 @@ swim_delete(struct swim *swim)
 	mh_int_t node;
 	mh_foreach(swim->members, node) {
 		m = *mh_swim_table_node(swim->members, node);
-		rlist_del_entry(m, in_round_queue);
+		swim_round_remove(swim, m);
 		if (! heap_node_is_stray(&m->in_wait_ack_heap))
 			wait_ack_heap_delete(&swim->wait_ack_heap, m);
 		rlist_del_entry(m, in_dissemination_queue);
@@ -2237,10 +2402,12 @@ swim_delete(struct swim *swim)
 	 * try to invalidate the already destroyed task.
 	 */
 	swim_task_destroy(&swim->round_step_task);
+	for (int i = 0; i < (int)lengthof(swim->diss_tasks); ++i)
+		swim_task_destroy(&swim->diss_tasks[i]);
 	wait_ack_heap_destroy(&swim->wait_ack_heap);
 	mh_swim_table_delete(swim->members);
 	trigger_destroy(&swim->on_member_event);
-	free(swim->shuffled);
+	free(swim->round_order);
 	free(swim);
 }
 
@@ -2255,7 +2422,8 @@ swim_quit_step_complete(struct swim_task *task,
 {
 	(void) rc;
 	struct swim *swim = swim_by_scheduler(scheduler);
-	if (rlist_empty(&swim->round_queue)) {
+	struct swim_member *m = swim_round_next(swim);
+	if (m == NULL) {
 		/*
 		 * The handler should be dead - can't yield here,
 		 * it is the scheduler fiber.
@@ -2264,9 +2432,7 @@ swim_quit_step_complete(struct swim_task *task,
 		swim_delete(swim);
 		return;
 	}
-	struct swim_member *m =
-		rlist_shift_entry(&swim->round_queue, struct swim_member,
-				  in_round_queue);
+	++swim->round_pos;
 	swim_task_send(task, &m->addr, scheduler);
 }
 
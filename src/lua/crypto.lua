@@ -4,6 +4,8 @@ local ffi = require('ffi')
 local buffer = require('buffer')
 local cord_ibuf_take = buffer.internal.cord_ibuf_take
 local cord_ibuf_put = buffer.internal.cord_ibuf_put
+-- C part of the digest module, registered before builtin Lua modules.
+local internal = require('digest')
 
 ffi.cdef[[
     /* from openssl/err.h */
@@ -323,10 +325,21 @@ crypto_stream_mt = {
     }
 }
 
+local function check_batch(list, usage)
+    if type(list) ~= 'table' then
+        error(usage, 3)
+    end
+end
+
 local digest_api = {}
 for class, digest in pairs(digests) do
     digest_api[class] = setmetatable({
-        new = function () return digest_new(digest) end
+        new = function () return digest_new(digest) end,
+        -- Big batches are processed in the thread pool, so it may yield.
+        batch = function (list)
+            check_batch(list, "Usage: digest."..class..".batch(table)")
+            return internal.digest_batch(class, list)
+        end
     }, {
         __call = function (self, str)
             if type(str) ~= 'string' then
@@ -349,7 +362,14 @@ digest_api = setmetatable(digest_api,
 local hmac_api = {}
 for class, digest in pairs(hmacs) do
     hmac_api[class] = setmetatable({
-        new = function (key) return hmac_new(digest, key) end
+        new = function (key) return hmac_new(digest, key) end,
+        batch = function (key, list)
+            if type(key) ~= 'string' then
+                error('Key should be specified for HMAC operations', 2)
+            end
+            check_batch(list, "Usage: hmac."..class..".batch(key, table)")
+            return internal.digest_batch(class, list, key)
+        end
     }, {
         __call = function (self, key, str)
             if type(str) ~= 'string' then
@@ -416,6 +436,17 @@ for algo_name, algo_value in pairs(crypto_algos) do
                 new = function(key, iv)
                     return crypto_stream_new(algo_value, mode_value, key, iv,
                                              dir_value)
+                end,
+                batch = function(list, key, iv)
+                    if type(key) ~= 'string' or type(iv) ~= 'string' then
+                        error('Key and IV should be specified for cipher ' ..
+                              'batch operations', 2)
+                    end
+                    check_batch(list, 'Usage: cipher.' .. algo_name .. '.' ..
+                                mode_name .. '.' .. dir_name ..
+                                '.batch(table, key, iv)')
+                    return internal.cipher_batch(algo_value, mode_value,
+                                                 dir_value, list, key, iv)
                 end
             }, {
                 __call = function(self, str, key, iv)
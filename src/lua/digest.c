@@ -29,17 +29,31 @@
  * SUCH DAMAGE.
  */
 
+#include <assert.h>
 #include <string.h>
 #include <lua/digest.h>
 #include <sha1.h>
 #include <openssl/evp.h>
+#include <openssl/hmac.h>
+#include <openssl/err.h>
 #include <coio_task.h>
 #include <lua.h>
 #include <lauxlib.h>
 #include "utils.h"
+#include "diag.h"
+#include "crypto/crypto.h"
 
 #define PBKDF2_MAX_DIGEST_SIZE 128
 
+enum {
+	/**
+	 * Batches with less data are processed in the calling
+	 * thread: a round trip to the thread pool costs more than
+	 * hashing or encrypting a few kilobytes.
+	 */
+	DIGEST_BATCH_ASYNC_THRESHOLD = 64 * 1024,
+};
+
 unsigned char *
 SHA1internal(const unsigned char *d, size_t n, unsigned char *md)
 {
@@ -90,11 +104,220 @@ lua_pbkdf2(lua_State *L)
 	return 1;
 }
 
+/** An input of a batch and its result. */
+struct digest_batch_item {
+	const char *in;
+	size_t in_size;
+	unsigned char *out;
+	/** Size of the out buffer, the size of the result when done. */
+	size_t out_size;
+};
+
+/**
+ * A batch of digests, HMACs or cipher operations with the same
+ * algorithm and keys.
+ */
+struct digest_batch {
+	/** Digest algorithm, NULL for ciphers. */
+	const EVP_MD *md;
+	/** Cipher stream, NULL for digests. */
+	struct crypto_stream *stream;
+	/** HMAC or cipher key, NULL for plain digests. */
+	const char *key;
+	size_t key_size;
+	/** Cipher initial vector. */
+	const char *iv;
+	size_t iv_size;
+	struct digest_batch_item *items;
+	int item_count;
+};
+
+#define diag_set_OpenSSL()					\
+	diag_set(CryptoError, "OpenSSL error: %s",		\
+		 ERR_error_string(ERR_get_error(), NULL))
+
+static int
+digest_batch_run_cipher(struct digest_batch *batch,
+			struct digest_batch_item *item)
+{
+	struct crypto_stream *s = batch->stream;
+	if (crypto_stream_begin(s, batch->key, batch->key_size,
+				batch->iv, batch->iv_size) != 0)
+		return -1;
+	char *out = (char *)item->out;
+	int len = crypto_stream_append(s, item->in, item->in_size,
+				       out, item->out_size);
+	if (len < 0)
+		return -1;
+	assert((size_t)len <= item->out_size - CRYPTO_MAX_BLOCK_SIZE);
+	int tail = crypto_stream_commit(s, out + len, item->out_size - len);
+	if (tail < 0)
+		return -1;
+	item->out_size = len + tail;
+	return 0;
+}
+
+/** Process all items of a batch. Doesn't yield, so can run in any thread. */
+static int
+digest_batch_run(struct digest_batch *batch)
+{
+	for (int i = 0; i < batch->item_count; i++) {
+		struct digest_batch_item *item = &batch->items[i];
+		unsigned int len;
+		if (batch->stream != NULL) {
+			if (digest_batch_run_cipher(batch, item) != 0)
+				return -1;
+		} else if (batch->key != NULL) {
+			if (HMAC(batch->md, batch->key, batch->key_size,
+				 (const unsigned char *)item->in,
+				 item->in_size, item->out, &len) == NULL)
+				goto openssl_error;
+			item->out_size = len;
+		} else {
+			if (EVP_Digest(item->in, item->in_size, item->out,
+				       &len, batch->md, NULL) != 1)
+				goto openssl_error;
+			item->out_size = len;
+		}
+	}
+	return 0;
+openssl_error:
+	diag_set_OpenSSL();
+	return -1;
+}
+
+static ssize_t
+digest_batch_f(va_list ap)
+{
+	struct digest_batch *batch = va_arg(ap, struct digest_batch *);
+	return digest_batch_run(batch);
+}
+
+/**
+ * Read the list of strings at @a idx to batch items and allocate
+ * the output buffers of @a out_size, plus the input size for
+ * ciphers. Items and buffers are allocated as a userdata pushed
+ * onto the stack, so they are freed on error. Returns the total
+ * input size.
+ */
+static size_t
+digest_batch_prepare(struct lua_State *L, int idx, size_t out_size,
+		     bool is_cipher, struct digest_batch *batch)
+{
+	luaL_checktype(L, idx, LUA_TTABLE);
+	int count = lua_objlen(L, idx);
+	size_t total = 0;
+	size_t size = count * sizeof(struct digest_batch_item);
+	for (int i = 1; i <= count; i++) {
+		lua_rawgeti(L, idx, i);
+		size_t len;
+		if (lua_type(L, -1) != LUA_TSTRING ||
+		    lua_tolstring(L, -1, &len) == NULL)
+			luaL_error(L, "batch item %d must be a string", i);
+		lua_pop(L, 1);
+		total += len;
+		size += out_size + (is_cipher ? len : 0);
+	}
+	struct digest_batch_item *items = lua_newuserdata(L, size);
+	unsigned char *out = (unsigned char *)(items + count);
+	for (int i = 0; i < count; i++) {
+		struct digest_batch_item *item = &items[i];
+		/* The strings are referenced by the table. */
+		lua_rawgeti(L, idx, i + 1);
+		item->in = lua_tolstring(L, -1, &item->in_size);
+		lua_pop(L, 1);
+		item->out = out;
+		item->out_size = out_size + (is_cipher ? item->in_size : 0);
+		out += item->out_size;
+	}
+	batch->items = items;
+	batch->item_count = count;
+	return total;
+}
+
+/**
+ * Process a batch, in the coio thread pool if it's big enough, and
+ * push a table with the results. The fiber yields while the batch is
+ * processed by a worker thread.
+ */
+static int
+digest_batch_exec(struct lua_State *L, struct digest_batch *batch,
+		  size_t total)
+{
+	int rc;
+	if (total < DIGEST_BATCH_ASYNC_THRESHOLD) {
+		rc = digest_batch_run(batch);
+	} else {
+		rc = coio_call(digest_batch_f, batch);
+		if (rc != 0 && diag_is_empty(diag_get()))
+			diag_set(OutOfMemory, sizeof(struct coio_task),
+				 "calloc", "coio_task");
+	}
+	if (batch->stream != NULL)
+		crypto_stream_delete(batch->stream);
+	if (rc != 0)
+		return luaT_error(L);
+	lua_createtable(L, batch->item_count, 0);
+	for (int i = 0; i < batch->item_count; i++) {
+		struct digest_batch_item *item = &batch->items[i];
+		lua_pushlstring(L, (const char *)item->out, item->out_size);
+		lua_rawseti(L, -2, i + 1);
+	}
+	return 1;
+}
+
+/**
+ * digest_batch(name, list[, key]) returns a table with the digests
+ * of the strings in list, or their HMACs if key is given.
+ */
+static int
+lua_digest_batch(struct lua_State *L)
+{
+	const char *name = luaL_checkstring(L, 1);
+	struct digest_batch batch;
+	memset(&batch, 0, sizeof(batch));
+	batch.md = EVP_get_digestbyname(name);
+	if (batch.md == NULL)
+		return luaL_error(L, "Digest method \"%s\" is not supported",
+				  name);
+	if (!lua_isnoneornil(L, 3))
+		batch.key = luaL_checklstring(L, 3, &batch.key_size);
+	size_t total = digest_batch_prepare(L, 2, EVP_MAX_MD_SIZE, false,
+					    &batch);
+	return digest_batch_exec(L, &batch, total);
+}
+
+/**
+ * cipher_batch(algo, mode, direction, list, key, iv) returns a table
+ * with the strings in list encrypted or decrypted with the same key
+ * and initial vector.
+ */
+static int
+lua_cipher_batch(struct lua_State *L)
+{
+	enum crypto_algo algo = luaL_checkinteger(L, 1);
+	enum crypto_mode mode = luaL_checkinteger(L, 2);
+	enum crypto_direction dir = luaL_checkinteger(L, 3);
+	struct digest_batch batch;
+	memset(&batch, 0, sizeof(batch));
+	batch.key = luaL_checklstring(L, 5, &batch.key_size);
+	batch.iv = luaL_checklstring(L, 6, &batch.iv_size);
+	/* Check the input before creating the stream not to leak it. */
+	size_t total = digest_batch_prepare(L, 4, 2 * CRYPTO_MAX_BLOCK_SIZE,
+					    true, &batch);
+	batch.stream = crypto_stream_new(algo, mode, dir);
+	if (batch.stream == NULL)
+		return luaT_error(L);
+	return digest_batch_exec(L, &batch, total);
+}
+
 void
 tarantool_lua_digest_init(struct lua_State *L)
 {
 	static const struct luaL_Reg lua_digest_methods [] = {
 		{"pbkdf2", lua_pbkdf2},
+		{"digest_batch", lua_digest_batch},
+		{"cipher_batch", lua_cipher_batch},
 		{NULL, NULL}
 	};
 	luaL_register_module(L, "digest", lua_digest_methods);
@@ -153,6 +153,23 @@ lbox_checkfiber(struct lua_State *L, int index)
 	return f;
 }
 
+/**
+ * Return statistics of stacks of the current cord's fibers.
+ */
+static int
+lbox_fiber_stack_stat(struct lua_State *L)
+{
+	struct cord *cord = cord();
+	lua_createtable(L, 0, 3);
+	lua_pushnumber(L, cord->stack_size);
+	lua_setfield(L, -2, "total");
+	lua_pushinteger(L, cord->fiber_count);
+	lua_setfield(L, -2, "fibers");
+	lua_pushinteger(L, cord->dead_count);
+	lua_setfield(L, -2, "cached");
+	return 1;
+}
+
 static int
 lbox_fiber_id(struct lua_State *L)
 {
@@ -890,6 +907,7 @@ static const struct luaL_Reg lbox_fiber_meta [] = {
 
 static const struct luaL_Reg fiberlib[] = {
 	{"info", lbox_fiber_info},
+	{"stack_stat", lbox_fiber_stack_stat},
 #if ENABLE_FIBER_TOP
 	{"top", lbox_fiber_top},
 	{"top_enable", lbox_fiber_top_enable},
@@ -13,6 +13,7 @@ ffi.cdef[[
     int umask(int mask);
     char *dirname(char *path);
     int chdir(const char *path);
+    void *memchr(const void *s, int c, size_t n);
 
     struct fio_handle {
         int fh;
@@ -170,6 +171,280 @@ fio_methods.__serialize = function(self)
     return {fh = self.fh}
 end
 
+--
+-- Buffered stream over a file handle, see fio_methods.stream().
+--
+-- A reading stream reads the file in chunks of `readahead` bytes.
+-- While a chunk is consumed, the next one is read by a background
+-- fiber, so reading line by line costs one thread pool round trip
+-- per chunk, and the round trip overlaps with processing.
+--
+-- A writing stream collects writes in a buffer of `write_behind`
+-- bytes. A full buffer is written by a background fiber, and the
+-- writes go to another buffer in the meantime.
+--
+-- The file position of the handle is ahead of the reader and behind
+-- the writer, so a stream is either for reading or for writing, and
+-- the handle must not be used directly until the stream is closed.
+--
+local STREAM_READAHEAD_DEFAULT = 1024 * 1024
+local STREAM_WRITE_BEHIND_DEFAULT = 1024 * 1024
+
+local stream_methods = {}
+
+local function stream_check(self, mode)
+    if self.fh == nil then
+        error('fio stream is closed', 3)
+    end
+    if self.mode == nil then
+        self.mode = mode
+    elseif self.mode ~= mode then
+        error(sprintf('fio stream is open for %s', self.mode), 3)
+    end
+end
+
+-- Wait for the background read or write to finish.
+local function stream_wait(self)
+    while self.busy do
+        self.cond:wait()
+    end
+end
+
+local function stream_prefetch_f(self, buf)
+    local ptr = buf:reserve(self.readahead)
+    local res, err = internal.read(self.fh.fh, ptr, self.readahead)
+    if res == nil then
+        self.err = err
+    elseif res == 0 then
+        self.eof = true
+    else
+        buf:alloc(res)
+    end
+    self.busy = false
+    self.cond:broadcast()
+end
+
+-- Make the read buffer non-empty unless the end of the file is
+-- reached. Returns false and an error on failure.
+local function stream_fill(self)
+    while self.rbuf:size() == 0 do
+        if not self.busy then
+            if self.eof or self.err ~= nil then
+                break
+            end
+            self.busy = true
+            stream_prefetch_f(self, self.rnext)
+        end
+        stream_wait(self)
+        if self.err ~= nil then
+            break
+        end
+        self.rbuf:reset()
+        self.rbuf, self.rnext = self.rnext, self.rbuf
+        if not self.eof then
+            self.busy = true
+            fiber.new(stream_prefetch_f, self, self.rnext)
+        end
+    end
+    if self.err ~= nil and self.rbuf:size() == 0 then
+        local err = self.err
+        self.err = nil
+        return false, err
+    end
+    return true
+end
+
+local function stream_take(self, size)
+    local buf = self.rbuf
+    local str = ffi.string(buf.rpos, size)
+    buf.rpos = buf.rpos + size
+    return str
+end
+
+-- read([size]) -> str, reads up to size bytes or until the end of
+-- the file. Returns an empty string at the end of the file.
+stream_methods.read = function(self, size)
+    stream_check(self, 'reading')
+    if size ~= nil and (type(size) ~= 'number' or size < 0) then
+        error('Usage: stream:read([size])', 2)
+    end
+    local chunks = {}
+    local left = size or math.huge
+    while left > 0 do
+        local ok, err = stream_fill(self)
+        if not ok then
+            return nil, err
+        end
+        local n = math.min(self.rbuf:size(), left)
+        if n == 0 then
+            break
+        end
+        table.insert(chunks, stream_take(self, n))
+        left = left - n
+    end
+    return table.concat(chunks)
+end
+
+-- read_line() -> str, returns the next line without the line
+-- feed or nil at the end of the file.
+stream_methods.read_line = function(self)
+    stream_check(self, 'reading')
+    local chunks = {}
+    while true do
+        local ok, err = stream_fill(self)
+        if not ok then
+            return nil, err
+        end
+        local buf = self.rbuf
+        local size = buf:size()
+        if size == 0 then
+            if #chunks == 0 then
+                return nil
+            end
+            return table.concat(chunks)
+        end
+        local eol = ffi.C.memchr(buf.rpos, 10, size)
+        if eol ~= nil then
+            local len = ffi.cast('char *', eol) - buf.rpos
+            table.insert(chunks, stream_take(self, len))
+            buf.rpos = buf.rpos + 1
+            return table.concat(chunks)
+        end
+        table.insert(chunks, stream_take(self, size))
+    end
+end
+
+-- lines() -> iterator over lines of the rest of the file. Raises
+-- an error on a read failure.
+stream_methods.lines = function(self)
+    return function()
+        local line, err = self:read_line()
+        if err ~= nil then
+            error(err, 2)
+        end
+        return line
+    end
+end
+
+local function stream_write_f(self, buf)
+    local res, err = internal.write(self.fh.fh, buf.rpos, buf:size())
+    if res == nil then
+        self.err = err
+    end
+    buf:reset()
+    self.busy = false
+    self.cond:broadcast()
+end
+
+-- write(str) -> true, the data is written to the file later, by
+-- stream:flush() or in background once the buffer is full. An error
+-- of a background write is returned by the next call.
+stream_methods.write = function(self, data)
+    stream_check(self, 'writing')
+    data = tostring(data)
+    if self.err ~= nil then
+        local err = self.err
+        self.err = nil
+        return false, err
+    end
+    local buf = self.wbuf
+    ffi.copy(buf:alloc(#data), data, #data)
+    if buf:size() >= self.write_behind then
+        stream_wait(self)
+        self.wbuf, self.wnext = self.wnext, buf
+        self.busy = true
+        fiber.new(stream_write_f, self, buf)
+    end
+    return true
+end
+
+-- flush() -> true, writes all buffered data to the file.
+stream_methods.flush = function(self)
+    if self.fh == nil then
+        error('fio stream is closed', 2)
+    end
+    if self.mode ~= 'writing' then
+        return true
+    end
+    stream_wait(self)
+    if self.wbuf:size() > 0 then
+        self.busy = true
+        stream_write_f(self, self.wbuf)
+    end
+    if self.err ~= nil then
+        local err = self.err
+        self.err = nil
+        return false, err
+    end
+    return true
+end
+
+-- close() -> true, flushes the stream. The file handle is closed
+-- too unless the stream was created with {close = false}.
+stream_methods.close = function(self)
+    local ok, err = self:flush()
+    stream_wait(self)
+    local fh = self.fh
+    self.fh = nil
+    self.rbuf:recycle()
+    self.rnext:recycle()
+    self.wbuf:recycle()
+    self.wnext:recycle()
+    if self.close_fh then
+        local res, close_err = fh:close()
+        if ok and not res then
+            ok, err = res, close_err
+        end
+    end
+    return ok, err
+end
+
+local stream_mt = {
+    __index = stream_methods,
+    __serialize = function(self)
+        return {mode = self.mode, readahead = self.readahead,
+                write_behind = self.write_behind}
+    end,
+}
+
+local function check_stream_size(opts, name, default)
+    local size = opts[name]
+    if size == nil then
+        return default
+    end
+    if type(size) ~= 'number' or size <= 0 then
+        error(sprintf('fio stream: %s must be a positive number', name), 3)
+    end
+    return size
+end
+
+-- stream([opts]) -> a buffered stream over the file handle.
+--   opts.readahead - size of a read, 1 MB by default;
+--   opts.write_behind - size of a write, 1 MB by default;
+--   opts.close - close the handle when the stream is closed,
+--                true by default.
+fio_methods.stream = function(self, opts)
+    opts = opts or {}
+    if type(opts) ~= 'table' then
+        error('Usage: fh:stream([opts])', 2)
+    end
+    return setmetatable({
+        fh = self,
+        readahead = check_stream_size(opts, 'readahead',
+                                      STREAM_READAHEAD_DEFAULT),
+        write_behind = check_stream_size(opts, 'write_behind',
+                                         STREAM_WRITE_BEHIND_DEFAULT),
+        close_fh = opts.close ~= false,
+        rbuf = buffer.ibuf(),
+        rnext = buffer.ibuf(),
+        wbuf = buffer.ibuf(),
+        wnext = buffer.ibuf(),
+        cond = fiber.cond(),
+        busy = false,
+        eof = false,
+    }, stream_mt)
+end
+
 local fio_mt = {
     __index = fio_methods,
     __gc = function(obj)
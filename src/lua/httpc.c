@@ -33,11 +33,13 @@
  * Unique name for userdata metatables
  */
 #define DRIVER_LUA_UDATA_NAME	"httpc"
+#define REQUEST_LUA_UDATA_NAME	"httpc.request"
 
 #include "http_parser/http_parser.h"
 #include <httpc.h>
 #include "say.h"
 #include "lua/utils.h"
+#include "lua/error.h"
 #include "lua/httpc.h"
 #include "core/fiber.h"
 
@@ -141,63 +143,74 @@ parse_headers(lua_State *L, char *buffer, size_t len,
 
 enum { MAX_HTTP_HEADER_NAME_LEN = 32 };
 
-static int
-luaT_httpc_request(lua_State *L)
-{
-	struct httpc_env *ctx = luaT_httpc_checkenv(L);
-	if (ctx == NULL)
-		return luaL_error(L, "can't get httpc environment");
+/** A request prepared by client:prepare() for client:execute_many(). */
+struct luaT_httpc_prepared {
+	/** The request, NULL once executed. */
+	struct httpc_request *req;
+	int max_header_name_length;
+};
 
+/**
+ * Create a request from the arguments of client:request() at
+ * indexes 2-5: method, url, body and options. Raises an error
+ * on failure.
+ */
+static struct httpc_request *
+luaT_httpc_request_new(lua_State *L, struct httpc_env *ctx, double *timeout,
+		       int *max_header_name_length)
+{
 	const char *method = luaL_checkstring(L, 2);
 	const char *url  = luaL_checkstring(L, 3);
 
 	struct httpc_request *req = httpc_request_new(ctx, method, url);
-	if (req == NULL)
-		return luaT_error(L);
+	if (req == NULL) {
+		luaT_error(L);
+		unreachable();
+	}
 
-	double timeout = TIMEOUT_INFINITY;
-	int max_header_name_length = MAX_HTTP_HEADER_NAME_LEN;
+	*timeout = TIMEOUT_INFINITY;
+	*max_header_name_length = MAX_HTTP_HEADER_NAME_LEN;
 	if (lua_isstring(L, 4)) {
 		size_t len = 0;
 		const char *body = lua_tolstring(L, 4, &len);
 		if (len > 0 && httpc_set_body(req, body, len) != 0) {
 			httpc_request_delete(req);
-			return luaT_error(L);
+			luaT_error(L);
 		}
 	} else if (!lua_isnil(L, 4)) {
 		httpc_request_delete(req);
-		return luaL_error(L, "fourth argument must be a string");
+		luaL_error(L, "fourth argument must be a string");
 	}
 
 	if (!lua_istable(L, 5)) {
 		httpc_request_delete(req);
-		return luaL_error(L, "fifth argument must be a table");
+		luaL_error(L, "fifth argument must be a table");
 	}
 
 	lua_getfield(L, 5, "headers");
 	if (!lua_isnil(L, -1)) {
 		if (lua_istable(L, -1) == 0) {
 			httpc_request_delete(req);
-			return luaL_error(L, "opts.headers should be a table");
+			luaL_error(L, "opts.headers should be a table");
 		}
 		lua_pushnil(L);
 		while (lua_next(L, -2) != 0) {
 			int header_type = lua_type(L, -1);
 			if (header_type != LUA_TSTRING) {
 				httpc_request_delete(req);
-				return luaL_error(L, "opts.headers values "
+				luaL_error(L, "opts.headers values "
 						  "should be strings");
 			}
 			if (lua_type(L, -2) != LUA_TSTRING) {
 				httpc_request_delete(req);
-				return luaL_error(L, "opts.headers keys should "
+				luaL_error(L, "opts.headers keys should "
 						  "be strings");
 			}
 			if (httpc_set_header(req, "%s: %s",
 					     lua_tostring(L, -2),
 					     lua_tostring(L, -1)) < 0) {
 				httpc_request_delete(req);
-				return luaT_error(L);
+				luaT_error(L);
 			}
 			lua_pop(L, 1);
 		}
@@ -218,7 +231,7 @@ luaT_httpc_request(lua_State *L)
 	if (!lua_isnil(L, -1)) {
 		if(httpc_set_unix_socket(req, lua_tostring(L, -1))) {
 			httpc_request_delete(req);
-			return luaT_error(L);
+			luaT_error(L);
 		}
 	}
 	lua_pop(L, 1);
@@ -292,12 +305,12 @@ luaT_httpc_request(lua_State *L)
 
 	lua_getfield(L, 5, "timeout");
 	if (!lua_isnil(L, -1))
-		timeout = lua_tonumber(L, -1);
+		*timeout = lua_tonumber(L, -1);
 	lua_pop(L, 1);
 
 	lua_getfield(L, 5, "max_header_name_length");
 	if (!lua_isnil(L, -1))
-		max_header_name_length = lua_tonumber(L, -1);
+		*max_header_name_length = lua_tonumber(L, -1);
 	lua_pop(L, 1);
 
 	lua_getfield(L, 5, "verbose");
@@ -320,11 +333,17 @@ luaT_httpc_request(lua_State *L)
 		httpc_set_accept_encoding(req, lua_tostring(L, -1));
 	lua_pop(L, 1);
 
-	if (httpc_execute(req, timeout) != 0) {
-		httpc_request_delete(req);
-		return luaT_error(L);
-	}
+	return req;
+}
 
+/**
+ * Push a table with the response to a request: status, reason,
+ * headers and body.
+ */
+static int
+luaT_httpc_push_response(lua_State *L, struct httpc_request *req,
+			 int max_header_name_length)
+{
 	lua_newtable(L);
 
 	lua_pushstring(L, "status");
@@ -340,8 +359,7 @@ luaT_httpc_request(lua_State *L)
 		char *headers = region_join(&req->resp_headers, headers_len);
 		if (headers == NULL) {
 			diag_set(OutOfMemory, headers_len, "region", "headers");
-			httpc_request_delete(req);
-			return luaT_error(L);
+			return -1;
 		}
 		if (parse_headers(L, headers, headers_len,
 				  max_header_name_length) < 0)
@@ -353,19 +371,147 @@ luaT_httpc_request(lua_State *L)
 		char *body = region_join(&req->resp_body, body_len);
 		if (body == NULL) {
 			diag_set(OutOfMemory, body_len, "region", "body");
-			httpc_request_delete(req);
-			return luaT_error(L);
+			return -1;
 		}
 		lua_pushstring(L, "body");
 		lua_pushlstring(L, body, body_len);
 		lua_settable(L, -3);
 	}
+	return 0;
+}
+
+static int
+luaT_httpc_request(lua_State *L)
+{
+	struct httpc_env *ctx = luaT_httpc_checkenv(L);
+	if (ctx == NULL)
+		return luaL_error(L, "can't get httpc environment");
+
+	double timeout;
+	int max_header_name_length;
+	struct httpc_request *req = luaT_httpc_request_new(
+		L, ctx, &timeout, &max_header_name_length);
+
+	if (httpc_execute(req, timeout) != 0 ||
+	    luaT_httpc_push_response(L, req, max_header_name_length) != 0) {
+		httpc_request_delete(req);
+		return luaT_error(L);
+	}
 
 	/* clean up */
 	httpc_request_delete(req);
 	return 1;
 }
 
+/**
+ * client:prepare(method, url, body, opts) creates a request to be
+ * executed later with client:execute_many().
+ */
+static int
+luaT_httpc_prepare(lua_State *L)
+{
+	struct httpc_env *ctx = luaT_httpc_checkenv(L);
+	lua_settop(L, 5);
+	struct luaT_httpc_prepared *prepared =
+		lua_newuserdata(L, sizeof(*prepared));
+	prepared->req = NULL;
+	luaL_getmetatable(L, REQUEST_LUA_UDATA_NAME);
+	lua_setmetatable(L, -2);
+
+	double timeout;
+	prepared->req = luaT_httpc_request_new(
+		L, ctx, &timeout, &prepared->max_header_name_length);
+	return 1;
+}
+
+static int
+luaT_httpc_prepared_gc(lua_State *L)
+{
+	struct luaT_httpc_prepared *prepared =
+		luaL_checkudata(L, 1, REQUEST_LUA_UDATA_NAME);
+	if (prepared->req != NULL)
+		httpc_request_delete(prepared->req);
+	prepared->req = NULL;
+	return 0;
+}
+
+/**
+ * client:execute_many(requests, timeout) executes requests
+ * created by client:prepare() concurrently, waking the fiber up
+ * once all of them are done. Returns a table of responses and a
+ * table of errors, indexed as the requests. Each request can be
+ * executed only once.
+ */
+static int
+luaT_httpc_execute_many(lua_State *L)
+{
+	struct httpc_env *ctx = luaT_httpc_checkenv(L);
+	luaL_checktype(L, 2, LUA_TTABLE);
+	double timeout = luaL_optnumber(L, 3, TIMEOUT_INFINITY);
+	int count = lua_objlen(L, 2);
+	struct httpc_request **reqs =
+		lua_newuserdata(L, count * sizeof(*reqs));
+	for (int i = 0; i < count; i++) {
+		lua_rawgeti(L, 2, i + 1);
+		struct luaT_httpc_prepared *prepared =
+			luaL_checkudata(L, -1, REQUEST_LUA_UDATA_NAME);
+		if (prepared->req == NULL)
+			return luaL_error(L, "request %d was already executed",
+					  i + 1);
+		if (prepared->req->env != ctx)
+			return luaL_error(L, "request %d belongs to another "
+					  "client", i + 1);
+		reqs[i] = prepared->req;
+		lua_pop(L, 1);
+	}
+	/* The requests are referenced by the table. */
+	if (httpc_execute_many(reqs, count, timeout) != 0)
+		return luaT_error(L);
+
+	lua_createtable(L, count, 0);
+	lua_newtable(L);
+	for (int i = 0; i < count; i++) {
+		lua_rawgeti(L, 2, i + 1);
+		struct luaT_httpc_prepared *prepared = lua_touserdata(L, -1);
+		lua_pop(L, 1);
+		int top = lua_gettop(L);
+		if (httpc_request_finish(prepared->req) == 0 &&
+		    luaT_httpc_push_response(
+				L, prepared->req,
+				prepared->max_header_name_length) == 0) {
+			lua_rawseti(L, -3, i + 1);
+		} else {
+			lua_settop(L, top);
+			luaT_pusherror(L, diag_last_error(diag_get()));
+			lua_rawseti(L, -2, i + 1);
+		}
+		httpc_request_delete(prepared->req);
+		prepared->req = NULL;
+	}
+	return 2;
+}
+
+/** Push statistics of a host to the table on top of the stack. */
+static void
+luaT_httpc_push_host_stat(struct httpc_host_stat *stat, void *arg)
+{
+	lua_State *L = arg;
+	lua_pushlstring(L, stat->name, stat->name_len);
+	lua_newtable(L);
+	lua_add_key_u64(L, "total_requests", stat->total_requests);
+	lua_add_key_u64(L, "failed_requests", stat->failed_requests);
+	lua_add_key_u64(L, "new_connections", stat->new_connections);
+	lua_add_key_u64(L, "reused_connections", stat->reused_connections);
+	lua_pushstring(L, "latency");
+	lua_newtable(L);
+	lua_pushnumber(L, latency_get(&stat->latency, 50));
+	lua_setfield(L, -2, "p50");
+	lua_pushnumber(L, latency_get(&stat->latency, 99));
+	lua_setfield(L, -2, "p99");
+	lua_settable(L, -3);
+	lua_settable(L, -3);
+}
+
 static int
 luaT_httpc_stat(lua_State *L)
 {
@@ -389,6 +535,11 @@ luaT_httpc_stat(lua_State *L)
 	lua_add_key_u64(L, "failed_requests",
 			(uint64_t) ctx->stat.failed_requests);
 
+	lua_pushstring(L, "hosts");
+	lua_newtable(L);
+	httpc_env_foreach_host_stat(ctx, luaT_httpc_push_host_stat, L);
+	lua_settable(L, -3);
+
 	return 1;
 }
 
@@ -402,7 +553,10 @@ luaT_httpc_new(lua_State *L)
 
 	long max_conns = luaL_checklong(L, 1);
 	long max_total_conns = luaL_checklong(L, 2);
-	if (httpc_env_create(ctx, max_conns, max_total_conns) != 0)
+	long max_host_conns = luaL_optlong(L, 3, 0);
+	bool http2 = lua_toboolean(L, 4);
+	if (httpc_env_create(ctx, max_conns, max_total_conns, max_host_conns,
+			     http2) != 0)
 		return luaT_error(L);
 
 	luaL_getmetatable(L, DRIVER_LUA_UDATA_NAME);
@@ -440,11 +594,18 @@ static const struct luaL_Reg Module[] = {
 
 static const struct luaL_Reg Client[] = {
 	{"request", luaT_httpc_request},
+	{"prepare", luaT_httpc_prepare},
+	{"execute_many", luaT_httpc_execute_many},
 	{"stat", luaT_httpc_stat},
 	{"__gc", luaT_httpc_cleanup},
 	{NULL, NULL}
 };
 
+static const struct luaL_Reg Request[] = {
+	{"__gc", luaT_httpc_prepared_gc},
+	{NULL, NULL}
+};
+
 /*
  * Lib initializer
  */
@@ -452,6 +613,7 @@ LUA_API int
 luaopen_http_client_driver(lua_State *L)
 {
 	luaL_register_type(L, DRIVER_LUA_UDATA_NAME, Client);
+	luaL_register_type(L, REQUEST_LUA_UDATA_NAME, Request);
 	luaL_register_module(L, "http.client", Module);
 	return 1;
 }
@@ -41,6 +41,11 @@ local curl_mt
 --
 --  max_connections -  Maximum number of entries in the connection cache
 --  max_total_connections -  Maximum number of active connections
+--  max_host_connections -  Maximum number of active connections to
+--                          a single host
+--  http2 - use HTTP/2 for https:// requests if the server supports
+--          it and send concurrent requests to a host over one
+--          connection
 --
 --  Returns:
 --  curl object or raise error()
@@ -52,8 +57,10 @@ local http_new = function(opts)
 
     opts.max_connections = opts.max_connections or -1
     opts.max_total_connections = opts.max_total_connections or 0
+    opts.max_host_connections = opts.max_host_connections or 0
 
-    local curl = driver.new(opts.max_connections, opts.max_total_connections)
+    local curl = driver.new(opts.max_connections, opts.max_total_connections,
+                            opts.max_host_connections, opts.http2 == true)
     return setmetatable({ curl = curl, }, curl_mt )
 end
 
@@ -228,6 +235,16 @@ local function process_headers(headers)
     return headers
 end
 
+local function process_response(resp)
+    if resp and resp.headers then
+        if resp.headers['set-cookie'] ~= nil then
+            resp.cookies = process_cookies(resp.headers['set-cookie'])
+        end
+        resp.headers = process_headers(resp.headers)
+    end
+    return resp
+end
+
 --
 --  <request> This function does HTTP request
 --
@@ -318,13 +335,46 @@ curl_mt = {
                 error('request(method, url[, body, [options]])')
             end
             local resp = self.curl:request(method, url, body, opts or {})
-            if resp and resp.headers then
-                if resp.headers['set-cookie'] ~= nil then
-                    resp.cookies = process_cookies(resp.headers['set-cookie'])
+            return process_response(resp)
+        end,
+
+        --
+        --  <request_many> - execute a list of requests concurrently
+        --
+        --  Parameters:
+        --
+        --  requests - a list of requests, each is a table
+        --      {method, url[, body[, options]]}, see <request>.
+        --      The timeout option of a request is ignored.
+        --  options - a table with the timeout of the whole batch
+        --
+        --  The fiber yields until all requests are done or the
+        --  timeout expires, so it is woken up once no matter how
+        --  many requests there are.
+        --
+        --  Returns: a list of responses and a list of errors, both
+        --  indexed as the requests. A request either has a response
+        --  or an error.
+        --
+        request_many = function(self, requests, options)
+            check_args(self, 'request_many')
+            if type(requests) ~= 'table' then
+                error('request_many(requests[, options])')
+            end
+            local prepared = {}
+            for i, r in ipairs(requests) do
+                if type(r) ~= 'table' or not r[1] or not r[2] then
+                    error(('request_many: request %d must be ' ..
+                           '{method, url[, body[, options]]}'):format(i))
                 end
-                resp.headers = process_headers(resp.headers)
+                prepared[i] = self.curl:prepare(r[1], r[2], r[3], r[4] or {})
+            end
+            local timeout = options and options.timeout
+            local resps, errs = self.curl:execute_many(prepared, timeout)
+            for _, resp in pairs(resps) do
+                process_response(resp)
             end
-            return resp
+            return resps, errs
         end,
 
         --
@@ -425,6 +475,11 @@ curl_mt = {
         --  failed_requests - this is a total number of requests which have
         --      failed (included systeme erros, curl errors, HTTP
         --      errors and so on)
+        --
+        --  hosts - a table of statistics per host (and port, if it
+        --      is given in the URL) with total_requests,
+        --      failed_requests, new_connections, reused_connections
+        --      and latency = {p50, p99} in seconds
         --  }
         --  or error()
         --
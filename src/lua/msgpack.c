@@ -233,7 +233,32 @@ restart: /* used by MP_EXT of unidentified subtype */
 		}
 		uint32_t size = field->size;
 		mpstream_encode_array(stream, size);
+		/*
+		 * Numbers and strings stored in the array part of
+		 * a table are encoded right from the table slots,
+		 * without pushing them onto the Lua stack.
+		 */
+		GCtab *t = lua_type(L, top) == LUA_TTABLE ?
+			   tabV(L->base + top - 1) : NULL;
 		for (uint32_t i = 0; i < size; i++) {
+			if (t != NULL && i + 1 < t->asize) {
+				cTValue *tv = arrayslot(t, i + 1);
+				if (tvisnumber(tv)) {
+					double num = numberVnum(tv);
+					if (luaL_number_tofield(cfg, num,
+								field) < 0)
+						return luaT_error(L);
+					luamp_encode_r(L, cfg, stream, field,
+						       level + 1);
+					continue;
+				}
+				if (tvisstr(tv)) {
+					mpstream_encode_strn(stream,
+							     strVdata(tv),
+							     strV(tv)->len);
+					continue;
+				}
+			}
 			lua_rawgeti(L, top, i + 1);
 			if (luaL_tofield(L, cfg, top + 1, field) < 0)
 				return luaT_error(L);
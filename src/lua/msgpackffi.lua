@@ -10,6 +10,7 @@ local uint16_ptr_t = ffi.typeof('uint16_t *')
 local uint32_ptr_t = ffi.typeof('uint32_t *')
 local uint64_ptr_t = ffi.typeof('uint64_t *')
 local char_ptr_t = ffi.typeof('char *')
+local const_char_ptr_t = ffi.typeof('const char *')
 local cord_ibuf_take = buffer.internal.cord_ibuf_take
 local cord_ibuf_drop = buffer.internal.cord_ibuf_drop
 
@@ -643,6 +644,31 @@ decode_r = function(data)
     end
 end
 
+-- Same as decode_r(), but a string or a binary is not copied:
+-- a pointer to its data and its size are returned instead.
+local function decode_view(data)
+    local c = data[0][0]
+    local size
+    if c >= 0xa0 and c <= 0xbf then
+        data[0] = data[0] + 1
+        size = bit.band(c, 0x1f)
+    elseif c == 0xd9 or c == 0xc4 then
+        data[0] = data[0] + 1
+        size = decode_u8(data)
+    elseif c == 0xda or c == 0xc5 then
+        data[0] = data[0] + 1
+        size = decode_u16(data)
+    elseif c == 0xdb or c == 0xc6 then
+        data[0] = data[0] + 1
+        size = decode_u32(data)
+    else
+        return decode_r(data)
+    end
+    local ptr = ffi.cast(const_char_ptr_t, data[0])
+    data[0] = data[0] + size
+    return ptr, size
+end
+
 ---
 -- All decode_XXX functions accept const char **data as its first argument,
 -- like libmsgpuck does. After decoding data[0] position is changed to the next
@@ -699,5 +725,6 @@ return {
         encode_fix = encode_fix;
         encode_array = encode_array;
         encode_r = encode_r;
+        decode_view = decode_view;
     }
 }
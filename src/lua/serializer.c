@@ -429,6 +429,35 @@ lua_field_tostring(struct lua_State *L, struct luaL_serializer *cfg, int idx,
 		luaT_error(L);
 }
 
+int
+luaL_number_tofield(struct luaL_serializer *cfg, double num,
+		    struct luaL_field *field)
+{
+	double intpart;
+	if (isfinite(num) && modf(num, &intpart) != 0.0) {
+		field->type = MP_DOUBLE;
+		field->dval = num;
+	} else if (num >= 0 && num < exp2(64)) {
+		field->type = MP_UINT;
+		field->ival = (uint64_t) num;
+	} else if (num >= -exp2(63) && num < exp2(63)) {
+		field->type = MP_INT;
+		field->ival = (int64_t) num;
+	} else {
+		field->type = MP_DOUBLE;
+		field->dval = num;
+		if (!isfinite(num) && !cfg->encode_invalid_numbers) {
+			if (!cfg->encode_invalid_as_nil) {
+				diag_set(LuajitError,
+					 "number must not be NaN or Inf");
+				return -1;
+			}
+			field->type = MP_NIL;
+		}
+	}
+	return 0;
+}
+
 int
 luaL_tofield(struct lua_State *L, struct luaL_serializer *cfg, int index,
 	     struct luaL_field *field)
@@ -436,8 +465,6 @@ luaL_tofield(struct lua_State *L, struct luaL_serializer *cfg, int index,
 	if (index < 0)
 		index = lua_gettop(L) + index + 1;
 
-	double num;
-	double intpart;
 	size_t size;
 
 #define CHECK_NUMBER(x) ({							\
@@ -451,22 +478,7 @@ luaL_tofield(struct lua_State *L, struct luaL_serializer *cfg, int index,
 
 	switch (lua_type(L, index)) {
 	case LUA_TNUMBER:
-		num = lua_tonumber(L, index);
-		if (isfinite(num) && modf(num, &intpart) != 0.0) {
-			field->type = MP_DOUBLE;
-			field->dval = num;
-		} else if (num >= 0 && num < exp2(64)) {
-			field->type = MP_UINT;
-			field->ival = (uint64_t) num;
-		} else if (num >= -exp2(63) && num < exp2(63)) {
-			field->type = MP_INT;
-			field->ival = (int64_t) num;
-		} else {
-			field->type = MP_DOUBLE;
-			field->dval = num;
-			CHECK_NUMBER(num);
-		}
-		return 0;
+		return luaL_number_tofield(cfg, lua_tonumber(L, index), field);
 	case LUA_TCDATA:
 	{
 		GCcdata *cd = cdataV(L->base + index - 1);
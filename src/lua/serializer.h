@@ -284,6 +284,19 @@ int
 luaL_tofield(struct lua_State *L, struct luaL_serializer *cfg, int index,
 	     struct luaL_field *field);
 
+/**
+ * Convert a Lua number to a field the same way luaL_tofield()
+ * does it for LUA_TNUMBER. It lets encoders convert numbers read
+ * directly from a table without pushing them onto the stack.
+ *
+ * @retval  0 Success.
+ * @retval -1 The number is NaN or Inf and the serializer can't
+ *            encode it, a diag is set.
+ */
+int
+luaL_number_tofield(struct luaL_serializer *cfg, double num,
+		    struct luaL_field *field);
+
 /**
  * @brief Try to convert userdata/cdata values using defined conversion logic.
  * Must be used only after lua_tofield().
@@ -44,6 +44,9 @@
 #include <netinet/tcp.h>
 #include <netinet/udp.h>
 #include <unistd.h>
+#if defined(__linux__)
+#include <linux/errqueue.h>
+#endif
 
 #include <lua.h>
 #include <lauxlib.h>
@@ -482,6 +485,63 @@ lbox_socket_nonblock(int fh, int mode)
 	return mode ? 1 : 0;
 }
 
+int
+lbox_socket_zerocopy_enable(int fd)
+{
+#if defined(SO_ZEROCOPY) && defined(MSG_ZEROCOPY)
+	int one = 1;
+	return setsockopt(fd, SOL_SOCKET, SO_ZEROCOPY, &one, sizeof(one));
+#else
+	(void)fd;
+	errno = ENOTSUP;
+	return -1;
+#endif
+}
+
+int
+lbox_socket_zerocopy_reap(int fd, uint32_t *done)
+{
+#if defined(SO_EE_ORIGIN_ZEROCOPY)
+	char control[CMSG_SPACE(sizeof(struct sock_extended_err)) * 4];
+	while (true) {
+		struct msghdr msg;
+		memset(&msg, 0, sizeof(msg));
+		msg.msg_control = control;
+		msg.msg_controllen = sizeof(control);
+		if (recvmsg(fd, &msg, MSG_ERRQUEUE | MSG_DONTWAIT) < 0) {
+			if (errno == EAGAIN || errno == EWOULDBLOCK)
+				return 0;
+			return -1;
+		}
+		for (struct cmsghdr *cmsg = CMSG_FIRSTHDR(&msg); cmsg != NULL;
+		     cmsg = CMSG_NXTHDR(&msg, cmsg)) {
+			if (!(cmsg->cmsg_level == SOL_IP &&
+			      cmsg->cmsg_type == IP_RECVERR) &&
+			    !(cmsg->cmsg_level == SOL_IPV6 &&
+			      cmsg->cmsg_type == IPV6_RECVERR))
+				continue;
+			struct sock_extended_err *err =
+				(struct sock_extended_err *)CMSG_DATA(cmsg);
+			if (err->ee_errno != 0 ||
+			    err->ee_origin != SO_EE_ORIGIN_ZEROCOPY)
+				continue;
+			/*
+			 * Sends [ee_info, ee_data] are complete. TCP
+			 * completes them in order, so the upper bound
+			 * is enough.
+			 */
+			if (err->ee_data + 1 > *done)
+				*done = err->ee_data + 1;
+		}
+	}
+#else
+	(void)fd;
+	(void)done;
+	errno = ENOTSUP;
+	return -1;
+#endif
+}
+
 static int
 lbox_socket_iowait(struct lua_State *L)
 {
@@ -31,6 +31,7 @@
  * SUCH DAMAGE.
  */
 #include <stddef.h>
+#include <stdint.h>
 #include <sys/socket.h>
 
 #if defined(__cplusplus)
@@ -46,6 +47,21 @@ lbox_socket_local_resolve(const char *host, const char *port,
 int
 lbox_socket_nonblock(int fh, int mode);
 
+/**
+ * Enable MSG_ZEROCOPY sends on a socket. Fails with ENOTSUP if the
+ * platform doesn't support them.
+ */
+int
+lbox_socket_zerocopy_enable(int fd);
+
+/**
+ * Read MSG_ZEROCOPY completion notifications from the socket error
+ * queue without blocking. @a done is the number of the sends known
+ * to be complete, it is updated by the notifications.
+ */
+int
+lbox_socket_zerocopy_reap(int fd, uint32_t *done);
+
 #if defined(__cplusplus)
 } /* extern "C" */
 #endif
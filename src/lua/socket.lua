@@ -16,6 +16,16 @@ local cord_ibuf_drop = buffer.internal.cord_ibuf_drop
 
 local format = string.format
 
+local ibuf_t = ffi.typeof('struct ibuf')
+local iovec_t = ffi.typeof('struct iovec[?]')
+-- Max number of buffers passed to readv() and writev() at once.
+local IOV_MAX = 1024
+-- Smaller sends are cheaper to copy than to pin, see the kernel
+-- documentation on MSG_ZEROCOPY.
+local ZEROCOPY_THRESHOLD = 64 * 1024
+local ZEROCOPY_POLL_INTERVAL = 0.01
+local MSG_ZEROCOPY = 0x4000000
+
 ffi.cdef[[
     struct gc_socket {
         const int fd;
@@ -44,6 +54,15 @@ ffi.cdef[[
     lbox_socket_local_resolve(const char *host, const char *port,
                          struct sockaddr *addr, socklen_t *socklen);
     int lbox_socket_nonblock(int fd, int mode);
+    int lbox_socket_zerocopy_enable(int fd);
+    int lbox_socket_zerocopy_reap(int fd, uint32_t *done);
+
+    struct iovec {
+        void *iov_base;
+        size_t iov_len;
+    };
+    ssize_t readv(int fd, const struct iovec *iov, int iovcnt);
+    ssize_t writev(int fd, const struct iovec *iov, int iovcnt);
 
     int setsockopt(int s, int level, int iname, const void *opt, size_t optlen);
     int getsockopt(int s, int level, int iname, void *ptr, size_t *optlen);
@@ -780,6 +799,288 @@ local function socket_write(self, octets, timeout)
     return nil
 end
 
+--
+-- I/O with ibuf. The data is read to and written from the buffer
+-- memory directly, without Lua strings in between.
+--
+
+local function check_ibuf(buf, usage)
+    if not ffi.istype(ibuf_t, buf) then
+        error(usage)
+    end
+end
+
+-- Read into the buffers of the list of {ibuf, size} in order. Each
+-- ibuf gets size bytes reserved and its wpos advanced by the number
+-- of bytes read into it. The ibufs must be distinct, since reserving
+-- memory in one may move it. Returns the total number of bytes read,
+-- 0 on EOF, or nil on error or timeout.
+local function readv(self, bufs, timeout, usage)
+    local fd = check_socket(self)
+    timeout = timeout or TIMEOUT_INFINITY
+    local count = #bufs
+    local iov = iovec_t(count)
+    local total = 0
+    for i = 1, count do
+        if type(bufs[i]) ~= 'table' then
+            error(usage)
+        end
+        local buf, size = bufs[i][1], bufs[i][2] or buffer.READAHEAD
+        check_ibuf(buf, usage)
+        if type(size) ~= 'number' or size < 0 then
+            error(usage)
+        end
+        iov[i - 1].iov_base = buf:reserve(size)
+        iov[i - 1].iov_len = size
+        total = total + size
+    end
+
+    local res
+    local rbuf = self.rbuf
+    if rbuf ~= nil and rbuf:size() > 0 then
+        -- Data buffered by socket:read() goes first.
+        self._errno = nil
+        res = math.min(rbuf:size(), total)
+        local done = 0
+        for i = 0, count - 1 do
+            local len = math.min(tonumber(iov[i].iov_len), res - done)
+            ffi.copy(iov[i].iov_base, rbuf.rpos + done, len)
+            done = done + len
+        end
+        rbuf.rpos = rbuf.rpos + res
+    else
+        local deadline = fiber.clock() + timeout
+        repeat
+            self._errno = nil
+            res = ffi.C.readv(fd, iov, math.min(count, IOV_MAX))
+            if res >= 0 then
+                res = tonumber(res)
+                break
+            end
+            res = nil
+            self._errno = boxerrno()
+            if not errno_is_transient[self._errno] then
+                return nil
+            end
+        until not socket_readable(self, deadline - fiber.clock())
+        if res == nil then
+            return nil
+        end
+    end
+
+    local left = res
+    for i = 1, count do
+        local buf = bufs[i][1]
+        local len = math.min(tonumber(iov[i - 1].iov_len), left)
+        buf.wpos = buf.wpos + len
+        left = left - len
+    end
+    return res
+end
+
+local function socket_recv_into(self, ibuf, size, timeout)
+    return readv(self, {{ibuf, size}}, timeout,
+                 'Usage: socket:recv_into(ibuf[, size[, timeout]])')
+end
+
+local function socket_readv(self, bufs, timeout)
+    local usage = 'Usage: socket:readv({{ibuf, size}, ...}[, timeout])'
+    if type(bufs) ~= 'table' then
+        error(usage)
+    end
+    return readv(self, bufs, timeout, usage)
+end
+
+-- Write the strings and the contents of the ibufs of the list with
+-- as few system calls as possible. The written data is consumed
+-- from the ibufs, even if not all of it is written.
+local function socket_writev(self, bufs, timeout)
+    local usage = 'Usage: socket:writev({data or ibuf, ...}[, timeout])'
+    local fd = check_socket(self)
+    if type(bufs) ~= 'table' then
+        error(usage)
+    end
+    timeout = timeout or TIMEOUT_INFINITY
+    local count = #bufs
+    local iov = iovec_t(count)
+    local total = 0
+    for i = 1, count do
+        local buf = bufs[i]
+        local v = iov[i - 1]
+        if type(buf) == 'string' then
+            v.iov_base = ffi.cast('void *', ffi.cast('const char *', buf))
+            v.iov_len = #buf
+        else
+            check_ibuf(buf, usage)
+            v.iov_base = buf.rpos
+            v.iov_len = buf:size()
+        end
+        total = total + tonumber(v.iov_len)
+    end
+    if total == 0 then
+        return 0
+    end
+
+    local written = 0
+    local first = 0
+    local deadline = fiber.clock() + timeout
+    repeat
+        self._errno = nil
+        local res = ffi.C.writev(fd, iov + first,
+                                 math.min(count - first, IOV_MAX))
+        if res >= 0 then
+            res = tonumber(res)
+            written = written + res
+            if written == total then
+                break
+            end
+            -- Skip what is written.
+            while res > 0 do
+                local v = iov[first]
+                local len = tonumber(v.iov_len)
+                if res >= len then
+                    first = first + 1
+                    res = res - len
+                else
+                    v.iov_base = ffi.cast('char *', v.iov_base) + res
+                    v.iov_len = len - res
+                    res = 0
+                end
+            end
+        else
+            self._errno = boxerrno()
+            if not errno_is_transient[self._errno] then
+                break
+            end
+        end
+    until not socket_writable(self, deadline - fiber.clock())
+
+    local left = written
+    for i = 1, count do
+        local buf = bufs[i]
+        local len = math.min(type(buf) == 'string' and #buf or buf:size(),
+                             left)
+        if type(buf) ~= 'string' then
+            buf.rpos = buf.rpos + len
+        end
+        left = left - len
+    end
+    if written < total then
+        return nil
+    end
+    return written
+end
+
+-- Enable MSG_ZEROCOPY for big socket:send_from() writes. Returns
+-- false if the platform doesn't support it.
+local function socket_zerocopy(self, enable)
+    local fd = check_socket(self)
+    self._errno = nil
+    if not enable then
+        self._zerocopy = false
+        return true
+    end
+    if ffi.C.lbox_socket_zerocopy_enable(fd) ~= 0 then
+        self._errno = boxerrno()
+        return false
+    end
+    self._zerocopy = true
+    self._zerocopy_sent = self._zerocopy_sent or 0
+    self._zerocopy_done = self._zerocopy_done or 0
+    return true
+end
+
+local zerocopy_done = ffi.new('uint32_t[1]')
+
+-- Wait until the kernel stops referencing the memory passed to
+-- MSG_ZEROCOPY sends.
+local function zerocopy_wait(self, deadline)
+    local fd = check_socket(self)
+    while true do
+        zerocopy_done[0] = self._zerocopy_done
+        if ffi.C.lbox_socket_zerocopy_reap(fd, zerocopy_done) ~= 0 then
+            self._errno = boxerrno()
+            return false
+        end
+        self._zerocopy_done = zerocopy_done[0]
+        if self._zerocopy_done >= self._zerocopy_sent then
+            return true
+        end
+        local timeout = deadline - fiber.clock()
+        if timeout < 0 then
+            self._errno = boxerrno.ETIMEDOUT
+            return false
+        end
+        -- A completion is an error event, which wakes up readers,
+        -- but so does pending input, hence the bounded wait.
+        internal.iowait(fd, 1, math.min(timeout, ZEROCOPY_POLL_INTERVAL))
+        fiber.testcancel()
+    end
+end
+
+-- Write size bytes (all by default) from the ibuf and consume them.
+-- Returns the number of bytes written, or nil on error or timeout,
+-- in which case the ibuf is consumed by the number of bytes written.
+-- With socket:zerocopy(true), big writes don't copy the data to the
+-- kernel, and the call returns when the kernel doesn't need the
+-- memory anymore. If it fails, the memory may be still in use, so
+-- the ibuf must not be reused.
+local function socket_send_from(self, ibuf, size, timeout)
+    local fd = check_socket(self)
+    check_ibuf(ibuf, 'Usage: socket:send_from(ibuf[, size[, timeout]])')
+    size = math.min(size or ibuf:size(), ibuf:size())
+    if size <= 0 then
+        return 0
+    end
+    timeout = timeout or TIMEOUT_INFINITY
+
+    local zerocopy = self._zerocopy
+    local sent = 0
+    local deadline = fiber.clock() + timeout
+    repeat
+        self._errno = nil
+        local len = size - sent
+        local res
+        if zerocopy and len >= ZEROCOPY_THRESHOLD then
+            res = ffi.C.send(fd, ibuf.rpos, len, MSG_ZEROCOPY)
+            if res >= 0 then
+                self._zerocopy_sent = self._zerocopy_sent + 1
+            end
+        else
+            res = ffi.C.write(fd, ibuf.rpos, len)
+        end
+        if res >= 0 then
+            res = tonumber(res)
+            ibuf.rpos = ibuf.rpos + res
+            sent = sent + res
+            if sent == size then
+                break
+            end
+        else
+            self._errno = boxerrno()
+            if zerocopy and self._errno == boxerrno.ENOBUFS then
+                -- Out of the limit of pinned memory, copy the rest.
+                zerocopy = false
+            elseif not errno_is_transient[self._errno] then
+                break
+            end
+        end
+    until not socket_writable(self, deadline - fiber.clock())
+
+    if self._zerocopy_sent ~= nil and
+       self._zerocopy_done < self._zerocopy_sent then
+        local errno = self._errno
+        if not zerocopy_wait(self, deadline) then
+            return nil
+        end
+        self._errno = errno
+    end
+    if sent < size then
+        return nil
+    end
+    return sent
+end
+
 local function socket_send(self, octets, flags)
     local fd = check_socket(self)
     local iflags = get_iflags(internal.SEND_FLAGS, flags)
@@ -1260,6 +1561,11 @@ socket_mt   = {
         write = socket_write;
         send = socket_send;
         recv = socket_recv;
+        recv_into = socket_recv_into;
+        send_from = socket_send_from;
+        readv = socket_readv;
+        writev = socket_writev;
+        zerocopy = socket_zerocopy;
         recvfrom = socket_recvfrom;
         sendto = socket_sendto;
         name = socket_name;
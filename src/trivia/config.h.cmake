@@ -89,6 +89,14 @@
  * Defined if fdatasync(2) call is present.
  */
 #cmakedefine HAVE_FDATASYNC 1
+/*
+ * Defined if the Linux io_uring interface is available.
+ */
+#cmakedefine HAVE_IO_URING 1
+/*
+ * Defined if USDT probes are enabled, see lib/core/probe.h.
+ */
+#cmakedefine ENABLE_USDT 1
 
 #ifndef HAVE_FDATASYNC
 #if defined(__APPLE__)
@@ -195,6 +203,8 @@
 #cmakedefine HAVE_PTHREAD_SET_NAME_NP 1
 
 #cmakedefine HAVE_PTHREAD_GETATTR_NP 1
+/** pthread_setaffinity_np(pthread_self(), size, cpu_set) - Linux */
+#cmakedefine HAVE_PTHREAD_SETAFFINITY_NP 1
 #cmakedefine HAVE_PTHREAD_ATTR_GET_NP 1
 
 #cmakedefine HAVE_PTHREAD_GET_STACKSIZE_NP 1
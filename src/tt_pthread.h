@@ -37,6 +37,9 @@
 #include <stdio.h>
 #include <errno.h>
 #include <pthread.h>
+#if HAVE_PTHREAD_SETAFFINITY_NP
+#include <sched.h>
+#endif
 #if HAVE_PTHREAD_NP_H || (__OpenBSD__)
 #include <pthread_np.h>
 #endif
@@ -330,6 +333,26 @@ tt_pthread_setname(const char *name)
 #endif
 }
 
+/**
+ * Pin the current thread to the given CPU.
+ * Returns 0 on success, an error code otherwise.
+ */
+static inline int
+tt_pthread_setaffinity(int cpu)
+{
+#if HAVE_PTHREAD_SETAFFINITY_NP
+	if (cpu >= CPU_SETSIZE)
+		return EINVAL;
+	cpu_set_t set;
+	CPU_ZERO(&set);
+	CPU_SET(cpu, &set);
+	return pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+#else
+	(void)cpu;
+	return ENOTSUP;
+#endif
+}
+
 static inline void
 tt_pthread_attr_getstack(pthread_t thread, void **stackaddr, size_t *stacksize)
 {
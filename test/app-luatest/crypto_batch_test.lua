@@ -0,0 +1,80 @@
+local crypto = require('crypto')
+local digest = require('digest')
+local fiber = require('fiber')
+local t = require('luatest')
+local g = t.group()
+
+local function make_list(count, size)
+    local list = {}
+    for i = 1, count do
+        list[i] = string.rep(string.char(string.byte('a') + i % 26), size)
+    end
+    return list
+end
+
+-- Small batches are processed in the calling fiber, big ones in the
+-- thread pool: check both.
+local cases = {
+    small = make_list(10, 100),
+    big = make_list(10, 100 * 1024),
+    empty = {},
+}
+
+for name, list in pairs(cases) do
+    g['test_digest_' .. name] = function()
+        local res = crypto.digest.sha256.batch(list)
+        t.assert_equals(#res, #list)
+        for i, str in ipairs(list) do
+            t.assert_equals(res[i], digest.sha256(str))
+        end
+        res = crypto.digest.md5.batch(list)
+        for i, str in ipairs(list) do
+            t.assert_equals(res[i], digest.md5(str))
+        end
+    end
+
+    g['test_hmac_' .. name] = function()
+        local key = 'secret'
+        local res = crypto.hmac.sha1.batch(key, list)
+        t.assert_equals(#res, #list)
+        for i, str in ipairs(list) do
+            t.assert_equals(res[i], crypto.hmac.sha1(key, str))
+        end
+    end
+
+    g['test_cipher_' .. name] = function()
+        local key = '12345678876543211234567887654321'
+        local iv = 'abcdefghijklmnop'
+        local cbc = crypto.cipher.aes256.cbc
+        local enc = cbc.encrypt.batch(list, key, iv)
+        t.assert_equals(#enc, #list)
+        for i, str in ipairs(list) do
+            t.assert_equals(enc[i], cbc.encrypt(str, key, iv))
+        end
+        t.assert_equals(cbc.decrypt.batch(enc, key, iv), list)
+    end
+end
+
+g.test_yield = function()
+    local list = make_list(10, 100 * 1024)
+    local yielded = false
+    local f = fiber.new(function() yielded = true end)
+    f:set_joinable(true)
+    crypto.digest.sha512.batch(list)
+    t.assert(yielded)
+    f:join()
+end
+
+g.test_errors = function()
+    t.assert_error_msg_contains('Usage: digest.sha256.batch(table)',
+                                crypto.digest.sha256.batch, 'abc')
+    t.assert_error_msg_contains('batch item 2 must be a string',
+                                crypto.digest.sha256.batch, {'a', 1})
+    t.assert_error_msg_contains('Key should be specified',
+                                crypto.hmac.sha256.batch, nil, {'a'})
+    t.assert_error_msg_contains('Key and IV should be specified',
+                                crypto.cipher.aes128.cbc.encrypt.batch, {'a'})
+    t.assert_error_msg_contains('OpenSSL error',
+                                crypto.cipher.aes128.cbc.decrypt.batch,
+                                {'abc'}, '1234567887654321', '1234567887654321')
+end
@@ -0,0 +1,23 @@
+local fiber = require('fiber')
+local t = require('luatest')
+local g = t.group()
+
+g.test_stack_stat = function()
+    local stat = fiber.stack_stat()
+    t.assert_ge(stat.fibers, stat.cached)
+    t.assert_ge(stat.total, 0)
+    local count = 1000
+    local cond = fiber.cond()
+    for _ = 1, count do
+        fiber.create(function() cond:wait() end)
+    end
+    local peak = fiber.stack_stat()
+    t.assert_ge(peak.fibers, count)
+    t.assert_gt(peak.total, stat.total)
+    cond:broadcast()
+    fiber.yield()
+    -- Dead fibers left after the burst release their stacks.
+    local after = fiber.stack_stat()
+    t.assert_lt(after.cached, count / 2)
+    t.assert_lt(after.total, peak.total / 2)
+end
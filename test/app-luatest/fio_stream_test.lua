@@ -0,0 +1,77 @@
+local fio = require('fio')
+local t = require('luatest')
+local g = t.group()
+
+g.before_each(function(cg)
+    cg.dir = fio.tempdir()
+    cg.path = fio.pathjoin(cg.dir, 'data.csv')
+end)
+
+g.after_each(function(cg)
+    fio.rmtree(cg.dir)
+end)
+
+local function make_lines(count)
+    local lines = {}
+    for i = 1, count do
+        lines[i] = string.format('%d,%s', i, string.rep('x', i % 50))
+    end
+    return lines
+end
+
+g.test_write_read_lines = function(cg)
+    local lines = make_lines(10000)
+    local fh = fio.open(cg.path, {'O_WRONLY', 'O_CREAT'}, tonumber('644', 8))
+    -- Small buffers to go through several background writes.
+    local s = fh:stream({write_behind = 1000})
+    for _, line in ipairs(lines) do
+        t.assert(s:write(line .. '\n'))
+    end
+    t.assert(s:close())
+
+    fh = fio.open(cg.path, {'O_RDONLY'})
+    s = fh:stream({readahead = 1000})
+    local res = {}
+    for line in s:lines() do
+        table.insert(res, line)
+    end
+    t.assert_equals(res, lines)
+    t.assert_equals(s:read(), '')
+    t.assert(s:close())
+end
+
+g.test_read = function(cg)
+    local fh = fio.open(cg.path, {'O_RDWR', 'O_CREAT'}, tonumber('644', 8))
+    fh:write('abc\ndef\nlast line without eol')
+    fh:seek(0)
+    local s = fh:stream({readahead = 3, close = false})
+    t.assert_equals(s:read(2), 'ab')
+    t.assert_equals(s:read_line(), 'c')
+    t.assert_equals(s:read(6), 'def\nla')
+    t.assert_equals(s:read_line(), 'st line without eol')
+    t.assert_equals(s:read_line(), nil)
+    t.assert(s:close())
+    -- The handle is still open.
+    t.assert_equals(fh:seek(0), 0)
+    t.assert(fh:close())
+end
+
+g.test_errors = function(cg)
+    local fh = fio.open(cg.path, {'O_RDWR', 'O_CREAT'}, tonumber('644', 8))
+    local s = fh:stream()
+    s:write('abc')
+    t.assert_error_msg_contains('fio stream is open for writing',
+                                s.read, s)
+    t.assert(s:close())
+    t.assert_error_msg_contains('fio stream is closed', s.write, s, 'x')
+    t.assert_error_msg_contains('readahead must be a positive number',
+                                fh.stream, fh, {readahead = 0})
+    t.assert_equals(fio.open(cg.path):read(), 'abc')
+
+    fh = fio.open(cg.path, {'O_WRONLY'})
+    s = fh:stream({close = false})
+    local line, err = s:read_line()
+    t.assert_equals(line, nil)
+    t.assert_not_equals(err, nil)
+    fh:close()
+end
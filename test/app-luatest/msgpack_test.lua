@@ -418,3 +418,30 @@ g.test_object_misc = function()
     t.assert_not(msgpack.is_object(it))
     t.assert_not(msgpack.is_object({mp}))
 end
+
+g.test_encode_array_slots = function()
+    -- Numbers and strings of the array part are encoded without
+    -- going through the Lua stack, the result must be the same.
+    local arr = {1, -1, 1.5, 2^64, -2^63, 'abc', true, {2}, box.NULL}
+    local mp = msgpack.encode(arr)
+    t.assert_equals(mp, '\x99\x01\xff\xcb\x3f\xf8\x00\x00\x00\x00\x00\x00' ..
+                        '\xcb\x43\xf0\x00\x00\x00\x00\x00\x00' ..
+                        '\xd3\x80\x00\x00\x00\x00\x00\x00\x00' ..
+                        '\xa3abc\xc3\x91\x02\xc0')
+    t.assert_equals(msgpack.decode(mp), arr)
+
+    -- Elements stored in the hash part of a table.
+    local sparse = {}
+    sparse[3] = 'c'
+    sparse[2] = 2
+    sparse[1] = 1
+    t.assert_equals(msgpack.decode(msgpack.encode(sparse)), {1, 2, 'c'})
+
+    local serializer = msgpack.new()
+    serializer.cfg({encode_invalid_numbers = false})
+    t.assert_error_msg_content_equals(
+        "number must not be NaN or Inf",
+        function() serializer.encode({1, 0 / 0}) end)
+    serializer.cfg({encode_invalid_as_nil = true})
+    t.assert_equals(serializer.encode({1, 0 / 0}), '\x92\x01\xc0')
+end
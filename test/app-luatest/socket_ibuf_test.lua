@@ -0,0 +1,104 @@
+local buffer = require('buffer')
+local ffi = require('ffi')
+local socket = require('socket')
+local t = require('luatest')
+local g = t.group()
+
+g.before_all(function(cg)
+    -- Echo server built on ibuf I/O.
+    cg.server = socket.tcp_server('127.0.0.1', 0, function(s)
+        local buf = buffer.ibuf()
+        while true do
+            local n = s:recv_into(buf, 4096)
+            if n == nil or n == 0 then
+                break
+            end
+            if s:send_from(buf) == nil then
+                break
+            end
+        end
+    end)
+    cg.port = cg.server:name().port
+end)
+
+g.after_all(function(cg)
+    cg.server:close()
+end)
+
+g.before_each(function(cg)
+    cg.client = socket.tcp_connect('127.0.0.1', cg.port)
+    t.assert(cg.client)
+end)
+
+g.after_each(function(cg)
+    cg.client:close()
+end)
+
+g.test_writev_readv = function(cg)
+    local s = cg.client
+    local out = buffer.ibuf()
+    ffi.copy(out:alloc(5), 'world', 5)
+    t.assert_equals(s:writev({'hello, ', out, '!', ''}), 13)
+    t.assert_equals(out:size(), 0)
+
+    local head = buffer.ibuf()
+    local body = buffer.ibuf()
+    local n = 0
+    while n < 13 do
+        local res = s:readv({{head, 7 - head:size()},
+                             {body, 6 - body:size()}}, 1)
+        t.assert(res ~= nil and res > 0)
+        n = n + res
+    end
+    t.assert_equals(ffi.string(head.rpos, head:size()), 'hello, ')
+    t.assert_equals(ffi.string(body.rpos, body:size()), 'world!')
+end
+
+g.test_recv_into_after_read = function(cg)
+    local s = cg.client
+    t.assert_equals(s:write('abcdef'), 6)
+    t.assert_equals(s:read(2), 'ab')
+    -- The rest may be buffered by read() already.
+    local buf = buffer.ibuf()
+    while buf:size() < 4 do
+        t.assert(s:recv_into(buf, 4 - buf:size(), 1) > 0)
+    end
+    t.assert_equals(ffi.string(buf.rpos, buf:size()), 'cdef')
+end
+
+g.test_send_from = function(cg)
+    local s = cg.client
+    -- Zero-copy may be unsupported, the result must be the same.
+    s:zerocopy(true)
+    local size = 1024 * 1024
+    local data = string.rep('0123456789abcdef', size / 16)
+    local buf = buffer.ibuf()
+    ffi.copy(buf:alloc(size), data, size)
+    -- Partial send of the first 10 bytes.
+    t.assert_equals(s:send_from(buf, 10), 10)
+    t.assert_equals(buf:size(), size - 10)
+    -- The reader runs concurrently, so that the echo doesn't block.
+    local fiber = require('fiber')
+    local ch = fiber.channel(1)
+    fiber.create(function()
+        ch:put(s:read(size, 10))
+    end)
+    t.assert_equals(s:send_from(buf, nil, 10), size - 10)
+    t.assert_equals(buf:size(), 0)
+    t.assert_equals(ch:get(10), data)
+    s:zerocopy(false)
+end
+
+g.test_usage = function(cg)
+    local s = cg.client
+    t.assert_error_msg_contains('Usage: socket:recv_into(ibuf',
+                                s.recv_into, s, 'str')
+    t.assert_error_msg_contains('Usage: socket:send_from(ibuf',
+                                s.send_from, s, {})
+    t.assert_error_msg_contains('Usage: socket:readv',
+                                s.readv, s, {buffer.ibuf()})
+    t.assert_error_msg_contains('Usage: socket:writev',
+                                s.writev, s, {1})
+    t.assert_equals(s:send_from(buffer.ibuf()), 0)
+    t.assert_equals(s:writev({}), 0)
+end
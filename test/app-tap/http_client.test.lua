@@ -572,8 +572,44 @@ local function test_concurrent(test, url, opts)
     test:ok(ok_active, "no active requests")
 end
 
+local function test_request_many(test, url, opts)
+    test:plan(9)
+    local http = client.new({max_host_connections = 2})
+    local requests = {}
+    for i = 1, 10 do
+        requests[i] = {'GET', url, nil, opts}
+    end
+    table.insert(requests, {'POST', url, 'body', opts})
+    local resps, errs = http:request_many(requests)
+    local ok = true
+    for i = 1, #requests do
+        if resps[i] == nil or resps[i].status ~= 200 then
+            ok = false
+        end
+    end
+    test:ok(ok, "all requests are ok")
+    test:is(next(errs), nil, "no errors")
+    test:is(resps[11].body, 'body', "post body")
+    test:is(resps[1].body, 'hello world', "get body")
+
+    local st = http:stat()
+    test:is(st.total_requests, 11, "total requests")
+    local host, host_st = next(st.hosts)
+    test:ok(host ~= nil and next(st.hosts, host) == nil, "one host")
+    test:is(host_st.total_requests, 11, "host requests")
+    test:is(host_st.new_connections + host_st.reused_connections, 11,
+            "host connections")
+
+    -- The whole batch times out at once.
+    resps, errs = http:request_many({
+        {'GET', url .. 'long_query', nil, opts},
+        {'GET', url, nil, opts},
+    }, {timeout = 0.0001})
+    test:is(resps[1] ~= nil and resps[1].status, 408, "batch timeout")
+end
+
 local function run_tests(test, sock_family, sock_addr)
-    test:plan(11)
+    test:plan(12)
     local server, url, opts = start_server(test, sock_family, sock_addr)
     test:test("http.client", test_http_client, url, opts)
     test:test("http.client headers redefine", test_http_client_headers_redefine,
@@ -584,6 +620,7 @@ local function run_tests(test, sock_family, sock_addr)
     test:test("request_headers", test_request_headers, url, opts)
     test:test("headers", test_headers, url, opts)
     test:test("special methods", test_special_methods, url, opts)
+    test:test("request_many", test_request_many, url, opts)
     if sock_family == 'AF_UNIX' and jit.os ~= "Linux" then
         --
         -- BSD-based operating systems (including OS X) will fail
@@ -21,7 +21,7 @@ end
 
 tap.test("json", function(test)
     local serializer = require('json')
-    test:plan(58)
+    test:plan(60)
 
     test:test("unsigned", common.test_unsigned, serializer)
     test:test("signed", common.test_signed, serializer)
@@ -213,4 +213,28 @@ tap.test("json", function(test)
     local bigjson = serializer.encode(t)
     local t_dec = serializer.decode(bigjson)
     test:is_deeply(t_dec, t, 'encode/decode big strings')
+
+    --
+    -- Strings are escaped and unescaped in blocks of 16 bytes, check
+    -- special characters at every position of a block and in the tail.
+    --
+    local strs = {}
+    for i = 1, 40 do
+        for _, c in ipairs({'"', '\\', '/', '\n', '\1', '\127', '\255'}) do
+            table.insert(strs, string.rep('x', i - 1) .. c ..
+                               string.rep('y', 40 - i))
+        end
+    end
+    local ok = true
+    for _, s in ipairs(strs) do
+        local enc = serializer.encode(s)
+        if serializer.decode(enc) ~= s or
+           serializer.decode(serializer.encode({s}))[1] ~= s then
+            ok = false
+        end
+    end
+    test:ok(ok, 'encode/decode special characters at any position')
+    test:is(serializer.encode(string.rep('a', 17) .. '"' .. string.rep('b', 17)),
+            '"' .. string.rep('a', 17) .. '\\"' .. string.rep('b', 17) .. '"',
+            'escape a quote after a block')
 end)
@@ -0,0 +1,66 @@
+local server = require('test.luatest_helpers.server')
+local t = require('luatest')
+local g = t.group()
+
+g.before_all(function(cg)
+    cg.server = server:new({
+        alias = 'master',
+        box_cfg = {checkpoint_count = 5},
+    })
+    cg.server:start()
+end)
+
+g.after_all(function(cg)
+    cg.server:drop()
+end)
+
+g.after_each(function(cg)
+    cg.server:exec(function()
+        box.backup.stop()
+    end)
+end)
+
+g.test_incremental_backup = function(cg)
+    cg.server:exec(function()
+        local fio = require('fio')
+        local s = box.schema.space.create('test')
+        s:create_index('pk')
+        box.snapshot()
+        local base = box.info.gc().checkpoints[#box.info.gc().checkpoints]
+        s:insert({1})
+        box.snapshot()
+        s:insert({2})
+        box.snapshot()
+
+        local files = box.backup.start(0, {base = base.signature})
+        t.assert_not_equals(#files, 0)
+        for _, f in ipairs(files) do
+            t.assert_str_matches(fio.basename(f), '%d+%.xlog')
+            t.assert(fio.path.exists(f))
+        end
+        -- The first file contains the base checkpoint.
+        local first = tonumber(fio.basename(files[1]):match('%d+'))
+        t.assert_le(first, base.signature)
+        box.backup.stop()
+
+        t.assert_error_msg_contains('base checkpoint must be older',
+                                    box.backup.start, 0,
+                                    {base = box.info.signature})
+        t.assert_error_msg_contains('invalid base checkpoint',
+                                    box.backup.start, 0, {base = -1})
+        s:drop()
+    end)
+end)
+
+g.test_incremental_backup_missing_wal = function(cg)
+    cg.server:exec(function()
+        box.cfg{checkpoint_count = 1}
+        box.space._schema:replace({'incremental_backup'})
+        box.snapshot()
+        box.space._schema:delete({'incremental_backup'})
+        box.snapshot()
+        t.assert_error_msg_contains('have been removed', box.backup.start,
+                                    0, {base = 0})
+        box.cfg{checkpoint_count = 5}
+    end)
+end)
@@ -0,0 +1,74 @@
+local server = require('test.luatest_helpers.server')
+local t = require('luatest')
+local g = t.group()
+
+g.before_all(function(cg)
+    cg.server = server:new({alias = 'master'})
+    cg.server:start()
+end)
+
+g.after_all(function(cg)
+    cg.server:drop()
+end)
+
+g.after_each(function(cg)
+    cg.server:exec(function()
+        if box.space.test ~= nil then
+            box.space.test:drop()
+        end
+    end)
+end)
+
+g.test_cached_paths = function(cg)
+    cg.server:exec(function()
+        local s = box.schema.space.create('test', {
+            format = {{'id', 'unsigned'}, {'data', 'map', is_nullable = true}},
+            cached_paths = {'data.user.id', '[2].tags[1]'},
+        })
+        s:create_index('pk')
+        local doc = {user = {id = 10, name = 'a'}, tags = {'x', 'y'}}
+        local tuple = s:insert({1, doc})
+        t.assert_equals(tuple['data.user.id'], 10)
+        t.assert_equals(tuple['[2].user.id'], 10)
+        t.assert_equals(tuple['data.tags[1]'], 'x')
+        t.assert_equals(tuple['data.user.name'], 'a')
+        t.assert_equals(s:insert({2, {user = {}}})['data.user.id'], nil)
+        t.assert_equals(s:insert({3})['data.user.id'], nil)
+        t.assert_error_msg_contains('expected map, got string',
+                                    s.insert, s, {4, {user = 'a'}})
+
+        -- Tuples are decoded anew when the option changes.
+        s:alter({cached_paths = {}})
+        t.assert_equals(s:get(1)['data.user.id'], 10)
+        s:replace({4, {user = 'a'}})
+        t.assert_equals(s:get(4)['data.user'], 'a')
+        t.assert_error_msg_contains('expected map, got string', s.alter, s,
+                                    {cached_paths = {'data.user.id'}})
+        s:delete(4)
+        s:alter({cached_paths = {'data.user.id'}})
+        t.assert_equals(s:get(1)['data.user.id'], 10)
+    end)
+end
+
+g.test_invalid = function(cg)
+    cg.server:exec(function()
+        local function create(paths)
+            return box.schema.space.create('test', {
+                format = {{'id', 'unsigned'}, {'data', 'any'}},
+                cached_paths = paths,
+            })
+        end
+        t.assert_error_msg_contains("'cached_paths' must be an array",
+                                    create, {1})
+        t.assert_error_msg_contains("invalid cached path 'data[*].a'",
+                                    create, {'data[*].a'})
+        t.assert_error_msg_contains("unknown field in cached path 'foo.a'",
+                                    create, {'foo.a'})
+        t.assert_error_msg_contains("cached path 'data' must point",
+                                    create, {'data'})
+        t.assert_error_msg_contains('engine does not support cached paths',
+                                    box.schema.space.create, 'test',
+                                    {engine = 'vinyl',
+                                     cached_paths = {'[2].a'}})
+    end)
+end
@@ -0,0 +1,57 @@
+local server = require('test.luatest_helpers.server')
+local t = require('luatest')
+local g = t.group()
+
+g.before_all(function(cg)
+    cg.server = server:new({
+        alias = 'master',
+        box_cfg = {
+            memtx_memory = 64 * 1024 * 1024,
+            snap_io_rate_limit = 1,
+        },
+    })
+    cg.server:start()
+end)
+
+g.after_all(function(cg)
+    cg.server:drop()
+end)
+
+g.test_delayed_free = function(cg)
+    cg.server:exec(function()
+        local digest = require('digest')
+        local fiber = require('fiber')
+        t.assert_equals(box.info.gc().delayed_free, 0)
+        local s = box.schema.space.create('test')
+        s:create_index('pk')
+        box.begin()
+        for i = 1, 30000 do
+            s:insert({i, digest.base64_encode(digest.urandom(768))})
+        end
+        box.commit()
+
+        local f = fiber.new(box.snapshot)
+        f:set_joinable(true)
+        t.helpers.retrying({}, function()
+            t.assert(box.info.gc().checkpoint_is_in_progress)
+        end)
+        -- Tuples deleted during the checkpoint can't be freed.
+        box.begin()
+        for i = 1, 30000 do
+            s:delete({i})
+        end
+        box.commit()
+        t.assert_gt(box.info.gc().delayed_free, 15 * 1024 * 1024)
+        t.assert_equals({f:join()}, {true, 'ok'})
+
+        -- The memory is freed on allocation once the checkpoint
+        -- completes.
+        for _ = 1, 1000 do
+            s:replace({1})
+        end
+        t.assert_equals(box.info.gc().delayed_free, 0)
+        s:drop()
+    end)
+    -- Throttling is stopped since too much memory is held.
+    t.assert(cg.server:grep_log('ignoring snap_io_rate_limit'))
+end
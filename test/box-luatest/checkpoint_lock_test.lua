@@ -0,0 +1,64 @@
+local server = require('test.luatest_helpers.server')
+local t = require('luatest')
+local g = t.group()
+
+g.before_all(function(cg)
+    cg.server = server:new({alias = 'master'})
+    cg.server:start()
+end)
+
+g.after_all(function(cg)
+    cg.server:drop()
+end)
+
+g.test_checkpoint_lock = function(cg)
+    cg.server:exec(function()
+        local ffi = require('ffi')
+        local fio = require('fio')
+        ffi.cdef('int flock(int fd, int operation);')
+        local LOCK_EX = 2
+
+        local path = fio.pathjoin(box.cfg.work_dir or fio.cwd(),
+                                  'checkpoint.lock')
+        box.cfg{checkpoint_lock = path}
+        t.assert(fio.path.exists(path))
+
+        -- Pretend another instance is making a checkpoint.
+        local fh = fio.open(path, {'O_RDWR'})
+        t.assert_equals(ffi.C.flock(fh.fh, LOCK_EX), 0)
+
+        local function last_checkpoint()
+            local checkpoints = box.info.gc().checkpoints
+            return checkpoints[#checkpoints].signature
+        end
+
+        local s = box.schema.space.create('test')
+        s:create_index('pk')
+        s:insert({1})
+        local signature = last_checkpoint()
+        box.cfg{checkpoint_interval = 0.1}
+        require('fiber').sleep(0.5)
+        t.assert_equals(last_checkpoint(), signature)
+
+        -- The scheduled checkpoint proceeds once the lock is released.
+        fh:close()
+        t.helpers.retrying({}, function()
+            t.assert_gt(last_checkpoint(), signature)
+        end)
+        box.cfg{checkpoint_interval = 3600, checkpoint_lock = box.NULL}
+    end)
+    t.assert(cg.server:grep_log('waiting for another instance ' ..
+                                'to complete checkpoint'))
+end
+
+g.test_checkpoint_write_duration = function(cg)
+    cg.server:exec(function()
+        t.assert_error_msg_contains(
+            "Incorrect value for option 'checkpoint_write_duration'",
+            box.cfg, {checkpoint_write_duration = -1})
+        box.cfg{checkpoint_write_duration = 10}
+        box.space.test:insert({2})
+        box.snapshot()
+        box.cfg{checkpoint_write_duration = 0}
+    end)
+end
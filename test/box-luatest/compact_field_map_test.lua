@@ -0,0 +1,54 @@
+local server = require('test.luatest_helpers.server')
+local t = require('luatest')
+local g = t.group('compact_field_map', {{engine = 'memtx'},
+                                        {engine = 'vinyl'}})
+
+g.before_each(function(cg)
+    cg.server = server:new({alias = 'master'})
+    cg.server:start()
+end)
+
+g.after_each(function(cg)
+    cg.server:drop()
+end)
+
+-- Field map slots are 1, 2 or 4 bytes wide depending on the offsets
+-- of indexed fields. Check that indexed fields are found correctly
+-- for every slot size.
+g.test_slot_size = function(cg)
+    cg.server:exec(function(engine)
+        local s = box.schema.space.create('test', {engine = engine})
+        s:create_index('pk')
+        s:create_index('sk1', {parts = {{3, 'unsigned'}}})
+        s:create_index('sk2', {parts = {{5, 'string'}}})
+        box.snapshot()
+        for i, len in ipairs({1, 200, 1000, 70000}) do
+            local pad = string.rep('x', len)
+            s:insert({i, pad, i * 10, pad, 'k' .. i})
+        end
+        for i, len in ipairs({1, 200, 1000, 70000}) do
+            local tuple = s.index.sk1:get(i * 10)
+            t.assert_equals(tuple[1], i)
+            t.assert_equals(#tuple[4], len)
+            t.assert_equals(s.index.sk2:get('k' .. i)[3], i * 10)
+            t.assert_equals(tuple[5], 'k' .. i)
+        end
+    end, {cg.params.engine})
+end
+
+-- Multikey indexes need full-size slots.
+g.test_multikey = function(cg)
+    cg.server:exec(function(engine)
+        local s = box.schema.space.create('test', {engine = engine})
+        s:create_index('pk')
+        s:create_index('mk', {parts = {{2, 'unsigned', path = '[*]'}},
+                              unique = false})
+        s:create_index('sk', {parts = {{3, 'unsigned'}}})
+        s:insert({1, {10, 20, 30}, 100})
+        s:insert({2, {20, 40}, 200})
+        t.assert_equals(s.index.mk:select(20), {{1, {10, 20, 30}, 100},
+                                                {2, {20, 40}, 200}})
+        t.assert_equals(s.index.mk:select(40), {{2, {20, 40}, 200}})
+        t.assert_equals(s.index.sk:get(200), {2, {20, 40}, 200})
+    end, {cg.params.engine})
+end
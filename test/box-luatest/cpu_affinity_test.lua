@@ -0,0 +1,44 @@
+local server = require('test.luatest_helpers.server')
+local t = require('luatest')
+local g = t.group()
+
+g.before_all(function(cg)
+    cg.server = server:new({
+        alias = 'master',
+        box_cfg = {
+            iproto_threads = 2,
+            iproto_cpu_affinity = {0, 0},
+            tx_cpu_affinity = 0,
+            wal_cpu_affinity = 0,
+        },
+    })
+    cg.server:start()
+end)
+
+g.after_all(function(cg)
+    cg.server:drop()
+end)
+
+g.test_info = function(cg)
+    cg.server:exec(function()
+        local info = box.info.affinity
+        t.assert_equals(info.tx.cpu, 0)
+        t.assert_equals(info.wal.cpu, 0)
+        t.assert_equals(#info.iproto, 2)
+        for _, thread in ipairs({info.tx, info.wal, unpack(info.iproto)}) do
+            t.assert_equals(thread.cpu, 0)
+            t.assert_equals(thread.numa_node, info.tx.numa_node)
+        end
+    end)
+end
+
+g.test_cfg = function(cg)
+    cg.server:exec(function()
+        t.assert_error_msg_content_equals(
+            "Can't set option 'tx_cpu_affinity' dynamically",
+            box.cfg, {tx_cpu_affinity = 1})
+        t.assert_error_msg_content_equals(
+            "Can't set option 'wal_cpu_affinity' dynamically",
+            box.cfg, {wal_cpu_affinity = 1})
+    end)
+end
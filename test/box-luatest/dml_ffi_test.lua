@@ -0,0 +1,107 @@
+local server = require('test.luatest_helpers.server')
+local t = require('luatest')
+local g = t.group()
+
+g.before_all(function(cg)
+    cg.server = server:new({alias = 'master'})
+    cg.server:start()
+    cg.server:exec(function()
+        local s = box.schema.space.create('test')
+        s:create_index('pk')
+        s:create_index('sk', {parts = {2, 'unsigned'}})
+    end)
+end)
+
+g.after_all(function(cg)
+    cg.server:drop()
+end)
+
+g.after_each(function(cg)
+    cg.server:exec(function()
+        box.space.test:truncate()
+    end)
+end)
+
+g.test_dml_in_txn = function(cg)
+    cg.server:exec(function()
+        local s = box.space.test
+        box.begin()
+        t.assert_equals(s:insert({1, 10}), {1, 10})
+        t.assert_equals(s:insert(box.tuple.new({2, 20})), {2, 20})
+        t.assert_equals(s:replace({1, 11, 'a'}), {1, 11, 'a'})
+        t.assert_equals(s:update(1, {{'+', 2, 1}}), {1, 12, 'a'})
+        t.assert_equals(s.index.sk:update(20, {{'=', 3, 'b'}}), {2, 20, 'b'})
+        t.assert_equals(s:update(3, {{'+', 2, 1}}), nil)
+        t.assert_equals(s:upsert({3, 30}, {{'+', 2, 1}}), nil)
+        t.assert_equals(s:upsert({3, 30}, {{'+', 2, 1}}), nil)
+        t.assert_equals(s:delete(2), {2, 20, 'b'})
+        t.assert_equals(s.index.sk:delete(31), {3, 31})
+        t.assert_equals(s:delete(4), nil)
+        box.commit()
+        t.assert_equals(s:select(), {{1, 12, 'a'}})
+    end)
+end
+
+g.test_dml_error_in_txn = function(cg)
+    cg.server:exec(function()
+        local s = box.space.test
+        box.begin()
+        s:insert({1, 10})
+        t.assert_error_msg_contains('Duplicate key exists',
+                                    s.insert, s, {1, 10})
+        t.assert_error_msg_contains('Tuple field 2 required',
+                                    s.replace, s, {2})
+        t.assert_error_msg_contains("Usage index:update(key, ops)",
+                                    s.update, s, 1, 'ops')
+        t.assert_error_msg_contains('Unknown UPDATE operation',
+                                    s.update, s, 1, {{'x', 2, 1}})
+        t.assert_error_msg_contains('Tuple/Key must be MsgPack array',
+                                    s.insert, s, 5)
+        -- The transaction is alive after the errors.
+        t.assert(box.is_in_txn())
+        box.commit()
+        t.assert_equals(s:select(), {{1, 10}})
+    end)
+end
+
+g.test_dml_triggers = function(cg)
+    cg.server:exec(function()
+        local s = box.space.test
+        local log = {}
+        local function trig(old, new)
+            table.insert(log, {old, new})
+        end
+        s:on_replace(trig)
+        s:before_replace(function(_, new)
+            if new ~= nil and new[3] == 'skip' then
+                return new:update({{'=', 3, 'done'}})
+            end
+        end)
+        box.atomic(function()
+            s:insert({1, 10, 'skip'})
+            s:delete(1)
+        end)
+        s:before_replace(nil, s:before_replace()[1])
+        s:on_replace(nil, trig)
+        t.assert_equals(log, {{nil, {1, 10, 'done'}}, {{1, 10, 'done'}}})
+    end)
+end
+
+g.test_dml_func_index = function(cg)
+    cg.server:exec(function()
+        box.schema.func.create('second', {
+            body = 'function(tuple) return {tuple[2] * 2} end',
+            is_deterministic = true, is_sandboxed = true,
+        })
+        local s = box.schema.space.create('test_func')
+        s:create_index('pk')
+        s:create_index('func', {func = 'second', parts = {{1, 'unsigned'}}})
+        box.atomic(function()
+            s:insert({1, 5})
+            s:replace({2, 6})
+        end)
+        t.assert_equals(s.index.func:get(12), {2, 6})
+        s:drop()
+        box.schema.func.drop('second')
+    end)
+end
@@ -0,0 +1,85 @@
+local net = require('net.box')
+local server = require('test.luatest_helpers.server')
+local t = require('luatest')
+local g = t.group()
+
+g.before_all(function(cg)
+    cg.server = server:new({alias = 'master'})
+    cg.server:start()
+    cg.server:exec(function()
+        local s = box.schema.space.create('test')
+        s:create_index('pk')
+        s:insert({1, 'a'})
+        rawset(_G, 'call_count', 0)
+        rawset(_G, 'get', function(key)
+            rawset(_G, 'call_count', _G.call_count + 1)
+            return box.space.test:get(key)
+        end)
+        box.schema.func.create('get', {is_deterministic = true, cache = true})
+        box.schema.func.create('get_nocache', {is_deterministic = true})
+        rawset(_G, 'get_nocache', _G.get)
+        box.schema.user.grant('guest', 'execute', 'function', 'get')
+        box.schema.user.grant('guest', 'execute', 'function', 'get_nocache')
+        box.schema.user.create('noexec', {password = 'secret'})
+    end)
+    cg.conn = net.connect(cg.server.net_box_uri)
+end)
+
+g.after_all(function(cg)
+    cg.conn:close()
+    cg.server:drop()
+end)
+
+local function call_count(cg)
+    return cg.server:exec(function() return _G.call_count end)
+end
+
+g.test_cache = function(cg)
+    local c = cg.conn
+    -- Drop the results cached by other tests.
+    cg.server:exec(function() box.space.test:replace({1, 'a'}) end)
+    local count = call_count(cg)
+    t.assert_equals(c:call('get', {1}), {1, 'a'})
+    t.assert_equals(c:call('get', {1}), {1, 'a'})
+    t.assert_equals(call_count(cg), count + 1)
+    -- Different arguments are cached separately.
+    t.assert_equals(c:call('get', {2}), nil)
+    t.assert_equals(c:call('get', {2}), nil)
+    t.assert_equals(call_count(cg), count + 2)
+    -- Any data change invalidates the cache.
+    cg.server:exec(function() box.space.test:replace({2, 'b'}) end)
+    t.assert_equals(c:call('get', {2}), {2, 'b'})
+    t.assert_equals(c:call('get', {1}), {1, 'a'})
+    t.assert_equals(call_count(cg), count + 4)
+    -- Functions without the option are always called.
+    t.assert_equals(c:call('get_nocache', {1}), {1, 'a'})
+    t.assert_equals(c:call('get_nocache', {1}), {1, 'a'})
+    t.assert_equals(call_count(cg), count + 6)
+    -- Local calls are not cached.
+    cg.server:exec(function()
+        box.func.get:call({1})
+        box.func.get:call({1})
+    end)
+    t.assert_equals(call_count(cg), count + 8)
+end
+
+g.test_cache_access = function(cg)
+    t.assert_equals(cg.conn:call('get', {1}), {1, 'a'})
+    -- A cached result is not returned to a user without access.
+    local c = net.connect(cg.server.net_box_uri,
+                          {user = 'noexec', password = 'secret'})
+    t.assert_error_msg_contains("Execute access to function 'get' is denied",
+                                c.call, c, 'get', {1})
+    c:close()
+end
+
+g.test_cache_opts = function(cg)
+    cg.server:exec(function()
+        t.assert_error_msg_contains(
+            "cache option may be set only for a deterministic function",
+            box.schema.func.create, 'test', {cache = true})
+        t.assert_error_msg_contains(
+            "options parameter 'cache' should be of type boolean",
+            box.schema.func.create, 'test', {cache = 1})
+    end)
+end
@@ -0,0 +1,81 @@
+local server = require('test.luatest_helpers.server')
+local t = require('luatest')
+local g = t.group()
+
+g.before_all(function(cg)
+    cg.server = server:new({alias = 'master'})
+    cg.server:start()
+    cg.server:exec(function()
+        local s = box.schema.space.create('test')
+        s:create_index('pk')
+        s:insert({1, 'a b a'})
+        s:insert({2, 'b c'})
+        box.schema.func.create('words', {
+            body = [[function(tuple)
+                local res = {}
+                for w in string.gmatch(tuple[2], '%S+') do
+                    table.insert(res, {w})
+                end
+                return res
+            end]],
+            is_deterministic = true,
+            is_sandboxed = true,
+            opts = {is_multikey = true},
+        })
+        s:create_index('words', {func = 'words', unique = false,
+                                 parts = {{1, 'string'}}})
+    end)
+end)
+
+g.after_all(function(cg)
+    cg.server:drop()
+end)
+
+-- The keys of a tuple are computed once and deleted from the index
+-- by the tuple, without calling the function again. Check that
+-- replace, delete, rollback and index rebuild keep the index right.
+g.test_keys = function(cg)
+    cg.server:exec(function()
+        local s = box.space.test
+        local function ids(word)
+            local res = {}
+            for _, tuple in s.index.words:pairs({word}) do
+                table.insert(res, tuple[1])
+            end
+            return res
+        end
+        t.assert_equals(s.index.words:len(), 4)
+        t.assert_equals(ids('a'), {1})
+        t.assert_equals(ids('b'), {1, 2})
+
+        s:replace({1, 'c d'})
+        t.assert_equals(ids('a'), {})
+        t.assert_equals(ids('b'), {2})
+        t.assert_equals(ids('c'), {1, 2})
+        t.assert_equals(s.index.words:len(), 4)
+
+        box.begin()
+        s:replace({2, 'e'})
+        s:delete({1})
+        t.assert_equals(ids('c'), {})
+        box.rollback()
+        t.assert_equals(ids('c'), {1, 2})
+        t.assert_equals(ids('e'), {})
+
+        s:delete({2})
+        t.assert_equals(ids('b'), {})
+        t.assert_equals(ids('c'), {1})
+        t.assert_equals(s.index.words:len(), 2)
+        t.assert_gt(s.index.words:bsize(), 0)
+
+        s:insert({3, 'x x y'})
+        s.index.words:drop()
+        s:create_index('words', {func = 'words', unique = false,
+                                 parts = {{1, 'string'}}})
+        t.assert_equals(ids('x'), {3})
+        t.assert_equals(ids('d'), {1})
+        s:delete({3})
+        t.assert_equals(ids('x'), {})
+        t.assert_equals(s.index.words:len(), 2)
+    end)
+end
@@ -0,0 +1,63 @@
+local server = require('test.luatest_helpers.server')
+local t = require('luatest')
+local g = t.group()
+
+g.before_all(function(cg)
+    cg.server = server:new({alias = 'master'})
+    cg.server:start()
+    cg.server:exec(function()
+        local s = box.schema.space.create('test')
+        s:create_index('pk')
+        s:create_index('sk', {parts = {2, 'string'}})
+    end)
+end)
+
+g.after_all(function(cg)
+    cg.server:drop()
+end)
+
+g.after_each(function(cg)
+    cg.server:exec(function()
+        box.space.test:truncate()
+    end)
+end)
+
+g.test_insert_batch = function(cg)
+    cg.server:exec(function()
+        local s = box.space.test
+        t.assert_equals(s:insert_batch({}), nil)
+        t.assert_equals(s:count(), 0)
+        s:insert_batch({{3, 'c'}, {1, 'a'}, box.tuple.new({2, 'b'})})
+        t.assert_equals(s:select(), {{1, 'a'}, {2, 'b'}, {3, 'c'}})
+        t.assert_equals(s.index.sk:select(), {{1, 'a'}, {2, 'b'}, {3, 'c'}})
+    end)
+end
+
+g.test_insert_batch_error = function(cg)
+    cg.server:exec(function()
+        local s = box.space.test
+        s:insert({1, 'a'})
+        t.assert_error_msg_contains('Duplicate key exists',
+                                    s.insert_batch, s, {{2, 'b'}, {1, 'c'}})
+        t.assert_error_msg_contains('Tuple/Key must be MsgPack array',
+                                    s.insert_batch, s, {{2, 'b'}, 3})
+        t.assert_error_msg_contains('Usage space:insert_batch(tuples)',
+                                    s.insert_batch, s, 1)
+        t.assert_equals(s:select(), {{1, 'a'}})
+    end)
+end
+
+g.test_insert_batch_in_txn = function(cg)
+    cg.server:exec(function()
+        local s = box.space.test
+        box.begin()
+        s:insert({1, 'a'})
+        s:insert_batch({{2, 'b'}, {3, 'c'}})
+        t.assert_error_msg_contains('Duplicate key exists',
+                                    s.insert_batch, s, {{4, 'd'}, {1, 'e'}})
+        -- The failed batch is rolled back, the rest of the
+        -- transaction is kept.
+        box.commit()
+        t.assert_equals(s:select(), {{1, 'a'}, {2, 'b'}, {3, 'c'}})
+    end)
+end
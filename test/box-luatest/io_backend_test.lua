@@ -0,0 +1,39 @@
+local server = require('test.luatest_helpers.server')
+local t = require('luatest')
+local g = t.group()
+
+g.before_all = function()
+    g.server = server:new({alias = 'master',
+                           box_cfg = {io_backend = 'io_uring'}})
+    g.server:start()
+end
+
+g.after_all = function()
+    g.server:drop()
+end
+
+-- io_uring falls back on system calls if unsupported so the test
+-- must pass either way.
+g.test_io_uring = function()
+    g.server:exec(function()
+        t.assert_equals(box.cfg.io_backend, 'io_uring')
+        t.assert_error_msg_content_equals(
+            "Can't set option 'io_backend' dynamically",
+            box.cfg, {io_backend = 'syscall'})
+        local s = box.schema.space.create('test')
+        s:create_index('pk')
+        for i = 1, 100 do
+            s:insert({i})
+        end
+        box.snapshot()
+        for i = 101, 200 do
+            s:insert({i})
+        end
+    end)
+    g.server:stop()
+    g.server:start()
+    g.server:exec(function()
+        t.assert_equals(box.space.test:count(), 200)
+        box.space.test:drop()
+    end)
+end
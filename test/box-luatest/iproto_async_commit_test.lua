@@ -0,0 +1,151 @@
+local server = require('test.luatest_helpers.server')
+local t = require('luatest')
+local g = t.group()
+
+g.before_all(function(cg)
+    cg.server = server:new({alias = 'master'})
+    cg.server:start()
+    cg.server:exec(function()
+        box.schema.user.grant('guest', 'read,write', 'universe')
+        local s = box.schema.space.create('test')
+        s:create_index('pk')
+        -- Returns a raw socket and functions writing requests to it
+        -- and reading responses. The stream id is 1 unless the
+        -- header sets it.
+        rawset(_G, 'connect', function()
+            local msgpack = require('msgpack')
+            local socket = require('socket')
+            local uri = require('uri').parse(box.cfg.listen)
+            local sock = socket.tcp_connect(uri.host, uri.service)
+            sock:read(128) -- skip greeting
+            local function write(header, body)
+                if header[0x0a] == nil then
+                    header[0x0a] = 1
+                end
+                header = msgpack.encode(header)
+                body = msgpack.encode(body or {})
+                sock:write(msgpack.encode(#header + #body) ..
+                           header .. body)
+            end
+            local function read()
+                local size = msgpack.decode(sock:read(5))
+                local response = sock:read(size)
+                local header, pos = msgpack.decode(response)
+                return header, msgpack.decode(response, pos)
+            end
+            return sock, write, read
+        end)
+    end)
+end)
+
+g.after_all(function(cg)
+    cg.server:drop()
+end)
+
+g.after_each(function(cg)
+    cg.server:exec(function()
+        box.error.injection.set('ERRINJ_WAL_DELAY', false)
+        box.error.injection.set('ERRINJ_WAL_WRITE', false)
+        box.space.test:truncate()
+    end)
+end)
+
+g.test_feature = function(cg)
+    cg.server:exec(function()
+        local net = require('net.box')
+        local c = net.connect(box.cfg.listen)
+        t.assert(c.peer_protocol_features.async_commit)
+        c:close()
+    end)
+end
+
+-- The flag is accepted only for DML requests in a stream outside a
+-- stream transaction.
+g.test_illegal = function(cg)
+    cg.server:exec(function()
+        local sock, write, read = _G.connect()
+        local space_id = box.space.test.id
+        local function check(code, msg)
+            local header, body = read()
+            t.assert_equals(header[0x00], 0x8000 + code)
+            t.assert_str_contains(body[0x31], msg)
+        end
+        write({[0x00] = 2, [0x01] = 1, [0x09] = 0x08, [0x0a] = 0},
+              {[0x10] = space_id, [0x21] = {1}})
+        check(box.error.ILLEGAL_PARAMS, 'async commit')
+        write({[0x00] = 1, [0x01] = 2, [0x09] = 0x08},
+              {[0x10] = space_id, [0x20] = {}})
+        check(box.error.ILLEGAL_PARAMS, 'async commit')
+        write({[0x00] = 14, [0x01] = 3})
+        t.assert_equals(read()[0x00], 0)
+        write({[0x00] = 2, [0x01] = 4, [0x09] = 0x08},
+              {[0x10] = space_id, [0x21] = {1}})
+        check(box.error.ACTIVE_TRANSACTION, 'active transaction')
+        write({[0x00] = 16, [0x01] = 5})
+        t.assert_equals(read()[0x00], 0)
+        sock:close()
+        t.assert_equals(box.space.test:select(), {})
+    end)
+end
+
+-- The next request of the stream is executed while the previous one
+-- waits for WAL, and the reply to the previous one is sent after the
+-- write.
+g.test_release = function(cg)
+    cg.server:exec(function()
+        local sock, write, read = _G.connect()
+        local space_id = box.space.test.id
+        box.error.injection.set('ERRINJ_WAL_DELAY', true)
+        write({[0x00] = 2, [0x01] = 1, [0x09] = 0x08},
+              {[0x10] = space_id, [0x21] = {1}})
+        write({[0x00] = 4, [0x01] = 2, [0x09] = 0x08},
+              {[0x10] = space_id, [0x20] = {1},
+               [0x21] = {{'=', 2, 'x'}}})
+        write({[0x00] = 1, [0x01] = 3},
+              {[0x10] = space_id, [0x20] = {}})
+        local header, body = read()
+        t.assert_equals(header[0x00], 0)
+        t.assert_equals(header[0x01], 3)
+        t.assert_equals(body[0x30], {{1, 'x'}})
+        box.error.injection.set('ERRINJ_WAL_DELAY', false)
+        header, body = read()
+        t.assert_equals(header[0x00], 0)
+        t.assert_equals(header[0x01], 1)
+        t.assert_equals(body[0x30], {{1}})
+        header, body = read()
+        t.assert_equals(header[0x00], 0)
+        t.assert_equals(header[0x01], 2)
+        t.assert_equals(body[0x30], {{1, 'x'}})
+        sock:close()
+        t.assert_equals(box.space.test:select(), {{1, 'x'}})
+    end)
+end
+
+-- A failed WAL write rolls back all the requests released before
+-- it completed, and each of them replies with an error.
+g.test_wal_error = function(cg)
+    cg.server:exec(function()
+        local sock, write, read = _G.connect()
+        local space_id = box.space.test.id
+        box.error.injection.set('ERRINJ_WAL_DELAY', true)
+        write({[0x00] = 2, [0x01] = 1, [0x09] = 0x08},
+              {[0x10] = space_id, [0x21] = {1}})
+        write({[0x00] = 2, [0x01] = 2, [0x09] = 0x08},
+              {[0x10] = space_id, [0x21] = {2}})
+        write({[0x00] = 64, [0x01] = 3})
+        local header = read()
+        t.assert_equals(header[0x00], 0)
+        t.assert_equals(header[0x01], 3)
+        box.error.injection.set('ERRINJ_WAL_WRITE', true)
+        box.error.injection.set('ERRINJ_WAL_DELAY', false)
+        local syncs = {}
+        for _ = 1, 2 do
+            header = read()
+            t.assert_ge(header[0x00], 0x8000)
+            syncs[header[0x01]] = true
+        end
+        t.assert_equals(syncs, {[1] = true, [2] = true})
+        sock:close()
+        t.assert_equals(box.space.test:select(), {})
+    end)
+end
@@ -0,0 +1,145 @@
+local server = require('test.luatest_helpers.server')
+local t = require('luatest')
+local g = t.group()
+
+g.before_all(function(cg)
+    cg.server = server:new({
+        alias = 'master',
+        box_cfg = {memtx_use_mvcc_engine = true},
+    })
+    cg.server:start()
+    cg.server:exec(function()
+        box.schema.user.grant('guest', 'read,write', 'universe')
+        local s = box.schema.space.create('test')
+        s:create_index('pk')
+    end)
+end)
+
+g.after_all(function(cg)
+    cg.server:drop()
+end)
+
+g.after_each(function(cg)
+    cg.server:exec(function()
+        box.space.test:truncate()
+    end)
+end)
+
+-- Sends a BATCH request with the given sub-requests over a raw
+-- socket and returns the response header and body.
+local function batch(cg, requests)
+    return cg.server:exec(function(requests)
+        local msgpack = require('msgpack')
+        local socket = require('socket')
+        local uri = require('uri').parse(box.cfg.listen)
+        local sock = socket.tcp_connect(uri.host, uri.service)
+        sock:read(128) -- skip greeting
+        local header = msgpack.encode({[0x00] = 77, [0x01] = 1})
+        local body = msgpack.encode({[0x59] = requests})
+        local size = msgpack.encode(#header + #body)
+        sock:write(size .. header .. body)
+        size = msgpack.decode(sock:read(5))
+        local response = sock:read(size)
+        sock:close()
+        local header, pos = msgpack.decode(response)
+        return header, msgpack.decode(response, pos)
+    end, {requests})
+end
+
+g.test_feature = function(cg)
+    cg.server:exec(function()
+        local net = require('net.box')
+        local c = net.connect(box.cfg.listen)
+        t.assert(c.peer_protocol_features.batch)
+        c:close()
+    end)
+end
+
+g.test_batch = function(cg)
+    local header, body = batch(cg, {
+        {[0x00] = 2, [0x10] = 512, [0x21] = {1, 'a'}},
+        {[0x00] = 3, [0x10] = 512, [0x21] = {2, 'b'}},
+        {[0x00] = 4, [0x10] = 512, [0x20] = {1},
+         [0x21] = {{'=', 2, 'c'}}},
+        {[0x00] = 5, [0x10] = 512, [0x20] = {2}},
+        {[0x00] = 1, [0x10] = 512, [0x11] = 0, [0x12] = 10,
+         [0x20] = {}},
+    })
+    t.assert_equals(header[0x00], 0)
+    t.assert_equals(body[0x30], {
+        {{1, 'a'}}, {{2, 'b'}}, {{1, 'c'}}, {{2, 'b'}}, {{1, 'c'}},
+    })
+    header, body = batch(cg, {})
+    t.assert_equals(header[0x00], 0)
+    t.assert_equals(body[0x30], {})
+end
+
+-- A batch is executed in one transaction.
+g.test_error = function(cg)
+    local header, body = batch(cg, {
+        {[0x00] = 2, [0x10] = 512, [0x21] = {1}},
+        {[0x00] = 2, [0x10] = 512, [0x21] = {1}},
+    })
+    t.assert_not_equals(header[0x00], 0)
+    t.assert_str_contains(body[0x31], 'Duplicate key exists')
+    cg.server:exec(function()
+        t.assert_equals(box.space.test:select(), {})
+    end)
+end
+
+g.test_invalid = function(cg)
+    local header, body = batch(cg, {
+        {[0x00] = 2, [0x10] = 512, [0x21] = {1}},
+        {[0x00] = 10, [0x22] = 'f', [0x21] = {}},
+    })
+    t.assert_not_equals(header[0x00], 0)
+    t.assert_equals(body[0x31], 'Illegal parameters, ' ..
+                    'BATCH may only contain SELECT and DML requests')
+    header, body = batch(cg, {{[0x10] = 512, [0x21] = {1}}})
+    t.assert_not_equals(header[0x00], 0)
+    t.assert_equals(body[0x31],
+                    "Missing mandatory field 'type' in request")
+    cg.server:exec(function()
+        t.assert_equals(box.space.test:select(), {})
+    end)
+end
+
+-- A failed batch sent in a stream transaction rolls back only its own
+-- sub-requests, and the transaction can still be committed.
+g.test_stream = function(cg)
+    cg.server:exec(function()
+        local msgpack = require('msgpack')
+        local socket = require('socket')
+        local uri = require('uri').parse(box.cfg.listen)
+        local sock = socket.tcp_connect(uri.host, uri.service)
+        sock:read(128) -- skip greeting
+        local sync = 0
+        local function request(type, body)
+            sync = sync + 1
+            local header = msgpack.encode({[0x00] = type, [0x01] = sync,
+                                           [0x0a] = 1})
+            body = msgpack.encode(body)
+            local size = msgpack.encode(#header + #body)
+            sock:write(size .. header .. body)
+            size = msgpack.decode(sock:read(5))
+            local response = sock:read(size)
+            local header, pos = msgpack.decode(response)
+            return header, msgpack.decode(response, pos)
+        end
+        local header = request(14, {})
+        t.assert_equals(header[0x00], 0)
+        header = request(2, {[0x10] = 512, [0x21] = {1}})
+        t.assert_equals(header[0x00], 0)
+        local body
+        header, body = request(77, {[0x59] = {
+            {[0x00] = 2, [0x10] = 512, [0x21] = {2}},
+            {[0x00] = 2, [0x10] = 512, [0x21] = {1}},
+        }})
+        t.assert_not_equals(header[0x00], 0)
+        t.assert_str_contains(body[0x31], 'Duplicate key exists')
+        header = request(15, {})
+        t.assert_equals(header[0x00], 0)
+        sock:close()
+        t.assert_equals(box.space.test:select(), {{1}})
+    end)
+end
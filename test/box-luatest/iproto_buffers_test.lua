@@ -0,0 +1,58 @@
+local server = require('test.luatest_helpers.server')
+local t = require('luatest')
+local g = t.group()
+
+g.before_all(function(cg)
+    cg.server = server:new({alias = 'master'})
+    cg.server:start()
+    cg.server:exec(function()
+        box.schema.user.grant('guest', 'read,write,execute', 'universe')
+        local s = box.schema.space.create('test')
+        s:create_index('pk')
+        for i = 1, 100 do
+            s:insert({i, string.rep('x', 1000)})
+        end
+    end)
+end)
+
+g.after_all(function(cg)
+    cg.server:drop()
+end)
+
+g.test_stat = function(cg)
+    cg.server:exec(function()
+        local stat = box.stat.net()
+        t.assert_type(stat.INPUT_BUFFERS.current, 'number')
+        t.assert_type(stat.OUTPUT_BUFFERS.current, 'number')
+        t.assert_type(box.stat.net.INPUT_BUFFERS.current, 'number')
+        t.assert_type(box.stat.net.OUTPUT_BUFFERS.current, 'number')
+        stat = box.stat.net.thread[1]
+        t.assert_type(stat.INPUT_BUFFERS.current, 'number')
+        t.assert_type(stat.OUTPUT_BUFFERS.current, 'number')
+    end)
+end
+
+-- Buffers of idle connections are returned to the slab caches.
+g.test_idle = function(cg)
+    cg.server:exec(function()
+        local net = require('net.box')
+        local input = box.stat.net.INPUT_BUFFERS.current
+        local output = box.stat.net.OUTPUT_BUFFERS.current
+        local conns = {}
+        for i = 1, 50 do
+            conns[i] = net.connect(box.cfg.listen)
+            t.assert_equals(#conns[i].space.test:select(), 100)
+        end
+        t.assert_gt(box.stat.net.INPUT_BUFFERS.current, input)
+        t.assert_gt(box.stat.net.OUTPUT_BUFFERS.current, output)
+        t.helpers.retrying({timeout = 10}, function()
+            t.assert_le(box.stat.net.INPUT_BUFFERS.current, input)
+            t.assert_le(box.stat.net.OUTPUT_BUFFERS.current, output)
+        end)
+        -- Idle connections keep working.
+        for _, c in ipairs(conns) do
+            t.assert_equals(#c.space.test:select(), 100)
+            c:close()
+        end
+    end)
+end
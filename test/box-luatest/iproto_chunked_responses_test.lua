@@ -0,0 +1,107 @@
+local server = require('test.luatest_helpers.server')
+local t = require('luatest')
+local g = t.group()
+
+g.before_all(function(cg)
+    cg.server = server:new({alias = 'master'})
+    cg.server:start()
+    cg.server:exec(function()
+        box.schema.user.grant('guest', 'read', 'universe')
+        local s = box.schema.space.create('test')
+        s:create_index('pk')
+        for i = 1, 4000 do
+            s:insert({i, string.rep('x', 1000)})
+        end
+    end)
+end)
+
+g.after_all(function(cg)
+    cg.server:drop()
+end)
+
+g.test_feature = function(cg)
+    cg.server:exec(function()
+        local net = require('net.box')
+        local c = net.connect(box.cfg.listen)
+        t.assert(c.peer_protocol_features.chunked_responses)
+        c:close()
+    end)
+end
+
+-- A big result is sent in IPROTO_CHUNK packets followed by the reply.
+g.test_chunks = function(cg)
+    cg.server:exec(function()
+        local msgpack = require('msgpack')
+        local socket = require('socket')
+        local uri = require('uri').parse(box.cfg.listen)
+        local sock = socket.tcp_connect(uri.host, uri.service)
+        sock:read(128) -- skip greeting
+        local function write(header, body)
+            header = msgpack.encode(header)
+            body = msgpack.encode(body)
+            sock:write(msgpack.encode(#header + #body) .. header .. body)
+        end
+        local function read()
+            local size = msgpack.decode(sock:read(5))
+            local response = sock:read(size)
+            local header, pos = msgpack.decode(response)
+            return header, msgpack.decode(response, pos)
+        end
+        write({[0x00] = 73, [0x01] = 1}, {[0x54] = 7, [0x55] = {7}})
+        local header = read()
+        t.assert_equals(header[0x00], 0)
+        write({[0x00] = 1, [0x01] = 2},
+              {[0x10] = box.space.test.id, [0x12] = 10000, [0x20] = {}})
+        local tuples = {}
+        local chunks = 0
+        local body
+        repeat
+            header, body = read()
+            t.assert_equals(header[0x01], 2)
+            for _, tuple in ipairs(body[0x30]) do
+                table.insert(tuples, tuple)
+            end
+            if header[0x00] == 0x80 then
+                chunks = chunks + 1
+            end
+        until header[0x00] ~= 0x80
+        t.assert_equals(header[0x00], 0)
+        t.assert_gt(chunks, 1)
+        t.assert_equals(#tuples, 4000)
+        t.assert_equals(tuples[4000], {4000, string.rep('x', 1000)})
+        -- Small results are sent as usual.
+        write({[0x00] = 1, [0x01] = 3},
+              {[0x10] = box.space.test.id, [0x12] = 10, [0x20] = {}})
+        header, body = read()
+        t.assert_equals(header[0x00], 0)
+        t.assert_equals(#body[0x30], 10)
+        sock:close()
+    end)
+end
+
+-- net.box assembles the chunks.
+g.test_net_box = function(cg)
+    cg.server:exec(function()
+        local buffer = require('buffer')
+        local msgpack = require('msgpack')
+        local net = require('net.box')
+        local c = net.connect(box.cfg.listen)
+        local s = c.space.test
+        local expected = box.space.test:select()
+        t.assert_equals(s:select(), expected)
+        t.assert_equals(s:select({}, {is_async = true}):wait_result(),
+                        expected)
+        local raw = s:select({}, {return_raw = true})
+        t.assert_equals(raw:decode(), expected)
+        local ibuf = buffer.ibuf()
+        s:select({}, {buffer = ibuf})
+        local body = msgpack.decode(ibuf.rpos, ibuf:size())
+        t.assert_equals(body[0x30], expected)
+        ibuf:recycle()
+        s:select({}, {buffer = ibuf, skip_header = true})
+        t.assert_equals(msgpack.decode(ibuf.rpos, ibuf:size()), expected)
+        ibuf:recycle()
+        t.assert_equals(s:get(4000), expected[4000])
+        c:close()
+    end)
+end
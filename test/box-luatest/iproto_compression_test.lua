@@ -0,0 +1,52 @@
+local server = require('test.luatest_helpers.server')
+local t = require('luatest')
+local g = t.group()
+
+g.before_all(function(cg)
+    cg.server = server:new({alias = 'master'})
+    cg.server:start()
+    cg.server:exec(function()
+        box.schema.user.grant('guest', 'read,write,execute', 'universe')
+        local s = box.schema.space.create('test')
+        s:create_index('pk')
+        for i = 1, 1000 do
+            s:insert({i, string.rep('x', 100)})
+        end
+    end)
+end)
+
+g.after_all(function(cg)
+    cg.server:drop()
+end)
+
+g.test_feature = function(cg)
+    cg.server:exec(function()
+        local net = require('net.box')
+        local c = net.connect(box.cfg.listen)
+        t.assert(c.peer_protocol_features.compression)
+        c:close()
+    end)
+end
+
+-- Small responses are sent in raw chunks, big ones are compressed.
+g.test_compression = function(cg)
+    cg.server:exec(function()
+        local net = require('net.box')
+        local c = net.connect(box.cfg.listen, {compression = true})
+        t.assert_equals(c.state, 'active')
+        local s = c.space.test
+        t.assert_equals(s:get(1), {1, string.rep('x', 100)})
+        local sent = box.stat.net().SENT.total
+        t.assert_equals(s:select(), box.space.test:select())
+        t.assert_lt(box.stat.net().SENT.total - sent, 100 * 1000 / 2)
+        local futures = {}
+        for i = 1, 100 do
+            futures[i] = c:call('box.space.test:select', {{}, {limit = i}},
+                                {is_async = true})
+        end
+        for i = 1, 100 do
+            t.assert_equals(#futures[i]:wait_result()[1], i)
+        end
+        c:close()
+    end)
+end
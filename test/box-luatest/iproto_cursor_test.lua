@@ -0,0 +1,142 @@
+local server = require('test.luatest_helpers.server')
+local t = require('luatest')
+local g = t.group()
+
+g.before_all(function(cg)
+    cg.server = server:new({alias = 'master'})
+    cg.server:start()
+    cg.server:exec(function()
+        box.schema.user.grant('guest', 'read,write', 'universe')
+        local s = box.schema.space.create('test')
+        s:create_index('pk')
+        for i = 1, 10 do
+            s:insert({i})
+        end
+    end)
+end)
+
+g.after_all(function(cg)
+    cg.server:drop()
+end)
+
+-- Sends the given requests over one raw socket and returns the
+-- response headers and bodies.
+local function send(cg, requests)
+    return cg.server:exec(function(requests)
+        local msgpack = require('msgpack')
+        local socket = require('socket')
+        local uri = require('uri').parse(box.cfg.listen)
+        local sock = socket.tcp_connect(uri.host, uri.service)
+        sock:read(128) -- skip greeting
+        local responses = {}
+        for i, request in ipairs(requests) do
+            local header = msgpack.encode({[0x00] = request[1],
+                                           [0x01] = i})
+            local body = msgpack.encode(request[2])
+            local size = msgpack.encode(#header + #body)
+            sock:write(size .. header .. body)
+            size = msgpack.decode(sock:read(5))
+            local response = sock:read(size)
+            local header, pos = msgpack.decode(response)
+            responses[i] = {header, msgpack.decode(response, pos)}
+        end
+        sock:close()
+        return responses
+    end, {requests})
+end
+
+local CURSOR_OPEN = 78
+local CURSOR_FETCH = 79
+local CURSOR_CLOSE = 80
+
+g.test_feature = function(cg)
+    cg.server:exec(function()
+        local net = require('net.box')
+        local c = net.connect(box.cfg.listen)
+        t.assert(c.peer_protocol_features.cursors)
+        c:close()
+    end)
+end
+
+g.test_fetch = function(cg)
+    local r = send(cg, {
+        {CURSOR_OPEN, {[0x10] = 512, [0x12] = 4, [0x20] = {}}},
+        {CURSOR_FETCH, {[0x5a] = 1, [0x12] = 4}},
+        {CURSOR_FETCH, {[0x5a] = 1, [0x12] = 4}},
+        {CURSOR_FETCH, {[0x5a] = 1}},
+    })
+    t.assert_equals(r[1][1][0x00], 0)
+    t.assert_equals(r[1][2][0x5a], 1)
+    t.assert_equals(r[1][2][0x30], {{1}, {2}, {3}, {4}})
+    t.assert_equals(r[2][2][0x5a], 1)
+    t.assert_equals(r[2][2][0x30], {{5}, {6}, {7}, {8}})
+    -- The cursor is closed once exhausted.
+    t.assert_equals(r[3][2][0x5a], 0)
+    t.assert_equals(r[3][2][0x30], {{9}, {10}})
+    t.assert_not_equals(r[4][1][0x00], 0)
+    t.assert_equals(r[4][2][0x31], 'Cursor 1 does not exist')
+end
+
+g.test_open = function(cg)
+    local r = send(cg, {
+        -- Iterator, key and offset are the same as in SELECT.
+        {CURSOR_OPEN, {[0x10] = 512, [0x11] = 0, [0x12] = 2,
+                       [0x13] = 1, [0x14] = 5, [0x20] = {5}}},
+        {CURSOR_FETCH, {[0x5a] = 1, [0x12] = 2}},
+        -- Exhausted on open.
+        {CURSOR_OPEN, {[0x10] = 512, [0x12] = 100, [0x20] = {}}},
+        {CURSOR_OPEN, {[0x10] = 513, [0x12] = 100, [0x20] = {}}},
+        {CURSOR_OPEN, {[0x10] = 512, [0x20] = {}}},
+    })
+    t.assert_equals(r[1][2][0x5a], 1)
+    t.assert_equals(r[1][2][0x30], {{6}, {7}})
+    t.assert_equals(r[2][2][0x30], {{8}, {9}})
+    t.assert_equals(r[3][2][0x5a], 0)
+    t.assert_equals(#r[3][2][0x30], 10)
+    t.assert_str_contains(r[4][2][0x31], "Space '513' does not exist")
+    t.assert_equals(r[5][2][0x31], "Missing mandatory field 'limit' " ..
+                    "in request")
+end
+
+g.test_close = function(cg)
+    local r = send(cg, {
+        {CURSOR_OPEN, {[0x10] = 512, [0x12] = 1, [0x20] = {}}},
+        {CURSOR_CLOSE, {[0x5a] = 1}},
+        {CURSOR_FETCH, {[0x5a] = 1, [0x12] = 1}},
+        {CURSOR_CLOSE, {[0x5a] = 1}},
+        {CURSOR_CLOSE, {}},
+    })
+    t.assert_equals(r[2][1][0x00], 0)
+    t.assert_equals(r[3][2][0x31], 'Cursor 1 does not exist')
+    t.assert_equals(r[4][2][0x31], 'Cursor 1 does not exist')
+    t.assert_equals(r[5][2][0x31], "Missing mandatory field 'cursor id' " ..
+                    "in request")
+end
+
+-- A cursor survives changes of the space.
+g.test_update = function(cg)
+    local r = cg.server:exec(function()
+        local msgpack = require('msgpack')
+        local socket = require('socket')
+        local uri = require('uri').parse(box.cfg.listen)
+        local sock = socket.tcp_connect(uri.host, uri.service)
+        sock:read(128) -- skip greeting
+        local function request(type, body)
+            local header = msgpack.encode({[0x00] = type, [0x01] = 1})
+            body = msgpack.encode(body)
+            sock:write(msgpack.encode(#header + #body) .. header .. body)
+            local size = msgpack.decode(sock:read(5))
+            local response = sock:read(size)
+            local _, pos = msgpack.decode(response)
+            return msgpack.decode(response, pos)[0x30]
+        end
+        local r = {}
+        r[1] = request(78, {[0x10] = 512, [0x12] = 2, [0x20] = {}})
+        box.space.test:delete(3)
+        r[2] = request(79, {[0x5a] = 1, [0x12] = 2})
+        box.space.test:insert({3})
+        sock:close()
+        return r
+    end)
+    t.assert_equals(r, {{{1}, {2}}, {{4}, {5}}})
+end
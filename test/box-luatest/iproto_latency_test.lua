@@ -0,0 +1,71 @@
+local server = require('test.luatest_helpers.server')
+local t = require('luatest')
+local g = t.group()
+
+local STAGES = {'queue', 'execution', 'reply', 'total'}
+local PCTS = {'p50', 'p75', 'p90', 'p95', 'p99'}
+
+g.before_all(function(cg)
+    cg.server = server:new({
+        alias = 'master',
+        box_cfg = {iproto_threads = 2},
+    })
+    cg.server:start()
+    cg.server:exec(function()
+        box.schema.user.grant('guest', 'read,write,execute', 'universe')
+        local s = box.schema.space.create('test')
+        s:create_index('pk')
+    end)
+end)
+
+g.after_all(function(cg)
+    cg.server:drop()
+end)
+
+g.test_latency = function(cg)
+    cg.server:exec(function(stages, pcts)
+        local net = require('net.box')
+        local function keys(tbl)
+            local res = {}
+            for k in pairs(tbl) do
+                table.insert(res, k)
+            end
+            return res
+        end
+        box.stat.reset()
+        t.assert_equals(box.stat.net().LATENCY, {})
+        local c = net.connect(box.cfg.listen)
+        for i = 1, 10 do
+            c.space.test:insert({i})
+            c.space.test:select({i})
+        end
+        c:call('box.info')
+        c:close()
+        local latency = box.stat.net().LATENCY
+        t.assert_equals(latency, box.stat.net.LATENCY)
+        t.assert_items_equals(keys(latency),
+                              {'INSERT', 'SELECT', 'CALL'})
+        for _, stat in pairs(latency) do
+            t.assert_items_equals(keys(stat), stages)
+            for _, stage in ipairs(stages) do
+                t.assert_items_equals(keys(stat[stage]), pcts)
+                t.assert_ge(stat[stage].p50, 0)
+                t.assert_le(stat[stage].p50, stat[stage].p99)
+            end
+            t.assert_ge(stat.total.p99, stat.execution.p50)
+        end
+        -- Every request is accounted in the thread that served it.
+        local threads = box.stat.net.thread()
+        local count = 0
+        for i = 1, #threads do
+            if threads[i].LATENCY.INSERT ~= nil then
+                count = count + 1
+            end
+            t.assert_equals(box.stat.net.thread[i].LATENCY,
+                            threads[i].LATENCY)
+        end
+        t.assert_equals(count, 1)
+        box.stat.reset()
+        t.assert_equals(box.stat.net().LATENCY, {})
+    end, {STAGES, PCTS})
+end
@@ -0,0 +1,59 @@
+local server = require('test.luatest_helpers.server')
+local t = require('luatest')
+local g = t.group()
+
+local THREADS = 4
+
+g.before_all(function(cg)
+    cg.server = server:new({
+        alias = 'master',
+        box_cfg = {
+            iproto_threads = THREADS,
+            iproto_reuseport = true,
+            iproto_cpu_affinity = {0, 0, 0, 0},
+        },
+    })
+    cg.server:start()
+end)
+
+g.after_all(function(cg)
+    cg.server:drop()
+end)
+
+-- Every iproto thread accepts connections on its own socket.
+g.test_accept = function(cg)
+    cg.server:exec(function(threads)
+        local net = require('net.box')
+        local conns = {}
+        for i = 1, 10 * threads do
+            conns[i] = net.connect(box.cfg.listen)
+            t.assert_equals(conns[i]:ping(), true)
+        end
+        local stat = box.stat.net.thread()
+        for i = 1, threads do
+            t.assert_gt(stat[i].CONNECTIONS.current, 0)
+        end
+        for _, c in ipairs(conns) do
+            c:close()
+        end
+        -- Sockets are reopened on listen change.
+        local listen = box.cfg.listen
+        box.cfg{listen = ''}
+        t.assert_not(net.connect(listen):is_connected())
+        box.cfg{listen = listen}
+        local c = net.connect(listen)
+        t.assert_equals(c:ping(), true)
+        c:close()
+    end, {THREADS})
+end
+
+g.test_cfg = function(cg)
+    cg.server:exec(function()
+        t.assert_error_msg_content_equals(
+            "Can't set option 'iproto_reuseport' dynamically",
+            box.cfg, {iproto_reuseport = false})
+        t.assert_error_msg_content_equals(
+            "Can't set option 'iproto_cpu_affinity' dynamically",
+            box.cfg, {iproto_cpu_affinity = 1})
+    end)
+end
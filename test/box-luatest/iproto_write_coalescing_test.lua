@@ -0,0 +1,39 @@
+local server = require('test.luatest_helpers.server')
+local t = require('luatest')
+local g = t.group()
+
+g.before_all(function(cg)
+    cg.server = server:new({alias = 'master'})
+    cg.server:start()
+end)
+
+g.after_all(function(cg)
+    cg.server:drop()
+end)
+
+-- Concurrent requests issued on one connection are sent, and replied
+-- to, with fewer writes than requests.
+g.test_write_coalescing = function(cg)
+    cg.server:exec(function()
+        local fiber = require('fiber')
+        local net = require('net.box')
+        local c = net.connect(box.cfg.listen)
+        t.assert_equals(c.state, 'active')
+
+        local count = 100
+        local writes = box.stat.net().WRITES.total
+        local requests = box.stat.net().REQUESTS.total
+        local ch = fiber.channel(count)
+        for _ = 1, count do
+            fiber.create(function()
+                ch:put(c:ping())
+            end)
+        end
+        for _ = 1, count do
+            t.assert(ch:get())
+        end
+        t.assert_equals(box.stat.net().REQUESTS.total - requests, count)
+        t.assert_lt(box.stat.net().WRITES.total - writes, count / 2)
+        c:close()
+    end)
+end
@@ -0,0 +1,96 @@
+local server = require('test.luatest_helpers.server')
+local t = require('luatest')
+local g = t.group()
+
+g.before_all = function()
+    g.server = server:new({alias = 'master'})
+    g.server:start()
+end
+
+g.after_all = function()
+    g.server:drop()
+end
+
+g.test_to_msgpack = function()
+    g.server:exec(function()
+        local json = require('json')
+        local msgpack = require('msgpack')
+        local str = '{"a": [1, -2, 3.5, "x", true, null, {}, []], "b": {"c": 1}}'
+        local obj = json.to_msgpack(str)
+        t.assert_equals(obj:decode(), json.decode(str))
+        t.assert_equals(json.to_msgpack('1e3'):decode(), 1000)
+        t.assert_equals(json.to_msgpack('"\\u00e9\\n"'):decode(), 'é\n')
+        -- Key order and duplicates are kept.
+        local mp = msgpack.encode(json.to_msgpack('{"b": 1, "a": 2, "b": 3}'))
+        t.assert_equals(mp, '\x83\xa1b\x01\xa1a\x02\xa1b\x03')
+        -- Long arrays get a longer header.
+        local arr = {}
+        for i = 1, 70000 do
+            arr[i] = i % 3
+        end
+        t.assert_equals(json.to_msgpack(json.encode(arr)):decode(), arr)
+
+        t.assert_error_msg_contains("Expected the end but found comma",
+                                    json.to_msgpack, '1, 2')
+        t.assert_error_msg_contains("Expected comma or ']'",
+                                    json.to_msgpack, '[1 2]')
+        local deep = string.rep('[', 200) .. string.rep(']', 200)
+        t.assert_error_msg_contains("Found too many nested data structures",
+                                    json.to_msgpack, deep,
+                                    {decode_max_depth = 100})
+    end)
+end
+
+g.test_from_msgpack = function()
+    g.server:exec(function()
+        local json = require('json')
+        local msgpack = require('msgpack')
+        local value = {1, -2, 3.5, 'x', true, box.NULL, {a = {b = 'c'}}}
+        local obj = msgpack.object(value)
+        t.assert_equals(json.decode(json.from_msgpack(obj)), value)
+        t.assert_equals(json.from_msgpack(msgpack.encode(value)),
+                        json.encode(value))
+        t.assert_equals(json.from_msgpack(msgpack.encode({[10] = 'x'})),
+                        '{"10":"x"}')
+        t.assert_equals(json.from_msgpack(msgpack.object({
+            require('uuid').fromstr('7e3b1bbc-e2b5-4a3d-9a2e-1a6e3b1b0c0d'),
+            require('decimal').new('1.5'),
+        })), '["7e3b1bbc-e2b5-4a3d-9a2e-1a6e3b1b0c0d","1.5"]')
+
+        local deep = msgpack.encode({{{1}}})
+        t.assert_equals(json.from_msgpack(deep, {encode_max_depth = 2,
+                                                 encode_deep_as_nil = true}),
+                        '[[null]]')
+        t.assert_error_msg_contains("Too high nest level",
+                                    json.from_msgpack, deep,
+                                    {encode_max_depth = 2})
+        t.assert_error_msg_contains("number must not be NaN or Inf",
+                                    json.from_msgpack, msgpack.encode(0/0),
+                                    {encode_invalid_numbers = false})
+        t.assert_error_msg_contains("Invalid MsgPack",
+                                    json.from_msgpack, '\x92\x01')
+    end)
+end
+
+g.test_tuple_new = function()
+    g.server:exec(function()
+        local json = require('json')
+        local msgpack = require('msgpack')
+        local obj = json.to_msgpack('[1, "a", {"b": 2}]')
+        local tuple = box.tuple.from_msgpack(obj)
+        t.assert_equals(tuple:totable(), {1, 'a', {b = 2}})
+        -- box.tuple.new() wraps a msgpack object as before.
+        t.assert_equals(box.tuple.new(obj):totable(), {{1, 'a', {b = 2}}})
+        t.assert_error_msg_contains('Usage: box.tuple.from_msgpack',
+                                    box.tuple.from_msgpack,
+                                    msgpack.object(1))
+        t.assert_error_msg_contains('Usage: box.tuple.from_msgpack',
+                                    box.tuple.from_msgpack, {1})
+        local s = box.schema.space.create('test')
+        s:create_index('pk')
+        s:insert(json.to_msgpack('[1, "x"]'))
+        t.assert_equals(json.from_msgpack(msgpack.object(s:get(1))),
+                        '[1,"x"]')
+        s:drop()
+    end)
+end
@@ -0,0 +1,120 @@
+local server = require('test.luatest_helpers.server')
+local t = require('luatest')
+local g = t.group()
+
+g.before_all(function(cg)
+    cg.server = server:new({alias = 'master'})
+    cg.server:start()
+    cg.server:exec(function()
+        local s = box.schema.space.create('test', {format = {
+            {'id', 'unsigned'},
+            {'name', 'string'},
+            {'score', 'number', is_nullable = true},
+            {'delta', 'integer', is_nullable = true},
+            {'flag', 'boolean', is_nullable = true},
+        }})
+        s:create_index('pk')
+    end)
+end)
+
+g.after_all(function(cg)
+    cg.server:drop()
+end)
+
+g.after_each(function(cg)
+    cg.server:exec(function()
+        box.space.test:truncate()
+    end)
+end)
+
+g.test_load_csv_string = function(cg)
+    cg.server:exec(function()
+        local s = box.space.test
+        local csv = 'id,name,score,delta,flag\n' ..
+                    '1,a,1.5,-3,true\n' ..
+                    '2,"b,c",10,,false\n' ..
+                    '\n' ..
+                    '3,"multi\nline",,7,\n' ..
+                    '4,d,,,,extra'
+        t.assert_equals(s:load_csv(csv, {skip_head_lines = 1}), 4)
+        t.assert_equals(s:select(), {
+            {1, 'a', 1.5, -3, true},
+            {2, 'b,c', 10, nil, false},
+            {3, 'multi\nline', nil, 7, nil},
+            {4, 'd', nil, nil, nil, 'extra'},
+        })
+    end)
+end
+
+g.test_load_csv_options = function(cg)
+    cg.server:exec(function()
+        local s = box.space.test
+        local csv = "1;'x;y'\n2;z\n3;w\n"
+        t.assert_equals(s:load_csv(csv, {delimiter = ';', quote_char = "'",
+                                         batch_size = 2}), 3)
+        t.assert_equals(s:select(), {{1, 'x;y'}, {2, 'z'}, {3, 'w'}})
+        t.assert_error_msg_contains("unexpected option 'foo'",
+                                    s.load_csv, s, '', {foo = 1})
+        t.assert_error_msg_contains('batch_size must be positive',
+                                    s.load_csv, s, '', {batch_size = 0})
+        t.assert_error_msg_contains('delimiter must be a single character',
+                                    s.load_csv, s, '', {delimiter = ';;'})
+        t.assert_error_msg_contains('Usage: space:load_csv',
+                                    s.load_csv, s, 1)
+    end)
+end
+
+g.test_load_csv_readable = function(cg)
+    cg.server:exec(function()
+        local fio = require('fio')
+        local s = box.space.test
+        local lines = {}
+        for i = 1, 1000 do
+            table.insert(lines, string.format('%d,name%d,%d.25', i, i, i))
+        end
+        local path = fio.pathjoin(fio.tempdir(), 'data.csv')
+        local fh = fio.open(path, {'O_CREAT', 'O_WRONLY'}, tonumber('644', 8))
+        fh:write(table.concat(lines, '\n'))
+        fh:close()
+        for _, in_thread in ipairs({false, true}) do
+            fh = fio.open(path, {'O_RDONLY'})
+            -- Small chunks make rows span chunk boundaries.
+            t.assert_equals(s:load_csv(fh, {chunk_size = 7, batch_size = 100,
+                                            parse_in_thread = in_thread}),
+                            1000)
+            fh:close()
+            t.assert_equals(s:count(), 1000)
+            t.assert_equals(s:get(1), {1, 'name1', 1.25})
+            t.assert_equals(s:get(1000), {1000, 'name1000', 1000.25})
+            s:truncate()
+        end
+        fio.unlink(path)
+    end)
+end
+
+g.test_load_csv_error = function(cg)
+    cg.server:exec(function()
+        local s = box.space.test
+        t.assert_error_msg_equals(
+            "CSV row 2, field 1: can't convert '-2' to unsigned",
+            s.load_csv, s, '1,a\n-2,b\n')
+        t.assert_error_msg_equals(
+            "CSV row 1, field 5: can't convert 'yes' to boolean",
+            s.load_csv, s, '5,a,,,yes\n')
+        t.assert_error_msg_equals(
+            "CSV row 1, field 4: can't convert '1.5' to integer",
+            s.load_csv, s, '5,a,,1.5\n')
+        t.assert_error_msg_equals(
+            "CSV row 2: unterminated quoted field",
+            s.load_csv, s, '6,a\n7,"b\n')
+        t.assert_error_msg_contains('Duplicate key exists',
+                                    s.load_csv, s, '8,a\n8,b\n')
+        t.assert_equals(s:select(), {})
+        t.assert_error_msg_contains("can't be used in a transaction",
+                                    function()
+            box.atomic(s.load_csv, s, '9,a\n', {parse_in_thread = true})
+        end)
+        box.atomic(s.load_csv, s, '9,a\n')
+        t.assert_equals(s:select(), {{9, 'a'}})
+    end)
+end
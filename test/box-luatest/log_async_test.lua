@@ -0,0 +1,67 @@
+local server = require('test.luatest_helpers.server')
+local t = require('luatest')
+local g = t.group()
+
+g.before_all(function(cg)
+    cg.server = server:new({
+        alias = 'master',
+        box_cfg = {log_async = true},
+    })
+    cg.server:start()
+end)
+
+g.after_all(function(cg)
+    cg.server:drop()
+end)
+
+g.test_log_async = function(cg)
+    cg.server:exec(function()
+        local fiber = require('fiber')
+        local log = require('log')
+        t.assert_equals(box.cfg.log_async, true)
+        t.assert_equals(box.cfg.log_async_overflow, 'drop')
+        local info = box.info.log
+        t.assert_equals(info.async, true)
+        t.assert_equals(info.queue.size, 1024 * 1024)
+        log.info('async message')
+        t.helpers.retrying({}, function()
+            t.assert_equals(box.info.log.queue.used, 0)
+        end)
+        -- Overflow blocks the writer instead of dropping messages.
+        box.cfg{log_async_overflow = 'block'}
+        local dropped = box.info.log.queue.dropped
+        for i = 1, 10000 do
+            log.info('blocking message %d %s', i, string.rep('x', 1000))
+        end
+        t.assert_equals(box.info.log.queue.dropped, dropped)
+        fiber.sleep(0)
+    end)
+    t.helpers.retrying({}, function()
+        t.assert(cg.server:grep_log('async message'))
+        t.assert(cg.server:grep_log('blocking message 10000'))
+    end)
+end
+
+g.test_log_sync = function(cg)
+    cg.server:exec(function()
+        local log = require('log')
+        box.cfg{log_async = false}
+        t.assert_equals(box.info.log.async, false)
+        t.assert_equals(box.info.log.queue.size, 0)
+        log.info('sync message')
+        box.cfg{log_async = true}
+        t.assert_equals(box.info.log.async, true)
+    end)
+    t.assert(cg.server:grep_log('sync message'))
+end
+
+g.test_cfg = function(cg)
+    cg.server:exec(function()
+        local overflow = box.cfg.log_async_overflow
+        t.assert_error_msg_content_equals(
+            "Incorrect value for option 'log_async_overflow': " ..
+            "expected 'drop' or 'block'",
+            box.cfg, {log_async_overflow = 'foo'})
+        t.assert_equals(box.cfg.log_async_overflow, overflow)
+    end)
+end
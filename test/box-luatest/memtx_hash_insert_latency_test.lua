@@ -0,0 +1,34 @@
+local server = require('test.luatest_helpers.server')
+local t = require('luatest')
+local g = t.group()
+
+g.before_all(function(cg)
+    cg.server = server:new({alias = 'master'})
+    cg.server:start()
+end)
+
+g.after_all(function(cg)
+    cg.server:drop()
+end)
+
+g.test_insert_latency = function(cg)
+    cg.server:exec(function()
+        local s = box.schema.space.create('test')
+        s:create_index('pk', {type = 'hash'})
+        -- Only every 64th insert is timed.
+        for i = 1, 6400 do
+            s:replace({i})
+        end
+        local stat = s.index.pk:stat().insert_latency
+        t.assert_equals(stat.count, 100)
+        t.assert_gt(stat.p50, 0)
+        t.assert_le(stat.p50, stat.p90)
+        t.assert_le(stat.p90, stat.p99)
+        t.assert_le(stat.p99, stat.p999)
+        box.stat.reset()
+        stat = s.index.pk:stat().insert_latency
+        t.assert_equals(stat.count, 0)
+        t.assert_equals(stat.p999, 0)
+        s:drop()
+    end)
+end
@@ -0,0 +1,81 @@
+local server = require('test.luatest_helpers.server')
+local t = require('luatest')
+local g = t.group()
+
+g.before_all(function(cg)
+    cg.server = server:new({alias = 'master'})
+    cg.server:start()
+end)
+
+g.after_all(function(cg)
+    cg.server:drop()
+end)
+
+g.after_each(function(cg)
+    cg.server:exec(function()
+        if box.space.test ~= nil then
+            box.space.test:drop()
+        end
+    end)
+end)
+
+g.test_secondary_index_build_yields = function(cg)
+    cg.server:exec(function()
+        local fiber = require('fiber')
+        local s = box.schema.space.create('test')
+        s:create_index('pk', {type = 'hash'})
+        local count = 10000
+        box.begin()
+        for i = 1, count do
+            s:insert({i, i})
+        end
+        box.commit()
+
+        local f = fiber.new(s.create_index, s, 'sk',
+                            {type = 'tree', parts = {2, 'unsigned'}})
+        f:set_joinable(true)
+        fiber.yield()
+        -- The build yields, so writes go on while it's running.
+        t.assert_equals(f:status(), 'suspended')
+        for i = 1, 100 do
+            s:delete({i})
+            s:replace({count + i, count + i})
+            s:update({100 + i}, {{'=', 2, 2 * count + i}})
+        end
+        box.begin()
+        s:insert({3 * count, 3 * count})
+        box.rollback()
+        t.assert((f:join()))
+
+        t.assert_equals(s.index.sk:count(), s.index.pk:count())
+        for _, tuple in s:pairs() do
+            t.assert_equals(s.index.sk:get({tuple[2]}), tuple)
+        end
+        t.assert_equals(s.index.sk:get({3 * count}), nil)
+    end)
+end
+
+g.test_secondary_index_build_conflict = function(cg)
+    cg.server:exec(function()
+        local fiber = require('fiber')
+        local s = box.schema.space.create('test')
+        s:create_index('pk', {type = 'hash'})
+        local count = 10000
+        box.begin()
+        for i = 1, count do
+            s:insert({i, i})
+        end
+        box.commit()
+
+        local f = fiber.new(s.create_index, s, 'sk',
+                            {type = 'tree', parts = {2, 'unsigned'}})
+        f:set_joinable(true)
+        fiber.yield()
+        t.assert_equals(f:status(), 'suspended')
+        s:replace({count + 1, 1})
+        local ok, err = f:join()
+        t.assert_not(ok)
+        t.assert_str_contains(tostring(err), 'Duplicate key exists')
+        t.assert_equals(s.index.sk, nil)
+    end)
+end
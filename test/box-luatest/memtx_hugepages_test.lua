@@ -0,0 +1,39 @@
+local server = require('test.luatest_helpers.server')
+local t = require('luatest')
+local g = t.group()
+
+g.before_all(function(cg)
+    cg.server = server:new({
+        alias = 'master',
+        box_cfg = {memtx_use_hugepages = true},
+    })
+    cg.server:start()
+end)
+
+g.after_all(function(cg)
+    cg.server:drop()
+end)
+
+g.test_hugepages = function(cg)
+    cg.server:exec(function()
+        t.assert_equals(box.cfg.memtx_use_hugepages, true)
+        local s = box.schema.space.create('test')
+        s:create_index('pk')
+        for i = 1, 10000 do
+            s:insert({i, string.rep('x', 100)})
+        end
+        local info = box.slab.info()
+        t.assert_type(info.arena_hugepages, 'number')
+        t.assert_ge(info.arena_hugepages, 0)
+        t.assert_le(info.arena_hugepages, info.quota_size)
+        s:drop()
+    end)
+end
+
+g.test_cfg = function(cg)
+    cg.server:exec(function()
+        t.assert_error_msg_content_equals(
+            "Can't set option 'memtx_use_hugepages' dynamically",
+            box.cfg, {memtx_use_hugepages = false})
+    end)
+end
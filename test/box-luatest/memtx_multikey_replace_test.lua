@@ -0,0 +1,77 @@
+local server = require('test.luatest_helpers.server')
+local t = require('luatest')
+local g = t.group()
+
+g.before_all(function(cg)
+    cg.server = server:new({alias = 'master'})
+    cg.server:start()
+    cg.server:exec(function()
+        local s = box.schema.space.create('test')
+        s:create_index('pk')
+        s:create_index('tags', {parts = {{'[2][*]', 'string'}},
+                                unique = false})
+        s:create_index('uniq', {parts = {{'[3][*]', 'unsigned'}}})
+    end)
+end)
+
+g.after_all(function(cg)
+    cg.server:drop()
+end)
+
+g.after_each(function(cg)
+    cg.server:exec(function()
+        box.space.test:truncate()
+    end)
+end)
+
+-- Replacing a tuple must leave exactly the entries of the new tuple
+-- in a multikey index, whichever of the old entries it replaced.
+g.test_replace = function(cg)
+    cg.server:exec(function()
+        local s = box.space.test
+        local function check(expected)
+            t.assert_equals(s.index.tags:len(), expected)
+            t.assert_equals(#s.index.tags:select(), expected)
+        end
+        s:insert({1, {'a', 'b', 'c'}, {1, 2}})
+        s:insert({2, {'b', 'd'}, {3}})
+        check(5)
+        -- Same arrays: every old entry is replaced.
+        s:update(1, {{'=', 4, 'x'}})
+        check(5)
+        t.assert_equals(s.index.tags:select('a'), {{1, {'a', 'b', 'c'},
+                                                    {1, 2}, 'x'}})
+        -- Some old entries are replaced, some are deleted.
+        s:replace({1, {'c', 'e', 'a', 'e'}, {2, 4}})
+        check(5)
+        t.assert_equals(s.index.tags:select('b'), {{2, {'b', 'd'}, {3}}})
+        t.assert_equals(#s.index.tags:select('e'), 1)
+        t.assert_equals(s.index.uniq:select(1), {})
+        t.assert_equals(s.index.uniq:get(4)[1], 1)
+        -- No old entries are replaced.
+        s:replace({1, {'f'}, {5}})
+        check(3)
+        t.assert_equals(s.index.tags:select('a'), {})
+        t.assert_equals(s.index.uniq:get(2), nil)
+        -- An empty array.
+        s:replace({1, {}, {}})
+        check(2)
+        t.assert_equals(s.index.uniq:len(), 1)
+    end)
+end
+
+g.test_replace_error = function(cg)
+    cg.server:exec(function()
+        local s = box.space.test
+        s:insert({1, {'a', 'b'}, {1, 2}})
+        s:insert({2, {'c'}, {3}})
+        t.assert_error_msg_contains('Duplicate key exists', s.replace, s,
+                                    {1, {'a', 'd'}, {2, 3}})
+        t.assert_equals(s:get(1), {1, {'a', 'b'}, {1, 2}})
+        t.assert_equals(s.index.tags:len(), 3)
+        t.assert_equals(s.index.tags:select('b')[1][1], 1)
+        t.assert_equals(s.index.tags:select('d'), {})
+        t.assert_equals(s.index.uniq:get(2)[1], 1)
+        t.assert_equals(s.index.uniq:get(3)[1], 2)
+    end)
+end
@@ -0,0 +1,65 @@
+local server = require('test.luatest_helpers.server')
+local t = require('luatest')
+local g = t.group()
+
+g.before_all = function()
+    g.server = server:new({alias = 'master',
+                           box_cfg = {memtx_sort_threads = 3}})
+    g.server:start()
+end
+
+g.after_all = function()
+    g.server:drop()
+end
+
+g.test_build_secondary_keys = function()
+    g.server:exec(function()
+        local s = box.schema.space.create('test')
+        s:create_index('pk')
+        s:create_index('sk1', {parts = {2, 'unsigned'}})
+        s:create_index('sk2', {parts = {3, 'string'}, unique = false})
+        s:create_index('sk3', {type = 'hash', parts = {2, 'unsigned'}})
+        s:create_index('sk4', {parts = {{4, 'unsigned', path = '[*]'}},
+                               unique = false})
+        box.begin()
+        for i = 1, 20000 do
+            s:insert({i, 20000 - i, tostring(i % 100), {i, i + 1}})
+        end
+        box.commit()
+        box.snapshot()
+    end)
+    g.server:stop()
+    g.server:start()
+    g.server:exec(function()
+        local s = box.space.test
+        t.assert_equals(s.index.sk1:len(), 20000)
+        t.assert_equals(s.index.sk2:len(), 20000)
+        t.assert_equals(s.index.sk3:len(), 20000)
+        t.assert_equals(s.index.sk4:len(), 20001)
+        t.assert_equals(s.index.sk1:min(), {20000, 0, '0', {20000, 20001}})
+        t.assert_equals(s.index.sk2:count('7'), 200)
+        t.assert_equals(s.index.sk4:count(2), 2)
+
+        local recovery = box.info.memtx().recovery
+        t.assert_equals(recovery.status, 'idle')
+        t.assert_ge(recovery.rows, 20000)
+        t.assert_gt(recovery.rps, 0)
+
+        local build = box.info.memtx().build
+        t.assert_equals(build.status, 'idle')
+        t.assert_equals(build.spaces_done, build.spaces_total)
+        t.assert_ge(build.indexes_done, 4)
+        local space = build.spaces.test
+        t.assert_equals(space.tuples, 20000)
+        for _, name in ipairs({'sk1', 'sk2', 'sk3', 'sk4'}) do
+            t.assert_type(space.indexes[name].sort, 'number')
+            t.assert_type(space.indexes[name].build, 'number')
+        end
+    end)
+end
+
+g.test_memtx_sort_threads_cfg = function()
+    t.assert_error_msg_contains("Can't set option 'memtx_sort_threads' dynamically", function()
+        g.server:exec(function() box.cfg{memtx_sort_threads = 2} end)
+    end)
+end
@@ -0,0 +1,48 @@
+local server = require('test.luatest_helpers.server')
+local t = require('luatest')
+local g = t.group()
+
+g.before_all(function(cg)
+    cg.server = server:new({alias = 'master',
+                            box_cfg = {memtx_use_mvcc_engine = true}})
+    cg.server:start()
+end)
+
+g.after_all(function(cg)
+    cg.server:drop()
+end)
+
+g.test_tx_stat = function(cg)
+    cg.server:exec(function()
+        local s = box.schema.space.create('test')
+        s:create_index('pk')
+        box.begin()
+        for i = 1, 100 do
+            s:replace({i})
+        end
+        s:select({200}, {iterator = 'GE'})
+        s:get({300})
+
+        local stat = box.info.memtx().tx
+        t.assert_ge(stat.txns, 1)
+        t.assert_ge(stat.stories.count, 100)
+        t.assert_gt(stat.stories.total, 0)
+        t.assert_ge(stat.spaces.test.stories, 100)
+        t.assert_ge(stat.trackers.gaps, 1)
+        t.assert_ge(stat.trackers.point_holes, 1)
+        box.commit()
+
+        -- The background GC deletes the stories that aren't used.
+        t.helpers.retrying({}, function()
+            stat = box.info.memtx().tx
+            t.assert_equals(stat.stories.count, 0)
+            t.assert_equals(stat.stories.total, 0)
+            t.assert_equals(stat.spaces, {})
+        end)
+        t.assert_equals(stat.trackers.gaps, 0)
+        t.assert_equals(stat.trackers.point_holes, 0)
+        t.assert_ge(stat.gc.freed, 100)
+        t.assert_ge(stat.gc.steps, stat.gc.freed)
+        s:drop()
+    end)
+end
@@ -0,0 +1,67 @@
+local server = require('test.luatest_helpers.server')
+local t = require('luatest')
+local g = t.group()
+
+g.before_all(function(cg)
+    cg.server = server:new({alias = 'master'})
+    cg.server:start()
+end)
+
+g.after_all(function(cg)
+    cg.server:drop()
+end)
+
+g.after_each(function(cg)
+    cg.server:exec(function()
+        if box.space.test ~= nil then
+            box.space.test:drop()
+        end
+    end)
+end)
+
+-- An update that changes one field without changing its size
+-- copies the old tuple and patches the field. Check that the
+-- result is the same as with a full rebuild of the tuple.
+g.test_patch = function(cg)
+    cg.server:exec(function()
+        local s = box.schema.space.create('test', {format = {
+            {'id', 'unsigned'}, {'cnt', 'unsigned'},
+            {'opt', 'integer', is_nullable = true}, {'data', 'string'},
+        }})
+        s:create_index('pk')
+        s:create_index('sk', {parts = {{'cnt'}, {'data'}}})
+        local long = string.rep('x', 300)
+        s:insert({1, 10, 0, 'a'})
+        s:insert({2, 10, 0, long, 'tail'})
+
+        t.assert_equals(s:update(1, {{'+', 2, 5}}), {1, 15, 0, 'a'})
+        t.assert_equals(s:update(2, {{'+', 2, 5}}), {2, 15, 0, long, 'tail'})
+        t.assert_equals(s:update(1, {{'=', 3, box.NULL}}),
+                        {1, 15, box.NULL, 'a'})
+        t.assert_equals(s:update(2, {{'=', 4, string.rep('y', 300)}}),
+                        {2, 15, 0, string.rep('y', 300), 'tail'})
+        t.assert_equals(s:update(2, {{'=', 5, 'TAIL'}}),
+                        {2, 15, 0, string.rep('y', 300), 'TAIL'})
+        t.assert_equals(s:update(1, {}), {1, 15, box.NULL, 'a'})
+        t.assert_equals(s.index.sk:select({15}, {iterator = 'eq'}),
+                        {{1, 15, box.NULL, 'a'},
+                         {2, 15, 0, string.rep('y', 300), 'TAIL'}})
+        t.assert_equals(s.index.sk:select({10}), {})
+        t.assert_equals(s:get(1).cnt, 15)
+
+        t.assert_error_msg_contains('expected unsigned, got integer',
+                                    s.update, s, 1, {{'=', 2, -1}})
+        t.assert_error_msg_contains('expected unsigned, got nil',
+                                    s.update, s, 1, {{'=', 2, box.NULL}})
+        t.assert_error_msg_contains('expected string, got unsigned',
+                                    s.update, s, 1, {{'=', 4, 1}})
+        t.assert_equals(s:get(1), {1, 15, box.NULL, 'a'})
+
+        box.begin()
+        s:update(1, {{'+', 2, 1}})
+        t.assert_equals(s:get(1), {1, 16, box.NULL, 'a'})
+        box.rollback()
+        t.assert_equals(s:get(1), {1, 15, box.NULL, 'a'})
+        t.assert_equals(s.index.sk:count({15}), 2)
+    end)
+end
@@ -0,0 +1,58 @@
+local server = require('test.luatest_helpers.server')
+local t = require('luatest')
+local g = t.group()
+
+g.before_all(function(cg)
+    cg.server = server:new({alias = 'master'})
+    cg.server:start()
+    cg.server:exec(function()
+        box.schema.user.grant('guest', 'execute', 'universe')
+        rawset(_G, 'echo', function(...) return ... end)
+    end)
+end)
+
+g.after_all(function(cg)
+    cg.server:drop()
+end)
+
+g.test_prepare_call = function(cg)
+    cg.server:exec(function()
+        local buffer = require('buffer')
+        local msgpack = require('msgpack')
+        local net = require('net.box')
+        local c = net.connect(box.cfg.listen)
+        local echo = c:prepare_call('echo')
+        t.assert_equals({echo({1, 'a'})}, {1, 'a'})
+        t.assert_equals({echo()}, {})
+        t.assert_equals({echo(msgpack.object({1, 2}))}, {1, 2})
+        t.assert_error_msg_contains('Use remote:call(func_name',
+                                    echo, 1, 2)
+        t.assert_error_msg_contains('Use remote:prepare_call(func_name',
+                                    c.prepare_call, c, 'echo', 1)
+
+        -- Options are given once and applied to every call.
+        local raw = c:prepare_call('echo', {return_raw = true})
+        local ret = raw({1, 2, 3})
+        t.assert(msgpack.is_object(ret))
+        t.assert_equals(ret:decode(), {1, 2, 3})
+        local async = c:prepare_call('echo', {is_async = true})
+        t.assert_equals(async({4, 5}):wait_result(), {4, 5})
+        local ibuf = buffer.ibuf()
+        local buffered = c:prepare_call('echo', {buffer = ibuf,
+                                                 skip_header = true})
+        t.assert_gt(buffered({6}), 0)
+        t.assert_equals(msgpack.decode(ibuf.rpos, ibuf:size()),
+                        {[0x30] = {6}})
+        ibuf:recycle()
+
+        -- Errors are raised as for usual calls.
+        local missing = c:prepare_call('missing')
+        t.assert_error_msg_content_equals(
+            "Procedure 'missing' is not defined", missing, {})
+
+        -- Local connection supports prepared calls, too.
+        echo = net.self:prepare_call('echo')
+        t.assert_equals({echo({1, 'a'})}, {1, 'a'})
+        c:close()
+    end)
+end
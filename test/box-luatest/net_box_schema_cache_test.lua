@@ -0,0 +1,64 @@
+local server = require('test.luatest_helpers.server')
+local t = require('luatest')
+local g = t.group()
+
+g.before_all(function(cg)
+    cg.server = server:new({alias = 'master'})
+    cg.server:start()
+    cg.server:exec(function()
+        box.schema.user.grant('guest', 'read,write', 'universe')
+        local s = box.schema.space.create('test')
+        s:create_index('pk')
+    end)
+end)
+
+g.after_all(function(cg)
+    cg.server:drop()
+end)
+
+g.test_schema_cache = function(cg)
+    cg.server:exec(function()
+        local net = require('net.box')
+        local function selects()
+            return box.stat().SELECT.total
+        end
+        local opts = {schema_cache = true}
+
+        -- The first connection fetches the schema.
+        local count = selects()
+        local c1 = net.connect(box.cfg.listen, opts)
+        t.assert_equals(c1.state, 'active')
+        t.assert_gt(selects(), count)
+
+        -- The second one takes it from the cache.
+        count = selects()
+        local c2 = net.connect(box.cfg.listen, opts)
+        t.assert_equals(c2.state, 'active')
+        t.assert_equals(selects(), count)
+        t.assert_equals(c2.space.test.id, box.space.test.id)
+        t.assert_equals(c2.space.test.connection, c2)
+
+        -- A connection without the option always fetches the schema.
+        count = selects()
+        local c3 = net.connect(box.cfg.listen)
+        t.assert_gt(selects(), count)
+        c3:close()
+
+        -- After DDL, the schema is fetched once.
+        box.schema.space.create('test2')
+        c1:ping()
+        t.helpers.retrying({}, function()
+            t.assert_not_equals(c1.space.test2, nil)
+        end)
+        count = selects()
+        c2:ping()
+        t.helpers.retrying({}, function()
+            t.assert_not_equals(c2.space.test2, nil)
+        end)
+        t.assert_equals(selects(), count)
+
+        c1:close()
+        c2:close()
+        box.space.test2:drop()
+    end)
+end
@@ -0,0 +1,63 @@
+local server = require('test.luatest_helpers.server')
+local t = require('luatest')
+local g = t.group()
+
+g.before_all(function(cg)
+    cg.server = server:new({alias = 'master'})
+    cg.server:start()
+    cg.server:exec(function()
+        local s = box.schema.space.create('test')
+        s:create_index('pk')
+        s:create_index('sk', {parts = {2, 'unsigned'}, unique = false})
+        for i = 1, 10 do
+            s:insert({i, i % 3})
+        end
+    end)
+end)
+
+g.after_all(function(cg)
+    cg.server:drop()
+end)
+
+g.test_pairs_prefetch = function(cg)
+    cg.server:exec(function()
+        local s = box.space.test
+        for _, prefetch in ipairs({1, 2, 3, 5, 10, 11, 1024}) do
+            local opts = {prefetch = prefetch}
+            t.assert_equals(s:pairs(nil, opts):totable(), s:select())
+            opts.iterator = 'GE'
+            t.assert_equals(s:pairs(4, opts):totable(),
+                            s:select(4, {iterator = 'GE'}))
+            opts.iterator = 'EQ'
+            t.assert_equals(s.index.sk:pairs(1, opts):totable(),
+                            s.index.sk:select(1))
+            t.assert_equals(s.index.sk:pairs(5, opts):totable(), {})
+        end
+    end)
+end
+
+g.test_pairs_prefetch_break = function(cg)
+    cg.server:exec(function()
+        local s = box.space.test
+        local res = {}
+        for _, tuple in s:pairs(nil, {prefetch = 4}) do
+            table.insert(res, tuple)
+            if #res == 6 then
+                break
+            end
+        end
+        t.assert_equals(res, s:select(nil, {limit = 6}))
+    end)
+end
+
+g.test_pairs_prefetch_invalid = function(cg)
+    cg.server:exec(function()
+        local s = box.space.test
+        local msg = "options parameter 'prefetch' should be an integer " ..
+                    "from 1 to 1024"
+        for _, prefetch in ipairs({0, -1, 1.5, 1025, 'x'}) do
+            t.assert_error_msg_equals(msg, s.pairs, s, nil,
+                                      {prefetch = prefetch})
+        end
+    end)
+end
@@ -0,0 +1,109 @@
+local server = require('test.luatest_helpers.server')
+local t = require('luatest')
+local g = t.group('prefix_iterator', {{engine = 'memtx'},
+                                      {engine = 'vinyl'}})
+
+g.before_all(function(cg)
+    cg.server = server:new({alias = 'master'})
+    cg.server:start()
+end)
+
+g.after_all(function(cg)
+    cg.server:drop()
+end)
+
+g.after_each(function(cg)
+    cg.server:exec(function()
+        if box.space.test ~= nil then
+            box.space.test:drop()
+        end
+    end)
+end)
+
+g.test_prefix = function(cg)
+    cg.server:exec(function(engine)
+        local s = box.schema.space.create('test', {engine = engine})
+        s:create_index('pk', {parts = {{1, 'string'}}})
+        s:create_index('sk', {parts = {{2, 'unsigned'}, {1, 'string'}}})
+        for _, k in ipairs({'ab', 'abc', 'abcd', 'abd', 'abc\0', 'b', ''}) do
+            s:insert({k, #k % 2})
+        end
+        local function keys(index, key)
+            local res = {}
+            for _, tuple in index:pairs(key, {iterator = 'prefix'}) do
+                table.insert(res, tuple[1])
+            end
+            return res
+        end
+        t.assert_equals(box.index.PREFIX, 12)
+        t.assert_equals(keys(s.index.pk, 'abc'), {'abc', 'abc\0', 'abcd'})
+        t.assert_equals(keys(s.index.pk, 'ab'),
+                        {'ab', 'abc', 'abc\0', 'abcd', 'abd'})
+        t.assert_equals(keys(s.index.pk, 'abe'), {})
+        t.assert_equals(keys(s.index.pk, 'c'), {})
+        t.assert_equals(#keys(s.index.pk, ''), 7)
+        t.assert_equals(keys(s.index.sk, {1, 'ab'}), {'abc', 'abd'})
+        t.assert_equals(keys(s.index.sk, {0, 'ab'}),
+                        {'ab', 'abc\0', 'abcd'})
+        t.assert_equals(s.index.pk:select('abc', {iterator = 'prefix',
+                                                  limit = 1}),
+                        {{'abc', 1}})
+    end, {cg.params.engine})
+end
+
+-- Vinyl reads key statements from the runs of a secondary index.
+-- Their fields are in the index part order, not at the field
+-- numbers of the parts.
+g.test_prefix_after_dump = function(cg)
+    cg.server:exec(function(engine)
+        local s = box.schema.space.create('test', {engine = engine})
+        s:create_index('pk', {parts = {{1, 'unsigned'}}})
+        s:create_index('sk', {parts = {{3, 'unsigned'}, {2, 'string'}}})
+        local keys = {'ab', 'abc', 'abd', 'b', 'abcd'}
+        for i, k in ipairs(keys) do
+            s:insert({i, k, i % 2})
+        end
+        box.snapshot()
+        local function select(key)
+            local res = {}
+            for _, tuple in s.index.sk:pairs(key, {iterator = 'prefix'}) do
+                table.insert(res, tuple[2])
+            end
+            return res
+        end
+        t.assert_equals(select({1, 'ab'}), {'ab', 'abcd', 'abd'})
+        t.assert_equals(select({0, 'ab'}), {'abc'})
+        t.assert_equals(select({1, 'abc'}), {'abcd'})
+        t.assert_equals(select({0, 'b'}), {'b'})
+        t.assert_equals(select({1, 'b'}), {})
+        t.assert_equals(#select({1, ''}), 3)
+    end, {cg.params.engine})
+end
+
+g.test_invalid_key = function(cg)
+    cg.server:exec(function(engine)
+        local s = box.schema.space.create('test', {engine = engine})
+        s:create_index('pk', {parts = {{1, 'unsigned'}}})
+        s:create_index('sk', {parts = {{2, 'string'}}, unique = false})
+        t.assert_error_msg_contains('PREFIX iterator requires a key',
+                                    s.index.sk.select, s.index.sk, {},
+                                    {iterator = 'prefix'})
+        t.assert_error_msg_contains('expected string',
+                                    s.index.sk.select, s.index.sk, {1},
+                                    {iterator = 'prefix'})
+        t.assert_error_msg_contains('does not support PREFIX iterator',
+                                    s.index.pk.select, s.index.pk, {1},
+                                    {iterator = 'prefix'})
+    end, {cg.params.engine})
+end
+
+g.test_unsupported_index = function(cg)
+    t.skip_if(cg.params.engine ~= 'memtx', 'memtx only')
+    cg.server:exec(function()
+        local s = box.schema.space.create('test')
+        s:create_index('pk', {type = 'hash', parts = {{1, 'string'}}})
+        t.assert_error_msg_contains('does not support requested iterator type',
+                                    s.index.pk.select, s.index.pk, {'a'},
+                                    {iterator = 'prefix'})
+    end)
+end
@@ -0,0 +1,125 @@
+local server = require('test.luatest_helpers.server')
+local t = require('luatest')
+local g = t.group()
+
+g.before_all(function(cg)
+    cg.server = server:new({alias = 'master'})
+    cg.server:start()
+    cg.server:exec(function()
+        local a = box.schema.space.create('a', {format = {
+            {'id', 'unsigned'}, {'value', 'string'},
+        }})
+        a:create_index('pk')
+        local b = box.schema.space.create('b')
+        b:create_index('pk', {parts = {2, 'unsigned'}})
+        local v = box.schema.space.create('v', {engine = 'vinyl'})
+        v:create_index('pk')
+    end)
+end)
+
+g.after_all(function(cg)
+    cg.server:drop()
+end)
+
+g.after_each(function(cg)
+    cg.server:exec(function()
+        box.space.a:truncate()
+        box.space.b:truncate()
+    end)
+end)
+
+g.test_read_view = function(cg)
+    cg.server:exec(function()
+        local a, b = box.space.a, box.space.b
+        for i = 1, 5 do
+            a:insert({i, tostring(i)})
+            b:insert({'x', 10 - i})
+        end
+        local rv = box.read_view.open({a, 'b'})
+        a:delete(1)
+        a:replace({2, 'two'})
+        a:insert({6, '6'})
+        b:truncate()
+        local res = {}
+        for _, tuple in rv:pairs('a') do
+            table.insert(res, {tuple.id, tuple.value})
+        end
+        t.assert_equals(res, {{1, '1'}, {2, '2'}, {3, '3'}, {4, '4'},
+                              {5, '5'}})
+        rv:close()
+        -- An iterator can be taken before the view is closed.
+        res = {}
+        t.assert_error_msg_equals('Read view is closed', rv.pairs, rv, b)
+        rv = box.read_view.open({b.id})
+        local gen, param, state = rv:pairs(b.id)
+        rv:close()
+        for _, tuple in gen, param, state do
+            table.insert(res, tuple)
+        end
+        t.assert_equals(res, {})
+    end)
+end
+
+g.test_read_view_order = function(cg)
+    cg.server:exec(function()
+        local b = box.space.b
+        for i = 1, 5 do
+            b:insert({'x', 10 - i})
+        end
+        local rv = box.read_view.open({b})
+        local res = {}
+        for _, tuple in rv:pairs(b) do
+            table.insert(res, tuple[2])
+        end
+        t.assert_equals(res, {5, 6, 7, 8, 9})
+        rv:close()
+    end)
+end
+
+g.test_read_view_vinyl = function(cg)
+    cg.server:exec(function()
+        local a, v = box.space.a, box.space.v
+        a:insert({1, 'a'})
+        v:insert({1})
+        v:insert({2})
+        local rv = box.read_view.open({a, v})
+        a:delete(1)
+        v:delete(1)
+        v:insert({3})
+        local res = {}
+        for _, tuple in rv:pairs(v) do
+            table.insert(res, tuple)
+        end
+        t.assert_equals(res, {{1}, {2}})
+        res = {}
+        for _, tuple in rv:pairs(a) do
+            table.insert(res, tuple)
+        end
+        t.assert_equals(res, {{1, 'a'}})
+        rv:close()
+        v:truncate()
+    end)
+end
+
+g.test_read_view_errors = function(cg)
+    cg.server:exec(function()
+        local a = box.space.a
+        t.assert_error_msg_equals("Space 'c' does not exist",
+                                  box.read_view.open, {'c'})
+        t.assert_error_msg_equals("a read view needs at least one space",
+                                  box.read_view.open, {})
+        t.assert_error_msg_equals("space 'a' is given twice",
+                                  box.read_view.open, {a, 'a'})
+        local rv = box.read_view.open({a})
+        t.assert_error_msg_equals(
+            string.format('space %d is not in the read view',
+                          box.space.b.id),
+            rv.pairs, rv, 'b')
+        rv:pairs(a)
+        t.assert_error_msg_equals(
+            string.format('space %d is already iterated in the read view',
+                          a.id),
+            rv.pairs, rv, a)
+        rv:close()
+    end)
+end
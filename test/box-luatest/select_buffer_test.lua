@@ -0,0 +1,83 @@
+local server = require('test.luatest_helpers.server')
+local t = require('luatest')
+local g = t.group('select_buffer', t.helpers.matrix({
+    engine = {'memtx', 'vinyl'},
+}))
+
+g.before_all(function(cg)
+    cg.server = server:new({alias = 'master'})
+    cg.server:start()
+    cg.server:exec(function(engine)
+        local s = box.schema.space.create('test', {engine = engine})
+        s:create_index('pk')
+        s:create_index('sk', {parts = {2, 'string'}, unique = false})
+        for i = 1, 100 do
+            s:insert({i, 'x' .. i % 10, string.rep('y', i)})
+        end
+    end, {cg.params.engine})
+end)
+
+g.after_all(function(cg)
+    cg.server:drop()
+end)
+
+g.test_select = function(cg)
+    cg.server:exec(function()
+        local buffer = require('buffer')
+        local msgpack = require('msgpack')
+        local s = box.space.test
+        local buf = buffer.ibuf()
+        local size = s:select({}, {buffer = buf, limit = 10, offset = 5})
+        t.assert_equals(size, buf:size())
+        t.assert_equals(msgpack.decode(buf.rpos, buf:size()),
+                        s:select({}, {limit = 10, offset = 5}))
+        -- Results are appended.
+        local old_size = buf:size()
+        size = s.index.sk:select('x5', {buffer = buf})
+        t.assert_equals(buf:size(), old_size + size)
+        local _, pos = msgpack.decode(buf.rpos, buf:size())
+        t.assert_equals(msgpack.decode(pos, size),
+                        s.index.sk:select('x5'))
+        -- A pointer to a buffer is accepted, too.
+        buf:reset()
+        local ptr = require('ffi').cast('struct ibuf *', buf)
+        size = s:select({1000}, {buffer = ptr})
+        t.assert_equals(size, 1)
+        t.assert_equals(msgpack.decode(buf.rpos, buf:size()), {})
+        -- The buffer can be iterated without decoding all of it.
+        buf:reset()
+        s:select({}, {buffer = buf, iterator = 'lt', limit = 3})
+        local it = msgpack.object_from_raw(buf.rpos, buf:size()):iterator()
+        t.assert_equals(it:decode_array_header(), 3)
+        t.assert_equals(it:take():decode()[1], 100)
+        it:skip()
+        t.assert_equals(it:decode()[1], 98)
+        t.assert_error_msg_equals(
+            "Illegal parameters, options parameter 'buffer' should be " ..
+            "of type ibuf", s.select, s, {}, {buffer = 'buf'})
+    end)
+end
+
+-- A selected buffer can be fed to the merger.
+g.test_merger = function(cg)
+    cg.server:exec(function()
+        local buffer = require('buffer')
+        local merger = require('merger')
+        local key_def = require('key_def')
+        local s = box.space.test
+        local buf1 = buffer.ibuf()
+        local buf2 = buffer.ibuf()
+        s:select({50}, {buffer = buf1, iterator = 'le', limit = 5})
+        s:select({100}, {buffer = buf2, iterator = 'le', limit = 5})
+        local kd = key_def.new({{fieldno = 1, type = 'unsigned'}})
+        local m = merger.new(kd, {
+            merger.new_source_frombuffer(buf1),
+            merger.new_source_frombuffer(buf2),
+        }, {reverse = true})
+        local res = {}
+        for _, tuple in m:pairs() do
+            table.insert(res, tuple[1])
+        end
+        t.assert_equals(res, {100, 99, 98, 97, 96, 50, 49, 48, 47, 46})
+    end)
+end
@@ -0,0 +1,67 @@
+local server = require('test.luatest_helpers.server')
+local t = require('luatest')
+local g = t.group('select_point_lookup', {{engine = 'memtx'},
+                                          {engine = 'vinyl'}})
+
+g.before_all(function(cg)
+    cg.server = server:new({alias = 'master'})
+    cg.server:start()
+end)
+
+g.after_all(function(cg)
+    cg.server:drop()
+end)
+
+g.after_each(function(cg)
+    cg.server:exec(function()
+        if box.space.test ~= nil then
+            box.space.test:drop()
+        end
+    end)
+end)
+
+-- A full-key EQ select from a unique index is served without
+-- an iterator. Check that it respects offset and limit.
+g.test_unique = function(cg)
+    cg.server:exec(function(engine)
+        local s = box.schema.space.create('test', {engine = engine})
+        s:create_index('pk')
+        s:create_index('sk', {parts = {{2, 'string'}, {3, 'unsigned'}}})
+        for i = 1, 10 do
+            s:insert({i, 'k' .. i % 3, i})
+        end
+        t.assert_equals(s:select({5}), {{5, 'k2', 5}})
+        t.assert_equals(s:select({5}, {iterator = 'req'}), {{5, 'k2', 5}})
+        t.assert_equals(s:select({11}), {})
+        t.assert_equals(s:select({5}, {limit = 0}), {})
+        t.assert_equals(s:select({5}, {offset = 1}), {})
+        t.assert_equals(s.index.sk:select({'k1', 4}), {{4, 'k1', 4}})
+        t.assert_equals(s.index.sk:select({'k1', 5}), {})
+        t.assert_equals(s.index.sk:select({'k1'}),
+                        {{1, 'k1', 1}, {4, 'k1', 4},
+                         {7, 'k1', 7}, {10, 'k1', 10}})
+        box.begin()
+        s:replace({5, 'k0', 50})
+        t.assert_equals(s:select({5}), {{5, 'k0', 50}})
+        t.assert_equals(s.index.sk:select({'k0', 50}), {{5, 'k0', 50}})
+        t.assert_equals(s.index.sk:select({'k2', 5}), {})
+        box.rollback()
+        t.assert_equals(s:select({5}), {{5, 'k2', 5}})
+    end, {cg.params.engine})
+end
+
+-- A unique nullable index may store many tuples with NULL in
+-- a key part, so an EQ select must return all of them.
+g.test_nullable = function(cg)
+    cg.server:exec(function(engine)
+        local s = box.schema.space.create('test', {engine = engine})
+        s:create_index('pk')
+        s:create_index('sk', {parts = {{2, 'unsigned', is_nullable = true}}})
+        s:insert({1, box.NULL})
+        s:insert({2, box.NULL})
+        s:insert({3, 30})
+        t.assert_equals(s.index.sk:select({box.NULL}),
+                        {{1, box.NULL}, {2, box.NULL}})
+        t.assert_equals(s.index.sk:select({30}), {{3, 30}})
+    end, {cg.params.engine})
+end
@@ -0,0 +1,110 @@
+local server = require('test.luatest_helpers.server')
+local t = require('luatest')
+local g = t.group()
+
+g.before_all(function(cg)
+    cg.server = server:new({alias = 'master'})
+    cg.server:start()
+end)
+
+g.after_all(function(cg)
+    cg.server:drop()
+end)
+
+g.after_each(function(cg)
+    cg.server:exec(function()
+        if box.space.test ~= nil then
+            box.space.test:drop()
+        end
+        if box.sequence.test ~= nil then
+            box.sequence.test:drop()
+        end
+    end)
+end)
+
+g.test_sequence_cache = function(cg)
+    cg.server:exec(function()
+        local seq = box.schema.sequence.create('test', {cache = 10})
+        local lsn = box.info.lsn
+        t.assert_equals(seq:next(), 1)
+        t.assert_equals(box.info.lsn, lsn + 1)
+        -- The first call reserves 10 values in one row.
+        t.assert_equals(box.space._sequence_data:get(seq.id), {seq.id, 10})
+        for i = 2, 10 do
+            t.assert_equals(seq:next(), i)
+            t.assert_equals(seq:current(), i)
+        end
+        t.assert_equals(box.info.lsn, lsn + 1)
+        t.assert_equals(seq:next(), 11)
+        t.assert_equals(box.info.lsn, lsn + 2)
+        t.assert_equals(box.space._sequence_data:get(seq.id), {seq.id, 20})
+
+        -- set() and reset() drop the reserved values.
+        seq:set(100)
+        t.assert_equals(seq:next(), 101)
+        seq:reset()
+        t.assert_equals(seq:next(), 1)
+
+        -- An explicit value in a space drops the values it overlaps.
+        local s = box.schema.space.create('test')
+        s:create_index('pk', {sequence = 'test'})
+        s:insert({5})
+
+        -- Reservation stops at the sequence limit.
+        seq:alter({max = 13})
+        t.assert_equals(seq:next(), 11)
+        t.assert_equals(box.space._sequence_data:get(seq.id), {seq.id, 13})
+        t.assert_equals(seq:next(), 12)
+        t.assert_equals(seq:next(), 13)
+        t.assert_error_msg_contains('Sequence \'test\' has overflowed',
+                                    seq.next, seq)
+    end)
+end
+
+g.test_sequence_cache_restart = function(cg)
+    cg.server:exec(function()
+        local seq = box.schema.sequence.create('test', {cache = 10})
+        t.assert_equals(seq:next(), 1)
+        t.assert_equals(seq:next(), 2)
+    end)
+    cg.server:stop()
+    cg.server:start()
+    cg.server:exec(function()
+        -- Values reserved but not used before the restart are skipped.
+        t.assert_equals(box.sequence.test:current(), 10)
+        t.assert_equals(box.sequence.test:next(), 11)
+    end)
+end
+
+-- Values reserved by a transaction are used only after it commits.
+-- Otherwise the values reserved by a rolled back one would have no
+-- WAL record and would be returned again after a restart.
+g.test_sequence_cache_rollback = function(cg)
+    cg.server:exec(function()
+        local seq = box.schema.sequence.create('test', {cache = 10})
+        box.begin()
+        t.assert_equals(seq:next(), 1)
+        box.rollback()
+        t.assert_equals(seq:next(), 11)
+        t.assert_equals(seq:next(), 12)
+        box.begin()
+        t.assert_equals(seq:next(), 13)
+        box.commit()
+        box.begin()
+        t.assert_equals(seq:next(), 14)
+        box.rollback()
+        t.assert_equals(seq:next(), 15)
+        box.begin()
+        seq:set(30)
+        t.assert_equals(seq:next(), 31)
+        box.commit()
+        local lsn = box.info.lsn
+        t.assert_equals(seq:next(), 32)
+        t.assert_equals(box.info.lsn, lsn)
+    end)
+    cg.server:stop()
+    cg.server:start()
+    cg.server:exec(function()
+        t.assert_equals(box.sequence.test:next(), 41)
+    end)
+end
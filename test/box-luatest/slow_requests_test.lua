@@ -0,0 +1,67 @@
+local server = require('test.luatest_helpers.server')
+local t = require('luatest')
+local g = t.group()
+
+g.before_all(function(cg)
+    cg.server = server:new({alias = 'master',
+                            box_cfg = {too_long_threshold = 0.05}})
+    cg.server:start()
+    cg.server:exec(function()
+        box.schema.user.grant('guest', 'super')
+        local s = box.schema.space.create('test')
+        s:create_index('pk')
+        rawset(_G, 'slow', function()
+            require('fiber').sleep(0.1)
+        end)
+    end)
+end)
+
+g.after_all(function(cg)
+    cg.server:drop()
+end)
+
+g.test_slow_requests = function(cg)
+    cg.server:exec(function()
+        local net = require('net.box')
+        box.stat.reset()
+        t.assert_equals(box.stat.slow_requests(), {})
+
+        local c = net.connect(box.cfg.listen)
+        c.space.test:replace({1, 'a'})
+        c.space.test:select({1})
+        c:call('slow')
+        c:eval('require("fiber").sleep(0.1)')
+
+        local log = box.stat.slow_requests()
+        t.assert_equals(#log, 2)
+        t.assert_equals(log[1].type, 'CALL')
+        t.assert_equals(log[1].key, '"slow"')
+        t.assert_equals(log[1].session_id, c:eval('return box.session.id()'))
+        t.assert_equals(log[2].type, 'EVAL')
+        t.assert_str_contains(log[2].key, 'sleep')
+        for _, r in ipairs(log) do
+            t.assert_ge(r.execution, 0.1)
+            t.assert_ge(r.total, r.queue + r.execution + r.reply - 1e-6)
+            t.assert_ge(r.yields, 1)
+            t.assert_equals(r.wal, 0)
+            t.assert_equals(r.limbo, 0)
+            t.assert_almost_equals(r.time, require('clock').time(), 10)
+        end
+        t.assert_le(log[1].time, log[2].time)
+
+        -- The threshold applies to the whole request.
+        box.cfg({too_long_threshold = 0})
+        c.space.test:replace({2, string.rep('x', 100)})
+        log = box.stat.slow_requests()
+        local r = log[#log]
+        t.assert_equals(r.type, 'REPLACE')
+        t.assert_equals(r.space_id, box.space.test.id)
+        t.assert_str_contains(r.key, '[2, "xxx')
+        t.assert_gt(r.wal, 0)
+        box.cfg({too_long_threshold = 0.05})
+
+        box.stat.reset()
+        t.assert_equals(box.stat.slow_requests(), {})
+        c:close()
+    end)
+end
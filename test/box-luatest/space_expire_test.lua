@@ -0,0 +1,109 @@
+local server = require('test.luatest_helpers.server')
+local t = require('luatest')
+local g = t.group()
+
+g.before_all(function(cg)
+    cg.server = server:new({alias = 'master'})
+    cg.server:start()
+end)
+
+g.after_all(function(cg)
+    cg.server:drop()
+end)
+
+g.after_each(function(cg)
+    cg.server:exec(function()
+        if box.space.test ~= nil then
+            box.space.test:drop()
+        end
+    end)
+end)
+
+g.test_expire = function(cg)
+    cg.server:exec(function()
+        local fiber = require('fiber')
+        local s = box.schema.space.create('test', {expire_field = 2})
+        s:create_index('pk')
+        local deleted = {}
+        s:on_replace(function(old, new)
+            if new == nil then
+                table.insert(deleted, old[1])
+            end
+        end)
+        local now = fiber.time()
+        for i = 1, 3000 do
+            s:insert({i, i % 2 == 0 and now - 1 or now + 3600})
+        end
+        -- Tuples without a numeric expiration time never expire.
+        s:insert({5000})
+        s:insert({5001, 'never'})
+        t.helpers.retrying({timeout = 10}, function()
+            t.assert_equals(s:count(), 1502)
+        end)
+        t.assert_equals(#deleted, 1500)
+        t.assert_equals(s:stat().expired, 1500)
+        t.assert_equals(s:get(1)[2], now + 3600)
+        t.assert_equals(s:get(2), nil)
+        t.assert_equals(s:get(5000), {5000})
+
+        -- The option may be set and dropped by alter.
+        s:alter({expire_field = 0})
+        s:insert({6000, now - 1})
+        fiber.sleep(1.5)
+        t.assert_equals(s:get(6000), {6000, now - 1})
+        s:alter({expire_field = 2})
+        t.assert_equals(s:stat().expired, 1500)
+        t.helpers.retrying({timeout = 10}, function()
+            t.assert_equals(s:get(6000), nil)
+        end)
+    end)
+end
+
+g.test_expire_vinyl = function(cg)
+    cg.server:exec(function()
+        t.assert_error_msg_contains(
+            'engine does not support expire_field',
+            box.schema.space.create, 'test',
+            {engine = 'vinyl', expire_field = 2})
+    end)
+end
+
+g.test_expire_index = function(cg)
+    cg.server:exec(function()
+        local fiber = require('fiber')
+        local s = box.schema.space.create('test', {expire_field = 2})
+        s:create_index('pk')
+        s:create_index('expire', {parts = {{2, 'number'}}, unique = false})
+        local now = fiber.time()
+        for i = 1, 5000 do
+            s:insert({i, i <= 2500 and now - i or now + 3600 + i})
+        end
+        t.helpers.retrying({timeout = 10}, function()
+            t.assert_equals(s:count(), 2500)
+        end)
+        t.assert_equals(s:stat().expired, 2500)
+        t.assert_equals(s.index.expire:min()[1], 2501)
+    end)
+end
+
+-- Decimal expiration times are ordered together with doubles in a
+-- 'number' index and expire as well.
+g.test_expire_index_decimal = function(cg)
+    cg.server:exec(function()
+        local decimal = require('decimal')
+        local fiber = require('fiber')
+        local s = box.schema.space.create('test', {expire_field = 2})
+        s:create_index('pk')
+        s:create_index('expire', {parts = {{2, 'number'}}, unique = false})
+        local now = fiber.time()
+        for i = 1, 200 do
+            local time = i <= 100 and now - i or now + 3600 + i
+            s:insert({i, i % 2 == 0 and decimal.new(time) or time})
+        end
+        t.helpers.retrying({timeout = 10}, function()
+            t.assert_equals(s:count(), 100)
+        end)
+        t.assert_equals(s:stat().expired, 100)
+        t.assert_equals(s.index.expire:min()[1], 101)
+    end)
+end
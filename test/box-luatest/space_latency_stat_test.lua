@@ -0,0 +1,82 @@
+local server = require('test.luatest_helpers.server')
+local t = require('luatest')
+local g = t.group('space_latency_stat', t.helpers.matrix({
+    engine = {'memtx', 'vinyl'},
+}))
+
+g.before_all(function(cg)
+    cg.server = server:new({alias = 'master'})
+    cg.server:start()
+end)
+
+g.after_all(function(cg)
+    cg.server:drop()
+end)
+
+g.after_each(function(cg)
+    cg.server:exec(function()
+        box.cfg({space_latency_stat = false})
+        box.stat.reset()
+        if box.space.test ~= nil then
+            box.space.test:drop()
+        end
+    end)
+end)
+
+g.test_cfg = function(cg)
+    cg.server:exec(function()
+        t.assert_equals(box.cfg.space_latency_stat, false)
+        t.assert_error_msg_contains(
+            "Incorrect value for option 'space_latency_stat'",
+            box.cfg, {space_latency_stat = 1})
+    end)
+end
+
+g.test_collect = function(cg)
+    cg.server:exec(function(engine)
+        local s = box.schema.space.create('test', {engine = engine})
+        s:create_index('pk')
+        s:create_index('sk', {parts = {2, 'unsigned'}, unique = false})
+
+        -- Nothing is collected by default.
+        s:insert({1, 10})
+        s:get({1})
+        t.assert_equals(box.stat.latency(), {})
+
+        box.cfg({space_latency_stat = true})
+        s:insert({2, 20})
+        s:replace({3, 30})
+        s:update({1}, {{'=', 2, 11}})
+        s:upsert({4, 40}, {{'=', 2, 41}})
+        s:delete({3})
+        s:get({1})
+        s.index.pk:select({2})
+        s.index.sk:select({11})
+        s.index.sk:select({}, {iterator = 'ge'})
+        for _ in s.index.sk:pairs() do end
+
+        local stat = box.stat.latency().test
+        for _, op in ipairs({'insert', 'replace', 'update',
+                             'upsert', 'delete'}) do
+            t.assert_equals(stat[op].count, 1, op)
+            t.assert_ge(stat[op].p999, stat[op].p50, op)
+        end
+        t.assert_equals(stat.index.pk.get.count, 2)
+        t.assert_equals(stat.index.pk.select, nil)
+        t.assert_equals(stat.index.sk.select.count, 2)
+        -- Three tuples and the end of the index.
+        t.assert_equals(stat.index.sk.next.count, 4)
+
+        -- Statistics survive alter.
+        s:format({{'a', 'unsigned'}, {'b', 'unsigned'}})
+        t.assert_equals(box.stat.latency().test.insert.count, 1)
+
+        box.cfg({space_latency_stat = false})
+        s:insert({5, 50})
+        t.assert_equals(box.stat.latency().test.insert.count, 1)
+
+        box.stat.reset()
+        t.assert_equals(box.stat.latency().test, {index = {pk = {},
+                                                           sk = {}}})
+    end, {cg.params.engine})
+end
@@ -0,0 +1,83 @@
+local server = require('test.luatest_helpers.server')
+local t = require('luatest')
+local g = t.group()
+
+g.before_all = function()
+    g.server = server:new({alias = 'master'})
+    g.server:start()
+end
+
+g.after_all = function()
+    g.server:drop()
+end
+
+g.after_each = function()
+    g.server:exec(function()
+        if box.space.test ~= nil then
+            box.space.test:drop()
+        end
+    end)
+end
+
+g.test_stat = function()
+    g.server:exec(function()
+        local s = box.schema.space.create('test')
+        s:create_index('pk')
+        local stat = s:stat()
+        t.assert_equals(stat.memory.tuples, 0)
+        t.assert_equals(stat.memory_quota, 0)
+        for i = 1, 100 do
+            s:insert({i, string.rep('x', 100)})
+        end
+        stat = s:stat()
+        t.assert_ge(stat.memory.tuples, s:bsize())
+        t.assert_equals(stat.memory.indexes, s.index.pk:bsize())
+        t.assert_equals(stat.memory.total,
+                        stat.memory.tuples + stat.memory.indexes)
+        s:truncate()
+        t.assert_equals(s:stat().memory.tuples, 0)
+    end)
+end
+
+g.test_quota = function()
+    g.server:exec(function()
+        local s = box.schema.space.create('test', {memory_quota = 64 * 1024})
+        s:create_index('pk')
+        t.assert_equals(s:stat().memory_quota, 64 * 1024)
+        local count = 0
+        local ok, err
+        repeat
+            count = count + 1
+            ok, err = pcall(s.insert, s, {count, string.rep('x', 1000)})
+        until not ok
+        t.assert_equals(err.code, box.error.SPACE_MEMORY_QUOTA)
+        t.assert_equals(err.message,
+                        "Space 'test' exceeds its memory quota of " ..
+                        "65536 bytes")
+        t.assert_le(s:stat().memory.total, 64 * 1024)
+        t.assert_equals(s:count(), count - 1)
+        -- Statements that don't grow the space are allowed.
+        s:replace({1, 'y'})
+        s:delete({2})
+        -- The quota can be changed.
+        s:alter({memory_quota = 0})
+        s:insert({count, string.rep('x', 1000)})
+        s:alter({memory_quota = 1024})
+        t.assert_error_msg_content_equals(
+            "Space 'test' exceeds its memory quota of 1024 bytes",
+            s.insert, s, {count + 1})
+        t.assert_error_msg_content_equals(
+            "Can't modify space 'test': " ..
+            "memory_quota must be non-negative",
+            s.alter, s, {memory_quota = -1})
+    end)
+end
+
+g.test_vinyl = function()
+    g.server:exec(function()
+        t.assert_error_msg_content_equals(
+            "Can't modify space 'test': engine does not support memory quota",
+            box.schema.space.create, 'test',
+            {engine = 'vinyl', memory_quota = 1024})
+    end)
+end
@@ -0,0 +1,67 @@
+local server = require('test.luatest_helpers.server')
+local t = require('luatest')
+local g = t.group()
+
+g.before_all(function(cg)
+    cg.server = server:new({alias = 'master'})
+    cg.server:start()
+    cg.server:exec(function()
+        local function create(name, count)
+            box.execute(string.format([[CREATE TABLE %s (id INT PRIMARY KEY,
+                                        a INT);]], name))
+            local s = box.space[name]
+            box.begin()
+            for i = 1, count do
+                s:insert({i, i})
+            end
+            box.commit()
+        end
+        create('S', 100)
+        create('M', 1000)
+        create('B', 20000)
+    end)
+end)
+
+g.after_all(function(cg)
+    cg.server:drop()
+end)
+
+local function plan(cg, sql)
+    return cg.server:exec(function(sql)
+        local res = box.execute('EXPLAIN QUERY PLAN ' .. sql)
+        local plan = {}
+        for _, row in ipairs(res.rows) do
+            table.insert(plan, row[4])
+        end
+        return plan
+    end, {sql})
+end
+
+-- Spaces smaller than 10240 tuples keep the extra cost of an
+-- automatic index, so a join of such spaces is still done with
+-- nested full scans.
+g.test_small_space = function(cg)
+    local sql = 'SELECT COUNT(*) FROM s, m WHERE s.a = m.a;'
+    local p = plan(cg, sql)
+    t.assert_equals(#p, 2)
+    for _, row in ipairs(p) do
+        t.assert_str_contains(row, 'SCAN TABLE')
+        t.assert_not_str_contains(row, 'EPHEMERAL INDEX')
+    end
+    t.assert_equals(cg.server:exec(function(sql)
+        return box.execute(sql).rows
+    end, {sql}), {{100}})
+end
+
+-- The automatic index of a big space costs as much as sorting the
+-- space, so it's chosen over nested full scans of the space.
+g.test_big_space = function(cg)
+    local sql = 'SELECT COUNT(*) FROM s, b WHERE s.a = b.a;'
+    local p = plan(cg, sql)
+    t.assert_equals(#p, 2)
+    t.assert_str_contains(p[1], 'SCAN TABLE S')
+    t.assert_str_contains(p[2], 'SEARCH TABLE B USING EPHEMERAL INDEX (A=?)')
+    t.assert_equals(cg.server:exec(function(sql)
+        return box.execute(sql).rows
+    end, {sql}), {{100}})
+end
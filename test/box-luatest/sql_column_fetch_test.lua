@@ -0,0 +1,41 @@
+local server = require('test.luatest_helpers.server')
+local t = require('luatest')
+local g = t.group()
+
+g.before_all(function(cg)
+    cg.server = server:new({alias = 'master'})
+    cg.server:start()
+end)
+
+g.after_all(function(cg)
+    cg.server:drop()
+end)
+
+-- Field offsets cached for one tuple must not leak to the next one.
+g.test_wide_tuples = function(cg)
+    cg.server:exec(function()
+        local NULL = box.NULL
+        local format = {}
+        for i = 1, 100 do
+            format[i] = {'F' .. i, 'unsigned', is_nullable = i > 1}
+        end
+        local s = box.schema.space.create('T', {format = format})
+        s:create_index('pk')
+        for i = 1, 10 do
+            local tuple = {}
+            for j = 1, 10 * i do
+                tuple[j] = i * 1000 + j
+            end
+            s:insert(tuple)
+        end
+        local res = box.execute([[SELECT F70, F3, F90, F65, F100, F66
+                                  FROM T ORDER BY F1 DESC;]])
+        t.assert_equals(res.rows[1], {10070, 10003, 10090, 10065, 10100,
+                                      10066})
+        t.assert_equals(res.rows[2], {9070, 9003, 9090, 9065, NULL, 9066})
+        t.assert_equals(res.rows[4], {7070, 7003, NULL, 7065, NULL, 7066})
+        t.assert_equals(res.rows[5], {NULL, 6003, NULL, NULL, NULL, NULL})
+        t.assert_equals(res.rows[10], {NULL, 1003, NULL, NULL, NULL, NULL})
+        s:drop()
+    end)
+end
@@ -0,0 +1,76 @@
+local server = require('test.luatest_helpers.server')
+local t = require('luatest')
+local g = t.group()
+
+g.before_all(function(cg)
+    cg.server = server:new({alias = 'master'})
+    cg.server:start()
+    cg.server:exec(function()
+        box.execute([[CREATE TABLE t (id INT PRIMARY KEY, a INT);]])
+        for i = 1, 10 do
+            box.execute([[INSERT INTO t VALUES (?, ?);]], {i, i})
+        end
+    end)
+end)
+
+g.after_all(function(cg)
+    cg.server:drop()
+end)
+
+-- EXPLAIN ANALYZE lists instructions with their execution counters.
+g.test_explain_analyze = function(cg)
+    cg.server:exec(function()
+        local sql = [[EXPLAIN ANALYZE SELECT * FROM t WHERE a > 5;]]
+        local res = box.execute(sql)
+        local names = {}
+        for _, col in ipairs(res.metadata) do
+            table.insert(names, col.name)
+        end
+        t.assert_equals(names, {'addr', 'opcode', 'p1', 'p2', 'p3', 'p4',
+                                'p5', 'comment', 'count', 'time', 'scanned',
+                                'returned'})
+        local explain, result_row
+        for _, row in ipairs(res.rows) do
+            t.assert_type(row[9], 'number')
+            t.assert_type(row[10], 'number')
+            t.assert(row[10] >= 0)
+            if row[2] == 'Explain' then
+                explain = row
+            elseif row[2] == 'ResultRow' then
+                result_row = row
+            else
+                t.assert_equals(row[11], nil)
+                t.assert_equals(row[12], nil)
+            end
+        end
+        t.assert_str_contains(explain[6], 'SCAN TABLE T')
+        -- The loop is started once, visits all rows and returns those
+        -- that match the condition.
+        t.assert_equals(explain[9], 1)
+        t.assert_equals(explain[11], 10)
+        t.assert_equals(explain[12], 5)
+        t.assert_equals(result_row[9], 5)
+
+        -- Counters are reset on every execution.
+        local stmt = box.prepare(sql)
+        local res1 = stmt:execute()
+        local res2 = stmt:execute()
+        stmt:unprepare()
+        for i, row in ipairs(res1.rows) do
+            t.assert_equals(res2.rows[i][9], row[9])
+        end
+    end)
+end
+
+-- EXPLAIN ANALYZE executes the statement.
+g.test_explain_analyze_dml = function(cg)
+    cg.server:exec(function()
+        local res = box.execute([[EXPLAIN ANALYZE INSERT INTO t
+                                  VALUES (11, 11);]])
+        t.assert_not_equals(#res.rows, 0)
+        t.assert_equals(box.space.T:get(11), {11, 11})
+        local _, err = box.execute([[EXPLAIN ANALYZE INSERT INTO t
+                                     VALUES (11, 11);]])
+        t.assert_str_contains(err.message, 'Duplicate key exists')
+    end)
+end
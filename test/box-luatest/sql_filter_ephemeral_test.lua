@@ -0,0 +1,47 @@
+local server = require('test.luatest_helpers.server')
+local t = require('luatest')
+local g = t.group()
+
+g.before_all(function(cg)
+    cg.server = server:new({alias = 'master'})
+    cg.server:start()
+    cg.server:exec(function()
+        box.execute([[CREATE TABLE t (id INT PRIMARY KEY, s STRING,
+                      b VARBINARY, n INT);]])
+        box.execute([[CREATE TABLE u (id INT PRIMARY KEY, s STRING);]])
+        for i = 1, 100 do
+            local s = string.rep(string.char(string.byte('a') + i % 26),
+                                 i % 10 + 1)
+            box.execute([[INSERT INTO t VALUES (?, ?, CAST(? AS VARBINARY),
+                                                ?);]],
+                        {i, s, s, i % 3 ~= 0 and i or box.NULL})
+            box.execute([[INSERT INTO u VALUES (?, ?);]], {i, s})
+        end
+    end)
+end)
+
+g.after_all(function(cg)
+    cg.server:drop()
+end)
+
+-- Columns fetched for filters are not copied, make sure the
+-- values returned to the user are still correct.
+g.test_filter = function(cg)
+    cg.server:exec(function()
+        local res = box.execute([[SELECT id, s FROM t
+                                  WHERE s > 'x' AND s < 'z' AND n IS NOT NULL
+                                  ORDER BY s LIMIT 3;]])
+        t.assert_equals(res.rows, {{23, 'xxxx'}, {49, 'xxxxxxxxxx'},
+                                   {50, 'y'}})
+        res = box.execute([[SELECT COUNT(*) FROM t WHERE n IS NULL;]])
+        t.assert_equals(res.rows, {{33}})
+        res = box.execute([[SELECT COUNT(*), MAX(u.s) FROM t, u
+                            WHERE t.s = u.s AND
+                            t.b = CAST(u.s AS VARBINARY);]])
+        t.assert_equals(res.rows, {{100, 'zzzzzzzz'}})
+        res = box.execute([[SELECT s, COUNT(*) FROM t WHERE s != 'a'
+                            GROUP BY s ORDER BY COUNT(*) DESC, s LIMIT 2;]])
+        t.assert_equals(#res.rows, 2)
+        t.assert_equals(res.rows[1][2], 1)
+    end)
+end
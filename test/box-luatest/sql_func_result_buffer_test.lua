@@ -0,0 +1,43 @@
+local server = require('test.luatest_helpers.server')
+local t = require('luatest')
+local g = t.group()
+
+g.before_all(function(cg)
+    cg.server = server:new({alias = 'master'})
+    cg.server:start()
+    cg.server:exec(function()
+        box.execute([[CREATE TABLE t (id INT PRIMARY KEY, s STRING,
+                      b VARBINARY);]])
+        for i = 1, 100 do
+            -- Lengths go up and down, so the result register buffer is
+            -- both reused and grown.
+            local s = string.rep(string.char(string.byte('a') + i % 26),
+                                 (i * 7) % 40 + 1) .. 'ß'
+            box.execute([[INSERT INTO t VALUES (?, ?, CAST(? AS VARBINARY));]],
+                        {i, s, s})
+        end
+    end)
+end)
+
+g.after_all(function(cg)
+    cg.server:drop()
+end)
+
+-- Results of UPPER(), LOWER(), HEX() and CHAR() are written to the
+-- buffer of the result register, make sure every row gets its own value.
+g.test_func_result_buffer = function(cg)
+    cg.server:exec(function()
+        local res = box.execute([[SELECT s, UPPER(s), LOWER(UPPER(s)), HEX(b),
+                                  CHAR(id, id + 1) FROM t;]])
+        t.assert_equals(#res.rows, 100)
+        for i, row in ipairs(res.rows) do
+            local s = row[1]
+            t.assert_equals(row[2], s:sub(1, -3):upper() .. 'SS')
+            t.assert_equals(row[3], s:sub(1, -3) .. 'ss')
+            t.assert_equals(row[4], (s:gsub('.', function(c)
+                return string.format('%02X', c:byte())
+            end)))
+            t.assert_equals(row[5], utf8.char(i, i + 1))
+        end
+    end)
+end
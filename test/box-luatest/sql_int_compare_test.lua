@@ -0,0 +1,31 @@
+local server = require('test.luatest_helpers.server')
+local t = require('luatest')
+local g = t.group()
+
+g.before_all(function(cg)
+    cg.server = server:new({alias = 'master'})
+    cg.server:start()
+end)
+
+g.after_all(function(cg)
+    cg.server:drop()
+end)
+
+g.test_int_compare = function(cg)
+    cg.server:exec(function()
+        local values = {-9223372036854775808LL, -1, 0, 1,
+                        9223372036854775807LL, 18446744073709551615ULL}
+        for i, a in ipairs(values) do
+            for j, b in ipairs(values) do
+                local res = box.execute([[SELECT ? < ?, ? <= ?, ? > ?,
+                                          ? >= ?, ? = ?, ? != ?;]],
+                                        {a, b, a, b, a, b, a, b, a, b, a, b})
+                t.assert_equals(res.rows[1], {i < j, i <= j, i > j, i >= j,
+                                              i == j, i ~= j})
+            end
+        end
+        t.assert_error_msg_content_equals(
+            "Type mismatch: can not convert any(1) to comparable type",
+            box.execute, [[SELECT CAST(1 AS ANY) < 2;]])
+    end)
+end
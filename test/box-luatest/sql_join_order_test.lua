@@ -0,0 +1,55 @@
+local server = require('test.luatest_helpers.server')
+local t = require('luatest')
+local g = t.group()
+
+g.before_all(function(cg)
+    cg.server = server:new({alias = 'master'})
+    cg.server:start()
+end)
+
+g.after_all(function(cg)
+    cg.server:drop()
+end)
+
+-- Spaces bigger than the default estimate are estimated by their
+-- real size, so a big space isn't scanned in the outer loop. The
+-- default is 2^20 tuples, so the test fills a space with more and
+-- is a long run one.
+g.test_big_space = function(cg)
+    cg.server:exec(function()
+        for _, name in ipairs({'B', 'S1', 'S2', 'S3'}) do
+            box.execute(string.format([[CREATE TABLE %s (id INT PRIMARY KEY,
+                                        a INT);]], name))
+        end
+        local N = 1100000
+        local s = box.space.B
+        box.begin()
+        for i = 1, N do
+            s:insert({i, i})
+            if i % 10000 == 0 then
+                box.commit()
+                box.begin()
+            end
+        end
+        box.commit()
+        for i = 1, 10 do
+            box.space.S1:insert({i, i})
+            box.space.S2:insert({i, i})
+            box.space.S3:insert({i, i})
+        end
+        local res = box.execute([[EXPLAIN QUERY PLAN
+            SELECT * FROM b, s1, s2, s3 WHERE b.id = s1.a AND
+            s1.id = s2.id AND s2.id = s3.id;]])
+        local plan = {}
+        for _, row in ipairs(res.rows) do
+            table.insert(plan, row[4])
+        end
+        t.assert_not_str_contains(plan[1], 'TABLE B ')
+        t.assert_items_include(plan,
+            {'SEARCH TABLE B USING PRIMARY KEY (ID=?) (~1 row)'})
+        res = box.execute([[SELECT COUNT(*) FROM b, s1, s2, s3
+                            WHERE b.id = s1.a AND s1.id = s2.id AND
+                            s2.id = s3.id;]])
+        t.assert_equals(res.rows, {{10}})
+    end)
+end
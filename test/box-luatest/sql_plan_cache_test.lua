@@ -0,0 +1,104 @@
+local server = require('test.luatest_helpers.server')
+local t = require('luatest')
+local g = t.group()
+
+g.before_all(function(cg)
+    cg.server = server:new({alias = 'master'})
+    cg.server:start()
+    cg.server:exec(function()
+        box.execute([[CREATE TABLE t (id INT PRIMARY KEY, a INT);]])
+        for i = 1, 10 do
+            box.execute([[INSERT INTO t VALUES (?, ?);]], {i, i * 10})
+        end
+    end)
+end)
+
+g.after_all(function(cg)
+    cg.server:drop()
+end)
+
+g.after_each(function(cg)
+    cg.server:exec(function()
+        box.cfg{sql_plan_cache_size = 5 * 1024 * 1024}
+    end)
+end)
+
+-- Statements executed by text are reused by later executions.
+g.test_hits = function(cg)
+    cg.server:exec(function()
+        local sql = [[SELECT a FROM t WHERE id = ?;]]
+        local stat = box.info.sql().plan_cache
+        for i = 1, 10 do
+            t.assert_equals(box.execute(sql, {i}).rows, {{i * 10}})
+        end
+        local new_stat = box.info.sql().plan_cache
+        t.assert_ge(new_stat.hits - stat.hits, 9)
+        t.assert_gt(new_stat.stmt_count, 0)
+        t.assert_gt(new_stat.size, 0)
+        -- Another text is compiled anew.
+        box.execute([[SELECT a FROM t WHERE id = ? + 0;]], {1})
+        t.assert_equals(box.info.sql().plan_cache.misses,
+                        new_stat.misses + 1)
+    end)
+end
+
+-- A cached statement is not used after the schema changes.
+g.test_schema_change = function(cg)
+    cg.server:exec(function()
+        local sql = [[SELECT * FROM t WHERE id = 1;]]
+        t.assert_equals(box.execute(sql).rows, {{1, 10}})
+        box.execute([[ALTER TABLE t ADD COLUMN b INT;]])
+        t.assert_equals(box.execute(sql).rows, {{1, 10, box.NULL}})
+        box.execute([[UPDATE t SET b = a + 1;]])
+        t.assert_equals(box.execute(sql).rows, {{1, 10, 11}})
+    end)
+end
+
+-- Session settings affecting compilation are a part of the key.
+g.test_session_settings = function(cg)
+    cg.server:exec(function()
+        local sql = [[SELECT t.a FROM t WHERE id = 1;]]
+        local name = box.execute(sql).metadata[1].name
+        t.assert_equals(name, 'A')
+        box.execute([[SET SESSION "sql_full_column_names" = true;]])
+        name = box.execute(sql).metadata[1].name
+        t.assert_equals(name, 'T.A')
+        box.execute([[SET SESSION "sql_full_column_names" = false;]])
+    end)
+end
+
+g.test_eviction = function(cg)
+    cg.server:exec(function()
+        box.cfg{sql_plan_cache_size = 4096}
+        local stat = box.info.sql().plan_cache
+        t.assert_le(stat.size, 4096)
+        for i = 1, 50 do
+            box.execute(string.format([[SELECT a + %d FROM t;]], i))
+        end
+        local new_stat = box.info.sql().plan_cache
+        t.assert_gt(new_stat.evictions, stat.evictions)
+        t.assert_le(new_stat.size, 4096)
+    end)
+end
+
+g.test_disable = function(cg)
+    cg.server:exec(function()
+        box.cfg{sql_plan_cache_size = 0}
+        local stat = box.info.sql().plan_cache
+        t.assert_equals(stat.size, 0)
+        t.assert_equals(stat.stmt_count, 0)
+        local sql = [[SELECT a FROM t WHERE id = 2;]]
+        t.assert_equals(box.execute(sql).rows, {{20}})
+        t.assert_equals(box.execute(sql).rows, {{20}})
+        t.assert_equals(box.info.sql().plan_cache, stat)
+    end)
+end
+
+g.test_cfg = function(cg)
+    cg.server:exec(function()
+        t.assert_error_msg_content_equals(
+            "Incorrect value for option 'sql_plan_cache_size': " ..
+            "must be non-negative",
+            box.cfg, {sql_plan_cache_size = -1})
+    end)
+end
@@ -0,0 +1,53 @@
+local server = require('test.luatest_helpers.server')
+local t = require('luatest')
+local g = t.group()
+
+g.before_all(function(cg)
+    cg.server = server:new({alias = 'master'})
+    cg.server:start()
+    cg.server:exec(function()
+        box.execute([[CREATE TABLE t (id INT PRIMARY KEY, s STRING);]])
+        box.begin()
+        for i = 1, 20000 do
+            box.space.T:insert({i, string.format('%05d', (i * 7919) % 20000)
+                               .. string.rep('x', 100)})
+        end
+        box.commit()
+    end)
+end)
+
+g.after_all(function(cg)
+    cg.server:drop()
+end)
+
+-- A big sort doesn't block other fibers.
+g.test_offload = function(cg)
+    cg.server:exec(function()
+        local fiber = require('fiber')
+        local count = 0
+        local f = fiber.new(function()
+            while true do
+                count = count + 1
+                fiber.yield()
+            end
+        end)
+        local res = box.execute([[SELECT s FROM t ORDER BY s;]])
+        f:cancel()
+        t.assert_gt(count, 0)
+        t.assert_equals(#res.rows, 20000)
+        for i = 2, #res.rows do
+            t.assert_lt(res.rows[i - 1][1], res.rows[i][1])
+        end
+    end)
+end
+
+-- The sort is done in the tx thread if the transaction can't yield.
+g.test_no_yield = function(cg)
+    cg.server:exec(function()
+        box.begin()
+        box.space.T:replace({1, '00000'})
+        local res = box.execute([[SELECT s FROM t ORDER BY s LIMIT 1;]])
+        t.assert_equals(res.rows, {{'00000'}})
+        box.rollback()
+    end)
+end
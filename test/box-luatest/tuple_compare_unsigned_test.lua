@@ -0,0 +1,66 @@
+local server = require('test.luatest_helpers.server')
+local t = require('luatest')
+local g = t.group()
+
+g.before_all = function()
+    g.server = server:new({alias = 'master'})
+    g.server:start()
+end
+
+g.after_all = function()
+    g.server:drop()
+end
+
+g.after_each = function()
+    g.server:exec(function()
+        if box.space.test ~= nil then
+            box.space.test:drop()
+        end
+    end)
+end
+
+-- Multipart sequential unsigned keys are compared several fields
+-- at a time while the fields are encoded as fixints. Check that
+-- mixing fixints and wider encodings doesn't break the order.
+g.test_sequential_unsigned_key_order = function()
+    g.server:exec(function()
+        local values = {0, 1, 126, 127, 128, 255, 256, 65535, 65536,
+                        4294967295, 4294967296, 18446744073709551615ULL}
+        local function less(a, b)
+            for i = 1, #a do
+                if a[i] ~= b[i] then
+                    return a[i] < b[i]
+                end
+            end
+            return false
+        end
+        local s = box.schema.space.create('test')
+        s:create_index('pk', {parts = {{1, 'unsigned'}, {2, 'unsigned'},
+                                       {3, 'unsigned'}}})
+        local expected = {}
+        for i = #values, 1, -1 do
+            for j = 1, #values do
+                for k = #values, 1, -1 do
+                    local tuple = {values[i], values[j], values[k]}
+                    s:insert(tuple)
+                    table.insert(expected, tuple)
+                end
+            end
+        end
+        table.sort(expected, less)
+        local actual = s:select()
+        t.assert_equals(#actual, #expected)
+        for i, tuple in ipairs(actual) do
+            t.assert_equals(tuple:totable(), expected[i])
+        end
+        local n = #values
+        for idx, v in ipairs(values) do
+            t.assert_equals(s:count({v}), n * n)
+            t.assert_equals(s:count({v, 127}), n)
+            -- Four values are less than 128.
+            t.assert_equals(s:count({128, v}, {iterator = 'lt'}),
+                            4 * n * n + (idx - 1) * n)
+            t.assert_equals(s:get({v, 128, 127}):totable(), {v, 128, 127})
+        end
+    end)
+end
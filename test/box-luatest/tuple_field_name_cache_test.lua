@@ -0,0 +1,86 @@
+local server = require('test.luatest_helpers.server')
+local t = require('luatest')
+local g = t.group()
+
+g.before_all(function(cg)
+    cg.server = server:new({alias = 'master'})
+    cg.server:start()
+end)
+
+g.after_all(function(cg)
+    cg.server:drop()
+end)
+
+g.after_each(function(cg)
+    cg.server:exec(function()
+        if box.space.test ~= nil then
+            box.space.test:drop()
+        end
+    end)
+end)
+
+-- The cached field number must not be used after the format changes.
+g.test_field_by_name_format_change = function(cg)
+    cg.server:exec(function()
+        local s = box.schema.space.create('test', {format = {
+            {'id', 'unsigned'}, {'a', 'any'}, {'b', 'any'},
+        }})
+        s:create_index('pk')
+        s:insert({1, 'x', 'y'})
+        local function get(key, name)
+            return s:get(key)[name]
+        end
+        for _ = 1, 3 do
+            t.assert_equals(get(1, 'a'), 'x')
+            t.assert_equals(get(1, 'b'), 'y')
+            t.assert_equals(get(1, 'c'), nil)
+        end
+        s:format({{'id', 'unsigned'}, {'b', 'any'}, {'c', 'any'}})
+        for _ = 1, 3 do
+            t.assert_equals(get(1, 'a'), nil)
+            t.assert_equals(get(1, 'b'), 'x')
+            t.assert_equals(get(1, 'c'), 'y')
+        end
+        -- Names that aren't fields still fall back to paths and methods.
+        t.assert_equals(s:get(1)['[2]'], 'x')
+        t.assert_equals(s:get(1):bsize(), s:get(1):bsize())
+    end)
+end
+
+g.test_field_by_name_many_formats = function(cg)
+    cg.server:exec(function()
+        local tuples = {}
+        for i = 1, 10 do
+            local format = {{'id', 'unsigned'}}
+            for j = 2, 10 do
+                format[j] = {'f' .. ((i + j) % 10), 'any'}
+            end
+            local s = box.schema.space.create('test' .. i, {format = format})
+            s:create_index('pk')
+            tuples[i] = s:insert({2, 3, 4, 5, 6, 7, 8, 9, 10})
+        end
+        for _ = 1, 3 do
+            for i = 1, 10 do
+                for j = 2, 10 do
+                    local name = 'f' .. ((i + j) % 10)
+                    t.assert_equals(tuples[i][name], j)
+                end
+            end
+        end
+        for i = 1, 10 do
+            box.space['test' .. i]:drop()
+        end
+    end)
+end
+
+g.test_tomap = function(cg)
+    cg.server:exec(function()
+        local s = box.schema.space.create('test', {format = {
+            {'a', 'unsigned'}, {'b', 'any'},
+        }})
+        s:create_index('pk')
+        local tuple = s:insert({1, {2}, 3})
+        t.assert_equals(tuple:tomap(), {1, {2}, 3, a = 1, b = {2}})
+        t.assert_equals(tuple:tomap({names_only = true}), {a = 1, b = {2}})
+    end)
+end
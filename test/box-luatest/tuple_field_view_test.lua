@@ -0,0 +1,56 @@
+local server = require('test.luatest_helpers.server')
+local t = require('luatest')
+local g = t.group()
+
+g.before_all(function(cg)
+    cg.server = server:new({alias = 'master'})
+    cg.server:start()
+end)
+
+g.after_all(function(cg)
+    cg.server:drop()
+end)
+
+g.test_field_view = function(cg)
+    cg.server:exec(function()
+        local ffi = require('ffi')
+        local long = string.rep('x', 300)
+        local huge = string.rep('y', 70000)
+        local tuple = box.tuple.new({1, -2, 1.5, 'abc', long, huge, true,
+                                     box.NULL, {1, 2}, {a = 1}})
+        t.assert_equals(tuple:field_view(1), 1)
+        t.assert_equals(tuple:field_view(2), -2)
+        t.assert_equals(tuple:field_view(3), 1.5)
+        for i, s in pairs({[4] = 'abc', [5] = long, [6] = huge}) do
+            local ptr, size = tuple:field_view(i)
+            t.assert_equals(type(ptr), 'cdata')
+            t.assert_equals(size, #s)
+            t.assert_equals(ffi.string(ptr, size), s)
+        end
+        t.assert_equals(tuple:field_view(7), true)
+        t.assert_equals(tuple:field_view(8), box.NULL)
+        t.assert_equals(tuple:field_view(9), {1, 2})
+        t.assert_equals(tuple:field_view(10), {a = 1})
+        t.assert_equals(tuple:field_view(11), nil)
+        t.assert_equals(box.tuple.field_view(tuple, 1), 1)
+        t.assert_error_msg_contains('Usage: tuple:field_view(fieldno)',
+                                    tuple.field_view, tuple, 'a')
+        t.assert_error_msg_contains('Usage: tuple:field_view(fieldno)',
+                                    box.tuple.field_view, {1}, 1)
+    end)
+end
+
+-- Binary fields are returned as views too.
+g.test_varbinary = function(cg)
+    cg.server:exec(function()
+        local ffi = require('ffi')
+        box.execute([[CREATE TABLE test (id INT PRIMARY KEY,
+                                         data VARBINARY);]])
+        box.execute([[INSERT INTO test VALUES (1, x'000102');]])
+        local s = box.space.TEST
+        local ptr, size = s:get(1):field_view(2)
+        t.assert_equals(size, 3)
+        t.assert_equals(ffi.string(ptr, size), '\0\1\2')
+        s:drop()
+    end)
+end
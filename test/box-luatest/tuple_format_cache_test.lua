@@ -0,0 +1,44 @@
+local server = require('test.luatest_helpers.server')
+local t = require('luatest')
+local g = t.group()
+
+g.before_all(function(cg)
+    cg.server = server:new({alias = 'master'})
+    cg.server:start()
+end)
+
+g.after_all(function(cg)
+    cg.server:drop()
+end)
+
+g.test_runtime_format_cache = function(cg)
+    cg.server:exec(function()
+        local format = {{name = 'cache_test_a', type = 'unsigned'},
+                        {name = 'cache_test_b', type = 'string'}}
+        local stat = box.stat.tuple_format()
+        local f = box.internal.new_tuple_format(format)
+        t.assert_equals(box.stat.tuple_format().count, stat.count + 1)
+
+        -- An unreferenced format stays registered in the cache.
+        f = nil -- luacheck: no unused
+        collectgarbage()
+        collectgarbage()
+        local stat2 = box.stat.tuple_format()
+        t.assert_equals(stat2.count, stat.count + 1)
+        t.assert_equals(stat2.cached, stat.cached + 1)
+
+        -- An equal format is taken from the cache.
+        f = box.internal.new_tuple_format(format)
+        local stat3 = box.stat.tuple_format()
+        t.assert_equals(stat3.count, stat2.count)
+        t.assert_equals(stat3.cached, stat2.cached - 1)
+        t.assert_equals(stat3.reused, stat2.reused + 1)
+
+        -- A different format is created anew.
+        format[2].type = 'unsigned'
+        local f2 = box.internal.new_tuple_format(format)
+        t.assert_equals(box.stat.tuple_format().count, stat3.count + 1)
+        t.assert_equals(box.stat.tuple_format().reused, stat3.reused)
+        t.assert_not_equals(f, f2)
+    end)
+end
@@ -0,0 +1,49 @@
+local server = require('test.luatest_helpers.server')
+local t = require('luatest')
+local g = t.group()
+
+g.before_all(function(cg)
+    cg.server = server:new({alias = 'master'})
+    cg.server:start()
+end)
+
+g.after_all(function(cg)
+    cg.server:drop()
+end)
+
+g.after_each(function(cg)
+    cg.server:exec(function()
+        if box.space.test ~= nil then
+            box.space.test:drop()
+        end
+    end)
+end)
+
+-- Keys of integer fields are hashed as one span of MsgPack. Check
+-- that tuples and keys get the same hash with any encoding width.
+g.test_integer_keys = function(cg)
+    cg.server:exec(function()
+        local s = box.schema.space.create('test')
+        s:create_index('pk', {type = 'hash',
+                              parts = {{1, 'integer'}, {2, 'unsigned'},
+                                       {3, 'integer'}, {4, 'unsigned'}}})
+        s:create_index('sk', {type = 'hash', parts = {{5, 'integer'}}})
+        local values = {0, 1, 127, 128, 65536, 4294967296, -1, -33, -129,
+                        -2147483649}
+        local n = 0
+        for i, v in ipairs(values) do
+            local u = math.abs(v) + i
+            s:insert({v, u, -v, u * 3, v * 10 - i})
+            n = n + 1
+        end
+        for i, v in ipairs(values) do
+            local u = math.abs(v) + i
+            t.assert_equals(s:get({v, u, -v, u * 3}),
+                            {v, u, -v, u * 3, v * 10 - i})
+            t.assert_equals(s.index.sk:get({v * 10 - i}),
+                            {v, u, -v, u * 3, v * 10 - i})
+            t.assert_equals(s:get({v, u, -v, u * 3 + 1}), nil)
+        end
+        t.assert_equals(s:len(), n)
+    end)
+end
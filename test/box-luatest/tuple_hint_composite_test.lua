@@ -0,0 +1,129 @@
+local server = require('test.luatest_helpers.server')
+local t = require('luatest')
+local g = t.group('tuple_hint_composite', t.helpers.matrix({
+    engine = {'memtx', 'vinyl'},
+}))
+
+g.before_all(function(cg)
+    cg.server = server:new({alias = 'master'})
+    cg.server:start()
+end)
+
+g.after_all(function(cg)
+    cg.server:drop()
+end)
+
+g.after_each(function(cg)
+    cg.server:exec(function()
+        if box.space.test ~= nil then
+            box.space.test:drop()
+        end
+    end)
+end)
+
+-- Keys with an integer first part get hints built from two parts.
+-- The first part is mapped exactly only in a limited range, so check
+-- the order around the range bounds and for the second parts of
+-- different types.
+g.test_order = function(cg)
+    cg.server:exec(function(engine)
+        local decimal = require('decimal')
+        local uuid = require('uuid')
+        local datetime = require('datetime')
+        local heads = {-9223372036854775808LL, -2^40, -8388609, -8388608,
+                       -8388607, -1, 0, 1, 8388606, 8388607, 8388608,
+                       2^40, 18446744073709551615ULL}
+        local tails = {
+            integer = {-2^52, -1e12, -1, 0, 1, 1700000000000,
+                       1700000000001, 2^52},
+            string = {'', 'a', 'abcdefgh', 'abcdefgi', 'b'},
+            number = {-1e300, -2^40, -1.5, 0, 0.5, 2^40, 2^40 + 0.5, 1e300},
+            decimal = {decimal.new('-1e30'), decimal.new('0.1'),
+                       decimal.new('0.2'), decimal.new('1e30')},
+            uuid = {uuid.fromstr('00000000-0000-0000-0000-000000000001'),
+                    uuid.fromstr('00000000-0000-0000-0000-000000000002'),
+                    uuid.fromstr('ffffffff-0000-0000-0000-000000000000')},
+            datetime = {datetime.new({timestamp = 0}),
+                        datetime.new({timestamp = 0, nsec = 1}),
+                        datetime.new({timestamp = 1700000000}),
+                        datetime.new({timestamp = 1700000001})},
+        }
+        for type, values in pairs(tails) do
+            local s = box.schema.space.create('test', {engine = engine})
+            s:create_index('pk', {parts = {{1, 'integer'}, {2, type}}})
+            local expected = {}
+            for i = #heads, 1, -1 do
+                for j = #values, 1, -1 do
+                    s:insert({heads[i], values[j]})
+                end
+            end
+            for i = 1, #heads do
+                for j = 1, #values do
+                    table.insert(expected, {heads[i], values[j]})
+                end
+            end
+            local actual = s:select()
+            t.assert_equals(#actual, #expected, type)
+            for i, tuple in ipairs(actual) do
+                t.assert_equals(tuple[1], expected[i][1], type)
+                t.assert_equals(tuple[2], expected[i][2], type)
+            end
+            for i = 1, #heads do
+                local found = s:select({heads[i]})
+                t.assert_equals(#found, #values, type)
+                for j = 1, #values do
+                    t.assert_equals(found[j][2], values[j], type)
+                    t.assert_equals(s:get({heads[i], values[j]})[2],
+                                    values[j], type)
+                end
+                t.assert_equals(s:count({heads[i]}, {iterator = 'lt'}),
+                                (i - 1) * #values, type)
+                t.assert_equals(s:count({heads[i]}, {iterator = 'le'}),
+                                i * #values, type)
+                t.assert_equals(s:count({heads[i]}, {iterator = 'gt'}),
+                                (#heads - i) * #values, type)
+            end
+            s:drop()
+        end
+    end, {cg.params.engine})
+end
+
+g.test_nullable = function(cg)
+    cg.server:exec(function(engine)
+        local s = box.schema.space.create('test', {engine = engine})
+        s:create_index('pk')
+        local sk = s:create_index('sk', {parts = {
+            {2, 'unsigned'}, {3, 'unsigned', is_nullable = true},
+        }})
+        s:insert({1, 5, 10})
+        s:insert({2, 5, box.NULL})
+        s:insert({3, 5})
+        s:insert({4, 5, 0})
+        s:insert({5, 4, 100})
+        t.assert_equals(sk:select({5}, {iterator = 'ge'}),
+                        {{2, 5, box.NULL}, {3, 5}, {4, 5, 0}, {1, 5, 10}})
+        t.assert_equals(sk:select({5, box.NULL}), {{2, 5, box.NULL}, {3, 5}})
+        t.assert_equals(sk:select({5, 0}, {iterator = 'gt'}), {{1, 5, 10}})
+    end, {cg.params.engine})
+end
+
+-- The hint layout doesn't depend on the type of the second part, so
+-- it can be altered without rebuild. The index must still be usable.
+g.test_alter = function(cg)
+    cg.server:exec(function(engine)
+        local s = box.schema.space.create('test', {engine = engine})
+        local pk = s:create_index('pk', {parts = {{1, 'unsigned'},
+                                                  {2, 'unsigned'}}})
+        for i = 1, 10 do
+            s:insert({1, i * 1000})
+        end
+        pk:alter({parts = {{1, 'unsigned'}, {2, 'number'}}})
+        s:insert({1, 1500.5})
+        t.assert_equals(pk:select({1, 1500}, {iterator = 'gt', limit = 2}),
+                        {{1, 1500.5}, {1, 2000}})
+        pk:alter({parts = {{1, 'integer'}, {2, 'number'}}})
+        t.assert_equals(pk:select({1, 1000}, {iterator = 'le'}),
+                        {{1, 1000}})
+        t.assert_equals(s:count(), 11)
+    end, {cg.params.engine})
+end
@@ -0,0 +1,111 @@
+local server = require('test.luatest_helpers.server')
+local t = require('luatest')
+local g = t.group()
+
+g.before_all(function(cg)
+    cg.server = server:new({alias = 'master',
+                            box_cfg = {memtx_use_mvcc_engine = true}})
+    cg.server:start()
+    cg.server:exec(function()
+        box.schema.user.grant('guest', 'read,write', 'universe')
+        local s = box.schema.space.create('test')
+        s:create_index('pk')
+        s:create_index('sk', {parts = {2, 'unsigned'}, unique = false})
+    end)
+end)
+
+g.after_all(function(cg)
+    cg.server:drop()
+end)
+
+g.after_each(function(cg)
+    cg.server:exec(function()
+        box.space.test:truncate()
+    end)
+end)
+
+g.test_snapshot = function(cg)
+    cg.server:exec(function()
+        local fiber = require('fiber')
+        local s = box.space.test
+        s:insert({1, 10})
+        s:insert({2, 20})
+
+        box.begin({isolation = 'read-only-snapshot'})
+        local f = fiber.new(function()
+            s:replace({1, 11})
+            s:delete({2})
+            s:insert({3, 30})
+        end)
+        f:set_joinable(true)
+        t.assert(f:join())
+
+        t.assert_equals(s:get({1}), {1, 10})
+        t.assert_equals(s:get({3}), nil)
+        t.assert_equals(s:select(), {{1, 10}, {2, 20}})
+        t.assert_equals(s.index.sk:select({15}, {iterator = 'GE'}),
+                        {{2, 20}})
+        t.assert_equals(s:count(), 2)
+
+        -- Nothing is tracked.
+        local stat = box.info.memtx().tx
+        t.assert_equals(stat.read_views, 1)
+        t.assert_equals(stat.trackers, {read = 0, point_holes = 0,
+                                        gaps = 0, full_scans = 0})
+
+        t.assert_error_msg_equals(
+            'Read-only snapshot transaction does not support writes',
+            s.insert, s, {4, 40})
+        box.commit()
+
+        t.assert_equals(s:select(), {{1, 11}, {3, 30}})
+    end)
+end
+
+g.test_begin_options = function(cg)
+    cg.server:exec(function()
+        local s = box.space.test
+        t.assert_error_msg_equals(
+            "isolation must be one of 'default', 'read-only-snapshot'",
+            box.begin, {isolation = 'serializable'})
+        t.assert_not(box.is_in_txn())
+
+        box.begin({isolation = 'default'})
+        s:insert({1, 10})
+        box.commit()
+        t.assert_equals(s:select(), {{1, 10}})
+
+        -- The isolation level can't be changed after the first statement.
+        local ffi = require('ffi')
+        box.begin()
+        s:get({1})
+        t.assert_equals(ffi.C.box_txn_set_isolation(1), -1)
+        t.assert_equals(box.error.last().code, box.error.ACTIVE_TRANSACTION)
+        box.commit()
+    end)
+end
+
+g.test_stream = function(cg)
+    cg.server:exec(function()
+        local net = require('net.box')
+        local s = box.space.test
+        s:insert({1, 10})
+
+        local c = net.connect(box.cfg.listen)
+        local stream = c:new_stream()
+        t.assert_error_msg_equals(
+            "isolation must be one of 'default', 'read-only-snapshot'",
+            stream.begin, stream, {isolation = 'foo'})
+        stream:begin({isolation = 'read-only-snapshot', timeout = 60})
+        local ss = stream.space.test
+        t.assert_equals(ss:select(), {{1, 10}})
+        s:replace({1, 11})
+        t.assert_equals(ss:get({1}), {1, 10})
+        t.assert_error_msg_equals(
+            'Read-only snapshot transaction does not support writes',
+            ss.insert, ss, {2, 20})
+        stream:commit()
+        t.assert_equals(ss:get({1}), {1, 11})
+        c:close()
+    end)
+end
@@ -0,0 +1,71 @@
+local server = require('test.luatest_helpers.server')
+local t = require('luatest')
+local g = t.group()
+
+g.before_all(function(cg)
+    cg.server = server:new({
+        alias = 'master',
+        box_cfg = {
+            memtx_use_mvcc_engine = true,
+            replication_synchro_quorum = 1,
+            replication_synchro_timeout = 1000,
+        },
+    })
+    cg.server:start()
+    cg.server:exec(function()
+        box.ctl.promote()
+        box.schema.user.grant('guest', 'super')
+        box.schema.space.create('sync', {is_sync = true})
+        box.space.sync:create_index('pk')
+    end)
+end)
+
+g.after_all(function(cg)
+    cg.server:drop()
+end)
+
+g.test_setting = function(cg)
+    cg.server:exec(function()
+        t.assert_equals(box.session.settings.txn_read_own_prepared, false)
+        t.assert_error_msg_contains(
+            "Session setting txn_read_own_prepared expected a value " ..
+            "of type boolean", function()
+                box.session.settings.txn_read_own_prepared = 1
+            end)
+        box.session.settings.txn_read_own_prepared = true
+        t.assert_equals(box.session.settings.txn_read_own_prepared, true)
+        box.session.settings.txn_read_own_prepared = false
+    end)
+end
+
+-- A session that opted in sees its synchronous writes waiting for the
+-- quorum. The other sessions don't.
+g.test_read_own_prepared = function(cg)
+    cg.server:exec(function()
+        local net = require('net.box')
+        local function select(c)
+            local res = {}
+            for _, tuple in ipairs(c.space.sync:select()) do
+                table.insert(res, tuple:totable())
+            end
+            return res
+        end
+        local c1 = net.connect(box.cfg.listen)
+        local c2 = net.connect(box.cfg.listen)
+        box.cfg{replication_synchro_quorum = 2}
+        local future = c1.space.sync:insert({1}, {is_async = true})
+        t.helpers.retrying({}, function()
+            t.assert_equals(box.info.synchro.queue.len, 1)
+        end)
+        t.assert_equals(select(c1), {})
+        c1:eval('box.session.settings.txn_read_own_prepared = true')
+        t.assert_equals(select(c1), {{1}})
+        t.assert_equals(select(c2), {})
+
+        box.cfg{replication_synchro_quorum = 1}
+        t.assert_equals(future:wait_result(10):totable(), {1})
+        t.assert_equals(select(c2), {{1}})
+        c1:close()
+        c2:close()
+    end)
+end
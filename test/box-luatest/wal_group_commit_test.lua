@@ -0,0 +1,58 @@
+local server = require('test.luatest_helpers.server')
+local t = require('luatest')
+local g = t.group()
+
+g.before_all = function()
+    g.server = server:new({alias = 'master',
+                           box_cfg = {wal_group_commit_timeout = 0.01}})
+    g.server:start()
+end
+
+g.after_all = function()
+    g.server:drop()
+end
+
+g.test_cfg = function()
+    g.server:exec(function()
+        t.assert_error_msg_content_equals(
+            "Incorrect value for option 'wal_group_commit_timeout': " ..
+            "value must be >= 0",
+            box.cfg, {wal_group_commit_timeout = -1})
+        t.assert_error_msg_content_equals(
+            "Incorrect value for option 'wal_group_commit_max_size': " ..
+            "value must be > 0",
+            box.cfg, {wal_group_commit_max_size = 0})
+        t.assert_error_msg_content_equals(
+            "Incorrect value for option 'wal_group_commit_max_entries': " ..
+            "value must be > 0",
+            box.cfg, {wal_group_commit_max_entries = 0})
+        box.cfg{wal_group_commit_max_entries = 100}
+        t.assert_equals(box.cfg.wal_group_commit_max_entries, 100)
+    end)
+end
+
+g.test_group_commit = function()
+    g.server:exec(function()
+        local fiber = require('fiber')
+        local s = box.schema.space.create('test')
+        s:create_index('pk')
+        box.stat.reset()
+        local fibers = {}
+        for i = 1, 100 do
+            local f = fiber.new(function() s:insert({i}) end)
+            f:set_joinable(true)
+            table.insert(fibers, f)
+        end
+        for _, f in ipairs(fibers) do
+            t.assert(f:join())
+        end
+        t.assert_equals(s:count(), 100)
+
+        local stat = box.stat.wal().group_commit
+        t.assert_le(stat.window, 0.01)
+        t.assert_gt(stat.batch_entries.total, 0)
+        t.assert_lt(stat.batch_entries.total, 100)
+        t.assert_equals(stat.batch_wait.total, stat.batch_entries.total)
+        s:drop()
+    end)
+end
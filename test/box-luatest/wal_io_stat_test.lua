@@ -0,0 +1,53 @@
+local server = require('test.luatest_helpers.server')
+local t = require('luatest')
+local g = t.group()
+
+g.before_all = function()
+    g.server = server:new({alias = 'master'})
+    g.server:start()
+end
+
+g.after_all = function()
+    g.server:drop()
+end
+
+g.test_wal_stat = function()
+    g.server:exec(function()
+        local s = box.schema.space.create('test')
+        s:create_index('pk')
+        box.stat.reset()
+        for i = 1, 10 do
+            s:insert({i, string.rep('x', 1000)})
+        end
+        local stat = box.stat.wal()
+        t.assert_equals(stat.write_size.total, 10)
+        t.assert_equals(stat.write_size.histogram.le_512, 0)
+        t.assert_equals(stat.write_size.histogram.le_1024, 0)
+        t.assert_equals(stat.write_size.histogram.le_4096, 10)
+        t.assert_equals(stat.write_time.total, 10)
+        t.assert_equals(stat.queue_size.total, 10)
+        t.assert_type(stat.fallocate_time.total, 'number')
+        box.stat.reset()
+        stat = box.stat.wal()
+        t.assert_equals(stat.write_size.total, 0)
+        t.assert_equals(stat.queue_size.total, 0)
+        s:drop()
+    end)
+end
+
+g.test_checkpoint_stat = function()
+    g.server:exec(function()
+        local s = box.schema.space.create('test')
+        s:create_index('pk')
+        for i = 1, 100 do
+            s:insert({i, string.rep('x', 1000)})
+        end
+        box.snapshot()
+        local stat = box.info.gc().checkpoint
+        t.assert_gt(stat.duration, 0)
+        t.assert_gt(stat.snap_size, 100 * 1000)
+        t.assert_gt(stat.snap_write_time, 0)
+        t.assert_gt(stat.snap_write_rate, 0)
+        s:drop()
+    end)
+end
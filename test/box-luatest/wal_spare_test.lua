@@ -0,0 +1,49 @@
+local server = require('test.luatest_helpers.server')
+local t = require('luatest')
+local g = t.group()
+
+g.before_all(function(cg)
+    cg.server = server:new({
+        alias = 'master',
+        box_cfg = {
+            wal_max_size = 1024 * 1024,
+        },
+    })
+    cg.server:start()
+end)
+
+g.after_all(function(cg)
+    cg.server:drop()
+end)
+
+g.test_spare = function(cg)
+    cg.server:exec(function()
+        local fio = require('fio')
+        local spare = fio.pathjoin(box.cfg.wal_dir, 'spare.xlog.inprogress')
+        local s = box.schema.space.create('test')
+        s:create_index('pk')
+        -- The spare file is prepared in background after rotation.
+        t.helpers.retrying({}, function()
+            t.assert(fio.path.exists(spare))
+        end)
+        -- It doesn't show up as an xlog and has no data.
+        t.assert_equals(fio.stat(spare).size, 0)
+        local xlogs = fio.glob(fio.pathjoin(box.cfg.wal_dir, '*.xlog'))
+        -- Force rotation: the spare is used for the new WAL and
+        -- then prepared again.
+        local data = string.rep('x', 1024)
+        for i = 1, 2000 do
+            s:insert({i, data})
+        end
+        t.assert_gt(#fio.glob(fio.pathjoin(box.cfg.wal_dir, '*.xlog')),
+                    #xlogs)
+        t.helpers.retrying({}, function()
+            t.assert(fio.path.exists(spare))
+        end)
+    end)
+    -- Data written to the reused files is recovered.
+    cg.server:restart()
+    cg.server:exec(function()
+        t.assert_equals(box.space.test:count(), 2000)
+    end)
+end)
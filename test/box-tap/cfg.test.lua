@@ -6,7 +6,7 @@ local socket = require('socket')
 local fio = require('fio')
 local uuid = require('uuid')
 local msgpack = require('msgpack')
-test:plan(109)
+test:plan(110)
 
 --------------------------------------------------------------------------------
 -- Invalid values
@@ -32,6 +32,7 @@ invalid('replication_sync_lag', -1)
 invalid('replication_sync_lag', 0)
 invalid('replication_sync_timeout', -1)
 invalid('replication_sync_timeout', 0)
+invalid('replication_ack_interval', -1)
 invalid('replication_connect_timeout', -1)
 invalid('replication_connect_timeout', 0)
 invalid('replication_connect_quorum', -1)
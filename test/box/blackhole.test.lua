@@ -75,6 +75,7 @@ vclock = test_run:get_vclock('default')
 test_run:wait_vclock('replica', vclock)
 test_run:cmd("switch replica")
 t
+box.space.test:stat()
 test_run:cmd('switch default')
 test_run:cmd("stop server replica")
 test_run:cmd("cleanup server replica")
@@ -2,6 +2,7 @@
 #include "module.h"
 
 #include <stdio.h>
+#include <stdlib.h>
 #include <msgpuck.h>
 
 int
@@ -290,3 +291,42 @@ test_return_mp(box_function_ctx_t *ctx, const char *args, const char *args_end)
 	rc = box_return_tuple(ctx, tuple);
 	return rc;
 }
+
+static int return_mp_ref_free_count = 0;
+
+static void
+return_mp_ref_free(void *arg)
+{
+	free(arg);
+	return_mp_ref_free_count++;
+}
+
+int
+test_return_mp_ref(box_function_ctx_t *ctx, const char *args,
+		   const char *args_end)
+{
+	(void) args;
+	(void) args_end;
+	const char *str = "123456789101112131415161718192021222324252627";
+	char *buf = malloc(mp_sizeof_str(strlen(str)));
+	if (buf == NULL)
+		return box_error_set(__FILE__, __LINE__, ER_PROC_C, "%s",
+				     "malloc failed");
+	char *pos = mp_encode_str(buf, str, strlen(str));
+	if (box_return_mp_ref(ctx, buf, pos, return_mp_ref_free, buf) != 0) {
+		free(buf);
+		return -1;
+	}
+	return 0;
+}
+
+int
+test_return_mp_ref_free_count(box_function_ctx_t *ctx, const char *args,
+			      const char *args_end)
+{
+	(void) args;
+	(void) args_end;
+	char buf[16];
+	char *pos = mp_encode_uint(buf, return_mp_ref_free_count);
+	return box_return_mp(ctx, buf, pos);
+}
@@ -283,6 +283,45 @@ box.schema.user.revoke('guest', 'super')
 
 box.schema.func.drop(name)
 
+--
+-- box_return_mp_ref() returns MessagePack without copying and
+-- releases it when the result is encoded.
+--
+name = 'function1.test_return_mp_ref'
+box.schema.func.create(name, {language = "C", exports = {'LUA'}})
+box.schema.func.create('function1.test_return_mp_ref_free_count', {language = "C", exports = {'LUA'}})
+free_count = box.func['function1.test_return_mp_ref_free_count']
+box.func[name]:call()
+free_count:call()
+box.schema.user.grant('guest', 'super')
+net:connect(box.cfg.listen):call(name)
+box.schema.user.revoke('guest', 'super')
+free_count:call()
+box.schema.func.drop(name)
+box.schema.func.drop('function1.test_return_mp_ref_free_count')
+
+--
+-- Threadsafe C functions are executed in a worker thread.
+--
+box.schema.func.create('threadsafe', {body = "function() end", opts = {is_threadsafe = true}})
+box.schema.func.create('function1.args', {language = "C", is_threadsafe = true, exports = {'LUA'}})
+box.space._func.index.name:get('function1.args').opts
+box.func['function1.args']:call()
+box.schema.func.drop('function1.args')
+name = 'function1.test_return_mp_ref'
+box.schema.func.create(name, {language = "C", is_threadsafe = true, exports = {'LUA'}})
+box.schema.func.create('function1.test_return_mp_ref_free_count', {language = "C", exports = {'LUA'}})
+free_count = box.func['function1.test_return_mp_ref_free_count']
+n = free_count:call()
+box.func[name]:call()
+free_count:call() - n
+box.schema.user.grant('guest', 'super')
+net:connect(box.cfg.listen):call(name)
+box.schema.user.revoke('guest', 'super')
+free_count:call() - n
+box.schema.func.drop(name)
+box.schema.func.drop('function1.test_return_mp_ref_free_count')
+
 --
 -- gh-4182: Introduce persistent Lua functions.
 --
@@ -0,0 +1,112 @@
+local t = require('luatest')
+local cluster = require('test.luatest_helpers.cluster')
+local helpers = require('test.luatest_helpers')
+
+local g = t.group()
+
+g.before_all(function(cg)
+    cg.cluster = cluster:new({})
+    cg.master = cg.cluster:build_server({
+        alias = 'master',
+        box_cfg = {
+            replication = {helpers.instance_uri('master')},
+            replication_timeout = 5,
+            replication_synchro_timeout = 120,
+        },
+    })
+    cg.replica = cg.cluster:build_server({
+        alias = 'replica',
+        box_cfg = {
+            replication = {helpers.instance_uri('master')},
+            replication_timeout = 5,
+            replication_ack_interval = 0.5,
+            read_only = true,
+        },
+    })
+    cg.cluster:add_server(cg.master)
+    cg.cluster:add_server(cg.replica)
+    cg.cluster:start()
+    cg.master:exec(function()
+        box.schema.space.create('test')
+        box.space.test:create_index('pk')
+        box.schema.space.create('sync', {is_sync = true})
+        box.space.sync:create_index('pk')
+    end)
+    local vclock = cg.master:exec(function()
+        local vclock = box.info.vclock
+        vclock[0] = nil
+        return vclock
+    end)
+    cg.replica:exec(function(vclock)
+        box.ctl.wait_vclock(vclock, 10)
+    end, {vclock})
+end)
+
+g.after_all(function(cg)
+    cg.cluster:drop()
+end)
+
+g.test_cfg = function(cg)
+    cg.replica:exec(function()
+        t.assert_equals(box.cfg.replication_ack_interval, 0.5)
+        t.assert_error_msg_contains(
+            "Incorrect value for option 'replication_ack_interval'",
+            box.cfg, {replication_ack_interval = -1})
+    end)
+end
+
+-- Acks for asynchronous transactions arrive, but in fewer messages
+-- than WAL writes.
+g.test_async = function(cg)
+    local replica_id = cg.replica:exec(function() return box.info.id end)
+    cg.master:exec(function(replica_id)
+        local fiber = require('fiber')
+        local function acked_lsn()
+            local info = box.info.replication[replica_id]
+            return info.downstream.vclock[box.info.id] or 0
+        end
+        local updates = 0
+        local lsn = acked_lsn()
+        local f = fiber.new(function()
+            while true do
+                local new_lsn = acked_lsn()
+                if new_lsn ~= lsn then
+                    updates = updates + 1
+                    lsn = new_lsn
+                end
+                fiber.sleep(0.01)
+            end
+        end)
+        for i = 1, 20 do
+            box.space.test:replace({i})
+            fiber.sleep(0.01)
+        end
+        t.helpers.retrying({timeout = 10}, function()
+            t.assert_equals(acked_lsn(), box.info.lsn)
+        end)
+        f:cancel()
+        t.assert_lt(updates, 20)
+        t.assert_equals(box.info.replication[replica_id].downstream.status,
+                        'follow')
+    end, {replica_id})
+end
+
+-- Acks for synchronous transactions aren't delayed.
+g.test_sync = function(cg)
+    cg.replica:exec(function()
+        box.cfg{replication_ack_interval = 60}
+    end)
+    cg.master:exec(function()
+        local clock = require('clock')
+        box.cfg{replication_synchro_quorum = 2}
+        local start = clock.monotonic()
+        for i = 1, 5 do
+            box.space.sync:replace({i})
+        end
+        t.assert_lt(clock.monotonic() - start, 4)
+        box.cfg{replication_synchro_quorum = 1}
+    end)
+    cg.replica:exec(function()
+        box.cfg{replication_ack_interval = 0.5}
+    end)
+end
@@ -0,0 +1,58 @@
+local t = require('luatest')
+local cluster = require('test.luatest_helpers.cluster')
+local helpers = require('test.luatest_helpers')
+
+local g = t.group()
+
+g.before_all(function(cg)
+    cg.cluster = cluster:new({})
+    cg.master = cg.cluster:build_server({
+        alias = 'master',
+        box_cfg = {
+            replication = {helpers.instance_uri('master')},
+            replication_timeout = 0.1,
+        },
+    })
+    cg.replica = cg.cluster:build_server({
+        alias = 'replica',
+        box_cfg = {
+            replication = {helpers.instance_uri('master')},
+            replication_timeout = 0.1,
+            read_only = true,
+        },
+    })
+    cg.cluster:add_server(cg.master)
+    cg.cluster:add_server(cg.replica)
+    cg.cluster:start()
+    cg.master:exec(function()
+        box.schema.space.create('test')
+        box.space.test:create_index('pk')
+    end)
+end)
+
+g.after_all(function(cg)
+    cg.cluster:drop()
+end)
+
+-- Small transactions received by the applier while catching up
+-- are not written to WAL one by one: they share WAL batches.
+g.test_catch_up = function(cg)
+    local count = 1000
+    cg.replica:stop()
+    local vclock = cg.master:exec(function(count)
+        for i = 1, count do
+            box.space.test:insert({i})
+        end
+        local vclock = box.info.vclock
+        vclock[0] = nil
+        return vclock
+    end, {count})
+    cg.replica:start()
+    cg.replica:exec(function(vclock, count)
+        box.ctl.wait_vclock(vclock, 10)
+        t.assert_equals(box.space.test:count(), count)
+        local stat = box.stat.wal().group_commit
+        t.assert_gt(stat.batch_entries.total, 0)
+        t.assert_lt(stat.batch_entries.total, count)
+    end, {vclock, count})
+end
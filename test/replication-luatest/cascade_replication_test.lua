@@ -0,0 +1,89 @@
+local t = require('luatest')
+local cluster = require('test.luatest_helpers.cluster')
+local helpers = require('test.luatest_helpers')
+
+local g = t.group()
+
+g.before_all(function(cg)
+    cg.cluster = cluster:new({})
+    cg.master = cg.cluster:build_server({
+        alias = 'master',
+        box_cfg = {
+            replication = {helpers.instance_uri('master')},
+            replication_timeout = 0.1,
+        },
+    })
+    cg.middle = cg.cluster:build_server({
+        alias = 'middle',
+        box_cfg = {
+            replication = {helpers.instance_uri('master')},
+            replication_timeout = 0.1,
+            read_only = true,
+        },
+    })
+    cg.edge = cg.cluster:build_server({
+        alias = 'edge',
+        box_cfg = {
+            replication = {helpers.instance_uri('middle')},
+            replication_timeout = 0.1,
+            replication_anon = true,
+            read_only = true,
+        },
+    })
+    cg.cluster:add_server(cg.master)
+    cg.cluster:add_server(cg.middle)
+    cg.cluster:start()
+    cg.master:exec(function()
+        box.schema.space.create('test')
+        box.space.test:create_index('pk')
+        box.schema.space.create('seq')
+        box.space.seq:create_index('pk', {sequence = true})
+    end)
+    cg.edge:start()
+end)
+
+g.after_all(function(cg)
+    cg.cluster:drop()
+    cg.edge:drop()
+end)
+
+local function wait_edge(cg)
+    local vclock = cg.master:exec(function()
+        local vclock = box.info.vclock
+        vclock[0] = nil
+        return vclock
+    end)
+    cg.edge:exec(function(vclock)
+        box.ctl.wait_vclock(vclock, 10)
+    end, {vclock})
+end
+
+-- Rows received by a cascading replica are relayed downstream
+-- as they are written to its WAL, including the changes made by
+-- its own triggers.
+g.test_cascade = function(cg)
+    cg.middle:exec(function()
+        t.helpers.retrying({}, function()
+            t.assert_not_equals(box.space.test, nil)
+        end)
+        box.space.test:before_replace(function(_, new)
+            if new ~= nil and new[2] == 'change' then
+                return new:update({{'=', 2, 'changed'}})
+            end
+        end)
+    end)
+    cg.master:exec(function()
+        box.space.test:insert({1, 'keep'})
+        box.space.test:insert({2, 'change'})
+        box.space.test:upsert({3, 'upsert'}, {{'=', 2, 'upsert'}})
+        box.space.test:update({1}, {{'=', 2, 'update'}})
+        box.space.test:delete({3})
+        box.space.seq:insert({box.NULL, 'seq'})
+    end)
+    wait_edge(cg)
+    cg.edge:exec(function()
+        t.assert_equals(box.space.test:select(),
+                        {{1, 'update'}, {2, 'changed'}})
+        t.assert_equals(box.space.seq:select(), {{1, 'seq'}})
+    end)
+end
@@ -0,0 +1,64 @@
+local t = require('luatest')
+local cluster = require('test.luatest_helpers.cluster')
+local helpers = require('test.luatest_helpers')
+
+local g = t.group('lag_stat')
+
+g.before_all(function(cg)
+    cg.cluster = cluster:new({})
+
+    local box_cfg = {
+        replication_timeout = 0.1,
+    }
+    cg.master = cg.cluster:build_server({alias = 'master', box_cfg = box_cfg})
+
+    local box_cfg = {
+        replication         = {
+            helpers.instance_uri('master'),
+        },
+        replication_timeout = 0.1,
+        read_only           = true,
+    }
+    cg.replica = cg.cluster:build_server({alias = 'replica', box_cfg = box_cfg})
+
+    cg.cluster:add_server(cg.master)
+    cg.cluster:add_server(cg.replica)
+    cg.cluster:start()
+end)
+
+g.after_all(function(cg)
+    cg.cluster.servers = nil
+    cg.cluster:drop()
+end)
+
+g.test_lag_stat = function(cg)
+    cg.master:exec(function()
+        local s = box.schema.space.create('test')
+        s:create_index('pk')
+        for i = 1, 100 do
+            s:insert({i})
+        end
+    end)
+    local vclock = helpers:get_vclock(cg.master)
+    vclock[0] = nil
+    helpers:wait_vclock(cg.replica, vclock)
+
+    cg.replica:exec(function()
+        local t = require('luatest')
+        local stat = box.info.replication[1].upstream.lag_stat
+        for _, stage in ipairs({'recv', 'wal'}) do
+            t.assert_ge(stat[stage].p50, 0, stage)
+            t.assert_ge(stat[stage].p99, stat[stage].p50, stage)
+            t.assert_lt(stat[stage].p99, 10, stage)
+        end
+    end)
+    t.helpers.retrying({}, function()
+        cg.master:exec(function()
+            local t = require('luatest')
+            local stat = box.info.replication[2].downstream.lag_stat
+            t.assert_gt(stat.ack.p99, 0)
+            t.assert_ge(stat.ack.p99, stat.send.p50)
+            t.assert_lt(stat.ack.p99, 10)
+        end)
+    end)
+end
@@ -0,0 +1,129 @@
+local t = require('luatest')
+local cluster = require('test.luatest_helpers.cluster')
+local helpers = require('test.luatest_helpers')
+
+local g = t.group('parallel_apply', {{engine = 'memtx'}, {engine = 'vinyl'}})
+
+g.before_each(function(cg)
+    local engine = cg.params.engine
+
+    cg.cluster = cluster:new({})
+
+    local box_cfg = {
+        replication_timeout = 0.1,
+    }
+    cg.master = cg.cluster:build_server({alias = 'master', engine = engine,
+                                         box_cfg = box_cfg})
+
+    local box_cfg = {
+        replication         = {
+            helpers.instance_uri('master'),
+        },
+        replication_timeout = 0.1,
+        replication_apply_fibers = 4,
+        read_only           = true,
+    }
+    cg.replica = cg.cluster:build_server({alias = 'replica', engine = engine,
+                                          box_cfg = box_cfg})
+
+    cg.cluster:add_server(cg.master)
+    cg.cluster:add_server(cg.replica)
+    cg.cluster:start()
+
+    cg.master:exec(function(engine)
+        for i = 1, 4 do
+            local s = box.schema.space.create('test' .. i, {engine = engine})
+            s:create_index('pk')
+        end
+    end, {engine})
+end)
+
+g.after_each(function(cg)
+    cg.cluster.servers = nil
+    cg.cluster:drop()
+end)
+
+local function wait_replica(cg)
+    local vclock = helpers:get_vclock(cg.master)
+    vclock[0] = nil
+    helpers:wait_vclock(cg.replica, vclock)
+end
+
+g.test_parallel_apply = function(cg)
+    cg.master:exec(function()
+        local fiber = require('fiber')
+        local fibers = {}
+        for i = 1, 4 do
+            local f = fiber.new(function()
+                local s = box.space['test' .. i]
+                for j = 1, 1000 do
+                    s:replace({j, i})
+                    if j % 100 == 0 then
+                        box.begin()
+                        s:delete({j})
+                        s:replace({j, -i})
+                        box.commit()
+                    end
+                end
+            end)
+            f:set_joinable(true)
+            table.insert(fibers, f)
+        end
+        for _, f in ipairs(fibers) do
+            f:join()
+        end
+    end)
+    wait_replica(cg)
+    local expected = cg.master:exec(function()
+        local data = {}
+        for i = 1, 4 do
+            data[i] = box.space['test' .. i]:select()
+        end
+        return data
+    end)
+    cg.replica:exec(function(expected)
+        local t = require('luatest')
+        for i = 1, 4 do
+            t.assert_equals(box.space['test' .. i]:select(), expected[i])
+        end
+        local upstream = box.info.replication[1].upstream
+        t.assert_equals(upstream.status, 'follow')
+        t.assert_equals(upstream.apply_queue, 0)
+    end, {expected})
+end
+
+g.test_switch_mode = function(cg)
+    cg.master:exec(function()
+        for j = 1, 100 do
+            box.space.test1:replace({j})
+        end
+    end)
+    cg.replica:exec(function()
+        box.cfg{replication_apply_fibers = 1}
+    end)
+    cg.master:exec(function()
+        for j = 1, 100 do
+            box.space.test2:replace({j})
+            box.space.test1:delete({j})
+        end
+    end)
+    wait_replica(cg)
+    cg.replica:exec(function()
+        local t = require('luatest')
+        t.assert_equals(box.space.test1:count(), 0)
+        t.assert_equals(box.space.test2:count(), 100)
+        t.assert_equals(box.info.replication[1].upstream.status, 'follow')
+    end)
+end
+
+g.test_cfg = function(cg)
+    cg.replica:exec(function()
+        local t = require('luatest')
+        local msg = "Incorrect value for option 'replication_apply_fibers': " ..
+                    "the value must be in range [1, 64]"
+        t.assert_error_msg_content_equals(msg, box.cfg,
+                                          {replication_apply_fibers = 0})
+        t.assert_error_msg_content_equals(msg, box.cfg,
+                                          {replication_apply_fibers = 65})
+    end)
+end
@@ -0,0 +1,53 @@
+local server = require('test.luatest_helpers.server')
+local t = require('luatest')
+local g = t.group()
+
+g.before_all(function(cg)
+    cg.server = server:new({
+        alias = 'master',
+        box_cfg = {replication_synchro_quorum = 1},
+    })
+    cg.server:start()
+    cg.server:exec(function()
+        box.ctl.promote()
+        box.schema.space.create('sync', {is_sync = true})
+        box.space.sync:create_index('pk')
+    end)
+end)
+
+g.after_all(function(cg)
+    cg.server:drop()
+end)
+
+-- Quorum advances that happen while a CONFIRM is being written
+-- are covered by a single CONFIRM.
+g.test_confirm_batch = function(cg)
+    cg.server:exec(function()
+        local fiber = require('fiber')
+        local fio = require('fio')
+        local xlog = require('xlog')
+        local count = 100
+        local fibers = {}
+        for i = 1, count do
+            fibers[i] = fiber.new(box.space.sync.insert, box.space.sync, {i})
+            fibers[i]:set_joinable(true)
+        end
+        for i = 1, count do
+            t.assert((fibers[i]:join()))
+        end
+        t.assert_equals(box.space.sync:count(), count)
+        t.assert_equals(box.info.synchro.queue.len, 0)
+
+        local confirms = 0
+        local files = fio.glob(fio.pathjoin(box.cfg.wal_dir, '*.xlog'))
+        for _, path in ipairs(files) do
+            for _, row in xlog.pairs(path) do
+                if row.HEADER.type == 'CONFIRM' then
+                    confirms = confirms + 1
+                end
+            end
+        end
+        t.assert_gt(confirms, 0)
+        t.assert_lt(confirms, count / 2)
+    end)
+end
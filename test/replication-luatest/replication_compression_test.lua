@@ -0,0 +1,77 @@
+local t = require('luatest')
+local cluster = require('test.luatest_helpers.cluster')
+local helpers = require('test.luatest_helpers')
+
+local g = t.group()
+
+g.before_all(function(cg)
+    cg.cluster = cluster:new({})
+    cg.master = cg.cluster:build_server({
+        alias = 'master',
+        box_cfg = {
+            replication = {helpers.instance_uri('master')},
+            replication_timeout = 0.1,
+        },
+    })
+    cg.replica = cg.cluster:build_server({
+        alias = 'replica',
+        box_cfg = {
+            replication = {helpers.instance_uri('master')},
+            replication_timeout = 0.1,
+            replication_compression = true,
+            read_only = true,
+        },
+    })
+    cg.cluster:add_server(cg.master)
+    cg.cluster:add_server(cg.replica)
+    cg.cluster:start()
+    cg.master:exec(function()
+        box.schema.space.create('test')
+        box.space.test:create_index('pk')
+    end)
+end)
+
+g.after_all(function(cg)
+    cg.cluster:drop()
+end)
+
+local function check_replication(cg, count)
+    cg.master:exec(function(count)
+        local payload = string.rep('x', 1000)
+        box.begin()
+        for i = 1, count do
+            box.space.test:replace({i, payload})
+        end
+        box.commit()
+        -- Small rows, which aren't compressed.
+        for i = 1, 10 do
+            box.space.test:replace({count + i})
+        end
+    end, {count})
+    local vclock = cg.master:exec(function()
+        local vclock = box.info.vclock
+        vclock[0] = nil
+        return vclock
+    end)
+    cg.replica:exec(function(vclock, count)
+        box.ctl.wait_vclock(vclock, 10)
+        t.assert_equals(box.space.test:count(), count + 10)
+        t.assert_equals(box.info.replication[1].upstream.status, 'follow')
+    end, {vclock, count})
+end
+
+g.test_compression = function(cg)
+    t.assert(cg.replica:grep_log('subscribed with compression'))
+    check_replication(cg, 2000)
+end
+
+g.test_compression_off = function(cg)
+    cg.replica:exec(function()
+        box.cfg{replication_compression = false}
+        -- Reconnect to apply the option.
+        local replication = box.cfg.replication
+        box.cfg{replication = {}}
+        box.cfg{replication = replication}
+    end)
+    check_replication(cg, 100)
+end
@@ -0,0 +1,78 @@
+local t = require('luatest')
+local cluster = require('test.luatest_helpers.cluster')
+local helpers = require('test.luatest_helpers')
+
+local g = t.group()
+
+g.before_all(function(cg)
+    cg.cluster = cluster:new({})
+    cg.master = cg.cluster:build_server({
+        alias = 'master',
+        box_cfg = {
+            replication = {helpers.instance_uri('master')},
+            replication_timeout = 0.1,
+        },
+    })
+    cg.replica = cg.cluster:build_server({
+        alias = 'replica',
+        box_cfg = {
+            replication = {helpers.instance_uri('master')},
+            replication_timeout = 0.1,
+            replication_space_filter = {600},
+            read_only = true,
+        },
+    })
+    cg.cluster:add_server(cg.master)
+    cg.cluster:start()
+    cg.master:exec(function()
+        box.schema.space.create('wanted', {id = 600})
+        box.space.wanted:create_index('pk')
+        box.schema.space.create('skipped', {id = 601})
+        box.space.skipped:create_index('pk')
+        for i = 1, 10 do
+            box.space.wanted:insert({i})
+            box.space.skipped:insert({i})
+        end
+    end)
+    cg.replica:start()
+end)
+
+g.after_all(function(cg)
+    cg.cluster:drop()
+    cg.replica:drop()
+end)
+
+g.test_cfg = function(cg)
+    cg.replica:exec(function()
+        t.assert_equals(box.cfg.replication_space_filter, {600})
+        t.assert_error_msg_contains("Can't set option",
+                                    box.cfg, {replication_space_filter = 1})
+    end)
+end
+
+-- Only the spaces the replica asked for are sent by join and
+-- subscribe. The schema is sent in full, and the replica vclock
+-- follows the master's one.
+g.test_filter = function(cg)
+    cg.replica:exec(function()
+        t.assert_equals(box.space.wanted:count(), 10)
+        t.assert_equals(box.space.skipped:count(), 0)
+    end)
+    local vclock = cg.master:exec(function()
+        box.begin()
+        box.space.skipped:insert({11})
+        box.space.wanted:insert({11})
+        box.space.skipped:insert({12})
+        box.commit()
+        box.space.skipped:delete({1})
+        local vclock = box.info.vclock
+        vclock[0] = nil
+        return vclock
+    end)
+    cg.replica:exec(function(vclock)
+        box.ctl.wait_vclock(vclock, 10)
+        t.assert_equals(box.space.wanted:count(), 11)
+        t.assert_equals(box.space.skipped:count(), 0)
+        t.assert_equals(box.info.replication[1].upstream.status, 'follow')
+    end, {vclock})
+end
@@ -0,0 +1,90 @@
+local t = require('luatest')
+local cluster = require('test.luatest_helpers.cluster')
+local helpers = require('test.luatest_helpers')
+
+local g = t.group()
+
+g.before_all(function(cg)
+    cg.cluster = cluster:new({})
+    cg.master = cg.cluster:build_server({
+        alias = 'master',
+        box_cfg = {
+            replication = {helpers.instance_uri('master')},
+            replication_timeout = 0.1,
+        },
+    })
+    cg.replica = cg.cluster:build_server({
+        alias = 'replica',
+        box_cfg = {
+            replication = {helpers.instance_uri('master')},
+            replication_timeout = 0.1,
+            read_only = true,
+        },
+    })
+    cg.cluster:add_server(cg.master)
+    cg.cluster:add_server(cg.replica)
+    cg.cluster:start()
+    cg.master:exec(function()
+        box.schema.space.create('test')
+        box.space.test:create_index('pk')
+    end)
+end)
+
+g.after_all(function(cg)
+    cg.cluster:drop()
+end)
+
+g.test_invalid_args = function(cg)
+    cg.replica:exec(function()
+        local msg = 'Usage: box.ctl.wait_vclock(vclock[, timeout])'
+        t.assert_error_msg_content_equals(msg, box.ctl.wait_vclock)
+        t.assert_error_msg_content_equals(msg, box.ctl.wait_vclock, 1)
+        t.assert_error_msg_contains('Invalid vclock component',
+                                    box.ctl.wait_vclock, {[32] = 1})
+        t.assert_error_msg_contains('Invalid vclock component',
+                                    box.ctl.wait_vclock, {[1] = -1})
+    end)
+end)
+
+g.test_timeout = function(cg)
+    cg.replica:exec(function()
+        local vclock = table.copy(box.info.vclock)
+        vclock[0] = nil
+        vclock[box.info.id] = (vclock[box.info.id] or 0) + 1
+        t.assert_error_msg_content_equals('Timeout exceeded',
+                                          box.ctl.wait_vclock, vclock, 0.01)
+    end)
+end)
+
+g.test_wait = function(cg)
+    -- A vclock which is already reached doesn't block.
+    local vclock = cg.master:exec(function()
+        box.space.test:replace({1})
+        return box.info.vclock
+    end)
+    vclock[0] = nil
+    cg.replica:exec(function(vclock)
+        box.ctl.wait_vclock(vclock, 10)
+        t.assert_equals(box.space.test:get(1), {1})
+        -- The local component is ignored.
+        box.ctl.wait_vclock({[0] = 1000}, 0)
+    end, {vclock})
+
+    -- A waiter wakes up once the vclock is reached.
+    local id = cg.master:exec(function() return box.info.id end)
+    vclock[id] = vclock[id] + 1
+    cg.replica:exec(function(vclock)
+        local fiber = require('fiber')
+        rawset(_G, 'wait_done', false)
+        fiber.create(function()
+            box.ctl.wait_vclock(vclock, 10)
+            _G.wait_done = box.space.test:get(2) ~= nil
+        end)
+        fiber.sleep(0.01)
+        t.assert_not(_G.wait_done)
+    end, {vclock})
+    cg.master:exec(function() box.space.test:replace({2}) end)
+    cg.replica:exec(function()
+        t.helpers.retrying({}, function() t.assert(_G.wait_done) end)
+    end)
+end
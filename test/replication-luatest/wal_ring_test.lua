@@ -0,0 +1,91 @@
+local t = require('luatest')
+local cluster = require('test.luatest_helpers.cluster')
+local helpers = require('test.luatest_helpers')
+
+local g = t.group('wal_ring')
+
+g.before_all(function(cg)
+    cg.cluster = cluster:new({})
+
+    local box_cfg = {
+        replication_timeout = 0.1,
+        wal_ring_size       = 64 * 1024,
+    }
+    cg.master = cg.cluster:build_server({alias = 'master', box_cfg = box_cfg})
+
+    local box_cfg = {
+        replication         = {
+            helpers.instance_uri('master'),
+        },
+        replication_timeout = 0.1,
+        read_only           = true,
+    }
+    cg.replica = cg.cluster:build_server({alias = 'replica', box_cfg = box_cfg})
+
+    cg.cluster:add_server(cg.master)
+    cg.cluster:add_server(cg.replica)
+    cg.cluster:start()
+
+    cg.master:exec(function()
+        box.schema.space.create('test')
+        box.space.test:create_index('pk')
+    end)
+end)
+
+g.after_all(function(cg)
+    cg.cluster.servers = nil
+    cg.cluster:drop()
+end)
+
+local function insert(server, first, last, size)
+    server:exec(function(first, last, size)
+        for i = first, last do
+            box.space.test:replace({i, string.rep('x', size)})
+        end
+    end, {first, last, size})
+end
+
+local function check_replica(cg, count, size)
+    local vclock = helpers:get_vclock(cg.master)
+    vclock[0] = nil
+    helpers:wait_vclock(cg.replica, vclock)
+    cg.replica:exec(function(count, size)
+        local t = require('luatest')
+        t.assert_equals(box.space.test:count(), count)
+        for _, tuple in box.space.test:pairs() do
+            t.assert_equals(#tuple[2], size)
+        end
+        t.assert_equals(box.info.replication[1].upstream.status, 'follow')
+    end, {count, size})
+end
+
+g.test_ring = function(cg)
+    -- Small rows fit in the ring.
+    insert(cg.master, 1, 100, 10)
+    check_replica(cg, 100, 10)
+
+    -- Rows that don't fit in the ring are read from xlog files.
+    insert(cg.master, 1, 100, 100 * 1024)
+    check_replica(cg, 100, 100 * 1024)
+
+    -- The relay switches back to the ring once caught up.
+    insert(cg.master, 1, 100, 20)
+    check_replica(cg, 100, 20)
+
+    -- The ring may be disabled and enabled on the fly.
+    cg.master:exec(function() box.cfg{wal_ring_size = 0} end)
+    insert(cg.master, 1, 100, 30)
+    check_replica(cg, 100, 30)
+    cg.master:exec(function() box.cfg{wal_ring_size = 1024 * 1024} end)
+    insert(cg.master, 1, 100, 40)
+    check_replica(cg, 100, 40)
+end
+
+g.test_cfg = function(cg)
+    cg.master:exec(function()
+        local t = require('luatest')
+        t.assert_error_msg_content_equals(
+            "Incorrect value for option 'wal_ring_size': value must be >= 0",
+            box.cfg, {wal_ring_size = -1})
+    end)
+end
@@ -94,6 +94,9 @@ _select(1, 10)
 test_run:cmd("switch hot_standby")
 _wait_lsn(10)
 box.space.tweedledum.index[1]:select()
+-- Check the replay lag is reported during hot standby.
+box.info.hot_standby.lag >= 0
+box.info.hot_standby.idle >= 0
 
 test_run:cmd("switch replica")
 _wait_lsn(10)
@@ -102,6 +105,7 @@ _select(1, 10)
 test_run:cmd("stop server default")
 test_run:cmd("switch hot_standby")
 while box.info.status ~= 'running' do fiber.sleep(0.001) end
+box.info.hot_standby
 test_run:cmd("switch replica")
 
 -- hot_standby.listen is garbage, since hot_standby.lua
@@ -194,12 +194,60 @@ void test_get_set()
 	footer();
 }
 
+static
+void test_sparse_pages()
+{
+	header();
+
+	struct tt_bitset bm;
+	tt_bitset_create(&bm, realloc);
+	struct tt_bitset_info info;
+
+	/* A page with few bits set stores their offsets. */
+	const size_t PAGE_BIT = 160 * CHAR_BIT;
+	for (size_t i = 0; i < 64; i++)
+		fail_if(tt_bitset_set(&bm, i * 3) < 0);
+	tt_bitset_info(&bm, &info);
+	fail_unless(info.pages == 1);
+	fail_unless(info.array_pages == 1);
+	fail_unless(info.mem_total < info.page_total_size);
+
+	/* It becomes a bitmap when it fills up... */
+	fail_if(tt_bitset_set(&bm, PAGE_BIT - 1) < 0);
+	tt_bitset_info(&bm, &info);
+	fail_unless(info.pages == 1);
+	fail_unless(info.array_pages == 0);
+	fail_unless(tt_bitset_cardinality(&bm) == 65);
+	for (size_t i = 0; i < PAGE_BIT; i++) {
+		bool expected = (i % 3 == 0 && i < 64 * 3) || i == PAGE_BIT - 1;
+		fail_unless(tt_bitset_test(&bm, i) == expected);
+	}
+
+	/* ...and sparse again when it gets empty enough. */
+	for (size_t i = 0; i < 33; i++)
+		fail_unless(tt_bitset_clear(&bm, i * 3) == 1);
+	tt_bitset_info(&bm, &info);
+	fail_unless(info.pages == 1);
+	fail_unless(info.array_pages == 1);
+	fail_unless(tt_bitset_cardinality(&bm) == 32);
+	for (size_t i = 0; i < PAGE_BIT; i++) {
+		bool expected = (i % 3 == 0 && i >= 33 * 3 && i < 64 * 3) ||
+				i == PAGE_BIT - 1;
+		fail_unless(tt_bitset_test(&bm, i) == expected);
+	}
+
+	tt_bitset_destroy(&bm);
+
+	footer();
+}
+
 int main(int argc, char *argv[])
 {
 	setbuf(stdout, NULL);
 	srand(time(NULL));
 	test_cardinality();
 	test_get_set();
+	test_sparse_pages();
 
 	return 0;
 }
@@ -30,7 +30,9 @@ compare(type_t a, type_t b);
 #define bps_tree_elem_t char
 #define bps_tree_key_t char
 #define bps_tree_arg_t int
+#define BPS_TREE_PREFETCH
 #include "salad/bps_tree.h"
+#undef BPS_TREE_PREFETCH
 #undef BPS_TREE_NAME
 #undef BPS_TREE_BLOCK_SIZE
 #undef BPS_TREE_EXTENT_SIZE
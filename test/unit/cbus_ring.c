@@ -0,0 +1,141 @@
+#include "memory.h"
+#include "fiber.h"
+#include "cbus.h"
+#include "unit.h"
+
+/**
+ * Test pipes created with cpipe_create_ring(): messages must be
+ * delivered in order even if there are more of them than fits in
+ * the ring, including the ones left in a pipe when it's destroyed.
+ */
+
+enum { MSG_COUNT = 5000 };
+
+struct test_msg {
+	struct cmsg base;
+	int seq;
+};
+
+static struct test_msg msgs[2 * MSG_COUNT];
+/** Number of messages received by the main thread. */
+static int received_count;
+/** Set if a message is received out of order. */
+static bool is_reordered;
+
+struct cord worker;
+struct cpipe pipe_to_worker;
+struct cpipe pipe_to_main;
+
+static void
+receive_f(struct cmsg *m)
+{
+	struct test_msg *msg = (struct test_msg *)m;
+	if (msg->seq != received_count)
+		is_reordered = true;
+	received_count++;
+}
+
+static void
+finish_f(struct cmsg *m)
+{
+	(void)m;
+	fiber_cancel(fiber());
+}
+
+/** Push messages [from, to) to the main thread without flushing. */
+static void
+send_msgs(int from, int to)
+{
+	static const struct cmsg_hop route[] = {
+		{ receive_f, NULL },
+	};
+	for (int i = from; i < to; i++) {
+		cmsg_init(&msgs[i].base, route);
+		msgs[i].seq = i;
+		cpipe_push_input(&pipe_to_main, &msgs[i].base);
+	}
+}
+
+static void
+test_push_f(struct cmsg *m)
+{
+	(void)m;
+	static const struct cmsg_hop finish_route[] = {
+		{ finish_f, NULL },
+	};
+	static struct cmsg finish_msg;
+	send_msgs(0, MSG_COUNT);
+	cmsg_init(&finish_msg, finish_route);
+	cpipe_push_input(&pipe_to_main, &finish_msg);
+	cpipe_flush_input(&pipe_to_main);
+}
+
+static int
+worker_f(va_list ap)
+{
+	(void)ap;
+	cpipe_create_ring(&pipe_to_main, "main");
+	struct cbus_endpoint endpoint;
+	cbus_endpoint_create(&endpoint, "worker", fiber_schedule_cb, fiber());
+	cbus_loop(&endpoint);
+	cbus_endpoint_destroy(&endpoint, cbus_process);
+	/* Destroy the pipe with messages that don't fit in the ring. */
+	send_msgs(MSG_COUNT, 2 * MSG_COUNT);
+	cpipe_destroy(&pipe_to_main);
+	return 0;
+}
+
+static int
+main_f(va_list ap)
+{
+	(void)ap;
+	struct cbus_endpoint endpoint;
+	cbus_endpoint_create(&endpoint, "main", fiber_schedule_cb, fiber());
+	fail_if(cord_costart(&worker, "worker", worker_f, NULL) != 0);
+	cpipe_create_ring(&pipe_to_worker, "worker");
+
+	static const struct cmsg_hop test_push_route[] = {
+		{ test_push_f, NULL },
+	};
+	static struct cmsg test_push_msg;
+	cmsg_init(&test_push_msg, test_push_route);
+	cpipe_push(&pipe_to_worker, &test_push_msg);
+
+	cbus_loop(&endpoint);
+	is(received_count, MSG_COUNT, "all messages are received");
+	ok(!is_reordered, "messages are received in order");
+
+	cbus_stop_loop(&pipe_to_worker);
+	cpipe_destroy(&pipe_to_worker);
+	fail_if(cord_join(&worker) != 0);
+	cbus_endpoint_destroy(&endpoint, cbus_process);
+	is(received_count, 2 * MSG_COUNT,
+	   "all messages are received after pipe destruction");
+	ok(!is_reordered, "messages are received in order "
+	   "after pipe destruction");
+
+	ev_break(loop(), EVBREAK_ALL);
+	return 0;
+}
+
+int
+main()
+{
+	header();
+	plan(4);
+
+	memory_init();
+	fiber_init(fiber_c_invoke);
+	cbus_init();
+	struct fiber *main_fiber = fiber_new("main", main_f);
+	assert(main_fiber != NULL);
+	fiber_wakeup(main_fiber);
+	ev_run(loop(), 0);
+	cbus_free();
+	fiber_free();
+	memory_free();
+
+	int rc = check_plan();
+	footer();
+	return rc;
+}
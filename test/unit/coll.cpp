@@ -11,6 +11,7 @@
 #include "coll/coll.h"
 #include "unit.h"
 #include <PMurHash.h>
+#include <unicode/ucol.h>
 
 using namespace std;
 
@@ -184,6 +185,73 @@ cache_test()
 	footer();
 }
 
+/**
+ * Count mismatches between the collation comparator and ICU on
+ * random strings of printable ASCII characters.
+ */
+static int
+ascii_mismatch_count(struct coll *coll)
+{
+	/* A few chars that are equal or adjacent at some strength. */
+	static const char alphabet[] = "aAbBzZ019 -_.,'\"~";
+	enum { STR_LEN_MAX = 6, ITERATIONS = 20000 };
+	int mismatches = 0;
+	srand(42);
+	for (int i = 0; i < ITERATIONS; i++) {
+		char s[STR_LEN_MAX], t[STR_LEN_MAX];
+		int s_len = rand() % STR_LEN_MAX;
+		int t_len = rand() % STR_LEN_MAX;
+		for (int j = 0; j < s_len; j++)
+			s[j] = alphabet[rand() % (sizeof(alphabet) - 1)];
+		for (int j = 0; j < t_len; j++)
+			t[j] = alphabet[rand() % (sizeof(alphabet) - 1)];
+		int cmp = coll->cmp(s, s_len, t, t_len, coll);
+		UCharIterator s_iter, t_iter;
+		uiter_setUTF8(&s_iter, s, s_len);
+		uiter_setUTF8(&t_iter, t, t_len);
+		UErrorCode status = U_ZERO_ERROR;
+		int expected = ucol_strcollIter(coll->collator, &s_iter,
+						&t_iter, &status);
+		if (cmp != expected)
+			mismatches++;
+	}
+	return mismatches;
+}
+
+void
+ascii_test()
+{
+	header();
+	plan(6);
+
+	struct coll_def def;
+	memset(&def, 0, sizeof(def));
+	def.type = COLL_TYPE_ICU;
+
+	/* unicode */
+	struct coll *coll = coll_new(&def);
+	ok(coll->has_ascii_weights, "unicode has ASCII weights");
+	is(ascii_mismatch_count(coll), 0, "unicode ASCII order");
+	coll_unref(coll);
+
+	/* unicode_ci */
+	def.icu.strength = COLL_ICU_STRENGTH_PRIMARY;
+	coll = coll_new(&def);
+	ok(coll->has_ascii_weights, "unicode_ci has ASCII weights");
+	is(ascii_mismatch_count(coll), 0, "unicode_ci ASCII order");
+	is(coll->cmp("=\xcc\xb8", 3, "\xe2\x89\xa0", 3, coll), 0,
+	   "non-ASCII strings are compared with ICU");
+	coll_unref(coll);
+
+	snprintf(def.locale, sizeof(def.locale), "%s", "cs_CZ");
+	coll = coll_new(&def);
+	ok(!coll->has_ascii_weights, "no ASCII weights for a locale");
+	coll_unref(coll);
+
+	check_plan();
+	footer();
+}
+
 int
 main(int, const char**)
 {
@@ -193,6 +261,7 @@ main(int, const char**)
 	manual_test();
 	hash_test();
 	cache_test();
+	ascii_test();
 	fiber_free();
 	memory_free();
 	coll_free();
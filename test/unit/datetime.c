@@ -211,7 +211,7 @@ tostring_datetime_test(void)
 	};
 	size_t index;
 
-	plan(15);
+	plan(18);
 	for (index = 0; index < lengthof(tests); index++) {
 		struct datetime date = {
 			tests[index].secs,
@@ -225,6 +225,14 @@ tostring_datetime_test(void)
 		   "string '%s' expected, received '%s'",
 		   tests[index].string, buf);
 	}
+	struct datetime date = {1382982716, 0, 0, 0};
+	const char *expected = "2013-10-28T17:51:56Z";
+	is(datetime_to_string(&date, NULL, 0), strlen(expected),
+	   "length is returned for NULL buffer");
+	char buf[8];
+	is(datetime_to_string(&date, buf, sizeof(buf)), strlen(expected),
+	   "full length is returned for short buffer");
+	is(strcmp(buf, "2013-10"), 0, "output is truncated to '%s'", buf);
 	check_plan();
 }
 
@@ -45,6 +45,15 @@
 	is(decimal_compare(&c, &d), 0, "decimal_compare("#expected")");\
 })
 
+#define dectest_op_str(op, stra, strb, expected) ({\
+	decimal_t a, b, c;\
+	decimal_from_string(&a, stra);\
+	decimal_from_string(&b, strb);\
+	is(decimal_##op(&c, &a, &b), &c, "decimal_"#op"("stra", "strb")");\
+	is(strcmp(decimal_str(&c), expected), 0,\
+	   "decimal_"#op"("stra", "strb") == "expected);\
+})
+
 #define dectest_op1(op, stra, expected, scale) ({\
 	decimal_t a, c, d;\
 	is(decimal_from_string(&a, #stra), &a, "decimal_from_string("#stra")");\
@@ -295,6 +304,31 @@ mp_snprint_ext_test(char *buf, int size, const char **data, int depth)
 	return mp_snprint_decimal(buf, size, data, len);
 }
 
+static int
+test_fast_path(void)
+{
+	plan(22);
+
+	/* Exact results keep the scale of the operands. */
+	dectest_op_str(add, "1.10", "2", "3.10");
+	dectest_op_str(sub, "1.10", "2", "-0.90");
+	dectest_op_str(mul, "1.10", "2", "2.20");
+	dectest_op_str(mul, "-1.5", "2.00", "-3.000");
+	dectest_op_str(add, "-0.5", "0.5", "0.0");
+	dectest_op_str(sub, "0.5", "0.5", "0.0");
+	dectest_op_str(add, "-0", "-0", "-0");
+	dectest_op_str(mul, "0.01", "-0", "-0.00");
+	dectest_op_str(mul, "9999999999999999999", "9999999999999999999",
+		       "99999999999999999980000000000000000001");
+	dectest_op_str(add, "9999999999999999999", "0.000000000000000001",
+		       "9999999999999999999.000000000000000001");
+	/* Needs rounding, handled by decNumber. */
+	dectest_op_str(add, "9999999999999999999", "1e-30",
+		       "9999999999999999999.0000000000000000000");
+
+	return check_plan();
+}
+
 static void
 test_mp_print(void)
 {
@@ -336,7 +370,7 @@ test_mp_print(void)
 int
 main(void)
 {
-	plan(312);
+	plan(313);
 
 	dectest(314, 271, uint64, uint64_t);
 	dectest(65535, 23456, uint64, uint64_t);
@@ -421,5 +455,7 @@ main(void)
 	dectest_is(is_neg, 0, false);
 	dectest_is(is_neg, -0, false);
 
+	test_fast_path();
+
 	return check_plan();
 }
@@ -21,7 +21,7 @@ main_f(va_list ap)
 	struct fiber *fiber;
 
 	header();
-	plan(6);
+	plan(8);
 
 	/*
 	 * Set non-default stack size to prevent reusing of an
@@ -60,6 +60,29 @@ main_f(va_list ap)
 	ok(fiber != NULL, "madvise: non critical error on madvise hint");
 	ok(diag_get() != NULL, "madvise: diag is armed after error");
 
+	/*
+	 * Check that dead fibers left after a burst don't keep
+	 * their stacks.
+	 */
+	diag_clear(diag_get());
+	enum { BURST_SIZE = 1000 };
+	static struct fiber *burst[BURST_SIZE];
+	int fiber_count = cord()->fiber_count;
+	for (int i = 0; i < BURST_SIZE; i++) {
+		burst[i] = fiber_new("burst", noop_f);
+		fail_if(burst[i] == NULL);
+		fiber_set_joinable(burst[i], true);
+		fiber_start(burst[i]);
+	}
+	size_t stack_size = cord()->stack_size;
+	ok(cord()->fiber_count >= fiber_count + BURST_SIZE / 2,
+	   "burst: fibers are created");
+	for (int i = 0; i < BURST_SIZE; i++)
+		fiber_join(burst[i]);
+	ok(cord()->dead_count < BURST_SIZE / 2 &&
+	   cord()->stack_size < stack_size / 2,
+	   "burst: dead fiber cache is trimmed");
+
 	/*
 	 * Check if we leak on fiber destruction.
 	 * We will print an error and result get
@@ -0,0 +1,146 @@
+#include <errno.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "memory.h"
+#include "fiber.h"
+#include "file_reclaim.h"
+#include "trivia/util.h"
+#include "unit.h"
+
+enum {
+	CHUNK_SIZE = 1024 * 1024,
+	/** Four chunks per second. */
+	RATE = 4 * CHUNK_SIZE,
+};
+
+static char dir[] = "file_reclaim.XXXXXX";
+
+/** Create a sparse file of the given size and return its path. */
+static const char *
+create_file(const char *name, off_t size)
+{
+	static char path[PATH_MAX];
+	snprintf(path, sizeof(path), "%s/%s", dir, name);
+	int fd = open(path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+	fail_if(fd < 0);
+	fail_if(ftruncate(fd, size) != 0);
+	close(fd);
+	return path;
+}
+
+static bool
+file_exists(const char *path)
+{
+	struct stat st;
+	return stat(path, &st) == 0;
+}
+
+/** Wait until the backlog is empty. Returns false on timeout. */
+static bool
+wait_backlog_empty(void)
+{
+	struct file_reclaim_stat stat;
+	for (int i = 0; i < 1000; i++) {
+		file_reclaim_stat(&stat);
+		if (stat.files == 0)
+			return stat.bytes == 0;
+		usleep(10 * 1000);
+	}
+	return false;
+}
+
+static void
+test_small(void)
+{
+	header();
+	plan(3);
+
+	const char *path = create_file("small", CHUNK_SIZE);
+	is(file_reclaim_unlink(path), 0, "unlink");
+	ok(!file_exists(path), "file is removed");
+	struct file_reclaim_stat stat;
+	file_reclaim_stat(&stat);
+	is(stat.files, 0, "small file isn't queued");
+
+	check_plan();
+	footer();
+}
+
+static void
+test_large(void)
+{
+	header();
+	plan(5);
+
+	const char *path = create_file("large", 10 * CHUNK_SIZE);
+	is(file_reclaim_unlink(path), 0, "unlink");
+	ok(!file_exists(path), "file is removed at once");
+	struct file_reclaim_stat stat;
+	file_reclaim_stat(&stat);
+	is(stat.files, 1, "file is queued");
+	ok(stat.bytes > 0 && stat.bytes <= 10 * CHUNK_SIZE, "bytes");
+	ok(wait_backlog_empty(), "file is freed in background");
+
+	check_plan();
+	footer();
+}
+
+static void
+test_error(void)
+{
+	header();
+	plan(2);
+
+	char path[PATH_MAX];
+	snprintf(path, sizeof(path), "%s/missing", dir);
+	is(file_reclaim_unlink(path), -1, "unlink of a missing file fails");
+	is(errno, ENOENT, "errno");
+
+	check_plan();
+	footer();
+}
+
+static void
+test_shutdown(void)
+{
+	header();
+	plan(3);
+
+	const char *path = create_file("pending", 100 * CHUNK_SIZE);
+	is(file_reclaim_unlink(path), 0, "unlink");
+	file_reclaim_free();
+	struct file_reclaim_stat stat;
+	file_reclaim_stat(&stat);
+	is(stat.files, 0, "backlog is dropped on shutdown");
+
+	path = create_file("stopped", 10 * CHUNK_SIZE);
+	is(file_reclaim_unlink(path), 0, "unlink after shutdown");
+
+	check_plan();
+	footer();
+}
+
+int
+main(void)
+{
+	header();
+	plan(4);
+	memory_init();
+	fiber_init(fiber_c_invoke);
+	fail_if(mkdtemp(dir) == NULL);
+	fail_if(file_reclaim_init(CHUNK_SIZE, RATE) != 0);
+	test_small();
+	test_large();
+	test_error();
+	test_shutdown();
+	rmdir(dir);
+	fiber_free();
+	memory_free();
+	footer();
+	return check_plan();
+}
@@ -1421,10 +1421,98 @@ raft_test_promote_restore(void)
 	raft_finish_test();
 }
 
+static void
+raft_test_leader_witness(void)
+{
+	raft_start_test(15);
+	struct raft_node node;
+	raft_node_create(&node);
+
+	is(raft_node_send_leader(&node,
+		2 /* Term. */,
+		2 /* Source. */
+	), 0, "leader notification");
+	is(raft_node_send_is_leader_seen(&node,
+		2 /* Term. */,
+		true /* Is leader seen. */,
+		3 /* Source. */
+	), 0, "the leader is seen by 3");
+	ok(raft_is_leader_seen(&node.raft), "the leader is seen by self");
+
+	/* The leader is lost only by this node, don't disturb it. */
+	raft_node_net_drop(&node);
+	raft_run_for(node.cfg_death_timeout * 2);
+	ok(raft_node_check_full_state(&node,
+		RAFT_STATE_FOLLOWER /* State. */,
+		2 /* Leader. */,
+		2 /* Term. */,
+		0 /* Vote. */,
+		2 /* Volatile term. */,
+		0 /* Volatile vote. */,
+		"{0: 1}" /* Vclock. */
+	), "no election while the leader is seen by 3");
+	is(node.net.count, 1, "1 pending message");
+	ok(raft_node_net_check_msg(&node,
+		0 /* Index. */,
+		RAFT_STATE_FOLLOWER /* State. */,
+		2 /* Term. */,
+		0 /* Vote. */,
+		NULL /* Vclock. */
+	) && !node.net.msgs[0].is_leader_seen, "the leader loss is sent");
+
+	raft_node_send_heartbeat(&node, 2);
+	ok(raft_is_leader_seen(&node.raft), "the leader is seen again");
+
+	/* The last witness loses the leader. */
+	raft_run_for(node.cfg_death_timeout * 2);
+	ok(!raft_is_leader_seen(&node.raft), "the leader is lost again");
+	is(raft_node_send_is_leader_seen(&node,
+		2 /* Term. */,
+		false /* Is leader seen. */,
+		3 /* Source. */
+	), 0, "the leader is not seen by 3");
+	ok(raft_node_check_full_state(&node,
+		RAFT_STATE_CANDIDATE /* State. */,
+		0 /* Leader. */,
+		3 /* Term. */,
+		1 /* Vote. */,
+		3 /* Volatile term. */,
+		1 /* Volatile vote. */,
+		"{0: 2}" /* Vclock. */
+	), "election is started immediately");
+
+	/* The witness is lost together with the connection to it. */
+	is(raft_node_send_leader(&node,
+		4 /* Term. */,
+		2 /* Source. */
+	), 0, "leader notification");
+	is(raft_node_send_is_leader_seen(&node,
+		4 /* Term. */,
+		true /* Is leader seen. */,
+		3 /* Source. */
+	), 0, "the leader is seen by 3");
+	raft_run_for(node.cfg_death_timeout * 2);
+	is(node.raft.volatile_term, 4, "no election while the leader is seen");
+	raft_node_disconnect(&node, 3);
+	ok(raft_node_check_full_state(&node,
+		RAFT_STATE_CANDIDATE /* State. */,
+		0 /* Leader. */,
+		5 /* Term. */,
+		1 /* Vote. */,
+		5 /* Volatile term. */,
+		1 /* Volatile vote. */,
+		"{0: 4}" /* Vclock. */
+	), "election is started when the witness is disconnected");
+	is(node.raft.leader_witness_map, 0, "no witnesses in the new term");
+
+	raft_node_destroy(&node);
+	raft_finish_test();
+}
+
 static int
 main_f(va_list ap)
 {
-	raft_start_test(14);
+	raft_start_test(15);
 
 	(void) ap;
 	fakeev_init();
@@ -1443,6 +1531,7 @@ main_f(va_list ap)
 	raft_test_enable_disable();
 	raft_test_too_long_wal_write();
 	raft_test_promote_restore();
+	raft_test_leader_witness();
 
 	fakeev_free();
 
@@ -312,6 +312,18 @@ raft_node_send_follower(struct raft_node *node, uint64_t term, uint32_t source)
 	return raft_node_process_msg(node, &msg, source);
 }
 
+int
+raft_node_send_is_leader_seen(struct raft_node *node, uint64_t term,
+			      bool is_leader_seen, uint32_t source)
+{
+	struct raft_msg msg = {
+		.state = RAFT_STATE_FOLLOWER,
+		.term = term,
+		.is_leader_seen = is_leader_seen,
+	};
+	return raft_node_process_msg(node, &msg, source);
+}
+
 void
 raft_node_send_heartbeat(struct raft_node *node, uint32_t source)
 {
@@ -319,6 +331,14 @@ raft_node_send_heartbeat(struct raft_node *node, uint32_t source)
 	raft_process_heartbeat(&node->raft, source);
 }
 
+void
+raft_node_disconnect(struct raft_node *node, uint32_t source)
+{
+	assert(raft_node_is_started(node));
+	raft_process_disconnect(&node->raft, source);
+	raft_run_async_work();
+}
+
 void
 raft_node_restart(struct raft_node *node)
 {
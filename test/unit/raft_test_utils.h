@@ -181,10 +181,22 @@ raft_node_send_leader(struct raft_node *node, uint64_t term, uint32_t source);
 int
 raft_node_send_follower(struct raft_node *node, uint64_t term, uint32_t source);
 
+/**
+ * Deliver a message from a follower @a source telling whether it sees the
+ * leader of the @a term.
+ */
+int
+raft_node_send_is_leader_seen(struct raft_node *node, uint64_t term,
+			      bool is_leader_seen, uint32_t source);
+
 /** Deliver a heartbeat message from @a source instance. */
 void
 raft_node_send_heartbeat(struct raft_node *node, uint32_t source);
 
+/** Simulate a loss of connection to @a source instance. */
+void
+raft_node_disconnect(struct raft_node *node, uint32_t source);
+
 /** Restart the node. The same as stop + start. */
 void
 raft_node_restart(struct raft_node *node);
@@ -275,12 +275,87 @@ neighbor_test()
 	footer();
 }
 
+static void
+bulk_load_check()
+{
+	header();
+
+	const size_t count = 5000;
+	struct rtree_rect *rects =
+		(struct rtree_rect *)malloc(count * sizeof(*rects));
+	for (size_t i = 0; i < count; i++) {
+		coord_t x = (i * 7919) % 1000;
+		coord_t y = (i * 104729) % 1000;
+		rtree_set2d(&rects[i], x, y, x + i % 5, y + i % 3);
+	}
+
+	struct rtree tree;
+	rtree_init(&tree, 2, extent_size,
+		   extent_alloc, extent_free, &page_count,
+		   RTREE_EUCLID);
+	size_t entry_size = rtree_bulk_entry_size(&tree);
+	void *entries = malloc(count * entry_size);
+	for (size_t i = 0; i < count; i++)
+		rtree_bulk_entry_set(&tree, entries, i, &rects[i],
+				     (record_t)(i + 1));
+	rtree_bulk_load(&tree, entries, count);
+	free(entries);
+	if (rtree_number_of_records(&tree) != count)
+		fail("Tree count mismatch", "true");
+	if (rtree_used_size(&tree) != rtree_bulk_load_size(&tree, count))
+		fail("Tree size mismatch", "true");
+
+	/* Every record is found, and only matching ones are. */
+	struct rtree_iterator iterator;
+	rtree_iterator_init(&iterator);
+	for (size_t q = 0; q < 100; q++) {
+		struct rtree_rect rect;
+		coord_t x = q * 10;
+		coord_t y = 1000 - q * 10;
+		rtree_set2d(&rect, x, y - 50, x + 50, y);
+		size_t expected = 0;
+		for (size_t i = 0; i < count; i++) {
+			const coord_t *c = rects[i].coords;
+			if (c[0] <= x + 50 && c[1] >= x &&
+			    c[2] <= y && c[3] >= y - 50)
+				expected++;
+		}
+		size_t found = 0;
+		rtree_search(&tree, &rect, SOP_OVERLAPS, &iterator);
+		while (rtree_iterator_next(&iterator) != NULL)
+			found++;
+		if (found != expected)
+			fail("Search result mismatch", "true");
+	}
+	for (size_t i = 0; i < count; i++) {
+		if (!rtree_search(&tree, &rects[i], SOP_EQUALS, &iterator))
+			fail("element in tree", "false");
+	}
+
+	/* The tree can be modified after that. */
+	for (size_t i = 0; i < count; i++) {
+		if (!rtree_remove(&tree, &rects[i], (record_t)(i + 1)))
+			fail("delete element in tree", "false");
+	}
+	if (rtree_number_of_records(&tree) != 0)
+		fail("Tree count mismatch", "true");
+	rtree_insert(&tree, &rects[0], (record_t)1);
+	if (!rtree_search(&tree, &rects[0], SOP_EQUALS, &iterator))
+		fail("element in tree", "false");
+
+	rtree_iterator_destroy(&iterator);
+	rtree_destroy(&tree);
+	free(rects);
+
+	footer();
+}
 
 int
 main(void)
 {
 	simple_check();
 	neighbor_test();
+	bulk_load_check();
 	if (page_count != 0) {
 		fail("memory leak!", "true");
 	}
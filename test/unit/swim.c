@@ -1092,10 +1092,163 @@ swim_test_member_by_uuid(void)
 	swim_finish_test();
 }
 
+/**
+ * Packet filter of a listener: counts the packets received from
+ * one instance, drops all the packets the listener sends. So the
+ * listener never answers and the only packets coming from the
+ * instance are its round step packets.
+ */
+struct swim_listener {
+	/** Descriptor of the instance to count packets from. */
+	int src_fd;
+	/** Number of packets received from the instance. */
+	int count;
+};
+
+static bool
+swim_filter_listener(const char *data, int size, void *udata, int dir,
+		     int peer_fd)
+{
+	(void) data;
+	(void) size;
+	if (dir == 1)
+		return true;
+	struct swim_listener *l = (struct swim_listener *) udata;
+	if (peer_fd == l->src_fd)
+		++l->count;
+	return false;
+}
+
+/**
+ * Make all the instances but S1 its listeners and add them to S1.
+ * The instance with id @a skip_id, if any, is not added.
+ */
+static void
+swim_cluster_listen_s1(struct swim_cluster *cluster, int size,
+		       struct swim_listener *listeners, int skip_id)
+{
+	int src_fd = swim_fd(swim_cluster_member(cluster, 0));
+	for (int i = 1; i < size; ++i) {
+		listeners[i].src_fd = src_fd;
+		listeners[i].count = 0;
+		fakenet_add_filter(swim_fd(swim_cluster_member(cluster, i)),
+				   swim_filter_listener, &listeners[i]);
+		if (i != skip_id)
+			swim_cluster_add_link(cluster, 0, i);
+	}
+}
+
+static void
+swim_test_round_order(void)
+{
+	swim_start_test(4);
+	struct swim_listener listeners[11];
+	int size = (int) lengthof(listeners);
+	int new_id = size - 1;
+	struct swim_cluster *cluster = swim_cluster_new(size);
+	/* No acks are received, so no ping-reqs and no failures. */
+	swim_cluster_set_ack_timeout(cluster, 1000);
+	swim_cluster_listen_s1(cluster, size, listeners, new_id);
+	/*
+	 * A step per second, a round is size - 2 steps: the
+	 * new member and self are not visited.
+	 */
+	int round_steps = size - 2;
+	swim_run_for(round_steps * 3 + 0.5);
+	bool is_ok = true;
+	for (int i = 1; i < new_id; ++i)
+		is_ok = is_ok && listeners[i].count == 3;
+	ok(is_ok, "each round visits every member exactly once");
+	is(listeners[new_id].count, 0, "a not added member is not visited");
+	/*
+	 * Add a member in the middle of a round. It is pinged in
+	 * this round, not in the next one. The addition restarts
+	 * the round timer.
+	 */
+	swim_run_for(4);
+	fail_if(swim_cluster_add_link(cluster, 0, new_id) != 0);
+	swim_run_for(round_steps - 4 + 1 + 0.5);
+	is(listeners[new_id].count, 1, "a member added in the middle of a "\
+	   "round is visited in this round");
+	is_ok = true;
+	for (int i = 1; i < new_id; ++i)
+		is_ok = is_ok && listeners[i].count == 4;
+	ok(is_ok, "the other members are visited once in this round");
+
+	swim_cluster_delete(cluster);
+	swim_finish_test();
+}
+
+/**
+ * Check if any of the instances except S1 and the member itself
+ * knows every member.
+ */
+static bool
+swim_cluster_listeners_know_all(struct swim_cluster *cluster, int size)
+{
+	for (int j = 0; j < size; ++j) {
+		bool is_known = false;
+		for (int i = 1; i < size && !is_known; ++i) {
+			is_known = i != j &&
+				   swim_cluster_member_view(cluster, i, j) !=
+				   NULL;
+		}
+		if (!is_known)
+			return false;
+	}
+	return true;
+}
+
+static void
+swim_test_event_burst(void)
+{
+	swim_start_test(3);
+	/*
+	 * A step of S1 carries ~90 'new member' events: a half
+	 * of the round packet and 3 dissemination packets.
+	 */
+	int size = 50;
+	struct swim_listener listeners[200];
+	struct swim_cluster *cluster = swim_cluster_new(size);
+	swim_cluster_set_ack_timeout(cluster, 1000);
+	swim_cluster_listen_s1(cluster, size, listeners, -1);
+	swim_run_for(1.5);
+	int addressee = 0;
+	for (int i = 1; i < size; ++i) {
+		if (listeners[i].count > 0) {
+			fail_if(addressee != 0);
+			addressee = i;
+		}
+	}
+	fail_if(addressee == 0);
+	ok(listeners[addressee].count > 1, "events which didn't fit into "\
+	   "the round packet are sent in more packets of the same step");
+	is(swim_size(swim_cluster_member(cluster, addressee)), size,
+	   "the addressee learned all the events in one step");
+	swim_cluster_delete(cluster);
+	/*
+	 * The events don't fit into a step, and all of them have
+	 * TTD ceil(log2(200)) + 1 = 9. If TTDs were decreased for
+	 * all the events on each step, the tail of the queue would
+	 * expire without being sent. The sent events go after the
+	 * not sent ones, so each event is sent in a few steps.
+	 */
+	size = 200;
+	cluster = swim_cluster_new(size);
+	swim_cluster_set_ack_timeout(cluster, 1000);
+	swim_cluster_listen_s1(cluster, size, listeners, -1);
+	swim_run_for(5.5);
+	ok(swim_cluster_listeners_know_all(cluster, size),
+	   "each event of a burst is sent before it expires");
+	swim_cluster_delete(cluster);
+
+	swim_finish_test();
+}
+
 static int
 main_f(va_list ap)
 {
-	swim_start_test(23);
+	swim_start_test(25);
 
 	(void) ap;
 	fakeev_init();
@@ -1124,6 +1277,8 @@ main_f(va_list ap)
 	swim_test_dissemination_speed();
 	swim_test_suspect_new_members();
 	swim_test_member_by_uuid();
+	swim_test_round_order();
+	swim_test_event_burst();
 
 	fakenet_free();
 	fakeev_free();
@@ -0,0 +1,168 @@
+#include <unistd.h>
+
+#include "memory.h"
+#include "fiber.h"
+#include "thread_pool.h"
+#include "trivia/util.h"
+#include "unit.h"
+
+enum { WORKER_COUNT = 2, FIBER_COUNT = 8 };
+
+static struct thread_pool pool;
+
+struct sum_task {
+	struct thread_pool_task base;
+	int n;
+	long long result;
+	/** Time to sleep in microseconds before computing. */
+	int delay;
+};
+
+static int
+sum_f(struct thread_pool_task *base)
+{
+	struct sum_task *task = (struct sum_task *)base;
+	if (task->delay > 0)
+		usleep(task->delay);
+	if (task->n < 0) {
+		diag_set(IllegalParams, "negative number");
+		return -1;
+	}
+	task->result = 0;
+	for (int i = 1; i <= task->n; i++)
+		task->result += i;
+	return 0;
+}
+
+static int
+sum(int n, int delay, long long *result)
+{
+	struct sum_task task;
+	task.base.f = sum_f;
+	task.n = n;
+	task.delay = delay;
+	task.result = 0;
+	int rc = thread_pool_call(&pool, &task.base);
+	*result = task.result;
+	return rc;
+}
+
+static int
+sum_fiber_f(va_list ap)
+{
+	int n = va_arg(ap, int);
+	bool *is_ok = va_arg(ap, bool *);
+	long long result;
+	*is_ok = sum(n, 0, &result) == 0 && result == (long long)n * (n + 1) / 2;
+	return 0;
+}
+
+static void
+test_basic(void)
+{
+	header();
+	plan(3);
+
+	long long result;
+	is(sum(100, 0, &result), 0, "call");
+	is(result, 5050, "result");
+
+	bool is_ok[FIBER_COUNT];
+	struct fiber *fibers[FIBER_COUNT];
+	for (int i = 0; i < FIBER_COUNT; i++) {
+		fibers[i] = fiber_new("sum", sum_fiber_f);
+		fail_if(fibers[i] == NULL);
+		fiber_set_joinable(fibers[i], true);
+		fiber_start(fibers[i], 1000 * (i + 1), &is_ok[i]);
+	}
+	bool all_ok = true;
+	for (int i = 0; i < FIBER_COUNT; i++) {
+		fiber_join(fibers[i]);
+		all_ok = all_ok && is_ok[i];
+	}
+	ok(all_ok, "concurrent calls");
+
+	check_plan();
+	footer();
+}
+
+static void
+test_error(void)
+{
+	header();
+	plan(2);
+
+	long long result;
+	is(sum(-1, 0, &result), -1, "error");
+	struct error *e = diag_last_error(diag_get());
+	ok(e != NULL && strcmp(e->errmsg, "negative number") == 0,
+	   "diag is moved to the caller");
+	diag_clear(diag_get());
+
+	check_plan();
+	footer();
+}
+
+static int
+slow_fiber_f(va_list ap)
+{
+	bool *is_done = va_arg(ap, bool *);
+	long long result;
+	sum(1, 500 * 1000, &result);
+	*is_done = true;
+	return 0;
+}
+
+static void
+test_steal(void)
+{
+	header();
+	plan(1);
+
+	/*
+	 * Occupy a worker with a slow task. The tasks submitted to
+	 * its queue after are stolen by the other worker.
+	 */
+	bool is_slow_done = false;
+	struct fiber *slow = fiber_new("slow", slow_fiber_f);
+	fail_if(slow == NULL);
+	fiber_set_joinable(slow, true);
+	fiber_start(slow, &is_slow_done);
+	long long result;
+	for (int i = 0; i < 2 * WORKER_COUNT; i++)
+		sum(10, 0, &result);
+	ok(!is_slow_done, "tasks are stolen from a busy worker");
+	fiber_join(slow);
+
+	check_plan();
+	footer();
+}
+
+static int
+main_f(va_list ap)
+{
+	(void)ap;
+	fail_if(thread_pool_create(&pool, "test", WORKER_COUNT) != 0);
+	test_basic();
+	test_error();
+	test_steal();
+	thread_pool_destroy(&pool);
+	ev_break(loop(), EVBREAK_ALL);
+	return 0;
+}
+
+int
+main(void)
+{
+	header();
+	plan(3);
+	memory_init();
+	fiber_init(fiber_c_invoke);
+	struct fiber *f = fiber_new("main", main_f);
+	fiber_wakeup(f);
+	ev_run(loop(), 0);
+	fiber_free();
+	memory_free();
+	footer();
+	return check_plan();
+}
@@ -25,7 +25,7 @@ write_run(struct vy_run *run, const char *dir_name,
 	if (vy_run_writer_create(&writer, run, dir_name,
 				 lsm->space_id, lsm->index_id,
 				 lsm->cmp_def, lsm->key_def,
-				 4096, 0.1, false) != 0)
+				 4096, 0.1, false, false) != 0)
 		goto fail;
 
 	if (wi->iface->start(wi) != 0)
@@ -196,7 +196,8 @@ test_basic()
 	struct vy_stmt_stream *write_stream;
 	write_stream = vy_write_iterator_new(pk->cmp_def, true, true,
 					     &read_views, NULL);
-	vy_write_iterator_new_mem(write_stream, run_mem);
+	vy_write_iterator_new_mem(write_stream, run_mem, vy_entry_none(),
+				  vy_entry_none());
 	struct vy_run *run = vy_run_new(&run_env, 1);
 	isnt(run, NULL, "vy_run_new");
 
@@ -227,7 +228,8 @@ test_basic()
 	}
 	write_stream = vy_write_iterator_new(pk->cmp_def, true, true,
 					     &read_views, NULL);
-	vy_write_iterator_new_mem(write_stream, run_mem);
+	vy_write_iterator_new_mem(write_stream, run_mem, vy_entry_none(),
+				  vy_entry_none());
 	run = vy_run_new(&run_env, 2);
 	isnt(run, NULL, "vy_run_new");
 
@@ -108,7 +108,8 @@ compare_write_iterator_results(const struct vy_stmt_template *content,
 	wi = vy_write_iterator_new(key_def, is_primary, is_last_level, &rv_list,
 				   is_primary ? &handler.base : NULL);
 	fail_if(wi == NULL);
-	fail_if(vy_write_iterator_new_mem(wi, mem) != 0);
+	fail_if(vy_write_iterator_new_mem(wi, mem, vy_entry_none(),
+					  vy_entry_none()) != 0);
 
 	struct vy_entry ret;
 	fail_if(wi->iface->start(wi) != 0);
@@ -300,6 +300,84 @@ test_request_str()
 	check_plan();
 }
 
+/**
+ * Check that DML request bodies with the keys in the order used
+ * by net.box and in any other order are decoded the same way.
+ */
+static void
+test_xrow_decode_dml()
+{
+	plan(10);
+
+	char buffer[64];
+	uint64_t key_map = dml_request_key_map(IPROTO_REPLACE);
+
+	struct xrow_header header;
+	memset(&header, 0, sizeof(header));
+	header.type = IPROTO_REPLACE;
+	header.bodycnt = 1;
+	struct request request;
+
+	char *pos = mp_encode_map(buffer, 2);
+	pos = mp_encode_uint(pos, IPROTO_SPACE_ID);
+	pos = mp_encode_uint(pos, 512);
+	pos = mp_encode_uint(pos, IPROTO_TUPLE);
+	pos = mp_encode_array(pos, 1);
+	pos = mp_encode_uint(pos, 300);
+	header.body[0].iov_base = buffer;
+	header.body[0].iov_len = pos - buffer;
+	is(xrow_decode_dml(&header, &request, key_map), 0,
+	   "decode {space_id, tuple}");
+	is(request.space_id, 512u, "space_id of {space_id, tuple}");
+	ok(request.tuple_end - request.tuple == 3 &&
+	   mp_typeof(*request.tuple) == MP_ARRAY,
+	   "tuple of {space_id, tuple}");
+	ok(!request.has_extra_keys, "no extra keys in {space_id, tuple}");
+
+	pos = mp_encode_map(buffer, 2);
+	pos = mp_encode_uint(pos, IPROTO_TUPLE);
+	pos = mp_encode_array(pos, 1);
+	pos = mp_encode_uint(pos, 300);
+	pos = mp_encode_uint(pos, IPROTO_SPACE_ID);
+	pos = mp_encode_uint(pos, 512);
+	header.body[0].iov_len = pos - buffer;
+	is(xrow_decode_dml(&header, &request, key_map), 0,
+	   "decode {tuple, space_id}");
+	is(request.space_id, 512u, "space_id of {tuple, space_id}");
+	ok(request.tuple_end - request.tuple == 3 &&
+	   mp_typeof(*request.tuple) == MP_ARRAY,
+	   "tuple of {tuple, space_id}");
+
+	pos = mp_encode_map(buffer, 2);
+	pos = mp_encode_uint(pos, IPROTO_SPACE_ID);
+	pos = mp_encode_str(pos, "a", 1);
+	pos = mp_encode_uint(pos, IPROTO_TUPLE);
+	pos = mp_encode_array(pos, 0);
+	header.body[0].iov_len = pos - buffer;
+	is(xrow_decode_dml(&header, &request, key_map), -1,
+	   "invalid space_id type");
+
+	pos = mp_encode_map(buffer, 1);
+	pos = mp_encode_uint(pos, IPROTO_SPACE_ID);
+	pos = mp_encode_uint(pos, 512);
+	header.body[0].iov_len = pos - buffer;
+	is(xrow_decode_dml(&header, &request, key_map), -1,
+	   "missing tuple");
+
+	pos = mp_encode_map(buffer, 3);
+	pos = mp_encode_uint(pos, IPROTO_SPACE_ID);
+	pos = mp_encode_uint(pos, 512);
+	pos = mp_encode_str(pos, "a", 1);
+	pos = mp_encode_uint(pos, 1);
+	pos = mp_encode_uint(pos, IPROTO_TUPLE);
+	pos = mp_encode_array(pos, 0);
+	header.body[0].iov_len = pos - buffer;
+	ok(xrow_decode_dml(&header, &request, key_map) == 0 &&
+	   request.has_extra_keys, "extra keys in {space_id, 'a', tuple}");
+
+	check_plan();
+}
+
 /**
  * The compiler doesn't have to preserve bitfields order,
  * still we rely on it for convenience sake.
@@ -342,7 +420,7 @@ main(void)
 {
 	memory_init();
 	fiber_init(fiber_c_invoke);
-	plan(4);
+	plan(5);
 
 	random_init();
 
@@ -351,6 +429,7 @@ main(void)
 	test_xrow_header_encode_decode();
 	test_request_str();
 	test_xrow_fields();
+	test_xrow_decode_dml();
 
 	random_free();
 	fiber_free();
@@ -0,0 +1,75 @@
+local server = require('test.luatest_helpers.server')
+local t = require('luatest')
+
+local g = t.group()
+
+g.before_all(function(cg)
+    cg.server = server:new({
+        alias = 'default',
+        box_cfg = {vinyl_cache = 0},
+    })
+    cg.server:start()
+end)
+
+g.after_all(function(cg)
+    cg.server:drop()
+end)
+
+g.after_each(function(cg)
+    cg.server:exec(function()
+        if box.space.test ~= nil then
+            box.space.test:drop()
+        end
+    end)
+end)
+
+g.test_options = function(cg)
+    cg.server:exec(function()
+        local t = require('luatest')
+        local s = box.schema.space.create('test', {engine = 'vinyl'})
+        s:create_index('pk')
+        t.assert_equals(s.index.pk.options.bloom_partitioned, nil)
+        s:create_index('sk', {bloom_partitioned = true})
+        t.assert_equals(s.index.sk.options.bloom_partitioned, true)
+        t.assert_error_msg_content_equals(
+            "Illegal parameters, options parameter 'bloom_partitioned' " ..
+            "should be of type boolean",
+            s.create_index, s, 'tk', {bloom_partitioned = 1})
+    end)
+end
+
+g.test_lookup = function(cg)
+    cg.server:exec(function()
+        local s = box.schema.space.create('test', {engine = 'vinyl'})
+        s:create_index('pk', {parts = {{1, 'unsigned'}, {2, 'unsigned'}},
+                              page_size = 1024, bloom_partitioned = true})
+        for i = 1, 1000 do
+            s:insert({i, i * 2, string.rep('x', 50)})
+        end
+        box.snapshot()
+    end)
+    local function check()
+        cg.server:exec(function()
+            local t = require('luatest')
+            local s = box.space.test
+            local stat = s.index.pk:stat()
+            t.assert_gt(stat.disk.pages, 1)
+            t.assert_gt(stat.disk.bloom_size, 0)
+            t.assert_equals(box.stat.vinyl().memory.bloom_filter,
+                            stat.disk.bloom_size)
+            local hit = stat.disk.iterator.bloom.hit
+            for i = 1, 1000, 10 do
+                t.assert_equals(s:get({i, i * 2}),
+                                {i, i * 2, string.rep('x', 50)})
+                t.assert_equals(s:get({i, i * 2 + 1}), nil)
+                t.assert_equals(#s:select({i}), 1)
+            end
+            stat = s.index.pk:stat()
+            t.assert_gt(stat.disk.iterator.bloom.hit, hit)
+        end)
+    end
+    check()
+    -- Check that bloom filters are loaded from the index file.
+    cg.server:restart()
+    check()
+end
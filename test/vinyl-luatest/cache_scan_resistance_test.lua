@@ -0,0 +1,61 @@
+local server = require('test.luatest_helpers.server')
+local t = require('luatest')
+
+local g = t.group()
+
+g.before_all(function(cg)
+    cg.server = server:new({
+        alias = 'default',
+        box_cfg = {vinyl_cache = 1024 * 1024},
+    })
+    cg.server:start()
+end)
+
+g.after_all(function(cg)
+    cg.server:drop()
+end)
+
+-- Keys read more than once must survive scans that put more data
+-- into the cache than it can hold.
+g.test_scan_resistance = function(cg)
+    cg.server:exec(function()
+        local t = require('luatest')
+        local hot = box.schema.space.create('hot', {engine = 'vinyl'})
+        hot:create_index('pk')
+        local big = box.schema.space.create('big', {engine = 'vinyl'})
+        big:create_index('pk')
+        for i = 1, 100 do
+            hot:insert({i, string.rep('x', 100)})
+        end
+        for i = 1, 5000 do
+            big:insert({i, string.rep('x', 1000)})
+        end
+        box.snapshot()
+        -- The first read adds a key to the cache,
+        -- the second one protects it.
+        for _ = 1, 2 do
+            for i = 1, 100 do
+                hot:get({i})
+            end
+        end
+        -- A scan stops populating the cache after it has put
+        -- a quarter of the quota, so use several scans.
+        local put = big.index.pk:stat().cache.put.bytes
+        for i = 1, 5000, 500 do
+            t.assert_equals(#big:select({i}, {iterator = 'GE',
+                                              limit = 500}), 500)
+        end
+        local stat = big.index.pk:stat().cache
+        t.assert_gt(stat.put.bytes - put, box.cfg.vinyl_cache)
+        t.assert_gt(stat.evict.rows, 0)
+        t.assert_lt(stat.put.bytes - put, 5000 * 1000)
+        -- The hot keys are still cached.
+        local get = hot.index.pk:stat().cache.get.rows
+        for i = 1, 100 do
+            hot:get({i})
+        end
+        t.assert_equals(hot.index.pk:stat().cache.get.rows - get, 100)
+        hot:drop()
+        big:drop()
+    end)
+end
@@ -0,0 +1,94 @@
+local server = require('test.luatest_helpers.server')
+local t = require('luatest')
+
+local g = t.group()
+
+g.before_all(function(cg)
+    cg.server = server:new({alias = 'default'})
+    cg.server:start()
+end)
+
+g.after_all(function(cg)
+    cg.server:drop()
+end)
+
+g.after_each(function(cg)
+    cg.server:exec(function()
+        if box.space.test ~= nil then
+            box.space.test:drop()
+        end
+    end)
+end)
+
+g.test_options = function(cg)
+    cg.server:exec(function()
+        local t = require('luatest')
+        local s = box.schema.space.create('test', {engine = 'vinyl'})
+        s:create_index('pk')
+        t.assert_equals(s.index.pk.options.compaction_policy, nil)
+        t.assert_equals(s.index.pk:stat().disk.compaction.policy, 'leveled')
+        s.index.pk:alter({compaction_policy = 'tiered'})
+        t.assert_equals(s.index.pk.options.compaction_policy, 'tiered')
+        t.assert_equals(s.index.pk:stat().disk.compaction.policy, 'tiered')
+        s.index.pk:alter({compaction_policy = 'LEVELED'})
+        t.assert_equals(s.index.pk.options.compaction_policy, nil)
+        t.assert_error_msg_content_equals(
+            "Wrong index options (field 4): compaction_policy must be " ..
+            "either 'leveled' or 'tiered'",
+            s.create_index, s, 'sk', {compaction_policy = 'foo'})
+        t.assert_error_msg_content_equals(
+            "Illegal parameters, options parameter 'compaction_policy' " ..
+            "should be of type string",
+            s.create_index, s, 'sk', {compaction_policy = 1})
+    end)
+end
+
+local function dump_runs(policy, count)
+    local s = box.schema.space.create('test', {engine = 'vinyl'})
+    s:create_index('pk', {run_count_per_level = 2,
+                          compaction_policy = policy})
+    for i = 1, count do
+        for j = 1, 100 do
+            s:replace({i * 1000 + j})
+        end
+        box.snapshot()
+    end
+    return s.index.pk
+end
+
+g.test_leveled = function(cg)
+    cg.server:exec(dump_runs, {'leveled', 2})
+    cg.server:exec(function()
+        local t = require('luatest')
+        local pk = box.space.test.index.pk
+        -- The last level can't store more than one run.
+        t.helpers.retrying({}, function()
+            t.assert_equals(pk:stat().run_count, 1)
+        end)
+        t.assert_equals(pk:stat().disk.compaction.count, 1)
+    end)
+end
+
+g.test_tiered = function(cg)
+    cg.server:exec(dump_runs, {'tiered', 2})
+    cg.server:exec(function()
+        local t = require('luatest')
+        local pk = box.space.test.index.pk
+        -- The last level may store up to run_count_per_level runs.
+        local stat = pk:stat()
+        t.assert_equals(stat.run_count, 2)
+        t.assert_equals(stat.disk.compaction.count, 0)
+        t.assert_equals(stat.disk.compaction.queue.bytes, 0)
+        -- Once the limit is exceeded, the runs are compacted.
+        for i = 1, 2 do
+            for j = 1, 100 do
+                box.space.test:replace({(i + 10) * 1000 + j})
+            end
+            box.snapshot()
+        end
+        t.helpers.retrying({}, function()
+            t.assert_ge(pk:stat().disk.compaction.count, 1)
+        end)
+        t.assert_le(pk:stat().run_count, 2)
+    end)
+end
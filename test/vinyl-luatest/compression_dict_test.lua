@@ -0,0 +1,96 @@
+local server = require('test.luatest_helpers.server')
+local t = require('luatest')
+
+local g = t.group()
+
+g.before_all(function(cg)
+    cg.server = server:new({alias = 'default'})
+    cg.server:start()
+end)
+
+g.after_all(function(cg)
+    cg.server:drop()
+end)
+
+g.after_each(function(cg)
+    cg.server:exec(function()
+        for _, name in ipairs({'test', 'test_dict'}) do
+            if box.space[name] ~= nil then
+                box.space[name]:drop()
+            end
+        end
+    end)
+end)
+
+g.test_options = function(cg)
+    cg.server:exec(function()
+        local t = require('luatest')
+        local s = box.schema.space.create('test', {engine = 'vinyl'})
+        s:create_index('pk')
+        t.assert_equals(s.index.pk.options.compression_dict_size, nil)
+        s.index.pk:alter({compression_dict_size = 4096})
+        t.assert_equals(s.index.pk.options.compression_dict_size, 4096)
+        s.index.pk:alter({compression_dict_size = 0})
+        t.assert_equals(s.index.pk.options.compression_dict_size, nil)
+        for _, size in ipairs({-1, 255, 1024 * 1024 + 1}) do
+            t.assert_error_msg_content_equals(
+                "Wrong index options (field 4): compression_dict_size " ..
+                "must be either 0 or between 256 and 1048576",
+                s.create_index, s, 'sk', {compression_dict_size = size})
+        end
+        t.assert_error_msg_content_equals(
+            "Illegal parameters, options parameter " ..
+            "'compression_dict_size' should be of type number",
+            s.create_index, s, 'sk', {compression_dict_size = 'foo'})
+    end)
+end
+
+g.test_compression = function(cg)
+    cg.server:exec(function()
+        local t = require('luatest')
+        local function create(name, dict_size)
+            local s = box.schema.space.create(name, {engine = 'vinyl'})
+            s:create_index('pk', {page_size = 4096,
+                                  run_count_per_level = 100,
+                                  compression_dict_size = dict_size})
+            return s
+        end
+        local s1 = create('test', 0)
+        local s2 = create('test_dict', 4096)
+        local function tuple(i)
+            return {i, {name = 'user' .. i, status = 'active',
+                        email = 'user' .. i .. '@example.com'}}
+        end
+        -- The first dump trains a dictionary. L1 runs aren't
+        -- compressed so the dictionary is first used by compaction.
+        for i = 1, 2 do
+            for j = 1, 2000 do
+                local k = i * 10000 + j
+                s1:replace(tuple(k))
+                s2:replace(tuple(k))
+            end
+            box.snapshot()
+        end
+        s1.index.pk:compact()
+        s2.index.pk:compact()
+        t.helpers.retrying({}, function()
+            t.assert_equals(s1.index.pk:stat().run_count, 1)
+            t.assert_equals(s2.index.pk:stat().run_count, 1)
+        end)
+        local st1 = s1.index.pk:stat().disk
+        local st2 = s2.index.pk:stat().disk
+        t.assert_equals(st1.bytes, st2.bytes)
+        t.assert_lt(st2.bytes_compressed, st1.bytes_compressed)
+        t.assert_equals(s2:select(), s1:select())
+    end)
+    -- The dictionary is stored in the .index file.
+    cg.server:restart()
+    cg.server:exec(function()
+        local t = require('luatest')
+        local s1 = box.space.test
+        local s2 = box.space.test_dict
+        t.assert_equals(s2:count(), 4000)
+        t.assert_equals(s2:select(), s1:select())
+        t.assert_equals(s2:get(10001), s1:get(10001))
+    end)
+end
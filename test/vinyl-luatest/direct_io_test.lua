@@ -0,0 +1,63 @@
+local server = require('test.luatest_helpers.server')
+local t = require('luatest')
+
+local g = t.group()
+
+g.before_all(function(cg)
+    cg.server = server:new({
+        alias = 'default',
+        box_cfg = {
+            -- Disable the tuple cache so that all lookups go to disk.
+            vinyl_cache = 0,
+            vinyl_direct_io = true,
+        },
+    })
+    cg.server:start()
+end)
+
+g.after_all(function(cg)
+    cg.server:drop()
+end)
+
+g.test_cfg = function(cg)
+    cg.server:exec(function()
+        local t = require('luatest')
+        t.assert_equals(box.cfg.vinyl_direct_io, true)
+        t.assert_error_msg_contains(
+            "Incorrect value for option 'vinyl_direct_io'",
+            box.cfg, {vinyl_direct_io = 1})
+        box.cfg({vinyl_direct_io = false})
+        box.cfg({vinyl_direct_io = true})
+    end)
+end
+
+-- Pages are read correctly whether or not the file system supports
+-- O_DIRECT, including pages that aren't aligned in the file.
+g.test_read = function(cg)
+    cg.server:exec(function()
+        local s = box.schema.space.create('test', {engine = 'vinyl'})
+        s:create_index('pk', {page_size = 1000, run_count_per_level = 100})
+        for i = 1, 1000 do
+            s:insert({i, string.rep(tostring(i), 20)})
+        end
+        box.snapshot()
+    end)
+    local function check()
+        cg.server:exec(function()
+            local t = require('luatest')
+            local s = box.space.test
+            t.assert_gt(s.index.pk:stat().disk.pages, 1)
+            for i = 1, 1000, 7 do
+                t.assert_equals(s:get({i}), {i, string.rep(tostring(i), 20)})
+            end
+            t.assert_equals(s:count(), 1000)
+        end)
+    end
+    check()
+    -- Runs loaded on recovery are opened for direct I/O too.
+    cg.server:restart()
+    check()
+    cg.server:exec(function()
+        box.space.test:drop()
+    end)
+end
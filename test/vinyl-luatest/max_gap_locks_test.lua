@@ -0,0 +1,75 @@
+local server = require('test.luatest_helpers.server')
+local t = require('luatest')
+
+local g = t.group()
+
+g.before_all(function(cg)
+    cg.server = server:new({
+        alias = 'default',
+        box_cfg = {vinyl_max_gap_locks = 10},
+    })
+    cg.server:start()
+    cg.server:exec(function()
+        local s = box.schema.space.create('test', {engine = 'vinyl'})
+        s:create_index('pk')
+        for i = 1, 100 do
+            s:insert({i})
+        end
+    end)
+end)
+
+g.after_all(function(cg)
+    cg.server:drop()
+end)
+
+g.after_each(function(cg)
+    cg.server:exec(function()
+        box.cfg({vinyl_max_gap_locks = 10})
+        box.space.test:delete({1000})
+    end)
+end)
+
+g.test_cfg = function(cg)
+    cg.server:exec(function()
+        t.assert_equals(box.cfg.vinyl_max_gap_locks, 10)
+        t.assert_error_msg_contains(
+            "Incorrect value for option 'vinyl_max_gap_locks'",
+            box.cfg, {vinyl_max_gap_locks = -1})
+    end)
+end
+
+-- Reads odd keys in a transaction, then replaces key 4 from another
+-- fiber, then writes from the transaction and returns the result of
+-- its commit.
+local function read_and_write()
+    local fiber = require('fiber')
+    local s = box.space.test
+    local gap_locks = box.stat.vinyl().tx.gap_locks
+    local max_gap_locks = 0
+    box.begin()
+    for i = 1, 39, 2 do
+        s:get({i})
+        max_gap_locks = math.max(max_gap_locks,
+                                 box.stat.vinyl().tx.gap_locks - gap_locks)
+    end
+    local f = fiber.new(s.replace, s, {4})
+    f:set_joinable(true)
+    f:join()
+    s:replace({1000})
+    local ok = pcall(box.commit)
+    return ok, max_gap_locks
+end
+
+g.test_coarsen = function(cg)
+    local ok, max_gap_locks = cg.server:exec(read_and_write)
+    -- The reads were coarsened into one interval spanning key 4.
+    t.assert_not(ok)
+    t.assert_le(max_gap_locks, 10)
+end
+
+g.test_no_limit = function(cg)
+    cg.server:exec(function() box.cfg({vinyl_max_gap_locks = 0}) end)
+    local ok, max_gap_locks = cg.server:exec(read_and_write)
+    t.assert(ok)
+    t.assert_equals(max_gap_locks, 20)
+end
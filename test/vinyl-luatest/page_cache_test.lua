@@ -0,0 +1,93 @@
+local server = require('test.luatest_helpers.server')
+local t = require('luatest')
+
+local g = t.group()
+
+g.before_all(function(cg)
+    cg.server = server:new({
+        alias = 'default',
+        box_cfg = {
+            -- Disable the tuple cache so that all lookups go to disk.
+            vinyl_cache = 0,
+            vinyl_page_cache = 1024 * 1024,
+        },
+    })
+    cg.server:start()
+    cg.server:exec(function()
+        local s = box.schema.space.create('test', {engine = 'vinyl'})
+        s:create_index('pk', {page_size = 1024, run_count_per_level = 100})
+        for i = 1, 1000 do
+            s:insert({i, string.rep('x', 100)})
+        end
+        box.snapshot()
+    end)
+end)
+
+g.after_all(function(cg)
+    cg.server:drop()
+end)
+
+g.after_each(function(cg)
+    cg.server:exec(function()
+        box.cfg({vinyl_page_cache = 1024 * 1024})
+    end)
+end)
+
+g.test_cfg = function(cg)
+    cg.server:exec(function()
+        local t = require('luatest')
+        t.assert_equals(box.cfg.vinyl_page_cache, 1024 * 1024)
+        t.assert_error_msg_content_equals(
+            "Incorrect value for option 'vinyl_page_cache': " ..
+            "should be of type number",
+            box.cfg, {vinyl_page_cache = 'foo'})
+    end)
+end
+
+g.test_hit = function(cg)
+    cg.server:exec(function()
+        local t = require('luatest')
+        local s = box.space.test
+        local function pages_read()
+            return s.index.pk:stat().disk.iterator.read.pages
+        end
+        local st = box.stat.vinyl().page_cache
+        local pages = pages_read()
+        t.assert_equals(s:get(500), {500, string.rep('x', 100)})
+        t.assert_equals(pages_read() - pages, 1)
+        t.assert_equals(box.stat.vinyl().page_cache.miss - st.miss, 1)
+        t.assert_gt(box.stat.vinyl().page_cache.used, 0)
+        -- The page is taken from the cache, no disk reads.
+        st = box.stat.vinyl().page_cache
+        pages = pages_read()
+        t.assert_equals(s:get(500), {500, string.rep('x', 100)})
+        t.assert_equals(pages_read() - pages, 0)
+        t.assert_equals(box.stat.vinyl().page_cache.hit - st.hit, 1)
+        t.assert_equals(box.stat.vinyl().page_cache.miss - st.miss, 0)
+    end)
+end
+
+g.test_evict = function(cg)
+    cg.server:exec(function()
+        local t = require('luatest')
+        local s = box.space.test
+        local quota = 16 * 1024
+        box.cfg({vinyl_page_cache = quota})
+        local st = box.stat.vinyl().page_cache
+        for i = 1, 1000 do
+            s:get(i)
+        end
+        local stat = box.stat.vinyl().page_cache
+        t.assert_le(stat.used, quota)
+        t.assert_gt(stat.evict - st.evict, 0)
+        -- Zero quota disables the cache.
+        box.cfg({vinyl_page_cache = 0})
+        t.assert_equals(box.stat.vinyl().page_cache.used, 0)
+        st = box.stat.vinyl().page_cache
+        s:get(1)
+        s:get(1)
+        stat = box.stat.vinyl().page_cache
+        t.assert_equals(stat.hit - st.hit, 0)
+        t.assert_equals(stat.miss - st.miss, 0)
+    end)
+end
@@ -0,0 +1,103 @@
+local server = require('test.luatest_helpers.server')
+local t = require('luatest')
+
+local g = t.group()
+
+g.before_all(function(cg)
+    cg.server = server:new({
+        alias = 'default',
+        box_cfg = {
+            -- Disable the tuple cache so that all lookups go to disk.
+            vinyl_cache = 0,
+        },
+    })
+    cg.server:start()
+    cg.server:exec(function()
+        local s = box.schema.space.create('test', {engine = 'vinyl'})
+        s:create_index('pk', {
+            parts = {{1, 'unsigned'}, {2, 'string'}},
+            page_size = 512,
+        })
+        s:create_index('sk', {
+            parts = {{3, 'unsigned'}},
+            unique = false,
+            page_size = 512,
+        })
+        for i = 1, 200 do
+            for _, k in ipairs({'a', 'b'}) do
+                s:insert({i, k, i % 17, string.rep('x', 20)})
+            end
+        end
+        box.snapshot()
+        -- Put DELETE and UPSERT statements into a newer run.
+        for i = 1, 200, 3 do
+            s:delete({i, 'a'})
+        end
+        for i = 2, 200, 5 do
+            s:upsert({i, 'b', i % 17, 'y'}, {{'=', 4, 'y'}})
+        end
+        box.snapshot()
+    end)
+end)
+
+g.after_all(function(cg)
+    cg.server:drop()
+end)
+
+-- Lookups by full and partial keys return the same result as a
+-- filtered full scan, for every iterator type.
+g.test_find_key = function(cg)
+    cg.server:exec(function()
+        local t = require('luatest')
+        local s = box.space.test
+        local all = s:select()
+        local function filter(index, key, it)
+            local key_def = require('key_def').new(index.parts)
+            local res = {}
+            for _, tuple in ipairs(all) do
+                local cmp = key_def:compare_with_key(tuple, key)
+                if (it == 'EQ' and cmp == 0) or (it == 'GE' and cmp >= 0) or
+                   (it == 'GT' and cmp > 0) or (it == 'LE' and cmp <= 0) or
+                   (it == 'LT' and cmp < 0) then
+                    table.insert(res, tuple)
+                end
+            end
+            if it == 'LE' or it == 'LT' then
+                local rev = {}
+                for i = #res, 1, -1 do
+                    table.insert(rev, res[i])
+                end
+                res = rev
+            end
+            return res
+        end
+        local function check(index, key, it)
+            local res = index:select(key, {iterator = it})
+            local expected = filter(index, key, it)
+            if index.id ~= 0 then
+                -- Secondary key duplicates are ordered by the
+                -- primary key, so compare as sets.
+                local key_def = require('key_def').new(s.index.pk.parts)
+                table.sort(res, function(a, b)
+                    return key_def:compare(a, b) < 0
+                end)
+                table.sort(expected, function(a, b)
+                    return key_def:compare(a, b) < 0
+                end)
+            end
+            t.assert_equals(res, expected,
+                            string.format('%s %s %s', index.name,
+                                          require('json').encode(key), it))
+        end
+        for _, it in ipairs({'EQ', 'GE', 'GT', 'LE', 'LT'}) do
+            for _, i in ipairs({1, 2, 3, 4, 50, 99, 100, 101, 199, 200}) do
+                check(s.index.pk, {i}, it)
+                check(s.index.pk, {i, 'a'}, it)
+                check(s.index.pk, {i, 'b'}, it)
+            end
+            for i = 0, 17 do
+                check(s.index.sk, {i}, it)
+            end
+        end
+    end)
+end
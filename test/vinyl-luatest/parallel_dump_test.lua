@@ -0,0 +1,71 @@
+local server = require('test.luatest_helpers.server')
+local t = require('luatest')
+
+local g = t.group()
+
+g.before_all(function(cg)
+    -- A quarter of write threads is used for dump.
+    cg.server = server:new({alias = 'default',
+                            box_cfg = {vinyl_write_threads = 8}})
+    cg.server:start()
+end)
+
+g.after_all(function(cg)
+    cg.server:drop()
+end)
+
+g.test_parallel_dump = function(cg)
+    cg.server:exec(function()
+        local t = require('luatest')
+        local s = box.schema.space.create('test', {engine = 'vinyl'})
+        local pk = s:create_index('pk', {page_size = 256, range_size = 8192,
+                                         run_count_per_level = 1,
+                                         run_size_ratio = 1000})
+        local key_count = 512
+        local pad = string.rep('x', 32)
+        local function rewrite(iter)
+            for k = 1, key_count do
+                s:replace({k, iter, pad})
+            end
+        end
+        -- Rewrite the space until enough ranges are created.
+        local iter = 0
+        t.helpers.retrying({timeout = 60}, function()
+            iter = iter + 1
+            rewrite(iter)
+            box.snapshot()
+            t.assert_ge(pk:stat().range_count, 4)
+        end)
+        -- Disable compaction so that new runs stay as they are.
+        pk:alter({run_count_per_level = 100})
+        t.helpers.retrying({}, function()
+            t.assert_equals(box.stat.vinyl().scheduler.tasks_inprogress, 0)
+        end)
+        local stat = pk:stat()
+        for _ = 1, 4 do
+            iter = iter + 1
+            rewrite(iter)
+        end
+        box.snapshot()
+        -- The dump is split into tasks writing separate runs
+        -- while each range still receives one slice.
+        local new_stat = pk:stat()
+        t.assert_equals(new_stat.disk.dump.count, stat.disk.dump.count + 1)
+        t.assert_gt(new_stat.run_count, stat.run_count + 1)
+        t.assert_equals(s:count(), key_count)
+        for k = 1, key_count do
+            t.assert_equals(s:get(k), {k, iter, pad})
+        end
+    end)
+    cg.server:restart()
+    cg.server:exec(function()
+        local t = require('luatest')
+        local s = box.space.test
+        t.assert_equals(s:count(), 512)
+        local iter = s:get(1)[2]
+        for _, tuple in s:pairs() do
+            t.assert_equals(tuple[2], iter)
+        end
+        s:drop()
+    end)
+end
@@ -0,0 +1,62 @@
+local server = require('test.luatest_helpers.server')
+local t = require('luatest')
+
+local g = t.group()
+
+g.before_all(function(cg)
+    cg.server = server:new({
+        alias = 'default',
+        box_cfg = {vinyl_cache = 0},
+    })
+    cg.server:start()
+end)
+
+g.after_all(function(cg)
+    cg.server:drop()
+end)
+
+g.after_each(function(cg)
+    cg.server:exec(function()
+        if box.space.test ~= nil then
+            box.space.test:drop()
+        end
+    end)
+end)
+
+-- Point lookups read all runs that may store the key at the same
+-- time. Check that the history is still merged from newer runs to
+-- older ones.
+g.test_history = function(cg)
+    cg.server:exec(function()
+        local t = require('luatest')
+        local s = box.schema.space.create('test', {engine = 'vinyl'})
+        -- Disable bloom filters so that every run is read and
+        -- compaction so that every dump creates a new run.
+        s:create_index('pk', {bloom_fpr = 1, run_count_per_level = 100})
+        for i = 1, 10 do
+            s:replace({i, 0})
+        end
+        box.snapshot()
+        for i = 1, 10, 2 do
+            s:upsert({i, 0}, {{'+', 2, 1}})
+        end
+        box.snapshot()
+        for i = 1, 10, 3 do
+            s:delete({i})
+        end
+        box.snapshot()
+        for i = 1, 10, 4 do
+            s:upsert({i, 100}, {{'+', 2, 10}})
+        end
+        box.snapshot()
+        t.assert_equals(s.index.pk:stat().run_count, 4)
+        local expected = {
+            {1, 100}, {2, 0}, {3, 1}, nil, {5, 11},
+            {6, 0}, nil, {8, 0}, {9, 11}, nil,
+        }
+        for i = 1, 10 do
+            t.assert_equals(s:get({i}), expected[i], i)
+        end
+        t.assert_equals(s:get({11}), nil)
+    end)
+end
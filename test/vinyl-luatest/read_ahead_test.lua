@@ -0,0 +1,101 @@
+local server = require('test.luatest_helpers.server')
+local t = require('luatest')
+
+local g = t.group()
+
+g.before_all(function(cg)
+    cg.server = server:new({
+        alias = 'default',
+        box_cfg = {
+            -- Disable the tuple cache so that all reads go to disk.
+            vinyl_cache = 0,
+            vinyl_read_ahead = 4,
+        },
+    })
+    cg.server:start()
+    cg.server:exec(function()
+        local s = box.schema.space.create('test', {engine = 'vinyl'})
+        s:create_index('pk', {page_size = 1024, run_count_per_level = 100})
+        for i = 1, 1000 do
+            s:insert({i, string.rep('x', 100)})
+        end
+        box.snapshot()
+    end)
+end)
+
+g.after_all(function(cg)
+    cg.server:drop()
+end)
+
+g.after_each(function(cg)
+    cg.server:exec(function()
+        box.cfg({vinyl_read_ahead = 4})
+    end)
+end)
+
+g.test_cfg = function(cg)
+    cg.server:exec(function()
+        local t = require('luatest')
+        t.assert_equals(box.cfg.vinyl_read_ahead, 4)
+        t.assert_error_msg_content_equals(
+            "Incorrect value for option 'vinyl_read_ahead': " ..
+            "should be of type number",
+            box.cfg, {vinyl_read_ahead = 'foo'})
+        t.assert_error_msg_content_equals(
+            "Incorrect value for option 'vinyl_read_ahead': " ..
+            "must be greater than or equal to 0",
+            box.cfg, {vinyl_read_ahead = -1})
+    end)
+end
+
+local function check_scan(cg, iterator)
+    cg.server:exec(function(iterator)
+        local t = require('luatest')
+        local s = box.space.test
+        local st = s.index.pk:stat().disk.iterator
+        t.assert_equals(#s:select({}, {iterator = iterator}), 1000)
+        local stat = s.index.pk:stat().disk.iterator
+        local pages = stat.read.pages - st.read.pages
+        t.assert_gt(pages, 10)
+        -- Read-ahead starts from the third page of a scan.
+        local hit = stat.prefetch.hit - st.prefetch.hit
+        t.assert_gt(hit, pages / 2)
+        t.assert_le(hit, pages - 2)
+        t.assert_ge(stat.prefetch.pages - st.prefetch.pages, hit)
+    end, {iterator})
+end
+
+g.test_forward_scan = function(cg)
+    check_scan(cg, 'GE')
+end
+
+g.test_backward_scan = function(cg)
+    check_scan(cg, 'LE')
+end
+
+g.test_point_lookup = function(cg)
+    cg.server:exec(function()
+        local t = require('luatest')
+        local s = box.space.test
+        local st = s.index.pk:stat().disk.iterator
+        for i = 1, 1000, 100 do
+            t.assert_equals(s:get(i), {i, string.rep('x', 100)})
+        end
+        local stat = s.index.pk:stat().disk.iterator
+        t.assert_equals(stat.prefetch.pages - st.prefetch.pages, 0)
+    end)
+end
+
+g.test_disable = function(cg)
+    cg.server:exec(function()
+        local t = require('luatest')
+        local s = box.space.test
+        box.cfg({vinyl_read_ahead = 0})
+        local st = s.index.pk:stat().disk.iterator
+        t.assert_equals(#s:select(), 1000)
+        local stat = s.index.pk:stat().disk.iterator
+        t.assert_gt(stat.read.pages - st.read.pages, 10)
+        t.assert_equals(stat.prefetch.pages - st.prefetch.pages, 0)
+        t.assert_equals(stat.prefetch.hit - st.prefetch.hit, 0)
+    end)
+end
@@ -0,0 +1,45 @@
+local server = require('test.luatest_helpers.server')
+local t = require('luatest')
+
+local g = t.group()
+
+g.before_all(function(cg)
+    cg.server = server:new({alias = 'default'})
+    cg.server:start()
+    cg.server:exec(function()
+        local s = box.schema.space.create('test', {engine = 'vinyl'})
+        s:create_index('pk')
+    end)
+end)
+
+g.after_all(function(cg)
+    cg.server:drop()
+end)
+
+g.test_burst = function(cg)
+    cg.server:exec(function()
+        local r = box.stat.vinyl().regulator
+        t.assert_equals(r.bursts, 0)
+        t.assert_equals(r.early_dumps, 0)
+        t.assert_equals(r.throttle_avoided, 0)
+        t.assert_equals(r.write_rate_forecast, 0)
+
+        -- Write a few megabytes at once after a period of silence.
+        local s = box.space.test
+        local pad = string.rep('x', 1000)
+        box.begin()
+        for i = 1, 5000 do
+            s:insert({i, pad})
+        end
+        box.commit()
+
+        t.helpers.retrying({timeout = 10}, function()
+            r = box.stat.vinyl().regulator
+            t.assert_ge(r.bursts, 1)
+            t.assert_ge(r.write_rate_forecast, 1024 * 1024)
+        end)
+
+        box.stat.reset()
+        t.assert_equals(box.stat.vinyl().regulator.bursts, 0)
+    end)
+end
@@ -0,0 +1,55 @@
+local server = require('test.luatest_helpers.server')
+local t = require('luatest')
+
+local g = t.group()
+
+g.before_all(function(cg)
+    -- Three quarters of write threads are used for compaction.
+    cg.server = server:new({alias = 'default',
+                            box_cfg = {vinyl_write_threads = 8}})
+    cg.server:start()
+end)
+
+g.after_all(function(cg)
+    cg.server:drop()
+end)
+
+g.test_subcompaction = function(cg)
+    cg.server:exec(function()
+        local t = require('luatest')
+        local s = box.schema.space.create('test', {engine = 'vinyl'})
+        local pk = s:create_index('pk', {page_size = 256, range_size = 16384,
+                                         run_count_per_level = 1})
+        local pad = string.rep('x', 32)
+        for iter = 1, 2 do
+            for k = 1, 2048 do
+                s:replace({k, iter, pad})
+            end
+            box.snapshot()
+        end
+        -- The range is much bigger than range_size so its
+        -- compaction is split among compaction threads and
+        -- the range is replaced with a range per thread.
+        t.helpers.retrying({}, function()
+            t.assert_equals(pk:stat().disk.compaction.count, 1)
+        end)
+        local stat = pk:stat()
+        t.assert_gt(stat.range_count, 1)
+        t.assert_equals(stat.run_count, stat.range_count)
+        t.assert_equals(s:count(), 2048)
+        for k = 1, 2048 do
+            t.assert_equals(s:get(k), {k, 2, pad})
+        end
+    end)
+    cg.server:restart()
+    cg.server:exec(function()
+        local t = require('luatest')
+        local s = box.space.test
+        t.assert_gt(s.index.pk:stat().range_count, 1)
+        t.assert_equals(s:count(), 2048)
+        for _, tuple in s:pairs() do
+            t.assert_equals(tuple[2], 2)
+        end
+        s:drop()
+    end)
+end
@@ -0,0 +1,88 @@
+local server = require('test.luatest_helpers.server')
+local t = require('luatest')
+
+local g = t.group()
+
+g.before_all(function(cg)
+    cg.server = server:new({alias = 'default'})
+    cg.server:start()
+    cg.server:exec(function()
+        local s = box.schema.space.create('test', {engine = 'vinyl'})
+        s:create_index('pk')
+        s:create_index('sk1', {parts = {2, 'unsigned'}})
+        s:create_index('sk2', {parts = {3, 'unsigned'}, unique = false})
+    end)
+end)
+
+g.after_all(function(cg)
+    cg.server:drop()
+end)
+
+g.after_each(function(cg)
+    cg.server:exec(function()
+        box.space.test:truncate()
+    end)
+end)
+
+-- An update writes to a secondary index only if it may change
+-- the key of the index.
+g.test_update = function(cg)
+    cg.server:exec(function()
+        local s = box.space.test
+        for i = 1, 10 do
+            s:insert({i, i * 10, i % 3, 'x'})
+        end
+        box.snapshot()
+
+        box.begin()
+        s:update(1, {{'=', 4, 'y'}})
+        s:upsert({2, 0, 0, 'x'}, {{'=', 4, 'z'}})
+        t.assert_equals(s.index.pk:stat().txw.rows, 2)
+        t.assert_equals(s.index.sk1:stat().txw.rows, 0)
+        t.assert_equals(s.index.sk2:stat().txw.rows, 0)
+        s:update(3, {{'+', 3, 1}})
+        t.assert_equals(s.index.sk1:stat().txw.rows, 0)
+        t.assert_equals(s.index.sk2:stat().txw.rows, 2)
+        box.commit()
+
+        local function check()
+            t.assert_equals(s:get(1), {1, 10, 1, 'y'})
+            t.assert_equals(s.index.sk1:get(10), {1, 10, 1, 'y'})
+            t.assert_equals(s.index.sk1:get(20), {2, 20, 2, 'z'})
+            t.assert_equals(s.index.sk2:select(1, {iterator = 'EQ'}),
+                            {{1, 10, 1, 'y'}, {3, 30, 1, 'x'},
+                             {4, 40, 1, 'x'}, {7, 70, 1, 'x'},
+                             {10, 100, 1, 'x'}})
+            t.assert_equals(s.index.sk2:select(0), {{6, 60, 0, 'x'},
+                                                    {9, 90, 0, 'x'}})
+            t.assert_equals(s.index.sk1:count(), 10)
+            t.assert_equals(s.index.sk2:count(), 10)
+        end
+        check()
+        box.snapshot()
+        check()
+        s.index.sk1:compact()
+        s.index.sk2:compact()
+        check()
+    end)
+end
+
+-- Updates of non-key fields of a tuple changed earlier by the same
+-- transaction.
+g.test_update_after_replace = function(cg)
+    cg.server:exec(function()
+        local s = box.space.test
+        s:insert({1, 10, 1, 'a'})
+        box.begin()
+        s:replace({1, 20, 2, 'b'})
+        s:update(1, {{'=', 4, 'c'}})
+        s:update(1, {{'=', 2, 30}})
+        s:update(1, {{'=', 4, 'd'}})
+        box.commit()
+        t.assert_equals(s.index.sk1:select(), {{1, 30, 2, 'd'}})
+        t.assert_equals(s.index.sk2:select(), {{1, 30, 2, 'd'}})
+        box.snapshot()
+        t.assert_equals(s.index.sk1:select(), {{1, 30, 2, 'd'}})
+        t.assert_equals(s.index.sk2:select(), {{1, 30, 2, 'd'}})
+    end)
+end
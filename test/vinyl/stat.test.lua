@@ -72,11 +72,17 @@ end;
 --
 -- Filter dump/compaction time as we need error injection to
 -- test them properly.
+--
+-- Compaction policy is a string so filter it out, too.
+--
+-- Read-ahead statistics are checked by vinyl-luatest/read_ahead_test.
 function istat()
     local st = box.space.test.index.pk:stat()
     st.latency = nil
     st.disk.dump.time = nil
     st.disk.compaction.time = nil
+    st.disk.compaction.policy = nil
+    st.disk.iterator.prefetch = nil
     return st
 end;
 
@@ -85,11 +91,14 @@ end;
 -- Note, checking correctness of the load regulator logic is beyond
 -- the scope of this test so we just filter out related statistics.
 --
+-- Page cache statistics are checked by vinyl-luatest/page_cache_test.
+--
 -- Filter dump/compaction time as we need error injection to
 -- test them properly.
 function gstat()
     local st = box.stat.vinyl()
     st.regulator = nil
+    st.page_cache = nil
     st.scheduler.dump_time = nil
     st.scheduler.compaction_time = nil
     return st
@@ -42,6 +42,9 @@
 #include <string.h>
 #include <math.h>
 #include <limits.h>
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
 #include <lua.h>
 #include <lauxlib.h>
 
@@ -55,6 +58,11 @@
 #include "core/datetime.h"
 #include "cord_buf.h"
 #include "tt_uuid.h" /* tt_uuid_to_string(), UUID_STR_LEN */
+#include "core/mp_datetime.h"
+#include "core/mp_uuid.h"
+#include "lua/msgpack.h" /* luamp_push(), luamp_get() */
+#include <msgpuck.h>
+#include <small/ibuf.h>
 
 typedef enum {
     T_OBJ_BEGIN,
@@ -105,6 +113,7 @@ static char escape2char[256];  /* Decoding */
 typedef struct {
     const char *data;
     const char *ptr;
+    const char *end;  /* End of data, points to the terminating '\0' */
     strbuf_t *tmp;    /* Temporary storage for strings */
     struct luaL_serializer *cfg;
     int current_depth;
@@ -229,6 +238,37 @@ static void json_create_tokens()
 
 /* ===== ENCODING ===== */
 
+/* Returns the length of the longest prefix of str which doesn't need
+ * escaping, i.e. has no characters with a char2escape[] entry.
+ * With SSE2 16 bytes are checked at a time. */
+static size_t json_plain_span(const char *str, size_t len)
+{
+    size_t i = 0;
+#if defined(__SSE2__)
+    const __m128i ctrl = _mm_set1_epi8(0x1f);
+    const __m128i quote = _mm_set1_epi8('"');
+    const __m128i bslash = _mm_set1_epi8('\\');
+    const __m128i slash = _mm_set1_epi8('/');
+    const __m128i del = _mm_set1_epi8(0x7f);
+
+    for (; i + 16 <= len; i += 16) {
+        __m128i v = _mm_loadu_si128((const __m128i *)(str + i));
+        /* Unsigned v <= 0x1f */
+        __m128i m = _mm_cmpeq_epi8(_mm_min_epu8(v, ctrl), v);
+        m = _mm_or_si128(m, _mm_cmpeq_epi8(v, quote));
+        m = _mm_or_si128(m, _mm_cmpeq_epi8(v, bslash));
+        m = _mm_or_si128(m, _mm_cmpeq_epi8(v, slash));
+        m = _mm_or_si128(m, _mm_cmpeq_epi8(v, del));
+        int mask = _mm_movemask_epi8(m);
+        if (mask != 0)
+            return i + __builtin_ctz(mask);
+    }
+#endif
+    while (i < len && char2escape[(unsigned char)str[i]] == NULL)
+        i++;
+    return i;
+}
+
 /* json_append_string args:
  * - lua_State
  * - JSON strbuf
@@ -239,8 +279,7 @@ static void json_append_string(struct luaL_serializer *cfg, strbuf_t *json,
                    const char *str, size_t len)
 {
     (void) cfg;
-    const char *escstr;
-    size_t i;
+    size_t n;
 
     /* Worst case is len * 6 (all unicode escapes).
      * This buffer is reused constantly for small strings
@@ -249,12 +288,17 @@ static void json_append_string(struct luaL_serializer *cfg, strbuf_t *json,
     strbuf_ensure_empty_length(json, len * 6 + 2);
 
     strbuf_append_char_unsafe(json, '\"');
-    for (i = 0; i < len; i++) {
-        escstr = char2escape[(unsigned char)str[i]];
-        if (escstr)
-            strbuf_append_string(json, escstr);
-        else
-            strbuf_append_char_unsafe(json, str[i]);
+    while (len > 0) {
+        /* Copy characters which don't need escaping in bulk */
+        n = json_plain_span(str, len);
+        strbuf_append_mem_unsafe(json, str, n);
+        str += n;
+        len -= n;
+        if (len == 0)
+            break;
+        strbuf_append_string(json, char2escape[(unsigned char)*str]);
+        str++;
+        len--;
     }
     strbuf_append_char_unsafe(json, '\"');
 }
@@ -627,6 +671,35 @@ static void json_set_token_error(json_token_t *token, json_parse_t *json,
     token->value.string = errtype;
 }
 
+/* Returns the number of characters at ptr up to the closing quote,
+ * an escape or the end of data, which can be copied to the decoded
+ * string as is. */
+static size_t json_string_span(const char *ptr, const char *end)
+{
+    const char *p = ptr;
+#if defined(__SSE2__)
+    const __m128i quote = _mm_set1_epi8('"');
+    const __m128i bslash = _mm_set1_epi8('\\');
+    const __m128i zero = _mm_setzero_si128();
+
+    /* Don't read past the end of data: the string isn't padded */
+    for (; p + 16 <= end; p += 16) {
+        __m128i v = _mm_loadu_si128((const __m128i *)p);
+        __m128i m = _mm_cmpeq_epi8(v, quote);
+        m = _mm_or_si128(m, _mm_cmpeq_epi8(v, bslash));
+        m = _mm_or_si128(m, _mm_cmpeq_epi8(v, zero));
+        int mask = _mm_movemask_epi8(m);
+        if (mask != 0)
+            return p - ptr + __builtin_ctz(mask);
+    }
+#else
+    (void) end;
+#endif
+    while (*p != '"' && *p != '\\' && *p != '\0')
+        p++;
+    return p - ptr;
+}
+
 static void json_next_string_token(json_parse_t *json, json_token_t *token)
 {
     char ch;
@@ -644,6 +717,13 @@ static void json_next_string_token(json_parse_t *json, json_token_t *token)
     strbuf_reset(json->tmp);
 
     while ((ch = *json->ptr) != '"') {
+        /* Copy characters which don't need decoding in bulk */
+        size_t n = json_string_span(json->ptr, json->end);
+        if (n > 0) {
+            strbuf_append_mem_unsafe(json->tmp, json->ptr, n);
+            json->ptr += n;
+            continue;
+        }
         if (!ch) {
             /* Premature end of the string */
             json_set_token_error(token, json, "unexpected end of string");
@@ -1070,10 +1150,13 @@ static void json_process_value(lua_State *l, json_parse_t *json,
     }
 }
 
-static int json_decode(lua_State *l)
+/* Prepares json for parsing the string at index 1 of the Lua stack with
+ * the serializer options, overridden by the table at index 2 if given.
+ * user_cfg is used for the overridden options, so it must live as long
+ * as json. The temporary string buffer is allocated on a cord ibuf. */
+static void json_parse_begin(lua_State *l, json_parse_t *json,
+                             struct luaL_serializer *user_cfg)
 {
-    json_parse_t json;
-    json_token_t token;
     size_t json_len;
 
     luaL_argcheck(l, lua_gettop(l) == 2 || lua_gettop(l) == 1, 1,
@@ -1089,53 +1172,493 @@ static int json_decode(lua_State *l)
      * Life span of user_cfg is restricted by the scope of
      * :decode() so it is enough to allocate it on the stack.
      */
-    struct luaL_serializer user_cfg;
-    json.cfg = cfg;
+    json->cfg = cfg;
     if (lua_gettop(l) == 2) {
         /*
          * on_update triggers are left uninitialized for user_cfg.
          * The decoding code don't (and shouldn't) run them.
          */
-        luaL_serializer_copy_options(&user_cfg, cfg);
-        luaL_serializer_parse_options(l, &user_cfg);
+        luaL_serializer_copy_options(user_cfg, cfg);
+        luaL_serializer_parse_options(l, user_cfg);
         lua_pop(l, 1);
-        json.cfg = &user_cfg;
+        json->cfg = user_cfg;
     }
 
-    json.data = luaL_checklstring(l, 1, &json_len);
-    json.current_depth = 0;
-    json.ptr = json.data;
-    json.line_count = 1;
-    json.cur_line_ptr = json.data;
+    json->data = luaL_checklstring(l, 1, &json_len);
+    json->current_depth = 0;
+    json->ptr = json->data;
+    json->end = json->data + json_len;
+    json->line_count = 1;
+    json->cur_line_ptr = json->data;
 
     /* Detect Unicode other than UTF-8 (see RFC 4627, Sec 3)
      *
      * CJSON can support any simple data type, hence only the first
      * character is guaranteed to be ASCII (at worst: '"'). This is
      * still enough to detect whether the wrong encoding is in use. */
-    if (json_len >= 2 && (!json.data[0] || !json.data[1]))
+    if (json_len >= 2 && (!json->data[0] || !json->data[1]))
         luaL_error(l, "JSON parser does not support UTF-16 or UTF-32");
 
     /* Ensure the temporary buffer can hold the entire string.
      * This means we no longer need to do length checks since the decoded
      * string must be smaller than the entire json string */
+    strbuf_create(json->tmp, json_len, cord_ibuf_take());
+}
+
+/* Ensures there is no more input left and frees the temporary buffer.
+ * The cord ibuf it was allocated on is returned to be put back. */
+static struct ibuf *json_parse_end(lua_State *l, json_parse_t *json)
+{
+    json_token_t token;
+
+    json_next_token(json, &token);
+
+    if (token.type != T_END)
+        json_throw_parse_error(l, json, "the end", &token);
+
+    struct ibuf *ibuf = json->tmp->ibuf;
+    strbuf_destroy(json->tmp);
+    return ibuf;
+}
+
+static int json_decode(lua_State *l)
+{
+    json_parse_t json;
+    json_token_t token;
+    struct luaL_serializer user_cfg;
     strbuf_t decode_buf;
+
     json.tmp = &decode_buf;
-    struct ibuf *ibuf = cord_ibuf_take();
-    strbuf_create(&decode_buf, json_len, ibuf);
+    json_parse_begin(l, &json, &user_cfg);
 
     json_next_token(&json, &token);
     json_process_value(l, &json, &token);
 
-    /* Ensure there is no more input left */
+    cord_ibuf_put(json_parse_end(l, &json));
+    return 1;
+}
+
+/* ===== TRANSCODING ===== */
+
+/* json.to_msgpack() parses JSON with the same tokenizer as json.decode()
+ * and writes MsgPack right away, without creating Lua objects. The number
+ * of elements of an array or a map isn't known until its end, so the
+ * maximal header is reserved and then shrunk.
+ *
+ * MsgPack is written to the cord ibuf holding the temporary string buffer
+ * of the tokenizer, right after it. So the string buffer is at the read
+ * position of the ibuf and moves along with it when the ibuf grows. */
+
+enum {
+    /* Size of an array32 or map32 header */
+    JSON_MP_HEADER_MAX = 5,
+};
+
+static char *json_mp_reserve(lua_State *l, json_parse_t *json,
+                             struct ibuf *out, size_t size)
+{
+    char *p = ibuf_reserve(out, size);
+    if (p == NULL)
+        luaL_error(l, "Failed to allocate %d bytes for MsgPack", (int)size);
+    json->tmp->buf = out->rpos;
+    return p;
+}
+
+/* Reserves a container header, returns its offset in out */
+static size_t json_mp_begin_container(lua_State *l, json_parse_t *json,
+                                      struct ibuf *out)
+{
+    json_mp_reserve(l, json, out, JSON_MP_HEADER_MAX);
+    size_t offset = ibuf_used(out);
+    out->wpos += JSON_MP_HEADER_MAX;
+    return offset;
+}
+
+/* Writes the header of a container of count elements at offset, moving
+ * the elements closer if the header is shorter than the reserved one */
+static void json_mp_end_container(struct ibuf *out, size_t offset,
+                                  uint32_t count, bool is_map)
+{
+    char *header = out->rpos + offset;
+    char *data = header + JSON_MP_HEADER_MAX;
+    uint32_t size = is_map ? mp_sizeof_map(count) : mp_sizeof_array(count);
+    memmove(header + size, data, out->wpos - data);
+    out->wpos -= JSON_MP_HEADER_MAX - size;
+    if (is_map)
+        mp_encode_map(header, count);
+    else
+        mp_encode_array(header, count);
+}
+
+static void json_mp_process_value(lua_State *l, json_parse_t *json,
+                                  json_token_t *token, struct ibuf *out);
+
+static void json_mp_parse_object_context(lua_State *l, json_parse_t *json,
+                                         struct ibuf *out)
+{
+    json_token_t token;
+    uint32_t count = 0;
+
+    json_decode_descend(l, json, 0);
+    size_t offset = json_mp_begin_container(l, json, out);
+
+    json_next_token(json, &token);
+
+    /* Handle empty objects */
+    if (token.type == T_OBJ_END)
+        goto done;
+
+    while (1) {
+        if (token.type != T_STRING)
+            json_throw_parse_error(l, json, "object key string", &token);
+
+        /* Key. Unlike in a Lua table, duplicate keys are kept. */
+        json_mp_process_value(l, json, &token, out);
+
+        json_next_token(json, &token);
+        if (token.type != T_COLON)
+            json_throw_parse_error(l, json, "colon", &token);
+
+        /* Value */
+        json_next_token(json, &token);
+        json_mp_process_value(l, json, &token, out);
+        count++;
+
+        json_next_token(json, &token);
+
+        if (token.type == T_OBJ_END)
+            goto done;
+
+        if (token.type != T_COMMA)
+            json_throw_parse_error(l, json, "comma or '}'", &token);
+
+        json_next_token(json, &token);
+    }
+done:
+    json_mp_end_container(out, offset, count, true);
+    json_decode_ascend(json);
+}
+
+static void json_mp_parse_array_context(lua_State *l, json_parse_t *json,
+                                        struct ibuf *out)
+{
+    json_token_t token;
+    uint32_t count = 0;
+
+    json_decode_descend(l, json, 0);
+    size_t offset = json_mp_begin_container(l, json, out);
+
+    json_next_token(json, &token);
+
+    /* Handle empty arrays */
+    if (token.type == T_ARR_END)
+        goto done;
+
+    while (1) {
+        json_mp_process_value(l, json, &token, out);
+        count++;
+
+        json_next_token(json, &token);
+
+        if (token.type == T_ARR_END)
+            goto done;
+
+        if (token.type != T_COMMA)
+            json_throw_parse_error(l, json, "comma or ']'", &token);
+
+        json_next_token(json, &token);
+    }
+done:
+    json_mp_end_container(out, offset, count, false);
+    json_decode_ascend(json);
+}
+
+static void json_mp_process_value(lua_State *l, json_parse_t *json,
+                                  json_token_t *token, struct ibuf *out)
+{
+    struct luaL_field field;
+    char *p;
+
+    switch (token->type) {
+    case T_STRING:
+    {
+        /* The string is in json->tmp, which moves on reserve */
+        size_t offset = token->value.string - json->tmp->buf;
+        p = json_mp_reserve(l, json, out, mp_sizeof_str(token->string_len));
+        out->wpos = mp_encode_str(p, json->tmp->buf + offset,
+                                  token->string_len);
+        break;
+    }
+    case T_UINT:
+        field.type = MP_UINT;
+        field.ival = token->value.ival;
+        goto number;
+    case T_INT:
+        field.type = token->value.ival >= 0 ? MP_UINT : MP_INT;
+        field.ival = token->value.ival;
+        goto number;
+    case T_NUMBER:
+        /* Encode as luamp_encode() would encode the decoded number */
+        luaL_checkfinite(l, json->cfg, token->value.number);
+        if (luaL_number_tofield(json->cfg, token->value.number, &field) != 0)
+            luaT_error(l);
+number:
+        if (field.type == MP_UINT) {
+            p = json_mp_reserve(l, json, out, mp_sizeof_uint(field.ival));
+            out->wpos = mp_encode_uint(p, field.ival);
+        } else if (field.type == MP_INT) {
+            p = json_mp_reserve(l, json, out, mp_sizeof_int(field.ival));
+            out->wpos = mp_encode_int(p, field.ival);
+        } else if (field.type == MP_DOUBLE) {
+            p = json_mp_reserve(l, json, out, mp_sizeof_double(field.dval));
+            out->wpos = mp_encode_double(p, field.dval);
+        } else {
+            assert(field.type == MP_NIL);
+            p = json_mp_reserve(l, json, out, mp_sizeof_nil());
+            out->wpos = mp_encode_nil(p);
+        }
+        break;
+    case T_BOOLEAN:
+        p = json_mp_reserve(l, json, out, mp_sizeof_bool(token->value.boolean));
+        out->wpos = mp_encode_bool(p, token->value.boolean);
+        break;
+    case T_OBJ_BEGIN:
+        json_mp_parse_object_context(l, json, out);
+        break;
+    case T_ARR_BEGIN:
+        json_mp_parse_array_context(l, json, out);
+        break;
+    case T_NULL:
+        p = json_mp_reserve(l, json, out, mp_sizeof_nil());
+        out->wpos = mp_encode_nil(p);
+        break;
+    default:
+        json_throw_parse_error(l, json, "value", token);
+    }
+}
+
+/* json.to_msgpack(str[, opts]) returns a msgpack object holding str
+ * converted to MsgPack. It gives the same result as
+ * msgpack.object(json.decode(str)), except that the order and duplicates
+ * of object keys are kept. */
+static int json_to_msgpack(lua_State *l)
+{
+    json_parse_t json;
+    json_token_t token;
+    struct luaL_serializer user_cfg;
+    strbuf_t decode_buf;
+
+    json.tmp = &decode_buf;
+    json_parse_begin(l, &json, &user_cfg);
+
+    /* Put the string buffer at the read position, see above */
+    struct ibuf *out = decode_buf.ibuf;
+    assert(decode_buf.buf == out->wpos);
+    out->rpos = decode_buf.buf;
+    size_t tmp_size = decode_buf.size;
+    out->wpos += tmp_size;
+
     json_next_token(&json, &token);
+    json_mp_process_value(l, &json, &token, out);
 
-    if (token.type != T_END)
-        json_throw_parse_error(l, &json, "the end", &token);
+    json_parse_end(l, &json);
 
-    strbuf_destroy(&decode_buf);
-    cord_ibuf_put(ibuf);
+    luamp_push(l, out->rpos + tmp_size, out->wpos);
+    cord_ibuf_put(out);
+    return 1;
+}
+
+static void json_append_mp_number(lua_State *l, struct luaL_serializer *cfg,
+                                  strbuf_t *json, double num)
+{
+    if (!isfinite(num) && !cfg->encode_invalid_numbers) {
+        if (!cfg->encode_invalid_as_nil)
+            luaL_error(l, "number must not be NaN or Inf");
+        return json_append_nil(cfg, json);
+    }
+    json_append_number(cfg, json, num);
+}
+
+static void json_append_mp(lua_State *l, struct luaL_serializer *cfg,
+                           int current_depth, strbuf_t *json,
+                           const char **data);
+
+static void json_append_mp_ext(lua_State *l, struct luaL_serializer *cfg,
+                               strbuf_t *json, const char **data)
+{
+    int8_t ext_type;
+    uint32_t len = mp_decode_extl(data, &ext_type);
+
+    switch (ext_type) {
+    case MP_DECIMAL:
+    {
+        decimal_t dec;
+        if (decimal_unpack(data, len, &dec) == NULL)
+            break;
+        const char *str = decimal_str(&dec);
+        return json_append_string(cfg, json, str, strlen(str));
+    }
+    case MP_UUID:
+    {
+        struct tt_uuid uuid;
+        if (uuid_unpack(data, len, &uuid) == NULL)
+            break;
+        return json_append_string(cfg, json, tt_uuid_str(&uuid),
+                                  UUID_STR_LEN);
+    }
+    case MP_DATETIME:
+    {
+        struct datetime date;
+        if (datetime_unpack(data, len, &date) == NULL)
+            break;
+        char buf[DT_TO_STRING_BUFSIZE];
+        size_t sz = datetime_to_string(&date, buf, sizeof(buf));
+        return json_append_string(cfg, json, buf, sz);
+    }
+    default:
+        luaL_error(l, "Unsupported MsgPack extension type %d", ext_type);
+    }
+    luaL_error(l, "Invalid MsgPack extension of type %d", ext_type);
+}
+
+static void json_append_mp_object(lua_State *l, struct luaL_serializer *cfg,
+                                  int current_depth, strbuf_t *json,
+                                  const char **data)
+{
+    uint32_t size = mp_decode_map(data);
+    uint32_t len;
+    const char *str;
+
+    strbuf_append_char(json, '{');
+    for (uint32_t i = 0; i < size; i++) {
+        if (i > 0)
+            strbuf_append_char(json, ',');
+        switch (mp_typeof(**data)) {
+        case MP_UINT:
+            strbuf_append_char(json, '"');
+            json_append_uint(cfg, json, mp_decode_uint(data));
+            strbuf_append_mem(json, "\":", 2);
+            break;
+        case MP_INT:
+            strbuf_append_char(json, '"');
+            json_append_int(cfg, json, mp_decode_int(data));
+            strbuf_append_mem(json, "\":", 2);
+            break;
+        case MP_STR:
+            str = mp_decode_str(data, &len);
+            json_append_string(cfg, json, str, len);
+            strbuf_append_char(json, ':');
+            break;
+        default:
+            luaL_error(l, "table key must be a number or string");
+        }
+        json_append_mp(l, cfg, current_depth, json, data);
+    }
+    strbuf_append_char(json, '}');
+}
+
+static void json_append_mp_array(lua_State *l, struct luaL_serializer *cfg,
+                                 int current_depth, strbuf_t *json,
+                                 const char **data)
+{
+    uint32_t size = mp_decode_array(data);
+
+    strbuf_append_char(json, '[');
+    for (uint32_t i = 0; i < size; i++) {
+        if (i > 0)
+            strbuf_append_char(json, ',');
+        json_append_mp(l, cfg, current_depth, json, data);
+    }
+    strbuf_append_char(json, ']');
+}
+
+/* Serialise MsgPack into JSON string, same as json_append_data() does it
+ * for the decoded Lua value. */
+static void json_append_mp(lua_State *l, struct luaL_serializer *cfg,
+                           int current_depth, strbuf_t *json,
+                           const char **data)
+{
+    uint32_t len;
+    const char *str;
 
+    switch (mp_typeof(**data)) {
+    case MP_UINT:
+        return json_append_uint(cfg, json, mp_decode_uint(data));
+    case MP_INT:
+        return json_append_int(cfg, json, mp_decode_int(data));
+    case MP_STR:
+        str = mp_decode_str(data, &len);
+        return json_append_string(cfg, json, str, len);
+    case MP_BIN:
+        str = mp_decode_bin(data, &len);
+        return json_append_string(cfg, json, str, len);
+    case MP_FLOAT:
+        return json_append_mp_number(l, cfg, json, mp_decode_float(data));
+    case MP_DOUBLE:
+        return json_append_mp_number(l, cfg, json, mp_decode_double(data));
+    case MP_BOOL:
+        if (mp_decode_bool(data))
+            strbuf_append_mem(json, "true", 4);
+        else
+            strbuf_append_mem(json, "false", 5);
+        return;
+    case MP_NIL:
+        mp_decode_nil(data);
+        return json_append_nil(cfg, json);
+    case MP_MAP:
+    case MP_ARRAY:
+        if (current_depth >= cfg->encode_max_depth) {
+            if (! cfg->encode_deep_as_nil)
+                luaL_error(l, "Too high nest level");
+            mp_next(data);
+            return json_append_nil(cfg, json); /* Limit nesting */
+        }
+        if (mp_typeof(**data) == MP_MAP)
+            json_append_mp_object(l, cfg, current_depth + 1, json, data);
+        else
+            json_append_mp_array(l, cfg, current_depth + 1, json, data);
+        return;
+    case MP_EXT:
+        return json_append_mp_ext(l, cfg, json, data);
+    }
+}
+
+/* json.from_msgpack(data[, opts]) converts a msgpack object or a string
+ * with MsgPack to JSON, without decoding it to Lua objects. */
+static int json_from_msgpack(lua_State *l) {
+    luaL_argcheck(l, lua_gettop(l) == 2 || lua_gettop(l) == 1, 1,
+                  "expected 1 or 2 arguments");
+
+    struct luaL_serializer *cfg = luaL_checkserializer(l);
+    struct luaL_serializer user_cfg;
+    if (lua_gettop(l) == 2) {
+        user_cfg = *cfg;
+        luaL_serializer_parse_options(l, &user_cfg);
+        lua_pop(l, 1);
+        cfg = &user_cfg;
+    }
+
+    size_t data_len;
+    const char *data = luamp_get(l, 1, &data_len);
+    if (data == NULL) {
+        data = luaL_checklstring(l, 1, &data_len);
+        const char *p = data;
+        if (mp_check(&p, data + data_len) != 0 || p != data + data_len)
+            luaL_error(l, "Invalid MsgPack");
+    }
+
+    /* Reuse existing buffer. */
+    strbuf_t encode_buf;
+    struct ibuf *ibuf = cord_ibuf_take();
+    strbuf_create(&encode_buf, STRBUF_DEFAULT_SIZE, ibuf);
+
+    json_append_mp(l, cfg, 0, &encode_buf, &data);
+
+    char *json = strbuf_string(&encode_buf, NULL);
+    lua_pushlstring(l, json, strbuf_length(&encode_buf));
+    /* See json_encode() on why it's fine to skip this on error. */
+    strbuf_destroy(&encode_buf);
+    cord_ibuf_put(ibuf);
     return 1;
 }
 
@@ -1147,6 +1670,8 @@ json_new(lua_State *L);
 static const luaL_Reg jsonlib[] = {
     { "encode", json_encode },
     { "decode", json_decode },
+    { "to_msgpack", json_to_msgpack },
+    { "from_msgpack", json_from_msgpack },
     { "new",    json_new },
     { NULL, NULL}
 };